@@ -39,7 +39,19 @@ enum Protocol {
     Proto_LDPC_Repair,
 
     //! RTCP.
-    Proto_RTCP
+    Proto_RTCP,
+
+    //! Bare RTP over same-host shared memory ring.
+    Proto_RTP_Shm,
+
+    //! SRTP (RTP with encrypted and authenticated payload).
+    Proto_SRTP,
+
+    //! RTP source packet + FECFRAME RLC footer (m=8).
+    Proto_RTP_RLC_Source,
+
+    //! FEC repair packet + FECFRAME RLC header (m=8).
+    Proto_RLC_Repair
 };
 
 //! Get string name of the protocol.
@@ -83,6 +83,46 @@ ProtocolMap::ProtocolMap() {
         attrs.fec_scheme = packet::FEC_None;
         add_proto_(attrs);
     }
+    {
+        ProtocolAttrs attrs;
+        attrs.protocol = Proto_RTP_Shm;
+        attrs.iface = Iface_AudioSource;
+        attrs.scheme_name = "rtp+shm";
+        attrs.path_supported = false;
+        attrs.default_port = -1;
+        attrs.fec_scheme = packet::FEC_None;
+        add_proto_(attrs);
+    }
+    {
+        ProtocolAttrs attrs;
+        attrs.protocol = Proto_SRTP;
+        attrs.iface = Iface_AudioSource;
+        attrs.scheme_name = "srtp";
+        attrs.path_supported = false;
+        attrs.default_port = -1;
+        attrs.fec_scheme = packet::FEC_None;
+        add_proto_(attrs);
+    }
+    {
+        ProtocolAttrs attrs;
+        attrs.protocol = Proto_RTP_RLC_Source;
+        attrs.iface = Iface_AudioSource;
+        attrs.scheme_name = "rtp+rlc";
+        attrs.path_supported = false;
+        attrs.default_port = -1;
+        attrs.fec_scheme = packet::FEC_RLC;
+        add_proto_(attrs);
+    }
+    {
+        ProtocolAttrs attrs;
+        attrs.protocol = Proto_RLC_Repair;
+        attrs.iface = Iface_AudioRepair;
+        attrs.scheme_name = "rlc";
+        attrs.path_supported = false;
+        attrs.default_port = -1;
+        attrs.fec_scheme = packet::FEC_RLC;
+        add_proto_(attrs);
+    }
 }
 
 const ProtocolAttrs* ProtocolMap::find_by_id(Protocol proto) const {
@@ -77,7 +77,7 @@ public:
 private:
     friend class core::Singleton<ProtocolMap>;
 
-    enum { MaxProtos = 8 };
+    enum { MaxProtos = 12 };
 
     ProtocolMap();
 
@@ -20,6 +20,7 @@ SocketAddr::SocketAddr() {
 
 void SocketAddr::clear() {
     memset(&saddr_, 0, sizeof(saddr_));
+    hash_ = 0;
 }
 
 bool SocketAddr::has_host_port() const {
@@ -33,6 +34,7 @@ bool SocketAddr::set_host_port_saddr(const sockaddr* sa) {
     }
 
     memcpy(&saddr_, sa, (size_t)sa_size);
+    hash_ = 0;
 
     return true;
 }
@@ -62,6 +64,7 @@ bool SocketAddr::set_host_port_ipv4_(const char* ip_str, int port) {
     saddr_.addr4.sin_family = AF_INET;
     saddr_.addr4.sin_addr = addr;
     saddr_.addr4.sin_port = (in_port_t)core::hton16u((uint16_t)port);
+    hash_ = 0;
 
     return true;
 }
@@ -75,11 +78,13 @@ bool SocketAddr::set_host_port_ipv6_(const char* ip_str, int port) {
     saddr_.addr6.sin6_family = AF_INET6;
     saddr_.addr6.sin6_addr = addr;
     saddr_.addr6.sin6_port = (in_port_t)core::hton16u((uint16_t)port);
+    hash_ = 0;
 
     return true;
 }
 
 sockaddr* SocketAddr::saddr() {
+    hash_ = 0;
     return (sockaddr*)&saddr_;
 }
 
@@ -95,6 +100,13 @@ socklen_t SocketAddr::max_slen() const {
     return saddr_size_(AF_INET6);
 }
 
+core::hashsum_t SocketAddr::hash() const {
+    if (hash_ == 0) {
+        hash_ = compute_hash_();
+    }
+    return hash_;
+}
+
 AddrFamily SocketAddr::family() const {
     switch (saddr_family_()) {
     case AF_INET:
@@ -190,6 +202,44 @@ bool SocketAddr::operator!=(const SocketAddr& other) const {
     return !(*this == other);
 }
 
+core::hashsum_t SocketAddr::compute_hash_() const {
+    // Hash only fields compared by operator==, and not padding,
+    // flow info, or scope id.
+    uint8_t key[sizeof(sa_family_t) + sizeof(in_port_t) + sizeof(in6_addr)];
+    size_t key_size = 0;
+
+    const sa_family_t family = saddr_family_();
+    memcpy(key + key_size, &family, sizeof(family));
+    key_size += sizeof(family);
+
+    switch (family) {
+    case AF_INET:
+        memcpy(key + key_size, &saddr_.addr4.sin_port, sizeof(in_port_t));
+        key_size += sizeof(in_port_t);
+        memcpy(key + key_size, &saddr_.addr4.sin_addr, sizeof(in_addr));
+        key_size += sizeof(in_addr);
+        break;
+
+    case AF_INET6:
+        memcpy(key + key_size, &saddr_.addr6.sin6_port, sizeof(in_port_t));
+        key_size += sizeof(in_port_t);
+        memcpy(key + key_size, &saddr_.addr6.sin6_addr, sizeof(in6_addr));
+        key_size += sizeof(in6_addr);
+        break;
+
+    default:
+        break;
+    }
+
+    core::hashsum_t h = core::hashsum_mem(key, key_size);
+    if (h == 0) {
+        // Zero means "not computed".
+        h = 1;
+    }
+
+    return h;
+}
+
 socklen_t SocketAddr::saddr_size_(sa_family_t family) {
     switch (family) {
     case AF_INET:
@@ -17,6 +17,7 @@
 
 #include "roc_address/addr_family.h"
 #include "roc_core/attributes.h"
+#include "roc_core/hashsum.h"
 #include "roc_core/stddefs.h"
 
 namespace roc {
@@ -56,6 +57,8 @@ public:
     int port() const;
 
     //! Get sockaddr struct.
+    //! @remarks
+    //!  Resets cached hash, since struct may be modified by caller.
     sockaddr* saddr();
 
     //! Get sockaddr struct.
@@ -67,6 +70,13 @@ public:
     //! Get maximum allowed sockaddr struct length.
     socklen_t max_slen() const;
 
+    //! Get hash of address.
+    //! @remarks
+    //!  Computed from family, host, and port, i.e. equal addresses have
+    //!  equal hashes. Computed on first call and cached until address is
+    //!  changed, so that repeated hashmap lookups don't rehash sockaddr.
+    core::hashsum_t hash() const;
+
     //! Convert to bool.
     operator const struct unspecified_bool *() const;
 
@@ -89,10 +99,15 @@ private:
     bool set_host_port_ipv4_(const char* ip, int port);
     bool set_host_port_ipv6_(const char* ip, int port);
 
+    core::hashsum_t compute_hash_() const;
+
     union {
         sockaddr_in addr4;
         sockaddr_in6 addr6;
     } saddr_;
+
+    // Zero if not computed yet.
+    mutable core::hashsum_t hash_;
 };
 
 } // namespace address
@@ -8,10 +8,22 @@
 
 #include "roc_audio/builtin_resampler.h"
 #include "roc_audio/sample_spec_to_str.h"
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/cpu_traits.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
 
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && ROC_CPU_HAS_SSE2
+#define ROC_AUDIO_BUILTIN_RESAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if ROC_CPU_FAMILY == ROC_CPU_ARM && ROC_CPU_HAS_NEON
+#define ROC_AUDIO_BUILTIN_RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
 namespace roc {
 namespace audio {
 
@@ -66,6 +78,37 @@ inline float fractional(const fixedpoint_t x) {
     return (float)(x & FRACT_PART_MASK) * ((float)1. / (float)qt_one);
 }
 
+// Number of fractional bits in fixed-point samples (Q1.15).
+const uint32_t SAMPLE_FRACT_BITS = 15;
+
+// Number of fractional bits in fixed-point coefficients (Q1.30).
+const uint32_t COEFF_FRACT_BITS = 30;
+
+// One in terms of Q1.30.
+const int32_t q30_one = 1 << COEFF_FRACT_BITS;
+
+// Returns fractional part of x in f32 or in Q1.15, depending on result type.
+inline void get_fractional(const fixedpoint_t x, float& result) {
+    result = fractional(x);
+}
+
+inline void get_fractional(const fixedpoint_t x, int32_t& result) {
+    result = (int32_t)((x & FRACT_PART_MASK) >> (FRACT_BIT_COUNT - SAMPLE_FRACT_BITS));
+}
+
+// Converts sample to Q1.15 with rounding and saturation.
+inline int16_t sample_to_q15(const sample_t s) {
+    const sample_t v = s * (sample_t)(1 << SAMPLE_FRACT_BITS);
+
+    if (v >= (sample_t)32767) {
+        return 32767;
+    }
+    if (v <= (sample_t)-32768) {
+        return -32768;
+    }
+    return (int16_t)(v >= 0 ? v + (sample_t)0.5 : v - (sample_t)0.5);
+}
+
 // Returns log2(n) assuming that n is a power of two.
 inline size_t calc_bits(size_t n) {
     size_t c = 0;
@@ -106,11 +149,177 @@ inline size_t get_window_size(ResamplerProfile profile) {
     roc_panic("builtin resampler: unexpected profile");
 }
 
+// Polyphase filter bank rows are padded to multiple of this,
+// so that SIMD loops don't need a tail.
+const size_t BankTapsAlign = 4;
+
+// Polyphase dot products.
+// Computes out[ch] = sum(in[n * num_ch + ch] * (lo[n] + fract * (hi[n] - lo[n]))),
+// i.e. interpolates coefficients between two bank rows and applies them
+// to interleaved input. n_taps is a multiple of BankTapsAlign.
+
+void poly_dot_generic(sample_t* out,
+                      const sample_t* in,
+                      const sample_t* lo,
+                      const sample_t* hi,
+                      const sample_t fract,
+                      const size_t n_taps,
+                      const size_t num_ch) {
+    for (size_t ch = 0; ch < num_ch; ch++) {
+        out[ch] = 0;
+    }
+
+    for (size_t n = 0; n < n_taps; n++) {
+        const sample_t coeff = lo[n] + fract * (hi[n] - lo[n]);
+        for (size_t ch = 0; ch < num_ch; ch++) {
+            out[ch] += in[ch] * coeff;
+        }
+        in += num_ch;
+    }
+}
+
+#if defined(ROC_AUDIO_BUILTIN_RESAMPLER_SSE2)
+
+void poly_dot_mono(sample_t* out,
+                   const sample_t* in,
+                   const sample_t* lo,
+                   const sample_t* hi,
+                   const sample_t fract,
+                   const size_t n_taps) {
+    const __m128 v_fract = _mm_set1_ps(fract);
+    __m128 acc = _mm_setzero_ps();
+
+    for (size_t n = 0; n < n_taps; n += 4) {
+        const __m128 v_lo = _mm_loadu_ps(lo + n);
+        const __m128 coeff =
+            _mm_add_ps(v_lo, _mm_mul_ps(v_fract, _mm_sub_ps(_mm_loadu_ps(hi + n), v_lo)));
+
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(in + n), coeff));
+    }
+
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+
+    out[0] = _mm_cvtss_f32(acc);
+}
+
+void poly_dot_stereo(sample_t* out,
+                     const sample_t* in,
+                     const sample_t* lo,
+                     const sample_t* hi,
+                     const sample_t fract,
+                     const size_t n_taps) {
+    const __m128 v_fract = _mm_set1_ps(fract);
+    // L R L R
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (size_t n = 0; n < n_taps; n += 4) {
+        const __m128 v_lo = _mm_loadu_ps(lo + n);
+        const __m128 coeff =
+            _mm_add_ps(v_lo, _mm_mul_ps(v_fract, _mm_sub_ps(_mm_loadu_ps(hi + n), v_lo)));
+
+        // c0 c0 c1 c1 and c2 c2 c3 c3
+        const __m128 coeff_lo = _mm_unpacklo_ps(coeff, coeff);
+        const __m128 coeff_hi = _mm_unpackhi_ps(coeff, coeff);
+
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(in + n * 2), coeff_lo));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(in + n * 2 + 4), coeff_hi));
+    }
+
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+
+    out[0] = _mm_cvtss_f32(acc0);
+    out[1] = _mm_cvtss_f32(_mm_shuffle_ps(acc0, acc0, 1));
+}
+
+#elif defined(ROC_AUDIO_BUILTIN_RESAMPLER_NEON)
+
+void poly_dot_mono(sample_t* out,
+                   const sample_t* in,
+                   const sample_t* lo,
+                   const sample_t* hi,
+                   const sample_t fract,
+                   const size_t n_taps) {
+    float32x4_t acc = vdupq_n_f32(0);
+
+    for (size_t n = 0; n < n_taps; n += 4) {
+        const float32x4_t v_lo = vld1q_f32(lo + n);
+        const float32x4_t coeff =
+            vmlaq_n_f32(v_lo, vsubq_f32(vld1q_f32(hi + n), v_lo), fract);
+
+        acc = vmlaq_f32(acc, vld1q_f32(in + n), coeff);
+    }
+
+    const float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+
+    out[0] = vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+
+void poly_dot_stereo(sample_t* out,
+                     const sample_t* in,
+                     const sample_t* lo,
+                     const sample_t* hi,
+                     const sample_t fract,
+                     const size_t n_taps) {
+    // L R L R
+    float32x4_t acc0 = vdupq_n_f32(0);
+    float32x4_t acc1 = vdupq_n_f32(0);
+
+    for (size_t n = 0; n < n_taps; n += 4) {
+        const float32x4_t v_lo = vld1q_f32(lo + n);
+        const float32x4_t coeff =
+            vmlaq_n_f32(v_lo, vsubq_f32(vld1q_f32(hi + n), v_lo), fract);
+
+        // c0 c0 c1 c1 and c2 c2 c3 c3
+        const float32x4x2_t coeff2 = vzipq_f32(coeff, coeff);
+
+        acc0 = vmlaq_f32(acc0, vld1q_f32(in + n * 2), coeff2.val[0]);
+        acc1 = vmlaq_f32(acc1, vld1q_f32(in + n * 2 + 4), coeff2.val[1]);
+    }
+
+    acc0 = vaddq_f32(acc0, acc1);
+
+    const float32x2_t sum = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+
+    out[0] = vget_lane_f32(sum, 0);
+    out[1] = vget_lane_f32(sum, 1);
+}
+
+#else
+
+void poly_dot_mono(sample_t* out,
+                   const sample_t* in,
+                   const sample_t* lo,
+                   const sample_t* hi,
+                   const sample_t fract,
+                   const size_t n_taps) {
+    poly_dot_generic(out, in, lo, hi, fract, n_taps, 1);
+}
+
+void poly_dot_stereo(sample_t* out,
+                     const sample_t* in,
+                     const sample_t* lo,
+                     const sample_t* hi,
+                     const sample_t fract,
+                     const size_t n_taps) {
+    poly_dot_generic(out, in, lo, hi, fract, n_taps, 2);
+}
+
+#endif
+
+// Frame should fit the window, which spans more input samples when downscaling.
+// When upscaling, window doesn't become shorter in terms of input samples (see
+// set_scaling), so we don't shrink the frame either. Otherwise, at high output
+// rates, frames would consist of a few input samples, and we would rotate
+// frames and read tiny frames from upstream every few output samples.
 inline size_t get_frame_size(size_t window_size,
                              const SampleSpec& in_spec,
                              const SampleSpec& out_spec) {
     const float scaling =
-        (float)in_spec.sample_rate() / (float)out_spec.sample_rate() * 1.5f;
+        std::max((float)in_spec.sample_rate() / (float)out_spec.sample_rate(), 1.0f)
+        * 1.5f;
 
     return (size_t)std::ceil(window_size * scaling);
 }
@@ -121,10 +330,12 @@ BuiltinResampler::BuiltinResampler(core::IArena& arena,
                                    FrameFactory& frame_factory,
                                    ResamplerProfile profile,
                                    const SampleSpec& in_spec,
-                                   const SampleSpec& out_spec)
+                                   const SampleSpec& out_spec,
+                                   BuiltinResamplerArith arith)
     : IResampler(arena)
     , in_spec_(in_spec)
     , out_spec_(out_spec)
+    , arith_(arith)
     , n_ready_frames_(0)
     , prev_frame_(NULL)
     , curr_frame_(NULL)
@@ -136,8 +347,19 @@ BuiltinResampler::BuiltinResampler(core::IArena& arena,
     , window_interp_bits_(calc_bits(window_interp_))
     , frame_size_ch_(get_frame_size(window_size_, in_spec, out_spec))
     , frame_size_(frame_size_ch_ * in_spec.num_channels())
-    , sinc_table_(arena)
     , sinc_table_ptr_(NULL)
+    , coeffs_(arena)
+    , fixed_sinc_table_ptr_(NULL)
+    , fixed_frames_buf_(arena)
+    , fixed_coeffs_(arena)
+    , fixed_accum_(arena)
+    , fixed_gain_(q30_one)
+    , bank_(arena)
+    , bank_taps_(0)
+    , bank_half_(0)
+    , bank_in_rate_(0)
+    , bank_out_rate_(0)
+    , poly_frames_(arena)
     , qt_half_window_size_(float_to_fixedpoint((float)window_size_ / scaling_))
     , qt_epsilon_(float_to_fixedpoint(5e-8f))
     , qt_frame_size_(fixedpoint_t(frame_size_ch_ << FRACT_BIT_COUNT))
@@ -145,13 +367,23 @@ BuiltinResampler::BuiltinResampler(core::IArena& arena,
     , qt_dt_(0)
     , cutoff_freq_(0.9f)
     , valid_(false) {
-    roc_log(
-        LogDebug,
-        "builtin resampler: initializing:"
-        " profile=%s window_interp=%lu window_size=%lu frame_size=%lu channels_num=%lu",
-        resampler_profile_to_str(profile), (unsigned long)window_interp_,
-        (unsigned long)window_size_, (unsigned long)frame_size_,
-        (unsigned long)in_spec_.num_channels());
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(frame_order_); n++) {
+        frame_order_[n] = n;
+    }
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(fixed_frames_); n++) {
+        fixed_frames_[n] = NULL;
+    }
+
+    roc_log(LogDebug,
+            "builtin resampler: initializing:"
+            " profile=%s arith=%s window_interp=%lu window_size=%lu frame_size=%lu"
+            " channels_num=%lu",
+            resampler_profile_to_str(profile),
+            arith_ == BuiltinResamplerArith_Fixed
+                ? "fixed"
+                : arith_ == BuiltinResamplerArith_Polyphase ? "polyphase" : "float",
+            (unsigned long)window_interp_, (unsigned long)window_size_,
+            (unsigned long)frame_size_, (unsigned long)in_spec_.num_channels());
 
     if (!check_config_()) {
         return;
@@ -161,6 +393,10 @@ BuiltinResampler::BuiltinResampler(core::IArena& arena,
         return;
     }
 
+    if (!alloc_coeffs_()) {
+        return;
+    }
+
     if (!alloc_frames_(frame_factory)) {
         return;
     }
@@ -169,6 +405,12 @@ BuiltinResampler::BuiltinResampler(core::IArena& arena,
 }
 
 BuiltinResampler::~BuiltinResampler() {
+    if (sinc_table_ptr_) {
+        SincTableCache::instance().release(sinc_table_ptr_);
+    }
+    if (fixed_sinc_table_ptr_) {
+        SincTableCache::instance().release(fixed_sinc_table_ptr_);
+    }
 }
 
 bool BuiltinResampler::is_valid() const {
@@ -202,6 +444,13 @@ bool BuiltinResampler::set_scaling(size_t input_sample_rate,
         return false;
     }
 
+    if (arith_ == BuiltinResamplerArith_Polyphase
+        && (input_sample_rate != bank_in_rate_ || output_sample_rate != bank_out_rate_)) {
+        if (!build_bank_(input_sample_rate, output_sample_rate)) {
+            return false;
+        }
+    }
+
     // In case of upscaling one should properly shift the edge frequency
     // of the digital filter. In both cases it's sensible to decrease the
     // edge frequency to leave some.
@@ -235,6 +484,10 @@ bool BuiltinResampler::set_scaling(size_t input_sample_rate,
     scaling_ = new_scaling;
     qt_dt_ = float_to_fixedpoint(scaling_);
 
+    fixed_gain_ = scaling_ > 1.0f
+        ? (int32_t)((double)q30_one / (double)scaling_ + 0.5)
+        : q30_one;
+
     return true;
 }
 
@@ -243,18 +496,30 @@ const core::Slice<sample_t>& BuiltinResampler::begin_push_input() {
         return frames_[n_ready_frames_];
     }
 
-    core::Slice<sample_t> new_last_frame = frames_[0];
-    frames_[0] = frames_[1];
-    frames_[1] = frames_[2];
-    frames_[2] = new_last_frame;
+    // Rotate indices instead of slices to avoid touching reference counters.
+    const size_t new_last_frame = frame_order_[0];
+    frame_order_[0] = frame_order_[1];
+    frame_order_[1] = frame_order_[2];
+    frame_order_[2] = new_last_frame;
+
+    int16_t* new_last_fixed_frame = fixed_frames_[0];
+    fixed_frames_[0] = fixed_frames_[1];
+    fixed_frames_[1] = fixed_frames_[2];
+    fixed_frames_[2] = new_last_fixed_frame;
 
-    return frames_[2];
+    return frames_[frame_order_[2]];
 }
 
 void BuiltinResampler::end_push_input() {
-    prev_frame_ = frames_[0].data();
-    curr_frame_ = frames_[1].data();
-    next_frame_ = frames_[2].data();
+    if (arith_ == BuiltinResamplerArith_Fixed) {
+        convert_input_(n_ready_frames_ < 3 ? n_ready_frames_ : 2);
+    } else if (arith_ == BuiltinResamplerArith_Polyphase) {
+        copy_input_(n_ready_frames_ < 3 ? n_ready_frames_ : 2);
+    }
+
+    prev_frame_ = frames_[frame_order_[0]].data();
+    curr_frame_ = frames_[frame_order_[1]].data();
+    next_frame_ = frames_[frame_order_[2]].data();
 
     if (n_ready_frames_ < 3) {
         n_ready_frames_++;
@@ -284,8 +549,12 @@ size_t BuiltinResampler::pop_output(sample_t* out_data, size_t out_size) {
             qt_sample_ += qt_one;
         }
 
-        for (size_t channel = 0; channel < in_spec_.num_channels(); ++channel) {
-            out_data[out_pos + channel] = resample_(channel);
+        if (arith_ == BuiltinResamplerArith_Fixed) {
+            resample_fixed_(out_data + out_pos);
+        } else if (arith_ == BuiltinResamplerArith_Polyphase) {
+            resample_polyphase_(out_data + out_pos);
+        } else {
+            resample_(out_data + out_pos);
         }
         qt_sample_ += qt_dt_;
     }
@@ -299,7 +568,7 @@ float BuiltinResampler::n_left_to_process() const {
 
 bool BuiltinResampler::alloc_frames_(FrameFactory& frame_factory) {
     for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); n++) {
-        frames_[n] = frame_factory.new_raw_buffer();
+        frames_[n] = frame_factory.new_raw_buffer(frame_size_);
 
         if (!frames_[n]) {
             roc_log(LogError, "builtin resampler: can't allocate frame buffer");
@@ -309,6 +578,48 @@ bool BuiltinResampler::alloc_frames_(FrameFactory& frame_factory) {
         frames_[n].reslice(0, frame_size_);
     }
 
+    if (arith_ == BuiltinResamplerArith_Fixed) {
+        if (!fixed_frames_buf_.resize(frame_size_ * ROC_ARRAY_SIZE(fixed_frames_))) {
+            roc_log(LogError, "builtin resampler: can't allocate frame buffer");
+            return false;
+        }
+
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(fixed_frames_); n++) {
+            fixed_frames_[n] = fixed_frames_buf_.data() + frame_size_ * n;
+        }
+    }
+
+    if (arith_ == BuiltinResamplerArith_Polyphase) {
+        if (!poly_frames_.resize(frame_size_ * ROC_ARRAY_SIZE(frames_))) {
+            roc_log(LogError, "builtin resampler: can't allocate frame buffer");
+            return false;
+        }
+
+        for (size_t n = 0; n < poly_frames_.size(); n++) {
+            poly_frames_[n] = 0;
+        }
+    }
+
+    return true;
+}
+
+bool BuiltinResampler::alloc_coeffs_() {
+    // Window may span the whole previous, current, and next frames.
+    const size_t max_coeffs = frame_size_ch_ * 3 + 1;
+
+    if (arith_ == BuiltinResamplerArith_Fixed) {
+        if (!fixed_coeffs_.resize(max_coeffs)
+            || !fixed_accum_.resize(in_spec_.num_channels())) {
+            roc_log(LogError, "builtin resampler: can't allocate coefficients buffer");
+            return false;
+        }
+    } else if (arith_ == BuiltinResamplerArith_Float) {
+        if (!coeffs_.resize(max_coeffs)) {
+            roc_log(LogError, "builtin resampler: can't allocate coefficients buffer");
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -365,27 +676,21 @@ bool BuiltinResampler::check_config_() const {
 }
 
 bool BuiltinResampler::fill_sinc_() {
-    if (!sinc_table_.resize(window_size_ * window_interp_ + 2)) {
-        roc_log(LogError, "builtin resampler: can't allocate sinc table");
-        return false;
-    }
-
-    const double sinc_step = 1.0 / (double)window_interp_;
-    double sinc_t = sinc_step;
-
-    sinc_table_[0] = 1.0f;
-    for (size_t i = 1; i < sinc_table_.size(); ++i) {
-        const double window = 0.54
-            - 0.46
-                * std::cos(2 * M_PI
-                           * ((double)(i - 1) / 2.0 / (double)sinc_table_.size() + 0.5));
-        sinc_table_[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
-        sinc_t += sinc_step;
+    if (arith_ == BuiltinResamplerArith_Fixed) {
+        fixed_sinc_table_ptr_ =
+            SincTableCache::instance().acquire_fixed(window_size_, window_interp_);
+        if (!fixed_sinc_table_ptr_) {
+            roc_log(LogError, "builtin resampler: can't allocate sinc table");
+            return false;
+        }
+    } else {
+        sinc_table_ptr_ =
+            SincTableCache::instance().acquire(window_size_, window_interp_);
+        if (!sinc_table_ptr_) {
+            roc_log(LogError, "builtin resampler: can't allocate sinc table");
+            return false;
+        }
     }
-    sinc_table_[sinc_table_.size() - 2] = 0;
-    sinc_table_[sinc_table_.size() - 1] = 0;
-
-    sinc_table_ptr_ = &sinc_table_[0];
 
     return true;
 }
@@ -407,48 +712,262 @@ sample_t BuiltinResampler::sinc_(const fixedpoint_t x, const float fract_x) {
     return scaling_ > 1.0f ? result / scaling_ : result;
 }
 
-sample_t BuiltinResampler::resample_(const size_t channel_offset) {
+// Same as above, but in fixed point.
+// Table values and result are in Q1.30, fract_x is in Q1.15.
+int32_t BuiltinResampler::sinc_(const fixedpoint_t x, const int32_t fract_x) {
+    const size_t index = (x >> (FRACT_BIT_COUNT - window_interp_bits_));
+
+    const int32_t hl = fixed_sinc_table_ptr_[index];
+    const int32_t hh = fixed_sinc_table_ptr_[index + 1];
+
+    const int32_t result =
+        hl + (int32_t)(((int64_t)(hh - hl) * fract_x) >> SAMPLE_FRACT_BITS);
+
+    return fixed_gain_ != q30_one
+        ? (int32_t)(((int64_t)result * fixed_gain_) >> COEFF_FRACT_BITS)
+        : result;
+}
+
+void BuiltinResampler::convert_input_(size_t frame_index) {
+    const sample_t* in_frame = frames_[frame_order_[frame_index]].data();
+    int16_t* out_frame = fixed_frames_[frame_index];
+
+    for (size_t n = 0; n < frame_size_; n++) {
+        out_frame[n] = sample_to_q15(in_frame[n]);
+    }
+}
+
+void BuiltinResampler::copy_input_(size_t frame_index) {
+    sample_t* buf = poly_frames_.data();
+
+    if (n_ready_frames_ == 3) {
+        // Drop previous frame, current and next frames become previous and current.
+        memmove(buf, buf + frame_size_, frame_size_ * 2 * sizeof(sample_t));
+    }
+
+    memcpy(buf + frame_size_ * frame_index, frames_[frame_order_[frame_index]].data(),
+           frame_size_ * sizeof(sample_t));
+}
+
+bool BuiltinResampler::build_bank_(size_t input_rate, size_t output_rate) {
+    // Cutoff and gain are computed like in set_scaling(), but for nominal
+    // rates, so that bank doesn't depend on multiplier.
+    const double scaling = (double)input_rate / (double)output_rate;
+
+    const double sinc_step =
+        scaling > 1.0 ? (double)cutoff_freq_ / scaling : (double)cutoff_freq_;
+    const double gain = scaling > 1.0 ? 1.0 / scaling : 1.0;
+
+    const double half_window = (double)window_size_ / sinc_step;
+
+    // Output position is between taps (half - 1) and half. Taps cover
+    // half window on both sides for any fractional part of position.
+    const size_t half = (size_t)std::ceil(half_window) + 1;
+    const size_t taps = (half * 2 + BankTapsAlign - 1) / BankTapsAlign * BankTapsAlign;
+
+    // Window should fit previous and next frames.
+    if (half - 1 > frame_size_ch_ || taps - half > frame_size_ch_) {
+        roc_log(LogError,
+                "builtin resampler: rates do not fit frame size:"
+                " window_size=%lu frame_size=%lu in_rate=%lu out_rate=%lu",
+                (unsigned long)window_size_, (unsigned long)frame_size_,
+                (unsigned long)input_rate, (unsigned long)output_rate);
+        return false;
+    }
+
+    if (!bank_.resize((window_interp_ + 1) * taps)) {
+        roc_log(LogError, "builtin resampler: can't allocate filter bank");
+        return false;
+    }
+
+    const size_t table_len = window_size_ * window_interp_;
+
+    for (size_t phase = 0; phase <= window_interp_; phase++) {
+        sample_t* row = bank_.data() + phase * taps;
+
+        for (size_t n = 0; n < taps; n++) {
+            // Distance from tap to output position, in input samples.
+            const double dist = std::abs((double)phase / (double)window_interp_
+                                         + (double)half - 1.0 - (double)n);
+
+            // Position in sinc table, like in sinc_().
+            const double pos = dist * sinc_step * (double)window_interp_;
+
+            if (pos >= (double)table_len) {
+                row[n] = 0;
+                continue;
+            }
+
+            const size_t index = (size_t)pos;
+            const double fract = pos - (double)index;
+
+            const double hl = (double)sinc_table_ptr_[index];
+            const double hh = (double)sinc_table_ptr_[index + 1];
+
+            row[n] = (sample_t)((hl + fract * (hh - hl)) * gain);
+        }
+    }
+
+    bank_taps_ = taps;
+    bank_half_ = half;
+    bank_in_rate_ = input_rate;
+    bank_out_rate_ = output_rate;
+
+    roc_log(LogDebug,
+            "builtin resampler: built filter bank:"
+            " in_rate=%lu out_rate=%lu phases=%lu taps=%lu",
+            (unsigned long)input_rate, (unsigned long)output_rate,
+            (unsigned long)window_interp_ + 1, (unsigned long)taps);
+
+    return true;
+}
+
+void BuiltinResampler::resample_(sample_t* out_frame) {
     roc_panic_if_msg(qt_sinc_step_ == 0,
                      "builtin resampler:"
                      " set_scaling() must be called before any resampling could be done");
-    // Index of first input sample in window.
-    size_t ind_begin_prev;
 
-    // Window lasts till that index.
-    const size_t ind_end_prev = channelize_index(frame_size_ch_, channel_offset);
+    const size_t num_ch = in_spec_.num_channels();
+
+    size_t ind_begin_prev = 0, ind_begin_cur = 0, ind_end_cur = 0, ind_end_next = 0;
+    const size_t n_coeffs = compute_coeffs_(coeffs_.data(), ind_begin_prev,
+                                            ind_begin_cur, ind_end_cur, ind_end_next);
+
+    const size_t n_prev = frame_size_ch_ - ind_begin_prev;
+    const size_t n_cur = ind_end_cur + 1 - ind_begin_cur;
+    const size_t n_next = ind_end_next;
+
+    roc_panic_if(n_prev + n_cur + n_next != n_coeffs);
+
+    for (size_t ch = 0; ch < num_ch; ch++) {
+        out_frame[ch] = 0;
+    }
+
+    // Coefficients are applied in the same order as they were computed,
+    // so every channel is accumulated in the same order as if it was
+    // processed separately.
+    const sample_t* coeffs = coeffs_.data();
+
+    apply_coeffs_(out_frame, prev_frame_ + ind_begin_prev * num_ch, coeffs, n_prev);
+    coeffs += n_prev;
+
+    apply_coeffs_(out_frame, curr_frame_ + ind_begin_cur * num_ch, coeffs, n_cur);
+    coeffs += n_cur;
 
-    size_t ind_begin_cur;
-    size_t ind_end_cur;
+    apply_coeffs_(out_frame, next_frame_, coeffs, n_next);
+}
+
+void BuiltinResampler::resample_fixed_(sample_t* out_frame) {
+    roc_panic_if_msg(qt_sinc_step_ == 0,
+                     "builtin resampler:"
+                     " set_scaling() must be called before any resampling could be done");
+
+    const size_t num_ch = in_spec_.num_channels();
+
+    size_t ind_begin_prev = 0, ind_begin_cur = 0, ind_end_cur = 0, ind_end_next = 0;
+    const size_t n_coeffs = compute_coeffs_(fixed_coeffs_.data(), ind_begin_prev,
+                                            ind_begin_cur, ind_end_cur, ind_end_next);
+
+    const size_t n_prev = frame_size_ch_ - ind_begin_prev;
+    const size_t n_cur = ind_end_cur + 1 - ind_begin_cur;
+    const size_t n_next = ind_end_next;
+
+    roc_panic_if(n_prev + n_cur + n_next != n_coeffs);
+
+    int64_t* accum = fixed_accum_.data();
+
+    for (size_t ch = 0; ch < num_ch; ch++) {
+        accum[ch] = 0;
+    }
+
+    const int32_t* coeffs = fixed_coeffs_.data();
+
+    apply_coeffs_(accum, fixed_frames_[0] + ind_begin_prev * num_ch, coeffs, n_prev);
+    coeffs += n_prev;
+
+    apply_coeffs_(accum, fixed_frames_[1] + ind_begin_cur * num_ch, coeffs, n_cur);
+    coeffs += n_cur;
+
+    apply_coeffs_(accum, fixed_frames_[2], coeffs, n_next);
+
+    // Accumulators are in Q.45, keep 23 fractional bits, which is
+    // exactly representable in float.
+    const uint32_t shift = SAMPLE_FRACT_BITS + COEFF_FRACT_BITS - 23;
+
+    for (size_t ch = 0; ch < num_ch; ch++) {
+        out_frame[ch] =
+            (sample_t)(int32_t)(accum[ch] >> shift) * ((sample_t)1. / (1 << 23));
+    }
+}
+
+void BuiltinResampler::resample_polyphase_(sample_t* out_frame) {
+    roc_panic_if_msg(bank_taps_ == 0,
+                     "builtin resampler:"
+                     " set_scaling() must be called before any resampling could be done");
+
+    const size_t num_ch = in_spec_.num_channels();
+
+    // Integer part selects first tap, fractional part selects bank rows.
+    const size_t pos = fixedpoint_to_size(qt_sample_);
+    const fixedpoint_t pos_fract = qt_sample_ & FRACT_PART_MASK;
+
+    const size_t phase_shift = FRACT_BIT_COUNT - window_interp_bits_;
+    const fixedpoint_t phase_mask = ((fixedpoint_t)1 << phase_shift) - 1;
 
-    const size_t ind_begin_next = channelize_index(0, channel_offset);
-    size_t ind_end_next;
+    const size_t phase = pos_fract >> phase_shift;
+    const sample_t phase_fract =
+        (sample_t)(pos_fract & phase_mask) / (sample_t)(phase_mask + 1);
 
+    // Taps start in previous frame and end in next frame.
+    const size_t first_tap = frame_size_ch_ + pos + 1 - bank_half_;
+    roc_panic_if(first_tap + bank_taps_ > frame_size_ch_ * 3);
+
+    const sample_t* in = poly_frames_.data() + first_tap * num_ch;
+    const sample_t* lo = bank_.data() + phase * bank_taps_;
+    const sample_t* hi = lo + bank_taps_;
+
+    switch (num_ch) {
+    case 1:
+        poly_dot_mono(out_frame, in, lo, hi, phase_fract, bank_taps_);
+        break;
+
+    case 2:
+        poly_dot_stereo(out_frame, in, lo, hi, phase_fract, bank_taps_);
+        break;
+
+    default:
+        poly_dot_generic(out_frame, in, lo, hi, phase_fract, bank_taps_, num_ch);
+        break;
+    }
+}
+
+template <class Coeff>
+size_t BuiltinResampler::compute_coeffs_(Coeff* coeffs,
+                                         size_t& ind_begin_prev,
+                                         size_t& ind_begin_cur,
+                                         size_t& ind_end_cur,
+                                         size_t& ind_end_next) {
+    // Index of first input sample in window.
     ind_begin_prev = (qt_sample_ >= qt_half_window_size_)
         ? frame_size_ch_
         : fixedpoint_to_size(qceil(qt_sample_ + (qt_frame_size_ - qt_half_window_size_)));
-    // ind_begin_prev is comparable with channel_len_ till we'll convert it to channalyzed
-    // presentation.
     roc_panic_if(ind_begin_prev > frame_size_ch_);
-    ind_begin_prev = channelize_index(ind_begin_prev, channel_offset);
 
     ind_begin_cur = (qt_sample_ >= qt_half_window_size_)
         ? fixedpoint_to_size(qceil(qt_sample_ - qt_half_window_size_))
         : 0;
     roc_panic_if(ind_begin_cur > frame_size_ch_);
-    ind_begin_cur = channelize_index(ind_begin_cur, channel_offset);
 
     ind_end_cur = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
         ? frame_size_ch_ - 1
         : fixedpoint_to_size(qfloor(qt_sample_ + qt_half_window_size_));
     roc_panic_if(ind_end_cur > frame_size_ch_);
-    ind_end_cur = channelize_index(ind_end_cur, channel_offset);
 
     ind_end_next = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
         ? fixedpoint_to_size(qfloor(qt_sample_ + qt_half_window_size_ - qt_frame_size_))
             + 1
         : 0;
     roc_panic_if(ind_end_next > frame_size_ch_);
-    ind_end_next = channelize_index(ind_end_next, channel_offset);
 
     // Counter inside window.
     // t_sinc = (t_sample - ceil( t_sample - window_len/cutoff*scale )) * sinc_step
@@ -460,34 +979,36 @@ sample_t BuiltinResampler::resample_(const size_t channel_offset) {
     // sinc_table defined in positive half-plane, so at the beginning of the window
     // qt_sinc_cur starts decreasing and after we cross 0 it will be increasing
     // till the end of the window.
-    fixedpoint_t qt_sinc_inc = qt_sinc_step_;
+    const fixedpoint_t qt_sinc_inc = qt_sinc_step_;
 
     // Compute fractional part of time position at the beginning. It wont change during
     // the run.
-    float f_sinc_cur_fract = fractional(qt_sinc_cur << window_interp_bits_);
-    sample_t accumulator = 0;
+    Coeff f_sinc_cur_fract;
+    get_fractional(qt_sinc_cur << window_interp_bits_, f_sinc_cur_fract);
+
+    size_t n_coeffs = 0;
 
     size_t i;
 
     // Run through previous frame.
-    for (i = ind_begin_prev; i < ind_end_prev; i += in_spec_.num_channels()) {
-        accumulator += prev_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
+    for (i = ind_begin_prev; i < frame_size_ch_; i++) {
+        coeffs[n_coeffs++] = sinc_(qt_sinc_cur, f_sinc_cur_fract);
         qt_sinc_cur -= qt_sinc_inc;
     }
 
     // Run through current frame through the left windows side. qt_sinc_cur is decreasing.
     i = ind_begin_cur;
 
-    accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
+    coeffs[n_coeffs++] = sinc_(qt_sinc_cur, f_sinc_cur_fract);
     while (qt_sinc_cur >= qt_sinc_step_) {
-        i += in_spec_.num_channels();
+        i++;
         qt_sinc_cur -= qt_sinc_inc;
-        accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
+        coeffs[n_coeffs++] = sinc_(qt_sinc_cur, f_sinc_cur_fract);
     }
 
-    i += in_spec_.num_channels();
+    i++;
 
-    roc_panic_if(i > channelize_index(frame_size_ch_, channel_offset));
+    roc_panic_if(i > frame_size_ch_);
 
     // Crossing zero -- we just need to switch qt_sinc_cur.
     // -1 ------------ 0 ------------- +1
@@ -495,21 +1016,95 @@ sample_t BuiltinResampler::resample_(const size_t channel_offset) {
     //      |                  |
     //   -qt_sinc_cur  ->  +qt_sinc_cur     <=> qt_sinc_cur = 1 - qt_sinc_cur
     qt_sinc_cur = qt_sinc_step_ - qt_sinc_cur; // qt_sinc_cur = -qt_sinc_cur + 1;
-    f_sinc_cur_fract = fractional(qt_sinc_cur << window_interp_bits_);
+    get_fractional(qt_sinc_cur << window_interp_bits_, f_sinc_cur_fract);
 
     // Run through right side of the window, increasing qt_sinc_cur.
-    for (; i <= ind_end_cur; i += in_spec_.num_channels()) {
-        accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
+    for (; i <= ind_end_cur; i++) {
+        coeffs[n_coeffs++] = sinc_(qt_sinc_cur, f_sinc_cur_fract);
         qt_sinc_cur += qt_sinc_inc;
     }
 
+    // Left side may end after right side ends, then current frame
+    // window ends at the last sample of the left side.
+    ind_end_cur = i - 1;
+
     // Next frames run.
-    for (i = ind_begin_next; i < ind_end_next; i += in_spec_.num_channels()) {
-        accumulator += next_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
+    for (i = 0; i < ind_end_next; i++) {
+        coeffs[n_coeffs++] = sinc_(qt_sinc_cur, f_sinc_cur_fract);
         qt_sinc_cur += qt_sinc_inc;
     }
 
-    return accumulator;
+    roc_panic_if(n_coeffs > frame_size_ch_ * 3 + 1);
+
+    return n_coeffs;
+}
+
+void BuiltinResampler::apply_coeffs_(sample_t* out_frame,
+                                     const sample_t* in_frame,
+                                     const sample_t* coeffs,
+                                     size_t n_coeffs) const {
+    const size_t num_ch = in_spec_.num_channels();
+
+    switch (num_ch) {
+    case 1:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            out_frame[0] += in_frame[n] * coeffs[n];
+        }
+        break;
+
+    case 2:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            const sample_t coeff = coeffs[n];
+            out_frame[0] += in_frame[0] * coeff;
+            out_frame[1] += in_frame[1] * coeff;
+            in_frame += 2;
+        }
+        break;
+
+    default:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            const sample_t coeff = coeffs[n];
+            for (size_t ch = 0; ch < num_ch; ch++) {
+                out_frame[ch] += in_frame[ch] * coeff;
+            }
+            in_frame += num_ch;
+        }
+        break;
+    }
+}
+
+void BuiltinResampler::apply_coeffs_(int64_t* out_frame,
+                                     const int16_t* in_frame,
+                                     const int32_t* coeffs,
+                                     size_t n_coeffs) const {
+    const size_t num_ch = in_spec_.num_channels();
+
+    switch (num_ch) {
+    case 1:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            out_frame[0] += (int64_t)in_frame[n] * coeffs[n];
+        }
+        break;
+
+    case 2:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            const int64_t coeff = coeffs[n];
+            out_frame[0] += in_frame[0] * coeff;
+            out_frame[1] += in_frame[1] * coeff;
+            in_frame += 2;
+        }
+        break;
+
+    default:
+        for (size_t n = 0; n < n_coeffs; n++) {
+            const int64_t coeff = coeffs[n];
+            for (size_t ch = 0; ch < num_ch; ch++) {
+                out_frame[ch] += in_frame[ch] * coeff;
+            }
+            in_frame += num_ch;
+        }
+        break;
+    }
 }
 
 } // namespace audio
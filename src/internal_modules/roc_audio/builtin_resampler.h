@@ -28,6 +28,25 @@
 namespace roc {
 namespace audio {
 
+//! Arithmetic used by built-in resampler.
+enum BuiltinResamplerArith {
+    //! Floating-point samples and coefficients.
+    BuiltinResamplerArith_Float,
+
+    //! Fixed-point samples and coefficients.
+    //! Input samples are converted to Q1.15, sinc coefficients are Q1.30, and
+    //! products are accumulated in 64-bit integers. Precision is limited to
+    //! 16-bit input, but the inner loops don't use floating point at all.
+    BuiltinResamplerArith_Fixed,
+
+    //! Floating-point samples, coefficients from polyphase filter bank.
+    //! Coefficients are precomputed for a fixed number of phases of output
+    //! position and interpolated between two nearest phases, using SIMD
+    //! where available. Filter cutoff follows nominal rate ratio and doesn't
+    //! follow small changes of scaling made by latency tuner.
+    BuiltinResamplerArith_Polyphase
+};
+
 //! Built-in resampler.
 //!
 //! Resamples audio stream with non-integer dynamically changing factor.
@@ -36,6 +55,29 @@ namespace audio {
 //!
 //! This backend is quite CPU-hungry, but it maintains requested scaling
 //! factor with very high precision.
+//!
+//! Sinc coefficients of the window are the same for every channel, so for
+//! each output frame they are computed once into a coefficient vector, and
+//! then applied to all channels at once. Input frames are kept interleaved,
+//! so the inner loop walks contiguous memory and computes a dot product for
+//! all channels in parallel.
+//!
+//! Sinc table depends only on profile, so it is taken from SincTableCache
+//! and shared by all resamplers with the same profile.
+//!
+//! In fixed-point mode, every input frame is converted to 16-bit integers
+//! once when it's pushed, and then coefficients computation and convolution
+//! use only integer arithmetic. This is much cheaper on CPUs without fast
+//! floating point unit, where float multiply-add in the inner loop dominates.
+//!
+//! In polyphase mode, sinc is not evaluated per tap. Instead, when rates
+//! are set, a bank of coefficient vectors is built for every phase of
+//! output position (fractional part of it, quantized to window_interp
+//! steps). Input frames are copied into one contiguous buffer, so for each
+//! output frame a single pass interpolates between two bank rows and
+//! computes dot product for all interleaved channels. Without downscaling,
+//! the bank takes about 10KB, 40KB, and 300KB for low, medium, and high
+//! profiles.
 class BuiltinResampler : public IResampler, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -43,7 +85,8 @@ public:
                      FrameFactory& frame_factory,
                      ResamplerProfile profile,
                      const SampleSpec& in_spec,
-                     const SampleSpec& out_spec);
+                     const SampleSpec& out_spec,
+                     BuiltinResamplerArith arith);
 
     ~BuiltinResampler();
 
@@ -77,26 +120,57 @@ private:
     typedef int32_t signed_fixedpoint_t;
     typedef int64_t signed_long_fixedpoint_t;
 
-    inline size_t channelize_index(const size_t i, const size_t ch_offset) const {
-        return i * in_spec_.num_channels() + ch_offset;
-    }
-
     bool alloc_frames_(FrameFactory& frame_factory);
+    bool alloc_coeffs_();
 
     bool check_config_() const;
 
     bool fill_sinc_();
     sample_t sinc_(fixedpoint_t x, float fract_x);
-
-    // Computes single sample of the particular audio channel.
-    // channel_offset a serial number of the channel
-    // (e.g. left -- 0, right -- 1, etc.).
-    sample_t resample_(size_t channel_offset);
+    int32_t sinc_(fixedpoint_t x, int32_t fract_x);
+
+    // Converts just pushed input frame to fixed point.
+    void convert_input_(size_t frame_index);
+
+    // Copies just pushed input frame to contiguous buffer.
+    void copy_input_(size_t frame_index);
+
+    // Builds polyphase filter bank for given nominal rates.
+    bool build_bank_(size_t input_rate, size_t output_rate);
+
+    // Computes single output frame, i.e. one sample for every channel.
+    void resample_(sample_t* out_frame);
+    void resample_fixed_(sample_t* out_frame);
+    void resample_polyphase_(sample_t* out_frame);
+
+    // Computes sinc coefficients for the window around current position.
+    // Fills bounds of the window in every input frame.
+    // Coeff is sample_t for float mode and int32_t for fixed mode.
+    template <class Coeff>
+    size_t compute_coeffs_(Coeff* coeffs,
+                           size_t& ind_begin_prev,
+                           size_t& ind_begin_cur,
+                           size_t& ind_end_cur,
+                           size_t& ind_end_next);
+
+    // Adds n_coeffs input samples of every channel multiplied by coefficients.
+    void apply_coeffs_(sample_t* out_frame,
+                       const sample_t* in_frame,
+                       const sample_t* coeffs,
+                       size_t n_coeffs) const;
+    void apply_coeffs_(int64_t* out_frame,
+                       const int16_t* in_frame,
+                       const int32_t* coeffs,
+                       size_t n_coeffs) const;
 
     const SampleSpec in_spec_;
     const SampleSpec out_spec_;
 
+    const BuiltinResamplerArith arith_;
+
+    // frames_[frame_order_[0]] is previous frame, then current and next
     core::Slice<sample_t> frames_[3];
+    size_t frame_order_[3];
     size_t n_ready_frames_;
 
     const sample_t* prev_frame_;
@@ -114,9 +188,36 @@ private:
     const size_t frame_size_ch_;
     const size_t frame_size_;
 
-    core::Array<sample_t> sinc_table_;
+    // shared immutable table from SincTableCache
     const sample_t* sinc_table_ptr_;
 
+    // sinc coefficients for current window, shared by all channels
+    core::Array<sample_t> coeffs_;
+
+    // fixed-point mode: shared Q1.30 sinc table, Q1.15 copies of input
+    // frames (rotated together with frames_), Q1.30 coefficients for
+    // current window, and per-channel accumulators
+    const int32_t* fixed_sinc_table_ptr_;
+    core::Array<int16_t> fixed_frames_buf_;
+    int16_t* fixed_frames_[3];
+    core::Array<int32_t> fixed_coeffs_;
+    core::Array<int64_t> fixed_accum_;
+
+    // fixed-point mode: Q1.30 gain applied to coefficients when upscaling
+    int32_t fixed_gain_;
+
+    // polyphase mode: (window_interp_ + 1) rows of bank_taps_ coefficients,
+    // row N is for output position with fractional part N / window_interp_;
+    // first tap of each row is bank_half_ - 1 samples before output position
+    core::Array<sample_t> bank_;
+    size_t bank_taps_;
+    size_t bank_half_;
+    size_t bank_in_rate_;
+    size_t bank_out_rate_;
+
+    // polyphase mode: previous, current, and next frames, one after another
+    core::Array<sample_t> poly_frames_;
+
     // half window len in Q8.24 in terms of input signal
     fixedpoint_t qt_half_window_size_;
     const fixedpoint_t qt_epsilon_;
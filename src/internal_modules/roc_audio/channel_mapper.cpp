@@ -77,24 +77,95 @@ void ChannelMapper::map(const sample_t* in_samples,
 // Map between two surround channel sets.
 // Each output channel is a sum of input channels multiplied by coefficients
 // from the mapping matrix.
+//
+// Samples are processed in chunks. Input chunk is first converted to planar
+// layout, so that every channel is contiguous. Then every output channel is
+// accumulated over whole chunk, one input channel at a time, which compiler
+// can vectorize, and zero coefficients (most of the matrix, for large channel
+// sets) are skipped. Summation order is the same as in per-sample loop.
 void ChannelMapper::map_surround_surround_(const sample_t* in_samples,
                                            sample_t* out_samples,
                                            size_t n_samples) {
+    const size_t in_n = in_chans_.num_channels();
+    const size_t out_n = out_chans_.num_channels();
+
+    roc_panic_if(in_n > ChanPos_Max);
+
+    while (n_samples > 0) {
+        const size_t chunk_size = std::min(n_samples, (size_t)PlanarChunkSize);
+
+        for (size_t ns = 0; ns < chunk_size; ns++) {
+            for (size_t in_ch = 0; in_ch < in_n; in_ch++) {
+                in_planes_[in_ch * PlanarChunkSize + ns] = in_samples[in_ch];
+            }
+            in_samples += in_n;
+        }
+
+        for (size_t out_ch = 0; out_ch < out_n; out_ch++) {
+            for (size_t ns = 0; ns < chunk_size; ns++) {
+                out_plane_[ns] = 0;
+            }
+
+            for (size_t in_ch = 0; in_ch < in_n; in_ch++) {
+                const sample_t coeff = map_matrix_.coeff(out_ch, in_ch);
+                if (coeff == 0) {
+                    continue;
+                }
+
+                const sample_t* in_plane = in_planes_ + in_ch * PlanarChunkSize;
+
+                for (size_t ns = 0; ns < chunk_size; ns++) {
+                    out_plane_[ns] += in_plane[ns] * coeff;
+                }
+            }
+
+            for (size_t ns = 0; ns < chunk_size; ns++) {
+                sample_t out_s = out_plane_[ns];
+
+                out_s = std::min(out_s, Sample_Max);
+                out_s = std::max(out_s, Sample_Min);
+
+                out_samples[ns * out_n + out_ch] = out_s;
+            }
+        }
+
+        out_samples += chunk_size * out_n;
+        n_samples -= chunk_size;
+    }
+}
+
+// Same as map_surround_surround_(), but specialized for fixed number of
+// input and output channels. Used for the most common layouts: with loop
+// bounds known at compile time, compiler unrolls inner loops and keeps
+// coefficients in registers.
+template <size_t InChans, size_t OutChans>
+void ChannelMapper::map_surround_surround_fixed_(const sample_t* in_samples,
+                                                 sample_t* out_samples,
+                                                 size_t n_samples) {
+    sample_t coeffs[OutChans][InChans];
+
+    for (size_t out_ch = 0; out_ch < OutChans; out_ch++) {
+        for (size_t in_ch = 0; in_ch < InChans; in_ch++) {
+            coeffs[out_ch][in_ch] = map_matrix_.coeff(out_ch, in_ch);
+        }
+    }
+
     for (size_t ns = 0; ns < n_samples; ns++) {
-        for (size_t out_ch = 0; out_ch < out_chans_.num_channels(); out_ch++) {
+        for (size_t out_ch = 0; out_ch < OutChans; out_ch++) {
             sample_t out_s = 0;
 
-            for (size_t in_ch = 0; in_ch < in_chans_.num_channels(); in_ch++) {
-                out_s += in_samples[in_ch] * map_matrix_.coeff(out_ch, in_ch);
+            for (size_t in_ch = 0; in_ch < InChans; in_ch++) {
+                out_s += in_samples[in_ch] * coeffs[out_ch][in_ch];
             }
 
             out_s = std::min(out_s, Sample_Max);
             out_s = std::max(out_s, Sample_Min);
 
-            *out_samples++ = out_s;
+            out_samples[out_ch] = out_s;
         }
 
-        in_samples += in_chans_.num_channels();
+        in_samples += InChans;
+        out_samples += OutChans;
     }
 }
 
@@ -161,7 +232,7 @@ void ChannelMapper::setup_map_func_() {
             break;
 
         case ChanLayout_Surround:
-            map_func_ = &ChannelMapper::map_surround_surround_;
+            map_func_ = select_surround_surround_func_();
             break;
 
         case ChanLayout_Multitrack:
@@ -191,5 +262,38 @@ void ChannelMapper::setup_map_func_() {
     }
 }
 
+ChannelMapper::map_func_t ChannelMapper::select_surround_surround_func_() const {
+    const size_t in_n = in_chans_.num_channels();
+    const size_t out_n = out_chans_.num_channels();
+
+    // mono <=> stereo
+    if (in_n == 1 && out_n == 2) {
+        return &ChannelMapper::map_surround_surround_fixed_<1, 2>;
+    }
+    if (in_n == 2 && out_n == 1) {
+        return &ChannelMapper::map_surround_surround_fixed_<2, 1>;
+    }
+    // stereo => stereo (e.g. different order)
+    if (in_n == 2 && out_n == 2) {
+        return &ChannelMapper::map_surround_surround_fixed_<2, 2>;
+    }
+    // 6 channels (e.g. 5.1) <=> stereo, mono => 6 channels
+    if (in_n == 6 && out_n == 2) {
+        return &ChannelMapper::map_surround_surround_fixed_<6, 2>;
+    }
+    if (in_n == 2 && out_n == 6) {
+        return &ChannelMapper::map_surround_surround_fixed_<2, 6>;
+    }
+    if (in_n == 1 && out_n == 6) {
+        return &ChannelMapper::map_surround_surround_fixed_<1, 6>;
+    }
+    // 8 channels (e.g. 7.1) => stereo
+    if (in_n == 8 && out_n == 2) {
+        return &ChannelMapper::map_surround_surround_fixed_<8, 2>;
+    }
+
+    return &ChannelMapper::map_surround_surround_;
+}
+
 } // namespace audio
 } // namespace roc
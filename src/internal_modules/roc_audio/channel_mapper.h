@@ -39,6 +39,12 @@ public:
              size_t n_out_samples);
 
 private:
+    enum {
+        // Number of samples per channel processed at once by generic
+        // surround kernel.
+        PlanarChunkSize = 64
+    };
+
     typedef void (ChannelMapper::*map_func_t)(const sample_t* in_samples,
                                               sample_t* out_samples,
                                               size_t n_samples);
@@ -46,6 +52,10 @@ private:
     void map_surround_surround_(const sample_t* in_samples,
                                 sample_t* out_samples,
                                 size_t n_samples);
+    template <size_t InChans, size_t OutChans>
+    void map_surround_surround_fixed_(const sample_t* in_samples,
+                                      sample_t* out_samples,
+                                      size_t n_samples);
     void map_multitrack_surround_(const sample_t* in_samples,
                                   sample_t* out_samples,
                                   size_t n_samples);
@@ -54,6 +64,7 @@ private:
                                     size_t n_samples);
 
     void setup_map_func_();
+    map_func_t select_surround_surround_func_() const;
 
     const ChannelSet in_chans_;
     const ChannelSet out_chans_;
@@ -63,6 +74,10 @@ private:
 
     // use for surround <=> surround mapping
     ChannelMapperMatrix map_matrix_;
+
+    // use for surround <=> surround mapping by generic kernel
+    sample_t in_planes_[ChanPos_Max * PlanarChunkSize];
+    sample_t out_plane_[PlanarChunkSize];
 };
 
 } // namespace audio
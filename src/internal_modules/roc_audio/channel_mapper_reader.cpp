@@ -67,7 +67,7 @@ bool ChannelMapperReader::read(Frame& out_frame) {
     sample_t* out_samples = out_frame.raw_samples();
     size_t n_samples = out_frame.num_raw_samples() / out_spec_.num_channels();
 
-    unsigned flags = 0;
+    unsigned flags = Frame::FlagSilent;
 
     size_t frames_counter = 0;
     while (n_samples != 0) {
@@ -101,11 +101,16 @@ bool ChannelMapperReader::read_(sample_t* out_samples,
         return false;
     }
 
-    mapper_.map(in_frame.raw_samples(), in_frame.num_raw_samples(), out_samples,
-                n_samples * out_spec_.num_channels());
+    if (in_frame.flags() & Frame::FlagSilent) {
+        // Any mapping of zeros is zeros.
+        memset(out_samples, 0, n_samples * out_spec_.num_channels() * sizeof(sample_t));
+    } else {
+        mapper_.map(in_frame.raw_samples(), in_frame.num_raw_samples(), out_samples,
+                    n_samples * out_spec_.num_channels());
+    }
 
     capt_ts = in_frame.capture_timestamp();
-    flags |= in_frame.flags();
+    flags = Frame::combine_flags(flags, in_frame.flags());
 
     return true;
 }
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/clock_group.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+ClockGroup::ClockGroup(core::IArena& arena)
+    : core::RefCounted<ClockGroup, core::ArenaAllocation>(arena)
+    , leader_(NULL) {
+}
+
+ClockGroup::Role ClockGroup::claim(const LatencyTuner* tuner, LatencyTunerState& state) {
+    roc_panic_if(!tuner);
+
+    core::Mutex::Lock lock(mutex_);
+
+    state = state_;
+
+    if (leader_ == tuner) {
+        return Role_Leader;
+    }
+
+    if (!leader_) {
+        roc_log(LogDebug, "clock group: selected new leader: has_state=%d",
+                (int)(state_.freq_coeff > 0));
+
+        leader_ = tuner;
+        return Role_NewLeader;
+    }
+
+    return Role_Follower;
+}
+
+void ClockGroup::publish(const LatencyTuner* tuner, const LatencyTunerState& state) {
+    roc_panic_if(!tuner);
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (leader_ != tuner) {
+        return;
+    }
+
+    state_ = state;
+}
+
+void ClockGroup::leave(const LatencyTuner* tuner) {
+    roc_panic_if(!tuner);
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (leader_ == tuner) {
+        roc_log(LogDebug, "clock group: leader left group");
+        leader_ = NULL;
+    }
+}
+
+} // namespace audio
+} // namespace roc
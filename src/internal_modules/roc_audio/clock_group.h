@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/clock_group.h
+//! @brief Clock group.
+
+#ifndef ROC_AUDIO_CLOCK_GROUP_H_
+#define ROC_AUDIO_CLOCK_GROUP_H_
+
+#include "roc_audio/latency_tuner.h"
+#include "roc_core/allocation_policy.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/ref_counted.h"
+
+namespace roc {
+namespace audio {
+
+//! Clock group.
+//!
+//! Streams captured using the same clock, e.g. channels of one sound card sent
+//! as separate streams, drift relative to receiver clock in the same way. Their
+//! latency tuners can join one group and share one clock drift estimate:
+//!  - the first tuner becomes leader; it runs frequency estimator and publishes
+//!    its state and scaling factor to the group
+//!  - other tuners become followers; instead of running their own estimator,
+//!    they apply scaling published by leader, so that all streams are
+//!    resampled identically and stay sample-aligned
+//!  - when leader leaves, the next tuner that updates scaling becomes leader
+//!    and continues from the last published state
+//!
+//! Tuners of one group may be used from different threads.
+class ClockGroup : public core::RefCounted<ClockGroup, core::ArenaAllocation> {
+public:
+    //! Role of tuner in group.
+    enum Role {
+        //! Tuner is leader and should compute scaling.
+        Role_Leader,
+
+        //! Tuner has just become leader and should continue from
+        //! published state before computing scaling.
+        Role_NewLeader,
+
+        //! Tuner should apply published scaling.
+        Role_Follower
+    };
+
+    //! Initialize.
+    explicit ClockGroup(core::IArena& arena);
+
+    //! Get role of tuner and last published state.
+    //! @remarks
+    //!  If group has no leader, @p tuner becomes leader.
+    Role claim(const LatencyTuner* tuner, LatencyTunerState& state);
+
+    //! Publish state computed by leader.
+    //! @remarks
+    //!  Ignored if @p tuner is not leader.
+    void publish(const LatencyTuner* tuner, const LatencyTunerState& state);
+
+    //! Leave group.
+    //! @remarks
+    //!  If @p tuner was leader, group remains without leader until
+    //!  another tuner claims role.
+    void leave(const LatencyTuner* tuner);
+
+private:
+    core::Mutex mutex_;
+
+    const LatencyTuner* leader_;
+    LatencyTunerState state_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_CLOCK_GROUP_H_
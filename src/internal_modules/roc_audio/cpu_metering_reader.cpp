@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/cpu_metering_reader.h"
+#include "roc_core/fast_clock.h"
+
+namespace roc {
+namespace audio {
+
+CpuMeteringReader::CpuMeteringReader(IFrameReader& reader, core::CpuMeter& meter)
+    : reader_(reader)
+    , meter_(meter) {
+}
+
+bool CpuMeteringReader::read(Frame& frame) {
+    meter_.begin(core::fast_timestamp());
+    const bool ret = reader_.read(frame);
+    meter_.end(core::fast_timestamp());
+
+    return ret;
+}
+
+} // namespace audio
+} // namespace roc
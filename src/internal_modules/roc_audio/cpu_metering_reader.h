@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/cpu_metering_reader.h
+//! @brief CPU metering frame reader.
+
+#ifndef ROC_AUDIO_CPU_METERING_READER_H_
+#define ROC_AUDIO_CPU_METERING_READER_H_
+
+#include "roc_audio/iframe_reader.h"
+#include "roc_core/cpu_meter.h"
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace audio {
+
+//! CPU metering frame reader.
+//! Reports time spent in underlying reader to CpuMeter.
+class CpuMeteringReader : public IFrameReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    CpuMeteringReader(IFrameReader& reader, core::CpuMeter& meter);
+
+    //! Read audio frame.
+    virtual bool read(Frame& frame);
+
+private:
+    IFrameReader& reader_;
+    core::CpuMeter& meter_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_CPU_METERING_READER_H_
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/cpu_metering_writer.h"
+#include "roc_core/fast_clock.h"
+
+namespace roc {
+namespace audio {
+
+CpuMeteringWriter::CpuMeteringWriter(IFrameWriter& writer, core::CpuMeter& meter)
+    : writer_(writer)
+    , meter_(meter) {
+}
+
+void CpuMeteringWriter::write(Frame& frame) {
+    meter_.begin(core::fast_timestamp());
+    writer_.write(frame);
+    meter_.end(core::fast_timestamp());
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/cpu_metering_writer.h
+//! @brief CPU metering frame writer.
+
+#ifndef ROC_AUDIO_CPU_METERING_WRITER_H_
+#define ROC_AUDIO_CPU_METERING_WRITER_H_
+
+#include "roc_audio/iframe_writer.h"
+#include "roc_core/cpu_meter.h"
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace audio {
+
+//! CPU metering frame writer.
+//! Reports time spent in underlying writer to CpuMeter.
+class CpuMeteringWriter : public IFrameWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    CpuMeteringWriter(IFrameWriter& writer, core::CpuMeter& meter);
+
+    //! Write audio frame.
+    virtual void write(Frame& frame);
+
+private:
+    IFrameWriter& writer_;
+    core::CpuMeter& meter_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_CPU_METERING_WRITER_H_
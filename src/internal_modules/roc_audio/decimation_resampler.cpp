@@ -21,8 +21,13 @@ namespace {
 
 const core::nanoseconds_t LogReportInterval = 20 * core::Second;
 
+// Number of samples per channel in input frame pushed by caller.
+// Also defines how often we can insert or remove a sample.
 const size_t InputFrameSize = 16;
 
+// Maximum number of samples per channel requested from inner resampler at once.
+const size_t InnerFrameSize = 256;
+
 } // namespace
 
 DecimationResampler::DecimationResampler(
@@ -40,6 +45,7 @@ DecimationResampler::DecimationResampler(
     , num_ch_(in_spec.num_channels())
     , in_size_(0)
     , in_pos_(0)
+    , in_frame_end_(0)
     , out_acc_(0)
     , total_count_(0)
     , decim_count_(0)
@@ -75,14 +81,21 @@ DecimationResampler::DecimationResampler(
         return;
     }
 
-    in_buf_ = frame_factory.new_raw_buffer();
+    // Output of inner resampler is fetched in larger chunks, to reduce number
+    // of calls to inner resampler. Input from caller uses only beginning of
+    // the buffer.
+    const size_t in_buf_size =
+        std::min(InnerFrameSize, frame_factory.raw_buffer_size() / num_ch_) * num_ch_;
+
+    in_buf_ = frame_factory.new_raw_buffer(in_buf_size);
     if (!in_buf_) {
         roc_log(LogError, "decimation resampler: can't allocate temporary buffer");
         return;
     }
-    in_buf_.reslice(0, InputFrameSize * num_ch_);
+    in_buf_.reslice(0, in_buf_size);
+    in_frame_ = in_buf_.subslice(0, InputFrameSize * num_ch_);
 
-    last_buf_ = frame_factory.new_raw_buffer();
+    last_buf_ = frame_factory.new_raw_buffer(num_ch_);
     if (!last_buf_) {
         roc_log(LogError, "decimation resampler: can't allocate temporary buffer");
         return;
@@ -110,7 +123,7 @@ bool DecimationResampler::set_scaling(size_t input_rate,
         || multiplier <= 0
         // no more than num_ch insertions/removals per input frame,
         // because we insert or remove only one sample per time
-        || std::abs(in_buf_.size() / multiplier - in_buf_.size()) > num_ch_) {
+        || std::abs(in_frame_.size() / multiplier - in_frame_.size()) > num_ch_) {
         roc_log(LogError,
                 "decimation resampler:"
                 " scaling out of range: in_rate=%lu out_rate=%lu mult=%e",
@@ -145,7 +158,7 @@ const core::Slice<sample_t>& DecimationResampler::begin_push_input() {
     }
 
     // return our buffer
-    return in_buf_;
+    return in_frame_;
 }
 
 void DecimationResampler::end_push_input() {
@@ -158,9 +171,9 @@ void DecimationResampler::end_push_input() {
     }
 
     // start reading from our buffer
-    in_size_ = in_buf_.size();
+    in_size_ = in_frame_.size();
     in_pos_ = 0;
-    out_acc_ += in_size_ / multiplier_;
+    in_frame_end_ = 0;
 }
 
 size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
@@ -171,7 +184,7 @@ size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
     while (out_pos < out_size) {
         // self-check
         roc_panic_if_not(in_size_ % num_ch_ == 0 && in_pos_ % num_ch_ == 0
-                         && in_pos_ <= in_size_);
+                         && in_pos_ <= in_size_ && in_frame_end_ <= in_size_);
         roc_panic_if_not(out_size % num_ch_ == 0 && out_pos % num_ch_ == 0
                          && out_pos <= out_size);
 
@@ -180,7 +193,7 @@ size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
             // try to refill our buffer and start reading from it
             in_size_ = inner_resampler_->pop_output(in_buf_.data(), in_buf_.size());
             in_pos_ = 0;
-            out_acc_ += in_size_ / multiplier_;
+            in_frame_end_ = 0;
         }
 
         if (in_pos_ == in_size_) {
@@ -189,7 +202,16 @@ size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
             break;
         }
 
-        if (floorf(out_acc_) >= float(in_size_ - in_pos_) + num_ch_) {
+        if (in_pos_ == in_frame_end_) {
+            // start next input frame
+            // if inner resampler returned a large chunk, we split it into frames
+            // of the same size as pushed by caller, so that decimation is applied
+            // evenly regardless of the chunk size
+            in_frame_end_ = std::min(in_pos_ + in_frame_.size(), in_size_);
+            out_acc_ += (in_frame_end_ - in_pos_) / multiplier_;
+        }
+
+        if (floorf(out_acc_) >= float(in_frame_end_ - in_pos_) + num_ch_) {
             // accumulator is ahead of input by at least num_ch samples
             // duplicate num_ch input samples to compensate
             memcpy(out_data + out_pos, last_buf_.data(), num_ch_ * sizeof(sample_t));
@@ -197,7 +219,7 @@ size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
             out_acc_ -= num_ch_;
             // for reports
             decim_count_ += num_ch_;
-        } else if (ceilf(out_acc_) <= float(in_size_ - in_pos_) - num_ch_) {
+        } else if (ceilf(out_acc_) <= float(in_frame_end_ - in_pos_) - num_ch_) {
             // accumulator is behind of input by at least num_ch samples
             // skip num_ch input samples to compensate
             in_pos_ += num_ch_;
@@ -206,7 +228,7 @@ size_t DecimationResampler::pop_output(sample_t* out_data, size_t out_size) {
         }
 
         // copy input samples to output
-        const size_t copy_size = std::min(in_size_ - in_pos_, out_size - out_pos);
+        const size_t copy_size = std::min(in_frame_end_ - in_pos_, out_size - out_pos);
 
         if (copy_size != 0) {
             roc_panic_if_not(copy_size % num_ch_ == 0);
@@ -89,8 +89,10 @@ private:
     const size_t num_ch_;
 
     core::Slice<sample_t> in_buf_;
+    core::Slice<sample_t> in_frame_;
     size_t in_size_;
     size_t in_pos_;
+    size_t in_frame_end_;
 
     float out_acc_;
 
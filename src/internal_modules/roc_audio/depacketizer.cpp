@@ -10,6 +10,7 @@
 #include "roc_audio/sample_spec_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/singleton.h"
 #include "roc_core/stddefs.h"
 #include "roc_status/code_to_str.h"
 
@@ -24,28 +25,78 @@ inline void write_zeros(sample_t* buf, size_t bufsz) {
     memset(buf, 0, bufsz * sizeof(sample_t));
 }
 
+// 880Hz tone at 44100Hz repeats every 44100 / gcd(44100, 880) = 2205 samples.
+enum { BeepPeriod = 2205 };
+
+// One period of beep tone, so that beep can be produced by bulk copying
+// instead of computing sine for every sample.
+class BeepTable : public core::NonCopyable<> {
+public:
+    static const BeepTable& instance() {
+        return core::Singleton<BeepTable>::instance();
+    }
+
+    const sample_t* samples() const {
+        return samples_;
+    }
+
+private:
+    friend class core::Singleton<BeepTable>;
+
+    BeepTable() {
+        for (size_t n = 0; n < BeepPeriod; n++) {
+            samples_[n] = (sample_t)std::sin(2 * M_PI / 44100 * 880 * n);
+        }
+    }
+
+    sample_t samples_[BeepPeriod];
+};
+
 inline void write_beep(sample_t* buf, size_t bufsz) {
-    for (size_t n = 0; n < bufsz; n++) {
-        buf[n] = (sample_t)std::sin(2 * M_PI / 44100 * 880 * n);
+    const sample_t* table = BeepTable::instance().samples();
+
+    while (bufsz != 0) {
+        const size_t n = std::min(bufsz, (size_t)BeepPeriod);
+        memcpy(buf, table, n * sizeof(sample_t));
+        buf += n;
+        bufsz -= n;
     }
 }
 
+inline void prefetch_payload(const packet::Packet& packet) {
+#if defined(__GNUC__)
+    __builtin_prefetch(packet.payload().data());
+#else
+    (void)packet;
+#endif
+}
+
 } // namespace
 
 Depacketizer::Depacketizer(packet::IReader& reader,
                            IFrameDecoder& payload_decoder,
                            const SampleSpec& sample_spec,
-                           bool beep)
+                           bool beep,
+                           LossConcealer* concealer)
     : reader_(reader)
     , payload_decoder_(payload_decoder)
     , sample_spec_(sample_spec)
+    , batch_head_(0)
+    , batch_size_(0)
     , stream_ts_(0)
     , next_capture_ts_(0)
     , valid_capture_ts_(false)
     , zero_samples_(0)
     , missing_samples_(0)
     , packet_samples_(0)
+    , silence_samples_(0)
+    , concealed_samples_(0)
+    , prev_seqnum_(0)
+    , has_prev_seqnum_(false)
+    , seqnum_continuous_(false)
     , rate_limiter_(LogInterval)
+    , concealer_(concealer)
+    , concealment_enabled_(true)
     , beep_(beep)
     , first_packet_(true)
     , valid_(false) {
@@ -67,6 +118,19 @@ bool Depacketizer::is_started() const {
     return !first_packet_;
 }
 
+uint64_t Depacketizer::concealed_samples() const {
+    return concealed_samples_;
+}
+
+void Depacketizer::set_concealment(bool enabled) {
+    if (concealer_ && enabled && !concealment_enabled_) {
+        // History wasn't updated while concealment was disabled.
+        concealer_->reset();
+    }
+
+    concealment_enabled_ = enabled;
+}
+
 packet::stream_timestamp_t Depacketizer::next_timestamp() const {
     if (first_packet_) {
         return 0;
@@ -93,6 +157,15 @@ void Depacketizer::read_frame_(Frame& frame) {
     FrameInfo info;
 
     while (buff_ptr < buff_end) {
+        if (!packet_ && !first_packet_) {
+            // Fast path for packets following each other without gaps.
+            sample_t* new_buff_ptr = read_batch_(buff_ptr, buff_end, info);
+            if (new_buff_ptr != buff_ptr) {
+                buff_ptr = new_buff_ptr;
+                continue;
+            }
+        }
+
         buff_ptr = read_samples_(buff_ptr, buff_end, info);
     }
 
@@ -100,6 +173,108 @@ void Depacketizer::read_frame_(Frame& frame) {
     set_frame_props_(frame, info);
 }
 
+sample_t*
+Depacketizer::read_batch_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info) {
+    const size_t num_channels = sample_spec_.num_channels();
+
+    fetch_batch_((size_t)(buff_end - buff_ptr) / num_channels);
+
+    sample_t* const decoded_ptr = buff_ptr;
+
+    while (buff_ptr < buff_end && batch_head_ < batch_size_) {
+        const packet::Packet& packet = *batch_[batch_head_];
+
+        // Anything except next packet is left for read_samples_().
+        if (packet.stream_timestamp() != stream_ts_) {
+            break;
+        }
+
+        payload_decoder_.begin(packet.stream_timestamp(), packet.payload().data(),
+                               packet.payload().size());
+
+        if (payload_decoder_.position() != stream_ts_) {
+            payload_decoder_.end();
+            break;
+        }
+
+        if (batch_head_ + 1 < batch_size_) {
+            prefetch_payload(*batch_[batch_head_ + 1]);
+        }
+
+        update_seqnum_(packet);
+
+        next_capture_ts_ = packet.capture_timestamp();
+        if (!valid_capture_ts_ && !!next_capture_ts_) {
+            valid_capture_ts_ = true;
+        }
+
+        const size_t requested_samples = (size_t)(buff_end - buff_ptr) / num_channels;
+        const size_t decoded_samples = payload_decoder_.read(buff_ptr, requested_samples);
+        const size_t n_samples = decoded_samples * num_channels;
+
+        if (n_samples && !info.capture_ts && valid_capture_ts_) {
+            info.capture_ts = next_capture_ts_
+                - sample_spec_.samples_overall_2_ns(info.n_filled_samples);
+        }
+        if (valid_capture_ts_) {
+            next_capture_ts_ += sample_spec_.samples_overall_2_ns(n_samples);
+        }
+
+        info.n_decoded_samples += n_samples;
+        info.n_filled_samples += n_samples;
+
+        stream_ts_ += (packet::stream_timestamp_t)decoded_samples;
+        packet_samples_ += (packet::stream_timestamp_t)decoded_samples;
+
+        buff_ptr += n_samples;
+
+        if (decoded_samples < requested_samples) {
+            payload_decoder_.end();
+        } else {
+            // Frame is full, rest of packet goes to next frame.
+            packet_ = batch_[batch_head_];
+        }
+
+        batch_[batch_head_++] = NULL;
+    }
+
+    if (concealer_ && concealment_enabled_ && buff_ptr != decoded_ptr) {
+        concealer_->write(decoded_ptr, (size_t)(buff_ptr - decoded_ptr) / num_channels);
+    }
+
+    return buff_ptr;
+}
+
+void Depacketizer::fetch_batch_(size_t n_samples) {
+    if (batch_head_ != batch_size_) {
+        // Previous batch is not consumed yet.
+        return;
+    }
+
+    batch_head_ = 0;
+    batch_size_ = 0;
+
+    // Fetch only packets needed for current frame, so that packets arriving
+    // later can still be reordered by reader.
+    size_t n_fetched = 0;
+
+    while (n_fetched < n_samples && batch_size_ < MaxBatchPackets) {
+        packet::PacketPtr pp = fetch_packet_();
+        if (!pp) {
+            break;
+        }
+
+        prefetch_payload(*pp);
+
+        batch_[batch_size_++] = pp;
+
+        if (pp->duration() == 0) {
+            break;
+        }
+        n_fetched += pp->duration();
+    }
+}
+
 sample_t*
 Depacketizer::read_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info) {
     update_packet_(info);
@@ -116,7 +291,13 @@ Depacketizer::read_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& i
             const size_t max_samples = (size_t)(buff_end - buff_ptr);
             const size_t n_samples = std::min(mis_samples, max_samples);
 
-            buff_ptr = read_missing_samples_(buff_ptr, buff_ptr + n_samples);
+            if (seqnum_continuous_) {
+                // No packets were lost, sender suppressed silence.
+                buff_ptr = read_silence_samples_(buff_ptr, buff_ptr + n_samples, info);
+                info.n_silence_samples += n_samples;
+            } else {
+                buff_ptr = read_missing_samples_(buff_ptr, buff_ptr + n_samples, info);
+            }
 
             //           next_capture_ts_
             //           next_timestamp
@@ -162,7 +343,7 @@ Depacketizer::read_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& i
         }
 
         info.n_filled_samples += n_samples;
-        return read_missing_samples_(buff_ptr, buff_end);
+        return read_missing_samples_(buff_ptr, buff_end, info);
     }
 }
 
@@ -175,6 +356,10 @@ sample_t* Depacketizer::read_packet_samples_(sample_t* buff_ptr, sample_t* buff_
     stream_ts_ += (packet::stream_timestamp_t)decoded_samples;
     packet_samples_ += (packet::stream_timestamp_t)decoded_samples;
 
+    if (concealer_ && concealment_enabled_) {
+        concealer_->write(buff_ptr, decoded_samples);
+    }
+
     if (decoded_samples < requested_samples) {
         payload_decoder_.end();
         packet_ = NULL;
@@ -183,14 +368,32 @@ sample_t* Depacketizer::read_packet_samples_(sample_t* buff_ptr, sample_t* buff_
     return (buff_ptr + decoded_samples * sample_spec_.num_channels());
 }
 
-sample_t* Depacketizer::read_missing_samples_(sample_t* buff_ptr, sample_t* buff_end) {
+sample_t* Depacketizer::read_missing_samples_(sample_t* buff_ptr,
+                                              sample_t* buff_end,
+                                              FrameInfo& info) {
     const size_t num_samples =
         (size_t)(buff_end - buff_ptr) / sample_spec_.num_channels();
 
     if (beep_) {
         write_beep(buff_ptr, num_samples * sample_spec_.num_channels());
     } else {
-        write_zeros(buff_ptr, num_samples * sample_spec_.num_channels());
+        // Before first packet, decoder has nothing to extrapolate from.
+        size_t n_concealed =
+            first_packet_ ? 0 : payload_decoder_.conceal(buff_ptr, num_samples);
+        roc_panic_if_not(n_concealed <= num_samples);
+
+        if (concealer_ && concealment_enabled_ && !first_packet_
+            && n_concealed == 0) {
+            n_concealed = concealer_->conceal(buff_ptr, num_samples);
+            roc_panic_if_not(n_concealed <= num_samples);
+        }
+
+        concealed_samples_ += n_concealed;
+
+        write_zeros(buff_ptr + n_concealed * sample_spec_.num_channels(),
+                    (num_samples - n_concealed) * sample_spec_.num_channels());
+
+        info.n_zero_samples += (num_samples - n_concealed) * sample_spec_.num_channels();
     }
 
     stream_ts_ += (packet::stream_timestamp_t)num_samples;
@@ -204,6 +407,27 @@ sample_t* Depacketizer::read_missing_samples_(sample_t* buff_ptr, sample_t* buff
     return (buff_ptr + num_samples * sample_spec_.num_channels());
 }
 
+sample_t* Depacketizer::read_silence_samples_(sample_t* buff_ptr,
+                                              sample_t* buff_end,
+                                              FrameInfo& info) {
+    const size_t num_samples =
+        (size_t)(buff_end - buff_ptr) / sample_spec_.num_channels();
+
+    write_zeros(buff_ptr, num_samples * sample_spec_.num_channels());
+
+    info.n_zero_samples += num_samples * sample_spec_.num_channels();
+
+    if (concealer_) {
+        // Don't repeat signal preceding silence on next loss.
+        concealer_->reset();
+    }
+
+    stream_ts_ += (packet::stream_timestamp_t)num_samples;
+    silence_samples_ += (packet::stream_timestamp_t)num_samples;
+
+    return (buff_ptr + num_samples * sample_spec_.num_channels());
+}
+
 void Depacketizer::update_packet_(FrameInfo& info) {
     if (packet_) {
         return;
@@ -213,6 +437,8 @@ void Depacketizer::update_packet_(FrameInfo& info) {
     unsigned n_dropped = 0;
 
     while ((packet_ = read_packet_())) {
+        update_seqnum_(*packet_);
+
         payload_decoder_.begin(packet_->stream_timestamp(), packet_->payload().data(),
                                packet_->payload().size());
 
@@ -277,6 +503,17 @@ void Depacketizer::update_packet_(FrameInfo& info) {
 }
 
 packet::PacketPtr Depacketizer::read_packet_() {
+    if (batch_head_ < batch_size_) {
+        // Packet was fetched by read_batch_(), but not decoded there.
+        packet::PacketPtr pp = batch_[batch_head_];
+        batch_[batch_head_++] = NULL;
+        return pp;
+    }
+
+    return fetch_packet_();
+}
+
+packet::PacketPtr Depacketizer::fetch_packet_() {
     packet::PacketPtr pp;
     const status::StatusCode code = reader_.read(pp);
     if (code != status::StatusOK) {
@@ -292,14 +529,31 @@ packet::PacketPtr Depacketizer::read_packet_() {
     return pp;
 }
 
+void Depacketizer::update_seqnum_(const packet::Packet& packet) {
+    const packet::RTP* rtp = packet.rtp();
+    if (!rtp) {
+        seqnum_continuous_ = false;
+        return;
+    }
+
+    seqnum_continuous_ = has_prev_seqnum_
+        && packet::seqnum_diff(rtp->seqnum, prev_seqnum_) == 1;
+
+    prev_seqnum_ = rtp->seqnum;
+    has_prev_seqnum_ = true;
+}
+
 void Depacketizer::set_frame_props_(Frame& frame, const FrameInfo& info) {
     unsigned flags = 0;
 
-    if (info.n_decoded_samples != 0) {
+    // Intended silence is not a lack of data.
+    const size_t n_samples = info.n_decoded_samples + info.n_silence_samples;
+
+    if (n_samples != 0) {
         flags |= Frame::FlagNotBlank;
     }
 
-    if (info.n_decoded_samples < frame.num_raw_samples()) {
+    if (n_samples < frame.num_raw_samples()) {
         flags |= Frame::FlagNotComplete;
     }
 
@@ -307,6 +561,10 @@ void Depacketizer::set_frame_props_(Frame& frame, const FrameInfo& info) {
         flags |= Frame::FlagPacketDrops;
     }
 
+    if (info.n_zero_samples == frame.num_raw_samples()) {
+        flags |= Frame::FlagSilent;
+    }
+
     frame.set_flags(flags);
     frame.set_duration(frame.num_raw_samples() / sample_spec_.num_channels());
 
@@ -326,8 +584,11 @@ void Depacketizer::report_stats_() {
     const double loss_ratio =
         total_samples != 0 ? (double)missing_samples_ / total_samples : 0.;
 
-    roc_log(LogDebug, "depacketizer: ts=%lu loss_ratio=%.5lf", (unsigned long)stream_ts_,
-            loss_ratio);
+    roc_log(LogDebug,
+            "depacketizer: ts=%lu loss_ratio=%.5lf silence_samples=%lu"
+            " concealed_samples=%lu",
+            (unsigned long)stream_ts_, loss_ratio, (unsigned long)silence_samples_,
+            (unsigned long)concealed_samples_);
 }
 
 } // namespace audio
@@ -14,6 +14,7 @@
 
 #include "roc_audio/iframe_decoder.h"
 #include "roc_audio/iframe_reader.h"
+#include "roc_audio/loss_concealer.h"
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_core/noncopyable.h"
@@ -27,6 +28,21 @@ namespace audio {
 //! @remarks
 //!  Reads packets from a packet reader, decodes samples from packets using a
 //!  decoder, and produces an audio stream.
+//!
+//!  Gap between packets is normally a packet loss and is concealed by decoder.
+//!  If decoder doesn't support concealment (e.g. PCM), the gap may be concealed
+//!  by optional LossConcealer. Otherwise, it's filled with zeros.
+//!  However, if sequence numbers around the gap are continuous, the gap is an
+//!  intended silence produced by sender with DTX, and it's filled with zeros.
+//!  Such silence is not counted as loss and frames are not reported as blank.
+//!
+//!  Frames that are completely filled with zeros, e.g. frames of idle session,
+//!  are marked with Frame::FlagSilent, so that mixer can skip them.
+//!
+//!  When frame is longer than packet, packets covering the frame are fetched
+//!  from reader in one batch, and those following each other without gaps are
+//!  decoded directly into the frame one after another. Gaps, late packets, and
+//!  overlaps are handled on regular per-packet path.
 class Depacketizer : public IFrameReader, public core::NonCopyable<> {
 public:
     //! Initialization.
@@ -36,10 +52,13 @@ public:
     //!  - @p payload_decoder is used to extract samples from packets
     //!  - @p sample_spec describes output frames
     //!  - @p beep enables weird beeps instead of silence on packet loss
+    //!  - @p concealer, if non-null, is used to conceal packet loss when
+    //!    decoder can't do it
     Depacketizer(packet::IReader& reader,
                  IFrameDecoder& payload_decoder,
                  const SampleSpec& sample_spec,
-                 bool beep);
+                 bool beep,
+                 LossConcealer* concealer = NULL);
 
     //! Was depacketizer constructed without errors?
     bool is_valid() const;
@@ -50,6 +69,19 @@ public:
     //! Read audio frame.
     virtual bool read(Frame& frame);
 
+    //! Get number of concealed samples per channel.
+    //! @remarks
+    //!  Counts samples generated in place of lost packets, either by decoder
+    //!  or by concealer.
+    uint64_t concealed_samples() const;
+
+    //! Enable or disable loss concealment.
+    //! @remarks
+    //!  Has effect only if concealer was provided. Enabled by default.
+    //!  Disabling saves CPU, e.g. when pipeline is overloaded; lost samples
+    //!  are then filled with zeros.
+    void set_concealment(bool enabled);
+
     //! Get next timestamp to be rendered.
     //! @pre
     //!  is_started() should return true
@@ -63,6 +95,13 @@ private:
         // Number of samples filled out in the frame.
         size_t n_filled_samples;
 
+        // Number of samples filled with intended silence.
+        size_t n_silence_samples;
+
+        // Number of samples filled with zeros (silence, or loss that
+        // was not concealed).
+        size_t n_zero_samples;
+
         // Number of packets dropped during frame construction.
         size_t n_dropped_packets;
 
@@ -72,20 +111,35 @@ private:
         FrameInfo()
             : n_decoded_samples(0)
             , n_filled_samples(0)
+            , n_silence_samples(0)
+            , n_zero_samples(0)
             , n_dropped_packets(0)
             , capture_ts(0) {
         }
     };
 
+    enum {
+        // Maximum number of packets fetched at once.
+        MaxBatchPackets = 32
+    };
+
     void read_frame_(Frame& frame);
 
+    sample_t* read_batch_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info);
+    void fetch_batch_(size_t n_samples);
+
     sample_t* read_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info);
 
     sample_t* read_packet_samples_(sample_t* buff_ptr, sample_t* buff_end);
-    sample_t* read_missing_samples_(sample_t* buff_ptr, sample_t* buff_end);
+    sample_t*
+    read_missing_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info);
+    sample_t*
+    read_silence_samples_(sample_t* buff_ptr, sample_t* buff_end, FrameInfo& info);
 
     void update_packet_(FrameInfo& info);
     packet::PacketPtr read_packet_();
+    packet::PacketPtr fetch_packet_();
+    void update_seqnum_(const packet::Packet& packet);
 
     void set_frame_props_(Frame& frame, const FrameInfo& info);
 
@@ -98,6 +152,10 @@ private:
 
     packet::PacketPtr packet_;
 
+    packet::PacketPtr batch_[MaxBatchPackets];
+    size_t batch_head_;
+    size_t batch_size_;
+
     packet::stream_timestamp_t stream_ts_;
     core::nanoseconds_t next_capture_ts_;
     bool valid_capture_ts_;
@@ -105,9 +163,18 @@ private:
     packet::stream_timestamp_t zero_samples_;
     packet::stream_timestamp_t missing_samples_;
     packet::stream_timestamp_t packet_samples_;
+    packet::stream_timestamp_t silence_samples_;
+    uint64_t concealed_samples_;
+
+    packet::seqnum_t prev_seqnum_;
+    bool has_prev_seqnum_;
+    bool seqnum_continuous_;
 
     core::RateLimiter rate_limiter_;
 
+    LossConcealer* concealer_;
+    bool concealment_enabled_;
+
     const bool beep_;
 
     bool first_packet_;
@@ -7,10 +7,22 @@
  */
 
 #include "roc_audio/fanout.h"
+#include "roc_core/log.h"
 
 namespace roc {
 namespace audio {
 
+Fanout::Fanout()
+    : workers_(NULL)
+    , frame_(NULL) {
+}
+
+Fanout::Fanout(core::WorkerPool& workers, core::IArena& arena)
+    : workers_(&workers)
+    , frame_(NULL) {
+    outputs_.reset(new (outputs_) core::Array<IFrameWriter*>(arena));
+}
+
 bool Fanout::has_output(IFrameWriter& writer) {
     return writers_.contains(writer);
 }
@@ -24,10 +36,39 @@ void Fanout::remove_output(IFrameWriter& writer) {
 }
 
 void Fanout::write(Frame& frame) {
+    if (workers_ && writers_.size() > 1 && prepare_outputs_()) {
+        // Write to all outputs in parallel and wait until they're done.
+        frame_ = &frame;
+        workers_->run(*this, outputs_->size());
+        frame_ = NULL;
+        return;
+    }
+
     for (IFrameWriter* wp = writers_.front(); wp; wp = writers_.nextof(*wp)) {
         wp->write(frame);
     }
 }
 
+bool Fanout::prepare_outputs_() {
+    core::Array<IFrameWriter*>& outputs = *outputs_;
+
+    if (!outputs.resize(writers_.size())) {
+        roc_log(LogError, "fanout: can't allocate outputs, falling back to serial write");
+        return false;
+    }
+
+    size_t n = 0;
+
+    for (IFrameWriter* wp = writers_.front(); wp; wp = writers_.nextof(*wp), n++) {
+        outputs[n] = wp;
+    }
+
+    return true;
+}
+
+void Fanout::run_job(size_t job_index) {
+    (*outputs_)[job_index]->write(*frame_);
+}
+
 } // namespace audio
 } // namespace roc
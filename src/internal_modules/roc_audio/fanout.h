@@ -14,17 +14,36 @@
 
 #include "roc_audio/iframe_writer.h"
 #include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/iworker_job.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/slice.h"
+#include "roc_core/worker_pool.h"
 
 namespace roc {
 namespace audio {
 
 //! Fanout.
 //! Duplicates audio stream to multiple output writers.
-class Fanout : public IFrameWriter, public core::NonCopyable<> {
+//!
+//! If worker pool is provided, fanout writes frame to all outputs in parallel,
+//! and returns when all outputs are done. Outputs should be safe to write
+//! concurrently with each other and should not modify the frame.
+class Fanout : public IFrameWriter,
+               public core::NonCopyable<>,
+               private core::IWorkerJob {
 public:
+    //! Initialize.
+    Fanout();
+
+    //! Initialize with parallel writing.
+    //! @p workers is used to write to outputs in parallel.
+    //! @p arena is used to allocate per-output state.
+    Fanout(core::WorkerPool& workers, core::IArena& arena);
+
     //! Check if writer is already added.
     bool has_output(IFrameWriter&);
 
@@ -40,7 +59,14 @@ public:
     virtual void write(Frame& frame);
 
 private:
+    bool prepare_outputs_();
+    virtual void run_job(size_t job_index);
+
     core::List<IFrameWriter, core::NoOwnership> writers_;
+
+    core::WorkerPool* workers_;
+    core::Optional<core::Array<IFrameWriter*> > outputs_;
+    Frame* frame_;
 };
 
 } // namespace audio
@@ -8,6 +8,7 @@
 
 #include "roc_audio/feedback_monitor.h"
 #include "roc_audio/packetizer.h"
+#include "roc_core/cached_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/time.h"
@@ -21,7 +22,7 @@ FeedbackMonitor::FeedbackMonitor(IFrameWriter& writer,
                                  const FeedbackConfig& feedback_config,
                                  const LatencyConfig& latency_config,
                                  const SampleSpec& sample_spec)
-    : tuner_(latency_config, sample_spec)
+    : latency_config_(latency_config)
     , use_packetizer_(false)
     , has_feedback_(false)
     , last_feedback_ts_(0)
@@ -30,12 +31,13 @@ FeedbackMonitor::FeedbackMonitor(IFrameWriter& writer,
     , writer_(writer)
     , resampler_(resampler)
     , enable_scaling_(latency_config.tuner_profile != LatencyTunerProfile_Intact)
+    , passthrough_(false)
     , source_(0)
     , source_change_limiter_(feedback_config.source_cooldown)
     , sample_spec_(sample_spec)
     , started_(false)
     , valid_(false) {
-    if (!tuner_.is_valid()) {
+    if (!init_tuner_()) {
         return;
     }
 
@@ -98,6 +100,9 @@ void FeedbackMonitor::process_feedback(packet::stream_source_t source_id,
                 (unsigned long)source_, (unsigned long)source_id);
 
         source_ = source_id;
+
+        // Queue and clock of new receiver have nothing to do with old one.
+        restart_tuning_();
     }
 
     latency_metrics_ = latency_metrics;
@@ -114,6 +119,18 @@ void FeedbackMonitor::process_feedback(packet::stream_source_t source_id,
     last_feedback_ts_ = core::timestamp(core::ClockMonotonic);
 }
 
+bool FeedbackMonitor::set_target_latency(core::nanoseconds_t target_latency) {
+    roc_panic_if(!is_valid());
+
+    if (!tuner_->set_target_latency(target_latency)) {
+        return false;
+    }
+
+    latency_config_.target_latency = target_latency;
+
+    return true;
+}
+
 void FeedbackMonitor::write(Frame& frame) {
     roc_panic_if(!is_valid());
 
@@ -163,7 +180,8 @@ bool FeedbackMonitor::update_tuner_(packet::stream_timestamp_t duration) {
         return true;
     }
 
-    if (core::timestamp(core::ClockMonotonic) - last_feedback_ts_ > feedback_timeout_) {
+    if (core::CachedClock::now(core::ClockMonotonic) - last_feedback_ts_
+        > feedback_timeout_) {
         roc_log(LogInfo,
                 "feedback monitor: no reports from receiver during timeout:"
                 " source=%lu timeout=%.3fms",
@@ -173,20 +191,43 @@ bool FeedbackMonitor::update_tuner_(packet::stream_timestamp_t duration) {
         last_feedback_ts_ = 0;
         source_ = 0;
 
+        // Don't keep drifting according to outdated feedback.
+        restart_tuning_();
+
         return true;
     }
 
-    tuner_.write_metrics(latency_metrics_, link_metrics_);
+    tuner_->write_metrics(latency_metrics_, link_metrics_);
 
-    if (!tuner_.update_stream()) {
+    if (!tuner_->update_stream()) {
         return false;
     }
 
-    tuner_.advance_stream(duration);
+    tuner_->advance_stream(duration);
 
     return true;
 }
 
+bool FeedbackMonitor::init_tuner_() {
+    // Destroy old tuner before constructing new one in the same storage.
+    tuner_.reset();
+    tuner_.reset(new (tuner_) LatencyTuner(latency_config_, sample_spec_));
+
+    return tuner_->is_valid();
+}
+
+void FeedbackMonitor::restart_tuning_() {
+    if (!init_tuner_()) {
+        roc_panic("feedback monitor: can't re-create latency tuner");
+    }
+
+    if (enable_scaling_) {
+        if (!init_scaling_()) {
+            roc_panic("feedback monitor: can't reset scaling");
+        }
+    }
+}
+
 bool FeedbackMonitor::init_scaling_() {
     roc_panic_if_not(resampler_);
 
@@ -195,13 +236,28 @@ bool FeedbackMonitor::init_scaling_() {
         return false;
     }
 
+    // Resampler can be bypassed only until it's used for the first time,
+    // so after restart of tuning it stays enabled.
+    if (tuner_->is_clock_locked() && resampler_->set_passthrough(true)) {
+        roc_log(LogDebug, "feedback monitor: clocks are locked, bypassing resampler");
+        passthrough_ = true;
+    }
+
     return true;
 }
 
 bool FeedbackMonitor::update_scaling_() {
     roc_panic_if_not(resampler_);
 
-    const float scaling = tuner_.fetch_scaling();
+    if (passthrough_ && !tuner_->is_clock_locked()) {
+        roc_log(LogInfo, "feedback monitor: clock drift detected, enabling resampler");
+        if (!resampler_->set_passthrough(false)) {
+            return false;
+        }
+        passthrough_ = false;
+    }
+
+    const float scaling = tuner_->fetch_scaling();
     if (scaling > 0) {
         if (!resampler_->set_scaling(scaling)) {
             roc_log(LogDebug,
@@ -17,7 +17,9 @@
 #include "roc_audio/packetizer.h"
 #include "roc_audio/resampler_writer.h"
 #include "roc_audio/sample_spec.h"
+#include "roc_core/attributes.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/time.h"
 #include "roc_packet/ilink_meter.h"
@@ -50,6 +52,10 @@ struct FeedbackConfig {
 //!  - asks LatencyTuner to calculate scaling factor based on the actual and
 //!    target latencies
 //!  - passes calculated scaling factor to resampler
+//!  - restarts tuning from scratch when receiver changes or stops sending
+//!    feedback, since learned clock drift belongs to previous receiver
+//!  - if clocks are configured as locked, resampler is bypassed until tuner
+//!    detects clock drift, and then it is switched to resampling mode
 //!
 //! @b Flow
 //!
@@ -60,6 +66,13 @@ struct FeedbackConfig {
 //!    updated scaling factor to it
 //!  - pipeline also can query feedback monitor for latency metrics on behalf of
 //!    request from user
+//!
+//! @b Sender-driven latency
+//!
+//!  If latency tuning is enabled on sender and disabled on receiver
+//!  (LatencyTunerProfile_Intact), receiver doesn't create resampler at all,
+//!  and sender adjusts rate of its own stream to keep receiver queue near
+//!  target latency. This moves cost of resampling from receivers to sender.
 class FeedbackMonitor : public IFrameWriter, public core::NonCopyable<> {
 public:
     //! Constructor.
@@ -84,6 +97,14 @@ public:
                           const LatencyMetrics& latency_metrics,
                           const packet::LinkMetrics& link_metrics);
 
+    //! Set new target latency.
+    //! @remarks
+    //!  Latency tuner moves target gradually, see LatencyTuner. If tuning
+    //!  is restarted later, new tuner starts with this target.
+    //! @returns
+    //!  false if target can't be changed.
+    ROC_ATTR_NODISCARD bool set_target_latency(core::nanoseconds_t target_latency);
+
     //! Write audio frame.
     //! Passes frame to underlying writer.
     //! If feedback monitoring is started, also performs latency tuning.
@@ -103,10 +124,14 @@ public:
 private:
     bool update_tuner_(packet::stream_timestamp_t duration);
 
+    bool init_tuner_();
+    void restart_tuning_();
+
     bool init_scaling_();
     bool update_scaling_();
 
-    LatencyTuner tuner_;
+    LatencyConfig latency_config_;
+    core::Optional<LatencyTuner> tuner_;
 
     LatencyMetrics latency_metrics_;
     packet::LinkMetrics link_metrics_;
@@ -121,6 +146,7 @@ private:
 
     ResamplerWriter* resampler_;
     const bool enable_scaling_;
+    bool passthrough_;
 
     packet::stream_source_t source_;
     core::RateLimiter source_change_limiter_;
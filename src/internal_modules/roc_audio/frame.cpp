@@ -44,6 +44,11 @@ void Frame::set_flags(unsigned flags) {
     flags_ = flags;
 }
 
+unsigned Frame::combine_flags(unsigned flags1, unsigned flags2) {
+    return ((flags1 | flags2) & ~(unsigned)FlagSilent)
+        | (flags1 & flags2 & (unsigned)FlagSilent);
+}
+
 bool Frame::is_raw() const {
     return (flags_ & FlagNotRaw) == 0;
 }
@@ -114,6 +119,7 @@ void Frame::print() const {
         !(flags_ & FlagNotBlank) ? 'b' : '.',
         (flags_ & FlagNotComplete) ? 'i' : '.',
         (flags_ & FlagPacketDrops) ? 'd' : '.',
+        (flags_ & FlagSilent) ? 's' : '.',
         '\0',
     };
 
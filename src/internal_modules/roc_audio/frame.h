@@ -37,7 +37,7 @@ public:
     //! (concatenate or mix), bitwise OR of their flags will give flags for resulting
     //! frame. E.g., if at least one frame was non-blank, combined frame will be
     //! non-blank, if at least one frame was incomplete, combined frame will be
-    //! incomplete, etc.
+    //! incomplete, etc. The only exception is FlagSilent, see combine_flags().
     enum {
         //! Set if the frame has format different from raw samples.
         //! If this flag is set, only bytes() can be used, and raw_samples() panics.
@@ -53,9 +53,20 @@ public:
 
         //! Set if some late packets were dropped while the frame was being built.
         //! It's not necessarily that the frame itself is blank or incomplete.
-        FlagPacketDrops = (1 << 3)
+        FlagPacketDrops = (1 << 3),
+
+        //! Set if all samples of the frame are known to be zero.
+        //! Such frame may be skipped when mixing. Unlike other flags, combined
+        //! frame is silent only if all combined frames are silent.
+        FlagSilent = (1 << 4)
     };
 
+    //! Combine flags of two frames.
+    //! @remarks
+    //!  Returns bitwise OR of flags, except FlagSilent, which is kept only if
+    //!  it's set in both. To combine a sequence of frames, start from FlagSilent.
+    static unsigned combine_flags(unsigned flags1, unsigned flags2);
+
     //! Get flags.
     unsigned flags() const;
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/frame_encoder_config.h
+//! @brief Frame encoder config.
+
+#ifndef ROC_AUDIO_FRAME_ENCODER_CONFIG_H_
+#define ROC_AUDIO_FRAME_ENCODER_CONFIG_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Frame encoder config.
+//! Used only by compressing encoders; PCM encoder ignores it.
+struct FrameEncoderConfig {
+    //! Target bitrate, in bits per second.
+    //! If zero, encoder selects bitrate based on sample rate and channel count.
+    size_t bitrate;
+
+    //! Encoding complexity, from 0 (fastest) to 10 (best quality).
+    size_t complexity;
+
+    //! Initialize config with default values.
+    FrameEncoderConfig()
+        : bitrate(0)
+        , complexity(10) {
+    }
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_FRAME_ENCODER_CONFIG_H_
@@ -18,6 +18,7 @@ FrameFactory::FrameFactory(core::IArena& arena, size_t buffer_size) {
 
     buffer_pool_ = default_buffer_pool_.get();
     buffer_size_ = buffer_size;
+    n_small_pools_ = 0;
 }
 
 FrameFactory::FrameFactory(core::IPool& buffer_pool) {
@@ -30,6 +31,35 @@ FrameFactory::FrameFactory(core::IPool& buffer_pool) {
 
     buffer_pool_ = &buffer_pool;
     buffer_size_ = buffer_pool.object_size() - sizeof(core::Buffer);
+    n_small_pools_ = 0;
+}
+
+void FrameFactory::add_small_buffer_pool(core::IPool& buffer_pool) {
+    if (buffer_pool.object_size() < sizeof(core::Buffer)
+        || buffer_pool.object_size() - sizeof(core::Buffer) >= buffer_size_) {
+        roc_panic("frame factory: unexpected small buffer_pool object size:"
+                  " minimum=%lu maximum=%lu actual=%lu",
+                  (unsigned long)sizeof(core::Buffer),
+                  (unsigned long)(sizeof(core::Buffer) + buffer_size_ - 1),
+                  (unsigned long)buffer_pool.object_size());
+    }
+
+    if (n_small_pools_ == MaxSmallPools) {
+        roc_panic("frame factory: too many small buffer pools: max=%lu",
+                  (unsigned long)MaxSmallPools);
+    }
+
+    const size_t size = buffer_pool.object_size() - sizeof(core::Buffer);
+
+    size_t pos = n_small_pools_;
+    for (; pos > 0 && small_sizes_[pos - 1] > size; pos--) {
+        small_pools_[pos] = small_pools_[pos - 1];
+        small_sizes_[pos] = small_sizes_[pos - 1];
+    }
+
+    small_pools_[pos] = &buffer_pool;
+    small_sizes_[pos] = size;
+    n_small_pools_++;
 }
 
 size_t FrameFactory::byte_buffer_size() const {
@@ -41,6 +71,10 @@ core::Slice<uint8_t> FrameFactory::new_byte_buffer() {
         core::Buffer(*buffer_pool_, buffer_size_);
 }
 
+core::Slice<uint8_t> FrameFactory::new_byte_buffer(size_t size) {
+    return new_buffer_(size);
+}
+
 size_t FrameFactory::raw_buffer_size() const {
     return buffer_size_ / sizeof(sample_t);
 }
@@ -50,5 +84,27 @@ core::Slice<sample_t> FrameFactory::new_raw_buffer() {
         core::Buffer(*buffer_pool_, buffer_size_);
 }
 
+core::Slice<sample_t> FrameFactory::new_raw_buffer(size_t size) {
+    if (size > raw_buffer_size()) {
+        return core::Slice<sample_t>();
+    }
+
+    return new_buffer_(size * sizeof(sample_t));
+}
+
+core::BufferPtr FrameFactory::new_buffer_(size_t size) {
+    if (size > buffer_size_) {
+        return NULL;
+    }
+
+    for (size_t n = 0; n < n_small_pools_; n++) {
+        if (size <= small_sizes_[n]) {
+            return new (*small_pools_[n]) core::Buffer(*small_pools_[n], small_sizes_[n]);
+        }
+    }
+
+    return new (*buffer_pool_) core::Buffer(*buffer_pool_, buffer_size_);
+}
+
 } // namespace audio
 } // namespace roc
@@ -45,24 +45,61 @@ public:
     //! @p buffer_pool is a pool of core::Buffer objects.
     FrameFactory(core::IPool& buffer_pool);
 
+    //! Add pool for smaller frame buffers.
+    //! @remarks
+    //!  @p buffer_pool is a pool of core::Buffer objects, smaller than buffers
+    //!  of main buffer pool. It is used by new_byte_buffer(size) and
+    //!  new_raw_buffer(size) when requested size fits. Should be called
+    //!  before factory is used.
+    void add_small_buffer_pool(core::IPool& buffer_pool);
+
     //! Get number of bytes in byte buffer.
+    //! @remarks
+    //!  This is the maximum size, i.e. size of buffers of main buffer pool.
     size_t byte_buffer_size() const;
 
     //! Allocate byte buffer.
+    //! @remarks
+    //!  Returned buffer has maximum size.
     core::Slice<uint8_t> new_byte_buffer();
 
+    //! Allocate byte buffer of at least given number of bytes.
+    //! @remarks
+    //!  Returns buffer from the smallest pool which buffers fit @p size, or
+    //!  null if @p size is greater than byte_buffer_size().
+    core::Slice<uint8_t> new_byte_buffer(size_t size);
+
     //! Get number of samples in raw sample buffer.
+    //! @remarks
+    //!  This is the maximum size, i.e. size of buffers of main buffer pool.
     size_t raw_buffer_size() const;
 
     //! Allocate raw sample buffer.
+    //! @remarks
+    //!  Returned buffer has maximum size.
     core::Slice<sample_t> new_raw_buffer();
 
+    //! Allocate raw sample buffer of at least given number of samples.
+    //! @remarks
+    //!  Returns buffer from the smallest pool which buffers fit @p size, or
+    //!  null if @p size is greater than raw_buffer_size().
+    core::Slice<sample_t> new_raw_buffer(size_t size);
+
 private:
+    enum { MaxSmallPools = 4 };
+
+    core::BufferPtr new_buffer_(size_t size);
+
     // used if factory is created with default pools
     core::Optional<core::SlabPool<core::Buffer> > default_buffer_pool_;
 
     core::IPool* buffer_pool_;
     size_t buffer_size_;
+
+    // pools of smaller buffers, sorted by buffer size
+    core::IPool* small_pools_[MaxSmallPools];
+    size_t small_sizes_[MaxSmallPools];
+    size_t n_small_pools_;
 };
 
 } // namespace audio
@@ -38,41 +38,26 @@ FreqEstimatorConfig make_config(FreqEstimatorProfile profile) {
     return config;
 }
 
-// Calculate dot product of arrays IR of filter (coeff) and input array (samples).
-//
-// - coeff: Filter impulse response.
-// - samples: Array with sample values.
-// - sample_ind: index in input array to start from.
-// - len: How many samples do we need at output.
-// - len_mask: Bit mask of input array length.
-double dot_prod(const double* coeff,
-                const double* samples,
-                const size_t sample_ind,
-                const size_t len,
-                const size_t len_mask) {
-    double accum = 0;
-
-    for (size_t i = sample_ind, j = 0; j < len; i = (i - 1) & len_mask, ++j) {
-        accum += coeff[j] * samples[i];
-    }
-
-    return accum;
-}
-
 } // namespace
 
 FreqEstimator::FreqEstimator(FreqEstimatorProfile profile,
                              packet::stream_timestamp_t target_latency)
     : config_(make_config(profile))
     , target_(target_latency)
+    , dot_prod_(NULL)
     , dec1_ind_(0)
     , dec2_ind_(0)
     , samples_counter_(0)
     , accum_(0)
     , coeff_(1) {
-    roc_log(LogDebug, "freq estimator: initializing: P=%e I=%e dc1=%lu dc2=%lu",
+    const FreqEstimatorKernel kernel = fe_decim_kernel_best();
+    dot_prod_ = fe_decim_kernel_func(kernel);
+    roc_panic_if(!dot_prod_);
+
+    roc_log(LogDebug,
+            "freq estimator: initializing: P=%e I=%e dc1=%lu dc2=%lu kernel=%s",
             config_.P, config_.I, (unsigned long)config_.decimation_factor1,
-            (unsigned long)config_.decimation_factor2);
+            (unsigned long)config_.decimation_factor2, fe_decim_kernel_to_str(kernel));
 
     roc_panic_if_msg(
         config_.decimation_factor1 < 1
@@ -88,10 +73,7 @@ FreqEstimator::FreqEstimator(FreqEstimatorProfile profile,
     roc_panic_if_msg((fe_decim_len & (fe_decim_len - 1)) != 0,
                      "freq estimator: decim_len should be power of two");
 
-    memset(dec1_casc_buff_, 0, sizeof(dec1_casc_buff_));
-    memset(dec2_casc_buff_, 0, sizeof(dec2_casc_buff_));
-
-    for (size_t i = 0; i < fe_decim_len; i++) {
+    for (size_t i = 0; i < fe_decim_len * 2; i++) {
         dec1_casc_buff_[i] = target_;
         dec2_casc_buff_[i] = target_;
     }
@@ -109,17 +91,32 @@ void FreqEstimator::update(packet::stream_timestamp_t current) {
     }
 }
 
+void FreqEstimator::set_target_latency(packet::stream_timestamp_t target_latency) {
+    target_ = target_latency;
+}
+
+FreqEstimatorState FreqEstimator::save_state() const {
+    FreqEstimatorState state;
+    state.accum = accum_;
+    state.coeff = coeff_;
+    return state;
+}
+
+void FreqEstimator::restore_state(const FreqEstimatorState& state) {
+    accum_ = state.accum;
+    coeff_ = state.coeff;
+}
+
 bool FreqEstimator::run_decimators_(packet::stream_timestamp_t current,
                                     double& filtered) {
     samples_counter_++;
 
-    dec1_casc_buff_[dec1_ind_] = current;
+    store_(dec1_casc_buff_, dec1_ind_, current);
 
     if ((samples_counter_ % config_.decimation_factor1) == 0) {
         // Time to calculate first decimator's samples.
-        dec2_casc_buff_[dec2_ind_] = dot_prod(fe_decim_h, dec1_casc_buff_, dec1_ind_,
-                                              fe_decim_len, fe_decim_len_mask)
-            / fe_decim_h_gain;
+        store_(dec2_casc_buff_, dec2_ind_,
+               dot_prod_(dec1_casc_buff_ + dec1_ind_) / fe_decim_h_gain);
 
         // If the second stage decimator is totally turned off
         if (config_.decimation_factor2 == 0) {
@@ -131,21 +128,24 @@ bool FreqEstimator::run_decimators_(packet::stream_timestamp_t current,
             samples_counter_ = 0;
 
             // Time to calculate second decimator (and freq estimator's) output.
-            filtered = dot_prod(fe_decim_h, dec2_casc_buff_, dec2_ind_, fe_decim_len,
-                                fe_decim_len_mask)
-                / fe_decim_h_gain;
+            filtered = dot_prod_(dec2_casc_buff_ + dec2_ind_) / fe_decim_h_gain;
 
             return true;
         }
 
-        dec2_ind_ = (dec2_ind_ + 1) & fe_decim_len_mask;
+        dec2_ind_ = (dec2_ind_ - 1) & fe_decim_len_mask;
     }
 
-    dec1_ind_ = (dec1_ind_ + 1) & fe_decim_len_mask;
+    dec1_ind_ = (dec1_ind_ - 1) & fe_decim_len_mask;
 
     return false;
 }
 
+void FreqEstimator::store_(double* buff, size_t ind, double value) {
+    buff[ind] = value;
+    buff[ind + fe_decim_len] = value;
+}
+
 double FreqEstimator::run_controller_(double current) {
     const double error = (current - target_);
 
@@ -52,6 +52,20 @@ struct FreqEstimatorConfig {
     }
 };
 
+//! FreqEstimator state.
+//! @remarks
+//!  Can be saved from one estimator and restored into another one, so
+//!  that it continues from the same clock drift estimate.
+struct FreqEstimatorState {
+    double accum; //!< Integrator value.
+    double coeff; //!< Frequency coefficient.
+
+    FreqEstimatorState()
+        : accum(0)
+        , coeff(1) {
+    }
+};
+
 //! Evaluates sender's frequency to receivers's frequency ratio.
 //! @remarks
 //!  We provide FreqEstimator with traget latency and periodically update it with
@@ -75,17 +89,40 @@ public:
     //! Compute new value of frequency coefficient.
     void update(packet::stream_timestamp_t current_latency);
 
+    //! Change target latency.
+    //! @remarks
+    //!  Controller state is kept, so the coefficient changes smoothly and
+    //!  latency gradually moves to the new target.
+    void set_target_latency(packet::stream_timestamp_t target_latency);
+
+    //! Get current state.
+    FreqEstimatorState save_state() const;
+
+    //! Continue from previously saved state.
+    //! @remarks
+    //!  Restores integrator and frequency coefficient. Decimator histories
+    //!  are not restored, because latency of the new stream is unrelated.
+    void restore_state(const FreqEstimatorState& state);
+
 private:
     bool run_decimators_(packet::stream_timestamp_t current, double& filtered);
+    void store_(double* buff, size_t ind, double value);
     double run_controller_(double current);
 
     const FreqEstimatorConfig config_;
-    const double target_; // Target latency.
+    double target_; // Target latency.
+
+    // Filter kernel selected for current CPU.
+    FreqEstimatorKernelFunc dot_prod_;
 
-    double dec1_casc_buff_[fe_decim_len];
+    // Decimator histories, filled backwards, so that newest value goes first.
+    // Every value is stored twice, at ind and ind + fe_decim_len, so that
+    // last fe_decim_len values are always contiguous and can be passed to
+    // SIMD kernel without wrapping.
+    double dec1_casc_buff_[fe_decim_len * 2];
     size_t dec1_ind_;
 
-    double dec2_casc_buff_[fe_decim_len];
+    double dec2_casc_buff_[fe_decim_len * 2];
     size_t dec2_ind_;
 
     size_t samples_counter_; // Input samples counter.
@@ -7,6 +7,27 @@
  */
 
 #include "roc_audio/freq_estimator_decim.h"
+#include "roc_core/cpu_features.h"
+#include "roc_core/cpu_traits.h"
+#include "roc_core/macro_helpers.h"
+
+// SSE2 is enabled at compile time, AVX is enabled per-function
+// and selected at run time.
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && ROC_CPU_HAS_SSE2
+#define ROC_AUDIO_FE_DECIM_SSE2
+#include <emmintrin.h>
+#if defined(__clang__)                                                                   \
+    || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define ROC_AUDIO_FE_DECIM_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+// Double-precision NEON is available only on AArch64.
+#if ROC_CPU_FAMILY == ROC_CPU_ARM && ROC_CPU_HAS_NEON && defined(__aarch64__)
+#define ROC_AUDIO_FE_DECIM_NEON
+#include <arm_neon.h>
+#endif
 
 const double roc::audio::fe_decim_h_gain = 1.041106363770361;
 
@@ -76,3 +97,169 @@ const double roc::audio::fe_decim_h[fe_decim_len] = {
     0.00105746265,     0.0009566077497,  0.0008557052352,  0.0007556059863,
     0.0006585246301,   0.0005492189666,  0.001551611349,   0.00002171816595
 };
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+double dot_prod_scalar(const double* samples) {
+    double accum = 0;
+
+    for (size_t n = 0; n < fe_decim_len; n++) {
+        accum += fe_decim_h[n] * samples[n];
+    }
+
+    return accum;
+}
+
+#ifdef ROC_AUDIO_FE_DECIM_SSE2
+
+double dot_prod_sse2(const double* samples) {
+    // Two independent accumulators to hide latency of additions.
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+
+    for (size_t n = 0; n < fe_decim_len; n += 4) {
+        acc0 = _mm_add_pd(
+            acc0, _mm_mul_pd(_mm_loadu_pd(fe_decim_h + n), _mm_loadu_pd(samples + n)));
+        acc1 = _mm_add_pd(acc1,
+                          _mm_mul_pd(_mm_loadu_pd(fe_decim_h + n + 2),
+                                     _mm_loadu_pd(samples + n + 2)));
+    }
+
+    acc0 = _mm_add_pd(acc0, acc1);
+    acc0 = _mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0));
+
+    return _mm_cvtsd_f64(acc0);
+}
+
+#endif // ROC_AUDIO_FE_DECIM_SSE2
+
+#ifdef ROC_AUDIO_FE_DECIM_AVX
+
+__attribute__((target("avx"))) double dot_prod_avx(const double* samples) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    for (size_t n = 0; n < fe_decim_len; n += 8) {
+        acc0 = _mm256_add_pd(acc0,
+                             _mm256_mul_pd(_mm256_loadu_pd(fe_decim_h + n),
+                                           _mm256_loadu_pd(samples + n)));
+        acc1 = _mm256_add_pd(acc1,
+                             _mm256_mul_pd(_mm256_loadu_pd(fe_decim_h + n + 4),
+                                           _mm256_loadu_pd(samples + n + 4)));
+    }
+
+    acc0 = _mm256_add_pd(acc0, acc1);
+
+    __m128d sum =
+        _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+    sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+
+    const double result = _mm_cvtsd_f64(sum);
+
+    // Avoid AVX-SSE transition penalty in the caller.
+    _mm256_zeroupper();
+
+    return result;
+}
+
+#endif // ROC_AUDIO_FE_DECIM_AVX
+
+#ifdef ROC_AUDIO_FE_DECIM_NEON
+
+double dot_prod_neon(const double* samples) {
+    float64x2_t acc0 = vdupq_n_f64(0);
+    float64x2_t acc1 = vdupq_n_f64(0);
+
+    for (size_t n = 0; n < fe_decim_len; n += 4) {
+        acc0 = vaddq_f64(acc0,
+                         vmulq_f64(vld1q_f64(fe_decim_h + n), vld1q_f64(samples + n)));
+        acc1 = vaddq_f64(
+            acc1, vmulq_f64(vld1q_f64(fe_decim_h + n + 2), vld1q_f64(samples + n + 2)));
+    }
+
+    return vaddvq_f64(vaddq_f64(acc0, acc1));
+}
+
+#endif // ROC_AUDIO_FE_DECIM_NEON
+
+} // namespace
+
+FreqEstimatorKernelFunc fe_decim_kernel_func(FreqEstimatorKernel kernel) {
+    switch (kernel) {
+    case FreqEstimatorKernel_Scalar:
+        return &dot_prod_scalar;
+
+    case FreqEstimatorKernel_SSE2:
+#ifdef ROC_AUDIO_FE_DECIM_SSE2
+        if (core::cpu_supports(core::CpuFeature_SSE2)) {
+            return &dot_prod_sse2;
+        }
+#endif
+        break;
+
+    case FreqEstimatorKernel_AVX:
+#ifdef ROC_AUDIO_FE_DECIM_AVX
+        if (core::cpu_supports(core::CpuFeature_AVX)) {
+            return &dot_prod_avx;
+        }
+#endif
+        break;
+
+    case FreqEstimatorKernel_NEON:
+#ifdef ROC_AUDIO_FE_DECIM_NEON
+        if (core::cpu_supports(core::CpuFeature_NEON)) {
+            return &dot_prod_neon;
+        }
+#endif
+        break;
+
+    case FreqEstimatorKernel_Max:
+        break;
+    }
+
+    return NULL;
+}
+
+FreqEstimatorKernel fe_decim_kernel_best() {
+    // Ordered from fastest to slowest.
+    const FreqEstimatorKernel candidates[] = {
+        FreqEstimatorKernel_AVX,
+        FreqEstimatorKernel_SSE2,
+        FreqEstimatorKernel_NEON,
+    };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(candidates); n++) {
+        if (fe_decim_kernel_func(candidates[n])) {
+            return candidates[n];
+        }
+    }
+
+    return FreqEstimatorKernel_Scalar;
+}
+
+const char* fe_decim_kernel_to_str(FreqEstimatorKernel kernel) {
+    switch (kernel) {
+    case FreqEstimatorKernel_Scalar:
+        return "scalar";
+
+    case FreqEstimatorKernel_SSE2:
+        return "sse2";
+
+    case FreqEstimatorKernel_AVX:
+        return "avx";
+
+    case FreqEstimatorKernel_NEON:
+        return "neon";
+
+    case FreqEstimatorKernel_Max:
+        break;
+    }
+
+    return "invalid";
+}
+
+} // namespace audio
+} // namespace roc
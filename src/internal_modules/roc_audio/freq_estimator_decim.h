@@ -23,7 +23,7 @@ static const size_t fe_decim_factor_max = 10;
 
 //! Length of decimation filter response length in frequency estimator.
 //! @remarks
-//!  Should be power of two.
+//!  Should be power of two, not less than 8 (required by SIMD kernels).
 static const size_t fe_decim_len = 256;
 
 //! Bitmask for fe_decim_len.
@@ -35,6 +35,42 @@ extern const double fe_decim_h[fe_decim_len];
 //! Filters gain, sum(fe_decim_h).
 extern const double fe_decim_h_gain;
 
+//! Decimation filter kernel implementations.
+enum FreqEstimatorKernel {
+    //! Portable scalar implementation.
+    //! Always available.
+    FreqEstimatorKernel_Scalar,
+
+    //! x86 SSE2 implementation.
+    FreqEstimatorKernel_SSE2,
+
+    //! x86 AVX implementation.
+    FreqEstimatorKernel_AVX,
+
+    //! ARM NEON implementation (AArch64 only).
+    FreqEstimatorKernel_NEON,
+
+    //! Number of kernels.
+    FreqEstimatorKernel_Max
+};
+
+//! Decimation filter kernel function.
+//! Computes dot product of fe_decim_h and @p samples, which should
+//! contain fe_decim_len values, newest first.
+typedef double (*FreqEstimatorKernelFunc)(const double* samples);
+
+//! Get decimation filter kernel function.
+//! @returns
+//!  NULL if the kernel was not enabled at compile time or is not
+//!  supported by current CPU.
+FreqEstimatorKernelFunc fe_decim_kernel_func(FreqEstimatorKernel kernel);
+
+//! Get fastest decimation filter kernel supported by current CPU.
+FreqEstimatorKernel fe_decim_kernel_best();
+
+//! Get string name of decimation filter kernel.
+const char* fe_decim_kernel_to_str(FreqEstimatorKernel kernel);
+
 } // namespace audio
 } // namespace roc
 
@@ -109,6 +109,28 @@ public:
     //!  After this call, the frame can't be read or shifted anymore. A new frame
     //!  should be started by calling begin().
     virtual void end() = 0;
+
+    //! Generate samples in place of lost frames.
+    //!
+    //! @b Parameters
+    //!  - @p samples - buffer to write generated samples to
+    //!  - @p n_samples - number of samples to be generated per channel
+    //!
+    //! @remarks
+    //!  Invoked when there is a gap in the stream before the next frame, or when
+    //!  there are no more frames. Codecs with packet loss concealment extrapolate
+    //!  previously decoded frames. Does not affect decoded stream position.
+    //!
+    //! @returns
+    //!  number of samples generated per channel. The returned value can be fewer
+    //!  than @p n_samples (e.g. zero if the codec does not support concealment);
+    //!  in this case the caller fills the rest with silence.
+    //!
+    //! @pre
+    //!  This method may be called between frames, or after begin() but before
+    //!  the first read() or shift() of the new frame. In the latter case, the
+    //!  gap precedes the new frame, and the frame is decoded after concealment.
+    virtual size_t conceal(sample_t* samples, size_t n_samples) = 0;
 };
 
 } // namespace audio
@@ -26,6 +26,8 @@ public:
     virtual ~IFrameEncoder();
 
     //! Get encoded frame size in bytes for given number of samples per channel.
+    //! @remarks
+    //!  For encoders with variable output size, returns the maximum size.
     virtual size_t encoded_byte_count(size_t num_samples) const = 0;
 
     //! Start encoding a new frame.
@@ -57,7 +59,12 @@ public:
     //! @remarks
     //!  After this call, the frame is fully encoded and no more samples will be
     //!  written to the frame. A new frame should be started by calling begin().
-    virtual void end() = 0;
+    //!
+    //! @returns
+    //!  number of bytes actually written to the frame. It never exceeds
+    //!  encoded_byte_count() for the number of written samples, and is equal
+    //!  to it for encoders with fixed output size.
+    virtual size_t end() = 0;
 };
 
 } // namespace audio
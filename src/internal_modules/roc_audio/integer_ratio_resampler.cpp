@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/integer_ratio_resampler.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Number of filter taps on each side of center, per output sample.
+inline size_t get_half_taps(ResamplerProfile profile) {
+    switch (profile) {
+    case ResamplerProfile_Low:
+        return 12;
+
+    case ResamplerProfile_Medium:
+        return 24;
+
+    case ResamplerProfile_High:
+        return 48;
+    }
+
+    roc_panic("integer ratio resampler: unexpected profile");
+}
+
+} // namespace
+
+IntegerRatioResampler::IntegerRatioResampler(
+    const core::SharedPtr<IResampler>& inner_resampler,
+    core::IArena& arena,
+    FrameFactory& frame_factory,
+    ResamplerProfile profile,
+    const SampleSpec& in_spec,
+    const SampleSpec& out_spec)
+    : IResampler(arena)
+    , inner_resampler_(inner_resampler)
+    , in_spec_(in_spec)
+    , out_spec_(out_spec)
+    , num_ch_(in_spec.num_channels())
+    , factor_(out_spec.sample_rate() != 0 ? in_spec.sample_rate() / out_spec.sample_rate()
+                                          : 0)
+    , half_len_(0)
+    , coeffs_(arena)
+    , offsets_(arena)
+    , center_coeff_(0)
+    , in_buf_(arena)
+    , valid_(false) {
+    if (!in_spec.is_valid() || !out_spec.is_valid() || !in_spec.is_raw()
+        || !out_spec.is_raw()) {
+        roc_log(LogError,
+                "integer ratio resampler: invalid sample spec:"
+                " in_spec=%s out_spec=%s",
+                sample_spec_to_str(in_spec).c_str(),
+                sample_spec_to_str(out_spec).c_str());
+        return;
+    }
+
+    if (in_spec.channel_set() != out_spec.channel_set()) {
+        roc_log(LogError,
+                "integer ratio resampler: input and output channel sets should be equal:"
+                " in_spec=%s out_spec=%s",
+                sample_spec_to_str(in_spec).c_str(),
+                sample_spec_to_str(out_spec).c_str());
+        return;
+    }
+
+    if (!is_supported(in_spec.sample_rate(), out_spec.sample_rate())) {
+        roc_log(LogError,
+                "integer ratio resampler: input rate should be multiple of output rate:"
+                " in_rate=%lu out_rate=%lu",
+                (unsigned long)in_spec.sample_rate(),
+                (unsigned long)out_spec.sample_rate());
+        return;
+    }
+
+    if (!inner_resampler_->is_valid()) {
+        return;
+    }
+
+    if (!init_filter_(profile)) {
+        return;
+    }
+
+    if (!init_buffers_(frame_factory)) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "integer ratio resampler: initializing:"
+            " factor=%lu filter_len=%lu nonzero_taps=%lu frame_size=%lu num_ch=%lu",
+            (unsigned long)factor_, (unsigned long)(half_len_ * 2 + 1),
+            (unsigned long)(coeffs_.size() * 2 + 1), (unsigned long)in_frame_.size(),
+            (unsigned long)num_ch_);
+
+    valid_ = true;
+}
+
+bool IntegerRatioResampler::is_valid() const {
+    return valid_;
+}
+
+bool IntegerRatioResampler::is_supported(size_t input_rate, size_t output_rate) {
+    return output_rate != 0 && input_rate > output_rate
+        && input_rate % output_rate == 0;
+}
+
+bool IntegerRatioResampler::set_scaling(size_t input_rate,
+                                        size_t output_rate,
+                                        float multiplier) {
+    roc_panic_if_not(is_valid());
+
+    if (input_rate != in_spec_.sample_rate() || output_rate != out_spec_.sample_rate()) {
+        roc_log(LogError,
+                "integer ratio resampler: can't change rates:"
+                " in_rate=%lu out_rate=%lu",
+                (unsigned long)input_rate, (unsigned long)output_rate);
+        return false;
+    }
+
+    // inner resampler has equal rates and applies only multiplier
+    return inner_resampler_->set_scaling(output_rate, output_rate, multiplier);
+}
+
+const core::Slice<sample_t>& IntegerRatioResampler::begin_push_input() {
+    roc_panic_if_not(is_valid());
+
+    return in_frame_;
+}
+
+void IntegerRatioResampler::end_push_input() {
+    roc_panic_if_not(is_valid());
+
+    const size_t hist_size = half_len_ * 2 * num_ch_;
+
+    memcpy(in_buf_.data() + hist_size, in_frame_.data(),
+           in_frame_.size() * sizeof(sample_t));
+
+    const core::Slice<sample_t>& out_frame = inner_resampler_->begin_push_input();
+    roc_panic_if_not(out_frame.size() * factor_ == in_frame_.size());
+
+    decimate_(out_frame.data(), out_frame.size());
+
+    inner_resampler_->end_push_input();
+
+    // keep last samples as history for next frame
+    memmove(in_buf_.data(), in_buf_.data() + in_frame_.size(),
+            hist_size * sizeof(sample_t));
+}
+
+size_t IntegerRatioResampler::pop_output(sample_t* out_data, size_t out_size) {
+    roc_panic_if_not(is_valid());
+
+    return inner_resampler_->pop_output(out_data, out_size);
+}
+
+float IntegerRatioResampler::n_left_to_process() const {
+    roc_panic_if_not(is_valid());
+
+    // Decimated sample corresponds to the center of the filter, which is
+    // half_len_ samples behind the last input sample used to compute it.
+    return inner_resampler_->n_left_to_process() * factor_ + half_len_ * num_ch_;
+}
+
+// Builds windowed sinc low-pass filter with cutoff at output Nyquist frequency.
+// Filter is symmetric, and every factor_-th tap except center is zero, so we
+// store only non-zero taps of one half.
+bool IntegerRatioResampler::init_filter_(ResamplerProfile profile) {
+    half_len_ = get_half_taps(profile) * factor_;
+
+    if (!coeffs_.resize(half_len_) || !offsets_.resize(half_len_)) {
+        roc_log(LogError, "integer ratio resampler: can't allocate filter");
+        return false;
+    }
+
+    size_t n_taps = 0;
+    double sum = 1.0;
+
+    for (size_t i = 1; i <= half_len_; i++) {
+        if (i % factor_ == 0) {
+            continue;
+        }
+
+        const double x = M_PI * (double)i / (double)factor_;
+        const double w = M_PI * (double)i / (double)(half_len_ + 1);
+
+        // sinc multiplied by Blackman window
+        const double h =
+            std::sin(x) / x * (0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2 * w));
+
+        coeffs_[n_taps] = (sample_t)h;
+        offsets_[n_taps] = i;
+        n_taps++;
+
+        sum += h * 2;
+    }
+
+    if (!coeffs_.resize(n_taps) || !offsets_.resize(n_taps)) {
+        roc_log(LogError, "integer ratio resampler: can't allocate filter");
+        return false;
+    }
+
+    // normalize to unity gain at DC
+    for (size_t n = 0; n < n_taps; n++) {
+        coeffs_[n] = (sample_t)((double)coeffs_[n] / sum);
+    }
+    center_coeff_ = (sample_t)(1.0 / sum);
+
+    return true;
+}
+
+bool IntegerRatioResampler::init_buffers_(FrameFactory& frame_factory) {
+    // Every input frame is decimated into exactly one input frame of inner
+    // resampler. Inner resampler didn't receive any input yet, so
+    // begin_push_input() just gives us its first frame.
+    const size_t frame_size =
+        inner_resampler_->begin_push_input().size() / num_ch_ * factor_ * num_ch_;
+
+    if (frame_size == 0 || frame_factory.raw_buffer_size() < frame_size) {
+        roc_log(LogError,
+                "integer ratio resampler: can't allocate frame buffer:"
+                " required=%lu available=%lu",
+                (unsigned long)frame_size,
+                (unsigned long)frame_factory.raw_buffer_size());
+        return false;
+    }
+
+    in_frame_ = frame_factory.new_raw_buffer(frame_size);
+    if (!in_frame_) {
+        roc_log(LogError, "integer ratio resampler: can't allocate frame buffer");
+        return false;
+    }
+    in_frame_.reslice(0, frame_size);
+
+    if (!in_buf_.resize(half_len_ * 2 * num_ch_ + frame_size)) {
+        roc_log(LogError, "integer ratio resampler: can't allocate history buffer");
+        return false;
+    }
+
+    memset(in_buf_.data(), 0, in_buf_.size() * sizeof(sample_t));
+
+    return true;
+}
+
+// Computes filter only at positions of output samples, i.e. at the last
+// input sample of every group of factor_ samples.
+void IntegerRatioResampler::decimate_(sample_t* out_data, size_t out_size) {
+    const size_t n_taps = coeffs_.size();
+    const sample_t* coeffs = coeffs_.data();
+    const size_t* offsets = offsets_.data();
+
+    const sample_t* center = in_buf_.data() + (half_len_ + factor_ - 1) * num_ch_;
+
+    for (size_t out_pos = 0; out_pos < out_size; out_pos += num_ch_) {
+        sample_t* out = out_data + out_pos;
+
+        for (size_t ch = 0; ch < num_ch_; ch++) {
+            out[ch] = center[ch] * center_coeff_;
+        }
+
+        for (size_t n = 0; n < n_taps; n++) {
+            const sample_t* left = center - offsets[n] * num_ch_;
+            const sample_t* right = center + offsets[n] * num_ch_;
+            const sample_t coeff = coeffs[n];
+
+            for (size_t ch = 0; ch < num_ch_; ch++) {
+                out[ch] += (left[ch] + right[ch]) * coeff;
+            }
+        }
+
+        center += factor_ * num_ch_;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/integer_ratio_resampler.h
+//! @brief Integer ratio resampler.
+
+#ifndef ROC_AUDIO_INTEGER_RATIO_RESAMPLER_H_
+#define ROC_AUDIO_INTEGER_RATIO_RESAMPLER_H_
+
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/iresampler.h"
+#include "roc_audio/resampler_config.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Integer ratio resampler.
+//!
+//! Acts as decorator for another resampler instance.
+//!
+//! Used when input rate is an integer multiple of output rate, e.g. 96kHz to
+//! 48kHz or 48kHz to 16kHz. Performs resampling in two stages:
+//!  - first, applies constant part of scaling factor using polyphase FIR
+//!    decimator: low-pass filter is computed only for every factor-th input
+//!    sample, using coefficients computed once at construction
+//!  - then, uses underlying resampler, which works with equal input and
+//!    output rates, to apply dynamic part of scaling factor, a.k.a. multiplier
+//!
+//! Generic resampler has to compute interpolated sinc coefficients for every
+//! output sample, and its window grows with the ratio. Here, filter is fixed,
+//! it's symmetric, and for factor 2 every other coefficient is zero, so every
+//! output sample costs a fraction of multiplications. The underlying resampler
+//! is responsible only for a ratio close to 1.0, so a short window is enough.
+class IntegerRatioResampler : public IResampler, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p inner_resampler should be created for output rate on both sides.
+    //!  @p profile defines length of decimation filter.
+    IntegerRatioResampler(const core::SharedPtr<IResampler>& inner_resampler,
+                          core::IArena& arena,
+                          FrameFactory& frame_factory,
+                          ResamplerProfile profile,
+                          const SampleSpec& in_spec,
+                          const SampleSpec& out_spec);
+
+    //! Check if object is successfully constructed.
+    virtual bool is_valid() const;
+
+    //! Set new resample factor.
+    //! @remarks
+    //!  Input and output rates can't be changed, only multiplier.
+    virtual bool set_scaling(size_t input_rate, size_t output_rate, float multiplier);
+
+    //! Get buffer to be filled with input data.
+    virtual const core::Slice<sample_t>& begin_push_input();
+
+    //! Commit buffer with input data.
+    virtual void end_push_input();
+
+    //! Read samples from input frame and fill output frame.
+    virtual size_t pop_output(sample_t* out_data, size_t out_size);
+
+    //! How many samples were pushed but not processed yet.
+    virtual float n_left_to_process() const;
+
+    //! Check if resampler can be used for given rates.
+    static bool is_supported(size_t input_rate, size_t output_rate);
+
+private:
+    bool init_filter_(ResamplerProfile profile);
+    bool init_buffers_(FrameFactory& frame_factory);
+
+    void decimate_(sample_t* out_data, size_t out_size);
+
+    const core::SharedPtr<IResampler> inner_resampler_;
+
+    const SampleSpec in_spec_;
+    const SampleSpec out_spec_;
+
+    const size_t num_ch_;
+    const size_t factor_;
+
+    // half of filter length, in input samples per channel;
+    // filter has 2 * half_len_ + 1 taps, centered around current sample
+    size_t half_len_;
+
+    // non-zero coefficients of one half of symmetric filter, and distances
+    // of corresponding taps from center, in input samples per channel
+    core::Array<sample_t> coeffs_;
+    core::Array<size_t> offsets_;
+    sample_t center_coeff_;
+
+    // input frame pushed by caller
+    core::Slice<sample_t> in_frame_;
+
+    // filter history (last 2 * half_len_ input samples) followed by
+    // copy of input frame
+    core::Array<sample_t> in_buf_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_INTEGER_RATIO_RESAMPLER_H_
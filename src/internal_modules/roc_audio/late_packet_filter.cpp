@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/late_packet_filter.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace audio {
+
+LatePacketFilter::LatePacketFilter(packet::IWriter& writer, IFrameDecoder& decoder)
+    : writer_(writer)
+    , decoder_(decoder)
+    , has_position_(false)
+    , position_(0)
+    , has_block_(false)
+    , block_(0)
+    , n_dropped_(0) {
+}
+
+void LatePacketFilter::set_playback_position(packet::stream_timestamp_t position) {
+    has_position_ = true;
+    position_ = position;
+}
+
+void LatePacketFilter::set_fec_block(packet::blknum_t sbn) {
+    has_block_ = true;
+    block_ = sbn;
+}
+
+uint64_t LatePacketFilter::num_dropped() const {
+    return n_dropped_;
+}
+
+status::StatusCode LatePacketFilter::write(const packet::PacketPtr& packet) {
+    const packet::RTP* rtp = packet->rtp();
+
+    if (!has_position_ || !rtp) {
+        return writer_.write(packet);
+    }
+
+    // Duration is normally populated later by rtp::Filter. Don't store it in
+    // packet here, to keep packets in queue the same as without this filter.
+    packet::stream_timestamp_t duration = rtp->duration;
+    if (duration == 0) {
+        duration = (packet::stream_timestamp_t)decoder_.decoded_sample_count(
+            rtp->payload.data(), rtp->payload.size());
+    }
+
+    const packet::stream_timestamp_t pkt_end = rtp->stream_timestamp + duration;
+
+    if (!packet::stream_timestamp_le(pkt_end, position_)) {
+        return writer_.write(packet);
+    }
+
+    const packet::FEC* fec = packet->fec();
+
+    if (fec
+        && (!has_block_ || !packet::blknum_lt(fec->source_block_number, block_))) {
+        // FEC reader didn't pass packet's block yet and may need it for repair.
+        return writer_.write(packet);
+    }
+
+    roc_log(LogTrace,
+            "late packet filter: dropping late packet:"
+            " pkt_sn=%lu pkt_ts=%lu pkt_end=%lu play_pos=%lu",
+            (unsigned long)rtp->seqnum, (unsigned long)rtp->stream_timestamp,
+            (unsigned long)pkt_end, (unsigned long)position_);
+
+    n_dropped_++;
+    return status::StatusOK;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/late_packet_filter.h
+//! @brief Late packet filter.
+
+#ifndef ROC_AUDIO_LATE_PACKET_FILTER_H_
+#define ROC_AUDIO_LATE_PACKET_FILTER_H_
+
+#include "roc_audio/iframe_decoder.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Late packet filter.
+//!
+//! Drops incoming packets that end before current playback position, i.e.
+//! packets that depacketizer would drop anyway. Placed in front of incoming
+//! queue, it saves the cost of queuing them and passing them through the
+//! rest of the pipeline.
+//!
+//! Late packets that belong to FEC block are dropped only if their block was
+//! already passed by FEC reader, because until then FEC reader may still need
+//! them to repair other packets of the block. If FEC block is not set, late
+//! FEC packets are passed through.
+//!
+//! Until playback position is set, all packets are passed through.
+class LatePacketFilter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p decoder is used to compute packet duration, if it's not known yet.
+    LatePacketFilter(packet::IWriter& writer, IFrameDecoder& decoder);
+
+    //! Set playback position.
+    //! @remarks
+    //!  Packets ending before or at @p position will be dropped.
+    void set_playback_position(packet::stream_timestamp_t position);
+
+    //! Set current FEC block.
+    //! @remarks
+    //!  Late FEC packets from blocks preceding @p sbn will be dropped.
+    void set_fec_block(packet::blknum_t sbn);
+
+    //! Get number of packets dropped so far.
+    uint64_t num_dropped() const;
+
+    //! Write packet.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
+
+private:
+    packet::IWriter& writer_;
+    IFrameDecoder& decoder_;
+
+    bool has_position_;
+    packet::stream_timestamp_t position_;
+
+    bool has_block_;
+    packet::blknum_t block_;
+
+    uint64_t n_dropped_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LATE_PACKET_FILTER_H_
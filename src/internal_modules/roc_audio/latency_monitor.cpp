@@ -8,6 +8,7 @@
 
 #include "roc_audio/latency_monitor.h"
 #include "roc_audio/freq_estimator.h"
+#include "roc_core/cached_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
@@ -32,7 +33,14 @@ LatencyMonitor::LatencyMonitor(IFrameReader& frame_reader,
     , link_meter_(link_meter)
     , resampler_(resampler)
     , enable_scaling_(config.tuner_profile != audio::LatencyTunerProfile_Intact)
+    , passthrough_(false)
     , capture_ts_(0)
+    , sync_playback_(config.sync_playback)
+    , sync_target_(config.target_latency)
+    , sync_tolerance_(config.sync_tolerance)
+    , has_new_e2e_(false)
+    , sync_pending_(false)
+    , sync_frames_(0)
     , packet_sample_spec_(packet_sample_spec)
     , frame_sample_spec_(frame_sample_spec)
     , alive_(true)
@@ -41,6 +49,19 @@ LatencyMonitor::LatencyMonitor(IFrameReader& frame_reader,
         return;
     }
 
+    if (sync_playback_
+        && (config.tuner_backend != LatencyTunerBackend_E2e || sync_target_ <= 0
+            || sync_tolerance_ <= 0)) {
+        roc_log(LogError,
+                "latency monitor: invalid config: sync_playback requires e2e backend,"
+                " target_latency and sync_tolerance: backend=%s target=%.3fms"
+                " tolerance=%.3fms",
+                latency_tuner_backend_to_str(config.tuner_backend),
+                (double)sync_target_ / core::Millisecond,
+                (double)sync_tolerance_ / core::Millisecond);
+        return;
+    }
+
     if (enable_scaling_) {
         if (!init_scaling_()) {
             return;
@@ -66,10 +87,28 @@ const LatencyMetrics& LatencyMonitor::metrics() const {
     return latency_metrics_;
 }
 
+bool LatencyMonitor::has_playback_position() const {
+    roc_panic_if(!is_valid());
+
+    return depacketizer_.is_started();
+}
+
+packet::stream_timestamp_t LatencyMonitor::playback_position() const {
+    roc_panic_if(!is_valid());
+
+    return depacketizer_.next_timestamp();
+}
+
 bool LatencyMonitor::read(Frame& frame) {
     roc_panic_if(!is_valid());
 
-    if (alive_) {
+    if (alive_ && sync_playback_) {
+        if (check_sync_(frame)) {
+            return step_sync_(frame);
+        }
+    }
+
+    if (alive_ && !sync_pending_ && tuner_.need_update()) {
         compute_niq_latency_();
         query_link_meter_();
 
@@ -101,6 +140,43 @@ bool LatencyMonitor::reclock(const core::nanoseconds_t playback_timestamp) {
     return true;
 }
 
+LatencyTunerState LatencyMonitor::save_state() const {
+    roc_panic_if(!is_valid());
+
+    return tuner_.save_state();
+}
+
+void LatencyMonitor::restore_state(const LatencyTunerState& state) {
+    roc_panic_if(!is_valid());
+
+    tuner_.restore_state(state);
+}
+
+bool LatencyMonitor::need_resampler() const {
+    roc_panic_if(!is_valid());
+
+    return passthrough_ && !tuner_.is_clock_locked() && !resampler_->has_resampler();
+}
+
+void LatencyMonitor::set_clock_group(const core::SharedPtr<ClockGroup>& group) {
+    roc_panic_if(!is_valid());
+
+    tuner_.set_clock_group(group);
+}
+
+bool LatencyMonitor::set_target_latency(core::nanoseconds_t target_latency) {
+    roc_panic_if(!is_valid());
+
+    if (sync_playback_) {
+        roc_log(LogError,
+                "latency monitor: can't set target latency,"
+                " it's defined by synchronized playback");
+        return false;
+    }
+
+    return tuner_.set_target_latency(target_latency);
+}
+
 bool LatencyMonitor::pre_process_(const Frame& frame) {
     tuner_.write_metrics(latency_metrics_, link_metrics_);
 
@@ -109,6 +185,9 @@ bool LatencyMonitor::pre_process_(const Frame& frame) {
         return false;
     }
 
+    // target may be adjusted by tuner if latency budget is enabled
+    latency_metrics_.target_latency = tuner_.target_latency();
+
     if (enable_scaling_) {
         if (!update_scaling_()) {
             // TODO(gh-183): forward status code
@@ -127,6 +206,79 @@ void LatencyMonitor::post_process_(const Frame& frame) {
     tuner_.advance_stream(frame.duration());
 }
 
+// Returns true if playback should be stepped during this read.
+bool LatencyMonitor::check_sync_(const Frame& frame) {
+    if (sync_frames_ != 0) {
+        return true;
+    }
+
+    if (!has_new_e2e_) {
+        return false;
+    }
+    has_new_e2e_ = false;
+    sync_pending_ = false;
+
+    const core::nanoseconds_t deviation = latency_metrics_.e2e_latency - sync_target_;
+    if (deviation >= -sync_tolerance_ && deviation <= sync_tolerance_) {
+        return false;
+    }
+
+    const core::nanoseconds_t frame_len =
+        frame_sample_spec_.samples_overall_2_ns(frame.num_raw_samples());
+    if (frame_len <= 0) {
+        return false;
+    }
+
+    // Round to whole frames, remainder is left to tuner.
+    const core::nanoseconds_t abs_deviation = deviation > 0 ? deviation : -deviation;
+    const long n_frames = long((abs_deviation + frame_len / 2) / frame_len);
+    if (n_frames == 0) {
+        return false;
+    }
+
+    roc_log(LogInfo,
+            "latency monitor: stepping playback to sync with target:"
+            " e2e_latency=%.3fms target_latency=%.3fms %s=%ld frames",
+            (double)latency_metrics_.e2e_latency / core::Millisecond,
+            (double)sync_target_ / core::Millisecond,
+            deviation > 0 ? "drop" : "insert", n_frames);
+
+    // If playback is late, drop frames, if early, insert silence.
+    sync_frames_ = deviation > 0 ? -n_frames : n_frames;
+    sync_pending_ = true;
+
+    return true;
+}
+
+bool LatencyMonitor::step_sync_(Frame& frame) {
+    if (sync_frames_ > 0) {
+        memset(frame.raw_samples(), 0, frame.num_raw_samples() * sizeof(sample_t));
+
+        frame.set_flags(Frame::FlagSilent);
+        frame.set_duration(packet::stream_timestamp_t(
+            frame.num_raw_samples() / frame_sample_spec_.num_channels()));
+        frame.set_capture_timestamp(0);
+
+        sync_frames_--;
+    } else {
+        for (; sync_frames_ < 0; sync_frames_++) {
+            if (!frame_reader_.read(frame)) {
+                sync_frames_ = 0;
+                return false;
+            }
+            tuner_.advance_stream(frame.duration());
+        }
+
+        if (!frame_reader_.read(frame)) {
+            return false;
+        }
+    }
+
+    post_process_(frame);
+
+    return true;
+}
+
 void LatencyMonitor::compute_niq_latency_() {
     if (!depacketizer_.is_started()) {
         return;
@@ -155,7 +307,7 @@ void LatencyMonitor::compute_niq_latency_() {
 
     // compute delay since last packet
     const core::nanoseconds_t rts = latest_packet->receive_timestamp();
-    const core::nanoseconds_t now = core::timestamp(core::ClockUnix);
+    const core::nanoseconds_t now = core::CachedClock::now(core::ClockUnix);
 
     if (rts > 0 && rts < now) {
         latency_metrics_.niq_stalling = now - rts;
@@ -175,6 +327,7 @@ void LatencyMonitor::compute_e2e_latency_(const core::nanoseconds_t playback_tim
     // time when first sample of that frame was captured on sender
     // (both timestamps are in receiver clock domain)
     latency_metrics_.e2e_latency = playback_timestamp - capture_ts_;
+    has_new_e2e_ = true;
 }
 
 void LatencyMonitor::query_link_meter_() {
@@ -193,12 +346,38 @@ bool LatencyMonitor::init_scaling_() {
         return false;
     }
 
+    if (tuner_.is_clock_locked()) {
+        if (resampler_->set_passthrough(true)) {
+            roc_log(LogDebug, "latency monitor: clocks are locked, bypassing resampler");
+            passthrough_ = true;
+        } else {
+            // Resampler is still needed to convert rate, but scaling will
+            // stay intact while clocks are locked.
+            roc_log(LogDebug,
+                    "latency monitor: clocks are locked, but resampler can't be"
+                    " bypassed because of rate conversion");
+        }
+    }
+
     return true;
 }
 
 bool LatencyMonitor::update_scaling_() {
     roc_panic_if_not(resampler_);
 
+    if (passthrough_ && !tuner_.is_clock_locked()) {
+        if (!resampler_->has_resampler()) {
+            // Wait until pipeline allocates resampler, see need_resampler().
+            return true;
+        }
+
+        roc_log(LogInfo, "latency monitor: clock drift detected, enabling resampler");
+        if (!resampler_->set_passthrough(false)) {
+            return false;
+        }
+        passthrough_ = false;
+    }
+
     const float scaling = tuner_.fetch_scaling();
     if (scaling > 0) {
         if (!resampler_->set_scaling(scaling)) {
@@ -53,8 +53,19 @@ namespace audio {
 //!    which is E2E latency
 //!  - latency monitor has an instance of LatencyTuner; it continuously passes
 //!    calculated latencies to it, and obtains scaling factor for resampler
+//!  - to reduce per-frame overhead, NIQ latency is recomputed only when tuner
+//!    needs an update, i.e. once per update interval while latency is steady,
+//!    and on every frame when it deviates from target
 //!  - latency monitor has a reference to resampler, and periodically passes
 //!    updated scaling factor to it
+//!  - if clocks are configured as locked, resampler is bypassed until tuner
+//!    detects clock drift, and then it is switched back to resampling mode;
+//!    if resampler reader was created without resampler, pipeline allocates
+//!    it at that moment, see need_resampler()
+//!  - if playback is synchronized, and E2E latency deviates from target too
+//!    much, latency monitor steps playback to target by producing silence
+//!    frames or dropping frames, and doesn't pass latency to tuner until
+//!    E2E latency is measured again
 //!  - pipeline also can query latency monitor for latency metrics on behalf of
 //!    request from user or to report them to sender via RTCP
 class LatencyMonitor : public IFrameReader, public core::NonCopyable<> {
@@ -78,6 +89,18 @@ public:
     //! Get metrics.
     const LatencyMetrics& metrics() const;
 
+    //! Check if playback position is known.
+    //! @remarks
+    //!  Becomes true when depacketizer starts playing packets.
+    bool has_playback_position() const;
+
+    //! Get playback position.
+    //! @remarks
+    //!  Returns stream timestamp of the next sample to be taken from packets.
+    //!  Packets ending before it won't be played anymore.
+    //!  has_playback_position() should return true.
+    packet::stream_timestamp_t playback_position() const;
+
     //! Read audio frame from a pipeline.
     //! @remarks
     //!  Forwards frame from underlying reader as-is.
@@ -91,7 +114,39 @@ public:
     //!  false if the session is ended
     bool reclock(core::nanoseconds_t playback_timestamp);
 
+    //! Save latency tuner state.
+    LatencyTunerState save_state() const;
+
+    //! Restore latency tuner state.
+    //! @remarks
+    //!  Should be called before first read. Restored scaling is passed
+    //!  to resampler during first read.
+    void restore_state(const LatencyTunerState& state);
+
+    //! Check if resampler should be passed to resampler reader.
+    //! @remarks
+    //!  Returns true if clock drift was detected, but resampler reader was
+    //!  created without resampler. Until pipeline passes resampler to it,
+    //!  resampler stays bypassed and scaling is not applied.
+    bool need_resampler() const;
+
+    //! Share clock drift estimate with other monitors of the group.
+    //! @remarks
+    //!  See LatencyTuner::set_clock_group().
+    void set_clock_group(const core::SharedPtr<ClockGroup>& group);
+
+    //! Set new target latency.
+    //! @remarks
+    //!  Latency tuner moves target gradually, see LatencyTuner.
+    //! @returns
+    //!  false if target can't be changed, e.g. in synchronized playback
+    //!  mode, where target is defined by playback time.
+    ROC_ATTR_NODISCARD bool set_target_latency(core::nanoseconds_t target_latency);
+
 private:
+    bool check_sync_(const Frame& frame);
+    bool step_sync_(Frame& frame);
+
     void compute_niq_latency_();
     void compute_e2e_latency_(core::nanoseconds_t playback_timestamp);
     void query_link_meter_();
@@ -115,9 +170,20 @@ private:
 
     ResamplerReader* resampler_;
     const bool enable_scaling_;
+    bool passthrough_;
 
     core::nanoseconds_t capture_ts_;
 
+    const bool sync_playback_;
+    const core::nanoseconds_t sync_target_;
+    const core::nanoseconds_t sync_tolerance_;
+    // E2E latency was computed since last sync check.
+    bool has_new_e2e_;
+    // Waiting for E2E latency measured after step.
+    bool sync_pending_;
+    // Frames to drop (negative) or silence frames to insert (positive).
+    long sync_frames_;
+
     const SampleSpec packet_sample_spec_;
     const SampleSpec frame_sample_spec_;
 
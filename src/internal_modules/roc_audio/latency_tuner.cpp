@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/latency_tuner.h"
+#include "roc_audio/clock_group.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/time.h"
@@ -18,13 +19,30 @@ namespace {
 
 const core::nanoseconds_t LogInterval = 5 * core::Second;
 
+// How often target latency is moved towards latency budget or towards
+// target set via set_target_latency().
+const core::nanoseconds_t RetargetInterval = core::Second;
+
+// Minimum target latency when latency budget is enabled, in units of
+// network jitter and in absolute units.
+const int BudgetJitterFactor = 4;
+const core::nanoseconds_t BudgetMinTarget = core::Millisecond;
+
 } // namespace
 
 void LatencyConfig::deduce_defaults(core::nanoseconds_t default_target_latency,
                                     bool is_receiver) {
     // Deduce defaults for backend and profile.
     if (tuner_backend == LatencyTunerBackend_Default) {
-        tuner_backend = LatencyTunerBackend_Niq;
+        // Synchronized playback is defined in terms of e2e latency.
+        tuner_backend =
+            sync_playback ? LatencyTunerBackend_E2e : LatencyTunerBackend_Niq;
+    }
+
+    // With latency budget, initial target latency is just a guess, which is
+    // corrected when latency outside of the queue is measured.
+    if (latency_budget > 0 && target_latency == 0 && is_receiver) {
+        target_latency = latency_budget / 2;
     }
 
     if (tuner_profile == LatencyTunerProfile_Default) {
@@ -119,6 +137,33 @@ void LatencyConfig::deduce_defaults(core::nanoseconds_t default_target_latency,
         if (scaling_tolerance == 0) {
             scaling_tolerance = 0.005f;
         }
+
+        // Deduce default for locked_drift_tolerance.
+        if (locked_clocks && locked_drift_tolerance == 0) {
+            // Locked clocks have virtually no drift, so any persistent deviation
+            // notably above estimator noise means that clocks are not locked.
+            locked_drift_tolerance = std::min(0.0001f, scaling_tolerance);
+        }
+    }
+
+    // Deduce default for update_interval.
+    if (update_interval == 0) {
+        if (scaling_interval > 0) {
+            // Frequency estimator consumes one latency value per scaling interval,
+            // there is no point in computing metrics more often.
+            update_interval = scaling_interval;
+        } else {
+            update_interval = 10 * core::Millisecond;
+        }
+    }
+
+    // Deduce default for sync_tolerance.
+    if (sync_playback && sync_tolerance == 0) {
+        // Step well before latency goes out of bounds and session is terminated.
+        sync_tolerance = 10 * core::Millisecond;
+        if (latency_tolerance > 0) {
+            sync_tolerance = std::min(sync_tolerance, latency_tolerance / 2);
+        }
     }
 
     // If latency bounding is enabled.
@@ -141,11 +186,17 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
     : stream_pos_(0)
     , scale_interval_(0)
     , scale_pos_(0)
+    , update_interval_(0)
+    , update_pos_(0)
+    , is_steady_(false)
     , report_interval_(sample_spec.ns_2_stream_timestamp_delta(LogInterval))
     , report_pos_(0)
     , has_new_freq_coeff_(false)
     , freq_coeff_(0)
     , freq_coeff_max_delta_(config.scaling_tolerance)
+    , clock_locked_(config.locked_clocks
+                    && config.tuner_profile != audio::LatencyTunerProfile_Intact)
+    , locked_max_delta_(config.locked_drift_tolerance)
     , backend_(config.tuner_backend)
     , profile_(config.tuner_profile)
     , enable_tuning_(config.tuner_profile != audio::LatencyTunerProfile_Intact)
@@ -162,24 +213,54 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
     , min_latency_(0)
     , max_latency_(0)
     , max_stalling_(0)
+    , min_steady_latency_(0)
+    , max_steady_latency_(0)
+    , enable_budget_(config.latency_budget > 0)
+    , latency_budget_(0)
+    , latency_tolerance_(0)
+    , min_budget_target_(0)
+    , retarget_interval_(0)
+    , retarget_pos_(0)
+    , has_pending_target_(false)
+    , pending_target_(0)
+    , has_overhead_(false)
+    , max_overhead_(0)
     , sample_spec_(sample_spec)
     , valid_(false) {
     roc_log(LogDebug,
             "latency tuner: initializing:"
-            " target_latency=%ld(%.3fms) latency_tolerance=%ld(%.3fms)"
-            " stale_tolerance=%ld(%.3fms)"
+            " target_latency=%ld(%.3fms) latency_budget=%ld(%.3fms)"
+            " latency_tolerance=%ld(%.3fms) stale_tolerance=%ld(%.3fms)"
             " scaling_interval=%ld(%.3fms) scaling_tolerance=%f"
-            " backend=%s profile=%s",
+            " update_interval=%ld(%.3fms) backend=%s profile=%s"
+            " locked_clocks=%d locked_drift_tolerance=%f",
             (long)sample_spec_.ns_2_stream_timestamp_delta(config.target_latency),
             (double)config.target_latency / core::Millisecond,
+            (long)sample_spec_.ns_2_stream_timestamp_delta(config.latency_budget),
+            (double)config.latency_budget / core::Millisecond,
             (long)sample_spec_.ns_2_stream_timestamp_delta(config.latency_tolerance),
             (double)config.latency_tolerance / core::Millisecond,
             (long)sample_spec_.ns_2_stream_timestamp_delta(config.stale_tolerance),
             (double)config.stale_tolerance / core::Millisecond,
             (long)sample_spec_.ns_2_stream_timestamp_delta(config.scaling_interval),
             (double)config.scaling_interval / core::Millisecond,
-            (double)config.scaling_tolerance, latency_tuner_backend_to_str(backend_),
-            latency_tuner_profile_to_str(profile_));
+            (double)config.scaling_tolerance,
+            (long)sample_spec_.ns_2_stream_timestamp_delta(config.update_interval),
+            (double)config.update_interval / core::Millisecond,
+            latency_tuner_backend_to_str(backend_),
+            latency_tuner_profile_to_str(profile_), (int)config.locked_clocks,
+            (double)config.locked_drift_tolerance);
+
+    if (config.update_interval < 0) {
+        roc_log(LogError,
+                "latency tuner: invalid config: update_interval is out of bounds:"
+                " update_interval=%ld(%.3fms)",
+                (long)sample_spec_.ns_2_stream_timestamp_delta(config.update_interval),
+                (double)config.update_interval / core::Millisecond);
+        return;
+    }
+
+    update_interval_ = sample_spec_.ns_2_stream_timestamp_delta(config.update_interval);
 
     if (config.target_latency < 0) {
         roc_log(LogError,
@@ -188,6 +269,26 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
         return;
     }
 
+    if (config.latency_budget < 0) {
+        roc_log(LogError,
+                "latency tuner: invalid config: latency_budget is invalid:"
+                " latency_budget=%ld(%.3fms)",
+                (long)sample_spec_.ns_2_stream_timestamp_delta(config.latency_budget),
+                (double)config.latency_budget / core::Millisecond);
+        return;
+    }
+
+    if (enable_budget_
+        && (!enable_tuning_ || backend_ != audio::LatencyTunerBackend_Niq)) {
+        roc_log(LogError,
+                "latency tuner: invalid config:"
+                " latency_budget requires niq backend and enabled tuning:"
+                " backend=%s profile=%s",
+                latency_tuner_backend_to_str(backend_),
+                latency_tuner_profile_to_str(profile_));
+        return;
+    }
+
     if (enable_bounds_ || enable_tuning_) {
         target_latency_ = sample_spec_.ns_2_stream_timestamp_delta(config.target_latency);
 
@@ -208,6 +309,16 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
             max_stalling_ =
                 sample_spec_.ns_2_stream_timestamp_delta(config.stale_tolerance);
 
+            // Steady band is inner half of allowed latency range.
+            min_steady_latency_ = target_latency_ - (target_latency_ - min_latency_) / 2;
+            max_steady_latency_ = target_latency_ + (max_latency_ - target_latency_) / 2;
+
+            // Ensure that latency can't leave steady band and go out of bounds
+            // between two updates.
+            update_interval_ = std::min(
+                update_interval_,
+                sample_spec_.ns_2_stream_timestamp_delta(config.latency_tolerance) / 4);
+
             if (config.latency_tolerance < 0) {
                 roc_log(LogError,
                         "latency tuner: invalid config: latency_tolerance is invalid:"
@@ -217,6 +328,12 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
                         (double)config.latency_tolerance / core::Millisecond);
                 return;
             }
+
+            latency_tolerance_ =
+                sample_spec_.ns_2_stream_timestamp_delta(config.latency_tolerance);
+            retarget_interval_ =
+                sample_spec_.ns_2_stream_timestamp_delta(RetargetInterval);
+            retarget_pos_ = (packet::stream_timestamp_t)retarget_interval_;
         }
 
         if (enable_tuning_) {
@@ -243,6 +360,15 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
                 return;
             }
 
+            if (clock_locked_ && config.locked_drift_tolerance <= 0) {
+                roc_log(LogError,
+                        "latency tuner: invalid config:"
+                        " locked_drift_tolerance is out of bounds:"
+                        " locked_drift_tolerance=%f",
+                        (double)config.locked_drift_tolerance);
+                return;
+            }
+
             fe_.reset(new (fe_)
                           FreqEstimator(profile_ == LatencyTunerProfile_Responsive
                                             ? FreqEstimatorProfile_Responsive
@@ -252,11 +378,24 @@ LatencyTuner::LatencyTuner(const LatencyConfig& config, const SampleSpec& sample
                 return;
             }
         }
+
+        if (enable_budget_) {
+            latency_budget_ =
+                sample_spec_.ns_2_stream_timestamp_delta(config.latency_budget);
+            min_budget_target_ =
+                sample_spec_.ns_2_stream_timestamp_delta(BudgetMinTarget);
+        }
     }
 
     valid_ = true;
 }
 
+LatencyTuner::~LatencyTuner() {
+    if (clock_group_) {
+        clock_group_->leave(this);
+    }
+}
+
 bool LatencyTuner::is_valid() const {
     return valid_;
 }
@@ -286,6 +425,16 @@ void LatencyTuner::write_metrics(const LatencyMetrics& latency_metrics,
     }
 }
 
+bool LatencyTuner::need_update() const {
+    roc_panic_if(!is_valid());
+
+    if (!is_steady_ || update_interval_ <= 0) {
+        return true;
+    }
+
+    return !packet::stream_timestamp_lt(stream_pos_, update_pos_);
+}
+
 bool LatencyTuner::update_stream() {
     roc_panic_if(!is_valid());
 
@@ -320,6 +469,16 @@ bool LatencyTuner::update_stream() {
         compute_scaling_(latency);
     }
 
+    is_steady_ = !enable_bounds_
+        || (latency >= min_steady_latency_ && latency <= max_steady_latency_);
+    update_pos_ = stream_pos_ + (packet::stream_timestamp_t)update_interval_;
+
+    if (enable_budget_) {
+        update_budget_();
+    } else if (has_pending_target_) {
+        update_pending_target_();
+    }
+
     return true;
 }
 
@@ -342,6 +501,96 @@ float LatencyTuner::fetch_scaling() {
     return freq_coeff_;
 }
 
+core::nanoseconds_t LatencyTuner::target_latency() const {
+    roc_panic_if(!is_valid());
+
+    return sample_spec_.stream_timestamp_delta_2_ns(target_latency_);
+}
+
+bool LatencyTuner::set_target_latency(core::nanoseconds_t target_latency) {
+    roc_panic_if(!is_valid());
+
+    if (enable_budget_) {
+        roc_log(LogError,
+                "latency tuner: can't set target latency when latency budget is used");
+        return false;
+    }
+
+    const packet::stream_timestamp_diff_t new_target =
+        sample_spec_.ns_2_stream_timestamp_delta(target_latency);
+
+    if (target_latency <= 0 || new_target <= 0) {
+        roc_log(LogError,
+                "latency tuner: can't set target latency: invalid value:"
+                " target_latency=%ld(%.3fms)",
+                (long)new_target, (double)target_latency / core::Millisecond);
+        return false;
+    }
+
+    roc_log(LogDebug,
+            "latency tuner: requested new target latency:"
+            " old_target=%ld(%.3fms) new_target=%ld(%.3fms)",
+            (long)target_latency_,
+            sample_spec_.stream_timestamp_delta_2_ms(target_latency_), (long)new_target,
+            sample_spec_.stream_timestamp_delta_2_ms(new_target));
+
+    if (!enable_bounds_) {
+        // Target is not used for anything, no need to slew.
+        target_latency_ = new_target;
+        return true;
+    }
+
+    pending_target_ = new_target;
+    has_pending_target_ = true;
+
+    return true;
+}
+
+bool LatencyTuner::is_clock_locked() const {
+    roc_panic_if(!is_valid());
+
+    return clock_locked_;
+}
+
+LatencyTunerState LatencyTuner::save_state() const {
+    roc_panic_if(!is_valid());
+
+    LatencyTunerState state;
+
+    if (enable_tuning_ && freq_coeff_ > 0) {
+        state.fe_state = fe_->save_state();
+        state.freq_coeff = freq_coeff_;
+    }
+
+    return state;
+}
+
+void LatencyTuner::restore_state(const LatencyTunerState& state) {
+    roc_panic_if(!is_valid());
+
+    if (!enable_tuning_ || state.freq_coeff <= 0) {
+        return;
+    }
+
+    fe_->restore_state(state.fe_state);
+
+    set_freq_coeff_(state.freq_coeff);
+}
+
+void LatencyTuner::set_clock_group(const core::SharedPtr<ClockGroup>& group) {
+    roc_panic_if(!is_valid());
+
+    if (!enable_tuning_ || clock_group_ == group) {
+        return;
+    }
+
+    if (clock_group_) {
+        clock_group_->leave(this);
+    }
+
+    clock_group_ = group;
+}
+
 bool LatencyTuner::check_bounds_(const packet::stream_timestamp_diff_t latency) {
     // Queue is considered "stalling" if there were no new packets for
     // some period of time.
@@ -395,16 +644,176 @@ void LatencyTuner::compute_scaling_(packet::stream_timestamp_diff_t latency) {
         return;
     }
 
+    ClockGroup::Role role = ClockGroup::Role_Leader;
+    LatencyTunerState group_state;
+
+    if (clock_group_) {
+        role = clock_group_->claim(this, group_state);
+
+        if (role == ClockGroup::Role_NewLeader && group_state.freq_coeff > 0) {
+            // Continue from where previous leader stopped.
+            fe_->restore_state(group_state.fe_state);
+        }
+    }
+
+    // Followers still feed their estimator, to keep its filters warm in
+    // case they become leader, but ignore its output.
     while (stream_pos_ >= scale_pos_) {
         fe_->update((packet::stream_timestamp_t)latency);
         scale_pos_ += (packet::stream_timestamp_t)scale_interval_;
     }
 
-    has_new_freq_coeff_ = true;
+    if (role == ClockGroup::Role_Follower) {
+        if (group_state.freq_coeff > 0) {
+            set_freq_coeff_(group_state.freq_coeff);
+        }
+        return;
+    }
+
+    set_freq_coeff_(fe_->freq_coeff());
+
+    if (clock_group_) {
+        clock_group_->publish(this, save_state());
+    }
+}
+
+void LatencyTuner::update_budget_() {
+    if (!has_niq_latency_ || !has_e2e_latency_) {
+        return;
+    }
+
+    // Everything that is not in network incoming queue: sender buffering,
+    // network transit, frame buffering and sound device latency.
+    // Worst value during retarget interval is used.
+    const packet::stream_timestamp_diff_t overhead = e2e_latency_ - niq_latency_;
+
+    if (!has_overhead_ || overhead > max_overhead_) {
+        max_overhead_ = overhead;
+        has_overhead_ = true;
+    }
+
+    if (packet::stream_timestamp_lt(stream_pos_, retarget_pos_)) {
+        return;
+    }
+
+    retarget_pos_ = stream_pos_ + (packet::stream_timestamp_t)retarget_interval_;
+
+    const packet::stream_timestamp_diff_t window_overhead = max_overhead_;
+    has_overhead_ = false;
+
+    // Don't move target until latency converges to the current one,
+    // otherwise latency may lag behind and go out of bounds.
+    if (!is_steady_) {
+        return;
+    }
 
-    freq_coeff_ = fe_->freq_coeff();
-    freq_coeff_ = std::min(freq_coeff_, 1.0f + freq_coeff_max_delta_);
-    freq_coeff_ = std::max(freq_coeff_, 1.0f - freq_coeff_max_delta_);
+    // Queue gets what is left from the budget, but it should stay deep
+    // enough to absorb network jitter, even if budget can't be met then.
+    const packet::stream_timestamp_diff_t min_target =
+        std::max(min_budget_target_, jitter_ * BudgetJitterFactor);
+
+    packet::stream_timestamp_diff_t new_target = latency_budget_ - window_overhead;
+    if (new_target < min_target) {
+        new_target = min_target;
+    }
+
+    // Move target gradually, so that latency, which is in steady band of the
+    // current target, stays within bounds of the new target.
+    const packet::stream_timestamp_diff_t max_step =
+        std::max(latency_tolerance_ / 4, (packet::stream_timestamp_diff_t)1);
+
+    new_target = std::min(new_target, target_latency_ + max_step);
+    new_target = std::max(new_target, target_latency_ - max_step);
+
+    // Ignore small corrections to avoid hunting.
+    if (std::abs(new_target - target_latency_) <= target_latency_ / 20) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "latency tuner: adjusting target latency to budget:"
+            " old_target=%ld(%.3fms) new_target=%ld(%.3fms)"
+            " budget=%ld(%.3fms) overhead=%ld(%.3fms) jitter=%ld(%.3fms)",
+            (long)target_latency_,
+            sample_spec_.stream_timestamp_delta_2_ms(target_latency_), (long)new_target,
+            sample_spec_.stream_timestamp_delta_2_ms(new_target), (long)latency_budget_,
+            sample_spec_.stream_timestamp_delta_2_ms(latency_budget_),
+            (long)window_overhead,
+            sample_spec_.stream_timestamp_delta_2_ms(window_overhead), (long)jitter_,
+            sample_spec_.stream_timestamp_delta_2_ms(jitter_));
+
+    set_target_latency_(new_target);
+}
+
+void LatencyTuner::update_pending_target_() {
+    if (packet::stream_timestamp_lt(stream_pos_, retarget_pos_)) {
+        return;
+    }
+
+    retarget_pos_ = stream_pos_ + (packet::stream_timestamp_t)retarget_interval_;
+
+    // Same as with budget, move target gradually and only after latency
+    // converged to the current one, so that it never goes out of bounds.
+    if (!is_steady_) {
+        return;
+    }
+
+    const packet::stream_timestamp_diff_t max_step =
+        std::max(latency_tolerance_ / 4, (packet::stream_timestamp_diff_t)1);
+
+    packet::stream_timestamp_diff_t new_target = pending_target_;
+    new_target = std::min(new_target, target_latency_ + max_step);
+    new_target = std::max(new_target, target_latency_ - max_step);
+
+    if (new_target == pending_target_) {
+        has_pending_target_ = false;
+    }
+
+    roc_log(LogDebug,
+            "latency tuner: moving target latency:"
+            " old_target=%ld(%.3fms) new_target=%ld(%.3fms) final_target=%ld(%.3fms)",
+            (long)target_latency_,
+            sample_spec_.stream_timestamp_delta_2_ms(target_latency_), (long)new_target,
+            sample_spec_.stream_timestamp_delta_2_ms(new_target), (long)pending_target_,
+            sample_spec_.stream_timestamp_delta_2_ms(pending_target_));
+
+    set_target_latency_(new_target);
+}
+
+void LatencyTuner::set_target_latency_(packet::stream_timestamp_diff_t target_latency) {
+    target_latency_ = target_latency;
+
+    min_latency_ = target_latency_ - latency_tolerance_;
+    max_latency_ = target_latency_ + latency_tolerance_;
+
+    min_steady_latency_ = target_latency_ - latency_tolerance_ / 2;
+    max_steady_latency_ = target_latency_ + latency_tolerance_ / 2;
+
+    if (fe_) {
+        fe_->set_target_latency((packet::stream_timestamp_t)target_latency_);
+    }
+}
+
+void LatencyTuner::set_freq_coeff_(float freq_coeff) {
+    freq_coeff = std::min(freq_coeff, 1.0f + freq_coeff_max_delta_);
+    freq_coeff = std::max(freq_coeff, 1.0f - freq_coeff_max_delta_);
+
+    if (clock_locked_) {
+        if (std::abs(freq_coeff - 1.0f) <= locked_max_delta_) {
+            // No drift, keep scaling intact.
+            return;
+        }
+
+        roc_log(LogInfo,
+                "latency tuner: detected clock drift, leaving locked mode:"
+                " freq_coeff=%.6f locked_drift_tolerance=%f",
+                (double)freq_coeff, (double)locked_max_delta_);
+
+        clock_locked_ = false;
+    }
+
+    has_new_freq_coeff_ = true;
+    freq_coeff_ = freq_coeff;
 }
 
 void LatencyTuner::report_() {
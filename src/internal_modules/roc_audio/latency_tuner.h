@@ -14,8 +14,10 @@
 
 #include "roc_audio/freq_estimator.h"
 #include "roc_audio/sample_spec.h"
+#include "roc_core/attributes.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
+#include "roc_core/shared_ptr.h"
 #include "roc_core/time.h"
 #include "roc_packet/ilink_meter.h"
 #include "roc_packet/units.h"
@@ -24,6 +26,8 @@
 namespace roc {
 namespace audio {
 
+class ClockGroup;
+
 //! Latency tuner backend.
 //! Defines which latency we monitor and tune to achieve target.
 enum LatencyTunerBackend {
@@ -80,6 +84,21 @@ struct LatencyConfig {
     //!  Negative value is an error.
     core::nanoseconds_t target_latency;
 
+    //! End-to-end latency budget.
+    //! @remarks
+    //!  If set, target_latency is adjusted at run time to keep end-to-end
+    //!  latency within the budget. Latency outside of network incoming queue
+    //!  (sender buffering, network transit, frame buffering and sound device
+    //!  latency) is measured as the difference between e2e and niq latency,
+    //!  and the remainder of the budget is given to the queue, but not less
+    //!  than needed to absorb network jitter.
+    //!  Requires niq backend, enabled tuning, and capture timestamps, so that
+    //!  e2e latency can be measured. Until it's measured, target_latency is used.
+    //! @note
+    //!  If zero, target_latency is fixed.
+    //!  Negative value is an error.
+    core::nanoseconds_t latency_budget;
+
     //! Maximum allowed deviation from target latency.
     //! @remarks
     //!  If the latency goes out of bounds, the session is terminated.
@@ -105,6 +124,17 @@ struct LatencyConfig {
     //!  Negative value is an error.
     core::nanoseconds_t scaling_interval;
 
+    //! Metrics update interval.
+    //! @remarks
+    //!  How often to recompute latency metrics and check them in tuner.
+    //!  This interval is used while latency stays in steady band around
+    //!  target; when latency deviates from target, metrics are updated
+    //!  on every frame.
+    //! @note
+    //!  If zero, default value is used.
+    //!  Negative value is an error.
+    core::nanoseconds_t update_interval;
+
     //! Maximum allowed deviation of freq_coeff from 1.0.
     //! @remarks
     //!  If the scaling goes out of bounds, it is trimmed.
@@ -114,15 +144,58 @@ struct LatencyConfig {
     //!  Negative value is an error.
     float scaling_tolerance;
 
+    //! Assume that sender and receiver clocks are locked.
+    //! @remarks
+    //!  Should be enabled when both sides are disciplined by a common clock
+    //!  source, e.g. PTP. In this mode tuner keeps scaling at 1.0 and allows
+    //!  resampler to be bypassed, while still running frequency estimator
+    //!  to validate that there is no drift. When estimated drift exceeds
+    //!  locked_drift_tolerance, scaling is enabled until end of the stream.
+    bool locked_clocks;
+
+    //! Maximum deviation of estimated freq_coeff from 1.0 in locked mode.
+    //! @remarks
+    //!  Should be lower than scaling_tolerance.
+    //! @note
+    //!  If zero, default value is used.
+    //!  Negative value is an error.
+    float locked_drift_tolerance;
+
+    //! Synchronize playback with other receivers of the same stream.
+    //! @remarks
+    //!  Every frame is played at its capture time plus target_latency. If all
+    //!  receivers have same target latency and their clocks are synchronized
+    //!  with sender (e.g. by NTP or PTP), they play in sync, and target latency
+    //!  only needs to cover the slowest receiver's path instead of being padded.
+    //!  When e2e latency deviates from target by more than sync_tolerance,
+    //!  playback is stepped to target at once by inserting silence or dropping
+    //!  frames; smaller deviations are compensated by tuner.
+    //!  Requires e2e backend and capture timestamps (i.e. RTCP).
+    bool sync_playback;
+
+    //! Maximum deviation of e2e latency from target before stepping playback.
+    //! @remarks
+    //!  Used only if sync_playback is enabled.
+    //! @note
+    //!  If zero, default value is used.
+    //!  Negative value is an error.
+    core::nanoseconds_t sync_tolerance;
+
     //! Initialize.
     LatencyConfig()
         : tuner_backend(LatencyTunerBackend_Default)
         , tuner_profile(LatencyTunerProfile_Default)
         , target_latency(0)
+        , latency_budget(0)
         , latency_tolerance(0)
         , stale_tolerance(0)
         , scaling_interval(0)
-        , scaling_tolerance(0) {
+        , update_interval(0)
+        , scaling_tolerance(0)
+        , locked_clocks(false)
+        , locked_drift_tolerance(0)
+        , sync_playback(false)
+        , sync_tolerance(0) {
     }
 
     //! Automatically fill missing settings.
@@ -144,10 +217,33 @@ struct LatencyMetrics {
     //! on receiver.
     core::nanoseconds_t e2e_latency;
 
+    //! Current target latency.
+    //! Differs from configured target latency if latency budget is enabled.
+    //! Zero if latency tuning is disabled.
+    core::nanoseconds_t target_latency;
+
     LatencyMetrics()
         : niq_latency(0)
         , niq_stalling(0)
-        , e2e_latency(0) {
+        , e2e_latency(0)
+        , target_latency(0) {
+    }
+};
+
+//! Latency tuner state.
+//! @remarks
+//!  Allows new stream from the same sender to continue from the clock drift
+//!  estimate of the previous one instead of starting from scratch.
+struct LatencyTunerState {
+    //! Frequency estimator state.
+    FreqEstimatorState fe_state;
+
+    //! Last computed scaling factor.
+    //! Zero if tuning is disabled or scaling wasn't computed yet.
+    float freq_coeff;
+
+    LatencyTunerState()
+        : freq_coeff(0) {
     }
 };
 
@@ -169,6 +265,9 @@ public:
     //! Initialize.
     LatencyTuner(const LatencyConfig& config, const SampleSpec& sample_spec);
 
+    //! Deinitialize.
+    ~LatencyTuner();
+
     //! Check if the object was initialized successfully.
     bool is_valid() const;
 
@@ -177,6 +276,13 @@ public:
     void write_metrics(const LatencyMetrics& latency_metrics,
                        const packet::LinkMetrics& link_metrics);
 
+    //! Check if stream should be updated.
+    //! @remarks
+    //!  While latency stays in steady band around target, returns true once
+    //!  per update interval, otherwise returns true always. Caller may skip
+    //!  computing metrics and calling update_stream() when it returns false.
+    bool need_update() const;
+
     //! Update stream latency and scaling.
     //! This method performs all actual work:
     //!  - depending on configured backend, selects which latency from
@@ -199,18 +305,66 @@ public:
     //!  Returned value is close to 1.0.
     float fetch_scaling();
 
+    //! Get current target latency.
+    //! @remarks
+    //!  Returns zero if latency tuning and bounding are disabled.
+    core::nanoseconds_t target_latency() const;
+
+    //! Set new target latency.
+    //! @remarks
+    //!  Target is not changed at once. Instead, update_stream() moves it
+    //!  towards the new value by a fraction of latency tolerance per second,
+    //!  and only while latency stays near the current target, so that the
+    //!  stream follows the target without going out of bounds.
+    //! @returns
+    //!  false if the value is invalid or if target is managed by latency
+    //!  budget.
+    ROC_ATTR_NODISCARD bool set_target_latency(core::nanoseconds_t target_latency);
+
+    //! Check if clocks are considered locked.
+    //! @remarks
+    //!  Returns true if locked mode is enabled and no clock drift was
+    //!  detected so far. While it returns true, fetch_scaling() never
+    //!  returns new scaling, and resampler may be bypassed.
+    bool is_clock_locked() const;
+
+    //! Save tuner state.
+    LatencyTunerState save_state() const;
+
+    //! Restore tuner state saved from another tuner.
+    //! @remarks
+    //!  Restored scaling is returned by next fetch_scaling().
+    //!  Does nothing if tuning is disabled or state has no scaling.
+    void restore_state(const LatencyTunerState& state);
+
+    //! Join clock group.
+    //! @remarks
+    //!  Tuner shares clock drift estimate with other tuners of the group,
+    //!  see ClockGroup. If tuner is already in another group, it leaves it.
+    //!  Does nothing if tuning is disabled.
+    void set_clock_group(const core::SharedPtr<ClockGroup>& group);
+
 private:
     bool check_bounds_(packet::stream_timestamp_diff_t latency);
     void compute_scaling_(packet::stream_timestamp_diff_t latency);
+    void update_budget_();
+    void update_pending_target_();
+    void set_target_latency_(packet::stream_timestamp_diff_t target_latency);
+    void set_freq_coeff_(float freq_coeff);
     void report_();
 
     core::Optional<FreqEstimator> fe_;
+    core::SharedPtr<ClockGroup> clock_group_;
 
     packet::stream_timestamp_t stream_pos_;
 
     packet::stream_timestamp_diff_t scale_interval_;
     packet::stream_timestamp_t scale_pos_;
 
+    packet::stream_timestamp_diff_t update_interval_;
+    packet::stream_timestamp_t update_pos_;
+    bool is_steady_;
+
     packet::stream_timestamp_diff_t report_interval_;
     packet::stream_timestamp_t report_pos_;
 
@@ -218,6 +372,9 @@ private:
     float freq_coeff_;
     const float freq_coeff_max_delta_;
 
+    bool clock_locked_;
+    const float locked_max_delta_;
+
     const LatencyTunerBackend backend_;
     const LatencyTunerProfile profile_;
 
@@ -239,6 +396,22 @@ private:
     packet::stream_timestamp_diff_t max_latency_;
     packet::stream_timestamp_diff_t max_stalling_;
 
+    packet::stream_timestamp_diff_t min_steady_latency_;
+    packet::stream_timestamp_diff_t max_steady_latency_;
+
+    const bool enable_budget_;
+    packet::stream_timestamp_diff_t latency_budget_;
+    packet::stream_timestamp_diff_t latency_tolerance_;
+    packet::stream_timestamp_diff_t min_budget_target_;
+    packet::stream_timestamp_diff_t retarget_interval_;
+    packet::stream_timestamp_t retarget_pos_;
+
+    bool has_pending_target_;
+    packet::stream_timestamp_diff_t pending_target_;
+
+    bool has_overhead_;
+    packet::stream_timestamp_diff_t max_overhead_;
+
     const SampleSpec sample_spec_;
 
     bool valid_;
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/loss_concealer.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Range of pitch periods: 50 Hz .. 400 Hz.
+// Shorter periods are covered by their multiples.
+const core::nanoseconds_t MinPeriod = 2500 * core::Microsecond;
+const core::nanoseconds_t MaxPeriod = 20 * core::Millisecond;
+
+// Sample rate used for coarse pitch search.
+const size_t SearchRate = 8000;
+
+} // namespace
+
+LossConcealer::LossConcealer(const SampleSpec& sample_spec,
+                             const LossConcealerConfig& config,
+                             core::IArena& arena)
+    : num_ch_(sample_spec.num_channels())
+    , min_period_(0)
+    , max_period_(0)
+    , decim_(0)
+    , max_len_(0)
+    , fade_len_(0)
+    , history_(arena)
+    , hist_size_(0)
+    , hist_pos_(0)
+    , hist_fill_(0)
+    , mono_(arena)
+    , pattern_(arena)
+    , period_(0)
+    , conceal_pos_(0)
+    , concealing_(false)
+    , valid_(false) {
+    roc_panic_if_msg(!sample_spec.is_valid() || !sample_spec.is_raw(),
+                     "loss concealer: required valid sample spec with raw format: %s",
+                     sample_spec_to_str(sample_spec).c_str());
+
+    if (config.max_duration <= 0 || config.fade_duration < 0) {
+        roc_log(LogError,
+                "loss concealer: invalid config:"
+                " max_duration=%.3fms fade_duration=%.3fms",
+                (double)config.max_duration / core::Millisecond,
+                (double)config.fade_duration / core::Millisecond);
+        return;
+    }
+
+    min_period_ = std::max(sample_spec.ns_2_samples_per_chan(MinPeriod), (size_t)1);
+    max_period_ = std::max(sample_spec.ns_2_samples_per_chan(MaxPeriod), min_period_);
+    decim_ = std::max(sample_spec.sample_rate() / SearchRate, (size_t)1);
+
+    max_len_ = sample_spec.ns_2_samples_per_chan(config.max_duration);
+    fade_len_ = sample_spec.ns_2_samples_per_chan(config.fade_duration);
+
+    // History holds analysis window and the lag before it.
+    hist_size_ = max_period_ * 2;
+
+    if (!history_.resize(hist_size_ * num_ch_) || !mono_.resize(hist_size_)
+        || !pattern_.resize(max_period_ * num_ch_)) {
+        roc_log(LogError, "loss concealer: can't allocate buffers");
+        return;
+    }
+
+    roc_log(LogDebug,
+            "loss concealer: initializing:"
+            " min_period=%lu max_period=%lu max_len=%lu fade_len=%lu",
+            (unsigned long)min_period_, (unsigned long)max_period_,
+            (unsigned long)max_len_, (unsigned long)fade_len_);
+
+    valid_ = true;
+}
+
+bool LossConcealer::is_valid() const {
+    return valid_;
+}
+
+void LossConcealer::write(sample_t* samples, size_t n_samples) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!samples && n_samples);
+
+    if (n_samples == 0) {
+        return;
+    }
+
+    if (concealing_) {
+        const size_t n_fade = std::min(n_samples, fade_len_);
+
+        for (size_t ns = 0; ns < n_fade; ns++) {
+            const sample_t w = sample_t(ns + 1) / sample_t(n_fade + 1);
+
+            for (size_t nc = 0; nc < num_ch_; nc++) {
+                sample_t& s = samples[ns * num_ch_ + nc];
+                s = s * w + concealed_sample_(conceal_pos_ + ns, nc) * (1 - w);
+            }
+        }
+
+        concealing_ = false;
+    }
+
+    append_history_(samples, n_samples);
+}
+
+size_t LossConcealer::conceal(sample_t* samples, size_t n_samples) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!samples && n_samples);
+
+    if (!concealing_) {
+        if (hist_fill_ < hist_size_) {
+            // Not enough signal to estimate pitch.
+            return 0;
+        }
+        start_concealment_();
+    }
+
+    if (conceal_pos_ >= max_len_) {
+        return 0;
+    }
+
+    const size_t n_concealed = std::min(n_samples, max_len_ - conceal_pos_);
+
+    for (size_t ns = 0; ns < n_concealed; ns++) {
+        for (size_t nc = 0; nc < num_ch_; nc++) {
+            samples[ns * num_ch_ + nc] = concealed_sample_(conceal_pos_ + ns, nc);
+        }
+    }
+
+    conceal_pos_ += n_concealed;
+
+    return n_concealed;
+}
+
+void LossConcealer::reset() {
+    roc_panic_if(!is_valid());
+
+    hist_fill_ = 0;
+    concealing_ = false;
+}
+
+void LossConcealer::append_history_(const sample_t* samples, size_t n_samples) {
+    if (n_samples > hist_size_) {
+        // Only last samples are needed.
+        samples += (n_samples - hist_size_) * num_ch_;
+        n_samples = hist_size_;
+    }
+
+    while (n_samples != 0) {
+        const size_t n = std::min(n_samples, hist_size_ - hist_pos_);
+
+        memcpy(history_.data() + hist_pos_ * num_ch_, samples,
+               n * num_ch_ * sizeof(sample_t));
+
+        hist_pos_ = (hist_pos_ + n) % hist_size_;
+        hist_fill_ = std::min(hist_fill_ + n, hist_size_);
+
+        samples += n * num_ch_;
+        n_samples -= n;
+    }
+}
+
+void LossConcealer::start_concealment_() {
+    // History is full, so hist_pos_ points to the oldest sample.
+    for (size_t ns = 0; ns < hist_size_; ns++) {
+        const sample_t* frame =
+            history_.data() + ((hist_pos_ + ns) % hist_size_) * num_ch_;
+
+        sample_t sum = 0;
+        for (size_t nc = 0; nc < num_ch_; nc++) {
+            sum += frame[nc];
+        }
+
+        mono_[ns] = sum / (sample_t)num_ch_;
+    }
+
+    period_ = find_period_();
+
+    // Repeat last period of history.
+    for (size_t ns = 0; ns < period_; ns++) {
+        const size_t hist_idx = (hist_pos_ + hist_size_ - period_ + ns) % hist_size_;
+
+        memcpy(pattern_.data() + ns * num_ch_, history_.data() + hist_idx * num_ch_,
+               num_ch_ * sizeof(sample_t));
+    }
+
+    conceal_pos_ = 0;
+    concealing_ = true;
+
+    roc_log(LogTrace, "loss concealer: starting concealment: period=%lu",
+            (unsigned long)period_);
+}
+
+// Find lag with maximum normalized correlation between the most recent
+// max_period_ samples and preceding signal. First every decim_'th lag is
+// checked on decimated signal, then lags around the best one on full signal.
+size_t LossConcealer::find_period_() {
+    size_t best_lag = max_period_;
+    double best_score = 0;
+
+    for (size_t lag = min_period_; lag <= max_period_; lag += decim_) {
+        const double score = correlate_(lag, decim_);
+        if (score > best_score) {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+
+    const size_t lo = best_lag > min_period_ + decim_ ? best_lag - decim_ : min_period_;
+    const size_t hi = std::min(best_lag + decim_, max_period_);
+
+    best_score = 0;
+
+    for (size_t lag = lo; lag <= hi; lag++) {
+        const double score = correlate_(lag, 1);
+        if (score > best_score) {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+
+    return best_lag;
+}
+
+double LossConcealer::correlate_(size_t lag, size_t step) const {
+    const sample_t* x = mono_.data() + hist_size_ - max_period_;
+    const sample_t* y = x - lag;
+
+    double xy = 0, yy = 0;
+    for (size_t ns = 0; ns < max_period_; ns += step) {
+        xy += (double)x[ns] * (double)y[ns];
+        yy += (double)y[ns] * (double)y[ns];
+    }
+
+    if (yy <= 0) {
+        return 0;
+    }
+
+    return xy / std::sqrt(yy);
+}
+
+sample_t LossConcealer::concealed_sample_(size_t pos, size_t chan) const {
+    if (pos >= max_len_) {
+        return 0;
+    }
+
+    const sample_t gain = 1 - sample_t(pos) / sample_t(max_len_);
+
+    return pattern_[(pos % period_) * num_ch_ + chan] * gain;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/loss_concealer.h
+//! @brief Packet loss concealment.
+
+#ifndef ROC_AUDIO_LOSS_CONCEALER_H_
+#define ROC_AUDIO_LOSS_CONCEALER_H_
+
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+//! Loss concealer parameters.
+struct LossConcealerConfig {
+    //! Maximum duration of concealed signal for one gap.
+    //! @remarks
+    //!  Concealed signal fades out linearly during this time, and the rest
+    //!  of the gap is filled with silence. Repeating waveform for longer
+    //!  sounds worse than silence.
+    core::nanoseconds_t max_duration;
+
+    //! Duration of cross-fade from concealed signal to decoded signal,
+    //! when packets arrive again after the gap.
+    core::nanoseconds_t fade_duration;
+
+    LossConcealerConfig()
+        : max_duration(60 * core::Millisecond)
+        , fade_duration(5 * core::Millisecond) {
+    }
+};
+
+//! Packet loss concealment (PLC) using pitch repetition.
+//!
+//! Remembers recent decoded samples. When there is a gap in the stream,
+//! estimates pitch period of the recent signal and fills the gap by
+//! repeating the last period with fading gain. When decoded samples
+//! arrive again, they are cross-faded with continuation of concealed
+//! signal to avoid clicks.
+//!
+//! Used for codecs without built-in concealment, like PCM.
+//!
+//! CPU cost is bounded: pitch is estimated once per gap, on a decimated
+//! signal within fixed range of periods, and then refined around the best
+//! candidate. Filling the gap and remembering samples are linear.
+class LossConcealer : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    LossConcealer(const SampleSpec& sample_spec,
+                  const LossConcealerConfig& config,
+                  core::IArena& arena);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Remember decoded samples.
+    //! @remarks
+    //!  @p n_samples is number of samples per channel. If preceding samples
+    //!  were concealed, beginning of @p samples is modified in place to fade
+    //!  from concealed signal.
+    void write(sample_t* samples, size_t n_samples);
+
+    //! Generate samples in place of lost samples.
+    //! @remarks
+    //!  Continues concealment if it was already started by previous call.
+    //! @returns
+    //!  number of generated samples per channel; may be fewer than
+    //!  @p n_samples (or zero) when there is not enough history or when
+    //!  maximum duration is reached.
+    size_t conceal(sample_t* samples, size_t n_samples);
+
+    //! Forget remembered samples.
+    //! @remarks
+    //!  Called when stream is interrupted by intended silence, so that
+    //!  old signal is not repeated after it.
+    void reset();
+
+private:
+    void append_history_(const sample_t* samples, size_t n_samples);
+    void start_concealment_();
+    size_t find_period_();
+    double correlate_(size_t lag, size_t step) const;
+
+    sample_t concealed_sample_(size_t pos, size_t chan) const;
+
+    const size_t num_ch_;
+
+    // Range of pitch periods, per-channel samples.
+    size_t min_period_;
+    size_t max_period_;
+
+    // Every decim_'th sample is used for coarse pitch search.
+    size_t decim_;
+
+    size_t max_len_;
+    size_t fade_len_;
+
+    // Ring with recent samples, hist_size_ samples per channel.
+    core::Array<sample_t> history_;
+    size_t hist_size_;
+    size_t hist_pos_;
+    size_t hist_fill_;
+
+    // Mono mix of history used for pitch search.
+    core::Array<sample_t> mono_;
+
+    // Last pitch period of history, repeated during concealment.
+    core::Array<sample_t> pattern_;
+    size_t period_;
+
+    size_t conceal_pos_;
+    bool concealing_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LOSS_CONCEALER_H_
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/lossless_decoder.h"
+#include "roc_audio/lossless_format.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Same scaling as in L24 PCM to float conversion.
+inline sample_t dequantize(int32_t v) {
+    return sample_t(v * (1.0 / 8388608.0));
+}
+
+inline int32_t unzigzag(uint32_t u) {
+    return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+
+} // namespace
+
+IFrameDecoder* LosslessDecoder::construct(core::IArena& arena,
+                                          const SampleSpec& sample_spec) {
+    return new (arena) LosslessDecoder(arena, sample_spec);
+}
+
+LosslessDecoder::LosslessDecoder(core::IArena& arena, const SampleSpec& sample_spec)
+    : n_chans_(sample_spec.num_channels())
+    , samples_(arena)
+    , frame_samples_(0)
+    , frame_pos_(0)
+    , stream_pos_(0)
+    , stream_avail_(0)
+    , frame_data_(NULL) {
+}
+
+packet::stream_timestamp_t LosslessDecoder::position() const {
+    return stream_pos_;
+}
+
+packet::stream_timestamp_t LosslessDecoder::available() const {
+    return stream_avail_;
+}
+
+size_t LosslessDecoder::decoded_sample_count(const void* frame_data,
+                                             size_t frame_size) const {
+    roc_panic_if_not(frame_data);
+
+    if (frame_size < lossless::FrameHeaderSize) {
+        return 0;
+    }
+
+    const uint8_t* data = (const uint8_t*)frame_data;
+
+    return ((size_t)data[0] << 8) | data[1];
+}
+
+void LosslessDecoder::begin(packet::stream_timestamp_t frame_position,
+                            const void* frame_data,
+                            size_t frame_size) {
+    roc_panic_if_not(frame_data);
+
+    if (frame_data_) {
+        roc_panic("lossless decoder: unpaired begin/end");
+    }
+
+    frame_data_ = frame_data;
+    frame_pos_ = 0;
+    frame_samples_ = decoded_sample_count(frame_data, frame_size);
+
+    if (samples_.size() < frame_samples_ * n_chans_) {
+        if (!samples_.resize(frame_samples_ * n_chans_)) {
+            roc_log(LogError, "lossless decoder: can't allocate buffer: n_samples=%lu",
+                    (unsigned long)frame_samples_);
+            frame_samples_ = 0;
+        }
+    }
+
+    if (!decode_frame_(frame_data, frame_size, frame_samples_)) {
+        roc_log(LogDebug, "lossless decoder: can't decode frame: frame_size=%lu",
+                (unsigned long)frame_size);
+
+        for (size_t n = 0; n < frame_samples_ * n_chans_; n++) {
+            samples_[n] = 0;
+        }
+    }
+
+    stream_pos_ = frame_position;
+    stream_avail_ = (packet::stream_timestamp_t)frame_samples_;
+}
+
+size_t LosslessDecoder::read(sample_t* samples, size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("lossless decoder: read should be called only between begin/end");
+    }
+
+    if (n_samples > (size_t)stream_avail_) {
+        n_samples = (size_t)stream_avail_;
+    }
+
+    for (size_t c = 0; c < n_chans_; c++) {
+        const int32_t* row = samples_.data() + c * frame_samples_ + frame_pos_;
+
+        for (size_t n = 0; n < n_samples; n++) {
+            samples[n * n_chans_ + c] = dequantize(row[n]);
+        }
+    }
+
+    frame_pos_ += n_samples;
+
+    stream_pos_ += (packet::stream_timestamp_t)n_samples;
+    stream_avail_ -= (packet::stream_timestamp_t)n_samples;
+
+    return n_samples;
+}
+
+size_t LosslessDecoder::shift(size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("lossless decoder: shift should be called only between begin/end");
+    }
+
+    if (n_samples > (size_t)stream_avail_) {
+        n_samples = (size_t)stream_avail_;
+    }
+
+    frame_pos_ += n_samples;
+
+    stream_pos_ += (packet::stream_timestamp_t)n_samples;
+    stream_avail_ -= (packet::stream_timestamp_t)n_samples;
+
+    return n_samples;
+}
+
+void LosslessDecoder::end() {
+    if (!frame_data_) {
+        roc_panic("lossless decoder: unpaired begin/end");
+    }
+
+    stream_avail_ = 0;
+
+    frame_data_ = NULL;
+    frame_samples_ = 0;
+    frame_pos_ = 0;
+}
+
+size_t LosslessDecoder::conceal(sample_t*, size_t) {
+    // Codec has no inter-frame state to extrapolate from.
+    return 0;
+}
+
+bool LosslessDecoder::decode_frame_(const void* frame_data,
+                                    size_t frame_size,
+                                    size_t n_samples) {
+    if (n_samples == 0) {
+        return true;
+    }
+
+    core::BitReader reader(frame_data, frame_size);
+
+    reader.read(16);
+    const uint32_t mode = reader.read(8);
+
+    if (mode != lossless::ChanMode_Independent && n_chans_ != 2) {
+        return false;
+    }
+
+    int32_t* rows[2] = { samples_.data(), samples_.data() + n_samples };
+
+    switch (mode) {
+    case lossless::ChanMode_Independent:
+        for (size_t c = 0; c < n_chans_; c++) {
+            if (!decode_subframe_(reader, samples_.data() + c * n_samples, n_samples,
+                                  lossless::SampleBits)) {
+                return false;
+            }
+        }
+        return true;
+
+    case lossless::ChanMode_LeftSide:
+        if (!decode_subframe_(reader, rows[0], n_samples, lossless::SampleBits)
+            || !decode_subframe_(reader, rows[1], n_samples, lossless::SampleBits + 1)) {
+            return false;
+        }
+        for (size_t n = 0; n < n_samples; n++) {
+            rows[1][n] = rows[0][n] - rows[1][n];
+        }
+        return true;
+
+    case lossless::ChanMode_SideRight:
+        if (!decode_subframe_(reader, rows[0], n_samples, lossless::SampleBits + 1)
+            || !decode_subframe_(reader, rows[1], n_samples, lossless::SampleBits)) {
+            return false;
+        }
+        for (size_t n = 0; n < n_samples; n++) {
+            rows[0][n] = rows[0][n] + rows[1][n];
+        }
+        return true;
+
+    case lossless::ChanMode_MidSide:
+        if (!decode_subframe_(reader, rows[0], n_samples, lossless::SampleBits)
+            || !decode_subframe_(reader, rows[1], n_samples, lossless::SampleBits + 1)) {
+            return false;
+        }
+        for (size_t n = 0; n < n_samples; n++) {
+            const int32_t side = rows[1][n];
+            const int32_t mid = (int32_t)((uint32_t)rows[0][n] << 1) | (side & 1);
+            rows[0][n] = (mid + side) >> 1;
+            rows[1][n] = (mid - side) >> 1;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool LosslessDecoder::decode_subframe_(core::BitReader& reader,
+                                       int32_t* samples,
+                                       size_t n_samples,
+                                       size_t sample_bits) const {
+    const uint32_t type = reader.read(4);
+    const uint32_t wasted = reader.read(5);
+
+    if (type == lossless::Subframe_Constant) {
+        const int32_t value = reader.read_signed(sample_bits);
+        for (size_t n = 0; n < n_samples; n++) {
+            samples[n] = value;
+        }
+        return !reader.is_overflow();
+    }
+
+    if (wasted >= sample_bits) {
+        return false;
+    }
+
+    const size_t eff_bits = sample_bits - wasted;
+
+    if (type == lossless::Subframe_Verbatim) {
+        for (size_t n = 0; n < n_samples; n++) {
+            samples[n] = reader.read_signed(eff_bits);
+        }
+    } else {
+        const size_t order = type;
+
+        if (order > lossless::MaxOrder || order > n_samples) {
+            return false;
+        }
+
+        for (size_t n = 0; n < order; n++) {
+            samples[n] = reader.read_signed(eff_bits);
+        }
+
+        const uint32_t rice = reader.read(lossless::RiceParamBits);
+        if (rice > lossless::MaxRiceParam) {
+            return false;
+        }
+
+        for (size_t n = order; n < n_samples; n++) {
+            const uint32_t q = reader.read_unary();
+            const int32_t residual = unzigzag((q << rice) | reader.read(rice));
+
+            switch (order) {
+            case 0:
+                samples[n] = residual;
+                break;
+            case 1:
+                samples[n] = residual + samples[n - 1];
+                break;
+            case 2:
+                samples[n] = residual + 2 * samples[n - 1] - samples[n - 2];
+                break;
+            case 3:
+                samples[n] = residual + 3 * samples[n - 1] - 3 * samples[n - 2]
+                    + samples[n - 3];
+                break;
+            default:
+                samples[n] = residual + 4 * samples[n - 1] - 6 * samples[n - 2]
+                    + 4 * samples[n - 3] - samples[n - 4];
+                break;
+            }
+        }
+    }
+
+    if (reader.is_overflow()) {
+        return false;
+    }
+
+    if (wasted != 0) {
+        for (size_t n = 0; n < n_samples; n++) {
+            samples[n] = (int32_t)((uint32_t)samples[n] << wasted);
+        }
+    }
+
+    return true;
+}
+
+} // namespace audio
+} // namespace roc
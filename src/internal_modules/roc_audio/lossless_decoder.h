@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/lossless_decoder.h
+//! @brief Lossless decoder.
+
+#ifndef ROC_AUDIO_LOSSLESS_DECODER_H_
+#define ROC_AUDIO_LOSSLESS_DECODER_H_
+
+#include "roc_audio/iframe_decoder.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/bit_reader.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Lossless decoder.
+//! @remarks
+//!  Decodes frames produced by LosslessEncoder, see lossless_format.h.
+class LosslessDecoder : public IFrameDecoder, public core::NonCopyable<> {
+public:
+    //! Construction function.
+    static IFrameDecoder* construct(core::IArena& arena, const SampleSpec& sample_spec);
+
+    //! Initialize.
+    LosslessDecoder(core::IArena& arena, const SampleSpec& sample_spec);
+
+    //! Get current stream position.
+    virtual packet::stream_timestamp_t position() const;
+
+    //! Get number of samples available for decoding.
+    virtual packet::stream_timestamp_t available() const;
+
+    //! Get number of samples per channel, that can be decoded from given frame.
+    virtual size_t decoded_sample_count(const void* frame_data, size_t frame_size) const;
+
+    //! Start decoding a new frame.
+    virtual void begin(packet::stream_timestamp_t frame_position,
+                       const void* frame_data,
+                       size_t frame_size);
+
+    //! Read samples from current frame.
+    virtual size_t read(sample_t* samples, size_t n_samples);
+
+    //! Shift samples from current frame.
+    virtual size_t shift(size_t n_samples);
+
+    //! Finish decoding current frame.
+    virtual void end();
+
+    //! Generate samples in place of lost frames.
+    virtual size_t conceal(sample_t* samples, size_t n_samples);
+
+private:
+    bool decode_frame_(const void* frame_data, size_t frame_size, size_t n_samples);
+
+    bool decode_subframe_(core::BitReader& reader,
+                          int32_t* samples,
+                          size_t n_samples,
+                          size_t sample_bits) const;
+
+    const size_t n_chans_;
+
+    // Decoded samples, one row of frame_samples_ per channel.
+    core::Array<int32_t> samples_;
+    size_t frame_samples_;
+    size_t frame_pos_;
+
+    packet::stream_timestamp_t stream_pos_;
+    packet::stream_timestamp_t stream_avail_;
+
+    const void* frame_data_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LOSSLESS_DECODER_H_
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/lossless_encoder.h"
+#include "roc_audio/lossless_format.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Same quantization as in float to L24 PCM conversion.
+inline int32_t quantize(sample_t s) {
+    const double d = double(s) * 8388608.0;
+    if (d < -8388608.0) {
+        return -8388608;
+    }
+    if (d >= 8388608.0) {
+        return 8388607;
+    }
+    return int32_t(d);
+}
+
+inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline uint32_t abs_value(int32_t v) {
+    return v < 0 ? (uint32_t)0 - (uint32_t)v : (uint32_t)v;
+}
+
+} // namespace
+
+IFrameEncoder* LosslessEncoder::construct(core::IArena& arena,
+                                          const SampleSpec& sample_spec,
+                                          const FrameEncoderConfig&) {
+    return new (arena) LosslessEncoder(arena, sample_spec);
+}
+
+LosslessEncoder::LosslessEncoder(core::IArena& arena, const SampleSpec& sample_spec)
+    : n_chans_(sample_spec.num_channels())
+    , samples_(arena)
+    , max_samples_(0)
+    , frame_data_(NULL)
+    , frame_byte_size_(0)
+    , frame_samples_(0) {
+}
+
+size_t LosslessEncoder::encoded_byte_count(size_t num_samples) const {
+    return lossless::max_frame_size(n_chans_, num_samples);
+}
+
+void LosslessEncoder::begin(void* frame_data, size_t frame_size) {
+    roc_panic_if_not(frame_data);
+
+    if (frame_data_) {
+        roc_panic("lossless encoder: unpaired begin/end");
+    }
+
+    frame_data_ = frame_data;
+    frame_byte_size_ = frame_size;
+    frame_samples_ = 0;
+
+    // How much samples are guaranteed to fit into frame.
+    size_t max_samples = 0;
+    if (frame_size > lossless::FrameHeaderSize) {
+        const size_t avail_bits = (frame_size - lossless::FrameHeaderSize) * 8;
+        const size_t header_bits = n_chans_ * lossless::SubframeHeaderBits;
+        if (avail_bits > header_bits) {
+            max_samples =
+                (avail_bits - header_bits) / (n_chans_ * lossless::SampleBits);
+        }
+    }
+    if (max_samples > lossless::MaxFrameSamples) {
+        max_samples = lossless::MaxFrameSamples;
+    }
+
+    if (max_samples != max_samples_) {
+        // Usually happens only once, because packets have same size.
+        if (!samples_.resize(max_samples * (n_chans_ + 2))) {
+            roc_log(LogError, "lossless encoder: can't allocate buffer: n_samples=%lu",
+                    (unsigned long)max_samples);
+            max_samples = 0;
+        }
+        max_samples_ = max_samples;
+    }
+}
+
+size_t LosslessEncoder::write(const sample_t* samples, size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("lossless encoder: write should be called only between begin/end");
+    }
+
+    if (n_samples > max_samples_ - frame_samples_) {
+        n_samples = max_samples_ - frame_samples_;
+    }
+
+    for (size_t c = 0; c < n_chans_; c++) {
+        int32_t* row = samples_.data() + c * max_samples_ + frame_samples_;
+
+        for (size_t n = 0; n < n_samples; n++) {
+            row[n] = quantize(samples[n * n_chans_ + c]);
+        }
+    }
+
+    frame_samples_ += n_samples;
+
+    return n_samples;
+}
+
+size_t LosslessEncoder::end() {
+    if (!frame_data_) {
+        roc_panic("lossless encoder: unpaired begin/end");
+    }
+
+    core::BitWriter writer(frame_data_, frame_byte_size_);
+
+    const size_t n_samples = frame_samples_;
+
+    const int32_t* rows[2] = {};
+    size_t row_bits[2] = {};
+    Subframe subframes[2];
+
+    lossless::ChannelMode mode = lossless::ChanMode_Independent;
+
+    if (n_chans_ == 2 && n_samples != 0) {
+        const int32_t* left = samples_.data();
+        const int32_t* right = samples_.data() + max_samples_;
+        int32_t* mid = samples_.data() + max_samples_ * 2;
+        int32_t* side = samples_.data() + max_samples_ * 3;
+
+        for (size_t n = 0; n < n_samples; n++) {
+            mid[n] = (left[n] + right[n]) >> 1;
+            side[n] = left[n] - right[n];
+        }
+
+        const Subframe left_sf = analyze_(left, n_samples, lossless::SampleBits);
+        const Subframe right_sf = analyze_(right, n_samples, lossless::SampleBits);
+        const Subframe mid_sf = analyze_(mid, n_samples, lossless::SampleBits);
+        const Subframe side_sf = analyze_(side, n_samples, lossless::SampleBits + 1);
+
+        uint64_t best = left_sf.n_bits + right_sf.n_bits;
+
+        rows[0] = left;
+        rows[1] = right;
+        row_bits[0] = row_bits[1] = lossless::SampleBits;
+        subframes[0] = left_sf;
+        subframes[1] = right_sf;
+
+        if (left_sf.n_bits + side_sf.n_bits < best) {
+            best = left_sf.n_bits + side_sf.n_bits;
+            mode = lossless::ChanMode_LeftSide;
+            rows[0] = left;
+            rows[1] = side;
+            row_bits[0] = lossless::SampleBits;
+            row_bits[1] = lossless::SampleBits + 1;
+            subframes[0] = left_sf;
+            subframes[1] = side_sf;
+        }
+        if (side_sf.n_bits + right_sf.n_bits < best) {
+            best = side_sf.n_bits + right_sf.n_bits;
+            mode = lossless::ChanMode_SideRight;
+            rows[0] = side;
+            rows[1] = right;
+            row_bits[0] = lossless::SampleBits + 1;
+            row_bits[1] = lossless::SampleBits;
+            subframes[0] = side_sf;
+            subframes[1] = right_sf;
+        }
+        if (mid_sf.n_bits + side_sf.n_bits < best) {
+            best = mid_sf.n_bits + side_sf.n_bits;
+            mode = lossless::ChanMode_MidSide;
+            rows[0] = mid;
+            rows[1] = side;
+            row_bits[0] = lossless::SampleBits;
+            row_bits[1] = lossless::SampleBits + 1;
+            subframes[0] = mid_sf;
+            subframes[1] = side_sf;
+        }
+    }
+
+    writer.write((uint32_t)n_samples, 16);
+    writer.write((uint32_t)mode, 8);
+
+    if (n_samples != 0) {
+        if (mode != lossless::ChanMode_Independent) {
+            for (size_t c = 0; c < 2; c++) {
+                encode_(writer, subframes[c], rows[c], n_samples, row_bits[c]);
+            }
+        } else {
+            for (size_t c = 0; c < n_chans_; c++) {
+                const int32_t* row = samples_.data() + c * max_samples_;
+                encode_(writer, analyze_(row, n_samples, lossless::SampleBits), row,
+                        n_samples, lossless::SampleBits);
+            }
+        }
+    }
+
+    writer.flush();
+
+    if (writer.is_overflow()) {
+        roc_panic("lossless encoder: frame overflow: frame_size=%lu n_samples=%lu",
+                  (unsigned long)frame_byte_size_, (unsigned long)n_samples);
+    }
+
+    frame_data_ = NULL;
+    frame_byte_size_ = 0;
+    frame_samples_ = 0;
+
+    return writer.byte_count();
+}
+
+LosslessEncoder::Subframe LosslessEncoder::analyze_(const int32_t* samples,
+                                                    size_t n_samples,
+                                                    size_t sample_bits) const {
+    Subframe sf;
+
+    uint32_t all_bits = 0;
+    bool is_constant = true;
+
+    for (size_t n = 0; n < n_samples; n++) {
+        all_bits |= (uint32_t)samples[n];
+        if (samples[n] != samples[0]) {
+            is_constant = false;
+        }
+    }
+
+    if (is_constant) {
+        sf.type = lossless::Subframe_Constant;
+        sf.n_bits = lossless::SubframeHeaderBits + sample_bits;
+        return sf;
+    }
+
+    // Low bits that are zero in all samples are not transmitted.
+    while ((all_bits & 1) == 0) {
+        all_bits >>= 1;
+        sf.wasted++;
+    }
+
+    const size_t eff_bits = sample_bits - sf.wasted;
+
+    // Sums of absolute residuals for every fixed predictor order.
+    // Residual of order k is k-th difference of the signal.
+    uint64_t sums[lossless::MaxOrder + 1] = {};
+    int32_t prev[lossless::MaxOrder] = {};
+
+    for (size_t n = 0; n < n_samples; n++) {
+        int32_t diff[lossless::MaxOrder + 1];
+        diff[0] = samples[n] >> sf.wasted;
+        for (size_t k = 1; k <= lossless::MaxOrder; k++) {
+            diff[k] = diff[k - 1] - prev[k - 1];
+        }
+        for (size_t k = 0; k <= lossless::MaxOrder && k <= n; k++) {
+            sums[k] += abs_value(diff[k]);
+        }
+        for (size_t k = 0; k < lossless::MaxOrder; k++) {
+            prev[k] = diff[k];
+        }
+    }
+
+    size_t max_order = lossless::MaxOrder;
+    if (max_order > n_samples) {
+        max_order = n_samples;
+    }
+
+    size_t order = 0;
+    for (size_t k = 1; k <= max_order; k++) {
+        if (sums[k] < sums[order]) {
+            order = k;
+        }
+    }
+
+    // Rice parameter close to log2 of mean absolute residual.
+    const uint64_t n_residuals = n_samples - order;
+    unsigned rice = 0;
+    while (rice < lossless::MaxRiceParam && (n_residuals << (rice + 1)) < sums[order]) {
+        rice++;
+    }
+
+    // Exact size of predicted subframe.
+    uint64_t n_bits = lossless::SubframeHeaderBits + order * eff_bits
+        + lossless::RiceParamBits + n_residuals * (rice + 1);
+
+    for (size_t k = 0; k < lossless::MaxOrder; k++) {
+        prev[k] = 0;
+    }
+    for (size_t n = 0; n < n_samples; n++) {
+        int32_t diff[lossless::MaxOrder + 1];
+        diff[0] = samples[n] >> sf.wasted;
+        for (size_t k = 1; k <= order; k++) {
+            diff[k] = diff[k - 1] - prev[k - 1];
+        }
+        if (n >= order) {
+            n_bits += zigzag(diff[order]) >> rice;
+        }
+        for (size_t k = 0; k < order; k++) {
+            prev[k] = diff[k];
+        }
+    }
+
+    const uint64_t verbatim_bits = lossless::SubframeHeaderBits + n_samples * eff_bits;
+
+    if (n_bits < verbatim_bits) {
+        sf.type = (unsigned)order;
+        sf.rice = rice;
+        sf.n_bits = n_bits;
+    } else {
+        sf.type = lossless::Subframe_Verbatim;
+        sf.n_bits = verbatim_bits;
+    }
+
+    return sf;
+}
+
+void LosslessEncoder::encode_(core::BitWriter& writer,
+                              const Subframe& sf,
+                              const int32_t* samples,
+                              size_t n_samples,
+                              size_t sample_bits) const {
+    writer.write(sf.type, 4);
+    writer.write(sf.wasted, 5);
+
+    const size_t eff_bits = sample_bits - sf.wasted;
+
+    if (sf.type == lossless::Subframe_Constant) {
+        writer.write((uint32_t)samples[0], sample_bits);
+        return;
+    }
+
+    if (sf.type == lossless::Subframe_Verbatim) {
+        for (size_t n = 0; n < n_samples; n++) {
+            writer.write((uint32_t)(samples[n] >> sf.wasted), eff_bits);
+        }
+        return;
+    }
+
+    const size_t order = sf.type;
+
+    for (size_t n = 0; n < order; n++) {
+        writer.write((uint32_t)(samples[n] >> sf.wasted), eff_bits);
+    }
+
+    writer.write(sf.rice, lossless::RiceParamBits);
+
+    int32_t prev[lossless::MaxOrder] = {};
+
+    for (size_t n = 0; n < n_samples; n++) {
+        int32_t diff[lossless::MaxOrder + 1];
+        diff[0] = samples[n] >> sf.wasted;
+        for (size_t k = 1; k <= order; k++) {
+            diff[k] = diff[k - 1] - prev[k - 1];
+        }
+        if (n >= order) {
+            const uint32_t u = zigzag(diff[order]);
+            writer.write_unary(u >> sf.rice);
+            writer.write(u, sf.rice);
+        }
+        for (size_t k = 0; k < order; k++) {
+            prev[k] = diff[k];
+        }
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/lossless_encoder.h
+//! @brief Lossless encoder.
+
+#ifndef ROC_AUDIO_LOSSLESS_ENCODER_H_
+#define ROC_AUDIO_LOSSLESS_ENCODER_H_
+
+#include "roc_audio/frame_encoder_config.h"
+#include "roc_audio/iframe_encoder.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/bit_writer.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Lossless encoder.
+//! @remarks
+//!  Produces frames of variable size, see lossless_format.h.
+//!  encoded_byte_count() returns the worst case size, which is slightly
+//!  larger than L24 PCM.
+class LosslessEncoder : public IFrameEncoder, public core::NonCopyable<> {
+public:
+    //! Construction function.
+    static IFrameEncoder* construct(core::IArena& arena,
+                                    const SampleSpec& sample_spec,
+                                    const FrameEncoderConfig& config);
+
+    //! Initialize.
+    LosslessEncoder(core::IArena& arena, const SampleSpec& sample_spec);
+
+    //! Get maximum encoded frame size in bytes for given number of samples
+    //! per channel.
+    virtual size_t encoded_byte_count(size_t num_samples) const;
+
+    //! Start encoding a new frame.
+    virtual void begin(void* frame, size_t frame_size);
+
+    //! Encode samples.
+    virtual size_t write(const sample_t* samples, size_t n_samples);
+
+    //! Finish encoding frame.
+    virtual size_t end();
+
+private:
+    struct Subframe {
+        unsigned type;
+        unsigned wasted;
+        unsigned rice;
+        uint64_t n_bits;
+
+        Subframe()
+            : type(0)
+            , wasted(0)
+            , rice(0)
+            , n_bits(0) {
+        }
+    };
+
+    Subframe analyze_(const int32_t* samples, size_t n_samples, size_t sample_bits) const;
+
+    void encode_(core::BitWriter& writer,
+                 const Subframe& subframe,
+                 const int32_t* samples,
+                 size_t n_samples,
+                 size_t sample_bits) const;
+
+    const size_t n_chans_;
+
+    // Quantized samples, one row of max_samples_ per channel,
+    // plus two extra rows for mid and side channels.
+    core::Array<int32_t> samples_;
+    size_t max_samples_;
+
+    void* frame_data_;
+    size_t frame_byte_size_;
+    size_t frame_samples_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LOSSLESS_ENCODER_H_
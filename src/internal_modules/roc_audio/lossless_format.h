@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/lossless_format.h
+//! @brief Lossless codec bitstream format.
+
+#ifndef ROC_AUDIO_LOSSLESS_FORMAT_H_
+#define ROC_AUDIO_LOSSLESS_FORMAT_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Lossless codec bitstream format.
+//! @remarks
+//!  Samples are quantized to 24-bit integers, like in L24 PCM, and then
+//!  compressed without loss using a scheme similar to FLAC: fixed polynomial
+//!  linear prediction and Rice coding of prediction residuals.
+//!
+//!  Frame layout:
+//!   - 16 bits: number of samples per channel
+//!   - 8 bits: channel mode (see ChannelMode)
+//!   - subframe for every channel, bit-packed, MSB first
+//!   - zero bits up to byte boundary
+//!
+//!  Subframe layout:
+//!   - 4 bits: subframe type (predictor order or SubframeType)
+//!   - 5 bits: number of wasted (always zero) low bits
+//!   - for constant subframe: one sample
+//!   - for verbatim subframe: all samples
+//!   - for predicted subframe: warm-up samples, 5 bits of Rice parameter,
+//!     and Rice-coded residuals of remaining samples
+namespace lossless {
+
+enum {
+    //! Bits per quantized sample.
+    SampleBits = 24,
+
+    //! Frame header size in bytes.
+    FrameHeaderSize = 3,
+
+    //! Subframe header size in bits.
+    SubframeHeaderBits = 9,
+
+    //! Bits used to store Rice parameter.
+    RiceParamBits = 5,
+
+    //! Maximum Rice parameter.
+    MaxRiceParam = 30,
+
+    //! Maximum order of fixed predictor.
+    MaxOrder = 4,
+
+    //! Maximum number of samples per channel in frame.
+    MaxFrameSamples = 65535
+};
+
+//! How channels are decorrelated.
+enum ChannelMode {
+    //! Channels are coded independently.
+    ChanMode_Independent = 0,
+
+    //! Stereo: left and side (left - right).
+    ChanMode_LeftSide = 1,
+
+    //! Stereo: side (left - right) and right.
+    ChanMode_SideRight = 2,
+
+    //! Stereo: mid ((left + right) / 2) and side (left - right).
+    ChanMode_MidSide = 3
+};
+
+//! Subframe types other than fixed predictor (orders 0..MaxOrder).
+enum SubframeType {
+    //! All samples are stored as is.
+    Subframe_Verbatim = 14,
+
+    //! All samples are equal.
+    Subframe_Constant = 15
+};
+
+//! Get upper bound of encoded frame size.
+inline size_t max_frame_size(size_t n_chans, size_t n_samples) {
+    // Never larger than verbatim coding of independent channels.
+    return FrameHeaderSize
+        + (n_chans * (SubframeHeaderBits + SampleBits * n_samples) + 7) / 8;
+}
+
+} // namespace lossless
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LOSSLESS_FORMAT_H_
@@ -10,6 +10,7 @@
 #include "roc_audio/sample_spec_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/probe.h"
 #include "roc_core/stddefs.h"
 
 namespace roc {
@@ -17,21 +18,66 @@ namespace audio {
 
 Mixer::Mixer(FrameFactory& frame_factory,
              const SampleSpec& sample_spec,
-             bool enable_timestamps)
-    : sample_spec_(sample_spec)
+             bool enable_timestamps,
+             core::IArena& arena)
+    : frame_factory_(frame_factory)
+    , readers_(arena)
+    , workers_(NULL)
+    , input_size_(0)
+    , kernel_(NULL)
+    , max_inputs_(0)
+    , n_samples_(0)
+    , sample_spec_(sample_spec)
     , enable_timestamps_(enable_timestamps)
     , valid_(false) {
+    init_();
+}
+
+Mixer::Mixer(FrameFactory& frame_factory,
+             const SampleSpec& sample_spec,
+             bool enable_timestamps,
+             const MixerConfig& config,
+             core::WorkerPool* workers,
+             core::IArena& arena)
+    : frame_factory_(frame_factory)
+    , readers_(arena)
+    , config_(config)
+    , workers_(workers)
+    , input_size_(0)
+    , kernel_(NULL)
+    , max_inputs_(0)
+    , n_samples_(0)
+    , sample_spec_(sample_spec)
+    , enable_timestamps_(enable_timestamps)
+    , valid_(false) {
+    if (workers_ || config_.group_size > 1 || config_.max_active_inputs != 0) {
+        inputs_.reset(new (inputs_) core::Array<Input>(arena));
+        groups_.reset(new (groups_) core::Array<Group>(arena));
+    }
+
+    init_();
+}
+
+void Mixer::init_() {
     roc_panic_if_msg(!sample_spec_.is_valid() || !sample_spec_.is_raw(),
                      "mixer: required valid sample spec with raw format: %s",
                      sample_spec_to_str(sample_spec_).c_str());
 
-    temp_buf_ = frame_factory.new_raw_buffer();
-    if (!temp_buf_) {
-        roc_log(LogError, "mixer: can't allocate temporary buffer");
+    if (config_.group_size == 0) {
+        roc_log(LogError, "mixer: invalid config: group_size=0");
         return;
     }
 
-    temp_buf_.reslice(0, temp_buf_.capacity());
+    const MixerKernel kernel = mixer_kernel_best();
+    kernel_ = mixer_kernel_func(kernel);
+    roc_panic_if(!kernel_);
+
+    roc_log(LogDebug,
+            "mixer: initializing: kernel=%s n_workers=%lu group_size=%lu"
+            " max_active_inputs=%lu",
+            mixer_kernel_to_str(kernel),
+            (unsigned long)(workers_ ? workers_->num_threads() : 0),
+            (unsigned long)config_.group_size, (unsigned long)config_.max_active_inputs);
 
     valid_ = true;
 }
@@ -40,24 +86,76 @@ bool Mixer::is_valid() const {
     return valid_;
 }
 
-void Mixer::add_input(IFrameReader& reader) {
+bool Mixer::add_input(IFrameReader& reader) {
     roc_panic_if(!valid_);
 
-    readers_.push_back(reader);
+    for (size_t n = 0; n < readers_.size(); n++) {
+        if (readers_[n] == &reader) {
+            roc_panic("mixer: attempt to add input twice");
+        }
+    }
+
+    if (readers_.size() == 1) {
+        // Switching from direct read to mixing.
+        if (!alloc_buffers_()) {
+            return false;
+        }
+    }
+
+    if (!readers_.push_back(&reader)) {
+        roc_log(LogError, "mixer: can't add input: can't allocate array: n_inputs=%lu",
+                (unsigned long)readers_.size());
+        if (readers_.size() == 1) {
+            release_buffers_();
+        }
+        return false;
+    }
+
+    max_inputs_ = std::max(max_inputs_, readers_.size());
+
+    return true;
 }
 
 void Mixer::remove_input(IFrameReader& reader) {
     roc_panic_if(!valid_);
 
-    readers_.remove(reader);
+    size_t pos = 0;
+    while (pos < readers_.size() && readers_[pos] != &reader) {
+        pos++;
+    }
+
+    if (pos == readers_.size()) {
+        roc_panic("mixer: attempt to remove unknown input");
+    }
+
+    // Keep order of remaining inputs, since it defines order of mixing.
+    for (; pos + 1 < readers_.size(); pos++) {
+        readers_[pos] = readers_[pos + 1];
+    }
+    readers_.pop_back();
+
+    if (readers_.size() == 1) {
+        // Switching from mixing to direct read.
+        release_buffers_();
+    }
+}
+
+core::OccupancyMetrics Mixer::metrics() const {
+    core::OccupancyMetrics metrics;
+    metrics.occupancy = readers_.size();
+    metrics.max_occupancy = max_inputs_;
+    metrics.throughput = n_samples_;
+    return metrics;
 }
 
 bool Mixer::read(Frame& frame) {
     roc_panic_if(!valid_);
 
-    // Optimization for single reader case.
+    n_samples_ += frame.num_raw_samples() / sample_spec_.num_channels();
+
+    // Optimization for single reader case: read directly into output frame.
     if (readers_.size() == 1) {
-        if (!readers_.front()->read(frame)) {
+        if (!readers_[0]->read(frame)) {
             frame.set_duration(frame.num_raw_samples() / sample_spec_.num_channels());
         }
 
@@ -67,15 +165,20 @@ bool Mixer::read(Frame& frame) {
             frame.set_capture_timestamp(0);
         }
 
+        roc_probe(mixer_frame, (unsigned long)readers_.size(),
+                  (uint32_t)frame.duration(), (unsigned)frame.flags(),
+                  (int64_t)frame.capture_timestamp());
+
         return true;
     }
 
-    const size_t max_read = temp_buf_.size();
+    // Temporary buffer exists only when there are two or more inputs.
+    const size_t max_read = temp_buf_ ? temp_buf_.size() : frame.num_raw_samples();
 
     sample_t* samples = frame.raw_samples();
     size_t n_samples = frame.num_raw_samples();
 
-    unsigned flags = 0;
+    unsigned flags = Frame::FlagSilent;
     core::nanoseconds_t capture_ts = 0;
 
     while (n_samples != 0) {
@@ -97,6 +200,9 @@ bool Mixer::read(Frame& frame) {
     frame.set_duration(frame.num_raw_samples() / sample_spec_.num_channels());
     frame.set_capture_timestamp(capture_ts);
 
+    roc_probe(mixer_frame, (unsigned long)readers_.size(), (uint32_t)frame.duration(),
+              (unsigned)frame.flags(), (int64_t)frame.capture_timestamp());
+
     return true;
 }
 
@@ -109,52 +215,305 @@ void Mixer::read_(sample_t* out_data,
 
     const size_t n_readers = readers_.size();
 
-    core::nanoseconds_t cts_base = 0;
-    double cts_sum = 0;
-    size_t cts_count = 0;
+    MixState state;
+
+    if (inputs_ && n_readers > 1 && prepare_inputs_(out_size)) {
+        // Zeroize output frame.
+        memset(out_data, 0, out_size * sizeof(sample_t));
+
+        // Read and pre-mix groups of inputs, in parallel if there are workers,
+        // then mix groups or selected inputs here in the same order as they
+        // would be mixed serially.
+        const size_t n_groups = num_groups_();
+
+        if (workers_) {
+            workers_->run(*this, n_groups);
+        } else {
+            for (size_t n = 0; n < n_groups; n++) {
+                run_job(n);
+            }
+        }
+
+        if (config_.max_active_inputs != 0) {
+            mix_loudest_(out_data, out_size, state);
+        } else {
+            mix_groups_(out_data, out_size, state);
+        }
+    } else {
+        bool has_output = false;
+
+        for (size_t n = 0; n < n_readers; n++) {
+            IFrameReader* rp = readers_[n];
+
+            if (!has_output) {
+                // Read first input directly into output frame, instead of
+                // zeroizing output and then adding input from temporary buffer.
+                // This saves two passes over memory per mixed frame.
+                Frame out_frame(out_data, out_size);
+                if (!rp->read(out_frame)) {
+                    continue;
+                }
+
+                add_frame_state_(out_frame.flags(), out_frame.capture_timestamp(),
+                                 state);
+                has_output = true;
+                continue;
+            }
+
+            sample_t* temp_data = temp_buf_.data();
+
+            Frame temp_frame(temp_data, out_size);
+            if (!rp->read(temp_frame)) {
+                continue;
+            }
+
+            mix_frame_(out_data, temp_data, out_size, temp_frame.flags(),
+                       temp_frame.capture_timestamp(), state);
+        }
+
+        if (!has_output) {
+            // Zeroize output frame.
+            memset(out_data, 0, out_size * sizeof(sample_t));
+        }
+    }
+
+    // Accumulate flags from all mixed frames.
+    out_flags = Frame::combine_flags(out_flags, state.flags);
+
+    if (state.cts_count != 0) {
+        // Compute average timestamp.
+        // Don't forget to compensate everything that we subtracted above.
+        out_cts =
+            core::nanoseconds_t(state.cts_base * ((double)state.cts_count / n_readers)
+                                + state.cts_sum / (double)n_readers);
+    }
+}
+
+bool Mixer::alloc_buffers_() {
+    if (temp_buf_) {
+        return true;
+    }
+
+    temp_buf_ = frame_factory_.new_raw_buffer();
+    if (!temp_buf_) {
+        roc_log(LogError, "mixer: can't allocate temporary buffer");
+        return false;
+    }
 
-    // Zeroize output frame.
-    memset(out_data, 0, out_size * sizeof(sample_t));
+    temp_buf_.reslice(0, temp_buf_.capacity());
+
+    return true;
+}
 
-    for (IFrameReader* rp = readers_.front(); rp; rp = readers_.nextof(*rp)) {
-        sample_t* temp_data = temp_buf_.data();
+void Mixer::release_buffers_() {
+    temp_buf_ = core::Slice<sample_t>();
 
-        Frame temp_frame(temp_data, out_size);
-        if (!rp->read(temp_frame)) {
+    if (inputs_) {
+        // Return per-input buffers to pool.
+        inputs_->clear();
+    }
+}
+
+bool Mixer::prepare_inputs_(size_t size) {
+    core::Array<Input>& inputs = *inputs_;
+
+    if (!inputs.resize(readers_.size()) || !groups_->resize(num_groups_())) {
+        roc_log(LogError, "mixer: can't allocate inputs, falling back to serial read");
+        return false;
+    }
+
+    for (size_t n = 0; n < readers_.size(); n++) {
+        Input& input = inputs[n];
+
+        input.reader = readers_[n];
+
+        if (!input.buf) {
+            input.buf = frame_factory_.new_raw_buffer();
+            if (!input.buf) {
+                roc_log(LogError,
+                        "mixer: can't allocate input buffer, falling back to serial read");
+                return false;
+            }
+            input.buf.reslice(0, input.buf.capacity());
+        }
+
+        roc_panic_if(input.buf.size() < size);
+    }
+
+    input_size_ = size;
+
+    return true;
+}
+
+size_t Mixer::num_groups_() const {
+    return (readers_.size() + config_.group_size - 1) / config_.group_size;
+}
+
+void Mixer::run_job(size_t job_index) {
+    core::Array<Input>& inputs = *inputs_;
+    Group& group = (*groups_)[job_index];
+
+    const size_t begin = job_index * config_.group_size;
+    const size_t end = std::min(begin + config_.group_size, inputs.size());
+
+    group.has_output = false;
+    group.state = MixState();
+
+    for (size_t n = begin; n < end; n++) {
+        Input& input = inputs[n];
+
+        Frame frame(input.buf.data(), input_size_);
+
+        input.has_frame = input.reader->read(frame);
+        input.flags = frame.flags();
+        input.cts = frame.capture_timestamp();
+        input.energy = 0;
+        input.selected = false;
+
+        if (!input.has_frame) {
             continue;
         }
 
-        for (size_t n = 0; n < out_size; n++) {
-            out_data[n] += temp_data[n];
+        if (config_.max_active_inputs != 0) {
+            // Inputs are mixed after selection, here we only measure them.
+            if (!(input.flags & Frame::FlagSilent)) {
+                input.energy = compute_energy_(input.buf.data(), input_size_);
+            }
+            continue;
+        }
 
-            // Saturate on overflow.
-            out_data[n] = std::min(out_data[n], Sample_Max);
-            out_data[n] = std::max(out_data[n], Sample_Min);
+        if (!group.has_output) {
+            // First input of group holds group sum.
+            group.head = n;
+            group.has_output = true;
+            add_frame_state_(input.flags, input.cts, group.state);
+            continue;
         }
 
-        // Accumulate flags from all mixed frames.
-        out_flags |= temp_frame.flags();
+        mix_frame_(inputs[group.head].buf.data(), input.buf.data(), input_size_,
+                   input.flags, input.cts, group.state);
+    }
+}
+
+double Mixer::compute_energy_(const sample_t* data, size_t size) {
+    // Independent accumulators let CPU overlap multiplications.
+    sample_t acc[4] = {};
 
-        const core::nanoseconds_t frame_cts = temp_frame.capture_timestamp();
+    size_t n = 0;
+    for (; n + 4 <= size; n += 4) {
+        acc[0] += data[n] * data[n];
+        acc[1] += data[n + 1] * data[n + 1];
+        acc[2] += data[n + 2] * data[n + 2];
+        acc[3] += data[n + 3] * data[n + 3];
+    }
+    for (; n < size; n++) {
+        acc[0] += data[n] * data[n];
+    }
+
+    return (double)acc[0] + (double)acc[1] + (double)acc[2] + (double)acc[3];
+}
 
-        if (enable_timestamps_ && frame_cts != 0) {
-            // Subtract first non-zero timestamp from all other timestamps.
-            // Since timestamp calculation is used only when inputs are synchronous
-            // and their timestamps are close, this effectively makes all values
-            // small, avoiding overflow and rounding errors when adding them.
-            if (cts_base == 0) {
-                cts_base = frame_cts;
+void Mixer::mix_groups_(sample_t* out_data, size_t out_size, MixState& state) {
+    const core::Array<Input>& inputs = *inputs_;
+    const core::Array<Group>& groups = *groups_;
+
+    for (size_t n = 0; n < groups.size(); n++) {
+        const Group& group = groups[n];
+        if (!group.has_output) {
+            continue;
+        }
+
+        if (!(group.state.flags & Frame::FlagSilent)) {
+            kernel_(out_data, inputs[group.head].buf.data(), out_size);
+        }
+
+        add_mix_state_(group.state, state);
+    }
+}
+
+void Mixer::mix_loudest_(sample_t* out_data, size_t out_size, MixState& state) {
+    core::Array<Input>& inputs = *inputs_;
+
+    // Select up to N inputs with highest non-zero energy.
+    // N is expected to be small, so linear search per selection is fine.
+    for (size_t k = 0; k < config_.max_active_inputs; k++) {
+        Input* loudest = NULL;
+
+        for (size_t n = 0; n < inputs.size(); n++) {
+            Input& input = inputs[n];
+            if (input.selected || input.energy <= 0) {
+                continue;
+            }
+            if (!loudest || input.energy > loudest->energy) {
+                loudest = &input;
             }
-            cts_sum += double(frame_cts - cts_base);
-            cts_count++;
         }
+
+        if (!loudest) {
+            break;
+        }
+
+        loudest->selected = true;
     }
 
-    if (cts_count != 0) {
-        // Compute average timestamp.
-        // Don't forget to compensate everything that we subtracted above.
-        out_cts = core::nanoseconds_t(cts_base * ((double)cts_count / n_readers)
-                                      + cts_sum / (double)n_readers);
+    for (size_t n = 0; n < inputs.size(); n++) {
+        const Input& input = inputs[n];
+        if (!input.has_frame) {
+            continue;
+        }
+
+        if (input.selected) {
+            kernel_(out_data, input.buf.data(), out_size);
+        }
+
+        add_frame_state_(input.flags, input.cts, state);
+    }
+}
+
+void Mixer::mix_frame_(sample_t* out_data,
+                       const sample_t* in_data,
+                       size_t size,
+                       unsigned in_flags,
+                       core::nanoseconds_t in_cts,
+                       MixState& state) {
+    // Silent frame consists of zeros, so adding it is no-op.
+    if (!(in_flags & Frame::FlagSilent)) {
+        // Add samples and saturate on overflow.
+        kernel_(out_data, in_data, size);
+    }
+
+    add_frame_state_(in_flags, in_cts, state);
+}
+
+void Mixer::add_frame_state_(unsigned in_flags,
+                             core::nanoseconds_t in_cts,
+                             MixState& state) {
+    state.flags = Frame::combine_flags(state.flags, in_flags);
+
+    if (enable_timestamps_ && in_cts != 0) {
+        // Subtract first non-zero timestamp from all other timestamps.
+        // Since timestamp calculation is used only when inputs are synchronous
+        // and their timestamps are close, this effectively makes all values
+        // small, avoiding overflow and rounding errors when adding them.
+        if (state.cts_base == 0) {
+            state.cts_base = in_cts;
+        }
+        state.cts_sum += double(in_cts - state.cts_base);
+        state.cts_count++;
+    }
+}
+
+void Mixer::add_mix_state_(const MixState& in_state, MixState& state) {
+    state.flags = Frame::combine_flags(state.flags, in_state.flags);
+
+    if (in_state.cts_count != 0) {
+        // Rebase sum of group onto our base.
+        if (state.cts_base == 0) {
+            state.cts_base = in_state.cts_base;
+        }
+        state.cts_sum += in_state.cts_sum
+            + double(in_state.cts_base - state.cts_base) * in_state.cts_count;
+        state.cts_count += in_state.cts_count;
     }
 }
 
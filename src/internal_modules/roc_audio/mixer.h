@@ -14,17 +14,43 @@
 
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/iframe_reader.h"
+#include "roc_audio/mixer_kernel.h"
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_spec.h"
-#include "roc_core/list.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/iworker_job.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/occupancy_metrics.h"
+#include "roc_core/optional.h"
 #include "roc_core/slice.h"
 #include "roc_core/time.h"
+#include "roc_core/worker_pool.h"
 #include "roc_packet/units.h"
 
 namespace roc {
 namespace audio {
 
+//! Mixer parameters.
+struct MixerConfig {
+    //! Number of inputs read and pre-mixed together by one job.
+    //! Each group is summed into one buffer inside its job, which runs on
+    //! worker thread if there is a worker pool, and then only group sums are
+    //! mixed in the calling thread. If 1, every input is a separate job.
+    size_t group_size;
+
+    //! Maximum number of inputs mixed into output.
+    //! If non-zero, only this many loudest inputs are mixed in every frame,
+    //! and the rest are read but not added to output. If zero, all inputs
+    //! are mixed.
+    size_t max_active_inputs;
+
+    MixerConfig()
+        : group_size(1)
+        , max_active_inputs(0) {
+    }
+};
+
 //! Mixer.
 //! Mixes multiple input streams into one output stream.
 //!
@@ -43,24 +69,81 @@ namespace audio {
 //! frame as the average capture timestamps of all mixed input frames.
 //! This makes sense only when all inputs are synchronized and their
 //! timestamps are close to each other.
-class Mixer : public IFrameReader, public core::NonCopyable<> {
+//!
+//! Samples are added using the fastest mixer kernel supported by the CPU,
+//! which is selected once when mixer is constructed.
+//!
+//! If worker pool is provided, mixer reads from all inputs in parallel, each
+//! input into its own buffer, and then mixes the buffers in the calling thread.
+//! Inputs are mixed in the same order as in serial mode, so the result is the
+//! same. Inputs should be safe to read concurrently with each other.
+//!
+//! Input frames with Frame::FlagSilent are not added to the output, since
+//! they consist of zeros. Typically these are frames of idle sessions.
+//!
+//! When there is only one input, mixer reads it directly into the output
+//! frame, without mixing and averaging timestamps. Temporary buffers are
+//! allocated only when the second input is added, and are released when
+//! mixer goes back to one input, so point-to-point receivers don't pay
+//! for mixing at all.
+//!
+//! Inputs are kept in a contiguous array of pointers, which is updated only
+//! when inputs are added or removed, so that iterating inputs every frame
+//! doesn't chase list pointers.
+//!
+//! For large number of inputs, MixerConfig allows to build a two-level
+//! mixing tree: inputs are split into groups that are read and pre-mixed
+//! by worker jobs, and the calling thread mixes only group sums. Since
+//! order of additions differs from serial mode, results may differ when
+//! samples are saturated.
+//!
+//! In loudest-N mode, every job computes energy of its inputs, and only N
+//! inputs with highest energy are added to output, so that cost of mixing
+//! in the calling thread depends on the number of active talkers rather
+//! than on the number of inputs. Inputs are still read every frame, so
+//! their sessions keep running. Capture timestamps and flags are still
+//! combined from all inputs.
+class Mixer : public IFrameReader,
+              public core::NonCopyable<>,
+              private core::IWorkerJob {
 public:
     //! Initialize.
     //! @p buffer_factory is used to allocate a temporary buffer for mixing.
     //! @p enable_timestamps defines whether to enable calculation of capture timestamps.
+    //! @p arena is used to allocate array of inputs.
+    Mixer(FrameFactory& frame_factory,
+          const SampleSpec& sample_spec,
+          bool enable_timestamps,
+          core::IArena& arena);
+
+    //! Initialize with mixing tree.
+    //! @p config defines grouping and selection of inputs.
+    //! @p workers is used to read inputs in parallel; may be NULL.
+    //! @p arena is used to allocate per-input state.
     Mixer(FrameFactory& frame_factory,
           const SampleSpec& sample_spec,
-          bool enable_timestamps);
+          bool enable_timestamps,
+          const MixerConfig& config,
+          core::WorkerPool* workers,
+          core::IArena& arena);
 
     //! Check if the mixer was succefully constructed.
     bool is_valid() const;
 
     //! Add input reader.
-    void add_input(IFrameReader&);
+    //! @returns
+    //!  false if can't allocate buffers needed to mix inputs.
+    bool add_input(IFrameReader&);
 
     //! Remove input reader.
     void remove_input(IFrameReader&);
 
+    //! Get mixer occupancy.
+    //! @remarks
+    //!  Mixer doesn't buffer samples, so occupancy is the number of inputs,
+    //!  and throughput is the number of mixed samples per channel.
+    core::OccupancyMetrics metrics() const;
+
     //! Read audio frame.
     //! @remarks
     //!  Reads samples from every input reader, mixes them, and fills @p frame
@@ -68,14 +151,101 @@ public:
     virtual bool read(Frame& frame);
 
 private:
+    enum { EmbeddedInputs = 8 };
+
+    // State of input for parallel reading.
+    struct Input {
+        IFrameReader* reader;
+        core::Slice<sample_t> buf;
+        unsigned flags;
+        core::nanoseconds_t cts;
+        double energy;
+        bool has_frame;
+        bool selected;
+
+        Input()
+            : reader(NULL)
+            , flags(0)
+            , cts(0)
+            , energy(0)
+            , has_frame(false)
+            , selected(false) {
+        }
+    };
+
+    // Accumulated properties of mixed frames.
+    struct MixState {
+        unsigned flags;
+        core::nanoseconds_t cts_base;
+        double cts_sum;
+        size_t cts_count;
+
+        MixState()
+            : flags(Frame::FlagSilent)
+            , cts_base(0)
+            , cts_sum(0)
+            , cts_count(0) {
+        }
+    };
+
+    // State of group of inputs pre-mixed by one job.
+    struct Group {
+        // Input which buffer holds group sum.
+        size_t head;
+        bool has_output;
+        MixState state;
+
+        Group()
+            : head(0)
+            , has_output(false) {
+        }
+    };
+
+    void init_();
+
+    bool alloc_buffers_();
+    void release_buffers_();
+
     void read_(sample_t* out_data,
                size_t out_size,
                unsigned& out_flags,
                core::nanoseconds_t& out_cts);
 
-    core::List<IFrameReader, core::NoOwnership> readers_;
+    bool prepare_inputs_(size_t size);
+    size_t num_groups_() const;
+    virtual void run_job(size_t job_index);
+
+    static double compute_energy_(const sample_t* data, size_t size);
+
+    void mix_groups_(sample_t* out_data, size_t out_size, MixState& state);
+    void mix_loudest_(sample_t* out_data, size_t out_size, MixState& state);
+
+    void mix_frame_(sample_t* out_data,
+                    const sample_t* in_data,
+                    size_t size,
+                    unsigned in_flags,
+                    core::nanoseconds_t in_cts,
+                    MixState& state);
+    void add_frame_state_(unsigned in_flags, core::nanoseconds_t in_cts, MixState& state);
+    void add_mix_state_(const MixState& in_state, MixState& state);
+
+    FrameFactory& frame_factory_;
+
+    core::Array<IFrameReader*, EmbeddedInputs> readers_;
     core::Slice<sample_t> temp_buf_;
 
+    const MixerConfig config_;
+
+    core::WorkerPool* workers_;
+    core::Optional<core::Array<Input> > inputs_;
+    core::Optional<core::Array<Group> > groups_;
+    size_t input_size_;
+
+    MixerKernelFunc kernel_;
+
+    size_t max_inputs_;
+    uint64_t n_samples_;
+
     const SampleSpec sample_spec_;
     const bool enable_timestamps_;
 
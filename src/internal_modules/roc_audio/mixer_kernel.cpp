@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer_kernel.h"
+#include "roc_core/cpu_features.h"
+#include "roc_core/cpu_traits.h"
+#include "roc_core/macro_helpers.h"
+
+#include <algorithm>
+
+// SSE2 is enabled at compile time, AVX is enabled per-function
+// and selected at run time.
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && ROC_CPU_HAS_SSE2
+#define ROC_AUDIO_MIXER_SSE2
+#include <emmintrin.h>
+#if defined(__clang__)                                                                   \
+    || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define ROC_AUDIO_MIXER_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+#if ROC_CPU_FAMILY == ROC_CPU_ARM && ROC_CPU_HAS_NEON
+#define ROC_AUDIO_MIXER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+void mix_scalar(sample_t* out, const sample_t* in, size_t n_samples) {
+    for (size_t n = 0; n < n_samples; n++) {
+        sample_t s = out[n] + in[n];
+
+        // Saturate on overflow.
+        s = std::min(s, Sample_Max);
+        s = std::max(s, Sample_Min);
+
+        out[n] = s;
+    }
+}
+
+#ifdef ROC_AUDIO_MIXER_SSE2
+
+void mix_sse2(sample_t* out, const sample_t* in, size_t n_samples) {
+    const __m128 v_min = _mm_set1_ps(Sample_Min);
+    const __m128 v_max = _mm_set1_ps(Sample_Max);
+
+    size_t n = 0;
+
+    for (; n + 8 <= n_samples; n += 8) {
+        __m128 a0 = _mm_add_ps(_mm_loadu_ps(out + n), _mm_loadu_ps(in + n));
+        __m128 a1 = _mm_add_ps(_mm_loadu_ps(out + n + 4), _mm_loadu_ps(in + n + 4));
+
+        a0 = _mm_max_ps(_mm_min_ps(a0, v_max), v_min);
+        a1 = _mm_max_ps(_mm_min_ps(a1, v_max), v_min);
+
+        _mm_storeu_ps(out + n, a0);
+        _mm_storeu_ps(out + n + 4, a1);
+    }
+
+    mix_scalar(out + n, in + n, n_samples - n);
+}
+
+#endif // ROC_AUDIO_MIXER_SSE2
+
+#ifdef ROC_AUDIO_MIXER_AVX
+
+__attribute__((target("avx"))) void
+mix_avx(sample_t* out, const sample_t* in, size_t n_samples) {
+    const __m256 v_min = _mm256_set1_ps(Sample_Min);
+    const __m256 v_max = _mm256_set1_ps(Sample_Max);
+
+    size_t n = 0;
+
+    for (; n + 16 <= n_samples; n += 16) {
+        __m256 a0 = _mm256_add_ps(_mm256_loadu_ps(out + n), _mm256_loadu_ps(in + n));
+        __m256 a1 =
+            _mm256_add_ps(_mm256_loadu_ps(out + n + 8), _mm256_loadu_ps(in + n + 8));
+
+        a0 = _mm256_max_ps(_mm256_min_ps(a0, v_max), v_min);
+        a1 = _mm256_max_ps(_mm256_min_ps(a1, v_max), v_min);
+
+        _mm256_storeu_ps(out + n, a0);
+        _mm256_storeu_ps(out + n + 8, a1);
+    }
+
+    // Avoid AVX-SSE transition penalty in the tail.
+    _mm256_zeroupper();
+
+    mix_scalar(out + n, in + n, n_samples - n);
+}
+
+#endif // ROC_AUDIO_MIXER_AVX
+
+#ifdef ROC_AUDIO_MIXER_NEON
+
+void mix_neon(sample_t* out, const sample_t* in, size_t n_samples) {
+    const float32x4_t v_min = vdupq_n_f32(Sample_Min);
+    const float32x4_t v_max = vdupq_n_f32(Sample_Max);
+
+    size_t n = 0;
+
+    for (; n + 8 <= n_samples; n += 8) {
+        float32x4_t a0 = vaddq_f32(vld1q_f32(out + n), vld1q_f32(in + n));
+        float32x4_t a1 = vaddq_f32(vld1q_f32(out + n + 4), vld1q_f32(in + n + 4));
+
+        a0 = vmaxq_f32(vminq_f32(a0, v_max), v_min);
+        a1 = vmaxq_f32(vminq_f32(a1, v_max), v_min);
+
+        vst1q_f32(out + n, a0);
+        vst1q_f32(out + n + 4, a1);
+    }
+
+    mix_scalar(out + n, in + n, n_samples - n);
+}
+
+#endif // ROC_AUDIO_MIXER_NEON
+
+} // namespace
+
+MixerKernelFunc mixer_kernel_func(MixerKernel kernel) {
+    switch (kernel) {
+    case MixerKernel_Scalar:
+        return &mix_scalar;
+
+    case MixerKernel_SSE2:
+#ifdef ROC_AUDIO_MIXER_SSE2
+        if (core::cpu_supports(core::CpuFeature_SSE2)) {
+            return &mix_sse2;
+        }
+#endif
+        break;
+
+    case MixerKernel_AVX:
+#ifdef ROC_AUDIO_MIXER_AVX
+        if (core::cpu_supports(core::CpuFeature_AVX)) {
+            return &mix_avx;
+        }
+#endif
+        break;
+
+    case MixerKernel_NEON:
+#ifdef ROC_AUDIO_MIXER_NEON
+        if (core::cpu_supports(core::CpuFeature_NEON)) {
+            return &mix_neon;
+        }
+#endif
+        break;
+
+    case MixerKernel_Max:
+        break;
+    }
+
+    return NULL;
+}
+
+MixerKernel mixer_kernel_best() {
+    // Ordered from fastest to slowest.
+    const MixerKernel candidates[] = {
+        MixerKernel_AVX,
+        MixerKernel_SSE2,
+        MixerKernel_NEON,
+    };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(candidates); n++) {
+        if (mixer_kernel_func(candidates[n])) {
+            return candidates[n];
+        }
+    }
+
+    return MixerKernel_Scalar;
+}
+
+const char* mixer_kernel_to_str(MixerKernel kernel) {
+    switch (kernel) {
+    case MixerKernel_Scalar:
+        return "scalar";
+
+    case MixerKernel_SSE2:
+        return "sse2";
+
+    case MixerKernel_AVX:
+        return "avx";
+
+    case MixerKernel_NEON:
+        return "neon";
+
+    case MixerKernel_Max:
+        break;
+    }
+
+    return "invalid";
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/mixer_kernel.h
+//! @brief Mixer kernels.
+
+#ifndef ROC_AUDIO_MIXER_KERNEL_H_
+#define ROC_AUDIO_MIXER_KERNEL_H_
+
+#include "roc_audio/sample.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Mixer kernel implementations.
+enum MixerKernel {
+    //! Portable scalar implementation.
+    //! Always available.
+    MixerKernel_Scalar,
+
+    //! x86 SSE2 implementation.
+    MixerKernel_SSE2,
+
+    //! x86 AVX implementation.
+    MixerKernel_AVX,
+
+    //! ARM NEON implementation.
+    MixerKernel_NEON,
+
+    //! Number of kernels.
+    MixerKernel_Max
+};
+
+//! Mixer kernel function.
+//! Adds @p n_samples samples from @p in to @p out, saturating every
+//! result to [Sample_Min; Sample_Max] range.
+typedef void (*MixerKernelFunc)(sample_t* out, const sample_t* in, size_t n_samples);
+
+//! Get mixer kernel function.
+//! @returns
+//!  NULL if the kernel was not enabled at compile time or is not
+//!  supported by current CPU.
+MixerKernelFunc mixer_kernel_func(MixerKernel kernel);
+
+//! Get fastest mixer kernel supported by current CPU.
+MixerKernel mixer_kernel_best();
+
+//! Get string name of mixer kernel.
+const char* mixer_kernel_to_str(MixerKernel kernel);
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_MIXER_KERNEL_H_
@@ -21,7 +21,8 @@ Packetizer::Packetizer(packet::IWriter& writer,
                        IFrameEncoder& payload_encoder,
                        packet::PacketFactory& packet_factory,
                        core::nanoseconds_t packet_length,
-                       const SampleSpec& sample_spec)
+                       const SampleSpec& sample_spec,
+                       const DtxConfig& dtx_config)
     : writer_(writer)
     , composer_(composer)
     , sequencer_(sequencer)
@@ -33,6 +34,11 @@ Packetizer::Packetizer(packet::IWriter& writer,
     , packet_pos_(0)
     , packet_cts_(0)
     , capture_ts_(0)
+    , dtx_config_(dtx_config)
+    , keepalive_samples_(0)
+    , packet_silent_(false)
+    , in_silence_(false)
+    , unsent_samples_(0)
     , valid_(false) {
     roc_panic_if_msg(!sample_spec_.is_valid() || !sample_spec_.is_raw(),
                      "packetizer: required valid sample spec with raw format: %s",
@@ -50,12 +56,19 @@ Packetizer::Packetizer(packet::IWriter& writer,
     samples_per_packet_ = sample_spec.ns_2_stream_timestamp(packet_length);
     payload_size_ = payload_encoder.encoded_byte_count(samples_per_packet_);
 
+    if (dtx_config_.keepalive_interval > 0) {
+        keepalive_samples_ =
+            sample_spec.ns_2_stream_timestamp(dtx_config_.keepalive_interval);
+    }
+
     roc_log(
         LogDebug,
         "packetizer: initializing:"
-        " packet_length=%.3fms samples_per_packet=%lu payload_size=%lu sample_spec=%s",
+        " packet_length=%.3fms samples_per_packet=%lu payload_size=%lu sample_spec=%s"
+        " dtx=%d",
         (double)packet_length / core::Millisecond, (unsigned long)samples_per_packet_,
-        (unsigned long)payload_size_, sample_spec_to_str(sample_spec_).c_str());
+        (unsigned long)payload_size_, sample_spec_to_str(sample_spec_).c_str(),
+        (int)dtx_config_.enabled);
 
     valid_ = true;
 }
@@ -91,6 +104,11 @@ void Packetizer::write(Frame& frame) {
         const size_t n_requested =
             std::min(buffer_samples, samples_per_packet_ - packet_pos_);
 
+        if (packet_silent_) {
+            packet_silent_ =
+                is_silent_(buffer_ptr, n_requested * sample_spec_.num_channels());
+        }
+
         const size_t n_encoded = payload_encoder_.write(buffer_ptr, n_requested);
         roc_panic_if_not(n_encoded == n_requested);
 
@@ -123,6 +141,7 @@ bool Packetizer::begin_packet_() {
     packet_ = pp;
     packet_pos_ = 0;
     packet_cts_ = capture_ts_;
+    packet_silent_ = dtx_config_.enabled;
 
     // Begin encoding samples into packet.
     payload_encoder_.begin(packet_->payload().data(), packet_->payload().size());
@@ -131,21 +150,31 @@ bool Packetizer::begin_packet_() {
 }
 
 void Packetizer::end_packet_() {
-    // How much bytes we've written into packet payload.
-    const size_t written_payload_size = payload_encoder_.encoded_byte_count(packet_pos_);
+    // Finish encoding samples into packet.
+    // Returns how much bytes we've written into packet payload.
+    const size_t written_payload_size = payload_encoder_.end();
     roc_panic_if_not(written_payload_size <= payload_size_);
 
-    // Finish encoding samples into packet.
-    payload_encoder_.end();
+    if (suppress_packet_()) {
+        // Advance stream timestamp, but not seqnum.
+        sequencer_.skip((packet::stream_timestamp_t)packet_pos_);
 
-    // Fill protocol-specific fields.
-    sequencer_.next(*packet_, packet_cts_, (packet::stream_timestamp_t)packet_pos_);
+        metrics_.suppressed_count++;
 
-    // Apply padding if needed.
-    if (packet_pos_ < samples_per_packet_) {
-        pad_packet_(written_payload_size);
+        packet_ = NULL;
+        packet_pos_ = 0;
+        packet_cts_ = 0;
+        return;
     }
 
+    // Cut unused part of payload.
+    if (written_payload_size < payload_size_) {
+        shrink_packet_(written_payload_size);
+    }
+
+    // Fill protocol-specific fields.
+    sequencer_.next(*packet_, packet_cts_, (packet::stream_timestamp_t)packet_pos_);
+
     const status::StatusCode code = writer_.write(packet_);
     // TODO(gh-183): forward status
     roc_panic_if(code != status::StatusOK);
@@ -158,11 +187,73 @@ void Packetizer::end_packet_() {
     packet_cts_ = 0;
 }
 
-void Packetizer::pad_packet_(size_t written_payload_size) {
-    if (written_payload_size == payload_size_) {
+bool Packetizer::suppress_packet_() {
+    if (!packet_silent_) {
+        in_silence_ = false;
+        return false;
+    }
+
+    // First silent packet is always sent, so that decoder on receiver
+    // can smoothly fade out.
+    if (!in_silence_) {
+        in_silence_ = true;
+        unsent_samples_ = 0;
+        return false;
+    }
+
+    unsent_samples_ += packet_pos_;
+
+    if (keepalive_samples_ != 0 && unsent_samples_ >= keepalive_samples_) {
+        unsent_samples_ = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool Packetizer::is_silent_(const sample_t* samples, size_t n_samples) const {
+    const sample_t threshold = dtx_config_.silence_threshold;
+
+    for (size_t n = 0; n < n_samples; n++) {
+        if (samples[n] > threshold || samples[n] < -threshold) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Packetizer::shrink_packet_(size_t written_payload_size) {
+    // FEC block requires all packets to have same size.
+    if (packet_->has_flags(packet::Packet::FlagFEC)) {
+        pad_packet_(written_payload_size);
+        return;
+    }
+
+    // Re-prepare headers over the same buffer with smaller payload.
+    // Headers and payload stay at the same offsets, so encoded data is preserved.
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        pad_packet_(written_payload_size);
         return;
     }
 
+    pp->add_flags(packet::Packet::FlagAudio);
+
+    core::Slice<uint8_t> buffer = packet_->buffer();
+
+    if (!composer_.prepare(*pp, buffer, written_payload_size)) {
+        roc_panic("packetizer: can't shrink packet: orig_size=%lu actual_size=%lu",
+                  (unsigned long)payload_size_, (unsigned long)written_payload_size);
+    }
+    pp->add_flags(packet::Packet::FlagPrepared);
+
+    pp->set_buffer(buffer);
+
+    packet_ = pp;
+}
+
+void Packetizer::pad_packet_(size_t written_payload_size) {
     if (!composer_.pad(*packet_, payload_size_ - written_payload_size)) {
         roc_panic("packetizer: can't pad packet: orig_size=%lu actual_size=%lu",
                   (unsigned long)payload_size_, (unsigned long)written_payload_size);
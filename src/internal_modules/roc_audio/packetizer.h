@@ -27,6 +27,32 @@
 namespace roc {
 namespace audio {
 
+//! Discontinuous transmission (DTX) parameters.
+//! @remarks
+//!  When DTX is enabled, packetizer doesn't send packets which contain only
+//!  silence, except the first one and sparse keepalive packets. Sequence numbers
+//!  of sent packets remain continuous, so receiver can tell intended silence from
+//!  packet loss.
+struct DtxConfig {
+    //! Enable DTX.
+    bool enabled;
+
+    //! Maximum absolute value of sample considered silent.
+    //! Zero means that only digital silence is suppressed.
+    sample_t silence_threshold;
+
+    //! Maximum interval between packets during silence, nanoseconds.
+    //! Keeps receiver session alive; should be below receiver's
+    //! no-playback timeout. If zero, keepalive packets are not sent.
+    core::nanoseconds_t keepalive_interval;
+
+    DtxConfig()
+        : enabled(false)
+        , silence_threshold(0)
+        , keepalive_interval(100 * core::Millisecond) {
+    }
+};
+
 //! Metrics of packetizer.
 struct PacketizerMetrics {
     //! Cumulative count of produced packets.
@@ -36,9 +62,13 @@ struct PacketizerMetrics {
     //! This excludes packet headers and padding.
     uint64_t payload_count;
 
+    //! Cumulative count of packets suppressed because of silence.
+    uint64_t suppressed_count;
+
     PacketizerMetrics()
         : packet_count(0)
-        , payload_count(0) {
+        , payload_count(0)
+        , suppressed_count(0) {
     }
 };
 
@@ -46,6 +76,13 @@ struct PacketizerMetrics {
 //! @remarks
 //!  Gets an audio stream, encodes samples to packets using an encoder, and
 //!  writes packets to a packet writer.
+//!
+//!  If encoder produced less bytes than the packet can hold (e.g. because of
+//!  flush or because encoder has variable output size), packet is shrunk to
+//!  the actual payload size. For FEC packets, which should have equal sizes
+//!  within a block, the rest of the payload is marked as padding instead.
+//!
+//!  If DTX is enabled, silent packets are dropped, see DtxConfig.
 class Packetizer : public IFrameWriter, public core::NonCopyable<> {
 public:
     //! Initialization.
@@ -59,13 +96,15 @@ public:
     //!  - @p buffer_factory is used to allocate buffers for packets
     //!  - @p packet_length defines packet length in nanoseconds
     //!  - @p sample_spec describes input frames
+    //!  - @p dtx_config defines silence suppression parameters
     Packetizer(packet::IWriter& writer,
                packet::IComposer& composer,
                packet::ISequencer& sequencer,
                IFrameEncoder& payload_encoder,
                packet::PacketFactory& packet_factory,
                core::nanoseconds_t packet_length,
-               const SampleSpec& sample_spec);
+               const SampleSpec& sample_spec,
+               const DtxConfig& dtx_config = DtxConfig());
 
     //! Check if object is successfully constructed.
     bool is_valid() const;
@@ -88,6 +127,10 @@ private:
     bool begin_packet_();
     void end_packet_();
 
+    bool suppress_packet_();
+    bool is_silent_(const sample_t* samples, size_t n_samples) const;
+
+    void shrink_packet_(size_t written_payload_size);
     void pad_packet_(size_t written_payload_size);
 
     packet::PacketPtr create_packet_();
@@ -109,6 +152,12 @@ private:
 
     core::nanoseconds_t capture_ts_;
 
+    const DtxConfig dtx_config_;
+    size_t keepalive_samples_;
+    bool packet_silent_;
+    bool in_silence_;
+    size_t unsent_samples_;
+
     PacketizerMetrics metrics_;
 
     bool valid_;
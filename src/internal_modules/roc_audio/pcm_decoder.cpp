@@ -113,5 +113,10 @@ void PcmDecoder::end() {
     frame_bit_off_ = 0;
 }
 
+size_t PcmDecoder::conceal(sample_t*, size_t) {
+    // PCM has no inter-frame state to extrapolate from.
+    return 0;
+}
+
 } // namespace audio
 } // namespace roc
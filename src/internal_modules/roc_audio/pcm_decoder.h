@@ -52,6 +52,9 @@ public:
     //! Finish decoding current frame.
     virtual void end();
 
+    //! Generate samples in place of lost frames.
+    virtual size_t conceal(sample_t* samples, size_t n_samples);
+
 private:
     PcmMapper pcm_mapper_;
     const size_t n_chans_;
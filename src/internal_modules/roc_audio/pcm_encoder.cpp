@@ -12,7 +12,9 @@
 namespace roc {
 namespace audio {
 
-IFrameEncoder* PcmEncoder::construct(core::IArena& arena, const SampleSpec& sample_spec) {
+IFrameEncoder* PcmEncoder::construct(core::IArena& arena,
+                                     const SampleSpec& sample_spec,
+                                     const FrameEncoderConfig&) {
     return new (arena) PcmEncoder(sample_spec);
 }
 
@@ -58,14 +60,18 @@ size_t PcmEncoder::write(const sample_t* samples, size_t n_samples) {
     return n_mapped_samples;
 }
 
-void PcmEncoder::end() {
+size_t PcmEncoder::end() {
     if (!frame_data_) {
         roc_panic("pcm encoder: unpaired begin/end");
     }
 
+    const size_t written_bytes = (frame_bit_off_ + 7) / 8;
+
     frame_data_ = NULL;
     frame_byte_size_ = 0;
     frame_bit_off_ = 0;
+
+    return written_bytes;
 }
 
 } // namespace audio
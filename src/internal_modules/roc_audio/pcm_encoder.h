@@ -12,6 +12,7 @@
 #ifndef ROC_AUDIO_PCM_ENCODER_H_
 #define ROC_AUDIO_PCM_ENCODER_H_
 
+#include "roc_audio/frame_encoder_config.h"
 #include "roc_audio/iframe_encoder.h"
 #include "roc_audio/pcm_mapper.h"
 #include "roc_audio/sample_spec.h"
@@ -24,7 +25,9 @@ namespace audio {
 class PcmEncoder : public IFrameEncoder, public core::NonCopyable<> {
 public:
     //! Construction function.
-    static IFrameEncoder* construct(core::IArena& arena, const SampleSpec& sample_spec);
+    static IFrameEncoder* construct(core::IArena& arena,
+                                    const SampleSpec& sample_spec,
+                                    const FrameEncoderConfig& config);
 
     //! Initialize.
     PcmEncoder(const SampleSpec& sample_spec);
@@ -39,7 +42,7 @@ public:
     virtual size_t write(const sample_t* samples, size_t n_samples);
 
     //! Finish encoding frame.
-    virtual void end();
+    virtual size_t end();
 
 private:
     PcmMapper pcm_mapper_;
@@ -520,6 +520,48 @@ TYPES = [
     ('double', 8),
 ]
 
+# pcm code pairs with SIMD bulk mapping, see pcm_bulk_*() functions
+# in template; big-endian integers are byte-swapped
+BULK_PAIRS = []
+
+for code, short_name, width in [
+        ('SInt16', 's16', 16),
+        ('SInt24', 's24', 24),
+        ('SInt32', 's32', 32),
+    ]:
+    for endian in ['Little', 'Big']:
+        swap = str(endian == 'Big').lower()
+
+        BULK_PAIRS.append({
+            'in_code': code,
+            'in_endian': endian,
+            'in_width': width,
+            'out_code': 'Float32',
+            'out_endian': 'Little',
+            'out_width': 32,
+            'func': f'pcm_bulk_{short_name}_to_f32',
+            'swap': swap,
+        })
+
+        BULK_PAIRS.append({
+            'in_code': 'Float32',
+            'in_endian': 'Little',
+            'in_width': 32,
+            'out_code': code,
+            'out_endian': endian,
+            'out_width': width,
+            'func': f'pcm_bulk_f32_to_{short_name}',
+            'swap': swap,
+        })
+
+# pcm codes that are mapped to themselves by plain copy, when
+# endians match; these have no padding and are byte-aligned
+COPY_CODES = []
+
+for code in CODES:
+    if code['width'] == code['packed_width'] and code['width'] % 8 == 0:
+        COPY_CODES.append(code)
+
 for code in CODES:
     code['min'] = f"pcm_{code['code'].lower()}_min"
     code['max'] = f"pcm_{code['code'].lower()}_max"
@@ -851,6 +893,328 @@ template <> struct pcm_packer<PcmCode_{{ code.code }}, PcmEndian_{{ endian }}> {
 };
 
 {% endfor %}
+{% endfor %}
+// SIMD bulk mapping is implemented only for little-endian CPUs, where
+// native float is Float32 Little-Endian.
+#if ROC_CPU_ENDIAN == ROC_CPU_LE && ROC_CPU_FAMILY == ROC_CPU_X86 && ROC_CPU_HAS_SSE2
+#define ROC_AUDIO_PCM_SSE2
+#include <emmintrin.h>
+#elif ROC_CPU_ENDIAN == ROC_CPU_LE && ROC_CPU_FAMILY == ROC_CPU_ARM && ROC_CPU_HAS_NEON
+#define ROC_AUDIO_PCM_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(ROC_AUDIO_PCM_SSE2) || defined(ROC_AUDIO_PCM_NEON)
+#define ROC_AUDIO_PCM_BULK
+#endif
+
+#ifdef ROC_AUDIO_PCM_SSE2
+
+// Swap bytes in every 16-bit lane
+inline __m128i pcm_bulk_bswap16(__m128i x) {
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+// Swap bytes in every 32-bit lane
+inline __m128i pcm_bulk_bswap32(__m128i x) {
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    return pcm_bulk_bswap16(x);
+}
+
+// Convert 4 integers to floats
+inline __m128 pcm_bulk_i32_to_f32(__m128i x, float scale) {
+    return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(scale));
+}
+
+// Convert 4 floats to integers, clipping in the same way as
+// pcm_code_converter does
+inline __m128i pcm_bulk_f32_to_i32(__m128 x, float scale, int32_t max) {
+    const __m128 v_scale = _mm_set1_ps(scale);
+    const __m128 v = _mm_max_ps(_mm_mul_ps(x, v_scale), _mm_set1_ps(-scale));
+    const __m128i clip = _mm_castps_si128(_mm_cmpge_ps(v, v_scale));
+    return _mm_or_si128(_mm_andnot_si128(clip, _mm_cvttps_epi32(v)),
+                        _mm_and_si128(clip, _mm_set1_epi32(max)));
+}
+
+#endif // ROC_AUDIO_PCM_SSE2
+
+#ifdef ROC_AUDIO_PCM_NEON
+
+// Convert 4 integers to floats
+inline float32x4_t pcm_bulk_i32_to_f32(int32x4_t x, float scale) {
+    return vmulq_f32(vcvtq_f32_s32(x), vdupq_n_f32(scale));
+}
+
+// Convert 4 floats to integers, clipping in the same way as
+// pcm_code_converter does
+inline int32x4_t pcm_bulk_f32_to_i32(float32x4_t x, float scale, int32_t max) {
+    const float32x4_t v_scale = vdupq_n_f32(scale);
+    const float32x4_t v = vmaxq_f32(vmulq_f32(x, v_scale), vdupq_n_f32(-scale));
+    return vbslq_s32(vcgeq_f32(v, v_scale), vdupq_n_s32(max), vcvtq_s32_f32(v));
+}
+
+#endif // ROC_AUDIO_PCM_NEON
+
+#ifdef ROC_AUDIO_PCM_BULK
+
+// Bulk SInt16 to Float32 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_s16_to_f32(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 1.0f / 32768.0f;
+    size_t n = 0;
+#if defined(ROC_AUDIO_PCM_SSE2)
+    for (; n + 8 <= n_samples; n += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + n * 2));
+        if (swap) {
+            x = pcm_bulk_bswap16(x);
+        }
+        // sign extension
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps((float*)(out + n * 4), pcm_bulk_i32_to_f32(lo, scale));
+        _mm_storeu_ps((float*)(out + n * 4 + 16), pcm_bulk_i32_to_f32(hi, scale));
+    }
+#elif defined(ROC_AUDIO_PCM_NEON)
+    for (; n + 8 <= n_samples; n += 8) {
+        uint8x16_t b = vld1q_u8(in + n * 2);
+        if (swap) {
+            b = vrev16q_u8(b);
+        }
+        const int16x8_t x = vreinterpretq_s16_u8(b);
+        const float32x4_t lo = pcm_bulk_i32_to_f32(vmovl_s16(vget_low_s16(x)), scale);
+        const float32x4_t hi = pcm_bulk_i32_to_f32(vmovl_s16(vget_high_s16(x)), scale);
+        vst1q_u8(out + n * 4, vreinterpretq_u8_f32(lo));
+        vst1q_u8(out + n * 4 + 16, vreinterpretq_u8_f32(hi));
+    }
+#endif
+    return n;
+}
+
+// Bulk Float32 to SInt16 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_f32_to_s16(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 32768.0f;
+    const int32_t max = 32767;
+    size_t n = 0;
+#if defined(ROC_AUDIO_PCM_SSE2)
+    for (; n + 8 <= n_samples; n += 8) {
+        const __m128i lo = pcm_bulk_f32_to_i32(
+            _mm_loadu_ps((const float*)(in + n * 4)), scale, max);
+        const __m128i hi = pcm_bulk_f32_to_i32(
+            _mm_loadu_ps((const float*)(in + n * 4 + 16)), scale, max);
+        // values are already in range, no saturation happens
+        __m128i x = _mm_packs_epi32(lo, hi);
+        if (swap) {
+            x = pcm_bulk_bswap16(x);
+        }
+        _mm_storeu_si128((__m128i*)(out + n * 2), x);
+    }
+#elif defined(ROC_AUDIO_PCM_NEON)
+    for (; n + 8 <= n_samples; n += 8) {
+        const int32x4_t lo = pcm_bulk_f32_to_i32(
+            vreinterpretq_f32_u8(vld1q_u8(in + n * 4)), scale, max);
+        const int32x4_t hi = pcm_bulk_f32_to_i32(
+            vreinterpretq_f32_u8(vld1q_u8(in + n * 4 + 16)), scale, max);
+        uint8x16_t b =
+            vreinterpretq_u8_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+        if (swap) {
+            b = vrev16q_u8(b);
+        }
+        vst1q_u8(out + n * 2, b);
+    }
+#endif
+    return n;
+}
+
+// Bulk SInt24 to Float32 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_s24_to_f32(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 1.0f / 8388608.0f;
+    size_t n = 0;
+    for (; n + 4 <= n_samples; n += 4) {
+        // gather 3-byte samples into upper bits of 32-bit lanes
+        uint32_t v[4];
+        for (size_t i = 0; i < 4; i++) {
+            const uint8_t* p = in + (n + i) * 3;
+            if (swap) {
+                v[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16)
+                    | (uint32_t(p[2]) << 8);
+            } else {
+                v[i] = (uint32_t(p[2]) << 24) | (uint32_t(p[1]) << 16)
+                    | (uint32_t(p[0]) << 8);
+            }
+        }
+#if defined(ROC_AUDIO_PCM_SSE2)
+        // sign extension
+        const __m128i x = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)v), 8);
+        _mm_storeu_ps((float*)(out + n * 4), pcm_bulk_i32_to_f32(x, scale));
+#elif defined(ROC_AUDIO_PCM_NEON)
+        // sign extension
+        const int32x4_t x = vshrq_n_s32(vreinterpretq_s32_u32(vld1q_u32(v)), 8);
+        vst1q_u8(out + n * 4, vreinterpretq_u8_f32(pcm_bulk_i32_to_f32(x, scale)));
+#endif
+    }
+    return n;
+}
+
+// Bulk Float32 to SInt24 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_f32_to_s24(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 8388608.0f;
+    const int32_t max = 8388607;
+    size_t n = 0;
+    for (; n + 4 <= n_samples; n += 4) {
+        int32_t v[4];
+#if defined(ROC_AUDIO_PCM_SSE2)
+        _mm_storeu_si128((__m128i*)v,
+                         pcm_bulk_f32_to_i32(_mm_loadu_ps((const float*)(in + n * 4)),
+                                             scale, max));
+#elif defined(ROC_AUDIO_PCM_NEON)
+        vst1q_s32(v,
+                  pcm_bulk_f32_to_i32(vreinterpretq_f32_u8(vld1q_u8(in + n * 4)),
+                                      scale, max));
+#endif
+        // scatter 32-bit lanes into 3-byte samples
+        for (size_t i = 0; i < 4; i++) {
+            uint8_t* p = out + (n + i) * 3;
+            const uint32_t u = uint32_t(v[i]);
+            if (swap) {
+                p[0] = uint8_t(u >> 16);
+                p[1] = uint8_t(u >> 8);
+                p[2] = uint8_t(u);
+            } else {
+                p[0] = uint8_t(u);
+                p[1] = uint8_t(u >> 8);
+                p[2] = uint8_t(u >> 16);
+            }
+        }
+    }
+    return n;
+}
+
+// Bulk SInt32 to Float32 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_s32_to_f32(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 1.0f / 2147483648.0f;
+    size_t n = 0;
+#if defined(ROC_AUDIO_PCM_SSE2)
+    for (; n + 4 <= n_samples; n += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + n * 4));
+        if (swap) {
+            x = pcm_bulk_bswap32(x);
+        }
+        _mm_storeu_ps((float*)(out + n * 4), pcm_bulk_i32_to_f32(x, scale));
+    }
+#elif defined(ROC_AUDIO_PCM_NEON)
+    for (; n + 4 <= n_samples; n += 4) {
+        uint8x16_t b = vld1q_u8(in + n * 4);
+        if (swap) {
+            b = vrev32q_u8(b);
+        }
+        vst1q_u8(out + n * 4,
+                 vreinterpretq_u8_f32(
+                     pcm_bulk_i32_to_f32(vreinterpretq_s32_u8(b), scale)));
+    }
+#endif
+    return n;
+}
+
+// Bulk Float32 to SInt32 mapping
+// Returns number of mapped samples
+inline size_t
+pcm_bulk_f32_to_s32(const uint8_t* in, uint8_t* out, size_t n_samples, bool swap) {
+    const float scale = 2147483648.0f;
+    const int32_t max = 2147483647;
+    size_t n = 0;
+#if defined(ROC_AUDIO_PCM_SSE2)
+    for (; n + 4 <= n_samples; n += 4) {
+        __m128i x =
+            pcm_bulk_f32_to_i32(_mm_loadu_ps((const float*)(in + n * 4)), scale, max);
+        if (swap) {
+            x = pcm_bulk_bswap32(x);
+        }
+        _mm_storeu_si128((__m128i*)(out + n * 4), x);
+    }
+#elif defined(ROC_AUDIO_PCM_NEON)
+    for (; n + 4 <= n_samples; n += 4) {
+        uint8x16_t b = vreinterpretq_u8_s32(pcm_bulk_f32_to_i32(
+            vreinterpretq_f32_u8(vld1q_u8(in + n * 4)), scale, max));
+        if (swap) {
+            b = vrev32q_u8(b);
+        }
+        vst1q_u8(out + n * 4, b);
+    }
+#endif
+    return n;
+}
+
+#endif // ROC_AUDIO_PCM_BULK
+
+// Bulk mapping for byte-aligned buffers
+// Returns number of mapped samples; remaining samples are mapped
+// by the generic path
+template <PcmCode InCode, PcmEndian InEndian, PcmCode OutCode, PcmEndian OutEndian>
+struct pcm_bulk_mapper {
+    static inline size_t map(const uint8_t*, size_t&, uint8_t*, size_t&, size_t) {
+        return 0;
+    }
+};
+
+#ifdef ROC_AUDIO_PCM_BULK
+
+{% for pair in BULK_PAIRS %}
+// {{ pair.in_code }} {{ pair.in_endian }}-Endian to {{ pair.out_code }} {{ pair.out_endian }}-Endian bulk mapping
+template <>
+struct pcm_bulk_mapper<PcmCode_{{ pair.in_code }},
+                       PcmEndian_{{ pair.in_endian }},
+                       PcmCode_{{ pair.out_code }},
+                       PcmEndian_{{ pair.out_endian }}> {
+    static inline size_t map(const uint8_t* in_data,
+                             size_t& in_bit_off,
+                             uint8_t* out_data,
+                             size_t& out_bit_off,
+                             size_t n_samples) {
+        if ((in_bit_off & 0x7u) != 0 || (out_bit_off & 0x7u) != 0) {
+            return 0;
+        }
+        const uint8_t* in = in_data + (in_bit_off >> 3);
+        uint8_t* out = out_data + (out_bit_off >> 3);
+        const size_t n = {{ pair.func }}(in, out, n_samples, {{ pair.swap }});
+        in_bit_off += n * {{ pair.in_width }};
+        out_bit_off += n * {{ pair.out_width }};
+        return n;
+    }
+};
+
+{% endfor %}
+#endif // ROC_AUDIO_PCM_BULK
+
+{% for code in COPY_CODES %}
+// {{ code.code }} to {{ code.code }} bulk mapping (same endian)
+template <PcmEndian Endian>
+struct pcm_bulk_mapper<PcmCode_{{ code.code }}, Endian, PcmCode_{{ code.code }}, Endian> {
+    static inline size_t map(const uint8_t* in_data,
+                             size_t& in_bit_off,
+                             uint8_t* out_data,
+                             size_t& out_bit_off,
+                             size_t n_samples) {
+        if ((in_bit_off & 0x7u) != 0 || (out_bit_off & 0x7u) != 0) {
+            return 0;
+        }
+        memcpy(out_data + (out_bit_off >> 3), in_data + (in_bit_off >> 3),
+               n_samples * {{ code.width // 8 }});
+        in_bit_off += n_samples * {{ code.width }};
+        out_bit_off += n_samples * {{ code.width }};
+        return n_samples;
+    }
+};
+
 {% endfor %}
 // Mapping function implementation
 template <PcmCode InCode, PcmEndian InEndian, PcmCode OutCode, PcmEndian OutEndian>
@@ -860,7 +1224,10 @@ struct pcm_mapper {
                     uint8_t* out_data,
                     size_t& out_bit_off,
                     size_t n_samples) {
-        for (size_t n = 0; n < n_samples; n++) {
+        size_t n = pcm_bulk_mapper<InCode, InEndian, OutCode, OutEndian>::map(
+            in_data, in_bit_off, out_data, out_bit_off, n_samples);
+
+        for (; n < n_samples; n++) {
             pcm_packer<OutCode, OutEndian>::pack(
                 out_data, out_bit_off,
                 pcm_code_converter<InCode, OutCode>::convert(
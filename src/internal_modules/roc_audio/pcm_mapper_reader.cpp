@@ -75,7 +75,7 @@ bool PcmMapperReader::read(Frame& out_frame) {
     const size_t out_bit_count = mapper_.output_bit_count(out_sample_count * num_ch_);
     size_t out_bit_offset = 0;
 
-    unsigned out_flags = 0;
+    unsigned out_flags = Frame::FlagSilent;
 
     while (out_bit_offset < out_bit_count) {
         const size_t n_samples =
@@ -92,7 +92,7 @@ bool PcmMapperReader::read(Frame& out_frame) {
         mapper_.map(in_buf_.data(), in_byte_count, in_bit_offset, out_frame.bytes(),
                     out_frame.num_bytes(), out_bit_offset, n_samples * num_ch_);
 
-        out_flags |= in_frame.flags();
+        out_flags = Frame::combine_flags(out_flags, in_frame.flags());
         if (out_sample_offset == 0) {
             out_frame.set_capture_timestamp(in_frame.capture_timestamp());
         }
@@ -32,15 +32,27 @@ Profiler::Profiler(core::IArena& arena,
     , last_chunk_samples_(0)
     , moving_avg_(0)
     , sample_spec_(sample_spec)
+    , sampling_frames_(std::max(profiler_config.sampling_frames, (size_t)1))
+    , sampling_interval_(profiler_config.sampling_interval > 0
+                             ? sample_spec.ns_2_stream_timestamp(
+                                   profiler_config.sampling_interval)
+                             : 0)
+    , frames_since_measure_(0)
+    , duration_since_measure_(0)
+    , measured_frames_(0)
+    , skipped_frames_(0)
     , valid_(false)
     , buffer_full_(false) {
     if (profiler_config.profiling_interval < 0 || profiler_config.chunk_duration < 0
-        || chunk_length_ == 0 || num_chunks_ == 0) {
+        || profiler_config.sampling_interval < 0 || chunk_length_ == 0
+        || num_chunks_ == 0) {
         roc_log(LogError,
                 "profile: invalid config:"
-                " profiling_interval=%.3fms chunk_duration=%.3fms",
+                " profiling_interval=%.3fms chunk_duration=%.3fms"
+                " sampling_interval=%.3fms",
                 (double)profiler_config.profiling_interval / core::Millisecond,
-                (double)profiler_config.chunk_duration / core::Millisecond);
+                (double)profiler_config.chunk_duration / core::Millisecond,
+                (double)profiler_config.sampling_interval / core::Millisecond);
         return;
     }
 
@@ -56,10 +68,19 @@ bool Profiler::is_valid() const {
     return valid_;
 }
 
+bool Profiler::should_measure() const {
+    return frames_since_measure_ + 1 >= sampling_frames_
+        && duration_since_measure_ >= sampling_interval_;
+}
+
 void Profiler::add_frame(packet::stream_timestamp_t frame_duration,
                          core::nanoseconds_t elapsed) {
     roc_panic_if(!valid_);
 
+    frames_since_measure_ = 0;
+    duration_since_measure_ = 0;
+    measured_frames_++;
+
     update_moving_avg_(frame_duration, elapsed);
 
     if (rate_limiter_.allow()) {
@@ -70,7 +91,29 @@ void Profiler::add_frame(packet::stream_timestamp_t frame_duration,
     }
 }
 
-float Profiler::get_moving_avg() {
+void Profiler::skip_frame(packet::stream_timestamp_t frame_duration) {
+    roc_panic_if(!valid_);
+
+    frames_since_measure_++;
+    duration_since_measure_ += frame_duration;
+    skipped_frames_++;
+}
+
+ProfilerMetrics Profiler::metrics() const {
+    ProfilerMetrics metrics;
+
+    if (measured_frames_ != 0) {
+        metrics.speed = get_moving_avg();
+        metrics.speed_ratio = metrics.speed / sample_spec_.sample_rate();
+    }
+
+    metrics.measured_frames = measured_frames_;
+    metrics.skipped_frames = skipped_frames_;
+
+    return metrics;
+}
+
+float Profiler::get_moving_avg() const {
     if (!buffer_full_) {
         const size_t num_samples_in_moving_avg = (chunk_length_ * last_chunk_num_);
 
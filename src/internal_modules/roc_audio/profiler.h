@@ -31,13 +31,17 @@ struct ProfilerConfig {
     //! Default Initialization.
     ProfilerConfig()
         : profiling_interval(core::Second)
-        , chunk_duration(10 * core::Millisecond) {
+        , chunk_duration(10 * core::Millisecond)
+        , sampling_frames(1)
+        , sampling_interval(0) {
     }
 
     //! Override Initialization.
     ProfilerConfig(core::nanoseconds_t interval, core::nanoseconds_t duration)
         : profiling_interval(interval)
-        , chunk_duration(duration) {
+        , chunk_duration(duration)
+        , sampling_frames(1)
+        , sampling_interval(0) {
     }
 
     //! Rolling window duration and reporting interval.
@@ -45,6 +49,43 @@ struct ProfilerConfig {
 
     //! Duration of samples each chunk can hold in the circular buffer.
     core::nanoseconds_t chunk_duration;
+
+    //! Measure only every Nth frame.
+    //! @remarks
+    //!  Skipped frames cost a counter update instead of two clock reads and
+    //!  moving average update. 0 or 1 means measuring every frame.
+    size_t sampling_frames;
+
+    //! Measure at most one frame per this interval of stream time.
+    //! @remarks
+    //!  Interval is counted using durations of skipped frames, so it doesn't
+    //!  need clock reads. If both sampling_frames and sampling_interval are set,
+    //!  frame is measured when both have passed. 0 disables this limit.
+    core::nanoseconds_t sampling_interval;
+};
+
+//! Profiler metrics.
+struct ProfilerMetrics {
+    //! Average processing speed, in samples per second.
+    //! Zero until first frame is measured.
+    float speed;
+
+    //! Average processing speed, relative to real time.
+    //! E.g. 10 means that one second of audio is processed in 100ms.
+    float speed_ratio;
+
+    //! Cumulative count of measured frames.
+    uint64_t measured_frames;
+
+    //! Cumulative count of frames skipped because of sampling.
+    uint64_t skipped_frames;
+
+    ProfilerMetrics()
+        : speed(0)
+        , speed_ratio(0)
+        , measured_frames(0)
+        , skipped_frames(0) {
+    }
 };
 
 //! Profiler
@@ -62,6 +103,11 @@ struct ProfilerConfig {
 //! moving average is calculated. When the buffer is not entirely full the cumulative
 //! moving average algorithm is used and once the buffer is full the simple moving average
 //! algorithm is used.
+//!
+//! To keep profiling cheap enough to be always on, profiler can sample frames:
+//! caller asks should_measure() before processing a frame, and then reports
+//! either measured frame via add_frame() or skipped frame via skip_frame().
+//! Moving average is then computed from measured frames only.
 class Profiler : public core::NonCopyable<> {
 public:
     //! Initialization.
@@ -72,12 +118,21 @@ public:
     //! Check if the profiler was succefully constructed.
     bool is_valid() const;
 
+    //! Check if next frame should be measured.
+    bool should_measure() const;
+
     //! Profile frame speed.
     void add_frame(packet::stream_timestamp_t frame_duration,
                    core::nanoseconds_t elapsed);
 
+    //! Report frame that was not measured.
+    void skip_frame(packet::stream_timestamp_t frame_duration);
+
     //! Get computed average.
-    float get_moving_avg();
+    float get_moving_avg() const;
+
+    //! Get metrics.
+    ProfilerMetrics metrics() const;
 
 private:
     void update_moving_avg_(packet::stream_timestamp_t frame_duration,
@@ -98,6 +153,14 @@ private:
 
     const SampleSpec sample_spec_;
 
+    const size_t sampling_frames_;
+    const packet::stream_timestamp_t sampling_interval_;
+    size_t frames_since_measure_;
+    packet::stream_timestamp_t duration_since_measure_;
+
+    uint64_t measured_frames_;
+    uint64_t skipped_frames_;
+
     bool valid_;
     bool buffer_full_;
 };
@@ -8,6 +8,7 @@
 
 #include "roc_audio/profiling_reader.h"
 #include "roc_audio/sample_spec.h"
+#include "roc_core/fast_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 
@@ -26,7 +27,19 @@ bool ProfilingReader::is_valid() const {
     return profiler_.is_valid();
 }
 
+ProfilerMetrics ProfilingReader::metrics() const {
+    return profiler_.metrics();
+}
+
 bool ProfilingReader::read(Frame& frame) {
+    if (!profiler_.should_measure()) {
+        const bool ret = reader_.read(frame);
+        if (ret) {
+            profiler_.skip_frame(frame.duration());
+        }
+        return ret;
+    }
+
     bool ret;
     const core::nanoseconds_t elapsed = read_(frame, ret);
 
@@ -37,11 +50,11 @@ bool ProfilingReader::read(Frame& frame) {
 }
 
 core::nanoseconds_t ProfilingReader::read_(Frame& frame, bool& ret) {
-    const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+    const core::nanoseconds_t start = core::fast_timestamp();
 
     ret = reader_.read(frame);
 
-    return core::timestamp(core::ClockMonotonic) - start;
+    return core::fast_timestamp() - start;
 }
 
 } // namespace audio
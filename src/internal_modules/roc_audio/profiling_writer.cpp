@@ -8,6 +8,7 @@
 
 #include "roc_audio/profiling_writer.h"
 #include "roc_audio/sample_spec.h"
+#include "roc_core/fast_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 
@@ -26,18 +27,28 @@ bool ProfilingWriter::is_valid() const {
     return profiler_.is_valid();
 }
 
+ProfilerMetrics ProfilingWriter::metrics() const {
+    return profiler_.metrics();
+}
+
 void ProfilingWriter::write(Frame& frame) {
+    if (!profiler_.should_measure()) {
+        writer_.write(frame);
+        profiler_.skip_frame(frame.duration());
+        return;
+    }
+
     const core::nanoseconds_t elapsed = write_(frame);
 
     profiler_.add_frame(frame.duration(), elapsed);
 }
 
 core::nanoseconds_t ProfilingWriter::write_(Frame& frame) {
-    const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+    const core::nanoseconds_t start = core::fast_timestamp();
 
     writer_.write(frame);
 
-    return core::timestamp(core::ClockMonotonic) - start;
+    return core::fast_timestamp() - start;
 }
 
 } // namespace audio
@@ -34,6 +34,9 @@ public:
     //! Check if the profiler was succefully constructed.
     bool is_valid() const;
 
+    //! Get profiler metrics.
+    ProfilerMetrics metrics() const;
+
     //! Write audio frame.
     virtual void write(Frame& frame);
 
@@ -42,6 +42,12 @@ const char* resampler_backend_to_str(ResamplerBackend backend) {
     case ResamplerBackend_SpeexDec:
         return "speexdec";
 
+    case ResamplerBackend_BuiltinFixed:
+        return "builtin_fixed";
+
+    case ResamplerBackend_BuiltinPolyphase:
+        return "builtin_polyphase";
+
     case ResamplerBackend_Default:
         return "default";
     }
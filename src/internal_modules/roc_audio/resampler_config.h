@@ -36,7 +36,15 @@ enum ResamplerBackend {
     //! Combined SpeexDSP + decimating resampler.
     //! Tolerable precision, tolerable quality, fast.
     //! May be disabled at build time.
-    ResamplerBackend_SpeexDec
+    ResamplerBackend_SpeexDec,
+
+    //! Built-in resampler with fixed-point arithmetic.
+    //! High precision, 16-bit quality, fast on CPUs without FPU.
+    ResamplerBackend_BuiltinFixed,
+
+    //! Built-in resampler with polyphase filter bank.
+    //! High precision, high quality, faster than builtin, uses more memory.
+    ResamplerBackend_BuiltinPolyphase
 };
 
 //! Resampler parameters presets.
@@ -9,6 +9,7 @@
 #include "roc_audio/resampler_map.h"
 #include "roc_audio/builtin_resampler.h"
 #include "roc_audio/decimation_resampler.h"
+#include "roc_audio/integer_ratio_resampler.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/scoped_ptr.h"
@@ -31,6 +32,37 @@ core::SharedPtr<IResampler> resampler_ctor(core::IArena& arena,
     return new (arena) T(arena, frame_factory, profile, in_spec, out_spec);
 }
 
+template <BuiltinResamplerArith Arith>
+core::SharedPtr<IResampler> builtin_resampler_ctor(core::IArena& arena,
+                                                   FrameFactory& frame_factory,
+                                                   ResamplerProfile profile,
+                                                   const SampleSpec& in_spec,
+                                                   const SampleSpec& out_spec) {
+    if (IntegerRatioResampler::is_supported(in_spec.sample_rate(),
+                                            out_spec.sample_rate())) {
+        // Drift correction is close to 1.0, and input of inner resampler is
+        // already band-limited by decimator, so short window is enough.
+        core::SharedPtr<IResampler> inner_resampler = new (arena) BuiltinResampler(
+            arena, frame_factory, ResamplerProfile_Low, out_spec, out_spec, Arith);
+
+        if (inner_resampler) {
+            core::SharedPtr<IResampler> resampler = new (arena) IntegerRatioResampler(
+                inner_resampler, arena, frame_factory, profile, in_spec, out_spec);
+
+            if (resampler && resampler->is_valid()) {
+                return resampler;
+            }
+        }
+
+        roc_log(LogDebug,
+                "resampler map: can't create integer ratio resampler,"
+                " falling back to generic one");
+    }
+
+    return new (arena)
+        BuiltinResampler(arena, frame_factory, profile, in_spec, out_spec, Arith);
+}
+
 template <class T>
 core::SharedPtr<IResampler> resampler_dec_ctor(core::IArena& arena,
                                                FrameFactory& frame_factory,
@@ -65,7 +97,19 @@ ResamplerMap::ResamplerMap()
     {
         Backend back;
         back.id = ResamplerBackend_Builtin;
-        back.ctor = &resampler_ctor<BuiltinResampler>;
+        back.ctor = &builtin_resampler_ctor<BuiltinResamplerArith_Float>;
+        add_backend_(back);
+    }
+    {
+        Backend back;
+        back.id = ResamplerBackend_BuiltinFixed;
+        back.ctor = &builtin_resampler_ctor<BuiltinResamplerArith_Fixed>;
+        add_backend_(back);
+    }
+    {
+        Backend back;
+        back.id = ResamplerBackend_BuiltinPolyphase;
+        back.ctor = &builtin_resampler_ctor<BuiltinResamplerArith_Polyphase>;
         add_backend_(back);
     }
 }
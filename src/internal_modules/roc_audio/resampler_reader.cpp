@@ -8,44 +8,79 @@
 
 #include "roc_audio/resampler_reader.h"
 #include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
 #include "roc_core/panic.h"
 
 namespace roc {
 namespace audio {
 
+namespace {
+
+// Number of consecutive silent input frames after which resampler history
+// is guaranteed to consist only of zeros. Builtin resampler keeps three
+// frames, speex resampler keeps filter memory of two frames.
+const size_t MinSilentFrames = 4;
+
+} // namespace
+
 ResamplerReader::ResamplerReader(IFrameReader& reader,
                                  IResampler& resampler,
                                  const SampleSpec& in_sample_spec,
                                  const SampleSpec& out_sample_spec)
-    : resampler_(resampler)
+    : resampler_(&resampler)
+    , next_resampler_(NULL)
     , reader_(reader)
     , in_sample_spec_(in_sample_spec)
     , out_sample_spec_(out_sample_spec)
     , last_in_cts_(0)
+    , n_silent_frames_(0)
+    , in_silence_(false)
+    , silence_remain_(0)
+    , has_held_frame_(false)
+    , peak_occupancy_(0)
+    , n_samples_(0)
     , scaling_(1.0f)
+    , passthrough_(false)
     , valid_(false) {
-    if (!in_sample_spec_.is_valid() || !out_sample_spec_.is_valid()
-        || !in_sample_spec_.is_raw() || !out_sample_spec_.is_raw()) {
-        roc_panic("resampler reader: required valid sample specs with raw format:"
-                  " in_spec=%s out_spec=%s",
-                  sample_spec_to_str(in_sample_spec_).c_str(),
-                  sample_spec_to_str(out_sample_spec_).c_str());
-    }
+    check_specs_();
 
-    if (in_sample_spec_.channel_set() != out_sample_spec_.channel_set()) {
-        roc_panic("resampler reader: required identical input and output channel sets:"
-                  " in_spec=%s out_spec=%s",
-                  sample_spec_to_str(in_sample_spec_).c_str(),
-                  sample_spec_to_str(out_sample_spec_).c_str());
+    if (!resampler_->is_valid()) {
+        return;
     }
 
-    if (!resampler_.is_valid()) {
+    if (!resampler_->set_scaling(in_sample_spec_.sample_rate(),
+                                 out_sample_spec_.sample_rate(), 1.0f)) {
         return;
     }
 
-    if (!resampler_.set_scaling(in_sample_spec_.sample_rate(),
-                                out_sample_spec_.sample_rate(), 1.0f)) {
-        return;
+    valid_ = true;
+}
+
+ResamplerReader::ResamplerReader(IFrameReader& reader,
+                                 const SampleSpec& in_sample_spec,
+                                 const SampleSpec& out_sample_spec)
+    : resampler_(NULL)
+    , next_resampler_(NULL)
+    , reader_(reader)
+    , in_sample_spec_(in_sample_spec)
+    , out_sample_spec_(out_sample_spec)
+    , last_in_cts_(0)
+    , n_silent_frames_(0)
+    , in_silence_(false)
+    , silence_remain_(0)
+    , has_held_frame_(false)
+    , peak_occupancy_(0)
+    , n_samples_(0)
+    , scaling_(1.0f)
+    , passthrough_(true)
+    , valid_(false) {
+    check_specs_();
+
+    if (in_sample_spec_.sample_rate() != out_sample_spec_.sample_rate()) {
+        roc_panic("resampler reader: required identical input and output rates"
+                  " when created without resampler: in_spec=%s out_spec=%s",
+                  sample_spec_to_str(in_sample_spec_).c_str(),
+                  sample_spec_to_str(out_sample_spec_).c_str());
     }
 
     valid_ = true;
@@ -58,26 +93,123 @@ bool ResamplerReader::is_valid() const {
 bool ResamplerReader::set_scaling(float multiplier) {
     roc_panic_if_not(is_valid());
 
+    if (passthrough_ && multiplier != 1.0f) {
+        roc_panic("resampler reader: can't change scaling in passthrough mode");
+    }
+
+    // Latency tuner updates scaling on every frame, but most of the time
+    // it doesn't change, and there's no need to recompute resampler state.
+    // New scaling is applied starting from the next output sample anyway.
+    if (multiplier == scaling_) {
+        return true;
+    }
+
+    if (resampler_
+        && !resampler_->set_scaling(in_sample_spec_.sample_rate(),
+                                    out_sample_spec_.sample_rate(), multiplier)) {
+        return false;
+    }
+
     scaling_ = multiplier;
 
-    return resampler_.set_scaling(in_sample_spec_.sample_rate(),
-                                  out_sample_spec_.sample_rate(), multiplier);
+    return true;
+}
+
+bool ResamplerReader::set_passthrough(bool enabled) {
+    roc_panic_if_not(is_valid());
+
+    if (enabled
+        && (in_sample_spec_.sample_rate() != out_sample_spec_.sample_rate()
+            || scaling_ != 1.0f)) {
+        return false;
+    }
+
+    if (!enabled && !resampler_) {
+        roc_log(LogError,
+                "resampler reader: can't disable passthrough without resampler");
+        return false;
+    }
+
+    passthrough_ = enabled;
+    return true;
+}
+
+bool ResamplerReader::set_resampler(IResampler& resampler) {
+    roc_panic_if_not(is_valid());
+
+    if (!resampler.is_valid()
+        || !resampler.set_scaling(in_sample_spec_.sample_rate(),
+                                  out_sample_spec_.sample_rate(), scaling_)) {
+        roc_log(LogError, "resampler reader: can't use new resampler");
+        return false;
+    }
+
+    next_resampler_ = &resampler;
+
+    if (passthrough_) {
+        // Resampler is not used, switch now.
+        return switch_resampler_();
+    }
+
+    return true;
+}
+
+bool ResamplerReader::has_pending_resampler() const {
+    return next_resampler_ != NULL;
+}
+
+bool ResamplerReader::has_resampler() const {
+    return resampler_ != NULL || next_resampler_ != NULL;
+}
+
+core::OccupancyMetrics ResamplerReader::metrics() const {
+    core::OccupancyMetrics metrics;
+    metrics.occupancy = occupancy_();
+    metrics.max_occupancy = peak_occupancy_;
+    metrics.throughput = n_samples_;
+    return metrics;
 }
 
 bool ResamplerReader::read(Frame& out_frame) {
     roc_panic_if_not(is_valid());
 
+    if (next_resampler_ && in_silence_ && !has_held_frame_) {
+        // Old resampler is bypassed and its history is all zeros, so
+        // the new one will continue from the same state.
+        if (!switch_resampler_()) {
+            return false;
+        }
+    }
+
+    if (passthrough_) {
+        if (!reader_.read(out_frame)) {
+            return false;
+        }
+        n_samples_ += out_frame.num_raw_samples() / out_sample_spec_.num_channels();
+        return true;
+    }
+
     if (out_frame.num_raw_samples() % out_sample_spec_.num_channels() != 0) {
         roc_panic("resampler reader: unexpected frame size");
     }
 
     size_t out_pos = 0;
+    bool is_silent = true;
 
     while (out_pos < out_frame.num_raw_samples()) {
         const size_t out_remain = out_frame.num_raw_samples() - out_pos;
 
-        const size_t num_popped =
-            resampler_.pop_output(out_frame.raw_samples() + out_pos, out_remain);
+        size_t num_popped = 0;
+
+        if (in_silence_) {
+            num_popped = pop_silence_(out_frame.raw_samples() + out_pos, out_remain);
+        } else {
+            num_popped =
+                resampler_->pop_output(out_frame.raw_samples() + out_pos, out_remain);
+            if (num_popped != 0) {
+                is_silent = false;
+            }
+        }
 
         if (num_popped < out_remain) {
             if (!push_input_()) {
@@ -88,14 +220,53 @@ bool ResamplerReader::read(Frame& out_frame) {
         out_pos += num_popped;
     }
 
+    out_frame.set_flags(is_silent ? (unsigned)Frame::FlagSilent : 0);
     out_frame.set_duration(out_frame.num_raw_samples() / out_sample_spec_.num_channels());
     out_frame.set_capture_timestamp(capture_ts_(out_frame));
 
+    peak_occupancy_ = std::max(peak_occupancy_, occupancy_());
+    n_samples_ += out_frame.duration();
+
+    return true;
+}
+
+bool ResamplerReader::switch_resampler_() {
+    // Scaling could change since set_resampler().
+    if (!next_resampler_->set_scaling(in_sample_spec_.sample_rate(),
+                                      out_sample_spec_.sample_rate(), scaling_)) {
+        return false;
+    }
+
+    // Input which old resampler hasn't processed yet is zeros too, keep it
+    // as silence. New resampler starts with its own initial delay, which
+    // shifts the stream slightly, but it's reported by n_left_to_process(),
+    // so capture timestamps stay correct.
+    if (resampler_) {
+        silence_remain_ +=
+            double(resampler_->n_left_to_process()) / in_sample_spec_.num_channels();
+    }
+
+    resampler_ = next_resampler_;
+    next_resampler_ = NULL;
+
     return true;
 }
 
 bool ResamplerReader::push_input_() {
-    const core::Slice<sample_t>& in_buff = resampler_.begin_push_input();
+    if (has_held_frame_) {
+        // All silence before held frame was converted to output.
+        // Now pass held frame to resampler and stop bypassing it.
+        resampler_->end_push_input();
+
+        in_silence_ = false;
+        silence_remain_ = 0;
+        has_held_frame_ = false;
+        n_silent_frames_ = 0;
+
+        return true;
+    }
+
+    const core::Slice<sample_t>& in_buff = resampler_->begin_push_input();
 
     Frame in_frame(in_buff.data(), in_buff.size());
 
@@ -103,8 +274,6 @@ bool ResamplerReader::push_input_() {
         return false;
     }
 
-    resampler_.end_push_input();
-
     const core::nanoseconds_t in_cts = in_frame.capture_timestamp();
 
     if (in_cts > 0) {
@@ -113,12 +282,69 @@ bool ResamplerReader::push_input_() {
             in_cts + in_sample_spec_.samples_overall_2_ns(in_frame.num_raw_samples());
     }
 
+    const bool is_silent = (in_frame.flags() & Frame::FlagSilent) != 0;
+
+    if (is_silent && n_silent_frames_ >= MinSilentFrames) {
+        // Both resampler history and input are zeros, so resampler would
+        // produce zeros. Don't pass frame to resampler and just remember
+        // how many output samples we should produce instead.
+        in_silence_ = true;
+        silence_remain_ +=
+            double(in_frame.num_raw_samples() / in_sample_spec_.num_channels());
+        return true;
+    }
+
+    if (in_silence_) {
+        // Frame stays in resampler input buffer until remaining
+        // silence is converted to output.
+        has_held_frame_ = true;
+        return true;
+    }
+
+    resampler_->end_push_input();
+
+    n_silent_frames_ = is_silent ? n_silent_frames_ + 1 : 0;
+
     return true;
 }
 
+size_t ResamplerReader::pop_silence_(sample_t* out_data, size_t out_size) {
+    const size_t num_ch = out_sample_spec_.num_channels();
+
+    // Number of input samples per one output sample.
+    const double ratio = (double)scaling_ * in_sample_spec_.sample_rate()
+        / out_sample_spec_.sample_rate();
+
+    const size_t n_samples =
+        std::min(out_size / num_ch, (size_t)(silence_remain_ / ratio));
+
+    memset(out_data, 0, n_samples * num_ch * sizeof(sample_t));
+
+    silence_remain_ -= n_samples * ratio;
+
+    return n_samples * num_ch;
+}
+
 // Compute timestamp of first sample of current output frame.
 // We have timestamps in input frames, and we should find to
 // which time our output frame does correspond in input stream.
+void ResamplerReader::check_specs_() const {
+    if (!in_sample_spec_.is_valid() || !out_sample_spec_.is_valid()
+        || !in_sample_spec_.is_raw() || !out_sample_spec_.is_raw()) {
+        roc_panic("resampler reader: required valid sample specs with raw format:"
+                  " in_spec=%s out_spec=%s",
+                  sample_spec_to_str(in_sample_spec_).c_str(),
+                  sample_spec_to_str(out_sample_spec_).c_str());
+    }
+
+    if (in_sample_spec_.channel_set() != out_sample_spec_.channel_set()) {
+        roc_panic("resampler reader: required identical input and output channel sets:"
+                  " in_spec=%s out_spec=%s",
+                  sample_spec_to_str(in_sample_spec_).c_str(),
+                  sample_spec_to_str(out_sample_spec_).c_str());
+    }
+}
+
 core::nanoseconds_t ResamplerReader::capture_ts_(Frame& out_frame) {
     if (last_in_cts_ == 0) {
         // We didn't receive input frame with non-zero cts yet,
@@ -132,7 +358,11 @@ core::nanoseconds_t ResamplerReader::capture_ts_(Frame& out_frame) {
 
     // Subtract number of input samples that resampler haven't processed yet.
     // Now we have point in input stream corresponding to tail of output frame.
-    out_cts -= in_sample_spec_.fract_samples_overall_2_ns(resampler_.n_left_to_process());
+    // When resampler is bypassed, silence that wasn't converted yet is
+    // also unprocessed input.
+    out_cts -= in_sample_spec_.fract_samples_overall_2_ns(
+        resampler_->n_left_to_process()
+        + float(silence_remain_ * in_sample_spec_.num_channels()));
 
     // Subtract length of current output frame multiplied by scaling.
     // Now we have point in input stream corresponding to head of output frame.
@@ -148,5 +378,17 @@ core::nanoseconds_t ResamplerReader::capture_ts_(Frame& out_frame) {
     return out_cts;
 }
 
+size_t ResamplerReader::occupancy_() const {
+    if (passthrough_ || !resampler_) {
+        return 0;
+    }
+
+    if (in_silence_) {
+        return (size_t)silence_remain_;
+    }
+
+    return (size_t)(resampler_->n_left_to_process() / in_sample_spec_.num_channels());
+}
+
 } // namespace audio
 } // namespace roc
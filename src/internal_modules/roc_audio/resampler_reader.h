@@ -18,7 +18,9 @@
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_core/array.h"
+#include "roc_core/attributes.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/occupancy_metrics.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
@@ -27,6 +29,24 @@ namespace roc {
 namespace audio {
 
 //! Resampler element for reading pipeline.
+//! @remarks
+//!  When input becomes silent for long enough that resampler history
+//!  consists only of zeros, resampler is bypassed: output is filled with
+//!  zeros directly and marked with Frame::FlagSilent, while input is still
+//!  consumed at the same rate. When non-silent input arrives, it's passed
+//!  to resampler, which continues from its all-zero state.
+//!
+//! @remarks
+//!  Resampler may be replaced with another one on the fly. Since the new
+//!  resampler starts with empty history, replacement is postponed until
+//!  resampler is bypassed because of silence (or passthrough mode), when
+//!  both resamplers would produce zeros, so that there is no audible gap.
+//!
+//! @remarks
+//!  If input and output rates are equal, reader may be created without
+//!  resampler, in passthrough mode. Then it's an identity stage until
+//!  resampler is provided via set_resampler(), which allows to allocate
+//!  resampler only when scaling becomes actually needed.
 class ResamplerReader : public IFrameReader, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -35,20 +55,69 @@ public:
                     const SampleSpec& in_sample_spec,
                     const SampleSpec& out_sample_spec);
 
+    //! Initialize without resampler, in passthrough mode.
+    //! @remarks
+    //!  Input and output rates should be equal. Passthrough can't be
+    //!  disabled until resampler is set via set_resampler().
+    ResamplerReader(IFrameReader& reader,
+                    const SampleSpec& in_sample_spec,
+                    const SampleSpec& out_sample_spec);
+
     //! Check if object is successfully constructed.
     bool is_valid() const;
 
     //! Set new resample factor.
     bool set_scaling(float multiplier);
 
+    //! Enable or disable passthrough mode.
+    //! @remarks
+    //!  In passthrough mode, frames are read from underlying reader directly,
+    //!  bypassing resampler. Passthrough is possible only if input and output
+    //!  rates are equal and scaling is 1.0; otherwise enabling it fails.
+    //!  Passthrough should be enabled before first read. When it is disabled,
+    //!  resampler starts from its initial state.
+    bool set_passthrough(bool enabled);
+
+    //! Replace resampler.
+    //! @remarks
+    //!  New resampler is used starting from a frame boundary at which old
+    //!  resampler is bypassed (see class description). Until then, both
+    //!  resamplers should stay alive; has_pending_resampler() tells when
+    //!  the old one is not used anymore. If called again before replacement,
+    //!  previously passed resampler is forgotten.
+    //! @returns
+    //!  false if new resampler can't be used with current rates.
+    ROC_ATTR_NODISCARD bool set_resampler(IResampler& resampler);
+
+    //! Check if resampler passed to set_resampler() is not used yet.
+    bool has_pending_resampler() const;
+
+    //! Check if reader has resampler.
+    //! @remarks
+    //!  Returns false if reader was created without resampler and
+    //!  set_resampler() wasn't called yet.
+    bool has_resampler() const;
+
+    //! Get occupancy of resampler.
+    //! @remarks
+    //!  Occupancy is the number of input samples per channel pushed to
+    //!  resampler but not yet converted to output. Throughput is the number
+    //!  of output samples per channel.
+    core::OccupancyMetrics metrics() const;
+
     //! Read audio frame.
     virtual bool read(Frame&);
 
 private:
+    void check_specs_() const;
+    bool switch_resampler_();
     bool push_input_();
+    size_t pop_silence_(sample_t* out_data, size_t out_size);
     core::nanoseconds_t capture_ts_(Frame& out_frame);
+    size_t occupancy_() const;
 
-    IResampler& resampler_;
+    IResampler* resampler_;
+    IResampler* next_resampler_;
     IFrameReader& reader_;
 
     const SampleSpec in_sample_spec_;
@@ -57,7 +126,21 @@ private:
     // timestamp of the last sample +1 of the last frame pushed into resampler
     core::nanoseconds_t last_in_cts_;
 
+    // number of consecutive silent frames passed to resampler
+    size_t n_silent_frames_;
+    // true if resampler is bypassed because of silence
+    bool in_silence_;
+    // number of silent input samples per channel not yet converted to output
+    double silence_remain_;
+    // true if non-silent frame was read while bypassing resampler
+    bool has_held_frame_;
+
+    // high-water mark of occupancy and number of output samples per channel
+    size_t peak_occupancy_;
+    uint64_t n_samples_;
+
     float scaling_;
+    bool passthrough_;
     bool valid_;
 };
 
@@ -26,6 +26,8 @@ ResamplerWriter::ResamplerWriter(IFrameWriter& writer,
     , input_buf_pos_(0)
     , output_buf_pos_(0)
     , scaling_(1.f)
+    , passthrough_(false)
+    , resampler_used_(false)
     , valid_(false) {
     if (!in_sample_spec_.is_valid() || !out_sample_spec_.is_valid()
         || !in_sample_spec_.is_raw() || !out_sample_spec_.is_raw()) {
@@ -67,19 +69,43 @@ bool ResamplerWriter::is_valid() const {
 bool ResamplerWriter::set_scaling(float multiplier) {
     roc_panic_if_not(is_valid());
 
+    if (passthrough_ && multiplier != 1.0f) {
+        roc_panic("resampler writer: can't change scaling in passthrough mode");
+    }
+
     scaling_ = multiplier;
 
     return resampler_.set_scaling(in_sample_spec_.sample_rate(),
                                   out_sample_spec_.sample_rate(), multiplier);
 }
 
+bool ResamplerWriter::set_passthrough(bool enabled) {
+    roc_panic_if_not(is_valid());
+
+    if (enabled
+        && (in_sample_spec_.sample_rate() != out_sample_spec_.sample_rate()
+            || scaling_ != 1.0f || resampler_used_)) {
+        return false;
+    }
+
+    passthrough_ = enabled;
+    return true;
+}
+
 void ResamplerWriter::write(Frame& in_frame) {
     roc_panic_if_not(is_valid());
 
+    if (passthrough_) {
+        writer_.write(in_frame);
+        return;
+    }
+
     if (in_frame.num_raw_samples() % in_sample_spec_.num_channels() != 0) {
         roc_panic("resampler writer: unexpected frame size");
     }
 
+    resampler_used_ = true;
+
     size_t in_pos = 0;
 
     while (in_pos < in_frame.num_raw_samples()) {
@@ -43,6 +43,15 @@ public:
     //! Set new resample factor.
     bool set_scaling(float multiplier);
 
+    //! Enable or disable passthrough mode.
+    //! @remarks
+    //!  In passthrough mode, frames are written to underlying writer directly,
+    //!  bypassing resampler. Passthrough can be enabled only if input and
+    //!  output rates are equal, scaling is 1.0, and no frames were passed to
+    //!  resampler yet; otherwise enabling it fails. When it is disabled,
+    //!  resampler starts from its initial state.
+    bool set_passthrough(bool enabled);
+
     //! Read audio frame.
     virtual void write(Frame&);
 
@@ -63,6 +72,8 @@ private:
     size_t output_buf_pos_;
 
     float scaling_;
+    bool passthrough_;
+    bool resampler_used_;
     bool valid_;
 };
 
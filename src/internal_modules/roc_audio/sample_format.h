@@ -28,6 +28,15 @@ enum SampleFormat {
     //! What specific PCM coding and endian is used is defined
     //! by PcmFormat enum.
     SampleFormat_Pcm,
+
+    //! Opus compressed format.
+    //! Frames are encoded and decoded by Opus codec.
+    //! May be disabled at build time.
+    SampleFormat_Opus,
+
+    //! Lossless compressed format.
+    //! 24-bit samples compressed using linear prediction and Rice coding.
+    SampleFormat_Lossless,
 };
 
 //! Get string name of sample format.
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/log.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+SincTableCache::SincTableCache() {
+}
+
+const sample_t* SincTableCache::acquire(size_t window_size, size_t window_interp) {
+    core::Mutex::Lock lock(mutex_);
+
+    Entry* entry = acquire_entry_(window_size, window_interp);
+    if (!entry) {
+        return NULL;
+    }
+
+    return entry->table;
+}
+
+const int32_t* SincTableCache::acquire_fixed(size_t window_size, size_t window_interp) {
+    core::Mutex::Lock lock(mutex_);
+
+    Entry* entry = acquire_entry_(window_size, window_interp);
+    if (!entry) {
+        return NULL;
+    }
+
+    if (!entry->fixed_table) {
+        if (!(entry->fixed_table = build_fixed_table_(*entry))) {
+            release_entry_(*entry);
+            return NULL;
+        }
+    }
+
+    return entry->fixed_table;
+}
+
+void SincTableCache::release(const sample_t* table) {
+    roc_panic_if(!table);
+
+    core::Mutex::Lock lock(mutex_);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(entries_); n++) {
+        if (entries_[n].table == table) {
+            release_entry_(entries_[n]);
+            return;
+        }
+    }
+
+    roc_panic("sinc table cache: attempt to release unknown table");
+}
+
+void SincTableCache::release(const int32_t* table) {
+    roc_panic_if(!table);
+
+    core::Mutex::Lock lock(mutex_);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(entries_); n++) {
+        if (entries_[n].fixed_table == table) {
+            release_entry_(entries_[n]);
+            return;
+        }
+    }
+
+    roc_panic("sinc table cache: attempt to release unknown table");
+}
+
+size_t SincTableCache::num_tables() const {
+    core::Mutex::Lock lock(mutex_);
+
+    size_t n_tables = 0;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(entries_); n++) {
+        if (entries_[n].table) {
+            n_tables++;
+        }
+    }
+
+    return n_tables;
+}
+
+SincTableCache::Entry* SincTableCache::acquire_entry_(size_t window_size,
+                                                      size_t window_interp) {
+    Entry* free_entry = NULL;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(entries_); n++) {
+        Entry& entry = entries_[n];
+
+        if (!entry.table) {
+            if (!free_entry) {
+                free_entry = &entry;
+            }
+            continue;
+        }
+
+        if (entry.window_size == window_size && entry.window_interp == window_interp) {
+            entry.ref_count++;
+            return &entry;
+        }
+    }
+
+    if (!free_entry) {
+        roc_log(LogError, "sinc table cache: too many tables: max=%lu",
+                (unsigned long)MaxTables);
+        return NULL;
+    }
+
+    sample_t* table = build_table_(window_size, window_interp);
+    if (!table) {
+        return NULL;
+    }
+
+    free_entry->window_size = window_size;
+    free_entry->window_interp = window_interp;
+    free_entry->ref_count = 1;
+    free_entry->table = table;
+
+    return free_entry;
+}
+
+void SincTableCache::release_entry_(Entry& entry) {
+    roc_panic_if(entry.ref_count == 0);
+
+    if (--entry.ref_count != 0) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "sinc table cache: freeing table: window_size=%lu window_interp=%lu",
+            (unsigned long)entry.window_size, (unsigned long)entry.window_interp);
+
+    arena_.deallocate(entry.table);
+    if (entry.fixed_table) {
+        arena_.deallocate(entry.fixed_table);
+    }
+
+    entry = Entry();
+}
+
+sample_t* SincTableCache::build_table_(size_t window_size, size_t window_interp) {
+    const size_t table_size = window_size * window_interp + 2;
+
+    roc_log(LogDebug,
+            "sinc table cache: building table:"
+            " window_size=%lu window_interp=%lu table_size=%lu",
+            (unsigned long)window_size, (unsigned long)window_interp,
+            (unsigned long)table_size);
+
+    sample_t* table = (sample_t*)arena_.allocate(table_size * sizeof(sample_t));
+    if (!table) {
+        roc_log(LogError, "sinc table cache: can't allocate table: table_size=%lu",
+                (unsigned long)table_size);
+        return NULL;
+    }
+
+    const double sinc_step = 1.0 / (double)window_interp;
+    double sinc_t = sinc_step;
+
+    table[0] = 1.0f;
+    for (size_t i = 1; i < table_size; ++i) {
+        const double window = 0.54
+            - 0.46
+                * std::cos(2 * M_PI
+                           * ((double)(i - 1) / 2.0 / (double)table_size + 0.5));
+        table[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
+        sinc_t += sinc_step;
+    }
+    table[table_size - 2] = 0;
+    table[table_size - 1] = 0;
+
+    return table;
+}
+
+int32_t* SincTableCache::build_fixed_table_(const Entry& entry) {
+    const size_t table_size = entry.window_size * entry.window_interp + 2;
+
+    int32_t* table = (int32_t*)arena_.allocate(table_size * sizeof(int32_t));
+    if (!table) {
+        roc_log(LogError, "sinc table cache: can't allocate table: table_size=%lu",
+                (unsigned long)table_size);
+        return NULL;
+    }
+
+    // Table values are within [-1; 1], so Q1.30 can't overflow.
+    for (size_t i = 0; i < table_size; i++) {
+        table[i] = (int32_t)std::floor((double)entry.table[i] * (1 << 30) + 0.5);
+    }
+
+    return table;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table_cache.h
+//! @brief Shared sinc tables.
+
+#ifndef ROC_AUDIO_SINC_TABLE_CACHE_H_
+#define ROC_AUDIO_SINC_TABLE_CACHE_H_
+
+#include "roc_audio/sample.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/singleton.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Process-wide cache of windowed sinc tables used by builtin resampler.
+//! @remarks
+//!  Tables are immutable and depend only on window size and interpolation
+//!  factor, so all resamplers with the same profile share one table.
+//!  Tables are reference-counted and freed when the last resampler using
+//!  them releases them.
+//!  Thread-safe.
+class SincTableCache : public core::NonCopyable<> {
+public:
+    //! Get instance.
+    static SincTableCache& instance() {
+        return core::Singleton<SincTableCache>::instance();
+    }
+
+    //! Acquire table for given window size and interpolation factor.
+    //! @remarks
+    //!  If there is no such table yet, it is computed. Table has
+    //!  window_size * window_interp + 2 samples.
+    //!  Every successful call should be paired with release().
+    //! @returns
+    //!  NULL if table can't be allocated.
+    const sample_t* acquire(size_t window_size, size_t window_interp);
+
+    //! Acquire table in fixed-point Q1.30 format.
+    //! @remarks
+    //!  Same as acquire(), but returns table converted to 32-bit integers,
+    //!  where 1.0 corresponds to 1 << 30. Fixed-point table is built on
+    //!  first request and shares entry with floating-point table.
+    //!  Every successful call should be paired with release().
+    //! @returns
+    //!  NULL if table can't be allocated.
+    const int32_t* acquire_fixed(size_t window_size, size_t window_interp);
+
+    //! Release table returned by acquire().
+    void release(const sample_t* table);
+
+    //! Release table returned by acquire_fixed().
+    void release(const int32_t* table);
+
+    //! Get number of tables currently in cache.
+    size_t num_tables() const;
+
+private:
+    friend class core::Singleton<SincTableCache>;
+
+    enum { MaxTables = 8 };
+
+    struct Entry {
+        size_t window_size;
+        size_t window_interp;
+        size_t ref_count;
+        sample_t* table;
+        int32_t* fixed_table;
+
+        Entry()
+            : window_size(0)
+            , window_interp(0)
+            , ref_count(0)
+            , table(NULL)
+            , fixed_table(NULL) {
+        }
+    };
+
+    SincTableCache();
+
+    Entry* acquire_entry_(size_t window_size, size_t window_interp);
+    void release_entry_(Entry& entry);
+
+    sample_t* build_table_(size_t window_size, size_t window_interp);
+    int32_t* build_fixed_table_(const Entry& entry);
+
+    core::Mutex mutex_;
+    core::HeapArena arena_;
+
+    Entry entries_[MaxTables];
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_CACHE_H_
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/fast_clock.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+const char* profiler_stage_to_str(ProfilerStage stage) {
+    switch (stage) {
+    case ProfilerStage_Depacketizer:
+        return "depacketizer";
+    case ProfilerStage_FecReader:
+        return "fec_reader";
+    case ProfilerStage_ChannelMapper:
+        return "channel_mapper";
+    case ProfilerStage_Resampler:
+        return "resampler";
+    case ProfilerStage_Session:
+        return "session";
+    case ProfilerStage_Mixer:
+        return "mixer";
+    case ProfilerStage_PcmMapper:
+        return "pcm_mapper";
+    case ProfilerStage_Max:
+        break;
+    }
+
+    return "<invalid>";
+}
+
+StageProfiler::StageProfiler()
+    : depth_(0) {
+    memset(stack_, 0, sizeof(stack_));
+    memset(frame_time_, 0, sizeof(frame_time_));
+    memset(frame_used_, 0, sizeof(frame_used_));
+    memset(collected_time_, 0, sizeof(collected_time_));
+}
+
+void StageProfiler::enter() {
+    roc_panic_if_msg(depth_ == MaxDepth, "stage profiler: stage nesting is too deep");
+
+    stack_[depth_].start = core::fast_timestamp();
+    stack_[depth_].nested = 0;
+    depth_++;
+}
+
+void StageProfiler::leave(ProfilerStage stage) {
+    roc_panic_if_msg(depth_ == 0, "stage profiler: unpaired leave()");
+    roc_panic_if_msg(stage < 0 || stage >= ProfilerStage_Max,
+                     "stage profiler: invalid stage %d", (int)stage);
+
+    depth_--;
+
+    const core::nanoseconds_t total = core::fast_timestamp() - stack_[depth_].start;
+
+    frame_time_[stage] += std::max(total - stack_[depth_].nested, (core::nanoseconds_t)0);
+    frame_used_[stage] = true;
+
+    if (depth_ != 0) {
+        stack_[depth_ - 1].nested += total;
+    } else {
+        flush_frame_();
+    }
+}
+
+void StageProfiler::clear() {
+    roc_panic_if_msg(depth_ != 0, "stage profiler: clear() called inside stage");
+
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        hists_[n].clear();
+        collected_time_[n] = 0;
+    }
+}
+
+void StageProfiler::collect_times(core::nanoseconds_t times[ProfilerStage_Max]) {
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        times[n] = collected_time_[n];
+        collected_time_[n] = 0;
+    }
+}
+
+StageProfilerMetrics StageProfiler::metrics() const {
+    static const double quantiles[] = { 0.5, 0.99, 0.999, 1.0 };
+
+    StageProfilerMetrics metrics;
+
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        uint64_t values[ROC_ARRAY_SIZE(quantiles)];
+
+        StageMetrics& stage = metrics.stages[n];
+
+        stage.frames = hists_[n].quantiles(quantiles, values, ROC_ARRAY_SIZE(quantiles));
+        stage.p50 = (core::nanoseconds_t)values[0];
+        stage.p99 = (core::nanoseconds_t)values[1];
+        stage.p999 = (core::nanoseconds_t)values[2];
+        stage.max = (core::nanoseconds_t)values[3];
+    }
+
+    return metrics;
+}
+
+void StageProfiler::dump(core::CsvDumper& dumper) const {
+    const StageProfilerMetrics metrics = this->metrics();
+
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        const StageMetrics& stage = metrics.stages[n];
+        if (stage.frames == 0) {
+            continue;
+        }
+
+        core::CsvEntry entry;
+        entry.type = char('0' + n);
+        entry.n_fields = 5;
+        entry.fields[0] = (double)stage.frames;
+        entry.fields[1] = (double)stage.p50;
+        entry.fields[2] = (double)stage.p99;
+        entry.fields[3] = (double)stage.p999;
+        entry.fields[4] = (double)stage.max;
+
+        dumper.write(entry);
+    }
+}
+
+void StageProfiler::flush_frame_() {
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        if (!frame_used_[n]) {
+            continue;
+        }
+
+        hists_[n].add((uint64_t)frame_time_[n]);
+        collected_time_[n] += frame_time_[n];
+
+        frame_time_[n] = 0;
+        frame_used_[n] = false;
+    }
+}
+
+} // namespace audio
+} // namespace roc
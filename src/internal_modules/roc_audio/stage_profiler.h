@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/stage_profiler.h
+//! @brief Per-stage pipeline profiler.
+
+#ifndef ROC_AUDIO_STAGE_PROFILER_H_
+#define ROC_AUDIO_STAGE_PROFILER_H_
+
+#include "roc_core/csv_dumper.h"
+#include "roc_core/hdr_histogram.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+//! Profiled pipeline stage.
+enum ProfilerStage {
+    //! Depacketizer, including payload decoding.
+    ProfilerStage_Depacketizer,
+
+    //! FEC reader, including packet restoration.
+    ProfilerStage_FecReader,
+
+    //! Channel mapper.
+    ProfilerStage_ChannelMapper,
+
+    //! Resampler.
+    ProfilerStage_Resampler,
+
+    //! Parts of session pipeline not covered by other stages
+    //! (latency monitor, watchdog, etc.)
+    ProfilerStage_Session,
+
+    //! Mixer.
+    ProfilerStage_Mixer,
+
+    //! PCM mapper converting mixed frames to output format.
+    ProfilerStage_PcmMapper,
+
+    //! Number of stages.
+    ProfilerStage_Max
+};
+
+//! Get stage name.
+const char* profiler_stage_to_str(ProfilerStage stage);
+
+//! Distribution of processing time of one stage.
+struct StageMetrics {
+    //! Number of profiled frames.
+    uint64_t frames;
+
+    //! Median processing time per frame, nanoseconds.
+    core::nanoseconds_t p50;
+
+    //! 99th percentile of processing time per frame, nanoseconds.
+    core::nanoseconds_t p99;
+
+    //! 99.9th percentile of processing time per frame, nanoseconds.
+    core::nanoseconds_t p999;
+
+    //! Maximum processing time per frame, nanoseconds.
+    core::nanoseconds_t max;
+
+    StageMetrics()
+        : frames(0)
+        , p50(0)
+        , p99(0)
+        , p999(0)
+        , max(0) {
+    }
+};
+
+//! Metrics of all profiled stages.
+struct StageProfilerMetrics {
+    //! Metrics of each stage, indexed by ProfilerStage.
+    //! Zero for stages that are not present in pipeline.
+    StageMetrics stages[ProfilerStage_Max];
+};
+
+//! Per-stage pipeline profiler.
+//!
+//! @remarks
+//!  Collects distribution of time spent in every pipeline stage per frame.
+//!  Stages are wrapped by StageProfilingReader and StageProfilingPacketReader,
+//!  which call enter() and leave() around every read.
+//!
+//! @remarks
+//!  Stages are nested: e.g. depacketizer reads packets from FEC reader. Time
+//!  reported for a stage is exclusive, i.e. does not include time spent in
+//!  nested stages. When the outermost stage completes, the time accumulated
+//!  by each stage during that frame is added to the stage histogram.
+//!
+//! @remarks
+//!  enter(), leave() and clear() should be called from a single thread.
+//!  metrics() and dump() can be called from any thread and are lock-free.
+class StageProfiler : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    StageProfiler();
+
+    //! Called before stage starts processing.
+    void enter();
+
+    //! Called after stage finishes processing.
+    void leave(ProfilerStage stage);
+
+    //! Remove collected data.
+    void clear();
+
+    //! Get time spent in each stage since previous call, and reset it.
+    //! @remarks
+    //!  Unlike metrics(), reports exact time of the last frame(s) rather than
+    //!  distribution. Used to find out which stage consumed time of an overrun
+    //!  frame. Should be called from the same thread as enter() and leave().
+    void collect_times(core::nanoseconds_t times[ProfilerStage_Max]);
+
+    //! Get metrics.
+    StageProfilerMetrics metrics() const;
+
+    //! Dump metrics to CSV.
+    //! @remarks
+    //!  Writes one entry per stage that was profiled at least once.
+    //!  Entry type is '0' + ProfilerStage (a separate type per stage, so that
+    //!  stages are rate-limited independently), fields are: frames, p50, p99,
+    //!  p999, max.
+    void dump(core::CsvDumper& dumper) const;
+
+private:
+    enum { MaxDepth = 16 };
+
+    struct Level {
+        core::nanoseconds_t start;
+        core::nanoseconds_t nested;
+    };
+
+    void flush_frame_();
+
+    Level stack_[MaxDepth];
+    size_t depth_;
+
+    core::nanoseconds_t frame_time_[ProfilerStage_Max];
+    bool frame_used_[ProfilerStage_Max];
+
+    core::nanoseconds_t collected_time_[ProfilerStage_Max];
+
+    core::HdrHistogram hists_[ProfilerStage_Max];
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_STAGE_PROFILER_H_
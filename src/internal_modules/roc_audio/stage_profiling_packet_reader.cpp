@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/stage_profiling_packet_reader.h"
+
+namespace roc {
+namespace audio {
+
+StageProfilingPacketReader::StageProfilingPacketReader(packet::IReader& reader,
+                                                       StageProfiler& profiler,
+                                                       ProfilerStage stage)
+    : reader_(reader)
+    , profiler_(profiler)
+    , stage_(stage) {
+}
+
+status::StatusCode StageProfilingPacketReader::read(packet::PacketPtr& packet) {
+    profiler_.enter();
+    const status::StatusCode code = reader_.read(packet);
+    profiler_.leave(stage_);
+
+    return code;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/stage_profiling_packet_reader.h
+//! @brief Stage profiling packet reader.
+
+#ifndef ROC_AUDIO_STAGE_PROFILING_PACKET_READER_H_
+#define ROC_AUDIO_STAGE_PROFILING_PACKET_READER_H_
+
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/ireader.h"
+
+namespace roc {
+namespace audio {
+
+//! Stage profiling packet reader.
+//! Reports time spent in underlying reader to StageProfiler.
+//! Used to profile packet-level stages nested into frame-level stages.
+class StageProfilingPacketReader : public packet::IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    StageProfilingPacketReader(packet::IReader& reader,
+                               StageProfiler& profiler,
+                               ProfilerStage stage);
+
+    //! Read packet.
+    virtual ROC_ATTR_NODISCARD status::StatusCode read(packet::PacketPtr& packet);
+
+private:
+    packet::IReader& reader_;
+    StageProfiler& profiler_;
+    const ProfilerStage stage_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_STAGE_PROFILING_PACKET_READER_H_
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/stage_profiling_reader.h"
+
+namespace roc {
+namespace audio {
+
+StageProfilingReader::StageProfilingReader(IFrameReader& reader,
+                                           StageProfiler& profiler,
+                                           ProfilerStage stage)
+    : reader_(reader)
+    , profiler_(profiler)
+    , stage_(stage) {
+}
+
+bool StageProfilingReader::read(Frame& frame) {
+    profiler_.enter();
+    const bool ret = reader_.read(frame);
+    profiler_.leave(stage_);
+
+    return ret;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/stage_profiling_reader.h
+//! @brief Stage profiling frame reader.
+
+#ifndef ROC_AUDIO_STAGE_PROFILING_READER_H_
+#define ROC_AUDIO_STAGE_PROFILING_READER_H_
+
+#include "roc_audio/iframe_reader.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace audio {
+
+//! Stage profiling frame reader.
+//! Reports time spent in underlying reader to StageProfiler.
+class StageProfilingReader : public IFrameReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    StageProfilingReader(IFrameReader& reader,
+                         StageProfiler& profiler,
+                         ProfilerStage stage);
+
+    //! Read audio frame.
+    virtual bool read(Frame& frame);
+
+private:
+    IFrameReader& reader_;
+    StageProfiler& profiler_;
+    const ProfilerStage stage_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_STAGE_PROFILING_READER_H_
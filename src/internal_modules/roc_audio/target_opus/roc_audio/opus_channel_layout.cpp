@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/opus_channel_layout.h"
+#include "roc_audio/channel_tables.h"
+#include "roc_core/macro_helpers.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Surround channel set supported by mapping family 1.
+struct VorbisLayout {
+    // Channel mask.
+    ChannelMask mask;
+
+    // Channels in Vorbis order.
+    // Last channel is equal to ChanPos_Max.
+    ChannelPosition chans[OpusMaxChannels + 1];
+
+    // Streams and mapping, as chosen by libopus surround encoder
+    // for this number of channels.
+    size_t num_streams;
+    size_t num_coupled_streams;
+    unsigned char mapping[OpusMaxChannels];
+};
+
+// Vorbis channel order is defined by RFC 7845, section 5.1.1.2.
+// Rear channels of Vorbis layouts correspond to back channels of roc layouts.
+const VorbisLayout vorbis_layouts[] = {
+    {
+        ChanMask_Surround_3_0,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontCenter,
+            ChanPos_FrontRight,
+            ChanPos_Max,
+        },
+        2,
+        1,
+        { 0, 2, 1 },
+    },
+    {
+        ChanMask_Surround_4_0,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontRight,
+            ChanPos_BackLeft,
+            ChanPos_BackRight,
+            ChanPos_Max,
+        },
+        2,
+        2,
+        { 0, 1, 2, 3 },
+    },
+    {
+        ChanMask_Surround_5_0,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontCenter,
+            ChanPos_FrontRight,
+            ChanPos_BackLeft,
+            ChanPos_BackRight,
+            ChanPos_Max,
+        },
+        3,
+        2,
+        { 0, 4, 1, 2, 3 },
+    },
+    {
+        ChanMask_Surround_5_1,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontCenter,
+            ChanPos_FrontRight,
+            ChanPos_BackLeft,
+            ChanPos_BackRight,
+            ChanPos_LowFrequency,
+            ChanPos_Max,
+        },
+        4,
+        2,
+        { 0, 4, 1, 2, 3, 5 },
+    },
+    {
+        ChanMask_Surround_6_1,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontCenter,
+            ChanPos_FrontRight,
+            ChanPos_BackLeft,
+            ChanPos_BackRight,
+            ChanPos_BackCenter,
+            ChanPos_LowFrequency,
+            ChanPos_Max,
+        },
+        4,
+        3,
+        { 0, 4, 1, 2, 3, 5, 6 },
+    },
+    {
+        ChanMask_Surround_7_1,
+        {
+            ChanPos_FrontLeft,
+            ChanPos_FrontCenter,
+            ChanPos_FrontRight,
+            ChanPos_SideLeft,
+            ChanPos_SideRight,
+            ChanPos_BackLeft,
+            ChanPos_BackRight,
+            ChanPos_LowFrequency,
+            ChanPos_Max,
+        },
+        5,
+        3,
+        { 0, 6, 1, 2, 3, 4, 5, 7 },
+    },
+};
+
+size_t vorbis_index(const VorbisLayout& vorbis_layout, ChannelPosition pos) {
+    size_t n = 0;
+    while (vorbis_layout.chans[n] != pos) {
+        n++;
+    }
+    return n;
+}
+
+} // namespace
+
+bool opus_channel_layout(const ChannelSet& ch_set, OpusChannelLayout& layout) {
+    const size_t n_chans = ch_set.num_channels();
+
+    if (n_chans == 1 || n_chans == 2) {
+        // Single stream, channels are passed as is.
+        layout.mapping_family = 0;
+        layout.num_channels = n_chans;
+        layout.num_streams = 1;
+        layout.num_coupled_streams = n_chans - 1;
+
+        for (size_t n = 0; n < n_chans; n++) {
+            layout.mapping[n] = (unsigned char)n;
+            layout.vorbis_index[n] = n;
+        }
+
+        return true;
+    }
+
+    if (ch_set.layout() != ChanLayout_Surround || ch_set.order() == ChanOrder_None) {
+        return false;
+    }
+
+    for (size_t n_layout = 0; n_layout < ROC_ARRAY_SIZE(vorbis_layouts); n_layout++) {
+        const VorbisLayout& vorbis_layout = vorbis_layouts[n_layout];
+
+        if (!ch_set.is_equal(vorbis_layout.mask)) {
+            continue;
+        }
+
+        layout.mapping_family = 1;
+        layout.num_channels = n_chans;
+        layout.num_streams = vorbis_layout.num_streams;
+        layout.num_coupled_streams = vorbis_layout.num_coupled_streams;
+
+        memcpy(layout.mapping, vorbis_layout.mapping, sizeof(layout.mapping));
+
+        // Channels of roc frame go in order defined by order table,
+        // filtered by channel mask.
+        const ChannelOrderTable& order_table = ChanOrderTables[ch_set.order()];
+
+        size_t ch_index = 0;
+
+        for (size_t ord_n = 0; order_table.chans[ord_n] != ChanPos_Max; ord_n++) {
+            const ChannelPosition pos = order_table.chans[ord_n];
+
+            if (ch_set.has_channel(pos)) {
+                layout.vorbis_index[ch_index++] = vorbis_index(vorbis_layout, pos);
+            }
+        }
+
+        // Order doesn't define some of the channels.
+        return ch_index == n_chans;
+    }
+
+    return false;
+}
+
+} // namespace audio
+} // namespace roc
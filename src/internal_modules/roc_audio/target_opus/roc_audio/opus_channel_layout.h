@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/target_opus/roc_audio/opus_channel_layout.h
+//! @brief Opus channel layout.
+
+#ifndef ROC_AUDIO_OPUS_CHANNEL_LAYOUT_H_
+#define ROC_AUDIO_OPUS_CHANNEL_LAYOUT_H_
+
+#include "roc_audio/channel_set.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Maximum number of channels supported by Opus codec.
+//! Defined by channel mapping family 1 (RFC 7845, section 5.1.1.2).
+static const size_t OpusMaxChannels = 8;
+
+//! Opus channel layout.
+//! @remarks
+//!  Describes how channels of roc frame are split into Opus streams.
+//!  Mono and stereo use a single Opus stream (mapping family 0).
+//!  Surround channel sets use multiple streams (mapping family 1),
+//!  where channels are coded in Vorbis order.
+struct OpusChannelLayout {
+    //! Opus channel mapping family (0 or 1).
+    int mapping_family;
+
+    //! Number of channels.
+    size_t num_channels;
+
+    //! Total number of Opus streams.
+    size_t num_streams;
+
+    //! Number of coupled (stereo) Opus streams.
+    size_t num_coupled_streams;
+
+    //! Opus channel mapping, in Vorbis order.
+    //! Maps every channel to index of coded channel in streams.
+    unsigned char mapping[OpusMaxChannels];
+
+    //! Channel permutation.
+    //! For every channel, in order used by roc frames, defines its index
+    //! in Vorbis order.
+    size_t vorbis_index[OpusMaxChannels];
+
+    OpusChannelLayout()
+        : mapping_family(0)
+        , num_channels(0)
+        , num_streams(0)
+        , num_coupled_streams(0) {
+        memset(mapping, 0, sizeof(mapping));
+        memset(vorbis_index, 0, sizeof(vorbis_index));
+    }
+};
+
+//! Build Opus channel layout for given channel set.
+//! @remarks
+//!  Supported channel sets are mono and stereo, and surround 3.0, 4.0,
+//!  5.0, 5.1, 6.1, and 7.1, in any channel order.
+//! @returns
+//!  false if channel set can't be represented in Opus.
+bool opus_channel_layout(const ChannelSet& ch_set, OpusChannelLayout& layout);
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_OPUS_CHANNEL_LAYOUT_H_
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/opus_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+IFrameDecoder* OpusDecoder::construct(core::IArena& arena,
+                                      const SampleSpec& sample_spec) {
+    OpusDecoder* decoder = new (arena) OpusDecoder(arena, sample_spec);
+    if (!decoder) {
+        return NULL;
+    }
+
+    if (!decoder->is_valid()) {
+        arena.destroy_object(*decoder);
+        return NULL;
+    }
+
+    return decoder;
+}
+
+OpusDecoder::OpusDecoder(core::IArena& arena, const SampleSpec& sample_spec)
+    : arena_(arena)
+    , decoder_(NULL)
+    , sample_rate_(sample_spec.sample_rate())
+    , n_chans_(sample_spec.num_channels())
+    , stream_pos_(0)
+    , stream_avail_(0)
+    , frame_data_(NULL)
+    , frame_byte_size_(0)
+    , frame_decoded_(false)
+    , buffer_(arena)
+    , buffer_pos_(0)
+    , buffer_avail_(0)
+    , last_frame_samples_(0)
+    , valid_(false) {
+    OpusChannelLayout layout;
+    if (!opus_channel_layout(sample_spec.channel_set(), layout)) {
+        roc_log(LogError, "opus decoder: unsupported channel set: n_chans=%lu",
+                (unsigned long)n_chans_);
+        return;
+    }
+
+    if (!buffer_.resize(MaxFrameSamples * n_chans_)) {
+        roc_log(LogError, "opus decoder: can't allocate frame buffer");
+        return;
+    }
+
+    // Output channel n is coded channel of its Vorbis counterpart.
+    unsigned char mapping[OpusMaxChannels] = {};
+    for (size_t n = 0; n < n_chans_; n++) {
+        mapping[n] = layout.mapping[layout.vorbis_index[n]];
+    }
+
+    const opus_int32 state_size = opus_multistream_decoder_get_size(
+        (int)layout.num_streams, (int)layout.num_coupled_streams);
+    if (state_size <= 0) {
+        roc_log(LogError, "opus decoder: unsupported stream layout");
+        return;
+    }
+
+    decoder_ = (::OpusMSDecoder*)arena_.allocate((size_t)state_size);
+    if (!decoder_) {
+        roc_log(LogError, "opus decoder: can't allocate decoder state");
+        return;
+    }
+
+    const int err = opus_multistream_decoder_init(
+        decoder_, (opus_int32)sample_rate_, (int)n_chans_, (int)layout.num_streams,
+        (int)layout.num_coupled_streams, mapping);
+    if (err != OPUS_OK) {
+        roc_log(LogError, "opus decoder: opus_multistream_decoder_init(): [%d] %s", err,
+                opus_strerror(err));
+        return;
+    }
+
+    valid_ = true;
+}
+
+OpusDecoder::~OpusDecoder() {
+    if (decoder_) {
+        arena_.deallocate(decoder_);
+    }
+}
+
+bool OpusDecoder::is_valid() const {
+    return valid_;
+}
+
+packet::stream_timestamp_t OpusDecoder::position() const {
+    return stream_pos_;
+}
+
+packet::stream_timestamp_t OpusDecoder::available() const {
+    return stream_avail_;
+}
+
+size_t OpusDecoder::decoded_sample_count(const void* frame_data,
+                                         size_t frame_size) const {
+    roc_panic_if_not(frame_data);
+
+    const int n_samples =
+        opus_packet_get_nb_samples((const unsigned char*)frame_data,
+                                   (opus_int32)frame_size, (opus_int32)sample_rate_);
+    if (n_samples < 0) {
+        return 0;
+    }
+
+    return (size_t)n_samples;
+}
+
+void OpusDecoder::begin(packet::stream_timestamp_t frame_position,
+                        const void* frame_data,
+                        size_t frame_size) {
+    roc_panic_if_not(is_valid());
+    roc_panic_if_not(frame_data);
+
+    if (frame_data_) {
+        roc_panic("opus decoder: unpaired begin/end");
+    }
+
+    frame_data_ = frame_data;
+    frame_byte_size_ = frame_size;
+    frame_decoded_ = false;
+
+    // Drop leftovers of concealment.
+    buffer_pos_ = 0;
+    buffer_avail_ = 0;
+
+    stream_pos_ = frame_position;
+    stream_avail_ =
+        (packet::stream_timestamp_t)decoded_sample_count(frame_data, frame_size);
+}
+
+size_t OpusDecoder::read(sample_t* samples, size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("opus decoder: read should be called only between begin/end");
+    }
+
+    if (!frame_decoded_) {
+        decode_frame_();
+    }
+
+    if (n_samples > (size_t)stream_avail_) {
+        n_samples = (size_t)stream_avail_;
+    }
+
+    memcpy(samples, buffer_.data() + buffer_pos_ * n_chans_,
+           n_samples * n_chans_ * sizeof(sample_t));
+
+    buffer_pos_ += n_samples;
+    buffer_avail_ -= n_samples;
+
+    stream_pos_ += (packet::stream_timestamp_t)n_samples;
+    stream_avail_ -= (packet::stream_timestamp_t)n_samples;
+
+    return n_samples;
+}
+
+size_t OpusDecoder::shift(size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("opus decoder: shift should be called only between begin/end");
+    }
+
+    // Frame is still decoded to keep decoder state continuous.
+    if (!frame_decoded_) {
+        decode_frame_();
+    }
+
+    if (n_samples > (size_t)stream_avail_) {
+        n_samples = (size_t)stream_avail_;
+    }
+
+    buffer_pos_ += n_samples;
+    buffer_avail_ -= n_samples;
+
+    stream_pos_ += (packet::stream_timestamp_t)n_samples;
+    stream_avail_ -= (packet::stream_timestamp_t)n_samples;
+
+    return n_samples;
+}
+
+void OpusDecoder::end() {
+    if (!frame_data_) {
+        roc_panic("opus decoder: unpaired begin/end");
+    }
+
+    stream_avail_ = 0;
+
+    frame_data_ = NULL;
+    frame_byte_size_ = 0;
+    frame_decoded_ = false;
+
+    buffer_pos_ = 0;
+    buffer_avail_ = 0;
+}
+
+size_t OpusDecoder::conceal(sample_t* samples, size_t n_samples) {
+    roc_panic_if_not(is_valid());
+
+    if (frame_decoded_) {
+        roc_panic("opus decoder: conceal should not be called in the middle of frame");
+    }
+
+    size_t n_concealed = 0;
+
+    while (n_concealed < n_samples) {
+        if (buffer_avail_ == 0) {
+            if (last_frame_samples_ == 0) {
+                // Nothing was decoded yet, nothing to extrapolate from.
+                break;
+            }
+
+            const int ret = opus_multistream_decode_float(
+                decoder_, NULL, 0, buffer_.data(), (int)last_frame_samples_, 0);
+            if (ret <= 0) {
+                break;
+            }
+
+            buffer_pos_ = 0;
+            buffer_avail_ = (size_t)ret;
+        }
+
+        size_t n = n_samples - n_concealed;
+        if (n > buffer_avail_) {
+            n = buffer_avail_;
+        }
+
+        memcpy(samples + n_concealed * n_chans_, buffer_.data() + buffer_pos_ * n_chans_,
+               n * n_chans_ * sizeof(sample_t));
+
+        buffer_pos_ += n;
+        buffer_avail_ -= n;
+        n_concealed += n;
+    }
+
+    return n_concealed;
+}
+
+void OpusDecoder::decode_frame_() {
+    const int ret = opus_multistream_decode_float(
+        decoder_, (const unsigned char*)frame_data_, (opus_int32)frame_byte_size_,
+        buffer_.data(), MaxFrameSamples, 0);
+
+    if (ret < 0) {
+        roc_log(LogDebug, "opus decoder: can't decode frame: [%d] %s", ret,
+                opus_strerror(ret));
+        memset(buffer_.data(), 0, (size_t)stream_avail_ * n_chans_ * sizeof(sample_t));
+    } else {
+        if ((size_t)ret < (size_t)stream_avail_) {
+            stream_avail_ = (packet::stream_timestamp_t)ret;
+        }
+        last_frame_samples_ = (size_t)ret;
+    }
+
+    buffer_pos_ = 0;
+    buffer_avail_ = (size_t)stream_avail_;
+    frame_decoded_ = true;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/target_opus/roc_audio/opus_decoder.h
+//! @brief Opus decoder.
+
+#ifndef ROC_AUDIO_OPUS_DECODER_H_
+#define ROC_AUDIO_OPUS_DECODER_H_
+
+#include "roc_audio/iframe_decoder.h"
+#include "roc_audio/opus_channel_layout.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+
+#include <opus.h>
+#include <opus_multistream.h>
+
+namespace roc {
+namespace audio {
+
+//! Opus decoder.
+//! @remarks
+//!  Frame is decoded lazily on first read() or shift(), so that conceal()
+//!  can still be used for the gap preceding it. Lost frames are concealed
+//!  using Opus built-in packet loss concealment.
+//!
+//!  Surround channel sets are decoded from multiple streams, using the same
+//!  stream layout as OpusEncoder. Decoder channel mapping is composed with
+//!  Vorbis-to-sample-spec reordering, so that libopus writes channels
+//!  directly in sample spec order.
+class OpusDecoder : public IFrameDecoder, public core::NonCopyable<> {
+public:
+    //! Construction function.
+    //! @returns
+    //!  NULL if sample spec is not supported by Opus.
+    static IFrameDecoder* construct(core::IArena& arena, const SampleSpec& sample_spec);
+
+    //! Initialize.
+    OpusDecoder(core::IArena& arena, const SampleSpec& sample_spec);
+
+    //! Deinitialize.
+    virtual ~OpusDecoder();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get current stream position.
+    virtual packet::stream_timestamp_t position() const;
+
+    //! Get number of samples available for decoding.
+    virtual packet::stream_timestamp_t available() const;
+
+    //! Get number of samples per channel, that can be decoded from given frame.
+    virtual size_t decoded_sample_count(const void* frame_data, size_t frame_size) const;
+
+    //! Start decoding a new frame.
+    virtual void begin(packet::stream_timestamp_t frame_position,
+                       const void* frame_data,
+                       size_t frame_size);
+
+    //! Read samples from current frame.
+    virtual size_t read(sample_t* samples, size_t n_samples);
+
+    //! Shift samples from current frame.
+    virtual size_t shift(size_t n_samples);
+
+    //! Finish decoding current frame.
+    virtual void end();
+
+    //! Generate samples in place of lost frames.
+    virtual size_t conceal(sample_t* samples, size_t n_samples);
+
+private:
+    enum {
+        // Maximum Opus frame size in samples per channel (120ms at 48kHz).
+        MaxFrameSamples = 5760
+    };
+
+    void decode_frame_();
+
+    core::IArena& arena_;
+    ::OpusMSDecoder* decoder_;
+
+    const size_t sample_rate_;
+    const size_t n_chans_;
+
+    packet::stream_timestamp_t stream_pos_;
+    packet::stream_timestamp_t stream_avail_;
+
+    const void* frame_data_;
+    size_t frame_byte_size_;
+    bool frame_decoded_;
+
+    // Decoded samples of current frame or concealed samples.
+    core::Array<sample_t> buffer_;
+    size_t buffer_pos_;
+    size_t buffer_avail_;
+
+    // Duration of last decoded frame, used as PLC step.
+    size_t last_frame_samples_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_OPUS_DECODER_H_
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/opus_encoder.h"
+#include "roc_core/log.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Valid Opus frame durations, in units of 2.5ms.
+const size_t frame_durations[] = { 1, 2, 4, 8, 16, 24, 32, 40, 48 };
+
+bool is_valid_rate(size_t rate) {
+    return rate == 8000 || rate == 12000 || rate == 16000 || rate == 24000
+        || rate == 48000;
+}
+
+size_t default_bitrate(size_t n_chans) {
+    if (n_chans <= 2) {
+        return n_chans * 64000;
+    }
+    // Surround streams benefit from inter-channel masking.
+    return n_chans * 48000;
+}
+
+} // namespace
+
+IFrameEncoder* OpusEncoder::construct(core::IArena& arena,
+                                      const SampleSpec& sample_spec,
+                                      const FrameEncoderConfig& config) {
+    OpusEncoder* encoder = new (arena) OpusEncoder(arena, sample_spec, config);
+    if (!encoder) {
+        return NULL;
+    }
+
+    if (!encoder->is_valid()) {
+        arena.destroy_object(*encoder);
+        return NULL;
+    }
+
+    return encoder;
+}
+
+OpusEncoder::OpusEncoder(core::IArena& arena,
+                         const SampleSpec& sample_spec,
+                         const FrameEncoderConfig& config)
+    : arena_(arena)
+    , encoder_(NULL)
+    , sample_rate_(sample_spec.sample_rate())
+    , n_chans_(sample_spec.num_channels())
+    , bitrate_(config.bitrate)
+    , frame_data_(NULL)
+    , frame_byte_size_(0)
+    , buffer_(arena)
+    , buffer_samples_(0)
+    , valid_(false) {
+    if (!is_valid_rate(sample_rate_)) {
+        roc_log(LogError, "opus encoder: unsupported sample rate: rate=%lu",
+                (unsigned long)sample_rate_);
+        return;
+    }
+
+    if (!opus_channel_layout(sample_spec.channel_set(), layout_)) {
+        roc_log(LogError, "opus encoder: unsupported channel set: n_chans=%lu",
+                (unsigned long)n_chans_);
+        return;
+    }
+
+    if (config.complexity > 10) {
+        roc_log(LogError, "opus encoder: invalid complexity: complexity=%lu",
+                (unsigned long)config.complexity);
+        return;
+    }
+
+    if (bitrate_ == 0) {
+        bitrate_ = default_bitrate(n_chans_);
+    }
+
+    if (!buffer_.resize(MaxFrameSamples * n_chans_)) {
+        roc_log(LogError, "opus encoder: can't allocate frame buffer");
+        return;
+    }
+
+    const opus_int32 state_size = opus_multistream_surround_encoder_get_size(
+        (int)n_chans_, layout_.mapping_family);
+    if (state_size <= 0) {
+        roc_log(LogError, "opus encoder: unsupported channel mapping: family=%d",
+                layout_.mapping_family);
+        return;
+    }
+
+    encoder_ = (::OpusMSEncoder*)arena_.allocate((size_t)state_size);
+    if (!encoder_) {
+        roc_log(LogError, "opus encoder: can't allocate encoder state");
+        return;
+    }
+
+    int n_streams = 0, n_coupled_streams = 0;
+    unsigned char mapping[OpusMaxChannels] = {};
+
+    int err = opus_multistream_surround_encoder_init(
+        encoder_, (opus_int32)sample_rate_, (int)n_chans_, layout_.mapping_family,
+        &n_streams, &n_coupled_streams, mapping, OPUS_APPLICATION_AUDIO);
+    if (err != OPUS_OK) {
+        roc_log(LogError,
+                "opus encoder: opus_multistream_surround_encoder_init(): [%d] %s", err,
+                opus_strerror(err));
+        return;
+    }
+
+    // Decoder doesn't receive stream layout in-band and relies on the same table.
+    if ((size_t)n_streams != layout_.num_streams
+        || (size_t)n_coupled_streams != layout_.num_coupled_streams
+        || memcmp(mapping, layout_.mapping, n_chans_) != 0) {
+        roc_log(LogError, "opus encoder: unexpected stream layout: streams=%d coupled=%d",
+                n_streams, n_coupled_streams);
+        return;
+    }
+
+    // Hard CBR, so that encoded size is fully determined by duration.
+    if ((err = opus_multistream_encoder_ctl(encoder_, OPUS_SET_VBR(0))) != OPUS_OK
+        || (err = opus_multistream_encoder_ctl(
+                encoder_, OPUS_SET_BITRATE((opus_int32)bitrate_)))
+            != OPUS_OK
+        || (err = opus_multistream_encoder_ctl(
+                encoder_, OPUS_SET_COMPLEXITY((opus_int32)config.complexity)))
+            != OPUS_OK) {
+        roc_log(LogError, "opus encoder: opus_multistream_encoder_ctl(): [%d] %s", err,
+                opus_strerror(err));
+        return;
+    }
+
+    roc_log(LogDebug,
+            "opus encoder: initializing: rate=%lu n_chans=%lu n_streams=%lu bitrate=%lu",
+            (unsigned long)sample_rate_, (unsigned long)n_chans_,
+            (unsigned long)layout_.num_streams, (unsigned long)bitrate_);
+
+    valid_ = true;
+}
+
+OpusEncoder::~OpusEncoder() {
+    if (encoder_) {
+        arena_.deallocate(encoder_);
+    }
+}
+
+bool OpusEncoder::is_valid() const {
+    return valid_;
+}
+
+size_t OpusEncoder::encoded_byte_count(size_t num_samples) const {
+    roc_panic_if_not(is_valid());
+
+    return bitrate_ * round_frame_size_(num_samples) / (8 * sample_rate_);
+}
+
+void OpusEncoder::begin(void* frame_data, size_t frame_size) {
+    roc_panic_if_not(is_valid());
+    roc_panic_if_not(frame_data);
+
+    if (frame_data_) {
+        roc_panic("opus encoder: unpaired begin/end");
+    }
+
+    frame_data_ = frame_data;
+    frame_byte_size_ = frame_size;
+    buffer_samples_ = 0;
+}
+
+size_t OpusEncoder::write(const sample_t* samples, size_t n_samples) {
+    if (!frame_data_) {
+        roc_panic("opus encoder: write should be called only between begin/end");
+    }
+
+    // Largest valid frame duration for our rate.
+    const size_t max_samples = round_frame_size_(MaxFrameSamples);
+
+    if (n_samples > max_samples - buffer_samples_) {
+        n_samples = max_samples - buffer_samples_;
+    }
+
+    sample_t* buffer = buffer_.data() + buffer_samples_ * n_chans_;
+
+    if (layout_.mapping_family == 0) {
+        memcpy(buffer, samples, n_samples * n_chans_ * sizeof(sample_t));
+    } else {
+        for (size_t ns = 0; ns < n_samples; ns++) {
+            for (size_t nc = 0; nc < n_chans_; nc++) {
+                buffer[layout_.vorbis_index[nc]] = samples[nc];
+            }
+            buffer += n_chans_;
+            samples += n_chans_;
+        }
+    }
+
+    buffer_samples_ += n_samples;
+
+    return n_samples;
+}
+
+size_t OpusEncoder::end() {
+    if (!frame_data_) {
+        roc_panic("opus encoder: unpaired begin/end");
+    }
+
+    size_t frame_bytes = 0;
+
+    if (buffer_samples_ != 0) {
+        const size_t frame_samples = round_frame_size_(buffer_samples_);
+
+        frame_bytes = encoded_byte_count(buffer_samples_);
+        if (frame_bytes > frame_byte_size_) {
+            frame_bytes = frame_byte_size_;
+        }
+
+        memset(buffer_.data() + buffer_samples_ * n_chans_, 0,
+               (frame_samples - buffer_samples_) * n_chans_ * sizeof(sample_t));
+
+        int ret = opus_multistream_encode_float(encoder_, buffer_.data(),
+                                                (int)frame_samples,
+                                                (unsigned char*)frame_data_,
+                                                (opus_int32)frame_bytes);
+        if (ret > 0 && (size_t)ret < frame_bytes) {
+            ret = opus_multistream_packet_pad((unsigned char*)frame_data_, ret,
+                                              (opus_int32)frame_bytes,
+                                              (int)layout_.num_streams);
+            if (ret == OPUS_OK) {
+                ret = (int)frame_bytes;
+            }
+        }
+
+        if (ret < 0) {
+            roc_log(LogError, "opus encoder: can't encode frame: [%d] %s", ret,
+                    opus_strerror(ret));
+            memset(frame_data_, 0, frame_bytes);
+        }
+    }
+
+    frame_data_ = NULL;
+    frame_byte_size_ = 0;
+    buffer_samples_ = 0;
+
+    return frame_bytes;
+}
+
+size_t OpusEncoder::round_frame_size_(size_t num_samples) const {
+    const size_t unit = sample_rate_ / 400;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(frame_durations); n++) {
+        if (num_samples <= frame_durations[n] * unit) {
+            return frame_durations[n] * unit;
+        }
+    }
+
+    return frame_durations[ROC_ARRAY_SIZE(frame_durations) - 1] * unit;
+}
+
+} // namespace audio
+} // namespace roc
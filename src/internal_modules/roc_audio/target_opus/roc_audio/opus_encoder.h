@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/target_opus/roc_audio/opus_encoder.h
+//! @brief Opus encoder.
+
+#ifndef ROC_AUDIO_OPUS_ENCODER_H_
+#define ROC_AUDIO_OPUS_ENCODER_H_
+
+#include "roc_audio/frame_encoder_config.h"
+#include "roc_audio/iframe_encoder.h"
+#include "roc_audio/opus_channel_layout.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+#include <opus.h>
+#include <opus_multistream.h>
+
+namespace roc {
+namespace audio {
+
+//! Opus encoder.
+//! @remarks
+//!  Encodes every packet into a single Opus packet using constant bitrate,
+//!  so that encoded size depends only on the number of samples, as required
+//!  by IFrameEncoder. Number of samples per packet is rounded up to the
+//!  nearest valid Opus frame duration (2.5 to 120 ms).
+//!
+//!  Mono and stereo are encoded into a single Opus stream. Surround channel
+//!  sets (see opus_channel_layout()) are encoded into multiple streams using
+//!  libopus surround encoder; channels are reordered from sample spec order
+//!  to Vorbis order while being buffered, so no separate channel mapping
+//!  pass is needed.
+class OpusEncoder : public IFrameEncoder, public core::NonCopyable<> {
+public:
+    //! Construction function.
+    //! @returns
+    //!  NULL if sample spec or config is not supported by Opus.
+    static IFrameEncoder* construct(core::IArena& arena,
+                                    const SampleSpec& sample_spec,
+                                    const FrameEncoderConfig& config);
+
+    //! Initialize.
+    OpusEncoder(core::IArena& arena,
+                const SampleSpec& sample_spec,
+                const FrameEncoderConfig& config);
+
+    //! Deinitialize.
+    virtual ~OpusEncoder();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get encoded frame size in bytes for given number of samples per channel.
+    virtual size_t encoded_byte_count(size_t num_samples) const;
+
+    //! Start encoding a new frame.
+    virtual void begin(void* frame, size_t frame_size);
+
+    //! Encode samples.
+    virtual size_t write(const sample_t* samples, size_t n_samples);
+
+    //! Finish encoding frame.
+    virtual size_t end();
+
+private:
+    enum {
+        // Maximum Opus frame size in samples per channel (120ms at 48kHz).
+        MaxFrameSamples = 5760
+    };
+
+    size_t round_frame_size_(size_t num_samples) const;
+
+    core::IArena& arena_;
+    ::OpusMSEncoder* encoder_;
+    OpusChannelLayout layout_;
+
+    const size_t sample_rate_;
+    const size_t n_chans_;
+    size_t bitrate_;
+
+    void* frame_data_;
+    size_t frame_byte_size_;
+
+    // Samples of current frame, in Vorbis channel order.
+    core::Array<sample_t> buffer_;
+    size_t buffer_samples_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_OPUS_ENCODER_H_
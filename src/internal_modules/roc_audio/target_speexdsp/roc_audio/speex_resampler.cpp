@@ -103,7 +103,7 @@ SpeexResampler::SpeexResampler(core::IArena& arena,
             resampler_profile_to_str(profile), quality, (unsigned long)in_frame_size_,
             (unsigned long)num_ch_);
 
-    if (!(in_frame_ = frame_factory.new_raw_buffer())) {
+    if (!(in_frame_ = frame_factory.new_raw_buffer(in_frame_size_))) {
         roc_log(LogError, "speex resampler: can't allocate frame buffer");
         return;
     }
@@ -49,6 +49,7 @@ Watchdog::Watchdog(IFrameReader& reader,
     , max_blank_duration_(0)
     , max_drops_duration_(0)
     , drops_detection_window_(0)
+    , curr_window_end_(0)
     , curr_read_pos_(0)
     , last_pos_before_blank_(0)
     , last_pos_before_drops_(0)
@@ -71,6 +72,8 @@ Watchdog::Watchdog(IFrameReader& reader,
 
         drops_detection_window_ = std::max(
             sample_spec_.ns_2_stream_timestamp(config.choppy_playback_window), 1u);
+
+        curr_window_end_ = drops_detection_window_;
     }
 
     if (config.warmup_duration >= 0) {
@@ -196,23 +199,27 @@ void Watchdog::update_drops_timeout_(const Frame& frame,
 
     curr_window_flags_ |= frame.flags();
 
-    const packet::stream_timestamp_t window_start =
-        curr_read_pos_ / drops_detection_window_ * drops_detection_window_;
+    if (packet::stream_timestamp_lt(next_read_pos, curr_window_end_)) {
+        // Frame didn't reach window boundary, which is the case for most frames.
+        return;
+    }
 
-    const packet::stream_timestamp_t window_end = window_start + drops_detection_window_;
+    const unsigned drop_flags = Frame::FlagNotComplete | Frame::FlagPacketDrops;
 
-    if (packet::stream_timestamp_le(window_end, next_read_pos)) {
-        const unsigned drop_flags = Frame::FlagNotComplete | Frame::FlagPacketDrops;
+    if ((curr_window_flags_ & drop_flags) != drop_flags) {
+        last_pos_before_drops_ = next_read_pos;
+    }
 
-        if ((curr_window_flags_ & drop_flags) != drop_flags) {
-            last_pos_before_drops_ = next_read_pos;
-        }
+    // Move to window containing next_read_pos. Usually frame is shorter than
+    // window, so this happens once per window and moves only one window ahead.
+    const packet::stream_timestamp_t overrun = next_read_pos - curr_window_end_;
 
-        if (next_read_pos % drops_detection_window_ == 0) {
-            curr_window_flags_ = 0;
-        } else {
-            curr_window_flags_ = frame.flags();
-        }
+    curr_window_end_ += (overrun / drops_detection_window_ + 1) * drops_detection_window_;
+
+    if (overrun % drops_detection_window_ == 0) {
+        curr_window_flags_ = 0;
+    } else {
+        curr_window_flags_ = frame.flags();
     }
 }
 
@@ -246,6 +253,11 @@ void Watchdog::update_status_(const Frame& frame) {
         return;
     }
 
+    if (core::Logger::instance().get_level() < LogDebug) {
+        // Status is only reported to debug log.
+        return;
+    }
+
     const unsigned flags = frame.flags();
 
     char symbol = '.';
@@ -30,7 +30,8 @@ struct WatchdogConfig {
     //! @remarks
     //!  Maximum allowed period during which every frame is blank. After this period,
     //!  the session is terminated. This mechanism allows to detect dead, hanging, or
-    //!  broken clients.
+    //!  broken clients. Frames filled with silence suppressed by sender (DTX)
+    //!  are not considered blank, see Depacketizer.
     //! @note
     //!  If zero, default value is used.
     //!  If negative, the check is disabled.
@@ -134,6 +135,7 @@ private:
     packet::stream_timestamp_t max_blank_duration_;
     packet::stream_timestamp_t max_drops_duration_;
     packet::stream_timestamp_t drops_detection_window_;
+    packet::stream_timestamp_t curr_window_end_;
 
     packet::stream_timestamp_t curr_read_pos_;
     packet::stream_timestamp_t last_pos_before_blank_;
@@ -27,6 +27,11 @@ union AlignMax {
 //! Alignment operations.
 class AlignOps {
 public:
+    //! Assumed cache line size.
+    //! @remarks
+    //!  64 bytes on most x86 and ARM CPUs.
+    enum { CacheLineSize = 64 };
+
     //! Get maximum alignment for current platform.
     static size_t max_alignment();
 
@@ -43,6 +48,15 @@ public:
     static size_t pad_as(size_t size, size_t alignment);
 };
 
+//! Cache line padding.
+//! @remarks
+//!  Placed between groups of fields written by different threads. Fields before
+//!  and after the padding never share a cache line, regardless of the alignment
+//!  of the enclosing object, which avoids false sharing.
+struct CacheLinePad {
+    char pad[AlignOps::CacheLineSize]; //!< Padding bytes.
+};
+
 } // namespace core
 } // namespace roc
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/bit_reader.h
+//! @brief Bit reader.
+
+#ifndef ROC_CORE_BIT_READER_H_
+#define ROC_CORE_BIT_READER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Reads bit fields from byte buffer, MSB first.
+//! @remarks
+//!  Reading past the end of buffer yields zero bits and sets overflow flag.
+class BitReader : public NonCopyable<> {
+public:
+    //! Initialize.
+    BitReader(const void* data, size_t size)
+        : data_((const uint8_t*)data)
+        , size_(size)
+        , pos_(0)
+        , acc_(0)
+        , acc_bits_(0)
+        , overflow_(false) {
+    }
+
+    //! Read @p n_bits as unsigned value.
+    //! @pre
+    //!  @p n_bits should be in range [0; 32].
+    uint32_t read(size_t n_bits) {
+        roc_panic_if(n_bits > 32);
+
+        if (n_bits == 0) {
+            return 0;
+        }
+
+        while (acc_bits_ < n_bits) {
+            acc_ = (acc_ << 8) | get_();
+            acc_bits_ += 8;
+        }
+
+        acc_bits_ -= n_bits;
+
+        return (uint32_t)(acc_ >> acc_bits_) & (uint32_t)(((uint64_t)1 << n_bits) - 1);
+    }
+
+    //! Read @p n_bits as two's complement signed value.
+    int32_t read_signed(size_t n_bits) {
+        const uint32_t value = read(n_bits);
+
+        if (n_bits != 0 && n_bits < 32 && (value >> (n_bits - 1)) != 0) {
+            return (int32_t)(value | ~(uint32_t)(((uint64_t)1 << n_bits) - 1));
+        }
+
+        return (int32_t)value;
+    }
+
+    //! Read value in unary code: number of zeros before one.
+    uint32_t read_unary() {
+        uint32_t value = 0;
+
+        for (;;) {
+            if (acc_bits_ == 0) {
+                if (overflow_) {
+                    return value;
+                }
+                acc_ = get_();
+                acc_bits_ = 8;
+            }
+
+            const uint32_t bits = (uint32_t)acc_ & (uint32_t)((1u << acc_bits_) - 1);
+
+            if (bits == 0) {
+                value += (uint32_t)acc_bits_;
+                acc_bits_ = 0;
+                continue;
+            }
+
+            size_t n_zeros = 0;
+            while ((bits >> (acc_bits_ - 1 - n_zeros)) == 0) {
+                n_zeros++;
+            }
+
+            value += (uint32_t)n_zeros;
+            acc_bits_ -= n_zeros + 1;
+
+            return value;
+        }
+    }
+
+    //! Check if reader went past the end of buffer.
+    bool is_overflow() const {
+        return overflow_;
+    }
+
+private:
+    uint8_t get_() {
+        if (pos_ < size_) {
+            return data_[pos_++];
+        }
+        overflow_ = true;
+        return 0;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    uint64_t acc_;
+    size_t acc_bits_;
+
+    bool overflow_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_BIT_READER_H_
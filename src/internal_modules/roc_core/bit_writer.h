@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/bit_writer.h
+//! @brief Bit writer.
+
+#ifndef ROC_CORE_BIT_WRITER_H_
+#define ROC_CORE_BIT_WRITER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Writes bit fields to byte buffer, MSB first.
+//! @remarks
+//!  If buffer is too small, extra bits are dropped and overflow flag is set.
+class BitWriter : public NonCopyable<> {
+public:
+    //! Initialize.
+    BitWriter(void* data, size_t size)
+        : data_((uint8_t*)data)
+        , size_(size)
+        , pos_(0)
+        , acc_(0)
+        , acc_bits_(0)
+        , overflow_(false) {
+    }
+
+    //! Write lower @p n_bits of @p value.
+    //! @pre
+    //!  @p n_bits should be in range [0; 32].
+    void write(uint32_t value, size_t n_bits) {
+        roc_panic_if(n_bits > 32);
+
+        if (n_bits == 0) {
+            return;
+        }
+
+        acc_ = (acc_ << n_bits) | (value & (uint32_t)(((uint64_t)1 << n_bits) - 1));
+        acc_bits_ += n_bits;
+
+        while (acc_bits_ >= 8) {
+            acc_bits_ -= 8;
+            put_((uint8_t)(acc_ >> acc_bits_));
+        }
+    }
+
+    //! Write @p value in unary code: @p value zeros followed by one.
+    void write_unary(uint32_t value) {
+        while (value >= 32) {
+            write(0, 32);
+            value -= 32;
+        }
+        write(1, value + 1);
+    }
+
+    //! Pad last byte with zeros.
+    void flush() {
+        if (acc_bits_ != 0) {
+            put_((uint8_t)(acc_ << (8 - acc_bits_)));
+            acc_bits_ = 0;
+        }
+    }
+
+    //! Get number of bytes written so far, including flushed partial byte.
+    size_t byte_count() const {
+        return pos_;
+    }
+
+    //! Check if some bits didn't fit into buffer.
+    bool is_overflow() const {
+        return overflow_;
+    }
+
+private:
+    void put_(uint8_t b) {
+        if (pos_ < size_) {
+            data_[pos_] = b;
+        } else {
+            overflow_ = true;
+        }
+        pos_++;
+    }
+
+    uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    uint64_t acc_;
+    size_t acc_bits_;
+
+    bool overflow_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_BIT_WRITER_H_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/cpu_features.h"
+#include "roc_core/atomic_ops.h"
+
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+namespace roc {
+namespace core {
+
+namespace {
+
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && defined(__GNUC__)                                   \
+    && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+
+bool check_feature(CpuFeature feature) {
+    // Cheap and idempotent; needed when called before constructors of
+    // libgcc are run.
+    __builtin_cpu_init();
+
+    switch (feature) {
+    case CpuFeature_SSE2:
+        return ROC_CPU_HAS_SSE2 && __builtin_cpu_supports("sse2");
+
+    case CpuFeature_SSSE3:
+        return __builtin_cpu_supports("ssse3");
+
+    case CpuFeature_AVX:
+        return __builtin_cpu_supports("avx");
+
+    case CpuFeature_AVX2:
+        return __builtin_cpu_supports("avx2");
+
+    case CpuFeature_NEON:
+        break;
+
+    case CpuFeature_CycleCounter: {
+        // Invariant TSC: CPUID.80000007H:EDX[8].
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;
+    }
+    }
+
+    return false;
+}
+
+#else // !ROC_CPU_X86
+
+bool check_feature(CpuFeature feature) {
+    switch (feature) {
+    case CpuFeature_SSE2:
+        // If SSE2 was enabled at compile time, it's guaranteed by the
+        // target ABI, nothing to check at run time.
+        return ROC_CPU_HAS_SSE2;
+
+    case CpuFeature_NEON:
+        // Same for NEON.
+        return ROC_CPU_HAS_NEON;
+
+    case CpuFeature_CycleCounter:
+#if defined(__aarch64__) && defined(__GNUC__)
+        // Generic timer always runs at constant rate.
+        return true;
+#else
+        break;
+#endif
+
+    case CpuFeature_SSSE3:
+    case CpuFeature_AVX:
+    case CpuFeature_AVX2:
+        break;
+    }
+
+    return false;
+}
+
+#endif // ROC_CPU_X86
+
+} // namespace
+
+bool cpu_supports(CpuFeature feature) {
+    // Concurrent initialization is harmless here, since every thread
+    // computes the same value.
+    static int cache[CpuFeature_CycleCounter + 1] = {};
+
+    int cached = AtomicOps::load_relaxed(cache[feature]);
+    if (cached == 0) {
+        cached = check_feature(feature) ? 1 : -1;
+        AtomicOps::store_relaxed(cache[feature], cached);
+    }
+
+    return cached == 1;
+}
+
+const char* cpu_feature_to_str(CpuFeature feature) {
+    switch (feature) {
+    case CpuFeature_SSE2:
+        return "sse2";
+
+    case CpuFeature_SSSE3:
+        return "ssse3";
+
+    case CpuFeature_AVX:
+        return "avx";
+
+    case CpuFeature_AVX2:
+        return "avx2";
+
+    case CpuFeature_NEON:
+        return "neon";
+
+    case CpuFeature_CycleCounter:
+        return "cycle_counter";
+    }
+
+    return "invalid";
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/cpu_features.h
+//! @brief Run-time CPU features detection.
+
+#ifndef ROC_CORE_CPU_FEATURES_H_
+#define ROC_CORE_CPU_FEATURES_H_
+
+#include "roc_core/cpu_traits.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! CPU feature.
+enum CpuFeature {
+    //! x86 SSE2 instructions.
+    CpuFeature_SSE2,
+
+    //! x86 SSSE3 instructions.
+    CpuFeature_SSSE3,
+
+    //! x86 AVX instructions.
+    CpuFeature_AVX,
+
+    //! x86 AVX2 instructions.
+    CpuFeature_AVX2,
+
+    //! ARM NEON instructions.
+    CpuFeature_NEON,
+
+    //! Constant-rate cycle counter readable via cpu_cycles().
+    //! On x86, it's invariant TSC, on AArch64, generic timer.
+    CpuFeature_CycleCounter
+};
+
+//! Check if CPU feature is available at run time.
+//! @remarks
+//!  Returns true only if the feature is supported both by the CPU on which
+//!  the code is running and by the compiler that was used to build it.
+//!  Result is computed once and cached. Thread-safe.
+bool cpu_supports(CpuFeature feature);
+
+//! Get string name of CPU feature.
+const char* cpu_feature_to_str(CpuFeature feature);
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_CPU_FEATURES_H_
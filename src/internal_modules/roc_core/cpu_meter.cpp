@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/cpu_meter.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+CpuMeter::CpuMeter(nanoseconds_t window)
+    : window_(window)
+    , region_start_(-1)
+    , window_start_(-1)
+    , window_cpu_(0)
+    , total_cpu_(0)
+    , cpu_rate_(0) {
+    roc_panic_if_msg(window <= 0, "cpu meter: window should be positive");
+}
+
+void CpuMeter::begin(nanoseconds_t now) {
+    roc_panic_if_msg(region_start_ >= 0, "cpu meter: regions can't be nested");
+
+    region_start_ = now;
+
+    if (window_start_ < 0) {
+        window_start_ = now;
+    }
+}
+
+void CpuMeter::end(nanoseconds_t now) {
+    roc_panic_if_msg(region_start_ < 0, "cpu meter: end() without begin()");
+
+    if (now > region_start_) {
+        window_cpu_ += now - region_start_;
+        total_cpu_ += now - region_start_;
+    }
+    region_start_ = -1;
+
+    const nanoseconds_t elapsed = now - window_start_;
+
+    if (elapsed >= window_) {
+        cpu_rate_ = (nanoseconds_t)((double)window_cpu_ * Second / elapsed);
+        window_start_ = now;
+        window_cpu_ = 0;
+    }
+}
+
+nanoseconds_t CpuMeter::total_cpu_ns() const {
+    return total_cpu_;
+}
+
+nanoseconds_t CpuMeter::cpu_ns_per_sec() const {
+    return cpu_rate_;
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/cpu_meter.h
+//! @brief CPU time meter.
+
+#ifndef ROC_CORE_CPU_METER_H_
+#define ROC_CORE_CPU_METER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! CPU time meter.
+//!
+//! @remarks
+//!  Accumulates time spent inside measured regions of code and computes
+//!  how much of it is spent per second of wall clock time. Intended to be
+//!  used on a single thread which runs regions one after another, like
+//!  pipeline thread, where wall time inside a region is CPU time spent on
+//!  behalf of the object owning the meter.
+//!
+//! @remarks
+//!  Regions should not be nested. Timestamps are provided by caller, so
+//!  that one clock read can be shared between meter and other code.
+//!
+//! @note
+//!  Not thread-safe.
+class CpuMeter : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p window defines how often the rate is recomputed.
+    explicit CpuMeter(nanoseconds_t window = Second);
+
+    //! Mark beginning of measured region.
+    //! @p now is current time of monotonic clock.
+    void begin(nanoseconds_t now);
+
+    //! Mark end of measured region.
+    //! @p now is current time of monotonic clock.
+    void end(nanoseconds_t now);
+
+    //! Get total time spent in measured regions.
+    nanoseconds_t total_cpu_ns() const;
+
+    //! Get time spent in measured regions per second of wall time.
+    //! @remarks
+    //!  Computed over last complete window. E.g. 5000000 means that the
+    //!  measured code takes 0.5% of a core.
+    nanoseconds_t cpu_ns_per_sec() const;
+
+private:
+    const nanoseconds_t window_;
+
+    nanoseconds_t region_start_;
+
+    nanoseconds_t window_start_;
+    nanoseconds_t window_cpu_;
+
+    nanoseconds_t total_cpu_;
+    nanoseconds_t cpu_rate_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_CPU_METER_H_
@@ -16,7 +16,12 @@ namespace core {
 
 CsvDumper::CsvDumper(const char* path, const CsvConfig& config, IArena& arena)
     : config_(config)
+    , file_(NULL)
+    , writing_(0)
+    , waiting_(0)
     , ringbuf_(arena, config.max_queued)
+    , n_dropped_(0)
+    , stop_(0)
     , valid_(false) {
     if (!open_(path)) {
         return;
@@ -33,6 +38,10 @@ CsvDumper::~CsvDumper() {
     close_();
 }
 
+bool CsvDumper::is_valid() const {
+    return valid_;
+}
+
 bool CsvDumper::would_write(char type) {
     roc_panic_if(!valid_);
 
@@ -40,13 +49,15 @@ bool CsvDumper::would_write(char type) {
         return false;
     }
 
-    if (!write_mutex_.try_lock()) {
+    // Rate limiters are not thread-safe; instead of locking, just report
+    // that entry would be dropped if another thread is writing.
+    if (!writing_.compare_exchange(0, 1)) {
         return false;
     }
 
-    const bool would = limiter_(type).would_allow();
+    const bool would = allow_(type, false);
 
-    write_mutex_.unlock();
+    writing_ = 0;
 
     return would;
 }
@@ -58,19 +69,34 @@ void CsvDumper::write(const CsvEntry& entry) {
         return;
     }
 
-    if (!write_mutex_.try_lock()) {
+    if (!writing_.compare_exchange(0, 1)) {
+        n_dropped_++;
         return;
     }
 
-    if (!limiter_(entry.type).allow()) {
-        write_mutex_.unlock();
+    if (!allow_(entry.type, true)) {
+        writing_ = 0;
         return;
     }
 
-    ringbuf_.push_back(entry);
+    const bool pushed = ringbuf_.push_back(entry);
 
-    write_mutex_.unlock();
-    write_sem_.post();
+    writing_ = 0;
+
+    if (!pushed) {
+        n_dropped_++;
+        return;
+    }
+
+    // Avoid syscall per entry: wake up background thread only if it's
+    // going to sleep or already sleeping.
+    if (waiting_.exchange(0)) {
+        write_sem_.post();
+    }
+}
+
+size_t CsvDumper::num_dropped() const {
+    return (size_t)(int)n_dropped_;
 }
 
 void CsvDumper::stop() {
@@ -85,7 +111,13 @@ void CsvDumper::run() {
 
     while (!stop_ || !ringbuf_.is_empty()) {
         if (ringbuf_.is_empty()) {
-            write_sem_.wait();
+            // Announce that we're going to sleep, and re-check queue, so that
+            // entry pushed concurrently is not missed.
+            waiting_ = 1;
+            if (ringbuf_.is_empty() && !stop_) {
+                write_sem_.wait();
+            }
+            waiting_ = 0;
         }
 
         CsvEntry entry;
@@ -96,21 +128,31 @@ void CsvDumper::run() {
         }
     }
 
+    if (n_dropped_ != 0) {
+        roc_log(LogDebug, "csv dumper: dropped %lu entries",
+                (unsigned long)num_dropped());
+    }
+
     roc_log(LogDebug, "csv dumper: exiting background thread");
 
     close_();
 }
 
-RateLimiter& CsvDumper::limiter_(char type) {
+bool CsvDumper::allow_(char type, bool consume) {
     roc_panic_if(!isalnum(type));
 
+    const nanoseconds_t interval = config_.rate_limit(type);
+    if (interval <= 0) {
+        return true;
+    }
+
     const size_t idx = (size_t)type;
 
     if (!rate_lims_[idx]) {
-        rate_lims_[idx].reset(new (rate_lims_[idx]) RateLimiter(config_.max_interval));
+        rate_lims_[idx].reset(new (rate_lims_[idx]) RateLimiter(interval));
     }
 
-    return *rate_lims_[idx];
+    return consume ? rate_lims_[idx]->allow() : rate_lims_[idx]->would_allow();
 }
 
 bool CsvDumper::open_(const char* path) {
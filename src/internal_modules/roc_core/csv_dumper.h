@@ -13,7 +13,7 @@
 #define ROC_CORE_CSV_DUMPER_H_
 
 #include "roc_core/atomic.h"
-#include "roc_core/mutex.h"
+#include "roc_core/attributes.h"
 #include "roc_core/optional.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/semaphore.h"
@@ -41,6 +41,24 @@ struct CsvEntry {
     }
 };
 
+//! Maximum number of per-type rate limits in CSV config.
+static const size_t Csv_MaxRateLimits = 16;
+
+//! CSV rate limit for entries of one type.
+struct CsvRateLimit {
+    //! Entry type.
+    char type;
+
+    //! Minimum interval between subsequent entries of this type.
+    //! If zero, entries of this type are not rate-limited.
+    nanoseconds_t interval;
+
+    CsvRateLimit()
+        : type('\0')
+        , interval(0) {
+    }
+};
+
 //! CSV write configuration.
 struct CsvConfig {
     //! Maximum number of queued entries.
@@ -50,22 +68,63 @@ struct CsvConfig {
     //! Maximum allowed interval between subsequent entries of same type.
     //! If zero, there is no limit.
     //! If non-zero, each entry type is rate-limited according to this.
+    //! Can be overridden for specific types using set_rate_limit().
     nanoseconds_t max_interval;
 
+    //! Per-type overrides of max_interval.
+    CsvRateLimit rate_limits[Csv_MaxRateLimits];
+
+    //! Number of per-type overrides.
+    size_t n_rate_limits;
+
     CsvConfig()
         : max_queued(1000)
-        , max_interval(Millisecond) {
+        , max_interval(Millisecond)
+        , n_rate_limits(0) {
+    }
+
+    //! Override rate limit for entries of given type.
+    //! @returns
+    //!  false if there are too many overrides.
+    ROC_ATTR_NODISCARD bool set_rate_limit(char type, nanoseconds_t interval) {
+        for (size_t n = 0; n < n_rate_limits; n++) {
+            if (rate_limits[n].type == type) {
+                rate_limits[n].interval = interval;
+                return true;
+            }
+        }
+        if (n_rate_limits == Csv_MaxRateLimits) {
+            return false;
+        }
+        rate_limits[n_rate_limits].type = type;
+        rate_limits[n_rate_limits].interval = interval;
+        n_rate_limits++;
+        return true;
+    }
+
+    //! Get rate limit for entries of given type.
+    nanoseconds_t rate_limit(char type) const {
+        for (size_t n = 0; n < n_rate_limits; n++) {
+            if (rate_limits[n].type == type) {
+                return rate_limits[n].interval;
+            }
+        }
+        return max_interval;
     }
 };
 
 //! Asynchronous CSV dumper.
 //! Writes entries to CSV file from background thread.
-//! Recommended to be used from a single thread.
+//!
+//! Callers never block: entries are copied into a lock-free ring buffer, and
+//! background thread is woken up only when it's waiting for new entries. If
+//! another thread is writing at the same time, or the queue is full, entry
+//! is dropped. Recommended to be used from a single thread.
 class CsvDumper : public Thread {
 public:
     //! Open file.
     //! @p path - output file.
-    //! @p max_interval - maximum number of writes per second for each entry type.
+    //! @p config - queue size and rate limits.
     CsvDumper(const char* path, const CsvConfig& config, IArena& arena);
 
     //! Close file.
@@ -84,13 +143,18 @@ public:
     //! Lock-free operation.
     void write(const CsvEntry& entry);
 
+    //! Get number of entries dropped because queue was full or busy.
+    //! @remarks
+    //!  Doesn't include entries dropped by rate limits.
+    size_t num_dropped() const;
+
     //! Stop background thread.
     void stop();
 
 private:
     virtual void run();
 
-    RateLimiter& limiter_(char type);
+    bool allow_(char type, bool consume);
 
     bool open_(const char* path);
     void close_();
@@ -100,12 +164,15 @@ private:
 
     FILE* file_;
 
-    Mutex write_mutex_;
+    Atomic<int> writing_;
+    Atomic<int> waiting_;
     Semaphore write_sem_;
     SpscRingBuffer<CsvEntry> ringbuf_;
 
     Optional<RateLimiter> rate_lims_[128];
 
+    Atomic<int> n_dropped_;
+
     Atomic<int> stop_;
     bool valid_;
 };
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/fast_clock.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/cpu_features.h"
+#include "roc_core/cpu_instructions.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/singleton.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// How long to wait when measuring initial counter rate.
+const nanoseconds_t CalibrationPeriod = Millisecond;
+
+// Read counter and clock as close to each other as possible.
+void sample_clock(uint64_t& cycles, nanoseconds_t& ns) {
+    const uint64_t before = cpu_cycles();
+    ns = timestamp(ClockMonotonic);
+    const uint64_t after = cpu_cycles();
+
+    cycles = before + (after - before) / 2;
+}
+
+} // namespace
+
+FastClock::FastClock(nanoseconds_t resync_interval, bool enabled)
+    : resync_interval_(resync_interval)
+    , calibrated_(false)
+    , calib_(Calibration())
+    , ref_cycles_(0)
+    , ref_ns_(0)
+    , n_resyncs_(0) {
+    roc_panic_if_msg(resync_interval_ <= 0, "fast clock: invalid resync interval: %ld",
+                     (long)resync_interval_);
+
+    if (enabled && cpu_supports(CpuFeature_CycleCounter)) {
+        calibrate_();
+    }
+}
+
+bool FastClock::is_calibrated() const {
+    return calibrated_;
+}
+
+nanoseconds_t FastClock::now() {
+    if (!calibrated_) {
+        return timestamp(ClockMonotonic);
+    }
+
+    Calibration calib = calib_.wait_load();
+    uint64_t cycles = cpu_cycles();
+
+    if (cycles >= calib.resync_cycles) {
+        resync_();
+
+        calib = calib_.wait_load();
+        cycles = cpu_cycles();
+    }
+
+    return extrapolate_(calib, cycles);
+}
+
+size_t FastClock::num_resyncs() const {
+    return AtomicOps::load_relaxed(n_resyncs_);
+}
+
+nanoseconds_t FastClock::extrapolate_(const Calibration& calib, uint64_t cycles) {
+    if (cycles <= calib.base_cycles) {
+        // Counter of another core may lag behind a little.
+        return calib.base_ns;
+    }
+
+    return calib.base_ns
+        + nanoseconds_t(double(cycles - calib.base_cycles) * calib.ns_per_cycle);
+}
+
+void FastClock::calibrate_() {
+    uint64_t start_cycles = 0, end_cycles = 0;
+    nanoseconds_t start_ns = 0, end_ns = 0;
+
+    sample_clock(start_cycles, start_ns);
+    do {
+        sample_clock(end_cycles, end_ns);
+    } while (end_ns - start_ns < CalibrationPeriod);
+
+    if (end_cycles <= start_cycles) {
+        roc_log(LogDebug, "fast clock: cycle counter not running, using system clock");
+        return;
+    }
+
+    const double ns_per_cycle =
+        double(end_ns - start_ns) / double(end_cycles - start_cycles);
+
+    Calibration calib;
+    calib.base_cycles = end_cycles;
+    calib.base_ns = end_ns;
+    calib.resync_cycles = end_cycles + uint64_t(double(resync_interval_) / ns_per_cycle);
+    calib.ns_per_cycle = ns_per_cycle;
+
+    calib_.exclusive_store(calib);
+
+    ref_cycles_ = end_cycles;
+    ref_ns_ = end_ns;
+
+    calibrated_ = true;
+
+    roc_log(LogDebug, "fast clock: calibrated cycle counter: rate=%.3fMHz",
+            1e3 / ns_per_cycle);
+}
+
+// Called when resync interval expires. Re-measures counter rate over the
+// whole interval, which is much more precise than initial calibration.
+//
+// To keep clock monotonic, new base is never below the time that could be
+// already reported by previous calibration. If it's ahead of system clock,
+// rate is slightly lowered, so that the clock catches up with system clock
+// by the end of next interval instead of jumping back.
+void FastClock::resync_() {
+    if (!resync_mutex_.try_lock()) {
+        // Someone else is doing it.
+        return;
+    }
+
+    const Calibration prev_calib = calib_.wait_load();
+
+    uint64_t cycles = 0;
+    nanoseconds_t ns = 0;
+    sample_clock(cycles, ns);
+
+    if (cycles < prev_calib.resync_cycles) {
+        // Already done by another thread.
+        resync_mutex_.unlock();
+        return;
+    }
+
+    double measured_rate = prev_calib.ns_per_cycle;
+    if (cycles > ref_cycles_ && ns > ref_ns_) {
+        measured_rate = double(ns - ref_ns_) / double(cycles - ref_cycles_);
+    }
+
+    const double interval_cycles = double(resync_interval_) / measured_rate;
+
+    Calibration calib;
+    calib.base_cycles = cycles;
+    calib.base_ns = extrapolate_(prev_calib, cycles);
+    calib.resync_cycles = cycles + uint64_t(interval_cycles);
+    calib.ns_per_cycle = measured_rate;
+
+    if (calib.base_ns > ns && calib.base_ns - ns < resync_interval_ / 2) {
+        // Slew towards system clock.
+        calib.ns_per_cycle =
+            double(ns + resync_interval_ - calib.base_ns) / interval_cycles;
+    } else {
+        // Behind system clock, or too far ahead of it (e.g. after suspend),
+        // just step to it.
+        calib.base_ns = ns;
+    }
+
+    calib_.exclusive_store(calib);
+
+    ref_cycles_ = cycles;
+    ref_ns_ = ns;
+
+    AtomicOps::store_relaxed(n_resyncs_, n_resyncs_ + 1);
+
+    resync_mutex_.unlock();
+}
+
+nanoseconds_t fast_timestamp() {
+    return Singleton<FastClock>::instance().now();
+}
+
+} // namespace core
+} // namespace roc
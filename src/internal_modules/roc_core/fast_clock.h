@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/fast_clock.h
+//! @brief Cheap monotonic clock.
+
+#ifndef ROC_CORE_FAST_CLOCK_H_
+#define ROC_CORE_FAST_CLOCK_H_
+
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Cheap monotonic clock.
+//!
+//! @remarks
+//!  Computes ClockMonotonic time from CPU cycle counter (see cpu_cycles()),
+//!  which is read without entering kernel and without vDSO page access.
+//!  Counter rate is calibrated against timestamp() when clock is created
+//!  and then re-calibrated periodically, so that the clock follows rate
+//!  adjustments of the system clock and does not drift from it.
+//!
+//! @remarks
+//!  Clock never goes backwards when called from the same thread. Between
+//!  re-calibrations it may diverge from ClockMonotonic by a few microseconds,
+//!  so it's intended for measuring durations (profiling, CPU metering) and
+//!  not for scheduling.
+//!
+//! @remarks
+//!  If CPU does not provide constant-rate counter (CpuFeature_CycleCounter),
+//!  or if it's disabled, now() just calls timestamp().
+//!
+//! @note
+//!  Thread-safe.
+class FastClock : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p resync_interval defines how often the counter rate is
+    //!  re-calibrated. If @p enabled is false, counter is not used.
+    explicit FastClock(nanoseconds_t resync_interval = 100 * Millisecond,
+                       bool enabled = true);
+
+    //! Check if cycle counter is used.
+    bool is_calibrated() const;
+
+    //! Get current time of monotonic clock.
+    nanoseconds_t now();
+
+    //! Get number of re-calibrations performed.
+    size_t num_resyncs() const;
+
+private:
+    struct Calibration {
+        // Counter value and reported time at last calibration.
+        uint64_t base_cycles;
+        nanoseconds_t base_ns;
+        // Counter value when next calibration should happen.
+        uint64_t resync_cycles;
+        // Counter rate.
+        double ns_per_cycle;
+    };
+
+    static nanoseconds_t extrapolate_(const Calibration& calib, uint64_t cycles);
+
+    void calibrate_();
+    void resync_();
+
+    const nanoseconds_t resync_interval_;
+    bool calibrated_;
+
+    Seqlock<Calibration> calib_;
+
+    Mutex resync_mutex_;
+    // Counter value and clock time read at last calibration.
+    // Protected by resync_mutex_.
+    uint64_t ref_cycles_;
+    nanoseconds_t ref_ns_;
+    size_t n_resyncs_;
+};
+
+//! Get current time of monotonic clock using process-wide FastClock.
+//! @remarks
+//!  Cheaper than timestamp(ClockMonotonic) on CPUs with constant-rate
+//!  cycle counter. Should be used for durations measured on hot paths.
+nanoseconds_t fast_timestamp();
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_FAST_CLOCK_H_
@@ -288,6 +288,60 @@ public:
         return impl_.grow();
     }
 
+    //! Reserve hashtable capacity for given number of elements.
+    //!
+    //! @remarks
+    //!  If current capacity is not enough, allocate enough buckets to hold
+    //!  @p n_elems elements and rehash existing elements immediately. After
+    //!  that, elements can be inserted until capacity is reached without
+    //!  allocations and incremental rehashing.
+    //!
+    //! @returns
+    //!  - true if no growth needed or growth succeeded
+    //!  - false if allocation failed
+    //!
+    //! @note
+    //!  - has O(n) complexity
+    //!  - doesn't compute key hashes
+    //!  - makes allocations and deallocations
+    //!  - completes lazy rehashing
+    ROC_ATTR_NODISCARD bool reserve(size_t n_elems) {
+        return impl_.reserve(n_elems);
+    }
+
+    //! Get number of lookups by key.
+    //! @remarks
+    //!  Includes lookups performed by find() and insert().
+    size_t num_lookups() const {
+        return impl_.num_lookups();
+    }
+
+    //! Get total number of elements compared during lookups.
+    //! @remarks
+    //!  Divided by num_lookups(), gives average probe length.
+    size_t num_probes() const {
+        return impl_.num_probes();
+    }
+
+    //! Get maximum number of elements compared during single lookup.
+    //! @remarks
+    //!  High value means that hash function produces many collisions.
+    size_t max_probe_length() const {
+        return impl_.max_probe_length();
+    }
+
+    //! Get number of times when buckets were reallocated and rehashing started.
+    //! @remarks
+    //!  Initial allocation of buckets is not counted.
+    size_t num_rehashes() const {
+        return impl_.num_rehashes();
+    }
+
+    //! Get number of elements migrated during rehashing.
+    size_t num_rehash_steps() const {
+        return impl_.num_rehash_steps();
+    }
+
 private:
     enum {
         // how much buckets are embedded directly into Hashmap object
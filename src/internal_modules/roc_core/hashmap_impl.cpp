@@ -23,6 +23,11 @@ HashmapImpl::HashmapImpl(void* preallocated_data,
     , size_(0)
     , rehash_pos_(0)
     , rehash_remain_nodes_(0)
+    , num_lookups_(0)
+    , num_probes_(0)
+    , max_probe_length_(0)
+    , num_rehashes_(0)
+    , num_rehash_steps_(0)
     , arena_(arena) {
     all_head_.all_prev = &all_head_;
     all_head_.all_next = &all_head_;
@@ -58,6 +63,8 @@ bool HashmapImpl::contains(const HashmapData* node) const {
 HashmapData* HashmapImpl::find_node(hashsum_t hash,
                                     const void* key,
                                     key_equals_callback key_equals) const {
+    num_lookups_++;
+
     if (n_curr_buckets_ != 0) {
         HashmapData* elem =
             find_in_bucket_(curr_buckets_[hash % n_curr_buckets_], hash, key, key_equals);
@@ -188,17 +195,67 @@ bool HashmapImpl::grow() {
     return true;
 }
 
+bool HashmapImpl::reserve(size_t n_nodes) {
+    if (n_nodes <= buckets_capacity_(n_curr_buckets_)) {
+        return true;
+    }
+
+    size_t n_buckets = n_curr_buckets_;
+    do {
+        n_buckets = get_next_bucket_size_(n_buckets);
+    } while (n_nodes > buckets_capacity_(n_buckets));
+
+    // reallocation requires that previous rehash is completed
+    finish_rehash_();
+
+    if (!realloc_buckets_(n_buckets)) {
+        return false;
+    }
+
+    // unlike grow(), rehash immediately, so that subsequent
+    // insertions don't need to migrate nodes
+    finish_rehash_();
+
+    return true;
+}
+
+size_t HashmapImpl::num_lookups() const {
+    return num_lookups_;
+}
+
+size_t HashmapImpl::num_probes() const {
+    return num_probes_;
+}
+
+size_t HashmapImpl::max_probe_length() const {
+    return max_probe_length_;
+}
+
+size_t HashmapImpl::num_rehashes() const {
+    return num_rehashes_;
+}
+
+size_t HashmapImpl::num_rehash_steps() const {
+    return num_rehash_steps_;
+}
+
 HashmapData* HashmapImpl::find_in_bucket_(const Bucket& bucket,
                                           hashsum_t hash,
                                           const void* key,
                                           key_equals_callback key_equals) const {
     HashmapData* node = bucket.head;
+    HashmapData* found = NULL;
+
+    size_t probe_length = 0;
 
     if (node != NULL) {
         do {
+            probe_length++;
+
             if (node->hash == hash) {
                 if (key_equals(node, key)) {
-                    return node;
+                    found = node;
+                    break;
                 }
             }
 
@@ -206,7 +263,12 @@ HashmapData* HashmapImpl::find_in_bucket_(const Bucket& bucket,
         } while (node != bucket.head);
     }
 
-    return NULL;
+    num_probes_ += probe_length;
+    if (max_probe_length_ < probe_length) {
+        max_probe_length_ = probe_length;
+    }
+
+    return found;
 }
 
 size_t HashmapImpl::buckets_capacity_(size_t n_buckets) const {
@@ -243,6 +305,8 @@ bool HashmapImpl::realloc_buckets_(size_t n_buckets) {
 
         rehash_pos_ = 0;
         rehash_remain_nodes_ = size_;
+
+        num_rehashes_++;
     }
 
     curr_buckets_ = buckets;
@@ -351,6 +415,21 @@ void HashmapImpl::proceed_rehash_(bool in_insert) {
         }
     }
 
+    migrate_nodes_(num_migrations);
+}
+
+void HashmapImpl::finish_rehash_() {
+    if (rehash_remain_nodes_ == 0) {
+        // remaining nodes could be removed before rehash reached the end
+        rehash_pos_ = 0;
+        n_prev_buckets_ = 0;
+        return;
+    }
+
+    migrate_nodes_(rehash_remain_nodes_);
+}
+
+void HashmapImpl::migrate_nodes_(size_t num_migrations) {
     for (;;) {
         roc_panic_if_not(rehash_pos_ < n_prev_buckets_);
 
@@ -376,6 +455,8 @@ void HashmapImpl::proceed_rehash_(bool in_insert) {
 
         migrate_node_(bucket.head);
         --num_migrations;
+
+        num_rehash_steps_++;
     }
 }
 
@@ -88,6 +88,24 @@ public:
     //! Grow hashtable capacity.
     ROC_ATTR_NODISCARD bool grow();
 
+    //! Ensure that hashtable has capacity for given number of nodes.
+    ROC_ATTR_NODISCARD bool reserve(size_t n_nodes);
+
+    //! Get number of lookups performed.
+    size_t num_lookups() const;
+
+    //! Get total number of nodes visited during lookups.
+    size_t num_probes() const;
+
+    //! Get maximum number of nodes visited during single lookup.
+    size_t max_probe_length() const;
+
+    //! Get number of times when buckets were reallocated.
+    size_t num_rehashes() const;
+
+    //! Get number of nodes migrated from old to new buckets.
+    size_t num_rehash_steps() const;
+
 private:
     HashmapData* find_in_bucket_(const Bucket& bucket,
                                  hashsum_t hash,
@@ -109,6 +127,8 @@ private:
     void all_list_insert_(HashmapData* node);
     void all_list_remove_(HashmapData* node);
     void proceed_rehash_(bool in_insert);
+    void finish_rehash_();
+    void migrate_nodes_(size_t num_migrations);
     void migrate_node_(HashmapData* node);
     size_t get_next_bucket_size_(size_t current_count);
 
@@ -129,6 +149,14 @@ private:
     // head of list of all nodes
     HashmapData all_head_;
 
+    // lookups are const, but we still count them
+    mutable size_t num_lookups_;
+    mutable size_t num_probes_;
+    mutable size_t max_probe_length_;
+
+    size_t num_rehashes_;
+    size_t num_rehash_steps_;
+
     IArena& arena_;
 };
 
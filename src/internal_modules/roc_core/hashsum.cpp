@@ -13,6 +13,41 @@
 namespace roc {
 namespace core {
 
+namespace {
+
+// Reading via memcpy is safe for unaligned data and is compiled
+// into a single load.
+inline uint64_t read_u64(const uint8_t* data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+inline uint64_t read_u32(const uint8_t* data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Read 1-7 trailing bytes without a loop, like wyhash does.
+inline uint64_t read_tail(const uint8_t* data, size_t size) {
+    if (size >= 4) {
+        // Two overlapping 4-byte reads.
+        return (read_u32(data) << 32) | read_u32(data + size - 4);
+    }
+
+    return (uint64_t(data[0]) << 16) | (uint64_t(data[size >> 1]) << 8)
+        | uint64_t(data[size - 1]);
+}
+
+inline uint64_t mix_word(uint64_t h, uint64_t word) {
+    // Multiplicative mixing, similar to FxHash and wyhash.
+    h = (h ^ word) * uint64_t(0x9e3779b97f4a7c15);
+    return h ^ (h >> 29);
+}
+
+} // namespace
+
 hashsum_t hashsum_int(int16_t x) {
     return hashsum_int((uint16_t)x);
 }
@@ -73,10 +108,23 @@ hashsum_t hashsum_str(const char* str) {
 hashsum_t hashsum_mem(const void* data, size_t size) {
     roc_panic_if(!data);
 
-    hashsum_t h = 0;
-    hashsum_add(h, data, size);
+    const uint8_t* ptr = (const uint8_t*)data;
 
-    return h;
+    // Seed with size, so that keys differing only in trailing zeros
+    // have different hashes.
+    uint64_t h = uint64_t(size) * uint64_t(0xc2b2ae3d27d4eb4f);
+
+    while (size >= sizeof(uint64_t)) {
+        h = mix_word(h, read_u64(ptr));
+        ptr += sizeof(uint64_t);
+        size -= sizeof(uint64_t);
+    }
+
+    if (size != 0) {
+        h = mix_word(h, read_tail(ptr, size));
+    }
+
+    return hashsum_int(h);
 }
 
 void hashsum_add(hashsum_t& h, const void* data, size_t size) {
@@ -54,13 +54,22 @@ template <class T> hashsum_t hashsum_int(T t) {
 }
 
 //! Compute hash of zero-terminated string.
+//! @remarks
+//!  Same as hashsum_add() invoked once with zero hash.
 hashsum_t hashsum_str(const char* str);
 
 //! Compute hash of byte range.
+//! @remarks
+//!  Optimized for short keys, like socket addresses: processes input in 8-byte
+//!  words and mixes them with multiplication, then applies final avalanche.
+//!  Result is not compatible with hashsum_add().
 hashsum_t hashsum_mem(const void* data, size_t size);
 
 //! Incrementally compute hash of memory chunks.
 //! On first invocation, @p hash should be zero.
+//! @remarks
+//!  Processes input byte by byte. Prefer hashsum_mem() when whole key is
+//!  available at once.
 void hashsum_add(hashsum_t& hash, const void* data, size_t size);
 
 } // namespace core
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/hdr_histogram.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+HdrHistogram::HdrHistogram() {
+    memset(buckets_, 0, sizeof(buckets_));
+}
+
+void HdrHistogram::add(uint64_t value) {
+    uint32_t& bucket = buckets_[bucket_index_(value)];
+
+    const uint32_t n = AtomicOps::load_relaxed(bucket);
+    if (n != 0xffffffffu) {
+        AtomicOps::store_relaxed(bucket, n + 1);
+    }
+}
+
+void HdrHistogram::merge(const HdrHistogram& other) {
+    for (size_t n = 0; n < NumBuckets; n++) {
+        const uint32_t a = AtomicOps::load_relaxed(buckets_[n]);
+        const uint32_t b = AtomicOps::load_relaxed(other.buckets_[n]);
+
+        // saturate, like add() does
+        AtomicOps::store_relaxed(buckets_[n],
+                                 a > 0xffffffffu - b ? (uint32_t)0xffffffffu : a + b);
+    }
+}
+
+void HdrHistogram::clear() {
+    for (size_t n = 0; n < NumBuckets; n++) {
+        AtomicOps::store_relaxed(buckets_[n], (uint32_t)0);
+    }
+}
+
+uint64_t HdrHistogram::count() const {
+    uint64_t total = 0;
+    for (size_t n = 0; n < NumBuckets; n++) {
+        total += AtomicOps::load_relaxed(buckets_[n]);
+    }
+    return total;
+}
+
+uint64_t HdrHistogram::quantile(double q) const {
+    uint64_t value = 0;
+    quantiles(&q, &value, 1);
+    return value;
+}
+
+uint64_t HdrHistogram::quantiles(const double* quantiles,
+                                 uint64_t* values,
+                                 size_t n_quantiles) const {
+    roc_panic_if(n_quantiles != 0 && (!quantiles || !values));
+
+    for (size_t nq = 0; nq < n_quantiles; nq++) {
+        roc_panic_if_msg(quantiles[nq] < 0 || quantiles[nq] > 1
+                             || (nq != 0 && quantiles[nq] < quantiles[nq - 1]),
+                         "hdr histogram: quantiles should be sorted and in [0; 1]");
+    }
+
+    // Take a local copy, so that totals and cumulative sums are consistent
+    // even if writer updates buckets concurrently.
+    uint32_t snapshot[NumBuckets];
+    uint64_t total = 0;
+
+    for (size_t n = 0; n < NumBuckets; n++) {
+        snapshot[n] = AtomicOps::load_relaxed(buckets_[n]);
+        total += snapshot[n];
+    }
+
+    size_t nq = 0;
+
+    if (total != 0) {
+        uint64_t cumulative = 0;
+
+        for (size_t n = 0; n < NumBuckets && nq < n_quantiles; n++) {
+            cumulative += snapshot[n];
+
+            while (nq < n_quantiles) {
+                // Rank of the value at quantile, 1-based.
+                uint64_t rank = (uint64_t)ceil(quantiles[nq] * (double)total);
+                if (rank == 0) {
+                    rank = 1;
+                }
+                if (cumulative < rank) {
+                    break;
+                }
+                values[nq++] = bucket_upper_(n);
+            }
+        }
+    }
+
+    for (; nq < n_quantiles; nq++) {
+        values[nq] = 0;
+    }
+
+    return total;
+}
+
+size_t HdrHistogram::bucket_index_(uint64_t value) {
+    if (value > MaxValue) {
+        value = MaxValue;
+    }
+
+    if (value < SubBuckets) {
+        return (size_t)value;
+    }
+
+    // Position of most significant bit, >= SubBucketBits.
+    size_t msb = SubBucketBits;
+    while ((value >> (msb + 1)) != 0) {
+        msb++;
+    }
+
+    const size_t shift = msb - SubBucketBits;
+    const size_t sub = (size_t)(value >> shift) & (SubBuckets - 1);
+
+    return (shift + 1) * SubBuckets + sub;
+}
+
+uint64_t HdrHistogram::bucket_upper_(size_t index) {
+    if (index < SubBuckets) {
+        return index;
+    }
+
+    const size_t shift = index / SubBuckets - 1;
+    const size_t sub = index % SubBuckets;
+
+    const uint64_t lower = (uint64_t)(SubBuckets + sub) << shift;
+
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+} // namespace core
+} // namespace roc
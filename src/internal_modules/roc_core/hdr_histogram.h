@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/hdr_histogram.h
+//! @brief HDR-style histogram.
+
+#ifndef ROC_CORE_HDR_HISTOGRAM_H_
+#define ROC_CORE_HDR_HISTOGRAM_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! HDR-style histogram of non-negative integer values.
+//!
+//! @remarks
+//!  Values are grouped into a fixed number of log-linear buckets: each power of
+//!  two range is split into SubBuckets equal buckets, so that the relative error
+//!  of reported quantiles is bounded by 1 / SubBuckets. Values below SubBuckets
+//!  are stored exactly. Values above MaxValue are clamped.
+//!
+//! @remarks
+//!  Intended for one writer and any number of readers. add() and clear() should
+//!  be serialized, but readers may run concurrently with them. All operations
+//!  are lock-free and wait-free; a concurrent reader may see some of the last
+//!  additions and miss others.
+class HdrHistogram : public NonCopyable<> {
+public:
+    enum {
+        //! Log2 of number of sub-buckets per power of two.
+        SubBucketBits = 4,
+
+        //! Number of sub-buckets per power of two.
+        SubBuckets = 1 << SubBucketBits,
+
+        //! Total number of buckets.
+        NumBuckets = (32 - SubBucketBits + 1) * SubBuckets
+    };
+
+    //! Maximum value that can be stored without clamping.
+    static const uint64_t MaxValue = 0xffffffffu;
+
+    //! Initialize empty histogram.
+    HdrHistogram();
+
+    //! Add value.
+    void add(uint64_t value);
+
+    //! Add all values from another histogram.
+    void merge(const HdrHistogram& other);
+
+    //! Remove all values.
+    void clear();
+
+    //! Get number of added values.
+    uint64_t count() const;
+
+    //! Get value at given quantile.
+    //! @remarks
+    //!  @p q should be in range [0; 1]. Returns the highest value that falls
+    //!  into the same bucket as the value at given quantile, or zero if
+    //!  histogram is empty.
+    uint64_t quantile(double q) const;
+
+    //! Get values at several quantiles in one pass.
+    //! @remarks
+    //!  @p quantiles should be sorted in ascending order. Result is written
+    //!  to @p values, which should have @p n_quantiles elements.
+    //! @returns
+    //!  number of values in histogram.
+    uint64_t
+    quantiles(const double* quantiles, uint64_t* values, size_t n_quantiles) const;
+
+private:
+    static size_t bucket_index_(uint64_t value);
+    static uint64_t bucket_upper_(size_t index);
+
+    uint32_t buckets_[NumBuckets];
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_HDR_HISTOGRAM_H_
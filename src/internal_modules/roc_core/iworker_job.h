@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/iworker_job.h
+//! @brief Worker job interface.
+
+#ifndef ROC_CORE_IWORKER_JOB_H_
+#define ROC_CORE_IWORKER_JOB_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Worker job interface.
+//! @see WorkerPool.
+class IWorkerJob {
+public:
+    virtual ~IWorkerJob();
+
+    //! Execute job part with given index.
+    //! May be called concurrently from multiple threads with different indices.
+    virtual void run_job(size_t job_index) = 0;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_IWORKER_JOB_H_
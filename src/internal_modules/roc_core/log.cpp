@@ -7,6 +7,7 @@
  */
 
 #include "roc_core/log.h"
+#include "roc_core/async_log_queue.h"
 #include "roc_core/global_destructor.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
@@ -24,12 +25,24 @@ void backend_handler(const LogMessage& msg, void** args) {
     ((LogBackend*)args[0])->handle(msg);
 }
 
+// Flushes messages queued in asynchronous mode when program exits.
+struct AsyncFlusher {
+    ~AsyncFlusher() {
+        (void)Logger::instance().set_async(false);
+    }
+};
+
+AsyncFlusher async_flusher;
+
 } // namespace
 
 Logger::Logger()
     : level_(LogError)
     , colors_mode_(ColorsDisabled)
-    , location_mode_(LocationDisabled) {
+    , location_mode_(LocationDisabled)
+    , async_queue_(NULL)
+    , async_writers_(0)
+    , async_dropped_(0) {
     handler_ = &backend_handler;
     handler_args_[0] = &backend_;
 }
@@ -99,24 +112,99 @@ void Logger::set_handler(LogHandler handler, void** args, size_t n_args) {
     }
 }
 
+bool Logger::set_async(bool enabled) {
+    // Not holding mutex_ here: starting and stopping thread may log, and
+    // background thread takes mutex_ when passing messages to handler.
+    AsyncLogQueue* queue = AtomicOps::load_acquire(async_queue_);
+
+    if (enabled) {
+        if (queue) {
+            return true;
+        }
+
+        queue = new (async_arena_) AsyncLogQueue(async_arena_, &async_sink_, this);
+        if (!queue || !queue->is_valid() || !queue->start()) {
+            if (queue) {
+                async_arena_.destroy_object(*queue);
+            }
+            return false;
+        }
+
+        AsyncLogQueue* expected = NULL;
+        if (!AtomicOps::compare_exchange_seq_cst(async_queue_, expected, queue)) {
+            // Concurrent set_async(true) won.
+            queue->stop();
+            async_arena_.destroy_object(*queue);
+        }
+
+        return true;
+    }
+
+    queue = AtomicOps::exchange_seq_cst(async_queue_, (AsyncLogQueue*)NULL);
+    if (!queue) {
+        return true;
+    }
+
+    // Wait until writers that have seen the queue are done with it.
+    while (AtomicOps::load_seq_cst(async_writers_) != 0) {
+        sleep_for(ClockMonotonic, Microsecond * 100);
+    }
+
+    queue->stop();
+
+    {
+        Mutex::Lock lock(mutex_);
+        async_dropped_ += queue->num_dropped();
+    }
+
+    async_arena_.destroy_object(*queue);
+
+    return true;
+}
+
+size_t Logger::num_dropped() const {
+    Mutex::Lock lock(mutex_);
+
+    size_t n_dropped = async_dropped_;
+
+    AtomicOps::fetch_add_seq_cst(async_writers_, 1);
+
+    if (AsyncLogQueue* queue = AtomicOps::load_seq_cst(async_queue_)) {
+        n_dropped += queue->num_dropped();
+    }
+
+    AtomicOps::fetch_sub_seq_cst(async_writers_, 1);
+
+    return n_dropped;
+}
+
 void Logger::writef(LogLevel level,
                     const char* module,
                     const char* file,
                     int line,
                     const char* format,
                     ...) {
-    Mutex::Lock lock(mutex_);
+    if (AtomicOps::load_relaxed(async_queue_)) {
+        AtomicOps::fetch_add_seq_cst(async_writers_, 1);
 
-    if (level > level_ || level == LogNone) {
-        return;
+        if (AsyncLogQueue* queue = AtomicOps::load_seq_cst(async_queue_)) {
+            if (level <= get_level() && level != LogNone) {
+                va_list args;
+                va_start(args, format);
+                (void)queue->push(level, module, file, line, format, args);
+                va_end(args);
+            }
+
+            AtomicOps::fetch_sub_seq_cst(async_writers_, 1);
+            return;
+        }
+
+        AtomicOps::fetch_sub_seq_cst(async_writers_, 1);
     }
 
-    // If user installed custom log handler and did not uninstall it until process
-    // exit, it may happen that user's library will deinitialize before our
-    // library (if we're in different shared libraries). If this happened, attempt
-    // to invoke handler at this point may cause crashes. To reduce probability of
-    // this, we stop using user handler as soon as we have detected it.
-    if (handler_ != &backend_handler && GlobalDestructor::is_destroying()) {
+    Mutex::Lock lock(mutex_);
+
+    if (level > level_ || level == LogNone) {
         return;
     }
 
@@ -137,6 +225,29 @@ void Logger::writef(LogLevel level,
     msg.pid = Thread::get_pid();
     msg.tid = Thread::get_tid();
     msg.text = text;
+
+    emit_(msg);
+}
+
+void Logger::async_sink_(const LogMessage& msg, void* arg) {
+    Logger& self = *(Logger*)arg;
+
+    Mutex::Lock lock(self.mutex_);
+
+    LogMessage msg_copy = msg;
+    self.emit_(msg_copy);
+}
+
+void Logger::emit_(LogMessage& msg) {
+    // If user installed custom log handler and did not uninstall it until process
+    // exit, it may happen that user's library will deinitialize before our
+    // library (if we're in different shared libraries). If this happened, attempt
+    // to invoke handler at this point may cause crashes. To reduce probability of
+    // this, we stop using user handler as soon as we have detected it.
+    if (handler_ != &backend_handler && GlobalDestructor::is_destroying()) {
+        return;
+    }
+
     msg.location_mode = location_mode_;
     msg.colors_mode = colors_mode_;
 
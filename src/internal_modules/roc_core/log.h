@@ -14,6 +14,7 @@
 
 #include "roc_core/atomic_ops.h"
 #include "roc_core/attributes.h"
+#include "roc_core/heap_arena.h"
 #include "roc_core/log_backend.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
@@ -51,6 +52,8 @@ enum LogLevel {
 
 namespace core {
 
+class AsyncLogQueue;
+
 //! Colors mode.
 enum ColorsMode {
     ColorsAuto,     //!< Automatically use colored logs if colors are supported.
@@ -145,6 +148,22 @@ public:
     //!  Other threads will see the change immediately.
     void set_handler(LogHandler handler, void** args, size_t n_args);
 
+    //! Enable or disable asynchronous mode.
+    //! @remarks
+    //!  In asynchronous mode, writef() only formats message and pushes it to a
+    //!  lock-free queue, and a background thread passes queued messages to log
+    //!  handler. This way logging doesn't block realtime threads on the logger
+    //!  mutex and the handler. If the queue is full, messages are dropped, and
+    //!  the number of dropped messages is reported to the log later.
+    //!  When asynchronous mode is disabled, or when program exits, all queued
+    //!  messages are flushed.
+    //! @returns
+    //!  false if asynchronous mode can't be enabled.
+    ROC_ATTR_NODISCARD bool set_async(bool enabled);
+
+    //! Get number of messages dropped in asynchronous mode.
+    size_t num_dropped() const;
+
 private:
     friend class Singleton<Logger>;
 
@@ -152,6 +171,9 @@ private:
 
     Logger();
 
+    static void async_sink_(const LogMessage& msg, void* arg);
+    void emit_(LogMessage& msg);
+
     int level_;
 
     Mutex mutex_;
@@ -163,6 +185,11 @@ private:
 
     ColorsMode colors_mode_;
     LocationMode location_mode_;
+
+    HeapArena async_arena_;
+    AsyncLogQueue* async_queue_;
+    mutable int async_writers_;
+    size_t async_dropped_;
 };
 
 } // namespace core
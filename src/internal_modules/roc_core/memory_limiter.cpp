@@ -10,21 +10,42 @@
 
 #include "roc_core/cpu_instructions.h"
 #include "roc_core/log.h"
+#include "roc_core/thread.h"
 
 namespace roc {
 namespace core {
 
+namespace {
+
+size_t choose_chunk_size(size_t max_bytes, size_t num_shards, size_t max_chunk) {
+    if (max_bytes == 0) {
+        return max_chunk;
+    }
+
+    // Keep all shards together to hold a small fraction of the limit,
+    // so that exact accounting is needed only close to the limit.
+    const size_t chunk = max_bytes / num_shards / 4;
+
+    return chunk < max_chunk ? chunk : max_chunk;
+}
+
+} // namespace
+
 MemoryLimiter::MemoryLimiter(const char* name, size_t max_bytes)
     : name_(name)
     , max_bytes_(max_bytes)
-    , bytes_acquired_(0) {
+    , chunk_size_(choose_chunk_size(max_bytes, NumShards, MaxChunkSize))
+    , bytes_reserved_(0) {
 }
 
 MemoryLimiter::~MemoryLimiter() {
-    if (bytes_acquired_ > 0) {
+    // Panics if more bytes were released than acquired.
+    collect_shards_();
+
+    if (bytes_reserved_ > 0) {
         roc_panic("memory limiter (%s): detected that memory has not been released: "
                   "acquired=%lu",
-                  name_, (unsigned long)bytes_acquired_);
+                  name_, (unsigned long)bytes_reserved_);
     }
 }
 
@@ -32,22 +53,36 @@ bool MemoryLimiter::acquire(size_t num_bytes) {
     if (num_bytes == 0) {
         roc_panic("memory limiter (%s): tried to acquire zero bytes", name_);
     }
-    size_t current;
-    do {
-        current = bytes_acquired_;
-        size_t next = current + num_bytes;
-        if (max_bytes_ > 0 && next > max_bytes_) {
-            break;
-        }
-        if (bytes_acquired_.compare_exchange(current, next)) {
-            return true;
-        }
-        cpu_relax();
-    } while (true);
+
+    Shard& shard = current_shard_();
+
+    // Fast path: use quota reserved by shard earlier.
+    if (acquire_from_shard_(shard, num_bytes)) {
+        return true;
+    }
+
+    // Reserve requested bytes plus a chunk for next allocations.
+    if (reserve_(num_bytes + chunk_size_)) {
+        shard.available += chunk_size_;
+        return true;
+    }
+
+    // Limit is near, switch to exact accounting: reserve only requested
+    // bytes, and if it's not enough, collect unused quota from all shards.
+    if (reserve_(num_bytes)) {
+        return true;
+    }
+
+    collect_shards_();
+
+    if (reserve_(num_bytes)) {
+        return true;
+    }
+
     roc_log(LogError,
             "memory limiter (%s): could not acquire bytes due to limit: requested=%lu "
             "acquired=%lu limit=%lu",
-            name_, (unsigned long)num_bytes, (unsigned long)current,
+            name_, (unsigned long)num_bytes, (unsigned long)num_acquired(),
             (unsigned long)max_bytes_);
     return false;
 }
@@ -56,8 +91,90 @@ void MemoryLimiter::release(size_t num_bytes) {
     if (num_bytes == 0) {
         roc_panic("memory limiter (%s): tried to release zero bytes", name_);
     }
-    size_t next = bytes_acquired_ -= num_bytes;
-    size_t prev = next + num_bytes;
+
+    release_to_shard_(current_shard_(), num_bytes);
+}
+
+size_t MemoryLimiter::num_acquired() {
+    size_t available = 0;
+    for (size_t n = 0; n < NumShards; n++) {
+        available += shards_[n].available;
+    }
+
+    const size_t reserved = bytes_reserved_;
+
+    // may happen temporarily during concurrent operations
+    if (available > reserved) {
+        return 0;
+    }
+
+    return reserved - available;
+}
+
+// Maps calling thread to a shard. Identifiers of threads are usually
+// addresses of their control blocks, so low bits are dropped.
+MemoryLimiter::Shard& MemoryLimiter::current_shard_() {
+    const uint64_t tid = Thread::get_opaque_tid();
+    const size_t index = size_t((tid >> 4) ^ (tid >> 12) ^ (tid >> 20)) & (NumShards - 1);
+
+    return shards_[index];
+}
+
+bool MemoryLimiter::acquire_from_shard_(Shard& shard, size_t num_bytes) {
+    size_t current;
+    do {
+        current = shard.available;
+        if (current < num_bytes) {
+            return false;
+        }
+        if (shard.available.compare_exchange(current, current - num_bytes)) {
+            return true;
+        }
+        cpu_relax();
+    } while (true);
+}
+
+void MemoryLimiter::release_to_shard_(Shard& shard, size_t num_bytes) {
+    const size_t available = shard.available += num_bytes;
+
+    if (available <= chunk_size_ * 2) {
+        return;
+    }
+
+    // Shard holds too much unused quota, keep one chunk and return the rest.
+    size_t current;
+    do {
+        current = shard.available;
+        if (current <= chunk_size_) {
+            return;
+        }
+        if (shard.available.compare_exchange(current, chunk_size_)) {
+            break;
+        }
+        cpu_relax();
+    } while (true);
+
+    unreserve_(current - chunk_size_);
+}
+
+bool MemoryLimiter::reserve_(size_t num_bytes) {
+    size_t current;
+    do {
+        current = bytes_reserved_;
+        const size_t next = current + num_bytes;
+        if (max_bytes_ > 0 && next > max_bytes_) {
+            return false;
+        }
+        if (bytes_reserved_.compare_exchange(current, next)) {
+            return true;
+        }
+        cpu_relax();
+    } while (true);
+}
+
+void MemoryLimiter::unreserve_(size_t num_bytes) {
+    const size_t next = bytes_reserved_ -= num_bytes;
+    const size_t prev = next + num_bytes;
     if (next > prev) {
         roc_panic("memory limiter (%s): tried to release too many bytes: requested=%lu, "
                   "acquired=%lu",
@@ -65,8 +182,13 @@ void MemoryLimiter::release(size_t num_bytes) {
     }
 }
 
-size_t MemoryLimiter::num_acquired() {
-    return bytes_acquired_;
+void MemoryLimiter::collect_shards_() {
+    for (size_t n = 0; n < NumShards; n++) {
+        const size_t available = shards_[n].available.exchange(0);
+        if (available != 0) {
+            unreserve_(available);
+        }
+    }
 }
 
 } // namespace core
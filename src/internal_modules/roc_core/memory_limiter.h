@@ -12,6 +12,7 @@
 #ifndef ROC_CORE_MEMORY_LIMITER_H_
 #define ROC_CORE_MEMORY_LIMITER_H_
 
+#include "roc_core/align_ops.h"
 #include "roc_core/atomic.h"
 #include "roc_core/attributes.h"
 #include "roc_core/noncopyable.h"
@@ -24,6 +25,14 @@ namespace core {
 //! This class can be used to keep track of memory being consumed. This is done through
 //! the acquire and release methods. The class is used within classes such as LimitedPool,
 //! LimitedArena.
+//!
+//! To avoid contention of all threads on a single counter, quota is reserved
+//! from the global counter in chunks and kept in a number of shards; every
+//! thread is mapped to a shard, so that most acquire and release operations
+//! touch only shard counter. Unused quota in shard is returned to the global
+//! counter in bulk. When the limit is near, chunks are not reserved anymore,
+//! and unused quota is collected back from all shards, so that the limit is
+//! still enforced exactly.
 class MemoryLimiter : public NonCopyable<> {
 public:
     //! Initialize memory limiter.
@@ -42,15 +51,52 @@ public:
 
     //! Track released memory.
     //! This will panic if we are releasing more than what is currently acquired.
+    //! @remarks
+    //!  The check is performed when unused quota is returned to the global
+    //!  counter, so it may be delayed until following operations.
     void release(size_t num_bytes);
 
     //! Get number of bytes currently acquired.
+    //! @remarks
+    //!  Exact if there are no concurrent acquire and release operations.
     size_t num_acquired();
 
 private:
+    enum {
+        // Number of shards, power of two.
+        NumShards = 16,
+
+        // Maximum quota reserved by shard in advance.
+        MaxChunkSize = 16 * 1024
+    };
+
+    struct Shard {
+        // quota reserved from global counter, but not acquired yet
+        Atomic<size_t> available;
+
+        CacheLinePad pad;
+    };
+
+    Shard& current_shard_();
+
+    bool acquire_from_shard_(Shard& shard, size_t num_bytes);
+    void release_to_shard_(Shard& shard, size_t num_bytes);
+
+    bool reserve_(size_t num_bytes);
+    void unreserve_(size_t num_bytes);
+
+    void collect_shards_();
+
     const char* name_;
     const size_t max_bytes_;
-    Atomic<size_t> bytes_acquired_;
+    const size_t chunk_size_;
+
+    // quota reserved by all shards, including acquired and available bytes
+    Atomic<size_t> bytes_reserved_;
+
+    CacheLinePad pad_;
+
+    Shard shards_[NumShards];
 };
 
 } // namespace core
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/memory_tracker.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+const char* memory_tag_to_str(MemoryTag tag) {
+    switch (tag) {
+    case MemoryTag_Session:
+        return "session";
+    case MemoryTag_Queue:
+        return "queue";
+    case MemoryTag_Fec:
+        return "fec";
+    case MemoryTag_Resampler:
+        return "resampler";
+    case MemoryTag_Rtcp:
+        return "rtcp";
+    case MemoryTag_Max:
+        break;
+    }
+    return "<invalid>";
+}
+
+MemoryTracker::MemoryTracker(MemoryTracker* parent)
+    : parent_(parent) {
+}
+
+void MemoryTracker::acquire(MemoryTag tag, size_t num_bytes) {
+    roc_panic_if_msg(tag < 0 || tag >= MemoryTag_Max, "memory tracker: invalid tag: %d",
+                     (int)tag);
+
+    const size_t live = (live_bytes_[tag] += num_bytes);
+
+    for (;;) {
+        const size_t peak = peak_bytes_[tag];
+        if (live <= peak || peak_bytes_[tag].compare_exchange(peak, live)) {
+            break;
+        }
+    }
+
+    if (parent_) {
+        parent_->acquire(tag, num_bytes);
+    }
+}
+
+void MemoryTracker::release(MemoryTag tag, size_t num_bytes) {
+    roc_panic_if_msg(tag < 0 || tag >= MemoryTag_Max, "memory tracker: invalid tag: %d",
+                     (int)tag);
+
+    live_bytes_[tag] -= num_bytes;
+
+    if (parent_) {
+        parent_->release(tag, num_bytes);
+    }
+}
+
+MemoryUsage MemoryTracker::usage() const {
+    MemoryUsage usage;
+
+    for (size_t n = 0; n < MemoryTag_Max; n++) {
+        usage.live_bytes[n] = live_bytes_[n];
+        usage.peak_bytes[n] = peak_bytes_[n];
+    }
+
+    return usage;
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/memory_tracker.h
+//! @brief Memory accounting per subsystem.
+
+#ifndef ROC_CORE_MEMORY_TRACKER_H_
+#define ROC_CORE_MEMORY_TRACKER_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Subsystem to which memory is accounted.
+enum MemoryTag {
+    //! Session components not covered by other tags.
+    MemoryTag_Session,
+
+    //! Packet queues.
+    MemoryTag_Queue,
+
+    //! FEC blocks and codec state.
+    MemoryTag_Fec,
+
+    //! Resampler buffers.
+    MemoryTag_Resampler,
+
+    //! RTCP state.
+    MemoryTag_Rtcp,
+
+    //! Number of tags.
+    MemoryTag_Max
+};
+
+//! Get string name of memory tag.
+const char* memory_tag_to_str(MemoryTag tag);
+
+//! Memory usage per tag.
+struct MemoryUsage {
+    //! Number of bytes currently allocated.
+    size_t live_bytes[MemoryTag_Max];
+
+    //! Maximum number of bytes allocated at once.
+    size_t peak_bytes[MemoryTag_Max];
+
+    MemoryUsage() {
+        for (size_t n = 0; n < MemoryTag_Max; n++) {
+            live_bytes[n] = 0;
+            peak_bytes[n] = 0;
+        }
+    }
+};
+
+//! Memory tracker.
+//!
+//! Counts live and peak bytes per tag. Allocations are reported by TaggedArena.
+//!
+//! If parent tracker is given, every change is also reported to it, so that
+//! e.g. per-session trackers are summed up in per-context tracker. Peak of
+//! parent is peak of the sum, not sum of peaks.
+//!
+//! Tracker should outlive all arenas and allocations that report to it.
+//!
+//! Thread-safe and lock-free.
+class MemoryTracker : public NonCopyable<> {
+public:
+    //! Initialize.
+    explicit MemoryTracker(MemoryTracker* parent = NULL);
+
+    //! Track allocated memory.
+    void acquire(MemoryTag tag, size_t num_bytes);
+
+    //! Track deallocated memory.
+    void release(MemoryTag tag, size_t num_bytes);
+
+    //! Get current usage.
+    MemoryUsage usage() const;
+
+private:
+    MemoryTracker* parent_;
+
+    Atomic<size_t> live_bytes_[MemoryTag_Max];
+    Atomic<size_t> peak_bytes_[MemoryTag_Max];
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_MEMORY_TRACKER_H_
@@ -12,6 +12,7 @@
 #ifndef ROC_CORE_MPSC_QUEUE_IMPL_H_
 #define ROC_CORE_MPSC_QUEUE_IMPL_H_
 
+#include "roc_core/align_ops.h"
 #include "roc_core/mpsc_queue_node.h"
 
 namespace roc {
@@ -42,7 +43,12 @@ private:
 
     void change_owner_(MpscQueueData* node, void* from, void* to);
 
+    // written by producers
     MpscQueueData* tail_;
+
+    CacheLinePad pad_;
+
+    // written by consumer
     MpscQueueData* head_;
 
     MpscQueueData stub_;
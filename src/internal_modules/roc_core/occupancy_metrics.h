@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/occupancy_metrics.h
+//! @brief Occupancy metrics.
+
+#ifndef ROC_CORE_OCCUPANCY_METRICS_H_
+#define ROC_CORE_OCCUPANCY_METRICS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Occupancy metrics of a buffering stage (queue, buffer, etc).
+//! @remarks
+//!  Units are defined by stage: e.g. packets for packet queues, and samples
+//!  per channel for audio buffers.
+struct OccupancyMetrics {
+    //! Number of units buffered right now.
+    size_t occupancy;
+
+    //! Maximum value of occupancy seen so far (high-water mark).
+    size_t max_occupancy;
+
+    //! Cumulative count of units passed through stage.
+    uint64_t throughput;
+
+    OccupancyMetrics()
+        : occupancy(0)
+        , max_occupancy(0)
+        , throughput(0) {
+    }
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_OCCUPANCY_METRICS_H_
@@ -152,5 +152,69 @@ bool parse_size(const char* str, size_t& result) {
     return true;
 }
 
+bool parse_cpu_list(const char* str, uint64_t& result) {
+    if (str == NULL) {
+        roc_log(LogError, "parse cpu list: string is null");
+        return false;
+    }
+
+    const unsigned long max_cpu = 63;
+
+    uint64_t mask = 0;
+
+    for (;;) {
+        if (!isdigit(*str)) {
+            roc_log(LogError,
+                    "parse cpu list: invalid format: expected comma-separated"
+                    " list of <cpu> or <cpu>-<cpu>");
+            return false;
+        }
+
+        char* number_end = NULL;
+        const unsigned long first = strtoul(str, &number_end, 10);
+        unsigned long last = first;
+        str = number_end;
+
+        if (*str == '-') {
+            str++;
+            if (!isdigit(*str)) {
+                roc_log(LogError,
+                        "parse cpu list: invalid format: expected comma-separated"
+                        " list of <cpu> or <cpu>-<cpu>");
+                return false;
+            }
+            last = strtoul(str, &number_end, 10);
+            str = number_end;
+        }
+
+        if (first > last || last > max_cpu) {
+            roc_log(LogError,
+                    "parse cpu list: cpu out of range:"
+                    " first=%lu last=%lu maximum=%lu",
+                    first, last, max_cpu);
+            return false;
+        }
+
+        for (unsigned long cpu = first; cpu <= last; cpu++) {
+            mask |= (uint64_t)1 << cpu;
+        }
+
+        if (*str == '\0') {
+            break;
+        }
+
+        if (*str != ',') {
+            roc_log(LogError,
+                    "parse cpu list: invalid format: expected comma-separated"
+                    " list of <cpu> or <cpu>-<cpu>");
+            return false;
+        }
+        str++;
+    }
+
+    result = mask;
+    return true;
+}
+
 } // namespace core
 } // namespace roc
@@ -46,6 +46,17 @@ ROC_ATTR_NODISCARD bool parse_duration(const char* string, nanoseconds_t& result
 //!  false if string can't be parsed.
 ROC_ATTR_NODISCARD bool parse_size(const char* string, size_t& result);
 
+//! Parse list of CPUs from string.
+//!
+//! @remarks
+//!  The input string should be a comma-separated list of CPU numbers
+//!  and ranges, e.g. "0", "2,3", "0-3,6". CPU numbers should be below 64.
+//!  Result is a mask, where N-th bit is set for N-th CPU.
+//!
+//! @returns
+//!  false if string can't be parsed.
+ROC_ATTR_NODISCARD bool parse_cpu_list(const char* string, uint64_t& result);
+
 } // namespace core
 } // namespace roc
 
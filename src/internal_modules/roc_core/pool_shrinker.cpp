@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/pool_shrinker.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+PoolShrinker::PoolShrinker(const PoolShrinkerConfig& config)
+    : config_(config)
+    , n_pools_(0) {
+    roc_panic_if_msg(config_.idle_period < 0 || config_.headroom < 0,
+                     "pool shrinker: invalid config: idle_period=%.3fms headroom=%.3f",
+                     (double)config_.idle_period / Millisecond,
+                     (double)config_.headroom);
+}
+
+bool PoolShrinker::is_enabled() const {
+    return config_.idle_period > 0;
+}
+
+nanoseconds_t PoolShrinker::check_interval() const {
+    // Check several times per period to catch peaks.
+    return config_.idle_period / 4;
+}
+
+size_t PoolShrinker::shrink_pools(nanoseconds_t now) {
+    Mutex::Lock lock(mutex_);
+
+    if (!is_enabled()) {
+        return 0;
+    }
+
+    size_t n_released = 0;
+
+    for (size_t n = 0; n < n_pools_; n++) {
+        n_released += shrink_pool_(pools_[n], now);
+    }
+
+    return n_released;
+}
+
+bool PoolShrinker::add_pool_(SlabPoolImpl& pool, size_t min_slots) {
+    Mutex::Lock lock(mutex_);
+
+    if (n_pools_ == MaxPools) {
+        roc_log(LogError, "pool shrinker: too many pools: max=%lu",
+                (unsigned long)MaxPools);
+        return false;
+    }
+
+    PoolState& state = pools_[n_pools_++];
+
+    state.pool = &pool;
+    state.min_slots = min_slots;
+    state.grow_events = pool.num_grow_events();
+    state.peak_slots = pool.num_used_slots();
+    state.idle_since = -1;
+
+    return true;
+}
+
+size_t PoolShrinker::shrink_pool_(PoolState& state, nanoseconds_t now) {
+    const size_t grow_events = state.pool->num_grow_events();
+    const size_t used_slots = state.pool->num_used_slots();
+
+    if (state.idle_since < 0 || grow_events != state.grow_events) {
+        // Pool grew, restart idle period.
+        state.grow_events = grow_events;
+        state.peak_slots = used_slots;
+        state.idle_since = now;
+        return 0;
+    }
+
+    if (state.peak_slots < used_slots) {
+        state.peak_slots = used_slots;
+    }
+
+    if (now - state.idle_since < config_.idle_period) {
+        return 0;
+    }
+
+    size_t keep_slots = state.peak_slots
+        + (size_t)((double)state.peak_slots * (double)config_.headroom + 0.5);
+    if (keep_slots < state.min_slots) {
+        keep_slots = state.min_slots;
+    }
+
+    const size_t n_released = state.pool->release_free_slabs(keep_slots);
+
+    // Next period starts from current usage.
+    state.peak_slots = used_slots;
+    state.idle_since = now;
+
+    return n_released;
+}
+
+} // namespace core
+} // namespace roc
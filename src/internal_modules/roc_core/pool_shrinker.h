@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/pool_shrinker.h
+//! @brief Releases memory of pools after load peaks.
+
+#ifndef ROC_CORE_POOL_SHRINKER_H_
+#define ROC_CORE_POOL_SHRINKER_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Pool shrinker parameters.
+struct PoolShrinkerConfig {
+    //! How long pool should stay without growing before its memory is released.
+    //! If zero, pools are never shrunk.
+    nanoseconds_t idle_period;
+
+    //! Fraction of free slots kept above peak usage seen during idle period.
+    //! E.g. 0.5 means that after shrinking, pool can hold 1.5x of peak usage
+    //! without growing.
+    float headroom;
+
+    PoolShrinkerConfig()
+        : idle_period(0)
+        , headroom(0.5f) {
+    }
+};
+
+//! Pool shrinker.
+//!
+//! Slab pools grow on demand and keep their memory until destroyed, so after
+//! a load peak (many sessions, burst of packets) the memory stays reserved.
+//! Shrinker periodically checks registered pools and releases their fully
+//! free slabs when pool didn't grow during idle period.
+//!
+//! To avoid thrashing between growing and shrinking, pool keeps capacity for
+//! peak usage seen during idle period plus headroom, and every grow event
+//! restarts idle period.
+//!
+//! shrink_pools() scans free lists of pools and should be called from a
+//! background thread (e.g. control loop), not from audio or network threads.
+class PoolShrinker : public NonCopyable<> {
+public:
+    //! Initialize.
+    explicit PoolShrinker(const PoolShrinkerConfig& config);
+
+    //! Check if shrinking is enabled.
+    bool is_enabled() const;
+
+    //! Get interval at which shrink_pools() should be called.
+    nanoseconds_t check_interval() const;
+
+    //! Register pool.
+    //! @remarks
+    //!  Pool will never be shrunk below @p min_slots, e.g. its preallocated size.
+    //!  Pool should outlive shrinker.
+    template <class T, size_t EmbeddedCapacity>
+    ROC_ATTR_NODISCARD bool add_pool(SlabPool<T, EmbeddedCapacity>& pool,
+                                     size_t min_slots) {
+        return add_pool_(pool.impl_, min_slots);
+    }
+
+    //! Check registered pools and release memory of idle ones.
+    //! @p now is current time of monotonic clock.
+    //! @returns
+    //!  number of released slabs.
+    size_t shrink_pools(nanoseconds_t now);
+
+private:
+    enum { MaxPools = 8 };
+
+    struct PoolState {
+        SlabPoolImpl* pool;
+        size_t min_slots;
+        size_t grow_events;
+        size_t peak_slots;
+        nanoseconds_t idle_since;
+    };
+
+    bool add_pool_(SlabPoolImpl& pool, size_t min_slots);
+    size_t shrink_pool_(PoolState& state, nanoseconds_t now);
+
+    const PoolShrinkerConfig config_;
+
+    Mutex mutex_;
+
+    PoolState pools_[MaxPools];
+    size_t n_pools_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_POOL_SHRINKER_H_
@@ -34,7 +34,22 @@ namespace core {
 //! derived class. E.g., PoolAllocation policy holds a reference to the pool
 //! and uses it to release the object.
 //!
-//! Thread-safe.
+//! Thread-safe, unless switched to local mode using make_local(), in which
+//! case all references should be held by one thread at a time until
+//! make_shared() is called. See RefCountedImpl for details.
+//!
+//! Object in local mode may still move between threads without make_shared(),
+//! if two conditions hold:
+//!  - every move is ordered by a synchronization point, e.g. WorkerPool::run()
+//!    dispatching a job to a worker and waiting for it, so that accesses on
+//!    the old and the new thread happen-before each other
+//!  - while threads run concurrently, every object is touched (referenced,
+//!    released, or copied) by at most one of them; other owners may keep their
+//!    references, but don't touch them until threads are joined
+//!
+//! Receiver pipeline relies on this when it reads sessions in parallel, see
+//! ReceiverSessionGroup. Anything that lets two sessions reference the same
+//! packet during that time should switch packet to shared mode first.
 template <class T, class AllocationPolicy>
 class RefCounted : public NonCopyable<RefCounted<T, AllocationPolicy> >,
                    protected AllocationPolicy {
@@ -71,6 +86,26 @@ public:
         }
     }
 
+    //! Check if reference counter is in local mode.
+    bool is_local() const {
+        return impl_.is_local();
+    }
+
+    //! Switch reference counter to non-atomic local mode.
+    //! @remarks
+    //!  Succeeds only if caller holds the only reference.
+    //!  Should be called after object is received from another thread.
+    bool make_local() const {
+        return impl_.make_local();
+    }
+
+    //! Switch reference counter back to atomic shared mode.
+    //! @remarks
+    //!  Should be called before object is passed to another thread.
+    void make_shared() const {
+        impl_.make_shared();
+    }
+
 private:
     RefCountedImpl impl_;
 };
@@ -8,25 +8,35 @@
 
 #include "roc_core/ref_counted_impl.h"
 #include "roc_core/panic.h"
+#include "roc_core/worker_pool.h"
 
 namespace roc {
 namespace core {
 
 RefCountedImpl::RefCountedImpl()
-    : counter_(0) {
+    : counter_(0)
+    , local_(false)
+#ifdef ROC_DEBUG_CHECKS
+    , busy_(0)
+    , run_id_(0)
+    , job_index_(0)
+#endif
+{
 }
 
 RefCountedImpl::~RefCountedImpl() {
-    if (!counter_.compare_exchange(0, -1)) {
+    int exp_counter = 0;
+
+    if (!AtomicOps::compare_exchange_seq_cst(counter_, exp_counter, -1)) {
         roc_panic("ref counter:"
                   " attempt to destroy object that is in use, destroyed, or corrupted:"
                   " counter=%d",
-                  (int)counter_);
+                  (int)exp_counter);
     }
 }
 
 int RefCountedImpl::getref() const {
-    const int current_counter = counter_;
+    const int current_counter = AtomicOps::load_seq_cst(counter_);
 
     if (current_counter < 0 || current_counter > MaxCounter) {
         roc_panic("ref counter:"
@@ -39,28 +49,106 @@ int RefCountedImpl::getref() const {
 }
 
 int RefCountedImpl::incref() const {
-    const int current_counter = ++counter_;
+    int current_counter;
 
-    if (current_counter < 0 || current_counter > MaxCounter) {
-        roc_panic("ref counter:"
-                  " attempt to access destroyed or corrupted object"
-                  " counter=%d",
-                  (int)current_counter);
+    if (local_) {
+        begin_local_();
+        current_counter = AtomicOps::load_relaxed(counter_) + 1;
+        AtomicOps::store_relaxed(counter_, current_counter);
+        end_local_();
+    } else {
+        current_counter = AtomicOps::fetch_add_seq_cst(counter_, 1) + 1;
     }
 
+    check_(current_counter);
+
     return current_counter;
 }
 
 int RefCountedImpl::decref() const {
-    const int current_counter = --counter_;
+    int current_counter;
+
+    if (local_) {
+        begin_local_();
+        current_counter = AtomicOps::load_relaxed(counter_) - 1;
+        AtomicOps::store_relaxed(counter_, current_counter);
+        end_local_();
+    } else {
+        current_counter = AtomicOps::fetch_sub_seq_cst(counter_, 1) - 1;
+    }
+
+    check_(current_counter);
+
+    return current_counter;
+}
+
+bool RefCountedImpl::is_local() const {
+    return local_;
+}
+
+bool RefCountedImpl::make_local() const {
+    if (local_) {
+        return true;
+    }
 
+    // If we hold the only reference, nobody else can acquire a new one,
+    // and seq_cst load synchronizes with the last decref from other threads.
+    if (getref() != 1) {
+        return false;
+    }
+
+    local_ = true;
+    return true;
+}
+
+void RefCountedImpl::make_shared() const {
+    if (!local_) {
+        return;
+    }
+
+    begin_local_();
+    local_ = false;
+    end_local_();
+}
+
+void RefCountedImpl::check_(int current_counter) const {
     if (current_counter < 0 || current_counter > MaxCounter) {
         roc_panic("ref counter:"
                   " attempt to access destroyed or corrupted object"
                   " counter=%d",
                   (int)current_counter);
     }
-    return current_counter;
+}
+
+void RefCountedImpl::begin_local_() const {
+#ifdef ROC_DEBUG_CHECKS
+    if (AtomicOps::exchange_acquire(busy_, 1) != 0) {
+        roc_panic("ref counter:"
+                  " object in local mode is accessed from multiple threads"
+                  " concurrently, missing make_shared() before passing it"
+                  " to another thread?");
+    }
+
+    uint64_t run_id = 0;
+    size_t job_index = 0;
+    if (WorkerPool::current_job(run_id, job_index)) {
+        if (AtomicOps::load_relaxed(run_id_) == run_id
+            && AtomicOps::load_relaxed(job_index_) != job_index) {
+            roc_panic("ref counter:"
+                      " object in local mode is accessed from multiple jobs"
+                      " of same worker pool run, missing make_shared() before"
+                      " passing it to another session?");
+        }
+        AtomicOps::store_relaxed(run_id_, run_id);
+        AtomicOps::store_relaxed(job_index_, job_index);
+    }
+#endif
+}
+
+void RefCountedImpl::end_local_() const {
+#ifdef ROC_DEBUG_CHECKS
+    AtomicOps::store_release(busy_, 0);
+#endif
 }
 
 } // namespace core
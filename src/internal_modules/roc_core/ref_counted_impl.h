@@ -12,7 +12,8 @@
 #ifndef ROC_CORE_REF_COUNTED_IMPL_H_
 #define ROC_CORE_REF_COUNTED_IMPL_H_
 
-#include "roc_core/atomic.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace core {
@@ -20,6 +21,27 @@ namespace core {
 //! Implementation class for reference counter.
 //!
 //! Allows to increment and decrement reference counter.
+//!
+//! Counter can be in one of two modes:
+//!  - shared mode (default), when every increment and decrement is an atomic
+//!    read-modify-write operation, and references may be held and released
+//!    from multiple threads concurrently
+//!  - local mode, when increments and decrements are plain loads and stores,
+//!    and all references must be held and released by one thread at a time
+//!
+//! Object is switched to local mode by the thread which holds its only
+//! reference, typically after receiving object from a concurrent queue. It is
+//! switched back to shared mode by the thread which owns it, before passing
+//! it to a concurrent queue.
+//!
+//! Object in local mode may also be moved to another thread and back, if
+//! moves are ordered by a synchronization point and no two threads touch
+//! it concurrently, see RefCounted.
+//!
+//! When ROC_DEBUG_CHECKS is defined, local mode panics if it detects that
+//! counter is modified by two threads concurrently, or by two different jobs
+//! of the same WorkerPool::run(). The latter check doesn't depend on timing,
+//! so sharing of a local object between parallel sessions fails on first access.
 class RefCountedImpl {
 public:
     //! Initialize.
@@ -38,10 +60,43 @@ public:
     //! @returns reference counter value after decrementing.
     int decref() const;
 
+    //! Check if counter is in local mode.
+    bool is_local() const;
+
+    //! Switch counter to local mode.
+    //! @remarks
+    //!  Succeeds only if caller holds the only reference to the object.
+    //!  After this, all references should be held by the calling thread,
+    //!  until make_shared() is called.
+    //! @returns
+    //!  false if there are other references.
+    bool make_local() const;
+
+    //! Switch counter to shared mode.
+    //! @remarks
+    //!  Should be called by the owning thread before making object
+    //!  available to other threads.
+    void make_shared() const;
+
 private:
     enum { MaxCounter = 100000 };
 
-    mutable Atomic<int> counter_;
+    void check_(int current_counter) const;
+
+    void begin_local_() const;
+    void end_local_() const;
+
+    mutable int counter_;
+    // When true, counter is accessed without atomic read-modify-write;
+    // see class comment for when this is safe.
+    mutable bool local_;
+
+#ifdef ROC_DEBUG_CHECKS
+    mutable int busy_;
+    // Worker pool run and job that last accessed counter in local mode.
+    mutable uint64_t run_id_;
+    mutable size_t job_index_;
+#endif
 };
 
 } // namespace core
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/region_arena.h"
+#include "roc_core/align_ops.h"
+#include "roc_core/log.h"
+#include "roc_core/memory_ops.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+RegionArena::RegionArena(IArena& parent_arena, size_t region_size)
+    : parent_arena_(parent_arena)
+    , region_(NULL)
+    , region_size_(AlignOps::align_max(region_size))
+    , region_offset_(0)
+    , num_region_chunks_(0)
+    , num_parent_chunks_(0)
+    , num_fallbacks_(0) {
+    if (region_size_ == 0) {
+        roc_panic("region arena: region size must be positive");
+    }
+
+    region_ = (char*)parent_arena_.allocate(region_size_);
+    if (!region_) {
+        roc_log(LogError, "region arena: can't allocate region: size=%lu",
+                (unsigned long)region_size_);
+        return;
+    }
+}
+
+RegionArena::~RegionArena() {
+    if (num_region_chunks_ != 0 || num_parent_chunks_ != 0) {
+        roc_panic("region arena: detected leak(s): %lu chunk(s) were not freed",
+                  (unsigned long)(num_region_chunks_ + num_parent_chunks_));
+    }
+
+    if (region_) {
+        parent_arena_.deallocate(region_);
+    }
+}
+
+bool RegionArena::is_valid() const {
+    return region_ != NULL;
+}
+
+bool RegionArena::is_idle() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_region_chunks_ == 0 && num_parent_chunks_ == 0;
+}
+
+size_t RegionArena::num_allocations() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_region_chunks_ + num_parent_chunks_;
+}
+
+size_t RegionArena::num_used_bytes() const {
+    Mutex::Lock lock(mutex_);
+
+    return region_offset_;
+}
+
+size_t RegionArena::num_fallbacks() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_fallbacks_;
+}
+
+void* RegionArena::allocate(size_t size) {
+    roc_panic_if_msg(!region_, "region arena: attempt to use invalid arena");
+
+    const size_t chunk_size = compute_allocated_size(size);
+
+    {
+        Mutex::Lock lock(mutex_);
+
+        if (chunk_size <= region_size_ - region_offset_) {
+            ChunkHeader* chunk = (ChunkHeader*)(region_ + region_offset_);
+            chunk->size = size;
+
+            region_offset_ += chunk_size;
+            num_region_chunks_++;
+
+            char* memory = (char*)chunk + AlignOps::align_max(sizeof(ChunkHeader));
+            MemoryOps::poison_before_use(memory, size);
+
+            return memory;
+        }
+
+        num_fallbacks_++;
+    }
+
+    void* memory = parent_arena_.allocate(size);
+    if (memory) {
+        Mutex::Lock lock(mutex_);
+
+        num_parent_chunks_++;
+    }
+
+    return memory;
+}
+
+void RegionArena::deallocate(void* ptr) {
+    if (!ptr) {
+        roc_panic("region arena: null pointer");
+    }
+
+    if (!owns_(ptr)) {
+        parent_arena_.deallocate(ptr);
+
+        Mutex::Lock lock(mutex_);
+
+        if (num_parent_chunks_ == 0) {
+            roc_panic("region arena: unpaired deallocate");
+        }
+        num_parent_chunks_--;
+
+        return;
+    }
+
+    const ChunkHeader* chunk =
+        (const ChunkHeader*)((char*)ptr - AlignOps::align_max(sizeof(ChunkHeader)));
+    MemoryOps::poison_after_use(ptr, chunk->size);
+
+    Mutex::Lock lock(mutex_);
+
+    if (num_region_chunks_ == 0) {
+        roc_panic("region arena: unpaired deallocate");
+    }
+    num_region_chunks_--;
+
+    if (num_region_chunks_ == 0) {
+        // Last chunk returned, whole region can be reused.
+        region_offset_ = 0;
+    }
+}
+
+size_t RegionArena::compute_allocated_size(size_t size) const {
+    return AlignOps::align_max(sizeof(ChunkHeader)) + AlignOps::align_max(size);
+}
+
+size_t RegionArena::allocated_size(void* ptr) const {
+    if (!ptr) {
+        roc_panic("region arena: null pointer");
+    }
+
+    if (!owns_(ptr)) {
+        return parent_arena_.allocated_size(ptr);
+    }
+
+    const ChunkHeader* chunk =
+        (const ChunkHeader*)((char*)ptr - AlignOps::align_max(sizeof(ChunkHeader)));
+
+    return compute_allocated_size(chunk->size);
+}
+
+bool RegionArena::owns_(const void* ptr) const {
+    return region_ && (const char*)ptr >= region_
+        && (const char*)ptr < region_ + region_size_;
+}
+
+} // namespace core
+} // namespace roc
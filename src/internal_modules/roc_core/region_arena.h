@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/region_arena.h
+//! @brief Region arena.
+
+#ifndef ROC_CORE_REGION_ARENA_H_
+#define ROC_CORE_REGION_ARENA_H_
+
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Region arena.
+//!
+//! Allocates one fixed-size memory region from parent arena when constructed, and
+//! then serves allocations from that region by advancing an offset. Deallocated
+//! chunks are not reused individually; instead, when all chunks are returned, the
+//! whole region is rewound and becomes available again.
+//!
+//! This is useful for groups of objects that are created and destroyed together,
+//! e.g. all components of a pipeline session: once the region is allocated, such
+//! groups can be repeatedly constructed without touching the parent arena.
+//!
+//! If region has not enough space left, allocation is forwarded to parent arena.
+//!
+//! The memory is always maximum aligned.
+//!
+//! Thread-safe.
+class RegionArena : public IArena, public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Allocates region of @p region_size bytes from @p parent_arena.
+    RegionArena(IArena& parent_arena, size_t region_size);
+    ~RegionArena();
+
+    //! Check if region was successfully allocated.
+    bool is_valid() const;
+
+    //! Check if there are no chunks allocated from arena.
+    bool is_idle() const;
+
+    //! Get number of allocated chunks, including forwarded to parent arena.
+    size_t num_allocations() const;
+
+    //! Get number of bytes currently occupied in region.
+    size_t num_used_bytes() const;
+
+    //! Get number of allocations forwarded to parent arena because region
+    //! was exhausted.
+    size_t num_fallbacks() const;
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void* ptr);
+
+    //! Computes how many bytes will be actually allocated if allocate() is called with
+    //! given size. Covers all internal overhead, if any.
+    virtual size_t compute_allocated_size(size_t size) const;
+
+    //! Returns how many bytes was allocated for given pointer returned by allocate().
+    //! Covers all internal overhead, if any.
+    virtual size_t allocated_size(void* ptr) const;
+
+private:
+    struct ChunkHeader {
+        size_t size;
+    };
+
+    bool owns_(const void* ptr) const;
+
+    IArena& parent_arena_;
+
+    char* region_;
+    const size_t region_size_;
+    size_t region_offset_;
+
+    size_t num_region_chunks_;
+    size_t num_parent_chunks_;
+    size_t num_fallbacks_;
+
+    mutable Mutex mutex_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_REGION_ARENA_H_
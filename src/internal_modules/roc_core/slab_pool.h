@@ -50,6 +50,16 @@ enum {
 //! Automatically grows size of new slabs exponentially. The user can also specify the
 //! minimum and maximum limits for the slabs.
 //!
+//! Optionally, works in fixed capacity mode: memory is preallocated using reserve(),
+//! and allocate() returns null instead of allocating new slabs when all slots are
+//! in use. This guarantees that pool doesn't touch the arena after startup.
+//! Number of slabs allocated on demand can be obtained via num_grow_events(),
+//! and number of failed allocations via num_exhausted().
+//!
+//! Memory is returned to arena only when pool is destroyed, or when fully free
+//! slabs are released via release_free_slabs(), e.g. by PoolShrinker after
+//! load peaks.
+//!
 //! The returned memory is always maximum-aligned.
 //!
 //! Implements three safety measures:
@@ -67,6 +77,11 @@ enum {
 //! instance. If non-zero, this memory will be used for first allocations, before
 //! using memory arena.
 //!
+//! Optionally, maintains a thread cache: a few small bounded free lists, refilled
+//! from and flushed to the shared free list in batches. Threads allocating and
+//! deallocating objects concurrently then mostly don't contend on the same lock.
+//! Cache hit rate can be obtained via num_cache_hits() and num_cache_misses().
+//!
 //! Thread-safe.
 template <class T, size_t EmbeddedCapacity = 0>
 class SlabPool : public IPool, public NonCopyable<> {
@@ -80,12 +95,14 @@ public:
     //!  - @p min_alloc_bytes defines minimum size in bytes per request to arena
     //!  - @p max_alloc_bytes defines maximum size in bytes per request to arena
     //!  - @p guards defines options to modify behaviour as indicated in SlabPoolGuard
+    //!  - @p enable_thread_cache defines whether to keep free slots in thread cache
     SlabPool(const char* name,
              IArena& arena,
              size_t object_size = sizeof(T),
              size_t min_alloc_bytes = 0,
              size_t max_alloc_bytes = 0,
-             size_t guards = SlabPool_DefaultGuards)
+             size_t guards = SlabPool_DefaultGuards,
+             bool enable_thread_cache = false)
         : impl_(name,
                 arena,
                 object_size,
@@ -93,7 +110,8 @@ public:
                 max_alloc_bytes,
                 embedded_data_.memory(),
                 embedded_data_.size(),
-                guards) {
+                guards,
+                enable_thread_cache) {
     }
 
     //! Get size of the allocation per object.
@@ -111,6 +129,27 @@ public:
         return impl_.reserve(n_objects);
     }
 
+    //! Enable or disable fixed capacity mode.
+    //! @remarks
+    //!  If enabled, new slabs are allocated only by reserve(), and allocate()
+    //!  returns null when there are no free slots.
+    void set_fixed_capacity(bool fixed) {
+        impl_.set_fixed_capacity(fixed);
+    }
+
+    //! Release slabs that have no used slots.
+    //! @remarks
+    //!  Returns fully free slabs to arena, as long as total number of slots
+    //!  stays not less than @p min_slots. Preallocated embedded memory and
+    //!  memory of pool in fixed capacity mode are never released.
+    //!  Takes time proportional to number of free slots and slabs, so it
+    //!  should be called rarely and not from time-critical threads.
+    //! @returns
+    //!  number of released slabs.
+    size_t release_free_slabs(size_t min_slots) {
+        return impl_.release_free_slabs(min_slots);
+    }
+
     //! Allocate memory for an object.
     virtual void* allocate() {
         return impl_.allocate();
@@ -126,7 +165,46 @@ public:
         return impl_.num_guard_failures();
     }
 
+    //! Get number of operations served by thread cache.
+    size_t num_cache_hits() const {
+        return impl_.num_cache_hits();
+    }
+
+    //! Get number of operations that missed thread cache.
+    size_t num_cache_misses() const {
+        return impl_.num_cache_misses();
+    }
+
+    //! Get number of slabs allocated on demand, i.e. not by reserve().
+    //! @remarks
+    //!  Non-zero value means that pool was not preallocated enough.
+    size_t num_grow_events() const {
+        return impl_.num_grow_events();
+    }
+
+    //! Get number of slabs released by release_free_slabs().
+    size_t num_shrink_events() const {
+        return impl_.num_shrink_events();
+    }
+
+    //! Get number of allocations failed because pool had no free slots.
+    //! @remarks
+    //!  In fixed capacity mode, non-zero value means that pool capacity is
+    //!  too small.
+    size_t num_exhausted() const {
+        return impl_.num_exhausted();
+    }
+
+    //! Get number of slots currently in use.
+    //! @remarks
+    //!  Includes slots held in thread cache.
+    size_t num_used_slots() const {
+        return impl_.num_used_slots();
+    }
+
 private:
+    friend class PoolShrinker;
+
     enum {
         SlotSize = (sizeof(SlabPoolImpl::SlotHeader) + sizeof(SlabPoolImpl::SlotCanary)
                     + sizeof(T) + sizeof(SlabPoolImpl::SlotCanary) + sizeof(AlignMax) - 1)
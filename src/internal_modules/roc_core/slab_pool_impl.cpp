@@ -12,6 +12,7 @@
 #include "roc_core/memory_ops.h"
 #include "roc_core/panic.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
 
 namespace roc {
 namespace core {
@@ -37,7 +38,8 @@ SlabPoolImpl::SlabPoolImpl(const char* name,
                            size_t max_alloc_bytes,
                            void* preallocated_data,
                            size_t preallocated_size,
-                           size_t guards)
+                           size_t guards,
+                           bool enable_thread_cache)
     : name_(name)
     , arena_(arena)
     , n_used_slots_(0)
@@ -49,10 +51,15 @@ SlabPoolImpl::SlabPoolImpl(const char* name,
     , slab_hdr_size_(AlignOps::align_max(sizeof(Slab)))
     , slab_cur_slots_(slab_min_bytes_ == 0 ? 1 : slots_per_slab_(slab_min_bytes_, true))
     , slab_max_slots_(slab_max_bytes_ == 0 ? 0 : slots_per_slab_(slab_max_bytes_, false))
+    , fixed_capacity_(false)
+    , num_grow_events_(0)
+    , num_shrink_events_(0)
+    , num_exhausted_(0)
     , object_size_(object_size)
     , object_size_padding_(slot_size_ - unaligned_slot_size_)
     , guards_(guards)
-    , num_guard_failures_(0) {
+    , num_guard_failures_(0)
+    , magazines_(NULL) {
     roc_panic_if_not(slab_cur_slots_ > 0);
     roc_panic_if_not(slab_cur_slots_ <= slab_max_slots_ || slab_max_slots_ == 0);
 
@@ -60,18 +67,57 @@ SlabPoolImpl::SlabPoolImpl(const char* name,
         add_preallocated_memory_(preallocated_data, preallocated_size);
     }
 
+    if (enable_thread_cache) {
+        void* memory = arena_.allocate(sizeof(Magazine) * NumMagazines);
+        if (memory != NULL) {
+            magazines_ = (Magazine*)memory;
+            for (size_t n = 0; n < NumMagazines; n++) {
+                new (&magazines_[n]) Magazine;
+            }
+        } else {
+            roc_log(LogError, "slab pool (%s): can't allocate thread cache", name_);
+        }
+    }
+
     roc_log(LogDebug,
             "slab pool (%s): initializing:"
             " slot_size=%lu prealloc_size=%lu(%lu slots)"
-            " min_slab=%lu(%lu slots) max_slab=%lu(%lu slots)",
+            " min_slab=%lu(%lu slots) max_slab=%lu(%lu slots) thread_cache=%d",
             name_, (unsigned long)slot_size_, (unsigned long)preallocated_size,
             (unsigned long)free_slots_.size(), (unsigned long)slab_min_bytes_,
             (unsigned long)slab_cur_slots_, (unsigned long)slab_max_bytes_,
-            (unsigned long)slab_max_slots_);
+            (unsigned long)slab_max_slots_, (int)(magazines_ != NULL));
 }
 
 SlabPoolImpl::~SlabPoolImpl() {
+    if (magazines_) {
+        const size_t n_hits = num_cache_hits();
+        const size_t n_misses = num_cache_misses();
+
+        roc_log(LogDebug,
+                "slab pool (%s): thread cache stats: hits=%lu misses=%lu hit_rate=%.3f",
+                name_, (unsigned long)n_hits, (unsigned long)n_misses,
+                n_hits + n_misses != 0 ? (double)n_hits / (n_hits + n_misses) : 0.);
+
+        flush_magazines_();
+    }
+
+    if (num_grow_events_ != 0 || num_shrink_events_ != 0 || num_exhausted_ != 0) {
+        roc_log(LogDebug,
+                "slab pool (%s): capacity stats:"
+                " grow_events=%lu shrink_events=%lu exhausted=%lu",
+                name_, (unsigned long)num_grow_events_,
+                (unsigned long)num_shrink_events_, (unsigned long)num_exhausted_);
+    }
+
     deallocate_everything_();
+
+    if (magazines_) {
+        for (size_t n = 0; n < NumMagazines; n++) {
+            magazines_[n].~Magazine();
+        }
+        arena_.deallocate(magazines_);
+    }
 }
 
 bool SlabPoolImpl::reserve(size_t n_objects) {
@@ -80,16 +126,99 @@ bool SlabPoolImpl::reserve(size_t n_objects) {
     return reserve_slots_(n_objects);
 }
 
+void SlabPoolImpl::set_fixed_capacity(bool fixed) {
+    Mutex::Lock lock(mutex_);
+
+    fixed_capacity_ = fixed;
+}
+
+size_t SlabPoolImpl::release_free_slabs(size_t min_slots) {
+    if (magazines_) {
+        // Slots in magazines are counted as used, return them to free list
+        // so that their slabs can be found free.
+        flush_magazines_();
+    }
+
+    Mutex::Lock lock(mutex_);
+
+    if (fixed_capacity_) {
+        return 0;
+    }
+
+    for (Slab* slab = slabs_.front(); slab != NULL; slab = slabs_.nextof(*slab)) {
+        slab->n_free_slots = 0;
+    }
+
+    for (Slot* slot = free_slots_.front(); slot != NULL;
+         slot = free_slots_.nextof(*slot)) {
+        if (Slab* slab = find_slab_(slot)) {
+            slab->n_free_slots++;
+        }
+    }
+
+    size_t n_slots = n_used_slots_ + free_slots_.size();
+    size_t n_released = 0;
+
+    // Newer slabs are larger, release them first.
+    Slab* slab = slabs_.back();
+
+    while (slab != NULL) {
+        Slab* prev_slab = slabs_.prevof(*slab);
+
+        if (slab->n_free_slots == slab->n_slots && n_slots - slab->n_slots >= min_slots) {
+            Slot* slot = free_slots_.front();
+            while (slot != NULL) {
+                Slot* next_slot = free_slots_.nextof(*slot);
+                if (slab_contains_(*slab, slot)) {
+                    free_slots_.remove(*slot);
+                }
+                slot = next_slot;
+            }
+
+            // Next slab allocated on demand starts from released size.
+            if (slab_cur_slots_ > slab->n_slots) {
+                slab_cur_slots_ = slab->n_slots;
+            }
+
+            n_slots -= slab->n_slots;
+            n_released++;
+
+            slabs_.remove(*slab);
+            arena_.deallocate(slab);
+        }
+
+        slab = prev_slab;
+    }
+
+    if (n_released != 0) {
+        num_shrink_events_ += n_released;
+
+        roc_log(LogDebug,
+                "slab pool (%s): released free slabs: n_released=%lu n_slots=%lu",
+                name_, (unsigned long)n_released, (unsigned long)n_slots);
+    }
+
+    return n_released;
+}
+
 void* SlabPoolImpl::allocate() {
     Slot* slot;
 
-    {
+    if (magazines_) {
+        slot = acquire_cached_slot_();
+        if (slot == NULL) {
+            slot = steal_cached_slot_();
+        }
+    } else {
         Mutex::Lock lock(mutex_);
 
         slot = acquire_slot_();
     }
 
     if (slot == NULL) {
+        Mutex::Lock lock(mutex_);
+
+        num_exhausted_++;
         return NULL;
     }
 
@@ -107,7 +236,9 @@ void SlabPoolImpl::deallocate(void* memory) {
         return;
     }
 
-    {
+    if (magazines_) {
+        release_cached_slot_(slot);
+    } else {
         Mutex::Lock lock(mutex_);
 
         release_slot_(slot);
@@ -130,6 +261,58 @@ size_t SlabPoolImpl::num_guard_failures() const {
     return num_guard_failures_;
 }
 
+size_t SlabPoolImpl::num_grow_events() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_grow_events_;
+}
+
+size_t SlabPoolImpl::num_shrink_events() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_shrink_events_;
+}
+
+size_t SlabPoolImpl::num_exhausted() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_exhausted_;
+}
+
+size_t SlabPoolImpl::num_used_slots() const {
+    Mutex::Lock lock(mutex_);
+
+    return n_used_slots_;
+}
+
+size_t SlabPoolImpl::num_cache_hits() const {
+    size_t n_hits = 0;
+
+    if (magazines_) {
+        for (size_t n = 0; n < NumMagazines; n++) {
+            Mutex::Lock lock(magazines_[n].mutex);
+
+            n_hits += magazines_[n].n_hits;
+        }
+    }
+
+    return n_hits;
+}
+
+size_t SlabPoolImpl::num_cache_misses() const {
+    size_t n_misses = 0;
+
+    if (magazines_) {
+        for (size_t n = 0; n < NumMagazines; n++) {
+            Mutex::Lock lock(magazines_[n].mutex);
+
+            n_misses += magazines_[n].n_misses;
+        }
+    }
+
+    return n_misses;
+}
+
 void* SlabPoolImpl::give_slot_to_user_(Slot* slot) {
     slot->~Slot();
 
@@ -187,8 +370,10 @@ SlabPoolImpl::Slot* SlabPoolImpl::take_slot_from_user_(void* memory) {
 }
 
 SlabPoolImpl::Slot* SlabPoolImpl::acquire_slot_() {
-    if (free_slots_.is_empty()) {
-        allocate_new_slab_();
+    if (free_slots_.is_empty() && !fixed_capacity_) {
+        if (allocate_new_slab_()) {
+            num_grow_events_++;
+        }
     }
 
     Slot* slot = free_slots_.front();
@@ -209,6 +394,93 @@ void SlabPoolImpl::release_slot_(Slot* slot) {
     free_slots_.push_front(*slot);
 }
 
+SlabPoolImpl::Magazine& SlabPoolImpl::select_magazine_() {
+    // Thread identifiers are usually addresses or sequential numbers,
+    // so mix bits before selecting magazine.
+    const uint64_t hash = Thread::get_opaque_tid() * 0x9e3779b97f4a7c15ull;
+
+    return magazines_[(size_t)(hash >> 32) % NumMagazines];
+}
+
+SlabPoolImpl::Slot* SlabPoolImpl::acquire_cached_slot_() {
+    Magazine& mag = select_magazine_();
+
+    Mutex::Lock mag_lock(mag.mutex);
+
+    if (mag.n_slots != 0) {
+        mag.n_hits++;
+        return mag.slots[--mag.n_slots];
+    }
+
+    mag.n_misses++;
+
+    Mutex::Lock lock(mutex_);
+
+    Slot* slot = acquire_slot_();
+    if (slot == NULL) {
+        return NULL;
+    }
+
+    // Refill half of magazine, but don't allocate new slabs for that.
+    while (mag.n_slots < MagazineSize / 2 && !free_slots_.is_empty()) {
+        mag.slots[mag.n_slots++] = acquire_slot_();
+    }
+
+    return slot;
+}
+
+SlabPoolImpl::Slot* SlabPoolImpl::steal_cached_slot_() {
+    // Shared free list is empty and can't grow, but other magazines may still
+    // hold free slots. Lock one magazine at a time to keep lock order.
+    for (size_t n = 0; n < NumMagazines; n++) {
+        Magazine& mag = magazines_[n];
+
+        Mutex::Lock mag_lock(mag.mutex);
+
+        if (mag.n_slots != 0) {
+            return mag.slots[--mag.n_slots];
+        }
+    }
+
+    return NULL;
+}
+
+void SlabPoolImpl::release_cached_slot_(Slot* slot) {
+    Magazine& mag = select_magazine_();
+
+    Mutex::Lock mag_lock(mag.mutex);
+
+    if (mag.n_slots != MagazineSize) {
+        mag.n_hits++;
+        mag.slots[mag.n_slots++] = slot;
+        return;
+    }
+
+    mag.n_misses++;
+
+    Mutex::Lock lock(mutex_);
+
+    // Flush half of magazine.
+    while (mag.n_slots > MagazineSize / 2) {
+        release_slot_(mag.slots[--mag.n_slots]);
+    }
+
+    release_slot_(slot);
+}
+
+void SlabPoolImpl::flush_magazines_() {
+    for (size_t n = 0; n < NumMagazines; n++) {
+        Magazine& mag = magazines_[n];
+
+        Mutex::Lock mag_lock(mag.mutex);
+        Mutex::Lock lock(mutex_);
+
+        while (mag.n_slots != 0) {
+            release_slot_(mag.slots[--mag.n_slots]);
+        }
+    }
+}
+
 bool SlabPoolImpl::reserve_slots_(size_t desired_slots) {
     if (desired_slots > free_slots_.size()) {
         increase_slab_size_(desired_slots - free_slots_.size());
@@ -247,6 +519,8 @@ bool SlabPoolImpl::allocate_new_slab_() {
     }
 
     Slab* slab = new (memory) Slab;
+    slab->n_slots = slab_cur_slots_;
+    slab->n_free_slots = 0;
     slabs_.push_back(*slab);
 
     for (size_t n = 0; n < slab_cur_slots_; n++) {
@@ -277,6 +551,22 @@ void SlabPoolImpl::deallocate_everything_() {
     }
 }
 
+SlabPoolImpl::Slab* SlabPoolImpl::find_slab_(Slot* slot) {
+    for (Slab* slab = slabs_.front(); slab != NULL; slab = slabs_.nextof(*slab)) {
+        if (slab_contains_(*slab, slot)) {
+            return slab;
+        }
+    }
+
+    // Preallocated memory.
+    return NULL;
+}
+
+bool SlabPoolImpl::slab_contains_(const Slab& slab, const Slot* slot) const {
+    return (const char*)slot >= (const char*)&slab + slot_offset_(0)
+        && (const char*)slot < (const char*)&slab + slot_offset_(slab.n_slots);
+}
+
 void SlabPoolImpl::add_preallocated_memory_(void* memory, size_t memory_size) {
     if (memory == NULL) {
         roc_panic("slab pool (%s): preallocated memory is null", name_);
@@ -42,6 +42,19 @@ namespace core {
 //! If user data requires padding to be maximum-aligned, this padding
 //! also becomes part of the trailing canary guard.
 //!
+//! If thread cache is enabled, free slots are additionally kept in a few small
+//! bounded "magazines", each protected by its own mutex. Thread picks magazine
+//! by its identifier, and goes to the shared free list only when magazine is
+//! empty or full, moving half of magazine at once.
+//!
+//! In fixed capacity mode, new slabs are allocated only by reserve(). When
+//! there are no free slots, allocation takes a slot from other magazines, and
+//! fails if there are none.
+//!
+//! Slabs are never released while pool is alive, unless release_free_slabs()
+//! is called. It finds slabs with all slots free by scanning free list, so
+//! it's intended to be called rarely and not from time-critical threads.
+//!
 //! @see SlabPool.
 class SlabPoolImpl : public NonCopyable<> {
 public:
@@ -64,7 +77,8 @@ public:
                  size_t max_alloc_bytes,
                  void* preallocated_data,
                  size_t preallocated_size,
-                 size_t guards);
+                 size_t guards,
+                 bool enable_thread_cache);
 
     //! Deinitialize.
     ~SlabPoolImpl();
@@ -72,6 +86,12 @@ public:
     //! Reserve memory for given number of objects.
     ROC_ATTR_NODISCARD bool reserve(size_t n_objects);
 
+    //! Enable or disable fixed capacity mode.
+    void set_fixed_capacity(bool fixed);
+
+    //! Release slabs that have no used slots.
+    size_t release_free_slabs(size_t min_slots);
+
     //! Allocate memory for an object.
     void* allocate();
 
@@ -87,10 +107,58 @@ public:
     //! Get number of guard failures.
     size_t num_guard_failures() const;
 
+    //! Get number of allocations and deallocations served by thread cache.
+    size_t num_cache_hits() const;
+
+    //! Get number of allocations and deallocations that missed thread cache.
+    size_t num_cache_misses() const;
+
+    //! Get number of slabs allocated on demand.
+    size_t num_grow_events() const;
+
+    //! Get number of slabs released by release_free_slabs().
+    size_t num_shrink_events() const;
+
+    //! Get number of allocations failed because pool had no free slots.
+    size_t num_exhausted() const;
+
+    //! Get number of slots currently in use.
+    size_t num_used_slots() const;
+
 private:
-    struct Slab : ListNode<> {};
+    struct Slab : ListNode<> {
+        size_t n_slots;
+        size_t n_free_slots;
+    };
     struct Slot : ListNode<> {};
 
+    enum {
+        // Number of magazines in thread cache.
+        NumMagazines = 8,
+        // Maximum number of slots in one magazine.
+        MagazineSize = 16
+    };
+
+    struct Magazine {
+        Mutex mutex;
+        Slot* slots[MagazineSize];
+        size_t n_slots;
+        size_t n_hits;
+        size_t n_misses;
+
+        Magazine()
+            : n_slots(0)
+            , n_hits(0)
+            , n_misses(0) {
+        }
+    };
+
+    Magazine& select_magazine_();
+    Slot* acquire_cached_slot_();
+    Slot* steal_cached_slot_();
+    void release_cached_slot_(Slot* slot);
+    void flush_magazines_();
+
     void* give_slot_to_user_(Slot* slot);
     Slot* take_slot_from_user_(void* memory);
 
@@ -102,6 +170,9 @@ private:
     bool allocate_new_slab_();
     void deallocate_everything_();
 
+    Slab* find_slab_(Slot* slot);
+    bool slab_contains_(const Slab& slab, const Slot* slot) const;
+
     void add_preallocated_memory_(void* memory, size_t memory_size);
 
     size_t slots_per_slab_(size_t slab_size, bool round_up) const;
@@ -128,11 +199,18 @@ private:
     size_t slab_cur_slots_;
     const size_t slab_max_slots_;
 
+    bool fixed_capacity_;
+    size_t num_grow_events_;
+    size_t num_shrink_events_;
+    size_t num_exhausted_;
+
     const size_t object_size_;
     const size_t object_size_padding_;
 
     const size_t guards_;
     mutable size_t num_guard_failures_;
+
+    Magazine* magazines_;
 };
 
 } // namespace core
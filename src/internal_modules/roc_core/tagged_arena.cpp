@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/tagged_arena.h"
+
+namespace roc {
+namespace core {
+
+TaggedArena::TaggedArena(IArena& arena, MemoryTracker& memory_tracker, MemoryTag tag)
+    : arena_(arena)
+    , memory_tracker_(memory_tracker)
+    , tag_(tag) {
+}
+
+void* TaggedArena::allocate(size_t size) {
+    void* ptr = arena_.allocate(size);
+    if (ptr) {
+        memory_tracker_.acquire(tag_, arena_.allocated_size(ptr));
+    }
+    return ptr;
+}
+
+void TaggedArena::deallocate(void* ptr) {
+    const size_t allocated_size = arena_.allocated_size(ptr);
+    arena_.deallocate(ptr);
+    memory_tracker_.release(tag_, allocated_size);
+}
+
+size_t TaggedArena::compute_allocated_size(size_t size) const {
+    return arena_.compute_allocated_size(size);
+}
+
+size_t TaggedArena::allocated_size(void* ptr) const {
+    return arena_.allocated_size(ptr);
+}
+
+} // namespace core
+} // namespace roc
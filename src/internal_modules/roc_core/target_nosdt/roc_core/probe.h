@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_nosdt/roc_core/probe.h
+//! @brief Static tracepoints.
+
+#ifndef ROC_CORE_PROBE_H_
+#define ROC_CORE_PROBE_H_
+
+//! Static tracepoint.
+//! @remarks
+//!  Static tracepoints are disabled, arguments are not evaluated.
+#define roc_probe(name, ...) ((void)0)
+
+#endif // ROC_CORE_PROBE_H_
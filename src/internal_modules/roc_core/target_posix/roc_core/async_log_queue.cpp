@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/async_log_queue.h"
+#include "roc_core/panic.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// How long background thread sleeps when all rings are empty.
+const nanoseconds_t PollInterval = 5 * Millisecond;
+
+} // namespace
+
+AsyncLogQueue::AsyncLogQueue(IArena& arena, Sink sink, void* sink_arg)
+    : arena_(arena)
+    , sink_(sink)
+    , sink_arg_(sink_arg)
+    , has_ring_key_(false)
+    , n_dropped_(0)
+    , n_reported_(0)
+    , stop_(0)
+    , valid_(false) {
+    roc_panic_if(!sink_);
+
+    if (pthread_key_create(&ring_key_, &release_ring_) != 0) {
+        return;
+    }
+    has_ring_key_ = true;
+
+    for (size_t n = 0; n < NumRings; n++) {
+        rings_[n].buffer = new (arena_) SpscByteBuffer(arena_, sizeof(Record), RingSize);
+        if (!rings_[n].buffer || !rings_[n].buffer->is_valid()) {
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+AsyncLogQueue::~AsyncLogQueue() {
+    if (has_ring_key_) {
+        // After this, release_ring_() is not invoked for threads that still
+        // own rings, so rings can be safely destroyed.
+        pthread_key_delete(ring_key_);
+    }
+
+    for (size_t n = 0; n < NumRings; n++) {
+        if (rings_[n].buffer) {
+            arena_.destroy_object(*rings_[n].buffer);
+        }
+    }
+}
+
+bool AsyncLogQueue::is_valid() const {
+    return valid_;
+}
+
+bool AsyncLogQueue::push(LogLevel level,
+                         const char* module,
+                         const char* file,
+                         int line,
+                         const char* format,
+                         va_list args) {
+    roc_panic_if(!valid_);
+
+    Ring* ring = (Ring*)pthread_getspecific(ring_key_);
+    if (!ring) {
+        ring = acquire_ring_();
+    }
+
+    Record* rec = ring ? (Record*)ring->buffer->begin_write() : NULL;
+    if (!rec) {
+        n_dropped_++;
+        return false;
+    }
+
+    rec->level = level;
+    rec->module = module;
+    rec->file = file;
+    rec->line = line;
+    rec->time = timestamp(ClockUnix);
+    rec->pid = Thread::get_pid();
+    rec->tid = Thread::get_tid();
+
+    if (vsnprintf(rec->text, sizeof(rec->text) - 1, format, args) < 0) {
+        rec->text[0] = '\0';
+    }
+    rec->text[sizeof(rec->text) - 1] = '\0';
+
+    ring->buffer->end_write();
+
+    return true;
+}
+
+size_t AsyncLogQueue::num_dropped() const {
+    return (size_t)(int)n_dropped_;
+}
+
+void AsyncLogQueue::stop() {
+    stop_ = 1;
+    join();
+}
+
+void AsyncLogQueue::release_ring_(void* ring) {
+    // Invoked when owning thread exits. Background thread returns ring
+    // to free list after draining it.
+    ((Ring*)ring)->state = Ring_Orphaned;
+}
+
+AsyncLogQueue::Ring* AsyncLogQueue::acquire_ring_() {
+    for (size_t n = 0; n < NumRings; n++) {
+        if (rings_[n].state.compare_exchange(Ring_Free, Ring_Owned)) {
+            if (pthread_setspecific(ring_key_, &rings_[n]) != 0) {
+                rings_[n].state = Ring_Free;
+                return NULL;
+            }
+            return &rings_[n];
+        }
+    }
+
+    return NULL;
+}
+
+void AsyncLogQueue::run() {
+    while (!stop_) {
+        const size_t n_records = drain_();
+        report_drops_();
+
+        if (n_records == 0) {
+            sleep_for(ClockMonotonic, PollInterval);
+        }
+    }
+
+    // Deliver everything pushed before stop.
+    drain_();
+    report_drops_();
+}
+
+size_t AsyncLogQueue::drain_() {
+    size_t n_records = 0;
+
+    for (size_t n = 0; n < NumRings; n++) {
+        Ring& ring = rings_[n];
+
+        // Read state before draining: if owner has exited, all its records
+        // are already visible, and ring can be freed when it becomes empty.
+        const int state = ring.state;
+
+        while (const Record* rec = (const Record*)ring.buffer->begin_read()) {
+            LogMessage msg;
+            msg.level = rec->level;
+            msg.module = rec->module;
+            msg.file = rec->file;
+            msg.line = rec->line;
+            msg.time = rec->time;
+            msg.pid = rec->pid;
+            msg.tid = rec->tid;
+            msg.text = rec->text;
+
+            sink_(msg, sink_arg_);
+
+            ring.buffer->end_read();
+            n_records++;
+        }
+
+        if (state == Ring_Orphaned) {
+            ring.state = Ring_Free;
+        }
+    }
+
+    return n_records;
+}
+
+void AsyncLogQueue::report_drops_() {
+    const size_t n_dropped = num_dropped();
+
+    if (n_dropped == n_reported_) {
+        return;
+    }
+
+    char text[128] = {};
+    snprintf(text, sizeof(text), "logger: dropped %lu message(s), log queue is full",
+             (unsigned long)(n_dropped - n_reported_));
+
+    n_reported_ = n_dropped;
+
+    LogMessage msg;
+    msg.level = LogInfo;
+    msg.module = "roc_core";
+    msg.file = __FILE__;
+    msg.line = __LINE__;
+    msg.time = timestamp(ClockUnix);
+    msg.pid = Thread::get_pid();
+    msg.tid = Thread::get_tid();
+    msg.text = text;
+
+    sink_(msg, sink_arg_);
+}
+
+} // namespace core
+} // namespace roc
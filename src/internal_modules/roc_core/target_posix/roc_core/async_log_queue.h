@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/async_log_queue.h
+//! @brief Asynchronous log queue.
+
+#ifndef ROC_CORE_ASYNC_LOG_QUEUE_H_
+#define ROC_CORE_ASYNC_LOG_QUEUE_H_
+
+#include <pthread.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/log.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/spsc_byte_buffer.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+//! Asynchronous log queue.
+//!
+//! Allows threads to submit log messages without locking and without waiting
+//! for the log handler. Messages are formatted into fixed-size records, which
+//! are pushed into a lock-free SPSC ring owned by the calling thread. A
+//! background thread pops records from all rings and passes them to the sink.
+//!
+//! Rings are preallocated. Thread claims a free ring on its first push, and
+//! the ring is returned when thread exits and its records are drained. If
+//! thread's ring is full, or there are no free rings, message is dropped, and
+//! the background thread reports the number of dropped messages to the sink.
+//!
+//! Messages from one thread are delivered in order. Messages from different
+//! threads may be reordered, but have timestamps taken at the time of push.
+class AsyncLogQueue : public Thread {
+public:
+    //! Message sink.
+    //! Invoked from background thread.
+    typedef void (*Sink)(const LogMessage& msg, void* arg);
+
+    //! Initialize.
+    AsyncLogQueue(IArena& arena, Sink sink, void* sink_arg);
+
+    //! Deinitialize.
+    //! @remarks
+    //!  Should be called after stop().
+    ~AsyncLogQueue();
+
+    //! Check if rings were successfully allocated.
+    bool is_valid() const;
+
+    //! Format message and push it to queue.
+    //! @remarks
+    //!  Lock-free. Returns false if message was dropped.
+    ROC_ATTR_NODISCARD bool push(LogLevel level,
+                                 const char* module,
+                                 const char* file,
+                                 int line,
+                                 const char* format,
+                                 va_list args);
+
+    //! Get number of dropped messages.
+    size_t num_dropped() const;
+
+    //! Stop background thread.
+    //! @remarks
+    //!  Waits until all pushed messages are passed to sink.
+    void stop();
+
+private:
+    enum {
+        // Number of rings, i.e. maximum number of threads using queue at once.
+        NumRings = 16,
+        // Number of records per ring.
+        RingSize = 128,
+        // Maximum message length.
+        MaxText = 256
+    };
+
+    struct Record {
+        LogLevel level;
+        const char* module;
+        const char* file;
+        int line;
+        nanoseconds_t time;
+        uint64_t pid;
+        uint64_t tid;
+        char text[MaxText];
+    };
+
+    enum RingState { Ring_Free, Ring_Owned, Ring_Orphaned };
+
+    struct Ring {
+        SpscByteBuffer* buffer;
+        Atomic<int> state;
+
+        Ring()
+            : buffer(NULL)
+            , state(Ring_Free) {
+        }
+    };
+
+    static void release_ring_(void* ring);
+
+    virtual void run();
+
+    Ring* acquire_ring_();
+    size_t drain_();
+    void report_drops_();
+
+    IArena& arena_;
+
+    Sink sink_;
+    void* sink_arg_;
+
+    Ring rings_[NumRings];
+
+    pthread_key_t ring_key_;
+    bool has_ring_key_;
+
+    Atomic<int> n_dropped_;
+    size_t n_reported_;
+
+    Atomic<int> stop_;
+
+    bool valid_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_ASYNC_LOG_QUEUE_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <pthread.h>
+
+#include "roc_core/cached_clock.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/fast_clock.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+pthread_once_t scope_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t scope_key;
+
+void create_scope_key() {
+    if (int err = pthread_key_create(&scope_key, NULL)) {
+        roc_panic("cached clock: pthread_key_create(): %s", errno_to_str(err).c_str());
+    }
+}
+
+pthread_key_t get_scope_key() {
+    pthread_once(&scope_key_once, create_scope_key);
+    return scope_key;
+}
+
+} // namespace
+
+CachedClock::Scope::Scope()
+    : unix_time_(timestamp(ClockUnix))
+    , media_time_(media_clock() == MediaClock_System ? unix_time_
+                                                     : timestamp(ClockMedia))
+    , mono_time_(fast_timestamp())
+    , prev_((Scope*)pthread_getspecific(get_scope_key())) {
+    if (int err = pthread_setspecific(get_scope_key(), this)) {
+        roc_panic("cached clock: pthread_setspecific(): %s", errno_to_str(err).c_str());
+    }
+}
+
+CachedClock::Scope::~Scope() {
+    roc_panic_if_msg(pthread_getspecific(get_scope_key()) != this,
+                     "cached clock: scopes closed out of order");
+
+    if (int err = pthread_setspecific(get_scope_key(), prev_)) {
+        roc_panic("cached clock: pthread_setspecific(): %s", errno_to_str(err).c_str());
+    }
+}
+
+nanoseconds_t CachedClock::now(clock_t clock) {
+    const Scope* scope = (const Scope*)pthread_getspecific(get_scope_key());
+
+    if (!scope) {
+        return timestamp(clock);
+    }
+
+    switch (clock) {
+    case ClockUnix:
+        return scope->unix_time_;
+    case ClockMedia:
+        return scope->media_time_;
+    case ClockMonotonic:
+        break;
+    }
+
+    return scope->mono_time_;
+}
+
+} // namespace core
+} // namespace roc
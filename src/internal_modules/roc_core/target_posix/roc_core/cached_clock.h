@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/cached_clock.h
+//! @brief Per-thread cached clock.
+
+#ifndef ROC_CORE_CACHED_CLOCK_H_
+#define ROC_CORE_CACHED_CLOCK_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Per-thread cached clock.
+//!
+//! @remarks
+//!  Pipeline code often needs "current time" many times per frame, e.g. once
+//!  per session, while precision of one frame is enough for it. Instead of
+//!  reading system clock every time, pipeline thread opens a Scope at the
+//!  beginning of frame, which reads clocks once, and the code running inside
+//!  the scope gets that cached time from now().
+//!
+//! @remarks
+//!  Outside of a scope, or in other threads, now() is the same as timestamp().
+//!  So it's safe to use in code which is not always called from pipeline.
+//!
+//! @remarks
+//!  Should not be used for measuring durations inside a frame, since all
+//!  calls within scope return the same value. Use fast_timestamp() for that.
+class CachedClock {
+public:
+    //! Scope during which current thread uses cached time.
+    //! Scopes may be nested; inner scope re-reads clocks.
+    class Scope : public NonCopyable<> {
+    public:
+        //! Read clocks and make them cached time of current thread.
+        Scope();
+
+        //! Restore previous cached time of current thread, if any.
+        ~Scope();
+
+    private:
+        friend class CachedClock;
+
+        nanoseconds_t unix_time_;
+        nanoseconds_t media_time_;
+        nanoseconds_t mono_time_;
+
+        Scope* prev_;
+    };
+
+    //! Get current time.
+    //! @remarks
+    //!  If current thread is inside Scope, returns time cached when scope
+    //!  was opened. Otherwise reads clock.
+    static nanoseconds_t now(clock_t clock);
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_CACHED_CLOCK_H_
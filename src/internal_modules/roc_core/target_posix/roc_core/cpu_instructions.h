@@ -12,6 +12,8 @@
 #ifndef ROC_CORE_CPU_INSTRUCTIONS_H_
 #define ROC_CORE_CPU_INSTRUCTIONS_H_
 
+#include "roc_core/stddefs.h"
+
 namespace roc {
 namespace core {
 
@@ -23,18 +25,34 @@ inline void cpu_relax() {
     __asm__ __volatile__("pause" ::: "memory");
 }
 
+inline uint64_t cpu_cycles() {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return (uint64_t(hi) << 32) | lo;
+}
+
 #elif defined(__aarch64__)
 
 inline void cpu_relax() {
     __asm__ __volatile__("yield" ::: "memory");
 }
 
+inline uint64_t cpu_cycles() {
+    uint64_t val;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(val));
+    return val;
+}
+
 #else // unknown arch
 
 inline void cpu_relax() {
     __asm__ __volatile__("" ::: "memory");
 }
 
+inline uint64_t cpu_cycles() {
+    return 0;
+}
+
 #endif
 
 #else // !__GNUC__
@@ -46,6 +64,15 @@ inline void cpu_relax() {
 inline void cpu_relax() {
 }
 
+//! Read CPU cycle counter.
+//! @remarks
+//!  Returns TSC on x86 and virtual counter on AArch64, or zero if there
+//!  is no counter readable from user space. Counter rate is unknown and
+//!  may be not constant, see CpuFeature_CycleCounter and FastClock.
+inline uint64_t cpu_cycles() {
+    return 0;
+}
+
 #endif // __GNUC__
 
 } // namespace core
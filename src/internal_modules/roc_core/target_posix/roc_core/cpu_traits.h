@@ -183,4 +183,44 @@
 #define ROC_CPU_BITS 32
 #endif
 
+//! Value of ROC_CPU_FAMILY indicating x86 or x86_64 CPU.
+#define ROC_CPU_X86 1
+
+//! Value of ROC_CPU_FAMILY indicating 32-bit or 64-bit ARM CPU.
+#define ROC_CPU_ARM 2
+
+//! Value of ROC_CPU_FAMILY indicating unknown CPU family.
+#define ROC_CPU_OTHER 3
+
+// Detect CPU family.
+
+#ifndef ROC_CPU_FAMILY
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ROC_CPU_FAMILY ROC_CPU_X86
+#elif defined(__aarch64__) || defined(__arm__) || defined(_M_ARM) || defined(_M_ARM64)
+#define ROC_CPU_FAMILY ROC_CPU_ARM
+#else
+#define ROC_CPU_FAMILY ROC_CPU_OTHER
+#endif
+#endif
+
+// Detect SIMD extensions enabled at compile time.
+// Extensions that may be enabled only at run time are handled by cpu_features.h.
+
+#ifndef ROC_CPU_HAS_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROC_CPU_HAS_SSE2 1
+#else
+#define ROC_CPU_HAS_SSE2 0
+#endif
+#endif
+
+#ifndef ROC_CPU_HAS_NEON
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ROC_CPU_HAS_NEON 1
+#else
+#define ROC_CPU_HAS_NEON 0
+#endif
+#endif
+
 #endif // ROC_CORE_CPU_TRAITS_H_
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "roc_core/align_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/huge_page_arena.h"
+#include "roc_core/log.h"
+#include "roc_core/memory_ops.h"
+#include "roc_core/panic.h"
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// Most common huge page size (x86_64, arm64).
+// Mapping size is rounded up to it even if huge pages are not available,
+// so that transparent huge pages can cover the whole mapping.
+const size_t HugePageSize = 2 * 1024 * 1024;
+
+size_t align_huge(size_t size) {
+    return (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+}
+
+} // namespace
+
+HugePageArena::HugePageArena(IArena& parent_arena, size_t reserve_size)
+    : parent_arena_(parent_arena)
+    , region_(NULL)
+    , region_size_(0)
+    , region_offset_(0)
+    , huge_pages_(false)
+    , locked_(false)
+    , num_region_chunks_(0)
+    , num_parent_chunks_(0)
+    , num_fallbacks_(0)
+    , valid_(false) {
+    if (reserve_size == 0) {
+        valid_ = true;
+        return;
+    }
+
+    if (!reserve_(align_huge(reserve_size))) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "huge page arena: reserved memory: size=%lu huge_pages=%d locked=%d",
+            (unsigned long)region_size_, (int)huge_pages_, (int)locked_);
+
+    valid_ = true;
+}
+
+HugePageArena::~HugePageArena() {
+    if (num_region_chunks_ != 0 || num_parent_chunks_ != 0) {
+        roc_panic("huge page arena: detected leak(s): %lu chunk(s) were not freed",
+                  (unsigned long)(num_region_chunks_ + num_parent_chunks_));
+    }
+
+    release_();
+}
+
+bool HugePageArena::is_valid() const {
+    return valid_;
+}
+
+size_t HugePageArena::reserved_size() const {
+    return region_size_;
+}
+
+bool HugePageArena::has_huge_pages() const {
+    return huge_pages_;
+}
+
+bool HugePageArena::is_locked() const {
+    return locked_;
+}
+
+size_t HugePageArena::num_allocations() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_region_chunks_ + num_parent_chunks_;
+}
+
+size_t HugePageArena::num_used_bytes() const {
+    Mutex::Lock lock(mutex_);
+
+    return region_offset_;
+}
+
+size_t HugePageArena::num_fallbacks() const {
+    Mutex::Lock lock(mutex_);
+
+    return num_fallbacks_;
+}
+
+void* HugePageArena::allocate(size_t size) {
+    const size_t chunk_size = compute_allocated_size(size);
+
+    if (region_) {
+        Mutex::Lock lock(mutex_);
+
+        if (chunk_size <= region_size_ - region_offset_) {
+            ChunkHeader* chunk = (ChunkHeader*)(region_ + region_offset_);
+            chunk->size = size;
+
+            region_offset_ += chunk_size;
+            num_region_chunks_++;
+
+            char* memory = (char*)chunk + AlignOps::align_max(sizeof(ChunkHeader));
+            MemoryOps::poison_before_use(memory, size);
+
+            return memory;
+        }
+
+        num_fallbacks_++;
+    }
+
+    void* memory = parent_arena_.allocate(size);
+    if (memory) {
+        Mutex::Lock lock(mutex_);
+
+        num_parent_chunks_++;
+    }
+
+    return memory;
+}
+
+void HugePageArena::deallocate(void* ptr) {
+    if (!ptr) {
+        roc_panic("huge page arena: null pointer");
+    }
+
+    if (!owns_(ptr)) {
+        parent_arena_.deallocate(ptr);
+
+        Mutex::Lock lock(mutex_);
+
+        if (num_parent_chunks_ == 0) {
+            roc_panic("huge page arena: unpaired deallocate");
+        }
+        num_parent_chunks_--;
+
+        return;
+    }
+
+    const ChunkHeader* chunk =
+        (const ChunkHeader*)((char*)ptr - AlignOps::align_max(sizeof(ChunkHeader)));
+    MemoryOps::poison_after_use(ptr, chunk->size);
+
+    Mutex::Lock lock(mutex_);
+
+    if (num_region_chunks_ == 0) {
+        roc_panic("huge page arena: unpaired deallocate");
+    }
+    num_region_chunks_--;
+
+    if (num_region_chunks_ == 0) {
+        // Last chunk returned, whole mapping can be reused.
+        region_offset_ = 0;
+    }
+}
+
+size_t HugePageArena::compute_allocated_size(size_t size) const {
+    if (!region_) {
+        return parent_arena_.compute_allocated_size(size);
+    }
+
+    return AlignOps::align_max(sizeof(ChunkHeader)) + AlignOps::align_max(size);
+}
+
+size_t HugePageArena::allocated_size(void* ptr) const {
+    if (!ptr) {
+        roc_panic("huge page arena: null pointer");
+    }
+
+    if (!owns_(ptr)) {
+        return parent_arena_.allocated_size(ptr);
+    }
+
+    const ChunkHeader* chunk =
+        (const ChunkHeader*)((char*)ptr - AlignOps::align_max(sizeof(ChunkHeader)));
+
+    return AlignOps::align_max(sizeof(ChunkHeader)) + AlignOps::align_max(chunk->size);
+}
+
+bool HugePageArena::reserve_(size_t size) {
+    void* addr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED) {
+        huge_pages_ = true;
+    } else {
+        roc_log(LogDebug,
+                "huge page arena: can't map huge pages, falling back to regular"
+                " pages: size=%lu error=%s",
+                (unsigned long)size, errno_to_str(errno).c_str());
+    }
+#endif
+
+    if (addr == MAP_FAILED) {
+        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+        if (addr == MAP_FAILED) {
+            roc_log(LogError, "huge page arena: mmap(): size=%lu error=%s",
+                    (unsigned long)size, errno_to_str(errno).c_str());
+            return false;
+        }
+
+#if defined(MADV_HUGEPAGE)
+        if (madvise(addr, size, MADV_HUGEPAGE) != 0) {
+            roc_log(LogDebug, "huge page arena: madvise(MADV_HUGEPAGE): error=%s",
+                    errno_to_str(errno).c_str());
+        }
+#endif
+    }
+
+    region_ = (char*)addr;
+    region_size_ = size;
+
+    if (mlock(region_, region_size_) == 0) {
+        locked_ = true;
+    } else {
+        roc_log(LogInfo, "huge page arena: can't lock memory: size=%lu error=%s",
+                (unsigned long)region_size_, errno_to_str(errno).c_str());
+    }
+
+    // Touch every page, in case memory wasn't locked (mlock() faults pages
+    // in by itself), so that first allocations don't cause page faults.
+    for (size_t off = 0; off < region_size_; off += 4096) {
+        region_[off] = 0;
+    }
+
+    return true;
+}
+
+void HugePageArena::release_() {
+    if (!region_) {
+        return;
+    }
+
+    if (locked_ && munlock(region_, region_size_) != 0) {
+        roc_log(LogError, "huge page arena: munlock(): error=%s",
+                errno_to_str(errno).c_str());
+    }
+
+    if (munmap(region_, region_size_) != 0) {
+        roc_log(LogError, "huge page arena: munmap(): error=%s",
+                errno_to_str(errno).c_str());
+    }
+
+    region_ = NULL;
+}
+
+bool HugePageArena::owns_(const void* ptr) const {
+    return region_ && (const char*)ptr >= region_
+        && (const char*)ptr < region_ + region_size_;
+}
+
+} // namespace core
+} // namespace roc
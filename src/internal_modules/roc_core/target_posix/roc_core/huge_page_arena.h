@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/huge_page_arena.h
+//! @brief Huge-page backed arena.
+
+#ifndef ROC_CORE_HUGE_PAGE_ARENA_H_
+#define ROC_CORE_HUGE_PAGE_ARENA_H_
+
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Huge-page backed arena.
+//!
+//! Reserves one memory mapping of given size when constructed, and serves
+//! allocations from it by advancing an offset. When all chunks are returned,
+//! the mapping is rewound and becomes available again. If mapping has not
+//! enough space left, allocation is forwarded to parent arena.
+//!
+//! The mapping is backed by huge pages (MAP_HUGETLB) if the system has them
+//! reserved, and otherwise by regular pages with transparent huge pages
+//! enabled (MADV_HUGEPAGE). It is locked in memory and prefaulted during
+//! construction, so pools created on top of the arena don't cause page faults
+//! and TLB pressure when their slabs grow.
+//!
+//! Failure to lock memory (e.g. because of RLIMIT_MEMLOCK) is not fatal and
+//! is only logged.
+//!
+//! If reserve size is zero, the arena just forwards allocations to parent.
+//!
+//! The memory is always maximum aligned.
+//!
+//! Thread-safe.
+class HugePageArena : public IArena, public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Reserves @p reserve_size bytes, rounded up to huge page size.
+    HugePageArena(IArena& parent_arena, size_t reserve_size);
+    ~HugePageArena();
+
+    //! Check if memory was successfully reserved.
+    bool is_valid() const;
+
+    //! Get number of reserved bytes.
+    size_t reserved_size() const;
+
+    //! Check if reserved memory is backed by explicit huge pages.
+    //! @remarks
+    //!  If false, memory is backed by regular pages and relies on transparent
+    //!  huge pages, if they're enabled in the system.
+    bool has_huge_pages() const;
+
+    //! Check if reserved memory is locked.
+    bool is_locked() const;
+
+    //! Get number of allocated chunks, including forwarded to parent arena.
+    size_t num_allocations() const;
+
+    //! Get number of bytes currently occupied in reserved memory.
+    size_t num_used_bytes() const;
+
+    //! Get number of allocations forwarded to parent arena because reserved
+    //! memory was exhausted.
+    size_t num_fallbacks() const;
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void* ptr);
+
+    //! Computes how many bytes will be actually allocated if allocate() is called with
+    //! given size. Covers all internal overhead, if any.
+    virtual size_t compute_allocated_size(size_t size) const;
+
+    //! Returns how many bytes was allocated for given pointer returned by allocate().
+    //! Covers all internal overhead, if any.
+    virtual size_t allocated_size(void* ptr) const;
+
+private:
+    struct ChunkHeader {
+        size_t size;
+    };
+
+    bool reserve_(size_t size);
+    void release_();
+
+    bool owns_(const void* ptr) const;
+
+    IArena& parent_arena_;
+
+    char* region_;
+    size_t region_size_;
+    size_t region_offset_;
+
+    bool huge_pages_;
+    bool locked_;
+
+    size_t num_region_chunks_;
+    size_t num_parent_chunks_;
+    size_t num_fallbacks_;
+
+    bool valid_;
+
+    mutable Mutex mutex_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_HUGE_PAGE_ARENA_H_
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/mapped_file.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// Mapping of a growing file is extended by at least this size,
+// and at most by this size at once, to avoid both frequent remaps
+// and excessive disk reservation.
+const size_t MinGrowth = 1024 * 1024;
+const size_t MaxGrowth = 256 * 1024 * 1024;
+
+} // namespace
+
+MappedFile::MappedFile()
+    : fd_(-1)
+    , writable_(false)
+    , data_(NULL)
+    , size_(0)
+    , capacity_(0) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open_read(const char* path) {
+    roc_panic_if(!path);
+
+    if (fd_ >= 0) {
+        roc_panic("mapped file: already opened");
+    }
+
+    int fd = -1;
+    while ((fd = ::open(path, O_RDONLY)) == -1 && errno == EINTR) {
+    }
+
+    if (fd == -1) {
+        roc_log(LogDebug, "mapped file: open(): %s", errno_to_str(errno).c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        roc_log(LogDebug, "mapped file: not a regular file: path=%s", path);
+        (void)::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    writable_ = false;
+
+    if (st.st_size == 0) {
+        return true;
+    }
+
+    if (!remap_((size_t)st.st_size)) {
+        close();
+        return false;
+    }
+
+    size_ = (size_t)st.st_size;
+
+    if (madvise(data_, capacity_, MADV_SEQUENTIAL) == -1) {
+        roc_log(LogDebug, "mapped file: madvise(): %s", errno_to_str(errno).c_str());
+    }
+
+    return true;
+}
+
+bool MappedFile::open_write(const char* path) {
+    roc_panic_if(!path);
+
+    if (fd_ >= 0) {
+        roc_panic("mapped file: already opened");
+    }
+
+    int fd = -1;
+    while ((fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1
+           && errno == EINTR) {
+    }
+
+    if (fd == -1) {
+        roc_log(LogDebug, "mapped file: open(): %s", errno_to_str(errno).c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        roc_log(LogDebug, "mapped file: not a regular file: path=%s", path);
+        (void)::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    writable_ = true;
+
+    return true;
+}
+
+bool MappedFile::close() {
+    if (fd_ < 0) {
+        return true;
+    }
+
+    bool ok = true;
+
+    if (data_) {
+        if (munmap(data_, capacity_) == -1) {
+            roc_log(LogError, "mapped file: munmap(): %s", errno_to_str(errno).c_str());
+            ok = false;
+        }
+    }
+
+    if (writable_ && capacity_ != size_) {
+        if (ftruncate(fd_, (off_t)size_) == -1) {
+            roc_log(LogError, "mapped file: ftruncate(): %s",
+                    errno_to_str(errno).c_str());
+            ok = false;
+        }
+    }
+
+    if (::close(fd_) == -1) {
+        roc_log(LogError, "mapped file: close(): %s", errno_to_str(errno).c_str());
+        ok = false;
+    }
+
+    fd_ = -1;
+    writable_ = false;
+    data_ = NULL;
+    size_ = 0;
+    capacity_ = 0;
+
+    return ok;
+}
+
+bool MappedFile::is_opened() const {
+    return fd_ >= 0;
+}
+
+uint8_t* MappedFile::data() const {
+    return data_;
+}
+
+size_t MappedFile::size() const {
+    return size_;
+}
+
+size_t MappedFile::capacity() const {
+    return capacity_;
+}
+
+bool MappedFile::reserve(size_t size) {
+    roc_panic_if_msg(!writable_, "mapped file: reserve() requires write mode");
+
+    if (size <= capacity_) {
+        return true;
+    }
+
+    size_t new_capacity = capacity_;
+    while (new_capacity < size) {
+        size_t growth = new_capacity;
+        if (growth < MinGrowth) {
+            growth = MinGrowth;
+        }
+        if (growth > MaxGrowth) {
+            growth = MaxGrowth;
+        }
+        new_capacity += growth;
+    }
+
+    if (ftruncate(fd_, (off_t)new_capacity) == -1) {
+        roc_log(LogError, "mapped file: ftruncate(): %s", errno_to_str(errno).c_str());
+        return false;
+    }
+
+    return remap_(new_capacity);
+}
+
+void MappedFile::resize(size_t size) {
+    roc_panic_if_msg(!writable_, "mapped file: resize() requires write mode");
+
+    if (size > capacity_) {
+        roc_panic("mapped file: size exceeds capacity: size=%lu capacity=%lu",
+                  (unsigned long)size, (unsigned long)capacity_);
+    }
+
+    size_ = size;
+}
+
+bool MappedFile::remap_(size_t capacity) {
+    if (data_) {
+        if (munmap(data_, capacity_) == -1) {
+            roc_log(LogError, "mapped file: munmap(): %s", errno_to_str(errno).c_str());
+        }
+        data_ = NULL;
+        capacity_ = 0;
+    }
+
+    const int prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+
+    void* data = mmap(NULL, capacity, prot, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        roc_log(LogError, "mapped file: mmap(): size=%lu: %s", (unsigned long)capacity,
+                errno_to_str(errno).c_str());
+        return false;
+    }
+
+    data_ = (uint8_t*)data;
+    capacity_ = capacity;
+
+    return true;
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/mapped_file.h
+//! @brief Memory-mapped file.
+
+#ifndef ROC_CORE_MAPPED_FILE_H_
+#define ROC_CORE_MAPPED_FILE_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Memory-mapped file.
+//! @remarks
+//!  In read mode, the whole file is mapped read-only and kernel is advised
+//!  that it will be accessed sequentially.
+//!  In write mode, the file is extended and remapped in large chunks by
+//!  reserve(), and truncated to size() on close().
+//!  Only regular files can be mapped.
+class MappedFile : public NonCopyable<> {
+public:
+    //! Initialize closed file.
+    MappedFile();
+
+    //! Unmap and close file.
+    ~MappedFile();
+
+    //! Map existing file for reading.
+    bool open_read(const char* path);
+
+    //! Create or truncate file and map it for writing.
+    bool open_write(const char* path);
+
+    //! Unmap and close file.
+    //! @remarks
+    //!  In write mode, truncates file to size().
+    bool close();
+
+    //! Check if file is opened.
+    bool is_opened() const;
+
+    //! Get pointer to mapped data.
+    uint8_t* data() const;
+
+    //! Get size of file contents.
+    size_t size() const;
+
+    //! Get size of mapping.
+    size_t capacity() const;
+
+    //! Ensure that mapping can hold at least @p size bytes.
+    //! @remarks
+    //!  Write mode only. Pointer returned by data() may change.
+    bool reserve(size_t size);
+
+    //! Set size of file contents.
+    //! @remarks
+    //!  Write mode only. @p size should not exceed capacity().
+    void resize(size_t size);
+
+private:
+    bool remap_(size_t capacity);
+
+    int fd_;
+    bool writable_;
+
+    uint8_t* data_;
+    size_t size_;
+    size_t capacity_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_MAPPED_FILE_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/memory_lock.h"
+#include "roc_core/mutex.h"
+#include "roc_core/panic.h"
+#include "roc_core/singleton.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+struct MemoryLockState {
+    Mutex mutex;
+    size_t users;
+
+    MemoryLockState()
+        : users(0) {
+    }
+};
+
+MemoryLockState& lock_state() {
+    return Singleton<MemoryLockState>::instance();
+}
+
+} // namespace
+
+bool MemoryLock::acquire() {
+    MemoryLockState& state = lock_state();
+
+    Mutex::Lock lock(state.mutex);
+
+    if (state.users == 0) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            roc_log(LogError, "memory lock: mlockall(): %s",
+                    errno_to_str(errno).c_str());
+            return false;
+        }
+
+        roc_log(LogDebug, "memory lock: locked process memory");
+    }
+
+    state.users++;
+
+    return true;
+}
+
+void MemoryLock::release() {
+    MemoryLockState& state = lock_state();
+
+    Mutex::Lock lock(state.mutex);
+
+    if (state.users == 0) {
+        roc_panic("memory lock: unpaired release");
+    }
+
+    if (--state.users != 0) {
+        return;
+    }
+
+    if (munlockall() != 0) {
+        roc_log(LogError, "memory lock: munlockall(): %s", errno_to_str(errno).c_str());
+        return;
+    }
+
+    roc_log(LogDebug, "memory lock: unlocked process memory");
+}
+
+bool MemoryLock::get_page_faults(PageFaults& faults) {
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        roc_log(LogError, "memory lock: getrusage(): %s", errno_to_str(errno).c_str());
+        return false;
+    }
+
+    faults.minor = (uint64_t)usage.ru_minflt;
+    faults.major = (uint64_t)usage.ru_majflt;
+
+    return true;
+}
+
+} // namespace core
+} // namespace roc
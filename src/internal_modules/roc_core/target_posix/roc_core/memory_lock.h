@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/memory_lock.h
+//! @brief Process memory lock.
+
+#ifndef ROC_CORE_MEMORY_LOCK_H_
+#define ROC_CORE_MEMORY_LOCK_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Number of page faults of process.
+struct PageFaults {
+    //! Faults resolved without I/O, e.g. first touch of a page.
+    uint64_t minor;
+
+    //! Faults which required I/O, e.g. access to a page swapped out.
+    uint64_t major;
+
+    PageFaults()
+        : minor(0)
+        , major(0) {
+    }
+};
+
+//! Process memory lock.
+//!
+//! Locks all current and future pages of process in RAM using mlockall(),
+//! so that they are never swapped out, and so that new mappings (e.g. stacks
+//! of new threads and slabs of growing pools) are populated when created,
+//! instead of on first touch.
+//!
+//! Lock is process-wide and reference-counted: it's applied by first
+//! acquire() and removed by last release().
+class MemoryLock : public NonCopyable<> {
+public:
+    //! Lock process memory.
+    //! @returns
+    //!  false if memory can't be locked, e.g. because of RLIMIT_MEMLOCK.
+    ROC_ATTR_NODISCARD static bool acquire();
+
+    //! Unlock process memory, if there are no more users.
+    static void release();
+
+    //! Get page faults of process since its start.
+    ROC_ATTR_NODISCARD static bool get_page_faults(PageFaults& faults);
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_MEMORY_LOCK_H_
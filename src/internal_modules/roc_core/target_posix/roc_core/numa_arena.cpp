@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/numa_arena.h"
+#include "roc_core/panic.h"
+#include "roc_core/parse_units.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+#define ROC_CORE_HAS_MBIND
+#endif
+
+#if defined(__linux__) && !defined(__ANDROID__)
+bool read_node_cpus(size_t node, uint64_t& cpu_mask) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu/cpulist",
+             (unsigned long)node);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        roc_log(LogError, "numa arena: can't open %s: %s", path,
+                errno_to_str(errno).c_str());
+        return false;
+    }
+
+    char buf[256] = {};
+    const bool ok = fgets(buf, sizeof(buf), fp) != NULL;
+    fclose(fp);
+
+    if (!ok) {
+        roc_log(LogError, "numa arena: can't read %s", path);
+        return false;
+    }
+
+    for (size_t n = 0; buf[n]; n++) {
+        if (buf[n] == '\n') {
+            buf[n] = '\0';
+            break;
+        }
+    }
+
+    // Some nodes have memory but no CPUs; the file is empty then.
+    if (!buf[0]) {
+        cpu_mask = 0;
+        return true;
+    }
+
+    if (!parse_cpu_list(buf, cpu_mask)) {
+        roc_log(LogError, "numa arena: can't parse cpu list of node %lu: \"%s\"",
+                (unsigned long)node, buf);
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+} // namespace
+
+NumaArena::NumaArena(IArena& parent_arena, uint64_t node_mask)
+    : parent_arena_(parent_arena)
+    , node_mask_(node_mask)
+    , cpu_mask_(0)
+    , page_size_(0)
+    , valid_(false) {
+    if (node_mask_ == 0) {
+        valid_ = true;
+        return;
+    }
+
+    if (!get_node_cpus(node_mask_, cpu_mask_)) {
+        return;
+    }
+
+    if (cpu_mask_ == 0) {
+        roc_log(LogError, "numa arena: nodes have no cpus: node_mask=0x%llx",
+                (unsigned long long)node_mask_);
+        return;
+    }
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    page_size_ = page_size > 0 ? (size_t)page_size : 4096;
+
+    roc_log(LogDebug, "numa arena: initialized: node_mask=0x%llx cpu_mask=0x%llx",
+            (unsigned long long)node_mask_, (unsigned long long)cpu_mask_);
+
+    valid_ = true;
+}
+
+bool NumaArena::is_valid() const {
+    return valid_;
+}
+
+uint64_t NumaArena::node_mask() const {
+    return node_mask_;
+}
+
+uint64_t NumaArena::cpu_mask() const {
+    return cpu_mask_;
+}
+
+void* NumaArena::allocate(size_t size) {
+    void* ptr = parent_arena_.allocate(size);
+
+    if (ptr && valid_ && node_mask_ != 0) {
+        bind_(ptr, size);
+    }
+
+    return ptr;
+}
+
+void NumaArena::deallocate(void* ptr) {
+    parent_arena_.deallocate(ptr);
+}
+
+size_t NumaArena::compute_allocated_size(size_t size) const {
+    return parent_arena_.compute_allocated_size(size);
+}
+
+size_t NumaArena::allocated_size(void* ptr) const {
+    return parent_arena_.allocated_size(ptr);
+}
+
+bool NumaArena::get_node_cpus(uint64_t node_mask, uint64_t& cpu_mask) {
+    cpu_mask = 0;
+
+#if defined(__linux__) && !defined(__ANDROID__)
+    for (size_t node = 0; node < 64; node++) {
+        if (!(node_mask & ((uint64_t)1 << node))) {
+            continue;
+        }
+
+        uint64_t node_cpus = 0;
+        if (!read_node_cpus(node, node_cpus)) {
+            return false;
+        }
+
+        cpu_mask |= node_cpus;
+    }
+
+    return true;
+#else
+    (void)node_mask;
+
+    roc_log(LogError, "numa arena: numa nodes not supported on this platform");
+    return false;
+#endif
+}
+
+void NumaArena::bind_(void* ptr, size_t size) {
+#if defined(ROC_CORE_HAS_MBIND)
+    // mbind() works on whole pages, so only pages fully covered by the chunk
+    // are bound; the rest may be shared with other chunks.
+    const uintptr_t begin = ((uintptr_t)ptr + page_size_ - 1) & ~(page_size_ - 1);
+    const uintptr_t end = ((uintptr_t)ptr + size) & ~(page_size_ - 1);
+
+    if (begin >= end) {
+        return;
+    }
+
+    const int mode = (node_mask_ & (node_mask_ - 1)) ? MPOL_INTERLEAVE : MPOL_PREFERRED;
+    const unsigned long nodes = (unsigned long)node_mask_;
+
+    if (syscall(SYS_mbind, (void*)begin, (unsigned long)(end - begin), mode, &nodes,
+                (unsigned long)sizeof(nodes) * 8 + 1, (unsigned)MPOL_MF_MOVE)
+        != 0) {
+        roc_log(LogDebug, "numa arena: mbind() failed: size=%lu error=%s",
+                (unsigned long)(end - begin), errno_to_str(errno).c_str());
+    }
+#else
+    (void)ptr;
+    (void)size;
+#endif
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/numa_arena.h
+//! @brief NUMA-bound arena.
+
+#ifndef ROC_CORE_NUMA_ARENA_H_
+#define ROC_CORE_NUMA_ARENA_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! NUMA-bound arena.
+//!
+//! Forwards allocations to parent arena and asks the kernel to place pages of
+//! every allocated chunk on given set of NUMA nodes. Pools created on top of
+//! this arena get their slabs on these nodes regardless of which thread first
+//! touches the memory.
+//!
+//! If one node is specified, pages are preferably placed on that node. If many
+//! nodes are specified, pages are interleaved between them. Binding is best
+//! effort: only pages fully covered by a chunk are bound, and failures are
+//! logged and ignored.
+//!
+//! If node mask is zero, the arena just forwards allocations to parent.
+//!
+//! Supported only on Linux.
+//!
+//! Thread-safe.
+class NumaArena : public IArena, public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  N-th bit of @p node_mask corresponds to N-th NUMA node.
+    NumaArena(IArena& parent_arena, uint64_t node_mask);
+
+    //! Check if node mask was successfully resolved.
+    //! @remarks
+    //!  Returns false if node mask is non-zero, and NUMA is not supported on
+    //!  this platform, or some of the nodes don't exist or have no CPUs.
+    bool is_valid() const;
+
+    //! Get mask of NUMA nodes.
+    uint64_t node_mask() const;
+
+    //! Get mask of CPUs belonging to NUMA nodes.
+    //! @remarks
+    //!  N-th bit corresponds to N-th CPU. Zero if node mask is zero.
+    uint64_t cpu_mask() const;
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void* ptr);
+
+    //! Computes how many bytes will be actually allocated if allocate() is called with
+    //! given size. Covers all internal overhead, if any.
+    virtual size_t compute_allocated_size(size_t size) const;
+
+    //! Returns how many bytes was allocated for given pointer returned by allocate().
+    //! Covers all internal overhead, if any.
+    virtual size_t allocated_size(void* ptr) const;
+
+    //! Get mask of CPUs belonging to given NUMA nodes.
+    //! @remarks
+    //!  Reads node topology from sysfs. Only first 64 CPUs and nodes are
+    //!  supported.
+    //! @returns
+    //!  false if NUMA is not supported or some of the nodes don't exist.
+    ROC_ATTR_NODISCARD static bool get_node_cpus(uint64_t node_mask,
+                                                 uint64_t& cpu_mask);
+
+private:
+    void bind_(void* ptr, size_t size);
+
+    IArena& parent_arena_;
+
+    const uint64_t node_mask_;
+    uint64_t cpu_mask_;
+    size_t page_size_;
+
+    bool valid_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_NUMA_ARENA_H_
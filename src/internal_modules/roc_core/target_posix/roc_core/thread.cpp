@@ -24,6 +24,37 @@
 namespace roc {
 namespace core {
 
+namespace {
+
+#if defined(__linux__) && !defined(__ANDROID__)
+void make_cpu_set(uint64_t cpu_mask, cpu_set_t& cpu_set) {
+    CPU_ZERO(&cpu_set);
+
+    for (size_t cpu = 0; cpu < 64; cpu++) {
+        if (cpu_mask & ((uint64_t)1 << cpu)) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+}
+#endif
+
+// Writes one page-sized chunk of stack and recurses for the rest.
+// Touching chunk after recursive call prevents tail call optimization.
+void touch_stack(size_t size) {
+    volatile uint8_t chunk[4096];
+
+    chunk[0] = 0;
+    chunk[sizeof(chunk) - 1] = 0;
+
+    if (size > sizeof(chunk)) {
+        touch_stack(size - sizeof(chunk));
+    }
+
+    chunk[0] = chunk[sizeof(chunk) - 1];
+}
+
+} // namespace
+
 uint64_t Thread::get_pid() {
     return (uint64_t)getpid();
 }
@@ -46,6 +77,10 @@ uint64_t Thread::get_tid() {
 #endif
 }
 
+uint64_t Thread::get_opaque_tid() {
+    return (uint64_t)(uintptr_t)pthread_self();
+}
+
 bool Thread::enable_realtime() {
     sched_param param;
     memset(&param, 0, sizeof(param));
@@ -61,11 +96,60 @@ bool Thread::enable_realtime() {
     return true;
 }
 
+bool Thread::configure_current(const ThreadConfig& config) {
+    if (config.cpu_mask != 0) {
+#if defined(__linux__) && !defined(__ANDROID__)
+        cpu_set_t cpu_set;
+        make_cpu_set(config.cpu_mask, cpu_set);
+
+        if (int err =
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)) {
+            roc_log(LogError, "thread: can't set cpu affinity: %s",
+                    errno_to_str(err).c_str());
+            return false;
+        }
+#else
+        roc_log(LogError, "thread: cpu affinity is not supported on this platform");
+        return false;
+#endif
+    }
+
+    if (config.policy != ThreadPolicy_Default) {
+        int sched_policy = 0;
+        sched_param param;
+        if (!make_sched_param_(config, sched_policy, param)) {
+            return false;
+        }
+
+        if (int err = pthread_setschedparam(pthread_self(), sched_policy, &param)) {
+            roc_log(LogError, "thread: can't set scheduling policy: %s",
+                    errno_to_str(err).c_str());
+            return false;
+        }
+    }
+
+    if (config.prefault_stack != 0) {
+        prefault_stack(config.prefault_stack);
+    }
+
+    return true;
+}
+
+void Thread::prefault_stack(size_t size) {
+    touch_stack(size);
+}
+
 Thread::Thread()
     : started_(0)
     , joinable_(0) {
 }
 
+Thread::Thread(const ThreadConfig& config)
+    : config_(config)
+    , started_(0)
+    , joinable_(0) {
+}
+
 Thread::~Thread() {
     if (is_joinable()) {
         roc_panic("thread: thread was not joined before calling destructor");
@@ -84,7 +168,23 @@ bool Thread::start() {
         return false;
     }
 
-    if (int err = pthread_create(&thread_, NULL, &Thread::thread_runner_, this)) {
+    pthread_attr_t attr;
+    pthread_attr_t* attr_ptr = NULL;
+
+    if (!is_default_config_(config_)) {
+        if (!make_attr_(config_, attr)) {
+            return false;
+        }
+        attr_ptr = &attr;
+    }
+
+    const int err = pthread_create(&thread_, attr_ptr, &Thread::thread_runner_, this);
+
+    if (attr_ptr) {
+        pthread_attr_destroy(attr_ptr);
+    }
+
+    if (err != 0) {
         roc_log(LogError, "thread: pthread_thread_create(): %s",
                 errno_to_str(err).c_str());
         return false;
@@ -111,9 +211,99 @@ void Thread::join() {
 }
 
 void* Thread::thread_runner_(void* ptr) {
-    static_cast<Thread*>(ptr)->run();
+    Thread* self = static_cast<Thread*>(ptr);
+
+    if (self->config_.prefault_stack != 0) {
+        prefault_stack(self->config_.prefault_stack);
+    }
+
+    self->run();
     return NULL;
 }
 
+bool Thread::is_default_config_(const ThreadConfig& config) {
+    return config.cpu_mask == 0 && config.policy == ThreadPolicy_Default;
+}
+
+bool Thread::make_sched_param_(const ThreadConfig& config,
+                               int& sched_policy,
+                               sched_param& param) {
+    switch (config.policy) {
+    case ThreadPolicy_Fifo:
+        sched_policy = SCHED_FIFO;
+        break;
+    case ThreadPolicy_RoundRobin:
+        sched_policy = SCHED_RR;
+        break;
+    default:
+        roc_panic("thread: unexpected scheduling policy %d", (int)config.policy);
+    }
+
+    const int min_priority = sched_get_priority_min(sched_policy);
+    const int max_priority = sched_get_priority_max(sched_policy);
+
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = config.priority != 0 ? config.priority : max_priority;
+
+    if (param.sched_priority < min_priority || param.sched_priority > max_priority) {
+        roc_log(LogError,
+                "thread: invalid scheduling priority: priority=%d min=%d max=%d",
+                param.sched_priority, min_priority, max_priority);
+        return false;
+    }
+
+    return true;
+}
+
+bool Thread::make_attr_(const ThreadConfig& config, pthread_attr_t& attr) {
+    if (int err = pthread_attr_init(&attr)) {
+        roc_log(LogError, "thread: pthread_attr_init(): %s", errno_to_str(err).c_str());
+        return false;
+    }
+
+    if (config.cpu_mask != 0) {
+#if defined(__linux__) && !defined(__ANDROID__)
+        cpu_set_t cpu_set;
+        make_cpu_set(config.cpu_mask, cpu_set);
+
+        if (int err = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set), &cpu_set)) {
+            roc_log(LogError, "thread: can't set cpu affinity: %s",
+                    errno_to_str(err).c_str());
+            pthread_attr_destroy(&attr);
+            return false;
+        }
+#else
+        roc_log(LogError, "thread: cpu affinity is not supported on this platform");
+        pthread_attr_destroy(&attr);
+        return false;
+#endif
+    }
+
+    if (config.policy != ThreadPolicy_Default) {
+        int sched_policy = 0;
+        sched_param param;
+        if (!make_sched_param_(config, sched_policy, param)) {
+            pthread_attr_destroy(&attr);
+            return false;
+        }
+
+        int err = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        if (err == 0) {
+            err = pthread_attr_setschedpolicy(&attr, sched_policy);
+        }
+        if (err == 0) {
+            err = pthread_attr_setschedparam(&attr, &param);
+        }
+        if (err != 0) {
+            roc_log(LogError, "thread: can't set scheduling policy: %s",
+                    errno_to_str(err).c_str());
+            pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 } // namespace core
 } // namespace roc
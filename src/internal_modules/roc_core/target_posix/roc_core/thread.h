@@ -13,6 +13,7 @@
 #define ROC_CORE_THREAD_H_
 
 #include <pthread.h>
+#include <sched.h>
 
 #include "roc_core/atomic.h"
 #include "roc_core/attributes.h"
@@ -23,6 +24,50 @@
 namespace roc {
 namespace core {
 
+//! Thread scheduling policy.
+enum ThreadPolicy {
+    //! Inherit scheduling policy from creating thread.
+    ThreadPolicy_Default,
+
+    //! Realtime first-in first-out policy (SCHED_FIFO).
+    ThreadPolicy_Fifo,
+
+    //! Realtime round-robin policy (SCHED_RR).
+    ThreadPolicy_RoundRobin
+};
+
+//! Thread scheduling parameters.
+struct ThreadConfig {
+    //! Mask of CPUs on which thread is allowed to run.
+    //! @remarks
+    //!  N-th bit corresponds to N-th CPU.
+    //!  If zero, thread is not pinned to any CPU.
+    uint64_t cpu_mask;
+
+    //! Scheduling policy.
+    ThreadPolicy policy;
+
+    //! Scheduling priority.
+    //! @remarks
+    //!  Used only with realtime policies.
+    //!  If zero, maximum priority for the policy is used.
+    int priority;
+
+    //! Number of bytes of stack to touch when thread starts.
+    //! @remarks
+    //!  Maps stack pages in advance, so that deep calls in thread don't cause
+    //!  page faults later. Should be less than stack size of thread.
+    //!  If zero, stack is not prefaulted.
+    size_t prefault_stack;
+
+    ThreadConfig()
+        : cpu_mask(0)
+        , policy(ThreadPolicy_Default)
+        , priority(0)
+        , prefault_stack(0) {
+    }
+};
+
 //! Base class for thread objects.
 class Thread : public NonCopyable<Thread> {
 public:
@@ -32,9 +77,25 @@ public:
     //! Get numeric identifier of current thread.
     static uint64_t get_tid();
 
+    //! Get opaque identifier of current thread.
+    //! @remarks
+    //!  Unlike get_tid(), doesn't perform system calls and is cheap enough to
+    //!  be used on hot paths. Identifier may be reused after thread exits.
+    static uint64_t get_opaque_tid();
+
     //! Raise current thread priority to realtime.
     ROC_ATTR_NODISCARD static bool enable_realtime();
 
+    //! Apply scheduling parameters to current thread.
+    //! @remarks
+    //!  Can be used for threads not created by Thread, e.g. main thread.
+    ROC_ATTR_NODISCARD static bool configure_current(const ThreadConfig& config);
+
+    //! Touch given number of bytes of current thread stack.
+    //! @remarks
+    //!  See ThreadConfig::prefault_stack.
+    static void prefault_stack(size_t size);
+
     //! Check if thread was started and can be joined.
     //! @returns
     //!  true if start() was called and join() was not called yet.
@@ -42,7 +103,8 @@ public:
 
     //! Start thread.
     //! @remarks
-    //!  Executes run() in new thread.
+    //!  Executes run() in new thread. Fails if scheduling parameters passed
+    //!  to constructor can't be applied.
     ROC_ATTR_NODISCARD bool start();
 
     //! Join thread.
@@ -55,12 +117,23 @@ protected:
 
     Thread();
 
+    //! Initialize with given scheduling parameters.
+    explicit Thread(const ThreadConfig& config);
+
     //! Method to be executed in thread.
     virtual void run() = 0;
 
 private:
     static void* thread_runner_(void* ptr);
 
+    static bool is_default_config_(const ThreadConfig& config);
+    static bool make_sched_param_(const ThreadConfig& config,
+                                  int& sched_policy,
+                                  sched_param& param);
+    static bool make_attr_(const ThreadConfig& config, pthread_attr_t& attr);
+
+    const ThreadConfig config_;
+
     pthread_t thread_;
 
     int started_;
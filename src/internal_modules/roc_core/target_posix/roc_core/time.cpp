@@ -7,11 +7,16 @@
  */
 
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "roc_core/atomic_ops.h"
 #include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/time.h"
 
@@ -20,8 +25,83 @@ namespace core {
 
 namespace {
 
+// Serializes set_media_clock().
+pthread_mutex_t media_clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Current source of ClockMedia.
+// Written under media_clock_mutex, read without it.
+int media_clock_source = MediaClock_System;
+
 #if defined(CLOCK_REALTIME)
 
+// Clock id of current source of ClockMedia.
+// Written under media_clock_mutex, read without it.
+int media_clock_id = CLOCK_REALTIME;
+
+#if defined(__linux__)
+
+// Dynamic clock id of PTP clock device opened by file descriptor.
+// See "Dynamic POSIX clocks" in Linux kernel documentation.
+clockid_t fd_to_clockid(int fd) {
+    return clockid_t((~(unsigned int)fd << 3) | 3);
+}
+
+// PTP clock devices opened so far.
+// Descriptors are never closed, because other threads may still read
+// clock using previous id; repeated selection reuses descriptor.
+enum { MaxPtpDevices = 8 };
+
+struct PtpDevice {
+    char path[64];
+    int fd;
+};
+
+PtpDevice ptp_devices[MaxPtpDevices];
+size_t n_ptp_devices = 0;
+
+bool open_ptp_device(const char* path, clockid_t& clock_id) {
+    for (size_t n = 0; n < n_ptp_devices; n++) {
+        if (strcmp(ptp_devices[n].path, path) == 0) {
+            clock_id = fd_to_clockid(ptp_devices[n].fd);
+            return true;
+        }
+    }
+
+    if (strlen(path) >= sizeof(ptp_devices[0].path)) {
+        roc_log(LogError, "time: ptp device path too long: path=%s", path);
+        return false;
+    }
+
+    if (n_ptp_devices == MaxPtpDevices) {
+        roc_log(LogError, "time: too many ptp devices: max=%d", (int)MaxPtpDevices);
+        return false;
+    }
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        roc_log(LogError, "time: can't open ptp device: path=%s error=%s", path,
+                errno_to_str().c_str());
+        return false;
+    }
+
+    timespec ts;
+    if (clock_gettime(fd_to_clockid(fd), &ts) == -1) {
+        roc_log(LogError, "time: can't read ptp device: path=%s error=%s", path,
+                errno_to_str().c_str());
+        close(fd);
+        return false;
+    }
+
+    strcpy(ptp_devices[n_ptp_devices].path, path);
+    ptp_devices[n_ptp_devices].fd = fd;
+    n_ptp_devices++;
+
+    clock_id = fd_to_clockid(fd);
+    return true;
+}
+
+#endif // defined(__linux__)
+
 clockid_t map_clock(clock_t clock) {
     if (clock == ClockMonotonic) {
 #if defined(CLOCK_MONOTONIC)
@@ -29,13 +109,97 @@ clockid_t map_clock(clock_t clock) {
 #endif
     }
 
+    if (clock == ClockMedia) {
+        return (clockid_t)AtomicOps::load_relaxed(media_clock_id);
+    }
+
     return CLOCK_REALTIME;
 }
 
-#endif
+// Dynamic clocks don't support sleeping, so ClockMedia sleeps on
+// monotonic clock instead.
+clockid_t map_sleep_clock(clock_t clock) {
+    return map_clock(clock == ClockMedia ? ClockMonotonic : clock);
+}
+
+#endif // defined(CLOCK_REALTIME)
 
 } // namespace
 
+bool set_media_clock(MediaClockSource source, const char* ptp_device) {
+    pthread_mutex_lock(&media_clock_mutex);
+
+    bool ok = false;
+
+    switch (source) {
+    case MediaClock_System:
+#if defined(CLOCK_REALTIME)
+        AtomicOps::store_relaxed(media_clock_id, (int)CLOCK_REALTIME);
+#endif
+        ok = true;
+        break;
+
+    case MediaClock_Tai: {
+#if defined(__linux__) && defined(CLOCK_TAI)
+        timespec ts;
+        if (clock_gettime(CLOCK_TAI, &ts) == 0) {
+            AtomicOps::store_relaxed(media_clock_id, (int)CLOCK_TAI);
+            ok = true;
+        } else {
+            roc_log(LogError, "time: can't read tai clock: %s", errno_to_str().c_str());
+        }
+#else
+        roc_log(LogError, "time: tai clock not supported on this platform");
+#endif
+    } break;
+
+    case MediaClock_Ptp: {
+        if (!ptp_device || !*ptp_device) {
+            roc_log(LogError, "time: ptp device not specified");
+            break;
+        }
+#if defined(__linux__) && defined(CLOCK_REALTIME)
+        clockid_t clock_id = 0;
+        if (open_ptp_device(ptp_device, clock_id)) {
+            AtomicOps::store_relaxed(media_clock_id, (int)clock_id);
+            ok = true;
+        }
+#else
+        roc_log(LogError, "time: ptp clock not supported on this platform");
+#endif
+    } break;
+    }
+
+    if (ok) {
+        AtomicOps::store_relaxed(media_clock_source, (int)source);
+
+        roc_log(LogDebug, "time: selected media clock: source=%s device=%s",
+                media_clock_to_str(source),
+                source == MediaClock_Ptp ? ptp_device : "none");
+    }
+
+    pthread_mutex_unlock(&media_clock_mutex);
+
+    return ok;
+}
+
+MediaClockSource media_clock() {
+    return (MediaClockSource)AtomicOps::load_relaxed(media_clock_source);
+}
+
+const char* media_clock_to_str(MediaClockSource source) {
+    switch (source) {
+    case MediaClock_System:
+        return "system";
+    case MediaClock_Tai:
+        return "tai";
+    case MediaClock_Ptp:
+        return "ptp";
+    }
+
+    return "<invalid>";
+}
+
 #if defined(CLOCK_REALTIME)
 
 nanoseconds_t timestamp(clock_t clock) {
@@ -68,7 +232,7 @@ void sleep_for(clock_t clock, nanoseconds_t ns) {
     ts.tv_nsec = long(ns % 1000000000);
 
     int err;
-    while ((err = clock_nanosleep(map_clock(clock), 0, &ts, &ts))) {
+    while ((err = clock_nanosleep(map_sleep_clock(clock), 0, &ts, &ts))) {
         if (err != EINTR) {
             roc_panic("time: clock_nanosleep(): %s", errno_to_str(err).c_str());
         }
@@ -94,6 +258,14 @@ void sleep_for(clock_t, nanoseconds_t ns) {
 #if defined(CLOCK_REALTIME) && defined(TIMER_ABSTIME)
 
 void sleep_until(clock_t clock, nanoseconds_t ns) {
+    if (clock == ClockMedia) {
+        const nanoseconds_t now = timestamp(clock);
+        if (ns > now) {
+            sleep_for(clock, ns - now);
+        }
+        return;
+    }
+
     timespec ts;
     ts.tv_sec = time_t(ns / 1000000000);
     ts.tv_nsec = long(ns % 1000000000);
@@ -17,6 +17,37 @@
 namespace roc {
 namespace core {
 
+namespace {
+
+#if defined(__GLIBC__) && defined(CLOCK_MONOTONIC)                                       \
+    && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+
+// Deadline is already in CLOCK_MONOTONIC domain, wait on it directly.
+int sem_wait_until(sem_t* sem, nanoseconds_t deadline) {
+    timespec ts;
+    ts.tv_sec = time_t(deadline / Second);
+    ts.tv_nsec = long(deadline % Second);
+
+    return sem_clockwait(sem, CLOCK_MONOTONIC, &ts);
+}
+
+#else
+
+// sem_timedwait() expects deadline in CLOCK_REALTIME domain.
+int sem_wait_until(sem_t* sem, nanoseconds_t deadline) {
+    deadline += timestamp(ClockUnix) - timestamp(ClockMonotonic);
+
+    timespec ts;
+    ts.tv_sec = time_t(deadline / Second);
+    ts.tv_nsec = long(deadline % Second);
+
+    return sem_timedwait(sem, &ts);
+}
+
+#endif
+
+} // namespace
+
 Semaphore::Semaphore(unsigned counter)
     : guard_(0) {
     if (sem_init(&sem_, 0, counter) != 0) {
@@ -39,11 +70,7 @@ bool Semaphore::timed_wait(nanoseconds_t deadline) {
     }
 
     for (;;) {
-        timespec ts;
-        ts.tv_sec = long(deadline / Second);
-        ts.tv_nsec = long(deadline % Second);
-
-        if (sem_timedwait(&sem_, &ts) == 0) {
+        if (sem_wait_until(&sem_, deadline) == 0) {
             return true;
         }
 
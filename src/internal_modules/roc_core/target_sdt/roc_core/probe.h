@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_sdt/roc_core/probe.h
+//! @brief Static tracepoints.
+
+#ifndef ROC_CORE_PROBE_H_
+#define ROC_CORE_PROBE_H_
+
+#include <sys/sdt.h>
+
+//! Static tracepoint.
+//! @remarks
+//!  Defines SystemTap SDT probe with provider "roc" and given name, which can
+//!  be attached using perf, bpftrace, or SystemTap. Takes 1 to 12 integer
+//!  arguments. Until the probe is attached, it is a single nop instruction;
+//!  arguments are still evaluated, so they should be cheap to compute.
+#define roc_probe(name, ...) STAP_PROBEV(roc, name, __VA_ARGS__)
+
+#endif // ROC_CORE_PROBE_H_
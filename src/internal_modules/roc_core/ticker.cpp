@@ -7,12 +7,14 @@
  */
 
 #include "roc_core/ticker.h"
+#include "roc_core/cpu_instructions.h"
 
 namespace roc {
 namespace core {
 
-Ticker::Ticker(ticks_t freq)
+Ticker::Ticker(ticks_t freq, nanoseconds_t spin_window)
     : ratio_(double(freq) / Second)
+    , spin_window_(spin_window)
     , start_(0)
     , started_(false) {
 }
@@ -38,7 +40,36 @@ void Ticker::wait(ticks_t ticks) {
     if (!started_) {
         start();
     }
-    sleep_until(ClockMonotonic, start_ + nanoseconds_t(ticks / ratio_));
+
+    const nanoseconds_t deadline = start_ + nanoseconds_t(ticks / ratio_);
+
+    if (spin_window_ > 0) {
+        sleep_until(ClockMonotonic, deadline - spin_window_);
+    } else {
+        sleep_until(ClockMonotonic, deadline);
+    }
+
+    nanoseconds_t now = timestamp(ClockMonotonic);
+
+    if (spin_window_ > 0 && now < deadline) {
+        const nanoseconds_t spin_start = now;
+        while (now < deadline) {
+            cpu_relax();
+            now = timestamp(ClockMonotonic);
+        }
+        metrics_.total_spin_time += now - spin_start;
+    }
+
+    const nanoseconds_t lateness = now > deadline ? now - deadline : 0;
+
+    metrics_.wait_count++;
+    metrics_.last_lateness = lateness;
+    metrics_.max_lateness = std::max(metrics_.max_lateness, lateness);
+    metrics_.total_lateness += lateness;
+}
+
+const TickerMetrics& Ticker::metrics() const {
+    return metrics_;
 }
 
 } // namespace core
@@ -14,12 +14,52 @@
 
 #include "roc_core/noncopyable.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 #include "roc_core/time.h"
 
 namespace roc {
 namespace core {
 
+//! Ticker metrics.
+struct TickerMetrics {
+    //! Number of wait() calls.
+    uint64_t wait_count;
+
+    //! How late wait() returned relative to its deadline, last call.
+    //! Includes both scheduler wake-up delay and cases when caller is
+    //! behind schedule and wait() didn't block.
+    nanoseconds_t last_lateness;
+
+    //! Maximum lateness since start.
+    nanoseconds_t max_lateness;
+
+    //! Sum of lateness since start.
+    //! Divide by wait_count to get mean lateness.
+    nanoseconds_t total_lateness;
+
+    //! Total time spent in spin-wait since start.
+    nanoseconds_t total_spin_time;
+
+    TickerMetrics()
+        : wait_count(0)
+        , last_lateness(0)
+        , max_lateness(0)
+        , total_lateness(0)
+        , total_spin_time(0) {
+    }
+};
+
 //! Ticker.
+//!
+//! @remarks
+//!  Deadlines are computed from start time and number of ticks, so that
+//!  wake-up errors don't accumulate.
+//!
+//! @remarks
+//!  Sleeping typically oversleeps by tens or hundreds of microseconds. If
+//!  @p spin_window is non-zero, wait() sleeps until spin_window before the
+//!  deadline, and then busy-waits until the deadline. This trades up to
+//!  spin_window of CPU time per wait for much lower wake-up error.
 class Ticker : public NonCopyable<> {
 public:
     //! Number of ticks.
@@ -28,7 +68,8 @@ public:
     //! Initialize.
     //! @remarks
     //!  @p freq defines the number of ticks per second.
-    explicit Ticker(ticks_t freq);
+    //!  @p spin_window defines how long to busy-wait before deadline.
+    explicit Ticker(ticks_t freq, nanoseconds_t spin_window = 0);
 
     //! Start ticker.
     void start();
@@ -41,10 +82,16 @@ public:
     //! If ticker is not started yet, it is started automatically.
     void wait(ticks_t ticks);
 
+    //! Get metrics.
+    const TickerMetrics& metrics() const;
+
 private:
     const double ratio_;
+    const nanoseconds_t spin_window_;
     nanoseconds_t start_;
     bool started_;
+
+    TickerMetrics metrics_;
 };
 
 } // namespace core
@@ -12,6 +12,7 @@
 #ifndef ROC_CORE_TIME_H_
 #define ROC_CORE_TIME_H_
 
+#include "roc_core/attributes.h"
 #include "roc_core/stddefs.h"
 
 namespace roc {
@@ -51,7 +52,44 @@ enum clock_t {
     //! @note
     //!  Available on all platforms.
     //!  Actual precision is platform-dependent.
-    ClockUnix
+    ClockUnix,
+
+    //! Media clock.
+    //!
+    //! @remarks
+    //!  Clock used for capture and playback timestamps of audio frames and for
+    //!  timestamps exchanged in RTCP reports, i.e. for everything from which
+    //!  end-to-end latency is computed.
+    //!
+    //!  By default it is the same as ClockUnix. It can be switched to a more
+    //!  precise source using set_media_clock(), e.g. to PTP hardware clock
+    //!  of network card. Sender and receiver should use the same source,
+    //!  otherwise end-to-end latency is meaningless.
+    //!
+    //! @note
+    //!  Sleeping on this clock is performed using ClockMonotonic.
+    ClockMedia
+};
+
+//! Source of ClockMedia.
+enum MediaClockSource {
+    //! System real-time clock, same as ClockUnix.
+    MediaClock_System,
+
+    //! International Atomic Time.
+    //! @remarks
+    //!  Unlike ClockUnix, does not have leap seconds and is ahead of it by
+    //!  their number. When PTP daemon synchronizes system clock, this clock
+    //!  usually has the same precision as PTP.
+    //!  Supported only on Linux.
+    MediaClock_Tai,
+
+    //! PTP hardware clock of network interface (/dev/ptpN).
+    //! @remarks
+    //!  Read directly from network card, which is synchronized by PTP daemon
+    //!  with sub-microsecond precision. Usually runs in TAI timescale.
+    //!  Supported only on Linux.
+    MediaClock_Ptp
 };
 
 //! Nanoseconds.
@@ -91,6 +129,20 @@ void sleep_until(clock_t clock, nanoseconds_t timestamp);
 //!  @p duration specifies number of nanoseconds to sleep.
 void sleep_for(clock_t clock, nanoseconds_t duration);
 
+//! Select source of ClockMedia.
+//! @remarks
+//!  Affects the whole process. @p ptp_device is path to PTP clock device
+//!  (e.g. "/dev/ptp0") and is used only with MediaClock_Ptp.
+//!  Returns false if source is not supported on this platform or device
+//!  can't be opened; in this case previous source is kept.
+ROC_ATTR_NODISCARD bool set_media_clock(MediaClockSource source, const char* ptp_device);
+
+//! Get current source of ClockMedia.
+MediaClockSource media_clock();
+
+//! Get human-readable name of media clock source.
+const char* media_clock_to_str(MediaClockSource source);
+
 //! Convert timestamp in nanoseconds format to broken-down time.
 //! @note
 //!  std::tm has precision of one second.
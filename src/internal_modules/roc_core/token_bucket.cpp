@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/token_bucket.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+TokenBucket::TokenBucket(size_t rate, size_t burst)
+    : interval_(rate > 0 ? std::max(Second / nanoseconds_t(rate), nanoseconds_t(1))
+                         : 0)
+    , tolerance_(interval_ * nanoseconds_t(burst > 1 ? burst - 1 : 0))
+    , arrival_time_(0)
+    , started_(false)
+    , n_denied_(0) {
+    if (rate == 0) {
+        roc_panic("token bucket: expected positive rate");
+    }
+}
+
+bool TokenBucket::allow(nanoseconds_t now) {
+    if (!started_) {
+        arrival_time_ = now;
+        started_ = true;
+    }
+
+    // Event conforms if it's not earlier than its theoretical arrival time
+    // minus the time needed to accumulate the burst.
+    if (now < arrival_time_ - tolerance_) {
+        n_denied_++;
+        return false;
+    }
+
+    arrival_time_ = std::max(arrival_time_, now) + interval_;
+
+    return true;
+}
+
+uint64_t TokenBucket::num_denied() const {
+    return n_denied_;
+}
+
+} // namespace core
+} // namespace roc
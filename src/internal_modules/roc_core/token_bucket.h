@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/token_bucket.h
+//! @brief Token bucket.
+
+#ifndef ROC_CORE_TOKEN_BUCKET_H_
+#define ROC_CORE_TOKEN_BUCKET_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Token bucket.
+//!
+//! @remarks
+//!  Limits rate of events to given number per second, allowing bursts of
+//!  up to given number of events. Bucket starts full.
+//!
+//! @remarks
+//!  Implemented as generic cell rate algorithm: instead of refilling tokens,
+//!  bucket tracks theoretical time when next event would conform to the rate.
+//!  Each check is O(1) and uses only integer arithmetic.
+//!
+//! @remarks
+//!  Timestamps are provided by caller, so that one clock read can be shared
+//!  between several buckets.
+//!
+//! @note
+//!  Not thread-safe.
+class TokenBucket : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p rate defines number of events per second, should be positive.
+    //!  @p burst defines maximum number of events allowed at once; if it's
+    //!  zero, one event is allowed.
+    TokenBucket(size_t rate, size_t burst);
+
+    //! Check whether event is allowed to occur at given time.
+    //! @remarks
+    //!  If event is allowed, takes token from bucket.
+    //!  @p now is current time of monotonic clock.
+    bool allow(nanoseconds_t now);
+
+    //! Get number of events denied by allow().
+    uint64_t num_denied() const;
+
+private:
+    const nanoseconds_t interval_;
+    const nanoseconds_t tolerance_;
+
+    nanoseconds_t arrival_time_;
+    bool started_;
+
+    uint64_t n_denied_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_TOKEN_BUCKET_H_
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/worker_pool.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+#ifdef ROC_DEBUG_CHECKS
+
+namespace {
+
+// Registry of threads that are currently executing jobs, and identifiers of
+// those jobs. Each thread finds its own slot by its tid, so relaxed ordering
+// is enough.
+enum { MaxJobThreads = 64 };
+
+uint64_t job_threads[MaxJobThreads];
+uint64_t job_runs[MaxJobThreads];
+size_t job_indices[MaxJobThreads];
+int n_job_threads;
+uint64_t last_run_id;
+
+int enter_run(uint64_t run_id) {
+    const uint64_t tid = Thread::get_opaque_tid();
+
+    for (int n = 0; n < MaxJobThreads; n++) {
+        uint64_t exp_tid = 0;
+        if (AtomicOps::compare_exchange_relaxed(job_threads[n], exp_tid, tid)) {
+            AtomicOps::store_relaxed(job_runs[n], run_id);
+            AtomicOps::fetch_add_relaxed(n_job_threads, 1);
+            return n;
+        }
+    }
+
+    // Too many threads, run checks are disabled for this one.
+    return -1;
+}
+
+void enter_job(int slot, size_t job_index) {
+    if (slot < 0) {
+        return;
+    }
+
+    AtomicOps::store_relaxed(job_indices[slot], job_index);
+}
+
+void leave_run(int slot) {
+    if (slot < 0) {
+        return;
+    }
+
+    AtomicOps::fetch_sub_relaxed(n_job_threads, 1);
+    AtomicOps::store_relaxed(job_runs[slot], 0);
+    AtomicOps::store_relaxed(job_threads[slot], 0);
+}
+
+} // namespace
+
+bool WorkerPool::current_job(uint64_t& run_id, size_t& job_index) {
+    if (AtomicOps::load_relaxed(n_job_threads) == 0) {
+        return false;
+    }
+
+    const uint64_t tid = Thread::get_opaque_tid();
+
+    for (int n = 0; n < MaxJobThreads; n++) {
+        if (AtomicOps::load_relaxed(job_threads[n]) == tid) {
+            run_id = AtomicOps::load_relaxed(job_runs[n]);
+            job_index = AtomicOps::load_relaxed(job_indices[n]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // ROC_DEBUG_CHECKS
+
+WorkerPool::Worker::Worker(WorkerPool& pool)
+    : pool_(pool) {
+}
+
+void WorkerPool::Worker::wake_up() {
+    wake_sem_.post();
+}
+
+void WorkerPool::Worker::run() {
+    for (;;) {
+        wake_sem_.wait();
+
+        if (pool_.stop_) {
+            break;
+        }
+
+        pool_.process_jobs_();
+        pool_.done_sem_.post();
+    }
+}
+
+WorkerPool::WorkerPool(size_t n_threads, IArena& arena)
+    : arena_(arena)
+    , workers_(arena)
+    , job_(NULL)
+    , n_jobs_(0)
+    , next_job_(0)
+#ifdef ROC_DEBUG_CHECKS
+    , run_id_(0)
+#endif
+    , stop_(false)
+    , valid_(false) {
+    roc_log(LogDebug, "worker pool: initializing: n_threads=%lu",
+            (unsigned long)n_threads);
+
+    if (!workers_.grow(n_threads)) {
+        roc_log(LogError, "worker pool: can't allocate workers array");
+        return;
+    }
+
+    for (size_t n = 0; n < n_threads; n++) {
+        Worker* worker = new (arena_) Worker(*this);
+        if (!worker) {
+            roc_log(LogError, "worker pool: can't allocate worker");
+            return;
+        }
+
+        if (!workers_.push_back(worker)) {
+            roc_panic("worker pool: can't add worker to array");
+        }
+
+        if (!worker->start()) {
+            roc_log(LogError, "worker pool: can't start worker thread");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+WorkerPool::~WorkerPool() {
+    stop_workers_();
+}
+
+bool WorkerPool::is_valid() const {
+    return valid_;
+}
+
+size_t WorkerPool::num_threads() const {
+    return workers_.size();
+}
+
+void WorkerPool::run(IWorkerJob& job, size_t n_jobs) {
+    roc_panic_if(!valid_);
+
+    if (n_jobs == 0) {
+        return;
+    }
+
+    job_ = &job;
+    n_jobs_ = n_jobs;
+    next_job_ = 0;
+
+#ifdef ROC_DEBUG_CHECKS
+    run_id_ = AtomicOps::fetch_add_relaxed(last_run_id, 1) + 1;
+#endif
+
+    // Calling thread executes one part itself, so there is no need to wake up
+    // more than n_jobs-1 workers.
+    size_t n_woken = std::min(n_jobs - 1, workers_.size());
+
+    for (size_t n = 0; n < n_woken; n++) {
+        workers_[n]->wake_up();
+    }
+
+    process_jobs_();
+
+    for (size_t n = 0; n < n_woken; n++) {
+        done_sem_.wait();
+    }
+
+    job_ = NULL;
+    n_jobs_ = 0;
+}
+
+void WorkerPool::process_jobs_() {
+#ifdef ROC_DEBUG_CHECKS
+    const int slot = enter_run(run_id_);
+#endif
+
+    for (;;) {
+        const size_t job_index = (size_t)next_job_++;
+        if (job_index >= n_jobs_) {
+            break;
+        }
+
+#ifdef ROC_DEBUG_CHECKS
+        enter_job(slot, job_index);
+#endif
+
+        job_->run_job(job_index);
+    }
+
+#ifdef ROC_DEBUG_CHECKS
+    leave_run(slot);
+#endif
+}
+
+void WorkerPool::stop_workers_() {
+    stop_ = true;
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        if (workers_[n]->is_joinable()) {
+            workers_[n]->wake_up();
+            workers_[n]->join();
+        }
+        arena_.destroy_object(*workers_[n]);
+    }
+
+    workers_.clear();
+}
+
+} // namespace core
+} // namespace roc
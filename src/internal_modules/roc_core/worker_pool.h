@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/worker_pool.h
+//! @brief Fork-join pool of worker threads.
+
+#ifndef ROC_CORE_WORKER_POOL_H_
+#define ROC_CORE_WORKER_POOL_H_
+
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
+#include "roc_core/iworker_job.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+//! Fork-join pool of worker threads.
+//!
+//! Runs parts of a job in parallel and waits until all of them are finished.
+//! Calling thread takes part in execution too, so a pool with N threads
+//! executes up to N+1 parts concurrently.
+//!
+//! Worker threads are started in constructor and sleep on semaphores when
+//! there is no job, so run() doesn't allocate memory or create threads.
+//!
+//! run() should not be called concurrently.
+class WorkerPool : public NonCopyable<> {
+public:
+    //! Initialize.
+    //! Starts @p n_threads worker threads.
+    WorkerPool(size_t n_threads, IArena& arena);
+
+    //! Stop and join worker threads.
+    ~WorkerPool();
+
+    //! Check if all threads were successfully started.
+    bool is_valid() const;
+
+    //! Get number of worker threads.
+    size_t num_threads() const;
+
+    //! Run job.
+    //! @remarks
+    //!  Invokes job.run_job() for every index in range [0; n_jobs) using worker
+    //!  threads and calling thread. Blocks until all invocations return.
+    void run(IWorkerJob& job, size_t n_jobs);
+
+#ifdef ROC_DEBUG_CHECKS
+    //! Get run and job which are executed by calling thread.
+    //! @remarks
+    //!  Every run() gets a unique non-zero identifier. Used by debug checks
+    //!  in RefCountedImpl.
+    //! @returns
+    //!  false if calling thread is not executing a job now.
+    static bool current_job(uint64_t& run_id, size_t& job_index);
+#endif
+
+private:
+    class Worker : public Thread {
+    public:
+        explicit Worker(WorkerPool& pool);
+
+        void wake_up();
+
+    private:
+        virtual void run();
+
+        WorkerPool& pool_;
+        Semaphore wake_sem_;
+    };
+
+    void process_jobs_();
+    void stop_workers_();
+
+    IArena& arena_;
+
+    Array<Worker*, 8> workers_;
+
+    IWorkerJob* job_;
+    size_t n_jobs_;
+    Atomic<int> next_job_;
+    Semaphore done_sem_;
+
+#ifdef ROC_DEBUG_CHECKS
+    uint64_t run_id_;
+#endif
+
+    bool stop_;
+    bool valid_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_WORKER_POOL_H_
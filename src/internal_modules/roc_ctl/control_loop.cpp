@@ -90,16 +90,25 @@ ControlLoop::Tasks::PipelineProcessing::PipelineProcessing(
     , pipeline_(pipeline) {
 }
 
-ControlLoop::ControlLoop(netio::NetworkLoop& network_loop, core::IArena& arena)
+ControlLoop::Tasks::ShrinkPools::ShrinkPools(core::PoolShrinker& shrinker)
+    : ControlTask(&ControlLoop::task_shrink_pools_)
+    , shrinker_(shrinker) {
+}
+
+ControlLoop::ControlLoop(netio::NetworkLoop& network_loop,
+                         core::IArena& arena,
+                         const core::ThreadConfig& thread_config)
     : network_loop_(network_loop)
-    , arena_(arena) {
+    , arena_(arena)
+    , task_queue_(thread_config)
+    , processing_queue_(thread_config) {
 }
 
 ControlLoop::~ControlLoop() {
 }
 
 bool ControlLoop::is_valid() const {
-    return task_queue_.is_valid();
+    return task_queue_.is_valid() && processing_queue_.is_valid();
 }
 
 void ControlLoop::schedule(ControlTask& task, IControlTaskCompleter* completer) {
@@ -127,6 +136,19 @@ void ControlLoop::wait(ControlTask& task) {
     task_queue_.wait(task);
 }
 
+void ControlLoop::schedule_processing_at(Tasks::PipelineProcessing& task,
+                                         core::nanoseconds_t deadline) {
+    processing_queue_.schedule_at(task, deadline, *this, NULL);
+}
+
+void ControlLoop::async_cancel_processing(Tasks::PipelineProcessing& task) {
+    processing_queue_.async_cancel(task);
+}
+
+void ControlLoop::wait_processing(Tasks::PipelineProcessing& task) {
+    processing_queue_.wait(task);
+}
+
 ControlTaskResult ControlLoop::task_create_endpoint_(ControlTask& control_task) {
     Tasks::CreateEndpoint& task = (Tasks::CreateEndpoint&)control_task;
 
@@ -305,5 +327,13 @@ ControlTaskResult ControlLoop::task_pipeline_processing_(ControlTask& control_ta
     return ControlTaskSuccess;
 }
 
+ControlTaskResult ControlLoop::task_shrink_pools_(ControlTask& control_task) {
+    Tasks::ShrinkPools& task = (Tasks::ShrinkPools&)control_task;
+
+    task.shrinker_.shrink_pools(core::timestamp(core::ClockMonotonic));
+
+    return ControlTaskSuccess;
+}
+
 } // namespace ctl
 } // namespace roc
@@ -17,6 +17,7 @@
 #include "roc_core/attributes.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/pool_shrinker.h"
 #include "roc_core/shared_ptr.h"
 #include "roc_ctl/basic_control_endpoint.h"
 #include "roc_ctl/control_task_executor.h"
@@ -160,7 +161,7 @@ public:
             pipeline::ReceiverLoop& source_;
         };
 
-        //! Process pending pipeline tasks on control thread.
+        //! Process pending pipeline tasks on pipeline processing thread.
         class PipelineProcessing : public ControlTask {
         public:
             //! Set task parameters.
@@ -171,10 +172,27 @@ public:
 
             pipeline::PipelineLoop& pipeline_;
         };
+
+        //! Release memory of idle pools.
+        class ShrinkPools : public ControlTask {
+        public:
+            //! Set task parameters.
+            ShrinkPools(core::PoolShrinker& shrinker);
+
+        private:
+            friend class ControlLoop;
+
+            core::PoolShrinker& shrinker_;
+        };
     };
 
     //! Initialize.
-    ControlLoop(netio::NetworkLoop& network_loop, core::IArena& arena);
+    //! @remarks
+    //!  Starts background control and pipeline processing threads with given
+    //!  scheduling parameters.
+    ControlLoop(netio::NetworkLoop& network_loop,
+                core::IArena& arena,
+                const core::ThreadConfig& thread_config = core::ThreadConfig());
 
     virtual ~ControlLoop();
 
@@ -208,6 +226,24 @@ public:
     //! @see ControlTaskQueue::wait for details.
     void wait(ControlTask& task);
 
+    //! Enqueue pipeline processing task for asynchronous execution at given point
+    //! of time.
+    //! @remarks
+    //!  Pipeline processing tasks are executed on a dedicated thread with its own
+    //!  timer, so that they're not delayed by other control tasks and run as close
+    //!  to the deadline requested by pipeline as possible.
+    //! @see ControlTaskQueue::schedule_at for details.
+    void schedule_processing_at(Tasks::PipelineProcessing& task,
+                                core::nanoseconds_t deadline);
+
+    //! Try to cancel scheduled pipeline processing task.
+    //! @see ControlTaskQueue::async_cancel for details.
+    void async_cancel_processing(Tasks::PipelineProcessing& task);
+
+    //! Wait until pipeline processing task is completed.
+    //! @see ControlTaskQueue::wait for details.
+    void wait_processing(Tasks::PipelineProcessing& task);
+
 private:
     ControlTaskResult task_create_endpoint_(ControlTask&);
     ControlTaskResult task_delete_endpoint_(ControlTask&);
@@ -218,11 +254,13 @@ private:
     ControlTaskResult task_attach_source_(ControlTask&);
     ControlTaskResult task_detach_source_(ControlTask&);
     ControlTaskResult task_pipeline_processing_(ControlTask&);
+    ControlTaskResult task_shrink_pools_(ControlTask&);
 
     netio::NetworkLoop& network_loop_;
     core::IArena& arena_;
 
     ControlTaskQueue task_queue_;
+    ControlTaskQueue processing_queue_;
 
     core::List<BasicControlEndpoint> endpoints_;
 };
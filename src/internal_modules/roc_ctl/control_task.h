@@ -25,6 +25,7 @@ namespace roc {
 namespace ctl {
 
 class ControlTaskQueue;
+class ControlTaskHeap;
 class ControlTask;
 
 class IControlTaskExecutor;
@@ -76,6 +77,10 @@ protected:
         , renewed_deadline_(0)
         , effective_deadline_(0)
         , effective_version_(0)
+        , heap_child_(NULL)
+        , heap_next_(NULL)
+        , heap_prev_(NULL)
+        , heap_seqnum_(0)
         , func_(reinterpret_cast<ControlTaskFunc>(task_func))
         , executor_(NULL)
         , completer_(NULL)
@@ -86,6 +91,7 @@ protected:
 
 private:
     friend class ControlTaskQueue;
+    friend class ControlTaskHeap;
 
     enum State {
         // task is in ready queue or being fetched from it; after it's
@@ -155,6 +161,15 @@ private:
     // version of currently active task deadline
     core::seqlock_version_t effective_version_;
 
+    // links in sleeping heap: leftmost child, right sibling, and
+    // left sibling (or parent for leftmost child)
+    ControlTask* heap_child_;
+    ControlTask* heap_next_;
+    ControlTask* heap_prev_;
+
+    // insertion order in sleeping heap, used to order equal deadlines
+    uint64_t heap_seqnum_;
+
     // function to be executed
     ControlTaskFunc func_;
 
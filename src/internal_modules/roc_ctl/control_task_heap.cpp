@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_ctl/control_task_heap.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace ctl {
+
+ControlTaskHeap::ControlTaskHeap()
+    : root_(NULL)
+    , size_(0)
+    , seqnum_(0) {
+}
+
+ControlTaskHeap::~ControlTaskHeap() {
+    while (root_) {
+        remove(*root_);
+    }
+}
+
+size_t ControlTaskHeap::size() const {
+    return size_;
+}
+
+bool ControlTaskHeap::contains(const ControlTask& task) const {
+    // Every member except root has a link to its parent or left sibling.
+    return &task == root_ || task.heap_prev_ != NULL;
+}
+
+ControlTask* ControlTaskHeap::front() const {
+    return root_;
+}
+
+void ControlTaskHeap::insert(ControlTask& task) {
+    roc_panic_if_msg(task.effective_deadline_ <= 0,
+                     "control task heap: attempt to insert task with non-positive"
+                     " deadline: ptr=%p deadline=%lld",
+                     (void*)&task, (long long)task.effective_deadline_);
+
+    roc_panic_if_msg(contains(task),
+                     "control task heap: attempt to insert task which is already"
+                     " in heap: ptr=%p",
+                     (void*)&task);
+
+    task.heap_child_ = NULL;
+    task.heap_next_ = NULL;
+    task.heap_prev_ = NULL;
+    task.heap_seqnum_ = seqnum_++;
+
+    root_ = root_ ? meld_(root_, &task) : &task;
+    size_++;
+}
+
+void ControlTaskHeap::remove(ControlTask& task) {
+    roc_panic_if_msg(!contains(task),
+                     "control task heap: attempt to remove task which is not"
+                     " in heap: ptr=%p",
+                     (void*)&task);
+
+    ControlTask* subtree = merge_pairs_(task.heap_child_);
+
+    if (&task == root_) {
+        root_ = subtree;
+    } else {
+        // Unlink task from list of children of its parent.
+        if (task.heap_prev_->heap_child_ == &task) {
+            task.heap_prev_->heap_child_ = task.heap_next_;
+        } else {
+            task.heap_prev_->heap_next_ = task.heap_next_;
+        }
+        if (task.heap_next_) {
+            task.heap_next_->heap_prev_ = task.heap_prev_;
+        }
+
+        if (subtree) {
+            root_ = meld_(root_, subtree);
+        }
+    }
+
+    task.heap_child_ = NULL;
+    task.heap_next_ = NULL;
+    task.heap_prev_ = NULL;
+
+    size_--;
+}
+
+bool ControlTaskHeap::less_(const ControlTask& a, const ControlTask& b) {
+    if (a.effective_deadline_ != b.effective_deadline_) {
+        return a.effective_deadline_ < b.effective_deadline_;
+    }
+    return a.heap_seqnum_ < b.heap_seqnum_;
+}
+
+// Link two trees and return new root.
+// Both arguments should be roots, i.e. have no parent and siblings.
+ControlTask* ControlTaskHeap::meld_(ControlTask* a, ControlTask* b) {
+    if (less_(*b, *a)) {
+        ControlTask* tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    // Make b the leftmost child of a.
+    b->heap_prev_ = a;
+    b->heap_next_ = a->heap_child_;
+    if (a->heap_child_) {
+        a->heap_child_->heap_prev_ = b;
+    }
+    a->heap_child_ = b;
+
+    return a;
+}
+
+// Two-pass merge of list of siblings into a single tree.
+ControlTask* ControlTaskHeap::merge_pairs_(ControlTask* first) {
+    if (!first) {
+        return NULL;
+    }
+
+    // First pass: meld siblings in pairs from left to right, and
+    // build a stack of resulting trees linked via heap_next_.
+    ControlTask* stack = NULL;
+
+    while (first) {
+        ControlTask* a = first;
+        ControlTask* b = a->heap_next_;
+
+        first = b ? b->heap_next_ : NULL;
+
+        a->heap_next_ = a->heap_prev_ = NULL;
+        if (b) {
+            b->heap_next_ = b->heap_prev_ = NULL;
+            a = meld_(a, b);
+        }
+
+        a->heap_next_ = stack;
+        stack = a;
+    }
+
+    // Second pass: meld trees from right to left.
+    ControlTask* result = stack;
+    stack = stack->heap_next_;
+    result->heap_next_ = NULL;
+
+    while (stack) {
+        ControlTask* next = stack->heap_next_;
+        stack->heap_next_ = NULL;
+        result = meld_(result, stack);
+        stack = next;
+    }
+
+    result->heap_prev_ = NULL;
+
+    return result;
+}
+
+} // namespace ctl
+} // namespace roc
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_ctl/control_task_heap.h
+//! @brief Control task heap.
+
+#ifndef ROC_CTL_CONTROL_TASK_HEAP_H_
+#define ROC_CTL_CONTROL_TASK_HEAP_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_ctl/control_task.h"
+
+namespace roc {
+namespace ctl {
+
+//! Intrusive heap of control tasks ordered by deadline.
+//!
+//! Implemented as a pairing heap. Links are embedded into ControlTask, so that
+//! no allocations are needed. Insertion is O(1), removal of the first task and
+//! removal of arbitrary task are O(log n) amortized.
+//!
+//! Tasks with equal deadlines are ordered by insertion order.
+//!
+//! Not thread-safe.
+class ControlTaskHeap : public core::NonCopyable<> {
+public:
+    //! Initialize empty heap.
+    ControlTaskHeap();
+
+    //! Remove all tasks from heap.
+    ~ControlTaskHeap();
+
+    //! Get number of tasks in heap.
+    size_t size() const;
+
+    //! Check if task is in heap.
+    bool contains(const ControlTask& task) const;
+
+    //! Get task with smallest deadline.
+    //! @returns
+    //!  NULL if heap is empty.
+    ControlTask* front() const;
+
+    //! Insert task.
+    //! @remarks
+    //!  Task deadline should be positive and should not be changed while
+    //!  task is in heap.
+    //! @pre
+    //!  Task should not be member of heap.
+    void insert(ControlTask& task);
+
+    //! Remove task.
+    //! @pre
+    //!  Task should be member of heap.
+    void remove(ControlTask& task);
+
+private:
+    static bool less_(const ControlTask& a, const ControlTask& b);
+    static ControlTask* meld_(ControlTask* a, ControlTask* b);
+    static ControlTask* merge_pairs_(ControlTask* first);
+
+    ControlTask* root_;
+    size_t size_;
+    uint64_t seqnum_;
+};
+
+} // namespace ctl
+} // namespace roc
+
+#endif // ROC_CTL_CONTROL_TASK_HEAP_H_
@@ -14,8 +14,9 @@
 namespace roc {
 namespace ctl {
 
-ControlTaskQueue::ControlTaskQueue()
-    : started_(false)
+ControlTaskQueue::ControlTaskQueue(const core::ThreadConfig& thread_config)
+    : Thread(thread_config)
+    , started_(false)
     , stop_(false)
     , fetch_ready_(true)
     , ready_queue_size_(0) {
@@ -350,6 +351,13 @@ bool ControlTaskQueue::renew_scheduling_(ControlTask& task,
             if (task_flags & ControlTask::FlagResumed) {
                 roc_log(LogTrace, "control task queue: resuming task: ptr=%p",
                         (void*)&task);
+
+                // Task will be added to pause queue again if it pauses
+                // after this execution.
+                if (paused_queue_.contains(task)) {
+                    paused_queue_.remove(task);
+                }
+
                 is_ready = true;
             } else {
                 roc_log(
@@ -827,19 +835,7 @@ ControlTask* ControlTaskQueue::fetch_sleeping_task_() {
 void ControlTaskQueue::insert_sleeping_task_(ControlTask& task) {
     roc_panic_if_not(task.effective_deadline_ > 0);
 
-    ControlTask* pos = sleeping_queue_.front();
-
-    for (; pos; pos = sleeping_queue_.nextof(*pos)) {
-        if (pos->effective_deadline_ > task.effective_deadline_) {
-            break;
-        }
-    }
-
-    if (pos) {
-        sleeping_queue_.insert_before(task, *pos);
-    } else {
-        sleeping_queue_.push_back(task);
-    }
+    sleeping_queue_.insert(task);
 }
 
 void ControlTaskQueue::remove_sleeping_task_(ControlTask& task) {
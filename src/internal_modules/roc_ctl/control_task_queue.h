@@ -21,6 +21,7 @@
 #include "roc_core/timer.h"
 #include "roc_ctl/control_task.h"
 #include "roc_ctl/control_task_executor.h"
+#include "roc_ctl/control_task_heap.h"
 #include "roc_ctl/icontrol_task_completer.h"
 
 namespace roc {
@@ -55,8 +56,10 @@ namespace ctl {
 //!    - tasks to be re-scheduled with another deadline (renewed_deadline_ > 0)
 //!    - tasks to be canceled                           (renewed_deadline_ < 0)
 //!
-//!  - sleeping_queue_ - a sorted queue of tasks with non-zero deadline, scheduled for
+//!  - sleeping_queue_ - a heap of tasks with non-zero deadline, scheduled for
 //!    execution in future; the task at the head has the smallest (nearest) deadline;
+//!    insertion and removal are O(log n), so that re-scheduling stays cheap even
+//!    with thousands of sleeping tasks;
 //!
 //!  - pause_queue_ - an unsorted queue to keep track of all currently paused tasks.
 //!
@@ -126,8 +129,9 @@ class ControlTaskQueue : private core::Thread {
 public:
     //! Initialize.
     //! @remarks
-    //!  Starts background thread.
-    ControlTaskQueue();
+    //!  Starts background thread with given scheduling parameters.
+    explicit ControlTaskQueue(
+        const core::ThreadConfig& thread_config = core::ThreadConfig());
 
     //! Destroy.
     //! @remarks
@@ -275,7 +279,7 @@ private:
 
     core::Atomic<int> ready_queue_size_;
     core::MpscQueue<ControlTask, core::NoOwnership> ready_queue_;
-    core::List<ControlTask, core::NoOwnership> sleeping_queue_;
+    ControlTaskHeap sleeping_queue_;
     core::List<ControlTask, core::NoOwnership> paused_queue_;
 
     core::Timer wakeup_timer_;
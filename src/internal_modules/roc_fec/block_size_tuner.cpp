@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/block_size_tuner.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+BlockSizeTuner::BlockSizeTuner(const BlockSizeTunerConfig& config,
+                               const WriterConfig& writer_config,
+                               size_t max_block_length)
+    : config_(config)
+    , max_sblen_(writer_config.n_source_packets)
+    , max_rblen_(writer_config.n_repair_packets)
+    , cur_sblen_(writer_config.n_source_packets)
+    , cur_rblen_(writer_config.n_repair_packets)
+    , loss_rate_(0)
+    , rtt_(0)
+    , min_rtt_(0)
+    , prev_min_rtt_(0)
+    , min_rtt_window_ts_(0)
+    , queuing_delay_(0)
+    , congested_(false)
+    , n_congestion_events_(0)
+    , has_reports_(false)
+    , last_report_ts_(0)
+    , last_increase_ts_(0)
+    , n_adjustments_(0)
+    , valid_(false) {
+    roc_log(LogDebug,
+            "fec block size tuner: initializing:"
+            " max_sbl=%lu min_rbl=%lu max_rbl=%lu margin=%.2f congestion_delay=%.3fms",
+            (unsigned long)max_sblen_, (unsigned long)config_.min_repair_packets,
+            (unsigned long)max_rblen_, (double)config_.redundancy_margin,
+            (double)config_.congestion_delay / core::Millisecond);
+
+    if (max_sblen_ == 0 || max_sblen_ + max_rblen_ > max_block_length) {
+        roc_log(LogError, "fec block size tuner: invalid block length: sbl=%lu rbl=%lu",
+                (unsigned long)max_sblen_, (unsigned long)max_rblen_);
+        return;
+    }
+
+    if (config_.min_repair_packets > max_rblen_) {
+        roc_log(LogError,
+                "fec block size tuner: min repair packets can't exceed max:"
+                " min_rbl=%lu max_rbl=%lu",
+                (unsigned long)config_.min_repair_packets, (unsigned long)max_rblen_);
+        return;
+    }
+
+    if (config_.redundancy_margin <= 0 || config_.loss_smoothing <= 0
+        || config_.loss_smoothing > 1) {
+        roc_log(LogError,
+                "fec block size tuner: invalid config: margin=%.2f smoothing=%.2f",
+                (double)config_.redundancy_margin, (double)config_.loss_smoothing);
+        return;
+    }
+
+    if (config_.congestion_delay < 0
+        || (config_.congestion_delay > 0 && config_.min_rtt_window <= 0)) {
+        roc_log(LogError,
+                "fec block size tuner: invalid config:"
+                " congestion_delay=%.3fms min_rtt_window=%.3fms",
+                (double)config_.congestion_delay / core::Millisecond,
+                (double)config_.min_rtt_window / core::Millisecond);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool BlockSizeTuner::is_valid() const {
+    return valid_;
+}
+
+void BlockSizeTuner::update(float loss_fraction,
+                            core::nanoseconds_t rtt,
+                            core::nanoseconds_t current_time) {
+    roc_panic_if(!valid_);
+
+    if (loss_fraction < 0) {
+        loss_fraction = 0;
+    }
+    if (loss_fraction > 1) {
+        loss_fraction = 1;
+    }
+
+    if (!has_reports_) {
+        loss_rate_ = loss_fraction;
+        last_increase_ts_ = current_time;
+        has_reports_ = true;
+    } else {
+        loss_rate_ += (loss_fraction - loss_rate_) * config_.loss_smoothing;
+    }
+
+    last_report_ts_ = current_time;
+    rtt_ = rtt;
+
+    update_congestion_(rtt, current_time);
+
+    // React to loss spikes immediately, and to loss drops smoothly.
+    const float est_loss = std::max(loss_fraction, loss_rate_);
+
+    const double ratio = double(est_loss) * double(config_.redundancy_margin);
+
+    size_t target_sblen = max_sblen_;
+    // Small tolerance so that rounding errors don't add a whole packet.
+    size_t target_rblen = (size_t)std::ceil(ratio * double(max_sblen_) - 1e-6);
+
+    if (target_rblen > max_rblen_) {
+        // Not enough repair packets, use smaller blocks, but keep at least
+        // as many source packets as repair ones.
+        target_rblen = max_rblen_;
+        target_sblen = std::max((size_t)(double(max_rblen_) / ratio), max_rblen_);
+        target_sblen = std::min(target_sblen, max_sblen_);
+    }
+
+    target_rblen = std::max(target_rblen, config_.min_repair_packets);
+
+    // Compare protection as ratio of repair to source packets.
+    const bool increase = target_rblen * cur_sblen_ >= cur_rblen_ * target_sblen;
+
+    if (congested_) {
+        // Repair packets would only add load to congested path.
+        if (!increase) {
+            last_increase_ts_ = current_time;
+            set_sizes_(target_sblen, target_rblen);
+        }
+        return;
+    }
+
+    if (increase) {
+        last_increase_ts_ = current_time;
+        set_sizes_(target_sblen, target_rblen);
+        return;
+    }
+
+    if (current_time - last_increase_ts_ >= config_.decrease_hold + rtt_ * 2) {
+        // Counts as a new starting point for next decrease.
+        last_increase_ts_ = current_time;
+        set_sizes_(target_sblen, target_rblen);
+    }
+}
+
+void BlockSizeTuner::refresh(core::nanoseconds_t current_time) {
+    roc_panic_if(!valid_);
+
+    if (!has_reports_) {
+        return;
+    }
+
+    if (current_time - last_report_ts_ < config_.report_timeout) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "fec block size tuner: no loss reports during timeout, resetting:"
+            " timeout=%.3fms",
+            (double)config_.report_timeout / core::Millisecond);
+
+    has_reports_ = false;
+    loss_rate_ = 0;
+    rtt_ = 0;
+
+    min_rtt_ = 0;
+    prev_min_rtt_ = 0;
+    queuing_delay_ = 0;
+    congested_ = false;
+
+    set_sizes_(max_sblen_, max_rblen_);
+}
+
+size_t BlockSizeTuner::source_packets() const {
+    return cur_sblen_;
+}
+
+size_t BlockSizeTuner::repair_packets() const {
+    return cur_rblen_;
+}
+
+BlockSizeTunerMetrics BlockSizeTuner::metrics() const {
+    BlockSizeTunerMetrics metrics;
+    metrics.loss_rate = loss_rate_;
+    metrics.source_packets = cur_sblen_;
+    metrics.repair_packets = cur_rblen_;
+    metrics.adjustments = n_adjustments_;
+    metrics.queuing_delay = queuing_delay_;
+    metrics.congested = congested_;
+    metrics.congestion_events = n_congestion_events_;
+    return metrics;
+}
+
+void BlockSizeTuner::update_congestion_(core::nanoseconds_t rtt,
+                                        core::nanoseconds_t current_time) {
+    if (config_.congestion_delay == 0 || rtt <= 0) {
+        queuing_delay_ = 0;
+        congested_ = false;
+        return;
+    }
+
+    // Minimum is tracked over two adjacent windows, so that the baseline
+    // never drops to a single fresh sample right after rotation.
+    if (min_rtt_ == 0 || current_time - min_rtt_window_ts_ >= config_.min_rtt_window) {
+        prev_min_rtt_ = min_rtt_;
+        min_rtt_ = rtt;
+        min_rtt_window_ts_ = current_time;
+    } else {
+        min_rtt_ = std::min(min_rtt_, rtt);
+    }
+
+    const core::nanoseconds_t base_rtt =
+        prev_min_rtt_ != 0 ? std::min(prev_min_rtt_, min_rtt_) : min_rtt_;
+
+    queuing_delay_ = rtt - base_rtt;
+
+    const bool was_congested = congested_;
+    congested_ = queuing_delay_ >= config_.congestion_delay;
+
+    if (congested_ != was_congested) {
+        roc_log(LogDebug,
+                "fec block size tuner: path %s: rtt=%.3fms base_rtt=%.3fms"
+                " queuing_delay=%.3fms",
+                congested_ ? "became congested" : "is no longer congested",
+                (double)rtt / core::Millisecond, (double)base_rtt / core::Millisecond,
+                (double)queuing_delay_ / core::Millisecond);
+    }
+
+    if (congested_ && !was_congested) {
+        n_congestion_events_++;
+    }
+}
+
+void BlockSizeTuner::set_sizes_(size_t sblen, size_t rblen) {
+    if (sblen == cur_sblen_ && rblen == cur_rblen_) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "fec block size tuner: changing block size:"
+            " loss_rate=%.4f rtt=%.3fms old_sbl=%lu old_rbl=%lu new_sbl=%lu new_rbl=%lu",
+            (double)loss_rate_, (double)rtt_ / core::Millisecond,
+            (unsigned long)cur_sblen_, (unsigned long)cur_rblen_, (unsigned long)sblen,
+            (unsigned long)rblen);
+
+    cur_sblen_ = sblen;
+    cur_rblen_ = rblen;
+    n_adjustments_++;
+}
+
+} // namespace fec
+} // namespace roc
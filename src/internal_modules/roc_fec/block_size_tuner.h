@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/block_size_tuner.h
+//! @brief FEC block size tuner.
+
+#ifndef ROC_FEC_BLOCK_SIZE_TUNER_H_
+#define ROC_FEC_BLOCK_SIZE_TUNER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_fec/writer.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC block size tuner parameters.
+struct BlockSizeTunerConfig {
+    //! Minimum number of repair packets in block.
+    //! Used when there are no losses.
+    size_t min_repair_packets;
+
+    //! How many repair packets to send per expected lost packet.
+    //! E.g. with 5% loss and margin 2, there is 1 repair packet per 10
+    //! source packets.
+    float redundancy_margin;
+
+    //! Smoothing factor of loss rate estimate, in range (0; 1].
+    //! Higher values react faster to changes.
+    float loss_smoothing;
+
+    //! How long loss should stay low before protection is reduced.
+    //! Reduction is further delayed by two round-trip times, because
+    //! it takes so long to see how receiver reacts to it.
+    core::nanoseconds_t decrease_hold;
+
+    //! Timeout for loss reports.
+    //! If there are no reports during timeout, block sizes are reset
+    //! to configured values.
+    core::nanoseconds_t report_timeout;
+
+    //! Queuing delay at which path is considered congested.
+    //! Queuing delay is estimated as difference between current RTT and
+    //! minimum RTT seen during min_rtt_window. While path is congested, losses
+    //! are caused by our own traffic, so protection is not increased, and
+    //! reduction is not held. If zero, congestion is not detected.
+    core::nanoseconds_t congestion_delay;
+
+    //! Window of minimum RTT estimate.
+    //! Minimum RTT is forgotten after one or two windows, so that the
+    //! estimate follows route changes.
+    core::nanoseconds_t min_rtt_window;
+
+    BlockSizeTunerConfig()
+        : min_repair_packets(1)
+        , redundancy_margin(2.0f)
+        , loss_smoothing(0.3f)
+        , decrease_hold(3 * core::Second)
+        , report_timeout(1500 * core::Millisecond)
+        , congestion_delay(50 * core::Millisecond)
+        , min_rtt_window(10 * core::Second) {
+    }
+};
+
+//! FEC block size tuner metrics.
+struct BlockSizeTunerMetrics {
+    //! Smoothed loss rate reported by receiver, in range [0; 1].
+    float loss_rate;
+
+    //! Number of source packets per block chosen by tuner.
+    size_t source_packets;
+
+    //! Number of repair packets per block chosen by tuner.
+    size_t repair_packets;
+
+    //! Cumulative count of block size changes.
+    uint64_t adjustments;
+
+    //! Estimated queuing delay on path, zero if unknown.
+    core::nanoseconds_t queuing_delay;
+
+    //! Whether path is considered congested.
+    bool congested;
+
+    //! Cumulative count of times when path became congested.
+    uint64_t congestion_events;
+
+    BlockSizeTunerMetrics()
+        : loss_rate(0)
+        , source_packets(0)
+        , repair_packets(0)
+        , adjustments(0)
+        , queuing_delay(0)
+        , congested(false)
+        , congestion_events(0) {
+    }
+};
+
+//! FEC block size tuner.
+//!
+//! Chooses number of repair packets per block based on packet loss reported
+//! by receiver, within range from BlockSizeTunerConfig::min_repair_packets
+//! to WriterConfig::n_repair_packets. Protection is increased immediately
+//! when loss grows, and reduced only after loss stays low for a while.
+//!
+//! Number of source packets is kept as configured, because it defines
+//! latency required on receiver to repair a block. When loss is so high that
+//! maximum number of repair packets is not enough, number of source packets
+//! is reduced instead, down to the number of repair packets.
+//!
+//! Round-trip time from reports is also used to detect congestion. When RTT
+//! grows above its recent minimum, packets queue up somewhere on the path,
+//! and adding repair packets would only make losses worse. While congested,
+//! protection is never increased, and it's reduced without waiting.
+//!
+//! Pipeline passes loss reports to update() and periodically calls refresh().
+//! After each call, source_packets() and repair_packets() define sizes to be
+//! passed to Writer::resize().
+class BlockSizeTuner : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @p writer_config defines initial and maximum block sizes.
+    //! @p max_block_length defines maximum block length supported by codec.
+    BlockSizeTuner(const BlockSizeTunerConfig& config,
+                   const WriterConfig& writer_config,
+                   size_t max_block_length);
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Process loss report from receiver.
+    //! @p loss_fraction is fraction of packets lost since previous report.
+    //! @p rtt is estimated round-trip time, or zero if unknown.
+    void update(float loss_fraction,
+                core::nanoseconds_t rtt,
+                core::nanoseconds_t current_time);
+
+    //! Check for report timeout.
+    void refresh(core::nanoseconds_t current_time);
+
+    //! Get chosen number of source packets per block.
+    size_t source_packets() const;
+
+    //! Get chosen number of repair packets per block.
+    size_t repair_packets() const;
+
+    //! Get metrics.
+    BlockSizeTunerMetrics metrics() const;
+
+private:
+    void update_congestion_(core::nanoseconds_t rtt, core::nanoseconds_t current_time);
+    void set_sizes_(size_t sblen, size_t rblen);
+
+    const BlockSizeTunerConfig config_;
+
+    const size_t max_sblen_;
+    const size_t max_rblen_;
+
+    size_t cur_sblen_;
+    size_t cur_rblen_;
+
+    float loss_rate_;
+    core::nanoseconds_t rtt_;
+
+    core::nanoseconds_t min_rtt_;
+    core::nanoseconds_t prev_min_rtt_;
+    core::nanoseconds_t min_rtt_window_ts_;
+    core::nanoseconds_t queuing_delay_;
+    bool congested_;
+    uint64_t n_congestion_events_;
+
+    bool has_reports_;
+    core::nanoseconds_t last_report_ts_;
+    core::nanoseconds_t last_increase_ts_;
+
+    uint64_t n_adjustments_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_BLOCK_SIZE_TUNER_H_
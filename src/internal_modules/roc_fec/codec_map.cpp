@@ -11,6 +11,9 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_fec/rs8m_encoder.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 #ifdef ROC_TARGET_OPENFEC
@@ -38,14 +41,35 @@ ROC_ATTR_UNUSED I* ctor_func(const CodecConfig& config,
 
 CodecMap::CodecMap()
     : n_codecs_(0) {
+    // Builtin Reed-Solomon codec produces same repair packets as OpenFEC
+    // (see openfec_interop test). It is chosen if current CPU has SIMD GF(2^8)
+    // kernel. Otherwise OpenFEC is preferred, and builtin codec is used only
+    // if OpenFEC is disabled.
+#ifdef ROC_TARGET_OPENFEC
+    const bool use_builtin_rs8m = gf256_kernel_best() != Gf256Kernel_Scalar;
+#else
+    const bool use_builtin_rs8m = true;
+#endif
+
+    if (use_builtin_rs8m) {
+        Codec codec;
+        codec.encoder_ctor = ctor_func<IBlockEncoder, Rs8mEncoder>;
+        codec.decoder_ctor = ctor_func<IBlockDecoder, Rs8mDecoder>;
+
+        codec.scheme = packet::FEC_ReedSolomon_M8;
+        add_codec_(codec);
+    }
+
 #ifdef ROC_TARGET_OPENFEC
     {
         Codec codec;
         codec.encoder_ctor = ctor_func<IBlockEncoder, OpenfecEncoder>;
         codec.decoder_ctor = ctor_func<IBlockDecoder, OpenfecDecoder>;
 
-        codec.scheme = packet::FEC_ReedSolomon_M8;
-        add_codec_(codec);
+        if (!use_builtin_rs8m) {
+            codec.scheme = packet::FEC_ReedSolomon_M8;
+            add_codec_(codec);
+        }
 
         codec.scheme = packet::FEC_LDPC_Staircase;
         add_codec_(codec);
@@ -54,9 +78,17 @@ CodecMap::CodecMap()
 }
 
 bool CodecMap::is_supported(packet::FecScheme scheme) const {
+    if (is_sliding_window(scheme)) {
+        return true;
+    }
     return find_codec_(scheme);
 }
 
+bool CodecMap::is_sliding_window(packet::FecScheme scheme) const {
+    // Builtin RLC codec is always available.
+    return scheme == packet::FEC_RLC;
+}
+
 size_t CodecMap::num_schemes() const {
     return n_codecs_;
 }
@@ -32,12 +32,20 @@ public:
     }
 
     //! Check whether given FEC scheme is supported.
+    //! @remarks
+    //!  Includes both block and sliding-window schemes.
     bool is_supported(packet::FecScheme scheme) const;
 
-    //! Get number of supported FEC schemes.
+    //! Check whether given FEC scheme is sliding-window scheme.
+    //! @remarks
+    //!  Such schemes don't have block codecs, and are implemented by
+    //!  SlidingWriter and SlidingReader instead of Writer and Reader.
+    bool is_sliding_window(packet::FecScheme scheme) const;
+
+    //! Get number of supported block FEC schemes.
     size_t num_schemes() const;
 
-    //! Get FEC scheme ID by index.
+    //! Get block FEC scheme ID by index.
     packet::FecScheme nth_scheme(size_t n) const;
 
     //! Create a new block encoder.
@@ -145,16 +145,11 @@ public:
 
         payload_id.clear();
 
-        roc_panic_if((fec.encoding_symbol_id >> 16) != 0);
-        payload_id.set_esi((uint16_t)fec.encoding_symbol_id);
-
+        // setters panic if value doesn't fit into header field
+        payload_id.set_esi(fec.encoding_symbol_id);
         payload_id.set_sbn(fec.source_block_number);
-
-        roc_panic_if((fec.source_block_length >> 16) != 0);
-        payload_id.set_k((uint16_t)fec.source_block_length);
-
-        roc_panic_if((fec.block_length >> 16) != 0);
-        payload_id.set_n((uint16_t)fec.block_length);
+        payload_id.set_k(fec.source_block_length);
+        payload_id.set_n(fec.block_length);
 
         if (inner_composer_) {
             return inner_composer_->compose(packet);
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/decoder_worker.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+DecoderWorker::DecoderWorker(IBlockDecoder& decoder,
+                             size_t n_blocks,
+                             core::IArena& arena)
+    : arena_(arena)
+    , decoder_(decoder)
+    , blocks_(arena)
+    , free_blocks_(arena)
+    , pending_queue_(arena, n_blocks)
+    , done_queue_(arena, n_blocks)
+    , n_pending_(0)
+    , stop_(false)
+    , valid_(false) {
+    roc_log(LogDebug, "fec decoder worker: initializing: n_blocks=%lu",
+            (unsigned long)n_blocks);
+
+    if (n_blocks == 0) {
+        roc_log(LogError, "fec decoder worker: number of blocks can't be zero");
+        return;
+    }
+
+    if (!pending_queue_.is_valid() || !done_queue_.is_valid()) {
+        roc_log(LogError, "fec decoder worker: can't allocate queues");
+        return;
+    }
+
+    if (!blocks_.grow(n_blocks) || !free_blocks_.grow(n_blocks)) {
+        roc_log(LogError, "fec decoder worker: can't allocate blocks array");
+        return;
+    }
+
+    for (size_t n = 0; n < n_blocks; n++) {
+        DecoderBlock* block = new (arena_) DecoderBlock(arena_);
+        if (!block) {
+            roc_log(LogError, "fec decoder worker: can't allocate block");
+            return;
+        }
+
+        if (!blocks_.push_back(block) || !free_blocks_.push_back(block)) {
+            roc_panic("fec decoder worker: can't add block to array");
+        }
+    }
+
+    if (!start()) {
+        roc_log(LogError, "fec decoder worker: can't start thread");
+        return;
+    }
+
+    valid_ = true;
+}
+
+DecoderWorker::~DecoderWorker() {
+    stop_thread_();
+
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        arena_.destroy_object(*blocks_[n]);
+    }
+}
+
+bool DecoderWorker::is_valid() const {
+    return valid_;
+}
+
+size_t DecoderWorker::num_pending() const {
+    return n_pending_;
+}
+
+DecoderBlock* DecoderWorker::acquire(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if(!valid_);
+
+    if (free_blocks_.size() == 0) {
+        return NULL;
+    }
+
+    DecoderBlock* block = free_blocks_.back();
+
+    if (!block->source_packets.resize(sblen) || !block->repair_packets.resize(rblen)
+        || !block->restored_buffers.resize(sblen)) {
+        roc_log(LogError,
+                "fec decoder worker: can't allocate block memory: sblen=%lu rblen=%lu",
+                (unsigned long)sblen, (unsigned long)rblen);
+        return NULL;
+    }
+
+    free_blocks_.pop_back();
+
+    block->sbn = 0;
+    block->payload_size = payload_size;
+    block->submit_time = 0;
+    block->decoded = false;
+
+    return block;
+}
+
+void DecoderWorker::submit(DecoderBlock* block) {
+    roc_panic_if(!valid_);
+    roc_panic_if(!block);
+
+    block->submit_time = core::timestamp(core::ClockMonotonic);
+
+    if (!pending_queue_.push_back(block)) {
+        roc_panic("fec decoder worker: pending queue overflow");
+    }
+    n_pending_++;
+
+    wake_sem_.post();
+}
+
+DecoderBlock* DecoderWorker::poll() {
+    roc_panic_if(!valid_);
+
+    DecoderBlock* block = NULL;
+    if (!done_queue_.pop_front(block)) {
+        return NULL;
+    }
+
+    roc_panic_if(n_pending_ == 0);
+    n_pending_--;
+
+    return block;
+}
+
+void DecoderWorker::release(DecoderBlock* block) {
+    roc_panic_if(!valid_);
+    roc_panic_if(!block);
+
+    for (size_t n = 0; n < block->source_packets.size(); n++) {
+        block->source_packets[n] = NULL;
+        block->restored_buffers[n] = core::Slice<uint8_t>();
+    }
+    for (size_t n = 0; n < block->repair_packets.size(); n++) {
+        block->repair_packets[n] = NULL;
+    }
+
+    if (!free_blocks_.push_back(block)) {
+        roc_panic("fec decoder worker: can't return block to array");
+    }
+}
+
+void DecoderWorker::run() {
+    for (;;) {
+        wake_sem_.wait();
+
+        DecoderBlock* block = NULL;
+        while (pending_queue_.pop_front(block)) {
+            block->decoded = decode_(*block);
+            block->copied_bytes = decoder_.num_copied_bytes();
+
+            if (!done_queue_.push_back(block)) {
+                roc_panic("fec decoder worker: done queue overflow");
+            }
+        }
+
+        if (stop_) {
+            break;
+        }
+    }
+}
+
+bool DecoderWorker::decode_(DecoderBlock& block) {
+    const size_t sblen = block.source_packets.size();
+    const size_t rblen = block.repair_packets.size();
+
+    if (!decoder_.begin(sblen, rblen, block.payload_size)) {
+        roc_log(LogDebug,
+                "fec decoder worker: can't begin decoder block: sblen=%lu rblen=%lu"
+                " payload_size=%lu",
+                (unsigned long)sblen, (unsigned long)rblen,
+                (unsigned long)block.payload_size);
+        return false;
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        const packet::PacketPtr& sp = block.source_packets[n];
+        if (sp) {
+            decoder_.set(n, sp->fec()->payload);
+        }
+    }
+
+    for (size_t n = 0; n < rblen; n++) {
+        const packet::PacketPtr& rp = block.repair_packets[n];
+        if (rp) {
+            decoder_.set(sblen + n, rp->fec()->payload);
+        }
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (!block.source_packets[n]) {
+            block.restored_buffers[n] = decoder_.repair(n);
+        }
+    }
+
+    decoder_.end();
+
+    return true;
+}
+
+void DecoderWorker::stop_thread_() {
+    stop_ = true;
+
+    if (is_joinable()) {
+        wake_sem_.post();
+        join();
+    }
+}
+
+} // namespace fec
+} // namespace roc
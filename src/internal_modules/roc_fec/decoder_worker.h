@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/decoder_worker.h
+//! @brief Asynchronous FEC block decoder.
+
+#ifndef ROC_FEC_DECODER_WORKER_H_
+#define ROC_FEC_DECODER_WORKER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/slice.h"
+#include "roc_core/spsc_ring_buffer.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace fec {
+
+//! Block of packets passed to DecoderWorker.
+struct DecoderBlock {
+    //! Source block number.
+    packet::blknum_t sbn;
+
+    //! Received source packets of the block.
+    //! Lost packets are NULL.
+    core::Array<packet::PacketPtr> source_packets;
+
+    //! Received repair packets of the block.
+    //! Lost packets are NULL.
+    core::Array<packet::PacketPtr> repair_packets;
+
+    //! Restored buffers of lost source packets.
+    //! Filled by worker thread; empty slice if packet can't be restored.
+    core::Array<core::Slice<uint8_t> > restored_buffers;
+
+    //! Size of FEC payload of every packet.
+    size_t payload_size;
+
+    //! Time when block was submitted to worker.
+    core::nanoseconds_t submit_time;
+
+    //! Whether decoder block was successfully started.
+    bool decoded;
+
+    //! Cumulative number of bytes copied by decoder, after decoding this block.
+    uint64_t copied_bytes;
+
+    //! Initialize.
+    explicit DecoderBlock(core::IArena& arena)
+        : sbn(0)
+        , source_packets(arena)
+        , repair_packets(arena)
+        , restored_buffers(arena)
+        , payload_size(0)
+        , submit_time(0)
+        , decoded(false)
+        , copied_bytes(0) {
+    }
+};
+
+//! Asynchronous FEC block decoder.
+//!
+//! Owns a thread that restores lost source packets of submitted blocks using
+//! the given block decoder, so that the reading thread doesn't spend time on
+//! decoding large blocks.
+//!
+//! All methods except constructor and destructor should be called from
+//! a single (reading) thread. Blocks are passed to the worker thread and
+//! back via lock-free queues, so acquire(), submit() and poll() never block.
+//!
+//! Number of blocks is fixed and defines how many blocks may be decoded
+//! concurrently with reading. When all blocks are in use, acquire() returns NULL.
+//!
+//! After construction, block decoder may be used by the worker thread only.
+class DecoderWorker : public core::NonCopyable<>, private core::Thread {
+public:
+    //! Initialize.
+    //! Starts the worker thread.
+    DecoderWorker(IBlockDecoder& decoder, size_t n_blocks, core::IArena& arena);
+
+    //! Stop and join the worker thread.
+    ~DecoderWorker();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get number of blocks that are submitted but not yet polled.
+    size_t num_pending() const;
+
+    //! Get free block.
+    //! @remarks
+    //!  Returns NULL if all blocks are either being decoded or not yet polled.
+    //!  Returned block is resized to hold @p sblen source and @p rblen repair
+    //!  packets, all initially NULL.
+    DecoderBlock* acquire(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Pass acquired block to the worker thread.
+    void submit(DecoderBlock* block);
+
+    //! Get next block that was decoded by the worker thread.
+    //! @remarks
+    //!  Blocks are returned in the same order as they were submitted.
+    //!  Returns NULL if there are no such blocks yet.
+    DecoderBlock* poll();
+
+    //! Return polled block to free list.
+    void release(DecoderBlock* block);
+
+private:
+    virtual void run();
+
+    bool decode_(DecoderBlock& block);
+    void stop_thread_();
+
+    core::IArena& arena_;
+
+    IBlockDecoder& decoder_;
+
+    core::Array<DecoderBlock*> blocks_;
+    core::Array<DecoderBlock*> free_blocks_;
+
+    core::SpscRingBuffer<DecoderBlock*> pending_queue_;
+    core::SpscRingBuffer<DecoderBlock*> done_queue_;
+
+    core::Semaphore wake_sem_;
+
+    size_t n_pending_;
+
+    bool stop_;
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_DECODER_WORKER_H_
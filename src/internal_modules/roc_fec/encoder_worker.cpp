@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/encoder_worker.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+EncoderWorker::EncoderWorker(IBlockEncoder& encoder,
+                             size_t n_blocks,
+                             core::IArena& arena)
+    : arena_(arena)
+    , encoder_(encoder)
+    , blocks_(arena)
+    , free_blocks_(arena)
+    , pending_queue_(arena, n_blocks)
+    , done_queue_(arena, n_blocks)
+    , n_pending_(0)
+    , stop_(false)
+    , valid_(false) {
+    roc_log(LogDebug, "fec encoder worker: initializing: n_blocks=%lu",
+            (unsigned long)n_blocks);
+
+    if (n_blocks == 0) {
+        roc_log(LogError, "fec encoder worker: number of blocks can't be zero");
+        return;
+    }
+
+    if (!pending_queue_.is_valid() || !done_queue_.is_valid()) {
+        roc_log(LogError, "fec encoder worker: can't allocate queues");
+        return;
+    }
+
+    if (!blocks_.grow(n_blocks) || !free_blocks_.grow(n_blocks)) {
+        roc_log(LogError, "fec encoder worker: can't allocate blocks array");
+        return;
+    }
+
+    for (size_t n = 0; n < n_blocks; n++) {
+        EncoderBlock* block = new (arena_) EncoderBlock(arena_);
+        if (!block) {
+            roc_log(LogError, "fec encoder worker: can't allocate block");
+            return;
+        }
+
+        if (!blocks_.push_back(block) || !free_blocks_.push_back(block)) {
+            roc_panic("fec encoder worker: can't add block to array");
+        }
+    }
+
+    if (!start()) {
+        roc_log(LogError, "fec encoder worker: can't start thread");
+        return;
+    }
+
+    valid_ = true;
+}
+
+EncoderWorker::~EncoderWorker() {
+    stop_thread_();
+
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        arena_.destroy_object(*blocks_[n]);
+    }
+}
+
+bool EncoderWorker::is_valid() const {
+    return valid_;
+}
+
+size_t EncoderWorker::num_pending() const {
+    return n_pending_;
+}
+
+EncoderBlock* EncoderWorker::acquire(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if(!valid_);
+
+    if (free_blocks_.size() == 0) {
+        return NULL;
+    }
+
+    EncoderBlock* block = free_blocks_.back();
+
+    if (!block->source_packets.resize(sblen) || !block->repair_packets.resize(rblen)) {
+        roc_log(LogError,
+                "fec encoder worker: can't allocate block memory: sblen=%lu rblen=%lu",
+                (unsigned long)sblen, (unsigned long)rblen);
+        return NULL;
+    }
+
+    free_blocks_.pop_back();
+
+    block->payload_size = payload_size;
+    block->submit_time = 0;
+    block->encoded = false;
+
+    return block;
+}
+
+void EncoderWorker::submit(EncoderBlock* block) {
+    roc_panic_if(!valid_);
+    roc_panic_if(!block);
+
+    block->submit_time = core::timestamp(core::ClockMonotonic);
+
+    if (!pending_queue_.push_back(block)) {
+        roc_panic("fec encoder worker: pending queue overflow");
+    }
+    n_pending_++;
+
+    wake_sem_.post();
+}
+
+EncoderBlock* EncoderWorker::poll() {
+    roc_panic_if(!valid_);
+
+    EncoderBlock* block = NULL;
+    if (!done_queue_.pop_front(block)) {
+        return NULL;
+    }
+
+    roc_panic_if(n_pending_ == 0);
+    n_pending_--;
+
+    return block;
+}
+
+void EncoderWorker::release(EncoderBlock* block) {
+    roc_panic_if(!valid_);
+    roc_panic_if(!block);
+
+    for (size_t n = 0; n < block->source_packets.size(); n++) {
+        block->source_packets[n] = NULL;
+    }
+    for (size_t n = 0; n < block->repair_packets.size(); n++) {
+        block->repair_packets[n] = NULL;
+    }
+
+    if (!free_blocks_.push_back(block)) {
+        roc_panic("fec encoder worker: can't return block to array");
+    }
+}
+
+void EncoderWorker::run() {
+    for (;;) {
+        wake_sem_.wait();
+
+        EncoderBlock* block = NULL;
+        while (pending_queue_.pop_front(block)) {
+            block->encoded = encode_(*block);
+
+            if (!done_queue_.push_back(block)) {
+                roc_panic("fec encoder worker: done queue overflow");
+            }
+        }
+
+        if (stop_) {
+            break;
+        }
+    }
+}
+
+bool EncoderWorker::encode_(EncoderBlock& block) {
+    const size_t sblen = block.source_packets.size();
+    const size_t rblen = block.repair_packets.size();
+
+    if (!encoder_.begin(sblen, rblen, block.payload_size)) {
+        roc_log(LogError,
+                "fec encoder worker: can't begin encoder block: sblen=%lu rblen=%lu",
+                (unsigned long)sblen, (unsigned long)rblen);
+        return false;
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        encoder_.set(n, block.source_packets[n]->fec()->payload);
+    }
+
+    for (size_t n = 0; n < rblen; n++) {
+        const packet::PacketPtr& rp = block.repair_packets[n];
+        if (rp) {
+            encoder_.set(sblen + n, rp->fec()->payload);
+        }
+    }
+
+    encoder_.fill();
+    encoder_.end();
+
+    return true;
+}
+
+void EncoderWorker::stop_thread_() {
+    stop_ = true;
+
+    if (is_joinable()) {
+        wake_sem_.post();
+        join();
+    }
+}
+
+} // namespace fec
+} // namespace roc
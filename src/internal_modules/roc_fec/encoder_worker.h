@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/encoder_worker.h
+//! @brief Asynchronous FEC block encoder.
+
+#ifndef ROC_FEC_ENCODER_WORKER_H_
+#define ROC_FEC_ENCODER_WORKER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/spsc_ring_buffer.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_fec/iblock_encoder.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace fec {
+
+//! Block of packets passed to EncoderWorker.
+struct EncoderBlock {
+    //! Source packets of the block, with FEC payload filled.
+    core::Array<packet::PacketPtr> source_packets;
+
+    //! Repair packets of the block, prepared but not composed.
+    //! Missing packets are allowed and are skipped.
+    core::Array<packet::PacketPtr> repair_packets;
+
+    //! Size of FEC payload of every packet.
+    size_t payload_size;
+
+    //! Time when block was submitted to worker.
+    core::nanoseconds_t submit_time;
+
+    //! Whether repair payloads were successfully encoded.
+    bool encoded;
+
+    //! Initialize.
+    explicit EncoderBlock(core::IArena& arena)
+        : source_packets(arena)
+        , repair_packets(arena)
+        , payload_size(0)
+        , submit_time(0)
+        , encoded(false) {
+    }
+};
+
+//! Asynchronous FEC block encoder.
+//!
+//! Owns a thread that fills repair payloads of submitted blocks using
+//! the given block encoder, so that the writing thread doesn't spend
+//! time on encoding.
+//!
+//! All methods except constructor and destructor should be called from
+//! a single (writing) thread. Blocks are passed to the worker thread and
+//! back via lock-free queues, so acquire(), submit() and poll() never block.
+//!
+//! Number of blocks is fixed and defines how far encoding may lag behind
+//! writing. When all blocks are in use, acquire() returns NULL.
+//!
+//! After construction, block encoder may be used by the worker thread only.
+class EncoderWorker : public core::NonCopyable<>, private core::Thread {
+public:
+    //! Initialize.
+    //! Starts the worker thread.
+    EncoderWorker(IBlockEncoder& encoder, size_t n_blocks, core::IArena& arena);
+
+    //! Stop and join the worker thread.
+    ~EncoderWorker();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get number of blocks that are submitted but not yet polled.
+    size_t num_pending() const;
+
+    //! Get free block.
+    //! @remarks
+    //!  Returns NULL if all blocks are either being encoded or not yet polled.
+    //!  Returned block is resized to hold @p sblen source and @p rblen repair
+    //!  packets, all initially NULL.
+    EncoderBlock* acquire(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Pass acquired block to the worker thread.
+    void submit(EncoderBlock* block);
+
+    //! Get next block that was encoded by the worker thread.
+    //! @remarks
+    //!  Blocks are returned in the same order as they were submitted.
+    //!  Returns NULL if there are no such blocks yet.
+    EncoderBlock* poll();
+
+    //! Return polled block to free list.
+    void release(EncoderBlock* block);
+
+private:
+    virtual void run();
+
+    bool encode_(EncoderBlock& block);
+    void stop_thread_();
+
+    core::IArena& arena_;
+
+    IBlockEncoder& encoder_;
+
+    core::Array<EncoderBlock*> blocks_;
+    core::Array<EncoderBlock*> free_blocks_;
+
+    core::SpscRingBuffer<EncoderBlock*> pending_queue_;
+    core::SpscRingBuffer<EncoderBlock*> done_queue_;
+
+    core::Semaphore wake_sem_;
+
+    size_t n_pending_;
+
+    bool stop_;
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_ENCODER_WORKER_H_
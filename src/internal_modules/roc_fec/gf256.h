@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/gf256.h
+//! @brief GF(2^8) arithmetic.
+
+#ifndef ROC_FEC_GF256_H_
+#define ROC_FEC_GF256_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Exponent table of GF(2^8).
+//! @remarks
+//!  Field is generated by primitive polynomial x^8+x^4+x^3+x^2+1 (0x11D),
+//!  same as in RFC 5510. Table is doubled, so that a sum of two logarithms
+//!  can be used as index without reduction.
+extern const uint8_t gf256_exp_table[510];
+
+//! Logarithm table of GF(2^8).
+//! @remarks
+//!  Entry for zero is undefined.
+extern const uint8_t gf256_log_table[256];
+
+//! Multiply two field elements.
+inline uint8_t gf256_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return gf256_exp_table[gf256_log_table[a] + gf256_log_table[b]];
+}
+
+//! Get multiplicative inverse of non-zero field element.
+inline uint8_t gf256_inv(uint8_t a) {
+    return gf256_exp_table[255 - gf256_log_table[a]];
+}
+
+//! Raise primitive element to given power.
+inline uint8_t gf256_exp(size_t power) {
+    return gf256_exp_table[power % 255];
+}
+
+//! Invert square matrix in place.
+//! @remarks
+//!  @p matrix has @p n rows and @p n columns, stored row by row.
+//!  @p work should have room for n*n elements; its contents are
+//!  overwritten.
+//! @returns
+//!  false if matrix is singular.
+bool gf256_invert_matrix(uint8_t* matrix, uint8_t* work, size_t n);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GF256_H_
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/gf256_kernel.h"
+#include "roc_core/cpu_features.h"
+#include "roc_core/cpu_traits.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_fec/gf256.h"
+
+// SSSE3 and AVX2 are enabled per-function and selected at run time.
+#if ROC_CPU_FAMILY == ROC_CPU_X86 && ROC_CPU_HAS_SSE2                                   \
+    && (defined(__clang__)                                                               \
+        || (defined(__GNUC__)                                                            \
+            && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define ROC_FEC_GF256_SSSE3
+#define ROC_FEC_GF256_AVX2
+#include <immintrin.h>
+#endif
+
+#if ROC_CPU_FAMILY == ROC_CPU_ARM && ROC_CPU_HAS_NEON
+#define ROC_FEC_GF256_NEON
+#include <arm_neon.h>
+#endif
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+void muladd_scalar(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) {
+    if (coef == 0) {
+        return;
+    }
+
+    if (coef == 1) {
+        for (size_t n = 0; n < size; n++) {
+            dst[n] ^= src[n];
+        }
+        return;
+    }
+
+    const uint8_t* exp_table = gf256_exp_table + gf256_log_table[coef];
+
+    for (size_t n = 0; n < size; n++) {
+        if (src[n] != 0) {
+            dst[n] ^= exp_table[gf256_log_table[src[n]]];
+        }
+    }
+}
+
+#if defined(ROC_FEC_GF256_SSSE3) || defined(ROC_FEC_GF256_AVX2)                        \
+    || defined(ROC_FEC_GF256_NEON)
+
+// Split multiplication by coef into two 16-entry lookups: one for the low
+// nibble and one for the high nibble of every byte. The product is xor of
+// the two, since multiplication distributes over addition.
+void make_nibble_tables(uint8_t coef, uint8_t* lo_table, uint8_t* hi_table) {
+    for (uint8_t n = 0; n < 16; n++) {
+        lo_table[n] = gf256_mul(coef, n);
+        hi_table[n] = gf256_mul(coef, (uint8_t)(n << 4));
+    }
+}
+
+#endif
+
+#ifdef ROC_FEC_GF256_SSSE3
+
+__attribute__((target("ssse3"))) void
+muladd_ssse3(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) {
+    if (coef == 0) {
+        return;
+    }
+
+    uint8_t lo_table[16], hi_table[16];
+    make_nibble_tables(coef, lo_table, hi_table);
+
+    const __m128i v_lo = _mm_loadu_si128((const __m128i*)lo_table);
+    const __m128i v_hi = _mm_loadu_si128((const __m128i*)hi_table);
+    const __m128i v_mask = _mm_set1_epi8(0x0f);
+
+    size_t n = 0;
+
+    for (; n + 16 <= size; n += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + n));
+
+        const __m128i s_lo = _mm_and_si128(s, v_mask);
+        const __m128i s_hi = _mm_and_si128(_mm_srli_epi64(s, 4), v_mask);
+
+        const __m128i p =
+            _mm_xor_si128(_mm_shuffle_epi8(v_lo, s_lo), _mm_shuffle_epi8(v_hi, s_hi));
+
+        _mm_storeu_si128((__m128i*)(dst + n),
+                         _mm_xor_si128(_mm_loadu_si128((const __m128i*)(dst + n)), p));
+    }
+
+    muladd_scalar(dst + n, src + n, coef, size - n);
+}
+
+#endif // ROC_FEC_GF256_SSSE3
+
+#ifdef ROC_FEC_GF256_AVX2
+
+__attribute__((target("avx2"))) void
+muladd_avx2(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) {
+    if (coef == 0) {
+        return;
+    }
+
+    uint8_t lo_table[16], hi_table[16];
+    make_nibble_tables(coef, lo_table, hi_table);
+
+    // VPSHUFB looks up within 128-bit lanes, so both lanes get same table.
+    const __m256i v_lo =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lo_table));
+    const __m256i v_hi =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hi_table));
+    const __m256i v_mask = _mm256_set1_epi8(0x0f);
+
+    size_t n = 0;
+
+    for (; n + 32 <= size; n += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + n));
+
+        const __m256i p = _mm256_xor_si256(
+            _mm256_shuffle_epi8(v_lo, _mm256_and_si256(s, v_mask)),
+            _mm256_shuffle_epi8(v_hi, _mm256_and_si256(_mm256_srli_epi64(s, 4), v_mask)));
+
+        _mm256_storeu_si256(
+            (__m256i*)(dst + n),
+            _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(dst + n)), p));
+    }
+
+    // Avoid AVX-SSE transition penalty in the tail.
+    _mm256_zeroupper();
+
+    muladd_scalar(dst + n, src + n, coef, size - n);
+}
+
+#endif // ROC_FEC_GF256_AVX2
+
+#ifdef ROC_FEC_GF256_NEON
+
+void muladd_neon(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) {
+    if (coef == 0) {
+        return;
+    }
+
+    uint8_t lo_table[16], hi_table[16];
+    make_nibble_tables(coef, lo_table, hi_table);
+
+    const uint8x16_t v_mask = vdupq_n_u8(0x0f);
+
+#if defined(__aarch64__)
+    const uint8x16_t v_lo = vld1q_u8(lo_table);
+    const uint8x16_t v_hi = vld1q_u8(hi_table);
+#else
+    uint8x8x2_t v_lo, v_hi;
+    v_lo.val[0] = vld1_u8(lo_table);
+    v_lo.val[1] = vld1_u8(lo_table + 8);
+    v_hi.val[0] = vld1_u8(hi_table);
+    v_hi.val[1] = vld1_u8(hi_table + 8);
+#endif
+
+    size_t n = 0;
+
+    for (; n + 16 <= size; n += 16) {
+        const uint8x16_t s = vld1q_u8(src + n);
+        const uint8x16_t s_lo = vandq_u8(s, v_mask);
+        const uint8x16_t s_hi = vshrq_n_u8(s, 4);
+
+#if defined(__aarch64__)
+        const uint8x16_t p = veorq_u8(vqtbl1q_u8(v_lo, s_lo), vqtbl1q_u8(v_hi, s_hi));
+#else
+        const uint8x16_t p = vcombine_u8(
+            veor_u8(vtbl2_u8(v_lo, vget_low_u8(s_lo)), vtbl2_u8(v_hi, vget_low_u8(s_hi))),
+            veor_u8(vtbl2_u8(v_lo, vget_high_u8(s_lo)),
+                    vtbl2_u8(v_hi, vget_high_u8(s_hi))));
+#endif
+
+        vst1q_u8(dst + n, veorq_u8(vld1q_u8(dst + n), p));
+    }
+
+    muladd_scalar(dst + n, src + n, coef, size - n);
+}
+
+#endif // ROC_FEC_GF256_NEON
+
+} // namespace
+
+Gf256KernelFunc gf256_kernel_func(Gf256Kernel kernel) {
+    switch (kernel) {
+    case Gf256Kernel_Scalar:
+        return &muladd_scalar;
+
+    case Gf256Kernel_SSSE3:
+#ifdef ROC_FEC_GF256_SSSE3
+        if (core::cpu_supports(core::CpuFeature_SSSE3)) {
+            return &muladd_ssse3;
+        }
+#endif
+        break;
+
+    case Gf256Kernel_AVX2:
+#ifdef ROC_FEC_GF256_AVX2
+        if (core::cpu_supports(core::CpuFeature_AVX2)) {
+            return &muladd_avx2;
+        }
+#endif
+        break;
+
+    case Gf256Kernel_NEON:
+#ifdef ROC_FEC_GF256_NEON
+        if (core::cpu_supports(core::CpuFeature_NEON)) {
+            return &muladd_neon;
+        }
+#endif
+        break;
+
+    case Gf256Kernel_Max:
+        break;
+    }
+
+    return NULL;
+}
+
+Gf256Kernel gf256_kernel_best() {
+    // Ordered from fastest to slowest.
+    const Gf256Kernel candidates[] = {
+        Gf256Kernel_AVX2,
+        Gf256Kernel_SSSE3,
+        Gf256Kernel_NEON,
+    };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(candidates); n++) {
+        if (gf256_kernel_func(candidates[n])) {
+            return candidates[n];
+        }
+    }
+
+    return Gf256Kernel_Scalar;
+}
+
+const char* gf256_kernel_to_str(Gf256Kernel kernel) {
+    switch (kernel) {
+    case Gf256Kernel_Scalar:
+        return "scalar";
+
+    case Gf256Kernel_SSSE3:
+        return "ssse3";
+
+    case Gf256Kernel_AVX2:
+        return "avx2";
+
+    case Gf256Kernel_NEON:
+        return "neon";
+
+    case Gf256Kernel_Max:
+        break;
+    }
+
+    return "invalid";
+}
+
+} // namespace fec
+} // namespace roc
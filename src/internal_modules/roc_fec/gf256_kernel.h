@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/gf256_kernel.h
+//! @brief GF(2^8) region kernels.
+
+#ifndef ROC_FEC_GF256_KERNEL_H_
+#define ROC_FEC_GF256_KERNEL_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! GF(2^8) kernel implementations.
+enum Gf256Kernel {
+    //! Portable scalar implementation.
+    //! Always available.
+    Gf256Kernel_Scalar,
+
+    //! x86 SSSE3 implementation (PSHUFB table lookups).
+    Gf256Kernel_SSSE3,
+
+    //! x86 AVX2 implementation (VPSHUFB table lookups).
+    Gf256Kernel_AVX2,
+
+    //! ARM NEON implementation (TBL table lookups).
+    Gf256Kernel_NEON,
+
+    //! Number of kernels.
+    Gf256Kernel_Max
+};
+
+//! GF(2^8) kernel function.
+//! Multiplies @p size bytes from @p src by @p coef and adds (xors)
+//! result to @p dst.
+typedef void (*Gf256KernelFunc)(uint8_t* dst,
+                                const uint8_t* src,
+                                uint8_t coef,
+                                size_t size);
+
+//! Get GF(2^8) kernel function.
+//! @returns
+//!  NULL if the kernel was not enabled at compile time or is not
+//!  supported by current CPU.
+Gf256KernelFunc gf256_kernel_func(Gf256Kernel kernel);
+
+//! Get fastest GF(2^8) kernel supported by current CPU.
+Gf256Kernel gf256_kernel_best();
+
+//! Get string name of GF(2^8) kernel.
+const char* gf256_kernel_to_str(Gf256Kernel kernel);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GF256_KERNEL_H_
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/group_repairer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+GroupRepairer::GroupRepairer(const GroupRepairerConfig& config,
+                             packet::FecScheme fec_scheme,
+                             IBlockDecoder& decoder,
+                             packet::IParser& parser,
+                             packet::IWriter& writer,
+                             packet::PacketFactory& packet_factory,
+                             core::IArena& arena)
+    : fec_scheme_(fec_scheme)
+    , decoder_(decoder)
+    , parser_(parser)
+    , writer_(writer)
+    , packet_factory_(packet_factory)
+    , arena_(arena)
+    , blocks_(arena)
+    , max_sbn_(0)
+    , has_max_sbn_(false)
+    , valid_(false) {
+    if (config.max_blocks == 0) {
+        roc_log(LogError, "fec group repairer: max_blocks can't be zero");
+        return;
+    }
+
+    if (!blocks_.grow(config.max_blocks)) {
+        roc_log(LogError, "fec group repairer: can't allocate blocks");
+        return;
+    }
+
+    for (size_t n = 0; n < config.max_blocks; n++) {
+        Block* block = new (arena_) Block(arena_);
+        if (!block) {
+            roc_log(LogError, "fec group repairer: can't allocate blocks");
+            return;
+        }
+
+        if (!blocks_.push_back(block)) {
+            arena_.destroy_object(*block);
+            roc_log(LogError, "fec group repairer: can't allocate blocks");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+GroupRepairer::~GroupRepairer() {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        arena_.destroy_object(*blocks_[n]);
+    }
+}
+
+bool GroupRepairer::is_valid() const {
+    return valid_;
+}
+
+GroupRepairerMetrics GroupRepairer::metrics() const {
+    return metrics_;
+}
+
+status::StatusCode GroupRepairer::write(const packet::PacketPtr& pp) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!pp);
+
+    if (!validate_packet_(*pp)) {
+        return status::StatusOK;
+    }
+
+    const packet::FEC& fec = *pp->fec();
+
+    if (is_late_(fec.source_block_number)) {
+        return status::StatusOK;
+    }
+
+    Block* block = find_block_(fec.source_block_number);
+    if (!block) {
+        block = add_block_(fec);
+        if (!block) {
+            return status::StatusOK;
+        }
+    }
+
+    if (block->done) {
+        // Late repair packets of repaired block, or duplicates.
+        return status::StatusOK;
+    }
+
+    if (block->sblen != fec.source_block_length || block->blen != fec.block_length
+        || block->payload_size != fec.payload.size()) {
+        roc_log(LogDebug,
+                "fec group repairer: dropping packet with inconsistent block size:"
+                " sbn=%lu sblen=%lu/%lu blen=%lu/%lu payload_size=%lu/%lu",
+                (unsigned long)block->sbn, (unsigned long)block->sblen,
+                (unsigned long)fec.source_block_length, (unsigned long)block->blen,
+                (unsigned long)fec.block_length, (unsigned long)block->payload_size,
+                (unsigned long)fec.payload.size());
+        return status::StatusOK;
+    }
+
+    const size_t index = fec.encoding_symbol_id;
+    if (block->packets[index]) {
+        return status::StatusOK;
+    }
+
+    block->packets[index] = pp;
+
+    if (index < block->sblen) {
+        block->n_source++;
+    } else {
+        block->n_repair++;
+    }
+
+    if (block->n_source == block->sblen) {
+        metrics_.lossless_blocks++;
+        finish_block_(*block);
+        return status::StatusOK;
+    }
+
+    if (block->n_source + block->n_repair < block->sblen) {
+        return status::StatusOK;
+    }
+
+    // Enough packets for repair; for some schemes, decoding may still fail,
+    // and then it's retried when next packet of the block arrives.
+    return repair_block_(*block);
+}
+
+bool GroupRepairer::validate_packet_(const packet::Packet& packet) const {
+    const packet::FEC* fec = packet.fec();
+    if (!fec) {
+        roc_log(LogDebug, "fec group repairer: dropping non-fec packet");
+        return false;
+    }
+
+    if (fec->fec_scheme != fec_scheme_) {
+        roc_log(LogDebug,
+                "fec group repairer: dropping packet with unexpected fec scheme:"
+                " packet_scheme=%s group_scheme=%s",
+                packet::fec_scheme_to_str(fec->fec_scheme),
+                packet::fec_scheme_to_str(fec_scheme_));
+        return false;
+    }
+
+    if (fec->source_block_length == 0 || fec->block_length <= fec->source_block_length
+        || fec->block_length > decoder_.max_block_length()
+        || fec->encoding_symbol_id >= fec->block_length || fec->payload.size() == 0) {
+        roc_log(LogDebug,
+                "fec group repairer: dropping packet with invalid fec fields:"
+                " esi=%lu sblen=%lu blen=%lu payload_size=%lu",
+                (unsigned long)fec->encoding_symbol_id,
+                (unsigned long)fec->source_block_length, (unsigned long)fec->block_length,
+                (unsigned long)fec->payload.size());
+        return false;
+    }
+
+    return true;
+}
+
+bool GroupRepairer::is_late_(packet::blknum_t sbn) {
+    if (!has_max_sbn_ || packet::blknum_lt(max_sbn_, sbn)) {
+        max_sbn_ = sbn;
+        has_max_sbn_ = true;
+        return false;
+    }
+
+    // Block is older than all blocks we can keep.
+    return (size_t)packet::blknum_diff(max_sbn_, sbn) >= blocks_.size();
+}
+
+GroupRepairer::Block* GroupRepairer::find_block_(packet::blknum_t sbn) {
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        if (blocks_[n]->used && blocks_[n]->sbn == sbn) {
+            return blocks_[n];
+        }
+    }
+
+    return NULL;
+}
+
+GroupRepairer::Block* GroupRepairer::add_block_(const packet::FEC& fec) {
+    Block* block = NULL;
+
+    // Free slot, or else the oldest block.
+    for (size_t n = 0; n < blocks_.size(); n++) {
+        if (!blocks_[n]->used) {
+            block = blocks_[n];
+            break;
+        }
+        if (!block || packet::blknum_lt(blocks_[n]->sbn, block->sbn)) {
+            block = blocks_[n];
+        }
+    }
+
+    if (block->used && !block->done) {
+        roc_log(LogTrace,
+                "fec group repairer: dropping incomplete block: sbn=%lu n_source=%lu"
+                " n_repair=%lu sblen=%lu",
+                (unsigned long)block->sbn, (unsigned long)block->n_source,
+                (unsigned long)block->n_repair, (unsigned long)block->sblen);
+        metrics_.lost_blocks++;
+        finish_block_(*block);
+    }
+
+    if (!block->packets.resize(fec.block_length)) {
+        roc_log(LogError, "fec group repairer: can't allocate block: blen=%lu",
+                (unsigned long)fec.block_length);
+        block->used = false;
+        return NULL;
+    }
+
+    block->sbn = fec.source_block_number;
+    block->sblen = fec.source_block_length;
+    block->blen = fec.block_length;
+    block->payload_size = fec.payload.size();
+    block->n_source = 0;
+    block->n_repair = 0;
+    block->used = true;
+    block->done = false;
+
+    return block;
+}
+
+void GroupRepairer::finish_block_(Block& block) {
+    // Slot remains used, so that remaining packets of block are ignored.
+    block.done = true;
+
+    for (size_t n = 0; n < block.packets.size(); n++) {
+        block.packets[n] = NULL;
+    }
+}
+
+status::StatusCode GroupRepairer::repair_block_(Block& block) {
+    if (!decoder_.begin(block.sblen, block.blen - block.sblen, block.payload_size)) {
+        roc_log(LogDebug,
+                "fec group repairer: can't begin decoder block:"
+                " sbl=%lu rbl=%lu payload_size=%lu",
+                (unsigned long)block.sblen, (unsigned long)(block.blen - block.sblen),
+                (unsigned long)block.payload_size);
+        return status::StatusOK;
+    }
+
+    for (size_t n = 0; n < block.blen; n++) {
+        if (block.packets[n]) {
+            decoder_.set(n, block.packets[n]->fec()->payload);
+        }
+    }
+
+    status::StatusCode code = status::StatusOK;
+
+    for (size_t n = 0; n < block.sblen; n++) {
+        if (block.packets[n]) {
+            continue;
+        }
+
+        core::Slice<uint8_t> buffer = decoder_.repair(n);
+        if (!buffer) {
+            continue;
+        }
+
+        packet::PacketPtr pp = parse_repaired_packet_(buffer);
+        if (!pp) {
+            continue;
+        }
+
+        block.packets[n] = pp;
+        block.n_source++;
+        metrics_.restored_packets++;
+
+        // Writer routes packet to its session and doesn't touch decoder.
+        if (code == status::StatusOK) {
+            code = writer_.write(pp);
+        }
+    }
+
+    decoder_.end();
+
+    if (block.n_source == block.sblen) {
+        finish_block_(block);
+    }
+
+    return code;
+}
+
+packet::PacketPtr
+GroupRepairer::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        roc_log(LogError, "fec group repairer: can't allocate packet");
+        return NULL;
+    }
+
+    if (!parser_.parse(*pp, buffer)) {
+        roc_log(LogDebug, "fec group repairer: can't parse repaired packet");
+        return NULL;
+    }
+
+    pp->set_buffer(buffer);
+    pp->add_flags(packet::Packet::FlagRestored);
+
+    return pp;
+}
+
+} // namespace fec
+} // namespace roc
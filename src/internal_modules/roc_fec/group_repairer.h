@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/group_repairer.h
+//! @brief FEC repairer of blocks shared by multiple streams.
+
+#ifndef ROC_FEC_GROUP_REPAIRER_H_
+#define ROC_FEC_GROUP_REPAIRER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_packet/iparser.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC group repairer parameters.
+struct GroupRepairerConfig {
+    //! Maximum number of blocks being collected at the same time.
+    //! @remarks
+    //!  Blocks of a group are short, since they're filled by packets of all
+    //!  streams, and packets of different streams arrive with different delays.
+    //!  So packets of several recent blocks are kept. When a packet of a new
+    //!  block arrives and there is no room, the oldest block is dropped.
+    size_t max_blocks;
+
+    GroupRepairerConfig()
+        : max_blocks(16) {
+    }
+};
+
+//! FEC group repairer metrics.
+struct GroupRepairerMetrics {
+    //! Cumulative count of source packets restored from repair packets.
+    uint64_t restored_packets;
+
+    //! Cumulative count of blocks in which all source packets were received.
+    uint64_t lossless_blocks;
+
+    //! Cumulative count of blocks dropped before enough packets were received
+    //! to repair them.
+    uint64_t lost_blocks;
+
+    GroupRepairerMetrics()
+        : restored_packets(0)
+        , lossless_blocks(0)
+        , lost_blocks(0) {
+    }
+};
+
+//! FEC repairer of blocks shared by multiple streams.
+//!
+//! Counterpart of GroupWriter. Source packets of all streams of the group and
+//! their repair packets are written to repairer, in addition to passing source
+//! packets to their sessions as usual. As soon as enough packets of a block are
+//! collected, lost source packets of the block are restored and written to
+//! output writer, which should route them to sessions by source ID.
+//!
+//! Unlike Reader, repairer doesn't wait until a lost packet is needed for
+//! playback: restored packets are pushed to sessions as early as possible,
+//! and it's up to session queues to order them.
+class GroupRepairer : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines number of collected blocks
+    //!  - @p fec_scheme defines scheme of accepted packets
+    //!  - @p decoder is used to restore lost packets
+    //!  - @p parser is used to parse restored packets
+    //!  - @p writer is used to write restored packets
+    //!  - @p packet_factory is used to allocate restored packets
+    //!  - @p arena is used to allocate blocks
+    GroupRepairer(const GroupRepairerConfig& config,
+                  packet::FecScheme fec_scheme,
+                  IBlockDecoder& decoder,
+                  packet::IParser& parser,
+                  packet::IWriter& writer,
+                  packet::PacketFactory& packet_factory,
+                  core::IArena& arena);
+
+    ~GroupRepairer();
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get metrics.
+    GroupRepairerMetrics metrics() const;
+
+    //! Write source or repair packet.
+    //! @remarks
+    //!  Packet is kept until its block is repaired or dropped. May write
+    //!  restored packets of the block to output writer.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
+
+private:
+    struct Block {
+        packet::blknum_t sbn;
+        size_t sblen;
+        size_t blen;
+        size_t payload_size;
+
+        size_t n_source;
+        size_t n_repair;
+
+        // Block slot is occupied.
+        bool used;
+        // Block was repaired or didn't need repair.
+        bool done;
+
+        core::Array<packet::PacketPtr> packets;
+
+        Block(core::IArena& arena)
+            : sbn(0)
+            , sblen(0)
+            , blen(0)
+            , payload_size(0)
+            , n_source(0)
+            , n_repair(0)
+            , used(false)
+            , done(false)
+            , packets(arena) {
+        }
+    };
+
+    bool validate_packet_(const packet::Packet& packet) const;
+    bool is_late_(packet::blknum_t sbn);
+
+    Block* find_block_(packet::blknum_t sbn);
+    Block* add_block_(const packet::FEC& fec);
+    void finish_block_(Block& block);
+
+    status::StatusCode repair_block_(Block& block);
+    packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
+
+    const packet::FecScheme fec_scheme_;
+
+    IBlockDecoder& decoder_;
+    packet::IParser& parser_;
+    packet::IWriter& writer_;
+    packet::PacketFactory& packet_factory_;
+
+    core::IArena& arena_;
+    core::Array<Block*> blocks_;
+
+    // Newest block number seen, to detect late packets.
+    packet::blknum_t max_sbn_;
+    bool has_max_sbn_;
+
+    GroupRepairerMetrics metrics_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GROUP_REPAIRER_H_
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/group_writer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+GroupWriter::GroupWriter(const WriterConfig& writer_config,
+                         const CodecConfig& codec_config,
+                         packet::PacketFactory& packet_factory,
+                         core::IArena& arena)
+    : core::RefCounted<GroupWriter, core::ArenaAllocation>(arena)
+    , valid_(false) {
+    if (CodecMap::instance().is_sliding_window(codec_config.scheme)) {
+        roc_log(LogError, "fec group writer: unsupported fec scheme: scheme=%s",
+                packet::fec_scheme_to_str(codec_config.scheme));
+        return;
+    }
+
+    encoder_.reset(CodecMap::instance().new_encoder(codec_config, packet_factory, arena),
+                   arena);
+    if (!encoder_) {
+        return;
+    }
+
+    // Shared writer writes packets and formats them through proxies, which
+    // forward calls to the member that invoked it.
+    writer_.reset(new (writer_)
+                      Writer(writer_config, codec_config.scheme, *encoder_, source_proxy_,
+                             source_proxy_, repair_proxy_, packet_factory, arena));
+    if (!writer_ || !writer_->is_valid()) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool GroupWriter::is_valid() const {
+    return valid_;
+}
+
+WriterMetrics GroupWriter::metrics() const {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    return writer_->metrics();
+}
+
+status::StatusCode GroupWriter::write(const packet::PacketPtr& packet,
+                                      packet::IWriter& writer,
+                                      packet::IComposer& source_composer,
+                                      packet::IComposer& repair_composer) {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    // Source packet and repair packets which became ready are written
+    // synchronously, so member's writer is not used after we return.
+    source_proxy_.attach(&writer, &source_composer);
+    repair_proxy_.attach(&writer, &repair_composer);
+
+    const status::StatusCode code = writer_->write(packet);
+
+    source_proxy_.attach(NULL, NULL);
+    repair_proxy_.attach(NULL, NULL);
+
+    return code;
+}
+
+void GroupWriter::flush(packet::IWriter& writer, packet::IComposer& repair_composer) {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    repair_proxy_.attach(&writer, &repair_composer);
+
+    writer_->flush();
+
+    repair_proxy_.attach(NULL, NULL);
+}
+
+GroupWriter::MemberProxy::MemberProxy()
+    : writer_(NULL)
+    , composer_(NULL) {
+}
+
+void GroupWriter::MemberProxy::attach(packet::IWriter* writer,
+                                      packet::IComposer* composer) {
+    writer_ = writer;
+    composer_ = composer;
+}
+
+bool GroupWriter::MemberProxy::align(core::Slice<uint8_t>& buffer,
+                                     size_t header_size,
+                                     size_t payload_alignment) {
+    roc_panic_if(!composer_);
+
+    return composer_->align(buffer, header_size, payload_alignment);
+}
+
+bool GroupWriter::MemberProxy::prepare(packet::Packet& packet,
+                                       core::Slice<uint8_t>& buffer,
+                                       size_t payload_size) {
+    roc_panic_if(!composer_);
+
+    return composer_->prepare(packet, buffer, payload_size);
+}
+
+bool GroupWriter::MemberProxy::pad(packet::Packet& packet, size_t padding_size) {
+    roc_panic_if(!composer_);
+
+    return composer_->pad(packet, padding_size);
+}
+
+bool GroupWriter::MemberProxy::compose(packet::Packet& packet) {
+    roc_panic_if(!composer_);
+
+    return composer_->compose(packet);
+}
+
+status::StatusCode GroupWriter::MemberProxy::write(const packet::PacketPtr& packet) {
+    roc_panic_if(!writer_);
+
+    return writer_->write(packet);
+}
+
+GroupWriterMember::GroupWriterMember(const core::SharedPtr<GroupWriter>& group,
+                                     packet::IWriter& writer,
+                                     packet::IComposer& source_composer,
+                                     packet::IComposer& repair_composer)
+    : group_(group)
+    , writer_(writer)
+    , source_composer_(source_composer)
+    , repair_composer_(repair_composer) {
+    roc_panic_if(!group_);
+}
+
+const core::SharedPtr<GroupWriter>& GroupWriterMember::group() const {
+    return group_;
+}
+
+void GroupWriterMember::flush() {
+    group_->flush(writer_, repair_composer_);
+}
+
+status::StatusCode GroupWriterMember::write(const packet::PacketPtr& packet) {
+    return group_->write(packet, writer_, source_composer_, repair_composer_);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/group_writer.h
+//! @brief FEC writer shared by multiple streams.
+
+#ifndef ROC_FEC_GROUP_WRITER_H_
+#define ROC_FEC_GROUP_WRITER_H_
+
+#include "roc_core/allocation_policy.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/ref_counted.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/iblock_encoder.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/icomposer.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC writer shared by multiple streams.
+//!
+//! Low-rate streams sent from one host to one receiver, e.g. channels of a
+//! sound card sent as separate mono streams, can protect their packets
+//! together instead of running a writer per stream:
+//!  - source packets of all members form common blocks, in the order in which
+//!    members write them
+//!  - repair packets are encoded once per block and are sent by the member
+//!    which completed the block, using its repair composer and writer
+//!
+//! With N members, block of the same duration has N times more packets, so
+//! the same overhead survives longer bursts of losses, and repair packet rate
+//! doesn't grow with the number of streams. Receiver should repair blocks
+//! jointly as well, see GroupRepairer.
+//!
+//! Members should use same FEC scheme and same payload size.
+//! Members may write packets from different threads.
+class GroupWriter : public core::RefCounted<GroupWriter, core::ArenaAllocation> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer_config defines block size
+    //!  - @p codec_config defines FEC scheme
+    //!  - @p packet_factory is used to allocate repair packets
+    //!  - @p arena is used to allocate encoder and group itself
+    GroupWriter(const WriterConfig& writer_config,
+                const CodecConfig& codec_config,
+                packet::PacketFactory& packet_factory,
+                core::IArena& arena);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get metrics.
+    WriterMetrics metrics() const;
+
+    //! Write source packet of a member.
+    //! @remarks
+    //!  Source packet is composed using @p source_composer and written to
+    //!  @p writer. Repair packets that became ready are composed using
+    //!  @p repair_composer and written to @p writer too.
+    ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& packet,
+                                                packet::IWriter& writer,
+                                                packet::IComposer& source_composer,
+                                                packet::IComposer& repair_composer);
+
+    //! Write repair packets encoded asynchronously on behalf of a member.
+    void flush(packet::IWriter& writer, packet::IComposer& repair_composer);
+
+private:
+    // Forwards calls of shared writer to member which is currently writing.
+    class MemberProxy : public packet::IWriter, public packet::IComposer {
+    public:
+        MemberProxy();
+
+        void attach(packet::IWriter* writer, packet::IComposer* composer);
+
+        virtual bool
+        align(core::Slice<uint8_t>& buffer, size_t header_size, size_t payload_alignment);
+        virtual bool prepare(packet::Packet& packet,
+                             core::Slice<uint8_t>& buffer,
+                             size_t payload_size);
+        virtual bool pad(packet::Packet& packet, size_t padding_size);
+        virtual bool compose(packet::Packet& packet);
+
+        virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
+
+    private:
+        packet::IWriter* writer_;
+        packet::IComposer* composer_;
+    };
+
+    mutable core::Mutex mutex_;
+
+    MemberProxy source_proxy_;
+    MemberProxy repair_proxy_;
+
+    core::ScopedPtr<IBlockEncoder> encoder_;
+    core::Optional<Writer> writer_;
+
+    bool valid_;
+};
+
+//! Member of FEC writer group.
+//! @remarks
+//!  Writes packets of one stream to group, using composers and writer of
+//!  this stream.
+class GroupWriterMember : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    GroupWriterMember(const core::SharedPtr<GroupWriter>& group,
+                      packet::IWriter& writer,
+                      packet::IComposer& source_composer,
+                      packet::IComposer& repair_composer);
+
+    //! Get group.
+    const core::SharedPtr<GroupWriter>& group() const;
+
+    //! Write repair packets encoded asynchronously.
+    void flush();
+
+    //! Write packet to group.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
+
+private:
+    core::SharedPtr<GroupWriter> group_;
+
+    packet::IWriter& writer_;
+    packet::IComposer& source_composer_;
+    packet::IComposer& repair_composer_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GROUP_WRITER_H_
@@ -84,8 +84,9 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
-        esi_ = core::hton16u(val);
+    void set_esi(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        esi_ = core::hton16u((uint16_t)val);
     }
 
     //! Get source block length.
@@ -94,8 +95,9 @@ public:
     }
 
     //! Set source block length.
-    void set_k(uint16_t val) {
-        k_ = core::hton16u(val);
+    void set_k(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        k_ = core::hton16u((uint16_t)val);
     }
 
     //! Get number encoding symbols.
@@ -104,7 +106,7 @@ public:
     }
 
     //! Set number encoding symbols.
-    void set_n(uint16_t) {
+    void set_n(size_t) {
     }
 } ROC_ATTR_PACKED_END;
 
@@ -162,8 +164,9 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
-        esi_ = core::hton16u(val);
+    void set_esi(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        esi_ = core::hton16u((uint16_t)val);
     }
 
     //! Get source block length.
@@ -172,8 +175,9 @@ public:
     }
 
     //! Set source block length.
-    void set_k(uint16_t val) {
-        k_ = core::hton16u(val);
+    void set_k(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        k_ = core::hton16u((uint16_t)val);
     }
 
     //! Get number encoding symbols.
@@ -182,8 +186,9 @@ public:
     }
 
     //! Set number encoding symbols.
-    void set_n(uint16_t val) {
-        n_ = core::hton16u(val);
+    void set_n(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        n_ = core::hton16u((uint16_t)val);
     }
 } ROC_ATTR_PACKED_END;
 
@@ -241,7 +246,7 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
+    void set_esi(size_t val) {
         roc_panic_if((val >> 8) != 0);
         esi_ = (uint8_t)val;
     }
@@ -252,8 +257,9 @@ public:
     }
 
     //! Set source block length.
-    void set_k(uint16_t val) {
-        k_ = core::hton16u(val);
+    void set_k(size_t val) {
+        roc_panic_if((val >> 16) != 0);
+        k_ = core::hton16u((uint16_t)val);
     }
 
     //! Get number encoding symbols.
@@ -262,7 +268,157 @@ public:
     }
 
     //! Set number encoding symbols.
-    void set_n(uint16_t) {
+    void set_n(size_t) {
+    }
+} ROC_ATTR_PACKED_END;
+
+//! RLC Source FEC Payload ID (for m=8).
+//!
+//! RFC 8681 4.1.1.1: "Explicit Source FEC Payload ID"
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                   Encoding Symbol ID (ESI)                    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+ROC_ATTR_PACKED_BEGIN class RLC_Source_PayloadID {
+private:
+    //! Encoding symbol ID.
+    uint32_t esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FecScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get source block number.
+    uint16_t sbn() const {
+        return 0;
+    }
+
+    //! Set source block number.
+    void set_sbn(uint16_t) {
+    }
+
+    //! Get encoding symbol ID.
+    uint32_t esi() const {
+        return core::ntoh32u(esi_);
+    }
+
+    //! Set encoding symbol ID.
+    void set_esi(size_t val) {
+        roc_panic_if((uint64_t(val) >> 32) != 0);
+        esi_ = core::hton32u((uint32_t)val);
+    }
+
+    //! Get source block length.
+    uint16_t k() const {
+        return 0;
+    }
+
+    //! Set source block length.
+    void set_k(size_t) {
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(size_t) {
+    }
+} ROC_ATTR_PACKED_END;
+
+//! RLC Repair FEC Payload ID (for m=8).
+//!
+//! RFC 8681 4.1.1.2: "Repair FEC Payload ID"
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |       Repair_Key              |  DT   |NSS (# src symb in ew) |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                            FSS_ESI                            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+//!
+//! Fields are mapped to block-oriented interface as follows: sbn is
+//! Repair_Key, esi is FSS_ESI (first source symbol in encoding window),
+//! k is NSS (number of source symbols in encoding window), n is DT
+//! (density threshold).
+ROC_ATTR_PACKED_BEGIN class RLC_Repair_PayloadID {
+private:
+    //! Repair key.
+    uint16_t key_;
+
+    //! Density threshold (4 bits) and number of source symbols (12 bits).
+    uint16_t dt_nss_;
+
+    //! First source symbol ESI.
+    uint32_t fss_esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FecScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get repair key.
+    uint16_t sbn() const {
+        return core::ntoh16u(key_);
+    }
+
+    //! Set repair key.
+    void set_sbn(uint16_t val) {
+        key_ = core::hton16u(val);
+    }
+
+    //! Get first source symbol ESI.
+    uint32_t esi() const {
+        return core::ntoh32u(fss_esi_);
+    }
+
+    //! Set first source symbol ESI.
+    void set_esi(size_t val) {
+        roc_panic_if((uint64_t(val) >> 32) != 0);
+        fss_esi_ = core::hton32u((uint32_t)val);
+    }
+
+    //! Get number of source symbols in encoding window.
+    uint16_t k() const {
+        return core::ntoh16u(dt_nss_) & 0xfff;
+    }
+
+    //! Set number of source symbols in encoding window.
+    void set_k(size_t val) {
+        roc_panic_if((val >> 12) != 0);
+        dt_nss_ = core::hton16u(uint16_t((core::ntoh16u(dt_nss_) & 0xf000) | val));
+    }
+
+    //! Get density threshold.
+    uint16_t n() const {
+        return core::ntoh16u(dt_nss_) >> 12;
+    }
+
+    //! Set density threshold.
+    void set_n(size_t val) {
+        roc_panic_if((val >> 4) != 0);
+        dt_nss_ = core::hton16u(uint16_t((core::ntoh16u(dt_nss_) & 0xfff) | (val << 12)));
     }
 } ROC_ATTR_PACKED_END;
 
@@ -51,6 +51,14 @@ public:
     //!  Cleanups the resources allocated for the block. Should be called after
     //!  all operations for the block.
     virtual void end() = 0;
+
+    //! Get number of payload bytes copied by decoder.
+    //!
+    //! @remarks
+    //!  Cumulative count of bytes copied when restoring packets. Zero if
+    //!  decoder writes restored packets directly into buffers allocated
+    //!  from packet factory.
+    virtual uint64_t num_copied_bytes() const = 0;
 };
 
 } // namespace fec
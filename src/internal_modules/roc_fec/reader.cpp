@@ -9,6 +9,7 @@
 #include "roc_fec/reader.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/probe.h"
 #include "roc_packet/fec_scheme_to_str.h"
 #include "roc_status/code_to_str.h"
 
@@ -28,23 +29,45 @@ Reader::Reader(const ReaderConfig& config,
     , repair_reader_(repair_reader)
     , parser_(parser)
     , packet_factory_(packet_factory)
-    , source_queue_(0)
-    , repair_queue_(0)
+    , capture_ring_(NULL)
+    , source_queue_(arena, 0)
+    , repair_queue_(arena, 0)
     , source_block_(arena)
     , repair_block_(arena)
     , valid_(false)
     , alive_(true)
     , started_(false)
     , can_repair_(false)
+    , repair_pending_(false)
     , next_packet_(0)
     , cur_sbn_(0)
+    , n_block_received_(0)
+    , n_block_restored_(0)
     , payload_size_(0)
     , source_block_resized_(false)
     , repair_block_resized_(false)
     , payload_resized_(false)
+    , has_position_(false)
+    , position_(0)
+    , margin_(0)
+    , block_late_(false)
     , n_packets_(0)
+    , n_restored_(0)
+    , n_late_(0)
+    , n_copied_(0)
+    , max_decoding_lag_(0)
+    , n_lossless_(0)
+    , n_skipped_repair_(0)
+    , n_late_blocks_(0)
     , max_sbn_jump_(config.max_sbn_jump)
     , fec_scheme_(fec_scheme) {
+    if (config.max_pending_blocks != 0) {
+        worker_.reset(new (worker_)
+                          DecoderWorker(decoder_, config.max_pending_blocks, arena));
+        if (!worker_ || !worker_->is_valid()) {
+            return;
+        }
+    }
     valid_ = true;
 }
 
@@ -56,10 +79,50 @@ bool Reader::is_started() const {
     return started_;
 }
 
+packet::blknum_t Reader::current_block() const {
+    return cur_sbn_;
+}
+
 bool Reader::is_alive() const {
     return alive_;
 }
 
+ReaderMetrics Reader::metrics() const {
+    ReaderMetrics metrics;
+    metrics.restored_packets = n_restored_;
+    // Decoder is owned by worker thread in async mode.
+    metrics.copied_bytes = worker_ ? n_copied_ : decoder_.num_copied_bytes();
+    metrics.late_packets = n_late_;
+    metrics.pending_blocks = worker_ ? worker_->num_pending() : 0;
+    metrics.max_decoding_lag = max_decoding_lag_;
+    metrics.lossless_blocks = n_lossless_;
+    metrics.skipped_repair_packets = n_skipped_repair_;
+    metrics.late_blocks = n_late_blocks_;
+
+    return metrics;
+}
+
+core::OccupancyMetrics Reader::source_queue_metrics() const {
+    return source_queue_.metrics();
+}
+
+core::OccupancyMetrics Reader::repair_queue_metrics() const {
+    return repair_queue_.metrics();
+}
+
+void Reader::set_playback_position(packet::stream_timestamp_t position) {
+    has_position_ = true;
+    position_ = position;
+}
+
+void Reader::set_repair_margin(packet::stream_timestamp_t margin) {
+    margin_ = margin;
+}
+
+void Reader::set_packet_capture(packet::CaptureRing* capture_ring) {
+    capture_ring_ = capture_ring;
+}
+
 status::StatusCode Reader::read(packet::PacketPtr& pp) {
     roc_panic_if_not(is_valid());
 
@@ -71,6 +134,7 @@ status::StatusCode Reader::read(packet::PacketPtr& pp) {
     status::StatusCode code = read_(pp);
     if (code == status::StatusOK) {
         n_packets_++;
+        capture_(pp, 0);
     }
     if (!alive_) {
         pp = NULL;
@@ -146,7 +210,11 @@ status::StatusCode Reader::get_next_packet_(packet::PacketPtr& ptr) {
         }
 
         if (!pp) {
-            try_repair_();
+            if (worker_) {
+                collect_repairs_();
+            } else {
+                try_repair_();
+            }
 
             size_t pos;
             for (pos = next_packet_; pos < source_block_.size(); pos++) {
@@ -181,6 +249,10 @@ status::StatusCode Reader::get_next_packet_(packet::PacketPtr& ptr) {
 void Reader::next_block_() {
     roc_log(LogTrace, "fec reader: next block: sbn=%lu", (unsigned long)cur_sbn_);
 
+    if (source_block_.size() != 0 && n_block_received_ == source_block_.size()) {
+        n_lossless_++;
+    }
+
     for (size_t n = 0; n < source_block_.size(); n++) {
         source_block_[n] = NULL;
     }
@@ -192,11 +264,17 @@ void Reader::next_block_() {
     cur_sbn_++;
     next_packet_ = 0;
 
+    n_block_received_ = 0;
+    n_block_restored_ = 0;
+
     source_block_resized_ = false;
     repair_block_resized_ = false;
     payload_resized_ = false;
 
+    block_late_ = false;
+
     can_repair_ = false;
+    repair_pending_ = false;
 
     fill_block_();
 }
@@ -206,6 +284,11 @@ void Reader::try_repair_() {
         return;
     }
 
+    if (is_block_late_()) {
+        can_repair_ = false;
+        return;
+    }
+
     if (!source_block_resized_ || !repair_block_resized_ || !payload_resized_) {
         return;
     }
@@ -249,11 +332,135 @@ void Reader::try_repair_() {
             continue;
         }
 
-        source_block_[n] = pp;
+        add_source_packet_(n, pp, true);
     }
 
     decoder_.end();
     can_repair_ = false;
+
+    if (is_block_complete_()) {
+        release_repair_block_();
+    }
+}
+
+void Reader::submit_repair_() {
+    if (!can_repair_ || repair_pending_) {
+        return;
+    }
+
+    if (is_block_late_()) {
+        can_repair_ = false;
+        return;
+    }
+
+    if (!source_block_resized_ || !repair_block_resized_ || !payload_resized_) {
+        return;
+    }
+
+    const size_t n_source = n_block_received_ + n_block_restored_;
+    size_t n_repair = 0;
+
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (repair_block_[n]) {
+            n_repair++;
+        }
+    }
+
+    if (n_source == source_block_.size()) {
+        // Nothing to repair.
+        can_repair_ = false;
+        return;
+    }
+
+    if (n_source + n_repair < source_block_.size()) {
+        // Not enough packets yet, wait for more.
+        return;
+    }
+
+    DecoderBlock* block =
+        worker_->acquire(source_block_.size(), repair_block_.size(), payload_size_);
+    if (!block) {
+        roc_log(LogTrace,
+                "fec reader: can't submit block, too many pending blocks:"
+                " sbn=%lu n_pending=%lu",
+                (unsigned long)cur_sbn_, (unsigned long)worker_->num_pending());
+        return;
+    }
+
+    block->sbn = cur_sbn_;
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        block->source_packets[n] = source_block_[n];
+    }
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        block->repair_packets[n] = repair_block_[n];
+    }
+
+    worker_->submit(block);
+
+    can_repair_ = false;
+    repair_pending_ = true;
+}
+
+void Reader::collect_repairs_() {
+    while (DecoderBlock* block = worker_->poll()) {
+        const core::nanoseconds_t lag =
+            core::timestamp(core::ClockMonotonic) - block->submit_time;
+
+        max_decoding_lag_ = std::max(max_decoding_lag_, lag);
+        n_copied_ = block->copied_bytes;
+
+        const bool is_current = started_ && block->sbn == cur_sbn_
+            && block->restored_buffers.size() == source_block_.size();
+
+        if (is_current) {
+            repair_pending_ = false;
+        }
+
+        if (!block->decoded && is_current) {
+            roc_log(LogDebug,
+                    "fec reader: can't begin decoder block, shutting down:"
+                    " sbl=%lu rbl=%lu payload_size=%lu",
+                    (unsigned long)block->source_packets.size(),
+                    (unsigned long)block->repair_packets.size(),
+                    (unsigned long)block->payload_size);
+            alive_ = false;
+        }
+
+        for (size_t n = 0; n < block->restored_buffers.size(); n++) {
+            const core::Slice<uint8_t>& buffer = block->restored_buffers[n];
+            if (!buffer) {
+                continue;
+            }
+
+            if (!is_current || n < next_packet_) {
+                // Reader already moved past this packet.
+                n_late_++;
+                if (capture_ring_) {
+                    capture_(parse_repaired_packet_(buffer),
+                             packet::CaptureFlag_Late | packet::CaptureFlag_Dropped);
+                }
+                continue;
+            }
+
+            if (source_block_[n]) {
+                continue;
+            }
+
+            packet::PacketPtr pp = parse_repaired_packet_(buffer);
+            if (!pp) {
+                continue;
+            }
+
+            add_source_packet_(n, pp, true);
+        }
+
+        worker_->release(block);
+    }
+
+    if (is_block_complete_()) {
+        release_repair_block_();
+    }
 }
 
 packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
@@ -311,6 +518,11 @@ status::StatusCode Reader::fetch_packets_(packet::IReader& reader,
 void Reader::fill_block_() {
     fill_source_block_();
     fill_repair_block_();
+
+    if (worker_) {
+        collect_repairs_();
+        submit_repair_();
+    }
 }
 
 void Reader::fill_source_block_() {
@@ -345,6 +557,7 @@ void Reader::fill_source_block_() {
                     " cur_sbn=%lu pkt_sbn=%lu pkt_esi=%lu",
                     (unsigned long)cur_sbn_, (unsigned long)fec.source_block_number,
                     (unsigned long)fec.encoding_symbol_id);
+            capture_(pp, packet::CaptureFlag_Late | packet::CaptureFlag_Dropped);
             n_dropped++;
             continue;
         }
@@ -359,6 +572,7 @@ void Reader::fill_source_block_() {
                     (unsigned long)fec.encoding_symbol_id,
                     (unsigned long)fec.source_block_length,
                     (unsigned long)fec.block_length, (unsigned long)fec.payload.size());
+            capture_(pp, packet::CaptureFlag_Dropped);
             n_dropped++;
             continue;
         }
@@ -371,7 +585,7 @@ void Reader::fill_source_block_() {
 
         if (!source_block_[p_num]) {
             can_repair_ = true;
-            source_block_[p_num] = pp;
+            add_source_packet_(p_num, pp, false);
             n_added++;
         }
     }
@@ -380,10 +594,16 @@ void Reader::fill_source_block_() {
         roc_log(LogDebug, "fec reader: source queue: fetched=%u added=%u dropped=%u",
                 n_fetched, n_added, n_dropped);
     }
+
+    if (is_block_complete_()) {
+        // No need to keep repair packets for complete block.
+        release_repair_block_();
+        can_repair_ = false;
+    }
 }
 
 void Reader::fill_repair_block_() {
-    unsigned n_fetched = 0, n_added = 0, n_dropped = 0;
+    unsigned n_fetched = 0, n_added = 0, n_dropped = 0, n_skipped = 0;
 
     for (;;) {
         packet::PacketPtr pp = repair_queue_.head();
@@ -439,6 +659,14 @@ void Reader::fill_repair_block_() {
 
         const size_t p_num = fec.encoding_symbol_id - fec.source_block_length;
 
+        if (is_block_complete_()) {
+            // All source packets are here, release repair packet right away
+            // instead of keeping it until the end of block.
+            n_skipped_repair_++;
+            n_skipped++;
+            continue;
+        }
+
         if (!repair_block_[p_num]) {
             can_repair_ = true;
             repair_block_[p_num] = pp;
@@ -446,12 +674,96 @@ void Reader::fill_repair_block_() {
         }
     }
 
-    if (n_dropped != 0 || n_fetched != n_added) {
+    if (n_dropped != 0 || n_fetched != n_added + n_skipped) {
         roc_log(LogDebug, "fec reader: repair queue: fetched=%u added=%u dropped=%u",
                 n_fetched, n_added, n_dropped);
     }
 }
 
+void Reader::add_source_packet_(size_t index,
+                                const packet::PacketPtr& pp,
+                                bool restored) {
+    roc_panic_if(source_block_[index]);
+
+    source_block_[index] = pp;
+
+    if (restored) {
+        roc_probe(fec_repair, (unsigned long)cur_sbn_, (unsigned long)index,
+                  (uint32_t)pp->source_id(),
+                  (uint32_t)(pp->rtp() ? pp->rtp()->seqnum : 0),
+                  (uint32_t)pp->stream_timestamp());
+
+        n_block_restored_++;
+        n_restored_++;
+    } else {
+        n_block_received_++;
+    }
+}
+
+bool Reader::is_block_complete_() const {
+    return source_block_resized_
+        && n_block_received_ + n_block_restored_ == source_block_.size();
+}
+
+// Block is late if playback position passed the end of its last source packet
+// (minus repair margin).
+// If last packets of the block are lost, the end is extrapolated from the last
+// received one, assuming that all packets in block have same duration.
+bool Reader::is_block_late_() {
+    if (block_late_) {
+        return true;
+    }
+
+    if (!has_position_) {
+        return false;
+    }
+
+    for (size_t n = source_block_.size(); n > 0; n--) {
+        const packet::PacketPtr& pp = source_block_[n - 1];
+        if (!pp) {
+            continue;
+        }
+
+        if (pp->duration() == 0) {
+            return false;
+        }
+
+        const size_t n_remaining = source_block_.size() - n + 1;
+        const packet::stream_timestamp_t block_end = pp->stream_timestamp()
+            + pp->duration() * (packet::stream_timestamp_t)n_remaining;
+
+        if (!packet::stream_timestamp_le(block_end, position_ + margin_)) {
+            return false;
+        }
+
+        roc_log(LogTrace,
+                "fec reader: skipping decoding of late block:"
+                " sbn=%lu block_end=%lu play_pos=%lu",
+                (unsigned long)cur_sbn_, (unsigned long)block_end,
+                (unsigned long)position_);
+
+        block_late_ = true;
+        n_late_blocks_++;
+
+        return true;
+    }
+
+    return false;
+}
+
+void Reader::release_repair_block_() {
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (!repair_block_[n]) {
+            continue;
+        }
+        if (n_block_restored_ == 0) {
+            // Packet was never passed to decoder.
+            n_skipped_repair_++;
+        }
+        repair_block_[n] = NULL;
+    }
+}
+
 bool Reader::process_source_packet_(const packet::PacketPtr& pp) {
     const packet::FEC& fec = *pp->fec();
 
@@ -789,5 +1101,17 @@ void Reader::drop_repair_packets_from_prev_blocks_() {
     }
 }
 
+void Reader::capture_(const packet::PacketPtr& pp, unsigned flags) {
+    if (!capture_ring_ || !pp) {
+        return;
+    }
+
+    if (pp->has_flags(packet::Packet::FlagRestored)) {
+        flags |= packet::CaptureFlag_Repaired;
+    }
+
+    capture_ring_->capture(*pp, packet::CapturePoint_Repair, flags);
+}
+
 } // namespace fec
 } // namespace roc
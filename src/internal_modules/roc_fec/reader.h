@@ -15,8 +15,13 @@
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/occupancy_metrics.h"
+#include "roc_core/optional.h"
 #include "roc_core/slice.h"
+#include "roc_core/time.h"
+#include "roc_fec/decoder_worker.h"
 #include "roc_fec/iblock_decoder.h"
+#include "roc_packet/capture_ring.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/packet.h"
@@ -31,8 +36,67 @@ struct ReaderConfig {
     //! Maximum allowed source block number jump.
     size_t max_sbn_jump;
 
+    //! Maximum number of blocks being decoded asynchronously.
+    //! If non-zero, lost packets are restored on a dedicated thread, and
+    //! decoding of a block starts as soon as enough packets of the block are
+    //! received. If restored packets are not ready when they're needed, they
+    //! are skipped, as if they couldn't be restored. If zero, lost packets are
+    //! restored synchronously in read().
+    size_t max_pending_blocks;
+
     ReaderConfig()
-        : max_sbn_jump(100) {
+        : max_sbn_jump(100)
+        , max_pending_blocks(0) {
+    }
+};
+
+//! FEC reader metrics.
+struct ReaderMetrics {
+    //! Cumulative count of source packets restored from repair packets.
+    uint64_t restored_packets;
+
+    //! Cumulative count of payload bytes copied when restoring packets.
+    //! @remarks
+    //!  Reader passes received packets through without copying, so non-zero
+    //!  value means that decoder can't restore packets in place. This doesn't
+    //!  include copies made before packets reach reader, e.g. when network
+    //!  thread moves small datagrams to smaller buffers.
+    uint64_t copied_bytes;
+
+    //! Cumulative count of source packets restored asynchronously, but too late,
+    //! when reader already skipped them.
+    //! Always zero when decoding is synchronous.
+    uint64_t late_packets;
+
+    //! Number of blocks being decoded asynchronously right now.
+    size_t pending_blocks;
+
+    //! Maximum delay between submitting block to decoder and getting
+    //! restored packets back.
+    //! Always zero when decoding is synchronous.
+    core::nanoseconds_t max_decoding_lag;
+
+    //! Cumulative count of blocks in which all source packets were received,
+    //! so that decoding wasn't needed.
+    uint64_t lossless_blocks;
+
+    //! Cumulative count of repair packets released without passing them to
+    //! decoder, because all source packets of their block were already present.
+    uint64_t skipped_repair_packets;
+
+    //! Cumulative count of blocks which were not decoded, because playback
+    //! position already passed all their source packets.
+    uint64_t late_blocks;
+
+    ReaderMetrics()
+        : restored_packets(0)
+        , copied_bytes(0)
+        , late_packets(0)
+        , pending_blocks(0)
+        , max_decoding_lag(0)
+        , lossless_blocks(0)
+        , skipped_repair_packets(0)
+        , late_blocks(0) {
     }
 };
 
@@ -63,9 +127,47 @@ public:
     //! Did decoder catch block beginning?
     bool is_started() const;
 
+    //! Get number of current block.
+    //! @remarks
+    //!  Source packets from preceding blocks are not used anymore.
+    //!  Meaningful only if is_started() is true.
+    packet::blknum_t current_block() const;
+
     //! Is decoder alive?
     bool is_alive() const;
 
+    //! Get metrics.
+    ReaderMetrics metrics() const;
+
+    //! Get occupancy of queue of source packets waiting for their block.
+    core::OccupancyMetrics source_queue_metrics() const;
+
+    //! Get occupancy of queue of repair packets waiting for their block.
+    core::OccupancyMetrics repair_queue_metrics() const;
+
+    //! Set playback position.
+    //! @remarks
+    //!  Reports stream timestamp of the next sample to be played. Blocks in which
+    //!  all source packets end before it are not decoded, because restored
+    //!  packets would be dropped anyway.
+    void set_playback_position(packet::stream_timestamp_t position);
+
+    //! Set repair margin.
+    //! @remarks
+    //!  Blocks which end less than @p margin after playback position are not
+    //!  decoded too, as if they were already late. Used to save CPU when
+    //!  pipeline is overloaded, because such blocks are most likely to be
+    //!  restored too late anyway. Zero by default.
+    void set_repair_margin(packet::stream_timestamp_t margin);
+
+    //! Set packet capture ring.
+    //! @remarks
+    //!  If set, every packet returned by reader is captured into the ring,
+    //!  with CaptureFlag_Repaired if it was restored. Source packets dropped
+    //!  by reader and packets restored too late are captured as well, with
+    //!  CaptureFlag_Dropped. NULL by default.
+    void set_packet_capture(packet::CaptureRing* capture_ring);
+
     //! Read packet.
     //! @remarks
     //!  When a packet loss is detected, try to restore it from repair packets.
@@ -79,6 +181,8 @@ private:
 
     void next_block_();
     void try_repair_();
+    void submit_repair_();
+    void collect_repairs_();
 
     packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
 
@@ -89,6 +193,11 @@ private:
     void fill_source_block_();
     void fill_repair_block_();
 
+    void add_source_packet_(size_t index, const packet::PacketPtr&, bool restored);
+    bool is_block_complete_() const;
+    bool is_block_late_();
+    void release_repair_block_();
+
     bool process_source_packet_(const packet::PacketPtr&);
     bool process_repair_packet_(const packet::PacketPtr&);
 
@@ -108,12 +217,15 @@ private:
 
     void drop_repair_packets_from_prev_blocks_();
 
+    void capture_(const packet::PacketPtr&, unsigned flags);
+
     IBlockDecoder& decoder_;
 
     packet::IReader& source_reader_;
     packet::IReader& repair_reader_;
     packet::IParser& parser_;
     packet::PacketFactory& packet_factory_;
+    packet::CaptureRing* capture_ring_;
 
     packet::SortedQueue source_queue_;
     packet::SortedQueue repair_queue_;
@@ -126,17 +238,35 @@ private:
     bool alive_;
     bool started_;
     bool can_repair_;
+    bool repair_pending_;
 
     size_t next_packet_;
     packet::blknum_t cur_sbn_;
 
+    size_t n_block_received_;
+    size_t n_block_restored_;
+
     size_t payload_size_;
 
     bool source_block_resized_;
     bool repair_block_resized_;
     bool payload_resized_;
 
+    bool has_position_;
+    packet::stream_timestamp_t position_;
+    packet::stream_timestamp_t margin_;
+    bool block_late_;
+
     unsigned n_packets_;
+    uint64_t n_restored_;
+    uint64_t n_late_;
+    uint64_t n_copied_;
+    core::nanoseconds_t max_decoding_lag_;
+    uint64_t n_lossless_;
+    uint64_t n_skipped_repair_;
+    uint64_t n_late_blocks_;
+
+    core::Optional<DecoderWorker> worker_;
 
     const size_t max_sbn_jump_;
     const packet::FecScheme fec_scheme_;
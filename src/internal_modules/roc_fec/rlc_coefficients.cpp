@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_core/panic.h"
+#include "roc_fec/tinymt32.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+uint8_t nonzero_coefficient(TinyMT32& prng) {
+    uint8_t coeff;
+    do {
+        coeff = (uint8_t)prng.next_u8();
+    } while (coeff == 0);
+    return coeff;
+}
+
+} // namespace
+
+void rlc_make_coefficients(uint16_t repair_key,
+                           size_t density,
+                           uint8_t* coeffs,
+                           size_t n_coeffs) {
+    roc_panic_if(density > RlcMaxDensity);
+    roc_panic_if(!coeffs && n_coeffs != 0);
+
+    TinyMT32 prng(repair_key);
+
+    for (size_t i = 0; i < n_coeffs; i++) {
+        // With maximum density, RFC doesn't draw threshold at all,
+        // so we must not either, to keep sequence compatible.
+        if (density == RlcMaxDensity || prng.next_u4() <= density) {
+            coeffs[i] = nonzero_coefficient(prng);
+        } else {
+            coeffs[i] = 0;
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rlc_coefficients.h
+//! @brief RLC coding coefficients.
+
+#ifndef ROC_FEC_RLC_COEFFICIENTS_H_
+#define ROC_FEC_RLC_COEFFICIENTS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Maximum RLC density threshold.
+//! With this threshold, all coding coefficients are non-zero.
+const size_t RlcMaxDensity = 15;
+
+//! Maximum number of source symbols in RLC encoding window.
+//! @remarks
+//!  NSS field of repair FEC payload ID allows up to 4095 symbols, but
+//!  reader keeps this many source packets of history and decodes losses
+//!  using a dense matrix, so window is limited to keep both bounded.
+const size_t RlcMaxWindow = 256;
+
+//! Generate coding coefficients of RLC repair symbol over GF(2^8).
+//!
+//! @remarks
+//!  Implements RFC 8681 3.6 for m=8. Fills @p n_coeffs coefficients for
+//!  source symbols of encoding window, in ESI order. With @p density
+//!  less than RlcMaxDensity, each coefficient is zero with probability
+//!  1 - (density + 1) / 16.
+void rlc_make_coefficients(uint16_t repair_key,
+                           size_t density,
+                           uint8_t* coeffs,
+                           size_t n_coeffs);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RLC_COEFFICIENTS_H_
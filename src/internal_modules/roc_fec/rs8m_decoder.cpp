@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mDecoder::Rs8mDecoder(const CodecConfig& config,
+                         packet::PacketFactory& packet_factory,
+                         core::IArena& arena)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , n_received_(0)
+    , n_repaired_(0)
+    , has_new_packets_(false)
+    , matrix_(arena)
+    , kernel_(NULL)
+    , packet_factory_(packet_factory)
+    , buff_tab_(arena)
+    , lost_(arena)
+    , repair_(arena)
+    , repair_coefs_(arena)
+    , source_coefs_(arena)
+    , work_(arena)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_ReedSolomon_M8) {
+        roc_panic("rs8m decoder: unexpected fec scheme");
+    }
+
+    if (config.rs_m != 8) {
+        roc_log(LogError, "rs8m decoder: unsupported rs_m: rs_m=%u",
+                (unsigned)config.rs_m);
+        return;
+    }
+
+    const Gf256Kernel kernel = gf256_kernel_best();
+    kernel_ = gf256_kernel_func(kernel);
+    roc_panic_if(!kernel_);
+
+    roc_log(LogDebug, "rs8m decoder: initializing: kernel=%s",
+            gf256_kernel_to_str(kernel));
+
+    valid_ = true;
+}
+
+Rs8mDecoder::~Rs8mDecoder() {
+}
+
+bool Rs8mDecoder::is_valid() const {
+    return valid_;
+}
+
+size_t Rs8mDecoder::max_block_length() const {
+    roc_panic_if_not(is_valid());
+
+    return Rs8mMatrix::MaxBlockLength;
+}
+
+bool Rs8mDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(is_valid());
+
+    if (!matrix_.build(sblen, rblen)) {
+        return false;
+    }
+
+    if (!resize_tabs_(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+
+    return true;
+}
+
+void Rs8mDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(is_valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("rs8m decoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("rs8m decoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if (buff_tab_[index]) {
+        roc_panic("rs8m decoder: can't overwrite buffer: index=%lu",
+                  (unsigned long)index);
+    }
+
+    buff_tab_[index] = buffer;
+
+    n_received_++;
+    has_new_packets_ = true;
+}
+
+core::Slice<uint8_t> Rs8mDecoder::repair(size_t index) {
+    roc_panic_if_not(is_valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    // Same as OpenFEC, only source packets are repaired.
+    if (!buff_tab_[index] && index < sblen_) {
+        decode_();
+    }
+
+    return buff_tab_[index];
+}
+
+void Rs8mDecoder::end() {
+    roc_panic_if_not(is_valid());
+
+    report_();
+    reset_tabs_();
+}
+
+uint64_t Rs8mDecoder::num_copied_bytes() const {
+    // Restored packets are computed directly in packet buffers.
+    return 0;
+}
+
+bool Rs8mDecoder::resize_tabs_(size_t size) {
+    if (!buff_tab_.resize(size)) {
+        return false;
+    }
+
+    reset_tabs_();
+
+    return true;
+}
+
+void Rs8mDecoder::reset_tabs_() {
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+
+    n_received_ = 0;
+    n_repaired_ = 0;
+    has_new_packets_ = false;
+}
+
+// Any sblen rows of systematic RS matrix are linearly independent, so all
+// lost source symbols can be restored as soon as we have sblen packets.
+//
+// Instead of inverting the whole sblen x sblen decoding matrix, we invert
+// only the sub-matrix A of coefficients of lost symbols in used repair
+// symbols. Then every lost symbol is:
+//
+//   lost[l] = sum_r Ainv[l][r] * (repair[r] - sum_s G[r][s] * source[s])
+//           = sum_r Ainv[l][r] * repair[r] + sum_s B[l][s] * source[s]
+//
+// where s iterates received source symbols, and B = Ainv * G. The second
+// form allows to compute restored symbols right in the output buffers,
+// without intermediate copies.
+void Rs8mDecoder::decode_() {
+    if (!has_new_packets_ || n_received_ < sblen_) {
+        return;
+    }
+
+    has_new_packets_ = false;
+
+    size_t n_lost = 0;
+    for (size_t i = 0; i < sblen_; i++) {
+        if (!buff_tab_[i]) {
+            n_lost++;
+        }
+    }
+
+    if (n_lost == 0) {
+        return;
+    }
+
+    if (!lost_.resize(n_lost) || !repair_.resize(n_lost)
+        || !repair_coefs_.resize(n_lost * n_lost)
+        || !source_coefs_.resize(n_lost * sblen_) || !work_.resize(n_lost * n_lost)) {
+        roc_log(LogError, "rs8m decoder: can't allocate decoding tables");
+        return;
+    }
+
+    for (size_t i = 0, n = 0; i < sblen_; i++) {
+        if (!buff_tab_[i]) {
+            lost_[n++] = i;
+        }
+    }
+
+    for (size_t i = sblen_, n = 0; i < sblen_ + rblen_ && n < n_lost; i++) {
+        if (buff_tab_[i]) {
+            repair_[n++] = i - sblen_;
+        }
+    }
+
+    // A: coefficients of lost symbols in used repair symbols.
+    for (size_t r = 0; r < n_lost; r++) {
+        const uint8_t* row = matrix_.repair_row(repair_[r]);
+        for (size_t l = 0; l < n_lost; l++) {
+            repair_coefs_[r * n_lost + l] = row[lost_[l]];
+        }
+    }
+
+    if (!gf256_invert_matrix(repair_coefs_.data(), work_.data(), n_lost)) {
+        roc_log(LogError, "rs8m decoder: decoding matrix is singular");
+        return;
+    }
+
+    // B = Ainv * G, only columns of received source symbols are used.
+    memset(source_coefs_.data(), 0, n_lost * sblen_);
+
+    for (size_t l = 0; l < n_lost; l++) {
+        uint8_t* dst = source_coefs_.data() + l * sblen_;
+
+        for (size_t r = 0; r < n_lost; r++) {
+            const uint8_t coef = repair_coefs_[l * n_lost + r];
+            const uint8_t* row = matrix_.repair_row(repair_[r]);
+
+            for (size_t i = 0; i < sblen_; i++) {
+                dst[i] ^= gf256_mul(coef, row[i]);
+            }
+        }
+
+        // Lost symbols are restored in place and must not contribute.
+        for (size_t n = 0; n < n_lost; n++) {
+            dst[lost_[n]] = 0;
+        }
+    }
+
+    for (size_t l = 0; l < n_lost; l++) {
+        core::Slice<uint8_t> buffer;
+        if (!make_buffer_(buffer)) {
+            break;
+        }
+
+        memset(buffer.data(), 0, payload_size_);
+
+        for (size_t r = 0; r < n_lost; r++) {
+            kernel_(buffer.data(), buff_tab_[sblen_ + repair_[r]].data(),
+                    repair_coefs_[l * n_lost + r], payload_size_);
+        }
+
+        const uint8_t* coefs = source_coefs_.data() + l * sblen_;
+
+        for (size_t i = 0; i < sblen_; i++) {
+            if (coefs[i] != 0) {
+                kernel_(buffer.data(), buff_tab_[i].data(), coefs[i], payload_size_);
+            }
+        }
+
+        buff_tab_[lost_[l]] = buffer;
+        n_repaired_++;
+    }
+}
+
+bool Rs8mDecoder::make_buffer_(core::Slice<uint8_t>& buffer) {
+    buffer = packet_factory_.new_packet_buffer();
+
+    if (!buffer) {
+        roc_log(LogError, "rs8m decoder: can't allocate buffer");
+        return false;
+    }
+
+    if (buffer.capacity() < payload_size_) {
+        roc_log(LogError, "rs8m decoder: packet size too large: size=%lu max=%lu",
+                (unsigned long)payload_size_, (unsigned long)buffer.capacity());
+        buffer = core::Slice<uint8_t>();
+        return false;
+    }
+
+    buffer.reslice(0, payload_size_);
+
+    return true;
+}
+
+void Rs8mDecoder::report_() {
+    size_t n_lost = n_repaired_;
+    for (size_t i = 0; i < sblen_ && i < buff_tab_.size(); i++) {
+        if (!buff_tab_[i]) {
+            n_lost++;
+        }
+    }
+
+    if (n_lost == 0) {
+        return;
+    }
+
+    roc_log(LogDebug, "rs8m decoder: repaired %u/%u/%u", (unsigned)n_repaired_,
+            (unsigned)n_lost, (unsigned)buff_tab_.size());
+}
+
+} // namespace fec
+} // namespace roc
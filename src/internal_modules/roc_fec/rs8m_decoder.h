@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rs8m_decoder.h
+//! @brief Builtin Reed-Solomon decoder.
+
+#ifndef ROC_FEC_RS8M_DECODER_H_
+#define ROC_FEC_RS8M_DECODER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_fec/rs8m_matrix.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! Reed-Solomon (m=8) decoder implementation using SIMD GF(2^8) kernels.
+//! @remarks
+//!  Decodes repair symbols produced by RFC 5510 Reed-Solomon codec over GF(2^8).
+class Rs8mDecoder : public IBlockDecoder, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit Rs8mDecoder(const CodecConfig& config,
+                         packet::PacketFactory& packet_factory,
+                         core::IArena& arena);
+
+    virtual ~Rs8mDecoder();
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get the maximum number of encoding symbols for the scheme being used.
+    virtual size_t max_block_length() const;
+
+    //! Start block.
+    //!
+    //! @remarks
+    //!  Performs an initial setup for a block. Should be called before
+    //!  any operations for the block.
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Store source or repair packet buffer for current block.
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer);
+
+    //! Repair source packet buffer.
+    virtual core::Slice<uint8_t> repair(size_t index);
+
+    //! Finish block.
+    //!
+    //! @remarks
+    //!  Cleanups the resources allocated for the block. Should be called after
+    //!  all operations for the block.
+    virtual void end();
+
+    //! Get number of payload bytes copied by decoder.
+    virtual uint64_t num_copied_bytes() const;
+
+private:
+    bool resize_tabs_(size_t size);
+    void reset_tabs_();
+
+    void decode_();
+    bool make_buffer_(core::Slice<uint8_t>& buffer);
+
+    void report_();
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+
+    size_t n_received_;
+    size_t n_repaired_;
+    bool has_new_packets_;
+
+    Rs8mMatrix matrix_;
+    Gf256KernelFunc kernel_;
+
+    packet::PacketFactory& packet_factory_;
+
+    core::Array<core::Slice<uint8_t> > buff_tab_;
+
+    core::Array<size_t> lost_;
+    core::Array<size_t> repair_;
+    core::Array<uint8_t> repair_coefs_;
+    core::Array<uint8_t> source_coefs_;
+    core::Array<uint8_t> work_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RS8M_DECODER_H_
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_encoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mEncoder::Rs8mEncoder(const CodecConfig& config,
+                         packet::PacketFactory& packet_factory,
+                         core::IArena& arena)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , matrix_(arena)
+    , kernel_(NULL)
+    , buff_tab_(arena)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_ReedSolomon_M8) {
+        roc_panic("rs8m encoder: unexpected fec scheme");
+    }
+
+    if (config.rs_m != 8) {
+        roc_log(LogError, "rs8m encoder: unsupported rs_m: rs_m=%u",
+                (unsigned)config.rs_m);
+        return;
+    }
+
+    const Gf256Kernel kernel = gf256_kernel_best();
+    kernel_ = gf256_kernel_func(kernel);
+    roc_panic_if(!kernel_);
+
+    roc_log(LogDebug, "rs8m encoder: initializing: kernel=%s",
+            gf256_kernel_to_str(kernel));
+
+    valid_ = true;
+}
+
+Rs8mEncoder::~Rs8mEncoder() {
+}
+
+bool Rs8mEncoder::is_valid() const {
+    return valid_;
+}
+
+size_t Rs8mEncoder::alignment() const {
+    return Alignment;
+}
+
+size_t Rs8mEncoder::max_block_length() const {
+    roc_panic_if_not(is_valid());
+
+    return Rs8mMatrix::MaxBlockLength;
+}
+
+bool Rs8mEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(is_valid());
+
+    if (!matrix_.build(sblen, rblen)) {
+        return false;
+    }
+
+    if (!buff_tab_.resize(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+
+    return true;
+}
+
+void Rs8mEncoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(is_valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m encoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("rs8m encoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("rs8m encoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if ((uintptr_t)buffer.data() % Alignment != 0) {
+        roc_panic("rs8m encoder: buffer data should be %d-byte aligned: index=%lu",
+                  (int)Alignment, (unsigned long)index);
+    }
+
+    buff_tab_[index] = buffer;
+}
+
+void Rs8mEncoder::fill() {
+    roc_panic_if_not(is_valid());
+
+    for (size_t r = 0; r < rblen_; r++) {
+        const core::Slice<uint8_t>& repair = buff_tab_[sblen_ + r];
+        if (!repair) {
+            roc_panic("rs8m encoder: repair buffer not set: index=%lu",
+                      (unsigned long)(sblen_ + r));
+        }
+
+        const uint8_t* coefs = matrix_.repair_row(r);
+
+        memset(repair.data(), 0, payload_size_);
+
+        for (size_t s = 0; s < sblen_; s++) {
+            const core::Slice<uint8_t>& source = buff_tab_[s];
+            if (!source) {
+                roc_panic("rs8m encoder: source buffer not set: index=%lu",
+                          (unsigned long)s);
+            }
+
+            kernel_(repair.data(), source.data(), coefs[s], payload_size_);
+        }
+    }
+}
+
+void Rs8mEncoder::end() {
+    roc_panic_if_not(is_valid());
+
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rs8m_encoder.h
+//! @brief Builtin Reed-Solomon encoder.
+
+#ifndef ROC_FEC_RS8M_ENCODER_H_
+#define ROC_FEC_RS8M_ENCODER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/iblock_encoder.h"
+#include "roc_fec/rs8m_matrix.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! Reed-Solomon (m=8) encoder implementation using SIMD GF(2^8) kernels.
+//! @remarks
+//!  Produces same repair symbols as RFC 5510 Reed-Solomon codec over GF(2^8).
+class Rs8mEncoder : public IBlockEncoder, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit Rs8mEncoder(const CodecConfig& config,
+                         packet::PacketFactory& packet_factory,
+                         core::IArena& arena);
+
+    virtual ~Rs8mEncoder();
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get buffer alignment requirement.
+    virtual size_t alignment() const;
+
+    //! Get the maximum number of encoding symbols for the scheme being used.
+    virtual size_t max_block_length() const;
+
+    //! Start block.
+    //!
+    //! @remarks
+    //!  Performs an initial setup for a block. Should be called before
+    //!  any operations for the block.
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Store packet data for current block.
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer);
+
+    //! Fill repair packets.
+    virtual void fill();
+
+    //! Finish block.
+    //!
+    //! @remarks
+    //!  Cleanups the resources allocated for the block. Should be called after
+    //!  all operations for the block.
+    virtual void end();
+
+private:
+    enum { Alignment = 8 };
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+
+    Rs8mMatrix matrix_;
+    Gf256KernelFunc kernel_;
+
+    core::Array<core::Slice<uint8_t> > buff_tab_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RS8M_ENCODER_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_matrix.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mMatrix::Rs8mMatrix(core::IArena& arena)
+    : sblen_(0)
+    , rblen_(0)
+    , repair_rows_(arena)
+    , vandermonde_(arena)
+    , work_(arena) {
+}
+
+bool Rs8mMatrix::build(size_t sblen, size_t rblen) {
+    if (sblen_ == sblen && rblen_ == rblen) {
+        return true;
+    }
+
+    if (sblen == 0 || sblen + rblen > MaxBlockLength) {
+        roc_log(LogError, "rs8m matrix: invalid block size: sblen=%lu rblen=%lu max=%lu",
+                (unsigned long)sblen, (unsigned long)rblen,
+                (unsigned long)MaxBlockLength);
+        return false;
+    }
+
+    if (!repair_rows_.resize(rblen * sblen) || !vandermonde_.resize(sblen * sblen)
+        || !work_.resize(sblen * sblen)) {
+        roc_log(LogError, "rs8m matrix: can't allocate matrix: sblen=%lu rblen=%lu",
+                (unsigned long)sblen, (unsigned long)rblen);
+        sblen_ = rblen_ = 0;
+        return false;
+    }
+
+    // Upper square part of Vandermonde matrix.
+    // First row corresponds to x_0 = 0.
+    for (size_t col = 0; col < sblen; col++) {
+        vandermonde_[col] = (col == 0 ? 1 : 0);
+    }
+    for (size_t row = 1; row < sblen; row++) {
+        for (size_t col = 0; col < sblen; col++) {
+            vandermonde_[row * sblen + col] = gf256_exp((row - 1) * col);
+        }
+    }
+
+    // Vandermonde matrix with distinct x_i is always invertible.
+    if (!gf256_invert_matrix(vandermonde_.data(), work_.data(), sblen)) {
+        roc_panic("rs8m matrix: vandermonde matrix is singular: sblen=%lu",
+                  (unsigned long)sblen);
+    }
+
+    // Lower part of Vandermonde matrix multiplied by inverse of upper part.
+    for (size_t r = 0; r < rblen; r++) {
+        const size_t row = sblen + r;
+
+        uint8_t* dst = repair_rows_.data() + r * sblen;
+        memset(dst, 0, sblen);
+
+        for (size_t i = 0; i < sblen; i++) {
+            const uint8_t v = gf256_exp((row - 1) * i);
+            const uint8_t* inv_row = vandermonde_.data() + i * sblen;
+
+            for (size_t col = 0; col < sblen; col++) {
+                dst[col] ^= gf256_mul(v, inv_row[col]);
+            }
+        }
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+
+    return true;
+}
+
+size_t Rs8mMatrix::sblen() const {
+    return sblen_;
+}
+
+size_t Rs8mMatrix::rblen() const {
+    return rblen_;
+}
+
+const uint8_t* Rs8mMatrix::repair_row(size_t repair_index) const {
+    roc_panic_if_not(repair_index < rblen_);
+
+    return repair_rows_.data() + repair_index * sblen_;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rs8m_matrix.h
+//! @brief Reed-Solomon encoding matrix.
+
+#ifndef ROC_FEC_RS8M_MATRIX_H_
+#define ROC_FEC_RS8M_MATRIX_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Systematic Reed-Solomon encoding matrix over GF(2^8).
+//!
+//! @remarks
+//!  Built as described in RFC 5510: a Vandermonde matrix with rows
+//!  (x_i^0, x_i^1, ...), where x_0 = 0 and x_i = alpha^(i-1), is multiplied
+//!  by the inverse of its upper square part, which turns upper part into
+//!  identity. Only the lower part is stored, since the upper part maps
+//!  source symbols to themselves.
+class Rs8mMatrix : public core::NonCopyable<> {
+public:
+    //! Maximum number of source and repair symbols in block.
+    enum { MaxBlockLength = 255 };
+
+    //! Initialize.
+    explicit Rs8mMatrix(core::IArena& arena);
+
+    //! Compute matrix for given block.
+    //! @remarks
+    //!  Does nothing if block dimensions are the same as during previous call.
+    //! @returns
+    //!  false if dimensions are invalid or allocation failed.
+    bool build(size_t sblen, size_t rblen);
+
+    //! Get number of source symbols in block.
+    size_t sblen() const;
+
+    //! Get number of repair symbols in block.
+    size_t rblen() const;
+
+    //! Get coefficients of repair symbol.
+    //! @remarks
+    //!  Returns sblen() coefficients; n-th coefficient is multiplied
+    //!  by n-th source symbol.
+    const uint8_t* repair_row(size_t repair_index) const;
+
+private:
+    size_t sblen_;
+    size_t rblen_;
+
+    core::Array<uint8_t> repair_rows_;
+    core::Array<uint8_t> vandermonde_;
+    core::Array<uint8_t> work_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RS8M_MATRIX_H_
@@ -0,0 +1,657 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/sliding_reader.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t NoIndex = (size_t)-1;
+
+// Signed distance between ESIs, taking wrapping into account.
+inline int32_t esi_diff(uint32_t a, uint32_t b) {
+    return int32_t(a - b);
+}
+
+} // namespace
+
+SlidingReader::SlidingReader(packet::IReader& source_reader,
+                             packet::IReader& repair_reader,
+                             packet::IParser& parser,
+                             packet::PacketFactory& packet_factory,
+                             core::IArena& arena)
+    : source_reader_(source_reader)
+    , repair_reader_(repair_reader)
+    , parser_(parser)
+    , packet_factory_(packet_factory)
+    , kernel_(gf256_kernel_func(gf256_kernel_best()))
+    , source_queue_(arena, 0)
+    , ring_(arena)
+    , repairs_(arena)
+    , coeffs_(arena)
+    , matrix_(arena)
+    , rows_(arena)
+    , unknowns_(arena)
+    , columns_(arena)
+    , pivots_(arena)
+    , next_esi_(0)
+    , last_esi_(0)
+    , repair_esi_(0)
+    , valid_(false)
+    , alive_(true)
+    , started_(false)
+    , can_repair_(false)
+    , n_restored_(0) {
+    if (!ring_.resize(RingSize) || !columns_.resize(RingSize)
+        || !coeffs_.resize(RlcMaxWindow) || !repairs_.grow(MaxRepairPackets)) {
+        roc_log(LogError, "fec sliding reader: can't allocate buffers");
+        return;
+    }
+
+    for (size_t n = 0; n < columns_.size(); n++) {
+        columns_[n] = NoIndex;
+    }
+
+    valid_ = true;
+}
+
+bool SlidingReader::is_valid() const {
+    return valid_;
+}
+
+bool SlidingReader::is_started() const {
+    return started_;
+}
+
+bool SlidingReader::is_alive() const {
+    return alive_;
+}
+
+ReaderMetrics SlidingReader::metrics() const {
+    ReaderMetrics metrics;
+    metrics.restored_packets = n_restored_;
+
+    return metrics;
+}
+
+status::StatusCode SlidingReader::read(packet::PacketPtr& pp) {
+    roc_panic_if_not(is_valid());
+
+    if (!alive_) {
+        // TODO(gh-183): return StatusDead
+        return status::StatusNoData;
+    }
+
+    const status::StatusCode code = read_(pp);
+    if (!alive_) {
+        pp = NULL;
+        // TODO(gh-183): return StatusDead
+        return status::StatusNoData;
+    }
+
+    return code;
+}
+
+status::StatusCode SlidingReader::read_(packet::PacketPtr& ptr) {
+    const status::StatusCode code = fetch_packets_();
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    if (!started_) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp) {
+            return status::StatusNoData;
+        }
+
+        roc_log(LogDebug, "fec sliding reader: got first source packet: esi=%lu",
+                (unsigned long)pp->fec()->encoding_symbol_id);
+
+        reset_ring_((uint32_t)pp->fec()->encoding_symbol_id);
+        started_ = true;
+    }
+
+    fill_ring_();
+    drop_old_repair_packets_();
+
+    for (;;) {
+        packet::PacketPtr pp = ring_at_(next_esi_);
+
+        if (!pp && (can_repair_ || repair_esi_ != next_esi_)) {
+            // Retry same packet only when something changed since last attempt.
+            can_repair_ = false;
+            repair_esi_ = next_esi_;
+            try_repair_();
+            pp = ring_at_(next_esi_);
+        }
+
+        if (pp) {
+            next_packet_();
+            ptr = pp;
+            return status::StatusOK;
+        }
+
+        if (!has_later_packets_()) {
+            if (source_queue_.size() == 0) {
+                return status::StatusNoData;
+            }
+
+            // All packets in ring are consumed, and queued packets are too
+            // far ahead; jump to them instead of skipping one by one.
+            roc_log(LogDebug, "fec sliding reader: esi jump: old_esi=%lu new_esi=%lu",
+                    (unsigned long)next_esi_,
+                    (unsigned long)source_queue_.head()->fec()->encoding_symbol_id);
+
+            reset_ring_((uint32_t)source_queue_.head()->fec()->encoding_symbol_id);
+            fill_ring_();
+            drop_old_repair_packets_();
+            continue;
+        }
+
+        // Can't restore, skip.
+        next_packet_();
+        fill_ring_();
+    }
+}
+
+status::StatusCode SlidingReader::fetch_packets_() {
+    for (;;) {
+        packet::PacketPtr pp;
+
+        const status::StatusCode code = source_reader_.read(pp);
+        if (code != status::StatusOK) {
+            if (code == status::StatusNoData) {
+                break;
+            }
+            return code;
+        }
+
+        if (!validate_fec_packet_(pp)) {
+            return status::StatusOK;
+        }
+
+        add_source_packet_(pp);
+    }
+
+    for (;;) {
+        packet::PacketPtr pp;
+
+        const status::StatusCode code = repair_reader_.read(pp);
+        if (code != status::StatusOK) {
+            if (code == status::StatusNoData) {
+                break;
+            }
+            return code;
+        }
+
+        if (!validate_fec_packet_(pp)) {
+            return status::StatusOK;
+        }
+
+        add_repair_packet_(pp);
+    }
+
+    return status::StatusOK;
+}
+
+void SlidingReader::add_source_packet_(const packet::PacketPtr& pp) {
+    if (pp->fec()->payload.size() == 0) {
+        roc_log(LogTrace, "fec sliding reader: dropping source packet: empty payload");
+        return;
+    }
+
+    const status::StatusCode code = source_queue_.write(pp);
+    // TODO(gh-183): forward status
+    roc_panic_if(code != status::StatusOK);
+
+    can_repair_ = true;
+}
+
+void SlidingReader::add_repair_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+
+    if (fec.source_block_length == 0 || fec.source_block_length > RlcMaxWindow
+        || fec.block_length > RlcMaxDensity || fec.payload.size() == 0) {
+        roc_log(LogTrace,
+                "fec sliding reader: dropping repair packet: unsupported window:"
+                " nss=%lu max_nss=%lu dt=%lu payload_size=%lu",
+                (unsigned long)fec.source_block_length, (unsigned long)RlcMaxWindow,
+                (unsigned long)fec.block_length, (unsigned long)fec.payload.size());
+        return;
+    }
+
+    if (repairs_.size() == MaxRepairPackets) {
+        roc_log(LogTrace, "fec sliding reader: dropping repair packet: too many packets");
+        return;
+    }
+
+    if (!repairs_.push_back(pp)) {
+        roc_panic("fec sliding reader: can't add repair packet");
+    }
+
+    can_repair_ = true;
+}
+
+void SlidingReader::fill_ring_() {
+    for (;;) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp) {
+            break;
+        }
+
+        const uint32_t esi = (uint32_t)pp->fec()->encoding_symbol_id;
+
+        if (esi_diff(esi, next_esi_) >= (int32_t)RlcMaxWindow) {
+            break;
+        }
+
+        const status::StatusCode code = source_queue_.read(pp);
+        roc_panic_if(code != status::StatusOK);
+
+        if (esi_diff(esi, next_esi_) < -(int32_t)RlcMaxWindow) {
+            // Too far behind to be a late packet, sender was restarted.
+            roc_log(LogDebug, "fec sliding reader: esi jump: old_esi=%lu new_esi=%lu",
+                    (unsigned long)next_esi_, (unsigned long)esi);
+            reset_ring_(esi);
+        } else if (esi_diff(esi, next_esi_) < 0) {
+            roc_log(LogTrace, "fec sliding reader: dropping late source packet: esi=%lu",
+                    (unsigned long)esi);
+            continue;
+        }
+
+        packet::PacketPtr& slot = ring_at_(esi);
+        if (slot) {
+            continue;
+        }
+
+        slot = pp;
+
+        if (esi_diff(esi, last_esi_) > 0) {
+            last_esi_ = esi;
+        }
+    }
+}
+
+void SlidingReader::reset_ring_(uint32_t esi) {
+    for (size_t n = 0; n < ring_.size(); n++) {
+        ring_[n] = NULL;
+    }
+
+    next_esi_ = esi;
+    last_esi_ = esi - 1;
+    repair_esi_ = esi - 1;
+}
+
+void SlidingReader::next_packet_() {
+    // Slot of the oldest packet in history is reused by the packet which
+    // enters lookahead range.
+    ring_at_(next_esi_ + RlcMaxWindow) = NULL;
+    next_esi_++;
+}
+
+bool SlidingReader::has_later_packets_() const {
+    return esi_diff(last_esi_, next_esi_) > 0;
+}
+
+void SlidingReader::drop_old_repair_packets_() {
+    size_t n_kept = 0;
+
+    for (size_t n = 0; n < repairs_.size(); n++) {
+        const packet::FEC& fec = *repairs_[n]->fec();
+        const uint32_t end_esi =
+            uint32_t(fec.encoding_symbol_id + fec.source_block_length);
+
+        // Repair packet is useless when its window is fully before next packet
+        // or doesn't fit into history anymore.
+        if (esi_diff(end_esi, next_esi_) <= 0
+            || !is_in_ring_((uint32_t)fec.encoding_symbol_id)) {
+            continue;
+        }
+
+        if (n_kept != n) {
+            repairs_[n_kept] = repairs_[n];
+        }
+        n_kept++;
+    }
+
+    if (!repairs_.resize(n_kept)) {
+        roc_panic("fec sliding reader: can't resize repair packets");
+    }
+}
+
+void SlidingReader::try_repair_() {
+    size_t payload_size = 0;
+
+    // Symbol size is defined by repair packets covering next packet.
+    for (size_t n = 0; n < repairs_.size(); n++) {
+        const packet::FEC& fec = *repairs_[n]->fec();
+        const int32_t pos = esi_diff(next_esi_, (uint32_t)fec.encoding_symbol_id);
+
+        if (pos >= 0 && (size_t)pos < fec.source_block_length) {
+            payload_size = fec.payload.size();
+            break;
+        }
+    }
+
+    if (payload_size == 0) {
+        return;
+    }
+
+    const size_t n_rows = build_system_(payload_size);
+
+    if (n_rows != 0) {
+        solve_system_(n_rows, payload_size);
+        restore_packets_(n_rows, payload_size);
+    }
+
+    rows_.clear();
+}
+
+bool SlidingReader::is_usable_repair_(const packet::Packet& rp, size_t payload_size) {
+    const packet::FEC& fec = *rp.fec();
+
+    if (fec.payload.size() != payload_size) {
+        return false;
+    }
+
+    const uint32_t first_esi = (uint32_t)fec.encoding_symbol_id;
+    const uint32_t last_esi = uint32_t(first_esi + fec.source_block_length - 1);
+
+    if (!is_in_ring_(first_esi) || !is_in_ring_(last_esi)) {
+        return false;
+    }
+
+    for (size_t n = 0; n < fec.source_block_length; n++) {
+        const packet::PacketPtr& sp = ring_at_(uint32_t(first_esi + n));
+
+        if (sp && symbol_(*sp).size() != payload_size) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t SlidingReader::build_system_(size_t payload_size) {
+    size_t n_rows = 0;
+    uint32_t min_esi = next_esi_;
+    uint32_t max_esi = next_esi_;
+
+    // Mark unknown source packets covered by usable repair packets.
+    for (size_t n = 0; n < repairs_.size(); n++) {
+        if (!is_usable_repair_(*repairs_[n], payload_size)) {
+            continue;
+        }
+
+        const packet::FEC& fec = *repairs_[n]->fec();
+        const uint32_t first_esi = (uint32_t)fec.encoding_symbol_id;
+        const uint32_t end_esi = uint32_t(first_esi + fec.source_block_length);
+
+        for (uint32_t esi = first_esi; esi != end_esi; esi++) {
+            if (!ring_at_(esi)) {
+                columns_[esi % RingSize] = 0;
+            }
+        }
+
+        if (n_rows == 0 || esi_diff(first_esi, min_esi) < 0) {
+            min_esi = first_esi;
+        }
+        if (n_rows == 0 || esi_diff(end_esi, max_esi) > 0) {
+            max_esi = end_esi;
+        }
+
+        n_rows++;
+    }
+
+    if (n_rows == 0) {
+        return 0;
+    }
+
+    // Assign columns to unknown packets in ESI order.
+    unknowns_.clear();
+
+    for (uint32_t esi = min_esi; esi != max_esi; esi++) {
+        if (columns_[esi % RingSize] == NoIndex) {
+            continue;
+        }
+
+        columns_[esi % RingSize] = unknowns_.size();
+        if (!unknowns_.push_back(esi)) {
+            roc_panic("fec sliding reader: can't allocate unknowns");
+        }
+    }
+
+    const size_t n_cols = unknowns_.size();
+
+    if (!matrix_.resize(0) || !matrix_.resize(n_rows * n_cols) || !rows_.resize(n_rows)
+        || !pivots_.resize(n_cols)) {
+        roc_log(LogError, "fec sliding reader: can't allocate decoding matrix");
+        n_rows = 0;
+    }
+
+    // Fill matrix with coefficients of unknown packets, and subtract known
+    // packets from repair symbols.
+    size_t row = 0;
+
+    for (size_t n = 0; n < repairs_.size() && row < n_rows; n++) {
+        if (!is_usable_repair_(*repairs_[n], payload_size)) {
+            continue;
+        }
+
+        const packet::FEC& fec = *repairs_[n]->fec();
+        const uint32_t first_esi = (uint32_t)fec.encoding_symbol_id;
+
+        core::Slice<uint8_t> buffer = packet_factory_.new_packet_buffer(payload_size);
+        if (!buffer) {
+            roc_log(LogError, "fec sliding reader: can't allocate buffer");
+            n_rows = 0;
+            break;
+        }
+        buffer.reslice(0, payload_size);
+        memcpy(buffer.data(), fec.payload.data(), payload_size);
+
+        rlc_make_coefficients(fec.source_block_number, fec.block_length, coeffs_.data(),
+                              fec.source_block_length);
+
+        for (size_t i = 0; i < fec.source_block_length; i++) {
+            const uint8_t coeff = coeffs_[i];
+            if (coeff == 0) {
+                continue;
+            }
+
+            const uint32_t esi = uint32_t(first_esi + i);
+            const packet::PacketPtr& sp = ring_at_(esi);
+
+            if (sp) {
+                kernel_(buffer.data(), symbol_(*sp).data(), coeff, payload_size);
+            } else {
+                matrix_[row * n_cols + columns_[esi % RingSize]] = coeff;
+            }
+        }
+
+        rows_[row++] = buffer;
+    }
+
+    for (size_t n = 0; n < n_cols; n++) {
+        columns_[unknowns_[n] % RingSize] = NoIndex;
+    }
+
+    return n_rows;
+}
+
+size_t SlidingReader::solve_system_(size_t n_rows, size_t payload_size) {
+    const size_t n_cols = unknowns_.size();
+    uint8_t* matrix = matrix_.data();
+
+    size_t rank = 0;
+
+    // Gauss-Jordan elimination. Rows are not normalized, pivot coefficient
+    // is divided out when packet is restored.
+    for (size_t col = 0; col < n_cols; col++) {
+        pivots_[col] = NoIndex;
+
+        size_t pivot = rank;
+        while (pivot < n_rows && matrix[pivot * n_cols + col] == 0) {
+            pivot++;
+        }
+        if (pivot == n_rows) {
+            continue;
+        }
+
+        if (pivot != rank) {
+            for (size_t c = col; c < n_cols; c++) {
+                const uint8_t tmp = matrix[pivot * n_cols + c];
+                matrix[pivot * n_cols + c] = matrix[rank * n_cols + c];
+                matrix[rank * n_cols + c] = tmp;
+            }
+
+            const core::Slice<uint8_t> tmp = rows_[pivot];
+            rows_[pivot] = rows_[rank];
+            rows_[rank] = tmp;
+        }
+
+        const uint8_t* pivot_row = matrix + rank * n_cols;
+        const uint8_t pivot_inv = gf256_inv(pivot_row[col]);
+
+        for (size_t row = 0; row < n_rows; row++) {
+            if (row == rank || matrix[row * n_cols + col] == 0) {
+                continue;
+            }
+
+            const uint8_t factor = gf256_mul(matrix[row * n_cols + col], pivot_inv);
+
+            // Columns before pivot are zero in pivot row.
+            for (size_t c = col; c < n_cols; c++) {
+                matrix[row * n_cols + c] ^= gf256_mul(factor, pivot_row[c]);
+            }
+
+            kernel_(rows_[row].data(), rows_[rank].data(), factor, payload_size);
+        }
+
+        pivots_[col] = rank++;
+    }
+
+    return rank;
+}
+
+void SlidingReader::restore_packets_(size_t n_rows, size_t payload_size) {
+    const size_t n_cols = unknowns_.size();
+    const uint8_t* matrix = matrix_.data();
+
+    for (size_t col = 0; col < n_cols; col++) {
+        const uint32_t esi = unknowns_[col];
+
+        // Packets before next one were already skipped.
+        if (pivots_[col] == NoIndex || esi_diff(esi, next_esi_) < 0) {
+            continue;
+        }
+
+        const size_t row = pivots_[col];
+        roc_panic_if(row >= n_rows);
+
+        // Packet is determined only if its row doesn't depend on other unknowns.
+        bool solved = true;
+        for (size_t c = col + 1; c < n_cols; c++) {
+            if (matrix[row * n_cols + c] != 0) {
+                solved = false;
+                break;
+            }
+        }
+        if (!solved) {
+            continue;
+        }
+
+        core::Slice<uint8_t> buffer = packet_factory_.new_packet_buffer(payload_size);
+        if (!buffer) {
+            roc_log(LogError, "fec sliding reader: can't allocate buffer");
+            break;
+        }
+        buffer.reslice(0, payload_size);
+        memset(buffer.data(), 0, payload_size);
+
+        kernel_(buffer.data(), rows_[row].data(), gf256_inv(matrix[row * n_cols + col]),
+                payload_size);
+
+        packet::PacketPtr pp = parse_repaired_packet_(buffer);
+        if (!pp) {
+            continue;
+        }
+
+        roc_log(LogTrace, "fec sliding reader: restored packet: esi=%lu",
+                (unsigned long)esi);
+
+        ring_at_(esi) = pp;
+        if (esi_diff(esi, last_esi_) > 0) {
+            last_esi_ = esi;
+        }
+
+        n_restored_++;
+    }
+}
+
+packet::PacketPtr
+SlidingReader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        roc_log(LogError, "fec sliding reader: can't allocate packet");
+        return NULL;
+    }
+
+    if (!parser_.parse(*pp, buffer)) {
+        roc_log(LogDebug, "fec sliding reader: can't parse repaired packet");
+        return NULL;
+    }
+
+    pp->set_buffer(buffer);
+    pp->add_flags(packet::Packet::FlagRestored);
+
+    return pp;
+}
+
+bool SlidingReader::validate_fec_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+
+    if (!fec) {
+        roc_panic("fec sliding reader: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != packet::FEC_RLC) {
+        roc_log(LogDebug,
+                "fec sliding reader: unexpected packet fec scheme, shutting down:"
+                " packet_scheme=%s",
+                packet::fec_scheme_to_str(fec->fec_scheme));
+        return (alive_ = false);
+    }
+
+    return true;
+}
+
+bool SlidingReader::is_in_ring_(uint32_t esi) const {
+    const int32_t pos = esi_diff(esi, next_esi_);
+
+    return pos >= -(int32_t)RlcMaxWindow && pos < (int32_t)RlcMaxWindow;
+}
+
+packet::PacketPtr& SlidingReader::ring_at_(uint32_t esi) {
+    return ring_[esi % RingSize];
+}
+
+core::Slice<uint8_t> SlidingReader::symbol_(const packet::Packet& pp) const {
+    // Restored packets are not parsed by FEC parser, and their whole
+    // buffer is the symbol.
+    return pp.fec() ? pp.fec()->payload : pp.buffer();
+}
+
+} // namespace fec
+} // namespace roc
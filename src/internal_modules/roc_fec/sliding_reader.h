@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/sliding_reader.h
+//! @brief Sliding-window FEC reader.
+
+#ifndef ROC_FEC_SLIDING_READER_H_
+#define ROC_FEC_SLIDING_READER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_packet/iparser.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding-window FEC reader.
+//!
+//! @remarks
+//!  Implements RLC scheme (RFC 8681), counterpart of SlidingWriter.
+//!  Keeps recent source packets, including already returned ones, and
+//!  repair packets which encoding windows are not yet passed. When next
+//!  source packet is missing, solves linear system built from repair
+//!  packets covering it. Unlike block Reader, there is no need to wait
+//!  for the end of a block, only for the next repair packet.
+//!
+//! @remarks
+//!  Like block Reader, doesn't wait for missing packets: if a packet
+//!  can't be restored and there are later packets, it is skipped.
+class SlidingReader : public packet::IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p source_reader specifies input queue with data packets;
+    //!  - @p repair_reader specifies input queue with FEC packets;
+    //!  - @p parser specifies packet parser for restored packets.
+    //!  - @p packet_factory is used to allocate restored packets and buffers
+    //!  - @p arena is used to initialize packet arrays
+    SlidingReader(packet::IReader& source_reader,
+                  packet::IReader& repair_reader,
+                  packet::IParser& parser,
+                  packet::PacketFactory& packet_factory,
+                  core::IArena& arena);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Did reader get first source packet?
+    bool is_started() const;
+
+    //! Is reader alive?
+    bool is_alive() const;
+
+    //! Get metrics.
+    //! @remarks
+    //!  Only restored_packets is reported, other metrics are block-specific.
+    ReaderMetrics metrics() const;
+
+    //! Read packet.
+    //! @remarks
+    //!  When a packet loss is detected, try to restore it from repair packets.
+    virtual ROC_ATTR_NODISCARD status::StatusCode read(packet::PacketPtr&);
+
+private:
+    // Source packets are kept in ring indexed by ESI, which covers
+    // RlcMaxWindow packets before and after next packet to be read.
+    enum { RingSize = RlcMaxWindow * 2 };
+
+    // Maximum number of repair packets kept for decoding.
+    enum { MaxRepairPackets = RlcMaxWindow };
+
+    status::StatusCode read_(packet::PacketPtr&);
+
+    status::StatusCode fetch_packets_();
+    void add_source_packet_(const packet::PacketPtr&);
+    void add_repair_packet_(const packet::PacketPtr&);
+
+    void fill_ring_();
+    void reset_ring_(uint32_t esi);
+    void next_packet_();
+    bool has_later_packets_() const;
+    void drop_old_repair_packets_();
+
+    void try_repair_();
+    bool is_usable_repair_(const packet::Packet&, size_t payload_size);
+    size_t build_system_(size_t payload_size);
+    size_t solve_system_(size_t n_rows, size_t payload_size);
+    void restore_packets_(size_t n_rows, size_t payload_size);
+
+    packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
+
+    bool validate_fec_packet_(const packet::PacketPtr&);
+    bool is_in_ring_(uint32_t esi) const;
+
+    packet::PacketPtr& ring_at_(uint32_t esi);
+    core::Slice<uint8_t> symbol_(const packet::Packet&) const;
+
+    packet::IReader& source_reader_;
+    packet::IReader& repair_reader_;
+    packet::IParser& parser_;
+    packet::PacketFactory& packet_factory_;
+
+    Gf256KernelFunc kernel_;
+
+    packet::SortedQueue source_queue_;
+
+    core::Array<packet::PacketPtr> ring_;
+    core::Array<packet::PacketPtr> repairs_;
+
+    // Decoding workspace.
+    core::Array<uint8_t> coeffs_;
+    core::Array<uint8_t> matrix_;
+    core::Array<core::Slice<uint8_t> > rows_;
+    core::Array<uint32_t> unknowns_;
+    core::Array<size_t> columns_;
+    core::Array<size_t> pivots_;
+
+    uint32_t next_esi_;
+    uint32_t last_esi_;
+    uint32_t repair_esi_;
+
+    bool valid_;
+    bool alive_;
+    bool started_;
+    bool can_repair_;
+
+    uint64_t n_restored_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_SLIDING_READER_H_
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/sliding_writer.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+SlidingWriter::SlidingWriter(const WriterConfig& config,
+                             packet::IWriter& writer,
+                             packet::IComposer& source_composer,
+                             packet::IComposer& repair_composer,
+                             packet::PacketFactory& packet_factory,
+                             core::IArena& arena)
+    : writer_(writer)
+    , source_composer_(source_composer)
+    , repair_composer_(repair_composer)
+    , packet_factory_(packet_factory)
+    , kernel_(gf256_kernel_func(gf256_kernel_best()))
+    , window_(arena)
+    , coeffs_(arena)
+    , window_size_(config.n_source_packets)
+    , n_repair_(config.n_repair_packets)
+    , window_len_(0)
+    , ring_pos_(0)
+    , repair_pos_(0)
+    , payload_size_(0)
+    , next_esi_(0)
+    , repair_key_(0)
+    , valid_(false)
+    , alive_(true) {
+    if (window_size_ == 0 || window_size_ > RlcMaxWindow) {
+        roc_log(LogError,
+                "fec sliding writer: invalid window size: window=%lu max=%lu",
+                (unsigned long)window_size_, (unsigned long)RlcMaxWindow);
+        return;
+    }
+
+    if (!window_.resize(window_size_) || !coeffs_.resize(window_size_)) {
+        roc_log(LogError, "fec sliding writer: can't allocate window");
+        return;
+    }
+
+    next_esi_ = core::fast_random();
+    repair_key_ = (uint16_t)core::fast_random_range(0, uint16_t(-1));
+
+    roc_log(LogDebug,
+            "fec sliding writer: initializing: window=%lu repair_per_window=%lu",
+            (unsigned long)window_size_, (unsigned long)n_repair_);
+
+    valid_ = true;
+}
+
+bool SlidingWriter::is_valid() const {
+    return valid_;
+}
+
+bool SlidingWriter::is_alive() const {
+    return alive_;
+}
+
+status::StatusCode SlidingWriter::write(const packet::PacketPtr& pp) {
+    roc_panic_if_not(is_valid());
+    roc_panic_if_not(pp);
+
+    if (!alive_) {
+        // TODO(gh-183): return StatusDead
+        return status::StatusOK;
+    }
+
+    validate_fec_packet_(pp);
+
+    const size_t payload_size = pp->fec()->payload.size();
+    if (payload_size != payload_size_) {
+        restart_window_(payload_size);
+    }
+
+    status::StatusCode code = write_source_packet_(pp);
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    // Spread repair packets evenly: after i-th source packet of a cycle,
+    // total floor((i + 1) * n_repair / window_size) repair packets are written.
+    const size_t n_before = repair_pos_ * n_repair_ / window_size_;
+    const size_t n_after = (repair_pos_ + 1) * n_repair_ / window_size_;
+
+    repair_pos_ = (repair_pos_ + 1) % window_size_;
+
+    for (size_t n = n_before; n < n_after; n++) {
+        code = write_repair_packet_();
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
+    return status::StatusOK;
+}
+
+void SlidingWriter::restart_window_(size_t payload_size) {
+    if (window_len_ != 0) {
+        roc_log(LogDebug,
+                "fec sliding writer: payload size changed, restarting window:"
+                " old_size=%lu new_size=%lu",
+                (unsigned long)payload_size_, (unsigned long)payload_size);
+    }
+
+    for (size_t n = 0; n < window_.size(); n++) {
+        window_[n] = NULL;
+    }
+
+    window_len_ = 0;
+    payload_size_ = payload_size;
+}
+
+status::StatusCode SlidingWriter::write_source_packet_(const packet::PacketPtr& pp) {
+    pp->fec()->encoding_symbol_id = next_esi_;
+
+    if (!source_composer_.compose(*pp)) {
+        // TODO(gh-183): return status from composer
+        roc_panic("fec sliding writer: can't compose source packet");
+    }
+    pp->add_flags(packet::Packet::FlagComposed);
+
+    // Composing doesn't touch payload, so it can be used for encoding later.
+    window_[ring_pos_] = pp;
+    ring_pos_ = (ring_pos_ + 1) % window_size_;
+
+    if (window_len_ < window_size_) {
+        window_len_++;
+    }
+
+    next_esi_++;
+
+    return writer_.write(pp);
+}
+
+status::StatusCode SlidingWriter::write_repair_packet_() {
+    packet::PacketPtr rp = make_repair_packet_();
+    if (!rp) {
+        // TODO(gh-183): return StatusNoMem
+        return status::StatusOK;
+    }
+
+    if (!repair_composer_.compose(*rp)) {
+        // TODO(gh-183): return status from composer
+        roc_panic("fec sliding writer: can't compose repair packet");
+    }
+    rp->add_flags(packet::Packet::FlagComposed);
+
+    return writer_.write(rp);
+}
+
+packet::PacketPtr SlidingWriter::make_repair_packet_() {
+    packet::PacketPtr packet = packet_factory_.new_packet();
+    if (!packet) {
+        roc_log(LogError, "fec sliding writer: can't allocate packet");
+        return NULL;
+    }
+
+    core::Slice<uint8_t> buffer = packet_factory_.new_packet_buffer();
+    if (!buffer) {
+        roc_log(LogError, "fec sliding writer: can't allocate buffer");
+        return NULL;
+    }
+
+    if (!repair_composer_.align(buffer, 0, Alignment)) {
+        roc_log(LogError, "fec sliding writer: can't align packet buffer");
+        return NULL;
+    }
+
+    if (!repair_composer_.prepare(*packet, buffer, payload_size_)) {
+        roc_log(LogError, "fec sliding writer: can't prepare packet");
+        return NULL;
+    }
+    packet->add_flags(packet::Packet::FlagPrepared);
+
+    packet->set_buffer(buffer);
+
+    validate_fec_packet_(packet);
+
+    packet::FEC& fec = *packet->fec();
+
+    fec.encoding_symbol_id = uint32_t(next_esi_ - window_len_);
+    fec.source_block_number = repair_key_;
+    fec.source_block_length = window_len_;
+    fec.block_length = RlcMaxDensity;
+
+    rlc_make_coefficients(repair_key_, RlcMaxDensity, coeffs_.data(), window_len_);
+    repair_key_++;
+
+    uint8_t* payload = fec.payload.data();
+    memset(payload, 0, payload_size_);
+
+    for (size_t n = 0; n < window_len_; n++) {
+        const size_t pos = (ring_pos_ + window_size_ - window_len_ + n) % window_size_;
+        kernel_(payload, window_[pos]->fec()->payload.data(), coeffs_[n], payload_size_);
+    }
+
+    return packet;
+}
+
+void SlidingWriter::validate_fec_packet_(const packet::PacketPtr& pp) {
+    if (!pp->has_flags(packet::Packet::FlagPrepared)) {
+        roc_panic("fec sliding writer: unexpected packet: should be prepared");
+    }
+
+    if (pp->has_flags(packet::Packet::FlagComposed)) {
+        roc_panic("fec sliding writer: unexpected packet: should not be composed");
+    }
+
+    const packet::FEC* fec = pp->fec();
+    if (!fec) {
+        roc_panic("fec sliding writer: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != packet::FEC_RLC) {
+        roc_panic("fec sliding writer: unexpected packet fec scheme: packet_scheme=%s",
+                  packet::fec_scheme_to_str(fec->fec_scheme));
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/sliding_writer.h
+//! @brief Sliding-window FEC writer.
+
+#ifndef ROC_FEC_SLIDING_WRITER_H_
+#define ROC_FEC_SLIDING_WRITER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/icomposer.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding-window FEC writer.
+//!
+//! @remarks
+//!  Implements RLC scheme (RFC 8681). Unlike block Writer, repair packets
+//!  are not delayed until the end of a block. Each repair packet is a
+//!  random linear combination of the last source packets, which form
+//!  encoding window, and is written right after the source packet which
+//!  triggered it. Hence receiver can restore a loss as soon as the next
+//!  repair packet arrives, which reduces latency needed for FEC.
+//!
+//! @remarks
+//!  Uses WriterConfig: n_source_packets defines encoding window size, and
+//!  n_repair_packets defines how many repair packets are generated per
+//!  n_source_packets source packets; they're spread evenly.
+//!
+//! @remarks
+//!  All source packets in encoding window must have the same payload size.
+//!  If payload size changes, window is restarted.
+class SlidingWriter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config contains window and repair rate
+    //!  - @p writer is used to write source and repair packets
+    //!  - @p source_composer is used to format source packets
+    //!  - @p repair_composer is used to format repair packets
+    //!  - @p packet_factory is used to allocate repair packets and buffers
+    //!  - @p arena is used to initialize window
+    SlidingWriter(const WriterConfig& config,
+                  packet::IWriter& writer,
+                  packet::IComposer& source_composer,
+                  packet::IComposer& repair_composer,
+                  packet::PacketFactory& packet_factory,
+                  core::IArena& arena);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Check if writer is still working.
+    bool is_alive() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  - writes the given source packet to the output writer
+    //!  - adds it to encoding window, and if it's time for a repair
+    //!    packet, generates it and also writes it to the output writer
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
+
+private:
+    enum { Alignment = 8 };
+
+    void restart_window_(size_t payload_size);
+
+    status::StatusCode write_source_packet_(const packet::PacketPtr&);
+    status::StatusCode write_repair_packet_();
+    packet::PacketPtr make_repair_packet_();
+
+    void validate_fec_packet_(const packet::PacketPtr&);
+
+    packet::IWriter& writer_;
+
+    packet::IComposer& source_composer_;
+    packet::IComposer& repair_composer_;
+
+    packet::PacketFactory& packet_factory_;
+
+    Gf256KernelFunc kernel_;
+
+    core::Array<packet::PacketPtr> window_;
+    core::Array<uint8_t> coeffs_;
+
+    const size_t window_size_;
+    const size_t n_repair_;
+
+    size_t window_len_;
+    size_t ring_pos_;
+    size_t repair_pos_;
+    size_t payload_size_;
+
+    uint32_t next_esi_;
+    uint16_t repair_key_;
+
+    bool valid_;
+    bool alive_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_SLIDING_WRITER_H_
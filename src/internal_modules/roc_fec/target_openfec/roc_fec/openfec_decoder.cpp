@@ -35,6 +35,7 @@ OpenfecDecoder::OpenfecDecoder(const CodecConfig& config,
     , status_(arena)
     , has_new_packets_(false)
     , decoding_finished_(false)
+    , n_copied_bytes_(0)
     , valid_(false) {
     if (config.scheme == packet::FEC_ReedSolomon_M8) {
         roc_log(LogDebug, "openfec decoder: initializing: codec=rs m=%u",
@@ -165,6 +166,10 @@ void OpenfecDecoder::end() {
     decoding_finished_ = false;
 }
 
+uint64_t OpenfecDecoder::num_copied_bytes() const {
+    return n_copied_bytes_;
+}
+
 void OpenfecDecoder::update_session_params_(size_t sblen,
                                             size_t rblen,
                                             size_t payload_size) {
@@ -379,6 +384,7 @@ void OpenfecDecoder::fix_buffer_(size_t index) {
 
         if (void* buff = make_buffer_(index)) {
             memcpy(buff, data_tab_[index], payload_size_);
+            n_copied_bytes_ += payload_size_;
         }
     }
 }
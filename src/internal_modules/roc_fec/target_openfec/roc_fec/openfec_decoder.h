@@ -72,6 +72,9 @@ public:
     //!  all operations for the block.
     virtual void end();
 
+    //! Get number of payload bytes copied by decoder.
+    virtual uint64_t num_copied_bytes() const;
+
 private:
     void update_session_params_(size_t sblen, size_t rblen, size_t payload_size);
 
@@ -128,6 +131,8 @@ private:
     bool has_new_packets_;
     bool decoding_finished_;
 
+    uint64_t n_copied_bytes_;
+
     size_t max_block_length_;
 
     bool valid_;
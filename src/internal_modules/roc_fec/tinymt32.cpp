@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/tinymt32.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// RFC 8682 parameter set.
+const uint32_t Mat1 = 0x8f7011eeu;
+const uint32_t Mat2 = 0xfc78ff1fu;
+const uint32_t TMat = 0x3793fdffu;
+
+const uint32_t Mask = 0x7fffffffu;
+
+const uint32_t Sh0 = 1;
+const uint32_t Sh1 = 10;
+const uint32_t Sh8 = 8;
+
+const uint32_t MinLoop = 8;
+const uint32_t PreLoop = 8;
+
+// All ones if lowest bit is set, zero otherwise.
+inline uint32_t bit_mask(uint32_t x) {
+    return uint32_t(0) - (x & 1);
+}
+
+} // namespace
+
+TinyMT32::TinyMT32(uint32_t seed) {
+    status_[0] = seed;
+    status_[1] = Mat1;
+    status_[2] = Mat2;
+    status_[3] = TMat;
+
+    for (uint32_t i = 1; i < MinLoop; i++) {
+        const uint32_t prev = status_[(i - 1) & 3];
+        status_[i & 3] ^= i + 1812433253u * (prev ^ (prev >> 30));
+    }
+
+    // Period certification.
+    if ((status_[0] & Mask) == 0 && status_[1] == 0 && status_[2] == 0
+        && status_[3] == 0) {
+        status_[0] = 'T';
+        status_[1] = 'I';
+        status_[2] = 'N';
+        status_[3] = 'Y';
+    }
+
+    for (uint32_t i = 0; i < PreLoop; i++) {
+        next_state_();
+    }
+}
+
+uint32_t TinyMT32::next_u32() {
+    next_state_();
+    return temper_();
+}
+
+void TinyMT32::next_state_() {
+    uint32_t y = status_[3];
+    uint32_t x = (status_[0] & Mask) ^ status_[1] ^ status_[2];
+
+    x ^= (x << Sh0);
+    y ^= (y >> Sh0) ^ x;
+
+    status_[0] = status_[1];
+    status_[1] = status_[2];
+    status_[2] = x ^ (y << Sh1);
+    status_[3] = y;
+
+    status_[1] ^= bit_mask(y) & Mat1;
+    status_[2] ^= bit_mask(y) & Mat2;
+}
+
+uint32_t TinyMT32::temper_() const {
+    uint32_t t0 = status_[3];
+    const uint32_t t1 = status_[0] + (status_[2] >> Sh8);
+
+    t0 ^= t1;
+    t0 ^= bit_mask(t1) & TMat;
+
+    return t0;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/tinymt32.h
+//! @brief TinyMT32 PRNG.
+
+#ifndef ROC_FEC_TINYMT32_H_
+#define ROC_FEC_TINYMT32_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! TinyMT32 pseudo-random number generator.
+//!
+//! @remarks
+//!  Implements generator specified in RFC 8682, with the parameter set
+//!  mandated there. Sender and receiver of RLC repair packets must get
+//!  exactly the same sequence for the same seed, so the output is fixed
+//!  by RFC and must not change.
+class TinyMT32 {
+public:
+    //! Initialize with given seed.
+    explicit TinyMT32(uint32_t seed);
+
+    //! Get next 32-bit number.
+    uint32_t next_u32();
+
+    //! Get next number in range [0; 256).
+    uint32_t next_u8() {
+        return next_u32() & 0xFF;
+    }
+
+    //! Get next number in range [0; 16).
+    uint32_t next_u4() {
+        return next_u32() & 0xF;
+    }
+
+private:
+    void next_state_();
+    uint32_t temper_() const;
+
+    uint32_t status_[4];
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_TINYMT32_H_
@@ -35,6 +35,7 @@ Writer::Writer(const WriterConfig& config,
     , repair_composer_(repair_composer)
     , packet_factory_(packet_factory)
     , repair_block_(arena)
+    , cur_block_(NULL)
     , first_packet_(true)
     , cur_packet_(0)
     , fec_scheme_(fec_scheme)
@@ -46,6 +47,13 @@ Writer::Writer(const WriterConfig& config,
     if (!resize(config.n_source_packets, config.n_repair_packets)) {
         return;
     }
+    if (config.max_pending_blocks != 0) {
+        worker_.reset(new (worker_)
+                          EncoderWorker(encoder_, config.max_pending_blocks, arena));
+        if (!worker_ || !worker_->is_valid()) {
+            return;
+        }
+    }
     valid_ = true;
 }
 
@@ -91,6 +99,12 @@ bool Writer::resize(size_t sblen, size_t rblen) {
     return true;
 }
 
+WriterMetrics Writer::metrics() const {
+    WriterMetrics metrics = metrics_;
+    metrics.pending_blocks = worker_ ? worker_->num_pending() : 0;
+    return metrics;
+}
+
 status::StatusCode Writer::write(const packet::PacketPtr& pp) {
     roc_panic_if_not(is_valid());
     roc_panic_if_not(pp);
@@ -100,6 +114,8 @@ status::StatusCode Writer::write(const packet::PacketPtr& pp) {
         return status::StatusOK;
     }
 
+    write_ready_blocks_();
+
     validate_fec_packet_(pp);
 
     if (first_packet_) {
@@ -132,6 +148,16 @@ status::StatusCode Writer::write(const packet::PacketPtr& pp) {
     return status::StatusOK;
 }
 
+void Writer::flush() {
+    roc_panic_if_not(is_valid());
+
+    if (!alive_) {
+        return;
+    }
+
+    write_ready_blocks_();
+}
+
 bool Writer::begin_block_(const packet::PacketPtr& pp) {
     if (!apply_sizes_(next_sblen_, next_rblen_, pp->fec()->payload.size())) {
         return false;
@@ -142,6 +168,19 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
             (unsigned long)cur_sbn_, (unsigned long)cur_sblen_, (unsigned long)cur_rblen_,
             (unsigned long)cur_payload_size_);
 
+    if (worker_) {
+        // Encoder is owned by worker thread, just reserve block for it.
+        cur_block_ = worker_->acquire(cur_sblen_, cur_rblen_, cur_payload_size_);
+        if (!cur_block_) {
+            roc_log(LogDebug,
+                    "fec writer: encoder lags behind, dropping repair packets:"
+                    " sbn=%lu pending_blocks=%lu",
+                    (unsigned long)cur_sbn_, (unsigned long)worker_->num_pending());
+            metrics_.dropped_blocks++;
+        }
+        return true;
+    }
+
     if (!encoder_.begin(cur_sblen_, cur_rblen_, cur_payload_size_)) {
         roc_log(LogError,
                 "fec writer: can't begin encoder block, shutting down:"
@@ -154,12 +193,19 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
 }
 
 void Writer::end_block_() {
+    if (worker_) {
+        submit_block_();
+        return;
+    }
+
     make_repair_packets_();
     encode_repair_packets_();
-    compose_repair_packets_();
-    write_repair_packets_();
+    compose_repair_packets_(repair_block_);
+    write_repair_packets_(repair_block_);
 
     encoder_.end();
+
+    metrics_.encoded_blocks++;
 }
 
 void Writer::next_block_() {
@@ -168,6 +214,48 @@ void Writer::next_block_() {
     cur_packet_ = 0;
 }
 
+void Writer::submit_block_() {
+    if (!cur_block_) {
+        return;
+    }
+
+    make_repair_packets_();
+
+    for (size_t i = 0; i < cur_rblen_; i++) {
+        cur_block_->repair_packets[i] = repair_block_[i];
+        repair_block_[i] = NULL;
+    }
+
+    worker_->submit(cur_block_);
+    cur_block_ = NULL;
+}
+
+void Writer::write_ready_blocks_() {
+    if (!worker_) {
+        return;
+    }
+
+    while (EncoderBlock* block = worker_->poll()) {
+        const core::nanoseconds_t lag =
+            core::timestamp(core::ClockMonotonic) - block->submit_time;
+
+        metrics_.encoding_lag = lag;
+        metrics_.max_encoding_lag = std::max(metrics_.max_encoding_lag, lag);
+
+        if (block->encoded) {
+            compose_repair_packets_(block->repair_packets);
+            write_repair_packets_(block->repair_packets);
+
+            metrics_.encoded_blocks++;
+        } else {
+            roc_log(LogError, "fec writer: can't encode block, shutting down");
+            alive_ = false;
+        }
+
+        worker_->release(block);
+    }
+}
+
 bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
     if (payload_size == 0) {
         roc_log(LogError, "fec writer: payload size can't be zero");
@@ -192,7 +280,15 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
 }
 
 status::StatusCode Writer::write_source_packet_(const packet::PacketPtr& pp) {
-    encoder_.set(cur_packet_, pp->fec()->payload);
+    if (worker_) {
+        // Payload will be passed to encoder by worker thread, after the packet
+        // is composed and written. Composing doesn't touch payload.
+        if (cur_block_) {
+            cur_block_->source_packets[cur_packet_] = pp;
+        }
+    } else {
+        encoder_.set(cur_packet_, pp->fec()->payload);
+    }
 
     fill_packet_fec_fields_(pp, (packet::seqnum_t)cur_packet_);
 
@@ -260,9 +356,9 @@ void Writer::encode_repair_packets_() {
     encoder_.fill();
 }
 
-void Writer::compose_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+void Writer::compose_repair_packets_(core::Array<packet::PacketPtr>& repair_packets) {
+    for (size_t i = 0; i < repair_packets.size(); i++) {
+        packet::PacketPtr rp = repair_packets[i];
         if (!rp) {
             continue;
         }
@@ -275,18 +371,19 @@ void Writer::compose_repair_packets_() {
     }
 }
 
-status::StatusCode Writer::write_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+status::StatusCode
+Writer::write_repair_packets_(core::Array<packet::PacketPtr>& repair_packets) {
+    for (size_t i = 0; i < repair_packets.size(); i++) {
+        packet::PacketPtr rp = repair_packets[i];
         if (!rp) {
             continue;
         }
 
-        const status::StatusCode code = writer_.write(repair_block_[i]);
+        const status::StatusCode code = writer_.write(repair_packets[i]);
         // TODO(gh-183): forward status
         roc_panic_if(code != status::StatusOK);
 
-        repair_block_[i] = NULL;
+        repair_packets[i] = NULL;
     }
 
     return status::StatusOK;
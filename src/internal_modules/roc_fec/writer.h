@@ -15,7 +15,10 @@
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/slice.h"
+#include "roc_core/time.h"
+#include "roc_fec/encoder_worker.h"
 #include "roc_fec/iblock_encoder.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
@@ -33,9 +36,46 @@ struct WriterConfig {
     //! Number of FEC packets in block.
     size_t n_repair_packets;
 
+    //! Maximum number of blocks being encoded asynchronously.
+    //! If non-zero, repair packets are encoded on a dedicated thread, and
+    //! source packets are written without waiting for them. If encoding lags
+    //! behind by more than this number of blocks, repair packets of new blocks
+    //! are dropped. If zero, repair packets are encoded synchronously in write().
+    size_t max_pending_blocks;
+
     WriterConfig()
         : n_source_packets(18)
-        , n_repair_packets(10) {
+        , n_repair_packets(10)
+        , max_pending_blocks(0) {
+    }
+};
+
+//! FEC writer metrics.
+struct WriterMetrics {
+    //! Cumulative count of blocks for which repair packets were written.
+    uint64_t encoded_blocks;
+
+    //! Cumulative count of blocks for which repair packets were dropped
+    //! because asynchronous encoding lagged too much.
+    uint64_t dropped_blocks;
+
+    //! Number of blocks being encoded asynchronously right now.
+    size_t pending_blocks;
+
+    //! Delay between writing last source packet of a block and writing its
+    //! repair packets, for the most recent block.
+    //! Always zero when encoding is synchronous.
+    core::nanoseconds_t encoding_lag;
+
+    //! Maximum value of encoding_lag seen so far.
+    core::nanoseconds_t max_encoding_lag;
+
+    WriterMetrics()
+        : encoded_blocks(0)
+        , dropped_blocks(0)
+        , pending_blocks(0)
+        , encoding_lag(0)
+        , max_encoding_lag(0) {
     }
 };
 
@@ -71,25 +111,39 @@ public:
     //! Set number of source packets per block.
     bool resize(size_t sblen, size_t rblen);
 
+    //! Get metrics.
+    WriterMetrics metrics() const;
+
     //! Write packet.
     //! @remarks
     //!  - writes the given source packet to the output writer
     //!  - generates repair packets and also writes them to the output writer
+    //!  - in asynchronous mode, repair packets are written by one of the
+    //!    subsequent write() or flush() calls, when they are ready
     virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&);
 
+    //! Write repair packets that were encoded asynchronously and are ready.
+    //! @remarks
+    //!  Does nothing in synchronous mode.
+    void flush();
+
 private:
     bool begin_block_(const packet::PacketPtr& pp);
     void end_block_();
     void next_block_();
 
+    void submit_block_();
+    void write_ready_blocks_();
+
     bool apply_sizes_(size_t sblen, size_t rblen, size_t payload_size);
 
     status::StatusCode write_source_packet_(const packet::PacketPtr&);
     void make_repair_packets_();
     packet::PacketPtr make_repair_packet_(packet::seqnum_t n);
     void encode_repair_packets_();
-    void compose_repair_packets_();
-    status::StatusCode write_repair_packets_();
+    void compose_repair_packets_(core::Array<packet::PacketPtr>& repair_packets);
+    status::StatusCode
+    write_repair_packets_(core::Array<packet::PacketPtr>& repair_packets);
     void fill_packet_fec_fields_(const packet::PacketPtr& packet, packet::seqnum_t n);
 
     void validate_fec_packet_(const packet::PacketPtr&);
@@ -113,6 +167,11 @@ private:
 
     core::Array<packet::PacketPtr> repair_block_;
 
+    core::Optional<EncoderWorker> worker_;
+    EncoderBlock* cur_block_;
+
+    WriterMetrics metrics_;
+
     bool first_packet_;
 
     packet::blknum_t cur_sbn_;
@@ -12,13 +12,22 @@
 #include "roc_core/macro_helpers.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_netio/socket_ops.h"
+
+#ifdef ROC_TARGET_POSIX_EXT
+#include "roc_netio/shm_port.h"
+#endif // ROC_TARGET_POSIX_EXT
 
 namespace roc {
 namespace netio {
 
-NetworkLoop::Tasks::AddUdpPort::AddUdpPort(UdpConfig& config) {
+NetworkLoop::Tasks::AddUdpPort::AddUdpPort(UdpConfig& config,
+                                           packet::PacketFactory* packet_factory,
+                                           packet::CaptureRing* capture_ring) {
     func_ = &NetworkLoop::task_add_udp_port_;
     config_ = &config;
+    packet_factory_ = packet_factory;
+    capture_ring_ = capture_ring;
 }
 
 NetworkLoop::PortHandle NetworkLoop::Tasks::AddUdpPort::get_handle() const {
@@ -53,6 +62,60 @@ NetworkLoop::Tasks::StartUdpRecv::StartUdpRecv(PortHandle handle,
     inbound_writer_ = &inbound_writer;
 }
 
+NetworkLoop::Tasks::StartUdpInlineRecv::StartUdpInlineRecv(PortHandle handle) {
+    func_ = &NetworkLoop::task_start_udp_inline_recv_;
+    if (!handle) {
+        roc_panic("network loop: port handle is null");
+    }
+    port_ = (BasicPort*)handle;
+    inbound_reader_ = NULL;
+}
+
+packet::IReader& NetworkLoop::Tasks::StartUdpInlineRecv::get_inbound_reader() const {
+    roc_panic_if(!success());
+    roc_panic_if(!inbound_reader_);
+    return *inbound_reader_;
+}
+
+NetworkLoop::Tasks::AddShmPort::AddShmPort(ShmConfig& config,
+                                           packet::PacketFactory* packet_factory) {
+    func_ = &NetworkLoop::task_add_shm_port_;
+    config_ = &config;
+    packet_factory_ = packet_factory;
+}
+
+NetworkLoop::PortHandle NetworkLoop::Tasks::AddShmPort::get_handle() const {
+    if (!success()) {
+        return NULL;
+    }
+    roc_panic_if_not(port_handle_);
+    return (PortHandle)port_handle_;
+}
+
+NetworkLoop::Tasks::StartShmSend::StartShmSend(PortHandle handle) {
+    func_ = &NetworkLoop::task_start_shm_send_;
+    if (!handle) {
+        roc_panic("network loop: port handle is null");
+    }
+    port_ = (BasicPort*)handle;
+}
+
+packet::IWriter& NetworkLoop::Tasks::StartShmSend::get_outbound_writer() const {
+    roc_panic_if(!success());
+    roc_panic_if(!outbound_writer_);
+    return *outbound_writer_;
+}
+
+NetworkLoop::Tasks::StartShmRecv::StartShmRecv(PortHandle handle,
+                                               packet::IWriter& inbound_writer) {
+    func_ = &NetworkLoop::task_start_shm_recv_;
+    if (!handle) {
+        roc_panic("network loop: port handle is null");
+    }
+    port_ = (BasicPort*)handle;
+    inbound_writer_ = &inbound_writer;
+}
+
 NetworkLoop::Tasks::AddTcpServerPort::AddTcpServerPort(TcpServerConfig& config,
                                                        IConnAcceptor& conn_acceptor) {
     func_ = &NetworkLoop::task_add_tcp_server_;
@@ -102,16 +165,32 @@ NetworkLoop::Tasks::ResolveEndpointAddress::get_address() const {
     return resolve_req_.resolved_address;
 }
 
+NetworkLoop::Tasks::QueryPathMtu::QueryPathMtu(
+    const address::SocketAddr& remote_address) {
+    func_ = &NetworkLoop::task_query_path_mtu_;
+    remote_address_ = remote_address;
+    mtu_ = 0;
+}
+
+size_t NetworkLoop::Tasks::QueryPathMtu::get_mtu() const {
+    roc_panic_if(!success());
+    return mtu_;
+}
+
 NetworkLoop::NetworkLoop(core::IPool& packet_pool,
                          core::IPool& buffer_pool,
-                         core::IArena& arena)
-    : packet_factory_(packet_pool, buffer_pool)
+                         core::IArena& arena,
+                         const core::ThreadConfig& thread_config,
+                         const ResolverConfig& resolver_config)
+    : Thread(thread_config)
+    , packet_factory_(packet_pool, buffer_pool)
     , arena_(arena)
+    , capture_ring_(NULL)
     , started_(false)
     , loop_initialized_(false)
     , stop_sem_initialized_(false)
+    , resolver_(resolver_config, *this, loop_, arena)
     , task_sem_initialized_(false)
-    , resolver_(*this, loop_)
     , num_open_ports_(0) {
     if (int err = uv_loop_init(&loop_)) {
         roc_log(LogError, "network loop: uv_loop_init(): [%s] %s", uv_err_name(err),
@@ -176,10 +255,38 @@ bool NetworkLoop::is_valid() const {
     return started_;
 }
 
+void NetworkLoop::add_small_packet_buffer_pool(core::IPool& buffer_pool) {
+    if (num_open_ports_ != 0) {
+        roc_panic("network loop: can't add buffer pool when there are open ports");
+    }
+
+    packet_factory_.add_small_buffer_pool(buffer_pool);
+}
+
+void NetworkLoop::set_packet_capture(packet::CaptureRing& capture_ring) {
+    if (num_open_ports_ != 0) {
+        roc_panic("network loop: can't set packet capture when there are open ports");
+    }
+
+    capture_ring_ = &capture_ring;
+}
+
 size_t NetworkLoop::num_ports() const {
     return (size_t)num_open_ports_;
 }
 
+size_t NetworkLoop::num_task_wakeups() const {
+    return (size_t)task_wakeups_;
+}
+
+size_t NetworkLoop::num_resolver_cache_hits() const {
+    return resolver_.num_cache_hits();
+}
+
+size_t NetworkLoop::num_resolver_cache_misses() const {
+    return resolver_.num_cache_misses();
+}
+
 void NetworkLoop::schedule(NetworkTask& task, INetworkTaskCompleter& completer) {
     if (!is_valid()) {
         roc_panic("network loop: can't use invalid loop");
@@ -193,11 +300,7 @@ void NetworkLoop::schedule(NetworkTask& task, INetworkTaskCompleter& completer)
     task.state_ = NetworkTask::StatePending;
 
     pending_tasks_.push_back(task);
-
-    if (int err = uv_async_send(&task_sem_)) {
-        roc_panic("network loop: uv_async_send(): [%s] %s", uv_err_name(err),
-                  uv_strerror(err));
-    }
+    signal_task_sem_();
 }
 
 bool NetworkLoop::schedule_and_wait(NetworkTask& task) {
@@ -217,11 +320,7 @@ bool NetworkLoop::schedule_and_wait(NetworkTask& task) {
     task.state_ = NetworkTask::StatePending;
 
     pending_tasks_.push_back(task);
-
-    if (int err = uv_async_send(&task_sem_)) {
-        roc_panic("network loop: uv_async_send(): [%s] %s", uv_err_name(err),
-                  uv_strerror(err));
-    }
+    signal_task_sem_();
 
     task.sem_->wait();
 
@@ -288,9 +387,30 @@ void NetworkLoop::task_sem_cb_(uv_async_t* handle) {
     roc_panic_if_not(handle);
 
     NetworkLoop& self = *(NetworkLoop*)handle->data;
+
+    self.task_wakeups_++;
+    self.process_pending_tasks_();
+
+    // While flag is set, schedule() doesn't signal semaphore, relying on us to
+    // drain the queue. After clearing it, pick up tasks that were pushed
+    // before it was cleared; tasks pushed after will signal again.
+    self.task_sem_pending_ = 0;
     self.process_pending_tasks_();
 }
 
+void NetworkLoop::signal_task_sem_() {
+    // Only first producer after network thread went idle wakes it up,
+    // the rest tasks are picked up before network thread goes idle.
+    if (task_sem_pending_.exchange(1) != 0) {
+        return;
+    }
+
+    if (int err = uv_async_send(&task_sem_)) {
+        roc_panic("network loop: uv_async_send(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
+    }
+}
+
 void NetworkLoop::stop_sem_cb_(uv_async_t* handle) {
     roc_panic_if_not(handle);
 
@@ -304,8 +424,9 @@ void NetworkLoop::process_pending_tasks_() {
     // Using try_pop_front_exclusive() makes this method lock-free and wait-free.
     // try_pop_front_exclusive() may return NULL if the queue is not empty, but
     // push_back() is currently in progress. In this case we can exit the loop
-    // before processing all tasks, but schedule() always calls uv_async_send()
-    // after push_back(), so we'll wake up soon and process the rest tasks.
+    // before processing all tasks, but schedule() signals semaphore after
+    // push_back() unless we're going to drain the queue once more before
+    // going idle, so we'll process the rest tasks soon.
     while (NetworkTask* task = pending_tasks_.try_pop_front_exclusive()) {
         (this->*(task->func_))(*task);
 
@@ -385,8 +506,10 @@ void NetworkLoop::close_all_sems_() {
 void NetworkLoop::task_add_udp_port_(NetworkTask& base_task) {
     Tasks::AddUdpPort& task = (Tasks::AddUdpPort&)base_task;
 
-    core::SharedPtr<UdpPort> port =
-        new (arena_) UdpPort(*task.config_, loop_, packet_factory_, arena_);
+    core::SharedPtr<UdpPort> port = new (arena_) UdpPort(
+        *task.config_, loop_,
+        task.packet_factory_ ? *task.packet_factory_ : packet_factory_,
+        task.capture_ring_ ? task.capture_ring_ : capture_ring_, arena_);
     if (!port) {
         roc_log(LogError, "network loop: can't add udp port %s: allocate failed",
                 address::socket_addr_to_str(task.config_->bind_address).c_str());
@@ -459,6 +582,129 @@ void NetworkLoop::task_start_udp_recv_(NetworkTask& base_task) {
     task.state_ = NetworkTask::StateFinishing;
 }
 
+void NetworkLoop::task_start_udp_inline_recv_(NetworkTask& base_task) {
+    Tasks::StartUdpInlineRecv& task = (Tasks::StartUdpInlineRecv&)base_task;
+
+    roc_log(LogDebug, "network loop: starting receiving packets inline on port %s",
+            task.port_->descriptor());
+
+    core::SharedPtr<UdpPort> port = (UdpPort*)task.port_.get();
+
+    if (!(task.inbound_reader_ = port->start_inline_recv())) {
+        roc_log(LogError, "network loop: can't start receiving inline on port %s",
+                task.port_->descriptor());
+        task.success_ = false;
+        task.state_ = NetworkTask::StateFinishing;
+        return;
+    }
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+#ifdef ROC_TARGET_POSIX_EXT
+
+void NetworkLoop::task_add_shm_port_(NetworkTask& base_task) {
+    Tasks::AddShmPort& task = (Tasks::AddShmPort&)base_task;
+
+    core::SharedPtr<ShmPort> port = new (arena_) ShmPort(
+        *task.config_, task.packet_factory_ ? *task.packet_factory_ : packet_factory_,
+        arena_);
+    if (!port) {
+        roc_log(LogError, "network loop: can't add shm port %s: allocate failed",
+                address::socket_addr_to_str(task.config_->address).c_str());
+        task.success_ = false;
+        task.state_ = NetworkTask::StateFinishing;
+        return;
+    }
+
+    task.port_ = port;
+
+    if (!port->open()) {
+        roc_log(LogError, "network loop: can't add shm port %s: start failed",
+                address::socket_addr_to_str(task.config_->address).c_str());
+        task.success_ = false;
+        if (async_close_port_(port, &task) == AsyncOp_Started) {
+            task.state_ = NetworkTask::StateClosingPort;
+        } else {
+            task.state_ = NetworkTask::StateFinishing;
+        }
+        return;
+    }
+
+    open_ports_.push_back(*port);
+    update_num_ports_();
+
+    task.port_handle_ = port.get();
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+void NetworkLoop::task_start_shm_send_(NetworkTask& base_task) {
+    Tasks::StartShmSend& task = (Tasks::StartShmSend&)base_task;
+
+    roc_log(LogDebug, "network loop: starting sending packets on port %s",
+            task.port_->descriptor());
+
+    core::SharedPtr<ShmPort> port = (ShmPort*)task.port_.get();
+
+    if (!(task.outbound_writer_ = port->start_send())) {
+        roc_log(LogError, "network loop: can't start sending on port %s",
+                task.port_->descriptor());
+        task.success_ = false;
+        task.state_ = NetworkTask::StateFinishing;
+        return;
+    }
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+void NetworkLoop::task_start_shm_recv_(NetworkTask& base_task) {
+    Tasks::StartShmRecv& task = (Tasks::StartShmRecv&)base_task;
+
+    roc_log(LogDebug, "network loop: starting receiving packets on port %s",
+            task.port_->descriptor());
+
+    core::SharedPtr<ShmPort> port = (ShmPort*)task.port_.get();
+
+    if (!port->start_recv(*task.inbound_writer_)) {
+        roc_log(LogError, "network loop: can't start receiving on port %s",
+                task.port_->descriptor());
+        task.success_ = false;
+        task.state_ = NetworkTask::StateFinishing;
+        return;
+    }
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+#else // !ROC_TARGET_POSIX_EXT
+
+void NetworkLoop::task_add_shm_port_(NetworkTask& base_task) {
+    Tasks::AddShmPort& task = (Tasks::AddShmPort&)base_task;
+
+    roc_log(LogError,
+            "network loop: can't add shm port %s:"
+            " shared memory transport is not supported on this platform",
+            address::socket_addr_to_str(task.config_->address).c_str());
+
+    task.success_ = false;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+void NetworkLoop::task_start_shm_send_(NetworkTask&) {
+    roc_panic("network loop: shared memory transport is not supported");
+}
+
+void NetworkLoop::task_start_shm_recv_(NetworkTask&) {
+    roc_panic("network loop: shared memory transport is not supported");
+}
+
+#endif // ROC_TARGET_POSIX_EXT
+
 void NetworkLoop::task_add_tcp_server_(NetworkTask& base_task) {
     Tasks::AddTcpServerPort& task = (Tasks::AddTcpServerPort&)base_task;
 
@@ -577,5 +823,22 @@ void NetworkLoop::task_resolve_endpoint_address_(NetworkTask& base_task) {
     task.state_ = NetworkTask::StatePending;
 }
 
+void NetworkLoop::task_query_path_mtu_(NetworkTask& base_task) {
+    Tasks::QueryPathMtu& task = (Tasks::QueryPathMtu&)base_task;
+
+    task.success_ = socket_get_path_mtu(task.remote_address_, task.mtu_);
+
+    if (task.success_) {
+        roc_log(LogDebug, "network loop: path mtu to %s is %lu",
+                address::socket_addr_to_str(task.remote_address_).c_str(),
+                (unsigned long)task.mtu_);
+    } else {
+        roc_log(LogDebug, "network loop: can't determine path mtu to %s",
+                address::socket_addr_to_str(task.remote_address_).c_str());
+    }
+
+    task.state_ = NetworkTask::StateFinishing;
+}
+
 } // namespace netio
 } // namespace roc
@@ -15,6 +15,7 @@
 #include <uv.h>
 
 #include "roc_address/socket_addr.h"
+#include "roc_core/align_ops.h"
 #include "roc_core/atomic.h"
 #include "roc_core/attributes.h"
 #include "roc_core/iarena.h"
@@ -34,9 +35,12 @@
 #include "roc_netio/iterminate_handler.h"
 #include "roc_netio/network_task.h"
 #include "roc_netio/resolver.h"
+#include "roc_netio/shm_config.h"
 #include "roc_netio/tcp_connection_port.h"
 #include "roc_netio/tcp_server_port.h"
 #include "roc_netio/udp_port.h"
+#include "roc_packet/capture_ring.h"
+#include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_factory.h"
 
@@ -62,8 +66,14 @@ public:
         public:
             //! Set task parameters.
             //! @remarks
-            //!  Updates @p config with the actual bind address.
-            AddUdpPort(UdpConfig& config);
+            //!  - Updates @p config with the actual bind address.
+            //!  - If @p packet_factory is not NULL, received packets are allocated
+            //!    from it instead of the loop's own pools.
+            //!  - If @p capture_ring is not NULL, packets of the port are captured
+            //!    into it instead of the ring set by set_packet_capture().
+            AddUdpPort(UdpConfig& config,
+                       packet::PacketFactory* packet_factory = NULL,
+                       packet::CaptureRing* capture_ring = NULL);
 
             //! Get created port handle.
             //! @pre
@@ -74,6 +84,8 @@ public:
             friend class NetworkLoop;
 
             UdpConfig* config_;
+            packet::PacketFactory* packet_factory_;
+            packet::CaptureRing* capture_ring_;
         };
 
         //! Start sending on UDP port.
@@ -111,6 +123,85 @@ public:
             packet::IWriter* inbound_writer_;
         };
 
+        //! Start receiving inline on UDP port.
+        class StartUdpInlineRecv : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  get_inbound_reader() returns a reader for received packets. It
+            //!  polls socket without blocking from the thread that invokes it,
+            //!  instead of network thread.
+            StartUdpInlineRecv(PortHandle handle);
+
+            //! Get created reader for inbound packets.
+            //! @pre
+            //!  Should be called only after success() is true.
+            packet::IReader& get_inbound_reader() const;
+
+        private:
+            friend class NetworkLoop;
+
+            packet::IReader* inbound_reader_;
+        };
+
+        //! Add shared memory sender/receiver port.
+        class AddShmPort : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  - Task fails if shared memory transport is not supported
+            //!    on this platform.
+            //!  - If @p packet_factory is not NULL, received packets are allocated
+            //!    from it instead of the loop's own pools.
+            AddShmPort(ShmConfig& config, packet::PacketFactory* packet_factory = NULL);
+
+            //! Get created port handle.
+            //! @pre
+            //!  Should be called only after success() is true.
+            PortHandle get_handle() const;
+
+        private:
+            friend class NetworkLoop;
+
+            ShmConfig* config_;
+            packet::PacketFactory* packet_factory_;
+        };
+
+        //! Start sending on shared memory port.
+        class StartShmSend : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  get_outbound_writer() returns a writer for packets to be send.
+            //!  It may be used from another thread. It doesn't block the caller.
+            StartShmSend(PortHandle handle);
+
+            //! Get created writer for outbound packets.
+            //! @pre
+            //!  Should be called only after success() is true.
+            packet::IWriter& get_outbound_writer() const;
+
+        private:
+            friend class NetworkLoop;
+
+            packet::IWriter* outbound_writer_;
+        };
+
+        //! Start receiving on shared memory port.
+        class StartShmRecv : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  Received packets will be passed to @p inbound_writer.
+            //!  It is invoked from port thread. It should not block the caller.
+            StartShmRecv(PortHandle handle, packet::IWriter& inbound_writer);
+
+        private:
+            friend class NetworkLoop;
+
+            packet::IWriter* inbound_writer_;
+        };
+
         //! Add TCP server port.
         class AddTcpServerPort : public NetworkTask {
         public:
@@ -184,12 +275,38 @@ public:
 
             ResolverRequest resolve_req_;
         };
+
+        //! Query path MTU.
+        class QueryPathMtu : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  Asks OS for MTU of the path towards @p remote_address.
+            //!  Task fails if MTU can't be determined on this platform.
+            QueryPathMtu(const address::SocketAddr& remote_address);
+
+            //! Get path MTU, in bytes.
+            //! @pre
+            //!  Should be called only after success() is true.
+            size_t get_mtu() const;
+
+        private:
+            friend class NetworkLoop;
+
+            address::SocketAddr remote_address_;
+            size_t mtu_;
+        };
     };
 
     //! Initialize.
     //! @remarks
     //!  Start background thread if the object was successfully constructed.
-    NetworkLoop(core::IPool& packet_pool, core::IPool& buffer_pool, core::IArena& arena);
+    //!  Background thread is started with given scheduling parameters.
+    NetworkLoop(core::IPool& packet_pool,
+                core::IPool& buffer_pool,
+                core::IArena& arena,
+                const core::ThreadConfig& thread_config = core::ThreadConfig(),
+                const ResolverConfig& resolver_config = ResolverConfig());
 
     //! Destroy. Stop all receivers and senders.
     //! @remarks
@@ -199,9 +316,34 @@ public:
     //! Check if the object was successfully constructed.
     bool is_valid() const;
 
+    //! Add pool for smaller packet buffers.
+    //! @remarks
+    //!  Received packets that fit into buffers of this pool are moved from
+    //!  receive buffers of maximum size to smaller ones. Should be called
+    //!  before adding ports.
+    void add_small_packet_buffer_pool(core::IPool& buffer_pool);
+
+    //! Set packet capture ring.
+    //! @remarks
+    //!  UDP ports capture received and sent packets into the ring.
+    //!  Should be called before adding ports.
+    void set_packet_capture(packet::CaptureRing& capture_ring);
+
     //! Get number of receiver and sender ports.
     size_t num_ports() const;
 
+    //! Get number of times network thread was woken up to process tasks.
+    //! @remarks
+    //!  Tasks scheduled while network thread is already awake are processed
+    //!  without additional wakeups.
+    size_t num_task_wakeups() const;
+
+    //! Get number of address resolving requests served from cache.
+    size_t num_resolver_cache_hits() const;
+
+    //! Get number of address resolving requests not found in cache.
+    size_t num_resolver_cache_misses() const;
+
     //! Enqueue a task for asynchronous execution and return.
     //! The task should not be destroyed until the callback is called.
     //! The @p completer will be invoked on event loop thread after the
@@ -236,20 +378,29 @@ private:
 
     void update_num_ports_();
 
+    void signal_task_sem_();
+
     void close_all_sems_();
     void close_all_ports_();
 
     void task_add_udp_port_(NetworkTask&);
     void task_start_udp_send_(NetworkTask&);
     void task_start_udp_recv_(NetworkTask&);
+    void task_start_udp_inline_recv_(NetworkTask&);
+    void task_add_shm_port_(NetworkTask&);
+    void task_start_shm_send_(NetworkTask&);
+    void task_start_shm_recv_(NetworkTask&);
     void task_add_tcp_server_(NetworkTask&);
     void task_add_tcp_client_(NetworkTask&);
     void task_remove_port_(NetworkTask&);
     void task_resolve_endpoint_address_(NetworkTask&);
+    void task_query_path_mtu_(NetworkTask&);
 
     packet::PacketFactory packet_factory_;
     core::IArena& arena_;
 
+    packet::CaptureRing* capture_ring_;
+
     bool started_;
 
     uv_loop_t loop_;
@@ -258,16 +409,24 @@ private:
     uv_async_t stop_sem_;
     bool stop_sem_initialized_;
 
+    Resolver resolver_;
+
+    core::List<BasicPort> open_ports_;
+    core::List<BasicPort> closing_ports_;
+
+    // written by threads scheduling tasks
+    core::CacheLinePad pad_tasks_;
+
     uv_async_t task_sem_;
     bool task_sem_initialized_;
 
     core::MpscQueue<NetworkTask, core::NoOwnership> pending_tasks_;
+    core::Atomic<int> task_sem_pending_;
 
-    Resolver resolver_;
-
-    core::List<BasicPort> open_ports_;
-    core::List<BasicPort> closing_ports_;
+    // written by network thread, read by other threads
+    core::CacheLinePad pad_counters_;
 
+    core::Atomic<int> task_wakeups_;
     core::Atomic<int> num_open_ports_;
 };
 
@@ -17,9 +17,17 @@
 namespace roc {
 namespace netio {
 
-Resolver::Resolver(IResolverRequestHandler& req_handler, uv_loop_t& event_loop)
-    : loop_(event_loop)
-    , req_handler_(req_handler) {
+Resolver::Resolver(const ResolverConfig& config,
+                   IResolverRequestHandler& req_handler,
+                   uv_loop_t& event_loop,
+                   core::IArena& arena)
+    : config_(config)
+    , loop_(event_loop)
+    , req_handler_(req_handler)
+    , cache_pool_("resolver_cache_pool", arena)
+    , cache_map_(arena)
+    , cache_hits_(0)
+    , cache_misses_(0) {
 }
 
 bool Resolver::async_resolve(ResolverRequest& req) {
@@ -42,6 +50,10 @@ bool Resolver::async_resolve(ResolverRequest& req) {
         return false;
     }
 
+    if (lookup_cache_(req)) {
+        return false;
+    }
+
     req.handle.data = this;
 
     if (int err =
@@ -73,6 +85,7 @@ void Resolver::getaddrinfo_cb_(uv_getaddrinfo_t* req_handle,
 
     uv_freeaddrinfo(addrinfo);
 
+    self.store_cache_(req, status);
     self.finish_resolving_(req, status);
     self.req_handler_.handle_resolved(req);
 }
@@ -95,5 +108,97 @@ void Resolver::finish_resolving_(ResolverRequest& req, int status) {
     req.success = true;
 }
 
+size_t Resolver::num_cache_hits() const {
+    return (size_t)cache_hits_;
+}
+
+size_t Resolver::num_cache_misses() const {
+    return (size_t)cache_misses_;
+}
+
+bool Resolver::lookup_cache_(ResolverRequest& req) {
+    if (config_.cache_size == 0) {
+        return false;
+    }
+
+    core::SharedPtr<CacheEntry> entry = cache_map_.find(
+        CacheKey(req.endpoint_uri->host(), req.endpoint_uri->service()));
+
+    if (entry && entry->expiration <= core::timestamp(core::ClockMonotonic)) {
+        cache_lru_.remove(*entry);
+        cache_map_.remove(*entry);
+        entry = NULL;
+    }
+
+    if (!entry) {
+        cache_misses_++;
+        return false;
+    }
+
+    cache_hits_++;
+
+    cache_lru_.remove(*entry);
+    cache_lru_.push_front(*entry);
+
+    roc_log(LogTrace, "resolver: found in cache: hostname=%s status=%d",
+            entry->hostname, entry->status);
+
+    req.resolved_address = entry->address;
+    finish_resolving_(req, entry->status);
+
+    return true;
+}
+
+void Resolver::store_cache_(const ResolverRequest& req, int status) {
+    if (config_.cache_size == 0 || status == UV_ECANCELED) {
+        return;
+    }
+
+    const bool success = status == 0 && req.resolved_address.has_host_port();
+
+    const core::nanoseconds_t ttl =
+        success ? config_.cache_ttl : config_.negative_cache_ttl;
+    if (ttl <= 0) {
+        return;
+    }
+
+    const CacheKey key(req.endpoint_uri->host(), req.endpoint_uri->service());
+    if (strlen(key.hostname) > MaxHostnameLen || strlen(key.service) > MaxServiceLen) {
+        return;
+    }
+
+    core::SharedPtr<CacheEntry> entry = cache_map_.find(key);
+
+    if (!entry) {
+        if (cache_map_.size() >= config_.cache_size) {
+            CacheEntry* oldest = cache_lru_.back();
+            cache_lru_.remove(*oldest);
+            cache_map_.remove(*oldest);
+        }
+
+        entry = new (cache_pool_) CacheEntry(cache_pool_);
+        if (!entry) {
+            roc_log(LogError, "resolver: can't allocate cache entry");
+            return;
+        }
+
+        strcpy(entry->hostname, key.hostname);
+        strcpy(entry->service, key.service);
+
+        if (!cache_map_.insert(*entry)) {
+            roc_log(LogError, "resolver: can't insert cache entry");
+            return;
+        }
+    } else {
+        cache_lru_.remove(*entry);
+    }
+
+    cache_lru_.push_front(*entry);
+
+    entry->address = req.resolved_address;
+    entry->status = status;
+    entry->expiration = core::timestamp(core::ClockMonotonic) + ttl;
+}
+
 } // namespace netio
 } // namespace roc
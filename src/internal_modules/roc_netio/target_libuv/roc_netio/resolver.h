@@ -14,18 +14,56 @@
 
 #include <uv.h>
 
+#include "roc_address/socket_addr.h"
+#include "roc_core/atomic.h"
+#include "roc_core/hashmap.h"
+#include "roc_core/iarena.h"
+#include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/ref_counted.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
 #include "roc_netio/iresolver_request_handler.h"
 #include "roc_netio/resolver_request.h"
 
 namespace roc {
 namespace netio {
 
+//! Resolver parameters.
+struct ResolverConfig {
+    //! Maximum number of cached resolving results.
+    //! When cache is full, least recently used result is evicted.
+    //! If zero, cache is disabled.
+    size_t cache_size;
+
+    //! How long successfully resolved address is cached, nanoseconds.
+    //! If zero or negative, successful results are not cached.
+    core::nanoseconds_t cache_ttl;
+
+    //! How long resolving failure is cached, nanoseconds.
+    //! Avoids repeated lookups of unresolvable hostnames.
+    //! If zero or negative, failures are not cached.
+    core::nanoseconds_t negative_cache_ttl;
+
+    ResolverConfig()
+        : cache_size(256)
+        , cache_ttl(60 * core::Second)
+        , negative_cache_ttl(5 * core::Second) {
+    }
+};
+
 //! Hostname resolver.
+//! @remarks
+//!  Results of resolving are kept in a size-limited cache for a fixed time,
+//!  since getaddrinfo() doesn't report TTL of DNS records.
 class Resolver : public core::NonCopyable<> {
 public:
     //! Initialize.
-    Resolver(IResolverRequestHandler& req_handler, uv_loop_t& event_loop);
+    Resolver(const ResolverConfig& config,
+             IResolverRequestHandler& req_handler,
+             uv_loop_t& event_loop,
+             core::IArena& arena);
 
     //! Initiate asynchronous resolve request.
     //!
@@ -37,16 +75,87 @@ public:
     //!
     //! If there is no need for resolving or asynchronous request can't be started,
     //! fills @p req and returns false.
+    //! If result is found in cache, fills @p req and returns false.
     bool async_resolve(ResolverRequest& req);
 
+    //! Get number of requests served from cache.
+    //! Can be called from any thread.
+    size_t num_cache_hits() const;
+
+    //! Get number of requests that required actual resolving.
+    //! Can be called from any thread.
+    size_t num_cache_misses() const;
+
 private:
+    enum { MaxHostnameLen = 255, MaxServiceLen = 15 };
+
+    struct CacheKey {
+        const char* hostname;
+        const char* service;
+
+        CacheKey(const char* h, const char* s)
+            : hostname(h)
+            , service(s ? s : "") {
+        }
+    };
+
+    struct CacheEntry : core::RefCounted<CacheEntry, core::PoolAllocation>,
+                        core::HashmapNode<>,
+                        core::ListNode<> {
+        CacheEntry(core::IPool& pool)
+            : core::RefCounted<CacheEntry, core::PoolAllocation>(pool)
+            , status(0)
+            , expiration(0) {
+            hostname[0] = '\0';
+            service[0] = '\0';
+        }
+
+        // Resolved hostname and port or service name.
+        char hostname[MaxHostnameLen + 1];
+        char service[MaxServiceLen + 1];
+
+        // Result of resolving.
+        address::SocketAddr address;
+        int status;
+
+        // Monotonic timestamp when entry becomes stale.
+        core::nanoseconds_t expiration;
+
+        CacheKey key() const {
+            return CacheKey(hostname, service);
+        }
+
+        static core::hashsum_t key_hash(const CacheKey& key) {
+            core::hashsum_t hash = core::hashsum_str(key.hostname);
+            core::hashsum_add(hash, key.service, strlen(key.service));
+            return hash;
+        }
+
+        static bool key_equal(const CacheKey& key1, const CacheKey& key2) {
+            return strcmp(key1.hostname, key2.hostname) == 0
+                && strcmp(key1.service, key2.service) == 0;
+        }
+    };
+
     static void getaddrinfo_cb_(uv_getaddrinfo_t* req, int status, struct addrinfo* res);
 
     void finish_resolving_(ResolverRequest& req, int status);
 
+    bool lookup_cache_(ResolverRequest& req);
+    void store_cache_(const ResolverRequest& req, int status);
+
+    const ResolverConfig config_;
+
     uv_loop_t& loop_;
 
     IResolverRequestHandler& req_handler_;
+
+    core::SlabPool<CacheEntry> cache_pool_;
+    core::Hashmap<CacheEntry> cache_map_;
+    core::List<CacheEntry, core::NoOwnership> cache_lru_;
+
+    core::Atomic<int> cache_hits_;
+    core::Atomic<int> cache_misses_;
 };
 
 } // namespace netio
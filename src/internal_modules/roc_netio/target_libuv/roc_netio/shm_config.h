@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_libuv/roc_netio/shm_config.h
+//! @brief Shared memory port config.
+
+#ifndef ROC_NETIO_SHM_CONFIG_H_
+#define ROC_NETIO_SHM_CONFIG_H_
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace netio {
+
+//! Shared memory port parameters.
+struct ShmConfig {
+    //! Endpoint address.
+    //! Port number selects shared memory segment; sender and receiver on
+    //! the same host use same port number to find each other. Should be
+    //! non-zero. Also used as source and destination address of packets.
+    address::SocketAddr address;
+
+    //! Number of packet slots in ring.
+    //! When ring is full, sender drops packets.
+    //! Used only by receiving port, which creates the segment.
+    size_t ring_length;
+
+    ShmConfig()
+        : ring_length(256) {
+    }
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_CONFIG_H_
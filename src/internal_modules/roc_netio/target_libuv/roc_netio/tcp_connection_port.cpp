@@ -118,7 +118,8 @@ AsyncOperationStatus TcpConnectionPort::async_close(ICloseHandler& handler,
 
 bool TcpConnectionPort::accept(const TcpConnectionConfig& config,
                                const address::SocketAddr& server_address,
-                               SocketHandle server_socket) {
+                               SocketHandle sock,
+                               const address::SocketAddr& remote_address) {
     roc_panic_if_not(type_ == TcpConn_Server);
 
     const ConnectionState conn_state = get_state_();
@@ -130,13 +131,10 @@ bool TcpConnectionPort::accept(const TcpConnectionConfig& config,
 
     switch_and_report_state_(State_Connecting);
 
-    local_address_ = server_address;
+    socket_ = sock;
 
-    if (!socket_accept(server_socket, socket_, remote_address_)) {
-        roc_log(LogError, "tcp conn: %s: can't accept connection: socket_accept() failed",
-                descriptor());
-        return false;
-    }
+    local_address_ = server_address;
+    remote_address_ = remote_address;
 
     if (!socket_setup(socket_, config.socket_options)) {
         roc_log(LogError, "tcp conn: %s: can't accept connection: socket_setup() failed",
@@ -88,7 +88,7 @@ enum TcpConnectionType {
 //! loop, and is closed using RemovePort task. Before removing the port, the user
 //! must call async_terminate() and wait until termination is completed.
 //!
-//! Server-side connection is created by TcpServerPort when it receives a new
+//! Server-side connection is created by TcpServerPort when it accepts a new
 //! incoming connection. To remove it, the user should call async_terminate().
 //! When termination is completed, TcpServerPort automatically closes and
 //! destroys connection.
@@ -138,12 +138,16 @@ public:
     //!  Should be called from network loop thread.
     virtual AsyncOperationStatus async_close(ICloseHandler& handler, void* handler_arg);
 
-    //! Establish conection by accepting it from listening socket.
+    //! Establish conection using socket accepted from listening socket.
     //! @remarks
+    //!  Takes ownership of @p sock, which should be obtained using
+    //!  socket_try_accept(). The socket is closed when connection is
+    //!  terminated, even if accept() fails.
     //!  Should be called from network loop thread.
     bool accept(const TcpConnectionConfig& config,
                 const address::SocketAddr& server_address,
-                SocketHandle server_socket);
+                SocketHandle sock,
+                const address::SocketAddr& remote_address);
 
     //! Establish connection to remote peer (asynchronously).
     //! @remarks
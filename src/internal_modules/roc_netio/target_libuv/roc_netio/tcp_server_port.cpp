@@ -14,6 +14,12 @@
 namespace roc {
 namespace netio {
 
+namespace {
+
+const core::nanoseconds_t StatsReportInterval = 20 * core::Second;
+
+} // namespace
+
 TcpServerPort::TcpServerPort(const TcpServerConfig& config,
                              IConnAcceptor& conn_acceptor,
                              uv_loop_t& loop,
@@ -27,8 +33,15 @@ TcpServerPort::TcpServerPort(const TcpServerConfig& config,
     , socket_(SocketInvalid)
     , poll_handle_initialized_(false)
     , poll_handle_started_(false)
+    , conn_pool_("tcp_conn_pool", arena)
+    , conn_arena_(conn_pool_)
     , want_close_(false)
-    , closed_(false) {
+    , closed_(false)
+    , rate_limiter_(StatsReportInterval)
+    , accepted_conns_(0)
+    , accepted_batches_(0)
+    , failed_conns_(0)
+    , limit_pauses_(0) {
     BasicPort::update_descriptor();
 }
 
@@ -54,6 +67,14 @@ const address::SocketAddr& TcpServerPort::bind_address() const {
 }
 
 bool TcpServerPort::open() {
+    if (config_.max_connections != 0) {
+        if (!conn_pool_.reserve(config_.max_connections)) {
+            roc_log(LogError, "tcp server: %s: can't reserve memory for %lu connections",
+                    descriptor(), (unsigned long)config_.max_connections);
+            return false;
+        }
+    }
+
     if (!socket_create(config_.bind_address.family(), SocketType_Tcp, socket_)) {
         roc_log(LogError, "tcp server: %s: socket_create() failed", descriptor());
         return false;
@@ -143,49 +164,7 @@ void TcpServerPort::poll_cb_(uv_poll_t* handle, int status, int events) {
         return;
     }
 
-    roc_log(LogDebug, "tcp server: %s: trying to accept incoming connection",
-            self.descriptor());
-
-    core::SharedPtr<TcpConnectionPort> conn =
-        new (self.arena()) TcpConnectionPort(TcpConn_Server, self.loop_, self.arena());
-    if (!conn) {
-        roc_log(LogError, "tcp server: %s: can't allocate connection", self.descriptor());
-        return;
-    }
-
-    if (!conn->open()) {
-        roc_log(LogError, "tcp server: %s: can't open connection", self.descriptor());
-
-        self.async_close_connection_(conn);
-        return;
-    }
-
-    if (!conn->accept(self.config_, self.config_.bind_address, self.socket_)) {
-        roc_log(LogError, "tcp server: %s: can't accept connection", self.descriptor());
-
-        self.async_terminate_connection_(conn);
-        return;
-    }
-
-    roc_log(LogDebug, "tcp server: %s: adding connection: %s", self.descriptor(),
-            conn->descriptor());
-
-    IConnHandler* conn_handler = self.conn_acceptor_.add_connection(*conn);
-    if (!conn_handler) {
-        roc_log(LogError, "tcp server: %s: can't obtain connection handler",
-                self.descriptor());
-
-        self.async_terminate_connection_(conn);
-        return;
-    }
-
-    // release_usage will be called in handle_terminate_completed()
-    conn_handler->incref();
-
-    self.open_conns_.push_back(*conn);
-
-    conn->attach_terminate_handler(self, conn_handler);
-    conn->attach_connection_handler(*conn_handler);
+    self.accept_batch_();
 }
 
 void TcpServerPort::close_cb_(uv_handle_t* handle) {
@@ -242,6 +221,11 @@ void TcpServerPort::handle_close_completed(BasicPort& port, void*) {
 
     if (want_close_ && num_connections_() == 0) {
         async_close_server_();
+        return;
+    }
+
+    if (!want_close_ && !poll_handle_started_ && !limit_reached_()) {
+        resume_accepting_();
     }
 }
 
@@ -275,6 +259,147 @@ void TcpServerPort::finish_closing_server_() {
     }
 }
 
+void TcpServerPort::accept_batch_() {
+    size_t n_accepted = 0;
+
+    while (n_accepted < MaxAcceptBatch) {
+        if (limit_reached_()) {
+            // Remaining connections will wait in backlog until
+            // one of existing connections is closed.
+            pause_accepting_();
+            break;
+        }
+
+        SocketHandle sock = SocketInvalid;
+        address::SocketAddr remote_address;
+
+        const ssize_t ret = socket_try_accept(socket_, sock, remote_address);
+        if (ret == SockErr_WouldBlock) {
+            break;
+        }
+        if (ret < 0) {
+            roc_log(LogError, "tcp server: %s: can't accept connection", descriptor());
+            failed_conns_++;
+            break;
+        }
+
+        n_accepted++;
+        add_connection_(sock, remote_address);
+    }
+
+    if (n_accepted != 0) {
+        accepted_batches_++;
+    }
+
+    report_stats_();
+}
+
+void TcpServerPort::add_connection_(SocketHandle sock,
+                                    const address::SocketAddr& remote_address) {
+    core::SharedPtr<TcpConnectionPort> conn =
+        new (conn_arena_) TcpConnectionPort(TcpConn_Server, loop_, conn_arena_);
+    if (!conn) {
+        roc_log(LogError, "tcp server: %s: can't allocate connection", descriptor());
+
+        failed_conns_++;
+        (void)socket_close(sock);
+        return;
+    }
+
+    if (!conn->open()) {
+        roc_log(LogError, "tcp server: %s: can't open connection", descriptor());
+
+        failed_conns_++;
+        (void)socket_close(sock);
+        async_close_connection_(conn);
+        return;
+    }
+
+    if (!conn->accept(config_, config_.bind_address, sock, remote_address)) {
+        roc_log(LogError, "tcp server: %s: can't accept connection", descriptor());
+
+        failed_conns_++;
+        async_terminate_connection_(conn);
+        return;
+    }
+
+    roc_log(LogDebug, "tcp server: %s: adding connection: %s", descriptor(),
+            conn->descriptor());
+
+    IConnHandler* conn_handler = conn_acceptor_.add_connection(*conn);
+    if (!conn_handler) {
+        roc_log(LogError, "tcp server: %s: can't obtain connection handler",
+                descriptor());
+
+        failed_conns_++;
+        async_terminate_connection_(conn);
+        return;
+    }
+
+    // release_usage will be called in handle_terminate_completed()
+    conn_handler->incref();
+
+    open_conns_.push_back(*conn);
+
+    conn->attach_terminate_handler(*this, conn_handler);
+    conn->attach_connection_handler(*conn_handler);
+
+    accepted_conns_++;
+}
+
+bool TcpServerPort::limit_reached_() const {
+    // Closing connections still occupy memory in pool.
+    return config_.max_connections != 0 && num_connections_() >= config_.max_connections;
+}
+
+void TcpServerPort::pause_accepting_() {
+    if (!poll_handle_started_) {
+        return;
+    }
+
+    roc_log(LogDebug, "tcp server: %s: reached connection limit, pausing accept",
+            descriptor());
+
+    if (int err = uv_poll_stop(&poll_handle_)) {
+        roc_log(LogError, "tcp server: %s: uv_poll_stop(): [%s] %s", descriptor(),
+                uv_err_name(err), uv_strerror(err));
+        return;
+    }
+
+    poll_handle_started_ = false;
+    limit_pauses_++;
+}
+
+void TcpServerPort::resume_accepting_() {
+    if (poll_handle_started_ || !poll_handle_initialized_) {
+        return;
+    }
+
+    roc_log(LogDebug, "tcp server: %s: resuming accept", descriptor());
+
+    if (int err = uv_poll_start(&poll_handle_, UV_READABLE | UV_WRITABLE, poll_cb_)) {
+        roc_log(LogError, "tcp server: %s: uv_poll_start(): [%s] %s", descriptor(),
+                uv_err_name(err), uv_strerror(err));
+        return;
+    }
+
+    poll_handle_started_ = true;
+}
+
+void TcpServerPort::report_stats_() {
+    if (!rate_limiter_.allow()) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "tcp server: %s: accepted=%lu accept_batches=%lu failed=%lu"
+            " limit_pauses=%lu open=%lu closing=%lu",
+            descriptor(), (unsigned long)accepted_conns_,
+            (unsigned long)accepted_batches_, (unsigned long)failed_conns_,
+            (unsigned long)limit_pauses_, (unsigned long)open_conns_.size(),
+            (unsigned long)closing_conns_.size());
+}
+
 size_t TcpServerPort::num_connections_() const {
     return open_conns_.size() + closing_conns_.size();
 }
@@ -321,6 +446,30 @@ void TcpServerPort::finish_closing_connection_(
     closing_conns_.remove(*conn);
 }
 
+TcpServerPort::ConnArena::ConnArena(core::IPool& pool)
+    : pool_(pool) {
+}
+
+void* TcpServerPort::ConnArena::allocate(size_t size) {
+    roc_panic_if_msg(size > pool_.object_size(),
+                     "tcp server: unexpected allocation size: got=%lu max=%lu",
+                     (unsigned long)size, (unsigned long)pool_.object_size());
+
+    return pool_.allocate();
+}
+
+void TcpServerPort::ConnArena::deallocate(void* ptr) {
+    pool_.deallocate(ptr);
+}
+
+size_t TcpServerPort::ConnArena::compute_allocated_size(size_t) const {
+    return pool_.allocation_size();
+}
+
+size_t TcpServerPort::ConnArena::allocated_size(void*) const {
+    return pool_.allocation_size();
+}
+
 void TcpServerPort::format_descriptor(core::StringBuilder& b) {
     b.append_str("<tcpserv");
 
@@ -16,8 +16,11 @@
 
 #include "roc_address/socket_addr.h"
 #include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
 #include "roc_core/list.h"
+#include "roc_core/rate_limiter.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/slab_pool.h"
 #include "roc_core/stddefs.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
@@ -39,12 +42,24 @@ struct TcpServerConfig : TcpConnectionConfig {
     //! Maximum length to which the queue of pending connections may grow.
     size_t backlog_limit;
 
+    //! Maximum number of connections.
+    //! When reached, server stops accepting until one of the connections is
+    //! closed, and new connections wait in backlog. Memory for this number of
+    //! connections is reserved when server is opened.
+    //! If zero, number of connections is not limited.
+    size_t max_connections;
+
     TcpServerConfig()
-        : backlog_limit(128) {
+        : backlog_limit(128)
+        , max_connections(0) {
     }
 };
 
 //! TCP server.
+//! @remarks
+//!  Accepts pending connections in batches when listening socket becomes
+//!  readable. Connection objects are allocated from a pool owned by server,
+//!  so that their memory is reused when clients reconnect.
 class TcpServerPort : public BasicPort, private ITerminateHandler, private ICloseHandler {
 public:
     //! Initialize.
@@ -76,6 +91,23 @@ protected:
     virtual void format_descriptor(core::StringBuilder& b);
 
 private:
+    // Maximum number of connections accepted per one readiness event.
+    enum { MaxAcceptBatch = 16 };
+
+    // Allocates connections from pool instead of arena.
+    class ConnArena : public core::IArena, public core::NonCopyable<> {
+    public:
+        explicit ConnArena(core::IPool& pool);
+
+        virtual void* allocate(size_t size);
+        virtual void deallocate(void* ptr);
+        virtual size_t compute_allocated_size(size_t size) const;
+        virtual size_t allocated_size(void* ptr) const;
+
+    private:
+        core::IPool& pool_;
+    };
+
     static void poll_cb_(uv_poll_t* handle, int status, int events);
     static void close_cb_(uv_handle_t* handle);
 
@@ -85,6 +117,15 @@ private:
     AsyncOperationStatus async_close_server_();
     void finish_closing_server_();
 
+    void accept_batch_();
+    void add_connection_(SocketHandle sock, const address::SocketAddr& remote_address);
+
+    bool limit_reached_() const;
+    void pause_accepting_();
+    void resume_accepting_();
+
+    void report_stats_();
+
     size_t num_connections_() const;
     void async_close_all_connections_();
     void async_terminate_connection_(const core::SharedPtr<TcpConnectionPort>&);
@@ -106,11 +147,21 @@ private:
     bool poll_handle_initialized_;
     bool poll_handle_started_;
 
+    core::SlabPool<TcpConnectionPort> conn_pool_;
+    ConnArena conn_arena_;
+
     core::List<TcpConnectionPort> open_conns_;
     core::List<TcpConnectionPort> closing_conns_;
 
     bool want_close_;
     bool closed_;
+
+    core::RateLimiter rate_limiter_;
+
+    size_t accepted_conns_;
+    size_t accepted_batches_;
+    size_t failed_conns_;
+    size_t limit_pauses_;
 };
 
 } // namespace netio
@@ -10,6 +10,7 @@
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/probe.h"
 #include "roc_core/shared_ptr.h"
 #include "roc_core/string_builder.h"
 #include "roc_core/time.h"
@@ -28,6 +29,7 @@ const core::nanoseconds_t PacketLogInterval = 20 * core::Second;
 UdpPort::UdpPort(const UdpConfig& config,
                  uv_loop_t& event_loop,
                  packet::PacketFactory& packet_factory,
+                 packet::CaptureRing* capture_ring,
                  core::IArena& arena)
     : BasicPort(arena)
     , config_(config)
@@ -36,13 +38,19 @@ UdpPort::UdpPort(const UdpConfig& config,
     , loop_(event_loop)
     , handle_initialized_(false)
     , write_sem_initialized_(false)
+    , pacing_timer_initialized_(false)
+    , multicast_send_configured_(false)
     , multicast_group_joined_(false)
     , recv_started_(false)
+    , kernel_timestamps_(false)
+    , batch_recv_(false)
     , want_close_(false)
     , closed_(false)
     , fd_()
     , packet_factory_(packet_factory)
+    , capture_ring_(capture_ring)
     , inbound_writer_(NULL)
+    , send_req_pool_("udp_send_request_pool", arena)
     , rate_limiter_(PacketLogInterval) {
     BasicPort::update_descriptor();
 }
@@ -124,6 +132,10 @@ bool UdpPort::open() {
 
     update_descriptor();
 
+    if (!setup_socket_options_()) {
+        return false;
+    }
+
     roc_log(LogDebug, "udp port: %s: opened port", descriptor());
 
     return true;
@@ -166,18 +178,35 @@ packet::IWriter* UdpPort::start_send() {
         write_sem_initialized_ = true;
     }
 
+    if (!pacing_timer_initialized_) {
+        if (int err = uv_timer_init(&loop_, &pacing_timer_)) {
+            roc_log(LogError, "udp port: %s: uv_timer_init(): [%s] %s", descriptor(),
+                    uv_err_name(err), uv_strerror(err));
+            return NULL;
+        }
+
+        pacing_timer_.data = this;
+        pacing_timer_initialized_ = true;
+    }
+
+    if (!multicast_send_configured_) {
+        if (!setup_multicast_send_()) {
+            return NULL;
+        }
+    }
+
     return this;
 }
 
 bool UdpPort::start_recv(packet::IWriter& inbound_writer) {
-    if (!handle_initialized_) {
+    if (config_.enable_inline_recv) {
+        roc_log(LogError, "udp port: %s: port is configured for inline receiving",
+                descriptor());
         return false;
     }
 
-    if (config_.multicast_interface[0] && !multicast_group_joined_) {
-        if (!join_multicast_group_()) {
-            return false;
-        }
+    if (!setup_recv_()) {
+        return false;
     }
 
     if (!recv_started_) {
@@ -193,6 +222,49 @@ bool UdpPort::start_recv(packet::IWriter& inbound_writer) {
     return true;
 }
 
+packet::IReader* UdpPort::start_inline_recv() {
+    if (!config_.enable_inline_recv) {
+        roc_log(LogError, "udp port: %s: port is not configured for inline receiving",
+                descriptor());
+        return NULL;
+    }
+
+    if (!setup_recv_()) {
+        return NULL;
+    }
+
+    // Packets received by recv_batch_() are accumulated in queue
+    // until they're read.
+    inbound_writer_ = &inline_queue_;
+    return this;
+}
+
+bool UdpPort::setup_recv_() {
+    if (!handle_initialized_) {
+        return false;
+    }
+
+    if (config_.multicast_interface[0] && !multicast_group_joined_) {
+        if (!join_multicast_group_()) {
+            return false;
+        }
+    }
+
+    if (config_.enable_kernel_timestamps && !kernel_timestamps_) {
+        kernel_timestamps_ = socket_enable_recv_timestamps(fd_);
+        if (!kernel_timestamps_) {
+            roc_log(LogDebug,
+                    "udp port: %s: kernel timestamps not supported,"
+                    " falling back to user-space timestamps",
+                    descriptor());
+        }
+    }
+
+    batch_recv_ = config_.enable_batch_recv || kernel_timestamps_;
+
+    return true;
+}
+
 void UdpPort::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -200,11 +272,14 @@ void UdpPort::close_cb_(uv_handle_t* handle) {
 
     if (handle == (uv_handle_t*)&self.handle_) {
         self.handle_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.pacing_timer_) {
+        self.pacing_timer_initialized_ = false;
     } else {
         self.write_sem_initialized_ = false;
     }
 
-    if (self.handle_initialized_ || self.write_sem_initialized_) {
+    if (self.handle_initialized_ || self.write_sem_initialized_
+        || self.pacing_timer_initialized_) {
         return;
     }
 
@@ -222,6 +297,14 @@ void UdpPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
 
     UdpPort& self = *(UdpPort*)handle->data;
 
+    if (self.batch_recv_) {
+        // Don't let libuv read datagram, see recv_cb_().
+        buf->base = NULL;
+        buf->len = 0;
+
+        return;
+    }
+
     core::BufferPtr bp = self.packet_factory_.new_packet_buffer();
     if (!bp) {
         roc_log(LogError, "udp port: %s: can't allocate buffer", self.descriptor());
@@ -252,6 +335,17 @@ void UdpPort::recv_cb_(uv_udp_t* handle,
 
     UdpPort& self = *(UdpPort*)handle->data;
 
+    if (self.batch_recv_) {
+        // When batch receiving is enabled, alloc_cb_() returns no buffer and
+        // libuv reports UV_ENOBUFS without reading anything. Socket is readable,
+        // so we read pending datagrams ourselves, in batches and with kernel
+        // timestamps if enabled. libuv invokes callback once per readiness
+        // event in this case, so recv_batches_() limits work done per event.
+        roc_panic_if(buf->base);
+        self.recv_batches_();
+        return;
+    }
+
     address::SocketAddr src_addr;
     if (sockaddr) {
         if (!src_addr.set_host_port_saddr(sockaddr)) {
@@ -299,46 +393,171 @@ void UdpPort::recv_cb_(uv_udp_t* handle,
     }
 
     if (flags & UV_UDP_PARTIAL) {
-        roc_log(LogDebug,
-                "udp port: %s:"
-                " ignoring partial read: num=%d src=%s dst=%s nread=%ld",
-                self.descriptor(), (int)self.received_packets_,
-                address::socket_addr_to_str(src_addr).c_str(),
-                address::socket_addr_to_str(self.config_.bind_address).c_str(),
-                (long)nread);
+        self.report_truncated_(src_addr, bp->size());
         return;
     }
 
-    self.received_packets_++;
+    core::BufferPtr small_bp = self.shrink_buffer_(bp, (size_t)nread);
+
+    self.recv_packet_(small_bp ? small_bp : bp, (size_t)nread, src_addr, 0);
+}
+
+void UdpPort::recv_batches_() {
+    // While batches are filled completely, keep draining socket without
+    // returning to event loop, but limit number of batches to avoid
+    // starving other ports of the loop.
+    for (size_t n = 0; n < MaxRecvBatchesPerEvent; n++) {
+        if (recv_batch_() < MaxRecvBatch) {
+            break;
+        }
+    }
+}
+
+size_t UdpPort::recv_batch_() {
+    SocketDatagram dgrams[MaxRecvBatch];
+    size_t n_bufs = 0;
+
+    // Buffers that were not filled by previous batch are reused.
+    for (; n_bufs < MaxRecvBatch; n_bufs++) {
+        if (!recv_bufs_[n_bufs]) {
+            recv_bufs_[n_bufs] = packet_factory_.new_packet_buffer();
+
+            if (!recv_bufs_[n_bufs]) {
+                roc_log(LogError, "udp port: %s: can't allocate buffer", descriptor());
+                break;
+            }
+        }
+
+        dgrams[n_bufs].buf = recv_bufs_[n_bufs]->data();
+        dgrams[n_bufs].bufsz = recv_bufs_[n_bufs]->size();
+    }
+
+    if (n_bufs == 0) {
+        return 0;
+    }
+
+    const ssize_t n_dgrams = socket_try_recv_batch(fd_, dgrams, n_bufs);
+    if (n_dgrams <= 0) {
+        return 0;
+    }
+
+    received_batches_++;
+
+    roc_log(LogTrace, "udp port: %s: received batch: num=%d size=%ld", descriptor(),
+            (int)received_batches_, (long)n_dgrams);
+
+    for (size_t n = 0; n < (size_t)n_dgrams; n++) {
+        if (dgrams[n].truncated) {
+            report_truncated_(dgrams[n].addr, dgrams[n].bufsz);
+            continue;
+        }
+
+        if (dgrams[n].len == 0) {
+            continue;
+        }
+
+        core::BufferPtr bp = shrink_buffer_(recv_bufs_[n], dgrams[n].len);
+        if (!bp) {
+            // Packet doesn't fit smaller buffer, hand over receive buffer.
+            bp = recv_bufs_[n];
+            recv_bufs_[n] = NULL;
+        }
+
+        recv_packet_(bp, dgrams[n].len, dgrams[n].addr, dgrams[n].timestamp);
+    }
+
+    // Move buffers that can be reused to the beginning.
+    size_t n_unused = 0;
+    for (size_t n = 0; n < n_bufs; n++) {
+        if (!recv_bufs_[n]) {
+            continue;
+        }
+        if (n != n_unused) {
+            recv_bufs_[n_unused] = recv_bufs_[n];
+            recv_bufs_[n] = NULL;
+        }
+        n_unused++;
+    }
+
+    return (size_t)n_dgrams;
+}
+
+// Datagram didn't fit into receive buffer. This happens when sender uses
+// larger packets than max packet size configured on receiver, e.g. when it
+// uses jumbo frames. The first occurrence is reported as error, because all
+// packets from such sender are likely to be dropped.
+void UdpPort::report_truncated_(const address::SocketAddr& src_addr, size_t buf_size) {
+    const int trunc_num = ++truncated_packets_;
+
+    roc_log(trunc_num == 1 ? LogError : LogDebug,
+            "udp port: %s:"
+            " dropping datagram larger than max packet size:"
+            " num=%d src=%s dst=%s max_packet_size=%lu",
+            descriptor(), trunc_num, address::socket_addr_to_str(src_addr).c_str(),
+            address::socket_addr_to_str(config_.bind_address).c_str(),
+            (unsigned long)buf_size);
+}
+
+// Receive buffers have maximum packet size, which is often much larger than
+// actual datagrams. Since received packets may be kept in queues for the whole
+// latency duration, small datagrams are copied to smaller buffers, and receive
+// buffer is reused for next datagram. This is the only place where received
+// datagrams are copied; such copies are counted in port stats.
+core::BufferPtr UdpPort::shrink_buffer_(const core::BufferPtr& recv_buf, size_t size) {
+    core::BufferPtr bp = packet_factory_.new_packet_buffer(size);
+    if (!bp || bp->size() >= recv_buf->size()) {
+        return NULL;
+    }
+
+    memcpy(bp->data(), recv_buf->data(), size);
+
+    ++copied_packets_;
+
+    return bp;
+}
+
+void UdpPort::recv_packet_(const core::BufferPtr& bp,
+                           size_t size,
+                           const address::SocketAddr& src_addr,
+                           core::nanoseconds_t timestamp) {
+    received_packets_++;
 
     roc_log(LogTrace, "udp port: %s: received packet: num=%d src=%s dst=%s nread=%ld",
-            self.descriptor(), (int)self.received_packets_,
+            descriptor(), (int)received_packets_,
             address::socket_addr_to_str(src_addr).c_str(),
-            address::socket_addr_to_str(self.config_.bind_address).c_str(), (long)nread);
+            address::socket_addr_to_str(config_.bind_address).c_str(), (long)size);
 
-    if ((size_t)nread > bp->size()) {
-        roc_panic("udp port: %s: unexpected buffer size: got %ld, max %ld",
-                  self.descriptor(), (long)nread, (long)bp->size());
+    if (size > bp->size()) {
+        roc_panic("udp port: %s: unexpected buffer size: got %ld, max %ld", descriptor(),
+                  (long)size, (long)bp->size());
     }
 
-    packet::PacketPtr pp = self.packet_factory_.new_packet();
+    packet::PacketPtr pp = packet_factory_.new_packet();
     if (!pp) {
-        roc_log(LogError, "udp port: %s: can't allocate packet", self.descriptor());
+        roc_log(LogError, "udp port: %s: can't allocate packet", descriptor());
         return;
     }
 
     pp->add_flags(packet::Packet::FlagUDP);
 
     pp->udp()->src_addr = src_addr;
-    pp->udp()->dst_addr = self.config_.bind_address;
-    pp->udp()->receive_timestamp = core::timestamp(core::ClockUnix);
+    pp->udp()->dst_addr = config_.bind_address;
+    pp->udp()->receive_timestamp =
+        timestamp > 0 ? timestamp : core::timestamp(core::ClockUnix);
+
+    pp->set_buffer(core::Slice<uint8_t>(*bp, 0, size));
 
-    pp->set_buffer(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
+    roc_probe(udp_recv, (int)config_.bind_address.port(), (int)received_packets_,
+              (unsigned long)size, (int64_t)pp->udp()->receive_timestamp);
+
+    if (capture_ring_) {
+        capture_ring_->capture(*pp, packet::CapturePoint_Ingress, 0);
+    }
 
-    if (self.inbound_writer_) {
-        const status::StatusCode code = self.inbound_writer_->write(pp);
+    if (inbound_writer_) {
+        const status::StatusCode code = inbound_writer_->write(pp);
         if (code != status::StatusOK) {
-            roc_panic("udp port: %s: can't writer packet: status=%s", self.descriptor(),
+            roc_panic("udp port: %s: can't writer packet: status=%s", descriptor(),
                       status::code_to_str(code));
         }
     }
@@ -349,55 +568,218 @@ void UdpPort::write_sem_cb_(uv_async_t* handle) {
 
     UdpPort& self = *(UdpPort*)handle->data;
 
+    self.write_wakeups_++;
+
+    self.send_pending_();
+
+    if (self.config_.send_busy_poll > 0) {
+        self.poll_pending_();
+    }
+
+    // While flag is set, writers don't signal semaphore, relying on us to
+    // drain the queue. After clearing it, pick up packets that were pushed
+    // before it was cleared; packets pushed after will signal again.
+    self.write_sem_pending_ = 0;
+    self.send_pending_();
+}
+
+void UdpPort::pacing_timer_cb_(uv_timer_t* handle) {
+    roc_panic_if_not(handle);
+
+    UdpPort& self = *(UdpPort*)handle->data;
+
+    self.send_pending_();
+}
+
+void UdpPort::send_pending_() {
+    if (config_.enable_batch_send) {
+        send_batch_();
+    }
+
     // Using try_pop_front_exclusive() makes this method lock-free and wait-free.
     // try_pop_front_exclusive() may return NULL if the queue is not empty, but
     // push_back() is currently in progress. In this case we can exit the loop
-    // before processing all packets, but write() always calls uv_async_send()
-    // after push_back(), so we'll wake up soon and process the rest packets.
-    while (packet::PacketPtr pp = self.outbound_queue_.try_pop_front_exclusive()) {
-        packet::UDP& udp = *pp->udp();
+    // before processing all packets, but write() signals semaphore after
+    // push_back() unless we're going to drain the queue once more before
+    // going idle, so we'll process the rest packets soon.
+    while (packet::PacketPtr pp = pop_pending_()) {
+        send_packet_(pp);
+    }
+}
 
-        const int packet_num = ++self.sent_packets_;
-        ++self.sent_packets_blk_;
+// Keeps sending enqueued packets until busy-poll budget expires.
+// Stops earlier if port is closing or next packet is waiting for pacing timer.
+void UdpPort::poll_pending_() {
+    const core::nanoseconds_t deadline =
+        core::timestamp(core::ClockMonotonic) + config_.send_busy_poll;
 
-        roc_log(LogTrace, "udp port: %s: sending packet: num=%d src=%s dst=%s sz=%ld",
-                self.descriptor(), packet_num,
-                address::socket_addr_to_str(self.config_.bind_address).c_str(),
-                address::socket_addr_to_str(udp.dst_addr).c_str(),
-                (long)pp->buffer().size());
+    while (!want_close_ && !paced_packet_
+           && core::timestamp(core::ClockMonotonic) < deadline) {
+        send_pending_();
+    }
+}
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->buffer().data();
-        buf.len = pp->buffer().size();
+// Returns next packet from outbound queues, if its send time has come.
+// Otherwise, keeps packet until pacing timer fires, to preserve order.
+// Repair packets are taken only when there are no source and control packets.
+packet::PacketPtr UdpPort::pop_pending_() {
+    packet::PacketPtr pp = paced_packet_;
+    paced_packet_ = NULL;
 
-        udp.request.data = &self;
+    if (!pp) {
+        pp = outbound_queue_.try_pop_front_exclusive();
+    }
+    if (!pp) {
+        pp = outbound_repair_queue_.try_pop_front_exclusive();
+    }
+    if (!pp) {
+        return NULL;
+    }
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp port: %s: uv_udp_send(): [%s] %s", self.descriptor(),
-                    uv_err_name(err), uv_strerror(err));
-            continue;
+    const core::nanoseconds_t send_ts = pp->udp()->send_timestamp;
+    if (send_ts == 0) {
+        return pp;
+    }
+
+    const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+    if (send_ts <= now) {
+        return pp;
+    }
+
+    paced_packet_ = pp;
+
+    // libuv timers have millisecond resolution, round up.
+    const uint64_t timeout_ms =
+        uint64_t((send_ts - now + core::Millisecond - 1) / core::Millisecond);
+
+    if (int err = uv_timer_start(&pacing_timer_, pacing_timer_cb_, timeout_ms, 0)) {
+        roc_panic("udp port: %s: uv_timer_start(): [%s] %s", descriptor(),
+                  uv_err_name(err), uv_strerror(err));
+    }
+
+    return NULL;
+}
+
+void UdpPort::send_batch_() {
+    packet::PacketPtr packets[MaxSendBatch];
+    SocketDatagram dgrams[MaxSendBatch];
+
+    for (;;) {
+        // If libuv has its own queue of packets waiting for socket to become
+        // writable, sending directly would reorder packets.
+        if (uv_udp_get_send_queue_count(&handle_) != 0) {
+            return;
+        }
+
+        size_t n_packets = 0;
+
+        for (; n_packets < MaxSendBatch; n_packets++) {
+            packets[n_packets] = pop_pending_();
+            if (!packets[n_packets]) {
+                break;
+            }
+
+            dgrams[n_packets].buf = packets[n_packets]->buffer().data();
+            dgrams[n_packets].bufsz = packets[n_packets]->buffer().size();
+            dgrams[n_packets].len = packets[n_packets]->buffer().size();
+            dgrams[n_packets].addr = packets[n_packets]->udp()->dst_addr;
+        }
+
+        if (n_packets == 0) {
+            return;
         }
 
-        // will be decremented in send_cb_()
-        pp->incref();
+        ssize_t n_sent =
+            socket_try_send_batch(fd_, dgrams, n_packets, config_.enable_gso);
+        if (n_sent < 0) {
+            n_sent = 0;
+        }
+
+        if (n_sent > 0) {
+            const int batch_num = ++sent_batches_;
+
+            roc_log(LogTrace, "udp port: %s: sent batch: num=%d size=%ld", descriptor(),
+                    batch_num, (long)n_sent);
+        }
+
+        for (size_t n = 0; n < (size_t)n_sent; n++) {
+            const int packet_num = ++sent_packets_;
+            ++sent_packets_batch_;
+
+            roc_log(LogTrace, "udp port: %s: sent packet: num=%d src=%s dst=%s sz=%ld",
+                    descriptor(), packet_num,
+                    address::socket_addr_to_str(config_.bind_address).c_str(),
+                    address::socket_addr_to_str(dgrams[n].addr).c_str(),
+                    (long)dgrams[n].len);
+
+            packets[n] = NULL;
+        }
+
+        // Packets that were not sent are passed to libuv, which will send them
+        // when socket becomes writable.
+        for (size_t n = (size_t)n_sent; n < n_packets; n++) {
+            send_packet_(packets[n]);
+            packets[n] = NULL;
+        }
+
+        if (n_sent > 0) {
+            const int pending_packets = (pending_packets_ -= (int)n_sent);
+
+            if (pending_packets == 0 && want_close_) {
+                start_closing_();
+                return;
+            }
+        }
+
+        if ((size_t)n_sent < n_packets || n_packets < MaxSendBatch) {
+            return;
+        }
     }
 }
 
-void UdpPort::send_cb_(uv_udp_send_t* req, int status) {
-    roc_panic_if_not(req);
+void UdpPort::send_packet_(const packet::PacketPtr& pp) {
+    const packet::UDP& udp = *pp->udp();
 
-    UdpPort& self = *(UdpPort*)req->data;
+    const int packet_num = ++sent_packets_;
+    ++sent_packets_blk_;
 
-    packet::PacketPtr pp =
-        packet::Packet::container_of(ROC_CONTAINER_OF(req, packet::UDP, request));
+    roc_log(LogTrace, "udp port: %s: sending packet: num=%d src=%s dst=%s sz=%ld",
+            descriptor(), packet_num,
+            address::socket_addr_to_str(config_.bind_address).c_str(),
+            address::socket_addr_to_str(udp.dst_addr).c_str(), (long)pp->buffer().size());
 
-    // one reference for incref() called from write_sem_cb_()
-    // one reference for the shared pointer above
-    roc_panic_if(pp->getref() < 2);
+    uv_buf_t buf;
+    buf.base = (char*)pp->buffer().data();
+    buf.len = pp->buffer().size();
+
+    SendRequest* sr = new (send_req_pool_) SendRequest();
+    if (!sr) {
+        roc_log(LogError, "udp port: %s: can't allocate send request", descriptor());
+        return;
+    }
 
-    // decrement reference counter incremented in write_sem_cb_()
-    pp->decref();
+    // request holds packet reference until send_cb_() is called
+    sr->packet = pp;
+    sr->port = this;
+    sr->request.data = sr;
+
+    if (int err = uv_udp_send(&sr->request, &handle_, &buf, 1, udp.dst_addr.saddr(),
+                              send_cb_)) {
+        roc_log(LogError, "udp port: %s: uv_udp_send(): [%s] %s", descriptor(),
+                uv_err_name(err), uv_strerror(err));
+        send_req_pool_.destroy_object(*sr);
+        return;
+    }
+}
+
+void UdpPort::send_cb_(uv_udp_send_t* req, int status) {
+    roc_panic_if_not(req);
+
+    SendRequest& sr = *(SendRequest*)req->data;
+    UdpPort& self = *sr.port;
+
+    const packet::PacketPtr pp = sr.packet;
+    self.send_req_pool_.destroy_object(sr);
 
     if (status < 0) {
         roc_log(LogError,
@@ -416,6 +798,20 @@ void UdpPort::send_cb_(uv_udp_send_t* req, int status) {
     }
 }
 
+// Implementation of reader returned by start_inline_recv().
+// Invoked on the thread that consumes packets instead of network thread.
+status::StatusCode UdpPort::read(packet::PacketPtr& pp) {
+    roc_panic_if(!config_.enable_inline_recv);
+
+    if (inline_queue_.size() == 0) {
+        // Socket is non-blocking, so this returns immediately if there
+        // are no pending datagrams.
+        recv_batch_();
+    }
+
+    return inline_queue_.read(pp);
+}
+
 status::StatusCode UdpPort::write(const packet::PacketPtr& pp) {
     if (!pp) {
         roc_panic("udp port: %s: unexpected null packet", descriptor());
@@ -433,6 +829,30 @@ status::StatusCode UdpPort::write(const packet::PacketPtr& pp) {
         roc_panic("udp port: %s: attempt to use closed sender", descriptor());
     }
 
+    if (pp->has_flags(packet::Packet::FlagRepair) && config_.repair_queue_limit != 0
+        && pending_packets_ >= (int)config_.repair_queue_limit) {
+        const int drop_num = ++dropped_repair_packets_;
+
+        roc_log(LogTrace,
+                "udp port: %s: send queue is full, dropping repair packet:"
+                " num=%d pending=%d limit=%lu",
+                descriptor(), drop_num, (int)pending_packets_,
+                (unsigned long)config_.repair_queue_limit);
+
+        if (capture_ring_) {
+            capture_ring_->capture(*pp, packet::CapturePoint_Egress,
+                                   packet::CaptureFlag_Dropped);
+        }
+
+        report_stats_();
+
+        return status::StatusLimit;
+    }
+
+    if (capture_ring_) {
+        capture_ring_->capture(*pp, packet::CapturePoint_Egress, 0);
+    }
+
     write_(pp);
 
     report_stats_();
@@ -442,14 +862,29 @@ status::StatusCode UdpPort::write(const packet::PacketPtr& pp) {
 
 void UdpPort::write_(const packet::PacketPtr& pp) {
     const bool had_pending = (++pending_packets_ > 1);
-    if (!had_pending) {
+    const bool is_paced = pp->udp()->send_timestamp != 0
+        && pp->udp()->send_timestamp > core::timestamp(core::ClockMonotonic);
+    if (!had_pending && !is_paced) {
         if (try_nonblocking_write_(pp)) {
             --pending_packets_;
             return;
         }
     }
 
-    outbound_queue_.push_back(*pp);
+    // Packet may be local to pipeline thread.
+    pp->make_shared();
+
+    if (pp->has_flags(packet::Packet::FlagRepair)) {
+        outbound_repair_queue_.push_back(*pp);
+    } else {
+        outbound_queue_.push_back(*pp);
+    }
+
+    // Only first writer after network thread went idle wakes it up,
+    // the rest packets are picked up before network thread goes idle.
+    if (write_sem_pending_.exchange(1) != 0) {
+        return;
+    }
 
     if (int err = uv_async_send(&write_sem_)) {
         roc_panic("udp port: %s: uv_async_send(): [%s] %s", descriptor(),
@@ -463,8 +898,9 @@ bool UdpPort::try_nonblocking_write_(const packet::PacketPtr& pp) {
     }
 
     const packet::UDP& udp = *pp->udp();
-    const bool success =
-        socket_try_send_to(fd_, pp->buffer().data(), pp->buffer().size(), udp.dst_addr);
+    const bool success = socket_try_send_to(fd_, pp->buffer().data(),
+                                            pp->buffer().size(), udp.dst_addr)
+        > 0;
 
     if (success) {
         const int packet_num = ++sent_packets_;
@@ -480,7 +916,7 @@ bool UdpPort::try_nonblocking_write_(const packet::PacketPtr& pp) {
 }
 
 bool UdpPort::fully_closed_() const {
-    if (!handle_initialized_ && !write_sem_initialized_) {
+    if (!handle_initialized_ && !write_sem_initialized_ && !pacing_timer_initialized_) {
         return true;
     }
 
@@ -506,6 +942,10 @@ void UdpPort::start_closing_() {
         recv_started_ = false;
     }
 
+    for (size_t n = 0; n < MaxRecvBatch; n++) {
+        recv_bufs_[n] = NULL;
+    }
+
     if (multicast_group_joined_) {
         leave_multicast_group_();
     }
@@ -517,6 +957,125 @@ void UdpPort::start_closing_() {
     if (write_sem_initialized_ && !uv_is_closing((uv_handle_t*)&write_sem_)) {
         uv_close((uv_handle_t*)&write_sem_, close_cb_);
     }
+
+    if (pacing_timer_initialized_ && !uv_is_closing((uv_handle_t*)&pacing_timer_)) {
+        uv_close((uv_handle_t*)&pacing_timer_, close_cb_);
+    }
+}
+
+bool UdpPort::setup_socket_options_() {
+    if (config_.recv_buffer_size > (size_t)INT_MAX
+        || config_.send_buffer_size > (size_t)INT_MAX) {
+        roc_log(LogError,
+                "udp port: %s: invalid config: socket buffer size is too large:"
+                " recv_buffer_size=%lu send_buffer_size=%lu",
+                descriptor(), (unsigned long)config_.recv_buffer_size,
+                (unsigned long)config_.send_buffer_size);
+        return false;
+    }
+
+    if (config_.dscp > 63) {
+        roc_log(LogError,
+                "udp port: %s: invalid config: dscp should be in range [0; 63]: dscp=%u",
+                descriptor(), config_.dscp);
+        return false;
+    }
+
+    if (config_.recv_buffer_size != 0) {
+        int value = (int)config_.recv_buffer_size;
+        if (int err = uv_recv_buffer_size((uv_handle_t*)&handle_, &value)) {
+            roc_log(LogError, "udp port: %s: uv_recv_buffer_size(): [%s] %s",
+                    descriptor(), uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    if (config_.send_buffer_size != 0) {
+        int value = (int)config_.send_buffer_size;
+        if (int err = uv_send_buffer_size((uv_handle_t*)&handle_, &value)) {
+            roc_log(LogError, "udp port: %s: uv_send_buffer_size(): [%s] %s",
+                    descriptor(), uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    if (config_.recv_busy_poll != 0) {
+        if (!socket_set_busy_poll(fd_, config_.recv_busy_poll)) {
+            roc_log(LogError, "udp port: %s: can't set socket busy-poll", descriptor());
+            return false;
+        }
+    }
+
+    if (config_.dscp != 0) {
+        if (!socket_set_dscp(fd_, config_.bind_address.family(), config_.dscp)) {
+            roc_log(LogError, "udp port: %s: can't set socket dscp", descriptor());
+            return false;
+        }
+    }
+
+    if (config_.priority != 0) {
+        if (!socket_set_priority(fd_, config_.priority)) {
+            roc_log(LogError, "udp port: %s: can't set socket priority", descriptor());
+            return false;
+        }
+    }
+
+    // Read back effective buffer sizes, because OS may silently adjust them.
+    // E.g. Linux doubles requested size and caps it by net.core.rmem_max
+    // and net.core.wmem_max.
+    int recv_buffer_size = 0;
+    if (uv_recv_buffer_size((uv_handle_t*)&handle_, &recv_buffer_size) != 0) {
+        recv_buffer_size = 0;
+    }
+
+    int send_buffer_size = 0;
+    if (uv_send_buffer_size((uv_handle_t*)&handle_, &send_buffer_size) != 0) {
+        send_buffer_size = 0;
+    }
+
+    if ((size_t)recv_buffer_size < config_.recv_buffer_size
+        || (size_t)send_buffer_size < config_.send_buffer_size) {
+        roc_log(LogInfo,
+                "udp port: %s: socket buffer size was limited by OS:"
+                " recv_buffer=%lu(requested=%lu) send_buffer=%lu(requested=%lu)",
+                descriptor(), (unsigned long)recv_buffer_size,
+                (unsigned long)config_.recv_buffer_size,
+                (unsigned long)send_buffer_size,
+                (unsigned long)config_.send_buffer_size);
+    }
+
+    roc_log(LogDebug,
+            "udp port: %s: socket options:"
+            " recv_buffer=%lu send_buffer=%lu busy_poll=%.3fms dscp=%u priority=%d",
+            descriptor(), (unsigned long)recv_buffer_size,
+            (unsigned long)send_buffer_size,
+            (double)config_.recv_busy_poll / core::Millisecond, config_.dscp,
+            config_.priority);
+
+    return true;
+}
+
+bool UdpPort::setup_multicast_send_() {
+    if (config_.multicast_ttl != 0) {
+        if (int err = uv_udp_set_multicast_ttl(&handle_, (int)config_.multicast_ttl)) {
+            roc_log(LogError, "udp port: %s: uv_udp_set_multicast_ttl(): [%s] %s",
+                    descriptor(), uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    if (!config_.enable_multicast_loop) {
+        if (int err = uv_udp_set_multicast_loop(&handle_, 0)) {
+            roc_log(LogError, "udp port: %s: uv_udp_set_multicast_loop(): [%s] %s",
+                    descriptor(), uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    roc_log(LogDebug, "udp port: %s: configured multicast sending: ttl=%u loop=%d",
+            descriptor(), config_.multicast_ttl, (int)config_.enable_multicast_loop);
+
+    return (multicast_send_configured_ = true);
 }
 
 bool UdpPort::join_multicast_group_() {
@@ -569,11 +1128,23 @@ void UdpPort::report_stats_() {
     }
 
     const int recv_packets = received_packets_;
+    const int recv_batches = received_batches_;
     const int sent_packets = sent_packets_;
-    const int sent_packets_nb = (sent_packets - sent_packets_blk_);
-
-    roc_log(LogDebug, "udp port: %s: recv=%d send=%d send_nb=%d", descriptor(),
-            recv_packets, sent_packets, sent_packets_nb);
+    const int sent_packets_blk = sent_packets_blk_;
+    const int sent_packets_batch = sent_packets_batch_;
+    const int sent_packets_nb = (sent_packets - sent_packets_blk - sent_packets_batch);
+    const int sent_batches = sent_batches_;
+    const int write_wakeups = write_wakeups_;
+    const int dropped_repair = dropped_repair_packets_;
+    const int truncated = truncated_packets_;
+    const int copied = copied_packets_;
+
+    roc_log(LogDebug,
+            "udp port: %s: recv=%d recv_batch=%d recv_trunc=%d recv_copy=%d send=%d"
+            " send_nb=%d send_batched=%d send_batch=%d send_wakeups=%d drop_repair=%d",
+            descriptor(), recv_packets, recv_batches, truncated, copied, sent_packets,
+            sent_packets_nb, sent_packets_batch, sent_batches, write_wakeups,
+            dropped_repair);
 }
 
 void UdpPort::format_descriptor(core::StringBuilder& b) {
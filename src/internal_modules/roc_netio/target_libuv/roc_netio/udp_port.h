@@ -20,10 +20,15 @@
 #include "roc_core/list_node.h"
 #include "roc_core/mpsc_queue.h"
 #include "roc_core/rate_limiter.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
+#include "roc_packet/capture_ring.h"
+#include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
 
 namespace roc {
 namespace netio {
@@ -40,6 +45,18 @@ struct UdpConfig {
     //! Used only if receiving is started.
     char multicast_interface[64];
 
+    //! TTL of outgoing multicast packets.
+    //! Limits how many routers multicast packets may pass. If zero, OS default
+    //! is used, which is usually 1, i.e. packets don't leave local network.
+    //! Used only if sending is started.
+    unsigned int multicast_ttl;
+
+    //! If true, outgoing multicast packets are looped back to local sockets
+    //! which joined the group. Disabling it avoids delivering packets to
+    //! receivers on the same host when they're not needed there.
+    //! Used only if sending is started.
+    bool enable_multicast_loop;
+
     //! If set, enable SO_REUSEADDR when binding socket to non-ephemeral port.
     //! If not set, SO_REUSEADDR is enabled only for multicast sockets when
     //! binding to non-ephemeral port.
@@ -51,9 +68,114 @@ struct UdpConfig {
     //! Used only if sending is started.
     bool enable_non_blocking;
 
+    //! If true, receive multiple datagrams per system call.
+    //! When socket becomes readable, port drains pending datagrams in batches
+    //! into buffers preallocated from packet factory, using recvmmsg() where
+    //! it's available. Number of batches per wakeup is limited, so that a
+    //! flooded port doesn't starve other ports of the same network loop.
+    //! Used only if receiving is started.
+    bool enable_batch_recv;
+
+    //! If true, send multiple datagrams per system call.
+    //! When network thread wakes up to send enqueued packets, port sends them
+    //! in batches using sendmmsg() where it's available. Packets that can't be
+    //! sent without blocking fall back to regular asynchronous write.
+    //! Used only if sending is started.
+    bool enable_batch_send;
+
+    //! If true, use UDP generic segmentation offload for batched sending.
+    //! Subsequent packets in batch with same size and destination are passed
+    //! to kernel as a single message. Automatically disabled if kernel doesn't
+    //! support it.
+    //! Used only if batched sending is enabled.
+    bool enable_gso;
+
+    //! If true, take receive timestamps of packets from kernel.
+    //! Kernel stamps datagram when it's received by network stack, so the
+    //! timestamp doesn't include the delay before network thread wakes up and
+    //! reads it. This makes jitter and latency measurements more precise.
+    //! When enabled, port reads datagrams in batches, like with
+    //! enable_batch_recv, because libuv doesn't provide timestamps.
+    //! If kernel timestamps are not supported, they're silently replaced
+    //! with timestamps taken in user space.
+    //! Used only if receiving is started.
+    bool enable_kernel_timestamps;
+
+    //! If true, socket is not read on network thread.
+    //! Instead, receiving is started using start_inline_recv(), and the
+    //! returned reader polls socket without blocking from the thread that
+    //! consumes packets. This removes handoff of every packet from network
+    //! thread when one thread owns both socket and receiver pipeline.
+    //! Used only if receiving is started.
+    bool enable_inline_recv;
+
+    //! Size of socket receive buffer (SO_RCVBUF), in bytes.
+    //! Larger buffer allows to absorb bursts of incoming packets while
+    //! network thread is not yet woken up, instead of dropping them in kernel.
+    //! OS may adjust or limit the value, effective value is reported to log.
+    //! If zero, OS default is used.
+    size_t recv_buffer_size;
+
+    //! Size of socket send buffer (SO_SNDBUF), in bytes.
+    //! OS may adjust or limit the value, effective value is reported to log.
+    //! If zero, OS default is used.
+    size_t send_buffer_size;
+
+    //! Kernel busy-poll budget for receiving (SO_BUSY_POLL).
+    //! If non-zero, reads from socket busy-poll network device queue during
+    //! given time when there are no pending packets. Reduces receive latency
+    //! at the cost of higher CPU usage. Supported only on Linux. Setting value
+    //! higher than system default requires CAP_NET_ADMIN.
+    //! Used only if receiving is started.
+    core::nanoseconds_t recv_busy_poll;
+
+    //! DSCP value of outgoing packets, from 0 to 63.
+    //! Set via IP_TOS for IPv4 and IPV6_TCLASS for IPv6. Allows network
+    //! equipment to prioritize traffic, e.g. 46 (Expedited Forwarding) is
+    //! commonly used for real-time audio.
+    //! If zero, OS default is used.
+    unsigned int dscp;
+
+    //! Priority of outgoing packets in local queueing disciplines (SO_PRIORITY).
+    //! Supported only on Linux. Values higher than 6 require CAP_NET_ADMIN.
+    //! If zero, OS default is used.
+    int priority;
+
+    //! Busy-poll budget for sending.
+    //! If non-zero, after network thread wakes up and sends enqueued packets,
+    //! it keeps polling the queue during given time before going to sleep.
+    //! Packets written meanwhile are sent without waking up network thread
+    //! again, at the cost of higher CPU usage.
+    //! Used only if sending is started.
+    core::nanoseconds_t send_busy_poll;
+
+    //! Maximum number of packets waiting for sending before repair packets
+    //! are dropped.
+    //! Outgoing source and control packets are always sent before repair
+    //! packets. If non-zero, repair packets are also dropped instead of being
+    //! enqueued when this number of packets is already pending, so that they
+    //! don't delay following source packets. Source and control packets are
+    //! never dropped.
+    //! Used only if sending is started.
+    size_t repair_queue_limit;
+
     UdpConfig()
-        : enable_reuseaddr(false)
-        , enable_non_blocking(true) {
+        : multicast_ttl(0)
+        , enable_multicast_loop(true)
+        , enable_reuseaddr(false)
+        , enable_non_blocking(true)
+        , enable_batch_recv(true)
+        , enable_batch_send(true)
+        , enable_gso(false)
+        , enable_kernel_timestamps(false)
+        , enable_inline_recv(false)
+        , recv_buffer_size(0)
+        , send_buffer_size(0)
+        , recv_busy_poll(0)
+        , dscp(0)
+        , priority(0)
+        , send_busy_poll(0)
+        , repair_queue_limit(0) {
         multicast_interface[0] = '\0';
     }
 
@@ -61,18 +183,35 @@ struct UdpConfig {
     bool operator==(const UdpConfig& other) const {
         return bind_address == other.bind_address
             && strcmp(multicast_interface, other.multicast_interface) == 0
+            && multicast_ttl == other.multicast_ttl
+            && enable_multicast_loop == other.enable_multicast_loop
             && enable_reuseaddr == other.enable_reuseaddr
-            && enable_non_blocking == other.enable_non_blocking;
+            && enable_non_blocking == other.enable_non_blocking
+            && enable_batch_recv == other.enable_batch_recv
+            && enable_batch_send == other.enable_batch_send
+            && enable_gso == other.enable_gso
+            && enable_kernel_timestamps == other.enable_kernel_timestamps
+            && enable_inline_recv == other.enable_inline_recv
+            && recv_buffer_size == other.recv_buffer_size
+            && send_buffer_size == other.send_buffer_size
+            && recv_busy_poll == other.recv_busy_poll && dscp == other.dscp
+            && priority == other.priority
+            && send_busy_poll == other.send_busy_poll
+            && repair_queue_limit == other.repair_queue_limit;
     }
 };
 
 //! UDP sender/receiver port.
-class UdpPort : public BasicPort, private packet::IWriter {
+class UdpPort : public BasicPort, private packet::IWriter, private packet::IReader {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p capture_ring is not NULL, received and sent packets are captured
+    //!  into it.
     UdpPort(const UdpConfig& config,
             uv_loop_t& event_loop,
             packet::PacketFactory& packet_factory,
+            packet::CaptureRing* capture_ring,
             core::IArena& arena);
 
     //! Destroy.
@@ -91,6 +230,9 @@ public:
     //! @remarks
     //!  Packets written to returned writer will be enqueued for sending.
     //!  Writer can be used from any thread.
+    //!  Repair packets are sent after all enqueued source and control packets.
+    //!  If repair packet is dropped because of repair_queue_limit, writer
+    //!  returns status::StatusLimit.
     packet::IWriter* start_send();
 
     //! Start receiving packets.
@@ -99,11 +241,39 @@ public:
     //!  Writer will be invoked from network thread.
     bool start_recv(packet::IWriter& inbound_writer);
 
+    //! Start receiving packets inline.
+    //! @remarks
+    //!  Socket is not read on network thread. Instead, every read from
+    //!  returned reader receives pending datagrams without blocking and
+    //!  returns them one by one, or status::StatusNoData if there are none.
+    //!  Reader should be used from a single thread, and should not be used
+    //!  after port is closed.
+    //! @note
+    //!  Requires enable_inline_recv to be set in config.
+    packet::IReader* start_inline_recv();
+
 protected:
     //! Format descriptor.
     virtual void format_descriptor(core::StringBuilder& b);
 
 private:
+    // Maximum number of datagrams received by one batch.
+    enum { MaxRecvBatch = 32 };
+
+    // Maximum number of batches received per one readiness event.
+    enum { MaxRecvBatchesPerEvent = 8 };
+
+    // Maximum number of datagrams sent by one batch.
+    enum { MaxSendBatch = 32 };
+
+    // State of asynchronous send, allocated only for packets that couldn't
+    // be sent without blocking and were handed over to libuv.
+    struct SendRequest {
+        uv_udp_send_t request;
+        packet::PacketPtr packet;
+        UdpPort* port;
+    };
+
     static void close_cb_(uv_handle_t* handle);
 
     static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
@@ -113,9 +283,29 @@ private:
                          const sockaddr* addr,
                          unsigned flags);
 
+    bool setup_recv_();
+    void recv_batches_();
+    size_t recv_batch_();
+    core::BufferPtr shrink_buffer_(const core::BufferPtr& recv_buf, size_t size);
+    void report_truncated_(const address::SocketAddr& src_addr, size_t buf_size);
+    void recv_packet_(const core::BufferPtr& bp,
+                      size_t size,
+                      const address::SocketAddr& src_addr,
+                      core::nanoseconds_t timestamp);
+
     static void write_sem_cb_(uv_async_t* handle);
+    static void pacing_timer_cb_(uv_timer_t* handle);
+    void send_pending_();
+    void poll_pending_();
+    packet::PacketPtr pop_pending_();
     static void send_cb_(uv_udp_send_t* req, int status);
 
+    void send_batch_();
+    void send_packet_(const packet::PacketPtr& pp);
+
+    // Implements packet::IReader::read()
+    virtual status::StatusCode read(packet::PacketPtr& packet);
+
     // Implements packet::IWriter::write()
     virtual status::StatusCode write(const packet::PacketPtr& packet);
     void write_(const packet::PacketPtr& packet);
@@ -124,6 +314,8 @@ private:
     bool fully_closed_() const;
     void start_closing_();
 
+    bool setup_socket_options_();
+    bool setup_multicast_send_();
     bool join_multicast_group_();
     void leave_multicast_group_();
 
@@ -142,24 +334,46 @@ private:
     uv_async_t write_sem_;
     bool write_sem_initialized_;
 
+    uv_timer_t pacing_timer_;
+    bool pacing_timer_initialized_;
+    packet::PacketPtr paced_packet_;
+
+    bool multicast_send_configured_;
     bool multicast_group_joined_;
     bool recv_started_;
+    bool kernel_timestamps_;
+    bool batch_recv_;
     bool want_close_;
     bool closed_;
 
     uv_os_fd_t fd_;
 
     packet::PacketFactory& packet_factory_;
+    packet::CaptureRing* capture_ring_;
 
     packet::IWriter* inbound_writer_;
+    core::BufferPtr recv_bufs_[MaxRecvBatch];
+    // Received but not yet read packets, used in inline mode.
+    packet::Queue inline_queue_;
     core::MpscQueue<packet::Packet> outbound_queue_;
+    core::MpscQueue<packet::Packet> outbound_repair_queue_;
+
+    core::SlabPool<SendRequest> send_req_pool_;
 
     core::RateLimiter rate_limiter_;
 
     core::Atomic<int> pending_packets_;
+    core::Atomic<int> write_sem_pending_;
+    core::Atomic<int> write_wakeups_;
     core::Atomic<int> sent_packets_;
     core::Atomic<int> sent_packets_blk_;
+    core::Atomic<int> sent_packets_batch_;
+    core::Atomic<int> sent_batches_;
+    core::Atomic<int> dropped_repair_packets_;
     core::Atomic<int> received_packets_;
+    core::Atomic<int> received_batches_;
+    core::Atomic<int> truncated_packets_;
+    core::Atomic<int> copied_packets_;
 };
 
 } // namespace netio
@@ -0,0 +1,631 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <netinet/in.h>
+#include <string.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/pcap_reader.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// File header magic numbers.
+const uint32_t PcapMagic_Micro = 0xa1b2c3d4;
+const uint32_t PcapMagic_Nano = 0xa1b23c4d;
+const uint32_t PcapngMagic_ByteOrder = 0x1a2b3c4d;
+
+// Pcapng block types.
+const uint32_t PcapngBlock_Section = 0x0a0d0d0a;
+const uint32_t PcapngBlock_Interface = 0x00000001;
+const uint32_t PcapngBlock_SimplePacket = 0x00000003;
+const uint32_t PcapngBlock_EnhancedPacket = 0x00000006;
+
+// Pcapng interface option with timestamp resolution.
+const uint16_t PcapngOption_End = 0;
+const uint16_t PcapngOption_TsResol = 9;
+
+// Link types.
+// See https://www.tcpdump.org/linktypes.html
+const uint32_t LinkType_Null = 0;
+const uint32_t LinkType_Ethernet = 1;
+const uint32_t LinkType_RawBsd1 = 12;
+const uint32_t LinkType_RawBsd2 = 14;
+const uint32_t LinkType_Raw = 101;
+const uint32_t LinkType_Loop = 108;
+const uint32_t LinkType_LinuxSll = 113;
+const uint32_t LinkType_IPv4 = 228;
+const uint32_t LinkType_IPv6 = 229;
+const uint32_t LinkType_LinuxSll2 = 276;
+
+// Ethernet types.
+const uint16_t EtherType_IPv4 = 0x0800;
+const uint16_t EtherType_IPv6 = 0x86dd;
+const uint16_t EtherType_Vlan = 0x8100;
+const uint16_t EtherType_QinQ = 0x88a8;
+
+// IP protocols and IPv6 extension headers.
+const uint8_t IpProto_HopOpts = 0;
+const uint8_t IpProto_Udp = 17;
+const uint8_t IpProto_Routing = 43;
+const uint8_t IpProto_DstOpts = 60;
+
+const size_t PcapHeaderSize = 24;
+const size_t PcapRecordSize = 16;
+const size_t PcapngBlockOverhead = 12;
+const size_t EthernetHeaderSize = 14;
+const size_t SllHeaderSize = 16;
+const size_t Sll2HeaderSize = 20;
+const size_t NullHeaderSize = 4;
+const size_t IPv4HeaderSize = 20;
+const size_t IPv6HeaderSize = 40;
+const size_t UdpHeaderSize = 8;
+
+// Network headers are always big-endian.
+uint16_t get_be16(const uint8_t* p) {
+    return uint16_t((p[0] << 8) | p[1]);
+}
+
+bool is_ip_ethertype(uint16_t type) {
+    return type == EtherType_IPv4 || type == EtherType_IPv6;
+}
+
+} // namespace
+
+PcapReader::PcapReader(packet::PacketFactory& packet_factory, core::IArena& arena)
+    : packet_factory_(packet_factory)
+    , format_(Format_None)
+    , big_endian_(false)
+    , pos_(0)
+    , pcap_link_type_(0)
+    , pcap_nanosec_(false)
+    , interfaces_(arena)
+    , last_timestamp_(0)
+    , n_packets_(0)
+    , n_skipped_(0) {
+}
+
+bool PcapReader::open(const char* path) {
+    roc_panic_if(!path);
+
+    if (format_ != Format_None) {
+        roc_panic("pcap reader: already opened");
+    }
+
+    if (!file_.open_read(path)) {
+        roc_log(LogError, "pcap reader: can't open file: path=%s", path);
+        return false;
+    }
+
+    if (open_pcap_()) {
+        format_ = Format_Pcap;
+    } else if (open_pcapng_()) {
+        format_ = Format_Pcapng;
+    } else {
+        roc_log(LogError, "pcap reader: unknown file format: path=%s", path);
+        (void)file_.close();
+        return false;
+    }
+
+    roc_log(LogDebug, "pcap reader: opened file: path=%s format=%s size=%lu", path,
+            format_ == Format_Pcap ? "pcap" : "pcapng", (unsigned long)file_.size());
+
+    return true;
+}
+
+void PcapReader::close() {
+    if (format_ == Format_None) {
+        return;
+    }
+
+    (void)file_.close();
+
+    format_ = Format_None;
+    pos_ = 0;
+}
+
+size_t PcapReader::num_packets() const {
+    return n_packets_;
+}
+
+size_t PcapReader::num_skipped() const {
+    return n_skipped_;
+}
+
+status::StatusCode PcapReader::read(packet::PacketPtr& packet) {
+    if (format_ == Format_None) {
+        roc_panic("pcap reader: not opened");
+    }
+
+    for (;;) {
+        const uint8_t* data = NULL;
+        size_t size = 0;
+        uint32_t link_type = 0;
+        core::nanoseconds_t timestamp = 0;
+
+        const bool has_record = format_ == Format_Pcap
+            ? next_pcap_record_(data, size, link_type, timestamp)
+            : next_pcapng_record_(data, size, link_type, timestamp);
+
+        if (!has_record) {
+            return status::StatusNoData;
+        }
+
+        packet::PacketPtr pp = decode_link_(link_type, data, size, timestamp);
+        if (!pp) {
+            n_skipped_++;
+            continue;
+        }
+
+        n_packets_++;
+        packet = pp;
+
+        return status::StatusOK;
+    }
+}
+
+bool PcapReader::open_pcap_() {
+    if (file_.size() < PcapHeaderSize) {
+        return false;
+    }
+
+    const uint8_t* header = file_.data();
+
+    for (int n = 0; n < 2; n++) {
+        big_endian_ = (n == 1);
+
+        const uint32_t magic = get_u32_(header);
+
+        if (magic == PcapMagic_Micro || magic == PcapMagic_Nano) {
+            pcap_nanosec_ = (magic == PcapMagic_Nano);
+            // Upper bits may contain FCS length.
+            pcap_link_type_ = get_u32_(header + 20) & 0xffff;
+            pos_ = PcapHeaderSize;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PcapReader::open_pcapng_() {
+    if (file_.size() < PcapngBlockOverhead + 4) {
+        return false;
+    }
+
+    if (!parse_section_header_(file_.data(), file_.size())) {
+        return false;
+    }
+
+    pos_ = 0;
+    return true;
+}
+
+bool PcapReader::next_pcap_record_(const uint8_t*& data,
+                                   size_t& size,
+                                   uint32_t& link_type,
+                                   core::nanoseconds_t& timestamp) {
+    if (pos_ + PcapRecordSize > file_.size()) {
+        if (pos_ != file_.size()) {
+            roc_log(LogDebug, "pcap reader: ignoring truncated record at end of file");
+        }
+        return false;
+    }
+
+    const uint8_t* record = file_.data() + pos_;
+
+    const uint32_t ts_sec = get_u32_(record);
+    const uint32_t ts_frac = get_u32_(record + 4);
+    const uint32_t incl_len = get_u32_(record + 8);
+
+    if (incl_len > file_.size() - pos_ - PcapRecordSize) {
+        roc_log(LogDebug, "pcap reader: ignoring truncated record at end of file");
+        return false;
+    }
+
+    data = record + PcapRecordSize;
+    size = incl_len;
+    link_type = pcap_link_type_;
+    timestamp = (core::nanoseconds_t)ts_sec * core::Second
+        + (core::nanoseconds_t)ts_frac * (pcap_nanosec_ ? 1 : core::Microsecond);
+
+    pos_ += PcapRecordSize + incl_len;
+
+    return true;
+}
+
+bool PcapReader::next_pcapng_record_(const uint8_t*& data,
+                                     size_t& size,
+                                     uint32_t& link_type,
+                                     core::nanoseconds_t& timestamp) {
+    while (pos_ + PcapngBlockOverhead <= file_.size()) {
+        const uint8_t* block = file_.data() + pos_;
+
+        // Section header defines byte order of itself and following blocks,
+        // and its type is the same in both byte orders.
+        if (get_u32_(block) == PcapngBlock_Section) {
+            if (!parse_section_header_(block, file_.size() - pos_)) {
+                roc_log(LogError, "pcap reader: invalid section header");
+                return false;
+            }
+        }
+
+        const uint32_t block_type = get_u32_(block);
+        const uint32_t block_len = get_u32_(block + 4);
+
+        if (block_len < PcapngBlockOverhead || block_len % 4 != 0
+            || block_len > file_.size() - pos_) {
+            roc_log(LogDebug, "pcap reader: ignoring truncated block at end of file");
+            return false;
+        }
+
+        const uint8_t* body = block + 8;
+        const size_t body_size = block_len - PcapngBlockOverhead;
+
+        pos_ += block_len;
+
+        switch (block_type) {
+        case PcapngBlock_Interface:
+            if (!parse_interface_(body, body_size)) {
+                roc_log(LogError, "pcap reader: invalid interface description");
+                return false;
+            }
+            break;
+
+        case PcapngBlock_EnhancedPacket: {
+            if (body_size < 20) {
+                break;
+            }
+
+            const uint32_t if_id = get_u32_(body);
+            const uint64_t ts = ((uint64_t)get_u32_(body + 4) << 32) | get_u32_(body + 8);
+            const uint32_t cap_len = get_u32_(body + 12);
+
+            if (if_id >= interfaces_.size() || cap_len > body_size - 20) {
+                n_skipped_++;
+                break;
+            }
+
+            const Interface& iface = interfaces_[if_id];
+
+            data = body + 20;
+            size = cap_len;
+            link_type = iface.link_type;
+            timestamp = (core::nanoseconds_t)(ts / iface.ts_units) * core::Second
+                + (core::nanoseconds_t)((double)(ts % iface.ts_units) * core::Second
+                                        / (double)iface.ts_units);
+
+            last_timestamp_ = timestamp;
+            return true;
+        }
+
+        case PcapngBlock_SimplePacket: {
+            if (body_size < 4 || interfaces_.size() == 0) {
+                n_skipped_++;
+                break;
+            }
+
+            const uint32_t orig_len = get_u32_(body);
+
+            // Simple packet block has no timestamp, use timestamp of
+            // previous packet.
+            data = body + 4;
+            size = std::min((size_t)orig_len, body_size - 4);
+            link_type = interfaces_[0].link_type;
+            timestamp = last_timestamp_;
+            return true;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool PcapReader::parse_section_header_(const uint8_t* block, size_t block_size) {
+    if (block_size < PcapngBlockOverhead + 4) {
+        return false;
+    }
+
+    for (int n = 0; n < 2; n++) {
+        big_endian_ = (n == 1);
+
+        if (get_u32_(block) == PcapngBlock_Section
+            && get_u32_(block + 8) == PcapngMagic_ByteOrder) {
+            // Interface ids are local to section.
+            if (!interfaces_.resize(0)) {
+                return false;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PcapReader::parse_interface_(const uint8_t* body, size_t body_size) {
+    if (body_size < 8) {
+        return false;
+    }
+
+    Interface iface;
+    iface.link_type = get_u16_(body);
+    iface.ts_units = 1000000;
+
+    size_t pos = 8;
+
+    while (pos + 4 <= body_size) {
+        const uint16_t code = get_u16_(body + pos);
+        const uint16_t len = get_u16_(body + pos + 2);
+
+        pos += 4;
+
+        if (code == PcapngOption_End || len > body_size - pos) {
+            break;
+        }
+
+        if (code == PcapngOption_TsResol && len >= 1) {
+            const uint8_t resol = body[pos];
+
+            uint64_t units = 1;
+            if (resol & 0x80) {
+                units <<= std::min(resol & 0x7f, 63);
+            } else {
+                for (int n = 0; n < std::min((int)resol, 19); n++) {
+                    units *= 10;
+                }
+            }
+            iface.ts_units = units;
+        }
+
+        pos += (len + 3u) & ~3u;
+    }
+
+    return interfaces_.push_back(iface);
+}
+
+packet::PacketPtr PcapReader::decode_link_(uint32_t link_type,
+                                           const uint8_t* data,
+                                           size_t size,
+                                           core::nanoseconds_t timestamp) {
+    switch (link_type) {
+    case LinkType_Null:
+    case LinkType_Loop:
+        // 4-byte address family, IP version is checked later.
+        if (size < NullHeaderSize) {
+            return NULL;
+        }
+        return decode_ip_(data + NullHeaderSize, size - NullHeaderSize, timestamp);
+
+    case LinkType_Ethernet: {
+        size_t offset = EthernetHeaderSize - 2;
+        uint16_t type = 0;
+
+        for (;;) {
+            if (offset + 2 > size) {
+                return NULL;
+            }
+            type = get_be16(data + offset);
+            offset += 2;
+            if (type != EtherType_Vlan && type != EtherType_QinQ) {
+                break;
+            }
+            // Skip VLAN tag.
+            offset += 2;
+        }
+
+        if (!is_ip_ethertype(type)) {
+            return NULL;
+        }
+        return decode_ip_(data + offset, size - offset, timestamp);
+    }
+
+    case LinkType_LinuxSll:
+        if (size < SllHeaderSize || !is_ip_ethertype(get_be16(data + 14))) {
+            return NULL;
+        }
+        return decode_ip_(data + SllHeaderSize, size - SllHeaderSize, timestamp);
+
+    case LinkType_LinuxSll2:
+        if (size < Sll2HeaderSize || !is_ip_ethertype(get_be16(data))) {
+            return NULL;
+        }
+        return decode_ip_(data + Sll2HeaderSize, size - Sll2HeaderSize, timestamp);
+
+    case LinkType_Raw:
+    case LinkType_RawBsd1:
+    case LinkType_RawBsd2:
+    case LinkType_IPv4:
+    case LinkType_IPv6:
+        return decode_ip_(data, size, timestamp);
+
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+packet::PacketPtr PcapReader::decode_ip_(const uint8_t* data,
+                                         size_t size,
+                                         core::nanoseconds_t timestamp) {
+    if (size < 1) {
+        return NULL;
+    }
+
+    const int version = data[0] >> 4;
+
+    if (version == 4) {
+        const size_t header_size = (size_t)(data[0] & 0xf) * 4;
+        if (header_size < IPv4HeaderSize || size < header_size) {
+            return NULL;
+        }
+
+        // Trim link layer padding.
+        const size_t total_size = get_be16(data + 2);
+        if (total_size < header_size) {
+            return NULL;
+        }
+        if (total_size < size) {
+            size = total_size;
+        }
+
+        // Skip fragments, we can't decode UDP without reassembly.
+        if ((get_be16(data + 6) & 0x3fff) != 0) {
+            return NULL;
+        }
+
+        if (data[9] != IpProto_Udp) {
+            return NULL;
+        }
+
+        return decode_udp_(data + header_size, size - header_size, data + 12, data + 16,
+                           false, timestamp);
+    }
+
+    if (version == 6) {
+        if (size < IPv6HeaderSize) {
+            return NULL;
+        }
+
+        const size_t total_size = IPv6HeaderSize + get_be16(data + 4);
+        if (total_size < size) {
+            size = total_size;
+        }
+
+        uint8_t next_header = data[6];
+        size_t offset = IPv6HeaderSize;
+
+        while (next_header == IpProto_HopOpts || next_header == IpProto_Routing
+               || next_header == IpProto_DstOpts) {
+            if (offset + 2 > size) {
+                return NULL;
+            }
+            next_header = data[offset];
+            offset += ((size_t)data[offset + 1] + 1) * 8;
+        }
+
+        if (next_header != IpProto_Udp || offset > size) {
+            return NULL;
+        }
+
+        return decode_udp_(data + offset, size - offset, data + 8, data + 24, true,
+                           timestamp);
+    }
+
+    return NULL;
+}
+
+packet::PacketPtr PcapReader::decode_udp_(const uint8_t* data,
+                                          size_t size,
+                                          const uint8_t* src_ip,
+                                          const uint8_t* dst_ip,
+                                          bool ipv6,
+                                          core::nanoseconds_t timestamp) {
+    if (size < UdpHeaderSize) {
+        return NULL;
+    }
+
+    // Datagram is incomplete if capture was limited by snaplen.
+    const size_t udp_size = get_be16(data + 4);
+    if (udp_size < UdpHeaderSize || udp_size > size) {
+        return NULL;
+    }
+
+    const size_t payload_size = udp_size - UdpHeaderSize;
+
+    address::SocketAddr src_addr, dst_addr;
+
+    if (ipv6) {
+        sockaddr_in6 src_sa, dst_sa;
+        memset(&src_sa, 0, sizeof(src_sa));
+        memset(&dst_sa, 0, sizeof(dst_sa));
+
+        src_sa.sin6_family = dst_sa.sin6_family = AF_INET6;
+        memcpy(&src_sa.sin6_addr, src_ip, 16);
+        memcpy(&dst_sa.sin6_addr, dst_ip, 16);
+        memcpy(&src_sa.sin6_port, data, 2);
+        memcpy(&dst_sa.sin6_port, data + 2, 2);
+
+        if (!src_addr.set_host_port_saddr((const sockaddr*)&src_sa)
+            || !dst_addr.set_host_port_saddr((const sockaddr*)&dst_sa)) {
+            return NULL;
+        }
+    } else {
+        sockaddr_in src_sa, dst_sa;
+        memset(&src_sa, 0, sizeof(src_sa));
+        memset(&dst_sa, 0, sizeof(dst_sa));
+
+        src_sa.sin_family = dst_sa.sin_family = AF_INET;
+        memcpy(&src_sa.sin_addr, src_ip, 4);
+        memcpy(&dst_sa.sin_addr, dst_ip, 4);
+        memcpy(&src_sa.sin_port, data, 2);
+        memcpy(&dst_sa.sin_port, data + 2, 2);
+
+        if (!src_addr.set_host_port_saddr((const sockaddr*)&src_sa)
+            || !dst_addr.set_host_port_saddr((const sockaddr*)&dst_sa)) {
+            return NULL;
+        }
+    }
+
+    core::BufferPtr buffer = packet_factory_.new_packet_buffer();
+    if (!buffer) {
+        roc_log(LogError, "pcap reader: can't allocate buffer");
+        return NULL;
+    }
+
+    if (buffer->size() < payload_size) {
+        roc_log(LogDebug,
+                "pcap reader: skipping datagram larger than maximum packet size:"
+                " size=%lu max=%lu",
+                (unsigned long)payload_size, (unsigned long)buffer->size());
+        return NULL;
+    }
+
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        roc_log(LogError, "pcap reader: can't allocate packet");
+        return NULL;
+    }
+
+    core::Slice<uint8_t> payload(*buffer, 0, payload_size);
+    memcpy(payload.data(), data + UdpHeaderSize, payload_size);
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = dst_addr;
+    pp->udp()->receive_timestamp = timestamp;
+    pp->set_buffer(payload);
+
+    return pp;
+}
+
+uint16_t PcapReader::get_u16_(const uint8_t* p) const {
+    if (big_endian_) {
+        return uint16_t((p[0] << 8) | p[1]);
+    }
+    return uint16_t((p[1] << 8) | p[0]);
+}
+
+uint32_t PcapReader::get_u32_(const uint8_t* p) const {
+    if (big_endian_) {
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8)
+            | (uint32_t)p[3];
+    }
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8)
+        | (uint32_t)p[0];
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_posix/roc_netio/pcap_reader.h
+//! @brief Packet capture file reader.
+
+#ifndef ROC_NETIO_PCAP_READER_H_
+#define ROC_NETIO_PCAP_READER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mapped_file.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+
+//! Packet capture file reader.
+//!
+//! @remarks
+//!  Reads UDP datagrams from pcap or pcapng file, as written by tcpdump,
+//!  Wireshark, and similar tools. Supports Ethernet (with VLAN tags), Linux
+//!  cooked capture (v1 and v2), BSD loopback, and raw IP link types, and
+//!  both IPv4 and IPv6.
+//!
+//! @remarks
+//!  Every returned packet has UDP flag, source and destination addresses,
+//!  and receive timestamp set to capture time, and its buffer contains UDP
+//!  payload. Non-UDP and fragmented datagrams are skipped.
+//!
+//! @remarks
+//!  File is memory-mapped, so reading doesn't involve system calls.
+class PcapReader : public packet::IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    PcapReader(packet::PacketFactory& packet_factory, core::IArena& arena);
+
+    //! Open file.
+    //! @remarks
+    //!  Detects file format automatically.
+    ROC_ATTR_NODISCARD bool open(const char* path);
+
+    //! Close file.
+    void close();
+
+    //! Read next UDP packet.
+    //! @returns
+    //!  status::StatusNoData when end of file is reached or file is broken.
+    virtual ROC_ATTR_NODISCARD status::StatusCode read(packet::PacketPtr& packet);
+
+    //! Get number of returned packets.
+    size_t num_packets() const;
+
+    //! Get number of skipped records.
+    size_t num_skipped() const;
+
+private:
+    enum Format { Format_None, Format_Pcap, Format_Pcapng };
+
+    struct Interface {
+        // Link type.
+        uint32_t link_type;
+        // Number of timestamp units per second.
+        uint64_t ts_units;
+    };
+
+    enum { MaxInterfaces = 8 };
+
+    bool open_pcap_();
+    bool open_pcapng_();
+
+    bool next_pcap_record_(const uint8_t*& data,
+                           size_t& size,
+                           uint32_t& link_type,
+                           core::nanoseconds_t& timestamp);
+
+    bool next_pcapng_record_(const uint8_t*& data,
+                             size_t& size,
+                             uint32_t& link_type,
+                             core::nanoseconds_t& timestamp);
+
+    bool parse_section_header_(const uint8_t* block, size_t block_size);
+    bool parse_interface_(const uint8_t* body, size_t body_size);
+
+    packet::PacketPtr decode_link_(uint32_t link_type,
+                                   const uint8_t* data,
+                                   size_t size,
+                                   core::nanoseconds_t timestamp);
+    packet::PacketPtr decode_ip_(const uint8_t* data,
+                                 size_t size,
+                                 core::nanoseconds_t timestamp);
+    packet::PacketPtr decode_udp_(const uint8_t* data,
+                                  size_t size,
+                                  const uint8_t* src_ip,
+                                  const uint8_t* dst_ip,
+                                  bool ipv6,
+                                  core::nanoseconds_t timestamp);
+
+    uint16_t get_u16_(const uint8_t* p) const;
+    uint32_t get_u32_(const uint8_t* p) const;
+
+    packet::PacketFactory& packet_factory_;
+
+    core::MappedFile file_;
+    Format format_;
+    bool big_endian_;
+    size_t pos_;
+
+    // Pcap parameters.
+    uint32_t pcap_link_type_;
+    bool pcap_nanosec_;
+
+    // Pcapng parameters of current section.
+    core::Array<Interface, MaxInterfaces> interfaces_;
+    core::nanoseconds_t last_timestamp_;
+
+    size_t n_packets_;
+    size_t n_skipped_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_PCAP_READER_H_
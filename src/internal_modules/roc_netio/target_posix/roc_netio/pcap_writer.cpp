@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/pcap_writer.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// Pcapng magic and version.
+const uint32_t PcapngMagic_ByteOrder = 0x1a2b3c4d;
+const uint16_t PcapngVersion_Major = 1;
+const uint16_t PcapngVersion_Minor = 0;
+
+// Pcapng block types.
+const uint32_t PcapngBlock_Section = 0x0a0d0d0a;
+const uint32_t PcapngBlock_Interface = 0x00000001;
+const uint32_t PcapngBlock_EnhancedPacket = 0x00000006;
+
+// Pcapng options.
+const uint16_t PcapngOption_End = 0;
+const uint16_t PcapngOption_Comment = 1;
+const uint16_t PcapngOption_IfName = 2;
+const uint16_t PcapngOption_TsResol = 9;
+const uint16_t PcapngOption_ShbUserAppl = 4;
+
+// Timestamp resolution: 10^-9.
+const uint8_t PcapngTsResol_Nano = 9;
+
+// Link type of raw IPv4 or IPv6 packets.
+// See https://www.tcpdump.org/linktypes.html
+const uint16_t LinkType_Raw = 101;
+
+const uint8_t IpProto_Udp = 17;
+const uint8_t IpTtl = 64;
+
+const size_t IPv4HeaderSize = 20;
+const size_t IPv6HeaderSize = 40;
+const size_t UdpHeaderSize = 8;
+
+// Enough for largest packet block with comment.
+const size_t MaxBlockSize = packet::CaptureRecord::MaxSnapLen + 256;
+
+// Builds pcapng block in memory.
+// Block fields are in host byte order, network headers are big-endian.
+class BlockBuilder {
+public:
+    explicit BlockBuilder(uint32_t type)
+        : size_(0) {
+        put_u32(type);
+        put_u32(0); // total length, filled in finish()
+    }
+
+    const uint8_t* data() const {
+        return buf_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    void put_u8(uint8_t v) {
+        roc_panic_if(size_ + 1 > sizeof(buf_));
+        buf_[size_++] = v;
+    }
+
+    void put_u16(uint16_t v) {
+        put_bytes(&v, sizeof(v));
+    }
+
+    void put_u32(uint32_t v) {
+        put_bytes(&v, sizeof(v));
+    }
+
+    void put_be16(uint16_t v) {
+        put_u8(uint8_t(v >> 8));
+        put_u8(uint8_t(v));
+    }
+
+    void put_bytes(const void* data, size_t size) {
+        roc_panic_if(size_ + size > sizeof(buf_));
+        memcpy(buf_ + size_, data, size);
+        size_ += size;
+    }
+
+    void pad() {
+        while (size_ % 4 != 0) {
+            put_u8(0);
+        }
+    }
+
+    void put_option(uint16_t code, const void* data, size_t size) {
+        put_u16(code);
+        put_u16((uint16_t)size);
+        put_bytes(data, size);
+        pad();
+    }
+
+    void put_string_option(uint16_t code, const char* str) {
+        put_option(code, str, strlen(str));
+    }
+
+    void finish() {
+        put_u16(PcapngOption_End);
+        put_u16(0);
+        const uint32_t total = uint32_t(size_ + 4);
+        put_u32(total);
+        memcpy(buf_ + 4, &total, sizeof(total));
+    }
+
+private:
+    uint8_t buf_[MaxBlockSize];
+    size_t size_;
+};
+
+bool is_ipv6(const packet::CaptureRecord& record) {
+    return record.src_addr.family() == address::Family_IPv6
+        || record.dst_addr.family() == address::Family_IPv6;
+}
+
+uint16_t addr_port(const address::SocketAddr& addr) {
+    return addr.has_host_port() ? (uint16_t)addr.port() : 0;
+}
+
+void get_ipv4(const address::SocketAddr& addr, uint8_t ip[4]) {
+    memset(ip, 0, 4);
+    if (addr.family() == address::Family_IPv4) {
+        memcpy(ip, &((const sockaddr_in*)addr.saddr())->sin_addr, 4);
+    }
+}
+
+void get_ipv6(const address::SocketAddr& addr, uint8_t ip[16]) {
+    memset(ip, 0, 16);
+    if (addr.family() == address::Family_IPv6) {
+        memcpy(ip, &((const sockaddr_in6*)addr.saddr())->sin6_addr, 16);
+    }
+}
+
+void put_ipv4_header(BlockBuilder& b, const packet::CaptureRecord& record) {
+    uint8_t hdr[IPv4HeaderSize];
+    memset(hdr, 0, sizeof(hdr));
+
+    const size_t total_len = IPv4HeaderSize + UdpHeaderSize + record.orig_len;
+
+    hdr[0] = 0x45; // version 4, IHL 5
+    hdr[2] = uint8_t(total_len >> 8);
+    hdr[3] = uint8_t(total_len);
+    hdr[8] = IpTtl;
+    hdr[9] = IpProto_Udp;
+    get_ipv4(record.src_addr, hdr + 12);
+    get_ipv4(record.dst_addr, hdr + 16);
+
+    uint32_t sum = 0;
+    for (size_t n = 0; n < IPv4HeaderSize; n += 2) {
+        sum += uint32_t((hdr[n] << 8) | hdr[n + 1]);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    const uint16_t checksum = uint16_t(~sum);
+    hdr[10] = uint8_t(checksum >> 8);
+    hdr[11] = uint8_t(checksum);
+
+    b.put_bytes(hdr, sizeof(hdr));
+}
+
+void put_ipv6_header(BlockBuilder& b, const packet::CaptureRecord& record) {
+    uint8_t hdr[IPv6HeaderSize];
+    memset(hdr, 0, sizeof(hdr));
+
+    const size_t payload_len = UdpHeaderSize + record.orig_len;
+
+    hdr[0] = 0x60; // version 6
+    hdr[4] = uint8_t(payload_len >> 8);
+    hdr[5] = uint8_t(payload_len);
+    hdr[6] = IpProto_Udp;
+    hdr[7] = IpTtl;
+    get_ipv6(record.src_addr, hdr + 8);
+    get_ipv6(record.dst_addr, hdr + 24);
+
+    b.put_bytes(hdr, sizeof(hdr));
+}
+
+// Checksum is left zero, which means "not computed" for IPv4.
+void put_udp_header(BlockBuilder& b, const packet::CaptureRecord& record) {
+    b.put_be16(addr_port(record.src_addr));
+    b.put_be16(addr_port(record.dst_addr));
+    b.put_be16(uint16_t(UdpHeaderSize + record.orig_len));
+    b.put_be16(0);
+}
+
+void format_comment(char* buf, size_t bufsz, const packet::CaptureRecord& record) {
+    snprintf(buf, bufsz, "session=%lu flags=%s%s%s%s", (unsigned long)record.source_id,
+             record.flags == 0 ? "none" : "",
+             (record.flags & packet::CaptureFlag_Late) ? "late," : "",
+             (record.flags & packet::CaptureFlag_Repaired) ? "repaired," : "",
+             (record.flags & packet::CaptureFlag_Dropped) ? "dropped," : "");
+
+    // Strip trailing comma.
+    const size_t len = strlen(buf);
+    if (len != 0 && buf[len - 1] == ',') {
+        buf[len - 1] = '\0';
+    }
+}
+
+} // namespace
+
+PcapWriter::PcapWriter()
+    : file_(NULL)
+    , n_packets_(0) {
+}
+
+PcapWriter::~PcapWriter() {
+    if (file_) {
+        roc_panic("pcap writer: file was not closed before calling destructor");
+    }
+}
+
+bool PcapWriter::open(const char* path) {
+    roc_panic_if(!path);
+
+    if (file_) {
+        roc_panic("pcap writer: can't open: already opened");
+    }
+
+    file_ = fopen(path, "wb");
+    if (!file_) {
+        roc_log(LogError, "pcap writer: can't open output file: path=%s error=%s", path,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    n_packets_ = 0;
+
+    bool ok = write_section_header_();
+
+    for (int point = 0; ok && point < packet::CapturePoint_Max; point++) {
+        ok = write_interface_((packet::CapturePoint)point);
+    }
+
+    if (!ok) {
+        fclose(file_);
+        file_ = NULL;
+        return false;
+    }
+
+    roc_log(LogDebug, "pcap writer: opened output file: path=%s", path);
+
+    return true;
+}
+
+bool PcapWriter::write(const packet::CaptureRecord& record) {
+    roc_panic_if(!file_);
+    roc_panic_if(record.point < 0 || record.point >= packet::CapturePoint_Max);
+    roc_panic_if(record.cap_len > packet::CaptureRecord::MaxSnapLen);
+
+    const bool ipv6 = is_ipv6(record);
+    const size_t hdr_size = (ipv6 ? IPv6HeaderSize : IPv4HeaderSize) + UdpHeaderSize;
+
+    const uint64_t ts = (uint64_t)record.timestamp;
+
+    BlockBuilder b(PcapngBlock_EnhancedPacket);
+    b.put_u32((uint32_t)record.point); // interface id
+    b.put_u32(uint32_t(ts >> 32));
+    b.put_u32(uint32_t(ts));
+    b.put_u32(uint32_t(hdr_size + record.cap_len));
+    b.put_u32(uint32_t(hdr_size + record.orig_len));
+
+    if (ipv6) {
+        put_ipv6_header(b, record);
+    } else {
+        put_ipv4_header(b, record);
+    }
+    put_udp_header(b, record);
+    b.put_bytes(record.data, record.cap_len);
+    b.pad();
+
+    char comment[128];
+    format_comment(comment, sizeof(comment), record);
+    b.put_string_option(PcapngOption_Comment, comment);
+
+    b.finish();
+
+    if (!write_block_(b.data(), b.size())) {
+        return false;
+    }
+
+    n_packets_++;
+    return true;
+}
+
+bool PcapWriter::write_all(const packet::CaptureRing& ring) {
+    packet::CaptureRecord record;
+
+    const uint32_t end = ring.end_seqnum();
+
+    for (uint32_t seqnum = ring.first_seqnum(); seqnum != end; seqnum++) {
+        if (!ring.read(seqnum, record)) {
+            continue;
+        }
+        if (!write(record)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PcapWriter::close() {
+    if (!file_) {
+        return true;
+    }
+
+    const bool ok = fclose(file_) == 0;
+    if (!ok) {
+        roc_log(LogError, "pcap writer: can't close output file: error=%s",
+                core::errno_to_str(errno).c_str());
+    }
+
+    file_ = NULL;
+    return ok;
+}
+
+size_t PcapWriter::num_packets() const {
+    return n_packets_;
+}
+
+bool PcapWriter::write_section_header_() {
+    BlockBuilder b(PcapngBlock_Section);
+    b.put_u32(PcapngMagic_ByteOrder);
+    b.put_u16(PcapngVersion_Major);
+    b.put_u16(PcapngVersion_Minor);
+    b.put_u32(0xffffffff); // section length is not specified
+    b.put_u32(0xffffffff);
+    b.put_string_option(PcapngOption_ShbUserAppl, "roc-toolkit");
+    b.finish();
+
+    return write_block_(b.data(), b.size());
+}
+
+bool PcapWriter::write_interface_(packet::CapturePoint point) {
+    char name[32];
+    snprintf(name, sizeof(name), "roc:%s", packet::capture_point_to_str(point));
+
+    BlockBuilder b(PcapngBlock_Interface);
+    b.put_u16(LinkType_Raw);
+    b.put_u16(0); // reserved
+    b.put_u32(0); // snap length is not limited
+    b.put_string_option(PcapngOption_IfName, name);
+    b.put_option(PcapngOption_TsResol, &PcapngTsResol_Nano, 1);
+    b.finish();
+
+    return write_block_(b.data(), b.size());
+}
+
+bool PcapWriter::write_block_(const void* data, size_t size) {
+    if (fwrite(data, size, 1, file_) != 1) {
+        roc_log(LogError, "pcap writer: can't write output file: error=%s",
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace netio
+} // namespace roc
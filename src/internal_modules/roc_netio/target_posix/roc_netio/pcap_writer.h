@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_posix/roc_netio/pcap_writer.h
+//! @brief Packet capture file writer.
+
+#ifndef ROC_NETIO_PCAP_WRITER_H_
+#define ROC_NETIO_PCAP_WRITER_H_
+
+#include <stdio.h>
+
+#include "roc_core/attributes.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/capture_ring.h"
+
+namespace roc {
+namespace netio {
+
+//! Packet capture file writer.
+//!
+//! @remarks
+//!  Writes records of packet::CaptureRing to pcapng file, which can be opened
+//!  by Wireshark, tcpdump, or PcapReader.
+//!
+//! @remarks
+//!  Every capture point is written as a separate interface named "roc:<point>",
+//!  e.g. "roc:ingress". Records are written as raw IP packets, with IP and UDP
+//!  headers synthesized from captured addresses, and pipeline annotations
+//!  (session and flags) are written as packet comments.
+class PcapWriter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    PcapWriter();
+
+    //! Deinitialize.
+    ~PcapWriter();
+
+    //! Open file and write headers.
+    ROC_ATTR_NODISCARD bool open(const char* path);
+
+    //! Write record.
+    ROC_ATTR_NODISCARD bool write(const packet::CaptureRecord& record);
+
+    //! Write all records currently in ring.
+    //! @remarks
+    //!  Records overwritten during dump are skipped.
+    ROC_ATTR_NODISCARD bool write_all(const packet::CaptureRing& ring);
+
+    //! Flush and close file.
+    ROC_ATTR_NODISCARD bool close();
+
+    //! Get number of written packets.
+    size_t num_packets() const;
+
+private:
+    bool write_section_header_();
+    bool write_interface_(packet::CapturePoint point);
+    bool write_block_(const void* data, size_t size);
+
+    FILE* file_;
+    size_t n_packets_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_PCAP_WRITER_H_
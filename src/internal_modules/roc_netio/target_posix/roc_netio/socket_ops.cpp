@@ -10,9 +10,12 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <signal.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -210,6 +213,37 @@ bool set_nonblock(SocketHandle sock) {
 
 #endif // !defined(SOCK_NONBLOCK)
 
+// Space for control message with receive timestamp.
+// timespec is used for SCM_TIMESTAMPNS and timeval for SCM_TIMESTAMP.
+enum { RecvTimestampCmsgSpace = CMSG_SPACE(sizeof(timespec)) };
+
+// Extracts receive timestamp from control messages of received datagram.
+// Returns zero if there is no timestamp.
+core::nanoseconds_t get_recv_timestamp(msghdr& msg) {
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+#if defined(SCM_TIMESTAMPNS)
+        if (cm->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts;
+            memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+            return core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec;
+        }
+#endif
+#if defined(SCM_TIMESTAMP)
+        if (cm->cmsg_type == SCM_TIMESTAMP) {
+            timeval tv;
+            memcpy(&tv, CMSG_DATA(cm), sizeof(tv));
+            return core::nanoseconds_t(tv.tv_sec) * core::Second
+                + core::nanoseconds_t(tv.tv_usec) * core::Microsecond;
+        }
+#endif
+    }
+
+    return 0;
+}
+
 } // namespace
 
 #if defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
@@ -256,71 +290,88 @@ bool socket_create(address::AddrFamily family, SocketType type, SocketHandle& ne
 
 #if defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
 
-bool socket_accept(SocketHandle sock,
-                   SocketHandle& new_sock,
-                   address::SocketAddr& remote_address) {
+ssize_t socket_try_accept(SocketHandle sock,
+                          SocketHandle& new_sock,
+                          address::SocketAddr& remote_address) {
     roc_panic_if(sock < 0);
 
     socklen_t addrlen = remote_address.max_slen();
 
     // Here we assume that if SOCK_CLOEXEC and SOCK_NONBLOCK are available,
     // then accept4() is available as well.
-    new_sock =
-        accept4(sock, remote_address.saddr(), &addrlen, SOCK_CLOEXEC | SOCK_NONBLOCK);
-
-    if (new_sock == -1) {
+    while ((new_sock = accept4(sock, remote_address.saddr(), &addrlen,
+                               SOCK_CLOEXEC | SOCK_NONBLOCK))
+           == -1) {
         roc_panic_if(is_malformed(errno));
 
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (new_sock == -1 && is_ewouldblock(errno)) {
+        return SockErr_WouldBlock;
+    }
+
+    if (new_sock == -1) {
         roc_log(LogError, "socket: accept4(): %s", core::errno_to_str().c_str());
-        return false;
+        return SockErr_Failure;
     }
 
     if (addrlen != remote_address.slen()) {
         roc_log(LogError, "socket: accept4(): unexpected len: got=%lu expected=%lu",
                 (unsigned long)addrlen, (unsigned long)remote_address.slen());
         (void)socket_close(new_sock);
-        return false;
+        return SockErr_Failure;
     }
 
-    return true;
+    return 0;
 }
 
 #else // !defined(SOCK_CLOEXEC) || !defined(SOCK_NONBLOCK)
 
-bool socket_accept(SocketHandle sock,
-                   SocketHandle& new_sock,
-                   address::SocketAddr& remote_address) {
+ssize_t socket_try_accept(SocketHandle sock,
+                          SocketHandle& new_sock,
+                          address::SocketAddr& remote_address) {
     roc_panic_if(sock < 0);
 
     socklen_t addrlen = remote_address.max_slen();
 
-    new_sock = accept(sock, remote_address.saddr(), &addrlen);
-
-    if (new_sock == -1) {
+    while ((new_sock = accept(sock, remote_address.saddr(), &addrlen)) == -1) {
         roc_panic_if(is_malformed(errno));
 
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (new_sock == -1 && is_ewouldblock(errno)) {
+        return SockErr_WouldBlock;
+    }
+
+    if (new_sock == -1) {
         roc_log(LogError, "socket: accept(): %s", core::errno_to_str().c_str());
-        return false;
+        return SockErr_Failure;
     }
 
     if (addrlen != remote_address.slen()) {
         roc_log(LogError, "socket: accept(): unexpected len: got=%lu expected=%lu",
                 (unsigned long)addrlen, (unsigned long)remote_address.slen());
         (void)socket_close(new_sock);
-        return false;
+        return SockErr_Failure;
     }
 
     if (!set_cloexec(new_sock)) {
         (void)socket_close(new_sock);
-        return false;
+        return SockErr_Failure;
     }
 
     if (!set_nonblock(new_sock)) {
         (void)socket_close(new_sock);
-        return false;
+        return SockErr_Failure;
     }
 
-    return true;
+    return 0;
 }
 
 #endif // defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
@@ -653,6 +704,420 @@ ssize_t socket_try_send_to(SocketHandle sock,
     return ret;
 }
 
+#if defined(__linux__) && defined(_GNU_SOURCE)
+
+ssize_t
+socket_try_recv_batch(SocketHandle sock, SocketDatagram* dgrams, size_t n_dgrams) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!dgrams);
+
+    enum { MaxBatch = 64 };
+
+    mmsghdr msgs[MaxBatch];
+    iovec iovs[MaxBatch];
+
+    union {
+        char buf[RecvTimestampCmsgSpace];
+        cmsghdr align;
+    } ctrls[MaxBatch];
+
+    if (n_dgrams > MaxBatch) {
+        n_dgrams = MaxBatch;
+    }
+
+    if (n_dgrams == 0) {
+        return 0;
+    }
+
+    memset(msgs, 0, sizeof(msgs[0]) * n_dgrams);
+
+    for (size_t n = 0; n < n_dgrams; n++) {
+        roc_panic_if(!dgrams[n].buf);
+
+        iovs[n].iov_base = dgrams[n].buf;
+        iovs[n].iov_len = dgrams[n].bufsz;
+
+        msgs[n].msg_hdr.msg_name = dgrams[n].addr.saddr();
+        msgs[n].msg_hdr.msg_namelen = dgrams[n].addr.max_slen();
+        msgs[n].msg_hdr.msg_iov = &iovs[n];
+        msgs[n].msg_hdr.msg_iovlen = 1;
+        msgs[n].msg_hdr.msg_control = ctrls[n].buf;
+        msgs[n].msg_hdr.msg_controllen = sizeof(ctrls[n].buf);
+    }
+
+    int ret;
+    while ((ret = recvmmsg(sock, msgs, (unsigned)n_dgrams, MSG_DONTWAIT, NULL)) == -1) {
+        roc_panic_if(is_malformed(errno));
+
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (ret < 0 && is_ewouldblock(errno)) {
+        return SockErr_WouldBlock;
+    }
+
+    if (ret < 0) {
+        roc_log(LogError, "socket: recvmmsg(): %s", core::errno_to_str().c_str());
+        return SockErr_Failure;
+    }
+
+    if (ret == 0) {
+        return SockErr_WouldBlock;
+    }
+
+    for (int n = 0; n < ret; n++) {
+        dgrams[n].len = msgs[n].msg_len;
+        dgrams[n].truncated = (msgs[n].msg_hdr.msg_flags & MSG_TRUNC);
+        dgrams[n].timestamp = get_recv_timestamp(msgs[n].msg_hdr);
+    }
+
+    return ret;
+}
+
+namespace {
+
+// Maximum number of segments in one UDP GSO message (UDP_MAX_SEGMENTS).
+const size_t MaxGsoSegments = 64;
+
+// Maximum total size of UDP GSO message.
+const size_t MaxGsoBytes = 65000;
+
+// Returns number of subsequent datagrams starting from given one that
+// can be sent as a single GSO message.
+size_t gso_group_size(const SocketDatagram* dgrams, size_t n_dgrams) {
+    size_t n = 1;
+    while (n < n_dgrams && n < MaxGsoSegments && (n + 1) * dgrams[0].len <= MaxGsoBytes
+           && dgrams[n].len == dgrams[0].len && dgrams[n].addr == dgrams[0].addr) {
+        n++;
+    }
+    return n;
+}
+
+bool is_gso_unsupported(int err) {
+    return err == EINVAL || err == EIO || err == ENOPROTOOPT || err == EOPNOTSUPP;
+}
+
+} // namespace
+
+ssize_t socket_try_send_batch(SocketHandle sock,
+                              const SocketDatagram* dgrams,
+                              size_t n_dgrams,
+                              bool& use_gso) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!dgrams);
+
+    enum { MaxBatch = 64 };
+
+    mmsghdr msgs[MaxBatch];
+    iovec iovs[MaxBatch];
+    size_t msg_dgrams[MaxBatch];
+
+#if defined(UDP_SEGMENT)
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        cmsghdr align;
+    } ctrls[MaxBatch];
+#endif
+
+    if (n_dgrams > MaxBatch) {
+        n_dgrams = MaxBatch;
+    }
+
+    if (n_dgrams == 0) {
+        return 0;
+    }
+
+    for (;;) {
+        memset(msgs, 0, sizeof(msgs[0]) * n_dgrams);
+
+        size_t n_msgs = 0;
+        bool has_gso = false;
+
+        for (size_t n = 0; n < n_dgrams;) {
+            size_t group_size = 1;
+#if defined(UDP_SEGMENT)
+            if (use_gso) {
+                group_size = gso_group_size(dgrams + n, n_dgrams - n);
+            }
+#endif
+
+            mmsghdr& msg = msgs[n_msgs];
+
+            for (size_t i = 0; i < group_size; i++) {
+                roc_panic_if(!dgrams[n + i].buf);
+                roc_panic_if(!dgrams[n + i].addr.has_host_port());
+
+                iovs[n + i].iov_base = dgrams[n + i].buf;
+                iovs[n + i].iov_len = dgrams[n + i].len;
+            }
+
+            msg.msg_hdr.msg_name = const_cast<sockaddr*>(dgrams[n].addr.saddr());
+            msg.msg_hdr.msg_namelen = dgrams[n].addr.slen();
+            msg.msg_hdr.msg_iov = &iovs[n];
+            msg.msg_hdr.msg_iovlen = group_size;
+
+#if defined(UDP_SEGMENT)
+            if (group_size > 1) {
+                msg.msg_hdr.msg_control = ctrls[n_msgs].buf;
+                msg.msg_hdr.msg_controllen = sizeof(ctrls[n_msgs].buf);
+
+                cmsghdr* cm = CMSG_FIRSTHDR(&msg.msg_hdr);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                const uint16_t segment_size = (uint16_t)dgrams[n].len;
+                memcpy(CMSG_DATA(cm), &segment_size, sizeof(segment_size));
+
+                has_gso = true;
+            }
+#endif
+
+            msg_dgrams[n_msgs] = group_size;
+            n_msgs++;
+            n += group_size;
+        }
+
+        int ret;
+        while ((ret = sendmmsg(sock, msgs, (unsigned)n_msgs, MSG_DONTWAIT)) == -1) {
+            roc_panic_if(is_malformed(errno));
+
+            if (errno != EINTR) {
+                break;
+            }
+        }
+
+        if (ret < 0 && has_gso && is_gso_unsupported(errno)) {
+            roc_log(LogDebug, "socket: sendmmsg(): UDP GSO not supported, disabling: %s",
+                    core::errno_to_str().c_str());
+            use_gso = false;
+            continue;
+        }
+
+        if (ret < 0 && is_ewouldblock(errno)) {
+            return SockErr_WouldBlock;
+        }
+
+        if (ret < 0) {
+            roc_log(LogError, "socket: sendmmsg(): %s", core::errno_to_str().c_str());
+            return SockErr_Failure;
+        }
+
+        if (ret == 0) {
+            return SockErr_WouldBlock;
+        }
+
+        size_t n_sent = 0;
+        for (int n = 0; n < ret; n++) {
+            n_sent += msg_dgrams[n];
+        }
+
+        return (ssize_t)n_sent;
+    }
+}
+
+#else // !defined(__linux__)
+
+// Generic version, receives datagrams one by one.
+ssize_t
+socket_try_recv_batch(SocketHandle sock, SocketDatagram* dgrams, size_t n_dgrams) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!dgrams);
+
+    size_t n = 0;
+
+    for (; n < n_dgrams; n++) {
+        roc_panic_if(!dgrams[n].buf);
+
+        iovec iov;
+        iov.iov_base = dgrams[n].buf;
+        iov.iov_len = dgrams[n].bufsz;
+
+        union {
+            char buf[RecvTimestampCmsgSpace];
+            cmsghdr align;
+        } ctrl;
+
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = dgrams[n].addr.saddr();
+        msg.msg_namelen = dgrams[n].addr.max_slen();
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl.buf;
+        msg.msg_controllen = sizeof(ctrl.buf);
+
+        ssize_t ret;
+        while ((ret = recvmsg(sock, &msg, MSG_DONTWAIT)) == -1) {
+            roc_panic_if(is_malformed(errno));
+
+            if (errno != EINTR) {
+                break;
+            }
+        }
+
+        if (ret < 0) {
+            if (!is_ewouldblock(errno)) {
+                roc_log(LogError, "socket: recvmsg(): %s", core::errno_to_str().c_str());
+                if (n == 0) {
+                    return SockErr_Failure;
+                }
+            }
+            break;
+        }
+
+        dgrams[n].len = (size_t)ret;
+        dgrams[n].truncated = (msg.msg_flags & MSG_TRUNC);
+        dgrams[n].timestamp = get_recv_timestamp(msg);
+    }
+
+    if (n == 0) {
+        return SockErr_WouldBlock;
+    }
+
+    return (ssize_t)n;
+}
+
+// Generic version, sends datagrams one by one.
+ssize_t socket_try_send_batch(SocketHandle sock,
+                              const SocketDatagram* dgrams,
+                              size_t n_dgrams,
+                              bool& use_gso) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!dgrams);
+
+    // GSO is not available.
+    use_gso = false;
+
+    size_t n = 0;
+
+    for (; n < n_dgrams; n++) {
+        const ssize_t ret =
+            socket_try_send_to(sock, dgrams[n].buf, dgrams[n].len, dgrams[n].addr);
+
+        if (ret < 0) {
+            if (n == 0) {
+                return ret;
+            }
+            break;
+        }
+    }
+
+    if (n == 0) {
+        return SockErr_WouldBlock;
+    }
+
+    return (ssize_t)n;
+}
+
+#endif // defined(__linux__)
+
+bool socket_enable_recv_timestamps(SocketHandle sock) {
+    roc_panic_if(sock < 0);
+
+#if defined(SO_TIMESTAMPNS)
+    return set_int_option(sock, SOL_SOCKET, SO_TIMESTAMPNS, "SO_TIMESTAMPNS", 1);
+#elif defined(SO_TIMESTAMP)
+    return set_int_option(sock, SOL_SOCKET, SO_TIMESTAMP, "SO_TIMESTAMP", 1);
+#else
+    return false;
+#endif
+}
+
+bool socket_set_busy_poll(SocketHandle sock, core::nanoseconds_t duration) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(duration < 0);
+
+#if defined(SO_BUSY_POLL)
+    const core::nanoseconds_t usec =
+        (duration + core::Microsecond - 1) / core::Microsecond;
+
+    if (usec > INT_MAX) {
+        roc_log(LogError, "socket: busy-poll duration is too large");
+        return false;
+    }
+
+    return set_int_option(sock, SOL_SOCKET, SO_BUSY_POLL, "SO_BUSY_POLL", (int)usec);
+#else
+    roc_log(LogError, "socket: SO_BUSY_POLL is not supported on this platform");
+    return false;
+#endif
+}
+
+bool socket_set_dscp(SocketHandle sock, address::AddrFamily family, unsigned int dscp) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(dscp > 63);
+
+    // DSCP occupies upper 6 bits of TOS / traffic class byte,
+    // lower 2 bits are used by ECN and managed by kernel.
+    const int tos = (int)(dscp << 2);
+
+    if (family == address::Family_IPv6) {
+        return set_int_option(sock, IPPROTO_IPV6, IPV6_TCLASS, "IPV6_TCLASS", tos);
+    }
+
+    return set_int_option(sock, IPPROTO_IP, IP_TOS, "IP_TOS", tos);
+}
+
+bool socket_set_priority(SocketHandle sock, int priority) {
+    roc_panic_if(sock < 0);
+
+#if defined(SO_PRIORITY)
+    return set_int_option(sock, SOL_SOCKET, SO_PRIORITY, "SO_PRIORITY", priority);
+#else
+    (void)priority;
+    roc_log(LogError, "socket: SO_PRIORITY is not supported on this platform");
+    return false;
+#endif
+}
+
+#if defined(IP_MTU) && defined(IPV6_MTU)
+
+bool socket_get_path_mtu(const address::SocketAddr& remote_address, size_t& mtu) {
+    roc_panic_if(!remote_address.has_host_port());
+
+    const bool is_ipv6 = remote_address.family() == address::Family_IPv6;
+
+    const int level = is_ipv6 ? IPPROTO_IPV6 : IPPROTO_IP;
+    const int discover_opt = is_ipv6 ? IPV6_MTU_DISCOVER : IP_MTU_DISCOVER;
+    const int discover_val = is_ipv6 ? IPV6_PMTUDISC_DO : IP_PMTUDISC_DO;
+    const int mtu_opt = is_ipv6 ? IPV6_MTU : IP_MTU;
+
+    SocketHandle sock = SocketInvalid;
+    if (!socket_create(remote_address.family(), SocketType_Udp, sock)) {
+        return false;
+    }
+
+    bool success = false;
+    int mtu_val = 0;
+
+    // Connecting datagram socket doesn't send anything, it only selects route.
+    bool completed_immediately = false;
+
+    if (set_int_option(sock, level, discover_opt, "IP_MTU_DISCOVER", discover_val)
+        && socket_begin_connect(sock, remote_address, completed_immediately)
+        && get_int_option(sock, level, mtu_opt, "IP_MTU", mtu_val) && mtu_val > 0) {
+        mtu = (size_t)mtu_val;
+        success = true;
+    }
+
+    if (!socket_close(sock)) {
+        return false;
+    }
+
+    return success;
+}
+
+#else // !defined(IP_MTU) || !defined(IPV6_MTU)
+
+bool socket_get_path_mtu(const address::SocketAddr&, size_t&) {
+    return false;
+}
+
+#endif // defined(IP_MTU) && defined(IPV6_MTU)
+
 bool socket_shutdown(SocketHandle sock) {
     roc_panic_if(sock < 0);
 
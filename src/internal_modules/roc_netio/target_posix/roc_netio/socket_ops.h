@@ -15,6 +15,7 @@
 #include "roc_address/socket_addr.h"
 #include "roc_core/attributes.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace netio {
@@ -47,6 +48,40 @@ enum SocketError {
     SockErr_Failure = -3
 };
 
+//! Datagram for batched socket operations.
+struct SocketDatagram {
+    //! Datagram buffer.
+    void* buf;
+
+    //! Size of the buffer.
+    size_t bufsz;
+
+    //! Datagram length.
+    //! Filled when receiving, should be set when sending.
+    size_t len;
+
+    //! Remote address.
+    //! Filled with source address when receiving, should be set to
+    //! destination address when sending.
+    address::SocketAddr addr;
+
+    //! Set if datagram didn't fit into buffer and was truncated.
+    bool truncated;
+
+    //! Time when datagram was received by kernel, in Unix clock domain.
+    //! Filled when receiving, if receive timestamps are enabled on socket
+    //! and supported by platform, otherwise set to zero.
+    core::nanoseconds_t timestamp;
+
+    SocketDatagram()
+        : buf(NULL)
+        , bufsz(0)
+        , len(0)
+        , truncated(false)
+        , timestamp(0) {
+    }
+};
+
 //! Platform-specific socket handle.
 typedef int SocketHandle;
 
@@ -57,10 +92,12 @@ const SocketHandle SocketInvalid = -1;
 ROC_ATTR_NODISCARD bool
 socket_create(address::AddrFamily family, SocketType type, SocketHandle& new_sock);
 
-//! Accept incoming connection.
-ROC_ATTR_NODISCARD bool socket_accept(SocketHandle sock,
-                                      SocketHandle& new_sock,
-                                      address::SocketAddr& remote_address);
+//! Try to accept incoming connection without blocking.
+//! @returns 0 if connection was accepted or SocketError (< 0).
+//! SockErr_WouldBlock is returned if there are no pending connections.
+ROC_ATTR_NODISCARD ssize_t socket_try_accept(SocketHandle sock,
+                                             SocketHandle& new_sock,
+                                             address::SocketAddr& remote_address);
 
 //! Set socket options.
 ROC_ATTR_NODISCARD bool socket_setup(SocketHandle sock, const SocketOpts& options);
@@ -101,6 +138,68 @@ ROC_ATTR_NODISCARD ssize_t socket_try_send_to(SocketHandle sock,
                                               size_t bufsz,
                                               const address::SocketAddr& remote_address);
 
+//! Try to receive multiple datagrams from socket without blocking.
+//! @remarks
+//!  Fills buffers of @p dgrams in order, until there are no more pending
+//!  datagrams or all buffers are filled. Uses recvmmsg() to receive all
+//!  datagrams with a single system call where it's available.
+//! @returns number of datagrams received (> 0) or SocketError (< 0).
+ROC_ATTR_NODISCARD ssize_t socket_try_recv_batch(SocketHandle sock,
+                                                 SocketDatagram* dgrams,
+                                                 size_t n_dgrams);
+
+//! Try to send multiple datagrams via socket without blocking.
+//! @remarks
+//!  Sends @p dgrams in order, until all are sent or socket buffer is full.
+//!  Uses sendmmsg() to send all datagrams with a single system call where
+//!  it's available.
+//!  If @p use_gso is true, subsequent datagrams with same size and destination
+//!  are passed to kernel as one UDP GSO message, where it's supported. If kernel
+//!  rejects GSO, @p use_gso is reset to false and datagrams are sent without it.
+//! @returns number of datagrams sent (> 0) or SocketError (< 0).
+ROC_ATTR_NODISCARD ssize_t socket_try_send_batch(SocketHandle sock,
+                                                 const SocketDatagram* dgrams,
+                                                 size_t n_dgrams,
+                                                 bool& use_gso);
+
+//! Enable kernel receive timestamps on socket.
+//! @remarks
+//!  After this call, kernel stamps every received datagram with the time when
+//!  it was received by network stack, and socket_try_recv_batch() reports it
+//!  in SocketDatagram::timestamp. Uses SO_TIMESTAMPNS or SO_TIMESTAMP option,
+//!  depending on what's available.
+//! @returns
+//!  false if timestamps are not supported.
+ROC_ATTR_NODISCARD bool socket_enable_recv_timestamps(SocketHandle sock);
+
+//! Set busy-poll budget for receiving.
+//! @remarks
+//!  Uses SO_BUSY_POLL. Supported only on Linux.
+ROC_ATTR_NODISCARD bool socket_set_busy_poll(SocketHandle sock,
+                                             core::nanoseconds_t duration);
+
+//! Set DSCP field of outgoing packets.
+//! @remarks
+//!  Uses IP_TOS for IPv4 and IPV6_TCLASS for IPv6 sockets.
+ROC_ATTR_NODISCARD bool
+socket_set_dscp(SocketHandle sock, address::AddrFamily family, unsigned int dscp);
+
+//! Set priority of outgoing packets.
+//! @remarks
+//!  Uses SO_PRIORITY. Supported only on Linux.
+ROC_ATTR_NODISCARD bool socket_set_priority(SocketHandle sock, int priority);
+
+//! Query path MTU towards remote address.
+//! @remarks
+//!  Creates temporary UDP socket with path MTU discovery enabled (DF bit set),
+//!  connects it to @p remote_address, and asks kernel for the MTU of the route,
+//!  which includes MTU learned from ICMP "fragmentation needed" messages.
+//!  No packets are sent. Supported only on platforms with IP_MTU option.
+//! @returns
+//!  true and fills @p mtu if MTU is known, or false if it can't be determined.
+ROC_ATTR_NODISCARD bool socket_get_path_mtu(const address::SocketAddr& remote_address,
+                                            size_t& mtu);
+
 //! Gracefully shutdown connection.
 ROC_ATTR_NODISCARD bool socket_shutdown(SocketHandle sock);
 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/shm_port.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_status/code_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+const core::nanoseconds_t PacketLogInterval = 20 * core::Second;
+
+// How often sending port tries to attach to ring which is not created yet.
+const core::nanoseconds_t AttachInterval = 100 * core::Millisecond;
+
+// How often receiving thread checks for stop request while idle.
+const core::nanoseconds_t RecvWaitTimeout = 100 * core::Millisecond;
+
+} // namespace
+
+ShmPort::ShmPort(const ShmConfig& config,
+                 packet::PacketFactory& packet_factory,
+                 core::IArena& arena)
+    : BasicPort(arena)
+    , config_(config)
+    , packet_factory_(packet_factory)
+    , inbound_writer_(NULL)
+    , recv_stop_(0)
+    , recv_started_(false)
+    , sender_id_(core::fast_random_range(1, 65535))
+    , send_started_(false)
+    , attach_limiter_(AttachInterval)
+    , rate_limiter_(PacketLogInterval)
+    , received_packets_(0)
+    , sent_packets_(0)
+    , dropped_packets_(0) {
+    name_[0] = '\0';
+    BasicPort::update_descriptor();
+}
+
+ShmPort::~ShmPort() {
+    if (recv_started_ || recv_ring_.is_open() || send_ring_.is_open()) {
+        roc_panic("shm port: %s: port was not closed before calling destructor",
+                  descriptor());
+    }
+}
+
+const address::SocketAddr& ShmPort::address() const {
+    return config_.address;
+}
+
+bool ShmPort::open() {
+    if (!config_.address || config_.address.port() <= 0) {
+        roc_log(LogError, "shm port: %s: address should have non-zero port",
+                descriptor());
+        return false;
+    }
+
+    ShmRing::make_name(name_, sizeof(name_), config_.address.port());
+
+    update_descriptor();
+
+    roc_log(LogDebug, "shm port: %s: opened port", descriptor());
+
+    return true;
+}
+
+AsyncOperationStatus ShmPort::async_close(ICloseHandler&, void*) {
+    stop_recv_();
+
+    {
+        core::Mutex::Lock lock(send_mutex_);
+        send_ring_.close();
+    }
+
+    roc_log(LogDebug,
+            "shm port: %s: closed port:"
+            " received=%lu sent=%lu dropped=%lu",
+            descriptor(), (unsigned long)received_packets_, (unsigned long)sent_packets_,
+            (unsigned long)dropped_packets_);
+
+    return AsyncOp_Completed;
+}
+
+packet::IWriter* ShmPort::start_send() {
+    core::Mutex::Lock lock(send_mutex_);
+
+    if (!send_started_) {
+        // It's fine if receiver didn't create the ring yet, we'll retry on write.
+        (void)attach_send_ring_();
+        send_started_ = true;
+    }
+
+    return this;
+}
+
+bool ShmPort::start_recv(packet::IWriter& inbound_writer) {
+    if (recv_started_) {
+        roc_log(LogError, "shm port: %s: receiving is already started", descriptor());
+        return false;
+    }
+
+    if (!recv_ring_.create(name_, packet_factory_.packet_buffer_size(),
+                           config_.ring_length)) {
+        roc_log(LogError, "shm port: %s: can't create ring", descriptor());
+        return false;
+    }
+
+    inbound_writer_ = &inbound_writer;
+    recv_stop_ = 0;
+
+    if (!core::Thread::start()) {
+        roc_log(LogError, "shm port: %s: can't start receiving thread", descriptor());
+        recv_ring_.close();
+        return false;
+    }
+
+    recv_started_ = true;
+
+    roc_log(LogDebug, "shm port: %s: started receiving", descriptor());
+
+    return true;
+}
+
+status::StatusCode ShmPort::write(const packet::PacketPtr& pp) {
+    if (!pp) {
+        roc_panic("shm port: %s: unexpected null packet", descriptor());
+    }
+
+    const core::Slice<uint8_t>& buffer = pp->buffer();
+    if (!buffer) {
+        roc_panic("shm port: %s: unexpected packet w/o buffer", descriptor());
+    }
+
+    core::Mutex::Lock lock(send_mutex_);
+
+    if (send_ring_.is_open() && send_ring_.is_closed_by_peer()) {
+        roc_log(LogDebug, "shm port: %s: receiver closed ring, detaching", descriptor());
+        send_ring_.close();
+    }
+
+    if (!send_ring_.is_open() && !attach_send_ring_()) {
+        dropped_packets_++;
+        return status::StatusOK;
+    }
+
+    if (!send_ring_.write(sender_id_, buffer.data(), buffer.size())) {
+        dropped_packets_++;
+        if (rate_limiter_.allow()) {
+            roc_log(LogDebug,
+                    "shm port: %s: dropping packet, ring is full or packet is too large:"
+                    " size=%lu max=%lu dropped=%lu",
+                    descriptor(), (unsigned long)buffer.size(),
+                    (unsigned long)send_ring_.slot_size(),
+                    (unsigned long)dropped_packets_);
+        }
+        return status::StatusOK;
+    }
+
+    sent_packets_++;
+
+    return status::StatusOK;
+}
+
+void ShmPort::run() {
+    roc_log(LogDebug, "shm port: %s: entering receiving thread", descriptor());
+
+    while (!recv_stop_) {
+        uint32_t sender_id = 0;
+        size_t size = 0;
+
+        while (const uint8_t* data = recv_ring_.begin_read(sender_id, size)) {
+            recv_packet_(data, size, sender_id);
+            recv_ring_.end_read();
+        }
+
+        if (recv_stop_) {
+            break;
+        }
+
+        recv_ring_.wait(core::timestamp(core::ClockUnix) + RecvWaitTimeout);
+    }
+
+    roc_log(LogDebug, "shm port: %s: exiting receiving thread", descriptor());
+}
+
+void ShmPort::recv_packet_(const uint8_t* data, size_t size, uint32_t sender_id) {
+    received_packets_++;
+
+    core::BufferPtr bp = packet_factory_.new_packet_buffer(size);
+    if (!bp) {
+        roc_log(LogError, "shm port: %s: can't allocate buffer", descriptor());
+        return;
+    }
+
+    memcpy(bp->data(), data, size);
+
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        roc_log(LogError, "shm port: %s: can't allocate packet", descriptor());
+        return;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    // Every sender gets its own source port, same as with separate sockets.
+    const char* src_host =
+        config_.address.family() == address::Family_IPv6 ? "::1" : "127.0.0.1";
+
+    if (!pp->udp()->src_addr.set_host_port(config_.address.family(), src_host,
+                                           (int)sender_id)) {
+        roc_panic("shm port: %s: can't set source address", descriptor());
+    }
+
+    pp->udp()->dst_addr = config_.address;
+    pp->udp()->receive_timestamp = core::timestamp(core::ClockUnix);
+
+    pp->set_buffer(core::Slice<uint8_t>(*bp, 0, size));
+
+    const status::StatusCode code = inbound_writer_->write(pp);
+    if (code != status::StatusOK) {
+        roc_panic("shm port: %s: can't write packet: status=%s", descriptor(),
+                  status::code_to_str(code));
+    }
+}
+
+bool ShmPort::attach_send_ring_() {
+    if (!attach_limiter_.allow()) {
+        return false;
+    }
+
+    if (!send_ring_.attach(name_)) {
+        if (rate_limiter_.allow()) {
+            roc_log(LogDebug, "shm port: %s: receiver didn't create ring yet",
+                    descriptor());
+        }
+        return false;
+    }
+
+    roc_log(LogDebug, "shm port: %s: attached to ring: max_packet_size=%lu",
+            descriptor(), (unsigned long)send_ring_.slot_size());
+
+    return true;
+}
+
+void ShmPort::stop_recv_() {
+    if (!recv_started_) {
+        return;
+    }
+
+    recv_stop_ = 1;
+    recv_ring_.wake();
+
+    core::Thread::join();
+
+    recv_ring_.close();
+    recv_started_ = false;
+}
+
+void ShmPort::format_descriptor(core::StringBuilder& b) {
+    b.append_str("<shm");
+
+    b.append_str(" 0x");
+    b.append_uint((unsigned long)this, 16);
+
+    if (name_[0]) {
+        b.append_str(" name=");
+        b.append_str(name_);
+    }
+
+    b.append_str(">");
+}
+
+} // namespace netio
+} // namespace roc
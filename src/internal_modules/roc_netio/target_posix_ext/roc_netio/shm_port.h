@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_posix_ext/roc_netio/shm_port.h
+//! @brief Shared memory port.
+
+#ifndef ROC_NETIO_SHM_PORT_H_
+#define ROC_NETIO_SHM_PORT_H_
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/thread.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/iclose_handler.h"
+#include "roc_netio/shm_config.h"
+#include "roc_netio/shm_ring.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+
+//! Shared memory sender/receiver port.
+//! @remarks
+//!  Passes datagrams between sender and receiver processes on the same host
+//!  via ShmRing instead of UDP sockets. Receiving port creates the ring and
+//!  reads it from its own thread; sending ports attach to the ring and write
+//!  to it directly from the caller thread.
+//!
+//!  Packets look the same as received from UDP port: destination address is
+//!  the configured address, and source address is loopback address with
+//!  a port number unique for every sending port, so that the receiver can
+//!  distinguish senders.
+class ShmPort : public BasicPort, private packet::IWriter, private core::Thread {
+public:
+    //! Initialize.
+    ShmPort(const ShmConfig& config,
+            packet::PacketFactory& packet_factory,
+            core::IArena& arena);
+
+    //! Destroy.
+    virtual ~ShmPort();
+
+    //! Get port address.
+    const address::SocketAddr& address() const;
+
+    //! Open port.
+    virtual bool open();
+
+    //! Close port.
+    //! @remarks
+    //!  Always completes immediately.
+    virtual AsyncOperationStatus async_close(ICloseHandler& handler, void* handler_arg);
+
+    //! Start sending packets.
+    //! @remarks
+    //!  Packets written to returned writer are copied to the ring.
+    //!  Writer can be used from any thread. If receiver didn't create the ring
+    //!  yet or the ring is full, packets are dropped.
+    packet::IWriter* start_send();
+
+    //! Start receiving packets.
+    //! @remarks
+    //!  Creates the ring. Received packets will be written to inbound_writer.
+    //!  Writer will be invoked from port thread.
+    bool start_recv(packet::IWriter& inbound_writer);
+
+protected:
+    //! Format descriptor.
+    virtual void format_descriptor(core::StringBuilder& b);
+
+private:
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& packet);
+
+    virtual void run();
+
+    void recv_packet_(const uint8_t* data, size_t size, uint32_t sender_id);
+    bool attach_send_ring_();
+
+    void stop_recv_();
+
+    ShmConfig config_;
+
+    char name_[ShmRing::MaxNameLen];
+
+    packet::PacketFactory& packet_factory_;
+
+    packet::IWriter* inbound_writer_;
+    ShmRing recv_ring_;
+    core::Atomic<int> recv_stop_;
+    bool recv_started_;
+
+    core::Mutex send_mutex_;
+    ShmRing send_ring_;
+    uint32_t sender_id_;
+    bool send_started_;
+
+    core::RateLimiter attach_limiter_;
+    core::RateLimiter rate_limiter_;
+
+    size_t received_packets_;
+    size_t sent_packets_;
+    size_t dropped_packets_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_PORT_H_
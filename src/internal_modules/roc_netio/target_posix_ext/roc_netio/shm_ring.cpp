@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "roc_core/align_ops.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/shm_ring.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { Magic = 0x52534852 };
+
+} // namespace
+
+// Shared between processes. Written once by creator, except counters.
+struct ShmRing::SegmentHeader {
+    uint32_t magic;
+    uint32_t slot_size;
+    uint32_t n_slots;
+    int32_t closed;
+    sem_t sem;
+
+    // written by writers
+    core::CacheLinePad pad;
+
+    uint32_t write_pos;
+};
+
+// Precedes datagram in every slot.
+// Sequence number tells whether slot is free for writer at given position
+// (seq == pos) or filled for reader (seq == pos + 1).
+struct ShmRing::SlotHeader {
+    uint32_t seq;
+    uint32_t sender_id;
+    uint32_t size;
+    uint32_t reserved;
+};
+
+ShmRing::ShmRing()
+    : mem_(NULL)
+    , mem_size_(0)
+    , header_(NULL)
+    , slot_size_(0)
+    , stride_size_(0)
+    , n_slots_(0)
+    , read_pos_(0)
+    , creator_(false) {
+    name_[0] = '\0';
+}
+
+ShmRing::~ShmRing() {
+    close();
+}
+
+void ShmRing::make_name(char* name, size_t name_size, int port) {
+    snprintf(name, name_size, "/roc-shm-%d", port);
+}
+
+bool ShmRing::create(const char* name, size_t slot_size, size_t n_slots) {
+    roc_panic_if(is_open());
+
+    if (slot_size == 0 || slot_size > 0xffffff || n_slots == 0 || n_slots > 0x100000) {
+        roc_log(LogError, "shm ring: invalid ring size: slot_size=%lu n_slots=%lu",
+                (unsigned long)slot_size, (unsigned long)n_slots);
+        return false;
+    }
+
+    // Positions are 32-bit and wrap around, so number of slots should divide 2^32.
+    uint32_t n_slots_pow2 = 1;
+    while (n_slots_pow2 < n_slots) {
+        n_slots_pow2 <<= 1;
+    }
+
+    const size_t mem_size = header_size_() + stride_(slot_size) * n_slots_pow2;
+
+    if (shm_unlink(name) == 0) {
+        roc_log(LogDebug, "shm ring: removed stale segment %s", name);
+    }
+
+    const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        roc_log(LogError, "shm ring: shm_open(%s): %s", name,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    if (ftruncate(fd, (off_t)mem_size) != 0) {
+        roc_log(LogError, "shm ring: ftruncate(%s): %s", name,
+                core::errno_to_str().c_str());
+        (void)::close(fd);
+        (void)shm_unlink(name);
+        return false;
+    }
+
+    void* mem = mmap(NULL, mem_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)::close(fd);
+
+    if (mem == MAP_FAILED) {
+        roc_log(LogError, "shm ring: mmap(%s): %s", name, core::errno_to_str().c_str());
+        (void)shm_unlink(name);
+        return false;
+    }
+
+    // Segment is zero-filled by ftruncate().
+    mem_ = (uint8_t*)mem;
+    mem_size_ = mem_size;
+    header_ = (SegmentHeader*)mem;
+    slot_size_ = slot_size;
+    stride_size_ = stride_(slot_size);
+    n_slots_ = n_slots_pow2;
+    read_pos_ = 0;
+    creator_ = true;
+    snprintf(name_, sizeof(name_), "%s", name);
+
+    if (sem_init(&header_->sem, 1, 0) != 0) {
+        roc_log(LogError, "shm ring: sem_init(): %s", core::errno_to_str().c_str());
+        close();
+        return false;
+    }
+
+    header_->slot_size = (uint32_t)slot_size_;
+    header_->n_slots = n_slots_;
+
+    for (uint32_t pos = 0; pos < n_slots_; pos++) {
+        slot_(pos)->seq = pos;
+    }
+
+    // Writers don't touch segment until they see magic.
+    core::AtomicOps::store_release(header_->magic, (uint32_t)Magic);
+
+    roc_log(LogDebug, "shm ring: created segment %s: slot_size=%lu n_slots=%lu",
+            name_, (unsigned long)slot_size_, (unsigned long)n_slots_);
+
+    return true;
+}
+
+bool ShmRing::attach(const char* name) {
+    roc_panic_if(is_open());
+
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        roc_log(LogDebug, "shm ring: shm_open(%s): %s", name,
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < header_size_()) {
+        roc_log(LogDebug, "shm ring: segment %s is not initialized yet", name);
+        (void)::close(fd);
+        return false;
+    }
+
+    const size_t mem_size = (size_t)st.st_size;
+
+    void* mem = mmap(NULL, mem_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)::close(fd);
+
+    if (mem == MAP_FAILED) {
+        roc_log(LogError, "shm ring: mmap(%s): %s", name, core::errno_to_str().c_str());
+        return false;
+    }
+
+    SegmentHeader* header = (SegmentHeader*)mem;
+
+    if (core::AtomicOps::load_acquire(header->magic) != (uint32_t)Magic
+        || header->slot_size == 0 || header->n_slots == 0
+        || (header->n_slots & (header->n_slots - 1)) != 0
+        || header_size_() + stride_(header->slot_size) * header->n_slots > mem_size) {
+        roc_log(LogDebug, "shm ring: segment %s is not initialized yet", name);
+        (void)munmap(mem, mem_size);
+        return false;
+    }
+
+    mem_ = (uint8_t*)mem;
+    mem_size_ = mem_size;
+    header_ = header;
+    slot_size_ = header->slot_size;
+    stride_size_ = stride_(slot_size_);
+    n_slots_ = header->n_slots;
+    read_pos_ = 0;
+    creator_ = false;
+    snprintf(name_, sizeof(name_), "%s", name);
+
+    roc_log(LogDebug, "shm ring: attached to segment %s: slot_size=%lu n_slots=%lu",
+            name_, (unsigned long)slot_size_, (unsigned long)n_slots_);
+
+    return true;
+}
+
+void ShmRing::close() {
+    if (!is_open()) {
+        return;
+    }
+
+    if (creator_) {
+        // Semaphore is not destroyed, since writers may still post it
+        // until they notice that ring is closed.
+        core::AtomicOps::store_release(header_->closed, 1);
+        (void)sem_post(&header_->sem);
+
+        if (shm_unlink(name_) != 0) {
+            roc_log(LogDebug, "shm ring: shm_unlink(%s): %s", name_,
+                    core::errno_to_str().c_str());
+        }
+    }
+
+    if (munmap(mem_, mem_size_) != 0) {
+        roc_panic("shm ring: munmap(%s): %s", name_, core::errno_to_str().c_str());
+    }
+
+    mem_ = NULL;
+    mem_size_ = 0;
+    header_ = NULL;
+    creator_ = false;
+}
+
+bool ShmRing::is_open() const {
+    return mem_ != NULL;
+}
+
+bool ShmRing::is_closed_by_peer() const {
+    roc_panic_if(!is_open());
+
+    return core::AtomicOps::load_acquire(header_->closed) != 0;
+}
+
+size_t ShmRing::slot_size() const {
+    return slot_size_;
+}
+
+bool ShmRing::write(uint32_t sender_id, const void* data, size_t size) {
+    roc_panic_if(!is_open());
+
+    if (size > slot_size_) {
+        return false;
+    }
+
+    if (core::AtomicOps::load_acquire(header_->closed)) {
+        return false;
+    }
+
+    // Claim slot at current write position.
+    uint32_t pos = core::AtomicOps::load_relaxed(header_->write_pos);
+    SlotHeader* slot = NULL;
+
+    for (;;) {
+        slot = slot_(pos);
+
+        const int32_t diff =
+            (int32_t)(core::AtomicOps::load_acquire(slot->seq) - pos);
+
+        if (diff == 0) {
+            if (core::AtomicOps::compare_exchange_relaxed(header_->write_pos, pos,
+                                                          pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Reader didn't release slot yet, ring is full.
+            return false;
+        } else {
+            pos = core::AtomicOps::load_relaxed(header_->write_pos);
+        }
+    }
+
+    slot->sender_id = sender_id;
+    slot->size = (uint32_t)size;
+    memcpy((uint8_t*)slot + sizeof(SlotHeader), data, size);
+
+    core::AtomicOps::store_release(slot->seq, pos + 1);
+
+    // Enters kernel only if reader is sleeping.
+    (void)sem_post(&header_->sem);
+
+    return true;
+}
+
+const uint8_t* ShmRing::begin_read(uint32_t& sender_id, size_t& size) {
+    roc_panic_if(!is_open());
+    roc_panic_if(!creator_);
+
+    SlotHeader* slot = slot_(read_pos_);
+
+    if (core::AtomicOps::load_acquire(slot->seq) != read_pos_ + 1) {
+        return NULL;
+    }
+
+    sender_id = slot->sender_id;
+    size = std::min((size_t)slot->size, slot_size_);
+
+    return (const uint8_t*)slot + sizeof(SlotHeader);
+}
+
+void ShmRing::end_read() {
+    roc_panic_if(!is_open());
+    roc_panic_if(!creator_);
+
+    SlotHeader* slot = slot_(read_pos_);
+
+    // Slot becomes free for writer which will come here on next lap.
+    core::AtomicOps::store_release(slot->seq, read_pos_ + n_slots_);
+
+    read_pos_++;
+}
+
+void ShmRing::wait(core::nanoseconds_t deadline) {
+    roc_panic_if(!is_open());
+
+    timespec ts;
+    ts.tv_sec = time_t(deadline / core::Second);
+    ts.tv_nsec = long(deadline % core::Second);
+
+    while (sem_timedwait(&header_->sem, &ts) != 0) {
+        if (errno != EINTR) {
+            break;
+        }
+    }
+}
+
+void ShmRing::wake() {
+    roc_panic_if(!is_open());
+
+    (void)sem_post(&header_->sem);
+}
+
+size_t ShmRing::header_size_() {
+    const size_t line = core::AlignOps::CacheLineSize;
+    return (sizeof(SegmentHeader) + line - 1) / line * line;
+}
+
+size_t ShmRing::stride_(size_t slot_size) {
+    const size_t line = core::AlignOps::CacheLineSize;
+    return (sizeof(SlotHeader) + slot_size + line - 1) / line * line;
+}
+
+ShmRing::SlotHeader* ShmRing::slot_(uint32_t pos) const {
+    return (SlotHeader*)(mem_ + header_size_() + stride_size_ * (pos & (n_slots_ - 1)));
+}
+
+} // namespace netio
+} // namespace roc
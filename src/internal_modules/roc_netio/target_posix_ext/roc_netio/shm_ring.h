@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_posix_ext/roc_netio/shm_ring.h
+//! @brief Packet ring in shared memory segment.
+
+#ifndef ROC_NETIO_SHM_RING_H_
+#define ROC_NETIO_SHM_RING_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace netio {
+
+//! Packet ring in shared memory segment.
+//! @remarks
+//!  Moves datagrams between processes on the same host. Ring is a bounded
+//!  lock-free multi-producer single-consumer queue of fixed-size slots, placed
+//!  in named POSIX shared memory segment.
+//!
+//!  Receiver creates segment and is the only reader. Senders attach to
+//!  segment by name and may write concurrently. Writes and reads don't
+//!  involve system calls, except waking up reader when it sleeps on
+//!  process-shared semaphore.
+class ShmRing : public core::NonCopyable<> {
+public:
+    //! Maximum length of segment name.
+    enum { MaxNameLen = 32 };
+
+    //! Initialize.
+    ShmRing();
+
+    //! Destroy.
+    //! @remarks
+    //!  Closes ring if it's open.
+    ~ShmRing();
+
+    //! Format segment name for given port number.
+    static void make_name(char* name, size_t name_size, int port);
+
+    //! Create segment and open ring for reading.
+    //! @remarks
+    //!  If segment with the same name already exists, it's replaced, since
+    //!  it was probably left by a crashed receiver.
+    ROC_ATTR_NODISCARD bool create(const char* name, size_t slot_size, size_t n_slots);
+
+    //! Attach to existing segment and open ring for writing.
+    //! @remarks
+    //!  Fails if segment doesn't exist yet.
+    ROC_ATTR_NODISCARD bool attach(const char* name);
+
+    //! Close ring.
+    //! @remarks
+    //!  If ring was created, marks it closed for writers, wakes up reader,
+    //!  and removes segment name. Unmaps segment.
+    void close();
+
+    //! Check if ring is open.
+    bool is_open() const;
+
+    //! Check if ring was closed by its creator.
+    //! @remarks
+    //!  Writers should re-attach to a new segment.
+    bool is_closed_by_peer() const;
+
+    //! Get maximum datagram size.
+    size_t slot_size() const;
+
+    //! Copy datagram into free slot and wake up reader.
+    //! @remarks
+    //!  Lock-free, may be called concurrently from multiple threads and
+    //!  processes. Returns false if ring is full or closed.
+    ROC_ATTR_NODISCARD bool write(uint32_t sender_id, const void* data, size_t size);
+
+    //! Get next datagram.
+    //! @remarks
+    //!  Returns pointer to datagram in shared memory, or NULL if ring is empty.
+    //!  Slot remains occupied until end_read() is called.
+    //!  Should be called only by ring creator.
+    const uint8_t* begin_read(uint32_t& sender_id, size_t& size);
+
+    //! Release slot obtained from begin_read().
+    void end_read();
+
+    //! Wait until writer wakes up reader or deadline expires.
+    //! @remarks
+    //!  Deadline is in core::ClockUnix domain.
+    void wait(core::nanoseconds_t deadline);
+
+    //! Wake up reader blocked in wait().
+    void wake();
+
+private:
+    struct SegmentHeader;
+    struct SlotHeader;
+
+    static size_t header_size_();
+    static size_t stride_(size_t slot_size);
+
+    SlotHeader* slot_(uint32_t pos) const;
+
+    uint8_t* mem_;
+    size_t mem_size_;
+
+    SegmentHeader* header_;
+
+    size_t slot_size_;
+    size_t stride_size_;
+    uint32_t n_slots_;
+
+    uint32_t read_pos_;
+
+    bool creator_;
+    char name_[MaxNameLen];
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SHM_RING_H_
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/async_sink.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace node {
+
+AsyncSink::AsyncSink(sndio::ISink& inner,
+                     ctl::ControlTaskQueue& queue,
+                     const AsyncSinkConfig& config,
+                     core::IPool& frame_buffer_pool,
+                     core::IArena& arena)
+    : inner_(inner)
+    , queue_(queue)
+    , sample_spec_(inner.sample_spec())
+    , policy_(config.overflow_policy)
+    , frame_factory_(frame_buffer_pool)
+    , cond_(mutex_)
+    , ring_(arena)
+    , ring_begin_(0)
+    , ring_len_(0)
+    , entries_(arena)
+    , entries_begin_(0)
+    , entries_len_(0)
+    , max_refs_(config.max_references)
+    , n_refs_(0)
+    , refs_len_(0)
+    , peak_len_(0)
+    , n_dropped_(0)
+    , started_(false)
+    , valid_(false) {
+    const size_t ring_size = sample_spec_.ns_2_samples_overall(config.queue_length);
+
+    roc_log(LogDebug,
+            "async sink: initializing: queue_length=%.3fms queue_size=%lu policy=%d",
+            (double)config.queue_length / core::Millisecond, (unsigned long)ring_size,
+            (int)policy_);
+
+    if (ring_size == 0) {
+        roc_log(LogError, "async sink: queue size can't be zero");
+        return;
+    }
+
+    if (!ring_.resize(ring_size)) {
+        roc_log(LogError, "async sink: can't allocate queue: size=%lu",
+                (unsigned long)ring_size);
+        return;
+    }
+
+    // Consecutive copied writes share one entry, so in worst case
+    // references alternate with copied writes.
+    if (!entries_.resize(max_refs_ * 2 + 1)) {
+        roc_log(LogError, "async sink: can't allocate entries: max_references=%lu",
+                (unsigned long)max_refs_);
+        return;
+    }
+
+    // Frame size should be multiple of number of channels.
+    const size_t frame_size = frame_factory_.raw_buffer_size()
+        / sample_spec_.num_channels() * sample_spec_.num_channels();
+
+    if (frame_size == 0) {
+        roc_log(LogError, "async sink: frame buffer is too small: size=%lu",
+                (unsigned long)frame_factory_.raw_buffer_size());
+        return;
+    }
+
+    frame_buffer_ = frame_factory_.new_raw_buffer();
+    if (!frame_buffer_) {
+        roc_log(LogError, "async sink: can't allocate frame buffer");
+        return;
+    }
+
+    frame_buffer_.reslice(0, frame_size);
+
+    // Task runs until queue is empty and pauses, write() resumes it.
+    queue_.schedule(task_, *this, NULL);
+    started_ = true;
+
+    valid_ = true;
+}
+
+AsyncSink::~AsyncSink() {
+    roc_log(LogDebug, "async sink: deinitializing");
+
+    if (started_) {
+        queue_.async_cancel(task_);
+        queue_.wait(task_);
+
+        // Flush what's left in queue.
+        while (transfer_frame_()) {
+        }
+    }
+}
+
+bool AsyncSink::is_valid() const {
+    return valid_;
+}
+
+AsyncSinkMetrics AsyncSink::metrics() const {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(mutex_);
+
+    AsyncSinkMetrics metrics;
+    metrics.queue_capacity = sample_spec_.samples_overall_2_ns(ring_.size());
+    metrics.queue_length = sample_spec_.samples_overall_2_ns(ring_len_ + refs_len_);
+    metrics.peak_queue_length = sample_spec_.samples_overall_2_ns(peak_len_);
+    metrics.dropped_length = sample_spec_.samples_overall_2_ns((size_t)n_dropped_);
+
+    return metrics;
+}
+
+sndio::ISink* AsyncSink::to_sink() {
+    return this;
+}
+
+sndio::ISource* AsyncSink::to_source() {
+    return NULL;
+}
+
+sndio::DeviceType AsyncSink::type() const {
+    return inner_.type();
+}
+
+sndio::DeviceState AsyncSink::state() const {
+    return inner_.state();
+}
+
+void AsyncSink::pause() {
+    inner_.pause();
+}
+
+bool AsyncSink::resume() {
+    return inner_.resume();
+}
+
+bool AsyncSink::restart() {
+    return inner_.restart();
+}
+
+audio::SampleSpec AsyncSink::sample_spec() const {
+    return sample_spec_;
+}
+
+core::nanoseconds_t AsyncSink::latency() const {
+    return inner_.latency();
+}
+
+bool AsyncSink::has_latency() const {
+    return inner_.has_latency();
+}
+
+bool AsyncSink::has_clock() const {
+    return false;
+}
+
+void AsyncSink::write(audio::Frame& frame) {
+    roc_panic_if(!is_valid());
+
+    const size_t num_ch = sample_spec_.num_channels();
+
+    const audio::sample_t* samples = frame.raw_samples();
+    size_t n_samples = frame.num_raw_samples();
+
+    roc_panic_if_msg(n_samples % num_ch != 0,
+                     "async sink: unexpected frame size: samples=%lu channels=%lu",
+                     (unsigned long)n_samples, (unsigned long)num_ch);
+
+    if (n_samples == 0) {
+        return;
+    }
+
+    core::nanoseconds_t cts = frame_cts_(frame);
+
+    core::Mutex::Lock lock(mutex_);
+
+    while (n_samples != 0) {
+        if (ring_len_ == ring_.size()) {
+            if (policy_ == AsyncOverflow_Block) {
+                queue_.resume(task_);
+                cond_.wait();
+                continue;
+            }
+
+            if (policy_ == AsyncOverflow_Drop) {
+                n_dropped_ += n_samples;
+                n_samples = 0;
+                break;
+            }
+
+            const size_t n_discard = std::min(n_samples, ring_.size());
+
+            discard_(n_discard);
+            n_dropped_ += n_discard;
+        }
+
+        const size_t n_push = std::min(n_samples, ring_.size() - ring_len_);
+
+        Entry* entry = entries_len_ != 0 ? &entry_(entries_len_ - 1) : NULL;
+        if (!entry || entry->samples) {
+            // Can't fail, see constructor.
+            entry = add_entry_();
+            roc_panic_if(!entry);
+            entry->samples = NULL;
+            entry->num_samples = 0;
+        }
+
+        push_(samples, n_push);
+
+        // Samples in entry are contiguous, so cts of first sample is
+        // derived from cts of last write.
+        entry->num_samples += n_push;
+        entry->cts = cts + sample_spec_.samples_overall_2_ns(n_push)
+            - sample_spec_.samples_overall_2_ns(entry->num_samples);
+
+        samples += n_push;
+        n_samples -= n_push;
+        cts += sample_spec_.samples_overall_2_ns(n_push);
+    }
+
+    peak_len_ = std::max(peak_len_, ring_len_ + refs_len_);
+
+    queue_.resume(task_);
+}
+
+bool AsyncSink::write_ref(audio::Frame& frame,
+                          release_func_t release_func,
+                          void* release_arg) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!release_func);
+
+    const size_t num_ch = sample_spec_.num_channels();
+
+    roc_panic_if_msg(frame.num_raw_samples() % num_ch != 0,
+                     "async sink: unexpected frame size: samples=%lu channels=%lu",
+                     (unsigned long)frame.num_raw_samples(), (unsigned long)num_ch);
+
+    if (frame.num_raw_samples() == 0) {
+        release_func(release_arg);
+        return true;
+    }
+
+    const core::nanoseconds_t cts = frame_cts_(frame);
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        while (n_refs_ == max_refs_) {
+            if (policy_ != AsyncOverflow_Block || max_refs_ == 0) {
+                return false;
+            }
+            queue_.resume(task_);
+            cond_.wait();
+        }
+
+        Entry* entry = add_entry_();
+        roc_panic_if(!entry);
+
+        entry->samples = frame.raw_samples();
+        entry->num_samples = frame.num_raw_samples();
+        entry->cts = cts;
+        entry->release_func = release_func;
+        entry->release_arg = release_arg;
+
+        n_refs_++;
+        refs_len_ += entry->num_samples;
+        peak_len_ = std::max(peak_len_, ring_len_ + refs_len_);
+    }
+
+    queue_.resume(task_);
+
+    return true;
+}
+
+ctl::ControlTaskResult AsyncSink::process_(ctl::ControlTask&) {
+    while (transfer_frame_()) {
+    }
+
+    return ctl::ControlTaskPause;
+}
+
+bool AsyncSink::transfer_frame_() {
+    Entry ref;
+    ref.samples = NULL;
+
+    size_t n_samples = 0;
+    core::nanoseconds_t cts = 0;
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        // Skip entries which samples were overwritten.
+        while (entries_len_ != 0 && entry_(0).num_samples == 0
+               && !entry_(0).samples) {
+            remove_entry_();
+        }
+
+        if (entries_len_ == 0) {
+            return false;
+        }
+
+        Entry& entry = entry_(0);
+
+        if (entry.samples) {
+            // Reference entries are not touched by writers, so we can use it
+            // without lock and remove when done.
+            ref = entry;
+            n_samples = entry.num_samples;
+            cts = entry.cts;
+        } else {
+            n_samples = std::min(entry.num_samples, frame_buffer_.size());
+            cts = entry.cts;
+
+            pop_(frame_buffer_.data(), n_samples);
+
+            entry.num_samples -= n_samples;
+            entry.cts += sample_spec_.samples_overall_2_ns(n_samples);
+
+            if (entry.num_samples == 0) {
+                remove_entry_();
+            }
+
+            cond_.broadcast();
+        }
+    }
+
+    if (n_samples != 0) {
+        audio::Frame frame(ref.samples ? ref.samples : frame_buffer_.data(), n_samples);
+
+        frame.set_duration(
+            (packet::stream_timestamp_t)(n_samples / sample_spec_.num_channels()));
+        frame.set_capture_timestamp(cts);
+
+        inner_.write(frame);
+    }
+
+    if (ref.samples) {
+        {
+            core::Mutex::Lock lock(mutex_);
+
+            remove_entry_();
+            n_refs_--;
+            refs_len_ -= n_samples;
+
+            cond_.broadcast();
+        }
+
+        ref.release_func(ref.release_arg);
+    }
+
+    return true;
+}
+
+core::nanoseconds_t AsyncSink::frame_cts_(const audio::Frame& frame) const {
+    const core::nanoseconds_t cts = frame.capture_timestamp();
+    if (cts != 0) {
+        return cts;
+    }
+    return core::timestamp(core::ClockMedia);
+}
+
+// Should be called with mutex locked.
+AsyncSink::Entry& AsyncSink::entry_(size_t index) {
+    roc_panic_if(index >= entries_len_);
+
+    return entries_[(entries_begin_ + index) % entries_.size()];
+}
+
+// Should be called with mutex locked.
+AsyncSink::Entry* AsyncSink::add_entry_() {
+    if (entries_len_ == entries_.size()) {
+        return NULL;
+    }
+
+    entries_len_++;
+
+    return &entry_(entries_len_ - 1);
+}
+
+// Should be called with mutex locked.
+void AsyncSink::remove_entry_() {
+    roc_panic_if(entries_len_ == 0);
+
+    entries_begin_ = (entries_begin_ + 1) % entries_.size();
+    entries_len_--;
+}
+
+// Should be called with mutex locked.
+// Discards oldest copied samples. References are kept.
+void AsyncSink::discard_(size_t n_samples) {
+    roc_panic_if(n_samples > ring_len_);
+
+    for (size_t n = 0; n < entries_len_ && n_samples != 0; n++) {
+        Entry& entry = entry_(n);
+        if (entry.samples) {
+            continue;
+        }
+
+        const size_t n_discard = std::min(n_samples, entry.num_samples);
+
+        entry.num_samples -= n_discard;
+        entry.cts += sample_spec_.samples_overall_2_ns(n_discard);
+
+        ring_begin_ = (ring_begin_ + n_discard) % ring_.size();
+        ring_len_ -= n_discard;
+
+        n_samples -= n_discard;
+    }
+}
+
+// Should be called with mutex locked.
+void AsyncSink::push_(const audio::sample_t* samples, size_t n_samples) {
+    roc_panic_if(ring_len_ + n_samples > ring_.size());
+
+    size_t pos = (ring_begin_ + ring_len_) % ring_.size();
+
+    for (size_t n = 0; n < n_samples;) {
+        const size_t n_copy = std::min(n_samples - n, ring_.size() - pos);
+
+        memcpy(ring_.data() + pos, samples + n, n_copy * sizeof(audio::sample_t));
+
+        n += n_copy;
+        pos = 0;
+    }
+
+    ring_len_ += n_samples;
+}
+
+// Should be called with mutex locked.
+void AsyncSink::pop_(audio::sample_t* samples, size_t n_samples) {
+    roc_panic_if(n_samples > ring_len_);
+
+    for (size_t n = 0; n < n_samples;) {
+        const size_t n_copy = std::min(n_samples - n, ring_.size() - ring_begin_);
+
+        memcpy(samples + n, ring_.data() + ring_begin_,
+               n_copy * sizeof(audio::sample_t));
+
+        n += n_copy;
+        ring_begin_ = (ring_begin_ + n_copy) % ring_.size();
+    }
+
+    ring_len_ -= n_samples;
+}
+
+} // namespace node
+} // namespace roc
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/async_sink.h
+//! @brief Sink decorator with asynchronous write.
+
+#ifndef ROC_NODE_ASYNC_SINK_H_
+#define ROC_NODE_ASYNC_SINK_H_
+
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/cond.h"
+#include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_ctl/control_task.h"
+#include "roc_ctl/control_task_executor.h"
+#include "roc_ctl/control_task_queue.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace node {
+
+//! What to do when asynchronous write queue is full.
+enum AsyncOverflowPolicy {
+    //! Block writer until there is enough space.
+    AsyncOverflow_Block,
+
+    //! Discard samples being written.
+    AsyncOverflow_Drop,
+
+    //! Discard oldest queued samples.
+    AsyncOverflow_Overwrite
+};
+
+//! Asynchronous write parameters.
+struct AsyncSinkConfig {
+    //! Capacity of write queue.
+    //! @remarks
+    //!  If zero, asynchronous write is disabled.
+    core::nanoseconds_t queue_length;
+
+    //! What to do when queue is full.
+    AsyncOverflowPolicy overflow_policy;
+
+    //! Maximum number of frames enqueued by reference.
+    //! @remarks
+    //!  Frames passed to write_ref() don't occupy queue, but each of them
+    //!  takes one of these slots until it's released.
+    size_t max_references;
+
+    //! Initialize config with default values.
+    AsyncSinkConfig()
+        : queue_length(0)
+        , overflow_policy(AsyncOverflow_Block)
+        , max_references(16) {
+    }
+};
+
+//! Asynchronous write metrics.
+struct AsyncSinkMetrics {
+    //! Capacity of write queue.
+    core::nanoseconds_t queue_capacity;
+
+    //! Duration of samples currently in queue.
+    core::nanoseconds_t queue_length;
+
+    //! Maximum duration of samples in queue since it was created.
+    core::nanoseconds_t peak_queue_length;
+
+    //! Total duration of samples dropped or overwritten on overflow.
+    core::nanoseconds_t dropped_length;
+
+    AsyncSinkMetrics()
+        : queue_capacity(0)
+        , queue_length(0)
+        , peak_queue_length(0)
+        , dropped_length(0) {
+    }
+};
+
+//! Sink decorator with asynchronous write.
+//!
+//! @remarks
+//!  write() copies samples into preallocated ring and returns, and the
+//!  underlying sink is written from the thread of given task queue, so the
+//!  caller doesn't wait for whatever the underlying sink does. When the ring
+//!  is full, write() blocks or discards samples, depending on policy.
+//!
+//! @remarks
+//!  Samples are forwarded in frames of arbitrary size, so underlying sink
+//!  should not rely on frame boundaries. Every frame has duration and capture
+//!  timestamp set; if frame passed to write() doesn't have capture timestamp,
+//!  it's assigned from current time, i.e. includes time spent in queue.
+//!  Underlying sink should have auto-duration and auto-cts disabled.
+//!
+//! @remarks
+//!  write_ref() enqueues frame by reference instead of copying it. Such
+//!  frame is passed to underlying sink as is, and then release callback
+//!  is invoked from the writer thread. Frames written by reference and by
+//!  copy are forwarded in the order in which they were written. Overflow
+//!  policy applies only to copied samples; frames written by reference are
+//!  never discarded.
+//!
+//! @remarks
+//!  Samples that are still in queue when sink is destroyed are written to
+//!  underlying sink from destructor.
+class AsyncSink : public sndio::ISink,
+                  public ctl::ControlTaskExecutor<AsyncSink>,
+                  public core::NonCopyable<> {
+public:
+    //! Callback invoked when frame written by reference is released.
+    typedef void (*release_func_t)(void* release_arg);
+
+    //! Initialize.
+    //! @remarks
+    //!  Underlying sink @p inner is written on thread of @p queue.
+    //!  Frame buffer is allocated from @p frame_buffer_pool, queue
+    //!  is allocated from @p arena.
+    AsyncSink(sndio::ISink& inner,
+              ctl::ControlTaskQueue& queue,
+              const AsyncSinkConfig& config,
+              core::IPool& frame_buffer_pool,
+              core::IArena& arena);
+
+    //! Deinitialize.
+    ~AsyncSink();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Get metrics.
+    //! @remarks
+    //!  Can be called from any thread.
+    AsyncSinkMetrics metrics() const;
+
+    //! Cast IDevice to ISink.
+    virtual sndio::ISink* to_sink();
+
+    //! Cast IDevice to ISource.
+    virtual sndio::ISource* to_source();
+
+    //! Get device type.
+    virtual sndio::DeviceType type() const;
+
+    //! Get device state.
+    virtual sndio::DeviceState state() const;
+
+    //! Pause underlying sink.
+    virtual void pause();
+
+    //! Resume underlying sink.
+    virtual bool resume();
+
+    //! Restart underlying sink.
+    virtual bool restart();
+
+    //! Get sample specification of the sink.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if the sink supports latency reports.
+    virtual bool has_latency() const;
+
+    //! Check if the sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Enqueue audio frame.
+    //! @remarks
+    //!  Samples are copied into queue.
+    virtual void write(audio::Frame& frame);
+
+    //! Enqueue audio frame by reference.
+    //! @remarks
+    //!  Samples are not copied; caller should keep them unchanged until
+    //!  @p release_func is invoked with @p release_arg. The callback is
+    //!  invoked exactly once, from writer thread or from destructor.
+    //! @returns
+    //!  false if all reference slots are busy and overflow policy is not
+    //!  AsyncOverflow_Block; in this case the callback is not invoked.
+    ROC_ATTR_NODISCARD bool
+    write_ref(audio::Frame& frame, release_func_t release_func, void* release_arg);
+
+private:
+    class WriteTask : public ctl::ControlTask {
+    public:
+        WriteTask()
+            : ControlTask(&AsyncSink::process_) {
+        }
+    };
+
+    // Queued frame. References caller memory if samples is not NULL,
+    // otherwise refers to next num_samples samples in ring.
+    struct Entry {
+        audio::sample_t* samples;
+        size_t num_samples;
+        core::nanoseconds_t cts;
+        release_func_t release_func;
+        void* release_arg;
+    };
+
+    ctl::ControlTaskResult process_(ctl::ControlTask& task);
+
+    bool transfer_frame_();
+
+    core::nanoseconds_t frame_cts_(const audio::Frame& frame) const;
+
+    Entry& entry_(size_t index);
+    Entry* add_entry_();
+    void remove_entry_();
+
+    void discard_(size_t n_samples);
+    void push_(const audio::sample_t* samples, size_t n_samples);
+    void pop_(audio::sample_t* samples, size_t n_samples);
+
+    sndio::ISink& inner_;
+    ctl::ControlTaskQueue& queue_;
+    WriteTask task_;
+
+    const audio::SampleSpec sample_spec_;
+    const AsyncOverflowPolicy policy_;
+
+    audio::FrameFactory frame_factory_;
+    core::Slice<audio::sample_t> frame_buffer_;
+
+    mutable core::Mutex mutex_;
+    core::Cond cond_;
+
+    // guarded by mutex_
+    core::Array<audio::sample_t> ring_;
+    size_t ring_begin_;
+    size_t ring_len_;
+    core::Array<Entry> entries_;
+    size_t entries_begin_;
+    size_t entries_len_;
+    const size_t max_refs_;
+    size_t n_refs_;
+    size_t refs_len_;
+    size_t peak_len_;
+    uint64_t n_dropped_;
+
+    bool started_;
+    bool valid_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_ASYNC_SINK_H_
@@ -9,35 +9,248 @@
 #include "roc_node/context.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_netio/pcap_writer.h"
 
 namespace roc {
 namespace node {
 
+namespace {
+
+// How much of thread stack is prefaulted in realtime mode.
+const size_t DefaultPrefaultStack = 256 * 1024;
+
+} // namespace
+
 Context::Context(const ContextConfig& config, core::IArena& arena)
     : arena_(arena)
-    , packet_pool_("packet_pool", arena_)
-    , packet_buffer_pool_(
-          "packet_buffer_pool", arena_, sizeof(core::Buffer) + config.max_packet_size)
-    , frame_buffer_pool_(
-          "frame_buffer_pool", arena_, sizeof(core::Buffer) + config.max_frame_size)
+    , huge_page_arena_(arena, config.huge_pages_size)
+    , numa_arena_(huge_page_arena_, config.numa_nodes)
+    , node_memory_limit_(config.node_memory_limit)
+    , realtime_(config.realtime)
+    , memory_locked_(false)
+    , packet_pool_("packet_pool",
+                   numa_arena_,
+                   sizeof(packet::Packet),
+                   0,
+                   0,
+                   core::SlabPool_DefaultGuards,
+                   true)
+    , packet_buffer_pool_("packet_buffer_pool",
+                          numa_arena_,
+                          sizeof(core::Buffer) + config.max_packet_size,
+                          0,
+                          0,
+                          core::SlabPool_DefaultGuards,
+                          true)
+    , small_packet_buffer_pool_("small_packet_buffer_pool",
+                                numa_arena_,
+                                sizeof(core::Buffer) + config.small_packet_size,
+                                0,
+                                0,
+                                core::SlabPool_DefaultGuards,
+                                true)
+    , medium_packet_buffer_pool_("medium_packet_buffer_pool",
+                                 numa_arena_,
+                                 sizeof(core::Buffer) + config.medium_packet_size,
+                                 0,
+                                 0,
+                                 core::SlabPool_DefaultGuards,
+                                 true)
+    , frame_buffer_pool_("frame_buffer_pool",
+                         numa_arena_,
+                         sizeof(core::Buffer) + config.max_frame_size,
+                         0,
+                         0,
+                         core::SlabPool_DefaultGuards,
+                         true)
+    , small_frame_buffer_pool_("small_frame_buffer_pool",
+                               numa_arena_,
+                               sizeof(core::Buffer) + config.small_frame_size,
+                               0,
+                               0,
+                               core::SlabPool_DefaultGuards,
+                               true)
+    , medium_frame_buffer_pool_("medium_frame_buffer_pool",
+                                numa_arena_,
+                                sizeof(core::Buffer) + config.medium_frame_size,
+                                0,
+                                0,
+                                core::SlabPool_DefaultGuards,
+                                true)
+    , packet_factory_(packet_pool_, packet_buffer_pool_)
     , encoding_map_(arena_)
-    , network_loop_(packet_pool_, packet_buffer_pool_, arena_)
-    , control_loop_(network_loop_, arena_) {
-    roc_log(LogDebug, "context: initializing");
+    , fec_groups_(packet_factory_, arena_)
+    , shared_runtime_(config.shared_runtime)
+    , runtime_(NULL)
+    , pool_shrinker_(config.pool_shrinker)
+    , shrink_task_(pool_shrinker_)
+    , shrink_enabled_(false)
+    , shrink_started_(false)
+    , shrink_stopping_(false)
+    , writer_thread_config_(make_thread_config_(config.pipeline_thread))
+    , use_small_packet_buffers_(config.small_packet_size != 0
+                                && config.small_packet_size < config.max_packet_size
+                                && config.max_packets == 0)
+    , use_medium_packet_buffers_(config.medium_packet_size != 0
+                                 && config.medium_packet_size < config.max_packet_size
+                                 && config.medium_packet_size != config.small_packet_size
+                                 && config.max_packets == 0)
+    , use_small_frame_buffers_(config.small_frame_size != 0
+                               && config.small_frame_size < config.max_frame_size
+                               && config.max_frames == 0)
+    , use_medium_frame_buffers_(config.medium_frame_size != 0
+                                && config.medium_frame_size < config.max_frame_size
+                                && config.medium_frame_size != config.small_frame_size
+                                && config.max_frames == 0)
+    , valid_(false) {
+    roc_log(LogDebug,
+            "context: initializing: network_threads=%lu shared_runtime=%d"
+            " pipeline_threads=%lu numa_nodes=0x%llx huge_pages_size=%lu realtime=%d",
+            (unsigned long)config.network_threads, (int)config.shared_runtime,
+            (unsigned long)config.pipeline_threads,
+            (unsigned long long)config.numa_nodes,
+            (unsigned long)config.huge_pages_size, (int)config.realtime);
+
+    if (!huge_page_arena_.is_valid()) {
+        roc_log(LogError, "context: can't reserve huge page memory: size=%lu",
+                (unsigned long)config.huge_pages_size);
+        return;
+    }
+
+    if (!numa_arena_.is_valid()) {
+        roc_log(LogError, "context: can't bind to numa nodes: numa_nodes=0x%llx",
+                (unsigned long long)config.numa_nodes);
+        return;
+    }
+
+    if (config.max_packets != 0 && config.prealloc_packets > config.max_packets) {
+        roc_log(LogError,
+                "context: prealloc_packets can't be greater than max_packets:"
+                " prealloc_packets=%lu max_packets=%lu",
+                (unsigned long)config.prealloc_packets,
+                (unsigned long)config.max_packets);
+        return;
+    }
+
+    if (config.max_frames != 0 && config.prealloc_frames > config.max_frames) {
+        roc_log(LogError,
+                "context: prealloc_frames can't be greater than max_frames:"
+                " prealloc_frames=%lu max_frames=%lu",
+                (unsigned long)config.prealloc_frames, (unsigned long)config.max_frames);
+        return;
+    }
+
+    if (!setup_pool_(packet_pool_, config.prealloc_packets, config.max_packets)
+        || !setup_pool_(packet_buffer_pool_, config.prealloc_packets,
+                        config.max_packets)
+        || !setup_pool_(frame_buffer_pool_, config.prealloc_frames, config.max_frames)) {
+        return;
+    }
+
+    if (config.network_threads == 0) {
+        roc_log(LogError, "context: number of network threads can't be zero");
+        return;
+    }
+
+    if (config.media_clock != core::MediaClock_System
+        && !core::set_media_clock(config.media_clock, config.ptp_device)) {
+        roc_log(LogError, "context: can't select media clock: source=%s device=%s",
+                core::media_clock_to_str(config.media_clock),
+                config.ptp_device ? config.ptp_device : "none");
+        return;
+    }
+
+    if (use_small_packet_buffers_) {
+        packet_factory_.add_small_buffer_pool(small_packet_buffer_pool_);
+    }
+    if (use_medium_packet_buffers_) {
+        packet_factory_.add_small_buffer_pool(medium_packet_buffer_pool_);
+    }
+
+    if (config.packet_capture.num_records != 0) {
+        capture_ring_.reset(new (capture_ring_)
+                                packet::CaptureRing(config.packet_capture, arena_));
+        if (!capture_ring_->is_valid()) {
+            roc_log(LogError, "context: can't create packet capture ring");
+            return;
+        }
+    }
+
+    init_runtime_config_(config);
+
+    if (config.pipeline_threads != 0) {
+        pipeline_pool_.reset(new (pipeline_pool_) PipelinePool(
+            config.pipeline_threads, make_thread_config_(config.pipeline_thread),
+            arena_));
+        if (!pipeline_pool_->is_valid()) {
+            return;
+        }
+    }
+
+    if (!init_pool_shrinker_(config)) {
+        return;
+    }
+
+    // In realtime mode, threads are started in advance, so that their stacks
+    // are prefaulted and locked together with pools.
+    if (config.realtime && !start_runtime()) {
+        return;
+    }
+
+    // Locked last, when pools are reserved and threads are started.
+    if (!lock_memory_(config)) {
+        return;
+    }
+
+    valid_ = true;
 }
 
 Context::~Context() {
     roc_log(LogDebug, "context: deinitializing");
+
+    stop_pool_shrinker_();
+
+    if (runtime_ && shared_runtime_) {
+        Runtime::release_shared(*runtime_);
+    }
+
+    roc_log(LogDebug,
+            "context: pool stats:"
+            " packet_grow_events=%lu packet_exhausted=%lu"
+            " frame_grow_events=%lu frame_exhausted=%lu",
+            (unsigned long)packet_buffer_pool_.num_grow_events(),
+            (unsigned long)packet_buffer_pool_.num_exhausted(),
+            (unsigned long)frame_buffer_pool_.num_grow_events(),
+            (unsigned long)frame_buffer_pool_.num_exhausted());
+
+    if (memory_locked_) {
+        const ContextMetrics metrics = get_metrics();
+
+        roc_log(metrics.major_page_faults != 0 ? LogInfo : LogDebug,
+                "context: realtime mode stats: minor_faults=%llu major_faults=%llu",
+                (unsigned long long)metrics.minor_page_faults,
+                (unsigned long long)metrics.major_page_faults);
+
+        core::MemoryLock::release();
+    }
 }
 
 bool Context::is_valid() {
-    return network_loop_.is_valid() && control_loop_.is_valid();
+    return valid_;
 }
 
 core::IArena& Context::arena() {
     return arena_;
 }
 
+core::IArena& Context::pool_arena() {
+    return numa_arena_;
+}
+
+size_t Context::node_memory_limit() const {
+    return node_memory_limit_;
+}
+
 core::IPool& Context::packet_pool() {
     return packet_pool_;
 }
@@ -50,16 +263,334 @@ core::IPool& Context::frame_buffer_pool() {
     return frame_buffer_pool_;
 }
 
+packet::PacketFactory& Context::packet_factory() {
+    return packet_factory_;
+}
+
+packet::CaptureRing* Context::packet_capture() {
+    return capture_ring_.get();
+}
+
+core::MemoryTracker& Context::memory_tracker() {
+    return memory_tracker_;
+}
+
 rtp::EncodingMap& Context::encoding_map() {
     return encoding_map_;
 }
 
+pipeline::FecGroupMap& Context::fec_groups() {
+    return fec_groups_;
+}
+
+bool Context::start_runtime() {
+    if (runtime_) {
+        return true;
+    }
+
+    core::Mutex::Lock lock(runtime_mutex_);
+
+    if (runtime_) {
+        return true;
+    }
+
+    Runtime* runtime = NULL;
+
+    if (shared_runtime_) {
+        runtime = Runtime::acquire_shared(runtime_config_);
+        if (!runtime) {
+            roc_log(LogError, "context: can't acquire shared runtime");
+            return false;
+        }
+    } else {
+        roc_log(LogDebug, "context: starting network and control threads");
+
+        own_runtime_.reset(new (own_runtime_) Runtime(
+            runtime_config_, packet_pool_, packet_buffer_pool_, arena_));
+        if (!own_runtime_->is_valid()) {
+            roc_log(LogError, "context: can't start network and control threads");
+            own_runtime_.reset();
+            return false;
+        }
+
+        runtime = own_runtime_.get();
+    }
+
+    // Published before starting shrinker, which uses control loop.
+    runtime_ = runtime;
+
+    start_pool_shrinker_();
+
+    return true;
+}
+
+bool Context::has_runtime() const {
+    return runtime_ != NULL;
+}
+
 netio::NetworkLoop& Context::network_loop() {
-    return network_loop_;
+    return get_runtime_().network_loop();
+}
+
+size_t Context::num_network_loops() {
+    return get_runtime_().num_network_loops();
+}
+
+netio::NetworkLoop& Context::select_network_loop() {
+    return get_runtime_().select_network_loop();
 }
 
 ctl::ControlLoop& Context::control_loop() {
-    return control_loop_;
+    return get_runtime_().control_loop();
+}
+
+PipelinePool* Context::pipeline_pool() {
+    return pipeline_pool_.get();
+}
+
+ctl::ControlTaskQueue* Context::writer_queue() {
+    core::Mutex::Lock lock(writer_queue_mutex_);
+
+    if (!writer_queue_) {
+        roc_log(LogDebug, "context: starting writer thread");
+
+        writer_queue_.reset(new (writer_queue_)
+                                ctl::ControlTaskQueue(writer_thread_config_));
+    }
+
+    if (!writer_queue_->is_valid()) {
+        roc_log(LogError, "context: can't start writer thread");
+        return NULL;
+    }
+
+    return writer_queue_.get();
+}
+
+ContextMetrics Context::get_metrics() const {
+    ContextMetrics metrics;
+
+    metrics.packet_pool = get_pool_metrics_(packet_pool_);
+    metrics.packet_buffer_pool = get_pool_metrics_(packet_buffer_pool_);
+    metrics.small_packet_buffer_pool = get_pool_metrics_(small_packet_buffer_pool_);
+    metrics.medium_packet_buffer_pool = get_pool_metrics_(medium_packet_buffer_pool_);
+    metrics.frame_buffer_pool = get_pool_metrics_(frame_buffer_pool_);
+    metrics.small_frame_buffer_pool = get_pool_metrics_(small_frame_buffer_pool_);
+    metrics.medium_frame_buffer_pool = get_pool_metrics_(medium_frame_buffer_pool_);
+    metrics.memory = memory_tracker_.usage();
+
+    core::PageFaults faults;
+    if (memory_locked_ && core::MemoryLock::get_page_faults(faults)) {
+        metrics.minor_page_faults = faults.minor - page_faults_base_.minor;
+        metrics.major_page_faults = faults.major - page_faults_base_.major;
+    }
+
+    return metrics;
+}
+
+bool Context::dump_packet_capture(const char* path) {
+    roc_panic_if(!path);
+
+    if (!capture_ring_) {
+        roc_log(LogError, "context: can't dump packet capture: capture is disabled");
+        return false;
+    }
+
+    netio::PcapWriter writer;
+
+    if (!writer.open(path)) {
+        return false;
+    }
+
+    const bool write_ok = writer.write_all(*capture_ring_);
+    const bool close_ok = writer.close();
+
+    if (!write_ok || !close_ok) {
+        roc_log(LogError, "context: can't dump packet capture: path=%s", path);
+        return false;
+    }
+
+    roc_log(LogInfo,
+            "context: dumped packet capture: path=%s packets=%lu captured=%lu lost=%lu",
+            path, (unsigned long)writer.num_packets(),
+            (unsigned long)capture_ring_->num_captured(),
+            (unsigned long)capture_ring_->num_lost());
+
+    return true;
+}
+
+template <class T>
+PoolMetrics Context::get_pool_metrics_(const core::SlabPool<T>& pool) {
+    PoolMetrics metrics;
+
+    metrics.used_objects = pool.num_used_slots();
+    metrics.grow_events = pool.num_grow_events();
+    metrics.shrink_events = pool.num_shrink_events();
+    metrics.exhausted = pool.num_exhausted();
+
+    return metrics;
+}
+
+void Context::init_runtime_config_(const ContextConfig& config) {
+    runtime_config_.network_threads = config.network_threads;
+    runtime_config_.resolver = config.resolver;
+    runtime_config_.max_packet_size = config.max_packet_size;
+
+    if (config.shared_runtime) {
+        // Shared threads serve contexts bound to different nodes,
+        // so they're not pinned to nodes of this context.
+        runtime_config_.network_thread = config.network_thread;
+        runtime_config_.control_thread = config.control_thread;
+    } else {
+        runtime_config_.network_thread = make_thread_config_(config.network_thread);
+        runtime_config_.control_thread = make_thread_config_(config.control_thread);
+    }
+}
+
+Runtime& Context::get_runtime_() {
+    if (!start_runtime()) {
+        roc_panic("context: can't start network and control threads");
+    }
+
+    return *runtime_;
+}
+
+bool Context::lock_memory_(const ContextConfig& config) {
+    if (!config.realtime) {
+        return true;
+    }
+
+    if ((config.prealloc_packets == 0 && config.max_packets == 0)
+        || (config.prealloc_frames == 0 && config.max_frames == 0)) {
+        roc_log(LogInfo,
+                "context: realtime mode is enabled, but pools are not preallocated,"
+                " they will cause page faults when growing");
+    }
+
+    if (!core::MemoryLock::acquire()) {
+        roc_log(LogError, "context: can't lock memory for realtime mode");
+        return false;
+    }
+
+    memory_locked_ = true;
+
+    // Faults are counted from now on: locking faulted in all mapped memory,
+    // including reserved pools and stacks of started threads.
+    if (!core::MemoryLock::get_page_faults(page_faults_base_)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Context::init_pool_shrinker_(const ContextConfig& config) {
+    if (!pool_shrinker_.is_enabled()) {
+        return true;
+    }
+
+    if (config.realtime) {
+        // Memory returned by shrinker would cause page faults when pools grow.
+        roc_log(LogDebug, "context: not starting pool shrinker in realtime mode");
+        return true;
+    }
+
+    if (!pool_shrinker_.add_pool(packet_pool_, config.prealloc_packets)
+        || !pool_shrinker_.add_pool(packet_buffer_pool_, config.prealloc_packets)
+        || !pool_shrinker_.add_pool(small_packet_buffer_pool_, 0)
+        || !pool_shrinker_.add_pool(medium_packet_buffer_pool_, 0)
+        || !pool_shrinker_.add_pool(frame_buffer_pool_, config.prealloc_frames)
+        || !pool_shrinker_.add_pool(small_frame_buffer_pool_, 0)
+        || !pool_shrinker_.add_pool(medium_frame_buffer_pool_, 0)) {
+        return false;
+    }
+
+    roc_log(LogDebug, "context: enabling pool shrinker: idle_period=%.3fms",
+            (double)config.pool_shrinker.idle_period / core::Millisecond);
+
+    shrink_enabled_ = true;
+
+    return true;
+}
+
+void Context::start_pool_shrinker_() {
+    // Shrinker is run by control thread, so it's started together with it.
+    if (!shrink_enabled_) {
+        return;
+    }
+
+    shrink_started_ = true;
+
+    control_loop().schedule_at(
+        shrink_task_,
+        core::timestamp(core::ClockMonotonic) + pool_shrinker_.check_interval(), this);
+}
+
+void Context::stop_pool_shrinker_() {
+    if (!shrink_started_) {
+        return;
+    }
+
+    {
+        core::Mutex::Lock lock(shrink_mutex_);
+
+        shrink_stopping_ = true;
+
+        // If task is sleeping, it's cancelled, otherwise it finishes normally.
+        // In both cases completer will see stopping flag and won't reschedule.
+        control_loop().async_cancel(shrink_task_);
+    }
+
+    shrink_stopped_sem_.wait();
+}
+
+void Context::control_task_completed(ctl::ControlTask&) {
+    {
+        core::Mutex::Lock lock(shrink_mutex_);
+
+        if (!shrink_stopping_) {
+            control_loop().schedule_at(shrink_task_,
+                                       core::timestamp(core::ClockMonotonic)
+                                           + pool_shrinker_.check_interval(),
+                                       this);
+            return;
+        }
+    }
+
+    shrink_stopped_sem_.post();
+}
+
+core::ThreadConfig
+Context::make_thread_config_(const core::ThreadConfig& thread_config) const {
+    core::ThreadConfig result = thread_config;
+
+    // Explicit CPU mask takes precedence over NUMA binding.
+    if (result.cpu_mask == 0) {
+        result.cpu_mask = numa_arena_.cpu_mask();
+    }
+
+    if (realtime_ && result.prefault_stack == 0) {
+        result.prefault_stack = DefaultPrefaultStack;
+    }
+
+    return result;
+}
+
+template <class T>
+bool Context::setup_pool_(core::SlabPool<T>& pool,
+                          size_t prealloc_size,
+                          size_t max_size) {
+    const size_t reserve_size = std::max(prealloc_size, max_size);
+
+    if (reserve_size != 0 && !pool.reserve(reserve_size)) {
+        roc_log(LogError, "context: can't preallocate pool: size=%lu",
+                (unsigned long)reserve_size);
+        return false;
+    }
+
+    if (max_size != 0) {
+        pool.set_fixed_capacity(true);
+    }
+
+    return true;
 }
 
 } // namespace node
@@ -15,12 +15,28 @@
 #include "roc_audio/sample.h"
 #include "roc_core/allocation_policy.h"
 #include "roc_core/atomic.h"
+#include "roc_core/attributes.h"
+#include "roc_core/huge_page_arena.h"
 #include "roc_core/iarena.h"
+#include "roc_core/memory_lock.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/mutex.h"
+#include "roc_core/numa_arena.h"
+#include "roc_core/optional.h"
+#include "roc_core/pool_shrinker.h"
 #include "roc_core/ref_counted.h"
+#include "roc_core/semaphore.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_ctl/control_loop.h"
+#include "roc_ctl/control_task_queue.h"
 #include "roc_netio/network_loop.h"
+#include "roc_node/pipeline_pool.h"
+#include "roc_node/runtime.h"
+#include "roc_packet/capture_ring.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_pipeline/fec_group_map.h"
 #include "roc_rtp/encoding_map.h"
 
 namespace roc {
@@ -31,17 +47,262 @@ struct ContextConfig {
     //! Maximum size in bytes of a network packet.
     size_t max_packet_size;
 
+    //! Size in bytes of buffers for small received packets.
+    //! @remarks
+    //!  Received packets not larger than this are stored in buffers of this
+    //!  size instead of max_packet_size, e.g. RTCP packets and audio packets
+    //!  with short duration. Such packets are copied once by network thread
+    //!  from receive buffer, which is then reused for next datagram.
+    //!  If zero, or not less than max_packet_size, this size class is disabled.
+    //!  Size classes are not used when max_packets is set.
+    size_t small_packet_size;
+
+    //! Size in bytes of buffers for medium received packets.
+    //! @remarks
+    //!  Same as small_packet_size, but for packets larger than small_packet_size.
+    size_t medium_packet_size;
+
     //! Maximum size in bytes of an audio frame.
     size_t max_frame_size;
 
+    //! Size in bytes of buffers for small frames.
+    //! @remarks
+    //!  Pipeline elements which know how much space they need, e.g. resamplers,
+    //!  allocate buffers of this size instead of max_frame_size when it fits,
+    //!  so that pipelines with few channels or low rates don't hold buffers
+    //!  sized for the largest possible frame.
+    //!  If zero, or not less than max_frame_size, this size class is disabled.
+    //!  Size classes are not used when max_frames is set.
+    size_t small_frame_size;
+
+    //! Size in bytes of buffers for medium frames.
+    //! @remarks
+    //!  Same as small_frame_size, but for buffers larger than small_frame_size.
+    size_t medium_frame_size;
+
+    //! Number of network threads.
+    //! @remarks
+    //!  Each thread runs its own network event loop. Ports of senders and
+    //!  receivers are distributed between loops in round-robin order.
+    size_t network_threads;
+
+    //! Scheduling parameters of network threads.
+    core::ThreadConfig network_thread;
+
+    //! Scheduling parameters of control thread.
+    core::ThreadConfig control_thread;
+
+    //! Use process-wide shared runtime.
+    //! @remarks
+    //!  If true, context doesn't start its own network and control threads,
+    //!  and uses threads of runtime shared by all contexts with this option
+    //!  (see Runtime::acquire_shared()). Shared runtime is created by the
+    //!  first such context with its network_threads, network_thread,
+    //!  control_thread and resolver parameters; these parameters of other
+    //!  contexts are ignored. Pools, memory tracking and metrics are still
+    //!  separate for every context.
+    //!  If false, context has its own threads.
+    bool shared_runtime;
+
+    //! Number of pipeline threads.
+    //! @remarks
+    //!  If non-zero, context owns a pool of threads which can drive headless
+    //!  pipelines, i.e. receivers and senders whose other end is a file or
+    //!  nothing, instead of a thread per pipeline created by user.
+    //!  If zero, there is no pool.
+    size_t pipeline_threads;
+
+    //! Scheduling parameters of pipeline threads.
+    core::ThreadConfig pipeline_thread;
+
+    //! Parameters of hostname resolver.
+    //! @remarks
+    //!  Each network thread has its own resolver cache.
+    netio::ResolverConfig resolver;
+
+    //! Mask of NUMA nodes to which context is bound.
+    //! @remarks
+    //!  N-th bit corresponds to N-th NUMA node. If non-zero, memory of packet
+    //!  and frame pools is placed on these nodes, and network and control
+    //!  threads without explicit CPU mask are pinned to CPUs of these nodes.
+    //!  Senders and receivers attached to the context use its pools, so to get
+    //!  node-local pools for multiple nodes, create one context per node.
+    //!  If zero, context is not bound to any node.
+    uint64_t numa_nodes;
+
+    //! Number of bytes of huge-page backed memory reserved for pools.
+    //! @remarks
+    //!  If non-zero, packet and frame pools allocate their slabs from memory
+    //!  reserved, locked, and prefaulted when context is created, and
+    //!  fall back to context arena when it's exhausted.
+    //!  If zero, pools allocate slabs from context arena.
+    size_t huge_pages_size;
+
+    //! Number of packets to preallocate.
+    //! @remarks
+    //!  Packet pools reserve memory for this number of packets (and their
+    //!  buffers) when context is created, and grow on demand after that.
+    //!  If zero, packet pools grow on demand from the very beginning.
+    size_t prealloc_packets;
+
+    //! Number of frame buffers to preallocate.
+    //! @remarks
+    //!  Same as prealloc_packets, but for frame buffer pool.
+    size_t prealloc_frames;
+
+    //! Maximum number of packets.
+    //! @remarks
+    //!  If non-zero, packet pools reserve memory for at least this number of
+    //!  packets when context is created (rounded up to slab size), and never
+    //!  grow after that: allocation fails when all packets are in use. This
+    //!  guarantees that packets don't cause heap allocations after startup.
+    //!  If zero, number of packets is not limited.
+    size_t max_packets;
+
+    //! Maximum number of frame buffers.
+    //! @remarks
+    //!  Same as max_packets, but for frame buffer pool.
+    size_t max_frames;
+
+    //! Memory quota of every sender and receiver, in bytes.
+    //! @remarks
+    //!  If non-zero, every sender and receiver attached to context gets its
+    //!  own packet and frame pools (see NodePools), which allocate slabs from
+    //!  context memory, but not more than this quota. One sender or receiver
+    //!  then can't exhaust pools of others, or contend with them on pool locks.
+    //!  Such pools don't use small buffer size classes and are not affected by
+    //!  prealloc_packets, prealloc_frames, max_packets, and max_frames.
+    //!  If zero, all senders and receivers share pools of context.
+    size_t node_memory_limit;
+
+    //! Parameters of releasing pool memory after load peaks.
+    //! @remarks
+    //!  If idle_period is non-zero, control thread periodically returns fully
+    //!  free slabs of packet and frame pools to arena when pools didn't grow
+    //!  during idle period. Pools are not shrunk below prealloc_packets and
+    //!  prealloc_frames. Pools with max_packets or max_frames are not shrunk.
+    core::PoolShrinkerConfig pool_shrinker;
+
+    //! Run in realtime memory mode.
+    //! @remarks
+    //!  If true, memory of the whole process is locked in RAM when context is
+    //!  created (see core::MemoryLock), which also prefaults preallocated pools,
+    //!  and stacks of context threads are prefaulted when they start (see
+    //!  core::ThreadConfig::prefault_stack). Pool shrinker is disabled. After
+    //!  that, page faults of process are reported in ContextMetrics and should
+    //!  stay zero, as long as prealloc_packets, prealloc_frames, max_packets,
+    //!  and max_frames cover the load.
+    //!  If false, memory is not locked.
+    bool realtime;
+
+    //! Source of clock for capture timestamps and end-to-end latency.
+    //! @remarks
+    //!  Selection is process-wide (see core::set_media_clock()) and is
+    //!  applied when context is created. If MediaClock_System, current
+    //!  selection is not changed.
+    core::MediaClockSource media_clock;
+
+    //! Path to PTP clock device, e.g. "/dev/ptp0".
+    //! @remarks
+    //!  Used when media_clock is MediaClock_Ptp.
+    const char* ptp_device;
+
+    //! Parameters of in-process packet capture.
+    //! @remarks
+    //!  If num_records is non-zero, context keeps a ring of last packets
+    //!  received and sent by its UDP ports and passed through FEC readers of
+    //!  its receivers, which can be dumped using Context::dump_packet_capture().
+    //!  If zero, packets are not captured.
+    packet::CaptureConfig packet_capture;
+
     ContextConfig()
         : max_packet_size(2048)
-        , max_frame_size(4096) {
+        , small_packet_size(256)
+        , medium_packet_size(1024)
+        , max_frame_size(4096)
+        , small_frame_size(256)
+        , medium_frame_size(1024)
+        , network_threads(1)
+        , shared_runtime(false)
+        , pipeline_threads(0)
+        , numa_nodes(0)
+        , huge_pages_size(0)
+        , prealloc_packets(0)
+        , prealloc_frames(0)
+        , max_packets(0)
+        , max_frames(0)
+        , node_memory_limit(0)
+        , realtime(false)
+        , media_clock(core::MediaClock_System)
+        , ptp_device(NULL) {
+    }
+};
+
+//! Memory pool metrics.
+struct PoolMetrics {
+    //! Number of objects currently allocated from pool.
+    size_t used_objects;
+
+    //! Number of times pool allocated new memory on demand.
+    size_t grow_events;
+
+    //! Number of times pool released idle memory.
+    size_t shrink_events;
+
+    //! Number of allocations failed because pool had no free objects.
+    size_t exhausted;
+
+    PoolMetrics()
+        : used_objects(0)
+        , grow_events(0)
+        , shrink_events(0)
+        , exhausted(0) {
+    }
+};
+
+//! Node context metrics.
+struct ContextMetrics {
+    //! Packet pool metrics.
+    PoolMetrics packet_pool;
+
+    //! Packet buffer pool metrics.
+    PoolMetrics packet_buffer_pool;
+
+    //! Small packet buffer pool metrics.
+    PoolMetrics small_packet_buffer_pool;
+
+    //! Medium packet buffer pool metrics.
+    PoolMetrics medium_packet_buffer_pool;
+
+    //! Frame buffer pool metrics.
+    PoolMetrics frame_buffer_pool;
+
+    //! Small frame buffer pool metrics.
+    PoolMetrics small_frame_buffer_pool;
+
+    //! Medium frame buffer pool metrics.
+    PoolMetrics medium_frame_buffer_pool;
+
+    //! Memory allocated by pipelines of all receivers, per subsystem.
+    core::MemoryUsage memory;
+
+    //! Number of minor page faults of process since context was created.
+    //! Counted only in realtime mode.
+    uint64_t minor_page_faults;
+
+    //! Number of major page faults of process since context was created.
+    //! Counted only in realtime mode.
+    uint64_t major_page_faults;
+
+    ContextMetrics()
+        : minor_page_faults(0)
+        , major_page_faults(0) {
     }
 };
 
 //! Node context.
-class Context : public core::RefCounted<Context, core::ManualAllocation> {
+class Context : public core::RefCounted<Context, core::ManualAllocation>,
+                private ctl::IControlTaskCompleter {
 public:
     //! Initialize.
     explicit Context(const ContextConfig& config, core::IArena& arena);
@@ -59,31 +320,211 @@ public:
     core::IPool& packet_pool();
 
     //! Get packet buffer pool.
+    //! @remarks
+    //!  Buffers have max_packet_size.
     core::IPool& packet_buffer_pool();
 
     //! Get frame buffer pool.
+    //! @remarks
+    //!  Buffers have max_frame_size.
     core::IPool& frame_buffer_pool();
 
+    //! Get arena used by pools to allocate slabs.
+    //! @remarks
+    //!  Takes into account numa_nodes and huge_pages_size.
+    core::IArena& pool_arena();
+
+    //! Get memory quota of every sender and receiver.
+    //! @remarks
+    //!  Zero if senders and receivers share pools of context.
+    size_t node_memory_limit() const;
+
+    //! Get packet factory for network ports.
+    //! @remarks
+    //!  Should be passed to tasks adding ports, so that packets received by
+    //!  ports are allocated from pools of this context even when network loop
+    //!  is shared with other contexts.
+    packet::PacketFactory& packet_factory();
+
+    //! Get packet capture ring for network ports.
+    //! @returns
+    //!  NULL if packet capture is disabled.
+    packet::CaptureRing* packet_capture();
+
+    //! Add pools for smaller frame buffers to pipeline.
+    //! @remarks
+    //!  @p pipeline is pipeline::SenderLoop or pipeline::ReceiverLoop.
+    //!  Should be called before pipeline is used.
+    template <class Pipeline> void add_small_frame_buffer_pools(Pipeline& pipeline) {
+        if (use_small_frame_buffers_) {
+            pipeline.add_small_frame_buffer_pool(small_frame_buffer_pool_);
+        }
+        if (use_medium_frame_buffers_) {
+            pipeline.add_small_frame_buffer_pool(medium_frame_buffer_pool_);
+        }
+    }
+
+    //! Get memory tracker.
+    //! @remarks
+    //!  Pipelines report their memory usage here.
+    core::MemoryTracker& memory_tracker();
+
     //! Get encoding map.
     rtp::EncodingMap& encoding_map();
 
-    //! Get network event loop.
+    //! Get shared FEC writers.
+    //! @remarks
+    //!  Shared by all senders of context, see SenderSinkConfig::enable_shared_fec.
+    pipeline::FecGroupMap& fec_groups();
+
+    //! Start network and control threads.
+    //! @remarks
+    //!  Threads are not started when context is created (unless realtime mode
+    //!  is enabled), but on first call of this method or of any method
+    //!  returning network or control loop. Hence, contexts used only by
+    //!  encoders and decoders never start them.
+    //!  Can be called from any thread. Does nothing if threads are running.
+    //! @returns
+    //!  false if threads can't be started.
+    ROC_ATTR_NODISCARD bool start_runtime();
+
+    //! Check if network and control threads are running.
+    bool has_runtime() const;
+
+    //! Get main network event loop.
+    //! @remarks
+    //!  Can be used for tasks not bound to a port, like address resolving.
+    //!  Starts threads if needed, see start_runtime().
     netio::NetworkLoop& network_loop();
 
+    //! Get number of network event loops.
+    //! @remarks
+    //!  Starts threads if needed, see start_runtime().
+    size_t num_network_loops();
+
+    //! Select network event loop for a new port.
+    //! @remarks
+    //!  Returns loops in round-robin order. All tasks for a port should be
+    //!  scheduled on the loop to which it was added.
+    //!  Starts threads if needed, see start_runtime().
+    netio::NetworkLoop& select_network_loop();
+
     //! Get control event loop.
+    //! @remarks
+    //!  Starts threads if needed, see start_runtime().
     ctl::ControlLoop& control_loop();
 
+    //! Get pipeline thread pool.
+    //! @returns
+    //!  NULL if pipeline_threads was zero.
+    PipelinePool* pipeline_pool();
+
+    //! Get task queue for asynchronous writers.
+    //! @remarks
+    //!  Thread of the queue runs pipelines of senders with asynchronous write
+    //!  enabled. It's started on first call with scheduling parameters of
+    //!  pipeline threads, so contexts without such senders don't have it.
+    //! @returns
+    //!  NULL if thread can't be started.
+    ctl::ControlTaskQueue* writer_queue();
+
+    //! Get metrics.
+    //! @remarks
+    //!  Can be called from any thread.
+    ContextMetrics get_metrics() const;
+
+    //! Attach packet capture to pipeline.
+    //! @remarks
+    //!  @p pipeline is pipeline::ReceiverLoop.
+    //!  Should be called before pipeline is used.
+    template <class Pipeline> void add_packet_capture(Pipeline& pipeline) {
+        if (capture_ring_) {
+            pipeline.set_packet_capture(*capture_ring_);
+        }
+    }
+
+    //! Dump captured packets to pcapng file.
+    //! @remarks
+    //!  Writes packets currently kept in capture ring, from oldest to newest.
+    //!  Can be called from any thread, concurrently with capturing.
+    //! @returns
+    //!  false if packet capture is disabled or file can't be written.
+    ROC_ATTR_NODISCARD bool dump_packet_capture(const char* path);
+
 private:
+    core::ThreadConfig make_thread_config_(const core::ThreadConfig& thread_config) const;
+
+    template <class T>
+    bool setup_pool_(core::SlabPool<T>& pool, size_t prealloc_size, size_t max_size);
+
+    template <class T>
+    static PoolMetrics get_pool_metrics_(const core::SlabPool<T>& pool);
+
+    void init_runtime_config_(const ContextConfig& config);
+    Runtime& get_runtime_();
+
+    bool lock_memory_(const ContextConfig& config);
+
+    bool init_pool_shrinker_(const ContextConfig& config);
+    void start_pool_shrinker_();
+    void stop_pool_shrinker_();
+
+    virtual void control_task_completed(ctl::ControlTask& task);
+
     core::IArena& arena_;
+    core::HugePageArena huge_page_arena_;
+    core::NumaArena numa_arena_;
+
+    const size_t node_memory_limit_;
+
+    const bool realtime_;
+    bool memory_locked_;
+    core::PageFaults page_faults_base_;
+
+    core::MemoryTracker memory_tracker_;
 
     core::SlabPool<packet::Packet> packet_pool_;
     core::SlabPool<core::Buffer> packet_buffer_pool_;
+    core::SlabPool<core::Buffer> small_packet_buffer_pool_;
+    core::SlabPool<core::Buffer> medium_packet_buffer_pool_;
     core::SlabPool<core::Buffer> frame_buffer_pool_;
+    core::SlabPool<core::Buffer> small_frame_buffer_pool_;
+    core::SlabPool<core::Buffer> medium_frame_buffer_pool_;
+
+    packet::PacketFactory packet_factory_;
 
     rtp::EncodingMap encoding_map_;
 
-    netio::NetworkLoop network_loop_;
-    ctl::ControlLoop control_loop_;
+    pipeline::FecGroupMap fec_groups_;
+
+    core::Optional<packet::CaptureRing> capture_ring_;
+
+    RuntimeConfig runtime_config_;
+    const bool shared_runtime_;
+    core::Optional<Runtime> own_runtime_;
+    core::Atomic<Runtime*> runtime_;
+    core::Mutex runtime_mutex_;
+
+    core::PoolShrinker pool_shrinker_;
+    ctl::ControlLoop::Tasks::ShrinkPools shrink_task_;
+    core::Mutex shrink_mutex_;
+    bool shrink_enabled_;
+    bool shrink_started_;
+    bool shrink_stopping_;
+    core::Semaphore shrink_stopped_sem_;
+
+    core::Optional<PipelinePool> pipeline_pool_;
+
+    const core::ThreadConfig writer_thread_config_;
+    core::Optional<ctl::ControlTaskQueue> writer_queue_;
+    core::Mutex writer_queue_mutex_;
+
+    bool use_small_packet_buffers_;
+    bool use_medium_packet_buffers_;
+    bool use_small_frame_buffers_;
+    bool use_medium_frame_buffers_;
+
+    bool valid_;
 };
 
 } // namespace node
@@ -0,0 +1,1137 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/metrics_exporter.h"
+#include "roc_address/socket_addr_to_str.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+// Formats metric family header.
+void format_family(core::StringBuilder& b,
+                   const char* name,
+                   const char* type,
+                   const char* help) {
+    b.append_str("# HELP ");
+    b.append_str(name);
+    b.append_char(' ');
+    b.append_str(help);
+    b.append_str("\n# TYPE ");
+    b.append_str(name);
+    b.append_char(' ');
+    b.append_str(type);
+    b.append_char('\n');
+}
+
+// Formats one sample of metric family.
+void format_sample(core::StringBuilder& b,
+                   const char* name,
+                   const char* labels,
+                   double value) {
+    // %.15g keeps integer counters exact up to 10^15
+    char value_str[64];
+    snprintf(value_str, sizeof(value_str), "%.15g", value);
+
+    b.append_str(name);
+    if (*labels) {
+        b.append_char('{');
+        b.append_str(labels);
+        b.append_char('}');
+    }
+    b.append_char(' ');
+    b.append_str(value_str);
+    b.append_char('\n');
+}
+
+double ns_to_sec(core::nanoseconds_t ns) {
+    return (double)ns / core::Second;
+}
+
+struct ReceiverPartyMetric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get)(const pipeline::ReceiverParticipantMetrics&);
+};
+
+double recv_packets(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.link.total_packets;
+}
+
+double recv_lost_packets(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.link.lost_packets;
+}
+
+double recv_jitter(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.link.jitter);
+}
+
+double recv_peak_jitter(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.link.peak_jitter);
+}
+
+double recv_rtt(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.link.rtt);
+}
+
+double recv_niq_latency(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.latency.niq_latency);
+}
+
+double recv_niq_stalling(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.latency.niq_stalling);
+}
+
+double recv_e2e_latency(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.latency.e2e_latency);
+}
+
+double recv_fec_restored(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.fec.restored_packets;
+}
+
+double recv_fec_late(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.fec.late_packets;
+}
+
+double recv_fec_skipped(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.fec.skipped_repair_packets;
+}
+
+double recv_fec_decoding_lag(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.fec.max_decoding_lag);
+}
+
+double recv_concealed(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.concealed_samples;
+}
+
+double recv_duplicate(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.duplicate_packets;
+}
+
+double recv_rate_limited(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.rate_limited_packets;
+}
+
+double recv_queue_overflow(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.queue_overflow_packets;
+}
+
+double recv_cpu_ratio(const pipeline::ReceiverParticipantMetrics& m) {
+    return ns_to_sec(m.cpu_ns_per_sec);
+}
+
+double recv_overload_level(const pipeline::ReceiverParticipantMetrics& m) {
+    return (double)m.overload_level;
+}
+
+const ReceiverPartyMetric receiver_party_metrics[] = {
+    { "roc_receiver_packets_total", "counter", "Number of packets expected from sender",
+      recv_packets },
+    { "roc_receiver_lost_packets", "gauge",
+      "Number of lost packets (may be negative due to duplicates)", recv_lost_packets },
+    { "roc_receiver_jitter_seconds", "gauge", "Estimated packet interarrival jitter",
+      recv_jitter },
+    { "roc_receiver_peak_jitter_seconds", "gauge",
+      "Packet delay variation percentile over recent packets", recv_peak_jitter },
+    { "roc_receiver_rtt_seconds", "gauge", "Estimated round-trip time", recv_rtt },
+    { "roc_receiver_niq_latency_seconds", "gauge",
+      "Network incoming queue latency", recv_niq_latency },
+    { "roc_receiver_niq_stalling_seconds", "gauge",
+      "Delay since last packet in network incoming queue", recv_niq_stalling },
+    { "roc_receiver_e2e_latency_seconds", "gauge", "Estimated end-to-end latency",
+      recv_e2e_latency },
+    { "roc_receiver_fec_restored_packets_total", "counter",
+      "Number of packets restored by FEC", recv_fec_restored },
+    { "roc_receiver_fec_late_packets_total", "counter",
+      "Number of packets restored by FEC too late to be played", recv_fec_late },
+    { "roc_receiver_fec_skipped_repair_packets_total", "counter",
+      "Number of repair packets not used for restoration", recv_fec_skipped },
+    { "roc_receiver_fec_max_decoding_lag_seconds", "gauge",
+      "Maximum delay of FEC decoding", recv_fec_decoding_lag },
+    { "roc_receiver_concealed_samples_total", "counter",
+      "Number of samples per channel generated in place of lost packets",
+      recv_concealed },
+    { "roc_receiver_duplicate_packets_total", "counter",
+      "Number of packets dropped because they were received over another path",
+      recv_duplicate },
+    { "roc_receiver_rate_limited_packets_total", "counter",
+      "Number of packets dropped because sender exceeded packet rate limit",
+      recv_rate_limited },
+    { "roc_receiver_queue_overflow_packets_total", "counter",
+      "Number of packets dropped because session queue was full", recv_queue_overflow },
+    { "roc_receiver_session_cpu_ratio", "gauge",
+      "Fraction of CPU core spent by pipeline thread on session", recv_cpu_ratio },
+    { "roc_receiver_overload_level", "gauge",
+      "Quality degradation level applied because of CPU overload", recv_overload_level },
+};
+
+struct MemoryFamily {
+    const char* receiver_name;
+    const char* receiver_help;
+    const char* context_name;
+    const char* context_help;
+    size_t (core::MemoryUsage::*bytes)[core::MemoryTag_Max];
+};
+
+const MemoryFamily memory_families[] = {
+    { "roc_receiver_memory_bytes", "Memory allocated by session, per subsystem",
+      "roc_memory_bytes", "Memory allocated by pipelines of context, per subsystem",
+      &core::MemoryUsage::live_bytes },
+    { "roc_receiver_memory_peak_bytes",
+      "Maximum memory allocated by session, per subsystem", "roc_memory_peak_bytes",
+      "Maximum memory allocated by pipelines of context, per subsystem",
+      &core::MemoryUsage::peak_bytes },
+};
+
+struct SenderSlotMetric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get)(const pipeline::SenderSlotMetrics&);
+};
+
+double send_participants(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.num_participants;
+}
+
+double send_fec_encoded(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.fec.encoded_blocks;
+}
+
+double send_fec_dropped(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.fec.dropped_blocks;
+}
+
+double send_fec_encoding_lag(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.fec.encoding_lag);
+}
+
+double send_paced_packets(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.pacer.paced_packets;
+}
+
+double send_pacing_delay(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.pacer.pacing_delay);
+}
+
+double send_nacked_packets(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.retransmitter.requested_packets;
+}
+
+double send_retransmitted_packets(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.retransmitter.retransmitted_packets;
+}
+
+double send_packet_length(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.packet_length);
+}
+
+double send_timing_lateness(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.timing.last_lateness);
+}
+
+double send_timing_max_lateness(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.timing.max_lateness);
+}
+
+double send_timing_spin(const pipeline::SenderSlotMetrics& m) {
+    return ns_to_sec(m.timing.total_spin_time);
+}
+
+double send_frame_overruns(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.frame_overruns;
+}
+
+double send_speed_ratio(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.profiler.speed_ratio;
+}
+
+double send_profiled_frames(const pipeline::SenderSlotMetrics& m) {
+    return (double)m.profiler.measured_frames;
+}
+
+const SenderSlotMetric sender_slot_metrics[] = {
+    { "roc_sender_participants", "gauge", "Number of connected receivers",
+      send_participants },
+    { "roc_sender_fec_encoded_blocks_total", "counter", "Number of FEC blocks encoded",
+      send_fec_encoded },
+    { "roc_sender_fec_dropped_blocks_total", "counter",
+      "Number of FEC blocks dropped because encoder was overloaded", send_fec_dropped },
+    { "roc_sender_fec_encoding_lag_seconds", "gauge", "Delay of last FEC encoding",
+      send_fec_encoding_lag },
+    { "roc_sender_paced_packets_total", "counter", "Number of packets sent by pacer",
+      send_paced_packets },
+    { "roc_sender_pacing_delay_seconds", "gauge", "Delay of last packet in pacer",
+      send_pacing_delay },
+    { "roc_sender_nacked_packets_total", "counter",
+      "Number of packets requested by receivers for retransmission",
+      send_nacked_packets },
+    { "roc_sender_retransmitted_packets_total", "counter",
+      "Number of packets retransmitted", send_retransmitted_packets },
+    { "roc_sender_packet_length_seconds", "gauge", "Length of outgoing packets",
+      send_packet_length },
+    { "roc_sender_timing_lateness_seconds", "gauge",
+      "How late timer woke up for last frame", send_timing_lateness },
+    { "roc_sender_timing_max_lateness_seconds", "gauge",
+      "Maximum lateness of timer wake-up", send_timing_max_lateness },
+    { "roc_sender_timing_spin_seconds_total", "counter",
+      "Time spent busy-waiting for frame deadlines", send_timing_spin },
+    { "roc_sender_frame_overruns_total", "counter",
+      "Number of frames which took longer to process than their duration",
+      send_frame_overruns },
+    { "roc_sender_speed_ratio", "gauge",
+      "Processing speed relative to real time, zero if profiling is disabled",
+      send_speed_ratio },
+    { "roc_sender_profiled_frames_total", "counter",
+      "Number of frames measured by profiler", send_profiled_frames },
+};
+
+struct SenderPartyMetric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get)(const pipeline::SenderParticipantMetrics&);
+};
+
+double send_lost_packets(const pipeline::SenderParticipantMetrics& m) {
+    return (double)m.link.lost_packets;
+}
+
+double send_jitter(const pipeline::SenderParticipantMetrics& m) {
+    return ns_to_sec(m.link.jitter);
+}
+
+double send_rtt(const pipeline::SenderParticipantMetrics& m) {
+    return ns_to_sec(m.link.rtt);
+}
+
+double send_niq_latency(const pipeline::SenderParticipantMetrics& m) {
+    return ns_to_sec(m.latency.niq_latency);
+}
+
+double send_e2e_latency(const pipeline::SenderParticipantMetrics& m) {
+    return ns_to_sec(m.latency.e2e_latency);
+}
+
+double send_cpu_ratio(const pipeline::SenderParticipantMetrics& m) {
+    return ns_to_sec(m.cpu_ns_per_sec);
+}
+
+const SenderPartyMetric sender_party_metrics[] = {
+    { "roc_sender_lost_packets", "gauge", "Number of lost packets reported by receiver",
+      send_lost_packets },
+    { "roc_sender_jitter_seconds", "gauge", "Packet jitter reported by receiver",
+      send_jitter },
+    { "roc_sender_rtt_seconds", "gauge", "Estimated round-trip time", send_rtt },
+    { "roc_sender_niq_latency_seconds", "gauge",
+      "Network incoming queue latency reported by receiver", send_niq_latency },
+    { "roc_sender_e2e_latency_seconds", "gauge",
+      "End-to-end latency reported by receiver", send_e2e_latency },
+    { "roc_sender_session_cpu_ratio", "gauge",
+      "Fraction of CPU core spent by pipeline thread on session", send_cpu_ratio },
+};
+
+struct StageQuantile {
+    const char* quantile;
+    core::nanoseconds_t audio::StageMetrics::*value;
+};
+
+const StageQuantile stage_quantiles[] = {
+    { "0.5", &audio::StageMetrics::p50 },
+    { "0.99", &audio::StageMetrics::p99 },
+    { "0.999", &audio::StageMetrics::p999 },
+    { "1", &audio::StageMetrics::max },
+};
+
+struct OccupancyFamily {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get)(const core::OccupancyMetrics&);
+};
+
+double occupancy_current(const core::OccupancyMetrics& m) {
+    return (double)m.occupancy;
+}
+
+double occupancy_max(const core::OccupancyMetrics& m) {
+    return (double)m.max_occupancy;
+}
+
+double occupancy_throughput(const core::OccupancyMetrics& m) {
+    return (double)m.throughput;
+}
+
+const OccupancyFamily occupancy_families[] = {
+    { "roc_receiver_buffer_occupancy", "gauge",
+      "Number of packets or samples buffered in pipeline stage", occupancy_current },
+    { "roc_receiver_buffer_max_occupancy", "gauge",
+      "Maximum number of packets or samples buffered in pipeline stage",
+      occupancy_max },
+    { "roc_receiver_buffer_throughput_total", "counter",
+      "Number of packets or samples passed through pipeline stage",
+      occupancy_throughput },
+};
+
+struct SlotGraphStage {
+    const char* name;
+    core::OccupancyMetrics pipeline::ReceiverSlotGraph::*stage;
+};
+
+const SlotGraphStage slot_graph_stages[] = {
+    { "source_endpoint", &pipeline::ReceiverSlotGraph::source_endpoint },
+    { "repair_endpoint", &pipeline::ReceiverSlotGraph::repair_endpoint },
+    { "control_endpoint", &pipeline::ReceiverSlotGraph::control_endpoint },
+    { "mixer", &pipeline::ReceiverSlotGraph::mixer },
+};
+
+struct SessionGraphStage {
+    const char* name;
+    core::OccupancyMetrics pipeline::ReceiverSessionGraph::*stage;
+};
+
+const SessionGraphStage session_graph_stages[] = {
+    { "source_queue", &pipeline::ReceiverSessionGraph::source_queue },
+    { "repair_queue", &pipeline::ReceiverSessionGraph::repair_queue },
+    { "fec_source_queue", &pipeline::ReceiverSessionGraph::fec_source_queue },
+    { "fec_repair_queue", &pipeline::ReceiverSessionGraph::fec_repair_queue },
+    { "delayed_queue", &pipeline::ReceiverSessionGraph::delayed_queue },
+    { "resampler", &pipeline::ReceiverSessionGraph::resampler },
+};
+
+} // namespace
+
+MetricsExporter::MetricsExporter(Context& context, core::IArena& arena)
+    : context_(context)
+    , arena_(arena)
+    , n_receiver_slots_(0)
+    , n_sender_slots_(0)
+    , backup_source_(NULL)
+    , body_(arena)
+    , cond_(mutex_)
+    , n_active_conns_(0)
+    , stopping_(false)
+    , port_(NULL)
+    , valid_(false) {
+    for (size_t n = 0; n < MaxConnections; n++) {
+        connections_[n] = NULL;
+    }
+
+    for (size_t n = 0; n < MaxConnections; n++) {
+        connections_[n] = new (arena_) Connection(*this, arena_);
+        if (!connections_[n]) {
+            roc_log(LogError, "metrics exporter: can't allocate connection");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+
+    for (size_t n = 0; n < MaxConnections; n++) {
+        if (connections_[n]) {
+            arena_.destroy_object(*connections_[n]);
+        }
+    }
+}
+
+bool MetricsExporter::is_valid() const {
+    return valid_;
+}
+
+bool MetricsExporter::add_receiver_slot(Receiver& receiver,
+                                        Receiver::slot_index_t slot_index) {
+    roc_panic_if(!is_valid());
+    roc_panic_if_msg(port_, "metrics exporter: can't add slot after start()");
+
+    if (n_receiver_slots_ == MaxSlots) {
+        roc_log(LogError, "metrics exporter: can't add receiver slot: too many slots");
+        return false;
+    }
+
+    ReceiverSlot& slot = receiver_slots_[n_receiver_slots_++];
+    slot.receiver = &receiver;
+    slot.index = slot_index;
+    slot.party_count = 0;
+    slot.valid = false;
+
+    return true;
+}
+
+bool MetricsExporter::add_sender_slot(Sender& sender, Sender::slot_index_t slot_index) {
+    roc_panic_if(!is_valid());
+    roc_panic_if_msg(port_, "metrics exporter: can't add slot after start()");
+
+    if (n_sender_slots_ == MaxSlots) {
+        roc_log(LogError, "metrics exporter: can't add sender slot: too many slots");
+        return false;
+    }
+
+    SenderSlot& slot = sender_slots_[n_sender_slots_++];
+    slot.sender = &sender;
+    slot.index = slot_index;
+    slot.party_count = 0;
+    slot.valid = false;
+
+    return true;
+}
+
+void MetricsExporter::add_backup_source(sndio::PrebufferedSource& source) {
+    roc_panic_if(!is_valid());
+    roc_panic_if_msg(port_, "metrics exporter: can't add backup source after start()");
+
+    backup_source_ = &source;
+}
+
+bool MetricsExporter::start(address::SocketAddr& bind_address) {
+    roc_panic_if(!is_valid());
+    roc_panic_if_msg(port_, "metrics exporter: can't call start() twice");
+
+    netio::TcpServerConfig config;
+    config.bind_address = bind_address;
+    config.max_connections = MaxConnections;
+
+    if (!context_.start_runtime()) {
+        roc_log(LogError, "metrics exporter: can't start network thread");
+        return false;
+    }
+
+    netio::NetworkLoop::Tasks::AddTcpServerPort task(config, *this);
+    if (!context_.network_loop().schedule_and_wait(task)) {
+        roc_log(LogError, "metrics exporter: can't bind http server to %s",
+                address::socket_addr_to_str(bind_address).c_str());
+        return false;
+    }
+
+    port_ = task.get_handle();
+    bind_address = config.bind_address;
+
+    roc_log(LogInfo, "metrics exporter: serving metrics on http://%s/metrics",
+            address::socket_addr_to_str(bind_address).c_str());
+
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!port_) {
+        return;
+    }
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        // New connections will be refused from now on.
+        stopping_ = true;
+
+        for (size_t n = 0; n < MaxConnections; n++) {
+            connections_[n]->terminate(netio::Term_Failure);
+        }
+
+        while (n_active_conns_ != 0) {
+            cond_.wait();
+        }
+    }
+
+    netio::NetworkLoop::Tasks::RemovePort task(port_);
+    if (!context_.network_loop().schedule_and_wait(task)) {
+        roc_panic("metrics exporter: can't remove http server port");
+    }
+
+    port_ = NULL;
+}
+
+bool MetricsExporter::format_metrics(core::StringBuilder& b) {
+    core::Mutex::Lock lock(format_mutex_);
+
+    collect_metrics_();
+
+    format_receiver_metrics_(b);
+    format_sender_metrics_(b);
+    format_context_metrics_(b);
+    format_backup_metrics_(b);
+
+    return b.is_ok();
+}
+
+netio::IConnHandler* MetricsExporter::add_connection(netio::IConn& conn) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (stopping_) {
+        return NULL;
+    }
+
+    for (size_t n = 0; n < MaxConnections; n++) {
+        if (!connections_[n]->conn()) {
+            connections_[n]->reset(&conn);
+            n_active_conns_++;
+            return connections_[n];
+        }
+    }
+
+    roc_log(LogError, "metrics exporter: can't accept connection: too many connections");
+    return NULL;
+}
+
+void MetricsExporter::remove_connection(netio::IConnHandler& handler) {
+    core::Mutex::Lock lock(mutex_);
+
+    Connection& connection = static_cast<Connection&>(handler);
+    roc_panic_if(!connection.conn());
+
+    connection.reset(NULL);
+    n_active_conns_--;
+
+    cond_.broadcast();
+}
+
+bool MetricsExporter::build_response_(const char* request, core::StringBuffer& response) {
+    const bool is_get = strncmp(request, "GET ", 4) == 0;
+    const bool is_metrics =
+        strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET / ", 6) == 0;
+
+    core::StringBuilder resp_builder(response);
+
+    if (!is_get || !is_metrics) {
+        resp_builder.append_str(is_get ? "HTTP/1.1 404 Not Found\r\n"
+                                       : "HTTP/1.1 405 Method Not Allowed\r\n");
+        resp_builder.append_str("Content-Length: 0\r\n"
+                                "Connection: close\r\n"
+                                "\r\n");
+        return resp_builder.is_ok();
+    }
+
+    // body_ is used only on network thread
+    core::StringBuilder body_builder(body_);
+
+    if (!format_metrics(body_builder)) {
+        return false;
+    }
+
+    resp_builder.append_str("HTTP/1.1 200 OK\r\n"
+                            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                            "Content-Length: ");
+    resp_builder.append_uint(body_.len(), 10);
+    resp_builder.append_str("\r\n"
+                            "Connection: close\r\n"
+                            "\r\n");
+    resp_builder.append_str(body_.c_str());
+
+    return resp_builder.is_ok();
+}
+
+void MetricsExporter::collect_metrics_() {
+    for (size_t n = 0; n < n_receiver_slots_; n++) {
+        ReceiverSlot& slot = receiver_slots_[n];
+
+        slot.party_count = MaxParticipants;
+        slot.valid = slot.receiver->get_metrics(slot.index, receiver_slot_metrics_cb_,
+                                                &slot, receiver_party_metrics_cb_,
+                                                &slot.party_count, &slot);
+        slot.party_count = std::min(slot.party_count, (size_t)MaxParticipants);
+    }
+
+    for (size_t n = 0; n < n_sender_slots_; n++) {
+        SenderSlot& slot = sender_slots_[n];
+
+        slot.party_count = MaxParticipants;
+        slot.valid = slot.sender->get_metrics(slot.index, sender_slot_metrics_cb_, &slot,
+                                              sender_party_metrics_cb_, &slot.party_count,
+                                              &slot);
+        slot.party_count = std::min(slot.party_count, (size_t)MaxParticipants);
+    }
+
+    context_metrics_ = context_.get_metrics();
+
+    if (backup_source_) {
+        backup_metrics_ = backup_source_->get_metrics();
+    }
+}
+
+void MetricsExporter::format_receiver_metrics_(core::StringBuilder& b) {
+    if (n_receiver_slots_ == 0) {
+        return;
+    }
+
+    char labels[128];
+
+    format_family(b, "roc_receiver_participants", "gauge",
+                  "Number of senders connected to slot");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "slot=\"%lu\"", (unsigned long)slot.index);
+        format_sample(b, "roc_receiver_participants", labels,
+                      (double)slot.slot.num_participants);
+    }
+
+    format_family(b, "roc_receiver_frame_overruns_total", "counter",
+                  "Number of frames which took longer to process than their duration");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "slot=\"%lu\"", (unsigned long)slot.index);
+        format_sample(b, "roc_receiver_frame_overruns_total", labels,
+                      (double)slot.slot.frame_overruns);
+    }
+
+    format_family(
+        b, "roc_receiver_speed_ratio", "gauge",
+        "Processing speed relative to real time, zero if profiling is disabled");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "slot=\"%lu\"", (unsigned long)slot.index);
+        format_sample(b, "roc_receiver_speed_ratio", labels,
+                      (double)slot.slot.profiler.speed_ratio);
+    }
+
+    format_family(b, "roc_receiver_profiled_frames_total", "counter",
+                  "Number of frames measured by profiler");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "slot=\"%lu\"", (unsigned long)slot.index);
+        format_sample(b, "roc_receiver_profiled_frames_total", labels,
+                      (double)slot.slot.profiler.measured_frames);
+    }
+
+    for (size_t n_met = 0; n_met < ROC_ARRAY_SIZE(receiver_party_metrics); n_met++) {
+        const ReceiverPartyMetric& metric = receiver_party_metrics[n_met];
+
+        format_family(b, metric.name, metric.type, metric.help);
+
+        for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+            const ReceiverSlot& slot = receiver_slots_[n_slot];
+            if (!slot.valid) {
+                continue;
+            }
+
+            for (size_t n_party = 0; n_party < slot.party_count; n_party++) {
+                snprintf(labels, sizeof(labels), "slot=\"%lu\",participant=\"%lu\"",
+                         (unsigned long)slot.index, (unsigned long)n_party);
+                format_sample(b, metric.name, labels, metric.get(slot.party[n_party]));
+            }
+        }
+    }
+
+    format_family(b, "roc_receiver_stage_frames_total", "counter",
+                  "Number of frames processed by pipeline stage");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        for (size_t n_st = 0; n_st < audio::ProfilerStage_Max; n_st++) {
+            const audio::StageMetrics& stage = slot.slot.stages.stages[n_st];
+            if (stage.frames == 0) {
+                continue;
+            }
+
+            snprintf(labels, sizeof(labels), "slot=\"%lu\",stage=\"%s\"",
+                     (unsigned long)slot.index,
+                     audio::profiler_stage_to_str((audio::ProfilerStage)n_st));
+            format_sample(b, "roc_receiver_stage_frames_total", labels,
+                          (double)stage.frames);
+        }
+    }
+
+    format_family(b, "roc_receiver_stage_duration_seconds", "gauge",
+                  "Distribution of per-frame processing time of pipeline stage");
+
+    for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+        const ReceiverSlot& slot = receiver_slots_[n_slot];
+        if (!slot.valid) {
+            continue;
+        }
+
+        for (size_t n_st = 0; n_st < audio::ProfilerStage_Max; n_st++) {
+            const audio::StageMetrics& stage = slot.slot.stages.stages[n_st];
+            if (stage.frames == 0) {
+                continue;
+            }
+
+            for (size_t n_q = 0; n_q < ROC_ARRAY_SIZE(stage_quantiles); n_q++) {
+                snprintf(labels, sizeof(labels),
+                         "slot=\"%lu\",stage=\"%s\",quantile=\"%s\"",
+                         (unsigned long)slot.index,
+                         audio::profiler_stage_to_str((audio::ProfilerStage)n_st),
+                         stage_quantiles[n_q].quantile);
+                format_sample(b, "roc_receiver_stage_duration_seconds", labels,
+                              ns_to_sec(stage.*stage_quantiles[n_q].value));
+            }
+        }
+    }
+
+    for (size_t n_fam = 0; n_fam < ROC_ARRAY_SIZE(occupancy_families); n_fam++) {
+        const OccupancyFamily& family = occupancy_families[n_fam];
+
+        format_family(b, family.name, family.type, family.help);
+
+        for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+            const ReceiverSlot& slot = receiver_slots_[n_slot];
+            if (!slot.valid) {
+                continue;
+            }
+
+            for (size_t n_st = 0; n_st < ROC_ARRAY_SIZE(slot_graph_stages); n_st++) {
+                snprintf(labels, sizeof(labels), "slot=\"%lu\",stage=\"%s\"",
+                         (unsigned long)slot.index, slot_graph_stages[n_st].name);
+                format_sample(b, family.name, labels,
+                              family.get(slot.slot.graph.*slot_graph_stages[n_st].stage));
+            }
+
+            for (size_t n_party = 0; n_party < slot.party_count; n_party++) {
+                const pipeline::ReceiverSessionGraph& graph = slot.party[n_party].graph;
+
+                for (size_t n_st = 0; n_st < ROC_ARRAY_SIZE(session_graph_stages);
+                     n_st++) {
+                    snprintf(labels, sizeof(labels),
+                             "slot=\"%lu\",participant=\"%lu\",stage=\"%s\"",
+                             (unsigned long)slot.index, (unsigned long)n_party,
+                             session_graph_stages[n_st].name);
+                    format_sample(b, family.name, labels,
+                                  family.get(graph.*session_graph_stages[n_st].stage));
+                }
+            }
+        }
+    }
+
+    for (size_t n_fam = 0; n_fam < ROC_ARRAY_SIZE(memory_families); n_fam++) {
+        const MemoryFamily& family = memory_families[n_fam];
+
+        format_family(b, family.receiver_name, "gauge", family.receiver_help);
+
+        for (size_t n_slot = 0; n_slot < n_receiver_slots_; n_slot++) {
+            const ReceiverSlot& slot = receiver_slots_[n_slot];
+            if (!slot.valid) {
+                continue;
+            }
+
+            for (size_t n_party = 0; n_party < slot.party_count; n_party++) {
+                const core::MemoryUsage& memory = slot.party[n_party].memory;
+
+                for (size_t n_tag = 0; n_tag < core::MemoryTag_Max; n_tag++) {
+                    snprintf(labels, sizeof(labels),
+                             "slot=\"%lu\",participant=\"%lu\",tag=\"%s\"",
+                             (unsigned long)slot.index, (unsigned long)n_party,
+                             core::memory_tag_to_str((core::MemoryTag)n_tag));
+                    format_sample(b, family.receiver_name, labels,
+                                  (double)(memory.*family.bytes)[n_tag]);
+                }
+            }
+        }
+    }
+}
+
+void MetricsExporter::format_sender_metrics_(core::StringBuilder& b) {
+    if (n_sender_slots_ == 0) {
+        return;
+    }
+
+    char labels[128];
+
+    for (size_t n_met = 0; n_met < ROC_ARRAY_SIZE(sender_slot_metrics); n_met++) {
+        const SenderSlotMetric& metric = sender_slot_metrics[n_met];
+
+        format_family(b, metric.name, metric.type, metric.help);
+
+        for (size_t n_slot = 0; n_slot < n_sender_slots_; n_slot++) {
+            const SenderSlot& slot = sender_slots_[n_slot];
+            if (!slot.valid) {
+                continue;
+            }
+
+            snprintf(labels, sizeof(labels), "slot=\"%lu\"", (unsigned long)slot.index);
+            format_sample(b, metric.name, labels, metric.get(slot.slot));
+        }
+    }
+
+    for (size_t n_met = 0; n_met < ROC_ARRAY_SIZE(sender_party_metrics); n_met++) {
+        const SenderPartyMetric& metric = sender_party_metrics[n_met];
+
+        format_family(b, metric.name, metric.type, metric.help);
+
+        for (size_t n_slot = 0; n_slot < n_sender_slots_; n_slot++) {
+            const SenderSlot& slot = sender_slots_[n_slot];
+            if (!slot.valid) {
+                continue;
+            }
+
+            for (size_t n_party = 0; n_party < slot.party_count; n_party++) {
+                snprintf(labels, sizeof(labels), "slot=\"%lu\",participant=\"%lu\"",
+                         (unsigned long)slot.index, (unsigned long)n_party);
+                format_sample(b, metric.name, labels, metric.get(slot.party[n_party]));
+            }
+        }
+    }
+}
+
+void MetricsExporter::format_context_metrics_(core::StringBuilder& b) {
+    const char* pool_names[] = { "pool=\"packet\"", "pool=\"packet_buffer\"",
+                                 "pool=\"small_packet_buffer\"",
+                                 "pool=\"medium_packet_buffer\"",
+                                 "pool=\"frame_buffer\"",
+                                 "pool=\"small_frame_buffer\"",
+                                 "pool=\"medium_frame_buffer\"" };
+    const PoolMetrics* pools[] = { &context_metrics_.packet_pool,
+                                   &context_metrics_.packet_buffer_pool,
+                                   &context_metrics_.small_packet_buffer_pool,
+                                   &context_metrics_.medium_packet_buffer_pool,
+                                   &context_metrics_.frame_buffer_pool,
+                                   &context_metrics_.small_frame_buffer_pool,
+                                   &context_metrics_.medium_frame_buffer_pool };
+
+    format_family(b, "roc_pool_used_objects", "gauge",
+                  "Number of objects allocated from memory pool");
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pools); n++) {
+        format_sample(b, "roc_pool_used_objects", pool_names[n],
+                      (double)pools[n]->used_objects);
+    }
+
+    format_family(b, "roc_pool_grow_events_total", "counter",
+                  "Number of times memory pool allocated new memory on demand");
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pools); n++) {
+        format_sample(b, "roc_pool_grow_events_total", pool_names[n],
+                      (double)pools[n]->grow_events);
+    }
+
+    format_family(b, "roc_pool_shrink_events_total", "counter",
+                  "Number of times memory pool released idle memory");
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pools); n++) {
+        format_sample(b, "roc_pool_shrink_events_total", pool_names[n],
+                      (double)pools[n]->shrink_events);
+    }
+
+    format_family(b, "roc_pool_exhausted_total", "counter",
+                  "Number of allocations failed because memory pool was exhausted");
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pools); n++) {
+        format_sample(b, "roc_pool_exhausted_total", pool_names[n],
+                      (double)pools[n]->exhausted);
+    }
+
+    char labels[64];
+
+    for (size_t n_fam = 0; n_fam < ROC_ARRAY_SIZE(memory_families); n_fam++) {
+        const MemoryFamily& family = memory_families[n_fam];
+
+        format_family(b, family.context_name, "gauge", family.context_help);
+
+        for (size_t n_tag = 0; n_tag < core::MemoryTag_Max; n_tag++) {
+            snprintf(labels, sizeof(labels), "tag=\"%s\"",
+                     core::memory_tag_to_str((core::MemoryTag)n_tag));
+            format_sample(b, family.context_name, labels,
+                          (double)(context_metrics_.memory.*family.bytes)[n_tag]);
+        }
+    }
+
+    format_family(b, "roc_page_faults_total", "counter",
+                  "Number of page faults of process since context was created,"
+                  " counted in realtime mode");
+    format_sample(b, "roc_page_faults_total", "type=\"minor\"",
+                  (double)context_metrics_.minor_page_faults);
+    format_sample(b, "roc_page_faults_total", "type=\"major\"",
+                  (double)context_metrics_.major_page_faults);
+}
+
+void MetricsExporter::format_backup_metrics_(core::StringBuilder& b) {
+    if (!backup_source_) {
+        return;
+    }
+
+    format_family(b, "roc_backup_switches_total", "counter",
+                  "Number of times playback switched to backup source");
+    format_sample(b, "roc_backup_switches_total", "",
+                  (double)backup_metrics_.switch_count);
+
+    format_family(b, "roc_backup_switch_seconds", "gauge",
+                  "Time from switching to backup source until its first frame");
+    format_sample(b, "roc_backup_switch_seconds", "stat=\"last\"",
+                  ns_to_sec(backup_metrics_.last_switch_time));
+    format_sample(b, "roc_backup_switch_seconds", "stat=\"max\"",
+                  ns_to_sec(backup_metrics_.max_switch_time));
+
+    format_family(b, "roc_backup_underruns_total", "counter",
+                  "Number of times backup playback waited for decoding");
+    format_sample(b, "roc_backup_underruns_total", "",
+                  (double)backup_metrics_.underrun_count);
+}
+
+void MetricsExporter::receiver_slot_metrics_cb_(
+    const pipeline::ReceiverSlotMetrics& metrics, void* arg) {
+    ((ReceiverSlot*)arg)->slot = metrics;
+}
+
+void MetricsExporter::receiver_party_metrics_cb_(
+    const pipeline::ReceiverParticipantMetrics& metrics, size_t index, void* arg) {
+    if (index < MaxParticipants) {
+        ((ReceiverSlot*)arg)->party[index] = metrics;
+    }
+}
+
+void MetricsExporter::sender_slot_metrics_cb_(const pipeline::SenderSlotMetrics& metrics,
+                                              void* arg) {
+    ((SenderSlot*)arg)->slot = metrics;
+}
+
+void MetricsExporter::sender_party_metrics_cb_(
+    const pipeline::SenderParticipantMetrics& metrics, size_t index, void* arg) {
+    if (index < MaxParticipants) {
+        ((SenderSlot*)arg)->party[index] = metrics;
+    }
+}
+
+MetricsExporter::Connection::Connection(MetricsExporter& exporter, core::IArena& arena)
+    : exporter_(exporter)
+    , conn_(NULL)
+    , state_(State_Free)
+    , request_size_(0)
+    , response_(arena)
+    , response_pos_(0) {
+    request_[0] = '\0';
+}
+
+void MetricsExporter::Connection::reset(netio::IConn* conn) {
+    conn_ = conn;
+    state_ = conn ? State_Reading : State_Free;
+
+    request_size_ = 0;
+    request_[0] = '\0';
+
+    response_.clear();
+    response_pos_ = 0;
+}
+
+netio::IConn* MetricsExporter::Connection::conn() const {
+    return conn_;
+}
+
+void MetricsExporter::Connection::connection_refused(netio::IConn&) {
+    roc_panic("metrics exporter: unexpected connection_refused() on server side");
+}
+
+void MetricsExporter::Connection::connection_established(netio::IConn&) {
+}
+
+void MetricsExporter::Connection::terminate(netio::TerminationMode mode) {
+    if (!conn_ || state_ == State_Closing) {
+        return;
+    }
+
+    // IConn methods are thread-safe.
+    state_ = State_Closing;
+    conn_->async_terminate(mode);
+}
+
+void MetricsExporter::Connection::connection_writable(netio::IConn& conn) {
+    core::Mutex::Lock lock(exporter_.mutex_);
+
+    if (state_ != State_Writing) {
+        return;
+    }
+
+    write_response_(conn);
+}
+
+void MetricsExporter::Connection::connection_readable(netio::IConn& conn) {
+    core::Mutex::Lock lock(exporter_.mutex_);
+
+    if (state_ != State_Reading) {
+        return;
+    }
+
+    for (;;) {
+        if (request_size_ == MaxRequestSize) {
+            roc_log(LogDebug, "metrics exporter: request too large: remote_address=%s",
+                    address::socket_addr_to_str(conn.remote_address()).c_str());
+            terminate(netio::Term_Failure);
+            return;
+        }
+
+        const ssize_t n_read =
+            conn.try_read(request_ + request_size_, MaxRequestSize - request_size_);
+
+        if (n_read == netio::SockErr_WouldBlock || n_read == 0) {
+            return;
+        }
+
+        if (n_read < 0) {
+            terminate(netio::Term_Failure);
+            return;
+        }
+
+        request_size_ += (size_t)n_read;
+        request_[request_size_] = '\0';
+
+        if (strstr(request_, "\r\n\r\n") || strstr(request_, "\n\n")) {
+            break;
+        }
+    }
+
+    if (!exporter_.build_response_(request_, response_)) {
+        roc_log(LogError, "metrics exporter: can't build response");
+        terminate(netio::Term_Failure);
+        return;
+    }
+
+    state_ = State_Writing;
+    write_response_(conn);
+}
+
+void MetricsExporter::Connection::connection_terminated(netio::IConn&) {
+}
+
+void MetricsExporter::Connection::write_response_(netio::IConn& conn) {
+    while (response_pos_ < response_.len()) {
+        const ssize_t n_written = conn.try_write(response_.c_str() + response_pos_,
+                                                 response_.len() - response_pos_);
+
+        if (n_written == netio::SockErr_WouldBlock || n_written == 0) {
+            return;
+        }
+
+        if (n_written < 0) {
+            terminate(netio::Term_Failure);
+            return;
+        }
+
+        response_pos_ += (size_t)n_written;
+    }
+
+    terminate(netio::Term_Normal);
+}
+
+} // namespace node
+} // namespace roc
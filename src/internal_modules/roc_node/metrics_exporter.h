@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/metrics_exporter.h
+//! @brief Metrics exporter.
+
+#ifndef ROC_NODE_METRICS_EXPORTER_H_
+#define ROC_NODE_METRICS_EXPORTER_H_
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/attributes.h"
+#include "roc_core/cond.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/string_buffer.h"
+#include "roc_core/string_builder.h"
+#include "roc_netio/iconn_acceptor.h"
+#include "roc_netio/network_loop.h"
+#include "roc_node/context.h"
+#include "roc_node/receiver.h"
+#include "roc_node/sender.h"
+#include "roc_pipeline/metrics_snapshot.h"
+#include "roc_sndio/prebuffered_source.h"
+
+namespace roc {
+namespace node {
+
+//! Metrics exporter.
+//!
+//! @remarks
+//!  Runs HTTP server on network loop of the context and serves metrics of the
+//!  context and of registered sender and receiver slots in Prometheus text
+//!  exposition format (version 0.0.4), which is also accepted by OpenMetrics
+//!  scrapers. Any GET request for "/" or "/metrics" is answered with metrics,
+//!  other requests get 404.
+//!
+//! @remarks
+//!  Metrics are collected on network thread when request is received. Slot
+//!  metrics are read from the lock-free snapshots published by pipeline, so
+//!  scraping does not block or delay audio processing.
+class MetricsExporter : private netio::IConnAcceptor, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    MetricsExporter(Context& context, core::IArena& arena);
+
+    //! Deinitialize.
+    //! @remarks
+    //!  Stops server if it's running.
+    ~MetricsExporter();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Export metrics of receiver slot.
+    //! @remarks
+    //!  Should be called before start().
+    ROC_ATTR_NODISCARD bool add_receiver_slot(Receiver& receiver,
+                                              Receiver::slot_index_t slot_index);
+
+    //! Export metrics of sender slot.
+    //! @remarks
+    //!  Should be called before start().
+    ROC_ATTR_NODISCARD bool add_sender_slot(Sender& sender,
+                                            Sender::slot_index_t slot_index);
+
+    //! Export metrics of prebuffered backup source.
+    //! @remarks
+    //!  Should be called before start().
+    void add_backup_source(sndio::PrebufferedSource& source);
+
+    //! Start HTTP server.
+    //! @remarks
+    //!  If port of @p bind_address is zero, selects random port and
+    //!  updates @p bind_address.
+    ROC_ATTR_NODISCARD bool start(address::SocketAddr& bind_address);
+
+    //! Stop HTTP server.
+    //! @remarks
+    //!  Terminates active connections and waits until server is closed.
+    void stop();
+
+    //! Format current metrics.
+    //! @remarks
+    //!  Writes the same text as served over HTTP.
+    //!  Can be called from any thread.
+    ROC_ATTR_NODISCARD bool format_metrics(core::StringBuilder& builder);
+
+private:
+    enum {
+        // Maximum number of exported slots.
+        MaxSlots = 16,
+
+        // Maximum number of exported participants per slot.
+        MaxParticipants = pipeline::ReceiverMetricsSnapshot::MaxParticipants,
+
+        // Maximum number of simultaneous HTTP connections.
+        MaxConnections = 4,
+
+        // Maximum size of HTTP request head.
+        MaxRequestSize = 2048
+    };
+
+    struct ReceiverSlot {
+        Receiver* receiver;
+        Receiver::slot_index_t index;
+        pipeline::ReceiverSlotMetrics slot;
+        pipeline::ReceiverParticipantMetrics party[MaxParticipants];
+        size_t party_count;
+        bool valid;
+    };
+
+    struct SenderSlot {
+        Sender* sender;
+        Sender::slot_index_t index;
+        pipeline::SenderSlotMetrics slot;
+        pipeline::SenderParticipantMetrics party[MaxParticipants];
+        size_t party_count;
+        bool valid;
+    };
+
+    // HTTP connection.
+    class Connection : public netio::IConnHandler {
+    public:
+        Connection(MetricsExporter& exporter, core::IArena& arena);
+
+        // These methods should be called with exporter mutex locked.
+        void reset(netio::IConn* conn);
+        netio::IConn* conn() const;
+        void terminate(netio::TerminationMode mode);
+
+    private:
+        enum State { State_Free, State_Reading, State_Writing, State_Closing };
+
+        virtual void connection_refused(netio::IConn& conn);
+        virtual void connection_established(netio::IConn& conn);
+        virtual void connection_writable(netio::IConn& conn);
+        virtual void connection_readable(netio::IConn& conn);
+        virtual void connection_terminated(netio::IConn& conn);
+
+        void write_response_(netio::IConn& conn);
+
+        MetricsExporter& exporter_;
+
+        netio::IConn* conn_;
+        State state_;
+
+        char request_[MaxRequestSize + 1];
+        size_t request_size_;
+
+        core::StringBuffer response_;
+        size_t response_pos_;
+    };
+
+    // Methods of netio::IConnAcceptor
+    virtual netio::IConnHandler* add_connection(netio::IConn& conn);
+    virtual void remove_connection(netio::IConnHandler& handler);
+
+    bool build_response_(const char* request, core::StringBuffer& response);
+
+    void collect_metrics_();
+    void format_receiver_metrics_(core::StringBuilder& b);
+    void format_sender_metrics_(core::StringBuilder& b);
+    void format_context_metrics_(core::StringBuilder& b);
+    void format_backup_metrics_(core::StringBuilder& b);
+
+    static void receiver_slot_metrics_cb_(const pipeline::ReceiverSlotMetrics& metrics,
+                                          void* arg);
+    static void
+    receiver_party_metrics_cb_(const pipeline::ReceiverParticipantMetrics& metrics,
+                               size_t index,
+                               void* arg);
+    static void sender_slot_metrics_cb_(const pipeline::SenderSlotMetrics& metrics,
+                                        void* arg);
+    static void
+    sender_party_metrics_cb_(const pipeline::SenderParticipantMetrics& metrics,
+                             size_t index,
+                             void* arg);
+
+    Context& context_;
+    core::IArena& arena_;
+
+    ReceiverSlot receiver_slots_[MaxSlots];
+    size_t n_receiver_slots_;
+
+    SenderSlot sender_slots_[MaxSlots];
+    size_t n_sender_slots_;
+
+    ContextMetrics context_metrics_;
+
+    sndio::PrebufferedSource* backup_source_;
+    sndio::PrebufferedSourceMetrics backup_metrics_;
+
+    core::Mutex format_mutex_;
+
+    core::StringBuffer body_;
+
+    Connection* connections_[MaxConnections];
+
+    core::Mutex mutex_;
+    core::Cond cond_;
+    size_t n_active_conns_;
+    bool stopping_;
+
+    netio::NetworkLoop::PortHandle port_;
+
+    bool valid_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_METRICS_EXPORTER_H_
@@ -13,6 +13,12 @@ namespace node {
 
 Node::Node(Context& context)
     : context_(&context) {
+    if (context.node_memory_limit() != 0) {
+        pools_.reset(new (pools_) NodePools(
+            context.pool_arena(), context.node_memory_limit(),
+            context.packet_buffer_pool().object_size(),
+            context.frame_buffer_pool().object_size()));
+    }
 }
 
 Node::~Node() {
@@ -22,5 +28,25 @@ Context& Node::context() {
     return *context_;
 }
 
+core::IPool& Node::packet_pool() {
+    return pools_ ? pools_->packet_pool() : context_->packet_pool();
+}
+
+core::IPool& Node::packet_buffer_pool() {
+    return pools_ ? pools_->packet_buffer_pool() : context_->packet_buffer_pool();
+}
+
+core::IPool& Node::frame_buffer_pool() {
+    return pools_ ? pools_->frame_buffer_pool() : context_->frame_buffer_pool();
+}
+
+packet::PacketFactory& Node::packet_factory() {
+    return pools_ ? pools_->packet_factory() : context_->packet_factory();
+}
+
+size_t Node::pools_allocated_bytes() {
+    return pools_ ? pools_->num_allocated_bytes() : 0;
+}
+
 } // namespace node
 } // namespace roc
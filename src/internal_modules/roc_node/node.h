@@ -13,13 +13,18 @@
 #define ROC_NODE_NODE_H_
 
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/shared_ptr.h"
 #include "roc_node/context.h"
+#include "roc_node/node_pools.h"
 
 namespace roc {
 namespace node {
 
 //! Base class for nodes.
+//! @remarks
+//!  If ContextConfig::node_memory_limit is set, node has its own pools, and
+//!  pool getters return them. Otherwise they return pools of context.
 class Node : public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -31,8 +36,37 @@ public:
     //! All nodes hold reference to context.
     Context& context();
 
+    //! Get packet pool of node.
+    core::IPool& packet_pool();
+
+    //! Get packet buffer pool of node.
+    core::IPool& packet_buffer_pool();
+
+    //! Get frame buffer pool of node.
+    core::IPool& frame_buffer_pool();
+
+    //! Get packet factory of node.
+    //! @remarks
+    //!  Should be passed to tasks adding ports of node.
+    packet::PacketFactory& packet_factory();
+
+    //! Add pools for smaller frame buffers to pipeline.
+    //! @remarks
+    //!  Nodes with own pools don't use size classes.
+    template <class Pipeline> void add_small_frame_buffer_pools(Pipeline& pipeline) {
+        if (!pools_) {
+            context_->add_small_frame_buffer_pools(pipeline);
+        }
+    }
+
+    //! Get number of bytes allocated by own pools of node.
+    //! @remarks
+    //!  Zero if node uses pools of context.
+    size_t pools_allocated_bytes();
+
 private:
     core::SharedPtr<Context> context_;
+    core::Optional<NodePools> pools_;
 };
 
 } // namespace node
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/node_pools.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+// Maximum size of slab allocated by node pool.
+// Slabs grow exponentially, and slab larger than remaining quota would fail
+// to allocate even if quota is not exhausted yet.
+const size_t MaxSlabSize = 64 * 1024;
+
+} // namespace
+
+NodePools::NodePools(core::IArena& arena,
+                     size_t max_bytes,
+                     size_t packet_buffer_size,
+                     size_t frame_buffer_size)
+    : memory_limiter_("node_pools", max_bytes)
+    , arena_(arena, memory_limiter_)
+    , packet_pool_("node_packet_pool",
+                   arena_,
+                   sizeof(packet::Packet),
+                   0,
+                   MaxSlabSize,
+                   core::SlabPool_DefaultGuards,
+                   true)
+    , packet_buffer_pool_("node_packet_buffer_pool",
+                          arena_,
+                          packet_buffer_size,
+                          0,
+                          MaxSlabSize,
+                          core::SlabPool_DefaultGuards,
+                          true)
+    , frame_buffer_pool_("node_frame_buffer_pool",
+                         arena_,
+                         frame_buffer_size,
+                         0,
+                         MaxSlabSize,
+                         core::SlabPool_DefaultGuards,
+                         true)
+    , packet_factory_(packet_pool_, packet_buffer_pool_) {
+    roc_log(LogDebug, "node pools: initializing: max_bytes=%lu",
+            (unsigned long)max_bytes);
+}
+
+core::IPool& NodePools::packet_pool() {
+    return packet_pool_;
+}
+
+core::IPool& NodePools::packet_buffer_pool() {
+    return packet_buffer_pool_;
+}
+
+core::IPool& NodePools::frame_buffer_pool() {
+    return frame_buffer_pool_;
+}
+
+packet::PacketFactory& NodePools::packet_factory() {
+    return packet_factory_;
+}
+
+size_t NodePools::num_allocated_bytes() {
+    return memory_limiter_.num_acquired();
+}
+
+} // namespace node
+} // namespace roc
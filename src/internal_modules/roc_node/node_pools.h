@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/node_pools.h
+//! @brief Pools owned by node.
+
+#ifndef ROC_NODE_NODE_POOLS_H_
+#define ROC_NODE_NODE_POOLS_H_
+
+#include "roc_core/buffer.h"
+#include "roc_core/iarena.h"
+#include "roc_core/limited_arena.h"
+#include "roc_core/memory_limiter.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace node {
+
+//! Pools owned by node.
+//! @remarks
+//!  Packet and frame pools of a single sender or receiver. Pools allocate
+//!  slabs from context arena via memory limiter, so memory used by node is
+//!  limited by its own quota, and pools don't share free lists and locks
+//!  with other nodes.
+class NodePools : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p arena is used to allocate slabs.
+    //!  @p max_bytes defines quota for all pools together, zero means no limit.
+    NodePools(core::IArena& arena,
+              size_t max_bytes,
+              size_t packet_buffer_size,
+              size_t frame_buffer_size);
+
+    //! Get packet pool.
+    core::IPool& packet_pool();
+
+    //! Get packet buffer pool.
+    core::IPool& packet_buffer_pool();
+
+    //! Get frame buffer pool.
+    core::IPool& frame_buffer_pool();
+
+    //! Get packet factory using packet and packet buffer pools.
+    packet::PacketFactory& packet_factory();
+
+    //! Get number of bytes currently allocated by pools.
+    size_t num_allocated_bytes();
+
+private:
+    core::MemoryLimiter memory_limiter_;
+    core::LimitedArena arena_;
+
+    core::SlabPool<packet::Packet> packet_pool_;
+    core::SlabPool<core::Buffer> packet_buffer_pool_;
+    core::SlabPool<core::Buffer> frame_buffer_pool_;
+
+    packet::PacketFactory packet_factory_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_NODE_POOLS_H_
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/pipeline_pool.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+// If job falls behind its schedule by more than this number of frames,
+// it skips the backlog instead of trying to catch up.
+const int MaxLateFrames = 10;
+
+} // namespace
+
+PipelineJob::PipelineJob(sndio::ISource& source,
+                         sndio::ISink* sink,
+                         core::nanoseconds_t frame_length,
+                         core::IPool& frame_buffer_pool)
+    : ControlTask(&PipelinePool::process_job_)
+    , source_(source)
+    , sink_(sink)
+    , sample_spec_(source.sample_spec())
+    , frame_length_(frame_length)
+    , frame_factory_(frame_buffer_pool)
+    , next_deadline_(0)
+    , eof_(false)
+    , worker_(0)
+    , load_(0)
+    , n_frames_(0)
+    , attached_(false)
+    , finished_(false)
+    , stopping_(false)
+    , valid_(false) {
+    roc_panic_if_msg(frame_length <= 0, "pipeline job: frame length should be positive");
+
+    if (sink_) {
+        const audio::SampleSpec sink_spec = sink_->sample_spec();
+
+        if (sink_spec.sample_rate() != sample_spec_.sample_rate()
+            || sink_spec.num_channels() != sample_spec_.num_channels()) {
+            roc_log(LogError,
+                    "pipeline job: source and sink have different sample specs:"
+                    " source_rate=%lu source_chans=%lu sink_rate=%lu sink_chans=%lu",
+                    (unsigned long)sample_spec_.sample_rate(),
+                    (unsigned long)sample_spec_.num_channels(),
+                    (unsigned long)sink_spec.sample_rate(),
+                    (unsigned long)sink_spec.num_channels());
+            return;
+        }
+    }
+
+    const size_t frame_size = sample_spec_.ns_2_samples_overall(frame_length_);
+    if (frame_size == 0) {
+        roc_log(LogError, "pipeline job: frame size can't be zero");
+        return;
+    }
+
+    if (frame_factory_.raw_buffer_size() < frame_size) {
+        roc_log(LogError,
+                "pipeline job: buffer size is too small: required=%lu actual=%lu",
+                (unsigned long)frame_size,
+                (unsigned long)frame_factory_.raw_buffer_size());
+        return;
+    }
+
+    frame_buffer_ = frame_factory_.new_raw_buffer();
+    if (!frame_buffer_) {
+        roc_log(LogError, "pipeline job: can't allocate frame buffer");
+        return;
+    }
+
+    frame_buffer_.reslice(0, frame_size);
+
+    valid_ = true;
+}
+
+bool PipelineJob::is_valid() const {
+    return valid_;
+}
+
+bool PipelineJob::finished() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return finished_;
+}
+
+size_t PipelineJob::num_frames() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return n_frames_;
+}
+
+core::nanoseconds_t PipelineJob::cpu_ns_per_sec() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return load_;
+}
+
+bool PipelineJob::transfer_frame_() {
+    audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
+
+    if (!source_.read(frame)) {
+        return false;
+    }
+
+    if (!frame.has_duration()) {
+        frame.set_duration(sample_spec_.bytes_2_stream_timestamp(frame.num_bytes()));
+    }
+
+    if (frame.capture_timestamp() == 0) {
+        frame.set_capture_timestamp(core::timestamp(core::ClockMedia));
+    }
+
+    core::nanoseconds_t playback_latency = 0;
+
+    if (sink_) {
+        sink_->write(frame);
+
+        if (sink_->has_latency()) {
+            playback_latency =
+                sink_->latency() - sample_spec_.stream_timestamp_2_ns(frame.duration());
+        }
+    }
+
+    source_.reclock(core::timestamp(core::ClockMedia) + playback_latency);
+
+    return true;
+}
+
+PipelinePool::PipelinePool(size_t num_threads,
+                           const core::ThreadConfig& thread_config,
+                           core::IArena& arena)
+    : arena_(arena)
+    , workers_(arena)
+    , valid_(false) {
+    roc_log(LogDebug, "pipeline pool: initializing: num_threads=%lu",
+            (unsigned long)num_threads);
+
+    if (num_threads == 0) {
+        roc_log(LogError, "pipeline pool: number of threads can't be zero");
+        return;
+    }
+
+    if (!workers_.resize(num_threads)) {
+        roc_log(LogError, "pipeline pool: can't allocate workers array");
+        return;
+    }
+
+    for (size_t n = 0; n < num_threads; n++) {
+        workers_[n].queue = new (arena_) ctl::ControlTaskQueue(thread_config);
+        if (!workers_[n].queue) {
+            roc_log(LogError, "pipeline pool: can't allocate task queue");
+            return;
+        }
+
+        if (!workers_[n].queue->is_valid()) {
+            roc_log(LogError, "pipeline pool: can't initialize task queue");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+PipelinePool::~PipelinePool() {
+    roc_log(LogDebug, "pipeline pool: deinitializing");
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        roc_panic_if_msg(workers_[n].n_jobs != 0,
+                         "pipeline pool: attempt to destroy pool with running jobs:"
+                         " thread=%lu n_jobs=%lu",
+                         (unsigned long)n, (unsigned long)workers_[n].n_jobs);
+
+        if (workers_[n].queue) {
+            arena_.destroy_object(*workers_[n].queue);
+        }
+    }
+}
+
+bool PipelinePool::is_valid() const {
+    return valid_;
+}
+
+size_t PipelinePool::num_threads() const {
+    return workers_.size();
+}
+
+core::nanoseconds_t PipelinePool::thread_load(size_t thread_index) const {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if(thread_index >= workers_.size());
+
+    return workers_[thread_index].load;
+}
+
+size_t PipelinePool::thread_jobs(size_t thread_index) const {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if(thread_index >= workers_.size());
+
+    return workers_[thread_index].n_jobs;
+}
+
+bool PipelinePool::add_job(PipelineJob& job) {
+    roc_panic_if(!is_valid());
+
+    if (!job.is_valid()) {
+        roc_log(LogError, "pipeline pool: attempt to add invalid job");
+        return false;
+    }
+
+    core::Mutex::Lock job_lock(job.mutex_);
+
+    roc_panic_if_msg(job.attached_, "pipeline pool: job is already running: ptr=%p",
+                     (void*)&job);
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        job.worker_ = least_loaded_();
+        workers_[job.worker_].n_jobs++;
+    }
+
+    roc_log(LogDebug, "pipeline pool: adding job: ptr=%p thread=%lu", (void*)&job,
+            (unsigned long)job.worker_);
+
+    job.load_ = 0;
+    job.attached_ = true;
+    job.finished_ = false;
+    job.stopping_ = false;
+    job.eof_ = false;
+    job.next_deadline_ = core::timestamp(core::ClockMonotonic);
+
+    workers_[job.worker_].queue->schedule(job, *this, this);
+
+    return true;
+}
+
+void PipelinePool::remove_job(PipelineJob& job) {
+    roc_panic_if(!is_valid());
+
+    {
+        core::Mutex::Lock job_lock(job.mutex_);
+
+        if (!job.attached_) {
+            return;
+        }
+
+        roc_log(LogDebug, "pipeline pool: removing job: ptr=%p thread=%lu", (void*)&job,
+                (unsigned long)job.worker_);
+
+        job.stopping_ = true;
+
+        // If job is sleeping, it's cancelled, otherwise its current
+        // processing finishes normally. In both cases completer will
+        // see stopping_ flag and detach job.
+        workers_[job.worker_].queue->async_cancel(job);
+    }
+
+    job.stopped_sem_.wait();
+}
+
+ctl::ControlTaskResult PipelinePool::process_job_(ctl::ControlTask& task) {
+    PipelineJob& job = (PipelineJob&)task;
+
+    job.cpu_meter_.begin(core::timestamp(core::ClockMonotonic));
+
+    if (!job.transfer_frame_()) {
+        job.eof_ = true;
+    }
+
+    job.cpu_meter_.end(core::timestamp(core::ClockMonotonic));
+
+    return ctl::ControlTaskSuccess;
+}
+
+// Invoked on thread of the queue where job was just processed or cancelled.
+// Job is completed from the point of view of that queue, so we're free to
+// schedule it on the same or another queue.
+void PipelinePool::control_task_completed(ctl::ControlTask& task) {
+    PipelineJob& job = (PipelineJob&)task;
+
+    bool post_stopped = false;
+
+    {
+        core::Mutex::Lock job_lock(job.mutex_);
+
+        if (!task.cancelled() && !job.eof_) {
+            job.n_frames_++;
+        }
+
+        if (job.stopping_ || job.eof_) {
+            if (job.eof_ && !job.stopping_) {
+                roc_log(LogDebug, "pipeline pool: job finished: ptr=%p frames=%lu",
+                        (void*)&job, (unsigned long)job.n_frames_);
+            }
+
+            {
+                core::Mutex::Lock lock(mutex_);
+
+                workers_[job.worker_].load -= job.load_;
+                workers_[job.worker_].n_jobs--;
+            }
+
+            job.finished_ = job.eof_;
+            job.attached_ = false;
+
+            post_stopped = job.stopping_;
+        } else {
+            update_load_(job);
+            reschedule_job_(job);
+        }
+    }
+
+    // Job may be destroyed after this call.
+    if (post_stopped) {
+        job.stopped_sem_.post();
+    }
+}
+
+// Should be called with job mutex locked.
+// After this call, job may be already processed by another thread.
+void PipelinePool::reschedule_job_(PipelineJob& job) {
+    const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+    job.next_deadline_ += job.frame_length_;
+
+    if (job.next_deadline_ < now - job.frame_length_ * MaxLateFrames) {
+        roc_log(LogDebug,
+                "pipeline pool: job is too late, skipping backlog: ptr=%p late=%.3fms",
+                (void*)&job, (double)(now - job.next_deadline_) / core::Millisecond);
+        job.next_deadline_ = now;
+    }
+
+    workers_[job.worker_].queue->schedule_at(job, job.next_deadline_, *this, this);
+}
+
+// Should be called with job mutex locked.
+void PipelinePool::update_load_(PipelineJob& job) {
+    const core::nanoseconds_t new_load = job.cpu_meter_.cpu_ns_per_sec();
+
+    if (new_load == job.load_) {
+        return;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    Worker& curr = workers_[job.worker_];
+
+    curr.load += new_load - job.load_;
+    job.load_ = new_load;
+
+    const size_t target_index = least_loaded_();
+    Worker& target = workers_[target_index];
+
+    // Moving job changes difference between loads by twice its load.
+    // Move only if source thread remains at least as loaded as target,
+    // so that jobs don't bounce back and forth.
+    if (target_index == job.worker_ || curr.load - target.load <= job.load_ * 2) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "pipeline pool: migrating job: ptr=%p load=%lld thread=%lu>%lu"
+            " thread_load=%lld>%lld",
+            (void*)&job, (long long)job.load_, (unsigned long)job.worker_,
+            (unsigned long)target_index, (long long)curr.load, (long long)target.load);
+
+    curr.load -= job.load_;
+    curr.n_jobs--;
+
+    target.load += job.load_;
+    target.n_jobs++;
+
+    job.worker_ = target_index;
+}
+
+// Should be called with pool mutex locked.
+size_t PipelinePool::least_loaded_() const {
+    size_t best = 0;
+
+    for (size_t n = 1; n < workers_.size(); n++) {
+        if (workers_[n].load < workers_[best].load
+            || (workers_[n].load == workers_[best].load
+                && workers_[n].n_jobs < workers_[best].n_jobs)) {
+            best = n;
+        }
+    }
+
+    return best;
+}
+
+} // namespace node
+} // namespace roc
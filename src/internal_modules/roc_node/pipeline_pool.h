@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/pipeline_pool.h
+//! @brief Pool of threads for headless pipelines.
+
+#ifndef ROC_NODE_PIPELINE_POOL_H_
+#define ROC_NODE_PIPELINE_POOL_H_
+
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/cpu_meter.h"
+#include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_ctl/control_task.h"
+#include "roc_ctl/control_task_executor.h"
+#include "roc_ctl/control_task_queue.h"
+#include "roc_ctl/icontrol_task_completer.h"
+#include "roc_sndio/isink.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace node {
+
+class PipelinePool;
+
+//! Headless pipeline job.
+//!
+//! @remarks
+//!  Transfers frames from source to sink on one of the threads of PipelinePool,
+//!  one frame per frame period. Used to drive pipelines whose other end is not
+//!  a realtime device, e.g. receiver source with file sink or without sink, or
+//!  file source with sender sink.
+//!
+//! @remarks
+//!  Neither source nor sink should have a clock, i.e. pipeline timing should be
+//!  disabled, because pool paces frames itself and blocking in read or write
+//!  would stall other jobs of the same thread.
+class PipelineJob : public ctl::ControlTask, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  If @p sink is NULL, frames read from source are discarded.
+    //!  Frame buffer is allocated from @p frame_buffer_pool.
+    PipelineJob(sndio::ISource& source,
+                sndio::ISink* sink,
+                core::nanoseconds_t frame_length,
+                core::IPool& frame_buffer_pool);
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Check if source reached end of stream.
+    //! @remarks
+    //!  After this, job is removed from pool automatically.
+    bool finished() const;
+
+    //! Get number of transferred frames.
+    size_t num_frames() const;
+
+    //! Get time spent in job per second of wall time.
+    //! @remarks
+    //!  Recomputed once per second.
+    core::nanoseconds_t cpu_ns_per_sec() const;
+
+private:
+    friend class PipelinePool;
+
+    bool transfer_frame_();
+
+    sndio::ISource& source_;
+    sndio::ISink* sink_;
+
+    const audio::SampleSpec sample_spec_;
+    const core::nanoseconds_t frame_length_;
+
+    audio::FrameFactory frame_factory_;
+    core::Slice<audio::sample_t> frame_buffer_;
+
+    // used only by thread currently processing job
+    core::CpuMeter cpu_meter_;
+    core::nanoseconds_t next_deadline_;
+    bool eof_;
+
+    // guards fields below
+    mutable core::Mutex mutex_;
+
+    size_t worker_;
+    core::nanoseconds_t load_;
+    size_t n_frames_;
+    bool attached_;
+    bool finished_;
+    bool stopping_;
+
+    core::Semaphore stopped_sem_;
+
+    bool valid_;
+};
+
+//! Pool of threads for headless pipelines.
+//!
+//! @remarks
+//!  Runs PipelineJob objects on a fixed number of threads. Every thread has its
+//!  own control task queue, where jobs sleep until the deadline of their next
+//!  frame, so a single thread can drive many pipelines.
+//!
+//! @remarks
+//!  Every job measures time it spends per second. New jobs are added to the
+//!  thread with the smallest total load. When a job's measurement is updated,
+//!  and moving it to the least loaded thread would reduce imbalance, the job
+//!  migrates there between two frames.
+class PipelinePool : public ctl::ControlTaskExecutor<PipelinePool>,
+                     private ctl::IControlTaskCompleter,
+                     public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Starts @p num_threads threads with given scheduling parameters.
+    PipelinePool(size_t num_threads,
+                 const core::ThreadConfig& thread_config,
+                 core::IArena& arena);
+
+    //! Deinitialize.
+    //! @remarks
+    //!  All jobs should be removed or finished.
+    ~PipelinePool();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Get number of threads.
+    size_t num_threads() const;
+
+    //! Get total load of n-th thread.
+    //! @remarks
+    //!  Sum of cpu_ns_per_sec() of its jobs.
+    core::nanoseconds_t thread_load(size_t thread_index) const;
+
+    //! Get number of jobs on n-th thread.
+    size_t thread_jobs(size_t thread_index) const;
+
+    //! Start running job.
+    //! @remarks
+    //!  First frame is transferred as soon as possible.
+    //!  Job should not be already running.
+    ROC_ATTR_NODISCARD bool add_job(PipelineJob& job);
+
+    //! Stop running job.
+    //! @remarks
+    //!  Blocks until job is not used by pool anymore, after which it can
+    //!  be destroyed. Does nothing if job is not running.
+    void remove_job(PipelineJob& job);
+
+private:
+    friend class PipelineJob;
+
+    struct Worker {
+        ctl::ControlTaskQueue* queue;
+        core::nanoseconds_t load;
+        size_t n_jobs;
+
+        Worker()
+            : queue(NULL)
+            , load(0)
+            , n_jobs(0) {
+        }
+    };
+
+    ctl::ControlTaskResult process_job_(ctl::ControlTask& task);
+
+    virtual void control_task_completed(ctl::ControlTask& task);
+
+    void reschedule_job_(PipelineJob& job);
+    void update_load_(PipelineJob& job);
+    size_t least_loaded_() const;
+
+    core::IArena& arena_;
+
+    core::Array<Worker> workers_;
+    mutable core::Mutex mutex_;
+
+    bool valid_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_PIPELINE_POOL_H_
@@ -18,27 +18,56 @@ namespace node {
 Receiver::Receiver(Context& context,
                    const pipeline::ReceiverSourceConfig& pipeline_config)
     : Node(context)
-    , pipeline_(*this,
-                pipeline_config,
-                context.encoding_map(),
-                context.packet_pool(),
-                context.packet_buffer_pool(),
-                context.frame_buffer_pool(),
-                context.arena())
-    , processing_task_(pipeline_)
+    , num_shards_(std::max(pipeline_config.common.num_shards, (size_t)1))
     , slot_pool_("slot_pool", context.arena())
     , slot_map_(context.arena())
     , party_metrics_(context.arena())
     , valid_(false) {
-    roc_log(LogDebug, "receiver node: initializing");
+    roc_log(LogDebug, "receiver node: initializing: num_shards=%lu",
+            (unsigned long)num_shards_);
 
     memset(used_interfaces_, 0, sizeof(used_interfaces_));
     memset(used_protocols_, 0, sizeof(used_protocols_));
 
-    if (!pipeline_.is_valid()) {
+    if (num_shards_ > MaxShards) {
+        roc_log(LogError, "receiver node: too many shards: num_shards=%lu max=%lu",
+                (unsigned long)num_shards_, (unsigned long)MaxShards);
         return;
     }
 
+    for (size_t n = 0; n < num_shards_; n++) {
+        pipelines_[n].reset(new (pipelines_[n]) pipeline::ReceiverLoop(
+            *this, pipeline_config, context.encoding_map(), packet_pool(),
+            packet_buffer_pool(), frame_buffer_pool(), context.arena(),
+            &context.memory_tracker()));
+        if (!pipelines_[n] || !pipelines_[n]->is_valid()) {
+            return;
+        }
+
+        add_small_frame_buffer_pools(*pipelines_[n]);
+        context.add_packet_capture(*pipelines_[n]);
+
+        processing_tasks_[n].reset(new (processing_tasks_[n])
+                                       ctl::ControlLoop::Tasks::PipelineProcessing(
+                                           *pipelines_[n]));
+    }
+
+    if (num_shards_ > 1) {
+        // Calling thread reads one shard, and workers read others.
+        mixing_source_.reset(new (mixing_source_) sndio::MixingSource(
+            frame_buffer_pool(), pipelines_[0]->source().sample_spec(), num_shards_ - 1,
+            context.arena()));
+        if (!mixing_source_ || !mixing_source_->is_valid()) {
+            return;
+        }
+
+        for (size_t n = 0; n < num_shards_; n++) {
+            if (!mixing_source_->add_input(pipelines_[n]->source())) {
+                return;
+            }
+        }
+    }
+
     valid_ = true;
 }
 
@@ -51,9 +80,14 @@ Receiver::~Receiver() {
         slot_map_.remove(*slot);
     }
 
-    // Then wait until processing task is fully completed, before
-    // proceeding to its destruction.
-    context().control_loop().wait(processing_task_);
+    // Then wait until processing tasks are fully completed, before
+    // proceeding to their destruction. If control thread was never started,
+    // the tasks were never scheduled.
+    for (size_t n = 0; n < num_shards_ && n < MaxShards; n++) {
+        if (processing_tasks_[n] && context().has_runtime()) {
+            context().control_loop().wait_processing(*processing_tasks_[n]);
+        }
+    }
 }
 
 bool Receiver::is_valid() {
@@ -110,13 +144,30 @@ bool Receiver::configure(slot_index_t slot_index,
 bool Receiver::bind(slot_index_t slot_index,
                     address::Interface iface,
                     address::EndpointUri& uri) {
-    core::Mutex::Lock lock(mutex_);
-
     roc_panic_if_not(is_valid());
 
     roc_panic_if(iface < 0);
     roc_panic_if(iface >= (int)address::Iface_Max);
 
+    // Resolve address before locking mutex, because resolving may take long
+    // (e.g. DNS lookup), and we don't want to block other node operations.
+    // Errors are reported below under the mutex.
+    address::SocketAddr resolved_addr;
+    bool resolved = false;
+
+    // Network and control threads are started on first bind or connect.
+    const bool started = context().start_runtime();
+
+    if (started && uri.verify(address::EndpointUri::Subset_Full)) {
+        netio::NetworkLoop::Tasks::ResolveEndpointAddress resolve_task(uri);
+        if (context().network_loop().schedule_and_wait(resolve_task)) {
+            resolved_addr = resolve_task.get_address();
+            resolved = true;
+        }
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
     roc_log(LogInfo, "receiver node: binding %s interface of slot %lu to %s",
             address::interface_to_str(iface), (unsigned long)slot_index,
             address::endpoint_uri_to_str(uri).c_str());
@@ -164,8 +215,17 @@ bool Receiver::bind(slot_index_t slot_index,
 
     address::SocketAddr address;
 
-    netio::NetworkLoop::Tasks::ResolveEndpointAddress resolve_task(uri);
-    if (!context().network_loop().schedule_and_wait(resolve_task)) {
+    if (!started) {
+        roc_log(LogError,
+                "receiver node:"
+                " can't bind %s interface of slot %lu:"
+                " can't start network thread",
+                address::interface_to_str(iface), (unsigned long)slot_index);
+        break_slot_(*slot);
+        return false;
+    }
+
+    if (!resolved) {
         roc_log(LogError,
                 "receiver node:"
                 " can't bind %s interface of slot %lu:"
@@ -175,26 +235,67 @@ bool Receiver::bind(slot_index_t slot_index,
         return false;
     }
 
-    port.config.bind_address = resolve_task.get_address();
+    // Shared memory endpoints bypass sockets and are served by separate port type.
+    const bool use_shm = uri.proto() == address::Proto_RTP_Shm;
 
-    netio::NetworkLoop::Tasks::AddUdpPort port_task(port.config);
-    if (!context().network_loop().schedule_and_wait(port_task)) {
+    // In inline mode, pipeline thread polls socket by itself, so there should
+    // be exactly one pipeline.
+    const bool use_inline = !use_shm && port.config.enable_inline_recv;
+
+    if (use_inline && num_shards_ > 1) {
         roc_log(LogError,
                 "receiver node:"
                 " can't bind %s interface of slot %lu:"
-                " can't bind interface to local port",
+                " inline receiving is not supported with multiple shards",
                 address::interface_to_str(iface), (unsigned long)slot_index);
         break_slot_(*slot);
         return false;
     }
 
-    port.handle = port_task.get_handle();
+    netio::NetworkLoop& port_loop = context().select_network_loop();
+
+    if (use_shm) {
+        port.shm_config.address = resolved_addr;
+
+        netio::NetworkLoop::Tasks::AddShmPort port_task(port.shm_config,
+                                                        &packet_factory());
+        if (!port_loop.schedule_and_wait(port_task)) {
+            roc_log(LogError,
+                    "receiver node:"
+                    " can't bind %s interface of slot %lu:"
+                    " can't open shared memory port",
+                    address::interface_to_str(iface), (unsigned long)slot_index);
+            break_slot_(*slot);
+            return false;
+        }
+
+        port.config.bind_address = resolved_addr;
+        port.handle = port_task.get_handle();
+    } else {
+        port.config.bind_address = resolved_addr;
+
+        netio::NetworkLoop::Tasks::AddUdpPort port_task(port.config, &packet_factory(),
+                                                        context().packet_capture());
+        if (!port_loop.schedule_and_wait(port_task)) {
+            roc_log(LogError,
+                    "receiver node:"
+                    " can't bind %s interface of slot %lu:"
+                    " can't bind interface to local port",
+                    address::interface_to_str(iface), (unsigned long)slot_index);
+            break_slot_(*slot);
+            return false;
+        }
+
+        port.handle = port_task.get_handle();
+    }
+
+    port.loop = &port_loop;
 
     packet::IWriter* outbound_writer = NULL;
 
     if (iface == address::Iface_AudioControl) {
         netio::NetworkLoop::Tasks::StartUdpSend send_task(port.handle);
-        if (!context().network_loop().schedule_and_wait(send_task)) {
+        if (!port.loop->schedule_and_wait(send_task)) {
             roc_log(LogError,
                     "receiver node:"
                     " can't bind %s interface of slot %lu:"
@@ -207,21 +308,71 @@ bool Receiver::bind(slot_index_t slot_index,
         outbound_writer = &send_task.get_outbound_writer();
     }
 
-    pipeline::ReceiverLoop::Tasks::AddEndpoint endpoint_task(
-        slot->handle, iface, uri.proto(), port.config.bind_address, outbound_writer);
-    if (!pipeline_.schedule_and_wait(endpoint_task)) {
-        roc_log(LogError,
-                "receiver node:"
-                " can't bind %s interface of slot %lu:"
-                " can't add endpoint to pipeline",
-                address::interface_to_str(iface), (unsigned long)slot_index);
-        break_slot_(*slot);
-        return false;
+    if (use_inline) {
+        // Start receiving before adding endpoint, which will poll the port.
+        netio::NetworkLoop::Tasks::StartUdpInlineRecv recv_task(port.handle);
+        if (!port.loop->schedule_and_wait(recv_task)) {
+            roc_log(LogError,
+                    "receiver node:"
+                    " can't bind %s interface of slot %lu:"
+                    " can't start receiving on local port",
+                    address::interface_to_str(iface), (unsigned long)slot_index);
+            break_slot_(*slot);
+            return false;
+        }
+
+        port.inbound_reader = &recv_task.get_inbound_reader();
+    }
+
+    // Endpoint is added to every shard. If there are many shards, packets are
+    // distributed between their endpoints by sharder.
+    packet::IWriter* inbound_writer = NULL;
+
+    if (num_shards_ > 1) {
+        port.sharder.reset(new (port.sharder) packet::AddressSharder(context().arena()));
+    }
+
+    for (size_t n = 0; n < num_shards_; n++) {
+        pipeline::ReceiverLoop::Tasks::AddEndpoint endpoint_task(
+            slot->handles[n], iface, uri.proto(), port.config.bind_address,
+            outbound_writer);
+        if (port.inbound_reader) {
+            endpoint_task.set_inbound_reader(*port.inbound_reader);
+        }
+        if (!pipelines_[n]->schedule_and_wait(endpoint_task)) {
+            roc_log(LogError,
+                    "receiver node:"
+                    " can't bind %s interface of slot %lu:"
+                    " can't add endpoint to pipeline",
+                    address::interface_to_str(iface), (unsigned long)slot_index);
+            break_slot_(*slot);
+            return false;
+        }
+
+        if (port.sharder) {
+            if (!port.sharder->add_shard(*endpoint_task.get_inbound_writer())) {
+                break_slot_(*slot);
+                return false;
+            }
+            inbound_writer = port.sharder.get();
+        } else {
+            inbound_writer = endpoint_task.get_inbound_writer();
+        }
+    }
+
+    bool recv_started = false;
+
+    if (use_inline) {
+        recv_started = true;
+    } else if (use_shm) {
+        netio::NetworkLoop::Tasks::StartShmRecv recv_task(port.handle, *inbound_writer);
+        recv_started = port.loop->schedule_and_wait(recv_task);
+    } else {
+        netio::NetworkLoop::Tasks::StartUdpRecv recv_task(port.handle, *inbound_writer);
+        recv_started = port.loop->schedule_and_wait(recv_task);
     }
 
-    netio::NetworkLoop::Tasks::StartUdpRecv recv_task(
-        port.handle, *endpoint_task.get_inbound_writer());
-    if (!context().network_loop().schedule_and_wait(recv_task)) {
+    if (!recv_started) {
         roc_log(LogError,
                 "receiver node:"
                 " can't bind %s interface of slot %lu:"
@@ -243,6 +394,78 @@ bool Receiver::bind(slot_index_t slot_index,
     return true;
 }
 
+bool Receiver::bind_many(Binding* bindings, size_t n_bindings) {
+    roc_panic_if_not(is_valid());
+
+    roc_panic_if(!bindings && n_bindings != 0);
+
+    for (size_t i = 0; i < n_bindings; i++) {
+        roc_panic_if(!bindings[i].uri);
+        roc_panic_if(bindings[i].iface < 0);
+        roc_panic_if(bindings[i].iface >= (int)address::Iface_Max);
+
+        bindings[i].success = false;
+    }
+
+    roc_log(LogDebug, "receiver node: binding %lu interfaces in batch",
+            (unsigned long)n_bindings);
+
+    core::Array<BindOp*> ops(context().arena());
+
+    if (!ops.resize(n_bindings)) {
+        roc_log(LogError, "receiver node: can't bind interfaces: can't allocate batch");
+        return false;
+    }
+
+    bool success = true;
+
+    for (size_t i = 0; i < n_bindings; i++) {
+        ops[i] = new (context().arena()) BindOp(bindings[i]);
+        if (!ops[i]) {
+            roc_log(LogError,
+                    "receiver node: can't bind interfaces: can't allocate batch");
+            success = false;
+            break;
+        }
+    }
+
+    if (success) {
+        // Network and control threads are started on first bind or connect.
+        const bool started = context().start_runtime();
+
+        TaskBatch batch;
+
+        // Resolve addresses before locking mutex, see bind().
+        if (started) {
+            batch_resolve_(ops, batch);
+        }
+
+        core::Mutex::Lock lock(mutex_);
+
+        batch_create_slots_(ops, batch);
+        batch_check_(ops, started);
+        batch_add_ports_(ops, batch);
+        batch_start_send_(ops, batch);
+        batch_add_endpoints_(ops, batch);
+        batch_start_recv_(ops, batch);
+        batch_finish_(ops);
+
+        for (size_t i = 0; i < n_bindings; i++) {
+            if (!bindings[i].success) {
+                success = false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n_bindings; i++) {
+        if (ops[i]) {
+            context().arena().destroy_object(*ops[i]);
+        }
+    }
+
+    return success;
+}
+
 bool Receiver::unlink(slot_index_t slot_index) {
     core::Mutex::Lock lock(mutex_);
 
@@ -297,15 +520,39 @@ bool Receiver::get_metrics(slot_index_t slot_index,
         }
     }
 
-    pipeline::ReceiverLoop::Tasks::QuerySlot task(
-        slot->handle, slot_metrics_,
-        party_metrics_.size() != 0 ? party_metrics_.data() : NULL, party_metrics_size);
-    if (!pipeline_.schedule_and_wait(task)) {
-        roc_log(LogError,
-                "receiver node:"
-                " can't get metrics of slot %lu: operation failed",
-                (unsigned long)slot_index);
-        return false;
+    // Metrics of all shards are combined: participants are concatenated,
+    // and slot counters are summed.
+    size_t party_count = 0;
+
+    for (size_t n = 0; n < num_shards_; n++) {
+        pipeline::ReceiverSlotMetrics shard_slot_metrics;
+        size_t shard_party_count =
+            party_metrics_size ? party_metrics_.size() - party_count : 0;
+
+        if (!load_shard_metrics_(
+                n, *slot, shard_slot_metrics,
+                shard_party_count != 0 ? party_metrics_.data() + party_count : NULL,
+                party_metrics_size ? &shard_party_count : NULL)) {
+            roc_log(LogError,
+                    "receiver node:"
+                    " can't get metrics of slot %lu: operation failed",
+                    (unsigned long)slot_index);
+            return false;
+        }
+
+        if (n == 0) {
+            slot_metrics_ = shard_slot_metrics;
+        } else {
+            slot_metrics_.num_participants += shard_slot_metrics.num_participants;
+            slot_metrics_.rate_limited_packets +=
+                shard_slot_metrics.rate_limited_packets;
+        }
+
+        party_count += shard_party_count;
+    }
+
+    if (party_metrics_size) {
+        *party_metrics_size = party_count;
     }
 
     if (slot_metrics_arg) {
@@ -338,7 +585,435 @@ bool Receiver::has_broken() {
 }
 
 sndio::ISource& Receiver::source() {
-    return pipeline_.source();
+    if (mixing_source_) {
+        return *mixing_source_;
+    }
+
+    return pipelines_[0]->source();
+}
+
+bool Receiver::load_shard_metrics_(size_t shard,
+                                   Slot& slot,
+                                   pipeline::ReceiverSlotMetrics& slot_metrics,
+                                   pipeline::ReceiverParticipantMetrics* party_metrics,
+                                   size_t* party_metrics_size) {
+    pipeline::ReceiverLoop& pipeline = *pipelines_[shard];
+
+    // Fast path: read snapshot published by pipeline, without scheduling
+    // a task and disturbing pipeline thread.
+    if (pipeline.load_slot_metrics(slot.handles[shard], slot_metrics, party_metrics,
+                                   party_metrics_size)) {
+        return true;
+    }
+
+    // Slow path: if snapshot is not available, query pipeline directly.
+    pipeline::ReceiverLoop::Tasks::QuerySlot task(slot.handles[shard], slot_metrics,
+                                                  party_metrics, party_metrics_size);
+
+    return pipeline.schedule_and_wait(task);
+}
+
+void Receiver::batch_resolve_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (!op.binding.uri->verify(address::EndpointUri::Subset_Full)) {
+            continue;
+        }
+
+        op.resolve_task.reset(new (op.resolve_task)
+                                  netio::NetworkLoop::Tasks::ResolveEndpointAddress(
+                                      *op.binding.uri));
+        batch.schedule(context().network_loop(), *op.resolve_task);
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (op.resolve_task && op.resolve_task->success()) {
+            op.resolved_addr = op.resolve_task->get_address();
+            op.resolved = true;
+        }
+    }
+}
+
+void Receiver::batch_create_slots_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    pipeline::ReceiverSlotConfig slot_config;
+    slot_config.enable_routing = true;
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        roc_log(LogInfo, "receiver node: binding %s interface of slot %lu to %s",
+                address::interface_to_str(op.binding.iface),
+                (unsigned long)op.binding.slot_index,
+                address::endpoint_uri_to_str(*op.binding.uri).c_str());
+
+        // Slot may exist, or may be created by previous binding in batch.
+        op.slot = slot_map_.find(op.binding.slot_index);
+        if (op.slot) {
+            continue;
+        }
+
+        op.slot = new (slot_pool_) Slot(slot_pool_, op.binding.slot_index);
+        if (!op.slot || !slot_map_.insert(*op.slot)) {
+            op.slot = NULL;
+            fail_op_(op, "can't create slot");
+            continue;
+        }
+
+        for (size_t n = 0; n < num_shards_; n++) {
+            op.slot_tasks[n].reset(new (op.slot_tasks[n])
+                                       pipeline::ReceiverLoop::Tasks::CreateSlot(
+                                           slot_config));
+            batch.schedule(*pipelines_[n], *op.slot_tasks[n]);
+        }
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (!op.slot_tasks[0]) {
+            continue;
+        }
+
+        bool created = true;
+
+        for (size_t n = 0; n < num_shards_; n++) {
+            if (op.slot_tasks[n]->success()) {
+                op.slot->handles[n] = op.slot_tasks[n]->get_handle();
+            } else {
+                created = false;
+            }
+        }
+
+        if (!created) {
+            // Like in get_slot_(), slot is removed instead of marking it broken.
+            // Other bindings to this slot are skipped.
+            cleanup_slot_(*op.slot);
+            slot_map_.remove(*op.slot);
+            op.slot->broken = true;
+            op.slot = NULL;
+            fail_op_(op, "can't create slot");
+        }
+    }
+}
+
+void Receiver::batch_check_(core::Array<BindOp*>& ops, bool started) {
+    // Compatibility is checked against other slots and previous bindings in batch.
+    bool used_interfaces[address::Iface_Max];
+    address::Protocol used_protocols[address::Iface_Max];
+
+    memcpy(used_interfaces, used_interfaces_, sizeof(used_interfaces));
+    memcpy(used_protocols, used_protocols_, sizeof(used_protocols));
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (op.failed) {
+            continue;
+        }
+
+        const address::Interface iface = op.binding.iface;
+        const address::EndpointUri& uri = *op.binding.uri;
+
+        if (op.slot->broken) {
+            fail_op_(op, "slot is marked broken and should be unlinked");
+            continue;
+        }
+
+        op.port = &op.slot->ports[iface];
+
+        bool port_busy = op.port->handle != NULL;
+        for (size_t j = 0; j < i; j++) {
+            if (ops[j]->port == op.port) {
+                port_busy = true;
+            }
+        }
+        if (port_busy) {
+            fail_op_(op, "interface is already bound or connected");
+            continue;
+        }
+
+        if (op.binding.config) {
+            op.port->config = *op.binding.config;
+        }
+
+        if (!uri.verify(address::EndpointUri::Subset_Full)) {
+            fail_op_(op, "invalid uri");
+            continue;
+        }
+
+        if (used_interfaces[iface] && used_protocols[iface] != uri.proto()) {
+            fail_op_(op, "incompatible with other slots");
+            continue;
+        }
+
+        used_interfaces[iface] = true;
+        used_protocols[iface] = uri.proto();
+
+        if (!started) {
+            fail_op_(op, "can't start network thread");
+            continue;
+        }
+
+        if (!op.resolved) {
+            fail_op_(op, "can't resolve endpoint address");
+            continue;
+        }
+
+        op.use_shm = uri.proto() == address::Proto_RTP_Shm;
+        op.use_inline = !op.use_shm && op.port->config.enable_inline_recv;
+
+        if (op.use_inline && num_shards_ > 1) {
+            fail_op_(op, "inline receiving is not supported with multiple shards");
+            continue;
+        }
+    }
+}
+
+void Receiver::batch_add_ports_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (skip_op_(op)) {
+            continue;
+        }
+
+        op.loop = &context().select_network_loop();
+
+        op.port->config.bind_address = op.resolved_addr;
+
+        if (op.use_shm) {
+            op.port->shm_config.address = op.resolved_addr;
+
+            op.shm_port_task.reset(new (op.shm_port_task)
+                                       netio::NetworkLoop::Tasks::AddShmPort(
+                                           op.port->shm_config, &packet_factory()));
+            batch.schedule(*op.loop, *op.shm_port_task);
+        } else {
+            op.udp_port_task.reset(new (op.udp_port_task)
+                                       netio::NetworkLoop::Tasks::AddUdpPort(
+                                           op.port->config, &packet_factory(),
+                                           context().packet_capture()));
+            batch.schedule(*op.loop, *op.udp_port_task);
+        }
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (op.shm_port_task) {
+            if (!op.shm_port_task->success()) {
+                fail_op_(op, "can't open shared memory port");
+                continue;
+            }
+            op.port->handle = op.shm_port_task->get_handle();
+            op.port->loop = op.loop;
+        } else if (op.udp_port_task) {
+            if (!op.udp_port_task->success()) {
+                fail_op_(op, "can't bind interface to local port");
+                continue;
+            }
+            op.port->handle = op.udp_port_task->get_handle();
+            op.port->loop = op.loop;
+        }
+    }
+}
+
+void Receiver::batch_start_send_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (skip_op_(op)) {
+            continue;
+        }
+
+        if (op.binding.iface == address::Iface_AudioControl) {
+            op.send_task.reset(new (op.send_task)
+                                   netio::NetworkLoop::Tasks::StartUdpSend(
+                                       op.port->handle));
+            batch.schedule(*op.port->loop, *op.send_task);
+        }
+
+        if (op.use_inline) {
+            // Start receiving before adding endpoint, which will poll the port.
+            op.inline_recv_task.reset(new (op.inline_recv_task)
+                                          netio::NetworkLoop::Tasks::StartUdpInlineRecv(
+                                              op.port->handle));
+            batch.schedule(*op.port->loop, *op.inline_recv_task);
+        }
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (op.send_task) {
+            if (!op.send_task->success()) {
+                fail_op_(op, "can't start sending on local port");
+                continue;
+            }
+            op.outbound_writer = &op.send_task->get_outbound_writer();
+        }
+
+        if (op.inline_recv_task) {
+            if (!op.inline_recv_task->success()) {
+                fail_op_(op, "can't start receiving on local port");
+                continue;
+            }
+            op.port->inbound_reader = &op.inline_recv_task->get_inbound_reader();
+        }
+    }
+}
+
+void Receiver::batch_add_endpoints_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (skip_op_(op)) {
+            continue;
+        }
+
+        for (size_t n = 0; n < num_shards_; n++) {
+            op.endpoint_tasks[n].reset(new (op.endpoint_tasks[n])
+                                           pipeline::ReceiverLoop::Tasks::AddEndpoint(
+                                               op.slot->handles[n], op.binding.iface,
+                                               op.binding.uri->proto(),
+                                               op.port->config.bind_address,
+                                               op.outbound_writer));
+            if (op.port->inbound_reader) {
+                op.endpoint_tasks[n]->set_inbound_reader(*op.port->inbound_reader);
+            }
+            batch.schedule(*pipelines_[n], *op.endpoint_tasks[n]);
+        }
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (!op.endpoint_tasks[0]) {
+            continue;
+        }
+
+        if (num_shards_ > 1) {
+            op.port->sharder.reset(new (op.port->sharder)
+                                       packet::AddressSharder(context().arena()));
+        }
+
+        for (size_t n = 0; n < num_shards_; n++) {
+            if (!op.endpoint_tasks[n]->success()) {
+                fail_op_(op, "can't add endpoint to pipeline");
+                break;
+            }
+
+            if (op.port->sharder) {
+                if (!op.port->sharder->add_shard(
+                        *op.endpoint_tasks[n]->get_inbound_writer())) {
+                    fail_op_(op, "can't add endpoint to sharder");
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void Receiver::batch_start_recv_(core::Array<BindOp*>& ops, TaskBatch& batch) {
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (skip_op_(op) || op.use_inline) {
+            continue;
+        }
+
+        packet::IWriter& inbound_writer = op.port->sharder
+            ? *op.port->sharder
+            : *op.endpoint_tasks[0]->get_inbound_writer();
+
+        if (op.use_shm) {
+            op.shm_recv_task.reset(new (op.shm_recv_task)
+                                       netio::NetworkLoop::Tasks::StartShmRecv(
+                                           op.port->handle, inbound_writer));
+            batch.schedule(*op.port->loop, *op.shm_recv_task);
+        } else {
+            op.udp_recv_task.reset(new (op.udp_recv_task)
+                                       netio::NetworkLoop::Tasks::StartUdpRecv(
+                                           op.port->handle, inbound_writer));
+            batch.schedule(*op.port->loop, *op.udp_recv_task);
+        }
+    }
+
+    batch.wait();
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if ((op.shm_recv_task && !op.shm_recv_task->success())
+            || (op.udp_recv_task && !op.udp_recv_task->success())) {
+            fail_op_(op, "can't start receiving on local port");
+        }
+    }
+}
+
+void Receiver::batch_finish_(core::Array<BindOp*>& ops) {
+    // Slots are broken only after all batches are completed, since tasks of
+    // other bindings may still refer to them.
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (op.break_slot) {
+            break_slot_(*op.slot);
+        }
+    }
+
+    for (size_t i = 0; i < ops.size(); i++) {
+        BindOp& op = *ops[i];
+
+        if (skip_op_(op)) {
+            continue;
+        }
+
+        if (op.binding.uri->port() == 0) {
+            // Report back the port number we've selected.
+            if (!op.binding.uri->set_port(op.port->config.bind_address.port())) {
+                roc_panic("receiver node: can't set endpoint port");
+            }
+        }
+
+        update_compatibility_(op.binding.iface, *op.binding.uri);
+
+        op.binding.success = true;
+    }
+}
+
+bool Receiver::skip_op_(const BindOp& op) const {
+    // Binding is also skipped if another binding to the same slot failed.
+    return op.failed || !op.slot || op.slot->broken;
+}
+
+void Receiver::fail_op_(BindOp& op, const char* reason) {
+    roc_log(LogError,
+            "receiver node:"
+            " can't bind %s interface of slot %lu:"
+            " %s",
+            address::interface_to_str(op.binding.iface),
+            (unsigned long)op.binding.slot_index, reason);
+
+    op.failed = true;
+
+    if (op.slot && !op.slot->broken) {
+        op.slot->broken = true;
+        op.break_slot = true;
+    }
 }
 
 bool Receiver::check_compatibility_(address::Interface iface,
@@ -370,19 +1045,23 @@ core::SharedPtr<Receiver::Slot> Receiver::get_slot_(slot_index_t slot_index,
             pipeline::ReceiverSlotConfig slot_config;
             slot_config.enable_routing = true;
 
-            pipeline::ReceiverLoop::Tasks::CreateSlot slot_task(slot_config);
-            if (!pipeline_.schedule_and_wait(slot_task)) {
-                roc_log(LogError, "receiver node: failed to create slot");
-                return NULL;
-            }
-
-            slot = new (slot_pool_) Slot(slot_pool_, slot_index, slot_task.get_handle());
+            slot = new (slot_pool_) Slot(slot_pool_, slot_index);
             if (!slot) {
                 roc_log(LogError, "receiver node: failed to create slot %lu",
                         (unsigned long)slot_index);
                 return NULL;
             }
 
+            for (size_t n = 0; n < num_shards_; n++) {
+                pipeline::ReceiverLoop::Tasks::CreateSlot slot_task(slot_config);
+                if (!pipelines_[n]->schedule_and_wait(slot_task)) {
+                    roc_log(LogError, "receiver node: failed to create slot");
+                    cleanup_slot_(*slot);
+                    return NULL;
+                }
+                slot->handles[n] = slot_task.get_handle();
+            }
+
             if (!slot_map_.insert(*slot)) {
                 roc_log(LogError, "receiver node: failed to create slot %lu",
                         (unsigned long)slot_index);
@@ -402,27 +1081,43 @@ core::SharedPtr<Receiver::Slot> Receiver::get_slot_(slot_index_t slot_index,
 void Receiver::cleanup_slot_(Slot& slot) {
     // First remove network ports, because they write to pipeline slot.
     for (size_t p = 0; p < address::Iface_Max; p++) {
-        if (slot.ports[p].handle) {
-            netio::NetworkLoop::Tasks::RemovePort task(slot.ports[p].handle);
-            if (!context().network_loop().schedule_and_wait(task)) {
-                roc_panic("receiver node: can't remove network port of slot %lu",
+        if (slot.ports[p].handle && !slot.ports[p].inbound_reader) {
+            remove_port_(slot, slot.ports[p]);
+        }
+    }
+
+    // Then remove pipeline slots.
+    for (size_t n = 0; n < num_shards_; n++) {
+        if (slot.handles[n]) {
+            pipeline::ReceiverLoop::Tasks::DeleteSlot task(slot.handles[n]);
+            if (!pipelines_[n]->schedule_and_wait(task)) {
+                roc_panic("receiver node: can't remove pipeline slot %lu",
                           (unsigned long)slot.index);
             }
-            slot.ports[p].handle = NULL;
+            slot.handles[n] = NULL;
         }
     }
 
-    // Then remove pipeline slot.
-    if (slot.handle) {
-        pipeline::ReceiverLoop::Tasks::DeleteSlot task(slot.handle);
-        if (!pipeline_.schedule_and_wait(task)) {
-            roc_panic("receiver node: can't remove pipeline slot %lu",
-                      (unsigned long)slot.index);
+    // Ports receiving inline are polled by pipeline slot, so they're removed
+    // only after it.
+    for (size_t p = 0; p < address::Iface_Max; p++) {
+        if (slot.ports[p].handle) {
+            remove_port_(slot, slot.ports[p]);
         }
-        slot.handle = NULL;
     }
 }
 
+void Receiver::remove_port_(Slot& slot, Port& port) {
+    netio::NetworkLoop::Tasks::RemovePort task(port.handle);
+    if (!port.loop->schedule_and_wait(task)) {
+        roc_panic("receiver node: can't remove network port of slot %lu",
+                  (unsigned long)slot.index);
+    }
+    port.loop = NULL;
+    port.handle = NULL;
+    port.inbound_reader = NULL;
+}
+
 void Receiver::break_slot_(Slot& slot) {
     roc_log(LogError,
             "receiver node: marking slot %lu as broken, it needs to be unlinked",
@@ -432,13 +1127,25 @@ void Receiver::break_slot_(Slot& slot) {
     cleanup_slot_(slot);
 }
 
-void Receiver::schedule_task_processing(pipeline::PipelineLoop&,
+void Receiver::schedule_task_processing(pipeline::PipelineLoop& pipeline,
                                         core::nanoseconds_t deadline) {
-    context().control_loop().schedule_at(processing_task_, deadline, NULL);
+    context().control_loop().schedule_processing_at(processing_task_(pipeline),
+                                                    deadline);
 }
 
-void Receiver::cancel_task_processing(pipeline::PipelineLoop&) {
-    context().control_loop().async_cancel(processing_task_);
+void Receiver::cancel_task_processing(pipeline::PipelineLoop& pipeline) {
+    context().control_loop().async_cancel_processing(processing_task_(pipeline));
+}
+
+ctl::ControlLoop::Tasks::PipelineProcessing&
+Receiver::processing_task_(pipeline::PipelineLoop& pipeline) {
+    for (size_t n = 0; n < num_shards_; n++) {
+        if (pipelines_[n].get() == &pipeline) {
+            return *processing_tasks_[n];
+        }
+    }
+
+    roc_panic("receiver node: unknown pipeline");
 }
 
 } // namespace node
@@ -15,22 +15,33 @@
 #include "roc_address/endpoint_uri.h"
 #include "roc_address/interface.h"
 #include "roc_address/protocol.h"
+#include "roc_core/array.h"
 #include "roc_core/attributes.h"
 #include "roc_core/hashmap.h"
 #include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
 #include "roc_core/slab_pool.h"
 #include "roc_core/stddefs.h"
 #include "roc_ctl/control_loop.h"
 #include "roc_node/context.h"
 #include "roc_node/node.h"
+#include "roc_node/task_batch.h"
+#include "roc_packet/address_sharder.h"
 #include "roc_pipeline/ipipeline_task_scheduler.h"
 #include "roc_pipeline/receiver_loop.h"
+#include "roc_sndio/mixing_source.h"
 
 namespace roc {
 namespace node {
 
 //! Receiver node.
+//!
+//! If ReceiverCommonConfig::num_shards is greater than one, node runs several
+//! independent receiver pipelines. Every slot and endpoint is created in all of
+//! them, and packets arriving to a port are distributed between pipelines by
+//! sender address. Pipelines are read in parallel, and their outputs are mixed.
 class Receiver : public Node, private pipeline::IPipelineTaskScheduler {
 public:
     //! Slot index.
@@ -54,6 +65,48 @@ public:
     ROC_ATTR_NODISCARD bool
     bind(slot_index_t slot_index, address::Interface iface, address::EndpointUri& uri);
 
+    //! Interface binding for bind_many().
+    struct Binding {
+        //! Slot index.
+        slot_index_t slot_index;
+
+        //! Interface to bind.
+        address::Interface iface;
+
+        //! Interface config.
+        //! @remarks
+        //!  If NULL, config set by configure(), or default config, is used.
+        const netio::UdpConfig* config;
+
+        //! Local endpoint.
+        //! @remarks
+        //!  If port is zero, it's updated with selected port, like in bind().
+        address::EndpointUri* uri;
+
+        //! Set to true if binding succeeded.
+        bool success;
+
+        Binding()
+            : slot_index(0)
+            , iface(address::Iface_Invalid)
+            , config(NULL)
+            , uri(NULL)
+            , success(false) {
+        }
+    };
+
+    //! Configure and bind multiple interfaces at once.
+    //! @remarks
+    //!  Same as calling configure() and bind() for every binding, but each step
+    //!  (resolving addresses, creating slots, opening ports, adding endpoints,
+    //!  starting receiving) is submitted for all bindings as one batch of tasks,
+    //!  with single wait per batch. This makes provisioning of many slots much
+    //!  faster and avoids a burst of separate tasks for pipeline.
+    //!  If a binding fails, its slot is marked broken, like with bind().
+    //! @returns
+    //!  true if all bindings succeeded.
+    ROC_ATTR_NODISCARD bool bind_many(Binding* bindings, size_t n_bindings);
+
     //! Remove slot.
     ROC_ATTR_NODISCARD bool unlink(slot_index_t slot_index);
 
@@ -82,28 +135,37 @@ public:
     sndio::ISource& source();
 
 private:
+    enum { MaxShards = 16 };
+
     struct Port {
         netio::UdpConfig config;
+        netio::ShmConfig shm_config;
+        netio::NetworkLoop* loop;
         netio::NetworkLoop::PortHandle handle;
+        // distributes packets between shards, if there are many
+        core::Optional<packet::AddressSharder> sharder;
+        // polled by pipeline, if port receives inline
+        packet::IReader* inbound_reader;
 
         Port()
-            : handle(NULL) {
+            : loop(NULL)
+            , handle(NULL)
+            , inbound_reader(NULL) {
         }
     };
 
     struct Slot : core::RefCounted<Slot, core::PoolAllocation>, core::HashmapNode<> {
         const slot_index_t index;
-        pipeline::ReceiverLoop::SlotHandle handle;
+        // slot of every shard
+        pipeline::ReceiverLoop::SlotHandle handles[MaxShards];
         Port ports[address::Iface_Max];
         bool broken;
 
-        Slot(core::IPool& pool,
-             slot_index_t index,
-             pipeline::SenderLoop::SlotHandle handle)
+        Slot(core::IPool& pool, slot_index_t index)
             : core::RefCounted<Slot, core::PoolAllocation>(pool)
             , index(index)
-            , handle(handle)
             , broken(false) {
+            memset(handles, 0, sizeof(handles));
         }
 
         slot_index_t key() const {
@@ -119,21 +181,86 @@ private:
         }
     };
 
+    struct BindOp : core::NonCopyable<> {
+        Binding& binding;
+        core::SharedPtr<Slot> slot;
+        Port* port;
+        netio::NetworkLoop* loop;
+        address::SocketAddr resolved_addr;
+        bool resolved;
+        bool use_shm;
+        bool use_inline;
+        bool failed;
+        // if set, slot should be broken after batch
+        bool break_slot;
+        packet::IWriter* outbound_writer;
+
+        core::Optional<netio::NetworkLoop::Tasks::ResolveEndpointAddress> resolve_task;
+        core::Optional<pipeline::ReceiverLoop::Tasks::CreateSlot> slot_tasks[MaxShards];
+        core::Optional<netio::NetworkLoop::Tasks::AddUdpPort> udp_port_task;
+        core::Optional<netio::NetworkLoop::Tasks::AddShmPort> shm_port_task;
+        core::Optional<netio::NetworkLoop::Tasks::StartUdpSend> send_task;
+        core::Optional<netio::NetworkLoop::Tasks::StartUdpInlineRecv> inline_recv_task;
+        core::Optional<pipeline::ReceiverLoop::Tasks::AddEndpoint>
+            endpoint_tasks[MaxShards];
+        core::Optional<netio::NetworkLoop::Tasks::StartUdpRecv> udp_recv_task;
+        core::Optional<netio::NetworkLoop::Tasks::StartShmRecv> shm_recv_task;
+
+        BindOp(Binding& binding)
+            : binding(binding)
+            , port(NULL)
+            , loop(NULL)
+            , resolved(false)
+            , use_shm(false)
+            , use_inline(false)
+            , failed(false)
+            , break_slot(false)
+            , outbound_writer(NULL) {
+        }
+    };
+
+    void batch_resolve_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_create_slots_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_check_(core::Array<BindOp*>& ops, bool started);
+    void batch_add_ports_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_start_send_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_add_endpoints_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_start_recv_(core::Array<BindOp*>& ops, TaskBatch& batch);
+    void batch_finish_(core::Array<BindOp*>& ops);
+
+    bool skip_op_(const BindOp& op) const;
+    void fail_op_(BindOp& op, const char* reason);
+
     bool check_compatibility_(address::Interface iface, const address::EndpointUri& uri);
     void update_compatibility_(address::Interface iface, const address::EndpointUri& uri);
 
+    bool load_shard_metrics_(size_t shard,
+                             Slot& slot,
+                             pipeline::ReceiverSlotMetrics& slot_metrics,
+                             pipeline::ReceiverParticipantMetrics* party_metrics,
+                             size_t* party_metrics_size);
+
     core::SharedPtr<Slot> get_slot_(slot_index_t slot_index, bool auto_create);
     void cleanup_slot_(Slot& slot);
+    void remove_port_(Slot& slot, Port& port);
     void break_slot_(Slot& slot);
 
     virtual void schedule_task_processing(pipeline::PipelineLoop&,
                                           core::nanoseconds_t delay);
     virtual void cancel_task_processing(pipeline::PipelineLoop&);
 
+    ctl::ControlLoop::Tasks::PipelineProcessing&
+    processing_task_(pipeline::PipelineLoop& pipeline);
+
     core::Mutex mutex_;
 
-    pipeline::ReceiverLoop pipeline_;
-    ctl::ControlLoop::Tasks::PipelineProcessing processing_task_;
+    size_t num_shards_;
+    core::Optional<pipeline::ReceiverLoop> pipelines_[MaxShards];
+    core::Optional<ctl::ControlLoop::Tasks::PipelineProcessing>
+        processing_tasks_[MaxShards];
+
+    // mixes outputs of shards, if there are many
+    core::Optional<sndio::MixingSource> mixing_source_;
 
     core::SlabPool<Slot> slot_pool_;
     core::Hashmap<Slot> slot_map_;
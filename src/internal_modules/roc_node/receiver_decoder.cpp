@@ -18,14 +18,15 @@ namespace node {
 ReceiverDecoder::ReceiverDecoder(Context& context,
                                  const pipeline::ReceiverSourceConfig& pipeline_config)
     : Node(context)
-    , packet_factory_(context.packet_pool(), context.packet_buffer_pool())
+    , packet_factory_(packet_pool(), packet_buffer_pool())
     , pipeline_(*this,
                 pipeline_config,
                 context.encoding_map(),
-                context.packet_pool(),
-                context.packet_buffer_pool(),
-                context.frame_buffer_pool(),
-                context.arena())
+                packet_pool(),
+                packet_buffer_pool(),
+                frame_buffer_pool(),
+                context.arena(),
+                &context.memory_tracker())
     , slot_(NULL)
     , processing_task_(pipeline_)
     , valid_(false) {
@@ -36,6 +37,9 @@ ReceiverDecoder::ReceiverDecoder(Context& context,
         return;
     }
 
+    add_small_frame_buffer_pools(pipeline_);
+    context.add_packet_capture(pipeline_);
+
     pipeline::ReceiverSlotConfig slot_config;
     slot_config.enable_routing = false;
 
@@ -66,8 +70,11 @@ ReceiverDecoder::~ReceiverDecoder() {
     }
 
     // Then wait until processing task is fully completed, before
-    // proceeding to its destruction.
-    context().control_loop().wait(processing_task_);
+    // proceeding to its destruction. If control thread was never started,
+    // the task was never scheduled.
+    if (context().has_runtime()) {
+        context().control_loop().wait_processing(processing_task_);
+    }
 }
 
 bool ReceiverDecoder::is_valid() {
@@ -173,6 +180,37 @@ status::StatusCode ReceiverDecoder::write_packet(address::Interface iface,
     return writer->write(packet);
 }
 
+status::StatusCode ReceiverDecoder::write_packets(address::Interface iface,
+                                                  const packet::PacketPtr* packets,
+                                                  size_t n_packets,
+                                                  size_t& n_written) {
+    roc_panic_if_not(is_valid());
+
+    roc_panic_if(iface < 0);
+    roc_panic_if(iface >= (int)address::Iface_Max);
+
+    n_written = 0;
+
+    packet::IWriter* writer = endpoint_writers_[iface];
+    if (!writer) {
+        roc_log(LogError,
+                "receiver decoder node:"
+                " can't write to %s interface: interface not activated",
+                address::interface_to_str(iface));
+        // TODO(gh-183): return StatusNotFound
+        return status::StatusUnknown;
+    }
+
+    for (; n_written < n_packets; n_written++) {
+        const status::StatusCode code = writer->write(packets[n_written]);
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
+    return status::StatusOK;
+}
+
 status::StatusCode ReceiverDecoder::read_packet(address::Interface iface,
                                                 packet::PacketPtr& packet) {
     roc_panic_if_not(is_valid());
@@ -210,11 +248,11 @@ sndio::ISource& ReceiverDecoder::source() {
 
 void ReceiverDecoder::schedule_task_processing(pipeline::PipelineLoop&,
                                                core::nanoseconds_t deadline) {
-    context().control_loop().schedule_at(processing_task_, deadline, NULL);
+    context().control_loop().schedule_processing_at(processing_task_, deadline);
 }
 
 void ReceiverDecoder::cancel_task_processing(pipeline::PipelineLoop&) {
-    context().control_loop().async_cancel(processing_task_);
+    context().control_loop().async_cancel_processing(processing_task_);
 }
 
 } // namespace node
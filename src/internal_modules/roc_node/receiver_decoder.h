@@ -63,9 +63,24 @@ public:
                                         void* party_metrics_arg);
 
     //! Write packet for decoding.
+    //! @remarks
+    //!  Packet is added to lock-free MPSC queue of the endpoint, which is drained
+    //!  by pipeline when next frame is read from source(). Doesn't acquire locks,
+    //!  so it can be called from any number of threads concurrently, without
+    //!  contending with each other and with frame reading.
     ROC_ATTR_NODISCARD status::StatusCode write_packet(address::Interface iface,
                                                        const packet::PacketPtr& packet);
 
+    //! Write multiple packets for decoding.
+    //! @remarks
+    //!  Performs interface lookup only once per batch. Stops at first error.
+    //!  Thread-safe in the same way as write_packet().
+    //!  Sets @p n_written to the number of packets actually written.
+    ROC_ATTR_NODISCARD status::StatusCode write_packets(address::Interface iface,
+                                                        const packet::PacketPtr* packets,
+                                                        size_t n_packets,
+                                                        size_t& n_written);
+
     //! Read encoded packet.
     //! @note
     //!  Typically used to generate control packets with feedback for sender.
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/runtime.h"
+#include "roc_core/buffer.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/log.h"
+#include "roc_core/mutex.h"
+#include "roc_core/panic.h"
+#include "roc_core/singleton.h"
+#include "roc_core/slab_pool.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+// Shared runtime together with its default pools.
+struct SharedRuntime {
+    SharedRuntime(const RuntimeConfig& config, core::IArena& arena)
+        : packet_pool("shared_packet_pool", arena, sizeof(packet::Packet))
+        , buffer_pool("shared_packet_buffer_pool",
+                      arena,
+                      sizeof(core::Buffer) + config.max_packet_size)
+        , runtime(config, packet_pool, buffer_pool, arena) {
+    }
+
+    core::SlabPool<packet::Packet> packet_pool;
+    core::SlabPool<core::Buffer> buffer_pool;
+    Runtime runtime;
+};
+
+// Process-wide state of shared runtime.
+// Shared runtime is allocated from its own arena, because contexts using it
+// may have different arenas and may be closed in any order.
+struct SharedRuntimeState {
+    core::HeapArena arena;
+    core::Mutex mutex;
+    SharedRuntime* shared;
+    size_t users;
+
+    SharedRuntimeState()
+        : shared(NULL)
+        , users(0) {
+    }
+};
+
+SharedRuntimeState& shared_state() {
+    return core::Singleton<SharedRuntimeState>::instance();
+}
+
+} // namespace
+
+Runtime::Runtime(const RuntimeConfig& config,
+                 core::IPool& packet_pool,
+                 core::IPool& buffer_pool,
+                 core::IArena& arena)
+    : arena_(arena)
+    , network_loop_(packet_pool,
+                    buffer_pool,
+                    arena,
+                    config.network_thread,
+                    config.resolver)
+    , extra_network_loops_(arena)
+    , next_network_loop_(0)
+    , control_loop_(network_loop_, arena, config.control_thread)
+    , valid_(false) {
+    if (config.network_threads == 0) {
+        roc_log(LogError, "runtime: number of network threads can't be zero");
+        return;
+    }
+
+    if (!network_loop_.is_valid() || !control_loop_.is_valid()) {
+        return;
+    }
+
+    if (!extra_network_loops_.grow(config.network_threads - 1)) {
+        roc_log(LogError, "runtime: can't allocate network loops array");
+        return;
+    }
+
+    for (size_t n = 1; n < config.network_threads; n++) {
+        netio::NetworkLoop* loop =
+            new (arena_) netio::NetworkLoop(packet_pool, buffer_pool, arena_,
+                                            config.network_thread, config.resolver);
+        if (!loop) {
+            roc_log(LogError, "runtime: can't allocate network loop");
+            return;
+        }
+
+        if (!extra_network_loops_.push_back(loop)) {
+            roc_panic("runtime: can't add network loop to array");
+        }
+
+        if (!loop->is_valid()) {
+            roc_log(LogError, "runtime: can't initialize network loop");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+Runtime::~Runtime() {
+    for (size_t n = 0; n < extra_network_loops_.size(); n++) {
+        arena_.destroy_object(*extra_network_loops_[n]);
+    }
+}
+
+bool Runtime::is_valid() const {
+    return valid_;
+}
+
+netio::NetworkLoop& Runtime::network_loop() {
+    return network_loop_;
+}
+
+size_t Runtime::num_network_loops() const {
+    return extra_network_loops_.size() + 1;
+}
+
+netio::NetworkLoop& Runtime::select_network_loop() {
+    const size_t n = (size_t)(unsigned)next_network_loop_++ % num_network_loops();
+
+    if (n == 0) {
+        return network_loop_;
+    }
+
+    return *extra_network_loops_[n - 1];
+}
+
+ctl::ControlLoop& Runtime::control_loop() {
+    return control_loop_;
+}
+
+Runtime* Runtime::acquire_shared(const RuntimeConfig& config) {
+    SharedRuntimeState& state = shared_state();
+
+    core::Mutex::Lock lock(state.mutex);
+
+    if (!state.shared) {
+        roc_log(LogDebug, "runtime: creating shared runtime: network_threads=%lu",
+                (unsigned long)config.network_threads);
+
+        SharedRuntime* shared = new (state.arena) SharedRuntime(config, state.arena);
+        if (!shared) {
+            roc_log(LogError, "runtime: can't allocate shared runtime");
+            return NULL;
+        }
+
+        if (!shared->runtime.is_valid()) {
+            roc_log(LogError, "runtime: can't initialize shared runtime");
+            state.arena.destroy_object(*shared);
+            return NULL;
+        }
+
+        state.shared = shared;
+    }
+
+    state.users++;
+
+    return &state.shared->runtime;
+}
+
+void Runtime::release_shared(Runtime& runtime) {
+    SharedRuntimeState& state = shared_state();
+
+    core::Mutex::Lock lock(state.mutex);
+
+    if (!state.shared || &state.shared->runtime != &runtime || state.users == 0) {
+        roc_panic("runtime: attempt to release unknown shared runtime");
+    }
+
+    if (--state.users != 0) {
+        return;
+    }
+
+    roc_log(LogDebug, "runtime: destroying shared runtime");
+
+    state.arena.destroy_object(*state.shared);
+    state.shared = NULL;
+}
+
+size_t Runtime::num_shared_users() {
+    SharedRuntimeState& state = shared_state();
+
+    core::Mutex::Lock lock(state.mutex);
+
+    return state.users;
+}
+
+} // namespace node
+} // namespace roc
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/runtime.h
+//! @brief Node runtime.
+
+#ifndef ROC_NODE_RUNTIME_H_
+#define ROC_NODE_RUNTIME_H_
+
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/thread.h"
+#include "roc_ctl/control_loop.h"
+#include "roc_netio/network_loop.h"
+
+namespace roc {
+namespace node {
+
+//! Node runtime config.
+struct RuntimeConfig {
+    //! Number of network threads.
+    size_t network_threads;
+
+    //! Scheduling parameters of network threads.
+    core::ThreadConfig network_thread;
+
+    //! Scheduling parameters of control thread.
+    core::ThreadConfig control_thread;
+
+    //! Parameters of hostname resolver.
+    netio::ResolverConfig resolver;
+
+    //! Maximum size in bytes of a network packet.
+    //! @remarks
+    //!  Used for default pools of shared runtime.
+    size_t max_packet_size;
+
+    RuntimeConfig()
+        : network_threads(1)
+        , max_packet_size(2048) {
+    }
+};
+
+//! Node runtime.
+//!
+//! Owns background threads of context: network event loops and control loop.
+//!
+//! Usually every context has its own runtime. A context can also use shared
+//! runtime, which is a process-wide instance used by all such contexts. It
+//! allows many contexts to be served by the same few threads, while each
+//! context keeps its own pools, memory tracking and metrics.
+//!
+//! Network loops of runtime have their own pools, which are used only by
+//! ports which didn't provide packet factory when added.
+class Runtime : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p packet_pool and @p buffer_pool are default pools of network loops.
+    Runtime(const RuntimeConfig& config,
+            core::IPool& packet_pool,
+            core::IPool& buffer_pool,
+            core::IArena& arena);
+
+    //! Deinitialize.
+    ~Runtime();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Get main network event loop.
+    netio::NetworkLoop& network_loop();
+
+    //! Get number of network event loops.
+    size_t num_network_loops() const;
+
+    //! Select network event loop for a new port.
+    //! @remarks
+    //!  Returns loops in round-robin order.
+    netio::NetworkLoop& select_network_loop();
+
+    //! Get control event loop.
+    ctl::ControlLoop& control_loop();
+
+    //! Acquire process-wide shared runtime.
+    //! @remarks
+    //!  Shared runtime is created on first call using @p config, and is
+    //!  destroyed when all users released it. While it exists, @p config
+    //!  of subsequent calls is ignored.
+    //! @returns
+    //!  NULL if runtime can't be created.
+    static Runtime* acquire_shared(const RuntimeConfig& config);
+
+    //! Release shared runtime acquired by acquire_shared().
+    static void release_shared(Runtime& runtime);
+
+    //! Get number of current users of shared runtime.
+    static size_t num_shared_users();
+
+private:
+    core::IArena& arena_;
+
+    netio::NetworkLoop network_loop_;
+    core::Array<netio::NetworkLoop*> extra_network_loops_;
+    core::Atomic<int> next_network_loop_;
+
+    ctl::ControlLoop control_loop_;
+
+    bool valid_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_RUNTIME_H_
@@ -15,15 +15,36 @@
 namespace roc {
 namespace node {
 
-Sender::Sender(Context& context, const pipeline::SenderSinkConfig& pipeline_config)
+namespace {
+
+pipeline::SenderSinkConfig make_pipeline_config(const pipeline::SenderSinkConfig& config,
+                                                const AsyncSinkConfig& async_config) {
+    pipeline::SenderSinkConfig result = config;
+
+    if (async_config.queue_length != 0) {
+        // Duration and cts are assigned by async sink when frame is enqueued,
+        // pipeline would assign them when frame is dequeued.
+        result.enable_auto_duration = false;
+        result.enable_auto_cts = false;
+    }
+
+    return result;
+}
+
+} // namespace
+
+Sender::Sender(Context& context,
+               const pipeline::SenderSinkConfig& pipeline_config,
+               const AsyncSinkConfig& async_config)
     : Node(context)
     , pipeline_(*this,
-                pipeline_config,
+                make_pipeline_config(pipeline_config, async_config),
                 context.encoding_map(),
-                context.packet_pool(),
-                context.packet_buffer_pool(),
-                context.frame_buffer_pool(),
-                context.arena())
+                packet_pool(),
+                packet_buffer_pool(),
+                frame_buffer_pool(),
+                context.arena(),
+                &context.fec_groups())
     , processing_task_(pipeline_)
     , slot_pool_("slot_pool", context.arena())
     , slot_map_(context.arena())
@@ -38,12 +59,37 @@ Sender::Sender(Context& context, const pipeline::SenderSinkConfig& pipeline_conf
         return;
     }
 
+    add_small_frame_buffer_pools(pipeline_);
+
+    if (async_config.queue_length != 0) {
+        if (pipeline_config.enable_timing) {
+            roc_log(LogError,
+                    "sender node: asynchronous write can't be used with internal clock");
+            return;
+        }
+
+        ctl::ControlTaskQueue* writer_queue = context.writer_queue();
+        if (!writer_queue) {
+            return;
+        }
+
+        async_sink_.reset(new (async_sink_)
+                              AsyncSink(pipeline_.sink(), *writer_queue, async_config,
+                                        frame_buffer_pool(), context.arena()));
+        if (!async_sink_->is_valid()) {
+            return;
+        }
+    }
+
     valid_ = true;
 }
 
 Sender::~Sender() {
     roc_log(LogDebug, "sender node: deinitializing");
 
+    // Flush and stop writer before pipeline is destroyed.
+    async_sink_.reset();
+
     // First remove all slots. This may involve usage of processing task.
     while (core::SharedPtr<Slot> slot = slot_map_.front()) {
         cleanup_slot_(*slot);
@@ -51,8 +97,11 @@ Sender::~Sender() {
     }
 
     // Then wait until processing task is fully completed, before
-    // proceeding to its destruction.
-    context().control_loop().wait(processing_task_);
+    // proceeding to its destruction. If control thread was never started,
+    // the task was never scheduled.
+    if (context().has_runtime()) {
+        context().control_loop().wait_processing(processing_task_);
+    }
 }
 
 bool Sender::is_valid() const {
@@ -109,13 +158,30 @@ bool Sender::configure(slot_index_t slot_index,
 bool Sender::connect(slot_index_t slot_index,
                      address::Interface iface,
                      const address::EndpointUri& uri) {
-    core::Mutex::Lock lock(mutex_);
-
     roc_panic_if_not(is_valid());
 
     roc_panic_if(iface < 0);
     roc_panic_if(iface >= (int)address::Iface_Max);
 
+    // Resolve address before locking mutex, because resolving may take long
+    // (e.g. DNS lookup), and we don't want to block other node operations.
+    // Errors are reported below under the mutex.
+    address::SocketAddr resolved_addr;
+    bool resolved = false;
+
+    // Network and control threads are started on first bind or connect.
+    const bool started = context().start_runtime();
+
+    if (started && uri.verify(address::EndpointUri::Subset_Full)) {
+        netio::NetworkLoop::Tasks::ResolveEndpointAddress resolve_task(uri);
+        if (context().network_loop().schedule_and_wait(resolve_task)) {
+            resolved_addr = resolve_task.get_address();
+            resolved = true;
+        }
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
     roc_log(LogInfo, "sender node: connecting %s interface of slot %lu to %s",
             address::interface_to_str(iface), (unsigned long)slot_index,
             address::endpoint_uri_to_str(uri).c_str());
@@ -157,8 +223,17 @@ bool Sender::connect(slot_index_t slot_index,
         return false;
     }
 
-    netio::NetworkLoop::Tasks::ResolveEndpointAddress resolve_task(uri);
-    if (!context().network_loop().schedule_and_wait(resolve_task)) {
+    if (!started) {
+        roc_log(LogError,
+                "sender node:"
+                " can't connect %s interface of slot %lu:"
+                " can't start network thread",
+                address::interface_to_str(iface), (unsigned long)slot_index);
+        break_slot_(*slot);
+        return false;
+    }
+
+    if (!resolved) {
         roc_log(LogError,
                 "sender node:"
                 " can't connect %s interface of slot %lu:"
@@ -168,7 +243,11 @@ bool Sender::connect(slot_index_t slot_index,
         return false;
     }
 
-    const address::SocketAddr& address = resolve_task.get_address();
+    const address::SocketAddr& address = resolved_addr;
+
+    if (uri.proto() == address::Proto_RTP_Shm) {
+        return connect_shm_(*slot, iface, uri, address);
+    }
 
     Port& port = select_outgoing_port_(*slot, iface, address.family());
 
@@ -183,8 +262,11 @@ bool Sender::connect(slot_index_t slot_index,
     }
 
     if (!port.handle) {
-        netio::NetworkLoop::Tasks::AddUdpPort port_task(port.config);
-        if (!context().network_loop().schedule_and_wait(port_task)) {
+        netio::NetworkLoop& port_loop = context().select_network_loop();
+
+        netio::NetworkLoop::Tasks::AddUdpPort port_task(
+            port.config, &packet_factory(), context().packet_capture());
+        if (!port_loop.schedule_and_wait(port_task)) {
             roc_log(LogError,
                     "sender node:"
                     " can't connect %s interface of slot %lu:"
@@ -194,6 +276,7 @@ bool Sender::connect(slot_index_t slot_index,
             return false;
         }
 
+        port.loop = &port_loop;
         port.handle = port_task.get_handle();
 
         roc_log(LogInfo, "sender node: bound %s interface to %s",
@@ -203,7 +286,7 @@ bool Sender::connect(slot_index_t slot_index,
 
     if (!port.outbound_writer) {
         netio::NetworkLoop::Tasks::StartUdpSend send_task(port.handle);
-        if (!context().network_loop().schedule_and_wait(send_task)) {
+        if (!port.loop->schedule_and_wait(send_task)) {
             roc_log(LogError,
                     "sender node:"
                     " can't connect %s interface of slot %lu:"
@@ -216,8 +299,18 @@ bool Sender::connect(slot_index_t slot_index,
         port.outbound_writer = &send_task.get_outbound_writer();
     }
 
+    // Path MTU is optional and is used only if autotuning is enabled in pipeline.
+    size_t path_mtu = 0;
+
+    if (iface == address::Iface_AudioSource || iface == address::Iface_AudioRepair) {
+        netio::NetworkLoop::Tasks::QueryPathMtu mtu_task(address);
+        if (port.loop->schedule_and_wait(mtu_task)) {
+            path_mtu = mtu_task.get_mtu();
+        }
+    }
+
     pipeline::SenderLoop::Tasks::AddEndpoint endpoint_task(
-        slot->handle, iface, uri.proto(), address, *port.outbound_writer);
+        slot->handle, iface, uri.proto(), address, *port.outbound_writer, path_mtu);
     if (!pipeline_.schedule_and_wait(endpoint_task)) {
         roc_log(LogError,
                 "sender node:"
@@ -231,7 +324,7 @@ bool Sender::connect(slot_index_t slot_index,
     if (iface == address::Iface_AudioControl && endpoint_task.get_inbound_writer()) {
         netio::NetworkLoop::Tasks::StartUdpRecv recv_task(
             port.handle, *endpoint_task.get_inbound_writer());
-        if (!context().network_loop().schedule_and_wait(recv_task)) {
+        if (!port.loop->schedule_and_wait(recv_task)) {
             roc_log(LogError,
                     "sender node:"
                     " can't connect %s interface of slot %lu:"
@@ -301,15 +394,24 @@ bool Sender::get_metrics(slot_index_t slot_index,
         }
     }
 
-    pipeline::SenderLoop::Tasks::QuerySlot task(
-        slot->handle, slot_metrics_,
-        party_metrics_.size() != 0 ? party_metrics_.data() : NULL, party_metrics_size);
-    if (!pipeline_.schedule_and_wait(task)) {
-        roc_log(LogError,
-                "sender node:"
-                " can't get metrics of slot %lu: operation failed",
-                (unsigned long)slot_index);
-        return false;
+    // Fast path: read snapshot published by pipeline, without scheduling
+    // a task and disturbing pipeline thread.
+    // Slow path: if snapshot is not available, query pipeline directly.
+    if (!pipeline_.load_slot_metrics(
+            slot->handle, slot_metrics_,
+            party_metrics_.size() != 0 ? party_metrics_.data() : NULL,
+            party_metrics_size)) {
+        pipeline::SenderLoop::Tasks::QuerySlot task(
+            slot->handle, slot_metrics_,
+            party_metrics_.size() != 0 ? party_metrics_.data() : NULL,
+            party_metrics_size);
+        if (!pipeline_.schedule_and_wait(task)) {
+            roc_log(LogError,
+                    "sender node:"
+                    " can't get metrics of slot %lu: operation failed",
+                    (unsigned long)slot_index);
+            return false;
+        }
     }
 
     if (slot_metrics_arg) {
@@ -371,9 +473,38 @@ bool Sender::has_broken() {
 sndio::ISink& Sender::sink() {
     roc_panic_if_not(is_valid());
 
+    if (async_sink_) {
+        return *async_sink_;
+    }
+
     return pipeline_.sink();
 }
 
+bool Sender::write_ref(audio::Frame& frame,
+                       AsyncSink::release_func_t release_func,
+                       void* release_arg) {
+    roc_panic_if_not(is_valid());
+
+    if (async_sink_) {
+        return async_sink_->write_ref(frame, release_func, release_arg);
+    }
+
+    pipeline_.sink().write(frame);
+    release_func(release_arg);
+
+    return true;
+}
+
+AsyncSinkMetrics Sender::async_metrics() const {
+    roc_panic_if_not(is_valid());
+
+    if (async_sink_) {
+        return async_sink_->metrics();
+    }
+
+    return AsyncSinkMetrics();
+}
+
 bool Sender::check_compatibility_(address::Interface iface,
                                   const address::EndpointUri& uri) {
     if (used_interfaces_[iface] && used_protocols_[iface] != uri.proto()) {
@@ -446,10 +577,11 @@ void Sender::cleanup_slot_(Slot& slot) {
     for (size_t p = 0; p < address::Iface_Max; p++) {
         if (slot.ports[p].handle) {
             netio::NetworkLoop::Tasks::RemovePort task(slot.ports[p].handle);
-            if (!context().network_loop().schedule_and_wait(task)) {
+            if (!slot.ports[p].loop->schedule_and_wait(task)) {
                 roc_panic("sender node: can't remove network port of slot %lu",
                           (unsigned long)slot.index);
             }
+            slot.ports[p].loop = NULL;
             slot.ports[p].handle = NULL;
         }
     }
@@ -463,6 +595,73 @@ void Sender::break_slot_(Slot& slot) {
     cleanup_slot_(slot);
 }
 
+bool Sender::connect_shm_(Slot& slot,
+                          address::Interface iface,
+                          const address::EndpointUri& uri,
+                          const address::SocketAddr& address) {
+    // Shared memory ports are never shared between interfaces and don't have
+    // local address; the address only selects the ring to write to.
+    Port& port = slot.ports[iface];
+
+    if (port.handle) {
+        roc_log(LogError,
+                "sender node:"
+                " can't connect %s interface of slot %lu:"
+                " interface is already connected",
+                address::interface_to_str(iface), (unsigned long)slot.index);
+        break_slot_(slot);
+        return false;
+    }
+
+    netio::NetworkLoop& port_loop = context().select_network_loop();
+
+    port.shm_config.address = address;
+
+    netio::NetworkLoop::Tasks::AddShmPort port_task(port.shm_config, &packet_factory());
+    if (!port_loop.schedule_and_wait(port_task)) {
+        roc_log(LogError,
+                "sender node:"
+                " can't connect %s interface of slot %lu:"
+                " can't open shared memory port",
+                address::interface_to_str(iface), (unsigned long)slot.index);
+        break_slot_(slot);
+        return false;
+    }
+
+    port.loop = &port_loop;
+    port.handle = port_task.get_handle();
+
+    netio::NetworkLoop::Tasks::StartShmSend send_task(port.handle);
+    if (!port.loop->schedule_and_wait(send_task)) {
+        roc_log(LogError,
+                "sender node:"
+                " can't connect %s interface of slot %lu:"
+                " can't start sending on shared memory port",
+                address::interface_to_str(iface), (unsigned long)slot.index);
+        break_slot_(slot);
+        return false;
+    }
+
+    port.outbound_writer = &send_task.get_outbound_writer();
+
+    // Path MTU is not applicable, packet size is limited by ring slot size.
+    pipeline::SenderLoop::Tasks::AddEndpoint endpoint_task(
+        slot.handle, iface, uri.proto(), address, *port.outbound_writer, 0);
+    if (!pipeline_.schedule_and_wait(endpoint_task)) {
+        roc_log(LogError,
+                "sender node:"
+                " can't connect %s interface of slot %lu:"
+                " can't add endpoint to pipeline",
+                address::interface_to_str(iface), (unsigned long)slot.index);
+        break_slot_(slot);
+        return false;
+    }
+
+    update_compatibility_(iface, uri);
+
+    return true;
+}
+
 Sender::Port& Sender::select_outgoing_port_(Slot& slot,
                                             address::Interface iface,
                                             address::AddrFamily family) {
@@ -543,11 +742,11 @@ bool Sender::setup_outgoing_port_(Port& port,
 
 void Sender::schedule_task_processing(pipeline::PipelineLoop&,
                                       core::nanoseconds_t deadline) {
-    context().control_loop().schedule_at(processing_task_, deadline, NULL);
+    context().control_loop().schedule_processing_at(processing_task_, deadline);
 }
 
 void Sender::cancel_task_processing(pipeline::PipelineLoop&) {
-    context().control_loop().async_cancel(processing_task_);
+    context().control_loop().async_cancel_processing(processing_task_);
 }
 
 } // namespace node
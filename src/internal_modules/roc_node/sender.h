@@ -18,10 +18,12 @@
 #include "roc_core/allocation_policy.h"
 #include "roc_core/hashmap.h"
 #include "roc_core/mutex.h"
+#include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_core/slab_pool.h"
 #include "roc_core/stddefs.h"
+#include "roc_node/async_sink.h"
 #include "roc_node/context.h"
 #include "roc_node/node.h"
 #include "roc_packet/iwriter.h"
@@ -38,7 +40,12 @@ public:
     typedef uint64_t slot_index_t;
 
     //! Initialize.
-    Sender(Context& context, const pipeline::SenderSinkConfig& pipeline_config);
+    //! @remarks
+    //!  If @p async_config has non-zero queue length, sink() enqueues frames,
+    //!  and pipeline is run by writer thread of context.
+    Sender(Context& context,
+           const pipeline::SenderSinkConfig& pipeline_config,
+           const AsyncSinkConfig& async_config = AsyncSinkConfig());
 
     //! Deinitialize.
     ~Sender();
@@ -86,15 +93,36 @@ public:
     //! Get sender sink.
     sndio::ISink& sink();
 
+    //! Write frame by reference.
+    //! @remarks
+    //!  If asynchronous write is enabled, frame is enqueued without copying
+    //!  and @p release_func is invoked later from writer thread. Otherwise
+    //!  frame is written synchronously and @p release_func is invoked before
+    //!  returning.
+    //! @returns
+    //!  false if frame was not accepted; in this case callback is not invoked.
+    ROC_ATTR_NODISCARD bool write_ref(audio::Frame& frame,
+                                      AsyncSink::release_func_t release_func,
+                                      void* release_arg);
+
+    //! Get metrics of asynchronous write.
+    //! @remarks
+    //!  Returns zero metrics if asynchronous write is disabled.
+    //!  Can be called from any thread.
+    AsyncSinkMetrics async_metrics() const;
+
 private:
     struct Port {
         netio::UdpConfig config;
         netio::UdpConfig orig_config;
+        netio::ShmConfig shm_config;
+        netio::NetworkLoop* loop;
         netio::NetworkLoop::PortHandle handle;
         packet::IWriter* outbound_writer;
 
         Port()
-            : handle(NULL)
+            : loop(NULL)
+            , handle(NULL)
             , outbound_writer(NULL) {
         }
     };
@@ -134,6 +162,11 @@ private:
     void cleanup_slot_(Slot& slot);
     void break_slot_(Slot& slot);
 
+    bool connect_shm_(Slot& slot,
+                      address::Interface iface,
+                      const address::EndpointUri& uri,
+                      const address::SocketAddr& address);
+
     Port&
     select_outgoing_port_(Slot& slot, address::Interface, address::AddrFamily family);
     bool setup_outgoing_port_(Port& port,
@@ -149,6 +182,8 @@ private:
     pipeline::SenderLoop pipeline_;
     ctl::ControlLoop::Tasks::PipelineProcessing processing_task_;
 
+    core::Optional<AsyncSink> async_sink_;
+
     core::SlabPool<Slot> slot_pool_;
     core::Hashmap<Slot> slot_map_;
 
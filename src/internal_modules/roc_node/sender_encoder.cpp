@@ -19,13 +19,13 @@ namespace node {
 SenderEncoder::SenderEncoder(Context& context,
                              const pipeline::SenderSinkConfig& pipeline_config)
     : Node(context)
-    , packet_factory_(context.packet_pool(), context.packet_buffer_pool())
+    , packet_factory_(packet_pool(), packet_buffer_pool())
     , pipeline_(*this,
                 pipeline_config,
                 context.encoding_map(),
-                context.packet_pool(),
-                context.packet_buffer_pool(),
-                context.frame_buffer_pool(),
+                packet_pool(),
+                packet_buffer_pool(),
+                frame_buffer_pool(),
                 context.arena())
     , slot_(NULL)
     , processing_task_(pipeline_)
@@ -37,6 +37,8 @@ SenderEncoder::SenderEncoder(Context& context,
         return;
     }
 
+    add_small_frame_buffer_pools(pipeline_);
+
     pipeline::SenderSlotConfig slot_config;
 
     pipeline::SenderLoop::Tasks::CreateSlot slot_task(slot_config);
@@ -66,8 +68,11 @@ SenderEncoder::~SenderEncoder() {
     }
 
     // Then wait until processing task is fully completed, before
-    // proceeding to its destruction.
-    context().control_loop().wait(processing_task_);
+    // proceeding to its destruction. If control thread was never started,
+    // the task was never scheduled.
+    if (context().has_runtime()) {
+        context().control_loop().wait_processing(processing_task_);
+    }
 }
 
 bool SenderEncoder::is_valid() const {
@@ -188,6 +193,29 @@ status::StatusCode SenderEncoder::read_packet(address::Interface iface,
     return reader->read(packet);
 }
 
+status::StatusCode SenderEncoder::read_packets(address::Interface iface,
+                                               packet::PacketPtr* packets,
+                                               size_t max_packets,
+                                               size_t& n_packets) {
+    roc_panic_if_not(is_valid());
+
+    roc_panic_if(iface < 0);
+    roc_panic_if(iface >= (int)address::Iface_Max);
+
+    n_packets = 0;
+
+    if (!endpoint_readers_[iface]) {
+        roc_log(LogError,
+                "sender encoder node:"
+                " can't read from %s interface: interface not activated",
+                address::interface_to_str(iface));
+        // TODO(gh-183): return StatusNotFound
+        return status::StatusNoData;
+    }
+
+    return endpoint_queues_[iface]->read_batch(packets, max_packets, n_packets);
+}
+
 status::StatusCode SenderEncoder::write_packet(address::Interface iface,
                                                const packet::PacketPtr& packet) {
     roc_panic_if_not(is_valid());
@@ -225,11 +253,11 @@ sndio::ISink& SenderEncoder::sink() {
 
 void SenderEncoder::schedule_task_processing(pipeline::PipelineLoop&,
                                              core::nanoseconds_t deadline) {
-    context().control_loop().schedule_at(processing_task_, deadline, NULL);
+    context().control_loop().schedule_processing_at(processing_task_, deadline);
 }
 
 void SenderEncoder::cancel_task_processing(pipeline::PipelineLoop&) {
-    context().control_loop().async_cancel(processing_task_);
+    context().control_loop().async_cancel_processing(processing_task_);
 }
 
 } // namespace node
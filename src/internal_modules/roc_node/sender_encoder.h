@@ -71,6 +71,15 @@ public:
     ROC_ATTR_NODISCARD status::StatusCode read_packet(address::Interface iface,
                                                       packet::PacketPtr& packet);
 
+    //! Read up to @p max_packets encoded packets at once.
+    //! @remarks
+    //!  Performs interface lookup and queue locking only once per batch.
+    //!  Sets @p n_packets to the number of packets actually read.
+    ROC_ATTR_NODISCARD status::StatusCode read_packets(address::Interface iface,
+                                                       packet::PacketPtr* packets,
+                                                       size_t max_packets,
+                                                       size_t& n_packets);
+
     //! Write packet for decoding.
     //! @note
     //!  Typically used to deliver control packets with receiver feedback.
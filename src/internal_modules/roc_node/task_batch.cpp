@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_node/task_batch.h"
+
+namespace roc {
+namespace node {
+
+TaskBatch::TaskBatch()
+    : pending_(1) {
+}
+
+void TaskBatch::schedule(netio::NetworkLoop& loop, netio::NetworkTask& task) {
+    ++pending_;
+    loop.schedule(task, *this);
+}
+
+void TaskBatch::schedule(pipeline::PipelineLoop& loop, pipeline::PipelineTask& task) {
+    ++pending_;
+    loop.schedule(task, *this);
+}
+
+void TaskBatch::wait() {
+    // Drop our reference. If tasks are still pending, the last completed
+    // one will post semaphore.
+    if (--pending_ != 0) {
+        sem_.wait();
+    }
+
+    pending_ = 1;
+}
+
+void TaskBatch::network_task_completed(netio::NetworkTask&) {
+    complete_();
+}
+
+void TaskBatch::pipeline_task_completed(pipeline::PipelineTask&) {
+    complete_();
+}
+
+void TaskBatch::complete_() {
+    if (--pending_ == 0) {
+        sem_.post();
+    }
+}
+
+} // namespace node
+} // namespace roc
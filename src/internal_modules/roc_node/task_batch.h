@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_node/task_batch.h
+//! @brief Batch of network and pipeline tasks.
+
+#ifndef ROC_NODE_TASK_BATCH_H_
+#define ROC_NODE_TASK_BATCH_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/stddefs.h"
+#include "roc_netio/inetwork_task_completer.h"
+#include "roc_netio/network_loop.h"
+#include "roc_pipeline/ipipeline_task_completer.h"
+#include "roc_pipeline/pipeline_loop.h"
+
+namespace roc {
+namespace node {
+
+//! Batch of network and pipeline tasks.
+//! @remarks
+//!  Tasks are scheduled asynchronously, and wait() blocks until all of them
+//!  are completed. Loops process tasks queued together in one go, so instead
+//!  of a wakeup and a round-trip per task, there is one per batch.
+class TaskBatch : public netio::INetworkTaskCompleter,
+                  public pipeline::IPipelineTaskCompleter,
+                  public core::NonCopyable<> {
+public:
+    //! Initialize empty batch.
+    TaskBatch();
+
+    //! Schedule network task.
+    //! @remarks
+    //!  The task should not be destroyed until wait() returns.
+    void schedule(netio::NetworkLoop& loop, netio::NetworkTask& task);
+
+    //! Schedule pipeline task.
+    //! @remarks
+    //!  The task should not be destroyed until wait() returns.
+    void schedule(pipeline::PipelineLoop& loop, pipeline::PipelineTask& task);
+
+    //! Wait until all scheduled tasks are completed.
+    //! @remarks
+    //!  After this, batch is empty and can be used again.
+    void wait();
+
+private:
+    virtual void network_task_completed(netio::NetworkTask&);
+    virtual void pipeline_task_completed(pipeline::PipelineTask&);
+
+    void complete_();
+
+    // number of scheduled tasks plus one reference held by wait()
+    core::Atomic<int> pending_;
+    core::Semaphore sem_;
+};
+
+} // namespace node
+} // namespace roc
+
+#endif // ROC_NODE_TASK_BATCH_H_
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/address_sharder.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+core::hashsum_t hash_host(const address::SocketAddr& addr) {
+    switch (addr.family()) {
+    case address::Family_IPv4:
+        return core::hashsum_mem(&((const sockaddr_in*)addr.saddr())->sin_addr,
+                                 sizeof(in_addr));
+
+    case address::Family_IPv6:
+        return core::hashsum_mem(&((const sockaddr_in6*)addr.saddr())->sin6_addr,
+                                 sizeof(in6_addr));
+
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+AddressSharder::AddressSharder(core::IArena& arena)
+    : shards_(arena) {
+}
+
+bool AddressSharder::add_shard(IWriter& writer) {
+    if (!shards_.push_back(&writer)) {
+        roc_log(LogError, "address sharder: can't allocate shard");
+        return false;
+    }
+
+    return true;
+}
+
+size_t AddressSharder::num_shards() const {
+    return shards_.size();
+}
+
+size_t AddressSharder::select_shard(const Packet& packet) const {
+    if (shards_.size() < 2 || !packet.udp()) {
+        return 0;
+    }
+
+    return hash_host(packet.udp()->src_addr) % shards_.size();
+}
+
+status::StatusCode AddressSharder::write(const PacketPtr& packet) {
+    roc_panic_if(!packet);
+    roc_panic_if_msg(shards_.size() == 0, "address sharder: no shards");
+
+    return shards_[select_shard(*packet)]->write(packet);
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/address_sharder.h
+//! @brief Distribute packets between writers by sender address.
+
+#ifndef ROC_PACKET_ADDRESS_SHARDER_H_
+#define ROC_PACKET_ADDRESS_SHARDER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace packet {
+
+//! Distribute packets between writers by sender address.
+//!
+//! Packets are steered to one of the shards by hash of the sender IP address.
+//! Port is not hashed, so source, repair, and control packets of the same
+//! sender always go to the same shard, even if they're sent from different
+//! sockets. Packets without UDP address go to the first shard.
+//!
+//! Can be used from network thread to split packets of one port between
+//! several pipelines. Shards should be thread-safe writers, e.g. queues.
+class AddressSharder : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit AddressSharder(core::IArena& arena);
+
+    //! Add shard.
+    //! @remarks
+    //!  All shards should be added before writing first packet.
+    ROC_ATTR_NODISCARD bool add_shard(IWriter& writer);
+
+    //! Get number of shards.
+    size_t num_shards() const;
+
+    //! Get index of shard for packet.
+    size_t select_shard(const Packet& packet) const;
+
+    //! Write packet to its shard.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+private:
+    core::Array<IWriter*, 8> shards_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_ADDRESS_SHARDER_H_
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/bundler.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Bundler::Bundler(IWriter& writer,
+                 PacketFactory& packet_factory,
+                 const BundlerConfig& config)
+    : writer_(writer)
+    , packet_factory_(packet_factory)
+    , pending_size_(0)
+    , max_size_(std::min(config.max_bundle_size, packet_factory.packet_buffer_size())) {
+    roc_log(LogDebug, "bundler: initializing: max_bundle_size=%lu",
+            (unsigned long)max_size_);
+}
+
+status::StatusCode Bundler::write(const PacketPtr& packet) {
+    roc_panic_if(!packet);
+
+    if (!packet->has_flags(Packet::FlagComposed)) {
+        roc_panic("bundler: unexpected packet: should be composed");
+    }
+
+    const size_t size = LengthSize + packet->buffer().size();
+
+    if (!packet->udp() || size - LengthSize > MaxPacketSize || size > max_size_) {
+        // Packet can't be bundled, send it alone.
+        const status::StatusCode code = flush();
+        if (code != status::StatusOK) {
+            return code;
+        }
+        return writer_.write(packet);
+    }
+
+    if (PacketPtr first = pending_.front()) {
+        if (pending_size_ + size > max_size_
+            || first->udp()->dst_addr != packet->udp()->dst_addr) {
+            const status::StatusCode code = flush();
+            if (code != status::StatusOK) {
+                return code;
+            }
+        }
+    }
+
+    pending_.push_back(*packet);
+    pending_size_ += size;
+
+    return status::StatusOK;
+}
+
+status::StatusCode Bundler::flush() {
+    if (pending_.size() == 0) {
+        return status::StatusOK;
+    }
+
+    if (pending_.size() == 1) {
+        return write_pending_();
+    }
+
+    return write_bundle_();
+}
+
+status::StatusCode Bundler::write_bundle_() {
+    PacketPtr bundle = packet_factory_.new_packet();
+    core::Slice<uint8_t> buffer = packet_factory_.new_packet_buffer();
+
+    if (!bundle || !buffer) {
+        roc_log(LogError, "bundler: can't allocate bundle, sending packets separately");
+        return write_pending_();
+    }
+
+    buffer.reslice(0, pending_size_);
+
+    const Packet& first = *pending_.front();
+
+    bundle->add_flags(Packet::FlagUDP | Packet::FlagPrepared | Packet::FlagComposed);
+    bundle->udp()->src_addr = first.udp()->src_addr;
+    bundle->udp()->dst_addr = first.udp()->dst_addr;
+    bundle->udp()->send_timestamp = first.udp()->send_timestamp;
+
+    uint8_t* data = buffer.data();
+
+    while (PacketPtr pp = pending_.front()) {
+        pending_.remove(*pp);
+
+        const size_t size = pp->buffer().size();
+
+        data[0] = uint8_t((size >> 8) & 0x3F);
+        data[1] = uint8_t(size & 0xFF);
+        memcpy(data + LengthSize, pp->buffer().data(), size);
+
+        data += LengthSize + size;
+    }
+
+    roc_panic_if(data != buffer.data() + buffer.size());
+
+    bundle->set_buffer(buffer);
+    pending_size_ = 0;
+
+    return writer_.write(bundle);
+}
+
+status::StatusCode Bundler::write_pending_() {
+    pending_size_ = 0;
+
+    while (PacketPtr pp = pending_.front()) {
+        pending_.remove(*pp);
+
+        const status::StatusCode code = writer_.write(pp);
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
+    return status::StatusOK;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/bundler.h
+//! @brief Combines several packets into one datagram.
+
+#ifndef ROC_PACKET_BUNDLER_H_
+#define ROC_PACKET_BUNDLER_H_
+
+#include "roc_core/list.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+
+//! Bundler parameters.
+struct BundlerConfig {
+    //! Maximum size of bundle, in bytes.
+    //! @remarks
+    //!  Should not exceed path MTU minus IP and UDP headers, otherwise
+    //!  bundles will be fragmented.
+    size_t max_bundle_size;
+
+    BundlerConfig()
+        : max_bundle_size(1472) {
+    }
+};
+
+//! Combines several packets into one datagram.
+//!
+//! Reduces packet rate and per-datagram overhead (IP and UDP headers, syscalls)
+//! when many small packets are sent to the same address, e.g. packets of
+//! multiple streams or packets generated for one frame.
+//!
+//! Bundle is a sequence of composed packets, each prefixed with its length:
+//!
+//! @code
+//!   0                   1                   2                   3
+//!   0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!  |0 0|   length of packet 1      |  packet 1 ...                 |
+//!  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!  |0 0|   length of packet 2      |  packet 2 ...                 |
+//!  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+//!
+//! This is the framing from RFC 4571, with length limited to 14 bits. First two
+//! bits of RTP packet hold protocol version 2, hence receiver can distinguish
+//! bundle from a plain RTP packet, see Unbundler.
+//!
+//! Packets are accumulated until flush() is called, or until next packet doesn't
+//! fit into bundle or has different destination. If only one packet is pending,
+//! it is sent as is, without bundle framing.
+class Bundler : public IWriter, public core::NonCopyable<> {
+public:
+    enum {
+        //! Size of length prefix.
+        LengthSize = 2,
+
+        //! Maximum size of packet that can be bundled.
+        MaxPacketSize = 0x3FFF
+    };
+
+    //! Initialize.
+    //! @remarks
+    //!  Bundles are allocated using @p packet_factory and written to @p writer.
+    Bundler(IWriter& writer, PacketFactory& packet_factory, const BundlerConfig& config);
+
+    //! Write packet.
+    //! @remarks
+    //!  Packet should be composed and have UDP destination address.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+    //! Send pending packets to output writer.
+    ROC_ATTR_NODISCARD status::StatusCode flush();
+
+private:
+    status::StatusCode write_bundle_();
+    status::StatusCode write_pending_();
+
+    IWriter& writer_;
+    PacketFactory& packet_factory_;
+
+    core::List<Packet> pending_;
+    size_t pending_size_;
+
+    size_t max_size_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_BUNDLER_H_
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/capture_ring.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+const char* capture_point_to_str(CapturePoint point) {
+    switch (point) {
+    case CapturePoint_Ingress:
+        return "ingress";
+    case CapturePoint_Egress:
+        return "egress";
+    case CapturePoint_Repair:
+        return "repair";
+    case CapturePoint_Max:
+        break;
+    }
+
+    return "invalid";
+}
+
+CaptureRing::CaptureRing(const CaptureConfig& config, core::IArena& arena)
+    : arena_(arena)
+    , slots_(NULL)
+    , num_slots_(0)
+    , snap_len_(std::min(config.snap_len, (size_t)CaptureRecord::MaxSnapLen))
+    , write_pos_(0)
+    , num_lost_(0) {
+    if (config.num_records == 0) {
+        roc_log(LogError, "capture ring: number of records should be non-zero");
+        return;
+    }
+
+    // Power of two, so that slot index doesn't jump when position wraps.
+    num_slots_ = 1;
+    while (num_slots_ < config.num_records) {
+        num_slots_ *= 2;
+    }
+
+    slots_ = (Slot*)arena_.allocate(sizeof(Slot) * num_slots_);
+    if (!slots_) {
+        roc_log(LogError, "capture ring: can't allocate %lu records",
+                (unsigned long)num_slots_);
+        return;
+    }
+
+    for (size_t n = 0; n < num_slots_; n++) {
+        new (&slots_[n]) Slot();
+    }
+
+    roc_log(LogDebug, "capture ring: initializing: num_records=%lu snap_len=%lu",
+            (unsigned long)num_slots_, (unsigned long)snap_len_);
+}
+
+CaptureRing::~CaptureRing() {
+    if (slots_) {
+        for (size_t n = 0; n < num_slots_; n++) {
+            slots_[n].~Slot();
+        }
+        arena_.deallocate(slots_);
+    }
+}
+
+bool CaptureRing::is_valid() const {
+    return slots_ != NULL;
+}
+
+void CaptureRing::capture(const Packet& packet, CapturePoint point, unsigned flags) {
+    roc_panic_if(!is_valid());
+
+    CaptureRecord record;
+
+    record.seqnum = write_pos_++;
+    record.timestamp = core::timestamp(core::ClockUnix);
+    record.point = point;
+    record.flags = flags;
+    record.source_id = packet.has_source_id() ? packet.source_id() : 0;
+
+    if (const UDP* udp = packet.udp()) {
+        record.src_addr = udp->src_addr;
+        record.dst_addr = udp->dst_addr;
+    }
+
+    const core::Slice<uint8_t>& buffer = packet.buffer();
+
+    record.orig_len = buffer ? buffer.size() : 0;
+    record.cap_len = std::min(record.orig_len, snap_len_);
+    if (record.cap_len != 0) {
+        memcpy(record.data, buffer.data(), record.cap_len);
+    }
+
+    Slot& slot = slots_[record.seqnum & (num_slots_ - 1)];
+
+    core::seqlock_version_t ver;
+    if (!slot.lock.try_store(ver, &slot.record, sizeof(slot.record), &record)) {
+        num_lost_++;
+    }
+}
+
+uint32_t CaptureRing::first_seqnum() const {
+    roc_panic_if(!is_valid());
+
+    // May wrap, records which were not written yet are skipped by read().
+    return write_pos_ - (uint32_t)num_slots_;
+}
+
+uint32_t CaptureRing::end_seqnum() const {
+    roc_panic_if(!is_valid());
+
+    return write_pos_;
+}
+
+bool CaptureRing::read(uint32_t seqnum, CaptureRecord& record) const {
+    roc_panic_if(!is_valid());
+
+    const Slot& slot = slots_[seqnum & (num_slots_ - 1)];
+
+    core::seqlock_version_t ver;
+    if (!slot.lock.try_load_repeat(ver, &slot.record, sizeof(slot.record), &record)) {
+        return false;
+    }
+
+    // Empty slot, or slot already reused for newer record.
+    if (!core::seqlock_version_is_valid(ver) || ver == 0 || record.seqnum != seqnum) {
+        return false;
+    }
+
+    return true;
+}
+
+size_t CaptureRing::num_captured() const {
+    return write_pos_;
+}
+
+size_t CaptureRing::num_lost() const {
+    return num_lost_;
+}
+
+} // namespace packet
+} // namespace roc
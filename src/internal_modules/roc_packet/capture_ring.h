@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/capture_ring.h
+//! @brief In-process packet capture ring.
+
+#ifndef ROC_PACKET_CAPTURE_RING_H_
+#define ROC_PACKET_CAPTURE_RING_H_
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/seqlock_impl.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace packet {
+
+//! Point of pipeline where packet was captured.
+enum CapturePoint {
+    //! Packet received from network.
+    CapturePoint_Ingress,
+
+    //! Packet sent to network.
+    CapturePoint_Egress,
+
+    //! Packet after FEC repair, in the order it's passed to depacketizer.
+    CapturePoint_Repair,
+
+    //! Number of capture points.
+    CapturePoint_Max
+};
+
+//! Get capture point name.
+const char* capture_point_to_str(CapturePoint point);
+
+//! Pipeline annotations of captured packet.
+enum CaptureFlag {
+    //! Packet arrived after it was needed.
+    CaptureFlag_Late = (1 << 0),
+
+    //! Packet was restored from repair packets.
+    CaptureFlag_Repaired = (1 << 1),
+
+    //! Packet was dropped at capture point.
+    CaptureFlag_Dropped = (1 << 2)
+};
+
+//! Packet capture parameters.
+struct CaptureConfig {
+    //! Number of records kept in ring.
+    //! Rounded up to a power of two. If zero, capture is disabled.
+    size_t num_records;
+
+    //! Maximum number of bytes of packet kept in record.
+    //! Longer packets are truncated. Should not exceed CaptureRecord::MaxSnapLen.
+    size_t snap_len;
+
+    CaptureConfig()
+        : num_records(0)
+        , snap_len(128) {
+    }
+};
+
+//! Captured packet.
+struct CaptureRecord {
+    //! Maximum number of captured bytes.
+    enum { MaxSnapLen = 256 };
+
+    //! Sequential number of record in ring.
+    uint32_t seqnum;
+
+    //! Unix time when packet was captured.
+    core::nanoseconds_t timestamp;
+
+    //! Where packet was captured.
+    CapturePoint point;
+
+    //! Pipeline annotations, mask of CaptureFlag values.
+    unsigned flags;
+
+    //! Stream source identifier (session), or zero if unknown.
+    stream_source_t source_id;
+
+    //! Source address, if known.
+    address::SocketAddr src_addr;
+
+    //! Destination address, if known.
+    address::SocketAddr dst_addr;
+
+    //! Original packet size.
+    size_t orig_len;
+
+    //! Number of captured bytes.
+    size_t cap_len;
+
+    //! First cap_len bytes of packet.
+    uint8_t data[MaxSnapLen];
+};
+
+//! In-process packet capture ring.
+//!
+//! @remarks
+//!  Keeps headers and truncated payloads of last captured packets together
+//!  with pipeline annotations. Captures from network threads and pipeline
+//!  threads go to the same ring, so dump shows how packet travelled from
+//!  socket to depacketizer.
+//!
+//! @remarks
+//!  Writing is lock-free and wait-free and never allocates: every record is
+//!  stored into its own pre-allocated slot protected by a seqlock. When ring
+//!  is full, oldest records are overwritten. If two writers wrapped around to
+//!  the same slot at the same time, one of the records is lost.
+//!
+//! @remarks
+//!  Reading can be done from any thread concurrently with writing. Records
+//!  overwritten while being read are skipped.
+class CaptureRing : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    CaptureRing(const CaptureConfig& config, core::IArena& arena);
+
+    //! Deinitialize.
+    ~CaptureRing();
+
+    //! Check if ring was successfully constructed.
+    bool is_valid() const;
+
+    //! Capture packet.
+    //! @remarks
+    //!  Copies UDP addresses, stream source and first snap_len bytes of buffer.
+    void capture(const Packet& packet, CapturePoint point, unsigned flags);
+
+    //! Get number of the oldest record which may be still in ring.
+    //! @remarks
+    //!  Records should be iterated from first_seqnum() until end_seqnum()
+    //!  using != comparison, since numbers wrap.
+    uint32_t first_seqnum() const;
+
+    //! Get number of the next record to be written.
+    uint32_t end_seqnum() const;
+
+    //! Read record with given number.
+    //! @returns
+    //!  false if record was already overwritten or is being written right now.
+    bool read(uint32_t seqnum, CaptureRecord& record) const;
+
+    //! Get total number of captured packets.
+    size_t num_captured() const;
+
+    //! Get number of records lost because of concurrent writes to same slot.
+    size_t num_lost() const;
+
+private:
+    struct Slot {
+        core::SeqlockImpl lock;
+        CaptureRecord record;
+    };
+
+    core::IArena& arena_;
+
+    Slot* slots_;
+    size_t num_slots_;
+    size_t snap_len_;
+
+    core::Atomic<uint32_t> write_pos_;
+    core::Atomic<size_t> num_lost_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_CAPTURE_RING_H_
@@ -31,6 +31,38 @@ status::StatusCode ConcurrentQueue::read(PacketPtr& ptr) {
         return status::StatusNoData;
     }
 
+    ptr->make_local();
+
+    return status::StatusOK;
+}
+
+status::StatusCode
+ConcurrentQueue::read_batch(PacketPtr* packets, size_t max_packets, size_t& n_packets) {
+    if (!packets && max_packets != 0) {
+        roc_panic("concurrent queue: packets array is null");
+    }
+
+    if (write_sem_) {
+        roc_panic("concurrent queue: batch reads are not supported in blocking mode");
+    }
+
+    n_packets = 0;
+
+    core::Mutex::Lock lock(read_mutex_);
+
+    while (n_packets < max_packets) {
+        packets[n_packets] = queue_.pop_front_exclusive();
+        if (!packets[n_packets]) {
+            break;
+        }
+        packets[n_packets]->make_local();
+        n_packets++;
+    }
+
+    if (n_packets == 0) {
+        return status::StatusNoData;
+    }
+
     return status::StatusOK;
 }
 
@@ -39,6 +71,7 @@ status::StatusCode ConcurrentQueue::write(const PacketPtr& packet) {
         roc_panic("concurrent queue: packet is null");
     }
 
+    packet->make_shared();
     queue_.push_back(*packet);
 
     if (write_sem_) {
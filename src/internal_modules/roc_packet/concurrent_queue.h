@@ -25,6 +25,10 @@ namespace roc {
 namespace packet {
 
 //! Concurrent blocking packet queue.
+//!
+//! Switches packet reference counter to shared mode when packet is written,
+//! and back to local mode when it's read, if reader holds the only reference.
+//! See core::RefCountedImpl for details.
 class ConcurrentQueue : public IReader, public IWriter, public core::NonCopyable<> {
 public:
     //! Queue mode.
@@ -43,6 +47,13 @@ public:
     //! @see Mode.
     virtual ROC_ATTR_NODISCARD status::StatusCode read(PacketPtr&);
 
+    //! Read up to @p max_packets packets at once.
+    //! Acquires read lock only once for the whole batch. Can be used only
+    //! with non-blocking queue. Sets @p n_packets to the number of packets
+    //! actually read. Returns StatusNoData if queue is empty.
+    ROC_ATTR_NODISCARD status::StatusCode
+    read_batch(PacketPtr* packets, size_t max_packets, size_t& n_packets);
+
     //! Add packet to the queue.
     //! Wait-free operation.
     virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
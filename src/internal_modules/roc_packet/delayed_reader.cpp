@@ -18,9 +18,10 @@ namespace packet {
 
 DelayedReader::DelayedReader(IReader& reader,
                              core::nanoseconds_t target_delay,
-                             const audio::SampleSpec& sample_spec)
+                             const audio::SampleSpec& sample_spec,
+                             core::IArena& arena)
     : reader_(reader)
-    , queue_(0)
+    , queue_(arena, 0)
     , delay_(0)
     , started_(false)
     , sample_spec_(sample_spec)
@@ -58,6 +59,10 @@ status::StatusCode DelayedReader::read(PacketPtr& ptr) {
     return reader_.read(ptr);
 }
 
+core::OccupancyMetrics DelayedReader::metrics() const {
+    return queue_.metrics();
+}
+
 status::StatusCode DelayedReader::fetch_packets_() {
     PacketPtr pp;
     for (;;) {
@@ -14,6 +14,7 @@
 
 #include "roc_audio/sample_spec.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/occupancy_metrics.h"
 #include "roc_core/time.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/sorted_queue.h"
@@ -33,9 +34,11 @@ public:
     //!  - @p reader is used to read packets
     //!  - @p target_delay is the delay to insert before first packet
     //!  - @p sample_spec is the specifications of incoming packets
+    //!  - @p arena is used to allocate packet queue
     DelayedReader(IReader& reader,
                   core::nanoseconds_t target_delay,
-                  const audio::SampleSpec& sample_spec);
+                  const audio::SampleSpec& sample_spec,
+                  core::IArena& arena);
 
     //! Check if object was constructed successfully.
     bool is_valid() const;
@@ -43,6 +46,11 @@ public:
     //! Read packet.
     virtual ROC_ATTR_NODISCARD status::StatusCode read(PacketPtr&);
 
+    //! Get occupancy of queue, in packets.
+    //! @remarks
+    //!  Packets are queued only until delay is reached.
+    core::OccupancyMetrics metrics() const;
+
 private:
     status::StatusCode fetch_packets_();
     status::StatusCode read_queued_packet_(PacketPtr&);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/duplicate_filter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+DuplicateFilter::DuplicateFilter(IWriter& writer,
+                                 core::IArena& arena,
+                                 const DuplicateFilterConfig& config)
+    : writer_(writer)
+    , window_(arena)
+    , n_dropped_(0)
+    , valid_(false) {
+    if (config.window_size == 0) {
+        roc_log(LogError, "duplicate filter: invalid config: window_size=0");
+        return;
+    }
+
+    if (!window_.resize(config.window_size)) {
+        roc_log(LogError, "duplicate filter: can't allocate window: size=%lu",
+                (unsigned long)config.window_size);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool DuplicateFilter::is_valid() const {
+    return valid_;
+}
+
+size_t DuplicateFilter::num_dropped() const {
+    return n_dropped_;
+}
+
+status::StatusCode DuplicateFilter::write(const PacketPtr& packet) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!packet);
+
+    if (!packet->rtp()) {
+        return writer_.write(packet);
+    }
+
+    const seqnum_t seqnum = packet->rtp()->seqnum;
+    uint32_t& slot = window_[seqnum % window_.size()];
+
+    if (slot == (uint32_t)seqnum + 1) {
+        roc_log(LogTrace, "duplicate filter: dropping duplicate packet: sn=%lu",
+                (unsigned long)seqnum);
+        n_dropped_++;
+        return status::StatusOK;
+    }
+
+    const status::StatusCode code = writer_.write(packet);
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    slot = (uint32_t)seqnum + 1;
+
+    return status::StatusOK;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/duplicate_filter.h
+//! @brief Drops duplicate packets.
+
+#ifndef ROC_PACKET_DUPLICATE_FILTER_H_
+#define ROC_PACKET_DUPLICATE_FILTER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace packet {
+
+//! Duplicate filter parameters.
+struct DuplicateFilterConfig {
+    //! Number of recent seqnums remembered.
+    //! @remarks
+    //!  Should cover maximum difference of delays between paths, in packets.
+    //!  Duplicates arriving later than that are not detected here.
+    size_t window_size;
+
+    DuplicateFilterConfig()
+        : window_size(512) {
+    }
+};
+
+//! Drops duplicate packets.
+//!
+//! Used when the same stream is received over several paths, e.g. when
+//! sender duplicates packets to redundant network interfaces. First copy
+//! of every packet is passed to nested writer, and the rest are dropped.
+//!
+//! Recent seqnums are kept in a ring indexed by seqnum, so every packet is
+//! checked in constant time. Packets without RTP header are passed as is.
+class DuplicateFilter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    DuplicateFilter(IWriter& writer,
+                    core::IArena& arena,
+                    const DuplicateFilterConfig& config);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get number of dropped duplicates.
+    size_t num_dropped() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Writes packet to nested writer, unless it was already written.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+private:
+    IWriter& writer_;
+
+    // Seqnum plus one, or zero if slot is empty.
+    core::Array<uint32_t> window_;
+
+    size_t n_dropped_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_DUPLICATE_FILTER_H_
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/fanout.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Fanout::Fanout(PacketFactory& packet_factory, core::IArena& arena)
+    : packet_factory_(packet_factory)
+    , writers_(arena) {
+}
+
+bool Fanout::has_output(IWriter& writer) const {
+    for (size_t n = 0; n < writers_.size(); n++) {
+        if (writers_[n] == &writer) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Fanout::add_output(IWriter& writer) {
+    roc_panic_if(has_output(writer));
+
+    if (!writers_.push_back(&writer)) {
+        roc_log(LogError, "fanout: can't allocate output");
+        return false;
+    }
+
+    return true;
+}
+
+void Fanout::remove_output(IWriter& writer) {
+    for (size_t n = 0; n < writers_.size(); n++) {
+        if (writers_[n] != &writer) {
+            continue;
+        }
+
+        for (; n + 1 < writers_.size(); n++) {
+            writers_[n] = writers_[n + 1];
+        }
+
+        if (!writers_.resize(writers_.size() - 1)) {
+            roc_panic("fanout: can't resize array");
+        }
+
+        return;
+    }
+
+    roc_panic("fanout: output not found");
+}
+
+status::StatusCode Fanout::write(const PacketPtr& packet) {
+    roc_panic_if(!packet);
+
+    if (writers_.size() == 0) {
+        return status::StatusOK;
+    }
+
+    status::StatusCode code = writers_[0]->write(packet);
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    for (size_t n = 1; n < writers_.size(); n++) {
+        PacketPtr copy = copy_packet_(*packet);
+        if (!copy) {
+            // Lost only for this output, like if it was dropped by network.
+            roc_log(LogError, "fanout: can't allocate packet copy");
+            continue;
+        }
+
+        code = writers_[n]->write(copy);
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
+    return status::StatusOK;
+}
+
+PacketPtr Fanout::copy_packet_(const Packet& packet) {
+    if (!packet.has_flags(Packet::FlagComposed)) {
+        roc_panic("fanout: unexpected packet: should be composed");
+    }
+
+    PacketPtr copy = packet_factory_.new_packet();
+    if (!copy) {
+        return NULL;
+    }
+
+    // Protocol headers refer to buffer, which is shared, so they remain valid.
+    // UDP header is not copied, so that output can set its own address.
+    copy->add_flags(packet.flags() & ~unsigned(Packet::FlagUDP));
+    if (packet.rtp()) {
+        *copy->rtp() = *packet.rtp();
+    }
+    if (packet.fec()) {
+        *copy->fec() = *packet.fec();
+    }
+    if (packet.rtcp()) {
+        *copy->rtcp() = *packet.rtcp();
+    }
+    copy->set_buffer(packet.buffer());
+
+    return copy;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/fanout.h
+//! @brief Packet fanout.
+
+#ifndef ROC_PACKET_FANOUT_H_
+#define ROC_PACKET_FANOUT_H_
+
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+
+//! Packet fanout.
+//!
+//! Duplicates composed packets to multiple output writers.
+//!
+//! First output receives original packet. Other outputs receive copies that
+//! share buffer and protocol headers with original packet, but have their own
+//! UDP header, so that they can be sent to different addresses. Packet data
+//! is never copied.
+//!
+//! Since buffer is shared, packet should be composed by the first output
+//! (e.g. by Shipper), and should not be modified after that.
+class Fanout : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Fanout(PacketFactory& packet_factory, core::IArena& arena);
+
+    //! Check if writer is already added.
+    bool has_output(IWriter& writer) const;
+
+    //! Add output writer.
+    ROC_ATTR_NODISCARD bool add_output(IWriter& writer);
+
+    //! Remove output writer.
+    void remove_output(IWriter& writer);
+
+    //! Write packet.
+    //! @remarks
+    //!  Writes packet to first output writer, and its copies to other writers.
+    //!  Panics if packet is not composed after it was written to first writer.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+private:
+    PacketPtr copy_packet_(const Packet& packet);
+
+    PacketFactory& packet_factory_;
+
+    core::Array<IWriter*, 2> writers_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_FANOUT_H_
@@ -28,7 +28,17 @@ enum FecScheme {
     FEC_ReedSolomon_M8,
 
     //! LDPC-Staircase.
-    FEC_LDPC_Staircase
+    FEC_LDPC_Staircase,
+
+    //! Sliding-window Random Linear Codes over GF(2^8) (RFC 8681).
+    //! @remarks
+    //!  There are no blocks, and FEC fields have different meaning:
+    //!   - for source packets, encoding_symbol_id is the ESI of the packet;
+    //!   - for repair packets, encoding_symbol_id is the ESI of the first
+    //!     source packet in encoding window, source_block_length is the
+    //!     number of source packets in window, source_block_number is the
+    //!     repair key, and block_length is the density threshold.
+    FEC_RLC
 };
 
 //! FECFRAME packet.
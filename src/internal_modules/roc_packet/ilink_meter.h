@@ -46,11 +46,24 @@ struct LinkMetrics {
     //! and the loss may be negative if there are duplicates.
     int64_t lost_packets;
 
+    //! Bitmap of recently lost packets.
+    //! Bit N is set if packet with seqnum (ext_last_seqnum - N) was not received
+    //! (yet). Covers last 64 seqnums. Used to request retransmission of lost
+    //! packets from sender. Not reported via RTCP RR/XR.
+    uint64_t recent_losses;
+
     //! Estimated interarrival jitter.
     //! An estimate of the statistical variance of the RTP data packet
     //! interarrival time.
     core::nanoseconds_t jitter;
 
+    //! Peak interarrival jitter.
+    //! Packet delay variation at configured percentile (95th by default) over
+    //! recent packets. Unlike jitter, which is a smoothed average, reflects
+    //! short delay spikes.
+    //! Zero if not computed.
+    core::nanoseconds_t peak_jitter;
+
     //! Estimated round-trip time between sender and receiver.
     //! Computed based on NTP-like timestamp exchange implemennted by RTCP protocol.
     //! Read-only field. You can read it on sender, but you should not set
@@ -62,7 +75,9 @@ struct LinkMetrics {
         , ext_last_seqnum(0)
         , total_packets(0)
         , lost_packets(0)
+        , recent_losses(0)
         , jitter(0)
+        , peak_jitter(0)
         , rtt(0) {
     }
 };
@@ -17,14 +17,14 @@ namespace packet {
 Interleaver::Interleaver(IWriter& writer, core::IArena& arena, size_t block_sz)
     : writer_(writer)
     , block_size_(block_sz)
-    , send_seq_(arena)
+    , put_seq_(arena)
     , packets_(arena)
     , next_2_put_(0)
     , next_2_send_(0)
     , valid_(false) {
     roc_panic_if(block_sz == 0);
 
-    if (!send_seq_.resize(block_size_)) {
+    if (!put_seq_.resize(block_size_)) {
         return;
     }
     if (!packets_.resize(block_size_)) {
@@ -37,7 +37,7 @@ Interleaver::Interleaver(IWriter& writer, core::IArena& arena, size_t block_sz)
 
     for (size_t i = 0; i < block_size_; ++i) {
         roc_log(LogTrace, "  interleaver_seq[%u]: %u", (unsigned)i,
-                (unsigned)send_seq_[i]);
+                (unsigned)put_seq_[i]);
     }
 
     valid_ = true;
@@ -50,17 +50,26 @@ bool Interleaver::is_valid() const {
 status::StatusCode Interleaver::write(const PacketPtr& p) {
     roc_panic_if_not(is_valid());
 
-    packets_[next_2_put_] = p;
-    next_2_put_ = (next_2_put_ + 1) % block_size_;
+    packets_[put_seq_[next_2_put_]] = p;
+    if (++next_2_put_ == block_size_) {
+        next_2_put_ = 0;
+    }
+
+    for (;;) {
+        PacketPtr& pp = packets_[next_2_send_];
+        if (!pp) {
+            break;
+        }
 
-    while (packets_[send_seq_[next_2_send_]]) {
-        const status::StatusCode code = writer_.write(packets_[send_seq_[next_2_send_]]);
+        const status::StatusCode code = writer_.write(pp);
         if (code != status::StatusOK) {
             return code;
         }
 
-        packets_[send_seq_[next_2_send_]] = NULL;
-        next_2_send_ = (next_2_send_ + 1) % block_size_;
+        pp = NULL;
+        if (++next_2_send_ == block_size_) {
+            next_2_send_ = 0;
+        }
     }
 
     return status::StatusOK;
@@ -69,17 +78,19 @@ status::StatusCode Interleaver::write(const PacketPtr& p) {
 status::StatusCode Interleaver::flush() {
     roc_panic_if_not(is_valid());
 
+    // Send remaining packets in input order.
     for (size_t i = 0; i < block_size_; ++i) {
-        if (!packets_[i]) {
+        PacketPtr& pp = packets_[put_seq_[i]];
+        if (!pp) {
             continue;
         }
 
-        const status::StatusCode code = writer_.write(packets_[i]);
+        const status::StatusCode code = writer_.write(pp);
         if (code != status::StatusOK) {
             return code;
         }
 
-        packets_[i] = NULL;
+        pp = NULL;
     }
 
     next_2_put_ = next_2_send_ = 0;
@@ -92,14 +103,16 @@ size_t Interleaver::block_size() const {
 }
 
 void Interleaver::reinit_seq_() {
+    // Random permutation of output positions. Packet written at position i
+    // in input order is sent at position put_seq_[i] in output order.
     for (size_t i = 0; i < block_size_; ++i) {
-        send_seq_[i] = i;
+        put_seq_[i] = i;
     }
     for (size_t i = block_size_; i > 0; --i) {
         const size_t j = core::fast_random_range(0, (unsigned int)i - 1);
-        const size_t buff = send_seq_[i - 1];
-        send_seq_[i - 1] = send_seq_[j];
-        send_seq_[j] = buff;
+        const size_t buff = put_seq_[i - 1];
+        put_seq_[i - 1] = put_seq_[j];
+        put_seq_[j] = buff;
     }
 }
 
@@ -22,8 +22,18 @@ namespace roc {
 namespace packet {
 
 //! Interleaves packets to transmit them in pseudo random order.
+//! @remarks
+//!  Packets are placed into a ring directly at their position in output
+//!  order, so sending is a sequential scan of the ring. Storage for blocks
+//!  up to EmbeddedBlockSize packets is embedded into the object, so common
+//!  FEC block sizes don't need allocations.
 class Interleaver : public IWriter, public core::NonCopyable<> {
 public:
+    enum {
+        //! Maximum block size that doesn't require allocations.
+        EmbeddedBlockSize = 32
+    };
+
     //! Initialize.
     //! @remarks
     //!  Interleaver reorders packets passed to write() and writes
@@ -47,7 +57,7 @@ public:
     size_t block_size() const;
 
 private:
-    //! Initialize tx_seq_ to a new randomized sequence.
+    //! Initialize put_seq_ to a new randomized sequence.
     void reinit_seq_();
 
     // Output writer.
@@ -56,11 +66,11 @@ private:
     // Number of packets in block.
     size_t block_size_;
 
-    // Output sequence.
-    core::Array<size_t> send_seq_;
+    // Position in output order for every position in input order.
+    core::Array<size_t, EmbeddedBlockSize> put_seq_;
 
-    // Delay line.
-    core::Array<PacketPtr> packets_;
+    // Delay line, indexed by position in output order.
+    core::Array<PacketPtr, EmbeddedBlockSize> packets_;
 
     size_t next_2_put_;
     size_t next_2_send_;
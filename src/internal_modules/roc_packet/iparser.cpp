@@ -14,5 +14,25 @@ namespace packet {
 IParser::~IParser() {
 }
 
+size_t IParser::parse_batch(PacketPtr* packets, size_t n_packets) {
+    size_t n_parsed = 0;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!parse(*packets[n], packets[n]->buffer())) {
+            continue;
+        }
+        if (n_parsed != n) {
+            packets[n_parsed] = packets[n];
+        }
+        n_parsed++;
+    }
+
+    for (size_t n = n_parsed; n < n_packets; n++) {
+        packets[n] = NULL;
+    }
+
+    return n_parsed;
+}
+
 } // namespace packet
 } // namespace roc
@@ -30,6 +30,16 @@ public:
     //! @returns
     //!  true if the packet was successfully parsed or false if the packet is invalid.
     virtual bool parse(Packet& packet, const core::Slice<uint8_t>& buffer) = 0;
+
+    //! Parse multiple packets, each from its own buffer.
+    //! @remarks
+    //!  Same as invoking parse() for every packet in @p packets with the buffer
+    //!  attached to that packet, but allows implementation to avoid per-packet
+    //!  virtual calls. Successfully parsed packets are moved to the beginning
+    //!  of the array, preserving their order, and invalid packets are removed.
+    //! @returns
+    //!  number of successfully parsed packets.
+    virtual size_t parse_batch(PacketPtr* packets, size_t n_packets);
 };
 
 } // namespace packet
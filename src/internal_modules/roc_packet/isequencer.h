@@ -28,6 +28,13 @@ public:
     //! Fill next packet.
     virtual void
     next(Packet& packet, core::nanoseconds_t capture_ts, stream_timestamp_t duration) = 0;
+
+    //! Skip packet that was not sent.
+    //! @remarks
+    //!  Advances stream position by given duration without consuming sequence
+    //!  number. Used for silence suppression: receiver sees a gap in stream, but
+    //!  no gap in sequence, and thus can distinguish it from packet loss.
+    virtual void skip(stream_timestamp_t duration) = 0;
 };
 
 } // namespace packet
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/pacer.h"
+#include "roc_core/cached_clock.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Pacer::Pacer(IWriter& writer, const PacerConfig& config, size_t sample_rate)
+    : writer_(writer)
+    , config_(config)
+    , sample_rate_(sample_rate)
+    , interval_(0)
+    , has_interval_(false)
+    , next_ts_(0)
+    , valid_(false) {
+    roc_log(LogDebug, "pacer: initializing: burst_packets=%lu max_delay=%.3fms",
+            (unsigned long)config_.burst_packets,
+            (double)config_.max_delay / core::Millisecond);
+
+    if (sample_rate_ == 0) {
+        roc_log(LogError, "pacer: sample rate can't be zero");
+        return;
+    }
+
+    if (config_.burst_packets == 0 || config_.max_delay < 0) {
+        roc_log(LogError, "pacer: invalid config: burst_packets=%lu max_delay=%ld",
+                (unsigned long)config_.burst_packets, (long)config_.max_delay);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Pacer::is_valid() const {
+    return valid_;
+}
+
+core::nanoseconds_t Pacer::packet_interval() const {
+    return (core::nanoseconds_t)interval_;
+}
+
+PacerMetrics Pacer::metrics() const {
+    return metrics_;
+}
+
+status::StatusCode Pacer::write(const PacketPtr& packet) {
+    roc_panic_if(!valid_);
+    roc_panic_if(!packet);
+
+    update_interval_(*packet);
+
+    const core::nanoseconds_t current_time = core::CachedClock::now(core::ClockMonotonic);
+    const core::nanoseconds_t send_ts = schedule_(current_time);
+
+    if (!packet->has_flags(Packet::FlagUDP)) {
+        packet->add_flags(Packet::FlagUDP);
+    }
+    packet->udp()->send_timestamp = send_ts;
+
+    const core::nanoseconds_t delay = send_ts - current_time;
+
+    metrics_.pacing_delay = delay;
+    metrics_.max_pacing_delay = std::max(metrics_.max_pacing_delay, delay);
+    if (delay > 0) {
+        metrics_.paced_packets++;
+    }
+
+    return writer_.write(packet);
+}
+
+void Pacer::update_interval_(const Packet& packet) {
+    const double duration = (double)packet.duration() * core::Second / sample_rate_;
+
+    if (!has_interval_) {
+        if (duration == 0) {
+            // Nothing known about the rate yet.
+            return;
+        }
+        interval_ = duration;
+        has_interval_ = true;
+        return;
+    }
+
+    interval_ += (duration - interval_) / SmoothingWindow;
+}
+
+core::nanoseconds_t Pacer::schedule_(core::nanoseconds_t current_time) {
+    if (!has_interval_) {
+        next_ts_ = current_time;
+        return current_time;
+    }
+
+    const core::nanoseconds_t interval = (core::nanoseconds_t)interval_;
+
+    // Unused time is accumulated only up to burst size, so that after pause,
+    // at most burst_packets packets are sent back-to-back.
+    const core::nanoseconds_t min_next_ts =
+        current_time - interval * core::nanoseconds_t(config_.burst_packets - 1);
+
+    if (next_ts_ < min_next_ts) {
+        next_ts_ = min_next_ts;
+    }
+
+    core::nanoseconds_t send_ts = std::max(next_ts_, current_time);
+
+    if (send_ts - current_time > config_.max_delay) {
+        // Packets are written faster than they should be sent,
+        // give up pacing instead of accumulating delay.
+        send_ts = current_time + config_.max_delay;
+        next_ts_ = send_ts;
+    }
+
+    next_ts_ += interval;
+
+    return send_ts;
+}
+
+} // namespace packet
+} // namespace roc
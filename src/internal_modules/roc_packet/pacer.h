@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/pacer.h
+//! @brief Spreads packets evenly in time.
+
+#ifndef ROC_PACKET_PACER_H_
+#define ROC_PACKET_PACER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace packet {
+
+//! Pacer parameters.
+struct PacerConfig {
+    //! Maximum number of packets sent back-to-back without pacing.
+    size_t burst_packets;
+
+    //! Maximum delay that pacer may add to a packet.
+    //! If packets are written faster than they can be paced, they are
+    //! sent in a burst after this delay.
+    core::nanoseconds_t max_delay;
+
+    PacerConfig()
+        : burst_packets(2)
+        , max_delay(20 * core::Millisecond) {
+    }
+};
+
+//! Pacer metrics.
+struct PacerMetrics {
+    //! Cumulative count of packets which send time was delayed.
+    uint64_t paced_packets;
+
+    //! Delay added to most recent packet.
+    core::nanoseconds_t pacing_delay;
+
+    //! Maximum value of pacing_delay seen so far.
+    core::nanoseconds_t max_pacing_delay;
+
+    PacerMetrics()
+        : paced_packets(0)
+        , pacing_delay(0)
+        , max_pacing_delay(0) {
+    }
+};
+
+//! Spreads packets evenly in time.
+//!
+//! Assigns send timestamp to every packet, so that packets leave network
+//! thread at a steady rate instead of bursts, e.g. when a whole block of
+//! repair packets is generated at once.
+//!
+//! Rate is derived from media duration of passing packets: interval between
+//! packets is the average duration per packet, where packets without duration
+//! (e.g. repair packets) count as zero. This way, all packets are spread over
+//! the media duration they carry.
+//!
+//! Pacer doesn't delay packets by itself; it only fills UDP::send_timestamp
+//! and writes packets further immediately. Delay is performed by network
+//! thread when sending packet.
+class Pacer : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p sample_rate defines units of packet duration.
+    Pacer(IWriter& writer, const PacerConfig& config, size_t sample_rate);
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get current interval between packets.
+    core::nanoseconds_t packet_interval() const;
+
+    //! Get metrics.
+    PacerMetrics metrics() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Assigns send timestamp and writes packet to underlying writer.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+private:
+    // Number of packets for interval smoothing.
+    enum { SmoothingWindow = 64 };
+
+    void update_interval_(const Packet& packet);
+    core::nanoseconds_t schedule_(core::nanoseconds_t current_time);
+
+    IWriter& writer_;
+
+    const PacerConfig config_;
+    const size_t sample_rate_;
+
+    double interval_;
+    bool has_interval_;
+
+    core::nanoseconds_t next_ts_;
+
+    PacerMetrics metrics_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PACER_H_
@@ -158,14 +158,16 @@ public:
     static size_t approx_size(size_t n_samples);
 
 private:
+    // Fields are ordered by access frequency: flags, buffer and RTP headers are
+    // touched by every pipeline element and go first, next to reference counter
+    // and queue nodes; UDP, FEC and RTCP parts are needed only by some elements.
     unsigned flags_;
+    core::Slice<uint8_t> buffer_;
 
-    UDP udp_;
     RTP rtp_;
+    UDP udp_;
     FEC fec_;
     RTCP rtcp_;
-
-    core::Slice<uint8_t> buffer_;
 };
 
 } // namespace packet
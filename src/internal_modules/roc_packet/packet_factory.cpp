@@ -22,6 +22,7 @@ PacketFactory::PacketFactory(core::IArena& arena, size_t buffer_size) {
     packet_pool_ = default_packet_pool_.get();
     buffer_pool_ = default_buffer_pool_.get();
     buffer_size_ = buffer_size;
+    n_small_pools_ = 0;
 }
 
 PacketFactory::PacketFactory(core::IPool& packet_pool, core::IPool& buffer_pool) {
@@ -42,6 +43,35 @@ PacketFactory::PacketFactory(core::IPool& packet_pool, core::IPool& buffer_pool)
     packet_pool_ = &packet_pool;
     buffer_pool_ = &buffer_pool;
     buffer_size_ = buffer_pool.object_size() - sizeof(core::Buffer);
+    n_small_pools_ = 0;
+}
+
+void PacketFactory::add_small_buffer_pool(core::IPool& buffer_pool) {
+    if (buffer_pool.object_size() < sizeof(core::Buffer)
+        || buffer_pool.object_size() - sizeof(core::Buffer) >= buffer_size_) {
+        roc_panic("packet factory: unexpected small buffer_pool object size:"
+                  " minimum=%lu maximum=%lu actual=%lu",
+                  (unsigned long)sizeof(core::Buffer),
+                  (unsigned long)(sizeof(core::Buffer) + buffer_size_ - 1),
+                  (unsigned long)buffer_pool.object_size());
+    }
+
+    if (n_small_pools_ == MaxSmallPools) {
+        roc_panic("packet factory: too many small buffer pools: max=%lu",
+                  (unsigned long)MaxSmallPools);
+    }
+
+    const size_t size = buffer_pool.object_size() - sizeof(core::Buffer);
+
+    size_t pos = n_small_pools_;
+    for (; pos > 0 && small_sizes_[pos - 1] > size; pos--) {
+        small_pools_[pos] = small_pools_[pos - 1];
+        small_sizes_[pos] = small_sizes_[pos - 1];
+    }
+
+    small_pools_[pos] = &buffer_pool;
+    small_sizes_[pos] = size;
+    n_small_pools_++;
 }
 
 size_t PacketFactory::packet_buffer_size() const {
@@ -52,6 +82,20 @@ core::BufferPtr PacketFactory::new_packet_buffer() {
     return new (*buffer_pool_) core::Buffer(*buffer_pool_, buffer_size_);
 }
 
+core::BufferPtr PacketFactory::new_packet_buffer(size_t size) {
+    if (size > buffer_size_) {
+        return NULL;
+    }
+
+    for (size_t n = 0; n < n_small_pools_; n++) {
+        if (size <= small_sizes_[n]) {
+            return new (*small_pools_[n]) core::Buffer(*small_pools_[n], small_sizes_[n]);
+        }
+    }
+
+    return new_packet_buffer();
+}
+
 PacketPtr PacketFactory::new_packet() {
     return new (*packet_pool_) Packet(*packet_pool_);
 }
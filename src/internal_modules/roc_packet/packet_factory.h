@@ -44,18 +44,36 @@ public:
     //! @p buffer_pool is a pool of core::Buffer objects.
     PacketFactory(core::IPool& packet_pool, core::IPool& buffer_pool);
 
+    //! Add pool for smaller packet buffers.
+    //! @remarks
+    //!  @p buffer_pool is a pool of core::Buffer objects, smaller than buffers
+    //!  of main buffer pool. It is used by new_packet_buffer(size) when
+    //!  requested size fits. Should be called before factory is used.
+    void add_small_buffer_pool(core::IPool& buffer_pool);
+
     //! Get packet buffer size in bytes.
+    //! @remarks
+    //!  This is the maximum size, i.e. size of buffers of main buffer pool.
     size_t packet_buffer_size() const;
 
     //! Allocate packet buffer.
     //! @remarks
-    //!  Returned buffer may be attached to packet using Packet::set_buffer().
+    //!  Returned buffer has maximum size and may be attached to packet using
+    //!  Packet::set_buffer().
     core::BufferPtr new_packet_buffer();
 
+    //! Allocate packet buffer of at least given size.
+    //! @remarks
+    //!  Returns buffer from the smallest pool which buffers fit @p size, or
+    //!  null if @p size is greater than packet_buffer_size().
+    core::BufferPtr new_packet_buffer(size_t size);
+
     //! Allocate packet.
     PacketPtr new_packet();
 
 private:
+    enum { MaxSmallPools = 4 };
+
     // used if factory is created with default pools
     core::Optional<core::SlabPool<Packet> > default_packet_pool_;
     core::Optional<core::SlabPool<core::Buffer> > default_buffer_pool_;
@@ -63,6 +81,11 @@ private:
     core::IPool* packet_pool_;
     core::IPool* buffer_pool_;
     size_t buffer_size_;
+
+    // pools of smaller buffers, sorted by buffer size
+    core::IPool* small_pools_[MaxSmallPools];
+    size_t small_sizes_[MaxSmallPools];
+    size_t n_small_pools_;
 };
 
 } // namespace packet
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/retransmitter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Retransmitter::Retransmitter(IWriter& writer,
+                             PacketFactory& packet_factory,
+                             core::IArena& arena,
+                             const RetransmitterConfig& config)
+    : writer_(writer)
+    , packet_factory_(packet_factory)
+    , history_(arena)
+    , valid_(false) {
+    if (config.history_size == 0) {
+        roc_log(LogError, "retransmitter: invalid config: history_size=0");
+        return;
+    }
+
+    if (!history_.resize(config.history_size)) {
+        roc_log(LogError, "retransmitter: can't allocate history: size=%lu",
+                (unsigned long)config.history_size);
+        return;
+    }
+
+    roc_log(LogDebug, "initializing retransmitter: history_size=%lu",
+            (unsigned long)config.history_size);
+
+    valid_ = true;
+}
+
+bool Retransmitter::is_valid() const {
+    return valid_;
+}
+
+const RetransmitterMetrics& Retransmitter::metrics() const {
+    return metrics_;
+}
+
+status::StatusCode Retransmitter::write(const PacketPtr& packet) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!packet);
+
+    const status::StatusCode code = writer_.write(packet);
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    if (packet->rtp()) {
+        // Older packet with same index is evicted.
+        history_[packet->rtp()->seqnum % history_.size()] = packet;
+    }
+
+    return status::StatusOK;
+}
+
+status::StatusCode Retransmitter::retransmit(seqnum_t seqnum) {
+    roc_panic_if(!is_valid());
+
+    metrics_.requested_packets++;
+
+    const PacketPtr& packet = history_[seqnum % history_.size()];
+    if (!packet || packet->rtp()->seqnum != seqnum) {
+        roc_log(LogTrace, "retransmitter: packet not in history: sn=%lu",
+                (unsigned long)seqnum);
+        return status::StatusOK;
+    }
+
+    PacketPtr copy = copy_packet_(*packet);
+    if (!copy) {
+        roc_log(LogError, "retransmitter: can't allocate packet copy");
+        return status::StatusNoMem;
+    }
+
+    const status::StatusCode code = writer_.write(copy);
+    if (code != status::StatusOK) {
+        return code;
+    }
+
+    metrics_.retransmitted_packets++;
+
+    return status::StatusOK;
+}
+
+PacketPtr Retransmitter::copy_packet_(const Packet& packet) {
+    if (!packet.has_flags(Packet::FlagComposed)) {
+        roc_panic("retransmitter: unexpected packet: should be composed");
+    }
+
+    PacketPtr copy = packet_factory_.new_packet();
+    if (!copy) {
+        return NULL;
+    }
+
+    // Protocol headers refer to buffer, which is shared, so they remain valid.
+    // From UDP header, only address is copied, so that copy is sent without
+    // delay assigned to original packet by pacer.
+    copy->add_flags(packet.flags());
+    if (packet.udp()) {
+        copy->udp()->dst_addr = packet.udp()->dst_addr;
+    }
+    *copy->rtp() = *packet.rtp();
+    if (packet.fec()) {
+        *copy->fec() = *packet.fec();
+    }
+    copy->set_buffer(packet.buffer());
+
+    return copy;
+}
+
+} // namespace packet
+} // namespace roc
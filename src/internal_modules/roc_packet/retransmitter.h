@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/retransmitter.h
+//! @brief Re-sends lost packets on request.
+
+#ifndef ROC_PACKET_RETRANSMITTER_H_
+#define ROC_PACKET_RETRANSMITTER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace packet {
+
+//! Retransmitter parameters.
+struct RetransmitterConfig {
+    //! Number of recently sent packets kept for retransmission.
+    //! Should cover round-trip time plus RTCP report interval.
+    size_t history_size;
+
+    RetransmitterConfig()
+        : history_size(256) {
+    }
+};
+
+//! Retransmitter metrics.
+struct RetransmitterMetrics {
+    //! Cumulative count of packets requested by receivers.
+    uint64_t requested_packets;
+
+    //! Cumulative count of retransmitted packets.
+    //! Requested packets that are already gone from history are not counted.
+    uint64_t retransmitted_packets;
+
+    RetransmitterMetrics()
+        : requested_packets(0)
+        , retransmitted_packets(0) {
+    }
+};
+
+//! Re-sends lost packets on request.
+//!
+//! Passes packets to nested writer and keeps recently sent RTP packets in a
+//! ring indexed by seqnum. When receiver reports lost packets (via RTCP NACK),
+//! retransmit() writes them to nested writer again.
+//!
+//! Retransmitted packets are copies that share buffer with original packet,
+//! like in Fanout, so nested writer should compose packets (e.g. Shipper)
+//! and they should not be modified after that.
+class Retransmitter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Retransmitter(IWriter& writer,
+                  PacketFactory& packet_factory,
+                  core::IArena& arena,
+                  const RetransmitterConfig& config);
+
+    //! Check if object is successfully constructed.
+    bool is_valid() const;
+
+    //! Get metrics.
+    const RetransmitterMetrics& metrics() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Writes packet to nested writer and remembers it.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
+
+    //! Re-send packet.
+    //! @remarks
+    //!  If packet with given seqnum is still in history, writes its copy
+    //!  to nested writer. Otherwise does nothing.
+    ROC_ATTR_NODISCARD status::StatusCode retransmit(seqnum_t seqnum);
+
+private:
+    PacketPtr copy_packet_(const Packet& packet);
+
+    IWriter& writer_;
+    PacketFactory& packet_factory_;
+
+    core::Array<PacketPtr> history_;
+
+    RetransmitterMetrics metrics_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_RETRANSMITTER_H_
@@ -15,7 +15,8 @@ Shipper::Shipper(IComposer& composer,
                  IWriter& outbound_writer,
                  const address::SocketAddr* outbound_address)
     : composer_(composer)
-    , outbound_writer_(outbound_writer) {
+    , outbound_writer_(outbound_writer)
+    , n_dropped_repair_(0) {
     if (outbound_address) {
         outbound_address_ = *outbound_address;
     }
@@ -25,6 +26,10 @@ const address::SocketAddr& Shipper::outbound_address() const {
     return outbound_address_;
 }
 
+uint64_t Shipper::num_dropped_repair() const {
+    return n_dropped_repair_;
+}
+
 status::StatusCode Shipper::write(const PacketPtr& packet) {
     if (outbound_address_) {
         if (!packet->has_flags(Packet::FlagUDP)) {
@@ -47,7 +52,16 @@ status::StatusCode Shipper::write(const PacketPtr& packet) {
         packet->add_flags(Packet::FlagComposed);
     }
 
-    return outbound_writer_.write(packet);
+    const status::StatusCode code = outbound_writer_.write(packet);
+
+    if (code == status::StatusLimit && packet->has_flags(Packet::FlagRepair)) {
+        // Outbound queue is overloaded, repair packet was dropped to keep
+        // source packets flowing. Receiver will see it as regular loss.
+        n_dropped_repair_++;
+        return status::StatusOK;
+    }
+
+    return code;
 }
 
 } // namespace packet
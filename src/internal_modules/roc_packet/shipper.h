@@ -34,6 +34,13 @@ public:
     //! Get destination address for outbound packets.
     const address::SocketAddr& outbound_address() const;
 
+    //! Get number of repair packets dropped by outbound writer.
+    //! @remarks
+    //!  Outbound writer may refuse repair packets with status::StatusLimit
+    //!  when its queue is overloaded. Such packets are counted and treated
+    //!  as if they were lost by network.
+    uint64_t num_dropped_repair() const;
+
     //! Write outgoing packet.
     virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
 
@@ -41,6 +48,8 @@ private:
     IComposer& composer_;
     IWriter& outbound_writer_;
     address::SocketAddr outbound_address_;
+
+    uint64_t n_dropped_repair_;
 };
 
 } // namespace packet
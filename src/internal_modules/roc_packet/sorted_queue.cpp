@@ -14,18 +14,46 @@
 namespace roc {
 namespace packet {
 
-SortedQueue::SortedQueue(size_t max_size)
-    : max_size_(max_size) {
+namespace {
+
+// Initial number of slots in ring.
+const size_t MinRingSize = 16;
+
+// Maximum distance between head and tail seqnums, beyond which
+// seqnum comparison becomes ambiguous.
+const size_t MaxRingSpan = (size_t)1 << 15;
+
+} // namespace
+
+SortedQueue::SortedQueue(core::IArena& arena, size_t max_size)
+    : mode_(Mode_None)
+    , ring_(arena)
+    , ring_mask_(0)
+    , ring_head_(0)
+    , ring_span_(0)
+    , ring_size_(0)
+    , max_size_(max_size)
+    , n_overflows_(0)
+    , peak_size_(0)
+    , n_read_(0) {
 }
 
 status::StatusCode SortedQueue::read(PacketPtr& packet) {
-    packet = list_.back();
-    if (packet) {
-        list_.remove(*packet);
-        return status::StatusOK;
+    if (mode_ == Mode_Ring) {
+        packet = ring_read_();
+    } else {
+        packet = list_.back();
+        if (packet) {
+            list_.remove(*packet);
+        }
     }
 
-    return status::StatusNoData;
+    if (!packet) {
+        return status::StatusNoData;
+    }
+
+    n_read_++;
+    return status::StatusOK;
 }
 
 status::StatusCode SortedQueue::write(const PacketPtr& packet) {
@@ -33,14 +61,193 @@ status::StatusCode SortedQueue::write(const PacketPtr& packet) {
         roc_panic("sorted queue: attempting to add null packet");
     }
 
-    if (max_size_ > 0 && list_.size() == max_size_) {
+    if (max_size_ > 0 && size() == max_size_) {
         roc_log(LogDebug,
                 "sorted queue: queue is full, dropping packet:"
                 " max_size=%u",
                 (unsigned)max_size_);
+        n_overflows_++;
+        return status::StatusOK;
+    }
+
+    if (mode_ == Mode_None) {
+        mode_ = packet->rtp() ? Mode_Ring : Mode_List;
+    }
+
+    if ((mode_ == Mode_Ring) != (packet->rtp() != NULL)) {
+        roc_log(LogDebug, "sorted queue: dropping packet of incompatible type");
+        return status::StatusOK;
+    }
+
+    const status::StatusCode code =
+        mode_ == Mode_Ring ? ring_write_(packet) : list_write_(packet);
+
+    peak_size_ = std::max(peak_size_, size());
+
+    return code;
+}
+
+uint64_t SortedQueue::num_overflows() const {
+    return n_overflows_;
+}
+
+core::OccupancyMetrics SortedQueue::metrics() const {
+    core::OccupancyMetrics metrics;
+    metrics.occupancy = size();
+    metrics.max_occupancy = peak_size_;
+    metrics.throughput = n_read_;
+    return metrics;
+}
+
+size_t SortedQueue::size() const {
+    if (mode_ == Mode_Ring) {
+        return ring_size_;
+    }
+
+    return list_.size();
+}
+
+PacketPtr SortedQueue::head() const {
+    if (mode_ == Mode_Ring) {
+        if (ring_size_ == 0) {
+            return NULL;
+        }
+        return ring_[ring_head_ & ring_mask_];
+    }
+
+    return list_.back();
+}
+
+PacketPtr SortedQueue::tail() const {
+    if (mode_ == Mode_Ring) {
+        if (ring_size_ == 0) {
+            return NULL;
+        }
+        return ring_[(ring_head_ + ring_span_ - 1) & ring_mask_];
+    }
+
+    return list_.front();
+}
+
+PacketPtr SortedQueue::latest() const {
+    return latest_;
+}
+
+status::StatusCode SortedQueue::ring_write_(const PacketPtr& packet) {
+    const seqnum_t seqnum = packet->rtp()->seqnum;
+
+    // New span and head, if packet is added.
+    size_t new_span = 1;
+    seqnum_t new_head = seqnum;
+
+    if (ring_size_ != 0) {
+        const seqnum_diff_t dist = seqnum_diff(seqnum, ring_head_);
+
+        if (dist >= 0) {
+            new_span = std::max(ring_span_, (size_t)dist + 1);
+            new_head = ring_head_;
+        } else {
+            new_span = ring_span_ + (size_t)-dist;
+        }
+
+        if (new_span > MaxRingSpan) {
+            roc_log(LogDebug,
+                    "sorted queue: dropping packet too far from queue:"
+                    " sn=%lu head_sn=%lu span=%lu",
+                    (unsigned long)seqnum, (unsigned long)ring_head_,
+                    (unsigned long)ring_span_);
+            return status::StatusOK;
+        }
+    }
+
+    if (new_span > ring_.size() && !ring_grow_(new_span)) {
+        return status::StatusNoMem;
+    }
+
+    PacketPtr& slot = ring_[seqnum & ring_mask_];
+
+    if (slot) {
+        roc_log(LogDebug, "sorted queue: dropping duplicate packet");
         return status::StatusOK;
     }
 
+    slot = packet;
+
+    ring_head_ = new_head;
+    ring_span_ = new_span;
+    ring_size_++;
+
+    if (!latest_ || latest_->compare(*packet) <= 0) {
+        latest_ = packet;
+    }
+
+    return status::StatusOK;
+}
+
+PacketPtr SortedQueue::ring_read_() {
+    if (ring_size_ == 0) {
+        return NULL;
+    }
+
+    PacketPtr& slot = ring_[ring_head_ & ring_mask_];
+    roc_panic_if(!slot);
+
+    PacketPtr packet = slot;
+    slot = NULL;
+
+    ring_size_--;
+
+    if (ring_size_ == 0) {
+        ring_span_ = 0;
+        return packet;
+    }
+
+    // Skip gaps left by lost packets.
+    // Tail is always occupied, so this stops before tail.
+    do {
+        ring_head_++;
+        ring_span_--;
+    } while (!ring_[ring_head_ & ring_mask_]);
+
+    return packet;
+}
+
+bool SortedQueue::ring_grow_(size_t min_span) {
+    size_t new_size = std::max(ring_.size(), MinRingSize);
+    while (new_size < min_span) {
+        new_size *= 2;
+    }
+
+    const size_t old_size = ring_.size();
+
+    if (!ring_.resize(new_size)) {
+        roc_log(LogError, "sorted queue: can't grow ring: old_size=%lu new_size=%lu",
+                (unsigned long)old_size, (unsigned long)new_size);
+        return false;
+    }
+
+    const size_t new_mask = new_size - 1;
+
+    // Packets are indexed by seqnum & mask, so when the mask changes, they
+    // should be moved. Since span never exceeds old size, every packet either
+    // stays in its slot, or moves to the new part of the ring, which is empty.
+    for (size_t n = 0; n < old_size; n++) {
+        if (!ring_[n]) {
+            continue;
+        }
+
+        const size_t new_n = ring_[n]->rtp()->seqnum & new_mask;
+        if (new_n != n) {
+            ring_[new_n] = ring_[n];
+            ring_[n] = NULL;
+        }
+    }
+
+    ring_mask_ = new_mask;
+    return true;
+}
+
+status::StatusCode SortedQueue::list_write_(const PacketPtr& packet) {
     if (!latest_ || latest_->compare(*packet) <= 0) {
         latest_ = packet;
     }
@@ -71,21 +278,5 @@ status::StatusCode SortedQueue::write(const PacketPtr& packet) {
     return status::StatusOK;
 }
 
-size_t SortedQueue::size() const {
-    return list_.size();
-}
-
-PacketPtr SortedQueue::head() const {
-    return list_.back();
-}
-
-PacketPtr SortedQueue::tail() const {
-    return list_.front();
-}
-
-PacketPtr SortedQueue::latest() const {
-    return latest_;
-}
-
 } // namespace packet
 } // namespace roc
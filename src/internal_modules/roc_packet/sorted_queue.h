@@ -12,11 +12,15 @@
 #ifndef ROC_PACKET_SORTED_QUEUE_H_
 #define ROC_PACKET_SORTED_QUEUE_H_
 
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/occupancy_metrics.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet.h"
+#include "roc_packet/units.h"
 
 namespace roc {
 namespace packet {
@@ -24,18 +28,34 @@ namespace packet {
 //! Sorted packet queue.
 //! @remarks
 //!  Packets order is determined by Packet::compare() method.
+//!
+//!  If packets have RTP header, queue works as a jitter buffer: packets are
+//!  stored in a ring indexed by seqnum, so that insertion, duplicate detection,
+//!  and reading head are O(1) regardless of reordering. The ring covers the
+//!  range of seqnums between head and tail, so its size is bounded by the
+//!  queue's time window rather than by the number of packets.
+//!
+//!  Packets without RTP header (e.g. repair packets) are kept in a list
+//!  sorted by insertion.
+//!
+//!  Type of packets is determined by the first packet; packets of different
+//!  type are dropped afterwards.
 class SortedQueue : public IWriter, public IReader, public core::NonCopyable<> {
 public:
     //! Construct empty queue.
     //! @remarks
     //!  If @p max_size is non-zero, it specifies maximum number of packets in queue.
-    explicit SortedQueue(size_t max_size);
+    //!  @p arena is used to allocate the ring.
+    SortedQueue(core::IArena& arena, size_t max_size);
 
     //! Add packet to the queue.
     //! @remarks
     //!  - if the maximum queue size is reached, packet is dropped
     //!  - if packet is equal to another packet in the queue, it is dropped
+    //!  - if packet seqnum is too far from packets in the queue, it is dropped
     //!  - otherwise, packet is inserted into the queue, keeping the queue sorted
+    //! @returns
+    //!  status::StatusNoMem if the ring can't be grown.
     virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& packet);
 
     //! Read next packet.
@@ -69,10 +89,41 @@ public:
     //!  it's still there.
     PacketPtr latest() const;
 
+    //! Get number of packets dropped because queue was full.
+    uint64_t num_overflows() const;
+
+    //! Get occupancy metrics, in packets.
+    //! @remarks
+    //!  Throughput is the number of packets read from queue.
+    core::OccupancyMetrics metrics() const;
+
 private:
+    enum Mode { Mode_None, Mode_Ring, Mode_List };
+
+    status::StatusCode ring_write_(const PacketPtr& packet);
+    PacketPtr ring_read_();
+    bool ring_grow_(size_t min_span);
+
+    status::StatusCode list_write_(const PacketPtr& packet);
+
+    Mode mode_;
+
+    // ring of packets indexed by seqnum & ring_mask_, used in Mode_Ring
+    core::Array<PacketPtr> ring_;
+    size_t ring_mask_;
+    seqnum_t ring_head_;
+    size_t ring_span_;
+    size_t ring_size_;
+
+    // list of sorted packets, used in Mode_List
     core::List<Packet> list_;
+
     PacketPtr latest_;
     const size_t max_size_;
+    uint64_t n_overflows_;
+
+    size_t peak_size_;
+    uint64_t n_read_;
 };
 
 } // namespace packet
@@ -14,8 +14,8 @@ namespace packet {
 
 UDP::UDP()
     : receive_timestamp(0)
-    , queue_timestamp(0) {
-    memset(&request, 0, sizeof(request));
+    , queue_timestamp(0)
+    , send_timestamp(0) {
 }
 
 } // namespace packet
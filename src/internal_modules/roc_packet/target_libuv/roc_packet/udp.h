@@ -12,8 +12,6 @@
 #ifndef ROC_PACKET_UDP_H_
 #define ROC_PACKET_UDP_H_
 
-#include <uv.h>
-
 #include "roc_address/socket_addr.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
@@ -46,10 +44,11 @@ struct UDP {
     //!  allows us to account additional jitter introduced by thread-switch time.
     core::nanoseconds_t queue_timestamp;
 
-    //! Sender request state.
+    //! Packet send timestamp (STS), nanoseconds in monotonic clock domain.
     //! @remarks
-    //!  Used by network thread.
-    uv_udp_send_t request;
+    //!  If non-zero, network thread doesn't send packet before this moment.
+    //!  Assigned by pacer on sender.
+    core::nanoseconds_t send_timestamp;
 
     UDP();
 };
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/unbundler.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/bundler.h"
+#include "roc_status/code_to_str.h"
+
+namespace roc {
+namespace packet {
+
+Unbundler::Unbundler(PacketFactory& packet_factory)
+    : packet_factory_(packet_factory) {
+}
+
+bool Unbundler::is_bundle(const Packet& packet) {
+    const core::Slice<uint8_t>& buffer = packet.buffer();
+    if (!buffer || buffer.size() < Bundler::LengthSize) {
+        return false;
+    }
+
+    // RTP packet would have version 2 here.
+    return (buffer.data()[0] & 0xC0) == 0;
+}
+
+size_t Unbundler::unbundle(const Packet& bundle, IWriter& writer) {
+    const core::Slice<uint8_t>& buffer = bundle.buffer();
+    roc_panic_if(!buffer);
+
+    size_t n_packets = 0;
+    size_t pos = 0;
+
+    while (pos < buffer.size()) {
+        if (buffer.size() - pos < Bundler::LengthSize) {
+            roc_log(LogDebug, "unbundler: truncated bundle: size=%lu pos=%lu",
+                    (unsigned long)buffer.size(), (unsigned long)pos);
+            break;
+        }
+
+        const uint8_t* data = buffer.data() + pos;
+        const size_t size = (size_t(data[0] & 0x3F) << 8) | data[1];
+
+        if (size == 0 || size > buffer.size() - pos - Bundler::LengthSize) {
+            roc_log(LogDebug, "unbundler: bad packet length: size=%lu pos=%lu len=%lu",
+                    (unsigned long)buffer.size(), (unsigned long)pos,
+                    (unsigned long)size);
+            break;
+        }
+
+        pos += Bundler::LengthSize;
+
+        PacketPtr pp = packet_factory_.new_packet();
+        if (!pp) {
+            roc_log(LogError, "unbundler: can't allocate packet");
+            break;
+        }
+
+        if (const UDP* udp = bundle.udp()) {
+            pp->add_flags(Packet::FlagUDP);
+            pp->udp()->src_addr = udp->src_addr;
+            pp->udp()->dst_addr = udp->dst_addr;
+            pp->udp()->receive_timestamp = udp->receive_timestamp;
+            pp->udp()->queue_timestamp = udp->queue_timestamp;
+        }
+
+        pp->set_buffer(buffer.subslice(pos, pos + size));
+        pos += size;
+
+        const status::StatusCode code = writer.write(pp);
+        if (code != status::StatusOK) {
+            roc_log(LogError, "unbundler: can't write packet: status=%s",
+                    status::code_to_str(code));
+            break;
+        }
+
+        n_packets++;
+    }
+
+    return n_packets;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/unbundler.h
+//! @brief Splits datagram into packets.
+
+#ifndef ROC_PACKET_UNBUNDLER_H_
+#define ROC_PACKET_UNBUNDLER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+
+//! Splits bundle produced by Bundler into separate packets.
+//! @remarks
+//!  Packets reference the buffer of the bundle, no data is copied.
+class Unbundler : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit Unbundler(PacketFactory& packet_factory);
+
+    //! Check if packet is a bundle.
+    //! @remarks
+    //!  Should be used only for protocols where packets start with RTP header.
+    static bool is_bundle(const Packet& packet);
+
+    //! Split bundle and write packets to @p writer.
+    //! @remarks
+    //!  Bundled packets inherit UDP header of the bundle.
+    //! @returns
+    //!  number of written packets; if bundle is malformed, packets before
+    //!  the malformed part are still written.
+    size_t unbundle(const Packet& bundle, IWriter& writer);
+
+private:
+    PacketFactory& packet_factory_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_UNBUNDLER_H_
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/clock_group_map.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+ClockGroupMap::ClockGroupMap(core::IArena& arena)
+    : arena_(arena)
+    , map_(arena) {
+}
+
+core::SharedPtr<audio::ClockGroup> ClockGroupMap::find_or_create(const char* cname) {
+    roc_panic_if(!cname || !*cname);
+    roc_panic_if(strlen(cname) > rtcp::MaxCnameLen);
+
+    if (core::SharedPtr<Entry> entry = map_.find(cname)) {
+        return entry->group;
+    }
+
+    core::SharedPtr<Entry> entry = new (arena_) Entry(arena_);
+    if (!entry) {
+        return NULL;
+    }
+
+    entry->group = new (arena_) audio::ClockGroup(arena_);
+    if (!entry->group) {
+        return NULL;
+    }
+
+    strcpy(entry->cname, cname);
+
+    if (!map_.insert(*entry)) {
+        return NULL;
+    }
+
+    roc_log(LogDebug, "clock group map: created group: cname=%s num_groups=%lu",
+            rtcp::cname_to_str(cname).c_str(), (unsigned long)map_.size());
+
+    return entry->group;
+}
+
+void ClockGroupMap::remove_unused() {
+    core::SharedPtr<Entry> entry = map_.front();
+
+    while (entry) {
+        core::SharedPtr<Entry> next_entry = map_.nextof(*entry);
+
+        // Map holds the only reference.
+        if (entry->group->getref() == 1) {
+            roc_log(LogDebug, "clock group map: removed group: cname=%s",
+                    rtcp::cname_to_str(entry->cname).c_str());
+
+            map_.remove(*entry);
+        }
+
+        entry = next_entry;
+    }
+}
+
+size_t ClockGroupMap::num_groups() const {
+    return map_.size();
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/clock_group_map.h
+//! @brief Clock groups by sender CNAME.
+
+#ifndef ROC_PIPELINE_CLOCK_GROUP_MAP_H_
+#define ROC_PIPELINE_CLOCK_GROUP_MAP_H_
+
+#include "roc_audio/clock_group.h"
+#include "roc_core/allocation_policy.h"
+#include "roc_core/hashmap.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/ref_counted.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_rtcp/cname.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Clock groups by sender CNAME.
+//!
+//! Sender CNAME identifies sender host. Sessions from the same host, even if
+//! they belong to different slots, get the same audio::ClockGroup and share
+//! one clock drift estimate.
+//!
+//! Group is kept while there are sessions using it; unused groups are removed
+//! by remove_unused().
+class ClockGroupMap : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit ClockGroupMap(core::IArena& arena);
+
+    //! Get group for given CNAME, creating it if needed.
+    //! @returns
+    //!  NULL if allocation failed.
+    core::SharedPtr<audio::ClockGroup> find_or_create(const char* cname);
+
+    //! Remove groups not used by any session.
+    void remove_unused();
+
+    //! Get number of groups.
+    size_t num_groups() const;
+
+private:
+    enum { PreallocatedGroups = 8 };
+
+    struct Entry : core::RefCounted<Entry, core::ArenaAllocation>, core::HashmapNode<> {
+        Entry(core::IArena& arena)
+            : core::RefCounted<Entry, core::ArenaAllocation>(arena) {
+            cname[0] = '\0';
+        }
+
+        char cname[rtcp::MaxCnameLen + 1];
+        core::SharedPtr<audio::ClockGroup> group;
+
+        const char* key() const {
+            return cname;
+        }
+
+        static core::hashsum_t key_hash(const char* cname) {
+            return core::hashsum_str(cname);
+        }
+
+        static bool key_equal(const char* cname1, const char* cname2) {
+            return strcmp(cname1, cname2) == 0;
+        }
+    };
+
+    core::IArena& arena_;
+    core::Hashmap<Entry, PreallocatedGroups> map_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_CLOCK_GROUP_MAP_H_
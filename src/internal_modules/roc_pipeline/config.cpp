@@ -16,16 +16,47 @@ SenderSinkConfig::SenderSinkConfig()
     : input_sample_spec(DefaultSampleSpec)
     , payload_type(rtp::PayloadType_L16_Stereo)
     , packet_length(DefaultPacketLength)
+    , max_packet_length(0)
     , enable_timing(false)
+    , timing_spin_window(0)
     , enable_auto_duration(false)
     , enable_auto_cts(false)
     , enable_profiling(false)
-    , enable_interleaving(false) {
+    , enable_interleaving(false)
+    , enable_adaptive_fec(false)
+    , enable_pacing(false)
+    , enable_retransmission(false)
+    , enable_bundling(false)
+    , enable_mtu_autotune(false)
+    , enable_shared_encoding(false)
+    , enable_redundancy(false)
+    , enable_rapid_sync(false)
+    , enable_shared_fec(false)
+    , control_interval(0)
+    , enable_low_latency(false)
+    , session_threads(0) {
 }
 
 void SenderSinkConfig::deduce_defaults() {
     latency.deduce_defaults(DefaultLatency, false);
     resampler.deduce_defaults(latency.tuner_backend, latency.tuner_profile);
+
+    if (max_packet_length == 0) {
+        max_packet_length = DefaultMaxPacketLength;
+
+        if (latency.target_latency > 0) {
+            max_packet_length = std::min(max_packet_length, latency.target_latency / 4);
+        }
+    }
+
+    if (enable_low_latency) {
+        if (control_interval == 0) {
+            control_interval = DefaultLowLatencyControlInterval;
+        }
+        pipeline_loop.min_frame_length_between_tasks =
+            std::max(pipeline_loop.min_frame_length_between_tasks,
+                     DefaultLowLatencyTaskInterval);
+    }
 }
 
 SenderSlotConfig::SenderSlotConfig() {
@@ -34,25 +65,67 @@ SenderSlotConfig::SenderSlotConfig() {
 void SenderSlotConfig::deduce_defaults() {
 }
 
+SenderLiveConfig::SenderLiveConfig()
+    : target_latency(0)
+    , fec_n_source_packets(0)
+    , fec_n_repair_packets(0) {
+}
+
 ReceiverCommonConfig::ReceiverCommonConfig()
     : output_sample_spec(DefaultSampleSpec)
     , enable_timing(false)
     , enable_auto_reclock(false)
-    , enable_profiling(false) {
+    , enable_idle_wait(false)
+    , idle_wait_timeout(DefaultIdleWaitTimeout)
+    , enable_profiling(false)
+    , enable_stage_profiling(false)
+    , session_threads(0)
+    , num_shards(0)
+    , max_sessions(0)
+    , session_region_size(DefaultSessionRegionSize)
+    , max_session_packet_rate(0)
+    , max_slot_packet_rate(0)
+    , packet_rate_burst(DefaultPacketRateBurst)
+    , enable_redundancy(false)
+    , max_session_queue_packets(0)
+    , enable_early_routing(false)
+    , control_interval(0)
+    , enable_low_latency(false)
+    , enable_overload_control(false)
+    , enable_clock_groups(false)
+    , enable_shared_fec(false) {
 }
 
 void ReceiverCommonConfig::deduce_defaults() {
+    if (enable_low_latency && control_interval == 0) {
+        control_interval = DefaultLowLatencyControlInterval;
+    }
 }
 
 ReceiverSessionConfig::ReceiverSessionConfig()
     : payload_type(0)
-    , enable_beeping(false) {
+    , enable_beeping(false)
+    , enable_plc(false)
+    , warm_start_timeout(0)
+    , warm_start_latency(0) {
 }
 
 void ReceiverSessionConfig::deduce_defaults() {
     latency.deduce_defaults(DefaultLatency, true);
     watchdog.deduce_defaults(latency.target_latency);
     resampler.deduce_defaults(latency.tuner_backend, latency.tuner_profile);
+
+    if (warm_start_timeout > 0 && warm_start_latency == 0
+        && latency.target_latency > 0) {
+        // Start playback when latency is still far enough from lower bound,
+        // so that latency tuner doesn't terminate session right away.
+        warm_start_latency = latency.target_latency / 4;
+        if (latency.latency_tolerance > 0) {
+            warm_start_latency = std::max(
+                warm_start_latency,
+                latency.target_latency - latency.latency_tolerance / 2);
+        }
+    }
 }
 
 ReceiverSourceConfig::ReceiverSourceConfig() {
@@ -61,6 +134,12 @@ ReceiverSourceConfig::ReceiverSourceConfig() {
 void ReceiverSourceConfig::deduce_defaults() {
     common.deduce_defaults();
     session_defaults.deduce_defaults();
+
+    if (common.enable_low_latency) {
+        pipeline_loop.min_frame_length_between_tasks =
+            std::max(pipeline_loop.min_frame_length_between_tasks,
+                     DefaultLowLatencyTaskInterval);
+    }
 }
 
 ReceiverSlotConfig::ReceiverSlotConfig()
@@ -70,6 +149,12 @@ ReceiverSlotConfig::ReceiverSlotConfig()
 void ReceiverSlotConfig::deduce_defaults() {
 }
 
+ReceiverLiveConfig::ReceiverLiveConfig()
+    : target_latency(0)
+    , change_resampler(false)
+    , resampler_profile(audio::ResamplerProfile_Medium) {
+}
+
 TranscoderConfig::TranscoderConfig()
     : input_sample_spec(DefaultSampleSpec)
     , output_sample_spec(DefaultSampleSpec)
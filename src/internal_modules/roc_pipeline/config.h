@@ -14,20 +14,33 @@
 
 #include "roc_address/protocol.h"
 #include "roc_audio/feedback_monitor.h"
+#include "roc_audio/frame_encoder_config.h"
 #include "roc_audio/latency_tuner.h"
+#include "roc_audio/loss_concealer.h"
+#include "roc_audio/mixer.h"
+#include "roc_audio/packetizer.h"
 #include "roc_audio/profiler.h"
 #include "roc_audio/resampler_config.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/time.h"
+#include "roc_fec/block_size_tuner.h"
 #include "roc_fec/codec_config.h"
+#include "roc_fec/group_repairer.h"
 #include "roc_fec/reader.h"
 #include "roc_fec/writer.h"
+#include "roc_packet/bundler.h"
+#include "roc_packet/duplicate_filter.h"
+#include "roc_packet/pacer.h"
+#include "roc_packet/retransmitter.h"
 #include "roc_packet/units.h"
+#include "roc_pipeline/overload_controller.h"
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_rtcp/config.h"
 #include "roc_rtp/filter.h"
+#include "roc_rtp/link_meter.h"
+#include "roc_rtp/srtp_config.h"
 
 namespace roc {
 namespace pipeline {
@@ -48,12 +61,39 @@ static const audio::SampleSpec DefaultSampleSpec(DefaultSampleRate,
 //!  a lower length may be required depending on network MTU, e.g. for Internet.
 const core::nanoseconds_t DefaultPacketLength = 5 * core::Millisecond;
 
+//! Default maximum packet length for MTU autotuning.
+//! @remarks
+//!  Longer packets increase latency and make each loss more audible.
+const core::nanoseconds_t DefaultMaxPacketLength = 20 * core::Millisecond;
+
 //! Default latency.
 //! @remarks
 //!  200ms works well on majority Wi-Fi networks and is not too annoying. However, many
 //!  networks allow lower latencies, and some networks require higher.
 const core::nanoseconds_t DefaultLatency = 200 * core::Millisecond;
 
+//! Default size of memory region preallocated for one receiver session.
+//! @remarks
+//!  Typical session with resampler takes a few dozens of kilobytes, but buffers of
+//!  some components depend on configuration (e.g. FEC block size), so we leave
+//!  considerable headroom.
+const size_t DefaultSessionRegionSize = 128 * 1024;
+
+//! Default maximum time to block while receiver is idle.
+//! @remarks
+//!  Limits how long idle receiver doesn't produce frames, e.g. how long
+//!  it takes to notice that pump was stopped.
+const core::nanoseconds_t DefaultIdleWaitTimeout = 500 * core::Millisecond;
+
+//! Default burst allowed above receiver packet rate limits.
+const core::nanoseconds_t DefaultPacketRateBurst = 100 * core::Millisecond;
+
+//! Default interval between control updates in low-latency profile.
+const core::nanoseconds_t DefaultLowLatencyControlInterval = 5 * core::Millisecond;
+
+//! Default minimum frame length between task processing in low-latency profile.
+const core::nanoseconds_t DefaultLowLatencyTaskInterval = 1 * core::Millisecond;
+
 //! Parameters of sender sink and sender session.
 struct SenderSinkConfig {
     //! Input sample spec
@@ -68,12 +108,38 @@ struct SenderSinkConfig {
     //! Packet length, in nanoseconds.
     core::nanoseconds_t packet_length;
 
+    //! Maximum packet length selected by MTU autotuning, in nanoseconds.
+    //! @remarks
+    //!  If zero, default value is used, additionally limited to one fourth
+    //!  of target latency, if it's known.
+    core::nanoseconds_t max_packet_length;
+
+    //! Payload encoder parameters.
+    //! Used for compressed encodings, like Opus.
+    audio::FrameEncoderConfig payload_encoder;
+
+    //! Discontinuous transmission parameters.
+    //! Used to suppress packets during silence.
+    audio::DtxConfig dtx;
+
     //! FEC writer parameters.
     fec::WriterConfig fec_writer;
 
     //! FEC encoder parameters.
     fec::CodecConfig fec_encoder;
 
+    //! FEC block size tuner parameters.
+    fec::BlockSizeTunerConfig fec_tuner;
+
+    //! Packet pacer parameters.
+    packet::PacerConfig pacer;
+
+    //! Packet bundler parameters.
+    packet::BundlerConfig bundler;
+
+    //! Packet retransmitter parameters.
+    packet::RetransmitterConfig retransmitter;
+
     //! Latency parameters.
     audio::LatencyConfig latency;
 
@@ -89,9 +155,21 @@ struct SenderSinkConfig {
     //! RTCP config.
     rtcp::Config rtcp;
 
+    //! SRTP keys.
+    //! Used by source endpoint with SRTP protocol.
+    rtp::SrtpConfig srtp;
+
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool enable_timing;
 
+    //! Busy-wait during this time before each frame deadline.
+    //! Used only if enable_timing is set. Sleep alone often wakes up tens or
+    //! hundreds of microseconds late, which makes packet output bursty. With
+    //! non-zero value, pipeline sleeps until this time before deadline and
+    //! then spins, spending up to this time of CPU per frame.
+    //! Zero disables spinning.
+    core::nanoseconds_t timing_spin_window;
+
     //! Automatically fill duration of input frames.
     bool enable_auto_duration;
 
@@ -104,6 +182,95 @@ struct SenderSinkConfig {
     //! Interleave packets.
     bool enable_interleaving;
 
+    //! Adjust FEC block sizes according to loss reported by receiver via RTCP.
+    //! Ignored if FEC or RTCP is not used, or if RTCP is multicast.
+    bool enable_adaptive_fec;
+
+    //! Spread outgoing packets evenly over their media duration instead of
+    //! sending them in bursts.
+    bool enable_pacing;
+
+    //! Re-send source packets reported as lost by receiver via RTCP NACK.
+    //! Recently sent packets are kept in memory to be retransmitted. Can be
+    //! used instead of FEC on links with low RTT and rare losses. Receiver
+    //! should have NACK enabled in its RTCP config.
+    bool enable_retransmission;
+
+    //! Combine source packets generated for one frame into one datagram.
+    //! Reduces packet rate when packets are small. Bundles are recognized by
+    //! receiver automatically. Has no effect for protocols where packets
+    //! don't start with RTP header.
+    bool enable_bundling;
+
+    //! Select packet length automatically based on path MTU of source endpoint.
+    //! Packet length is set to the largest value that fits into single datagram
+    //! and doesn't exceed max_packet_length. If path MTU is unknown,
+    //! packet_length is used.
+    bool enable_mtu_autotune;
+
+    //! Share encoded packets between slots with identical transport settings.
+    //! @remarks
+    //!  If a slot uses same source and repair protocols (and, if MTU autotuning
+    //!  is enabled, same path MTU) as one of the existing slots, it doesn't
+    //!  encode audio itself. Instead, packets encoded by existing slot are
+    //!  also sent to endpoints of the new slot, with the same SSRC and seqnums.
+    //!  Ignored if latency tuning or adaptive FEC is enabled, because they
+    //!  adapt encoding to a particular receiver. Also ignored if redundancy
+    //!  is enabled.
+    bool enable_shared_encoding;
+
+    //! Send source packets over two paths (SMPTE 2022-7 style redundancy).
+    //! @remarks
+    //!  Allows adding second source endpoint to slot, e.g. on another network
+    //!  interface. Identical source packets are sent to both endpoints, and
+    //!  receiver with redundancy enabled merges them into one session.
+    bool enable_redundancy;
+
+    //! Send capture timestamps in RTP header extension (RFC 6051 rapid sync).
+    //! @remarks
+    //!  Every source packet gets 16-byte header extension with capture time of
+    //!  its first sample in NTP format. Receiver learns capture timestamps from
+    //!  the first packet instead of waiting for RTCP sender report, so that
+    //!  e2e latency can be measured and tuned right after joining. Receivers
+    //!  parse the extension automatically. Has effect only if capture
+    //!  timestamps of input frames are set (see enable_auto_cts).
+    bool enable_rapid_sync;
+
+    //! Protect packets of several streams to the same receiver jointly.
+    //! @remarks
+    //!  Sessions sending to the same repair endpoint with the same FEC scheme,
+    //!  payload type and packet length, even if they belong to different
+    //!  senders sharing FEC group map, form common FEC blocks instead of
+    //!  running FEC writer per session (see fec::GroupWriter). Blocks should
+    //!  be sized for all streams of the group. Receiver should have shared FEC
+    //!  enabled too. Ignored if FEC group map is not provided, if FEC scheme is
+    //!  sliding-window, or if adaptive FEC is enabled.
+    bool enable_shared_fec;
+
+    //! Interval between control updates.
+    //! @remarks
+    //!  If non-zero, RTCP reports, FEC tuning and publishing of metrics are
+    //!  performed not more often than once per this interval (or earlier, if
+    //!  RTCP requests it), instead of on every frame. Packets are still sent
+    //!  on every frame. If zero, control updates are performed on every frame.
+    core::nanoseconds_t control_interval;
+
+    //! Use low-latency profile.
+    //! @remarks
+    //!  Intended for very short frames and packets (125us - 1ms), when fixed
+    //!  per-frame costs dominate. Control updates and task processing are
+    //!  batched across several frames: if not set explicitly, control_interval
+    //!  and pipeline_loop.min_frame_length_between_tasks are raised.
+    //!  Profiling should be kept disabled, since it's performed per frame.
+    bool enable_low_latency;
+
+    //! Number of worker threads for parallel session processing.
+    //! If non-zero, every frame is written to sessions of all slots in parallel
+    //! using a pool of this many threads together with pipeline thread, so that
+    //! packetization and FEC encoding of different slots is spread between CPU
+    //! cores. If zero, sessions are processed serially in pipeline thread.
+    size_t session_threads;
+
     //! Initialize config.
     SenderSinkConfig();
 
@@ -120,6 +287,32 @@ struct SenderSlotConfig {
     void deduce_defaults();
 };
 
+//! Sender parameters which can be changed without restarting session.
+struct SenderLiveConfig {
+    //! New target latency for sender-side latency tuning.
+    //! @remarks
+    //!  Latency tuner moves to the new target gradually.
+    //! @note
+    //!  If zero, target latency is not changed.
+    core::nanoseconds_t target_latency;
+
+    //! New number of source packets in FEC block.
+    //! @remarks
+    //!  New block size is applied starting from the next FEC block.
+    //!  Can't be changed if adaptive FEC is enabled.
+    //! @note
+    //!  If zero, FEC block size is not changed.
+    size_t fec_n_source_packets;
+
+    //! New number of repair packets in FEC block.
+    //! @remarks
+    //!  Used if fec_n_source_packets is non-zero.
+    size_t fec_n_repair_packets;
+
+    //! Initialize config.
+    SenderLiveConfig();
+};
+
 //! Parameters common for all receiver sessions.
 struct ReceiverCommonConfig {
     //! Output sample spec.
@@ -131,18 +324,168 @@ struct ReceiverCommonConfig {
     //! RTP filter parameters.
     rtp::FilterConfig rtp_filter;
 
+    //! RTP link meter parameters.
+    rtp::LinkMeterConfig link_meter;
+
     //! RTCP config.
     rtcp::Config rtcp;
 
+    //! SRTP keys.
+    //! Used by source endpoints with SRTP protocol.
+    rtp::SrtpConfig srtp;
+
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool enable_timing;
 
     //! Automatically invoke reclock before returning frames with invocation time.
     bool enable_auto_reclock;
 
+    //! Block while there are no sessions and no pending packets.
+    //! Used only if enable_timing is set, i.e. when output has no clock, like
+    //! a file or null sink. Instead of producing silence in real time, read()
+    //! blocks until a packet arrives or idle_wait_timeout expires, so that
+    //! idle receiver doesn't consume CPU. Silence for the time spent waiting
+    //! is not produced.
+    bool enable_idle_wait;
+
+    //! Maximum time to block in idle wait.
+    //! When it expires, one frame of silence is produced.
+    core::nanoseconds_t idle_wait_timeout;
+
     //! Profile moving average of frames being written.
     bool enable_profiling;
 
+    //! Collect per-stage distribution of processing time.
+    //! Reported via ReceiverSlotMetrics::stages.
+    bool enable_stage_profiling;
+
+    //! Number of worker threads for parallel session processing.
+    //! If non-zero, frames of all sessions are produced in parallel using
+    //! a pool of this many threads together with pipeline thread, and then
+    //! mixed. If zero, sessions are processed serially in pipeline thread.
+    size_t session_threads;
+
+    //! Number of receiver pipelines sharing the same ports.
+    //! Used by receiver node. If greater than one, node runs this many
+    //! pipelines, distributes packets between them by sender address, reads
+    //! them in parallel, and mixes their outputs.
+    size_t num_shards;
+
+    //! Mixer parameters.
+    //! Defines how sessions are grouped into sub-mixes (which are produced
+    //! by session threads, if any) and whether only loudest sessions are mixed.
+    audio::MixerConfig mixer;
+
+    //! Maximum number of sessions per slot.
+    //! If non-zero, memory for this many sessions is preallocated when slot is
+    //! created, and a new session is constructed inside an idle preallocated region
+    //! instead of allocating its components from the heap. Packets from new senders
+    //! beyond this limit are dropped. If zero, number of sessions is unlimited and
+    //! nothing is preallocated.
+    size_t max_sessions;
+
+    //! Size of memory region preallocated for each session, in bytes.
+    //! Used only if max_sessions is non-zero. If session needs more memory,
+    //! remaining allocations are performed from the heap.
+    size_t session_region_size;
+
+    //! Maximum packet rate of one session, in packets per second.
+    //! If non-zero, packets of a sender exceeding this rate are dropped when
+    //! routed, before reaching session queues. Protects shared packet pool
+    //! and pipeline time of other sessions from a flooding sender.
+    size_t max_session_packet_rate;
+
+    //! Maximum packet rate of all sessions of a slot, in packets per second.
+    //! If non-zero, packets exceeding this rate are dropped when routed,
+    //! including packets that would create new sessions.
+    size_t max_slot_packet_rate;
+
+    //! Burst allowed above packet rate limits.
+    //! Defines how many packets may arrive at once, as a duration of
+    //! packets at the limited rate.
+    core::nanoseconds_t packet_rate_burst;
+
+    //! Receive source packets over two paths (SMPTE 2022-7 style redundancy).
+    //! @remarks
+    //!  Allows adding second source endpoint to slot. Packets from both
+    //!  endpoints are routed to the same session by SSRC, and duplicates are
+    //!  dropped before session queue, so that loss on one path is covered by
+    //!  another path without adding latency.
+    bool enable_redundancy;
+
+    //! Duplicate filter parameters.
+    //! Used if redundancy is enabled.
+    packet::DuplicateFilterConfig duplicate_filter;
+
+    //! Maximum number of packets in each queue of one session.
+    //! If non-zero, bounds packets held by session source and repair queues.
+    //! Packets beyond this limit are dropped.
+    size_t max_session_queue_packets;
+
+    //! Route transport packets to sessions in network thread.
+    //! @remarks
+    //!  Packets are parsed and looked up in a snapshot of routing table by
+    //!  network thread, and pushed directly to per-session lock-free queues,
+    //!  instead of going through single inbound queue of endpoint, which is
+    //!  parsed and routed by pipeline thread. If max_session_queue_packets
+    //!  is set, it also bounds per-session queues, so that a flooding sender
+    //!  is throttled before its packets reach pipeline thread. Packets which
+    //!  can't be routed in network thread (e.g. of new sessions) are routed
+    //!  by pipeline thread as usual.
+    bool enable_early_routing;
+
+    //! Interval between control updates.
+    //! @remarks
+    //!  If non-zero, session refresh (watchdog, latency checks), RTCP reports
+    //!  and publishing of metrics are performed not more often than once per
+    //!  this interval (or earlier, if RTCP requests it), instead of on every
+    //!  frame. Packets are still received on every frame. If zero, control
+    //!  updates are performed on every frame.
+    core::nanoseconds_t control_interval;
+
+    //! Use low-latency profile.
+    //! @remarks
+    //!  Intended for very short frames and packets (125us - 1ms), when fixed
+    //!  per-frame costs dominate. Control updates and task processing are
+    //!  batched across several frames: if not set explicitly, control_interval
+    //!  and pipeline_loop.min_frame_length_between_tasks are raised.
+    //!  Profiling should be kept disabled, since it's performed per frame.
+    bool enable_low_latency;
+
+    //! Degrade quality of sessions when frame processing nears its budget.
+    //! @remarks
+    //!  Time spent producing frames is compared with their duration. When
+    //!  it's too high, expensive features (loss concealment, repair of FEC
+    //!  blocks close to playback) are disabled step by step, and enabled
+    //!  back when there is headroom again. Current level is reported via
+    //!  ReceiverParticipantMetrics::overload_level.
+    bool enable_overload_control;
+
+    //! Overload controller parameters.
+    OverloadControllerConfig overload_control;
+
+    //! Share clock drift estimate between sessions with same sender CNAME.
+    //! @remarks
+    //!  Sessions from one sender host, even in different slots, join one
+    //!  clock group: one of them runs frequency estimator, and others apply
+    //!  its scaling factor, so that streams captured by the same clock are
+    //!  resampled identically. Should be enabled only if senders use the
+    //!  same CNAME only for streams produced using the same clock.
+    //!  Used only if latency tuning is enabled.
+    bool enable_clock_groups;
+
+    //! Repair packets of all sessions of slot jointly.
+    //! @remarks
+    //!  Should be enabled when senders use shared FEC. Repair packets are not
+    //!  passed to sessions; instead, slot collects FEC blocks formed by source
+    //!  packets of all its sessions, and routes restored packets to sessions
+    //!  by source ID (see fec::GroupRepairer). Disables early routing.
+    bool enable_shared_fec;
+
+    //! Shared FEC repairer parameters.
+    //! Used if shared FEC is enabled.
+    fec::GroupRepairerConfig shared_fec;
+
     //! Initialize config.
     ReceiverCommonConfig();
 
@@ -170,9 +513,35 @@ struct ReceiverSessionConfig {
     //! Resampler parameters.
     audio::ResamplerConfig resampler;
 
+    //! Loss concealer parameters.
+    audio::LossConcealerConfig plc;
+
     //! Insert weird beeps instead of silence on packet loss.
     bool enable_beeping;
 
+    //! Conceal packet loss by repeating recent waveform.
+    //! @remarks
+    //!  Used for encodings without built-in concealment, like PCM. Losses
+    //!  not recovered by FEC are masked instead of being filled with silence,
+    //!  which allows lighter FEC and lower latency. Ignored if beeping is
+    //!  enabled.
+    bool enable_plc;
+
+    //! How long to keep state of ended session for warm start.
+    //! @remarks
+    //!  If a new session is created in the same slot during this period, it
+    //!  reuses clock drift estimate and resampler scaling of the ended session,
+    //!  and starts playback after warm_start_latency instead of target latency.
+    //!  Intended for quick reconnection to the same sender.
+    //! @note
+    //!  Zero disables warm start.
+    core::nanoseconds_t warm_start_timeout;
+
+    //! Prefill latency of warm-started session.
+    //! @note
+    //!  If zero, default value is used.
+    core::nanoseconds_t warm_start_latency;
+
     //! Initialize config.
     ReceiverSessionConfig();
 
@@ -210,6 +579,30 @@ struct ReceiverSlotConfig {
     void deduce_defaults();
 };
 
+//! Receiver parameters which can be changed without restarting sessions.
+//! @remarks
+//!  Applied to existing sessions of the slot and to sessions created later.
+struct ReceiverLiveConfig {
+    //! New target latency.
+    //! @remarks
+    //!  Latency tuner moves to the new target gradually.
+    //! @note
+    //!  If zero, target latency is not changed.
+    core::nanoseconds_t target_latency;
+
+    //! Replace resampler of sessions.
+    bool change_resampler;
+
+    //! New resampler profile.
+    //! @remarks
+    //!  Used if change_resampler is true. Resampler of a session is replaced
+    //!  when its stream becomes silent, so that there is no audible gap.
+    audio::ResamplerProfile resampler_profile;
+
+    //! Initialize config.
+    ReceiverLiveConfig();
+};
+
 //! Converter parameters.
 struct TranscoderConfig {
     //! Input sample spec
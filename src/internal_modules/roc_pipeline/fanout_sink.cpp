@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/fanout_sink.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+FanoutSink::FanoutSink(sndio::ISink& main_sink,
+                       core::nanoseconds_t frame_length,
+                       core::IPool& buffer_pool,
+                       core::IArena& arena)
+    : main_sink_(main_sink)
+    , sample_spec_(main_sink.sample_spec())
+    , buffer_pool_(buffer_pool)
+    , arena_(arena)
+    , block_size_(0)
+    , outputs_(arena)
+    , valid_(false) {
+    if (!sample_spec_.is_valid() || !sample_spec_.is_raw()) {
+        roc_log(LogError,
+                "fanout sink: main sink should have valid spec with raw format: spec=%s",
+                audio::sample_spec_to_str(sample_spec_).c_str());
+        return;
+    }
+
+    block_size_ = sample_spec_.ns_2_samples_overall(frame_length);
+    if (block_size_ == 0) {
+        roc_log(LogError, "fanout sink: frame size cannot be 0");
+        return;
+    }
+
+    valid_ = true;
+}
+
+FanoutSink::~FanoutSink() {
+    for (size_t n = 0; n < outputs_.size(); n++) {
+        arena_.destroy_object(*outputs_[n]);
+    }
+}
+
+bool FanoutSink::is_valid() const {
+    return valid_;
+}
+
+bool FanoutSink::add_output(sndio::ISink& sink, const FanoutOutputConfig& config) {
+    roc_panic_if(!is_valid());
+
+    Output* output = new (arena_)
+        Output(sink, config, sample_spec_, block_size_, buffer_pool_, arena_);
+    if (!output) {
+        roc_log(LogError, "fanout sink: can't allocate output");
+        return false;
+    }
+
+    if (!output->is_valid()) {
+        arena_.destroy_object(*output);
+        return false;
+    }
+
+    if (!outputs_.push_back(output)) {
+        roc_log(LogError, "fanout sink: can't allocate output");
+        arena_.destroy_object(*output);
+        return false;
+    }
+
+    return true;
+}
+
+size_t FanoutSink::num_outputs() const {
+    return outputs_.size();
+}
+
+FanoutOutputMetrics FanoutSink::output_metrics(size_t index) const {
+    roc_panic_if(index >= outputs_.size());
+
+    return outputs_[index]->metrics();
+}
+
+sndio::ISink* FanoutSink::to_sink() {
+    return this;
+}
+
+sndio::ISource* FanoutSink::to_source() {
+    return NULL;
+}
+
+sndio::DeviceType FanoutSink::type() const {
+    return main_sink_.type();
+}
+
+sndio::DeviceState FanoutSink::state() const {
+    return main_sink_.state();
+}
+
+void FanoutSink::pause() {
+    main_sink_.pause();
+}
+
+bool FanoutSink::resume() {
+    return main_sink_.resume();
+}
+
+bool FanoutSink::restart() {
+    return main_sink_.restart();
+}
+
+audio::SampleSpec FanoutSink::sample_spec() const {
+    return sample_spec_;
+}
+
+core::nanoseconds_t FanoutSink::latency() const {
+    return main_sink_.latency();
+}
+
+bool FanoutSink::has_latency() const {
+    return main_sink_.has_latency();
+}
+
+bool FanoutSink::has_clock() const {
+    return main_sink_.has_clock();
+}
+
+void FanoutSink::write(audio::Frame& frame) {
+    roc_panic_if(!is_valid());
+
+    // Outputs don't modify frame, so it's written to all of them as is.
+    main_sink_.write(frame);
+
+    for (size_t n = 0; n < outputs_.size(); n++) {
+        outputs_[n]->write(frame);
+    }
+}
+
+FanoutSink::Output::Output(sndio::ISink& sink,
+                           const FanoutOutputConfig& config,
+                           const audio::SampleSpec& sample_spec,
+                           size_t block_size,
+                           core::IPool& buffer_pool,
+                           core::IArena& arena)
+    : sample_spec_(sample_spec)
+    , writer_(&sink)
+    , n_written_(0)
+    , n_dropped_(0)
+    , valid_(false) {
+    const audio::SampleSpec sink_spec = sink.sample_spec();
+
+    if (sink_spec != sample_spec_) {
+        // Convert only if specs differ.
+        TranscoderConfig transcoder_config;
+        transcoder_config.input_sample_spec = sample_spec_;
+        transcoder_config.output_sample_spec = sink_spec;
+        transcoder_config.resampler = config.resampler;
+
+        transcoder_.reset(new (transcoder_) TranscoderSink(transcoder_config, &sink,
+                                                           buffer_pool, arena));
+        if (!transcoder_->is_valid()) {
+            roc_log(LogError, "fanout sink: can't create transcoder: in=%s out=%s",
+                    audio::sample_spec_to_str(sample_spec_).c_str(),
+                    audio::sample_spec_to_str(sink_spec).c_str());
+            return;
+        }
+
+        writer_ = transcoder_.get();
+    }
+
+    if (config.ring_length > 0) {
+        const size_t n_blocks =
+            std::max((size_t)1, sample_spec_.ns_2_samples_overall(config.ring_length)
+                         / block_size);
+
+        ring_.reset(new (ring_) sndio::SampleRing(arena, block_size, n_blocks));
+        if (!ring_->is_valid()) {
+            roc_log(LogError, "fanout sink: can't allocate ring");
+            return;
+        }
+
+        if (!start()) {
+            roc_log(LogError, "fanout sink: can't start output thread");
+            return;
+        }
+    }
+
+    roc_log(LogDebug, "fanout sink: added output: convert=%d async=%d spec=%s",
+            (int)!!transcoder_, (int)!!ring_,
+            audio::sample_spec_to_str(sink_spec).c_str());
+
+    valid_ = true;
+}
+
+FanoutSink::Output::~Output() {
+    if (!ring_) {
+        return;
+    }
+
+    if (is_joinable()) {
+        // Empty block marks end of stream. Thread exits after writing
+        // all blocks before it.
+        if (ring_->begin_write()) {
+            ring_->end_write(0);
+        } else {
+            ring_->close();
+        }
+        join();
+    }
+}
+
+bool FanoutSink::Output::is_valid() const {
+    return valid_;
+}
+
+FanoutOutputMetrics FanoutSink::Output::metrics() const {
+    FanoutOutputMetrics metrics;
+    metrics.written_length = sample_spec_.samples_overall_2_ns(n_written_);
+    metrics.dropped_length = sample_spec_.samples_overall_2_ns(n_dropped_);
+
+    return metrics;
+}
+
+void FanoutSink::Output::write(audio::Frame& frame) {
+    roc_panic_if(!valid_);
+
+    if (!ring_) {
+        writer_->write(frame);
+        n_written_ += frame.num_raw_samples();
+        return;
+    }
+
+    const audio::sample_t* samples = frame.raw_samples();
+    size_t n_samples = frame.num_raw_samples();
+
+    while (n_samples != 0) {
+        audio::sample_t* block = ring_->try_begin_write();
+        if (!block) {
+            // Output is too slow, drop what doesn't fit.
+            n_dropped_ += n_samples;
+            break;
+        }
+
+        const size_t n_copy = std::min(n_samples, ring_->block_size());
+        memcpy(block, samples, n_copy * sizeof(audio::sample_t));
+
+        ring_->end_write(n_copy);
+
+        samples += n_copy;
+        n_samples -= n_copy;
+    }
+}
+
+// Output thread.
+void FanoutSink::Output::run() {
+    for (;;) {
+        size_t n_samples = 0;
+        const audio::sample_t* block = ring_->begin_read(n_samples);
+        if (!block) {
+            // ring was closed
+            break;
+        }
+
+        if (n_samples == 0) {
+            // end of stream
+            ring_->end_read();
+            break;
+        }
+
+        write_block_(block, n_samples);
+
+        ring_->end_read();
+    }
+}
+
+void FanoutSink::Output::write_block_(const audio::sample_t* samples,
+                                      size_t n_samples) {
+    // Frame is not modified by writer.
+    audio::Frame frame(const_cast<audio::sample_t*>(samples), n_samples);
+    frame.set_duration(
+        (packet::stream_timestamp_t)(n_samples / sample_spec_.num_channels()));
+
+    writer_->write(frame);
+
+    n_written_ += n_samples;
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/fanout_sink.h
+//! @brief Sink duplicating audio stream to multiple sinks.
+
+#ifndef ROC_PIPELINE_FANOUT_SINK_H_
+#define ROC_PIPELINE_FANOUT_SINK_H_
+
+#include "roc_audio/resampler_config.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_pipeline/transcoder_sink.h"
+#include "roc_sndio/isink.h"
+#include "roc_sndio/sample_ring.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Fanout output parameters.
+struct FanoutOutputConfig {
+    //! Length of ring between fanout and output.
+    //! @remarks
+    //!  If non-zero, output is written from its own thread, and samples
+    //!  which don't fit into ring are dropped, so that slow output never
+    //!  blocks main sink. If zero, output is written synchronously.
+    core::nanoseconds_t ring_length;
+
+    //! Resampler parameters.
+    //! @remarks
+    //!  Used if output sample rate differs from main sink.
+    audio::ResamplerConfig resampler;
+
+    //! Initialize config with default values.
+    FanoutOutputConfig()
+        : ring_length(0) {
+    }
+};
+
+//! Fanout output metrics.
+struct FanoutOutputMetrics {
+    //! Total duration of samples written to output.
+    core::nanoseconds_t written_length;
+
+    //! Total duration of samples dropped because ring was full.
+    core::nanoseconds_t dropped_length;
+
+    FanoutOutputMetrics()
+        : written_length(0)
+        , dropped_length(0) {
+    }
+};
+
+//! Sink duplicating audio stream to multiple sinks.
+//! @remarks
+//!  Frames are written to main sink, and then to every added output. Main
+//!  sink defines sample spec, state, latency and clock of fanout, so fanout
+//!  can be used in place of main sink, e.g. for playing receiver mix to a
+//!  device and recording it to a file at the same time, without running
+//!  receiver pipeline twice.
+//!
+//!  If output sample spec differs from main sink, frames are converted using
+//!  transcoder pipeline; otherwise they're passed as is.
+//!
+//!  Asynchronous outputs (see FanoutOutputConfig::ring_length) are decoupled
+//!  from main sink by lock-free ring; conversion and writing happen on the
+//!  output thread. Samples still in ring are written when fanout is destroyed.
+class FanoutSink : public sndio::ISink, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Main sink should have raw sample format.
+    //!  @p frame_length defines block size of asynchronous rings.
+    FanoutSink(sndio::ISink& main_sink,
+               core::nanoseconds_t frame_length,
+               core::IPool& buffer_pool,
+               core::IArena& arena);
+
+    //! Deinitialize.
+    //! @remarks
+    //!  Flushes and stops asynchronous outputs.
+    ~FanoutSink();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Add output sink.
+    //! @remarks
+    //!  Should be called before first write().
+    ROC_ATTR_NODISCARD bool add_output(sndio::ISink& sink,
+                                       const FanoutOutputConfig& config);
+
+    //! Get number of added outputs.
+    size_t num_outputs() const;
+
+    //! Get metrics of output.
+    //! @remarks
+    //!  Can be called from any thread.
+    FanoutOutputMetrics output_metrics(size_t index) const;
+
+    //! Cast IDevice to ISink.
+    virtual sndio::ISink* to_sink();
+
+    //! Cast IDevice to ISource.
+    virtual sndio::ISource* to_source();
+
+    //! Get device type.
+    virtual sndio::DeviceType type() const;
+
+    //! Get device state.
+    virtual sndio::DeviceState state() const;
+
+    //! Pause main sink.
+    virtual void pause();
+
+    //! Resume main sink.
+    virtual bool resume();
+
+    //! Restart main sink.
+    virtual bool restart();
+
+    //! Get sample specification of main sink.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of main sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if main sink supports latency reports.
+    virtual bool has_latency() const;
+
+    //! Check if main sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Write audio frame to main sink and all outputs.
+    virtual void write(audio::Frame& frame);
+
+private:
+    class Output : private core::Thread {
+    public:
+        Output(sndio::ISink& sink,
+               const FanoutOutputConfig& config,
+               const audio::SampleSpec& sample_spec,
+               size_t block_size,
+               core::IPool& buffer_pool,
+               core::IArena& arena);
+
+        ~Output();
+
+        bool is_valid() const;
+
+        FanoutOutputMetrics metrics() const;
+
+        void write(audio::Frame& frame);
+
+    private:
+        virtual void run();
+
+        void write_block_(const audio::sample_t* samples, size_t n_samples);
+
+        const audio::SampleSpec sample_spec_;
+
+        core::Optional<TranscoderSink> transcoder_;
+        sndio::ISink* writer_;
+
+        core::Optional<sndio::SampleRing> ring_;
+
+        core::Atomic<size_t> n_written_;
+        core::Atomic<size_t> n_dropped_;
+
+        bool valid_;
+    };
+
+    sndio::ISink& main_sink_;
+    const audio::SampleSpec sample_spec_;
+
+    core::IPool& buffer_pool_;
+    core::IArena& arena_;
+
+    size_t block_size_;
+
+    core::Array<Output*> outputs_;
+
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_FANOUT_SINK_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/fec_group_map.h"
+#include "roc_address/socket_addr_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace pipeline {
+
+FecGroupMap::FecGroupMap(packet::PacketFactory& packet_factory, core::IArena& arena)
+    : packet_factory_(packet_factory)
+    , arena_(arena) {
+}
+
+core::SharedPtr<fec::GroupWriter>
+FecGroupMap::find_or_create(const FecGroupKey& key,
+                            const fec::WriterConfig& writer_config,
+                            const fec::CodecConfig& codec_config) {
+    roc_panic_if(!key.repair_address);
+    roc_panic_if(key.fec_scheme != codec_config.scheme);
+
+    core::Mutex::Lock lock(mutex_);
+
+    remove_unused_();
+
+    for (core::SharedPtr<Entry> entry = list_.front(); entry;
+         entry = list_.nextof(*entry)) {
+        if (key_equal_(entry->key, key)) {
+            return entry->group;
+        }
+    }
+
+    core::SharedPtr<Entry> entry = new (arena_) Entry(arena_);
+    if (!entry) {
+        return NULL;
+    }
+
+    entry->key = key;
+    entry->group = new (arena_)
+        fec::GroupWriter(writer_config, codec_config, packet_factory_, arena_);
+    if (!entry->group || !entry->group->is_valid()) {
+        return NULL;
+    }
+
+    list_.push_back(*entry);
+
+    roc_log(LogDebug,
+            "fec group map: created group: repair_addr=%s fec_scheme=%s pt=%u"
+            " num_groups=%lu",
+            address::socket_addr_to_str(key.repair_address).c_str(),
+            packet::fec_scheme_to_str(key.fec_scheme), key.payload_type,
+            (unsigned long)list_.size());
+
+    return entry->group;
+}
+
+size_t FecGroupMap::num_groups() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return list_.size();
+}
+
+bool FecGroupMap::key_equal_(const FecGroupKey& key1, const FecGroupKey& key2) {
+    return key1.repair_address == key2.repair_address
+        && key1.fec_scheme == key2.fec_scheme && key1.payload_type == key2.payload_type
+        && key1.packet_length == key2.packet_length;
+}
+
+void FecGroupMap::remove_unused_() {
+    core::SharedPtr<Entry> entry = list_.front();
+
+    while (entry) {
+        core::SharedPtr<Entry> next_entry = list_.nextof(*entry);
+
+        // Map holds the only reference.
+        if (entry->group->getref() == 1) {
+            roc_log(LogDebug, "fec group map: removed group: repair_addr=%s",
+                    address::socket_addr_to_str(entry->key.repair_address).c_str());
+
+            list_.remove(*entry);
+        }
+
+        entry = next_entry;
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/fec_group_map.h
+//! @brief Shared FEC writers by destination.
+
+#ifndef ROC_PIPELINE_FEC_GROUP_MAP_H_
+#define ROC_PIPELINE_FEC_GROUP_MAP_H_
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/allocation_policy.h"
+#include "roc_core/iarena.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/ref_counted.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/group_writer.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Parameters that should match for sessions to share FEC writer.
+struct FecGroupKey {
+    //! Address of remote repair endpoint.
+    address::SocketAddr repair_address;
+
+    //! FEC scheme.
+    packet::FecScheme fec_scheme;
+
+    //! Payload type of source packets.
+    unsigned int payload_type;
+
+    //! Duration of source packets.
+    //! @remarks
+    //!  Together with payload type, defines size of source packets.
+    core::nanoseconds_t packet_length;
+
+    FecGroupKey()
+        : fec_scheme(packet::FEC_None)
+        , payload_type(0)
+        , packet_length(0) {
+    }
+};
+
+//! Shared FEC writers by destination.
+//!
+//! Sessions which send packets with same FEC scheme and same payload size to
+//! the same repair endpoint, even if they belong to different senders, get the
+//! same fec::GroupWriter and protect their packets jointly.
+//!
+//! Map can be used from multiple pipeline threads. Groups not used by any
+//! session are removed when next group is requested.
+class FecGroupMap : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p packet_factory and @p arena are used by groups, so they should
+    //!  outlive all senders using the map.
+    FecGroupMap(packet::PacketFactory& packet_factory, core::IArena& arena);
+
+    //! Get group for given key, creating it if needed.
+    //! @remarks
+    //!  If group is created, @p writer_config and @p codec_config define its
+    //!  block size and scheme. Otherwise they're ignored.
+    //! @returns
+    //!  NULL if allocation failed.
+    core::SharedPtr<fec::GroupWriter>
+    find_or_create(const FecGroupKey& key,
+                   const fec::WriterConfig& writer_config,
+                   const fec::CodecConfig& codec_config);
+
+    //! Get number of groups.
+    size_t num_groups() const;
+
+private:
+    struct Entry : core::RefCounted<Entry, core::ArenaAllocation>, core::ListNode<> {
+        Entry(core::IArena& arena)
+            : core::RefCounted<Entry, core::ArenaAllocation>(arena) {
+        }
+
+        FecGroupKey key;
+        core::SharedPtr<fec::GroupWriter> group;
+    };
+
+    static bool key_equal_(const FecGroupKey& key1, const FecGroupKey& key2);
+
+    void remove_unused_();
+
+    mutable core::Mutex mutex_;
+
+    packet::PacketFactory& packet_factory_;
+    core::IArena& arena_;
+
+    // Number of groups is small, hence linear search.
+    core::List<Entry> list_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_FEC_GROUP_MAP_H_
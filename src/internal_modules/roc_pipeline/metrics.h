@@ -13,8 +13,20 @@
 #define ROC_PIPELINE_METRICS_H_
 
 #include "roc_audio/latency_tuner.h"
+#include "roc_audio/profiler.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/occupancy_metrics.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/ticker.h"
+#include "roc_core/time.h"
+#include "roc_fec/block_size_tuner.h"
+#include "roc_fec/group_repairer.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/writer.h"
 #include "roc_packet/ilink_meter.h"
+#include "roc_packet/pacer.h"
+#include "roc_packet/retransmitter.h"
 #include "roc_packet/units.h"
 
 namespace roc {
@@ -28,7 +40,12 @@ struct SenderParticipantMetrics {
     //! Latency metrics.
     audio::LatencyMetrics latency;
 
-    SenderParticipantMetrics() {
+    //! Time spent by pipeline thread in sender session, per second.
+    //! Session is shared by all participants of the slot.
+    core::nanoseconds_t cpu_ns_per_sec;
+
+    SenderParticipantMetrics()
+        : cpu_ns_per_sec(0) {
     }
 };
 
@@ -43,13 +60,94 @@ struct SenderSlotMetrics {
     //! Is slot configuration complete (all endpoints bound).
     bool is_complete;
 
+    //! FEC writer metrics.
+    fec::WriterMetrics fec;
+
+    //! FEC block size tuner metrics.
+    fec::BlockSizeTunerMetrics fec_tuner;
+
+    //! Packet pacer metrics.
+    packet::PacerMetrics pacer;
+
+    //! Packet retransmitter metrics.
+    packet::RetransmitterMetrics retransmitter;
+
+    //! Path MTU of source endpoint, in bytes.
+    //! Zero if unknown.
+    size_t path_mtu;
+
+    //! Length of outgoing packets, in nanoseconds.
+    //! Differs from configured length if MTU autotuning is enabled.
+    core::nanoseconds_t packet_length;
+
+    //! Cumulative count of repair packets dropped before sending, because
+    //! send queue was overloaded.
+    uint64_t dropped_repair_packets;
+
+    //! Metrics of timer pacing frames written to sender.
+    //! Used only if enable_timing is set. Common for all slots of sender.
+    core::TickerMetrics timing;
+
+    //! Cumulative count of frames which pipeline took longer to write
+    //! than their duration. Common for all slots of sender.
+    uint64_t frame_overruns;
+
+    //! Processing speed of sender pipeline. Common for all slots of sender.
+    //! Zero if profiling is disabled.
+    audio::ProfilerMetrics profiler;
+
     SenderSlotMetrics()
         : source_id(0)
         , num_participants(0)
-        , is_complete(false) {
+        , is_complete(false)
+        , path_mtu(0)
+        , packet_length(0)
+        , dropped_repair_packets(0)
+        , frame_overruns(0) {
     }
 };
 
+//! Occupancy of buffering stages of receiver session.
+//! @remarks
+//!  Stages are listed in the order in which packets and samples pass them.
+//!  Stages not present in session are zero.
+struct ReceiverSessionGraph {
+    //! Queue of source packets, in packets.
+    core::OccupancyMetrics source_queue;
+
+    //! Queue of repair packets, in packets.
+    core::OccupancyMetrics repair_queue;
+
+    //! Queue of source packets inside FEC reader, in packets.
+    core::OccupancyMetrics fec_source_queue;
+
+    //! Queue of repair packets inside FEC reader, in packets.
+    core::OccupancyMetrics fec_repair_queue;
+
+    //! Queue of delayed reader, in packets.
+    //! Non-zero only until initial latency is accumulated.
+    core::OccupancyMetrics delayed_queue;
+
+    //! Resampler, in input samples per channel.
+    core::OccupancyMetrics resampler;
+};
+
+//! Occupancy of buffering stages of receiver slot.
+struct ReceiverSlotGraph {
+    //! Inbound queue of source endpoint, in packets.
+    core::OccupancyMetrics source_endpoint;
+
+    //! Inbound queue of repair endpoint, in packets.
+    core::OccupancyMetrics repair_endpoint;
+
+    //! Inbound queue of control endpoint, in packets.
+    core::OccupancyMetrics control_endpoint;
+
+    //! Mixer, occupancy is the number of inputs.
+    //! Common for all slots of receiver.
+    core::OccupancyMetrics mixer;
+};
+
 //! Receiver-side metrics specific to one participant (remote sender).
 struct ReceiverParticipantMetrics {
     //! Link metrics.
@@ -58,7 +156,53 @@ struct ReceiverParticipantMetrics {
     //! Latency metrics.
     audio::LatencyMetrics latency;
 
-    ReceiverParticipantMetrics() {
+    //! FEC metrics.
+    //! Zero if FEC is disabled.
+    fec::ReaderMetrics fec;
+
+    //! Cumulative count of samples per channel generated in place of lost
+    //! packets by packet loss concealment.
+    uint64_t concealed_samples;
+
+    //! Cumulative count of packets dropped on arrival, because playback
+    //! position already passed them.
+    uint64_t late_packets;
+
+    //! Cumulative count of packets dropped on arrival, because the same
+    //! packet was already received over another path.
+    //! Zero if redundancy is disabled.
+    uint64_t duplicate_packets;
+
+    //! Cumulative count of packets dropped on arrival, because sender
+    //! exceeded session packet rate limit.
+    uint64_t rate_limited_packets;
+
+    //! Cumulative count of packets dropped on arrival, because session
+    //! queue reached its size limit.
+    uint64_t queue_overflow_packets;
+
+    //! Time spent by pipeline thread in receiver session, per second.
+    //! Includes reading frames and routing packets to session.
+    core::nanoseconds_t cpu_ns_per_sec;
+
+    //! Quality degradation level applied because of CPU overload.
+    //! Zero (OverloadLevel_None) if overload control is disabled.
+    unsigned overload_level;
+
+    //! Memory allocated by session components, per subsystem.
+    core::MemoryUsage memory;
+
+    //! Occupancy of session buffers.
+    ReceiverSessionGraph graph;
+
+    ReceiverParticipantMetrics()
+        : concealed_samples(0)
+        , late_packets(0)
+        , duplicate_packets(0)
+        , rate_limited_packets(0)
+        , queue_overflow_packets(0)
+        , cpu_ns_per_sec(0)
+        , overload_level(0) {
     }
 };
 
@@ -70,9 +214,47 @@ struct ReceiverSlotMetrics {
     //! Number of participants (remote senders) connected to slot.
     size_t num_participants;
 
+    //! Per-stage processing time distribution.
+    //! Zero if stage profiling is disabled.
+    //! Mixer and PCM mapper stages are shared by all slots of the receiver.
+    audio::StageProfilerMetrics stages;
+
+    //! Cumulative count of packets dropped on arrival, because slot
+    //! packet rate limit was exceeded.
+    //! Doesn't include packets dropped by per-session limit.
+    uint64_t rate_limited_packets;
+
+    //! Cumulative count of frames which pipeline took longer to read
+    //! than their duration. Common for all slots of receiver.
+    uint64_t frame_overruns;
+
+    //! Processing speed of receiver pipeline. Common for all slots of receiver.
+    //! Zero if profiling is disabled.
+    audio::ProfilerMetrics profiler;
+
+    //! Occupancy of slot buffers.
+    ReceiverSlotGraph graph;
+
+    //! Cumulative count of packets routed to sessions in network thread.
+    //! Zero if early routing is disabled.
+    uint64_t early_routed_packets;
+
+    //! Cumulative count of packets dropped in network thread, because
+    //! per-session queue was full.
+    //! Zero if early routing is disabled.
+    uint64_t early_dropped_packets;
+
+    //! Metrics of FEC repair shared by all sessions of slot.
+    //! Zero if shared FEC is disabled.
+    fec::GroupRepairerMetrics shared_fec;
+
     ReceiverSlotMetrics()
         : source_id(0)
-        , num_participants(0) {
+        , num_participants(0)
+        , rate_limited_packets(0)
+        , frame_overruns(0)
+        , early_routed_packets(0)
+        , early_dropped_packets(0) {
     }
 };
 
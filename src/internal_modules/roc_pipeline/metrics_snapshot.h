@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/metrics_snapshot.h
+//! @brief Lock-free metrics snapshot.
+
+#ifndef ROC_PIPELINE_METRICS_SNAPSHOT_H_
+#define ROC_PIPELINE_METRICS_SNAPSHOT_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/stddefs.h"
+#include "roc_pipeline/metrics.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Lock-free snapshot of slot and participant metrics.
+//!
+//! @remarks
+//!  Pipeline thread publishes metrics once per frame, and any other thread can
+//!  read the last published version without scheduling a task and without
+//!  blocking the pipeline.
+//!
+//! @remarks
+//!  Snapshot is double-buffered: each publish goes to the buffer that is not
+//!  marked as latest, and readers start from the latest one. Both buffers are
+//!  protected by seqlock, so a reader can fail only if it was preempted for
+//!  two whole frames.
+//!
+//! @tparam SlotMetrics defines slot metrics struct.
+//! @tparam PartyMetrics defines participant metrics struct.
+template <class SlotMetrics, class PartyMetrics>
+class MetricsSnapshot : public core::NonCopyable<> {
+public:
+    //! Maximum number of participants stored in snapshot.
+    enum { MaxParticipants = 8 };
+
+    //! Published data.
+    struct Data {
+        //! Slot metrics.
+        SlotMetrics slot;
+
+        //! Participant metrics.
+        PartyMetrics party[MaxParticipants];
+
+        //! Number of valid elements in party.
+        size_t party_count;
+
+        Data()
+            : party_count(0) {
+        }
+    };
+
+    //! Initialize empty snapshot.
+    MetricsSnapshot()
+        : buf0_(Data())
+        , buf1_(Data())
+        , latest_(-1) {
+    }
+
+    //! Publish new data.
+    //! @remarks
+    //!  Publishes are not allowed to be concurrent.
+    //!  Lock-free and wait-free.
+    void publish(const Data& data) {
+        const int next = latest_ == 0 ? 1 : 0;
+
+        buffer_(next).exclusive_store(data);
+        latest_ = next;
+    }
+
+    //! Load last published data.
+    //! @remarks
+    //!  Fills @p slot_metrics and up to @p party_count elements of @p party_metrics,
+    //!  and updates @p party_count to the number of filled elements, like
+    //!  ReceiverSlot::get_metrics() and SenderSlot::get_metrics() do.
+    //!  Lock-free and wait-free.
+    //! @returns
+    //!  false if nothing was published yet, if both buffers were overwritten
+    //!  during the read, or if caller requested more participants than the
+    //!  snapshot was able to hold.
+    bool load(SlotMetrics& slot_metrics,
+              PartyMetrics* party_metrics,
+              size_t* party_count) const {
+        const int latest = latest_;
+        if (latest < 0) {
+            return false;
+        }
+
+        Data data;
+        if (!buffer_(latest).try_load(data)
+            && !buffer_(latest == 0 ? 1 : 0).try_load(data)) {
+            return false;
+        }
+
+        if (party_metrics && party_count) {
+            if (*party_count > data.party_count
+                && data.slot.num_participants > data.party_count) {
+                return false;
+            }
+
+            *party_count = std::min(*party_count, data.party_count);
+
+            for (size_t n_part = 0; n_part < *party_count; n_part++) {
+                party_metrics[n_part] = data.party[n_part];
+            }
+        } else if (party_count) {
+            *party_count = 0;
+        }
+
+        slot_metrics = data.slot;
+
+        return true;
+    }
+
+private:
+    core::Seqlock<Data>& buffer_(int n) {
+        return n == 0 ? buf0_ : buf1_;
+    }
+
+    const core::Seqlock<Data>& buffer_(int n) const {
+        return n == 0 ? buf0_ : buf1_;
+    }
+
+    core::Seqlock<Data> buf0_;
+    core::Seqlock<Data> buf1_;
+
+    core::Atomic<int> latest_;
+};
+
+//! Receiver slot metrics snapshot.
+typedef MetricsSnapshot<ReceiverSlotMetrics, ReceiverParticipantMetrics>
+    ReceiverMetricsSnapshot;
+
+//! Sender slot metrics snapshot.
+typedef MetricsSnapshot<SenderSlotMetrics, SenderParticipantMetrics>
+    SenderMetricsSnapshot;
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_METRICS_SNAPSHOT_H_
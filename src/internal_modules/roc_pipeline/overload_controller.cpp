@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/overload_controller.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+const char* overload_level_to_str(OverloadLevel level) {
+    switch (level) {
+    case OverloadLevel_None:
+        return "none";
+    case OverloadLevel_NoConcealment:
+        return "no_concealment";
+    case OverloadLevel_NoLateRepair:
+        return "no_late_repair";
+    case OverloadLevel_Max:
+        break;
+    }
+    return "<invalid>";
+}
+
+OverloadController::OverloadController(const OverloadControllerConfig& config)
+    : config_(config)
+    , level_(OverloadLevel_None)
+    , window_proc_(0)
+    , window_audio_(0)
+    , load_(0)
+    , n_low_windows_(0) {
+    roc_panic_if_msg(config_.window <= 0 || config_.low_load > config_.high_load,
+                     "overload controller: invalid config:"
+                     " window=%.3fms low_load=%.3f high_load=%.3f",
+                     (double)config_.window / core::Millisecond,
+                     (double)config_.low_load, (double)config_.high_load);
+}
+
+bool OverloadController::report_frame(core::nanoseconds_t proc_time,
+                                      core::nanoseconds_t frame_duration) {
+    window_proc_ += proc_time;
+    window_audio_ += frame_duration;
+
+    if (window_audio_ < config_.window) {
+        return false;
+    }
+
+    load_ = (float)((double)window_proc_ / (double)window_audio_);
+
+    window_proc_ = 0;
+    window_audio_ = 0;
+
+    const OverloadLevel prev_level = level_;
+
+    if (load_ > config_.high_load) {
+        n_low_windows_ = 0;
+        if (level_ + 1 < OverloadLevel_Max) {
+            level_ = OverloadLevel(level_ + 1);
+        }
+    } else if (load_ < config_.low_load) {
+        n_low_windows_++;
+        if (n_low_windows_ >= config_.step_up_windows && level_ > OverloadLevel_None) {
+            level_ = OverloadLevel(level_ - 1);
+            n_low_windows_ = 0;
+        }
+    } else {
+        n_low_windows_ = 0;
+    }
+
+    if (level_ == prev_level) {
+        return false;
+    }
+
+    roc_log(LogInfo, "overload controller: switching level: load=%.3f level=%s->%s",
+            (double)load_, overload_level_to_str(prev_level),
+            overload_level_to_str(level_));
+
+    return true;
+}
+
+OverloadLevel OverloadController::level() const {
+    return level_;
+}
+
+float OverloadController::load() const {
+    return load_;
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/overload_controller.h
+//! @brief Quality degradation under CPU overload.
+
+#ifndef ROC_PIPELINE_OVERLOAD_CONTROLLER_H_
+#define ROC_PIPELINE_OVERLOAD_CONTROLLER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Quality degradation level.
+//! Every level includes degradations of previous levels.
+enum OverloadLevel {
+    //! No degradation.
+    OverloadLevel_None,
+
+    //! Loss concealment is disabled, lost samples are filled with zeros.
+    OverloadLevel_NoConcealment,
+
+    //! FEC blocks which end close to playback position are not repaired.
+    OverloadLevel_NoLateRepair,
+
+    //! Number of levels.
+    OverloadLevel_Max
+};
+
+//! Get string name of overload level.
+const char* overload_level_to_str(OverloadLevel level);
+
+//! Overload controller parameters.
+struct OverloadControllerConfig {
+    //! Duration of audio over which processing load is measured.
+    core::nanoseconds_t window;
+
+    //! Step down if processing time exceeds this fraction of audio duration.
+    float high_load;
+
+    //! Step up if processing time stays below this fraction of audio duration.
+    float low_load;
+
+    //! How many windows in a row load should be low before stepping up.
+    //! Protects from oscillating between levels.
+    size_t step_up_windows;
+
+    //! FEC repair margin used at OverloadLevel_NoLateRepair.
+    //! Blocks that end less than this duration after playback position
+    //! are not repaired.
+    core::nanoseconds_t repair_margin;
+
+    OverloadControllerConfig()
+        : window(200 * core::Millisecond)
+        , high_load(0.8f)
+        , low_load(0.5f)
+        , step_up_windows(5)
+        , repair_margin(20 * core::Millisecond) {
+    }
+};
+
+//! Overload controller.
+//!
+//! Measures how much time pipeline spends producing frames relative to their
+//! duration. When it's close to frame duration (so pipeline is about to miss
+//! its deadlines), steps down to next degradation level, one level per window.
+//! When there is enough headroom again during several windows, steps back up.
+//!
+//! Controller only makes decisions; they're applied by pipeline to sessions,
+//! see ReceiverSession::set_overload_level().
+class OverloadController : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit OverloadController(const OverloadControllerConfig& config);
+
+    //! Report processed frame.
+    //! @remarks
+    //!  @p proc_time is time spent producing frame, @p frame_duration is
+    //!  duration of audio in frame.
+    //! @returns
+    //!  true if level was changed.
+    bool report_frame(core::nanoseconds_t proc_time, core::nanoseconds_t frame_duration);
+
+    //! Get current degradation level.
+    OverloadLevel level() const;
+
+    //! Get load measured during last complete window.
+    //! E.g. 0.5 means that producing frames took half of their duration.
+    float load() const;
+
+private:
+    const OverloadControllerConfig config_;
+
+    OverloadLevel level_;
+
+    core::nanoseconds_t window_proc_;
+    core::nanoseconds_t window_audio_;
+    float load_;
+
+    size_t n_low_windows_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_OVERLOAD_CONTROLLER_H_
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/overrun_detector.h"
+#include "roc_core/attributes.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+double ns_2_ms(core::nanoseconds_t ns) {
+    return (double)ns / core::Millisecond;
+}
+
+// Append formatted string to buffer, truncating if it doesn't fit.
+void append(char* buf, size_t buf_size, size_t& pos, const char* fmt, ...)
+    ROC_ATTR_PRINTF(4, 5);
+
+void append(char* buf, size_t buf_size, size_t& pos, const char* fmt, ...) {
+    if (pos >= buf_size) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    const int ret = vsnprintf(buf + pos, buf_size - pos, fmt, args);
+    va_end(args);
+
+    if (ret > 0) {
+        pos += (size_t)ret;
+    }
+}
+
+} // namespace
+
+void FrameOverrun::clear() {
+    frame_duration = 0;
+    proc_time = 0;
+    wait_time = 0;
+    blocking_task = NULL;
+    blocking_task_time = 0;
+    frame_time = 0;
+    task_time = 0;
+    num_tasks = 0;
+    for (size_t n = 0; n < MaxTasks; n++) {
+        task_names[n] = NULL;
+        task_times[n] = 0;
+    }
+    has_stages = false;
+    for (size_t n = 0; n < audio::ProfilerStage_Max; n++) {
+        stage_times[n] = 0;
+    }
+}
+
+OverrunDetector::OverrunDetector(const OverrunDetectorConfig& config)
+    : config_(config)
+    , in_frame_(false)
+    , call_time_(0)
+    , last_task_(NULL)
+    , last_task_start_(0)
+    , last_task_end_(0)
+    , num_overruns_(0)
+    , last_report_(0)
+    , num_unreported_(0) {
+    roc_panic_if_msg(config_.threshold <= 0 || config_.report_interval < 0,
+                     "overrun detector: invalid config:"
+                     " threshold=%.3f report_interval=%.3fms",
+                     (double)config_.threshold, ns_2_ms(config_.report_interval));
+}
+
+bool OverrunDetector::is_enabled() const {
+    return config_.enable;
+}
+
+void OverrunDetector::begin_frame(core::nanoseconds_t call_time,
+                                  core::nanoseconds_t start_time,
+                                  core::nanoseconds_t frame_duration) {
+    roc_panic_if_msg(in_frame_, "overrun detector: unpaired begin_frame()");
+
+    in_frame_ = true;
+    call_time_ = call_time;
+
+    frame_.clear();
+    frame_.frame_duration = frame_duration;
+    frame_.wait_time = std::max(start_time - call_time, (core::nanoseconds_t)0);
+
+    // Task that was running when frame was requested.
+    if (last_task_ && last_task_end_ > call_time) {
+        frame_.blocking_task = last_task_;
+        frame_.blocking_task_time = last_task_end_ - last_task_start_;
+    }
+}
+
+void OverrunDetector::report_subframe(core::nanoseconds_t elapsed) {
+    roc_panic_if_msg(!in_frame_, "overrun detector: report_subframe() outside frame");
+
+    frame_.frame_time += elapsed;
+}
+
+void OverrunDetector::report_task(const char* name,
+                                  core::nanoseconds_t start_time,
+                                  core::nanoseconds_t end_time) {
+    last_task_ = name;
+    last_task_start_ = start_time;
+    last_task_end_ = end_time;
+
+    if (!in_frame_) {
+        return;
+    }
+
+    const core::nanoseconds_t elapsed = end_time - start_time;
+
+    if (frame_.num_tasks < FrameOverrun::MaxTasks) {
+        frame_.task_names[frame_.num_tasks] = name;
+        frame_.task_times[frame_.num_tasks] = elapsed;
+    }
+
+    frame_.num_tasks++;
+    frame_.task_time += elapsed;
+}
+
+bool OverrunDetector::end_frame(core::nanoseconds_t end_time,
+                                const core::nanoseconds_t* stage_times) {
+    roc_panic_if_msg(!in_frame_, "overrun detector: unpaired end_frame()");
+
+    in_frame_ = false;
+
+    frame_.proc_time = end_time - call_time_;
+
+    if (frame_.frame_duration <= 0
+        || frame_.proc_time <= frame_.frame_duration * (double)config_.threshold) {
+        return false;
+    }
+
+    if (stage_times) {
+        frame_.has_stages = true;
+        for (size_t n = 0; n < audio::ProfilerStage_Max; n++) {
+            frame_.stage_times[n] = stage_times[n];
+        }
+    }
+
+    last_overrun_ = frame_;
+    num_overruns_++;
+    num_unreported_++;
+
+    if (last_report_ == 0 || end_time - last_report_ >= config_.report_interval) {
+        report_(end_time);
+    }
+
+    return true;
+}
+
+uint64_t OverrunDetector::num_overruns() const {
+    return num_overruns_;
+}
+
+const FrameOverrun& OverrunDetector::last_overrun() const {
+    return last_overrun_;
+}
+
+void OverrunDetector::report_(core::nanoseconds_t now) {
+    const FrameOverrun& r = last_overrun_;
+
+    char tasks[256];
+    size_t tasks_pos = 0;
+    tasks[0] = '\0';
+
+    for (size_t n = 0; n < std::min(r.num_tasks, (size_t)FrameOverrun::MaxTasks);
+         n++) {
+        append(tasks, sizeof(tasks), tasks_pos, "%s%s:%.3fms", n ? "," : "",
+               r.task_names[n], ns_2_ms(r.task_times[n]));
+    }
+    if (r.num_tasks > FrameOverrun::MaxTasks) {
+        append(tasks, sizeof(tasks), tasks_pos, ",...");
+    }
+
+    char stages[256];
+    size_t stages_pos = 0;
+    stages[0] = '\0';
+
+    if (r.has_stages) {
+        for (size_t n = 0; n < audio::ProfilerStage_Max; n++) {
+            if (r.stage_times[n] == 0) {
+                continue;
+            }
+            append(stages, sizeof(stages), stages_pos, "%s%s:%.3fms",
+                   stages_pos ? "," : "",
+                   audio::profiler_stage_to_str((audio::ProfilerStage)n),
+                   ns_2_ms(r.stage_times[n]));
+        }
+    }
+
+    roc_log(LogInfo,
+            "overrun detector: frame overrun:"
+            " duration=%.3fms proc=%.3fms wait=%.3fms blocking_task=%s(%.3fms)"
+            " frame=%.3fms stages=[%s] tasks=%lu(%.3fms) [%s]"
+            " overruns=%llu since_last_report=%llu",
+            ns_2_ms(r.frame_duration), ns_2_ms(r.proc_time), ns_2_ms(r.wait_time),
+            r.blocking_task ? r.blocking_task : "none",
+            ns_2_ms(r.blocking_task_time), ns_2_ms(r.frame_time), stages,
+            (unsigned long)r.num_tasks, ns_2_ms(r.task_time), tasks,
+            (unsigned long long)num_overruns_, (unsigned long long)num_unreported_);
+
+    last_report_ = now;
+    num_unreported_ = 0;
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/overrun_detector.h
+//! @brief Frame deadline overrun detector.
+
+#ifndef ROC_PIPELINE_OVERRUN_DETECTOR_H_
+#define ROC_PIPELINE_OVERRUN_DETECTOR_H_
+
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Overrun detector parameters.
+struct OverrunDetectorConfig {
+    //! Enable overrun detection.
+    bool enable;
+
+    //! Frame is overrun if its processing took longer than this fraction
+    //! of its duration.
+    float threshold;
+
+    //! Minimum interval between diagnostic records.
+    //! Overruns happening more often are only counted.
+    core::nanoseconds_t report_interval;
+
+    OverrunDetectorConfig()
+        : enable(true)
+        , threshold(1.0f)
+        , report_interval(5 * core::Second) {
+    }
+};
+
+//! Diagnostic record of a frame overrun.
+struct FrameOverrun {
+    //! Maximum number of tasks recorded per frame.
+    enum { MaxTasks = 8 };
+
+    //! Duration of audio in frame.
+    core::nanoseconds_t frame_duration;
+
+    //! Time from the start of frame processing call until its return.
+    core::nanoseconds_t proc_time;
+
+    //! Time spent waiting for pipeline to become available.
+    //! Non-zero when a task processed outside of frame didn't finish in time.
+    core::nanoseconds_t wait_time;
+
+    //! Name of the last task which finished during wait_time, if any.
+    const char* blocking_task;
+
+    //! Duration of blocking_task.
+    core::nanoseconds_t blocking_task_time;
+
+    //! Time spent reading or writing frame, excluding tasks.
+    core::nanoseconds_t frame_time;
+
+    //! Total time spent in tasks processed during frame.
+    core::nanoseconds_t task_time;
+
+    //! Number of tasks processed during frame.
+    size_t num_tasks;
+
+    //! Names of first MaxTasks tasks processed during frame.
+    const char* task_names[MaxTasks];
+
+    //! Durations of first MaxTasks tasks processed during frame.
+    core::nanoseconds_t task_times[MaxTasks];
+
+    //! Whether stage_times is filled.
+    bool has_stages;
+
+    //! Time spent in each pipeline stage during frame.
+    core::nanoseconds_t stage_times[audio::ProfilerStage_Max];
+
+    FrameOverrun() {
+        clear();
+    }
+
+    //! Reset all fields.
+    void clear();
+};
+
+//! Frame deadline overrun detector.
+//!
+//! @remarks
+//!  Pipeline should produce or consume every frame faster than the frame
+//!  duration, otherwise the audio device or timer falls behind and the user
+//!  hears a glitch. Detector watches every frame processed by pipeline loop,
+//!  and when processing took longer than frame duration, counts an overrun and
+//!  reports where the time was spent: waiting for a task which occupied the
+//!  pipeline, reading or writing frame itself (with per-stage breakdown if
+//!  stage profiling is enabled), or processing tasks between sub-frames.
+//!
+//! @remarks
+//!  Reports are written to log and rate-limited, the counter is not.
+//!
+//! @remarks
+//!  All methods should be called with pipeline locked.
+class OverrunDetector : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit OverrunDetector(const OverrunDetectorConfig& config);
+
+    //! Check if detection is enabled.
+    bool is_enabled() const;
+
+    //! Start frame.
+    //! @remarks
+    //!  @p call_time is when frame processing was requested, @p start_time is
+    //!  when pipeline became available, @p frame_duration is duration of audio.
+    void begin_frame(core::nanoseconds_t call_time,
+                     core::nanoseconds_t start_time,
+                     core::nanoseconds_t frame_duration);
+
+    //! Report time spent reading or writing (part of) current frame.
+    void report_subframe(core::nanoseconds_t elapsed);
+
+    //! Report processed task.
+    //! @remarks
+    //!  Can be called both inside and outside of frame.
+    void report_task(const char* name,
+                     core::nanoseconds_t start_time,
+                     core::nanoseconds_t end_time);
+
+    //! Finish frame.
+    //! @remarks
+    //!  @p stage_times is per-stage time spent during frame, or NULL if stages
+    //!  are not profiled.
+    //! @returns
+    //!  true if frame was overrun.
+    bool end_frame(core::nanoseconds_t end_time,
+                   const core::nanoseconds_t* stage_times);
+
+    //! Get number of detected overruns.
+    uint64_t num_overruns() const;
+
+    //! Get record of last detected overrun.
+    const FrameOverrun& last_overrun() const;
+
+private:
+    void report_(core::nanoseconds_t now);
+
+    const OverrunDetectorConfig config_;
+
+    bool in_frame_;
+    core::nanoseconds_t call_time_;
+    FrameOverrun frame_;
+
+    const char* last_task_;
+    core::nanoseconds_t last_task_start_;
+    core::nanoseconds_t last_task_end_;
+
+    FrameOverrun last_overrun_;
+    uint64_t num_overruns_;
+
+    core::nanoseconds_t last_report_;
+    uint64_t num_unreported_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_OVERRUN_DETECTOR_H_
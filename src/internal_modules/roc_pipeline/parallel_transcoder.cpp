@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/parallel_transcoder.h"
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+size_t gcd(size_t a, size_t b) {
+    while (b != 0) {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+size_t lcm(size_t a, size_t b) {
+    return a / gcd(a, b) * b;
+}
+
+size_t align_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ParallelTranscoder::ParallelTranscoder(const TranscoderConfig& transcoder_config,
+                                       const ParallelTranscoderConfig& parallel_config,
+                                       audio::IFrameWriter& output_writer,
+                                       core::IArena& arena)
+    : arena_(arena)
+    , output_writer_(output_writer)
+    , transcoder_config_(transcoder_config)
+    , num_jobs_(parallel_config.num_jobs)
+    , jobs_(arena)
+    , in_ch_(0)
+    , out_ch_(0)
+    , in_period_(0)
+    , out_period_(0)
+    , frame_size_(0)
+    , out_frame_size_(0)
+    , segment_size_(0)
+    , overlap_size_(0)
+    , pool_buf_size_(0)
+    , in_buf_(arena)
+    , in_buf_pos_(0)
+    , in_buf_size_(0)
+    , next_segment_pos_(0)
+    , eof_(false)
+    , valid_(false) {
+    const audio::SampleSpec& in_spec = transcoder_config_.input_sample_spec;
+    const audio::SampleSpec& out_spec = transcoder_config_.output_sample_spec;
+
+    if (!in_spec.is_valid() || !out_spec.is_valid() || !in_spec.is_raw()
+        || !out_spec.is_raw()) {
+        roc_log(LogError,
+                "parallel transcoder: required valid sample specs with raw format:"
+                " in_spec=%s out_spec=%s",
+                audio::sample_spec_to_str(in_spec).c_str(),
+                audio::sample_spec_to_str(out_spec).c_str());
+        return;
+    }
+
+    if (num_jobs_ == 0 || parallel_config.segment_length <= 0
+        || parallel_config.frame_length <= 0 || parallel_config.overlap_length < 0) {
+        roc_log(LogError,
+                "parallel transcoder: invalid config: num_jobs=%lu segment_len=%.3fms"
+                " overlap_len=%.3fms frame_len=%.3fms",
+                (unsigned long)num_jobs_,
+                (double)parallel_config.segment_length / core::Millisecond,
+                (double)parallel_config.overlap_length / core::Millisecond,
+                (double)parallel_config.frame_length / core::Millisecond);
+        return;
+    }
+
+    in_ch_ = in_spec.num_channels();
+    out_ch_ = out_spec.num_channels();
+
+    // every in_period_ input samples produce exactly out_period_ output samples
+    const size_t rate_gcd = gcd(in_spec.sample_rate(), out_spec.sample_rate());
+    in_period_ = in_spec.sample_rate() / rate_gcd;
+    out_period_ = out_spec.sample_rate() / rate_gcd;
+
+    frame_size_ = std::max(in_spec.ns_2_samples_per_chan(parallel_config.frame_length),
+                           (size_t)1);
+    out_frame_size_ = std::max(
+        out_spec.ns_2_samples_per_chan(parallel_config.frame_length), (size_t)1);
+
+    pool_buf_size_ = std::max(frame_size_, out_frame_size_) * std::max(in_ch_, out_ch_)
+        * sizeof(audio::sample_t);
+
+    size_t alignment = in_period_;
+
+    if (in_spec.sample_rate() != out_spec.sample_rate()) {
+        // resampler consumes input by fixed-size blocks; aligning segment
+        // boundaries to blocks makes every job see the same block grid
+        // as sequential transcoding, and produce the same amount of output
+        size_t block_size = 0;
+        if (!probe_resampler_(block_size)) {
+            return;
+        }
+        alignment = lcm(in_period_, block_size);
+    }
+
+    segment_size_ =
+        align_up(std::max(in_spec.ns_2_samples_per_chan(parallel_config.segment_length),
+                          (size_t)1),
+                 alignment);
+
+    // without resampling, transcoder is stateless and needs no overlap
+    if (in_spec.sample_rate() != out_spec.sample_rate()) {
+        overlap_size_ = align_up(
+            std::max(in_spec.ns_2_samples_per_chan(parallel_config.overlap_length),
+                     (size_t)1),
+            alignment);
+    }
+
+    if (!jobs_.grow(num_jobs_)) {
+        roc_log(LogError, "parallel transcoder: can't allocate jobs");
+        return;
+    }
+
+    // whole round with overlaps from both sides, and one extra frame,
+    // because input is read by frames
+    const size_t in_buf_size =
+        overlap_size_ * 2 + segment_size_ * num_jobs_ + frame_size_;
+
+    if (!in_buf_.resize(in_buf_size * in_ch_)) {
+        roc_log(LogError, "parallel transcoder: can't allocate input buffer: size=%lu",
+                (unsigned long)in_buf_size);
+        return;
+    }
+
+    roc_log(LogDebug,
+            "parallel transcoder: initializing: num_jobs=%lu segment_size=%lu"
+            " overlap_size=%lu frame_size=%lu",
+            (unsigned long)num_jobs_, (unsigned long)segment_size_,
+            (unsigned long)overlap_size_, (unsigned long)frame_size_);
+
+    valid_ = true;
+}
+
+ParallelTranscoder::~ParallelTranscoder() {
+    destroy_jobs_();
+}
+
+bool ParallelTranscoder::is_valid() const {
+    return valid_;
+}
+
+bool ParallelTranscoder::run(audio::IFrameReader& reader) {
+    roc_panic_if(!is_valid());
+
+    for (;;) {
+        fill_(reader, next_segment_pos_ + segment_size_ * num_jobs_ + overlap_size_);
+
+        if (next_segment_pos_ >= in_buf_pos_ + in_buf_size_) {
+            break;
+        }
+
+        if (!run_round_()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t ParallelTranscoder::num_input_samples() const {
+    return next_segment_pos_;
+}
+
+void ParallelTranscoder::fill_(audio::IFrameReader& reader, size_t end_pos) {
+    while (!eof_ && in_buf_pos_ + in_buf_size_ < end_pos) {
+        roc_panic_if((in_buf_size_ + frame_size_) * in_ch_ > in_buf_.size());
+
+        audio::Frame frame(in_buf_.data() + in_buf_size_ * in_ch_, frame_size_ * in_ch_);
+
+        if (!reader.read(frame)) {
+            eof_ = true;
+            break;
+        }
+
+        in_buf_size_ += frame_size_;
+    }
+}
+
+bool ParallelTranscoder::run_round_() {
+    const size_t buf_end = in_buf_pos_ + in_buf_size_;
+
+    bool last = false;
+
+    while (jobs_.size() < num_jobs_ && !last) {
+        const size_t seg_begin = next_segment_pos_ + jobs_.size() * segment_size_;
+        if (seg_begin >= buf_end) {
+            break;
+        }
+
+        // first segment has nothing to warm up from
+        const size_t in_begin =
+            seg_begin >= overlap_size_ ? seg_begin - overlap_size_ : 0;
+        size_t in_end = seg_begin + segment_size_ + overlap_size_;
+
+        // if there is not enough input after this segment to drain resampler,
+        // input is over, and this segment absorbs the rest of it
+        if (eof_ && in_end >= buf_end) {
+            in_end = buf_end;
+            last = true;
+        }
+
+        const size_t out_skip = in_2_out_(seg_begin - in_begin);
+        const size_t out_limit = last ? (size_t)-1 : in_2_out_(segment_size_);
+
+        Job* job = new (arena_)
+            Job(transcoder_config_, pool_buf_size_, frame_size_,
+                in_buf_.data() + (in_begin - in_buf_pos_) * in_ch_, in_end - in_begin,
+                out_skip, out_limit, arena_);
+
+        if (!job) {
+            roc_log(LogError, "parallel transcoder: can't allocate job");
+            destroy_jobs_();
+            return false;
+        }
+
+        if (!jobs_.push_back(job)) {
+            roc_panic("parallel transcoder: can't add job");
+        }
+
+        if (!job->is_valid()) {
+            roc_log(LogError, "parallel transcoder: can't initialize job");
+            destroy_jobs_();
+            return false;
+        }
+    }
+
+    bool ok = true;
+
+    // first job is processed in current thread
+    for (size_t n = 1; n < jobs_.size(); n++) {
+        if (!jobs_[n]->start()) {
+            roc_log(LogError, "parallel transcoder: can't start job thread");
+            ok = false;
+        }
+    }
+
+    jobs_[0]->process();
+
+    for (size_t n = 1; n < jobs_.size(); n++) {
+        jobs_[n]->join();
+    }
+
+    for (size_t n = 0; n < jobs_.size() && ok; n++) {
+        if (jobs_[n]->failed()) {
+            roc_log(LogError, "parallel transcoder: job failed");
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        for (size_t n = 0; n < jobs_.size(); n++) {
+            write_output_(jobs_[n]->output(), jobs_[n]->output_size());
+        }
+    }
+
+    next_segment_pos_ =
+        last ? buf_end : next_segment_pos_ + jobs_.size() * segment_size_;
+
+    destroy_jobs_();
+
+    // keep overlap before next segment and input read beyond it
+    const size_t keep_pos =
+        next_segment_pos_ >= overlap_size_ ? next_segment_pos_ - overlap_size_ : 0;
+
+    if (keep_pos > in_buf_pos_) {
+        const size_t keep_size = keep_pos < buf_end ? buf_end - keep_pos : 0;
+
+        memmove(in_buf_.data(), in_buf_.data() + (keep_pos - in_buf_pos_) * in_ch_,
+                keep_size * in_ch_ * sizeof(audio::sample_t));
+
+        in_buf_pos_ = keep_pos;
+        in_buf_size_ = keep_size;
+    }
+
+    return ok;
+}
+
+void ParallelTranscoder::destroy_jobs_() {
+    for (size_t n = 0; n < jobs_.size(); n++) {
+        arena_.destroy_object(*jobs_[n]);
+    }
+
+    jobs_.clear();
+}
+
+void ParallelTranscoder::write_output_(audio::sample_t* data, size_t size) {
+    while (size != 0) {
+        const size_t n_samples = std::min(size, out_frame_size_);
+
+        audio::Frame frame(data, n_samples * out_ch_);
+        frame.set_duration((packet::stream_timestamp_t)n_samples);
+
+        output_writer_.write(frame);
+
+        data += n_samples * out_ch_;
+        size -= n_samples;
+    }
+}
+
+bool ParallelTranscoder::probe_resampler_(size_t& block_size) {
+    transcoder_config_.deduce_defaults();
+
+    core::SlabPool<core::Buffer> pool("parallel_transcoder_probe_pool", arena_,
+                                      sizeof(core::Buffer) + pool_buf_size_);
+    audio::FrameFactory frame_factory(pool);
+
+    const audio::SampleSpec from_spec(transcoder_config_.input_sample_spec.sample_rate(),
+                                      audio::Sample_RawFormat,
+                                      transcoder_config_.input_sample_spec.channel_set());
+
+    const audio::SampleSpec to_spec(transcoder_config_.output_sample_spec.sample_rate(),
+                                    audio::Sample_RawFormat,
+                                    transcoder_config_.input_sample_spec.channel_set());
+
+    core::SharedPtr<audio::IResampler> resampler =
+        audio::ResamplerMap::instance().new_resampler(
+            arena_, frame_factory, transcoder_config_.resampler, from_spec, to_spec);
+
+    if (!resampler || !resampler->is_valid()) {
+        roc_log(LogError, "parallel transcoder: can't create resampler");
+        return false;
+    }
+
+    block_size = resampler->begin_push_input().size() / in_ch_;
+
+    if (block_size == 0) {
+        roc_log(LogError, "parallel transcoder: unexpected resampler block size");
+        return false;
+    }
+
+    return true;
+}
+
+size_t ParallelTranscoder::in_2_out_(size_t in_samples) const {
+    roc_panic_if(in_samples % in_period_ != 0);
+
+    return in_samples / in_period_ * out_period_;
+}
+
+ParallelTranscoder::Job::Job(const TranscoderConfig& config,
+                             size_t pool_buf_size,
+                             size_t frame_size,
+                             audio::sample_t* in_data,
+                             size_t in_size,
+                             size_t out_skip,
+                             size_t out_limit,
+                             core::IArena& arena)
+    : pool_("parallel_transcoder_pool", arena, sizeof(core::Buffer) + pool_buf_size)
+    , in_ch_(config.input_sample_spec.num_channels())
+    , out_ch_(config.output_sample_spec.num_channels())
+    , frame_size_(frame_size)
+    , in_data_(in_data)
+    , in_size_(in_size)
+    , out_skip_(out_skip)
+    , out_limit_(out_limit)
+    , out_(arena)
+    , failed_(false)
+    , valid_(false) {
+    transcoder_.reset(new (transcoder_) TranscoderSink(config, this, pool_, arena));
+    if (!transcoder_ || !transcoder_->is_valid()) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool ParallelTranscoder::Job::is_valid() const {
+    return valid_;
+}
+
+void ParallelTranscoder::Job::process() {
+    roc_panic_if(!is_valid());
+
+    for (size_t pos = 0; pos < in_size_ && !failed_; pos += frame_size_) {
+        const size_t n_samples = std::min(frame_size_, in_size_ - pos);
+
+        audio::Frame frame(in_data_ + pos * in_ch_, n_samples * in_ch_);
+        frame.set_duration((packet::stream_timestamp_t)n_samples);
+
+        transcoder_->write(frame);
+    }
+}
+
+bool ParallelTranscoder::Job::failed() const {
+    return failed_;
+}
+
+audio::sample_t* ParallelTranscoder::Job::output() {
+    return out_.size() != 0 ? out_.data() : NULL;
+}
+
+size_t ParallelTranscoder::Job::output_size() const {
+    return out_.size() / out_ch_;
+}
+
+void ParallelTranscoder::Job::run() {
+    process();
+}
+
+void ParallelTranscoder::Job::write(audio::Frame& frame) {
+    audio::sample_t* data = frame.raw_samples();
+    size_t n_samples = frame.num_raw_samples() / out_ch_;
+
+    // drop output produced from overlap
+    const size_t n_skip = std::min(n_samples, out_skip_);
+    data += n_skip * out_ch_;
+    n_samples -= n_skip;
+    out_skip_ -= n_skip;
+
+    n_samples = std::min(n_samples, out_limit_);
+    if (n_samples == 0) {
+        return;
+    }
+
+    const size_t pos = out_.size();
+    const size_t new_size = pos + n_samples * out_ch_;
+
+    if (!out_.grow_exp(new_size) || !out_.resize(new_size)) {
+        roc_log(LogError, "parallel transcoder: can't allocate output buffer");
+        failed_ = true;
+        return;
+    }
+
+    memcpy(out_.data() + pos, data, n_samples * out_ch_ * sizeof(audio::sample_t));
+    out_limit_ -= n_samples;
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/parallel_transcoder.h
+//! @brief Parallel transcoder pipeline.
+
+#ifndef ROC_PIPELINE_PARALLEL_TRANSCODER_H_
+#define ROC_PIPELINE_PARALLEL_TRANSCODER_H_
+
+#include "roc_audio/iframe_reader.h"
+#include "roc_audio/iframe_writer.h"
+#include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_pipeline/config.h"
+#include "roc_pipeline/transcoder_sink.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Parallel transcoder parameters.
+struct ParallelTranscoderConfig {
+    //! Number of segments transcoded concurrently.
+    size_t num_jobs;
+
+    //! Duration of input segment transcoded by one job.
+    core::nanoseconds_t segment_length;
+
+    //! Duration of input prepended and appended to every segment.
+    //! @remarks
+    //!  Used to warm up and drain resampler; output produced from
+    //!  overlap is dropped, so that segments are joined seamlessly.
+    core::nanoseconds_t overlap_length;
+
+    //! Duration of frames read from input and passed to transcoder.
+    core::nanoseconds_t frame_length;
+
+    //! Initialize config.
+    ParallelTranscoderConfig()
+        : num_jobs(1)
+        , segment_length(core::Second * 10)
+        , overlap_length(core::Millisecond * 100)
+        , frame_length(core::Millisecond * 100) {
+    }
+};
+
+//! Parallel transcoder pipeline.
+//! @remarks
+//!  Reads input in large rounds, splits every round into segments, and
+//!  transcodes segments concurrently, each by its own TranscoderSink
+//!  running in its own thread. Results are written to output writer
+//!  in order.
+//!
+//!  Segment boundaries and overlap are aligned to the period of input
+//!  and output rates and to resampler input block, so that the number of
+//!  output samples produced from the overlap is exact and joined output
+//!  has the same length as with sequential transcoding. Since every segment
+//!  starts with a fresh resampler, samples may differ from sequential
+//!  transcoding by a small fraction of sample phase.
+class ParallelTranscoder : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    ParallelTranscoder(const TranscoderConfig& transcoder_config,
+                       const ParallelTranscoderConfig& parallel_config,
+                       audio::IFrameWriter& output_writer,
+                       core::IArena& arena);
+
+    ~ParallelTranscoder();
+
+    //! Check if the pipeline was successfully constructed.
+    bool is_valid() const;
+
+    //! Read all frames from reader and transcode them.
+    //! @returns
+    //!  false if an error occurred.
+    bool run(audio::IFrameReader& reader);
+
+    //! Get number of input samples per channel processed so far.
+    size_t num_input_samples() const;
+
+private:
+    class Job : public core::Thread, public audio::IFrameWriter {
+    public:
+        Job(const TranscoderConfig& config,
+            size_t pool_buf_size,
+            size_t frame_size,
+            audio::sample_t* in_data,
+            size_t in_size,
+            size_t out_skip,
+            size_t out_limit,
+            core::IArena& arena);
+
+        bool is_valid() const;
+
+        void process();
+
+        bool failed() const;
+
+        audio::sample_t* output();
+        size_t output_size() const;
+
+    private:
+        virtual void run();
+        virtual void write(audio::Frame& frame);
+
+        core::SlabPool<core::Buffer> pool_;
+        core::Optional<TranscoderSink> transcoder_;
+
+        const size_t in_ch_;
+        const size_t out_ch_;
+        const size_t frame_size_;
+
+        audio::sample_t* in_data_;
+        const size_t in_size_;
+
+        size_t out_skip_;
+        size_t out_limit_;
+        core::Array<audio::sample_t> out_;
+
+        bool failed_;
+        bool valid_;
+    };
+
+    bool probe_resampler_(size_t& block_size);
+
+    void fill_(audio::IFrameReader& reader, size_t end_pos);
+    bool run_round_();
+    void destroy_jobs_();
+    void write_output_(audio::sample_t* data, size_t size);
+
+    size_t in_2_out_(size_t in_samples) const;
+
+    core::IArena& arena_;
+    audio::IFrameWriter& output_writer_;
+
+    TranscoderConfig transcoder_config_;
+
+    size_t num_jobs_;
+    core::Array<Job*> jobs_;
+
+    size_t in_ch_;
+    size_t out_ch_;
+
+    size_t in_period_;
+    size_t out_period_;
+
+    size_t frame_size_;
+    size_t out_frame_size_;
+    size_t segment_size_;
+    size_t overlap_size_;
+    size_t pool_buf_size_;
+
+    core::Array<audio::sample_t> in_buf_;
+    size_t in_buf_pos_;
+    size_t in_buf_size_;
+    size_t next_segment_pos_;
+    bool eof_;
+
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_PARALLEL_TRANSCODER_H_
@@ -9,6 +9,7 @@
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/probe.h"
 
 namespace roc {
 namespace pipeline {
@@ -31,14 +32,15 @@ PipelineLoop::PipelineLoop(IPipelineTaskScheduler& scheduler,
     , no_task_proc_half_interval_(config.task_processing_prohibited_interval / 2)
     , scheduler_(scheduler)
     , pending_tasks_(0)
-    , pending_frames_(0)
     , processing_state_(ProcNotScheduled)
+    , rate_limiter_(StatsReportInterval)
+    , pending_frames_(0)
     , frame_processing_tid_(0)
     , next_frame_deadline_(0)
     , subframe_tasks_deadline_(0)
     , samples_processed_(0)
     , enough_samples_to_process_tasks_(false)
-    , rate_limiter_(StatsReportInterval) {
+    , overrun_detector_(config.overrun_detector) {
 }
 
 PipelineLoop::~PipelineLoop() {
@@ -52,6 +54,14 @@ const PipelineLoop::Stats& PipelineLoop::get_stats_ref() const {
     return stats_;
 }
 
+uint64_t PipelineLoop::num_frame_overruns() const {
+    return overrun_detector_.num_overruns();
+}
+
+bool PipelineLoop::collect_stage_times_imp(core::nanoseconds_t*) {
+    return false;
+}
+
 size_t PipelineLoop::num_pending_tasks() const {
     return (size_t)pending_tasks_;
 }
@@ -202,11 +212,33 @@ bool PipelineLoop::process_subframes_and_tasks(audio::Frame& frame) {
 bool PipelineLoop::process_subframes_and_tasks_simple_(audio::Frame& frame) {
     ++pending_frames_;
 
+    const core::nanoseconds_t frame_call_time =
+        overrun_detector_.is_enabled() ? timestamp_imp() : 0;
+
     cancel_async_task_processing_();
 
     pipeline_mutex_.lock();
 
-    const bool frame_res = process_subframe_imp(frame);
+    bool frame_res = false;
+
+    if (overrun_detector_.is_enabled()) {
+        const packet::stream_timestamp_t frame_duration = frame.has_duration()
+            ? frame.duration()
+            : sample_spec_.bytes_2_stream_timestamp(frame.num_bytes());
+
+        const core::nanoseconds_t frame_start_time = timestamp_imp();
+
+        overrun_detector_.begin_frame(frame_call_time, frame_start_time,
+                                      sample_spec_.stream_timestamp_2_ns(frame_duration));
+
+        frame_res = process_subframe_imp(frame);
+
+        overrun_detector_.report_subframe(timestamp_imp() - frame_start_time);
+
+        end_overrun_detection_();
+    } else {
+        frame_res = process_subframe_imp(frame);
+    }
 
     pipeline_mutex_.unlock();
 
@@ -235,6 +267,11 @@ bool PipelineLoop::process_subframes_and_tasks_precise_(audio::Frame& frame) {
         ? frame.duration()
         : sample_spec_.bytes_2_stream_timestamp(frame.num_bytes());
 
+    if (overrun_detector_.is_enabled()) {
+        overrun_detector_.begin_frame(frame_start_time, timestamp_imp(),
+                                      sample_spec_.stream_timestamp_2_ns(frame_duration));
+    }
+
     for (;;) {
         const bool first_iteration = (frame_pos == 0);
 
@@ -264,6 +301,10 @@ bool PipelineLoop::process_subframes_and_tasks_precise_(audio::Frame& frame) {
         }
     }
 
+    if (overrun_detector_.is_enabled()) {
+        end_overrun_detection_();
+    }
+
     report_stats_();
 
     frame_processing_tid_.exclusive_store(tid_imp());
@@ -333,9 +374,22 @@ void PipelineLoop::cancel_async_task_processing_() {
 void PipelineLoop::process_task_(PipelineTask& task, bool notify) {
     IPipelineTaskCompleter* completer = task.completer_;
 
-    task.success_ = process_task_imp(task);
+    roc_probe(task_begin, (uintptr_t)&task, (int)(completer != NULL));
+
+    if (overrun_detector_.is_enabled()) {
+        const core::nanoseconds_t task_start_time = timestamp_imp();
+
+        task.success_ = process_task_imp(task);
+
+        overrun_detector_.report_task(task.name(), task_start_time, timestamp_imp());
+    } else {
+        task.success_ = process_task_imp(task);
+    }
+
     task.state_ = PipelineTask::StateFinished;
 
+    roc_probe(task_end, (uintptr_t)&task, (int)task.success_);
+
     if (completer) {
         completer->pipeline_task_completed(task);
     } else if (notify) {
@@ -362,17 +416,28 @@ bool PipelineLoop::process_next_subframe_(audio::Frame& frame,
                                         + sample_spec_.stream_timestamp_2_ns(*frame_pos));
     }
 
+    const core::nanoseconds_t subframe_start_time =
+        overrun_detector_.is_enabled() ? timestamp_imp() : 0;
+
     const bool ret = process_subframe_imp(sub_frame);
 
-    subframe_tasks_deadline_ = timestamp_imp() + config_.max_inframe_task_processing;
+    const core::nanoseconds_t subframe_end_time = timestamp_imp();
+
+    if (overrun_detector_.is_enabled()) {
+        overrun_detector_.report_subframe(subframe_end_time - subframe_start_time);
+    }
+
+    subframe_tasks_deadline_ = subframe_end_time + config_.max_inframe_task_processing;
 
     if (*frame_pos == 0) {
         frame.set_capture_timestamp(sub_frame.capture_timestamp());
+        frame.set_flags(sub_frame.flags());
+    } else {
+        frame.set_flags(audio::Frame::combine_flags(frame.flags(), sub_frame.flags()));
     }
 
     *frame_pos += subframe_duration;
 
-    frame.set_flags(frame.flags() | sub_frame.flags());
     frame.set_duration(*frame_pos);
 
     if (!enough_samples_to_process_tasks_) {
@@ -459,6 +524,16 @@ bool PipelineLoop::interframe_task_processing_allowed_(
         || now >= (next_frame_deadline + no_task_proc_half_interval_);
 }
 
+void PipelineLoop::end_overrun_detection_() {
+    core::nanoseconds_t stage_times[audio::ProfilerStage_Max];
+    const bool has_stages = collect_stage_times_imp(stage_times);
+
+    if (overrun_detector_.end_frame(timestamp_imp(), has_stages ? stage_times : NULL)) {
+        roc_probe(frame_overrun, (int64_t)overrun_detector_.last_overrun().proc_time,
+                  (int64_t)overrun_detector_.last_overrun().frame_duration);
+    }
+}
+
 void PipelineLoop::report_stats_() {
     if (!rate_limiter_.would_allow()) {
         return;
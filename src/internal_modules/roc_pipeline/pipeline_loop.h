@@ -14,6 +14,7 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/sample_spec.h"
+#include "roc_core/align_ops.h"
 #include "roc_core/atomic.h"
 #include "roc_core/mpsc_queue.h"
 #include "roc_core/mutex.h"
@@ -25,6 +26,7 @@
 #include "roc_packet/units.h"
 #include "roc_pipeline/ipipeline_task_completer.h"
 #include "roc_pipeline/ipipeline_task_scheduler.h"
+#include "roc_pipeline/overrun_detector.h"
 #include "roc_pipeline/pipeline_task.h"
 
 namespace roc {
@@ -65,6 +67,10 @@ struct PipelineLoopConfig {
     //! thread switch overhead, scheduler jitter clock drift, we use a wide interval.
     core::nanoseconds_t task_processing_prohibited_interval;
 
+    //! Frame deadline overrun detection.
+    //! Works both with and without precise task scheduling.
+    OverrunDetectorConfig overrun_detector;
+
     PipelineLoopConfig()
         : enable_precise_task_scheduling(true)
         , min_frame_length_between_tasks(200 * core::Microsecond)
@@ -222,6 +228,16 @@ struct PipelineLoopConfig {
 //! mostly wait-free, so that one thread is never or almost never blocked when another
 //! thread is blocked, preempted, or busy.
 //!
+//! Overrun detection
+//! -----------------
+//!
+//! Every process_frame_and_tasks() call is watched by OverrunDetector. If the call
+//! took longer than the frame duration, it's counted as an overrun, and a rate-limited
+//! report is logged. The report tells how much time was spent waiting for the pipeline
+//! mutex (and which task held it), processing the frame itself (per stage, if derived
+//! class implements collect_stage_times_imp()), and processing in-frame tasks (with
+//! their names).
+//!
 //! Benchmarks
 //! ----------
 //!
@@ -260,6 +276,9 @@ protected:
         //! Number of times when other method was preempted by process_frame_and_tasks().
         uint64_t preemptions;
 
+        //! Padding between counters updated under different mutexes.
+        core::CacheLinePad pad;
+
         //! Number of time when schedule_task_processing() was called.
         uint64_t scheduler_calls;
 
@@ -293,6 +312,10 @@ protected:
     //! Returned object can't be accessed concurrently with other methods.
     const Stats& get_stats_ref() const;
 
+    //! Get number of frames which took longer than their duration to process.
+    //! Can't be called concurrently with other methods.
+    uint64_t num_frame_overruns() const;
+
     //! Split frame and process subframes and some of the enqueued tasks.
     bool process_subframes_and_tasks(audio::Frame& frame);
 
@@ -308,6 +331,12 @@ protected:
     //! Process task.
     virtual bool process_task_imp(PipelineTask& task) = 0;
 
+    //! Get time spent in each pipeline stage since previous call.
+    //! Used to report which stage consumed time of an overrun frame.
+    //! @returns
+    //!  false if stages are not profiled (default).
+    virtual bool collect_stage_times_imp(core::nanoseconds_t* stage_times);
+
 private:
     enum ProcState { ProcNotScheduled, ProcScheduled, ProcRunning };
 
@@ -334,6 +363,8 @@ private:
     bool
     interframe_task_processing_allowed_(core::nanoseconds_t next_frame_deadline) const;
 
+    void end_overrun_detection_();
+
     void report_stats_();
 
     // configuration
@@ -349,8 +380,11 @@ private:
     // used to schedule asynchronous work
     IPipelineTaskScheduler& scheduler_;
 
-    // protects pipeline state
-    core::Mutex pipeline_mutex_;
+    // fields below are grouped by writer thread, groups are separated by
+    // padding to avoid false sharing between threads
+
+    // written by threads scheduling tasks
+    core::CacheLinePad pad_scheduler_;
 
     // protects IPipelineTaskScheduler
     core::Mutex scheduler_mutex_;
@@ -361,18 +395,30 @@ private:
     // counter of pending tasks
     core::Atomic<int> pending_tasks_;
 
-    // counter of pending process_frame_and_tasks() calls blocked on pipeline_mutex_
-    core::Atomic<int> pending_frames_;
-
     // asynchronous processing state
     core::Atomic<int> processing_state_;
 
+    // rate limiter for stats reporting, used under scheduler_mutex_
+    core::RateLimiter rate_limiter_;
+
+    // written by frame processing thread, read by threads scheduling tasks
+    core::CacheLinePad pad_frame_;
+
+    // counter of pending process_frame_and_tasks() calls blocked on pipeline_mutex_
+    core::Atomic<int> pending_frames_;
+
     // tid of last thread that performed frame processing
     core::Seqlock<uint64_t> frame_processing_tid_;
 
     // when next frame is expected to be started
     core::Seqlock<core::nanoseconds_t> next_frame_deadline_;
 
+    // written by thread holding pipeline_mutex_
+    core::CacheLinePad pad_pipeline_;
+
+    // protects pipeline state
+    core::Mutex pipeline_mutex_;
+
     // when task processing before next sub-frame ends
     core::nanoseconds_t subframe_tasks_deadline_;
 
@@ -383,8 +429,10 @@ private:
     bool enough_samples_to_process_tasks_;
 
     // task processing statistics
-    core::RateLimiter rate_limiter_;
     Stats stats_;
+
+    // detects frames processed longer than their duration
+    OverrunDetector overrun_detector_;
 };
 
 } // namespace pipeline
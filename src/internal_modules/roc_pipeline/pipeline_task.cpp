@@ -16,7 +16,8 @@ namespace pipeline {
 PipelineTask::PipelineTask()
     : state_(StateNew)
     , success_(false)
-    , completer_(NULL) {
+    , completer_(NULL)
+    , name_("task") {
 }
 
 PipelineTask::~PipelineTask() {
@@ -29,5 +30,14 @@ bool PipelineTask::success() const {
     return state_ == StateFinished && success_;
 }
 
+const char* PipelineTask::name() const {
+    return name_;
+}
+
+void PipelineTask::set_name(const char* name) {
+    roc_panic_if(!name);
+    name_ = name;
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -31,9 +31,17 @@ public:
     //! Check that the task finished and succeeded.
     bool success() const;
 
+    //! Get task name.
+    //! Used in diagnostics, e.g. in frame overrun reports.
+    const char* name() const;
+
 protected:
     PipelineTask();
 
+    //! Set task name.
+    //! @p name should be a string literal.
+    void set_name(const char* name);
+
 private:
     friend class PipelineLoop;
 
@@ -53,6 +61,9 @@ private:
 
     // Completion semaphore.
     core::Optional<core::Semaphore> sem_;
+
+    // Task name for diagnostics.
+    const char* name_;
 };
 
 } // namespace pipeline
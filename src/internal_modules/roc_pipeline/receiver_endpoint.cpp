@@ -19,11 +19,13 @@ namespace roc {
 namespace pipeline {
 
 ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
+                                   const rtp::SrtpConfig& srtp_config,
                                    StateTracker& state_tracker,
                                    ReceiverSessionGroup& session_group,
                                    const rtp::EncodingMap& encoding_map,
                                    const address::SocketAddr& inbound_address,
                                    packet::IWriter* outbound_writer,
+                                   packet::PacketFactory& packet_factory,
                                    core::IArena& arena)
     : core::RefCounted<ReceiverEndpoint, core::ArenaAllocation>(arena)
     , proto_(proto)
@@ -32,14 +34,35 @@ ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
     , composer_(NULL)
     , parser_(NULL)
     , inbound_address_(inbound_address)
+    , inbound_reader_(NULL)
+    , n_queued_(0)
+    , peak_queued_(0)
+    , n_pulled_(0)
+    , early_routing_(false)
     , valid_(false) {
     packet::IComposer* composer = NULL;
     packet::IParser* parser = NULL;
 
     switch (proto) {
     case address::Proto_RTP:
+    case address::Proto_RTP_Shm:
     case address::Proto_RTP_LDPC_Source:
     case address::Proto_RTP_RS8M_Source:
+    case address::Proto_RTP_RLC_Source:
+        rtp_parser_.reset(new (rtp_parser_) rtp::Parser(encoding_map, NULL));
+        if (!rtp_parser_) {
+            return;
+        }
+        parser = rtp_parser_.get();
+
+        // Sender may combine packets into bundles, see packet::Bundler.
+        unbundler_.reset(new (unbundler_) packet::Unbundler(packet_factory));
+        if (!unbundler_) {
+            return;
+        }
+        break;
+    case address::Proto_SRTP:
+        // Sender doesn't bundle SRTP packets.
         rtp_parser_.reset(new (rtp_parser_) rtp::Parser(encoding_map, NULL));
         if (!rtp_parser_) {
             return;
@@ -91,6 +114,51 @@ ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
         }
         parser = fec_parser_.get();
         break;
+    case address::Proto_RTP_RLC_Source:
+        fec_parser_.reset(
+            new (arena)
+                fec::Parser<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(parser),
+            arena);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    case address::Proto_RLC_Repair:
+        fec_parser_.reset(
+            new (arena)
+                fec::Parser<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(parser),
+            arena);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    default:
+        break;
+    }
+
+    switch (proto) {
+    case address::Proto_SRTP:
+        if (srtp_config.suite == rtp::Srtp_None) {
+            roc_log(LogError, "receiver endpoint: srtp key is required by protocol %s",
+                    address::proto_to_str(proto));
+            return;
+        }
+#ifdef ROC_TARGET_OPENSSL
+        // Decrypts packets in place before passing them to rtp parser.
+        srtp_parser_.reset(new (srtp_parser_) rtp::SrtpParser(srtp_config, *parser));
+        if (!srtp_parser_ || !srtp_parser_->is_valid()) {
+            return;
+        }
+        parser = srtp_parser_.get();
+        break;
+#else
+        roc_log(LogError,
+                "receiver endpoint: protocol %s is not supported: built without openssl",
+                address::proto_to_str(proto));
+        return;
+#endif // ROC_TARGET_OPENSSL
     default:
         break;
     }
@@ -145,6 +213,9 @@ ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
     composer_ = composer;
     parser_ = parser;
 
+    // Control packets are always processed by pipeline thread.
+    early_routing_ = session_group.has_early_routing() && proto != address::Proto_RTCP;
+
     valid_ = true;
 }
 
@@ -188,31 +259,120 @@ packet::IWriter& ReceiverEndpoint::inbound_writer() {
     return *this;
 }
 
+void ReceiverEndpoint::set_inbound_reader(packet::IReader& reader) {
+    roc_panic_if(!is_valid());
+
+    inbound_reader_ = &reader;
+}
+
 status::StatusCode ReceiverEndpoint::pull_packets(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
     roc_panic_if(!parser_);
 
+    peak_queued_ = std::max(peak_queued_, (size_t)n_queued_);
+
+    // Packets already parsed by network thread, but not routed by it.
+    while (packet::PacketPtr packet = parsed_queue_.try_pop_front_exclusive()) {
+        n_queued_--;
+        n_pulled_++;
+        packet->make_local();
+
+        const status::StatusCode code = session_group_.route_packet(packet, current_time);
+        state_tracker_.add_pending_packets(-1);
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
     // Using try_pop_front_exclusive() makes this method lock-free and wait-free.
     // It may return NULL either if the queue is empty or if the packets in the
     // queue were added in a very short time or are being added currently. It's
     // acceptable to consider such packets late and pull them next time.
-    while (packet::PacketPtr packet = inbound_queue_.try_pop_front_exclusive()) {
-        if (!parser_->parse(*packet, packet->buffer())) {
-            roc_log(LogDebug, "receiver endpoint: can't parse packet");
-            continue;
+    //
+    // Packets are parsed in batches, which allows parser to avoid per-packet
+    // virtual calls and keeps parsing code hot in cache.
+    packet::PacketPtr batch[ParseBatchSize];
+
+    for (;;) {
+        size_t n_packets = 0;
+        while (n_packets < ParseBatchSize) {
+            if (!(batch[n_packets] = fetch_packet_())) {
+                break;
+            }
+            n_packets++;
         }
 
-        const status::StatusCode code = session_group_.route_packet(packet, current_time);
-        state_tracker_.add_pending_packets(-1);
-        if (code != status::StatusOK) {
-            return code;
+        if (n_packets == 0) {
+            break;
+        }
+
+        const size_t n_parsed = parser_->parse_batch(batch, n_packets);
+        if (n_parsed != n_packets) {
+            roc_log(LogDebug, "receiver endpoint: can't parse packets: n_bad=%lu",
+                    (unsigned long)(n_packets - n_parsed));
+        }
+
+        for (size_t n = 0; n < n_parsed; n++) {
+            const status::StatusCode code =
+                session_group_.route_packet(batch[n], current_time);
+            state_tracker_.add_pending_packets(-1);
+            if (code != status::StatusOK) {
+                return code;
+            }
+        }
+
+        if (n_packets < ParseBatchSize) {
+            break;
         }
     }
 
     return status::StatusOK;
 }
 
+core::OccupancyMetrics ReceiverEndpoint::inbound_metrics() const {
+    roc_panic_if(!is_valid());
+
+    core::OccupancyMetrics metrics;
+    metrics.occupancy = n_queued_;
+    metrics.max_occupancy = std::max(peak_queued_, metrics.occupancy);
+    metrics.throughput = n_pulled_;
+    return metrics;
+}
+
+packet::PacketPtr ReceiverEndpoint::fetch_packet_() {
+    for (;;) {
+        packet::PacketPtr packet;
+        if (unbundled_queue_.read(packet) == status::StatusOK) {
+            return packet;
+        }
+
+        if ((packet = inbound_queue_.try_pop_front_exclusive())) {
+            n_queued_--;
+        } else {
+            if (!inbound_reader_ || inbound_reader_->read(packet) != status::StatusOK) {
+                return NULL;
+            }
+            // Packet polled inline didn't pass through write(), count it here.
+            state_tracker_.add_pending_packets(+1);
+        }
+        n_pulled_++;
+
+        // From now on, packet is used only by pipeline thread, so switch it
+        // to cheaper non-atomic reference counting, if nobody else holds it.
+        packet->make_local();
+
+        if (!unbundler_ || !packet::Unbundler::is_bundle(*packet)) {
+            return packet;
+        }
+
+        // One inbound packet was counted as pending, replace it with
+        // the packets extracted from bundle.
+        const size_t n_packets = unbundler_->unbundle(*packet, unbundled_queue_);
+        state_tracker_.add_pending_packets((int)n_packets - 1);
+    }
+}
+
 // Implementation of inbound_writer().write()
 status::StatusCode ReceiverEndpoint::write(const packet::PacketPtr& packet) {
     roc_panic_if(!is_valid());
@@ -221,10 +381,48 @@ status::StatusCode ReceiverEndpoint::write(const packet::PacketPtr& packet) {
     roc_panic_if(!parser_);
 
     state_tracker_.add_pending_packets(+1);
-    inbound_queue_.push_back(*packet);
+    packet->make_shared();
+
+    if (early_routing_) {
+        write_early_(packet);
+    } else {
+        n_queued_++;
+        inbound_queue_.push_back(*packet);
+    }
 
     return status::StatusOK;
 }
 
+void ReceiverEndpoint::write_early_(const packet::PacketPtr& packet) {
+    if (!unbundler_ || !packet::Unbundler::is_bundle(*packet)) {
+        route_early_(packet);
+        return;
+    }
+
+    // Same as in fetch_packet_(), but in network thread.
+    const size_t n_packets = unbundler_->unbundle(*packet, early_unbundled_queue_);
+    state_tracker_.add_pending_packets((int)n_packets - 1);
+
+    packet::PacketPtr pp;
+    while (early_unbundled_queue_.read(pp) == status::StatusOK) {
+        pp->make_shared();
+        route_early_(pp);
+    }
+}
+
+void ReceiverEndpoint::route_early_(const packet::PacketPtr& packet) {
+    if (!parser_->parse(*packet, packet->buffer())) {
+        roc_log(LogDebug, "receiver endpoint: can't parse packet");
+        state_tracker_.add_pending_packets(-1);
+        return;
+    }
+
+    if (!session_group_.route_packet_early(packet)) {
+        // No route yet, let pipeline thread find or create session.
+        n_queued_++;
+        parsed_queue_.push_back(*packet);
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -14,20 +14,31 @@
 
 #include "roc_address/interface.h"
 #include "roc_address/protocol.h"
+#include "roc_core/atomic.h"
 #include "roc_core/iarena.h"
 #include "roc_core/mpsc_queue.h"
+#include "roc_core/occupancy_metrics.h"
 #include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_packet/iparser.h"
+#include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
 #include "roc_packet/shipper.h"
+#include "roc_packet/unbundler.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/state_tracker.h"
 #include "roc_rtcp/composer.h"
 #include "roc_rtcp/parser.h"
 #include "roc_rtp/encoding_map.h"
 #include "roc_rtp/parser.h"
+#include "roc_rtp/srtp_config.h"
+
+#ifdef ROC_TARGET_OPENSSL
+#include "roc_rtp/srtp_parser.h"
+#endif // ROC_TARGET_OPENSSL
 
 namespace roc {
 namespace pipeline {
@@ -45,11 +56,13 @@ class ReceiverEndpoint : public core::RefCounted<ReceiverEndpoint, core::ArenaAl
 public:
     //! Initialize.
     ReceiverEndpoint(address::Protocol proto,
+                     const rtp::SrtpConfig& srtp_config,
                      StateTracker& state_tracker,
                      ReceiverSessionGroup& session_group,
                      const rtp::EncodingMap& encoding_map,
                      const address::SocketAddr& inbound_address,
                      packet::IWriter* outbound_writer,
+                     packet::PacketFactory& packet_factory,
                      core::IArena& arena);
 
     //! Check if the port pipeline was succefully constructed.
@@ -86,8 +99,20 @@ public:
     //!  Packets passed to this writer will be pulled into pipeline.
     //!  This writer is thread-safe and lock-free, packets can be written
     //!  to it from netio thread.
+    //! @note
+    //!  If session group has early routing enabled, transport packets are
+    //!  parsed and routed inside write(), so it should be invoked from one
+    //!  thread at a time.
     packet::IWriter& inbound_writer();
 
+    //! Set reader for inbound packets polled inline.
+    //! @remarks
+    //!  Used in run-to-completion mode, when pipeline thread owns the socket.
+    //!  pull_packets() reads all available packets from @p reader and
+    //!  processes them right away, after packets written to inbound_writer().
+    //!  Reader is invoked only from pipeline thread and should not block.
+    void set_inbound_reader(packet::IReader& reader);
+
     //! Pull packets written to inbound writer into pipeline.
     //! @remarks
     //!  Packets are written to inbound_writer() from network thread.
@@ -95,9 +120,24 @@ public:
     //!  should periodically call pull_packets() to make them available.
     ROC_ATTR_NODISCARD status::StatusCode pull_packets(core::nanoseconds_t current_time);
 
+    //! Get occupancy of inbound queue, in packets.
+    //! @remarks
+    //!  Occupancy is the number of packets written from network thread and
+    //!  not yet pulled into pipeline. High-water mark is sampled when packets
+    //!  are pulled. Should be called from pipeline thread.
+    core::OccupancyMetrics inbound_metrics() const;
+
 private:
+    // How many packets are passed to parser at once.
+    enum { ParseBatchSize = 32 };
+
     virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& packet);
 
+    packet::PacketPtr fetch_packet_();
+
+    void write_early_(const packet::PacketPtr& packet);
+    void route_early_(const packet::PacketPtr& packet);
+
     const address::Protocol proto_;
 
     StateTracker& state_tracker_;
@@ -114,9 +154,29 @@ private:
     packet::IParser* parser_;
     core::Optional<rtp::Parser> rtp_parser_;
     core::ScopedPtr<packet::IParser> fec_parser_;
+#ifdef ROC_TARGET_OPENSSL
+    core::Optional<rtp::SrtpParser> srtp_parser_;
+#endif // ROC_TARGET_OPENSSL
     core::Optional<rtcp::Parser> rtcp_parser_;
     address::SocketAddr inbound_address_;
     core::MpscQueue<packet::Packet> inbound_queue_;
+    packet::IReader* inbound_reader_;
+
+    // Packets in inbound and parsed queues, incremented by network thread.
+    core::Atomic<size_t> n_queued_;
+    size_t peak_queued_;
+    uint64_t n_pulled_;
+
+    // Splits bundles into packets.
+    // Present only for protocols where packets start with RTP header.
+    core::Optional<packet::Unbundler> unbundler_;
+    packet::Queue unbundled_queue_;
+
+    // Early routing, when packets are parsed and routed by network thread.
+    // Parsed packets which couldn't be routed are pulled by pipeline thread.
+    bool early_routing_;
+    packet::Queue early_unbundled_queue_;
+    core::MpscQueue<packet::Packet> parsed_queue_;
 
     bool valid_;
 };
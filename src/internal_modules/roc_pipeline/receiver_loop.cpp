@@ -7,6 +7,7 @@
  */
 
 #include "roc_pipeline/receiver_loop.h"
+#include "roc_core/cached_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/thread.h"
@@ -14,6 +15,17 @@
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+// Pipeline loop parameters may be adjusted by config profile (e.g. low-latency).
+PipelineLoopConfig make_loop_config(const ReceiverSourceConfig& source_config) {
+    ReceiverSourceConfig deduced_config = source_config;
+    deduced_config.deduce_defaults();
+    return deduced_config.pipeline_loop;
+}
+
+} // namespace
+
 ReceiverLoop::Task::Task()
     : func_(NULL)
     , slot_(NULL)
@@ -21,6 +33,7 @@ ReceiverLoop::Task::Task()
     , proto_(address::Proto_None)
     , inbound_address_()
     , inbound_writer_(NULL)
+    , inbound_reader_(NULL)
     , outbound_writer_(NULL)
     , slot_metrics_(NULL)
     , party_metrics_(NULL)
@@ -29,6 +42,7 @@ ReceiverLoop::Task::Task()
 
 ReceiverLoop::Tasks::CreateSlot::CreateSlot(const ReceiverSlotConfig& slot_config) {
     func_ = &ReceiverLoop::task_create_slot_;
+    set_name("create_slot");
     slot_config_ = slot_config;
 }
 
@@ -42,6 +56,7 @@ ReceiverLoop::SlotHandle ReceiverLoop::Tasks::CreateSlot::get_handle() const {
 
 ReceiverLoop::Tasks::DeleteSlot::DeleteSlot(SlotHandle slot) {
     func_ = &ReceiverLoop::task_delete_slot_;
+    set_name("delete_slot");
     if (!slot) {
         roc_panic("receiver loop: slot handle is null");
     }
@@ -53,6 +68,7 @@ ReceiverLoop::Tasks::QuerySlot::QuerySlot(SlotHandle slot,
                                           ReceiverParticipantMetrics* party_metrics,
                                           size_t* party_count) {
     func_ = &ReceiverLoop::task_query_slot_;
+    set_name("query_slot");
     if (!slot) {
         roc_panic("receiver loop: slot handle is null");
     }
@@ -62,12 +78,24 @@ ReceiverLoop::Tasks::QuerySlot::QuerySlot(SlotHandle slot,
     party_count_ = party_count;
 }
 
+ReceiverLoop::Tasks::ReconfigureSlot::ReconfigureSlot(
+    SlotHandle slot, const ReceiverLiveConfig& live_config) {
+    func_ = &ReceiverLoop::task_reconfigure_slot_;
+    set_name("reconfigure_slot");
+    if (!slot) {
+        roc_panic("receiver loop: slot handle is null");
+    }
+    slot_ = (ReceiverSlot*)slot;
+    live_config_ = live_config;
+}
+
 ReceiverLoop::Tasks::AddEndpoint::AddEndpoint(SlotHandle slot,
                                               address::Interface iface,
                                               address::Protocol proto,
                                               const address::SocketAddr& inbound_address,
                                               packet::IWriter* outbound_writer) {
     func_ = &ReceiverLoop::task_add_endpoint_;
+    set_name("add_endpoint");
     if (!slot) {
         roc_panic("receiver loop: slot handle is null");
     }
@@ -78,6 +106,11 @@ ReceiverLoop::Tasks::AddEndpoint::AddEndpoint(SlotHandle slot,
     outbound_writer_ = outbound_writer;
 }
 
+void ReceiverLoop::Tasks::AddEndpoint::set_inbound_reader(
+    packet::IReader& inbound_reader) {
+    inbound_reader_ = &inbound_reader;
+}
+
 packet::IWriter* ReceiverLoop::Tasks::AddEndpoint::get_inbound_writer() const {
     if (!success()) {
         return NULL;
@@ -92,17 +125,24 @@ ReceiverLoop::ReceiverLoop(IPipelineTaskScheduler& scheduler,
                            core::IPool& packet_pool,
                            core::IPool& packet_buffer_pool,
                            core::IPool& frame_buffer_pool,
-                           core::IArena& arena)
-    : PipelineLoop(
-        scheduler, source_config.pipeline_loop, source_config.common.output_sample_spec)
+                           core::IArena& arena,
+                           core::MemoryTracker* memory_tracker)
+    : PipelineLoop(scheduler,
+                   make_loop_config(source_config),
+                   source_config.common.output_sample_spec)
     , source_(source_config,
               encoding_map,
               packet_pool,
               packet_buffer_pool,
               frame_buffer_pool,
-              arena)
+              arena,
+              memory_tracker)
     , ticker_ts_(0)
     , auto_reclock_(source_config.common.enable_auto_reclock)
+    , idle_wait_(source_config.common.enable_idle_wait)
+    , idle_wait_timeout_(source_config.common.idle_wait_timeout)
+    , sample_spec_(source_config.common.output_sample_spec)
+    , release_pending_(0)
     , valid_(false) {
     if (!source_.is_valid()) {
         return;
@@ -129,6 +169,34 @@ sndio::ISource& ReceiverLoop::source() {
     return *this;
 }
 
+void ReceiverLoop::add_small_frame_buffer_pool(core::IPool& buffer_pool) {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(source_mutex_);
+
+    source_.add_small_frame_buffer_pool(buffer_pool);
+}
+
+void ReceiverLoop::set_packet_capture(packet::CaptureRing& capture_ring) {
+    roc_panic_if(!is_valid());
+
+    core::Mutex::Lock lock(source_mutex_);
+
+    source_.set_packet_capture(capture_ring);
+}
+
+bool ReceiverLoop::load_slot_metrics(SlotHandle slot_handle,
+                                     ReceiverSlotMetrics& slot_metrics,
+                                     ReceiverParticipantMetrics* party_metrics,
+                                     size_t* party_count) const {
+    roc_panic_if(!is_valid());
+
+    roc_panic_if(!slot_handle);
+
+    const ReceiverSlot* slot = (const ReceiverSlot*)slot_handle;
+    return slot->load_metrics(slot_metrics, party_metrics, party_count);
+}
+
 sndio::ISink* ReceiverLoop::to_sink() {
     roc_panic_if(!is_valid());
 
@@ -184,9 +252,9 @@ bool ReceiverLoop::restart() {
 audio::SampleSpec ReceiverLoop::sample_spec() const {
     roc_panic_if_not(is_valid());
 
-    core::Mutex::Lock lock(source_mutex_);
-
-    return source_.sample_spec();
+    // Sample spec never changes, so we don't need to lock source mutex,
+    // which may be held by read() for the whole frame duration.
+    return sample_spec_;
 }
 
 core::nanoseconds_t ReceiverLoop::latency() const {
@@ -228,9 +296,16 @@ void ReceiverLoop::reclock(core::nanoseconds_t timestamp) {
 bool ReceiverLoop::read(audio::Frame& frame) {
     roc_panic_if(!is_valid());
 
+    // done without lock, so that tasks can be processed while we're waiting
+    const bool waited = ticker_ && idle_wait_ && wait_idle_();
+
     core::Mutex::Lock lock(source_mutex_);
 
     if (ticker_) {
+        if (waited) {
+            // don't try to catch up with the time spent waiting
+            ticker_ts_ = ticker_->elapsed();
+        }
         ticker_->wait(ticker_ts_);
     }
 
@@ -242,7 +317,25 @@ bool ReceiverLoop::read(audio::Frame& frame) {
     ticker_ts_ += frame.duration();
 
     if (auto_reclock_) {
-        source_.reclock(core::timestamp(core::ClockUnix));
+        source_.reclock(core::timestamp(core::ClockMedia));
+    }
+
+    return true;
+}
+
+// If there are no sessions and no pending packets, blocks until a packet
+// arrives or timeout expires, instead of producing silence in real time.
+// Returns true if it was blocked.
+bool ReceiverLoop::wait_idle_() {
+    if (source_.state() != sndio::DeviceState_Idle) {
+        return false;
+    }
+
+    const core::nanoseconds_t deadline =
+        core::timestamp(core::ClockMonotonic) + idle_wait_timeout_;
+
+    if (!source_.wait_active(deadline)) {
+        roc_log(LogTrace, "receiver loop: idle wait timed out");
     }
 
     return true;
@@ -257,10 +350,18 @@ uint64_t ReceiverLoop::tid_imp() const {
 }
 
 bool ReceiverLoop::process_subframe_imp(audio::Frame& frame) {
+    // Code invoked below reads current time via CachedClock, so clocks
+    // are read once per sub-frame instead of once per session.
+    core::CachedClock::Scope clock_scope;
+
     // TODO: handle returned deadline and schedule refresh
-    source_.refresh(core::timestamp(core::ClockUnix));
+    source_.refresh(core::CachedClock::now(core::ClockMedia));
+
+    const bool res = source_.read(frame);
+
+    schedule_release_();
 
-    return source_.read(frame);
+    return res;
 }
 
 bool ReceiverLoop::process_task_imp(PipelineTask& basic_task) {
@@ -270,6 +371,32 @@ bool ReceiverLoop::process_task_imp(PipelineTask& basic_task) {
     return (this->*(task.func_))(task);
 }
 
+bool ReceiverLoop::collect_stage_times_imp(core::nanoseconds_t* stage_times) {
+    return source_.collect_stage_times(stage_times);
+}
+
+void ReceiverLoop::pipeline_task_completed(PipelineTask& task) {
+    roc_panic_if(&task != release_task_.get());
+
+    release_pending_ = 0;
+}
+
+// Release of ended sessions is deferred to a separate task, which is processed
+// between frames if there is time, or otherwise by task processing thread.
+void ReceiverLoop::schedule_release_() {
+    if (release_pending_ || !source_.has_ended_sessions()) {
+        return;
+    }
+
+    release_pending_ = 1;
+
+    release_task_.reset(new (release_task_) Task());
+    release_task_->func_ = &ReceiverLoop::task_release_sessions_;
+    release_task_->set_name("release_sessions");
+
+    schedule(*release_task_, *this);
+}
+
 bool ReceiverLoop::task_create_slot_(Task& task) {
     task.slot_ = source_.create_slot(task.slot_config_);
     return (bool)task.slot_;
@@ -282,14 +409,28 @@ bool ReceiverLoop::task_delete_slot_(Task& task) {
     return true;
 }
 
+bool ReceiverLoop::task_release_sessions_(Task&) {
+    source_.release_ended_sessions();
+    return true;
+}
+
 bool ReceiverLoop::task_query_slot_(Task& task) {
     roc_panic_if(!task.slot_);
     roc_panic_if(!task.slot_metrics_);
 
     task.slot_->get_metrics(*task.slot_metrics_, task.party_metrics_, task.party_count_);
+    task.slot_metrics_->frame_overruns = num_frame_overruns();
+    task.slot_metrics_->profiler = source_.profiler_metrics();
+    task.slot_metrics_->graph.mixer = source_.mixer_metrics();
     return true;
 }
 
+bool ReceiverLoop::task_reconfigure_slot_(Task& task) {
+    roc_panic_if(!task.slot_);
+
+    return task.slot_->reconfigure(task.live_config_);
+}
+
 bool ReceiverLoop::task_add_endpoint_(Task& task) {
     roc_panic_if(!task.slot_);
 
@@ -298,6 +439,9 @@ bool ReceiverLoop::task_add_endpoint_(Task& task) {
     if (!endpoint) {
         return false;
     }
+    if (task.inbound_reader_) {
+        endpoint->set_inbound_reader(*task.inbound_reader_);
+    }
     task.inbound_writer_ = &endpoint->inbound_writer();
     return true;
 }
@@ -12,12 +12,14 @@
 #ifndef ROC_PIPELINE_RECEIVER_LOOP_H_
 #define ROC_PIPELINE_RECEIVER_LOOP_H_
 
+#include "roc_core/atomic.h"
 #include "roc_core/iarena.h"
 #include "roc_core/ipool.h"
 #include "roc_core/mutex.h"
 #include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/ipipeline_task_completer.h"
 #include "roc_pipeline/metrics.h"
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_pipeline/receiver_source.h"
@@ -40,10 +42,17 @@ namespace pipeline {
 //!  - PipelineLoop - can be used to schedule tasks on the pipeline
 //!    (can be used from any thread)
 //!
+//! When sessions end during frame processing, the loop schedules an internal
+//! task that releases their resources. So freeing queues and decoders of
+//! ended sessions happens between frames or in the task processing thread,
+//! rather than during frame processing.
+//!
 //! @note
 //!  Private inheritance from ISource is used to decorate actual implementation
 //!  of ISource - ReceiverSource, in order to integrate it with PipelineLoop.
-class ReceiverLoop : public PipelineLoop, private sndio::ISource {
+class ReceiverLoop : public PipelineLoop,
+                     private sndio::ISource,
+                     private IPipelineTaskCompleter {
 public:
     //! Opaque slot handle.
     typedef struct SlotHandle* SlotHandle;
@@ -59,10 +68,12 @@ public:
 
         ReceiverSlot* slot_;                        //!< Slot.
         ReceiverSlotConfig slot_config_;            //!< Slot config.
+        ReceiverLiveConfig live_config_;            //!< Live config.
         address::Interface iface_;                  //!< Interface.
         address::Protocol proto_;                   //!< Protocol.
         address::SocketAddr inbound_address_;       //!< Inbound packet address.
         packet::IWriter* inbound_writer_;           //!< Inbound packet writer.
+        packet::IReader* inbound_reader_;           //!< Inbound packet reader.
         packet::IWriter* outbound_writer_;          //!< Outbound packet writer.
         ReceiverSlotMetrics* slot_metrics_;         //!< Output slot metrics.
         ReceiverParticipantMetrics* party_metrics_; //!< Output participant metrics.
@@ -101,6 +112,13 @@ public:
                       size_t* party_count);
         };
 
+        //! Change parameters of slot sessions without restarting them.
+        class ReconfigureSlot : public Task {
+        public:
+            //! Set task parameters.
+            ReconfigureSlot(SlotHandle slot, const ReceiverLiveConfig& live_config);
+        };
+
         //! Create endpoint on given interface of the slot.
         class AddEndpoint : public Task {
         public:
@@ -114,6 +132,13 @@ public:
                         const address::SocketAddr& inbound_address,
                         packet::IWriter* outbound_writer);
 
+            //! Poll inbound packets for the endpoint from given reader.
+            //! @remarks
+            //!  Enables run-to-completion mode: reader is invoked inline from
+            //!  pipeline thread every time packets are pulled into pipeline,
+            //!  without handing packets over from network thread.
+            void set_inbound_reader(packet::IReader& inbound_reader);
+
             //! Get packet writer for inbound packets for the endpoint.
             //! @remarks
             //!  The returned writer may be used from any thread.
@@ -122,13 +147,16 @@ public:
     };
 
     //! Initialize.
+    //! @remarks
+    //!  @p memory_tracker is passed to ReceiverSource.
     ReceiverLoop(IPipelineTaskScheduler& scheduler,
                  const ReceiverSourceConfig& source_config,
                  const rtp::EncodingMap& encoding_map,
                  core::IPool& packet_pool,
                  core::IPool& packet_buffer_pool,
                  core::IPool& frame_buffer_pool,
-                 core::IArena& arena);
+                 core::IArena& arena,
+                 core::MemoryTracker* memory_tracker = NULL);
 
     //! Check if the pipeline was successfully constructed.
     bool is_valid() const;
@@ -138,6 +166,31 @@ public:
     //!  Samples received from remote peers become available in this source.
     sndio::ISource& source();
 
+    //! Add pool for smaller frame buffers.
+    //! @remarks
+    //!  See ReceiverSource::add_small_frame_buffer_pool().
+    //!  Should be called before pipeline is used.
+    void add_small_frame_buffer_pool(core::IPool& buffer_pool);
+
+    //! Set packet capture ring.
+    //! @remarks
+    //!  See ReceiverSource::set_packet_capture().
+    //!  Should be called before pipeline is used.
+    void set_packet_capture(packet::CaptureRing& capture_ring);
+
+    //! Get slot metrics without scheduling a task.
+    //! @remarks
+    //!  Reads snapshot that is published by pipeline once per frame. Lock-free,
+    //!  doesn't block pipeline thread and may be called from any thread. The
+    //!  caller should ensure that the slot is not deleted concurrently.
+    //! @returns
+    //!  false if snapshot is not available (e.g. it can't hold requested number
+    //!  of participants); in this case Tasks::QuerySlot should be used.
+    bool load_slot_metrics(SlotHandle slot,
+                           ReceiverSlotMetrics& slot_metrics,
+                           ReceiverParticipantMetrics* party_metrics,
+                           size_t* party_count) const;
+
 private:
     // Methods of sndio::ISource
     virtual sndio::ISink* to_sink();
@@ -159,12 +212,22 @@ private:
     virtual uint64_t tid_imp() const;
     virtual bool process_subframe_imp(audio::Frame& frame);
     virtual bool process_task_imp(PipelineTask& task);
+    virtual bool collect_stage_times_imp(core::nanoseconds_t* stage_times);
+
+    // Methods of IPipelineTaskCompleter
+    virtual void pipeline_task_completed(PipelineTask& task);
+
+    void schedule_release_();
 
     // Methods for tasks
     bool task_create_slot_(Task& task);
     bool task_delete_slot_(Task& task);
     bool task_query_slot_(Task& task);
+    bool task_reconfigure_slot_(Task& task);
     bool task_add_endpoint_(Task& task);
+    bool task_release_sessions_(Task& task);
+
+    bool wait_idle_();
 
     ReceiverSource source_;
     core::Mutex source_mutex_;
@@ -173,6 +236,14 @@ private:
     core::Ticker::ticks_t ticker_ts_;
 
     const bool auto_reclock_;
+    const bool idle_wait_;
+    const core::nanoseconds_t idle_wait_timeout_;
+
+    const audio::SampleSpec sample_spec_;
+
+    // internal task releasing ended sessions
+    core::Optional<Task> release_task_;
+    core::Atomic<int> release_pending_;
 
     bool valid_;
 };
@@ -8,6 +8,7 @@
 
 #include "roc_pipeline/receiver_session.h"
 #include "roc_audio/resampler_map.h"
+#include "roc_core/fast_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_fec/codec_map.h"
@@ -20,9 +21,20 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const rtp::EncodingMap& encoding_map,
                                  packet::PacketFactory& packet_factory,
                                  audio::FrameFactory& frame_factory,
+                                 audio::StageProfiler* stage_profiler,
+                                 const audio::LatencyTunerState* warm_state,
+                                 core::MemoryTracker& memory_tracker,
                                  core::IArena& arena)
     : core::RefCounted<ReceiverSession, core::ArenaAllocation>(arena)
+    , memory_tracker_(&memory_tracker)
+    , session_arena_(arena, memory_tracker_, core::MemoryTag_Session)
+    , queue_arena_(arena, memory_tracker_, core::MemoryTag_Queue)
+    , fec_arena_(arena, memory_tracker_, core::MemoryTag_Fec)
+    , resampler_arena_(arena, memory_tracker_, core::MemoryTag_Resampler)
+    , frame_factory_(frame_factory)
     , frame_reader_(NULL)
+    , overload_level_(OverloadLevel_None)
+    , overload_repair_margin_(0)
     , valid_(false) {
     const rtp::Encoding* pkt_encoding =
         encoding_map.find_by_pt(session_config.payload_type);
@@ -30,7 +42,24 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         return;
     }
 
-    packet_router_.reset(new (packet_router_) packet::Router(arena));
+    overload_repair_margin_ = pkt_encoding->sample_spec.ns_2_stream_timestamp(
+        common_config.overload_control.repair_margin);
+
+    payload_decoder_.reset(
+        pkt_encoding->new_decoder(session_arena_, pkt_encoding->sample_spec),
+        session_arena_);
+    if (!payload_decoder_) {
+        return;
+    }
+
+    if (common_config.max_session_packet_rate != 0) {
+        const size_t burst = size_t((double)common_config.max_session_packet_rate
+                                    * common_config.packet_rate_burst / core::Second);
+        rate_limiter_.reset(new (rate_limiter_) core::TokenBucket(
+            common_config.max_session_packet_rate, burst));
+    }
+
+    packet_router_.reset(new (packet_router_) packet::Router(session_arena_));
     if (!packet_router_) {
         return;
     }
@@ -40,19 +69,44 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     // packets in the queues.
     packet::IWriter* pkt_writer = NULL;
 
-    source_queue_.reset(new (source_queue_) packet::SortedQueue(0));
+    source_queue_.reset(new (source_queue_) packet::SortedQueue(
+        queue_arena_, common_config.max_session_queue_packets));
     if (!source_queue_) {
         return;
     }
     pkt_writer = source_queue_.get();
 
-    source_meter_.reset(new (source_meter_) rtp::LinkMeter(encoding_map));
+    // Drop packets that are already late for playback before they reach queue.
+    // Late FEC packets are kept until FEC reader moves past their block, since
+    // they may still be needed to repair other packets.
+    // Link meter is placed before it, so that late packets are still taken
+    // into account in jitter and loss metrics.
+    late_filter_.reset(new (late_filter_)
+                           audio::LatePacketFilter(*pkt_writer, *payload_decoder_));
+    if (!late_filter_) {
+        return;
+    }
+    pkt_writer = late_filter_.get();
+
+    source_meter_.reset(new (source_meter_)
+                            rtp::LinkMeter(common_config.link_meter, encoding_map));
     if (!source_meter_) {
         return;
     }
     source_meter_->set_writer(*pkt_writer);
     pkt_writer = source_meter_.get();
 
+    // With redundancy, every packet arrives over two paths. Only first copy
+    // is passed further, so that link meter and queue see merged stream.
+    if (common_config.enable_redundancy) {
+        duplicate_filter_.reset(new (duplicate_filter_) packet::DuplicateFilter(
+            *pkt_writer, session_arena_, common_config.duplicate_filter));
+        if (!duplicate_filter_ || !duplicate_filter_->is_valid()) {
+            return;
+        }
+        pkt_writer = duplicate_filter_.get();
+    }
+
     if (!packet_router_->add_route(*pkt_writer, packet::Packet::FlagAudio)) {
         return;
     }
@@ -62,12 +116,6 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     // packets stored in the queues.
     packet::IReader* pkt_reader = source_queue_.get();
 
-    payload_decoder_.reset(pkt_encoding->new_decoder(arena, pkt_encoding->sample_spec),
-                           arena);
-    if (!payload_decoder_) {
-        return;
-    }
-
     filter_.reset(new (filter_)
                       rtp::Filter(*pkt_reader, *payload_decoder_,
                                   common_config.rtp_filter, pkt_encoding->sample_spec));
@@ -76,8 +124,15 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     }
     pkt_reader = filter_.get();
 
+    // Warm-started session continues from state of previous session,
+    // so it can start playback with smaller prefill.
+    const core::nanoseconds_t prefill_latency =
+        warm_state && session_config.warm_start_latency > 0
+        ? session_config.warm_start_latency
+        : session_config.latency.target_latency;
+
     delayed_reader_.reset(new (delayed_reader_) packet::DelayedReader(
-        *pkt_reader, session_config.latency.target_latency, pkt_encoding->sample_spec));
+        *pkt_reader, prefill_latency, pkt_encoding->sample_spec, queue_arena_));
     if (!delayed_reader_ || !delayed_reader_->is_valid()) {
         return;
     }
@@ -87,12 +142,14 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     pkt_reader = source_meter_.get();
 
     if (session_config.fec_decoder.scheme != packet::FEC_None) {
-        repair_queue_.reset(new (repair_queue_) packet::SortedQueue(0));
+        repair_queue_.reset(new (repair_queue_) packet::SortedQueue(
+            queue_arena_, common_config.max_session_queue_packets));
         if (!repair_queue_) {
             return;
         }
 
-        repair_meter_.reset(new (repair_meter_) rtp::LinkMeter(encoding_map));
+        repair_meter_.reset(new (repair_meter_)
+                                rtp::LinkMeter(common_config.link_meter, encoding_map));
         if (!repair_meter_) {
             return;
         }
@@ -102,25 +159,47 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             return;
         }
 
-        fec_decoder_.reset(fec::CodecMap::instance().new_decoder(
-                               session_config.fec_decoder, packet_factory, arena),
-                           arena);
-        if (!fec_decoder_) {
-            return;
-        }
-
         fec_parser_.reset(new (fec_parser_) rtp::Parser(encoding_map, NULL));
         if (!fec_parser_) {
             return;
         }
 
-        fec_reader_.reset(new (fec_reader_) fec::Reader(
-            session_config.fec_reader, session_config.fec_decoder.scheme, *fec_decoder_,
-            *pkt_reader, *repair_queue_, *fec_parser_, packet_factory, arena));
-        if (!fec_reader_ || !fec_reader_->is_valid()) {
-            return;
+        if (fec::CodecMap::instance().is_sliding_window(
+                session_config.fec_decoder.scheme)) {
+            fec_sliding_reader_.reset(new (fec_sliding_reader_) fec::SlidingReader(
+                *pkt_reader, *repair_queue_, *fec_parser_, packet_factory, fec_arena_));
+            if (!fec_sliding_reader_ || !fec_sliding_reader_->is_valid()) {
+                return;
+            }
+            pkt_reader = fec_sliding_reader_.get();
+        } else {
+            fec_decoder_.reset(
+                fec::CodecMap::instance().new_decoder(session_config.fec_decoder,
+                                                      packet_factory, fec_arena_),
+                fec_arena_);
+            if (!fec_decoder_) {
+                return;
+            }
+
+            fec_reader_.reset(new (fec_reader_) fec::Reader(
+                session_config.fec_reader, session_config.fec_decoder.scheme,
+                *fec_decoder_, *pkt_reader, *repair_queue_, *fec_parser_, packet_factory,
+                fec_arena_));
+            if (!fec_reader_ || !fec_reader_->is_valid()) {
+                return;
+            }
+            pkt_reader = fec_reader_.get();
+        }
+
+        if (stage_profiler) {
+            fec_reader_profiler_.reset(
+                new (fec_reader_profiler_) audio::StageProfilingPacketReader(
+                    *pkt_reader, *stage_profiler, audio::ProfilerStage_FecReader));
+            if (!fec_reader_profiler_) {
+                return;
+            }
+            pkt_reader = fec_reader_profiler_.get();
         }
-        pkt_reader = fec_reader_.get();
 
         fec_filter_.reset(new (fec_filter_) rtp::Filter(*pkt_reader, *payload_decoder_,
                                                         common_config.rtp_filter,
@@ -151,17 +230,36 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                          audio::Sample_RawFormat,
                                          pkt_encoding->sample_spec.channel_set());
 
+        if (session_config.enable_plc && !session_config.enable_beeping) {
+            loss_concealer_.reset(new (loss_concealer_) audio::LossConcealer(
+                out_spec, session_config.plc, session_arena_));
+            if (!loss_concealer_ || !loss_concealer_->is_valid()) {
+                return;
+            }
+        }
+
         depacketizer_.reset(new (depacketizer_) audio::Depacketizer(
-            *pkt_reader, *payload_decoder_, out_spec, session_config.enable_beeping));
+            *pkt_reader, *payload_decoder_, out_spec, session_config.enable_beeping,
+            loss_concealer_.get()));
         if (!depacketizer_ || !depacketizer_->is_valid()) {
             return;
         }
         frm_reader = depacketizer_.get();
 
+        if (stage_profiler) {
+            depacketizer_profiler_.reset(
+                new (depacketizer_profiler_) audio::StageProfilingReader(
+                    *frm_reader, *stage_profiler, audio::ProfilerStage_Depacketizer));
+            if (!depacketizer_profiler_) {
+                return;
+            }
+            frm_reader = depacketizer_profiler_.get();
+        }
+
         if (session_config.watchdog.no_playback_timeout >= 0
             || session_config.watchdog.choppy_playback_timeout >= 0) {
             watchdog_.reset(new (watchdog_) audio::Watchdog(
-                *frm_reader, out_spec, session_config.watchdog, arena));
+                *frm_reader, out_spec, session_config.watchdog, session_arena_));
             if (!watchdog_ || !watchdog_->is_valid()) {
                 return;
             }
@@ -186,6 +284,16 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             return;
         }
         frm_reader = channel_mapper_reader_.get();
+
+        if (stage_profiler) {
+            channel_mapper_profiler_.reset(
+                new (channel_mapper_profiler_) audio::StageProfilingReader(
+                    *frm_reader, *stage_profiler, audio::ProfilerStage_ChannelMapper));
+            if (!channel_mapper_profiler_) {
+                return;
+            }
+            frm_reader = channel_mapper_profiler_.get();
+        }
     }
 
     if (session_config.latency.tuner_profile != audio::LatencyTunerProfile_Intact
@@ -199,18 +307,41 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                          audio::Sample_RawFormat,
                                          common_config.output_sample_spec.channel_set());
 
-        resampler_.reset(audio::ResamplerMap::instance().new_resampler(
-            arena, frame_factory, session_config.resampler, in_spec, out_spec));
-        if (!resampler_) {
-            return;
-        }
+        resampler_config_ = session_config.resampler;
+        resampler_in_spec_ = in_spec;
+        resampler_out_spec_ = out_spec;
+
+        if (session_config.latency.locked_clocks
+            && in_spec.sample_rate() == out_spec.sample_rate()) {
+            // Resampler will be bypassed while clocks are locked, and may be
+            // never needed. It's allocated when drift is detected, see refresh().
+            resampler_reader_.reset(new (resampler_reader_) audio::ResamplerReader(
+                *frm_reader, in_spec, out_spec));
+        } else {
+            resampler_.reset(audio::ResamplerMap::instance().new_resampler(
+                resampler_arena_, frame_factory, resampler_config_, resampler_in_spec_,
+                resampler_out_spec_));
+            if (!resampler_) {
+                return;
+            }
 
-        resampler_reader_.reset(new (resampler_reader_) audio::ResamplerReader(
-            *frm_reader, *resampler_, in_spec, out_spec));
+            resampler_reader_.reset(new (resampler_reader_) audio::ResamplerReader(
+                *frm_reader, *resampler_, in_spec, out_spec));
+        }
         if (!resampler_reader_ || !resampler_reader_->is_valid()) {
             return;
         }
         frm_reader = resampler_reader_.get();
+
+        if (stage_profiler) {
+            resampler_profiler_.reset(
+                new (resampler_profiler_) audio::StageProfilingReader(
+                    *frm_reader, *stage_profiler, audio::ProfilerStage_Resampler));
+            if (!resampler_profiler_) {
+                return;
+            }
+            frm_reader = resampler_profiler_.get();
+        }
     }
 
     latency_monitor_.reset(new (latency_monitor_) audio::LatencyMonitor(
@@ -220,8 +351,30 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     if (!latency_monitor_ || !latency_monitor_->is_valid()) {
         return;
     }
+    if (warm_state) {
+        latency_monitor_->restore_state(*warm_state);
+    }
     frm_reader = latency_monitor_.get();
 
+    if (stage_profiler) {
+        // Covers the rest of session pipeline, so that its time is not
+        // attributed to the mixer.
+        session_profiler_.reset(new (session_profiler_) audio::StageProfilingReader(
+            *frm_reader, *stage_profiler, audio::ProfilerStage_Session));
+        if (!session_profiler_) {
+            return;
+        }
+        frm_reader = session_profiler_.get();
+    }
+
+    // Outermost, so that whole session pipeline is accounted.
+    cpu_metering_reader_.reset(new (cpu_metering_reader_)
+                                   audio::CpuMeteringReader(*frm_reader, cpu_meter_));
+    if (!cpu_metering_reader_) {
+        return;
+    }
+    frm_reader = cpu_metering_reader_.get();
+
     if (!frm_reader) {
         return;
     }
@@ -244,7 +397,21 @@ audio::IFrameReader& ReceiverSession::frame_reader() {
 status::StatusCode ReceiverSession::route_packet(const packet::PacketPtr& packet) {
     roc_panic_if(!is_valid());
 
-    return packet_router_->write(packet);
+    cpu_meter_.begin(core::fast_timestamp());
+    const status::StatusCode code = packet_router_->write(packet);
+    cpu_meter_.end(core::fast_timestamp());
+
+    return code;
+}
+
+bool ReceiverSession::allow_packet(core::nanoseconds_t current_time) {
+    roc_panic_if(!is_valid());
+
+    if (!rate_limiter_) {
+        return true;
+    }
+
+    return rate_limiter_->allow(current_time);
 }
 
 bool ReceiverSession::refresh(core::nanoseconds_t current_time,
@@ -267,6 +434,29 @@ bool ReceiverSession::refresh(core::nanoseconds_t current_time,
         return false;
     }
 
+    release_old_resampler_();
+
+    if (latency_monitor_->need_resampler()) {
+        if (!create_deferred_resampler_()) {
+            return false;
+        }
+    }
+
+    if (latency_monitor_->has_playback_position()) {
+        // Tell early stages which packets won't be played anymore,
+        // so they don't waste time queuing or restoring them.
+        const packet::stream_timestamp_t position =
+            latency_monitor_->playback_position();
+
+        late_filter_->set_playback_position(position);
+        if (fec_reader_) {
+            fec_reader_->set_playback_position(position);
+            if (fec_reader_->is_started()) {
+                late_filter_->set_fec_block(fec_reader_->current_block());
+            }
+        }
+    }
+
     return true;
 }
 
@@ -318,6 +508,7 @@ void ReceiverSession::generate_reports(const char* report_cname,
         report.ext_last_seqnum = link_metrics.ext_last_seqnum;
         report.packet_count = link_metrics.total_packets;
         report.cum_loss = link_metrics.lost_packets;
+        report.recent_losses = link_metrics.recent_losses;
         report.jitter = link_metrics.jitter;
         report.niq_latency = latency_metrics.niq_latency;
         report.niq_stalling = latency_metrics.niq_stalling;
@@ -363,15 +554,166 @@ void ReceiverSession::process_report(const rtcp::SendReport& report) {
     }
 }
 
+audio::LatencyTunerState ReceiverSession::save_state() const {
+    roc_panic_if(!is_valid());
+
+    return latency_monitor_->save_state();
+}
+
+void ReceiverSession::set_clock_group(const core::SharedPtr<audio::ClockGroup>& group) {
+    roc_panic_if(!is_valid());
+
+    latency_monitor_->set_clock_group(group);
+}
+
+void ReceiverSession::set_overload_level(OverloadLevel level) {
+    roc_panic_if(!is_valid());
+
+    if (overload_level_ == level) {
+        return;
+    }
+
+    overload_level_ = level;
+
+    depacketizer_->set_concealment(level < OverloadLevel_NoConcealment);
+
+    if (fec_reader_) {
+        fec_reader_->set_repair_margin(
+            level >= OverloadLevel_NoLateRepair ? overload_repair_margin_ : 0);
+    }
+}
+
+void ReceiverSession::set_packet_capture(packet::CaptureRing* capture_ring) {
+    roc_panic_if(!is_valid());
+
+    if (fec_reader_) {
+        fec_reader_->set_packet_capture(capture_ring);
+    }
+}
+
+bool ReceiverSession::reconfigure(const ReceiverLiveConfig& live_config) {
+    roc_panic_if(!is_valid());
+
+    if (live_config.target_latency != 0) {
+        if (!latency_monitor_->set_target_latency(live_config.target_latency)) {
+            return false;
+        }
+    }
+
+    if (live_config.change_resampler && resampler_reader_
+        && live_config.resampler_profile != resampler_config_.profile) {
+        audio::ResamplerConfig resampler_config = resampler_config_;
+        resampler_config.profile = live_config.resampler_profile;
+
+        if (!resampler_reader_->has_resampler()) {
+            // Resampler wasn't allocated yet, it will use new profile.
+            resampler_config_ = resampler_config;
+            return true;
+        }
+
+        release_old_resampler_();
+
+        core::SharedPtr<audio::IResampler> resampler =
+            audio::ResamplerMap::instance().new_resampler(
+                resampler_arena_, frame_factory_, resampler_config, resampler_in_spec_,
+                resampler_out_spec_);
+        if (!resampler) {
+            roc_log(LogError, "receiver session: can't create new resampler");
+            return false;
+        }
+
+        if (!resampler_reader_->set_resampler(*resampler)) {
+            return false;
+        }
+
+        // If previous replacement is still pending, reader has forgotten
+        // its resampler, and it's released here.
+        next_resampler_ = resampler;
+        resampler_config_ = resampler_config;
+    }
+
+    return true;
+}
+
 ReceiverParticipantMetrics ReceiverSession::get_metrics() const {
     roc_panic_if(!is_valid());
 
     ReceiverParticipantMetrics metrics;
     metrics.link = source_meter_->metrics();
     metrics.latency = latency_monitor_->metrics();
+    metrics.concealed_samples = depacketizer_->concealed_samples();
+    metrics.late_packets = late_filter_->num_dropped();
+    metrics.queue_overflow_packets = source_queue_->num_overflows();
+
+    if (repair_queue_) {
+        metrics.queue_overflow_packets += repair_queue_->num_overflows();
+    }
+
+    if (duplicate_filter_) {
+        metrics.duplicate_packets = duplicate_filter_->num_dropped();
+    }
+
+    if (rate_limiter_) {
+        metrics.rate_limited_packets = rate_limiter_->num_denied();
+    }
+
+    if (fec_reader_) {
+        metrics.fec = fec_reader_->metrics();
+    }
+
+    if (fec_sliding_reader_) {
+        metrics.fec = fec_sliding_reader_->metrics();
+    }
+
+    metrics.cpu_ns_per_sec = cpu_meter_.cpu_ns_per_sec();
+    metrics.overload_level = (unsigned)overload_level_;
+    metrics.memory = memory_tracker_.usage();
+
+    metrics.graph.source_queue = source_queue_->metrics();
+    metrics.graph.delayed_queue = delayed_reader_->metrics();
+
+    if (repair_queue_) {
+        metrics.graph.repair_queue = repair_queue_->metrics();
+    }
+
+    if (fec_reader_) {
+        metrics.graph.fec_source_queue = fec_reader_->source_queue_metrics();
+        metrics.graph.fec_repair_queue = fec_reader_->repair_queue_metrics();
+    }
+
+    if (resampler_reader_) {
+        metrics.graph.resampler = resampler_reader_->metrics();
+    }
 
     return metrics;
 }
 
+bool ReceiverSession::create_deferred_resampler_() {
+    roc_log(LogInfo, "receiver session: clock drift detected, allocating resampler");
+
+    resampler_.reset(audio::ResamplerMap::instance().new_resampler(
+        resampler_arena_, frame_factory_, resampler_config_, resampler_in_spec_,
+        resampler_out_spec_));
+    if (!resampler_) {
+        roc_log(LogError, "receiver session: can't create resampler");
+        return false;
+    }
+
+    // Reader is in passthrough mode, so it starts using resampler at once.
+    if (!resampler_reader_->set_resampler(*resampler_)) {
+        return false;
+    }
+
+    return true;
+}
+
+void ReceiverSession::release_old_resampler_() {
+    if (next_resampler_ && !resampler_reader_->has_pending_resampler()) {
+        // Resampler reader switched to new resampler, old one is not used.
+        resampler_ = next_resampler_;
+        next_resampler_.reset();
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -14,22 +14,36 @@
 
 #include "roc_address/socket_addr.h"
 #include "roc_audio/channel_mapper_reader.h"
+#include "roc_audio/clock_group.h"
+#include "roc_audio/cpu_metering_reader.h"
 #include "roc_audio/depacketizer.h"
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/iframe_decoder.h"
 #include "roc_audio/iframe_reader.h"
 #include "roc_audio/iresampler.h"
+#include "roc_audio/late_packet_filter.h"
 #include "roc_audio/latency_monitor.h"
+#include "roc_audio/loss_concealer.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_audio/stage_profiling_packet_reader.h"
+#include "roc_audio/stage_profiling_reader.h"
 #include "roc_audio/watchdog.h"
+#include "roc_core/cpu_meter.h"
 #include "roc_core/iarena.h"
 #include "roc_core/list_node.h"
+#include "roc_core/memory_tracker.h"
 #include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/tagged_arena.h"
+#include "roc_core/token_bucket.h"
 #include "roc_fec/iblock_decoder.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/sliding_reader.h"
+#include "roc_packet/capture_ring.h"
 #include "roc_packet/delayed_reader.h"
+#include "roc_packet/duplicate_filter.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
@@ -59,11 +73,19 @@ class ReceiverSession : public core::RefCounted<ReceiverSession, core::ArenaAllo
                         public core::ListNode<> {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p warm_state is not NULL, session continues from latency tuner
+    //!  state of previous session and uses reduced prefill.
+    //!  Memory of session components is accounted in session's own tracker,
+    //!  which reports to @p memory_tracker.
     ReceiverSession(const ReceiverSessionConfig& session_config,
                     const ReceiverCommonConfig& common_config,
                     const rtp::EncodingMap& encoding_map,
                     packet::PacketFactory& packet_factory,
                     audio::FrameFactory& frame_factory,
+                    audio::StageProfiler* stage_profiler,
+                    const audio::LatencyTunerState* warm_state,
+                    core::MemoryTracker& memory_tracker,
                     core::IArena& arena);
 
     //! Check if the session was succefully constructed.
@@ -83,6 +105,12 @@ public:
     //!  when frame are requested from frame_reader().
     ROC_ATTR_NODISCARD status::StatusCode route_packet(const packet::PacketPtr& packet);
 
+    //! Check whether packet arriving at given time fits session packet rate.
+    //! @remarks
+    //!  Always true if session packet rate is not limited.
+    //!  Packets that don't fit should be dropped without routing.
+    bool allow_packet(core::nanoseconds_t current_time);
+
     //! Refresh pipeline according to current time.
     //! @remarks
     //!  writes to @p next_refresh deadline (absolute time) when refresh should
@@ -112,10 +140,45 @@ public:
     //! Process RTCP report obtained from sender.
     void process_report(const rtcp::SendReport& report);
 
+    //! Save latency tuner state for warm start of next session.
+    audio::LatencyTunerState save_state() const;
+
+    //! Share clock drift estimate with other sessions of the group.
+    void set_clock_group(const core::SharedPtr<audio::ClockGroup>& group);
+
+    //! Apply quality degradation level chosen by overload controller.
+    void set_overload_level(OverloadLevel level);
+
+    //! Capture packets after FEC repair into given ring.
+    //! @remarks
+    //!  Has effect only if session uses block FEC. NULL disables capture.
+    void set_packet_capture(packet::CaptureRing* capture_ring);
+
+    //! Change session parameters on the fly.
+    //! @remarks
+    //!  Target latency is moved gradually by latency tuner. New resampler
+    //!  is created immediately, but replaces the old one only when stream
+    //!  becomes silent.
+    //! @returns
+    //!  false if parameters can't be applied.
+    ROC_ATTR_NODISCARD bool reconfigure(const ReceiverLiveConfig& live_config);
+
     //! Get session metrics.
     ReceiverParticipantMetrics get_metrics() const;
 
 private:
+    bool create_deferred_resampler_();
+    void release_old_resampler_();
+
+    // Memory of session components, accounted per subsystem.
+    // Declared first, so that components are destroyed before.
+    core::MemoryTracker memory_tracker_;
+    core::TaggedArena session_arena_;
+    core::TaggedArena queue_arena_;
+    core::TaggedArena fec_arena_;
+    core::TaggedArena resampler_arena_;
+
+    audio::FrameFactory& frame_factory_;
     audio::IFrameReader* frame_reader_;
 
     core::Optional<packet::Router> packet_router_;
@@ -126,8 +189,13 @@ private:
     core::Optional<rtp::LinkMeter> source_meter_;
     core::Optional<rtp::LinkMeter> repair_meter_;
 
+    core::Optional<audio::LatePacketFilter> late_filter_;
+    core::Optional<packet::DuplicateFilter> duplicate_filter_;
+
     core::ScopedPtr<audio::IFrameDecoder> payload_decoder_;
 
+    core::Optional<audio::LossConcealer> loss_concealer_;
+
     core::Optional<rtp::Filter> filter_;
     core::Optional<packet::DelayedReader> delayed_reader_;
     core::Optional<audio::Watchdog> watchdog_;
@@ -135,19 +203,39 @@ private:
     core::Optional<rtp::Parser> fec_parser_;
     core::ScopedPtr<fec::IBlockDecoder> fec_decoder_;
     core::Optional<fec::Reader> fec_reader_;
+    core::Optional<fec::SlidingReader> fec_sliding_reader_;
+    core::Optional<audio::StageProfilingPacketReader> fec_reader_profiler_;
     core::Optional<rtp::Filter> fec_filter_;
 
     core::Optional<rtp::TimestampInjector> timestamp_injector_;
 
     core::Optional<audio::Depacketizer> depacketizer_;
+    core::Optional<audio::StageProfilingReader> depacketizer_profiler_;
 
     core::Optional<audio::ChannelMapperReader> channel_mapper_reader_;
+    core::Optional<audio::StageProfilingReader> channel_mapper_profiler_;
 
     core::Optional<audio::ResamplerReader> resampler_reader_;
+    core::Optional<audio::StageProfilingReader> resampler_profiler_;
     core::SharedPtr<audio::IResampler> resampler_;
+    // Replaces resampler_ when resampler reader starts using it.
+    core::SharedPtr<audio::IResampler> next_resampler_;
+    audio::ResamplerConfig resampler_config_;
+    audio::SampleSpec resampler_in_spec_;
+    audio::SampleSpec resampler_out_spec_;
 
     core::Optional<audio::LatencyMonitor> latency_monitor_;
 
+    core::Optional<audio::StageProfilingReader> session_profiler_;
+
+    core::CpuMeter cpu_meter_;
+    core::Optional<audio::CpuMeteringReader> cpu_metering_reader_;
+
+    core::Optional<core::TokenBucket> rate_limiter_;
+
+    OverloadLevel overload_level_;
+    packet::stream_timestamp_t overload_repair_margin_;
+
     bool valid_;
 };
 
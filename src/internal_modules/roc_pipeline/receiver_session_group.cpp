@@ -10,6 +10,9 @@
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/probe.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
 #include "roc_rtcp/participant_info.h"
 #include "roc_status/code_to_str.h"
 
@@ -20,30 +23,74 @@ ReceiverSessionGroup::ReceiverSessionGroup(const ReceiverSourceConfig& source_co
                                            const ReceiverSlotConfig& slot_config,
                                            StateTracker& state_tracker,
                                            audio::Mixer& mixer,
+                                           audio::StageProfiler* stage_profiler,
+                                           ClockGroupMap* clock_groups,
                                            const rtp::EncodingMap& encoding_map,
                                            packet::PacketFactory& packet_factory,
                                            audio::FrameFactory& frame_factory,
+                                           core::MemoryTracker& memory_tracker,
                                            core::IArena& arena)
     : source_config_(source_config)
     , slot_config_(slot_config)
     , state_tracker_(state_tracker)
     , mixer_(mixer)
+    , session_profiler_(NULL)
+    , clock_groups_(clock_groups)
     , encoding_map_(encoding_map)
     , arena_(arena)
     , packet_factory_(packet_factory)
     , frame_factory_(frame_factory)
+    , memory_tracker_(memory_tracker)
+    , rtcp_arena_(arena, memory_tracker, core::MemoryTag_Rtcp)
     , session_router_(arena)
+    , session_array_(arena)
+    , session_regions_(arena)
+    , next_region_(0)
+    , warm_state_deadline_(0)
+    , overload_level_(OverloadLevel_None)
+    , capture_ring_(NULL)
+    // Packets routed by network thread would bypass shared FEC repairer.
+    , early_routing_(source_config.common.enable_early_routing
+                     && !source_config.common.enable_shared_fec)
+    , published_routes_(RouteTable())
+    , n_early_routed_(0)
+    , n_early_dropped_(0)
     , valid_(false) {
     identity_.reset(new (identity_) rtp::Identity());
     if (!identity_ || !identity_->is_valid()) {
         return;
     }
 
+    if (stage_profiler) {
+        if (source_config.common.session_threads == 0) {
+            session_profiler_ = stage_profiler;
+        } else {
+            // Profiler expects all stages to be invoked from one thread.
+            roc_log(LogDebug,
+                    "session group: not profiling session stages when sessions"
+                    " are read from worker threads");
+        }
+    }
+
+    if (source_config.common.max_slot_packet_rate != 0) {
+        const size_t burst = size_t((double)source_config.common.max_slot_packet_rate
+                                    * source_config.common.packet_rate_burst
+                                    / core::Second);
+        rate_limiter_.reset(new (rate_limiter_) core::TokenBucket(
+            source_config.common.max_slot_packet_rate, burst));
+    }
+
+    if (!preallocate_regions_()) {
+        return;
+    }
+
     valid_ = true;
 }
 
 ReceiverSessionGroup::~ReceiverSessionGroup() {
     remove_all_sessions_();
+    release_ended_sessions();
+    destroy_regions_();
 }
 
 bool ReceiverSessionGroup::is_valid() const {
@@ -62,7 +109,7 @@ bool ReceiverSessionGroup::create_control_pipeline(ReceiverEndpoint* control_end
 
     rtcp_communicator_.reset(new (rtcp_communicator_) rtcp::Communicator(
         source_config_.common.rtcp, *this, *control_endpoint->outbound_writer(),
-        *control_endpoint->outbound_composer(), packet_factory_, arena_));
+        *control_endpoint->outbound_composer(), packet_factory_, rtcp_arena_));
     if (!rtcp_communicator_ || !rtcp_communicator_->is_valid()) {
         rtcp_communicator_.reset();
         return false;
@@ -79,15 +126,104 @@ status::StatusCode ReceiverSessionGroup::route_packet(const packet::PacketPtr& p
         return route_control_packet_(packet, current_time);
     }
 
-    return route_transport_packet_(packet);
+    return route_transport_packet_(packet, current_time);
+}
+
+bool ReceiverSessionGroup::has_early_routing() const {
+    return early_routing_;
+}
+
+bool ReceiverSessionGroup::route_packet_early(const packet::PacketPtr& packet) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!packet);
+
+    if (!early_routing_ || packet->has_flags(packet::Packet::FlagControl)) {
+        return false;
+    }
+
+    // Fails if pipeline thread is publishing new routes right now,
+    // in this rare case packet just takes slow path.
+    RouteTable routes;
+    if (!published_routes_.try_load(routes)) {
+        return false;
+    }
+
+    int lane_index = routes.default_lane;
+
+    if (lane_index < 0 && packet->has_source_id()) {
+        for (size_t n = 0; n < routes.n_routes; n++) {
+            if (routes.source_ids[n] == packet->source_id()) {
+                lane_index = routes.lanes[n];
+                break;
+            }
+        }
+    }
+
+    if (lane_index < 0) {
+        return false;
+    }
+
+    SessionLane& lane = lanes_[lane_index];
+
+    const size_t queue_limit = source_config_.common.max_session_queue_packets;
+
+    if (queue_limit != 0 && (size_t)lane.n_packets >= queue_limit) {
+        // Pipeline thread doesn't keep up with this session,
+        // drop packet before it occupies pipeline thread.
+        n_early_dropped_++;
+        state_tracker_.add_pending_packets(-1);
+        return true;
+    }
+
+    lane.n_packets++;
+    n_early_routed_++;
+    lane.queue.push_back(*packet);
+
+    return true;
+}
+
+status::StatusCode
+ReceiverSessionGroup::pull_routed_packets(core::nanoseconds_t current_time) {
+    roc_panic_if(!is_valid());
+
+    if (!early_routing_) {
+        return status::StatusOK;
+    }
+
+    for (size_t n = 0; n < MaxLanes; n++) {
+        SessionLane& lane = lanes_[n];
+
+        // Same as in ReceiverEndpoint::pull_packets(), packets being pushed
+        // right now are pulled next time.
+        while (packet::PacketPtr packet = lane.queue.try_pop_front_exclusive()) {
+            lane.n_packets--;
+            packet->make_local();
+
+            status::StatusCode code;
+
+            // Routes could change after network thread pushed packet into lane,
+            // in this case packet is routed from scratch.
+            if (lane.session && has_route_(*packet, n)) {
+                code = route_to_session_(packet, *lane.session, current_time);
+            } else {
+                code = route_transport_packet_(packet, current_time);
+            }
+
+            state_tracker_.add_pending_packets(-1);
+
+            if (code != status::StatusOK) {
+                return code;
+            }
+        }
+    }
+
+    return status::StatusOK;
 }
 
 core::nanoseconds_t
 ReceiverSessionGroup::refresh_sessions(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
-    core::SharedPtr<ReceiverSession> curr, next;
-
     core::nanoseconds_t next_deadline = 0;
 
     if (rtcp_communicator_) {
@@ -101,14 +237,15 @@ ReceiverSessionGroup::refresh_sessions(core::nanoseconds_t current_time) {
         next_deadline = rtcp_communicator_->generation_deadline(current_time);
     }
 
-    for (curr = sessions_.front(); curr; curr = next) {
-        next = sessions_.nextof(*curr);
+    for (size_t n = 0; n < session_array_.size();) {
+        ReceiverSession* sess = session_array_[n];
 
         core::nanoseconds_t sess_deadline = 0;
 
-        if (!curr->refresh(current_time, &sess_deadline)) {
-            // Session ended.
-            remove_session_(curr);
+        if (!sess->refresh(current_time, &sess_deadline)) {
+            // Session ended. It's removed from array, so next session
+            // takes its position.
+            remove_session_(sess);
             continue;
         }
 
@@ -119,6 +256,8 @@ ReceiverSessionGroup::refresh_sessions(core::nanoseconds_t current_time) {
                 next_deadline = std::min(next_deadline, sess_deadline);
             }
         }
+
+        n++;
     }
 
     return next_deadline;
@@ -127,29 +266,129 @@ ReceiverSessionGroup::refresh_sessions(core::nanoseconds_t current_time) {
 void ReceiverSessionGroup::reclock_sessions(core::nanoseconds_t playback_time) {
     roc_panic_if(!is_valid());
 
-    core::SharedPtr<ReceiverSession> curr, next;
-
-    for (curr = sessions_.front(); curr; curr = next) {
-        next = sessions_.nextof(*curr);
+    for (size_t n = 0; n < session_array_.size();) {
+        ReceiverSession* sess = session_array_[n];
 
-        if (!curr->reclock(playback_time)) {
+        if (!sess->reclock(playback_time)) {
             // Session ended.
-            remove_session_(curr);
+            remove_session_(sess);
+            continue;
         }
+
+        n++;
+    }
+}
+
+void ReceiverSessionGroup::set_overload_level(OverloadLevel level) {
+    roc_panic_if(!is_valid());
+
+    overload_level_ = level;
+
+    for (core::SharedPtr<ReceiverSession> sess = sessions_.front(); sess;
+         sess = sessions_.nextof(*sess)) {
+        sess->set_overload_level(level);
     }
 }
 
+void ReceiverSessionGroup::set_packet_capture(packet::CaptureRing* capture_ring) {
+    roc_panic_if(!is_valid());
+
+    capture_ring_ = capture_ring;
+
+    for (core::SharedPtr<ReceiverSession> sess = sessions_.front(); sess;
+         sess = sessions_.nextof(*sess)) {
+        sess->set_packet_capture(capture_ring);
+    }
+}
+
+bool ReceiverSessionGroup::reconfigure(const ReceiverLiveConfig& live_config) {
+    roc_panic_if(!is_valid());
+
+    const audio::LatencyConfig& latency_config =
+        source_config_.session_defaults.latency;
+
+    if (live_config.target_latency != 0
+        && (latency_config.sync_playback || latency_config.latency_budget > 0)) {
+        roc_log(LogError,
+                "session group: can't change target latency when it's managed by"
+                " synchronized playback or latency budget");
+        return false;
+    }
+
+    if (live_config.target_latency < 0) {
+        roc_log(LogError, "session group: invalid target latency: %ld",
+                (long)live_config.target_latency);
+        return false;
+    }
+
+    roc_log(LogInfo,
+            "session group: reconfiguring sessions:"
+            " n_sessions=%lu target_latency=%.3fms change_resampler=%d"
+            " resampler_profile=%s",
+            (unsigned long)sessions_.size(),
+            (double)live_config.target_latency / core::Millisecond,
+            (int)live_config.change_resampler,
+            audio::resampler_profile_to_str(live_config.resampler_profile));
+
+    if (live_config.target_latency != 0) {
+        live_config_.target_latency = live_config.target_latency;
+    }
+    if (live_config.change_resampler) {
+        live_config_.change_resampler = true;
+        live_config_.resampler_profile = live_config.resampler_profile;
+    }
+
+    bool ok = true;
+
+    for (core::SharedPtr<ReceiverSession> sess = sessions_.front(); sess;
+         sess = sessions_.nextof(*sess)) {
+        if (!sess->reconfigure(live_config)) {
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
 size_t ReceiverSessionGroup::num_sessions() const {
     roc_panic_if(!is_valid());
 
     return sessions_.size();
 }
 
+bool ReceiverSessionGroup::has_ended_sessions() const {
+    return !ended_sessions_.is_empty();
+}
+
+void ReceiverSessionGroup::release_ended_sessions() {
+    if (ended_sessions_.is_empty()) {
+        return;
+    }
+
+    roc_log(LogDebug, "session group: releasing ended sessions: n_sessions=%lu",
+            (unsigned long)ended_sessions_.size());
+
+    while (core::SharedPtr<ReceiverSession> sess = ended_sessions_.front()) {
+        ended_sessions_.remove(*sess);
+    }
+}
+
 void ReceiverSessionGroup::get_slot_metrics(ReceiverSlotMetrics& slot_metrics) const {
     roc_panic_if(!is_valid());
 
     slot_metrics.source_id = identity_->ssrc();
     slot_metrics.num_participants = sessions_.size();
+
+    if (rate_limiter_) {
+        slot_metrics.rate_limited_packets = rate_limiter_->num_denied();
+    }
+
+    slot_metrics.early_routed_packets = n_early_routed_;
+    slot_metrics.early_dropped_packets = n_early_dropped_;
+
+    if (shared_fec_repairer_) {
+        slot_metrics.shared_fec = shared_fec_repairer_->metrics();
+    }
 }
 
 void ReceiverSessionGroup::get_participant_metrics(
@@ -252,11 +491,23 @@ ReceiverSessionGroup::notify_recv_stream(packet::stream_source_t send_source_id,
         remove_session_(old_sess);
     }
 
+    // Linked SSRC may now belong to another session.
+    reset_routes_();
+
     // If there is currently a session for given SSRC, let it process the report.
     core::SharedPtr<ReceiverSession> cur_sess =
         session_router_.find_by_source(send_source_id);
     if (cur_sess) {
         cur_sess->process_report(send_report);
+
+        // Sessions from the same sender host share clock drift estimate.
+        if (clock_groups_) {
+            core::SharedPtr<audio::ClockGroup> group =
+                clock_groups_->find_or_create(send_report.sender_cname);
+            if (group) {
+                cur_sess->set_clock_group(group);
+            }
+        }
     }
 
     return status::StatusOK;
@@ -275,10 +526,29 @@ void ReceiverSessionGroup::halt_recv_stream(packet::stream_source_t send_source_
         // means that there are no more routes to that session.
         remove_session_(old_sess);
     }
+
+    reset_routes_();
 }
 
 status::StatusCode
-ReceiverSessionGroup::route_transport_packet_(const packet::PacketPtr& packet) {
+ReceiverSessionGroup::route_transport_packet_(const packet::PacketPtr& packet,
+                                              core::nanoseconds_t current_time) {
+    if (source_config_.common.enable_shared_fec && packet->fec()) {
+        if (packet->has_flags(packet::Packet::FlagRepair)) {
+            // Repair packets are used only by group.
+            if (rate_limiter_ && !rate_limiter_->allow(current_time)) {
+                return status::StatusOK;
+            }
+            return route_shared_fec_packet_(packet);
+        }
+
+        // Source packets are used by group and are passed to session too.
+        const status::StatusCode code = route_shared_fec_packet_(packet);
+        if (code != status::StatusOK) {
+            return code;
+        }
+    }
+
     core::SharedPtr<ReceiverSession> sess;
 
     if (slot_config_.enable_routing) {
@@ -313,9 +583,20 @@ ReceiverSessionGroup::route_transport_packet_(const packet::PacketPtr& packet) {
         }
     }
 
+    roc_probe(session_route, (int)(sess != NULL), (uint32_t)packet->source_id(),
+              (uint32_t)(packet->rtp() ? packet->rtp()->seqnum : 0),
+              (uint32_t)packet->stream_timestamp(), (int64_t)packet->receive_timestamp());
+
     if (sess) {
-        // Session found, route packet to it.
-        return sess->route_packet(packet);
+        // Session found, let network thread route next packets of this
+        // session by itself, if early routing is enabled.
+        learn_route_(*packet, *sess);
+
+        return route_to_session_(packet, *sess, current_time);
+    }
+
+    if (rate_limiter_ && !rate_limiter_->allow(current_time)) {
+        return status::StatusOK;
     }
 
     // Session not found, auto-create session if possible.
@@ -327,6 +608,23 @@ ReceiverSessionGroup::route_transport_packet_(const packet::PacketPtr& packet) {
     return status::StatusOK;
 }
 
+status::StatusCode
+ReceiverSessionGroup::route_to_session_(const packet::PacketPtr& packet,
+                                        ReceiverSession& sess,
+                                        core::nanoseconds_t current_time) {
+    // Session limit is checked first, so that packets of a flooding sender
+    // don't consume slot limit shared with other senders.
+    if (!sess.allow_packet(current_time)) {
+        return status::StatusOK;
+    }
+
+    if (rate_limiter_ && !rate_limiter_->allow(current_time)) {
+        return status::StatusOK;
+    }
+
+    return sess.route_packet(packet);
+}
+
 status::StatusCode
 ReceiverSessionGroup::route_control_packet_(const packet::PacketPtr& packet,
                                             core::nanoseconds_t current_time) {
@@ -339,15 +637,166 @@ ReceiverSessionGroup::route_control_packet_(const packet::PacketPtr& packet,
     return rtcp_communicator_->process_packet(packet, current_time);
 }
 
+status::StatusCode
+ReceiverSessionGroup::route_shared_fec_packet_(const packet::PacketPtr& packet) {
+    if (!shared_fec_repairer_) {
+        if (!create_shared_fec_(packet->fec()->fec_scheme)) {
+            // TODO(gh-183): return status
+            return status::StatusOK;
+        }
+    }
+
+    // May invoke write() with restored packets.
+    return shared_fec_repairer_->write(packet);
+}
+
+bool ReceiverSessionGroup::create_shared_fec_(packet::FecScheme fec_scheme) {
+    if (fec::CodecMap::instance().is_sliding_window(fec_scheme)) {
+        roc_log(LogDebug,
+                "session group: shared fec is not supported for fec scheme %s",
+                packet::fec_scheme_to_str(fec_scheme));
+        return false;
+    }
+
+    fec::CodecConfig codec_config = source_config_.session_defaults.fec_decoder;
+    codec_config.scheme = fec_scheme;
+
+    shared_fec_decoder_.reset(
+        fec::CodecMap::instance().new_decoder(codec_config, packet_factory_, arena_),
+        arena_);
+    if (!shared_fec_decoder_) {
+        return false;
+    }
+
+    shared_fec_parser_.reset(new (shared_fec_parser_) rtp::Parser(encoding_map_, NULL));
+    if (!shared_fec_parser_) {
+        return false;
+    }
+
+    shared_fec_repairer_.reset(new (shared_fec_repairer_) fec::GroupRepairer(
+        source_config_.common.shared_fec, fec_scheme, *shared_fec_decoder_,
+        *shared_fec_parser_, *this, packet_factory_, arena_));
+    if (!shared_fec_repairer_ || !shared_fec_repairer_->is_valid()) {
+        shared_fec_repairer_.reset();
+        return false;
+    }
+
+    roc_log(LogDebug, "session group: created shared fec repairer: fec_scheme=%s",
+            packet::fec_scheme_to_str(fec_scheme));
+
+    return true;
+}
+
+status::StatusCode ReceiverSessionGroup::write(const packet::PacketPtr& packet) {
+    core::SharedPtr<ReceiverSession> sess;
+
+    // Restored packet carries source ID of its stream.
+    if (slot_config_.enable_routing) {
+        if (packet->has_source_id()) {
+            sess = session_router_.find_by_source(packet->source_id());
+        }
+    } else if (!sessions_.is_empty()) {
+        sess = sessions_.front();
+    }
+
+    if (!sess) {
+        // Session was removed or not created yet.
+        return status::StatusOK;
+    }
+
+    return sess->route_packet(packet);
+}
+
 bool ReceiverSessionGroup::can_create_session_(const packet::PacketPtr& packet) {
     if (packet->has_flags(packet::Packet::FlagRepair)) {
         roc_log(LogDebug, "session group: ignoring repair packet for unknown session");
         return false;
     }
 
+    if (source_config_.common.max_sessions != 0
+        && sessions_.size() >= source_config_.common.max_sessions) {
+        roc_log(LogDebug,
+                "session group: ignoring packet for unknown session,"
+                " reached session limit: max_sessions=%lu",
+                (unsigned long)source_config_.common.max_sessions);
+        return false;
+    }
+
     return true;
 }
 
+bool ReceiverSessionGroup::preallocate_regions_() {
+    const size_t n_regions = source_config_.common.max_sessions;
+    if (n_regions == 0) {
+        return true;
+    }
+
+    if (!session_regions_.grow(n_regions)) {
+        roc_log(LogError, "session group: can't allocate session regions");
+        return false;
+    }
+
+    for (size_t n = 0; n < n_regions; n++) {
+        core::RegionArena* region = new (arena_)
+            core::RegionArena(arena_, source_config_.common.session_region_size);
+        if (!region) {
+            roc_log(LogError, "session group: can't allocate session regions");
+            return false;
+        }
+
+        if (!session_regions_.push_back(region)) {
+            arena_.destroy_object(*region);
+            roc_log(LogError, "session group: can't allocate session regions");
+            return false;
+        }
+
+        if (!region->is_valid()) {
+            roc_log(LogError, "session group: can't allocate session regions");
+            return false;
+        }
+    }
+
+    roc_log(LogDebug,
+            "session group: preallocated session regions: n_regions=%lu region_size=%lu",
+            (unsigned long)n_regions,
+            (unsigned long)source_config_.common.session_region_size);
+
+    return true;
+}
+
+void ReceiverSessionGroup::destroy_regions_() {
+    for (size_t n = 0; n < session_regions_.size(); n++) {
+        arena_.destroy_object(*session_regions_[n]);
+    }
+    session_regions_.clear();
+}
+
+core::IArena* ReceiverSessionGroup::acquire_session_arena_() {
+    if (session_regions_.size() == 0) {
+        return &arena_;
+    }
+
+    // Session releases its region when it's destroyed, and this may happen after
+    // it was removed from group. Hence we look for any idle region, starting
+    // after the one used most recently.
+    for (size_t n = 0; n < session_regions_.size(); n++) {
+        const size_t pos = (next_region_ + n) % session_regions_.size();
+
+        if (session_regions_[pos]->is_idle()) {
+            next_region_ = (pos + 1) % session_regions_.size();
+            return session_regions_[pos];
+        }
+    }
+
+    if (has_ended_sessions()) {
+        // Ended sessions may still occupy regions, release them right now.
+        release_ended_sessions();
+        return acquire_session_arena_();
+    }
+
+    return NULL;
+}
+
 status::StatusCode
 ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
     if (!packet->rtp()) {
@@ -371,13 +820,25 @@ ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
     const address::SocketAddr& src_address = packet->udp()->src_addr;
     const address::SocketAddr& dst_address = packet->udp()->dst_addr;
 
-    roc_log(LogInfo, "session group: creating session: src_addr=%s dst_addr=%s",
+    const audio::LatencyTunerState* warm_state = take_warm_state_();
+
+    roc_log(LogInfo,
+            "session group: creating session: src_addr=%s dst_addr=%s warm_start=%d",
             address::socket_addr_to_str(src_address).c_str(),
-            address::socket_addr_to_str(dst_address).c_str());
+            address::socket_addr_to_str(dst_address).c_str(), (int)(warm_state != NULL));
+
+    core::IArena* sess_arena = acquire_session_arena_();
+    if (!sess_arena) {
+        roc_log(LogError, "session group: can't create session, no idle regions");
+        // TODO(gh-183): return status
+        return status::StatusOK;
+    }
 
     core::SharedPtr<ReceiverSession> sess =
-        new (arena_) ReceiverSession(sess_config, source_config_.common, encoding_map_,
-                                     packet_factory_, frame_factory_, arena_);
+        new (*sess_arena) ReceiverSession(sess_config, source_config_.common,
+                                          encoding_map_, packet_factory_, frame_factory_,
+                                          session_profiler_, warm_state, memory_tracker_,
+                                          *sess_arena);
 
     if (!sess || !sess->is_valid()) {
         roc_log(LogError, "session group: can't create session, initialization failed");
@@ -404,9 +865,27 @@ ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
         return status::StatusOK;
     }
 
-    mixer_.add_input(sess->frame_reader());
+    if (!mixer_.add_input(sess->frame_reader())) {
+        roc_log(LogError, "session group: can't create session, can't add to mixer");
+        session_router_.remove_session(sess);
+        // TODO(gh-183): return status
+        return status::StatusOK;
+    }
+
+    if (!session_array_.push_back(sess.get())) {
+        roc_log(LogError, "session group: can't create session, can't allocate array");
+        mixer_.remove_input(sess->frame_reader());
+        session_router_.remove_session(sess);
+        // TODO(gh-183): return status
+        return status::StatusOK;
+    }
     sessions_.push_back(*sess);
 
+    sess->set_overload_level(overload_level_);
+    sess->set_packet_capture(capture_ring_);
+
+    attach_lane_(*sess);
+
     state_tracker_.add_active_sessions(+1);
 
     return status::StatusOK;
@@ -415,11 +894,55 @@ ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
 void ReceiverSessionGroup::remove_session_(core::SharedPtr<ReceiverSession> sess) {
     roc_log(LogInfo, "session group: removing session");
 
+    save_warm_state_(*sess);
+
     mixer_.remove_input(sess->frame_reader());
     sessions_.remove(*sess);
 
+    size_t pos = 0;
+    while (session_array_[pos] != sess.get()) {
+        pos++;
+    }
+    for (; pos + 1 < session_array_.size(); pos++) {
+        session_array_[pos] = session_array_[pos + 1];
+    }
+    session_array_.pop_back();
+
     session_router_.remove_session(sess);
     state_tracker_.add_active_sessions(-1);
+
+    detach_lane_(*sess);
+
+    // Session is detached from pipeline, but its resources are released later,
+    // see release_ended_sessions().
+    ended_sessions_.push_back(*sess);
+}
+
+void ReceiverSessionGroup::save_warm_state_(const ReceiverSession& sess) {
+    if (source_config_.session_defaults.warm_start_timeout <= 0) {
+        return;
+    }
+
+    warm_state_ = sess.save_state();
+    warm_state_deadline_ = core::timestamp(core::ClockMonotonic)
+        + source_config_.session_defaults.warm_start_timeout;
+}
+
+const audio::LatencyTunerState* ReceiverSessionGroup::take_warm_state_() {
+    if (warm_state_deadline_ == 0) {
+        return NULL;
+    }
+
+    const bool expired = core::timestamp(core::ClockMonotonic) >= warm_state_deadline_;
+
+    // Saved state is used at most once.
+    warm_state_deadline_ = 0;
+
+    if (expired) {
+        return NULL;
+    }
+
+    return &warm_state_;
 }
 
 void ReceiverSessionGroup::remove_all_sessions_() {
@@ -439,13 +962,130 @@ ReceiverSessionGroup::make_session_config_(const packet::PacketPtr& packet) cons
         config.payload_type = rtp->payload_type;
     }
 
+    // With shared FEC, packets are repaired by group instead of session.
     packet::FEC* fec = packet->fec();
-    if (fec) {
+    if (fec && !source_config_.common.enable_shared_fec) {
         config.fec_decoder.scheme = fec->fec_scheme;
     }
 
+    if (live_config_.target_latency != 0) {
+        config.latency.target_latency = live_config_.target_latency;
+    }
+    if (live_config_.change_resampler) {
+        config.resampler.profile = live_config_.resampler_profile;
+    }
+
     return config;
 }
 
+void ReceiverSessionGroup::attach_lane_(ReceiverSession& sess) {
+    if (!early_routing_) {
+        return;
+    }
+
+    for (size_t n = 0; n < MaxLanes; n++) {
+        if (!lanes_[n].session) {
+            // Lane may still have packets of previous session,
+            // they are routed from scratch when pulled.
+            lanes_[n].session = &sess;
+            return;
+        }
+    }
+
+    roc_log(LogDebug,
+            "session group: no free lanes, session will be routed by pipeline thread:"
+            " max_lanes=%lu",
+            (unsigned long)MaxLanes);
+}
+
+void ReceiverSessionGroup::detach_lane_(ReceiverSession& sess) {
+    const int lane = find_lane_(sess);
+    if (lane < 0) {
+        return;
+    }
+
+    lanes_[lane].session = NULL;
+    reset_routes_();
+}
+
+int ReceiverSessionGroup::find_lane_(const ReceiverSession& sess) const {
+    for (size_t n = 0; n < MaxLanes; n++) {
+        if (lanes_[n].session == &sess) {
+            return (int)n;
+        }
+    }
+
+    return -1;
+}
+
+bool ReceiverSessionGroup::has_route_(const packet::Packet& packet, size_t lane) const {
+    if (routes_.default_lane == (int)lane) {
+        return true;
+    }
+
+    if (!packet.has_source_id()) {
+        return false;
+    }
+
+    for (size_t n = 0; n < routes_.n_routes; n++) {
+        if (routes_.source_ids[n] == packet.source_id()) {
+            return routes_.lanes[n] == lane;
+        }
+    }
+
+    return false;
+}
+
+void ReceiverSessionGroup::learn_route_(const packet::Packet& packet,
+                                        const ReceiverSession& sess) {
+    if (!early_routing_) {
+        return;
+    }
+
+    const int lane = find_lane_(sess);
+    if (lane < 0) {
+        return;
+    }
+
+    if (!slot_config_.enable_routing) {
+        // There is only one session, route everything to it.
+        if (routes_.default_lane == lane) {
+            return;
+        }
+        routes_.default_lane = lane;
+    } else {
+        // Repair packets without source ID always take slow path.
+        if (!packet.has_source_id()) {
+            return;
+        }
+
+        for (size_t n = 0; n < routes_.n_routes; n++) {
+            if (routes_.source_ids[n] == packet.source_id()) {
+                return;
+            }
+        }
+
+        if (routes_.n_routes == RouteTable::MaxRoutes) {
+            return;
+        }
+
+        routes_.source_ids[routes_.n_routes] = packet.source_id();
+        routes_.lanes[routes_.n_routes] = (uint8_t)lane;
+        routes_.n_routes++;
+    }
+
+    published_routes_.exclusive_store(routes_);
+}
+
+void ReceiverSessionGroup::reset_routes_() {
+    if (!early_routing_) {
+        return;
+    }
+
+    // Routes are learned again from packets taking slow path.
+    routes_ = RouteTable();
+    published_routes_.exclusive_store(routes_);
+}
+
 } // namespace pipeline
 } // namespace roc
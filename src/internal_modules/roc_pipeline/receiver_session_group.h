@@ -14,10 +14,24 @@
 
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/mixer.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
 #include "roc_core/iarena.h"
 #include "roc_core/list.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/mpsc_queue.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/region_arena.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/tagged_arena.h"
+#include "roc_core/token_bucket.h"
+#include "roc_fec/group_repairer.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_packet/iwriter.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_pipeline/clock_group_map.h"
 #include "roc_pipeline/metrics.h"
 #include "roc_pipeline/receiver_endpoint.h"
 #include "roc_pipeline/receiver_session.h"
@@ -27,6 +41,7 @@
 #include "roc_rtcp/composer.h"
 #include "roc_rtcp/iparticipant.h"
 #include "roc_rtp/identity.h"
+#include "roc_rtp/parser.h"
 
 namespace roc {
 namespace pipeline {
@@ -43,18 +58,46 @@ namespace pipeline {
 //! Session group creates and removes sessions and routes packets from endpoints to
 //! sessions with the help of ReceiverSessionRouter.
 //!
+//! Session group also enforces packet rate limits of the slot and of every
+//! session, so that a sender flooding the receiver can't occupy shared
+//! packet pool and pipeline time of other sessions.
+//!
 //! It also exchanges control information with remote senders using rtcp::Communicator
 //! and updates routing based on that control information.
-class ReceiverSessionGroup : public core::NonCopyable<>, private rtcp::IParticipant {
+//!
+//! If shared FEC is enabled, session group repairs packets of all sessions jointly
+//! using fec::GroupRepairer, and routes restored packets to sessions.
+//!
+//! If early routing is enabled, network threads may route parsed packets to
+//! sessions too, see route_packet_early(). Network threads never access
+//! router or sessions; instead, pipeline thread publishes a snapshot of routes
+//! learned by router, and network threads use it to push packets into
+//! per-session queues, which are then pulled by pipeline thread.
+//!
+//! If session threads are enabled, mixer reads sessions in parallel on
+//! core::WorkerPool threads. Packets are switched to non-atomic local mode when
+//! pulled from endpoint queues, and sessions incref and decref them on worker
+//! threads. This is safe only because (1) WorkerPool semaphores order all
+//! accesses from pipeline thread and worker threads, and (2) while sessions are
+//! read, every packet is referenced from at most one session. Components that
+//! share packets between sessions (like shared FEC repairer) may hold references,
+//! but must not touch them during parallel read. A component that hands the
+//! same packet to several sessions should call make_shared() on it first.
+class ReceiverSessionGroup : public core::NonCopyable<>,
+                             private rtcp::IParticipant,
+                             private packet::IWriter {
 public:
     //! Initialize.
     ReceiverSessionGroup(const ReceiverSourceConfig& source_config,
                          const ReceiverSlotConfig& slot_config,
                          StateTracker& state_tracker,
                          audio::Mixer& mixer,
+                         audio::StageProfiler* stage_profiler,
+                         ClockGroupMap* clock_groups,
                          const rtp::EncodingMap& encoding_map,
                          packet::PacketFactory& packet_factory,
                          audio::FrameFactory& frame_factory,
+                         core::MemoryTracker& memory_tracker,
                          core::IArena& arena);
 
     ~ReceiverSessionGroup();
@@ -74,6 +117,27 @@ public:
     ROC_ATTR_NODISCARD status::StatusCode route_packet(const packet::PacketPtr& packet,
                                                        core::nanoseconds_t current_time);
 
+    //! Check if packets can be routed by network thread.
+    bool has_early_routing() const;
+
+    //! Route parsed transport packet to session queue from network thread.
+    //! @remarks
+    //!  Looks up session by packet source ID (or uses the only session, if
+    //!  routing is disabled) in the snapshot of routing table, and pushes the
+    //!  packet to per-session queue. Thread-safe, lock-free and wait-free.
+    //!  Packet should be counted as pending in state tracker; if true is
+    //!  returned, group takes care of it.
+    //! @returns
+    //!  false if there is no route for the packet, in which case it should be
+    //!  passed to route_packet() from pipeline thread.
+    bool route_packet_early(const packet::PacketPtr& packet);
+
+    //! Pull packets routed by network thread into sessions.
+    //! @remarks
+    //!  Should be called from pipeline thread after pulling endpoints.
+    ROC_ATTR_NODISCARD status::StatusCode
+    pull_routed_packets(core::nanoseconds_t current_time);
+
     //! Refresh pipeline according to current time.
     //! @returns
     //!  deadline (absolute time) when refresh should be invoked again
@@ -86,9 +150,38 @@ public:
     //!  retrieved from pipeline will be actually played on sink
     void reclock_sessions(core::nanoseconds_t playback_time);
 
+    //! Apply quality degradation level to all sessions.
+    //! @remarks
+    //!  Sessions created later get the same level.
+    void set_overload_level(OverloadLevel level);
+
+    //! Capture packets of all sessions into given ring.
+    //! @remarks
+    //!  Sessions created later are captured too.
+    void set_packet_capture(packet::CaptureRing* capture_ring);
+
+    //! Change session parameters on the fly.
+    //! @remarks
+    //!  Applied to all sessions. Sessions created later are created
+    //!  with new parameters.
+    //! @returns
+    //!  false if parameters can't be applied.
+    ROC_ATTR_NODISCARD bool reconfigure(const ReceiverLiveConfig& live_config);
+
     //! Get number of sessions in group.
     size_t num_sessions() const;
 
+    //! Check if there are ended sessions not released yet.
+    bool has_ended_sessions() const;
+
+    //! Release resources of ended sessions.
+    //! @remarks
+    //!  When session ends, it's removed from mixer and router immediately,
+    //!  but its resources (queued packets, FEC decoder, resampler, etc) are
+    //!  kept until this method is called. This allows to release them outside
+    //!  of frame processing, so that freeing deep queues doesn't delay frames.
+    void release_ended_sessions();
+
     //! Get slot metrics.
     //! @remarks
     //!  These metrics are for the whole slot.
@@ -121,23 +214,83 @@ private:
                                                   const rtcp::SendReport& send_report);
     virtual void halt_recv_stream(packet::stream_source_t send_source_id);
 
-    status::StatusCode route_transport_packet_(const packet::PacketPtr& packet);
+    // Implementation of packet::IWriter interface.
+    // Invoked by fec::GroupRepairer with restored packets.
+    virtual status::StatusCode write(const packet::PacketPtr& packet);
+
+    // Snapshot of routes, published by pipeline thread for network threads.
+    // Holds only a few routes; packets of other sessions take slow path.
+    struct RouteTable {
+        enum { MaxRoutes = 16 };
+
+        // Lane for any packet, used when routing is disabled, or -1.
+        int default_lane;
+
+        size_t n_routes;
+        packet::stream_source_t source_ids[MaxRoutes];
+        uint8_t lanes[MaxRoutes];
+
+        RouteTable()
+            : default_lane(-1)
+            , n_routes(0) {
+        }
+    };
+
+    // Queue of packets routed to one session by network thread.
+    struct SessionLane {
+        core::MpscQueue<packet::Packet> queue;
+        core::Atomic<int> n_packets;
+        // Accessed only by pipeline thread.
+        ReceiverSession* session;
+
+        SessionLane()
+            : n_packets(0)
+            , session(NULL) {
+        }
+    };
+
+    enum { MaxLanes = 8 };
+
+    status::StatusCode route_transport_packet_(const packet::PacketPtr& packet,
+                                               core::nanoseconds_t current_time);
+    status::StatusCode route_to_session_(const packet::PacketPtr& packet,
+                                         ReceiverSession& sess,
+                                         core::nanoseconds_t current_time);
     status::StatusCode route_control_packet_(const packet::PacketPtr& packet,
                                              core::nanoseconds_t current_time);
+    status::StatusCode route_shared_fec_packet_(const packet::PacketPtr& packet);
+
+    bool create_shared_fec_(packet::FecScheme fec_scheme);
 
     bool can_create_session_(const packet::PacketPtr& packet);
 
+    bool preallocate_regions_();
+    void destroy_regions_();
+    core::IArena* acquire_session_arena_();
+
     status::StatusCode create_session_(const packet::PacketPtr& packet);
     void remove_session_(core::SharedPtr<ReceiverSession> sess);
+
+    void save_warm_state_(const ReceiverSession& sess);
+    const audio::LatencyTunerState* take_warm_state_();
     void remove_all_sessions_();
 
     ReceiverSessionConfig make_session_config_(const packet::PacketPtr& packet) const;
 
+    void attach_lane_(ReceiverSession& sess);
+    void detach_lane_(ReceiverSession& sess);
+    int find_lane_(const ReceiverSession& sess) const;
+    bool has_route_(const packet::Packet& packet, size_t lane) const;
+    void learn_route_(const packet::Packet& packet, const ReceiverSession& sess);
+    void reset_routes_();
+
     const ReceiverSourceConfig source_config_;
     const ReceiverSlotConfig slot_config_;
 
     StateTracker& state_tracker_;
     audio::Mixer& mixer_;
+    audio::StageProfiler* session_profiler_;
+    ClockGroupMap* clock_groups_;
 
     const rtp::EncodingMap& encoding_map_;
 
@@ -145,6 +298,9 @@ private:
     packet::PacketFactory& packet_factory_;
     audio::FrameFactory& frame_factory_;
 
+    core::MemoryTracker& memory_tracker_;
+    core::TaggedArena rtcp_arena_;
+
     core::Optional<rtp::Identity> identity_;
 
     core::Optional<rtcp::Communicator> rtcp_communicator_;
@@ -153,6 +309,43 @@ private:
     core::List<ReceiverSession> sessions_;
     ReceiverSessionRouter session_router_;
 
+    // same sessions as in sessions_, stored contiguously for per-frame
+    // iteration; updated only when sessions are added or removed
+    core::Array<ReceiverSession*, 8> session_array_;
+
+    // repairs packets of all sessions, if shared fec is enabled
+    core::ScopedPtr<fec::IBlockDecoder> shared_fec_decoder_;
+    core::Optional<rtp::Parser> shared_fec_parser_;
+    core::Optional<fec::GroupRepairer> shared_fec_repairer_;
+
+    // sessions removed from group, but not released yet
+    core::List<ReceiverSession> ended_sessions_;
+
+    core::Array<core::RegionArena*> session_regions_;
+    size_t next_region_;
+
+    // limits packet rate of all sessions
+    core::Optional<core::TokenBucket> rate_limiter_;
+
+    // state of last ended session, used for warm start of next one
+    audio::LatencyTunerState warm_state_;
+    core::nanoseconds_t warm_state_deadline_;
+
+    OverloadLevel overload_level_;
+
+    packet::CaptureRing* capture_ring_;
+
+    // parameters changed on the fly, applied to new sessions
+    ReceiverLiveConfig live_config_;
+
+    // early routing by network thread
+    const bool early_routing_;
+    SessionLane lanes_[MaxLanes];
+    RouteTable routes_;
+    core::Seqlock<RouteTable> published_routes_;
+    core::Atomic<size_t> n_early_routed_;
+    core::Atomic<size_t> n_early_dropped_;
+
     bool valid_;
 };
 
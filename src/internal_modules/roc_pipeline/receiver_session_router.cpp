@@ -22,7 +22,9 @@ ReceiverSessionRouter::ReceiverSessionRouter(core::IArena& arena)
     , source_route_map_(arena)
     , address_route_map_(arena)
     , cname_route_map_(arena)
-    , session_route_map_(arena) {
+    , session_route_map_(arena)
+    , last_source_node_(NULL)
+    , last_address_node_(NULL) {
 }
 
 ReceiverSessionRouter::~ReceiverSessionRouter() {
@@ -35,11 +37,17 @@ size_t ReceiverSessionRouter::num_routes() {
 
 core::SharedPtr<ReceiverSession>
 ReceiverSessionRouter::find_by_source(packet::stream_source_t source_id) {
+    if (last_source_node_ && last_source_node_->source_id == source_id) {
+        return last_source_node_->route().session;
+    }
+
     SourceNode* node = source_route_map_.find(source_id);
     if (!node) {
         return NULL;
     }
 
+    last_source_node_ = node;
+
     return node->route().session;
 }
 
@@ -47,11 +55,17 @@ core::SharedPtr<ReceiverSession>
 ReceiverSessionRouter::find_by_address(const address::SocketAddr& source_addr) {
     roc_panic_if(!source_addr);
 
+    if (last_address_node_ && last_address_node_->key() == source_addr) {
+        return last_address_node_->route().session;
+    }
+
     AddressNode* node = address_route_map_.find(source_addr);
     if (!node) {
         return NULL;
     }
 
+    last_address_node_ = node;
+
     return node->route().session;
 }
 
@@ -67,6 +81,8 @@ ReceiverSessionRouter::add_session(const core::SharedPtr<ReceiverSession>& sessi
                                    const address::SocketAddr& source_addr) {
     roc_panic_if(!session);
 
+    invalidate_cache_();
+
     // Session and address should be unique, forbid registering same
     // session or address twice.
     if (source_addr && address_route_map_.find(source_addr)) {
@@ -136,6 +152,8 @@ void ReceiverSessionRouter::remove_session(
     const core::SharedPtr<ReceiverSession>& session) {
     roc_panic_if(!session);
 
+    invalidate_cache_();
+
     SessionNode* node = session_route_map_.find(session);
     if (!node) {
         // Nothing to remove.
@@ -154,6 +172,8 @@ status::StatusCode ReceiverSessionRouter::link_source(packet::stream_source_t so
     roc_panic_if(!cname || !*cname);
     roc_panic_if(strlen(cname) > rtcp::MaxCnameLen);
 
+    invalidate_cache_();
+
     // Find routes for SSRC and CNAME.
     core::SharedPtr<Route> source_route, cname_route;
 
@@ -265,6 +285,8 @@ status::StatusCode ReceiverSessionRouter::link_source(packet::stream_source_t so
 }
 
 void ReceiverSessionRouter::unlink_source(packet::stream_source_t source_id) {
+    invalidate_cache_();
+
     // Find route for SSRC.
     SourceNode* node = source_route_map_.find(source_id);
     if (!node) {
@@ -457,7 +479,14 @@ void ReceiverSessionRouter::remove_route_(core::SharedPtr<Route> route) {
     route_list_.remove(*route);
 }
 
+void ReceiverSessionRouter::invalidate_cache_() {
+    last_source_node_ = NULL;
+    last_address_node_ = NULL;
+}
+
 void ReceiverSessionRouter::remove_all_routes_() {
+    invalidate_cache_();
+
     while (!route_list_.is_empty()) {
         remove_route_(route_list_.back());
     }
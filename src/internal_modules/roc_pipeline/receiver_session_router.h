@@ -56,6 +56,9 @@ namespace pipeline {
 //!    Session router will remember that these SSRCs are related and will route packets
 //!    from those streams to same session.
 //!
+//!    With redundancy, sender sends the same stream over two paths. Packets from both
+//!    paths have the same SSRC, hence they are routed to the same session as well.
+//!
 //!  - By source address.
 //!
 //!    As a fallback for the case when RTCP is not used, session router will assume that
@@ -64,6 +67,10 @@ namespace pipeline {
 //!    To make it work, sender should ensure that it sends all streams (audio, repair)
 //!    from the same socket, and that there are no proxies or retranslators that combine
 //!    multiple senders on the same socket.
+//!
+//! Both lookups are hash table lookups. In addition, router remembers the result of
+//! last successful lookup of each kind, because packets usually arrive in runs from
+//! the same sender. This cache is invalidated on every routing change.
 class ReceiverSessionRouter : public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -183,7 +190,7 @@ private:
         }
 
         static core::hashsum_t key_hash(const address::SocketAddr& source_addr) {
-            return core::hashsum_mem(source_addr.saddr(), (size_t)source_addr.slen());
+            return source_addr.hash();
         }
 
         static bool key_equal(const address::SocketAddr& source_addr1,
@@ -280,6 +287,8 @@ private:
         }
     };
 
+    void invalidate_cache_();
+
     status::StatusCode relink_source_(packet::stream_source_t source_id,
                                       const char* cname);
 
@@ -306,6 +315,11 @@ private:
     core::Hashmap<AddressNode, PreallocatedRoutes, core::NoOwnership> address_route_map_;
     core::Hashmap<CnameNode, PreallocatedRoutes, core::NoOwnership> cname_route_map_;
     core::Hashmap<SessionNode, PreallocatedRoutes, core::NoOwnership> session_route_map_;
+
+    // Last found nodes
+    // Reset when any mapping changes
+    SourceNode* last_source_node_;
+    AddressNode* last_address_node_;
 };
 
 } // namespace pipeline
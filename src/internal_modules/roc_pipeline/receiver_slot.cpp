@@ -17,20 +17,32 @@ ReceiverSlot::ReceiverSlot(const ReceiverSourceConfig& source_config,
                            const ReceiverSlotConfig& slot_config,
                            StateTracker& state_tracker,
                            audio::Mixer& mixer,
+                           audio::StageProfiler* stage_profiler,
+                           ClockGroupMap* clock_groups,
                            const rtp::EncodingMap& encoding_map,
                            packet::PacketFactory& packet_factory,
                            audio::FrameFactory& frame_factory,
+                           core::MemoryTracker& memory_tracker,
                            core::IArena& arena)
     : core::RefCounted<ReceiverSlot, core::ArenaAllocation>(arena)
     , encoding_map_(encoding_map)
+    , srtp_config_(source_config.common.srtp)
+    , enable_redundancy_(source_config.common.enable_redundancy)
+    , packet_factory_(packet_factory)
+    , control_interval_(source_config.common.control_interval)
+    , next_control_time_(0)
     , state_tracker_(state_tracker)
+    , stage_profiler_(stage_profiler)
     , session_group_(source_config,
                      slot_config,
                      state_tracker_,
                      mixer,
+                     stage_profiler,
+                     clock_groups,
                      encoding_map,
                      packet_factory,
                      frame_factory,
+                     memory_tracker,
                      arena)
     , valid_(false) {
     if (!session_group_.is_valid()) {
@@ -40,6 +52,8 @@ ReceiverSlot::ReceiverSlot(const ReceiverSourceConfig& source_config,
     roc_log(LogDebug, "receiver slot: initializing");
 
     valid_ = true;
+
+    publish_metrics_();
 }
 
 bool ReceiverSlot::is_valid() const {
@@ -57,6 +71,9 @@ ReceiverEndpoint* ReceiverSlot::add_endpoint(address::Interface iface,
 
     switch (iface) {
     case address::Iface_AudioSource:
+        if (source_endpoint_ && enable_redundancy_) {
+            return create_redundant_endpoint_(proto, inbound_address, outbound_writer);
+        }
         return create_source_endpoint_(proto, inbound_address, outbound_writer);
 
     case address::Iface_AudioRepair:
@@ -82,19 +99,48 @@ core::nanoseconds_t ReceiverSlot::refresh(core::nanoseconds_t current_time) {
         roc_panic_if(code != status::StatusOK);
     }
 
+    if (redundant_endpoint_) {
+        const status::StatusCode code = redundant_endpoint_->pull_packets(current_time);
+        // TODO(gh-183): forward status
+        roc_panic_if(code != status::StatusOK);
+    }
+
     if (repair_endpoint_) {
         const status::StatusCode code = repair_endpoint_->pull_packets(current_time);
         // TODO(gh-183): forward status
         roc_panic_if(code != status::StatusOK);
     }
 
+    {
+        // Packets routed to sessions by network thread, if enabled.
+        const status::StatusCode code = session_group_.pull_routed_packets(current_time);
+        // TODO(gh-183): forward status
+        roc_panic_if(code != status::StatusOK);
+    }
+
     if (control_endpoint_) {
         const status::StatusCode code = control_endpoint_->pull_packets(current_time);
         // TODO(gh-183): forward status
         roc_panic_if(code != status::StatusOK);
     }
 
-    return session_group_.refresh_sessions(current_time);
+    if (current_time < next_control_time_) {
+        return next_control_time_;
+    }
+
+    const core::nanoseconds_t deadline = session_group_.refresh_sessions(current_time);
+
+    publish_metrics_();
+
+    if (control_interval_ > 0) {
+        next_control_time_ = current_time + control_interval_;
+        if (deadline != 0 && deadline < next_control_time_) {
+            next_control_time_ = deadline;
+        }
+        return next_control_time_;
+    }
+
+    return deadline;
 }
 
 void ReceiverSlot::reclock(core::nanoseconds_t playback_time) {
@@ -103,12 +149,42 @@ void ReceiverSlot::reclock(core::nanoseconds_t playback_time) {
     session_group_.reclock_sessions(playback_time);
 }
 
+void ReceiverSlot::set_overload_level(OverloadLevel level) {
+    roc_panic_if(!is_valid());
+
+    session_group_.set_overload_level(level);
+}
+
+void ReceiverSlot::set_packet_capture(packet::CaptureRing* capture_ring) {
+    roc_panic_if(!is_valid());
+
+    session_group_.set_packet_capture(capture_ring);
+}
+
+bool ReceiverSlot::reconfigure(const ReceiverLiveConfig& live_config) {
+    roc_panic_if(!is_valid());
+
+    return session_group_.reconfigure(live_config);
+}
+
 size_t ReceiverSlot::num_sessions() const {
     roc_panic_if(!is_valid());
 
     return session_group_.num_sessions();
 }
 
+bool ReceiverSlot::has_ended_sessions() const {
+    roc_panic_if(!is_valid());
+
+    return session_group_.has_ended_sessions();
+}
+
+void ReceiverSlot::release_ended_sessions() {
+    roc_panic_if(!is_valid());
+
+    session_group_.release_ended_sessions();
+}
+
 void ReceiverSlot::get_metrics(ReceiverSlotMetrics& slot_metrics,
                                ReceiverParticipantMetrics* party_metrics,
                                size_t* party_count) const {
@@ -116,11 +192,40 @@ void ReceiverSlot::get_metrics(ReceiverSlotMetrics& slot_metrics,
 
     session_group_.get_slot_metrics(slot_metrics);
 
+    if (stage_profiler_) {
+        slot_metrics.stages = stage_profiler_->metrics();
+    }
+
+    if (source_endpoint_) {
+        slot_metrics.graph.source_endpoint = source_endpoint_->inbound_metrics();
+    }
+    if (repair_endpoint_) {
+        slot_metrics.graph.repair_endpoint = repair_endpoint_->inbound_metrics();
+    }
+    if (control_endpoint_) {
+        slot_metrics.graph.control_endpoint = control_endpoint_->inbound_metrics();
+    }
+
     if (party_metrics || party_count) {
         session_group_.get_participant_metrics(party_metrics, party_count);
     }
 }
 
+bool ReceiverSlot::load_metrics(ReceiverSlotMetrics& slot_metrics,
+                                ReceiverParticipantMetrics* party_metrics,
+                                size_t* party_count) const {
+    roc_panic_if(!is_valid());
+
+    return metrics_snapshot_.load(slot_metrics, party_metrics, party_count);
+}
+
+void ReceiverSlot::publish_metrics_() {
+    metrics_data_.party_count = ReceiverMetricsSnapshot::MaxParticipants;
+    get_metrics(metrics_data_.slot, metrics_data_.party, &metrics_data_.party_count);
+
+    metrics_snapshot_.publish(metrics_data_);
+}
+
 ReceiverEndpoint*
 ReceiverSlot::create_source_endpoint_(address::Protocol proto,
                                       const address::SocketAddr& inbound_address,
@@ -141,8 +246,8 @@ ReceiverSlot::create_source_endpoint_(address::Protocol proto,
     }
 
     source_endpoint_.reset(new (source_endpoint_) ReceiverEndpoint(
-        proto, state_tracker_, session_group_, encoding_map_, inbound_address,
-        outbound_writer, arena()));
+        proto, srtp_config_, state_tracker_, session_group_, encoding_map_,
+        inbound_address, outbound_writer, packet_factory_, arena()));
 
     if (!source_endpoint_ || !source_endpoint_->is_valid()) {
         roc_log(LogError, "receiver slot: can't create source endpoint");
@@ -153,6 +258,41 @@ ReceiverSlot::create_source_endpoint_(address::Protocol proto,
     return source_endpoint_.get();
 }
 
+ReceiverEndpoint*
+ReceiverSlot::create_redundant_endpoint_(address::Protocol proto,
+                                         const address::SocketAddr& inbound_address,
+                                         packet::IWriter* outbound_writer) {
+    if (redundant_endpoint_) {
+        roc_log(LogError,
+                "receiver slot: redundant audio source endpoint is already set");
+        return NULL;
+    }
+
+    // Both paths carry identical packets.
+    if (proto != source_endpoint_->proto()) {
+        roc_log(LogError,
+                "receiver slot: redundant audio source endpoint should use same"
+                " protocol as audio source endpoint: source=%s redundant=%s",
+                address::proto_to_str(source_endpoint_->proto()),
+                address::proto_to_str(proto));
+        return NULL;
+    }
+
+    // Packets from both endpoints are routed to the same session group,
+    // where they're matched to the same session by SSRC.
+    redundant_endpoint_.reset(new (redundant_endpoint_) ReceiverEndpoint(
+        proto, srtp_config_, state_tracker_, session_group_, encoding_map_,
+        inbound_address, outbound_writer, packet_factory_, arena()));
+
+    if (!redundant_endpoint_ || !redundant_endpoint_->is_valid()) {
+        roc_log(LogError, "receiver slot: can't create redundant source endpoint");
+        redundant_endpoint_.reset(NULL);
+        return NULL;
+    }
+
+    return redundant_endpoint_.get();
+}
+
 ReceiverEndpoint*
 ReceiverSlot::create_repair_endpoint_(address::Protocol proto,
                                       const address::SocketAddr& inbound_address,
@@ -173,8 +313,8 @@ ReceiverSlot::create_repair_endpoint_(address::Protocol proto,
     }
 
     repair_endpoint_.reset(new (repair_endpoint_) ReceiverEndpoint(
-        proto, state_tracker_, session_group_, encoding_map_, inbound_address,
-        outbound_writer, arena()));
+        proto, srtp_config_, state_tracker_, session_group_, encoding_map_,
+        inbound_address, outbound_writer, packet_factory_, arena()));
 
     if (!repair_endpoint_ || !repair_endpoint_->is_valid()) {
         roc_log(LogError, "receiver slot: can't create repair endpoint");
@@ -199,8 +339,8 @@ ReceiverSlot::create_control_endpoint_(address::Protocol proto,
     }
 
     control_endpoint_.reset(new (control_endpoint_) ReceiverEndpoint(
-        proto, state_tracker_, session_group_, encoding_map_, inbound_address,
-        outbound_writer, arena()));
+        proto, srtp_config_, state_tracker_, session_group_, encoding_map_,
+        inbound_address, outbound_writer, packet_factory_, arena()));
 
     if (!control_endpoint_ || !control_endpoint_->is_valid()) {
         roc_log(LogError, "receiver slot: can't create control endpoint");
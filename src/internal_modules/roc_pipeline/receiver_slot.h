@@ -16,11 +16,14 @@
 #include "roc_address/protocol.h"
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/mixer.h"
+#include "roc_audio/stage_profiler.h"
 #include "roc_core/iarena.h"
 #include "roc_core/list_node.h"
+#include "roc_core/memory_tracker.h"
 #include "roc_core/ref_counted.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/metrics.h"
+#include "roc_pipeline/metrics_snapshot.h"
 #include "roc_pipeline/receiver_endpoint.h"
 #include "roc_pipeline/receiver_session_group.h"
 #include "roc_pipeline/state_tracker.h"
@@ -34,6 +37,9 @@ namespace pipeline {
 //! Contains:
 //!  - one or more related receiver endpoints, one per each type
 //!  - one session group associated with those endpoints
+//!
+//! If redundancy is enabled, slot may have second source endpoint, which
+//! receives the same packets over another path.
 class ReceiverSlot : public core::RefCounted<ReceiverSlot, core::ArenaAllocation>,
                      public core::ListNode<> {
 public:
@@ -42,9 +48,12 @@ public:
                  const ReceiverSlotConfig& slot_config,
                  StateTracker& state_tracker,
                  audio::Mixer& mixer,
+                 audio::StageProfiler* stage_profiler,
+                 ClockGroupMap* clock_groups,
                  const rtp::EncodingMap& encoding_map,
                  packet::PacketFactory& packet_factory,
                  audio::FrameFactory& frame_factory,
+                 core::MemoryTracker& memory_tracker,
                  core::IArena& arena);
 
     //! Check if the slot was succefully constructed.
@@ -57,6 +66,9 @@ public:
                                    packet::IWriter* outbound_writer);
 
     //! Pull packets and refresh sessions according to current time.
+    //! @remarks
+    //!  Packets are pulled on every call. If control interval is configured,
+    //!  sessions are refreshed and metrics are published only when it expires.
     //! @returns
     //!  deadline (absolute time) when refresh should be invoked again
     //!  if there are no frames
@@ -68,18 +80,52 @@ public:
     //!  retrieved from pipeline will be actually played on sink
     void reclock(core::nanoseconds_t playback_time);
 
+    //! Apply quality degradation level to all sessions.
+    void set_overload_level(OverloadLevel level);
+
+    //! Capture packets of all sessions into given ring.
+    void set_packet_capture(packet::CaptureRing* capture_ring);
+
+    //! Change parameters of sessions on the fly.
+    //! @remarks
+    //!  Sessions created later get the same parameters.
+    ROC_ATTR_NODISCARD bool reconfigure(const ReceiverLiveConfig& live_config);
+
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Check if there are ended sessions not released yet.
+    bool has_ended_sessions() const;
+
+    //! Release resources of ended sessions.
+    void release_ended_sessions();
+
     //! Get metrics for slot and its participants.
     void get_metrics(ReceiverSlotMetrics& slot_metrics,
                      ReceiverParticipantMetrics* party_metrics,
                      size_t* party_count) const;
 
+    //! Get metrics for slot and its participants from last published snapshot.
+    //! @remarks
+    //!  Snapshot is published by pipeline thread once per refresh(), or once
+    //!  per control interval, if it's configured.
+    //!  Unlike get_metrics(), can be called from any thread and is lock-free.
+    //! @returns
+    //!  false if snapshot is not available; see MetricsSnapshot::load().
+    bool load_metrics(ReceiverSlotMetrics& slot_metrics,
+                      ReceiverParticipantMetrics* party_metrics,
+                      size_t* party_count) const;
+
 private:
+    void publish_metrics_();
+
     ReceiverEndpoint* create_source_endpoint_(address::Protocol proto,
                                               const address::SocketAddr& inbound_address,
                                               packet::IWriter* outbound_writer);
+    ReceiverEndpoint*
+    create_redundant_endpoint_(address::Protocol proto,
+                               const address::SocketAddr& inbound_address,
+                               packet::IWriter* outbound_writer);
     ReceiverEndpoint* create_repair_endpoint_(address::Protocol proto,
                                               const address::SocketAddr& inbound_address,
                                               packet::IWriter* outbound_writer);
@@ -88,14 +134,26 @@ private:
                                                packet::IWriter* outbound_writer);
 
     const rtp::EncodingMap& encoding_map_;
+    const rtp::SrtpConfig srtp_config_;
+    const bool enable_redundancy_;
+    packet::PacketFactory& packet_factory_;
+
+    const core::nanoseconds_t control_interval_;
+    core::nanoseconds_t next_control_time_;
 
     StateTracker& state_tracker_;
+    const audio::StageProfiler* stage_profiler_;
     ReceiverSessionGroup session_group_;
 
     core::Optional<ReceiverEndpoint> source_endpoint_;
+    // Second source endpoint, if redundancy is enabled.
+    core::Optional<ReceiverEndpoint> redundant_endpoint_;
     core::Optional<ReceiverEndpoint> repair_endpoint_;
     core::Optional<ReceiverEndpoint> control_endpoint_;
 
+    ReceiverMetricsSnapshot::Data metrics_data_;
+    ReceiverMetricsSnapshot metrics_snapshot_;
+
     bool valid_;
 };
 
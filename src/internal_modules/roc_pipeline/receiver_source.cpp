@@ -7,8 +7,10 @@
  */
 
 #include "roc_pipeline/receiver_source.h"
+#include "roc_core/fast_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace pipeline {
@@ -18,25 +20,60 @@ ReceiverSource::ReceiverSource(const ReceiverSourceConfig& source_config,
                                core::IPool& packet_pool,
                                core::IPool& packet_buffer_pool,
                                core::IPool& frame_buffer_pool,
-                               core::IArena& arena)
+                               core::IArena& arena,
+                               core::MemoryTracker* memory_tracker)
     : source_config_(source_config)
     , encoding_map_(encoding_map)
     , packet_factory_(packet_pool, packet_buffer_pool)
     , frame_factory_(frame_buffer_pool)
     , arena_(arena)
+    , memory_tracker_(memory_tracker)
+    , capture_ring_(NULL)
     , frame_reader_(NULL)
     , valid_(false) {
     source_config_.deduce_defaults();
 
     audio::IFrameReader* frm_reader = NULL;
 
+    if (source_config_.common.enable_stage_profiling) {
+        stage_profiler_.reset(new (stage_profiler_) audio::StageProfiler());
+        if (!stage_profiler_) {
+            return;
+        }
+    }
+
+    if (source_config_.common.session_threads != 0) {
+        session_workers_.reset(new (session_workers_) core::WorkerPool(
+            source_config_.common.session_threads, arena_));
+        if (!session_workers_ || !session_workers_->is_valid()) {
+            return;
+        }
+    }
+
+    if (source_config_.common.enable_clock_groups) {
+        clock_groups_.reset(new (clock_groups_) ClockGroupMap(arena_));
+        if (!clock_groups_) {
+            return;
+        }
+    }
+
     mixer_.reset(new (mixer_) audio::Mixer(
-        frame_factory_, source_config.common.output_sample_spec, true));
+        frame_factory_, source_config.common.output_sample_spec, true,
+        source_config_.common.mixer, session_workers_.get(), arena_));
     if (!mixer_ || !mixer_->is_valid()) {
         return;
     }
     frm_reader = mixer_.get();
 
+    if (stage_profiler_) {
+        mixer_profiler_.reset(new (mixer_profiler_) audio::StageProfilingReader(
+            *frm_reader, *stage_profiler_, audio::ProfilerStage_Mixer));
+        if (!mixer_profiler_) {
+            return;
+        }
+        frm_reader = mixer_profiler_.get();
+    }
+
     if (!source_config_.common.output_sample_spec.is_raw()) {
         const audio::SampleSpec in_spec(
             source_config_.common.output_sample_spec.sample_rate(),
@@ -50,6 +87,16 @@ ReceiverSource::ReceiverSource(const ReceiverSourceConfig& source_config,
             return;
         }
         frm_reader = pcm_mapper_.get();
+
+        if (stage_profiler_) {
+            pcm_mapper_profiler_.reset(
+                new (pcm_mapper_profiler_) audio::StageProfilingReader(
+                    *frm_reader, *stage_profiler_, audio::ProfilerStage_PcmMapper));
+            if (!pcm_mapper_profiler_) {
+                return;
+            }
+            frm_reader = pcm_mapper_profiler_.get();
+        }
     }
 
     if (source_config_.common.enable_profiling) {
@@ -66,6 +113,11 @@ ReceiverSource::ReceiverSource(const ReceiverSourceConfig& source_config,
         return;
     }
 
+    if (source_config_.common.enable_overload_control) {
+        overload_controller_.reset(new (overload_controller_) OverloadController(
+            source_config_.common.overload_control));
+    }
+
     frame_reader_ = frm_reader;
     valid_ = true;
 }
@@ -74,6 +126,26 @@ bool ReceiverSource::is_valid() const {
     return valid_;
 }
 
+void ReceiverSource::add_small_frame_buffer_pool(core::IPool& buffer_pool) {
+    roc_panic_if(!is_valid());
+
+    if (!slots_.is_empty()) {
+        roc_panic("receiver source: can't add buffer pool when there are slots");
+    }
+
+    frame_factory_.add_small_buffer_pool(buffer_pool);
+}
+
+void ReceiverSource::set_packet_capture(packet::CaptureRing& capture_ring) {
+    roc_panic_if(!is_valid());
+
+    if (!slots_.is_empty()) {
+        roc_panic("receiver source: can't set packet capture when there are slots");
+    }
+
+    capture_ring_ = &capture_ring;
+}
+
 ReceiverSlot* ReceiverSource::create_slot(const ReceiverSlotConfig& slot_config) {
     roc_panic_if(!is_valid());
 
@@ -81,13 +153,23 @@ ReceiverSlot* ReceiverSource::create_slot(const ReceiverSlotConfig& slot_config)
 
     core::SharedPtr<ReceiverSlot> slot =
         new (arena_) ReceiverSlot(source_config_, slot_config, state_tracker_, *mixer_,
-                                  encoding_map_, packet_factory_, frame_factory_, arena_);
+                                  stage_profiler_.get(), clock_groups_.get(),
+                                  encoding_map_, packet_factory_, frame_factory_,
+                                  memory_tracker_, arena_);
 
     if (!slot || !slot->is_valid()) {
         roc_log(LogError, "receiver source: can't create slot");
         return NULL;
     }
 
+    if (overload_controller_) {
+        slot->set_overload_level(overload_controller_->level());
+    }
+
+    if (capture_ring_) {
+        slot->set_packet_capture(capture_ring_);
+    }
+
     slots_.push_back(*slot);
     return slot.get();
 }
@@ -104,6 +186,28 @@ size_t ReceiverSource::num_sessions() const {
     return state_tracker_.num_active_sessions();
 }
 
+bool ReceiverSource::has_ended_sessions() const {
+    roc_panic_if(!is_valid());
+
+    for (core::SharedPtr<ReceiverSlot> slot = slots_.front(); slot;
+         slot = slots_.nextof(*slot)) {
+        if (slot->has_ended_sessions()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ReceiverSource::release_ended_sessions() {
+    roc_panic_if(!is_valid());
+
+    for (core::SharedPtr<ReceiverSlot> slot = slots_.front(); slot;
+         slot = slots_.nextof(*slot)) {
+        slot->release_ended_sessions();
+    }
+}
+
 core::nanoseconds_t ReceiverSource::refresh(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
@@ -112,6 +216,10 @@ core::nanoseconds_t ReceiverSource::refresh(core::nanoseconds_t current_time) {
                      " expected positive value, got %lld",
                      (long long)current_time);
 
+    // Sessions that weren't released since previous refresh are released here
+    // as a fallback, so that they don't accumulate if nobody else does it.
+    release_ended_sessions();
+
     core::nanoseconds_t next_deadline = 0;
 
     for (core::SharedPtr<ReceiverSlot> slot = slots_.front(); slot;
@@ -127,9 +235,46 @@ core::nanoseconds_t ReceiverSource::refresh(core::nanoseconds_t current_time) {
         }
     }
 
+    if (clock_groups_) {
+        clock_groups_->remove_unused();
+    }
+
     return next_deadline;
 }
 
+const audio::StageProfiler* ReceiverSource::stage_profiler() const {
+    roc_panic_if(!is_valid());
+
+    return stage_profiler_.get();
+}
+
+audio::ProfilerMetrics ReceiverSource::profiler_metrics() const {
+    roc_panic_if(!is_valid());
+
+    if (!profiler_) {
+        return audio::ProfilerMetrics();
+    }
+
+    return profiler_->metrics();
+}
+
+core::OccupancyMetrics ReceiverSource::mixer_metrics() const {
+    roc_panic_if(!is_valid());
+
+    return mixer_->metrics();
+}
+
+bool ReceiverSource::collect_stage_times(core::nanoseconds_t* stage_times) {
+    roc_panic_if(!is_valid());
+
+    if (!stage_profiler_) {
+        return false;
+    }
+
+    stage_profiler_->collect_times(stage_times);
+    return true;
+}
+
 sndio::ISink* ReceiverSource::to_sink() {
     return NULL;
 }
@@ -191,7 +336,35 @@ void ReceiverSource::reclock(core::nanoseconds_t playback_time) {
 bool ReceiverSource::read(audio::Frame& frame) {
     roc_panic_if(!is_valid());
 
-    return frame_reader_->read(frame);
+    if (!overload_controller_) {
+        return frame_reader_->read(frame);
+    }
+
+    const core::nanoseconds_t start_time = core::fast_timestamp();
+
+    if (!frame_reader_->read(frame)) {
+        return false;
+    }
+
+    const core::nanoseconds_t proc_time = core::fast_timestamp() - start_time;
+    const core::nanoseconds_t frame_duration =
+        source_config_.common.output_sample_spec.stream_timestamp_2_ns(frame.duration());
+
+    if (overload_controller_->report_frame(proc_time, frame_duration)) {
+        // Level changed, apply it to all slots.
+        for (core::SharedPtr<ReceiverSlot> slot = slots_.front(); slot;
+             slot = slots_.nextof(*slot)) {
+            slot->set_overload_level(overload_controller_->level());
+        }
+    }
+
+    return true;
+}
+
+bool ReceiverSource::wait_active(core::nanoseconds_t deadline) {
+    roc_panic_if(!is_valid());
+
+    return state_tracker_.wait_active(deadline);
 }
 
 } // namespace pipeline
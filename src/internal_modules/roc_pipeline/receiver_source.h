@@ -17,11 +17,17 @@
 #include "roc_audio/mixer.h"
 #include "roc_audio/pcm_mapper_reader.h"
 #include "roc_audio/profiling_reader.h"
+#include "roc_audio/stage_profiler.h"
+#include "roc_audio/stage_profiling_reader.h"
 #include "roc_core/iarena.h"
+#include "roc_core/memory_tracker.h"
 #include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/worker_pool.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_pipeline/clock_group_map.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/overload_controller.h"
 #include "roc_pipeline/receiver_endpoint.h"
 #include "roc_pipeline/receiver_slot.h"
 #include "roc_pipeline/state_tracker.h"
@@ -43,16 +49,32 @@ namespace pipeline {
 class ReceiverSource : public sndio::ISource, public core::NonCopyable<> {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p memory_tracker is not NULL, memory of slots and sessions is
+    //!  additionally accounted in it, e.g. to sum up receivers of a context.
     ReceiverSource(const ReceiverSourceConfig& source_config,
                    const rtp::EncodingMap& encoding_map,
                    core::IPool& packet_pool,
                    core::IPool& packet_buffer_pool,
                    core::IPool& frame_buffer_pool,
-                   core::IArena& arena);
+                   core::IArena& arena,
+                   core::MemoryTracker* memory_tracker = NULL);
 
     //! Check if the pipeline was successfully constructed.
     bool is_valid() const;
 
+    //! Add pool for smaller frame buffers.
+    //! @remarks
+    //!  See audio::FrameFactory::add_small_buffer_pool().
+    //!  Should be called before any slot is created.
+    void add_small_frame_buffer_pool(core::IPool& buffer_pool);
+
+    //! Set packet capture ring.
+    //! @remarks
+    //!  Sessions capture packets after FEC repair into the ring.
+    //!  Should be called before creating slots.
+    void set_packet_capture(packet::CaptureRing& capture_ring);
+
     //! Create slot.
     ReceiverSlot* create_slot(const ReceiverSlotConfig& slot_config);
 
@@ -62,6 +84,17 @@ public:
     //! Get number of active sessions.
     size_t num_sessions() const;
 
+    //! Check if there are ended sessions not released yet.
+    bool has_ended_sessions() const;
+
+    //! Release resources of ended sessions.
+    //! @remarks
+    //!  Ended sessions are detached from pipeline immediately, but their
+    //!  resources are released by this method, so that the caller can do it
+    //!  outside of frame processing. If it wasn't called, sessions that ended
+    //!  before previous refresh() are released in the next refresh().
+    void release_ended_sessions();
+
     //! Pull packets and refresh pipeline according to current time.
     //! @remarks
     //!  Should be invoked before reading each frame.
@@ -72,6 +105,27 @@ public:
     //!  if there are no frames
     core::nanoseconds_t refresh(core::nanoseconds_t current_time);
 
+    //! Get stage profiler.
+    //! @remarks
+    //!  Returns NULL if stage profiling is disabled. Returned profiler can be
+    //!  queried or dumped from any thread.
+    const audio::StageProfiler* stage_profiler() const;
+
+    //! Get profiler metrics.
+    //! @remarks
+    //!  Returns zero metrics if profiling is disabled.
+    audio::ProfilerMetrics profiler_metrics() const;
+
+    //! Get occupancy of mixer.
+    core::OccupancyMetrics mixer_metrics() const;
+
+    //! Get time spent in each stage since previous call.
+    //! @remarks
+    //!  Should be called from pipeline thread.
+    //! @returns
+    //!  false if stage profiling is disabled.
+    bool collect_stage_times(core::nanoseconds_t* stage_times);
+
     //! Cast IDevice to ISink.
     virtual sndio::ISink* to_sink();
 
@@ -114,6 +168,14 @@ public:
     //! Read audio frame.
     virtual bool read(audio::Frame&);
 
+    //! Block until receiver becomes active or deadline expires.
+    //! @remarks
+    //!  Receiver becomes active when a session exists or a packet arrives.
+    //!  Unlike other methods, doesn't require pipeline lock.
+    //! @returns
+    //!  true if receiver is active.
+    bool wait_active(core::nanoseconds_t deadline);
+
 private:
     ReceiverSourceConfig source_config_;
 
@@ -123,14 +185,25 @@ private:
     audio::FrameFactory frame_factory_;
     core::IArena& arena_;
 
+    core::MemoryTracker memory_tracker_;
+
     StateTracker state_tracker_;
 
+    core::Optional<core::WorkerPool> session_workers_;
+    core::Optional<ClockGroupMap> clock_groups_;
+    core::Optional<audio::StageProfiler> stage_profiler_;
     core::Optional<audio::Mixer> mixer_;
+    core::Optional<audio::StageProfilingReader> mixer_profiler_;
     core::Optional<audio::ProfilingReader> profiler_;
     core::Optional<audio::PcmMapperReader> pcm_mapper_;
+    core::Optional<audio::StageProfilingReader> pcm_mapper_profiler_;
+
+    core::Optional<OverloadController> overload_controller_;
 
     core::List<ReceiverSlot> slots_;
 
+    packet::CaptureRing* capture_ring_;
+
     audio::IFrameReader* frame_reader_;
 
     bool valid_;
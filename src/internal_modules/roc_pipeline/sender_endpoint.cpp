@@ -19,6 +19,8 @@ namespace roc {
 namespace pipeline {
 
 SenderEndpoint::SenderEndpoint(address::Protocol proto,
+                               const rtp::SrtpConfig& srtp_config,
+                               bool enable_rapid_sync,
                                StateTracker& state_tracker,
                                SenderSession& sender_session,
                                const address::SocketAddr& outbound_address,
@@ -35,9 +37,13 @@ SenderEndpoint::SenderEndpoint(address::Protocol proto,
 
     switch (proto) {
     case address::Proto_RTP:
+    case address::Proto_RTP_Shm:
+    case address::Proto_SRTP:
     case address::Proto_RTP_LDPC_Source:
     case address::Proto_RTP_RS8M_Source:
-        rtp_composer_.reset(new (rtp_composer_) rtp::Composer(NULL));
+    case address::Proto_RTP_RLC_Source:
+        rtp_composer_.reset(new (rtp_composer_)
+                                rtp::Composer(NULL, enable_rapid_sync));
         if (!rtp_composer_) {
             return;
         }
@@ -90,6 +96,54 @@ SenderEndpoint::SenderEndpoint(address::Protocol proto,
         }
         composer = fec_composer_.get();
         break;
+    case address::Proto_RTP_RLC_Source:
+        fec_composer_.reset(
+            new (arena)
+                fec::Composer<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(
+                    composer),
+            arena);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    case address::Proto_RLC_Repair:
+        fec_composer_.reset(
+            new (arena)
+                fec::Composer<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(
+                    composer),
+            arena);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    default:
+        break;
+    }
+
+    switch (proto) {
+    case address::Proto_SRTP:
+        if (srtp_config.suite == rtp::Srtp_None) {
+            roc_log(LogError, "sender endpoint: srtp key is required by protocol %s",
+                    address::proto_to_str(proto));
+            return;
+        }
+#ifdef ROC_TARGET_OPENSSL
+        // Encrypts packets composed by rtp composer, in the same buffer.
+        srtp_composer_.reset(new (srtp_composer_)
+                                 rtp::SrtpComposer(srtp_config, *composer));
+        if (!srtp_composer_ || !srtp_composer_->is_valid()) {
+            return;
+        }
+        composer = srtp_composer_.get();
+        break;
+#else
+        roc_log(LogError,
+                "sender endpoint: protocol %s is not supported: built without openssl",
+                address::proto_to_str(proto));
+        return;
+#endif // ROC_TARGET_OPENSSL
     default:
         break;
     }
@@ -160,6 +214,12 @@ packet::IWriter& SenderEndpoint::outbound_writer() {
     return *shipper_;
 }
 
+uint64_t SenderEndpoint::num_dropped_repair() const {
+    roc_panic_if(!is_valid());
+
+    return shipper_->num_dropped_repair();
+}
+
 packet::IWriter* SenderEndpoint::inbound_writer() {
     roc_panic_if(!is_valid());
 
@@ -184,6 +244,8 @@ status::StatusCode SenderEndpoint::pull_packets(core::nanoseconds_t current_time
     // queue were added in a very short time or are being added currently. It's
     // acceptable to consider such packets late and pull them next time.
     while (packet::PacketPtr packet = inbound_queue_.try_pop_front_exclusive()) {
+        packet->make_local();
+
         if (!parser_->parse(*packet, packet->buffer())) {
             roc_log(LogDebug, "sender endpoint: can't parse packet");
             continue;
@@ -208,6 +270,7 @@ status::StatusCode SenderEndpoint::write(const packet::PacketPtr& packet) {
     roc_panic_if(!parser_);
 
     state_tracker_.add_pending_packets(+1);
+    packet->make_shared();
     inbound_queue_.push_back(*packet);
 
     return status::StatusOK;
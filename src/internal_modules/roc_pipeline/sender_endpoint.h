@@ -27,6 +27,11 @@
 #include "roc_rtcp/composer.h"
 #include "roc_rtcp/parser.h"
 #include "roc_rtp/composer.h"
+#include "roc_rtp/srtp_config.h"
+
+#ifdef ROC_TARGET_OPENSSL
+#include "roc_rtp/srtp_composer.h"
+#endif // ROC_TARGET_OPENSSL
 
 namespace roc {
 namespace pipeline {
@@ -40,11 +45,15 @@ class SenderSession;
 class SenderEndpoint : public core::NonCopyable<>, private packet::IWriter {
 public:
     //! Initialize.
+    //!  - @p srtp_config specifies keys for SRTP protocol
+    //!  - @p enable_rapid_sync enables capture time extension in RTP headers
     //!  - @p outbound_address specifies destination address that is assigned to the
     //!    outgoing packets in the end of endpoint pipeline
     //!  - @p outbound_writer specifies destination writer to which packets are sent
     //!    in the end of endpoint pipeline
     SenderEndpoint(address::Protocol proto,
+                   const rtp::SrtpConfig& srtp_config,
+                   bool enable_rapid_sync,
                    StateTracker& state_tracker,
                    SenderSession& sender_session,
                    const address::SocketAddr& outbound_address,
@@ -73,6 +82,10 @@ public:
     //!  and writes them to outbound writers of endpoints.
     packet::IWriter& outbound_writer();
 
+    //! Get number of outbound repair packets dropped because of overloaded
+    //! send queue.
+    uint64_t num_dropped_repair() const;
+
     //! Get writer for inbound packets.
     //! This way feedback packets from receiver reach sender pipeline.
     //! @remarks
@@ -106,6 +119,9 @@ private:
     packet::IComposer* composer_;
     core::Optional<rtp::Composer> rtp_composer_;
     core::ScopedPtr<packet::IComposer> fec_composer_;
+#ifdef ROC_TARGET_OPENSSL
+    core::Optional<rtp::SrtpComposer> srtp_composer_;
+#endif // ROC_TARGET_OPENSSL
     core::Optional<rtcp::Composer> rtcp_composer_;
     core::Optional<packet::Shipper> shipper_;
 
@@ -8,6 +8,7 @@
 
 #include "roc_pipeline/sender_loop.h"
 #include "roc_audio/resampler_map.h"
+#include "roc_core/cached_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/thread.h"
@@ -16,12 +17,24 @@
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+// Pipeline loop parameters may be adjusted by config profile (e.g. low-latency).
+PipelineLoopConfig make_loop_config(const SenderSinkConfig& sink_config) {
+    SenderSinkConfig deduced_config = sink_config;
+    deduced_config.deduce_defaults();
+    return deduced_config.pipeline_loop;
+}
+
+} // namespace
+
 SenderLoop::Task::Task()
     : func_(NULL)
     , slot_(NULL)
     , iface_(address::Iface_Invalid)
     , proto_(address::Proto_None)
     , outbound_writer_(NULL)
+    , path_mtu_(0)
     , inbound_writer_(NULL)
     , slot_metrics_(NULL)
     , party_metrics_(NULL)
@@ -30,6 +43,7 @@ SenderLoop::Task::Task()
 
 SenderLoop::Tasks::CreateSlot::CreateSlot(const SenderSlotConfig& slot_config) {
     func_ = &SenderLoop::task_create_slot_;
+    set_name("create_slot");
     slot_config_ = slot_config;
 }
 
@@ -43,6 +57,7 @@ SenderLoop::SlotHandle SenderLoop::Tasks::CreateSlot::get_handle() const {
 
 SenderLoop::Tasks::DeleteSlot::DeleteSlot(SlotHandle slot) {
     func_ = &SenderLoop::task_delete_slot_;
+    set_name("delete_slot");
     if (!slot) {
         roc_panic("sender loop: slot handle is null");
     }
@@ -54,6 +69,7 @@ SenderLoop::Tasks::QuerySlot::QuerySlot(SlotHandle slot,
                                         SenderParticipantMetrics* party_metrics,
                                         size_t* party_count) {
     func_ = &SenderLoop::task_query_slot_;
+    set_name("query_slot");
     if (!slot) {
         roc_panic("sender loop: slot handle is null");
     }
@@ -63,12 +79,25 @@ SenderLoop::Tasks::QuerySlot::QuerySlot(SlotHandle slot,
     party_count_ = party_count;
 }
 
+SenderLoop::Tasks::ReconfigureSlot::ReconfigureSlot(SlotHandle slot,
+                                                    const SenderLiveConfig& live_config) {
+    func_ = &SenderLoop::task_reconfigure_slot_;
+    set_name("reconfigure_slot");
+    if (!slot) {
+        roc_panic("sender loop: slot handle is null");
+    }
+    slot_ = (SenderSlot*)slot;
+    live_config_ = live_config;
+}
+
 SenderLoop::Tasks::AddEndpoint::AddEndpoint(SlotHandle slot,
                                             address::Interface iface,
                                             address::Protocol proto,
                                             const address::SocketAddr& outbound_address,
-                                            packet::IWriter& outbound_writer) {
+                                            packet::IWriter& outbound_writer,
+                                            size_t path_mtu) {
     func_ = &SenderLoop::task_add_endpoint_;
+    set_name("add_endpoint");
     if (!slot) {
         roc_panic("sender loop: slot handle is null");
     }
@@ -77,6 +106,7 @@ SenderLoop::Tasks::AddEndpoint::AddEndpoint(SlotHandle slot,
     proto_ = proto;
     outbound_address_ = outbound_address;
     outbound_writer_ = &outbound_writer;
+    path_mtu_ = path_mtu;
 }
 
 packet::IWriter* SenderLoop::Tasks::AddEndpoint::get_inbound_writer() const {
@@ -92,15 +122,19 @@ SenderLoop::SenderLoop(IPipelineTaskScheduler& scheduler,
                        core::IPool& packet_pool,
                        core::IPool& packet_buffer_pool,
                        core::IPool& frame_buffer_pool,
-                       core::IArena& arena)
-    : PipelineLoop(scheduler, sink_config.pipeline_loop, sink_config.input_sample_spec)
+                       core::IArena& arena,
+                       FecGroupMap* fec_groups)
+    : PipelineLoop(
+        scheduler, make_loop_config(sink_config), sink_config.input_sample_spec)
     , sink_(sink_config,
             encoding_map,
             packet_pool,
             packet_buffer_pool,
             frame_buffer_pool,
-            arena)
+            arena,
+            fec_groups)
     , ticker_ts_(0)
+    , ticker_metrics_(core::TickerMetrics())
     , auto_duration_(sink_config.enable_auto_duration)
     , auto_cts_(sink_config.enable_auto_cts)
     , sample_spec_(sink_config.input_sample_spec)
@@ -111,7 +145,8 @@ SenderLoop::SenderLoop(IPipelineTaskScheduler& scheduler,
 
     if (sink_config.enable_timing) {
         ticker_.reset(new (ticker_)
-                          core::Ticker(sink_config.input_sample_spec.sample_rate()));
+                          core::Ticker(sink_config.input_sample_spec.sample_rate(),
+                                       sink_config.timing_spin_window));
         if (!ticker_) {
             return;
         }
@@ -130,6 +165,26 @@ sndio::ISink& SenderLoop::sink() {
     return *this;
 }
 
+void SenderLoop::add_small_frame_buffer_pool(core::IPool& buffer_pool) {
+    roc_panic_if_not(is_valid());
+
+    core::Mutex::Lock lock(sink_mutex_);
+
+    sink_.add_small_frame_buffer_pool(buffer_pool);
+}
+
+bool SenderLoop::load_slot_metrics(SlotHandle slot_handle,
+                                   SenderSlotMetrics& slot_metrics,
+                                   SenderParticipantMetrics* party_metrics,
+                                   size_t* party_count) const {
+    roc_panic_if_not(is_valid());
+
+    roc_panic_if(!slot_handle);
+
+    const SenderSlot* slot = (const SenderSlot*)slot_handle;
+    return slot->load_metrics(slot_metrics, party_metrics, party_count);
+}
+
 sndio::ISink* SenderLoop::to_sink() {
     roc_panic_if(!is_valid());
 
@@ -185,9 +240,9 @@ bool SenderLoop::restart() {
 audio::SampleSpec SenderLoop::sample_spec() const {
     roc_panic_if_not(is_valid());
 
-    core::Mutex::Lock lock(sink_mutex_);
-
-    return sink_.sample_spec();
+    // Sample spec never changes, so we don't need to lock sink mutex,
+    // which may be held by write() for the whole frame duration.
+    return sample_spec_;
 }
 
 core::nanoseconds_t SenderLoop::latency() const {
@@ -228,7 +283,7 @@ void SenderLoop::write(audio::Frame& frame) {
         if (frame.capture_timestamp() != 0) {
             roc_panic("sender loop: unexpected non-zero cts in auto-cts mode");
         }
-        frame.set_capture_timestamp(core::timestamp(core::ClockUnix));
+        frame.set_capture_timestamp(core::timestamp(core::ClockMedia));
     }
 
     core::Mutex::Lock lock(sink_mutex_);
@@ -236,6 +291,7 @@ void SenderLoop::write(audio::Frame& frame) {
     if (ticker_) {
         ticker_->wait(ticker_ts_);
         ticker_ts_ += frame.duration();
+        ticker_metrics_.exclusive_store(ticker_->metrics());
     }
 
     // invokes process_subframe_imp() and process_task_imp()
@@ -253,10 +309,14 @@ uint64_t SenderLoop::tid_imp() const {
 }
 
 bool SenderLoop::process_subframe_imp(audio::Frame& frame) {
+    // Code invoked below reads current time via CachedClock, so clocks
+    // are read once per sub-frame instead of once per packet.
+    core::CachedClock::Scope clock_scope;
+
     sink_.write(frame);
 
     // TODO: handle returned deadline and schedule refresh
-    sink_.refresh(core::timestamp(core::ClockUnix));
+    sink_.refresh(core::CachedClock::now(core::ClockMedia));
 
     return true;
 }
@@ -285,14 +345,24 @@ bool SenderLoop::task_query_slot_(Task& task) {
     roc_panic_if(!task.slot_metrics_);
 
     task.slot_->get_metrics(*task.slot_metrics_, task.party_metrics_, task.party_count_);
+    task.slot_metrics_->timing = ticker_metrics_.wait_load();
+    task.slot_metrics_->frame_overruns = num_frame_overruns();
+    task.slot_metrics_->profiler = sink_.profiler_metrics();
     return true;
 }
 
+bool SenderLoop::task_reconfigure_slot_(Task& task) {
+    roc_panic_if(!task.slot_);
+
+    return task.slot_->reconfigure(task.live_config_);
+}
+
 bool SenderLoop::task_add_endpoint_(Task& task) {
     roc_panic_if(!task.slot_);
 
-    SenderEndpoint* endpoint = task.slot_->add_endpoint(
-        task.iface_, task.proto_, task.outbound_address_, *task.outbound_writer_);
+    SenderEndpoint* endpoint =
+        task.slot_->add_endpoint(task.iface_, task.proto_, task.outbound_address_,
+                                 *task.outbound_writer_, task.path_mtu_);
     if (!endpoint) {
         return false;
     }
@@ -15,8 +15,10 @@
 #include "roc_core/iarena.h"
 #include "roc_core/ipool.h"
 #include "roc_core/mutex.h"
+#include "roc_core/seqlock.h"
 #include "roc_core/ticker.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/fec_group_map.h"
 #include "roc_pipeline/metrics.h"
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_pipeline/sender_sink.h"
@@ -57,10 +59,12 @@ public:
 
         SenderSlot* slot_;                        //!< Slot.
         SenderSlotConfig slot_config_;            //!< Slot config.
+        SenderLiveConfig live_config_;            //!< Live config.
         address::Interface iface_;                //!< Interface.
         address::Protocol proto_;                 //!< Protocol.
         address::SocketAddr outbound_address_;    //!< Destination address.
         packet::IWriter* outbound_writer_;        //!< Destination packet writer.
+        size_t path_mtu_;                         //!< Destination path MTU.
         packet::IWriter* inbound_writer_;         //!< Inbound packet writer.
         SenderSlotMetrics* slot_metrics_;         //!< Output slot metrics.
         SenderParticipantMetrics* party_metrics_; //!< Output participant metrics.
@@ -99,6 +103,13 @@ public:
                       size_t* party_count);
         };
 
+        //! Change parameters of slot session without restarting it.
+        class ReconfigureSlot : public Task {
+        public:
+            //! Set task parameters.
+            ReconfigureSlot(SlotHandle slot, const SenderLiveConfig& live_config);
+        };
+
         //! Create endpoint on given interface of the slot.
         class AddEndpoint : public Task {
         public:
@@ -106,11 +117,14 @@ public:
             //! @remarks
             //!  Each slot can have one source and zero or one repair endpoint.
             //!  The protocols of endpoints in one slot should be compatible.
+            //!  @p path_mtu is MTU of path towards @p outbound_address, or zero
+            //!  if it's unknown.
             AddEndpoint(SlotHandle slot,
                         address::Interface iface,
                         address::Protocol proto,
                         const address::SocketAddr& outbound_address,
-                        packet::IWriter& outbound_writer);
+                        packet::IWriter& outbound_writer,
+                        size_t path_mtu = 0);
 
             //! Get packet writer for inbound packets for the endpoint.
             //! @remarks
@@ -120,13 +134,16 @@ public:
     };
 
     //! Initialize.
+    //! @remarks
+    //!  @p fec_groups is passed to SenderSink.
     SenderLoop(IPipelineTaskScheduler& scheduler,
                const SenderSinkConfig& sink_config,
                const rtp::EncodingMap& encoding_map,
                core::IPool& packet_pool,
                core::IPool& packet_buffer_pool,
                core::IPool& frame_buffer_pool,
-               core::IArena& arena);
+               core::IArena& arena,
+               FecGroupMap* fec_groups = NULL);
 
     //! Check if the pipeline was successfully constructed.
     bool is_valid() const;
@@ -136,6 +153,25 @@ public:
     //!  Samples written to the sink are sent to remote peers.
     sndio::ISink& sink();
 
+    //! Add pool for smaller frame buffers.
+    //! @remarks
+    //!  See SenderSink::add_small_frame_buffer_pool().
+    //!  Should be called before pipeline is used.
+    void add_small_frame_buffer_pool(core::IPool& buffer_pool);
+
+    //! Get slot metrics without scheduling a task.
+    //! @remarks
+    //!  Reads snapshot that is published by pipeline once per frame. Lock-free,
+    //!  doesn't block pipeline thread and may be called from any thread. The
+    //!  caller should ensure that the slot is not deleted concurrently.
+    //! @returns
+    //!  false if snapshot is not available (e.g. it can't hold requested number
+    //!  of participants); in this case Tasks::QuerySlot should be used.
+    bool load_slot_metrics(SlotHandle slot,
+                           SenderSlotMetrics& slot_metrics,
+                           SenderParticipantMetrics* party_metrics,
+                           size_t* party_count) const;
+
 private:
     // Methods of sndio::ISink
     virtual sndio::ISink* to_sink();
@@ -161,6 +197,7 @@ private:
     bool task_create_slot_(Task&);
     bool task_delete_slot_(Task&);
     bool task_query_slot_(Task&);
+    bool task_reconfigure_slot_(Task&);
     bool task_add_endpoint_(Task&);
 
     SenderSink sink_;
@@ -168,6 +205,8 @@ private:
 
     core::Optional<core::Ticker> ticker_;
     core::Ticker::ticks_t ticker_ts_;
+    // Copy of ticker metrics, updated under sink_mutex_, read by tasks.
+    core::Seqlock<core::TickerMetrics> ticker_metrics_;
 
     const bool auto_duration_;
     const bool auto_cts_;
@@ -8,9 +8,12 @@
 
 #include "roc_pipeline/sender_session.h"
 #include "roc_audio/resampler_map.h"
+#include "roc_core/fast_clock.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
+#include "roc_status/code_to_str.h"
 
 namespace roc {
 namespace pipeline {
@@ -19,12 +22,24 @@ SenderSession::SenderSession(const SenderSinkConfig& sink_config,
                              const rtp::EncodingMap& encoding_map,
                              packet::PacketFactory& packet_factory,
                              audio::FrameFactory& frame_factory,
-                             core::IArena& arena)
+                             core::IArena& arena,
+                             FecGroupMap* fec_groups)
     : arena_(arena)
     , sink_config_(sink_config)
     , encoding_map_(encoding_map)
     , packet_factory_(packet_factory)
     , frame_factory_(frame_factory)
+    , fec_groups_(fec_groups)
+    , source_proto_(address::Proto_None)
+    , repair_proto_(address::Proto_None)
+    , followers_(arena)
+    , leader_(NULL)
+    , shared_source_writer_(NULL)
+    , shared_repair_writer_(NULL)
+    , fec_tuner_source_(0)
+    , fec_tuner_has_source_(false)
+    , path_mtu_(0)
+    , packet_length_(0)
     , frame_writer_(NULL)
     , valid_(false) {
     identity_.reset(new (identity_) rtp::Identity());
@@ -35,16 +50,30 @@ SenderSession::SenderSession(const SenderSinkConfig& sink_config,
     valid_ = true;
 }
 
+SenderSession::~SenderSession() {
+    if (leader_) {
+        leader_->remove_follower_(*this);
+    }
+
+    for (size_t n = 0; n < followers_.size(); n++) {
+        followers_[n]->leader_ = NULL;
+        followers_[n]->shared_source_writer_ = NULL;
+        followers_[n]->shared_repair_writer_ = NULL;
+    }
+}
+
 bool SenderSession::is_valid() const {
     return valid_;
 }
 
 bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
-                                              SenderEndpoint* repair_endpoint) {
+                                              SenderEndpoint* repair_endpoint,
+                                              size_t path_mtu) {
     roc_panic_if(!is_valid());
 
     roc_panic_if(!source_endpoint);
     roc_panic_if(frame_writer_);
+    roc_panic_if(leader_);
 
     const rtp::Encoding* pkt_encoding =
         encoding_map_.find_by_pt(sink_config_.payload_type);
@@ -63,17 +92,76 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
     }
     pkt_writer = router_.get();
 
-    if (!router_->add_route(source_endpoint->outbound_writer(),
-                            packet::Packet::FlagAudio)) {
+    packet::IWriter* source_writer = &source_endpoint->outbound_writer();
+    packet::IWriter* repair_writer =
+        repair_endpoint ? &repair_endpoint->outbound_writer() : NULL;
+
+    if (can_share_encoding_() || sink_config_.enable_redundancy) {
+        // Duplicates source packets to followers and to redundant endpoint.
+        source_fanout_.reset(new (source_fanout_)
+                                 packet::Fanout(packet_factory_, arena_));
+        if (!source_fanout_ || !source_fanout_->add_output(*source_writer)) {
+            return false;
+        }
+        source_writer = source_fanout_.get();
+    }
+
+    if (can_share_encoding_()) {
+        if (repair_writer) {
+            repair_fanout_.reset(new (repair_fanout_)
+                                     packet::Fanout(packet_factory_, arena_));
+            if (!repair_fanout_ || !repair_fanout_->add_output(*repair_writer)) {
+                return false;
+            }
+            repair_writer = repair_fanout_.get();
+        }
+
+        source_proto_ = source_endpoint->proto();
+        repair_proto_ = repair_endpoint ? repair_endpoint->proto() : address::Proto_None;
+    }
+
+    if (sink_config_.enable_retransmission) {
+        // After fanout, so that retransmitted packets reach followers too.
+        retransmitter_.reset(new (retransmitter_) packet::Retransmitter(
+            *source_writer, packet_factory_, arena_, sink_config_.retransmitter));
+        if (!retransmitter_ || !retransmitter_->is_valid()) {
+            return false;
+        }
+        source_writer = retransmitter_.get();
+    }
+
+    if (!router_->add_route(*source_writer, packet::Packet::FlagAudio)) {
         return false;
     }
 
-    if (repair_endpoint) {
-        if (!router_->add_route(repair_endpoint->outbound_writer(),
-                                packet::Packet::FlagRepair)) {
+    if (repair_writer) {
+        if (!router_->add_route(*repair_writer, packet::Packet::FlagRepair)) {
+            return false;
+        }
+    }
+
+    if (sink_config_.enable_pacing) {
+        pacer_.reset(new (pacer_) packet::Pacer(
+            *pkt_writer, sink_config_.pacer, pkt_encoding->sample_spec.sample_rate()));
+        if (!pacer_ || !pacer_->is_valid()) {
             return false;
         }
+        pkt_writer = pacer_.get();
+    }
+
+    payload_encoder_.reset(pkt_encoding->new_encoder(arena_, pkt_encoding->sample_spec,
+                                                     sink_config_.payload_encoder),
+                           arena_);
+    if (!payload_encoder_) {
+        return false;
+    }
 
+    // Selected before FEC writer, because packet length is a part of FEC group key.
+    path_mtu_ = path_mtu;
+    packet_length_ = select_packet_length_(pkt_encoding->sample_spec, source_endpoint,
+                                           repair_endpoint);
+
+    if (repair_endpoint) {
         if (sink_config_.enable_interleaving) {
             interleaver_.reset(new (interleaver_) packet::Interleaver(
                 *pkt_writer, arena_,
@@ -85,21 +173,70 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
             pkt_writer = interleaver_.get();
         }
 
-        fec_encoder_.reset(fec::CodecMap::instance().new_encoder(sink_config_.fec_encoder,
-                                                                 packet_factory_, arena_),
-                           arena_);
-        if (!fec_encoder_) {
-            return false;
+        const packet::FecScheme fec_scheme = sink_config_.fec_encoder.scheme;
+
+        if (fec::CodecMap::instance().is_sliding_window(fec_scheme)) {
+            if (sink_config_.enable_adaptive_fec) {
+                roc_log(LogError,
+                        "sender session: adaptive fec is not supported for fec scheme %s",
+                        packet::fec_scheme_to_str(fec_scheme));
+                return false;
+            }
+
+            fec_sliding_writer_.reset(new (fec_sliding_writer_) fec::SlidingWriter(
+                sink_config_.fec_writer, *pkt_writer,
+                source_endpoint->outbound_composer(),
+                repair_endpoint->outbound_composer(), packet_factory_, arena_));
+            if (!fec_sliding_writer_ || !fec_sliding_writer_->is_valid()) {
+                return false;
+            }
+            pkt_writer = fec_sliding_writer_.get();
+        } else if (can_share_fec_()) {
+            FecGroupKey key;
+            key.repair_address = repair_endpoint->outbound_address();
+            key.fec_scheme = fec_scheme;
+            key.payload_type = sink_config_.payload_type;
+            key.packet_length = packet_length_;
+
+            core::SharedPtr<fec::GroupWriter> group = fec_groups_->find_or_create(
+                key, sink_config_.fec_writer, sink_config_.fec_encoder);
+            if (!group) {
+                return false;
+            }
+
+            fec_group_member_.reset(new (fec_group_member_) fec::GroupWriterMember(
+                group, *pkt_writer, source_endpoint->outbound_composer(),
+                repair_endpoint->outbound_composer()));
+            if (!fec_group_member_) {
+                return false;
+            }
+            pkt_writer = fec_group_member_.get();
+        } else {
+            fec_encoder_.reset(fec::CodecMap::instance().new_encoder(
+                                   sink_config_.fec_encoder, packet_factory_, arena_),
+                               arena_);
+            if (!fec_encoder_) {
+                return false;
+            }
+
+            fec_writer_.reset(new (fec_writer_) fec::Writer(
+                sink_config_.fec_writer, fec_scheme, *fec_encoder_,
+                *pkt_writer, source_endpoint->outbound_composer(),
+                repair_endpoint->outbound_composer(), packet_factory_, arena_));
+            if (!fec_writer_ || !fec_writer_->is_valid()) {
+                return false;
+            }
+            pkt_writer = fec_writer_.get();
         }
 
-        fec_writer_.reset(new (fec_writer_) fec::Writer(
-            sink_config_.fec_writer, sink_config_.fec_encoder.scheme, *fec_encoder_,
-            *pkt_writer, source_endpoint->outbound_composer(),
-            repair_endpoint->outbound_composer(), packet_factory_, arena_));
-        if (!fec_writer_ || !fec_writer_->is_valid()) {
-            return false;
+        if (sink_config_.enable_adaptive_fec) {
+            fec_tuner_.reset(new (fec_tuner_) fec::BlockSizeTuner(
+                sink_config_.fec_tuner, sink_config_.fec_writer,
+                fec_encoder_->max_block_length()));
+            if (!fec_tuner_ || !fec_tuner_->is_valid()) {
+                return false;
+            }
         }
-        pkt_writer = fec_writer_.get();
     }
 
     timestamp_extractor_.reset(new (timestamp_extractor_) rtp::TimestampExtractor(
@@ -109,12 +246,6 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
     }
     pkt_writer = timestamp_extractor_.get();
 
-    payload_encoder_.reset(pkt_encoding->new_encoder(arena_, pkt_encoding->sample_spec),
-                           arena_);
-    if (!payload_encoder_) {
-        return false;
-    }
-
     sequencer_.reset(new (sequencer_)
                          rtp::Sequencer(*identity_, sink_config_.payload_type));
     if (!sequencer_ || !sequencer_->is_valid()) {
@@ -133,7 +264,8 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
 
         packetizer_.reset(new (packetizer_) audio::Packetizer(
             *pkt_writer, source_endpoint->outbound_composer(), *sequencer_,
-            *payload_encoder_, packet_factory_, sink_config_.packet_length, in_spec));
+            *payload_encoder_, packet_factory_, packet_length_, in_spec,
+            sink_config_.dtx));
         if (!packetizer_ || !packetizer_->is_valid()) {
             return false;
         }
@@ -194,6 +326,14 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
     }
     frm_writer = feedback_monitor_.get();
 
+    // Outermost, so that whole session pipeline is accounted.
+    cpu_metering_writer_.reset(new (cpu_metering_writer_)
+                                   audio::CpuMeteringWriter(*frm_writer, cpu_meter_));
+    if (!cpu_metering_writer_) {
+        return false;
+    }
+    frm_writer = cpu_metering_writer_.get();
+
     if (!frm_writer) {
         return false;
     }
@@ -227,6 +367,90 @@ bool SenderSession::create_control_pipeline(SenderEndpoint* control_endpoint) {
     return true;
 }
 
+bool SenderSession::add_redundant_endpoint(SenderEndpoint* redundant_endpoint) {
+    roc_panic_if(!is_valid());
+
+    roc_panic_if(!redundant_endpoint);
+    roc_panic_if(!frame_writer_);
+
+    if (!source_fanout_) {
+        roc_log(LogError, "sender session: redundancy is not enabled");
+        return false;
+    }
+
+    packet::IWriter& writer = redundant_endpoint->outbound_writer();
+
+    if (source_fanout_->has_output(writer)) {
+        return true;
+    }
+
+    if (!source_fanout_->add_output(writer)) {
+        roc_log(LogError, "sender session: can't add redundant endpoint");
+        return false;
+    }
+
+    roc_log(LogInfo, "sender session: sending source packets over redundant path");
+
+    return true;
+}
+
+bool SenderSession::add_follower(SenderSession& follower,
+                                 SenderEndpoint* source_endpoint,
+                                 SenderEndpoint* repair_endpoint,
+                                 size_t path_mtu) {
+    roc_panic_if(!is_valid());
+
+    roc_panic_if(!source_endpoint);
+    roc_panic_if(&follower == this);
+    roc_panic_if(follower.frame_writer_ || follower.leader_);
+
+    if (!can_share_encoding_() || !source_fanout_) {
+        // Transport pipeline not created yet, or encoding can't be shared.
+        return false;
+    }
+
+    if (source_endpoint->proto() != source_proto_
+        || (repair_endpoint ? repair_endpoint->proto() : address::Proto_None)
+            != repair_proto_) {
+        return false;
+    }
+
+    if (sink_config_.enable_mtu_autotune && path_mtu != path_mtu_) {
+        // Packet length may differ.
+        return false;
+    }
+
+    if (!followers_.push_back(&follower)) {
+        return false;
+    }
+
+    if (!source_fanout_->add_output(source_endpoint->outbound_writer())) {
+        remove_follower_(follower);
+        return false;
+    }
+    follower.leader_ = this;
+    follower.shared_source_writer_ = &source_endpoint->outbound_writer();
+
+    if (repair_endpoint) {
+        if (!repair_fanout_->add_output(repair_endpoint->outbound_writer())) {
+            remove_follower_(follower);
+            return false;
+        }
+        follower.shared_repair_writer_ = &repair_endpoint->outbound_writer();
+    }
+
+    roc_log(LogInfo, "sender session: sharing encoding: n_followers=%lu",
+            (unsigned long)followers_.size());
+
+    return true;
+}
+
+bool SenderSession::has_leader() const {
+    roc_panic_if(!is_valid());
+
+    return leader_ != NULL;
+}
+
 audio::IFrameWriter* SenderSession::frame_writer() const {
     roc_panic_if(!is_valid());
 
@@ -247,6 +471,35 @@ status::StatusCode SenderSession::route_packet(const packet::PacketPtr& packet,
 core::nanoseconds_t SenderSession::refresh(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
+    cpu_meter_.begin(core::fast_timestamp());
+    const core::nanoseconds_t deadline = refresh_(current_time);
+    cpu_meter_.end(core::fast_timestamp());
+
+    return deadline;
+}
+
+void SenderSession::flush() {
+    roc_panic_if(!is_valid());
+
+    if (fec_writer_) {
+        // Write repair packets encoded asynchronously since last frame.
+        fec_writer_->flush();
+    }
+
+    if (fec_group_member_) {
+        // Same, but for blocks of all sessions of group.
+        fec_group_member_->flush();
+    }
+}
+
+core::nanoseconds_t SenderSession::refresh_(core::nanoseconds_t current_time) {
+    flush();
+
+    if (fec_tuner_) {
+        fec_tuner_->refresh(current_time);
+        apply_fec_tuner_();
+    }
+
     if (rtcp_communicator_) {
         if (has_send_stream()) {
             const status::StatusCode code =
@@ -261,19 +514,114 @@ core::nanoseconds_t SenderSession::refresh(core::nanoseconds_t current_time) {
     return 0;
 }
 
+bool SenderSession::reconfigure(const SenderLiveConfig& live_config) {
+    roc_panic_if(!is_valid());
+
+    if (leader_) {
+        roc_log(LogError,
+                "sender session: can't reconfigure session which encoding is shared"
+                " with another session");
+        return false;
+    }
+
+    if (!frame_writer_) {
+        roc_log(LogError,
+                "sender session: can't reconfigure session before transport pipeline"
+                " is created");
+        return false;
+    }
+
+    if (live_config.fec_n_source_packets != 0) {
+        if (fec_sliding_writer_) {
+            roc_log(LogError,
+                    "sender session: can't change fec block,"
+                    " not supported by sliding-window fec");
+            return false;
+        }
+
+        if (fec_group_member_) {
+            roc_log(LogError,
+                    "sender session: can't change fec block,"
+                    " it's shared with other sessions");
+            return false;
+        }
+
+        if (!fec_writer_) {
+            roc_log(LogError, "sender session: can't change fec block, fec is disabled");
+            return false;
+        }
+
+        if (fec_tuner_) {
+            roc_log(LogError,
+                    "sender session: can't change fec block,"
+                    " it's managed by adaptive fec");
+            return false;
+        }
+
+        if (!fec_writer_->resize(live_config.fec_n_source_packets,
+                                 live_config.fec_n_repair_packets)) {
+            return false;
+        }
+    }
+
+    if (live_config.target_latency != 0) {
+        if (!feedback_monitor_->set_target_latency(live_config.target_latency)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void SenderSession::get_slot_metrics(SenderSlotMetrics& slot_metrics) const {
     roc_panic_if(!is_valid());
 
+    if (leader_) {
+        // Metrics of shared stream.
+        leader_->get_slot_metrics(slot_metrics);
+        return;
+    }
+
     slot_metrics.source_id = identity_->ssrc();
     slot_metrics.num_participants =
         feedback_monitor_ ? feedback_monitor_->num_participants() : 0;
     slot_metrics.is_complete = (frame_writer_ != NULL);
+
+    if (fec_writer_) {
+        slot_metrics.fec = fec_writer_->metrics();
+    }
+
+    if (fec_group_member_) {
+        // Blocks of whole group.
+        slot_metrics.fec = fec_group_member_->group()->metrics();
+    }
+
+    if (fec_tuner_) {
+        slot_metrics.fec_tuner = fec_tuner_->metrics();
+    }
+
+    if (pacer_) {
+        slot_metrics.pacer = pacer_->metrics();
+    }
+
+    if (retransmitter_) {
+        slot_metrics.retransmitter = retransmitter_->metrics();
+    }
+
+    slot_metrics.path_mtu = path_mtu_;
+    slot_metrics.packet_length = packet_length_;
 }
 
 void SenderSession::get_participant_metrics(SenderParticipantMetrics* party_metrics,
                                             size_t* party_count) const {
     roc_panic_if(!is_valid());
 
+    if (leader_) {
+        // Feedback from our receivers is forwarded to leader.
+        leader_->get_participant_metrics(party_metrics, party_count);
+        return;
+    }
+
     if (party_metrics && party_count) {
         *party_count = std::min(
             *party_count, feedback_monitor_ ? feedback_monitor_->num_participants() : 0);
@@ -281,6 +629,7 @@ void SenderSession::get_participant_metrics(SenderParticipantMetrics* party_metr
         for (size_t n_part = 0; n_part < *party_count; n_part++) {
             party_metrics[n_part].link = feedback_monitor_->link_metrics(n_part);
             party_metrics[n_part].latency = feedback_monitor_->latency_metrics(n_part);
+            party_metrics[n_part].cpu_ns_per_sec = cpu_meter_.cpu_ns_per_sec();
         }
     } else if (party_count) {
         *party_count = 0;
@@ -288,10 +637,13 @@ void SenderSession::get_participant_metrics(SenderParticipantMetrics* party_metr
 }
 
 rtcp::ParticipantInfo SenderSession::participant_info() {
+    // If we send leader's stream, we should report its SSRC.
+    const rtp::Identity& identity = leader_ ? *leader_->identity_ : *identity_;
+
     rtcp::ParticipantInfo part_info;
 
-    part_info.cname = identity_->cname();
-    part_info.source_id = identity_->ssrc();
+    part_info.cname = identity.cname();
+    part_info.source_id = identity.ssrc();
     part_info.report_mode = rtcp::Report_ToAddress;
     part_info.report_address = rtcp_outbound_addr_;
 
@@ -299,16 +651,29 @@ rtcp::ParticipantInfo SenderSession::participant_info() {
 }
 
 void SenderSession::change_source_id() {
+    if (leader_) {
+        leader_->change_source_id();
+        return;
+    }
+
     identity_->change_ssrc();
 }
 
 bool SenderSession::has_send_stream() {
+    if (leader_) {
+        return leader_->has_send_stream();
+    }
+
     return timestamp_extractor_ && timestamp_extractor_->has_mapping();
 }
 
 rtcp::SendReport SenderSession::query_send_stream(core::nanoseconds_t report_time) {
     roc_panic_if(!has_send_stream());
 
+    if (leader_) {
+        return leader_->query_send_stream(report_time);
+    }
+
     const audio::PacketizerMetrics& packet_metrics = packetizer_->metrics();
 
     rtcp::SendReport report;
@@ -328,6 +693,10 @@ SenderSession::notify_send_stream(packet::stream_source_t recv_source_id,
                                   const rtcp::RecvReport& recv_report) {
     roc_panic_if(!has_send_stream());
 
+    if (leader_) {
+        return leader_->notify_send_stream(recv_source_id, recv_report);
+    }
+
     if (feedback_monitor_ && feedback_monitor_->is_started()) {
         audio::LatencyMetrics latency_metrics;
         latency_metrics.niq_latency = recv_report.niq_latency;
@@ -346,9 +715,182 @@ SenderSession::notify_send_stream(packet::stream_source_t recv_source_id,
                                             link_metrics);
     }
 
+    if (fec_tuner_) {
+        update_fec_tuner_(recv_source_id, recv_report);
+    }
+
     return status::StatusOK;
 }
 
+void SenderSession::notify_send_losses(packet::stream_source_t recv_source_id,
+                                       const packet::seqnum_t* seqnums,
+                                       size_t n_seqnums) {
+    roc_panic_if(!has_send_stream());
+
+    if (leader_) {
+        leader_->notify_send_losses(recv_source_id, seqnums, n_seqnums);
+        return;
+    }
+
+    if (!retransmitter_) {
+        return;
+    }
+
+    for (size_t n = 0; n < n_seqnums; n++) {
+        const status::StatusCode code = retransmitter_->retransmit(seqnums[n]);
+        if (code != status::StatusOK) {
+            roc_log(LogDebug,
+                    "sender session: can't retransmit packet: recv_ssrc=%lu sn=%lu"
+                    " status=%s",
+                    (unsigned long)recv_source_id, (unsigned long)seqnums[n],
+                    status::code_to_str(code));
+            return;
+        }
+    }
+}
+
+// Selects largest packet length that fits into path MTU, if autotuning is enabled.
+core::nanoseconds_t
+SenderSession::select_packet_length_(const audio::SampleSpec& sample_spec,
+                                     SenderEndpoint* source_endpoint,
+                                     SenderEndpoint* repair_endpoint) {
+    if (!sink_config_.enable_mtu_autotune || path_mtu_ == 0) {
+        return sink_config_.packet_length;
+    }
+
+    // IP and UDP headers.
+    const size_t ip_overhead =
+        (source_endpoint->outbound_address().family() == address::Family_IPv6 ? 40 : 20)
+        + 8;
+
+    // Headers and footers added by composers. Repair packet carries whole source
+    // packet, hence overheads are summed.
+    size_t source_overhead = 0;
+    size_t repair_overhead = 0;
+
+    if (!get_header_overhead_(source_endpoint->outbound_composer(), source_overhead)
+        || (repair_endpoint
+            && !get_header_overhead_(repair_endpoint->outbound_composer(),
+                                     repair_overhead))) {
+        return sink_config_.packet_length;
+    }
+
+    const size_t overhead = source_overhead + repair_overhead;
+
+    size_t max_datagram = path_mtu_ - std::min(path_mtu_, ip_overhead);
+
+    if (max_datagram > packet_factory_.packet_buffer_size()) {
+        // E.g. jumbo frames are enabled, but max packet size wasn't raised.
+        roc_log(LogInfo,
+                "sender session: path mtu exceeds max packet size,"
+                " packet length will be limited: path_mtu=%lu max_packet_size=%lu",
+                (unsigned long)path_mtu_,
+                (unsigned long)packet_factory_.packet_buffer_size());
+        max_datagram = packet_factory_.packet_buffer_size();
+    }
+
+    if (max_datagram <= overhead) {
+        roc_log(LogError,
+                "sender session: path mtu is too small, using default packet length:"
+                " path_mtu=%lu overhead=%lu",
+                (unsigned long)path_mtu_, (unsigned long)(ip_overhead + overhead));
+        return sink_config_.packet_length;
+    }
+
+    const size_t max_payload = max_datagram - overhead;
+
+    // Find largest number of samples which encoded size fits into payload.
+    size_t lo = 0;
+    size_t hi = (size_t)sample_spec.ns_2_stream_timestamp(sink_config_.max_packet_length);
+
+    while (lo < hi) {
+        const size_t mid = hi - (hi - lo) / 2;
+        if (payload_encoder_->encoded_byte_count(mid) <= max_payload) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    if (lo == 0) {
+        return sink_config_.packet_length;
+    }
+
+    const core::nanoseconds_t packet_length =
+        sample_spec.stream_timestamp_2_ns((packet::stream_timestamp_t)lo);
+
+    roc_log(LogInfo,
+            "sender session: selected packet length from path mtu:"
+            " path_mtu=%lu max_payload=%lu packet_length=%.3fms samples_per_packet=%lu",
+            (unsigned long)path_mtu_, (unsigned long)max_payload,
+            (double)packet_length / core::Millisecond, (unsigned long)lo);
+
+    return packet_length;
+}
+
+bool SenderSession::get_header_overhead_(packet::IComposer& composer,
+                                         size_t& overhead) {
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        return false;
+    }
+
+    core::Slice<uint8_t> buffer = packet_factory_.new_packet_buffer();
+    if (!buffer) {
+        return false;
+    }
+
+    if (!composer.prepare(*pp, buffer, 0)) {
+        return false;
+    }
+
+    overhead = buffer.size();
+    return true;
+}
+
+// Encoding can't be shared if it's adapted to a particular receiver.
+bool SenderSession::can_share_encoding_() const {
+    return sink_config_.enable_shared_encoding && !sink_config_.enable_adaptive_fec
+        && !sink_config_.enable_redundancy
+        && sink_config_.latency.tuner_profile == audio::LatencyTunerProfile_Intact;
+}
+
+bool SenderSession::can_share_fec_() const {
+    return sink_config_.enable_shared_fec && fec_groups_ != NULL
+        && !sink_config_.enable_adaptive_fec;
+}
+
+void SenderSession::remove_follower_(SenderSession& follower) {
+    if (follower.shared_source_writer_) {
+        source_fanout_->remove_output(*follower.shared_source_writer_);
+    }
+    if (follower.shared_repair_writer_) {
+        repair_fanout_->remove_output(*follower.shared_repair_writer_);
+    }
+
+    follower.leader_ = NULL;
+    follower.shared_source_writer_ = NULL;
+    follower.shared_repair_writer_ = NULL;
+
+    for (size_t n = 0; n < followers_.size(); n++) {
+        if (followers_[n] != &follower) {
+            continue;
+        }
+
+        for (; n + 1 < followers_.size(); n++) {
+            followers_[n] = followers_[n + 1];
+        }
+
+        if (!followers_.resize(followers_.size() - 1)) {
+            roc_panic("sender session: can't resize array");
+        }
+
+        return;
+    }
+
+    roc_panic("sender session: follower not found");
+}
+
 void SenderSession::start_feedback_monitor_() {
     if (!feedback_monitor_) {
         // Transport endpoint not created yet.
@@ -374,6 +916,41 @@ void SenderSession::start_feedback_monitor_() {
     feedback_monitor_->start();
 }
 
+void SenderSession::update_fec_tuner_(packet::stream_source_t recv_source_id,
+                                      const rtcp::RecvReport& recv_report) {
+    if (rtcp_outbound_addr_.multicast()) {
+        // There are multiple receivers with different losses, and block sizes
+        // can't be tuned for every one of them.
+        return;
+    }
+
+    if (!fec_tuner_has_source_ || fec_tuner_source_ != recv_source_id) {
+        // New receiver, loss counters start from scratch.
+        fec_loss_estimator_ = rtcp::LossEstimator();
+        fec_loss_estimator_.update(recv_report.packet_count, recv_report.cum_loss);
+
+        fec_tuner_source_ = recv_source_id;
+        fec_tuner_has_source_ = true;
+        return;
+    }
+
+    const float loss_fraction =
+        fec_loss_estimator_.update(recv_report.packet_count, recv_report.cum_loss);
+
+    fec_tuner_->update(loss_fraction, recv_report.rtt,
+                       core::timestamp(core::ClockUnix));
+    apply_fec_tuner_();
+}
+
+void SenderSession::apply_fec_tuner_() {
+    if (!fec_writer_->resize(fec_tuner_->source_packets(),
+                             fec_tuner_->repair_packets())) {
+        roc_log(LogError, "sender session: can't resize fec block: sbl=%lu rbl=%lu",
+                (unsigned long)fec_tuner_->source_packets(),
+                (unsigned long)fec_tuner_->repair_packets());
+    }
+}
+
 status::StatusCode
 SenderSession::route_control_packet_(const packet::PacketPtr& packet,
                                      core::nanoseconds_t current_time) {
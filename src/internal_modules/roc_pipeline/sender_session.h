@@ -12,29 +12,41 @@
 #ifndef ROC_PIPELINE_SENDER_SESSION_H_
 #define ROC_PIPELINE_SENDER_SESSION_H_
 
+#include "roc_address/protocol.h"
 #include "roc_address/socket_addr.h"
 #include "roc_audio/channel_mapper_writer.h"
+#include "roc_audio/cpu_metering_writer.h"
 #include "roc_audio/feedback_monitor.h"
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/iframe_encoder.h"
 #include "roc_audio/iresampler.h"
 #include "roc_audio/packetizer.h"
 #include "roc_audio/resampler_writer.h"
+#include "roc_core/array.h"
+#include "roc_core/cpu_meter.h"
 #include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_fec/block_size_tuner.h"
+#include "roc_fec/group_writer.h"
 #include "roc_fec/iblock_encoder.h"
+#include "roc_fec/sliding_writer.h"
 #include "roc_fec/writer.h"
+#include "roc_packet/fanout.h"
 #include "roc_packet/interleaver.h"
+#include "roc_packet/pacer.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_packet/retransmitter.h"
 #include "roc_packet/router.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/fec_group_map.h"
 #include "roc_pipeline/metrics.h"
 #include "roc_pipeline/sender_endpoint.h"
 #include "roc_rtcp/communicator.h"
 #include "roc_rtcp/composer.h"
 #include "roc_rtcp/iparticipant.h"
+#include "roc_rtcp/loss_estimator.h"
 #include "roc_rtp/encoding_map.h"
 #include "roc_rtp/identity.h"
 #include "roc_rtp/sequencer.h"
@@ -49,25 +61,67 @@ namespace pipeline {
 //! Contains:
 //!  - a pipeline for processing audio frames from single sender and converting
 //!    them into packets
+//!
+//! If shared encoding is enabled, session may send packets encoded by another
+//! session (leader) instead of having its own transport pipeline. Such session
+//! (follower) reports leader's stream via RTCP and forwards feedback from its
+//! receivers to leader.
+//!
+//! If shared FEC is enabled, session writes source packets to FEC writer shared
+//! with other sessions sending to the same receiver, obtained from FecGroupMap.
 class SenderSession : public core::NonCopyable<>, private rtcp::IParticipant {
 public:
     //! Initialize.
+    //! @remarks
+    //!  @p fec_groups is used if shared FEC is enabled.
     SenderSession(const SenderSinkConfig& sink_config,
                   const rtp::EncodingMap& encoding_map,
                   packet::PacketFactory& packet_factory,
                   audio::FrameFactory& frame_factory,
-                  core::IArena& arena);
+                  core::IArena& arena,
+                  FecGroupMap* fec_groups = NULL);
+
+    ~SenderSession();
 
     //! Check if the session was succefully constructed.
     bool is_valid() const;
 
     //! Create transport sub-pipeline.
+    //! @remarks
+    //!  @p path_mtu defines MTU of network path of endpoints, or zero if
+    //!  it's unknown. It's used to select packet length, if MTU autotuning
+    //!  is enabled.
     bool create_transport_pipeline(SenderEndpoint* source_endpoint,
-                                   SenderEndpoint* repair_endpoint);
+                                   SenderEndpoint* repair_endpoint,
+                                   size_t path_mtu);
 
     //! Create control sub-pipeline.
     bool create_control_pipeline(SenderEndpoint* control_endpoint);
 
+    //! Send source packets to second endpoint as well.
+    //! @remarks
+    //!  Used when redundancy is enabled. Packets produced by transport pipeline
+    //!  are duplicated to @p redundant_endpoint, with the same SSRC and seqnums.
+    //!  Should be called after transport pipeline is created.
+    bool add_redundant_endpoint(SenderEndpoint* redundant_endpoint);
+
+    //! Share encoded packets with another session.
+    //! @remarks
+    //!  Packets produced by transport pipeline of this session are additionally
+    //!  sent to @p source_endpoint and @p repair_endpoint of @p follower, which
+    //!  doesn't need its own transport pipeline. @p path_mtu is the path MTU
+    //!  of follower endpoints.
+    //! @returns
+    //!  false if encoding can't be shared, e.g. if it's disabled or if
+    //!  endpoint protocols are different.
+    bool add_follower(SenderSession& follower,
+                      SenderEndpoint* source_endpoint,
+                      SenderEndpoint* repair_endpoint,
+                      size_t path_mtu);
+
+    //! Check if session sends packets encoded by another session.
+    bool has_leader() const;
+
     //! Get frame writer.
     //! @remarks
     //!  This way samples reach the pipeline.
@@ -84,11 +138,28 @@ public:
                                                        core::nanoseconds_t current_time);
 
     //! Refresh pipeline according to current time.
+    //! @remarks
+    //!  Also performs flush().
     //! @returns
     //!  deadline (absolute time) when refresh should be invoked again
     //!  if there are no frames
     core::nanoseconds_t refresh(core::nanoseconds_t current_time);
 
+    //! Write packets produced asynchronously since last call.
+    //! @remarks
+    //!  Should be called after every frame, even if refresh() is called
+    //!  less often.
+    void flush();
+
+    //! Change session parameters on the fly.
+    //! @remarks
+    //!  Target latency is moved gradually by latency tuner. New FEC block
+    //!  size is applied starting from the next block.
+    //! @returns
+    //!  false if parameters can't be applied, e.g. if transport pipeline
+    //!  is not created yet or if it's owned by leader session.
+    ROC_ATTR_NODISCARD bool reconfigure(const SenderLiveConfig& live_config);
+
     //! Get slot metrics.
     //! @remarks
     //!  These metrics are for the whole slot.
@@ -117,9 +188,27 @@ private:
     virtual rtcp::SendReport query_send_stream(core::nanoseconds_t report_time);
     virtual status::StatusCode notify_send_stream(packet::stream_source_t recv_source_id,
                                                   const rtcp::RecvReport& recv_report);
+    virtual void notify_send_losses(packet::stream_source_t recv_source_id,
+                                    const packet::seqnum_t* seqnums,
+                                    size_t n_seqnums);
+
+    core::nanoseconds_t select_packet_length_(const audio::SampleSpec& sample_spec,
+                                              SenderEndpoint* source_endpoint,
+                                              SenderEndpoint* repair_endpoint);
+    bool get_header_overhead_(packet::IComposer& composer, size_t& overhead);
+
+    bool can_share_encoding_() const;
+    bool can_share_fec_() const;
+    void remove_follower_(SenderSession& follower);
 
     void start_feedback_monitor_();
 
+    core::nanoseconds_t refresh_(core::nanoseconds_t current_time);
+
+    void update_fec_tuner_(packet::stream_source_t recv_source_id,
+                           const rtcp::RecvReport& recv_report);
+    void apply_fec_tuner_();
+
     status::StatusCode route_control_packet_(const packet::PacketPtr& packet,
                                              core::nanoseconds_t current_time);
 
@@ -132,21 +221,53 @@ private:
     packet::PacketFactory& packet_factory_;
     audio::FrameFactory& frame_factory_;
 
+    FecGroupMap* fec_groups_;
+
     core::Optional<rtp::Identity> identity_;
     core::Optional<rtp::Sequencer> sequencer_;
 
     core::Optional<packet::Router> router_;
 
+    // Duplicate packets to endpoints of followers, if encoding is shared.
+    core::Optional<packet::Fanout> source_fanout_;
+    core::Optional<packet::Fanout> repair_fanout_;
+    address::Protocol source_proto_;
+    address::Protocol repair_proto_;
+
+    // Sessions that send packets encoded by us.
+    core::Array<SenderSession*> followers_;
+
+    // Session which packets we send, and our writers added to its fanouts.
+    SenderSession* leader_;
+    packet::IWriter* shared_source_writer_;
+    packet::IWriter* shared_repair_writer_;
+
+    core::Optional<packet::Pacer> pacer_;
+
+    // Keeps sent source packets to re-send them on NACK.
+    core::Optional<packet::Retransmitter> retransmitter_;
+
     core::Optional<packet::Interleaver> interleaver_;
 
     core::ScopedPtr<fec::IBlockEncoder> fec_encoder_;
     core::Optional<fec::Writer> fec_writer_;
+    core::Optional<fec::SlidingWriter> fec_sliding_writer_;
+    // Writes to FEC writer shared with other sessions, instead of fec_writer_.
+    core::Optional<fec::GroupWriterMember> fec_group_member_;
+
+    core::Optional<fec::BlockSizeTuner> fec_tuner_;
+    rtcp::LossEstimator fec_loss_estimator_;
+    packet::stream_source_t fec_tuner_source_;
+    bool fec_tuner_has_source_;
 
     core::Optional<rtp::TimestampExtractor> timestamp_extractor_;
 
     core::ScopedPtr<audio::IFrameEncoder> payload_encoder_;
     core::Optional<audio::Packetizer> packetizer_;
 
+    size_t path_mtu_;
+    core::nanoseconds_t packet_length_;
+
     core::Optional<audio::ChannelMapperWriter> channel_mapper_writer_;
 
     core::Optional<audio::ResamplerWriter> resampler_writer_;
@@ -154,6 +275,9 @@ private:
 
     core::Optional<audio::FeedbackMonitor> feedback_monitor_;
 
+    core::CpuMeter cpu_meter_;
+    core::Optional<audio::CpuMeteringWriter> cpu_metering_writer_;
+
     core::Optional<rtcp::Communicator> rtcp_communicator_;
     address::SocketAddr rtcp_outbound_addr_;
 
@@ -19,17 +19,34 @@ SenderSink::SenderSink(const SenderSinkConfig& sink_config,
                        core::IPool& packet_pool,
                        core::IPool& packet_buffer_pool,
                        core::IPool& frame_buffer_pool,
-                       core::IArena& arena)
+                       core::IArena& arena,
+                       FecGroupMap* fec_groups)
     : sink_config_(sink_config)
     , encoding_map_(encoding_map)
     , packet_factory_(packet_pool, packet_buffer_pool)
     , frame_factory_(frame_buffer_pool)
     , arena_(arena)
+    , fec_groups_(fec_groups)
     , frame_writer_(NULL)
     , valid_(false) {
     sink_config_.deduce_defaults();
 
-    audio::IFrameWriter* frm_writer = &fanout_;
+    if (sink_config_.session_threads != 0) {
+        session_workers_.reset(new (session_workers_) core::WorkerPool(
+            sink_config_.session_threads, arena_));
+        if (!session_workers_ || !session_workers_->is_valid()) {
+            return;
+        }
+
+        fanout_.reset(new (fanout_) audio::Fanout(*session_workers_, arena_));
+    } else {
+        fanout_.reset(new (fanout_) audio::Fanout());
+    }
+    if (!fanout_) {
+        return;
+    }
+
+    audio::IFrameWriter* frm_writer = fanout_.get();
 
     if (!sink_config_.input_sample_spec.is_raw()) {
         const audio::SampleSpec out_spec(sink_config_.input_sample_spec.sample_rate(),
@@ -65,14 +82,24 @@ bool SenderSink::is_valid() const {
     return valid_;
 }
 
+void SenderSink::add_small_frame_buffer_pool(core::IPool& buffer_pool) {
+    roc_panic_if(!is_valid());
+
+    if (!slots_.is_empty()) {
+        roc_panic("sender sink: can't add buffer pool when there are slots");
+    }
+
+    frame_factory_.add_small_buffer_pool(buffer_pool);
+}
+
 SenderSlot* SenderSink::create_slot(const SenderSlotConfig& slot_config) {
     roc_panic_if(!is_valid());
 
     roc_log(LogInfo, "sender sink: adding slot");
 
-    core::SharedPtr<SenderSlot> slot =
-        new (arena_) SenderSlot(sink_config_, slot_config, state_tracker_, encoding_map_,
-                                fanout_, packet_factory_, frame_factory_, arena_);
+    core::SharedPtr<SenderSlot> slot = new (arena_)
+        SenderSlot(sink_config_, slot_config, state_tracker_, encoding_map_, *fanout_,
+                   slots_, packet_factory_, frame_factory_, arena_, fec_groups_);
 
     if (!slot || !slot->is_valid()) {
         roc_log(LogError, "sender sink: can't create slot");
@@ -98,6 +125,16 @@ size_t SenderSink::num_sessions() const {
     return state_tracker_.num_active_sessions();
 }
 
+audio::ProfilerMetrics SenderSink::profiler_metrics() const {
+    roc_panic_if(!is_valid());
+
+    if (!profiler_) {
+        return audio::ProfilerMetrics();
+    }
+
+    return profiler_->metrics();
+}
+
 core::nanoseconds_t SenderSink::refresh(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
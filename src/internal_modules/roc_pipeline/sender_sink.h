@@ -20,8 +20,10 @@
 #include "roc_core/ipool.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
+#include "roc_core/worker_pool.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/fec_group_map.h"
 #include "roc_pipeline/sender_endpoint.h"
 #include "roc_pipeline/sender_slot.h"
 #include "roc_pipeline/state_tracker.h"
@@ -40,19 +42,36 @@ namespace pipeline {
 //! Pipeline:
 //!  - input: frames
 //!  - output: packets
+//!
+//! If session threads are enabled, fanout writes frames to slot sessions in
+//! parallel on core::WorkerPool threads. Outbound packets produced there are
+//! created in atomic shared mode and stay in it, so sessions may pass them
+//! to components shared between slots, like FecGroupMap. Inbound control
+//! packets are switched to non-atomic local mode, so they are routed only by
+//! refresh() on pipeline thread, and never reach worker threads.
 class SenderSink : public sndio::ISink, public core::NonCopyable<> {
 public:
     //! Initialize.
+    //! @remarks
+    //!  @p fec_groups is used if shared FEC is enabled. It may be shared
+    //!  between multiple sinks.
     SenderSink(const SenderSinkConfig& sink_config,
                const rtp::EncodingMap& encoding_map,
                core::IPool& packet_pool,
                core::IPool& packet_buffer_pool,
                core::IPool& frame_buffer_pool,
-               core::IArena& arena);
+               core::IArena& arena,
+               FecGroupMap* fec_groups = NULL);
 
     //! Check if the pipeline was successfully constructed.
     bool is_valid() const;
 
+    //! Add pool for smaller frame buffers.
+    //! @remarks
+    //!  See audio::FrameFactory::add_small_buffer_pool().
+    //!  Should be called before any slot is created.
+    void add_small_frame_buffer_pool(core::IPool& buffer_pool);
+
     //! Create slot.
     SenderSlot* create_slot(const SenderSlotConfig& slot_config);
 
@@ -62,6 +81,11 @@ public:
     //! Get number of active sessions.
     size_t num_sessions() const;
 
+    //! Get profiler metrics.
+    //! @remarks
+    //!  Returns zero metrics if profiling is disabled.
+    audio::ProfilerMetrics profiler_metrics() const;
+
     //! Refresh pipeline according to current time.
     //! @remarks
     //!  Should be invoked after writing each frame.
@@ -117,9 +141,13 @@ private:
     audio::FrameFactory frame_factory_;
     core::IArena& arena_;
 
+    FecGroupMap* fec_groups_;
+
     StateTracker state_tracker_;
 
-    audio::Fanout fanout_;
+    core::Optional<core::WorkerPool> session_workers_;
+
+    core::Optional<audio::Fanout> fanout_;
     core::Optional<audio::ProfilingWriter> profiler_;
     core::Optional<audio::PcmMapperWriter> pcm_mapper_;
 
@@ -19,25 +19,38 @@ SenderSlot::SenderSlot(const SenderSinkConfig& sink_config,
                        StateTracker& state_tracker,
                        const rtp::EncodingMap& encoding_map,
                        audio::Fanout& fanout,
+                       core::List<SenderSlot>& peers,
                        packet::PacketFactory& packet_factory,
                        audio::FrameFactory& frame_factory,
-                       core::IArena& arena)
+                       core::IArena& arena,
+                       FecGroupMap* fec_groups)
     : core::RefCounted<SenderSlot, core::ArenaAllocation>(arena)
     , sink_config_(sink_config)
     , fanout_(fanout)
+    , peers_(peers)
+    , packet_factory_(packet_factory)
+    , path_mtu_(0)
     , state_tracker_(state_tracker)
-    , session_(sink_config, encoding_map, packet_factory, frame_factory, arena)
+    , session_(
+          sink_config, encoding_map, packet_factory, frame_factory, arena, fec_groups)
+    , active_(false)
+    , next_control_time_(0)
     , valid_(false) {
     if (!session_.is_valid()) {
         return;
     }
 
     valid_ = true;
+
+    publish_metrics_();
 }
 
 SenderSlot::~SenderSlot() {
     if (session_.frame_writer() && fanout_.has_output(*session_.frame_writer())) {
         fanout_.remove_output(*session_.frame_writer());
+    }
+
+    if (active_) {
         state_tracker_.add_active_sessions(-1);
     }
 }
@@ -49,19 +62,28 @@ bool SenderSlot::is_valid() const {
 SenderEndpoint* SenderSlot::add_endpoint(address::Interface iface,
                                          address::Protocol proto,
                                          const address::SocketAddr& outbound_address,
-                                         packet::IWriter& outbound_writer) {
+                                         packet::IWriter& outbound_writer,
+                                         size_t path_mtu) {
     roc_panic_if(!is_valid());
 
-    roc_log(LogDebug, "sender slot: adding %s endpoint %s",
-            address::interface_to_str(iface), address::proto_to_str(proto));
+    roc_log(LogDebug, "sender slot: adding %s endpoint %s: path_mtu=%lu",
+            address::interface_to_str(iface), address::proto_to_str(proto),
+            (unsigned long)path_mtu);
 
     SenderEndpoint* endpoint = NULL;
 
     switch (iface) {
     case address::Iface_AudioSource:
-        if (!(endpoint =
-                  create_source_endpoint_(proto, outbound_address, outbound_writer))) {
-            return NULL;
+        if (source_endpoint_ && sink_config_.enable_redundancy) {
+            if (!(endpoint = create_redundant_endpoint_(proto, outbound_address,
+                                                        outbound_writer))) {
+                return NULL;
+            }
+        } else {
+            if (!(endpoint = create_source_endpoint_(proto, outbound_address,
+                                                     outbound_writer))) {
+                return NULL;
+            }
         }
         break;
 
@@ -87,18 +109,12 @@ SenderEndpoint* SenderSlot::add_endpoint(address::Interface iface,
     switch (iface) {
     case address::Iface_AudioSource:
     case address::Iface_AudioRepair:
-        if (source_endpoint_
-            && (repair_endpoint_
-                || sink_config_.fec_encoder.scheme == packet::FEC_None)) {
-            if (!session_.create_transport_pipeline(source_endpoint_.get(),
-                                                    repair_endpoint_.get())) {
-                return NULL;
-            }
+        if (path_mtu != 0 && (path_mtu_ == 0 || path_mtu < path_mtu_)) {
+            path_mtu_ = path_mtu;
         }
-        if (session_.frame_writer()) {
-            if (!fanout_.has_output(*session_.frame_writer())) {
-                fanout_.add_output(*session_.frame_writer());
-                state_tracker_.add_active_sessions(+1);
+        if (transport_endpoints_ready_()) {
+            if (!start_transport_()) {
+                return NULL;
             }
         }
         break;
@@ -115,18 +131,35 @@ SenderEndpoint* SenderSlot::add_endpoint(address::Interface iface,
         break;
     }
 
+    publish_metrics_();
+
     return endpoint;
 }
 
 core::nanoseconds_t SenderSlot::refresh(core::nanoseconds_t current_time) {
     roc_panic_if(!is_valid());
 
+    if (active_ && !session_.frame_writer() && !session_.has_leader()) {
+        // Slot which encoding we've shared was removed, find another one
+        // or start our own encoding.
+        if (!start_transport_()) {
+            // TODO(gh-183): forward status
+            roc_panic("sender slot: can't restart transport pipeline");
+        }
+    }
+
     if (source_endpoint_) {
         const status::StatusCode code = source_endpoint_->pull_packets(current_time);
         // TODO(gh-183): forward status
         roc_panic_if(code != status::StatusOK);
     }
 
+    if (redundant_endpoint_) {
+        const status::StatusCode code = redundant_endpoint_->pull_packets(current_time);
+        // TODO(gh-183): forward status
+        roc_panic_if(code != status::StatusOK);
+    }
+
     if (repair_endpoint_) {
         const status::StatusCode code = repair_endpoint_->pull_packets(current_time);
         // TODO(gh-183): forward status
@@ -139,7 +172,50 @@ core::nanoseconds_t SenderSlot::refresh(core::nanoseconds_t current_time) {
         roc_panic_if(code != status::StatusOK);
     }
 
-    return session_.refresh(current_time);
+    const bool control_due = current_time >= next_control_time_;
+
+    core::nanoseconds_t deadline = 0;
+
+    if (control_due) {
+        deadline = session_.refresh(current_time);
+    } else {
+        session_.flush();
+    }
+
+    if (source_bundler_) {
+        // Send packets generated since last refresh.
+        const status::StatusCode code = source_bundler_->flush();
+        // TODO(gh-183): forward status
+        roc_panic_if(code != status::StatusOK);
+    }
+
+    if (redundant_bundler_) {
+        const status::StatusCode code = redundant_bundler_->flush();
+        // TODO(gh-183): forward status
+        roc_panic_if(code != status::StatusOK);
+    }
+
+    if (!control_due) {
+        return next_control_time_;
+    }
+
+    publish_metrics_();
+
+    if (sink_config_.control_interval > 0) {
+        next_control_time_ = current_time + sink_config_.control_interval;
+        if (deadline != 0 && deadline < next_control_time_) {
+            next_control_time_ = deadline;
+        }
+        return next_control_time_;
+    }
+
+    return deadline;
+}
+
+bool SenderSlot::reconfigure(const SenderLiveConfig& live_config) {
+    roc_panic_if(!is_valid());
+
+    return session_.reconfigure(live_config);
 }
 
 void SenderSlot::get_metrics(SenderSlotMetrics& slot_metrics,
@@ -149,11 +225,81 @@ void SenderSlot::get_metrics(SenderSlotMetrics& slot_metrics,
 
     session_.get_slot_metrics(slot_metrics);
 
+    if (repair_endpoint_) {
+        slot_metrics.dropped_repair_packets = repair_endpoint_->num_dropped_repair();
+    }
+
     if (party_metrics || party_count) {
         session_.get_participant_metrics(party_metrics, party_count);
     }
 }
 
+bool SenderSlot::load_metrics(SenderSlotMetrics& slot_metrics,
+                              SenderParticipantMetrics* party_metrics,
+                              size_t* party_count) const {
+    roc_panic_if(!is_valid());
+
+    return metrics_snapshot_.load(slot_metrics, party_metrics, party_count);
+}
+
+bool SenderSlot::transport_endpoints_ready_() const {
+    return source_endpoint_
+        && (repair_endpoint_ || sink_config_.fec_encoder.scheme == packet::FEC_None);
+}
+
+bool SenderSlot::start_transport_() {
+    if (!session_.frame_writer() && !session_.has_leader()) {
+        if (!sink_config_.enable_shared_encoding || !follow_peer_()) {
+            if (!session_.create_transport_pipeline(source_endpoint_.get(),
+                                                    repair_endpoint_.get(), path_mtu_)) {
+                return false;
+            }
+        }
+    }
+
+    if (session_.frame_writer() && redundant_endpoint_) {
+        if (!session_.add_redundant_endpoint(redundant_endpoint_.get())) {
+            return false;
+        }
+    }
+
+    if (session_.frame_writer() && !fanout_.has_output(*session_.frame_writer())) {
+        fanout_.add_output(*session_.frame_writer());
+    }
+
+    if (!active_) {
+        state_tracker_.add_active_sessions(+1);
+        active_ = true;
+    }
+
+    return true;
+}
+
+// Try to send packets encoded by one of the peer slots instead of encoding
+// the same audio once again.
+bool SenderSlot::follow_peer_() {
+    for (core::SharedPtr<SenderSlot> peer = peers_.front(); peer;
+         peer = peers_.nextof(*peer)) {
+        if (peer.get() == this || !peer->session_.frame_writer()) {
+            continue;
+        }
+
+        if (peer->session_.add_follower(session_, source_endpoint_.get(),
+                                        repair_endpoint_.get(), path_mtu_)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SenderSlot::publish_metrics_() {
+    metrics_data_.party_count = SenderMetricsSnapshot::MaxParticipants;
+    get_metrics(metrics_data_.slot, metrics_data_.party, &metrics_data_.party_count);
+
+    metrics_snapshot_.publish(metrics_data_);
+}
+
 SenderEndpoint*
 SenderSlot::create_source_endpoint_(address::Protocol proto,
                                     const address::SocketAddr& outbound_address,
@@ -178,8 +324,25 @@ SenderSlot::create_source_endpoint_(address::Protocol proto,
         return NULL;
     }
 
+    packet::IWriter* endpoint_writer = &outbound_writer;
+
+    // Receiver can detect bundles only if packets start with RTP header.
+    if (sink_config_.enable_bundling
+        && (proto == address::Proto_RTP || proto == address::Proto_RTP_Shm
+            || proto == address::Proto_RTP_LDPC_Source
+            || proto == address::Proto_RTP_RS8M_Source
+            || proto == address::Proto_RTP_RLC_Source)) {
+        source_bundler_.reset(new (source_bundler_) packet::Bundler(
+            outbound_writer, packet_factory_, sink_config_.bundler));
+        if (!source_bundler_) {
+            return NULL;
+        }
+        endpoint_writer = source_bundler_.get();
+    }
+
     source_endpoint_.reset(new (source_endpoint_) SenderEndpoint(
-        proto, state_tracker_, session_, outbound_address, outbound_writer, arena()));
+        proto, sink_config_.srtp, sink_config_.enable_rapid_sync, state_tracker_,
+        session_, outbound_address, *endpoint_writer, arena()));
     if (!source_endpoint_ || !source_endpoint_->is_valid()) {
         roc_log(LogError, "sender slot: can't create source endpoint");
         source_endpoint_.reset(NULL);
@@ -189,6 +352,48 @@ SenderSlot::create_source_endpoint_(address::Protocol proto,
     return source_endpoint_.get();
 }
 
+SenderEndpoint*
+SenderSlot::create_redundant_endpoint_(address::Protocol proto,
+                                       const address::SocketAddr& outbound_address,
+                                       packet::IWriter& outbound_writer) {
+    if (redundant_endpoint_) {
+        roc_log(LogError, "sender slot: redundant audio source endpoint is already set");
+        return NULL;
+    }
+
+    // Both paths carry identical packets.
+    if (proto != source_endpoint_->proto()) {
+        roc_log(LogError,
+                "sender slot: redundant audio source endpoint should use same"
+                " protocol as audio source endpoint: source=%s redundant=%s",
+                address::proto_to_str(source_endpoint_->proto()),
+                address::proto_to_str(proto));
+        return NULL;
+    }
+
+    packet::IWriter* endpoint_writer = &outbound_writer;
+
+    if (source_bundler_) {
+        redundant_bundler_.reset(new (redundant_bundler_) packet::Bundler(
+            outbound_writer, packet_factory_, sink_config_.bundler));
+        if (!redundant_bundler_) {
+            return NULL;
+        }
+        endpoint_writer = redundant_bundler_.get();
+    }
+
+    redundant_endpoint_.reset(new (redundant_endpoint_) SenderEndpoint(
+        proto, sink_config_.srtp, sink_config_.enable_rapid_sync, state_tracker_,
+        session_, outbound_address, *endpoint_writer, arena()));
+    if (!redundant_endpoint_ || !redundant_endpoint_->is_valid()) {
+        roc_log(LogError, "sender slot: can't create redundant source endpoint");
+        redundant_endpoint_.reset(NULL);
+        return NULL;
+    }
+
+    return redundant_endpoint_.get();
+}
+
 SenderEndpoint*
 SenderSlot::create_repair_endpoint_(address::Protocol proto,
                                     const address::SocketAddr& outbound_address,
@@ -214,7 +419,8 @@ SenderSlot::create_repair_endpoint_(address::Protocol proto,
     }
 
     repair_endpoint_.reset(new (repair_endpoint_) SenderEndpoint(
-        proto, state_tracker_, session_, outbound_address, outbound_writer, arena()));
+        proto, sink_config_.srtp, sink_config_.enable_rapid_sync, state_tracker_,
+        session_, outbound_address, outbound_writer, arena()));
     if (!repair_endpoint_ || !repair_endpoint_->is_valid()) {
         roc_log(LogError, "sender slot: can't create repair endpoint");
         repair_endpoint_.reset(NULL);
@@ -238,7 +444,8 @@ SenderSlot::create_control_endpoint_(address::Protocol proto,
     }
 
     control_endpoint_.reset(new (control_endpoint_) SenderEndpoint(
-        proto, state_tracker_, session_, outbound_address, outbound_writer, arena()));
+        proto, sink_config_.srtp, sink_config_.enable_rapid_sync, state_tracker_,
+        session_, outbound_address, outbound_writer, arena()));
     if (!control_endpoint_ || !control_endpoint_->is_valid()) {
         roc_log(LogError, "sender slot: can't create control endpoint");
         control_endpoint_.reset(NULL);
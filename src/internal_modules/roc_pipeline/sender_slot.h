@@ -20,9 +20,12 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
+#include "roc_packet/bundler.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/fec_group_map.h"
 #include "roc_pipeline/metrics.h"
+#include "roc_pipeline/metrics_snapshot.h"
 #include "roc_pipeline/sender_endpoint.h"
 #include "roc_pipeline/sender_session.h"
 #include "roc_pipeline/state_tracker.h"
@@ -35,6 +38,12 @@ namespace pipeline {
 //! Contains:
 //!  - one or more related sender endpoints, one per each type
 //!  - one session associated with those endpoints
+//!
+//! If shared encoding is enabled, session may send packets encoded by
+//! session of one of the peer slots, see SenderSession.
+//!
+//! If redundancy is enabled, slot may have second source endpoint, and
+//! source packets are duplicated to both source endpoints.
 class SenderSlot : public core::RefCounted<SenderSlot, core::ArenaAllocation>,
                    public core::ListNode<> {
 public:
@@ -44,9 +53,11 @@ public:
                StateTracker& state_tracker,
                const rtp::EncodingMap& encoding_map,
                audio::Fanout& fanout,
+               core::List<SenderSlot>& peers,
                packet::PacketFactory& packet_factory,
                audio::FrameFactory& frame_factory,
-               core::IArena& arena);
+               core::IArena& arena,
+               FecGroupMap* fec_groups);
 
     ~SenderSlot();
 
@@ -54,26 +65,57 @@ public:
     bool is_valid() const;
 
     //! Add endpoint.
+    //! @remarks
+    //!  @p path_mtu defines MTU of network path towards @p outbound_address,
+    //!  or zero if it's unknown.
     SenderEndpoint* add_endpoint(address::Interface iface,
                                  address::Protocol proto,
                                  const address::SocketAddr& outbound_address,
-                                 packet::IWriter& outbound_writer);
+                                 packet::IWriter& outbound_writer,
+                                 size_t path_mtu = 0);
 
     //! Refresh pipeline according to current time.
+    //! @remarks
+    //!  Packets are sent on every call. If control interval is configured,
+    //!  session is refreshed and metrics are published only when it expires.
     //! @returns
     //!  deadline (absolute time) when refresh should be invoked again
     //!  if there are no frames
     core::nanoseconds_t refresh(core::nanoseconds_t current_time);
 
+    //! Change parameters of slot session on the fly.
+    ROC_ATTR_NODISCARD bool reconfigure(const SenderLiveConfig& live_config);
+
     //! Get metrics for slot and its participants.
     void get_metrics(SenderSlotMetrics& slot_metrics,
                      SenderParticipantMetrics* party_metrics,
                      size_t* party_count) const;
 
+    //! Get metrics for slot and its participants from last published snapshot.
+    //! @remarks
+    //!  Snapshot is published by pipeline thread once per refresh(), or once
+    //!  per control interval, if it's configured.
+    //!  Unlike get_metrics(), can be called from any thread and is lock-free.
+    //! @returns
+    //!  false if snapshot is not available; see MetricsSnapshot::load().
+    bool load_metrics(SenderSlotMetrics& slot_metrics,
+                      SenderParticipantMetrics* party_metrics,
+                      size_t* party_count) const;
+
 private:
+    void publish_metrics_();
+
+    bool transport_endpoints_ready_() const;
+    bool start_transport_();
+    bool follow_peer_();
+
     SenderEndpoint* create_source_endpoint_(address::Protocol proto,
                                             const address::SocketAddr& outbound_address,
                                             packet::IWriter& outbound_writer);
+    SenderEndpoint*
+    create_redundant_endpoint_(address::Protocol proto,
+                               const address::SocketAddr& outbound_address,
+                               packet::IWriter& outbound_writer);
     SenderEndpoint* create_repair_endpoint_(address::Protocol proto,
                                             const address::SocketAddr& outbound_address,
                                             packet::IWriter& outbound_writer);
@@ -84,14 +126,33 @@ private:
     const SenderSinkConfig sink_config_;
 
     audio::Fanout& fanout_;
+    core::List<SenderSlot>& peers_;
+    packet::PacketFactory& packet_factory_;
+
+    // Combines source packets into datagrams, if bundling is enabled.
+    core::Optional<packet::Bundler> source_bundler_;
+    core::Optional<packet::Bundler> redundant_bundler_;
 
     core::Optional<SenderEndpoint> source_endpoint_;
+    // Second source endpoint, if redundancy is enabled.
+    core::Optional<SenderEndpoint> redundant_endpoint_;
     core::Optional<SenderEndpoint> repair_endpoint_;
     core::Optional<SenderEndpoint> control_endpoint_;
 
+    // Smallest known MTU of source and repair paths.
+    size_t path_mtu_;
+
     StateTracker& state_tracker_;
     SenderSession session_;
 
+    // Whether session is counted in state tracker.
+    bool active_;
+
+    core::nanoseconds_t next_control_time_;
+
+    SenderMetricsSnapshot::Data metrics_data_;
+    SenderMetricsSnapshot metrics_snapshot_;
+
     bool valid_;
 };
 
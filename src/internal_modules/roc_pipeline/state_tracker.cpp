@@ -14,7 +14,9 @@ namespace pipeline {
 
 StateTracker::StateTracker()
     : active_sessions_(0)
-    , pending_packets_(0) {
+    , pending_packets_(0)
+    , waiting_(0)
+    , sem_posted_(0) {
 }
 
 sndio::DeviceState StateTracker::get_state() const {
@@ -39,6 +41,10 @@ size_t StateTracker::num_active_sessions() const {
 void StateTracker::add_active_sessions(int increment) {
     const long result = active_sessions_ += increment;
     roc_panic_if(result < 0);
+
+    if (result == increment && increment > 0) {
+        signal_active_();
+    }
 }
 
 size_t StateTracker::num_pending_packets() const {
@@ -48,6 +54,45 @@ size_t StateTracker::num_pending_packets() const {
 void StateTracker::add_pending_packets(int increment) {
     const long result = pending_packets_ += increment;
     roc_panic_if(result < 0);
+
+    if (result == increment && increment > 0) {
+        signal_active_();
+    }
+}
+
+bool StateTracker::wait_active(core::nanoseconds_t deadline) {
+    // Set flag before checking state, so that concurrent transition to
+    // active state either is seen by the check or posts semaphore.
+    waiting_ = 1;
+
+    for (;;) {
+        if (get_state() == sndio::DeviceState_Active) {
+            break;
+        }
+
+        if (!sem_.timed_wait(deadline)) {
+            break;
+        }
+
+        sem_posted_ = 0;
+    }
+
+    waiting_ = 0;
+
+    return get_state() == sndio::DeviceState_Active;
+}
+
+// Invoked on transition of a counter from zero, which is rare, so that
+// regular updates of counters don't touch semaphore.
+void StateTracker::signal_active_() {
+    if (!waiting_) {
+        return;
+    }
+
+    // post at most once per wakeup
+    if (sem_posted_.compare_exchange(0, 1)) {
+        sem_.post();
+    }
 }
 
 } // namespace pipeline
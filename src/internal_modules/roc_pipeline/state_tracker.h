@@ -14,7 +14,9 @@
 
 #include "roc_core/atomic.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_sndio/device_state.h"
 
 namespace roc {
@@ -47,9 +49,24 @@ public:
     //! Add/subtract to pending packets counter.
     void add_pending_packets(int increment);
 
+    //! Block until state becomes active or deadline expires.
+    //! @remarks
+    //!  State becomes active when a session is created or a packet arrives.
+    //!  Deadline is in the same time domain as core::timestamp(ClockMonotonic).
+    //!  Only one thread may wait at a time.
+    //! @returns
+    //!  true if state is active.
+    bool wait_active(core::nanoseconds_t deadline);
+
 private:
+    void signal_active_();
+
     core::Atomic<int> active_sessions_;
     core::Atomic<int> pending_packets_;
+
+    core::Semaphore sem_;
+    core::Atomic<int> waiting_;
+    core::Atomic<int> sem_posted_;
 };
 
 } // namespace pipeline
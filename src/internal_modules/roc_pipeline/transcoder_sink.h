@@ -16,6 +16,7 @@
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/iresampler.h"
 #include "roc_audio/null_writer.h"
+#include "roc_audio/pcm_mapper_writer.h"
 #include "roc_audio/profiling_writer.h"
 #include "roc_audio/resampler_writer.h"
 #include "roc_core/ipool.h"
@@ -83,11 +84,15 @@ private:
 
     audio::NullWriter null_writer_;
 
+    core::Optional<audio::PcmMapperWriter> output_pcm_mapper_writer_;
+
     core::Optional<audio::ChannelMapperWriter> channel_mapper_writer_;
 
     core::Optional<audio::ResamplerWriter> resampler_writer_;
     core::SharedPtr<audio::IResampler> resampler_;
 
+    core::Optional<audio::PcmMapperWriter> input_pcm_mapper_writer_;
+
     core::Optional<audio::ProfilingWriter> profiler_;
 
     audio::IFrameWriter* frame_writer_;
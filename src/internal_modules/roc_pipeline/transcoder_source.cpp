@@ -27,47 +27,97 @@ TranscoderSource::TranscoderSource(const TranscoderConfig& config,
 
     audio::IFrameReader* frm_reader = &input_source_;
 
-    if (config_.input_sample_spec.channel_set()
-        != config_.output_sample_spec.channel_set()) {
-        const audio::SampleSpec from_spec(config_.input_sample_spec.sample_rate(),
-                                          audio::Sample_RawFormat,
-                                          config_.input_sample_spec.channel_set());
-
-        const audio::SampleSpec to_spec(config_.input_sample_spec.sample_rate(),
-                                        audio::Sample_RawFormat,
-                                        config_.output_sample_spec.channel_set());
-
-        channel_mapper_reader_.reset(
-            new (channel_mapper_reader_) audio::ChannelMapperReader(
-                *frm_reader, frame_factory_, from_spec, to_spec));
-        if (!channel_mapper_reader_ || !channel_mapper_reader_->is_valid()) {
+    const audio::SampleSpec& in_spec = config_.input_sample_spec;
+    const audio::SampleSpec& out_spec = config_.output_sample_spec;
+
+    const bool same_rate = in_spec.sample_rate() == out_spec.sample_rate();
+    const bool same_chans = in_spec.channel_set() == out_spec.channel_set();
+
+    if (in_spec == out_spec) {
+        // Fast path: identical specs, frames are read directly from input
+        // source into caller's buffer, without intermediate stages.
+    } else if (same_rate && same_chans) {
+        // Fast path: only sample format differs, map it with a single pass,
+        // without converting to raw samples in between.
+        output_pcm_mapper_reader_.reset(
+            new (output_pcm_mapper_reader_) audio::PcmMapperReader(
+                *frm_reader, frame_factory_, in_spec, out_spec));
+        if (!output_pcm_mapper_reader_ || !output_pcm_mapper_reader_->is_valid()) {
             return;
         }
-        frm_reader = channel_mapper_reader_.get();
-    }
-
-    if (config_.input_sample_spec.sample_rate()
-        != config_.output_sample_spec.sample_rate()) {
-        const audio::SampleSpec from_spec(config_.input_sample_spec.sample_rate(),
-                                          audio::Sample_RawFormat,
-                                          config_.output_sample_spec.channel_set());
+        frm_reader = output_pcm_mapper_reader_.get();
+    } else {
+        // Channel mapper and resampler operate on raw samples, so input
+        // is converted to raw format before them, and output is converted
+        // from raw format after them. Stages not needed are skipped.
+        if (!in_spec.is_raw()) {
+            const audio::SampleSpec to_spec(in_spec.sample_rate(),
+                                            audio::Sample_RawFormat,
+                                            in_spec.channel_set());
+
+            input_pcm_mapper_reader_.reset(
+                new (input_pcm_mapper_reader_) audio::PcmMapperReader(
+                    *frm_reader, frame_factory_, in_spec, to_spec));
+            if (!input_pcm_mapper_reader_ || !input_pcm_mapper_reader_->is_valid()) {
+                return;
+            }
+            frm_reader = input_pcm_mapper_reader_.get();
+        }
 
-        const audio::SampleSpec to_spec(config_.output_sample_spec.sample_rate(),
-                                        audio::Sample_RawFormat,
-                                        config_.output_sample_spec.channel_set());
+        if (!same_chans) {
+            const audio::SampleSpec from_spec(in_spec.sample_rate(),
+                                              audio::Sample_RawFormat,
+                                              in_spec.channel_set());
+
+            const audio::SampleSpec to_spec(in_spec.sample_rate(),
+                                            audio::Sample_RawFormat,
+                                            out_spec.channel_set());
+
+            channel_mapper_reader_.reset(
+                new (channel_mapper_reader_) audio::ChannelMapperReader(
+                    *frm_reader, frame_factory_, from_spec, to_spec));
+            if (!channel_mapper_reader_ || !channel_mapper_reader_->is_valid()) {
+                return;
+            }
+            frm_reader = channel_mapper_reader_.get();
+        }
 
-        resampler_.reset(audio::ResamplerMap::instance().new_resampler(
-            arena, frame_factory_, config_.resampler, from_spec, to_spec));
-        if (!resampler_) {
-            return;
+        if (!same_rate) {
+            const audio::SampleSpec from_spec(in_spec.sample_rate(),
+                                              audio::Sample_RawFormat,
+                                              out_spec.channel_set());
+
+            const audio::SampleSpec to_spec(out_spec.sample_rate(),
+                                            audio::Sample_RawFormat,
+                                            out_spec.channel_set());
+
+            resampler_.reset(audio::ResamplerMap::instance().new_resampler(
+                arena, frame_factory_, config_.resampler, from_spec, to_spec));
+            if (!resampler_) {
+                return;
+            }
+
+            resampler_reader_.reset(new (resampler_reader_) audio::ResamplerReader(
+                *frm_reader, *resampler_, from_spec, to_spec));
+            if (!resampler_reader_ || !resampler_reader_->is_valid()) {
+                return;
+            }
+            frm_reader = resampler_reader_.get();
         }
 
-        resampler_reader_.reset(new (resampler_reader_) audio::ResamplerReader(
-            *frm_reader, *resampler_, from_spec, to_spec));
-        if (!resampler_reader_ || !resampler_reader_->is_valid()) {
-            return;
+        if (!out_spec.is_raw()) {
+            const audio::SampleSpec from_spec(out_spec.sample_rate(),
+                                              audio::Sample_RawFormat,
+                                              out_spec.channel_set());
+
+            output_pcm_mapper_reader_.reset(
+                new (output_pcm_mapper_reader_) audio::PcmMapperReader(
+                    *frm_reader, frame_factory_, from_spec, out_spec));
+            if (!output_pcm_mapper_reader_ || !output_pcm_mapper_reader_->is_valid()) {
+                return;
+            }
+            frm_reader = output_pcm_mapper_reader_.get();
         }
-        frm_reader = resampler_reader_.get();
     }
 
     if (config_.enable_profiling) {
@@ -15,6 +15,7 @@
 #include "roc_audio/channel_mapper_reader.h"
 #include "roc_audio/frame_factory.h"
 #include "roc_audio/iresampler.h"
+#include "roc_audio/pcm_mapper_reader.h"
 #include "roc_audio/profiling_reader.h"
 #include "roc_audio/resampler_reader.h"
 #include "roc_core/ipool.h"
@@ -83,11 +84,15 @@ public:
 private:
     audio::FrameFactory frame_factory_;
 
+    core::Optional<audio::PcmMapperReader> input_pcm_mapper_reader_;
+
     core::Optional<audio::ChannelMapperReader> channel_mapper_reader_;
 
     core::Optional<audio::ResamplerReader> resampler_reader_;
     core::SharedPtr<audio::IResampler> resampler_;
 
+    core::Optional<audio::PcmMapperReader> output_pcm_mapper_reader_;
+
     core::Optional<audio::ProfilingReader> profiler_;
 
     sndio::ISource& input_source_;
@@ -426,6 +426,44 @@ void Builder::end_xr() {
     end_packet_();
 }
 
+void Builder::begin_nack(const header::NackPacket& nack) {
+    roc_panic_if_msg(state_ != TOP, "rtcp builder: wrong call order");
+
+    roc_panic_if_msg(config_.enable_sr_rr && !sr_written_ && !rr_written_,
+                     "rtcp builder: first packet should be SR or RR");
+
+    state_ = NACK_HEAD;
+
+    header::NackPacket* p = (header::NackPacket*)begin_packet_(sizeof(nack));
+    if (!p) {
+        return;
+    }
+    memcpy(p, &nack, sizeof(nack));
+}
+
+void Builder::add_nack_block(const header::NackBlock& block) {
+    roc_panic_if_msg(state_ != NACK_HEAD && state_ != NACK_BLOCK,
+                     "rtcp builder: wrong call order");
+
+    state_ = NACK_BLOCK;
+
+    header::NackBlock* p = (header::NackBlock*)add_block_(sizeof(block));
+    if (!p) {
+        return;
+    }
+    memcpy(p, &block, sizeof(block));
+
+    cur_pkt_header_->set_len_bytes(cur_pkt_slice_.size());
+}
+
+void Builder::end_nack() {
+    roc_panic_if_msg(state_ != NACK_BLOCK, "rtcp builder: wrong call order");
+
+    state_ = TOP;
+
+    end_packet_();
+}
+
 void Builder::add_padding(size_t padding_len) {
     roc_panic_if_msg(state_ != TOP, "rtcp builder: wrong call order");
 
@@ -109,6 +109,20 @@ public:
 
     //! @}
 
+    //! @name Generic NACK (RTPFB)
+    //! @{
+
+    //! Start NACK packet inside compound RTCP packet.
+    void begin_nack(const header::NackPacket& nack);
+
+    //! Add block to current NACK packet.
+    void add_nack_block(const header::NackBlock& block);
+
+    //! Finish current NACK packet.
+    void end_nack();
+
+    //! @}
+
     //! @name Session Description (SDES)
     //! @{
 
@@ -169,6 +183,8 @@ private:
         XR_HEAD,
         XR_DLRR_HEAD,
         XR_DLRR_REPORT,
+        NACK_HEAD,
+        NACK_BLOCK,
         SDES_HEAD,
         SDES_CHUNK,
         BYE_HEAD,
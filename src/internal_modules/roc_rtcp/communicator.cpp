@@ -102,7 +102,7 @@ status::StatusCode Communicator::process_packet(const packet::PacketPtr& packet,
 
     // First parse SDES packets to create/recreate/update streams.
     process_all_descriptions_(traverser);
-    // Then parse SR, RR, and XR to create/update streams.
+    // Then parse SR, RR, and XR to create/update streams, and NACK.
     process_all_reports_(traverser);
     // Then parse BYE packets to terminate streams.
     process_all_goodbyes_(traverser);
@@ -171,6 +171,10 @@ void Communicator::process_all_reports_(const Traverser& traverser) {
             process_extended_report_(xr);
         } break;
 
+        case Traverser::Iterator::NACK: {
+            reporter_.process_nack(iter.get_nack());
+        } break;
+
         default:
             break;
         }
@@ -363,8 +367,11 @@ status::StatusCode Communicator::generate_reports(core::nanoseconds_t current_ti
     }
 
     // TODO(gh-674): use IntervalComputer
-    next_deadline_ = current_time + config_.report_interval
-        - ((current_time - next_deadline_) % config_.report_interval);
+    // Interval grows with session size, see Config::members_per_interval.
+    const core::nanoseconds_t report_interval = reporter_.report_interval();
+
+    next_deadline_ = current_time + report_interval
+        - ((current_time - next_deadline_) % report_interval);
 
     roc_log(LogTrace, "rtcp communicator: generating report packets");
 
@@ -660,6 +667,10 @@ void Communicator::generate_reports_payload_(Builder& bld) {
     if (config_.enable_xr) {
         generate_extended_report_(bld);
     }
+    // Add NACK.
+    if (config_.enable_nack && reporter_.is_receiving()) {
+        generate_nack_(bld);
+    }
     // Add SDES.
     if (config_.enable_sdes) {
         generate_description_(bld);
@@ -802,6 +813,36 @@ void Communicator::generate_extended_report_(Builder& bld) {
     }
 }
 
+void Communicator::generate_nack_(Builder& bld) {
+    // One NACK per receiving stream with recent losses.
+    for (size_t stream_index = recv_stream_index_; stream_index < recv_stream_count_;
+         stream_index++) {
+        if (!next_recv_stream_(stream_index)) {
+            break;
+        }
+
+        const size_t n_blocks = reporter_.num_nack_blocks(dest_addr_index_, stream_index);
+        if (n_blocks == 0) {
+            continue;
+        }
+
+        header::NackPacket nack;
+        reporter_.generate_nack(dest_addr_index_, stream_index, nack);
+
+        bld.begin_nack(nack);
+
+        for (size_t block_index = 0; block_index < n_blocks; block_index++) {
+            header::NackBlock blk;
+            reporter_.generate_nack_block(dest_addr_index_, stream_index, block_index,
+                                          blk);
+
+            bld.add_nack_block(blk);
+        }
+
+        bld.end_nack();
+    }
+}
+
 void Communicator::generate_empty_report_(Builder& bld) {
     header::ReceiverReportPacket rr;
     reporter_.generate_rr(rr);
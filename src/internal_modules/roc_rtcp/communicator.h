@@ -131,6 +131,7 @@ private:
 
     void generate_standard_report_(Builder& bld);
     void generate_extended_report_(Builder& bld);
+    void generate_nack_(Builder& bld);
     void generate_empty_report_(Builder& bld);
     void generate_description_(Builder& bld);
     void generate_goodbye_(Builder& bld);
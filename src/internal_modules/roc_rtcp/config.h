@@ -28,6 +28,19 @@ struct Config {
     //! Timeout to remove inactive streams.
     core::nanoseconds_t inactivity_timeout;
 
+    //! Number of session members that fit into one report interval.
+    //! When session grows beyond this size, report interval and inactivity
+    //! timeout are scaled up proportionally to the number of members, as
+    //! suggested by RFC 3550 section 6.2. This keeps RTCP traffic and
+    //! processing cost per second bounded in large multicast sessions.
+    //! Zero disables scaling.
+    size_t members_per_interval;
+
+    //! Number of streams for which memory is reserved in advance.
+    //! Allows to avoid allocations and rehashing when many members
+    //! join session at once. Zero disables reservation.
+    size_t reserved_streams;
+
     //! RTT estimation config.
     RttConfig rtt;
 
@@ -40,12 +53,21 @@ struct Config {
     //! Enable generation of SDES packets.
     bool enable_sdes;
 
+    //! Enable generation of Generic NACK packets (RFC 4585).
+    //! Receiver asks sender to retransmit recently lost packets.
+    //! Lost packets are reported with regular reports, so report_interval
+    //! should be well below target latency for retransmission to be useful.
+    bool enable_nack;
+
     Config()
         : report_interval(core::Millisecond * 200)
         , inactivity_timeout(core::Second * 5)
+        , members_per_interval(64)
+        , reserved_streams(0)
         , enable_sr_rr(true)
         , enable_xr(true)
-        , enable_sdes(true) {
+        , enable_sdes(true)
+        , enable_nack(false) {
     }
 };
 
@@ -103,12 +103,13 @@ enum Version {
 
 //! RTCP packet type.
 enum PacketType {
-    RTCP_SR = 200,   //!< Sender report packet.
-    RTCP_RR = 201,   //!< Receiver report packet.
-    RTCP_SDES = 202, //!< Source Description packet.
-    RTCP_BYE = 203,  //!< BYE packet.
-    RTCP_APP = 204,  //!< APP-specific packet.
-    RTCP_XR = 207    //!< Extended report packet.
+    RTCP_SR = 200,    //!< Sender report packet.
+    RTCP_RR = 201,    //!< Receiver report packet.
+    RTCP_SDES = 202,  //!< Source Description packet.
+    RTCP_BYE = 203,   //!< BYE packet.
+    RTCP_APP = 204,   //!< APP-specific packet.
+    RTCP_RTPFB = 205, //!< Transport layer feedback packet.
+    RTCP_XR = 207     //!< Extended report packet.
 };
 
 //! RTCP packet header, common for all RTCP packet types.
@@ -1017,6 +1018,161 @@ public:
     }
 } ROC_ATTR_PACKED_END;
 
+//! Transport layer feedback message type.
+//! Stored in counter field of RTPFB packet header.
+enum RtpfbFormat {
+    RTPFB_NACK = 1 //!< Generic NACK.
+};
+
+//! Generic NACK block.
+//!
+//! RFC 4585 6.2.1: "Generic NACK"
+//!
+//! @code
+//!  0                   1                   2                   3
+//!  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! |            PID                |             BLP               |
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+ROC_ATTR_PACKED_BEGIN class NackBlock {
+private:
+    // Seqnum of lost packet.
+    uint16_t pid_;
+    // Bitmask of following lost packets.
+    uint16_t blp_;
+
+public:
+    NackBlock() {
+        reset();
+    }
+
+    //! Reset to initial state (all zeros).
+    void reset() {
+        pid_ = 0;
+        blp_ = 0;
+    }
+
+    //! Get seqnum of lost packet.
+    packet::seqnum_t pid() const {
+        return core::ntoh16u(pid_);
+    }
+
+    //! Set seqnum of lost packet.
+    void set_pid(const packet::seqnum_t sn) {
+        pid_ = core::hton16u(sn);
+    }
+
+    //! Get bitmask of following lost packets.
+    //! If bit i is set, packet with seqnum (PID + i + 1) is lost too.
+    uint16_t blp() const {
+        return core::ntoh16u(blp_);
+    }
+
+    //! Set bitmask of following lost packets.
+    void set_blp(const uint16_t mask) {
+        blp_ = core::hton16u(mask);
+    }
+} ROC_ATTR_PACKED_END;
+
+//! Generic NACK RTCP packet.
+//!
+//! RFC 4585 6.1: "Common Packet Format for Feedback Messages"
+//! RFC 4585 6.2.1: "Generic NACK"
+//!
+//! @code
+//!  0                   1                   2                   3
+//!  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! |V=2|P| FMT=1   |   PT=RTPFB=205|          length               |
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! |                  SSRC of packet sender                        |
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! |                  SSRC of media source                         |
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! :                NACK blocks (PID + BLP)                        :
+//! +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+ROC_ATTR_PACKED_BEGIN class NackPacket {
+private:
+    PacketHeader header_;
+
+    // Receiver that sends feedback.
+    uint32_t ssrc_;
+
+    // Sender to which feedback is addressed.
+    uint32_t media_ssrc_;
+
+public:
+    NackPacket() {
+        reset();
+    }
+
+    //! Reset to initial state (all zeros).
+    void reset() {
+        header_.reset(RTCP_RTPFB);
+        header_.set_counter(RTPFB_NACK);
+        ssrc_ = 0;
+        media_ssrc_ = 0;
+    }
+
+    //! Get common packet header.
+    const PacketHeader& header() const {
+        return header_;
+    }
+
+    //! Get common packet header.
+    PacketHeader& header() {
+        return header_;
+    }
+
+    //! Get SSRC of packet sender.
+    packet::stream_source_t ssrc() const {
+        return core::ntoh32u(ssrc_);
+    }
+
+    //! Set SSRC of packet sender.
+    void set_ssrc(const packet::stream_source_t s) {
+        ssrc_ = core::hton32u(s);
+    }
+
+    //! Get SSRC of media source.
+    packet::stream_source_t media_ssrc() const {
+        return core::ntoh32u(media_ssrc_);
+    }
+
+    //! Set SSRC of media source.
+    void set_media_ssrc(const packet::stream_source_t s) {
+        media_ssrc_ = core::hton32u(s);
+    }
+
+    //! Get number of blocks.
+    //! Unlike other packets, NACK doesn't have blocks counter,
+    //! and number of blocks is derived from packet length.
+    size_t num_blocks() const {
+        size_t len = header_.len_bytes();
+        if (header_.has_padding() && len > sizeof(header_)) {
+            // Last byte of padding holds padding length.
+            const size_t padding = ((const uint8_t*)this)[len - 1];
+            len = padding < len ? len - padding : 0;
+        }
+        if (len < sizeof(*this)) {
+            return 0;
+        }
+        return (len - sizeof(*this)) / sizeof(NackBlock);
+    }
+
+    //! Get NACK block by index.
+    const NackBlock& get_block(const size_t i) const {
+        return get_block_by_index<const NackBlock>(this, i, num_blocks(), "rtcp nack");
+    }
+
+    //! Get NACK block by index.
+    NackBlock& get_block(const size_t i) {
+        return get_block_by_index<NackBlock>(this, i, num_blocks(), "rtcp nack");
+    }
+} ROC_ATTR_PACKED_END;
+
 //! RTCP Extended Report Packet.
 //!
 //! RFC 3611 2: "XR Packet Format"
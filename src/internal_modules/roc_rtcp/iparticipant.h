@@ -81,6 +81,16 @@ public:
         return status::StatusOK;
     }
 
+    //! Notify local sending stream with lost packets.
+    //! Invoked when NACK was received from remote receiver, which asks to
+    //! retransmit packets with given seqnums.
+    //! @p recv_source_id identifies remote receiver which sent NACK.
+    //! @p seqnums points to array of @p n_seqnums lost packets.
+    virtual void notify_send_losses(packet::stream_source_t recv_source_id,
+                                    const packet::seqnum_t* seqnums,
+                                    size_t n_seqnums) {
+    }
+
     //! Check how many local receiving streams are present.
     //! Multiple local receiving streams are allowed, each one corresponding to
     //! its own remote sender with unique sender SSRC.
@@ -95,6 +95,24 @@ void print_sr(core::Printer& p, const header::SenderReportPacket& sr) {
     }
 }
 
+void print_nack(core::Printer& p, const header::NackPacket& nack) {
+    p.writef("+ nack:\n");
+
+    print_header(p, nack.header());
+
+    p.writef("|- body:\n");
+    p.writef("|-- ssrc: %lu\n", (unsigned long)nack.ssrc());
+    p.writef("|-- media_ssrc: %lu\n", (unsigned long)nack.media_ssrc());
+
+    for (size_t n = 0; n < nack.num_blocks(); n++) {
+        const header::NackBlock& blk = nack.get_block(n);
+
+        p.writef("|- block:\n");
+        p.writef("|-- pid: %lu\n", (unsigned long)blk.pid());
+        p.writef("|-- blp: 0x%04x\n", (unsigned)blk.blp());
+    }
+}
+
 void print_xr_block_header(core::Printer& p, const header::XrBlockHeader& hdr) {
     p.writef("|-- block header:\n");
     p.writef("|--- type: %d\n", (int)hdr.block_type());
@@ -333,6 +351,10 @@ void print_packet(const core::Slice<uint8_t>& data) {
             print_xr(p, xr);
         } break;
 
+        case Traverser::Iterator::NACK: {
+            print_nack(p, iter.get_nack());
+        } break;
+
         case Traverser::Iterator::SDES: {
             SdesTraverser sdes = iter.get_sdes();
             if (!sdes.parse()) {
@@ -21,6 +21,38 @@
 namespace roc {
 namespace rtcp {
 
+namespace {
+
+// Fill NACK block with oldest lost packet from bitmap and up to 16 lost
+// packets following it, and remove them from bitmap.
+// Bit N of bitmap corresponds to seqnum (last_seqnum - N).
+void pop_nack_block(uint64_t& losses,
+                    packet::seqnum_t last_seqnum,
+                    header::NackBlock& blk) {
+    roc_panic_if(losses == 0);
+
+    size_t pid_bit = 63;
+    while (!(losses & ((uint64_t)1 << pid_bit))) {
+        pid_bit--;
+    }
+
+    uint16_t blp = 0;
+    for (size_t n = 0; n < 16 && n < pid_bit; n++) {
+        const uint64_t bit = (uint64_t)1 << (pid_bit - n - 1);
+        if (losses & bit) {
+            blp |= (uint16_t)(1 << n);
+            losses &= ~bit;
+        }
+    }
+    losses &= ~((uint64_t)1 << pid_bit);
+
+    blk.reset();
+    blk.set_pid(packet::seqnum_t(last_seqnum - pid_bit));
+    blk.set_blp(blp);
+}
+
+} // namespace
+
 Reporter::Reporter(const Config& config, IParticipant& participant, core::IArena& arena)
     : arena_(arena)
     , participant_(participant)
@@ -60,6 +92,16 @@ Reporter::Reporter(const Config& config, IParticipant& participant, core::IArena
     local_source_id_ = part_info.source_id;
     strcpy(local_cname_, part_info.cname);
 
+    if (config_.reserved_streams != 0) {
+        if (!stream_pool_.reserve(config_.reserved_streams)
+            || !stream_map_.reserve(config_.reserved_streams)
+            || !address_map_.reserve(config_.reserved_streams)) {
+            roc_log(LogError, "rtcp reporter: can't reserve memory for %lu streams",
+                    (unsigned long)config_.reserved_streams);
+            return;
+        }
+    }
+
     roc_log(LogDebug,
             "rtcp reporter: initializing:"
             " local_ssrc=%lu local_cname=%s report_mode=%s report_addr=%s timeout=%.3fms",
@@ -104,6 +146,12 @@ size_t Reporter::total_streams() const {
     return stream_map_.size();
 }
 
+core::nanoseconds_t Reporter::report_interval() const {
+    roc_panic_if(!is_valid());
+
+    return scale_to_group_size_(config_.report_interval);
+}
+
 status::StatusCode Reporter::begin_processing(const address::SocketAddr& report_addr,
                                               core::nanoseconds_t report_time) {
     roc_panic_if(!is_valid());
@@ -550,6 +598,45 @@ void Reporter::process_queue_metrics_block(const header::XrPacket& xr,
     update_stream_(*stream);
 }
 
+// Process NACK generated by remote receiver.
+void Reporter::process_nack(const header::NackPacket& nack) {
+    roc_panic_if_msg(report_state_ != State_Processing,
+                     "rtcp reporter: invalid call order");
+
+    // SSRC of packet sender is stream receiver (RTCP packet originator).
+    // SSRC of media source is stream sender (RTCP packet recipient).
+    const packet::stream_source_t send_source_id = nack.media_ssrc();
+    const packet::stream_source_t recv_source_id = nack.ssrc();
+
+    detect_collision_(recv_source_id);
+
+    if (!has_local_send_report_ || send_source_id != local_source_id_) {
+        // This feedback is for different sender, not for us, so ignore it.
+        return;
+    }
+
+    roc_log(LogTrace,
+            "rtcp reporter: processing NACK: send_ssrc=%lu recv_ssrc=%lu n_blocks=%lu",
+            (unsigned long)send_source_id, (unsigned long)recv_source_id,
+            (unsigned long)nack.num_blocks());
+
+    for (size_t n = 0; n < nack.num_blocks(); n++) {
+        const header::NackBlock& blk = nack.get_block(n);
+
+        packet::seqnum_t seqnums[17];
+        size_t n_seqnums = 0;
+
+        seqnums[n_seqnums++] = blk.pid();
+        for (size_t bit = 0; bit < 16; bit++) {
+            if (blk.blp() & (1 << bit)) {
+                seqnums[n_seqnums++] = packet::seqnum_t(blk.pid() + bit + 1);
+            }
+        }
+
+        participant_.notify_send_losses(recv_source_id, seqnums, n_seqnums);
+    }
+}
+
 // Process BYE message generated by sender.
 void Reporter::process_goodbye(const packet::stream_source_t ssrc) {
     roc_panic_if_msg(report_state_ != State_Processing,
@@ -858,6 +945,75 @@ void Reporter::generate_queue_metrics_block(size_t addr_index,
     }
 }
 
+// Get number of NACK blocks to deliver to remote sender.
+size_t Reporter::num_nack_blocks(size_t addr_index, size_t stream_index) const {
+    roc_panic_if_msg(report_state_ != State_Generating,
+                     "rtcp reporter: invalid call order");
+
+    roc_panic_if_msg(!is_receiving(),
+                     "rtcp reporter: NACK can be generated only by receiver");
+
+    const Stream* stream = address_index_[addr_index]->recv_stream_index[stream_index];
+    roc_panic_if(!stream);
+
+    const packet::seqnum_t last_seqnum =
+        (packet::seqnum_t)stream->local_recv_report->ext_last_seqnum;
+    uint64_t losses = stream->local_recv_report->recent_losses;
+    size_t n_blocks = 0;
+
+    while (losses != 0) {
+        header::NackBlock blk;
+        pop_nack_block(losses, last_seqnum, blk);
+        n_blocks++;
+    }
+
+    return n_blocks;
+}
+
+// Generate NACK header to deliver to remote sender.
+void Reporter::generate_nack(size_t addr_index,
+                             size_t stream_index,
+                             header::NackPacket& nack) {
+    roc_panic_if_msg(report_state_ != State_Generating,
+                     "rtcp reporter: invalid call order");
+
+    roc_panic_if_msg(!is_receiving(),
+                     "rtcp reporter: NACK can be generated only by receiver");
+
+    Stream* stream = address_index_[addr_index]->recv_stream_index[stream_index];
+    roc_panic_if(!stream);
+
+    nack.reset();
+
+    nack.set_ssrc(local_source_id_);
+    nack.set_media_ssrc(stream->source_id);
+}
+
+// Generate NACK block to deliver to remote sender.
+void Reporter::generate_nack_block(size_t addr_index,
+                                   size_t stream_index,
+                                   size_t block_index,
+                                   header::NackBlock& blk) {
+    roc_panic_if_msg(report_state_ != State_Generating,
+                     "rtcp reporter: invalid call order");
+
+    roc_panic_if_msg(!is_receiving(),
+                     "rtcp reporter: NACK can be generated only by receiver");
+
+    Stream* stream = address_index_[addr_index]->recv_stream_index[stream_index];
+    roc_panic_if(!stream);
+
+    const packet::seqnum_t last_seqnum =
+        (packet::seqnum_t)stream->local_recv_report->ext_last_seqnum;
+    uint64_t losses = stream->local_recv_report->recent_losses;
+
+    // Blocks are not stored, but built from bitmap every time. Bitmap has
+    // only 64 bits, so there are at most 4 blocks.
+    for (size_t n = 0; n <= block_index; n++) {
+        pop_nack_block(losses, last_seqnum, blk);
+    }
+}
+
 bool Reporter::need_goodbye() const {
     roc_panic_if_msg(report_state_ != State_Generating,
                      "rtcp reporter: invalid call order");
@@ -1168,16 +1324,38 @@ status::StatusCode Reporter::rebuild_index_() {
         }
     }
 
-    roc_log(LogDebug, "rtcp reporter: completed index rebuild: n_streams=%lu n_addrs=%lu",
-            (unsigned long)stream_map_.size(), (unsigned long)address_map_.size());
+    roc_log(LogDebug,
+            "rtcp reporter: completed index rebuild: n_streams=%lu n_addrs=%lu"
+            " stream_rehashes=%lu stream_max_probe=%lu",
+            (unsigned long)stream_map_.size(), (unsigned long)address_map_.size(),
+            (unsigned long)stream_map_.num_rehashes(),
+            (unsigned long)stream_map_.max_probe_length());
 
     return status::StatusOK;
 }
 
+core::nanoseconds_t
+Reporter::scale_to_group_size_(core::nanoseconds_t duration) const {
+    // Every remote stream represents one remote participant, plus one for us.
+    const size_t n_members = stream_map_.size() + 1;
+
+    if (config_.members_per_interval == 0 || n_members <= config_.members_per_interval) {
+        return duration;
+    }
+
+    // Each member sends reports to all other members, so with fixed interval,
+    // total traffic and processing cost grows with the square of group size.
+    // Stretch interval proportionally, so that per-member cost remains constant.
+    return duration * (core::nanoseconds_t)n_members
+        / (core::nanoseconds_t)config_.members_per_interval;
+}
+
 void Reporter::detect_timeouts_() {
     // If stream was not updated after deadline (i.e. there were no new reports),
-    // it should be removed.
-    const core::nanoseconds_t deadline = report_time_ - config_.inactivity_timeout;
+    // it should be removed. Timeout is scaled together with report interval,
+    // otherwise streams of large sessions would expire between reports.
+    const core::nanoseconds_t deadline =
+        report_time_ - scale_to_group_size_(config_.inactivity_timeout);
 
     while (Stream* stream = stream_lru_.back()) {
         // Recently updated streams are moved to the front of the list.
@@ -1200,7 +1378,7 @@ void Reporter::detect_timeouts_() {
                 " ssrc=%lu cname=%s last_update=%lld deadline=%lld timeout=%.3fms",
                 (unsigned long)stream->source_id, cname_to_str(stream->cname).c_str(),
                 (long long)stream->last_update, (long long)deadline,
-                (double)config_.inactivity_timeout / core::Millisecond);
+                (double)(report_time_ - deadline) / core::Millisecond);
 
         {
             // If we're receiving, notify pipeline that sender timed out.
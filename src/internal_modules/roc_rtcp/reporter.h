@@ -108,6 +108,11 @@ public:
     //! Get number of tracked streams, for testing.
     size_t total_streams() const;
 
+    //! Get interval between reports.
+    //! Same as configured interval, but scaled up if the number of
+    //! session members exceeds Config::members_per_interval.
+    core::nanoseconds_t report_interval() const;
+
     //! @name Report processing
     //! @{
 
@@ -146,6 +151,9 @@ public:
     void process_queue_metrics_block(const header::XrPacket& xr,
                                      const header::XrQueueMetricsBlock& blk);
 
+    //! Process Generic NACK packet.
+    void process_nack(const header::NackPacket& nack);
+
     //! Process BYE message.
     void process_goodbye(packet::stream_source_t ssrc);
 
@@ -228,6 +236,26 @@ public:
                                       size_t stream_index,
                                       header::XrQueueMetricsBlock& blk);
 
+    //! Get number of NACK blocks needed to report lost packets.
+    //! Zero if there are no recent losses.
+    //! @p addr_index should be in range [0; num_dest_addresses()-1].
+    //! @p stream_index should be in range [0; num_receiving_streams()-1].
+    size_t num_nack_blocks(size_t addr_index, size_t stream_index) const;
+
+    //! Generate Generic NACK header.
+    //! @p addr_index should be in range [0; num_dest_addresses()-1].
+    //! @p stream_index should be in range [0; num_receiving_streams()-1].
+    void generate_nack(size_t addr_index, size_t stream_index, header::NackPacket& nack);
+
+    //! Generate Generic NACK block.
+    //! @p addr_index should be in range [0; num_dest_addresses()-1].
+    //! @p stream_index should be in range [0; num_receiving_streams()-1].
+    //! @p block_index should be in range [0; num_nack_blocks()-1].
+    void generate_nack_block(size_t addr_index,
+                             size_t stream_index,
+                             size_t block_index,
+                             header::NackBlock& blk);
+
     //! Check if BYE message should be included.
     bool need_goodbye() const;
 
@@ -386,7 +414,7 @@ private:
         }
 
         static core::hashsum_t key_hash(const address::SocketAddr& addr) {
-            return core::hashsum_mem(addr.saddr(), (size_t)addr.slen());
+            return addr.hash();
         }
 
         static bool key_equal(const address::SocketAddr& addr1,
@@ -400,6 +428,8 @@ private:
     status::StatusCode query_streams_();
     status::StatusCode rebuild_index_();
 
+    core::nanoseconds_t scale_to_group_size_(core::nanoseconds_t duration) const;
+
     void detect_timeouts_();
     void detect_collision_(packet::stream_source_t source_id);
     void resolve_collision_();
@@ -140,6 +140,12 @@ struct RecvReport {
     //! and the loss may be negative if there are duplicates.
     int64_t cum_loss;
 
+    //! Bitmap of recently lost packets.
+    //! Bit N is set if packet with seqnum (ext_last_seqnum - N) is lost.
+    //! On receiver, used to generate NACK, if it's enabled in config.
+    //! On sender, always zero, lost packets are reported separately.
+    uint64_t recent_losses;
+
     //! Estimated interarrival jitter.
     //! An estimate of the statistical variance of the RTP data packet
     //! interarrival time.
@@ -180,6 +186,7 @@ struct RecvReport {
         , ext_last_seqnum(0)
         , packet_count(0)
         , cum_loss(0)
+        , recent_losses(0)
         , jitter(0)
         , niq_latency(0)
         , niq_stalling(0)
@@ -125,6 +125,18 @@ void Traverser::Iterator::next_packet_() {
         case header::RTCP_XR:
             state_ = XR;
             return;
+        case header::RTCP_RTPFB:
+            if (cur_pkt_header_->counter() != header::RTPFB_NACK) {
+                // Unknown feedback message type.
+                break;
+            }
+            if (!remove_padding_() || !check_nack_()) {
+                // Skipping invalid NACK packet.
+                error_ = true;
+                break;
+            }
+            state_ = NACK;
+            return;
         default:
             // Unknown packet type.
             break;
@@ -142,7 +154,7 @@ bool Traverser::Iterator::remove_padding_() {
             || padding_len > cur_pkt_len_ - sizeof(header::PacketHeader)) {
             return false;
         }
-        cur_pkt_slice_ = buf_.subslice(0, cur_pkt_len_ - padding_len);
+        cur_pkt_slice_ = cur_pkt_slice_.subslice(0, cur_pkt_len_ - padding_len);
     }
     return true;
 }
@@ -173,6 +185,14 @@ bool Traverser::Iterator::check_rr_() {
     return true;
 }
 
+bool Traverser::Iterator::check_nack_() {
+    if (sizeof(header::NackPacket) > cur_pkt_slice_.size()) {
+        return false;
+    }
+
+    return true;
+}
+
 const header::SenderReportPacket& Traverser::Iterator::get_sr() const {
     roc_panic_if_msg(state_ != SR, "rtcp traverser: get_sr() called in wrong state %d",
                      (int)state_);
@@ -191,6 +211,14 @@ const header::ReceiverReportPacket& Traverser::Iterator::get_rr() const {
     return *rr;
 }
 
+const header::NackPacket& Traverser::Iterator::get_nack() const {
+    roc_panic_if_msg(state_ != NACK,
+                     "rtcp traverser: get_nack() called in wrong state %d", (int)state_);
+
+    const header::NackPacket* nack = (const header::NackPacket*)cur_pkt_slice_.data();
+    return *nack;
+}
+
 XrTraverser Traverser::Iterator::get_xr() const {
     roc_panic_if_msg(state_ != XR, "rtcp traverser: get_xr() called in wrong state %d",
                      (int)state_);
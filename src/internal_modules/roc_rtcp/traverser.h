@@ -32,6 +32,7 @@ public:
             SR,    //!< SR packet.
             RR,    //!< RR packet.
             XR,    //!< XR packet.
+            NACK,  //!< Generic NACK packet.
             SDES,  //!< SDES packet.
             BYE,   //!< BYE packet.
             END    //!< Parsed whole compound packet.
@@ -55,6 +56,10 @@ public:
         //! @pre Can be used if next() returned XR.
         XrTraverser get_xr() const;
 
+        //! Get Generic NACK packet.
+        //! @pre Can be used if next() returned NACK.
+        const header::NackPacket& get_nack() const;
+
         //! Get traverser for SDES packet.
         //! @pre Can be used if next() returned SDES.
         SdesTraverser get_sdes();
@@ -71,6 +76,7 @@ public:
         bool remove_padding_();
         bool check_sr_();
         bool check_rr_();
+        bool check_nack_();
 
         State state_;
         const core::Slice<uint8_t> buf_;
@@ -24,7 +24,10 @@ public:
     //! Initialization.
     //! @remarks
     //!  If @p inner_composer is not NULL, it is used to compose the packet payload.
-    Composer(packet::IComposer* inner_composer);
+    //!  If @p enable_capture_time is true, every packet gets header extension
+    //!  with its capture timestamp (see CaptureTimeExtension). Extension
+    //!  has fixed size, so that all packets of stream have same header size.
+    Composer(packet::IComposer* inner_composer, bool enable_capture_time = false);
 
     //! Adjust buffer to align payload.
     virtual bool
@@ -42,6 +45,7 @@ public:
 
 private:
     packet::IComposer* inner_composer_;
+    const size_t header_size_;
 };
 
 } // namespace rtp
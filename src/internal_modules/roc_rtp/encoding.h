@@ -12,6 +12,7 @@
 #ifndef ROC_RTP_ENCODING_H_
 #define ROC_RTP_ENCODING_H_
 
+#include "roc_audio/frame_encoder_config.h"
 #include "roc_audio/iframe_decoder.h"
 #include "roc_audio/iframe_encoder.h"
 #include "roc_audio/pcm_format.h"
@@ -36,7 +37,8 @@ struct Encoding {
 
     //! Create frame encoder.
     audio::IFrameEncoder* (*new_encoder)(core::IArena& arena,
-                                         const audio::SampleSpec& sample_spec);
+                                         const audio::SampleSpec& sample_spec,
+                                         const audio::FrameEncoderConfig& config);
 
     //! Create frame decoder.
     audio::IFrameDecoder* (*new_decoder)(core::IArena& arena,
@@ -7,11 +7,18 @@
  */
 
 #include "roc_rtp/encoding_map.h"
+#include "roc_audio/lossless_decoder.h"
+#include "roc_audio/lossless_encoder.h"
 #include "roc_audio/pcm_decoder.h"
 #include "roc_audio/pcm_encoder.h"
 #include "roc_audio/sample_format.h"
 #include "roc_core/panic.h"
 
+#ifdef ROC_TARGET_OPUS
+#include "roc_audio/opus_decoder.h"
+#include "roc_audio/opus_encoder.h"
+#endif // ROC_TARGET_OPUS
+
 namespace roc {
 namespace rtp {
 
@@ -38,6 +45,68 @@ EncodingMap::EncodingMap(core::IArena& arena)
 
         add_builtin_(enc);
     }
+    {
+        Encoding enc;
+        enc.payload_type = PayloadType_Lossless_Mono;
+        enc.sample_spec.set_sample_format(audio::SampleFormat_Lossless);
+        enc.sample_spec.set_sample_rate(48000);
+        enc.sample_spec.channel_set().set_layout(audio::ChanLayout_Surround);
+        enc.sample_spec.channel_set().set_order(audio::ChanOrder_Smpte);
+        enc.sample_spec.channel_set().set_mask(audio::ChanMask_Surround_Mono);
+        enc.packet_flags = packet::Packet::FlagAudio;
+
+        add_builtin_(enc);
+    }
+    {
+        Encoding enc;
+        enc.payload_type = PayloadType_Lossless_Stereo;
+        enc.sample_spec.set_sample_format(audio::SampleFormat_Lossless);
+        enc.sample_spec.set_sample_rate(48000);
+        enc.sample_spec.channel_set().set_layout(audio::ChanLayout_Surround);
+        enc.sample_spec.channel_set().set_order(audio::ChanOrder_Smpte);
+        enc.sample_spec.channel_set().set_mask(audio::ChanMask_Surround_Stereo);
+        enc.packet_flags = packet::Packet::FlagAudio;
+
+        add_builtin_(enc);
+    }
+#ifdef ROC_TARGET_OPUS
+    {
+        Encoding enc;
+        enc.payload_type = PayloadType_Opus;
+        enc.sample_spec.set_sample_format(audio::SampleFormat_Opus);
+        enc.sample_spec.set_sample_rate(48000);
+        enc.sample_spec.channel_set().set_layout(audio::ChanLayout_Surround);
+        enc.sample_spec.channel_set().set_order(audio::ChanOrder_Smpte);
+        enc.sample_spec.channel_set().set_mask(audio::ChanMask_Surround_Stereo);
+        enc.packet_flags = packet::Packet::FlagAudio;
+
+        add_builtin_(enc);
+    }
+    {
+        Encoding enc;
+        enc.payload_type = PayloadType_Opus_5_1;
+        enc.sample_spec.set_sample_format(audio::SampleFormat_Opus);
+        enc.sample_spec.set_sample_rate(48000);
+        enc.sample_spec.channel_set().set_layout(audio::ChanLayout_Surround);
+        enc.sample_spec.channel_set().set_order(audio::ChanOrder_Smpte);
+        enc.sample_spec.channel_set().set_mask(audio::ChanMask_Surround_5_1);
+        enc.packet_flags = packet::Packet::FlagAudio;
+
+        add_builtin_(enc);
+    }
+    {
+        Encoding enc;
+        enc.payload_type = PayloadType_Opus_7_1;
+        enc.sample_spec.set_sample_format(audio::SampleFormat_Opus);
+        enc.sample_spec.set_sample_rate(48000);
+        enc.sample_spec.channel_set().set_layout(audio::ChanLayout_Surround);
+        enc.sample_spec.channel_set().set_order(audio::ChanOrder_Smpte);
+        enc.sample_spec.channel_set().set_mask(audio::ChanMask_Surround_7_1);
+        enc.packet_flags = packet::Packet::FlagAudio;
+
+        add_builtin_(enc);
+    }
+#endif // ROC_TARGET_OPUS
 }
 
 const Encoding* EncodingMap::find_by_pt(unsigned int pt) const {
@@ -126,6 +195,26 @@ void EncodingMap::find_codecs_(Encoding& enc) {
         }
         break;
 
+    case audio::SampleFormat_Lossless:
+        if (!enc.new_encoder) {
+            enc.new_encoder = &audio::LosslessEncoder::construct;
+        }
+        if (!enc.new_decoder) {
+            enc.new_decoder = &audio::LosslessDecoder::construct;
+        }
+        break;
+
+    case audio::SampleFormat_Opus:
+#ifdef ROC_TARGET_OPUS
+        if (!enc.new_encoder) {
+            enc.new_encoder = &audio::OpusEncoder::construct;
+        }
+        if (!enc.new_decoder) {
+            enc.new_decoder = &audio::OpusDecoder::construct;
+        }
+#endif // ROC_TARGET_OPUS
+        break;
+
     case audio::SampleFormat_Invalid:
         break;
     }
@@ -16,6 +16,7 @@
 #include "roc_core/endian.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_packet/ntp.h"
 #include "roc_packet/units.h"
 
 namespace roc {
@@ -28,8 +29,34 @@ enum Version {
 
 //! RTP payload type.
 enum PayloadType {
-    PayloadType_L16_Stereo = 10, //!< Audio, 16-bit PCM, 2 channels, 44100 Hz.
-    PayloadType_L16_Mono = 11    //!< Audio, 16-bit PCM, 1 channel, 44100 Hz.
+    PayloadType_L16_Stereo = 10,       //!< Audio, 16-bit PCM, 2 channels, 44100 Hz.
+    PayloadType_L16_Mono = 11,         //!< Audio, 16-bit PCM, 1 channel, 44100 Hz.
+    PayloadType_Opus = 111,            //!< Audio, Opus, 2 channels, 48000 Hz.
+    PayloadType_Lossless_Stereo = 112, //!< Audio, lossless, 2 channels, 48000 Hz.
+    PayloadType_Lossless_Mono = 113,   //!< Audio, lossless, 1 channel, 48000 Hz.
+    PayloadType_Opus_5_1 = 114,        //!< Audio, Opus, surround 5.1, 48000 Hz.
+    PayloadType_Opus_7_1 = 115         //!< Audio, Opus, surround 7.1, 48000 Hz.
+};
+
+//! RTP header extension profile.
+enum ExtensionProfile {
+    //! One-byte header extension elements (RFC 8285 4.2).
+    ExtProfile_OneByte = 0xBEDE
+};
+
+//! Identifier of one-byte header extension element.
+//! @remarks
+//!  Identifiers are usually negotiated via SDP. Roc doesn't use SDP for
+//!  streaming, hence identifiers are fixed.
+enum ExtensionId {
+    //! Padding byte.
+    ExtId_Padding = 0,
+
+    //! Capture time of first sample in 64-bit NTP format (RFC 6051 3.3).
+    ExtId_CaptureTime = 1,
+
+    //! Reserved, stops parsing of elements.
+    ExtId_Reserved = 15
 };
 
 //! RTP header.
@@ -122,6 +149,14 @@ public:
         return (uint32_t)sizeof(*this) + num_csrc() * (uint32_t)sizeof(uint32_t);
     }
 
+    //! Check if header has fixed size and no optional parts.
+    //! @remarks
+    //!  True for RTP version 2 header without padding, extension, and CSRC.
+    //!  Such header is exactly 12 bytes, and payload follows it directly.
+    bool is_minimal() const {
+        return flags_ == (V2 << Flag_VersionShift);
+    }
+
     //! Clear header.
     void clear() {
         memset(this, 0, sizeof(*this));
@@ -155,6 +190,12 @@ public:
         return (flags_ & (Flag_ExtensionMask << Flag_ExtensionShift));
     }
 
+    //! Set extension flag.
+    void set_extension(bool v) {
+        flags_ &= (uint8_t) ~(Flag_ExtensionMask << Flag_ExtensionShift);
+        flags_ |= ((v ? 1 : 0) << Flag_ExtensionShift);
+    }
+
     //! Get payload type.
     uint8_t payload_type() const {
         return ((mpt_ >> MPT_PayloadTypeShift) & MPT_PayloadTypeMask);
@@ -251,10 +292,77 @@ public:
         return core::ntoh16u(type_);
     }
 
+    //! Set extension type.
+    void set_type(uint16_t t) {
+        type_ = core::hton16u(t);
+    }
+
     //! Get extension data size in bytes (without extension header itself).
     uint32_t data_size() const {
         return (uint32_t(core::ntoh16u(len_)) << 2);
     }
+
+    //! Set extension data size in bytes (without extension header itself).
+    //! @remarks
+    //!  Size should be multiple of 4.
+    void set_data_size(uint32_t size) {
+        roc_panic_if((size & 0x3) != 0);
+        roc_panic_if((size >> 2) > (uint16_t)-1);
+        len_ = core::hton16u(uint16_t(size >> 2));
+    }
+} ROC_ATTR_PACKED_END;
+
+//! RTP header extension with capture time.
+//!
+//! One-byte header extension (RFC 8285) with single element carrying capture
+//! time of the first sample of packet in 64-bit NTP format, as described in
+//! RFC 6051 3.3: "RTP Header Extension Format". Allows receiver to learn
+//! capture timestamps from the very first packet, without waiting for RTCP.
+//!
+//! @code
+//!    0             1               2               3               4
+//!    0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7 0 1 2 3 4 5 6 7
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |             0xBEDE            |           length=3            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |  ID   | L=7   |     NTP timestamp format - seconds part       |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |       |      NTP timestamp format - fractional part           |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |       |                 padding (zeros)                       |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+ROC_ATTR_PACKED_BEGIN class CaptureTimeExtension {
+private:
+    //! Extension header.
+    ExtentionHeader header_;
+
+    //! Element ID and length.
+    uint8_t id_len_;
+
+    //! NTP timestamp, unaligned.
+    uint8_t ntp_[8];
+
+    //! Padding to 32-bit boundary.
+    uint8_t padding_[3];
+
+public:
+    //! Clear extension and fill extension header.
+    //! @remarks
+    //!  Cleared extension contains only padding bytes.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+        header_.set_type(ExtProfile_OneByte);
+        header_.set_data_size(sizeof(*this) - sizeof(ExtentionHeader));
+    }
+
+    //! Set capture time element.
+    void set_ntp_timestamp(packet::ntp_timestamp_t ts) {
+        id_len_ = (uint8_t)((ExtId_CaptureTime << 4) | (sizeof(ntp_) - 1));
+        for (size_t n = 0; n < sizeof(ntp_); n++) {
+            ntp_[n] = uint8_t(ts >> (56 - n * 8));
+        }
+    }
 } ROC_ATTR_PACKED_END;
 
 } // namespace rtp
@@ -13,8 +13,9 @@
 namespace roc {
 namespace rtp {
 
-LinkMeter::LinkMeter(const EncodingMap& encoding_map)
-    : encoding_map_(encoding_map)
+LinkMeter::LinkMeter(const LinkMeterConfig& config, const EncodingMap& encoding_map)
+    : config_(config)
+    , encoding_map_(encoding_map)
     , encoding_(NULL)
     , writer_(NULL)
     , reader_(NULL)
@@ -22,7 +23,15 @@ LinkMeter::LinkMeter(const EncodingMap& encoding_map)
     , has_metrics_(false)
     , first_seqnum_(0)
     , last_seqnum_hi_(0)
-    , last_seqnum_lo_(0) {
+    , last_seqnum_lo_(0)
+    , n_received_(0)
+    , recv_mask_(0)
+    , has_prev_packet_(false)
+    , prev_recv_ts_(0)
+    , prev_stream_ts_(0)
+    , pdv_cur_(0)
+    , pdv_cur_count_(0)
+    , peak_jitter_dirty_(false) {
 }
 
 bool LinkMeter::has_metrics() const {
@@ -30,6 +39,10 @@ bool LinkMeter::has_metrics() const {
 }
 
 const packet::LinkMetrics& LinkMeter::metrics() const {
+    if (peak_jitter_dirty_) {
+        update_peak_jitter_();
+    }
+
     return metrics_;
 }
 
@@ -62,7 +75,8 @@ status::StatusCode LinkMeter::write(const packet::PacketPtr& packet) {
 
     // When we create LinkMeter, we don't know yet if RTP is used (e.g.
     // for repair packets), so we should be ready for non-rtp packets.
-    if (packet->rtp()) {
+    // Restored packets weren't received over the link and are not counted.
+    if (packet->rtp() && !packet->has_flags(packet::Packet::FlagRestored)) {
         // Since we don't know packet type in-before, we also determine
         // encoding dynamically.
         if (!encoding_ || encoding_->payload_type != packet->rtp()->payload_type) {
@@ -107,9 +121,14 @@ void LinkMeter::update_metrics_(const packet::Packet& packet) {
         first_seqnum_ = pkt_seqnum;
     }
 
+    const packet::seqnum_diff_t seqnum_dist =
+        first_packet_ ? 0 : packet::seqnum_diff(pkt_seqnum, last_seqnum_lo_);
+
+    update_losses_(seqnum_dist);
+
     // If packet seqnum is after last seqnum, update last seqnum, and
     // also counts possible wraps.
-    if (first_packet_ || packet::seqnum_diff(pkt_seqnum, last_seqnum_lo_) > 0) {
+    if (first_packet_ || seqnum_dist > 0) {
         if (pkt_seqnum < last_seqnum_lo_) {
             last_seqnum_hi_ += (uint16_t)-1;
         }
@@ -119,14 +138,86 @@ void LinkMeter::update_metrics_(const packet::Packet& packet) {
     metrics_.ext_first_seqnum = first_seqnum_;
     metrics_.ext_last_seqnum = last_seqnum_hi_ + last_seqnum_lo_;
 
-    // TODO(gh-688):
-    //  - fill total_packets
-    //  - fill lost_packets
-    //  - fill jitter (use encoding_->sample_spec to convert to nanoseconds)
+    // Late and duplicate packets are counted as received, so loss may
+    // become negative, as defined in RFC 3550.
+    n_received_++;
+
+    metrics_.total_packets =
+        (uint64_t)(metrics_.ext_last_seqnum - metrics_.ext_first_seqnum) + 1;
+    metrics_.lost_packets = (int64_t)metrics_.total_packets - (int64_t)n_received_;
+
+    update_jitter_(packet);
 
     first_packet_ = false;
     has_metrics_ = true;
 }
 
+// Tracks which of last 64 seqnums were received. Seqnums before first
+// packet and skipped by a jump larger than the window are not considered
+// lost, since it's more likely a stream restart than a loss.
+void LinkMeter::update_losses_(packet::seqnum_diff_t seqnum_dist) {
+    if (first_packet_) {
+        recv_mask_ = ~(uint64_t)0;
+    } else if (seqnum_dist > 0) {
+        recv_mask_ = seqnum_dist < 64 ? (recv_mask_ << seqnum_dist) | 1 : ~(uint64_t)0;
+    } else if (seqnum_dist > -64) {
+        recv_mask_ |= (uint64_t)1 << -seqnum_dist;
+    }
+
+    metrics_.recent_losses = ~recv_mask_;
+}
+
+// Computes interarrival jitter as defined in RFC 3550: difference of relative
+// transit times of two consecutive packets, smoothed with gain 1/16.
+// Packets are taken in order of arrival, not in order of seqnums.
+void LinkMeter::update_jitter_(const packet::Packet& packet) {
+    const core::nanoseconds_t recv_ts = packet.receive_timestamp();
+    if (recv_ts == 0) {
+        return;
+    }
+
+    const packet::stream_timestamp_t stream_ts = packet.rtp()->stream_timestamp;
+
+    if (has_prev_packet_) {
+        const core::nanoseconds_t send_delta =
+            encoding_->sample_spec.stream_timestamp_delta_2_ns(
+                packet::stream_timestamp_diff(stream_ts, prev_stream_ts_));
+
+        core::nanoseconds_t pdv = (recv_ts - prev_recv_ts_) - send_delta;
+        if (pdv < 0) {
+            pdv = -pdv;
+        }
+
+        metrics_.jitter += (pdv - metrics_.jitter) / 16;
+
+        pdv_hist_[pdv_cur_].add((uint64_t)pdv);
+        pdv_cur_count_++;
+
+        if (config_.jitter_window != 0 && pdv_cur_count_ >= config_.jitter_window) {
+            // Current window is full, previous one is discarded.
+            pdv_cur_ = 1 - pdv_cur_;
+            pdv_cur_count_ = 0;
+            pdv_hist_[pdv_cur_].clear();
+        }
+
+        peak_jitter_dirty_ = true;
+    }
+
+    has_prev_packet_ = true;
+    prev_recv_ts_ = recv_ts;
+    prev_stream_ts_ = stream_ts;
+}
+
+void LinkMeter::update_peak_jitter_() const {
+    pdv_merged_.clear();
+    pdv_merged_.merge(pdv_hist_[0]);
+    pdv_merged_.merge(pdv_hist_[1]);
+
+    metrics_.peak_jitter =
+        (core::nanoseconds_t)pdv_merged_.quantile(config_.jitter_percentile);
+
+    peak_jitter_dirty_ = false;
+}
+
 } // namespace rtp
 } // namespace roc
@@ -13,6 +13,7 @@
 #define ROC_RTP_LINK_METER_H_
 
 #include "roc_audio/sample_spec.h"
+#include "roc_core/hdr_histogram.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/time.h"
 #include "roc_packet/ilink_meter.h"
@@ -25,6 +26,22 @@
 namespace roc {
 namespace rtp {
 
+//! RTP link meter parameters.
+struct LinkMeterConfig {
+    //! Number of packets used to compute peak jitter.
+    //! Peak jitter is computed over last N to 2*N packets.
+    size_t jitter_window;
+
+    //! Percentile of packet delay variation reported as peak jitter.
+    //! Should be in range [0; 1].
+    double jitter_percentile;
+
+    LinkMeterConfig()
+        : jitter_window(1000)
+        , jitter_percentile(0.95) {
+    }
+};
+
 //! RTP link meter.
 //!
 //! Computes various link metrics based on sequence of RTP packets.
@@ -40,13 +57,18 @@ namespace rtp {
 //!
 //! In both cases, LinkMeter passes through packets to/from nested
 //! writer/reader, and updates metrics.
+//!
+//! Per-packet cost is constant: jitter is computed as exponential moving
+//! average, as described in RFC 3550, and for peak jitter, packet delay
+//! variation is only added to a histogram. Percentile of the histogram is
+//! computed lazily, when metrics are queried.
 class LinkMeter : public packet::ILinkMeter,
                   public packet::IWriter,
                   public packet::IReader,
                   public core::NonCopyable<> {
 public:
     //! Initialize.
-    explicit LinkMeter(const EncodingMap& encoding_map);
+    LinkMeter(const LinkMeterConfig& config, const EncodingMap& encoding_map);
 
     //! Check if metrics are already gathered and can be reported.
     virtual bool has_metrics() const;
@@ -89,6 +111,11 @@ public:
 
 private:
     void update_metrics_(const packet::Packet& packet);
+    void update_losses_(packet::seqnum_diff_t seqnum_dist);
+    void update_jitter_(const packet::Packet& packet);
+    void update_peak_jitter_() const;
+
+    const LinkMeterConfig config_;
 
     const EncodingMap& encoding_map_;
     const Encoding* encoding_;
@@ -99,11 +126,28 @@ private:
     bool first_packet_;
     bool has_metrics_;
 
-    packet::LinkMetrics metrics_;
+    mutable packet::LinkMetrics metrics_;
 
     uint16_t first_seqnum_;
     uint32_t last_seqnum_hi_;
     uint16_t last_seqnum_lo_;
+
+    uint64_t n_received_;
+
+    // bit N is set if packet (last seqnum - N) was received
+    uint64_t recv_mask_;
+
+    bool has_prev_packet_;
+    core::nanoseconds_t prev_recv_ts_;
+    packet::stream_timestamp_t prev_stream_ts_;
+
+    // current and previous windows of packet delay variation,
+    // and scratch histogram to merge them when metrics are queried
+    core::HdrHistogram pdv_hist_[2];
+    size_t pdv_cur_;
+    size_t pdv_cur_count_;
+    mutable core::HdrHistogram pdv_merged_;
+    mutable bool peak_jitter_dirty_;
 };
 
 } // namespace rtp
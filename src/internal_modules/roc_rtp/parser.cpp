@@ -15,16 +15,74 @@ namespace rtp {
 
 Parser::Parser(const EncodingMap& encoding_map, packet::IParser* inner_parser)
     : encoding_map_(encoding_map)
-    , inner_parser_(inner_parser) {
+    , inner_parser_(inner_parser)
+    , last_encoding_(NULL) {
 }
 
 bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    return parse_packet_(packet, buffer);
+}
+
+size_t Parser::parse_batch(packet::PacketPtr* packets, size_t n_packets) {
+    size_t n_parsed = 0;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!parse_packet_(*packets[n], packets[n]->buffer())) {
+            continue;
+        }
+        if (n_parsed != n) {
+            packets[n_parsed] = packets[n];
+        }
+        n_parsed++;
+    }
+
+    for (size_t n = n_parsed; n < n_packets; n++) {
+        packets[n] = NULL;
+    }
+
+    return n_parsed;
+}
+
+bool Parser::parse_packet_(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
     if (buffer.size() < sizeof(Header)) {
         roc_log(LogDebug, "rtp parser: bad packet: size<%d (rtp header)",
                 (int)sizeof(Header));
         return false;
     }
 
+    if (((const Header*)buffer.data())->is_minimal()) {
+        return parse_minimal_(packet, buffer);
+    }
+
+    return parse_generic_(packet, buffer);
+}
+
+// Fast path for the most common case, when there are no optional header parts.
+bool Parser::parse_minimal_(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    const Header& header = *(const Header*)buffer.data();
+
+    packet.add_flags(packet::Packet::FlagRTP);
+
+    packet::RTP& rtp = *packet.rtp();
+
+    rtp.source_id = header.ssrc();
+    rtp.seqnum = header.seqnum();
+    rtp.stream_timestamp = header.timestamp();
+    rtp.marker = header.marker();
+    rtp.payload_type = header.payload_type();
+    rtp.header = buffer.subslice(0, sizeof(Header));
+    rtp.payload = buffer.subslice(sizeof(Header), buffer.size());
+
+    set_encoding_(packet, rtp.payload_type);
+
+    if (inner_parser_) {
+        return inner_parser_->parse(packet, rtp.payload);
+    }
+
+    return true;
+}
+
+bool Parser::parse_generic_(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
     const Header& header = *(const Header*)buffer.data();
 
     if (header.version() != V2) {
@@ -34,6 +92,7 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
     }
 
     size_t header_size = header.header_size();
+    core::nanoseconds_t capture_ts = 0;
 
     if (header.has_extension()) {
         header_size += sizeof(ExtentionHeader);
@@ -50,13 +109,20 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
             *(const ExtentionHeader*)(buffer.data() + header.header_size());
 
         header_size += extension.data_size();
-    }
 
-    if (buffer.size() < header_size) {
-        roc_log(LogDebug,
-                "rtp parser: bad packet: size<%d (rtp header + ext header + ext data)",
-                (int)header_size);
-        return false;
+        if (buffer.size() < header_size) {
+            roc_log(LogDebug,
+                    "rtp parser: bad packet:"
+                    " size<%d (rtp header + ext header + ext data)",
+                    (int)header_size);
+            return false;
+        }
+
+        if (extension.type() == ExtProfile_OneByte) {
+            capture_ts = parse_capture_time_(
+                buffer.data() + header.header_size() + sizeof(ExtentionHeader),
+                extension.data_size());
+        }
     }
 
     size_t payload_begin = header_size;
@@ -94,6 +160,7 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
     rtp.source_id = header.ssrc();
     rtp.seqnum = header.seqnum();
     rtp.stream_timestamp = header.timestamp();
+    rtp.capture_timestamp = capture_ts;
     rtp.marker = header.marker();
     rtp.payload_type = header.payload_type();
     rtp.header = buffer.subslice(0, header_size);
@@ -103,9 +170,7 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
         rtp.padding = buffer.subslice(payload_end, payload_end + pad_size);
     }
 
-    if (const Encoding* encoding = encoding_map_.find_by_pt(header.payload_type())) {
-        packet.add_flags(encoding->packet_flags);
-    }
+    set_encoding_(packet, rtp.payload_type);
 
     if (inner_parser_) {
         return inner_parser_->parse(packet, rtp.payload);
@@ -114,5 +179,52 @@ bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
     return true;
 }
 
+// Scan elements of one-byte header extension (RFC 8285 4.2) for capture time.
+core::nanoseconds_t Parser::parse_capture_time_(const uint8_t* data, size_t size) {
+    size_t pos = 0;
+
+    while (pos < size) {
+        const unsigned id = data[pos] >> 4;
+        const size_t len = size_t(data[pos] & 0xf) + 1;
+
+        if (id == ExtId_Padding) {
+            pos++;
+            continue;
+        }
+
+        if (id == ExtId_Reserved || pos + 1 + len > size) {
+            break;
+        }
+
+        if (id == ExtId_CaptureTime && len == sizeof(packet::ntp_timestamp_t)) {
+            packet::ntp_timestamp_t ntp = 0;
+            for (size_t n = 0; n < len; n++) {
+                ntp = (ntp << 8) | data[pos + 1 + n];
+            }
+            if (ntp == 0) {
+                return 0;
+            }
+            const core::nanoseconds_t capture_ts = packet::ntp_2_unix(ntp);
+            return capture_ts > 0 ? capture_ts : 0;
+        }
+
+        pos += 1 + len;
+    }
+
+    return 0;
+}
+
+void Parser::set_encoding_(packet::Packet& packet, unsigned int payload_type) {
+    if (!last_encoding_ || last_encoding_->payload_type != payload_type) {
+        const Encoding* encoding = encoding_map_.find_by_pt(payload_type);
+        if (!encoding) {
+            return;
+        }
+        last_encoding_ = encoding;
+    }
+
+    packet.add_flags(last_encoding_->packet_flags);
+}
+
 } // namespace rtp
 } // namespace roc
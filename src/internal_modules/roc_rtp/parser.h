@@ -14,12 +14,21 @@
 
 #include "roc_core/noncopyable.h"
 #include "roc_packet/iparser.h"
+#include "roc_rtp/encoding.h"
 #include "roc_rtp/encoding_map.h"
 
 namespace roc {
 namespace rtp {
 
 //! RTP packet parser.
+//!
+//! Packets with minimal 12-byte header (no padding, extension, and CSRC) are
+//! handled by a fast path which skips generic header processing. Encoding of
+//! the most recent payload type is cached to avoid locking encoding map for
+//! every packet.
+//!
+//! If packet has one-byte header extension with capture time element (see
+//! CaptureTimeExtension), capture timestamp of packet is filled from it.
 class Parser : public packet::IParser, public core::NonCopyable<> {
 public:
     //! Initialization.
@@ -34,9 +43,24 @@ public:
     //! Parse packet from buffer.
     virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
 
+    //! Parse multiple packets, each from its own buffer.
+    virtual size_t parse_batch(packet::PacketPtr* packets, size_t n_packets);
+
 private:
+    bool parse_packet_(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+    bool parse_minimal_(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+    bool parse_generic_(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+
+    static core::nanoseconds_t parse_capture_time_(const uint8_t* data, size_t size);
+
+    void set_encoding_(packet::Packet& packet, unsigned int payload_type);
+
     const EncodingMap& encoding_map_;
     packet::IParser* inner_parser_;
+
+    // Encoding for most recently seen payload type.
+    // Encodings are never removed from map, so pointer remains valid.
+    const Encoding* last_encoding_;
 };
 
 } // namespace rtp
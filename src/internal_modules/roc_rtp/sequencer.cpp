@@ -18,6 +18,7 @@ Sequencer::Sequencer(Identity& identity, unsigned int payload_type)
     , payload_type_(payload_type)
     , seqnum_(0)
     , stream_ts_(0)
+    , marker_(false)
     , valid_(false) {
     // Start with random RTP seqnum and timestamp, as required by RFC 3550.
     seqnum_ = (packet::seqnum_t)core::fast_random_range(0, packet::seqnum_t(-1));
@@ -47,9 +48,16 @@ void Sequencer::next(packet::Packet& packet,
     rtp->stream_timestamp = stream_ts_;
     rtp->duration = duration;
     rtp->capture_timestamp = capture_ts;
+    rtp->marker = marker_;
 
     seqnum_++;
     stream_ts_ += duration;
+    marker_ = false;
+}
+
+void Sequencer::skip(packet::stream_timestamp_t duration) {
+    stream_ts_ += duration;
+    marker_ = true;
 }
 
 } // namespace rtp
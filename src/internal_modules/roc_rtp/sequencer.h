@@ -33,12 +33,19 @@ public:
                       core::nanoseconds_t capture_ts,
                       packet::stream_timestamp_t duration);
 
+    //! Skip packet that was not sent.
+    //! @remarks
+    //!  Next packet gets marker bit set, which marks beginning of a talkspurt
+    //!  after silence, as defined in RFC 3551.
+    virtual void skip(packet::stream_timestamp_t duration);
+
 private:
     Identity& identity_;
 
     const unsigned int payload_type_;
     packet::seqnum_t seqnum_;
     packet::stream_timestamp_t stream_ts_;
+    bool marker_;
 
     bool valid_;
 };
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/srtp_config.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+int hex_digit(char ch) {
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+bool parse_hex(const char*& str, uint8_t* data, size_t size) {
+    for (size_t n = 0; n < size; n++) {
+        const int hi = hex_digit(str[0]);
+        if (hi < 0) {
+            return false;
+        }
+        const int lo = hex_digit(str[1]);
+        if (lo < 0) {
+            return false;
+        }
+        data[n] = uint8_t((hi << 4) | lo);
+        str += 2;
+    }
+    return true;
+}
+
+} // namespace
+
+size_t srtp_key_size(SrtpSuite suite) {
+    switch (suite) {
+    case Srtp_AES_CM_128_HMAC_SHA1_80:
+    case Srtp_AEAD_AES_128_GCM:
+        return 16;
+    case Srtp_None:
+        break;
+    }
+    return 0;
+}
+
+size_t srtp_salt_size(SrtpSuite suite) {
+    switch (suite) {
+    case Srtp_AES_CM_128_HMAC_SHA1_80:
+        return 14;
+    case Srtp_AEAD_AES_128_GCM:
+        return 12;
+    case Srtp_None:
+        break;
+    }
+    return 0;
+}
+
+size_t srtp_tag_size(SrtpSuite suite) {
+    switch (suite) {
+    case Srtp_AES_CM_128_HMAC_SHA1_80:
+        return 10;
+    case Srtp_AEAD_AES_128_GCM:
+        return 16;
+    case Srtp_None:
+        break;
+    }
+    return 0;
+}
+
+const char* srtp_suite_to_str(SrtpSuite suite) {
+    switch (suite) {
+    case Srtp_None:
+        return "none";
+    case Srtp_AES_CM_128_HMAC_SHA1_80:
+        return "AES_CM_128_HMAC_SHA1_80";
+    case Srtp_AEAD_AES_128_GCM:
+        return "AEAD_AES_128_GCM";
+    }
+    return "?";
+}
+
+bool parse_srtp_key(const char* str, SrtpConfig& config) {
+    if (!str) {
+        roc_log(LogError, "srtp: key is null");
+        return false;
+    }
+
+    const size_t key_size = srtp_key_size(config.suite);
+    const size_t salt_size = srtp_salt_size(config.suite);
+
+    if (key_size == 0) {
+        roc_log(LogError, "srtp: suite is not set");
+        return false;
+    }
+
+    if (strlen(str) != (key_size + salt_size) * 2) {
+        roc_log(LogError,
+                "srtp: bad key: expected %lu hex digits (key + salt) for %s, got %lu",
+                (unsigned long)(key_size + salt_size) * 2,
+                srtp_suite_to_str(config.suite), (unsigned long)strlen(str));
+        return false;
+    }
+
+    memset(config.master_key, 0, sizeof(config.master_key));
+    memset(config.master_salt, 0, sizeof(config.master_salt));
+
+    if (!parse_hex(str, config.master_key, key_size)
+        || !parse_hex(str, config.master_salt, salt_size)) {
+        roc_log(LogError, "srtp: bad key: expected hex digits");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace rtp
+} // namespace roc
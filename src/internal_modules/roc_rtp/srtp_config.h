@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/srtp_config.h
+//! @brief SRTP config.
+
+#ifndef ROC_RTP_SRTP_CONFIG_H_
+#define ROC_RTP_SRTP_CONFIG_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace rtp {
+
+//! SRTP crypto suite.
+enum SrtpSuite {
+    //! SRTP is not configured.
+    Srtp_None,
+
+    //! AES-128 in counter mode with 80-bit HMAC-SHA1 tag (RFC 3711).
+    Srtp_AES_CM_128_HMAC_SHA1_80,
+
+    //! AES-128 in Galois/Counter mode with 128-bit tag (RFC 7714).
+    Srtp_AEAD_AES_128_GCM
+};
+
+//! SRTP config.
+struct SrtpConfig {
+    //! Maximum sizes of master key and salt.
+    enum { MaxKeySize = 16, MaxSaltSize = 14 };
+
+    //! Crypto suite.
+    SrtpSuite suite;
+
+    //! Master key.
+    //! Size is defined by srtp_key_size().
+    uint8_t master_key[MaxKeySize];
+
+    //! Master salt.
+    //! Size is defined by srtp_salt_size().
+    uint8_t master_salt[MaxSaltSize];
+
+    //! Initialize.
+    SrtpConfig()
+        : suite(Srtp_None) {
+        memset(master_key, 0, sizeof(master_key));
+        memset(master_salt, 0, sizeof(master_salt));
+    }
+};
+
+//! Get master key size for suite, in bytes.
+size_t srtp_key_size(SrtpSuite suite);
+
+//! Get master salt size for suite, in bytes.
+size_t srtp_salt_size(SrtpSuite suite);
+
+//! Get authentication tag size for suite, in bytes.
+size_t srtp_tag_size(SrtpSuite suite);
+
+//! Get string name of suite.
+const char* srtp_suite_to_str(SrtpSuite suite);
+
+//! Parse master key and salt.
+//! @remarks
+//!  @p str is a hex string with master key followed by master salt,
+//!  e.g. 60 hex digits for AES_CM_128_HMAC_SHA1_80. Suite should be
+//!  already set in @p config.
+ROC_ATTR_NODISCARD bool parse_srtp_key(const char* str, SrtpConfig& config);
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_SRTP_CONFIG_H_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/srtp_composer.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace rtp {
+
+SrtpComposer::SrtpComposer(const SrtpConfig& config, packet::IComposer& rtp_composer)
+    : crypto_(config)
+    , rtp_composer_(rtp_composer)
+    , has_stream_(false)
+    , ssrc_(0)
+    , last_seqnum_(0)
+    , roc_(0) {
+}
+
+bool SrtpComposer::is_valid() const {
+    return crypto_.is_valid();
+}
+
+bool SrtpComposer::align(core::Slice<uint8_t>& buffer,
+                         size_t header_size,
+                         size_t payload_alignment) {
+    roc_panic_if(!is_valid());
+
+    return rtp_composer_.align(buffer, header_size, payload_alignment);
+}
+
+bool SrtpComposer::prepare(packet::Packet& packet,
+                           core::Slice<uint8_t>& buffer,
+                           size_t payload_size) {
+    roc_panic_if(!is_valid());
+
+    core::Slice<uint8_t> rtp_buffer = buffer.subslice(0, 0);
+
+    if (!rtp_composer_.prepare(packet, rtp_buffer, payload_size)) {
+        return false;
+    }
+
+    const size_t tag_size = crypto_.tag_size();
+
+    if (rtp_buffer.capacity() < rtp_buffer.size() + tag_size) {
+        roc_log(LogDebug,
+                "srtp composer: not enough space for auth tag: size=%lu cap=%lu",
+                (unsigned long)(rtp_buffer.size() + tag_size),
+                (unsigned long)rtp_buffer.capacity());
+        return false;
+    }
+
+    buffer.reslice(0, rtp_buffer.size() + tag_size);
+
+    return true;
+}
+
+bool SrtpComposer::pad(packet::Packet& packet, size_t padding_size) {
+    roc_panic_if(!is_valid());
+
+    return rtp_composer_.pad(packet, padding_size);
+}
+
+bool SrtpComposer::compose(packet::Packet& packet) {
+    roc_panic_if(!is_valid());
+
+    if (!rtp_composer_.compose(packet)) {
+        return false;
+    }
+
+    packet::RTP* rtp = packet.rtp();
+    if (!rtp) {
+        roc_panic("srtp composer: unexpected non-rtp packet");
+    }
+
+    const core::Slice<uint8_t>& buffer = packet.buffer();
+    if (!buffer || rtp->header.data() != buffer.data()) {
+        roc_panic("srtp composer: unexpected packet buffer");
+    }
+
+    const size_t header_size = rtp->header.size();
+    const size_t tag_size = crypto_.tag_size();
+
+    if (buffer.size() < header_size + tag_size) {
+        roc_panic("srtp composer: unexpected packet size");
+    }
+
+    // Payload and padding are encrypted, tag follows them.
+    const size_t payload_size = buffer.size() - header_size - tag_size;
+
+    return crypto_.protect(buffer.data(), header_size, payload_size,
+                           rollover_counter_(rtp->source_id, rtp->seqnum));
+}
+
+// Packets may be reordered by interleaver before reaching composer, so
+// rollover counter is deduced from seqnum distance to the latest packet.
+uint32_t SrtpComposer::rollover_counter_(packet::stream_source_t ssrc,
+                                         packet::seqnum_t seqnum) {
+    if (!has_stream_ || ssrc != ssrc_) {
+        has_stream_ = true;
+        ssrc_ = ssrc;
+        last_seqnum_ = seqnum;
+        roc_ = 0;
+        return roc_;
+    }
+
+    const packet::seqnum_diff_t dist = packet::seqnum_diff(seqnum, last_seqnum_);
+
+    if (dist > 0) {
+        if (seqnum < last_seqnum_) {
+            roc_++;
+        }
+        last_seqnum_ = seqnum;
+        return roc_;
+    }
+
+    if (seqnum > last_seqnum_ && roc_ > 0) {
+        // Late packet from before wrap.
+        return roc_ - 1;
+    }
+
+    return roc_;
+}
+
+} // namespace rtp
+} // namespace roc
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_openssl/roc_rtp/srtp_composer.h
+//! @brief SRTP packet composer.
+
+#ifndef ROC_RTP_SRTP_COMPOSER_H_
+#define ROC_RTP_SRTP_COMPOSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_packet/icomposer.h"
+#include "roc_packet/units.h"
+#include "roc_rtp/srtp_config.h"
+#include "roc_rtp/srtp_crypto.h"
+
+namespace roc {
+namespace rtp {
+
+//! SRTP packet composer.
+//! @remarks
+//!  Wraps RTP composer. Reserves space for authentication tag after RTP
+//!  packet, and after RTP composer fills the header, encrypts payload and
+//!  writes tag in place, without copying packet.
+class SrtpComposer : public packet::IComposer, public core::NonCopyable<> {
+public:
+    //! Initialization.
+    //! @remarks
+    //!  @p rtp_composer is used to compose RTP packet which is then protected.
+    SrtpComposer(const SrtpConfig& config, packet::IComposer& rtp_composer);
+
+    //! Check if composer was successfully initialized.
+    bool is_valid() const;
+
+    //! Adjust buffer to align payload.
+    virtual bool
+    align(core::Slice<uint8_t>& buffer, size_t header_size, size_t payload_alignment);
+
+    //! Prepare buffer for composing a packet.
+    virtual bool
+    prepare(packet::Packet& packet, core::Slice<uint8_t>& buffer, size_t payload_size);
+
+    //! Pad packet.
+    virtual bool pad(packet::Packet& packet, size_t padding_size);
+
+    //! Compose packet to buffer.
+    virtual bool compose(packet::Packet& packet);
+
+private:
+    uint32_t rollover_counter_(packet::stream_source_t ssrc, packet::seqnum_t seqnum);
+
+    SrtpCrypto crypto_;
+    packet::IComposer& rtp_composer_;
+
+    // Rollover counter of the stream, incremented when seqnum wraps.
+    bool has_stream_;
+    packet::stream_source_t ssrc_;
+    packet::seqnum_t last_seqnum_;
+    uint32_t roc_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_SRTP_COMPOSER_H_
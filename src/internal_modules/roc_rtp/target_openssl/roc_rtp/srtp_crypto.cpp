@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <openssl/crypto.h>
+
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtp/srtp_crypto.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+// Key derivation labels (RFC 3711, section 4.3.2).
+enum { Label_CipherKey = 0x00, Label_AuthKey = 0x01, Label_Salt = 0x02 };
+
+// Offsets of sequence number and SSRC in RTP header.
+enum { SeqnumOffset = 2, SsrcOffset = 8 };
+
+void store_be32(uint8_t* dst, uint32_t val) {
+    dst[0] = uint8_t(val >> 24);
+    dst[1] = uint8_t(val >> 16);
+    dst[2] = uint8_t(val >> 8);
+    dst[3] = uint8_t(val);
+}
+
+} // namespace
+
+SrtpCrypto::SrtpCrypto(const SrtpConfig& config)
+    : suite_(config.suite)
+    , tag_size_(srtp_tag_size(config.suite))
+    , encrypt_ctx_(NULL)
+    , decrypt_ctx_(NULL)
+    , hmac_key_(NULL)
+    , hmac_init_ctx_(NULL)
+    , hmac_ctx_(NULL)
+    , valid_(false) {
+    memset(session_salt_, 0, sizeof(session_salt_));
+
+    encrypt_ctx_ = EVP_CIPHER_CTX_new();
+    decrypt_ctx_ = EVP_CIPHER_CTX_new();
+    if (!encrypt_ctx_ || !decrypt_ctx_) {
+        roc_log(LogError, "srtp crypto: can't allocate cipher context");
+        return;
+    }
+
+    switch (suite_) {
+    case Srtp_AES_CM_128_HMAC_SHA1_80:
+        if (!init_cm_(config)) {
+            return;
+        }
+        break;
+
+    case Srtp_AEAD_AES_128_GCM:
+        if (!init_gcm_(config)) {
+            return;
+        }
+        break;
+
+    case Srtp_None:
+        roc_log(LogError, "srtp crypto: suite is not set");
+        return;
+    }
+
+    roc_log(LogDebug, "srtp crypto: initialized: suite=%s tag_size=%lu",
+            srtp_suite_to_str(suite_), (unsigned long)tag_size_);
+
+    valid_ = true;
+}
+
+SrtpCrypto::~SrtpCrypto() {
+    if (hmac_ctx_) {
+        EVP_MD_CTX_free(hmac_ctx_);
+    }
+    if (hmac_init_ctx_) {
+        EVP_MD_CTX_free(hmac_init_ctx_);
+    }
+    if (hmac_key_) {
+        EVP_PKEY_free(hmac_key_);
+    }
+    if (decrypt_ctx_) {
+        EVP_CIPHER_CTX_free(decrypt_ctx_);
+    }
+    if (encrypt_ctx_) {
+        EVP_CIPHER_CTX_free(encrypt_ctx_);
+    }
+}
+
+bool SrtpCrypto::is_valid() const {
+    return valid_;
+}
+
+size_t SrtpCrypto::tag_size() const {
+    roc_panic_if(!is_valid());
+
+    return tag_size_;
+}
+
+bool SrtpCrypto::protect(uint8_t* packet,
+                         size_t header_size,
+                         size_t payload_size,
+                         uint32_t roc) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!packet);
+    roc_panic_if(header_size < SsrcOffset + 4);
+
+    if (suite_ == Srtp_AEAD_AES_128_GCM) {
+        return protect_gcm_(packet, header_size, payload_size, roc);
+    }
+    return protect_cm_(packet, header_size, payload_size, roc);
+}
+
+bool SrtpCrypto::unprotect(uint8_t* packet,
+                           size_t header_size,
+                           size_t payload_size,
+                           uint32_t roc) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(!packet);
+    roc_panic_if(header_size < SsrcOffset + 4);
+
+    if (suite_ == Srtp_AEAD_AES_128_GCM) {
+        return unprotect_gcm_(packet, header_size, payload_size, roc);
+    }
+    return unprotect_cm_(packet, header_size, payload_size, roc);
+}
+
+bool SrtpCrypto::derive_key(const uint8_t* master_key,
+                            const uint8_t* master_salt,
+                            size_t master_salt_size,
+                            uint8_t label,
+                            uint8_t* key,
+                            size_t key_size) {
+    roc_panic_if(master_salt_size > MaxSessionSaltSize);
+
+    // x = (label || r) XOR master_salt, where r = index DIV kdr = 0.
+    // IV = x * 2^16.
+    uint8_t iv[16] = {};
+    memcpy(iv, master_salt, master_salt_size);
+    iv[7] ^= label;
+
+    memset(key, 0, key_size);
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+
+    int out_size = 0;
+    const bool ok =
+        EVP_EncryptInit_ex(ctx, EVP_aes_128_ctr(), NULL, master_key, iv) == 1
+        && EVP_EncryptUpdate(ctx, key, &out_size, key, (int)key_size) == 1;
+
+    EVP_CIPHER_CTX_free(ctx);
+
+    return ok;
+}
+
+bool SrtpCrypto::init_cm_(const SrtpConfig& config) {
+    const size_t salt_size = srtp_salt_size(suite_);
+
+    uint8_t cipher_key[CipherKeySize];
+    uint8_t auth_key[AuthKeySize];
+
+    if (!derive_key(config.master_key, config.master_salt, salt_size, Label_CipherKey,
+                    cipher_key, sizeof(cipher_key))
+        || !derive_key(config.master_key, config.master_salt, salt_size, Label_AuthKey,
+                       auth_key, sizeof(auth_key))
+        || !derive_key(config.master_key, config.master_salt, salt_size, Label_Salt,
+                       session_salt_, salt_size)) {
+        roc_log(LogError, "srtp crypto: can't derive session keys");
+        return false;
+    }
+
+    // In counter mode, decryption is the same operation as encryption.
+    if (EVP_EncryptInit_ex(encrypt_ctx_, EVP_aes_128_ctr(), NULL, cipher_key, NULL) != 1
+        || EVP_EncryptInit_ex(decrypt_ctx_, EVP_aes_128_ctr(), NULL, cipher_key, NULL)
+            != 1) {
+        roc_log(LogError, "srtp crypto: can't initialize AES-CTR cipher");
+        return false;
+    }
+
+    // Context initialized with key is copied for every packet, which is cheaper
+    // than re-initializing HMAC.
+    hmac_key_ = EVP_PKEY_new_raw_private_key(EVP_PKEY_HMAC, NULL, auth_key,
+                                             sizeof(auth_key));
+    hmac_init_ctx_ = EVP_MD_CTX_new();
+    hmac_ctx_ = EVP_MD_CTX_new();
+
+    if (!hmac_key_ || !hmac_init_ctx_ || !hmac_ctx_
+        || EVP_DigestSignInit(hmac_init_ctx_, NULL, EVP_sha1(), NULL, hmac_key_) != 1) {
+        roc_log(LogError, "srtp crypto: can't initialize HMAC-SHA1");
+        return false;
+    }
+
+    OPENSSL_cleanse(cipher_key, sizeof(cipher_key));
+    OPENSSL_cleanse(auth_key, sizeof(auth_key));
+
+    return true;
+}
+
+bool SrtpCrypto::init_gcm_(const SrtpConfig& config) {
+    const size_t salt_size = srtp_salt_size(suite_);
+
+    uint8_t cipher_key[CipherKeySize];
+
+    if (!derive_key(config.master_key, config.master_salt, salt_size, Label_CipherKey,
+                    cipher_key, sizeof(cipher_key))
+        || !derive_key(config.master_key, config.master_salt, salt_size, Label_Salt,
+                       session_salt_, salt_size)) {
+        roc_log(LogError, "srtp crypto: can't derive session keys");
+        return false;
+    }
+
+    if (EVP_EncryptInit_ex(encrypt_ctx_, EVP_aes_128_gcm(), NULL, cipher_key, NULL) != 1
+        || EVP_DecryptInit_ex(decrypt_ctx_, EVP_aes_128_gcm(), NULL, cipher_key, NULL)
+            != 1) {
+        roc_log(LogError, "srtp crypto: can't initialize AES-GCM cipher");
+        return false;
+    }
+
+    OPENSSL_cleanse(cipher_key, sizeof(cipher_key));
+
+    return true;
+}
+
+bool SrtpCrypto::protect_cm_(uint8_t* packet,
+                             size_t header_size,
+                             size_t payload_size,
+                             uint32_t roc) {
+    uint8_t iv[16];
+    make_cm_iv_(packet, roc, iv);
+
+    if (!apply_ctr_(encrypt_ctx_, packet + header_size, payload_size, iv)) {
+        return false;
+    }
+
+    // Authenticated portion is header and encrypted payload, followed by ROC.
+    uint8_t tag[HmacSize];
+    if (!compute_hmac_(packet, header_size + payload_size, roc, tag)) {
+        return false;
+    }
+
+    memcpy(packet + header_size + payload_size, tag, tag_size_);
+
+    return true;
+}
+
+bool SrtpCrypto::unprotect_cm_(uint8_t* packet,
+                               size_t header_size,
+                               size_t payload_size,
+                               uint32_t roc) {
+    uint8_t tag[HmacSize];
+    if (!compute_hmac_(packet, header_size + payload_size, roc, tag)) {
+        return false;
+    }
+
+    if (CRYPTO_memcmp(packet + header_size + payload_size, tag, tag_size_) != 0) {
+        return false;
+    }
+
+    uint8_t iv[16];
+    make_cm_iv_(packet, roc, iv);
+
+    return apply_ctr_(decrypt_ctx_, packet + header_size, payload_size, iv);
+}
+
+bool SrtpCrypto::protect_gcm_(uint8_t* packet,
+                              size_t header_size,
+                              size_t payload_size,
+                              uint32_t roc) {
+    uint8_t iv[12];
+    make_gcm_iv_(packet, roc, iv);
+
+    int out_size = 0;
+
+    // Header is authenticated as associated data, payload is encrypted in place.
+    if (EVP_EncryptInit_ex(encrypt_ctx_, NULL, NULL, NULL, iv) != 1
+        || EVP_EncryptUpdate(encrypt_ctx_, NULL, &out_size, packet, (int)header_size)
+            != 1
+        || EVP_EncryptUpdate(encrypt_ctx_, packet + header_size, &out_size,
+                             packet + header_size, (int)payload_size)
+            != 1
+        || EVP_EncryptFinal_ex(encrypt_ctx_, packet + header_size + payload_size,
+                               &out_size)
+            != 1
+        || EVP_CIPHER_CTX_ctrl(encrypt_ctx_, EVP_CTRL_GCM_GET_TAG, (int)tag_size_,
+                               packet + header_size + payload_size)
+            != 1) {
+        roc_log(LogError, "srtp crypto: AES-GCM encryption failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool SrtpCrypto::unprotect_gcm_(uint8_t* packet,
+                                size_t header_size,
+                                size_t payload_size,
+                                uint32_t roc) {
+    uint8_t iv[12];
+    make_gcm_iv_(packet, roc, iv);
+
+    uint8_t* tag = packet + header_size + payload_size;
+
+    int out_size = 0;
+
+    // Decryption writes plaintext in place before tag is verified, but caller
+    // drops packet if verification fails.
+    if (EVP_DecryptInit_ex(decrypt_ctx_, NULL, NULL, NULL, iv) != 1
+        || EVP_DecryptUpdate(decrypt_ctx_, NULL, &out_size, packet, (int)header_size)
+            != 1
+        || EVP_DecryptUpdate(decrypt_ctx_, packet + header_size, &out_size,
+                             packet + header_size, (int)payload_size)
+            != 1
+        || EVP_CIPHER_CTX_ctrl(decrypt_ctx_, EVP_CTRL_GCM_SET_TAG, (int)tag_size_, tag)
+            != 1) {
+        roc_log(LogError, "srtp crypto: AES-GCM decryption failed");
+        return false;
+    }
+
+    uint8_t final_block[16];
+    return EVP_DecryptFinal_ex(decrypt_ctx_, final_block, &out_size) == 1;
+}
+
+// IV = (k_s * 2^16) XOR (SSRC * 2^64) XOR (i * 2^16), i = ROC * 2^16 + SEQ
+// (RFC 3711, section 4.1.1).
+void SrtpCrypto::make_cm_iv_(const uint8_t* packet, uint32_t roc, uint8_t* iv) const {
+    memset(iv, 0, 16);
+    memcpy(iv, session_salt_, 14);
+
+    for (size_t n = 0; n < 4; n++) {
+        iv[4 + n] ^= packet[SsrcOffset + n];
+    }
+
+    uint8_t roc_bytes[4];
+    store_be32(roc_bytes, roc);
+
+    for (size_t n = 0; n < 4; n++) {
+        iv[8 + n] ^= roc_bytes[n];
+    }
+
+    iv[12] ^= packet[SeqnumOffset];
+    iv[13] ^= packet[SeqnumOffset + 1];
+}
+
+// IV = (0x0000 || SSRC || ROC || SEQ) XOR salt (RFC 7714, section 8.1).
+void SrtpCrypto::make_gcm_iv_(const uint8_t* packet, uint32_t roc, uint8_t* iv) const {
+    memset(iv, 0, 12);
+
+    memcpy(iv + 2, packet + SsrcOffset, 4);
+    store_be32(iv + 6, roc);
+    memcpy(iv + 10, packet + SeqnumOffset, 2);
+
+    for (size_t n = 0; n < 12; n++) {
+        iv[n] ^= session_salt_[n];
+    }
+}
+
+bool SrtpCrypto::apply_ctr_(EVP_CIPHER_CTX* ctx,
+                            uint8_t* data,
+                            size_t size,
+                            const uint8_t* iv) {
+    int out_size = 0;
+
+    if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv) != 1
+        || EVP_EncryptUpdate(ctx, data, &out_size, data, (int)size) != 1) {
+        roc_log(LogError, "srtp crypto: AES-CTR encryption failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool SrtpCrypto::compute_hmac_(const uint8_t* data,
+                               size_t size,
+                               uint32_t roc,
+                               uint8_t* tag) {
+    uint8_t roc_bytes[4];
+    store_be32(roc_bytes, roc);
+
+    size_t tag_len = HmacSize;
+
+    if (EVP_MD_CTX_copy_ex(hmac_ctx_, hmac_init_ctx_) != 1
+        || EVP_DigestSignUpdate(hmac_ctx_, data, size) != 1
+        || EVP_DigestSignUpdate(hmac_ctx_, roc_bytes, sizeof(roc_bytes)) != 1
+        || EVP_DigestSignFinal(hmac_ctx_, tag, &tag_len) != 1) {
+        roc_log(LogError, "srtp crypto: HMAC-SHA1 computation failed");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace rtp
+} // namespace roc
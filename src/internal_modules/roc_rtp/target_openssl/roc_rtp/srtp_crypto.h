@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_openssl/roc_rtp/srtp_crypto.h
+//! @brief SRTP packet transform.
+
+#ifndef ROC_RTP_SRTP_CRYPTO_H_
+#define ROC_RTP_SRTP_CRYPTO_H_
+
+#include <openssl/evp.h>
+
+#include "roc_core/attributes.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_rtp/srtp_config.h"
+
+namespace roc {
+namespace rtp {
+
+//! SRTP packet transform.
+//! @remarks
+//!  Derives session keys from master key (RFC 3711, section 4.3) and encrypts
+//!  and authenticates RTP packets in place, using AES-CM with HMAC-SHA1
+//!  (RFC 3711) or AES-GCM (RFC 7714).
+//!
+//!  Ciphers are invoked via OpenSSL EVP interface, which uses AES-NI and
+//!  PCLMULQDQ on x86 and crypto extensions on ARMv8 when CPU supports them.
+//!
+//!  Keeps no per-stream state; rollover counter is provided by caller.
+class SrtpCrypto : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit SrtpCrypto(const SrtpConfig& config);
+
+    //! Deinitialize.
+    ~SrtpCrypto();
+
+    //! Check if crypto was successfully initialized.
+    bool is_valid() const;
+
+    //! Get authentication tag size.
+    size_t tag_size() const;
+
+    //! Encrypt packet in place and append authentication tag.
+    //! @remarks
+    //!  @p packet contains @p header_size bytes of RTP header followed by
+    //!  @p payload_size bytes of payload. Tag is written right after payload,
+    //!  so there should be tag_size() bytes of space after it.
+    ROC_ATTR_NODISCARD bool
+    protect(uint8_t* packet, size_t header_size, size_t payload_size, uint32_t roc);
+
+    //! Verify authentication tag and decrypt packet in place.
+    //! @remarks
+    //!  @p packet contains @p header_size bytes of RTP header followed by
+    //!  @p payload_size bytes of encrypted payload, followed by tag.
+    //!  Returns false if tag doesn't match.
+    ROC_ATTR_NODISCARD bool
+    unprotect(uint8_t* packet, size_t header_size, size_t payload_size, uint32_t roc);
+
+    //! Derive session key from master key.
+    //! @remarks
+    //!  Implements AES-CM PRF with key derivation rate of zero.
+    //!  Master key is 16 bytes; master salt is zero-padded to 14 bytes.
+    static ROC_ATTR_NODISCARD bool derive_key(const uint8_t* master_key,
+                                              const uint8_t* master_salt,
+                                              size_t master_salt_size,
+                                              uint8_t label,
+                                              uint8_t* key,
+                                              size_t key_size);
+
+private:
+    enum {
+        CipherKeySize = 16,
+        AuthKeySize = 20,
+        MaxSessionSaltSize = 14,
+        HmacSize = 20
+    };
+
+    bool init_cm_(const SrtpConfig& config);
+    bool init_gcm_(const SrtpConfig& config);
+
+    bool protect_cm_(uint8_t* packet,
+                     size_t header_size,
+                     size_t payload_size,
+                     uint32_t roc);
+    bool unprotect_cm_(uint8_t* packet,
+                       size_t header_size,
+                       size_t payload_size,
+                       uint32_t roc);
+
+    bool protect_gcm_(uint8_t* packet,
+                      size_t header_size,
+                      size_t payload_size,
+                      uint32_t roc);
+    bool unprotect_gcm_(uint8_t* packet,
+                        size_t header_size,
+                        size_t payload_size,
+                        uint32_t roc);
+
+    void make_cm_iv_(const uint8_t* packet, uint32_t roc, uint8_t* iv) const;
+    void make_gcm_iv_(const uint8_t* packet, uint32_t roc, uint8_t* iv) const;
+
+    bool apply_ctr_(EVP_CIPHER_CTX* ctx, uint8_t* data, size_t size, const uint8_t* iv);
+    bool compute_hmac_(const uint8_t* data, size_t size, uint32_t roc, uint8_t* tag);
+
+    SrtpSuite suite_;
+    size_t tag_size_;
+
+    uint8_t session_salt_[MaxSessionSaltSize];
+
+    EVP_CIPHER_CTX* encrypt_ctx_;
+    EVP_CIPHER_CTX* decrypt_ctx_;
+
+    EVP_PKEY* hmac_key_;
+    EVP_MD_CTX* hmac_init_ctx_;
+    EVP_MD_CTX* hmac_ctx_;
+
+    bool valid_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_SRTP_CRYPTO_H_
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/srtp_parser.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+uint64_t make_index(uint32_t roc, packet::seqnum_t seqnum) {
+    return (uint64_t(roc) << 16) | seqnum;
+}
+
+} // namespace
+
+SrtpParser::SrtpParser(const SrtpConfig& config, packet::IParser& rtp_parser)
+    : crypto_(config)
+    , rtp_parser_(rtp_parser)
+    , next_stream_(0) {
+}
+
+bool SrtpParser::is_valid() const {
+    return crypto_.is_valid();
+}
+
+bool SrtpParser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if(!is_valid());
+
+    size_t header_size = 0;
+    if (!header_size_(buffer, header_size)) {
+        return false;
+    }
+
+    const size_t tag_size = crypto_.tag_size();
+
+    if (buffer.size() < header_size + tag_size) {
+        roc_log(LogDebug, "srtp parser: bad packet: size<%d (rtp header + auth tag)",
+                (int)(header_size + tag_size));
+        return false;
+    }
+
+    const Header& header = *(const Header*)buffer.data();
+
+    const packet::stream_source_t ssrc = header.ssrc();
+    const packet::seqnum_t seqnum = header.seqnum();
+
+    Stream* stream = find_stream_(ssrc);
+
+    // Unknown stream starts with zero rollover counter.
+    const uint32_t roc = stream ? guess_roc_(*stream, seqnum) : 0;
+
+    if (stream && !check_replay_(*stream, make_index(roc, seqnum))) {
+        roc_log(LogDebug, "srtp parser: dropping replayed packet: ssrc=%lu sn=%lu",
+                (unsigned long)ssrc, (unsigned long)seqnum);
+        return false;
+    }
+
+    const size_t payload_size = buffer.size() - header_size - tag_size;
+
+    if (!crypto_.unprotect(buffer.data(), header_size, payload_size, roc)) {
+        roc_log(LogDebug,
+                "srtp parser: dropping packet: authentication failed: ssrc=%lu sn=%lu",
+                (unsigned long)ssrc, (unsigned long)seqnum);
+        return false;
+    }
+
+    if (!stream) {
+        stream = add_stream_(ssrc);
+    }
+    update_stream_(*stream, roc, seqnum);
+
+    return rtp_parser_.parse(packet, buffer.subslice(0, buffer.size() - tag_size));
+}
+
+// Header and extension are not encrypted, but we need their size
+// to find where encrypted payload starts.
+bool SrtpParser::header_size_(const core::Slice<uint8_t>& buffer, size_t& header_size) {
+    if (buffer.size() < sizeof(Header)) {
+        roc_log(LogDebug, "srtp parser: bad packet: size<%d (rtp header)",
+                (int)sizeof(Header));
+        return false;
+    }
+
+    const Header& header = *(const Header*)buffer.data();
+
+    if (header.version() != V2) {
+        roc_log(LogDebug, "srtp parser: bad version: get=%d expected=%d",
+                (int)header.version(), (int)V2);
+        return false;
+    }
+
+    header_size = header.header_size();
+
+    if (header.has_extension()) {
+        if (buffer.size() < header_size + sizeof(ExtentionHeader)) {
+            roc_log(LogDebug,
+                    "srtp parser: bad packet: size<%d (rtp header + ext header)",
+                    (int)(header_size + sizeof(ExtentionHeader)));
+            return false;
+        }
+
+        const ExtentionHeader& extension =
+            *(const ExtentionHeader*)(buffer.data() + header_size);
+
+        header_size += sizeof(ExtentionHeader) + extension.data_size();
+    }
+
+    if (buffer.size() < header_size) {
+        roc_log(LogDebug, "srtp parser: bad packet: size<%d (rtp header + ext)",
+                (int)header_size);
+        return false;
+    }
+
+    return true;
+}
+
+SrtpParser::Stream* SrtpParser::find_stream_(packet::stream_source_t ssrc) {
+    for (size_t n = 0; n < MaxStreams; n++) {
+        if (streams_[n].used && streams_[n].ssrc == ssrc) {
+            return &streams_[n];
+        }
+    }
+    return NULL;
+}
+
+SrtpParser::Stream* SrtpParser::add_stream_(packet::stream_source_t ssrc) {
+    // When table is full, streams are replaced in round-robin order.
+    Stream& stream = streams_[next_stream_];
+    next_stream_ = (next_stream_ + 1) % MaxStreams;
+
+    stream = Stream();
+    stream.used = true;
+    stream.ssrc = ssrc;
+
+    return &stream;
+}
+
+// Estimate rollover counter of packet (RFC 3711, appendix A).
+uint32_t SrtpParser::guess_roc_(const Stream& stream, packet::seqnum_t seqnum) {
+    if (stream.seqnum < 0x8000) {
+        if (int(seqnum) - int(stream.seqnum) > 0x8000 && stream.roc > 0) {
+            return stream.roc - 1;
+        }
+    } else {
+        if (int(stream.seqnum) - 0x8000 > int(seqnum)) {
+            return stream.roc + 1;
+        }
+    }
+    return stream.roc;
+}
+
+bool SrtpParser::check_replay_(const Stream& stream, uint64_t index) {
+    if (stream.window == 0) {
+        return true;
+    }
+
+    const uint64_t last_index = make_index(stream.roc, stream.seqnum);
+
+    if (index > last_index) {
+        return true;
+    }
+
+    const uint64_t delta = last_index - index;
+
+    if (delta >= ReplayWindow) {
+        return false;
+    }
+
+    return (stream.window & (uint64_t(1) << delta)) == 0;
+}
+
+void SrtpParser::update_stream_(Stream& stream,
+                                uint32_t roc,
+                                packet::seqnum_t seqnum) {
+    const uint64_t index = make_index(roc, seqnum);
+
+    if (stream.window == 0) {
+        stream.roc = roc;
+        stream.seqnum = seqnum;
+        stream.window = 1;
+        return;
+    }
+
+    const uint64_t last_index = make_index(stream.roc, stream.seqnum);
+
+    if (index > last_index) {
+        const uint64_t shift = index - last_index;
+
+        stream.window = shift < ReplayWindow ? (stream.window << shift) | 1 : 1;
+        stream.roc = roc;
+        stream.seqnum = seqnum;
+    } else {
+        stream.window |= uint64_t(1) << (last_index - index);
+    }
+}
+
+} // namespace rtp
+} // namespace roc
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_openssl/roc_rtp/srtp_parser.h
+//! @brief SRTP packet parser.
+
+#ifndef ROC_RTP_SRTP_PARSER_H_
+#define ROC_RTP_SRTP_PARSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iparser.h"
+#include "roc_packet/units.h"
+#include "roc_rtp/srtp_config.h"
+#include "roc_rtp/srtp_crypto.h"
+
+namespace roc {
+namespace rtp {
+
+//! SRTP packet parser.
+//! @remarks
+//!  Verifies authentication tag and decrypts payload in place, and then
+//!  passes RTP packet without tag to RTP parser.
+//!
+//!  Tracks rollover counter and replay window for every sender, as described
+//!  in RFC 3711, section 3.3. Streams are added only after first successfully
+//!  authenticated packet, so forged packets can't evict real ones.
+class SrtpParser : public packet::IParser, public core::NonCopyable<> {
+public:
+    //! Initialization.
+    //! @remarks
+    //!  @p rtp_parser is used to parse decrypted RTP packet.
+    SrtpParser(const SrtpConfig& config, packet::IParser& rtp_parser);
+
+    //! Check if parser was successfully initialized.
+    bool is_valid() const;
+
+    //! Parse packet from buffer.
+    virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+
+private:
+    enum {
+        // Maximum number of tracked senders.
+        MaxStreams = 16,
+
+        // Size of replay window, in packets.
+        ReplayWindow = 64
+    };
+
+    struct Stream {
+        bool used;
+        packet::stream_source_t ssrc;
+        uint32_t roc;
+        packet::seqnum_t seqnum;
+        uint64_t window;
+
+        Stream()
+            : used(false)
+            , ssrc(0)
+            , roc(0)
+            , seqnum(0)
+            , window(0) {
+        }
+    };
+
+    static bool header_size_(const core::Slice<uint8_t>& buffer, size_t& header_size);
+
+    Stream* find_stream_(packet::stream_source_t ssrc);
+    Stream* add_stream_(packet::stream_source_t ssrc);
+
+    static uint32_t guess_roc_(const Stream& stream, packet::seqnum_t seqnum);
+    static bool check_replay_(const Stream& stream, uint64_t index);
+    static void update_stream_(Stream& stream, uint32_t roc, packet::seqnum_t seqnum);
+
+    SrtpCrypto crypto_;
+    packet::IParser& rtp_parser_;
+
+    Stream streams_[MaxStreams];
+    size_t next_stream_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_SRTP_PARSER_H_
@@ -44,12 +44,18 @@ status::StatusCode TimestampInjector::read(packet::PacketPtr& pkt) {
         roc_panic("timestamp injector: unexpected non-rtp packet");
     }
 
-    if (pkt->rtp()->capture_timestamp != 0) {
-        roc_panic("timestamp injector: unexpected non-zero cts in packet: %lld",
+    if (pkt->rtp()->capture_timestamp < 0) {
+        roc_panic("timestamp injector: unexpected negative cts in packet: %lld",
                   (long long)pkt->rtp()->capture_timestamp);
     }
 
-    if (has_ts_) {
+    if (pkt->rtp()->capture_timestamp != 0) {
+        // Capture timestamp was delivered with packet itself,
+        // use it for following packets which don't have it.
+        capt_ts_ = pkt->rtp()->capture_timestamp;
+        rtp_ts_ = pkt->rtp()->stream_timestamp;
+        has_ts_ = true;
+    } else if (has_ts_) {
         const packet::stream_timestamp_diff_t rtp_dn =
             packet::stream_timestamp_diff(pkt->rtp()->stream_timestamp, rtp_ts_);
 
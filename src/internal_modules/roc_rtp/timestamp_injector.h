@@ -25,6 +25,8 @@ namespace rtp {
 //! @remarks
 //!  Gets a pair of a reference unix-time stamp (in ns) and correspondent rtp timestamp,
 //!  and approximates this dependency to a passing packet.
+//!  If packet already has capture timestamp (from RTP header extension), it is
+//!  kept as is and is used as the new reference pair.
 class TimestampInjector : public packet::IReader, public core::NonCopyable<> {
 public:
     //! Initialize.
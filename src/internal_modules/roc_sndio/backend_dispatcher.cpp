@@ -176,16 +176,17 @@ IDevice* BackendDispatcher::open_default_device_(DeviceType device_type,
                  | (device_type == DeviceType_Sink ? DriverFlag_SupportsSink
                                                    : DriverFlag_SupportsSource));
 
-    for (size_t n = 0; n < BackendMap::instance().num_drivers(); n++) {
-        const DriverInfo& driver_info = BackendMap::instance().nth_driver(n);
+    // Drivers are discovered lazily, so if a device of high-priority backend
+    // is opened, the rest backends are not probed.
+    const DriverInfo* driver_info = NULL;
 
-        if (!match_driver(driver_info, NULL, DriverType_Device, driver_flags)) {
+    for (size_t n = 0; (driver_info = BackendMap::instance().find_driver(n)); n++) {
+        if (!match_driver(*driver_info, NULL, DriverType_Device, driver_flags)) {
             continue;
         }
 
-        IDevice* device = BackendMap::instance().nth_driver(n).backend->open_device(
-            device_type, DriverType_Device, BackendMap::instance().nth_driver(n).name,
-            "default", config, arena_);
+        IDevice* device = driver_info->backend->open_device(
+            device_type, DriverType_Device, driver_info->name, "default", config, arena_);
         if (device) {
             return device;
         }
@@ -205,14 +206,14 @@ IDevice* BackendDispatcher::open_device_(DeviceType device_type,
                                         : DriverFlag_SupportsSource);
 
     if (driver_name != NULL) {
-        for (size_t n = 0; n < BackendMap::instance().num_drivers(); n++) {
-            const DriverInfo& driver_info = BackendMap::instance().nth_driver(n);
+        const DriverInfo* driver_info = NULL;
 
-            if (!match_driver(driver_info, driver_name, driver_type, driver_flags)) {
+        for (size_t n = 0; (driver_info = BackendMap::instance().find_driver(n)); n++) {
+            if (!match_driver(*driver_info, driver_name, driver_type, driver_flags)) {
                 continue;
             }
 
-            IDevice* device = BackendMap::instance().nth_driver(n).backend->open_device(
+            IDevice* device = driver_info->backend->open_device(
                 device_type, driver_type, driver_name, path, config, arena_);
             if (device) {
                 return device;
@@ -15,12 +15,12 @@ namespace sndio {
 
 BackendMap::BackendMap()
     : backends_(core::NoopArena)
-    , drivers_(core::NoopArena) {
+    , drivers_(core::NoopArena)
+    , n_discovered_(0) {
     register_backends_();
-    register_drivers_();
 
-    roc_log(LogDebug, "backend map: initializing: n_backends=%d n_drivers=%d",
-            (int)backends_.size(), (int)drivers_.size());
+    roc_log(LogDebug, "backend map: initializing: n_backends=%d",
+            (int)backends_.size());
 }
 
 size_t BackendMap::num_backends() const {
@@ -32,11 +32,36 @@ IBackend& BackendMap::nth_backend(size_t backend_index) const {
 }
 
 size_t BackendMap::num_drivers() const {
+    core::Mutex::Lock lock(mutex_);
+
+    while (discover_next_backend_()) {
+    }
+
     return drivers_.size();
 }
 
 const DriverInfo& BackendMap::nth_driver(size_t driver_index) const {
-    return drivers_[driver_index];
+    const DriverInfo* driver_info = find_driver(driver_index);
+    if (!driver_info) {
+        roc_panic("backend map: driver index out of bounds: index=%lu",
+                  (unsigned long)driver_index);
+    }
+
+    return *driver_info;
+}
+
+const DriverInfo* BackendMap::find_driver(size_t driver_index) const {
+    core::Mutex::Lock lock(mutex_);
+
+    while (driver_index >= drivers_.size()) {
+        if (!discover_next_backend_()) {
+            return NULL;
+        }
+    }
+
+    // drivers_ has fixed capacity and never reallocates,
+    // so it's safe to use the pointer after unlocking
+    return &drivers_[driver_index];
 }
 
 void BackendMap::set_frame_size(core::nanoseconds_t frame_length,
@@ -55,6 +80,11 @@ void BackendMap::register_backends_() {
     add_backend_(pulseaudio_backend_.get());
 #endif // ROC_TARGET_PULSEAUDIO
 
+#ifdef ROC_TARGET_ALSA
+    alsa_backend_.reset(new (alsa_backend_) AlsaBackend);
+    add_backend_(alsa_backend_.get());
+#endif // ROC_TARGET_ALSA
+
 #ifdef ROC_TARGET_SNDFILE
     sndfile_backend_.reset(new (sndfile_backend_) SndfileBackend);
     add_backend_(sndfile_backend_.get());
@@ -69,10 +99,18 @@ void BackendMap::register_backends_() {
 #endif // ROC_TARGET_SOX
 }
 
-void BackendMap::register_drivers_() {
-    for (size_t n = 0; n < backends_.size(); n++) {
-        backends_[n]->discover_drivers(drivers_);
+bool BackendMap::discover_next_backend_() const {
+    if (n_discovered_ == backends_.size()) {
+        return false;
     }
+
+    IBackend* backend = backends_[n_discovered_++];
+    backend->discover_drivers(drivers_);
+
+    roc_log(LogDebug, "backend map: discovered drivers: backend=%s n_drivers=%d",
+            backend->name(), (int)drivers_.size());
+
+    return true;
 }
 
 void BackendMap::add_backend_(IBackend* backend) {
@@ -12,6 +12,7 @@
 #ifndef ROC_SNDIO_BACKEND_MAP_H_
 #define ROC_SNDIO_BACKEND_MAP_H_
 
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/singleton.h"
@@ -22,6 +23,10 @@
 #include "roc_sndio/pulseaudio_backend.h"
 #endif // ROC_TARGET_PULSEAUDIO
 
+#ifdef ROC_TARGET_ALSA
+#include "roc_sndio/alsa_backend.h"
+#endif // ROC_TARGET_ALSA
+
 #ifdef ROC_TARGET_SNDFILE
 #include "roc_sndio/sndfile_backend.h"
 #endif // ROC_TARGET_SNDFILE
@@ -36,6 +41,12 @@ namespace roc {
 namespace sndio {
 
 //! Backend map.
+//!
+//! Backends are created when map is created, but they don't initialize
+//! underlying libraries until they're used. Drivers are discovered lazily,
+//! backend by backend in order of priority, so that, for example, opening
+//! a device of the first backend doesn't require initializing and probing
+//! the rest backends.
 class BackendMap : public core::NonCopyable<> {
 public:
     //! Get instance.
@@ -50,11 +61,22 @@ public:
     IBackend& nth_backend(size_t backend_index) const;
 
     //! Get number of drivers available.
+    //! @remarks
+    //!  Discovers drivers of all backends.
     size_t num_drivers() const;
 
     //! Get driver by index.
+    //! @remarks
+    //!  Discovers drivers of backends up to the one that owns the driver.
     const DriverInfo& nth_driver(size_t driver_index) const;
 
+    //! Get driver by index, if it exists.
+    //! @remarks
+    //!  Discovers drivers of backends up to the one that owns the driver.
+    //!  Returns NULL if there are less drivers. Can be used to iterate drivers
+    //!  in order of priority and stop early without probing all backends.
+    const DriverInfo* find_driver(size_t driver_index) const;
+
     //! Set internal buffer size for all backends that need it.
     void set_frame_size(core::nanoseconds_t frame_length,
                         const audio::SampleSpec& sample_spec);
@@ -65,7 +87,7 @@ private:
     BackendMap();
 
     void register_backends_();
-    void register_drivers_();
+    bool discover_next_backend_() const;
 
     void add_backend_(IBackend*);
 
@@ -73,6 +95,10 @@ private:
     core::Optional<PulseaudioBackend> pulseaudio_backend_;
 #endif // ROC_TARGET_PULSEAUDIO
 
+#ifdef ROC_TARGET_ALSA
+    core::Optional<AlsaBackend> alsa_backend_;
+#endif // ROC_TARGET_ALSA
+
 #ifdef ROC_TARGET_SNDFILE
     core::Optional<SndfileBackend> sndfile_backend_;
 #endif // ROC_TARGET_SNDFILE
@@ -84,7 +110,12 @@ private:
     core::Optional<WavBackend> wav_backend_;
 
     core::Array<IBackend*, MaxBackends> backends_;
-    core::Array<DriverInfo, MaxDrivers> drivers_;
+
+    core::Mutex mutex_;
+
+    // drivers of first n_discovered_ backends
+    mutable core::Array<DriverInfo, MaxDrivers> drivers_;
+    mutable size_t n_discovered_;
 };
 
 } // namespace sndio
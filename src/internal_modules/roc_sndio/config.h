@@ -36,10 +36,18 @@ struct Config {
     //! Requested input or output latency.
     core::nanoseconds_t latency;
 
+    //! Length of lock-free ring buffer between pump and device, in nanoseconds.
+    //! If zero, frames are written to or read from device directly.
+    //! Currently supported by PulseAudio sink, where ring is drained by stream
+    //! callback, and by sndfile source and sink, where ring is filled or drained
+    //! by I/O thread in large blocks.
+    core::nanoseconds_t ring_length;
+
     //! Initialize.
     Config()
         : frame_length(DefaultFrameLength)
-        , latency(0) {
+        , latency(0)
+        , ring_length(0) {
     }
 };
 
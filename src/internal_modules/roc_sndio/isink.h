@@ -12,6 +12,7 @@
 #ifndef ROC_SNDIO_ISINK_H_
 #define ROC_SNDIO_ISINK_H_
 
+#include "roc_audio/iframe_reader.h"
 #include "roc_audio/iframe_writer.h"
 #include "roc_sndio/idevice.h"
 
@@ -22,6 +23,21 @@ namespace sndio {
 class ISink : virtual public IDevice, public audio::IFrameWriter {
 public:
     virtual ~ISink();
+
+    //! Start pulling frames from reader.
+    //! @remarks
+    //!  If supported, the sink invokes reader.read() from its own (typically
+    //!  realtime) callback whenever it needs more samples and renders them
+    //!  directly into the device buffer, instead of waiting for write() calls.
+    //!  The reader is used until stop_pull() is called.
+    //! @returns
+    //!  false if pull mode is not supported by the sink.
+    virtual bool start_pull(audio::IFrameReader& reader);
+
+    //! Stop pulling frames from reader.
+    //! @remarks
+    //!  After this call, the reader passed to start_pull() is not used anymore.
+    virtual void stop_pull();
 };
 
 } // namespace sndio
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/mixing_source.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+MixingSource::MixingSource(core::IPool& frame_buffer_pool,
+                           const audio::SampleSpec& sample_spec,
+                           size_t num_threads,
+                           core::IArena& arena)
+    : frame_factory_(frame_buffer_pool)
+    , sample_spec_(sample_spec)
+    , inputs_(arena)
+    , valid_(false) {
+    if (!sample_spec_.is_valid() || !sample_spec_.is_raw()) {
+        roc_log(LogError,
+                "mixing source: required valid sample spec with raw format: %s",
+                audio::sample_spec_to_str(sample_spec_).c_str());
+        return;
+    }
+
+    if (num_threads != 0) {
+        workers_.reset(new (workers_) core::WorkerPool(num_threads, arena));
+        if (!workers_ || !workers_->is_valid()) {
+            return;
+        }
+    }
+
+    mixer_.reset(new (mixer_) audio::Mixer(frame_factory_, sample_spec_, true,
+                                           audio::MixerConfig(), workers_.get(),
+                                           arena));
+    if (!mixer_ || !mixer_->is_valid()) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool MixingSource::is_valid() const {
+    return valid_;
+}
+
+bool MixingSource::add_input(ISource& source) {
+    roc_panic_if(!is_valid());
+
+    if (source.sample_spec() != sample_spec_) {
+        roc_log(LogError, "mixing source: input sample spec mismatch: want=%s got=%s",
+                audio::sample_spec_to_str(sample_spec_).c_str(),
+                audio::sample_spec_to_str(source.sample_spec()).c_str());
+        return false;
+    }
+
+    if (!inputs_.push_back(&source)) {
+        roc_log(LogError, "mixing source: can't allocate input");
+        return false;
+    }
+
+    if (!mixer_->add_input(source)) {
+        inputs_.resize(inputs_.size() - 1);
+        return false;
+    }
+
+    return true;
+}
+
+ISink* MixingSource::to_sink() {
+    return NULL;
+}
+
+ISource* MixingSource::to_source() {
+    return this;
+}
+
+DeviceType MixingSource::type() const {
+    return DeviceType_Source;
+}
+
+DeviceState MixingSource::state() const {
+    DeviceState state = DeviceState_Paused;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        const DeviceState input_state = inputs_[n]->state();
+
+        if (input_state == DeviceState_Active) {
+            return DeviceState_Active;
+        }
+        if (input_state == DeviceState_Idle) {
+            state = DeviceState_Idle;
+        }
+    }
+
+    return state;
+}
+
+void MixingSource::pause() {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        inputs_[n]->pause();
+    }
+}
+
+bool MixingSource::resume() {
+    bool ok = true;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (!inputs_[n]->resume()) {
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool MixingSource::restart() {
+    bool ok = true;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (!inputs_[n]->restart()) {
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+audio::SampleSpec MixingSource::sample_spec() const {
+    return sample_spec_;
+}
+
+core::nanoseconds_t MixingSource::latency() const {
+    core::nanoseconds_t latency = 0;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (inputs_[n]->has_latency()) {
+            latency = std::max(latency, inputs_[n]->latency());
+        }
+    }
+
+    return latency;
+}
+
+bool MixingSource::has_latency() const {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (inputs_[n]->has_latency()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MixingSource::has_clock() const {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (inputs_[n]->has_clock()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MixingSource::reclock(core::nanoseconds_t timestamp) {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        inputs_[n]->reclock(timestamp);
+    }
+}
+
+bool MixingSource::read(audio::Frame& frame) {
+    roc_panic_if(!is_valid());
+
+    return mixer_->read(frame);
+}
+
+} // namespace sndio
+} // namespace roc
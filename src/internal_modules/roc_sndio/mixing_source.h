@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/mixing_source.h
+//! @brief Mixing source.
+
+#ifndef ROC_SNDIO_MIXING_SOURCE_H_
+#define ROC_SNDIO_MIXING_SOURCE_H_
+
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/mixer.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
+#include "roc_core/ipool.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/worker_pool.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! Mixing source.
+//!
+//! Combines several sources with same sample spec into one source, which
+//! output is the mix of their outputs. All inputs are paused, resumed, and
+//! reclocked together.
+//!
+//! If @p num_threads is non-zero, inputs are read in parallel using a pool
+//! of this many threads together with the calling thread. Inputs should be
+//! independent, e.g. separate pipelines, so that they can be read concurrently.
+class MixingSource : public ISource, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    MixingSource(core::IPool& frame_buffer_pool,
+                 const audio::SampleSpec& sample_spec,
+                 size_t num_threads,
+                 core::IArena& arena);
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Add input source.
+    ROC_ATTR_NODISCARD bool add_input(ISource& source);
+
+    //! Cast IDevice to ISink.
+    virtual ISink* to_sink();
+
+    //! Cast IDevice to ISource.
+    virtual ISource* to_source();
+
+    //! Get device type.
+    virtual DeviceType type() const;
+
+    //! Get device state.
+    //! @remarks
+    //!  Active if any input is active.
+    virtual DeviceState state() const;
+
+    //! Pause reading.
+    virtual void pause();
+
+    //! Resume paused reading.
+    virtual bool resume();
+
+    //! Restart reading from the beginning.
+    virtual bool restart();
+
+    //! Get sample specification of the source.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of the source.
+    //! @remarks
+    //!  Maximum latency of inputs.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if the source supports latency reports.
+    virtual bool has_latency() const;
+
+    //! Check if the source has own clock.
+    virtual bool has_clock() const;
+
+    //! Adjust source clock to match consumer clock.
+    virtual void reclock(core::nanoseconds_t timestamp);
+
+    //! Read frame.
+    virtual bool read(audio::Frame& frame);
+
+private:
+    audio::FrameFactory frame_factory_;
+    const audio::SampleSpec sample_spec_;
+
+    core::Array<ISource*, 8> inputs_;
+
+    core::Optional<core::WorkerPool> workers_;
+    core::Optional<audio::Mixer> mixer_;
+
+    bool valid_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_MIXING_SOURCE_H_
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/prebuffered_source.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+PrebufferedSource::PrebufferedSource(core::IArena& arena,
+                                     ISource& source,
+                                     core::nanoseconds_t frame_length,
+                                     core::nanoseconds_t buffer_length)
+    : source_(source)
+    , sample_spec_(source.sample_spec())
+    , block_size_(0)
+    , n_blocks_(0)
+    , prefix_(arena)
+    , prefix_size_(0)
+    , prefix_eof_(false)
+    , ring_(arena)
+    , ring_sizes_(arena)
+    , cond_(mutex_)
+    , ring_head_(0)
+    , ring_count_(0)
+    , ring_eof_(false)
+    , rewind_(false)
+    , stop_(false)
+    , prefix_pos_(0)
+    , ring_pos_(0)
+    , ring_used_(false)
+    , paused_(false)
+    , switch_pending_(false)
+    , switch_start_(0)
+    , valid_(false) {
+    if (source_.has_clock()) {
+        roc_log(LogError, "prebuffered source: source with own clock is not supported");
+        return;
+    }
+
+    if (frame_length <= 0 || buffer_length <= 0) {
+        roc_log(LogError,
+                "prebuffered source: invalid config:"
+                " frame_length and buffer_length should be positive");
+        return;
+    }
+
+    block_size_ = sample_spec_.ns_2_samples_overall(frame_length);
+    if (block_size_ < sample_spec_.num_channels()) {
+        block_size_ = sample_spec_.num_channels();
+    }
+
+    n_blocks_ = size_t((buffer_length + frame_length - 1) / frame_length);
+    if (n_blocks_ < 2) {
+        n_blocks_ = 2;
+    }
+
+    if (!prefix_.resize(n_blocks_ * block_size_) || !ring_.resize(n_blocks_ * block_size_)
+        || !ring_sizes_.resize(n_blocks_)) {
+        roc_log(LogError, "prebuffered source: can't allocate buffers");
+        return;
+    }
+
+    if (!fill_prefix_()) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "prebuffered source: initialized:"
+            " buffer_len=%.3fms n_blocks=%lu block_size=%lu prefix_size=%lu eof=%d",
+            (double)buffer_length / core::Millisecond, (unsigned long)n_blocks_,
+            (unsigned long)block_size_, (unsigned long)prefix_size_, (int)prefix_eof_);
+
+    if (prefix_eof_) {
+        // Whole stream fits into prefix, ring is not needed.
+        ring_eof_ = true;
+    } else if (!start()) {
+        roc_log(LogError, "prebuffered source: can't start decoding thread");
+        return;
+    }
+
+    valid_ = true;
+}
+
+PrebufferedSource::~PrebufferedSource() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        cond_.broadcast();
+    }
+
+    if (is_joinable()) {
+        join();
+    }
+}
+
+bool PrebufferedSource::is_valid() const {
+    return valid_;
+}
+
+PrebufferedSourceMetrics PrebufferedSource::get_metrics() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return metrics_;
+}
+
+ISink* PrebufferedSource::to_sink() {
+    return NULL;
+}
+
+ISource* PrebufferedSource::to_source() {
+    return this;
+}
+
+DeviceType PrebufferedSource::type() const {
+    return DeviceType_Source;
+}
+
+DeviceState PrebufferedSource::state() const {
+    return paused_ ? DeviceState_Paused : DeviceState_Active;
+}
+
+void PrebufferedSource::pause() {
+    paused_ = true;
+}
+
+bool PrebufferedSource::resume() {
+    paused_ = false;
+    return true;
+}
+
+bool PrebufferedSource::restart() {
+    roc_panic_if(!valid_);
+
+    roc_log(LogDebug, "prebuffered source: restarting");
+
+    if (ring_used_) {
+        request_rewind_();
+    }
+
+    prefix_pos_ = 0;
+    paused_ = false;
+
+    switch_pending_ = true;
+    switch_start_ = core::timestamp(core::ClockMonotonic);
+
+    return true;
+}
+
+audio::SampleSpec PrebufferedSource::sample_spec() const {
+    return sample_spec_;
+}
+
+core::nanoseconds_t PrebufferedSource::latency() const {
+    return 0;
+}
+
+bool PrebufferedSource::has_latency() const {
+    return false;
+}
+
+bool PrebufferedSource::has_clock() const {
+    return false;
+}
+
+void PrebufferedSource::reclock(core::nanoseconds_t) {
+    // no-op, underlying source has no clock
+}
+
+bool PrebufferedSource::read(audio::Frame& frame) {
+    roc_panic_if(!valid_);
+
+    audio::sample_t* frame_data = frame.raw_samples();
+    const size_t frame_size = frame.num_raw_samples();
+
+    size_t n_samples = read_prefix_(frame_data, frame_size);
+
+    if (n_samples < frame_size && !prefix_eof_) {
+        n_samples += read_ring_(frame_data + n_samples, frame_size - n_samples);
+    }
+
+    if (n_samples == 0) {
+        // Start rewinding early, restart() will likely follow.
+        if (ring_used_) {
+            request_rewind_();
+        }
+        return false;
+    }
+
+    if (n_samples < frame_size) {
+        memset(frame_data + n_samples, 0,
+               (frame_size - n_samples) * sizeof(audio::sample_t));
+    }
+
+    if (switch_pending_) {
+        report_switch_();
+    }
+
+    return true;
+}
+
+// Decoding thread.
+void PrebufferedSource::run() {
+    for (;;) {
+        bool rewind = false;
+        size_t index = 0;
+
+        {
+            core::Mutex::Lock lock(mutex_);
+
+            while (!stop_ && !rewind_ && (ring_eof_ || ring_count_ == n_blocks_)) {
+                cond_.wait();
+            }
+
+            if (stop_) {
+                break;
+            }
+
+            if (rewind_) {
+                rewind_ = false;
+                rewind = true;
+
+                ring_head_ = 0;
+                ring_count_ = 0;
+                ring_eof_ = false;
+            } else {
+                index = (ring_head_ + ring_count_) % n_blocks_;
+            }
+        }
+
+        if (rewind) {
+            if (!rewind_source_()) {
+                core::Mutex::Lock lock(mutex_);
+
+                ring_eof_ = true;
+                cond_.broadcast();
+            }
+            continue;
+        }
+
+        // Block is not visible to reader until committed, so we can
+        // fill it without holding the lock.
+        audio::Frame frame(ring_.data() + index * block_size_, block_size_);
+        const bool ok = source_.read(frame);
+
+        core::Mutex::Lock lock(mutex_);
+
+        if (rewind_) {
+            // Block belongs to old position, drop it.
+            continue;
+        }
+
+        if (ok) {
+            ring_sizes_[index] = block_size_;
+            ring_count_++;
+        } else {
+            ring_eof_ = true;
+        }
+
+        cond_.broadcast();
+    }
+}
+
+bool PrebufferedSource::fill_prefix_() {
+    while (prefix_size_ < prefix_.size()) {
+        audio::Frame frame(prefix_.data() + prefix_size_, block_size_);
+
+        if (!source_.read(frame)) {
+            prefix_eof_ = true;
+            break;
+        }
+
+        prefix_size_ += block_size_;
+    }
+
+    if (prefix_size_ == 0) {
+        roc_log(LogError, "prebuffered source: source is empty");
+        return false;
+    }
+
+    return true;
+}
+
+// Called from decoding thread, without lock.
+bool PrebufferedSource::rewind_source_() {
+    const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+    if (!source_.restart()) {
+        roc_log(LogError, "prebuffered source: can't restart source");
+        return false;
+    }
+
+    // Skip part which is already in prefix. First ring block is not visible
+    // to reader yet and is used as scratch buffer.
+    for (size_t pos = 0; pos < prefix_size_; pos += block_size_) {
+        audio::Frame frame(ring_.data(), block_size_);
+
+        if (!source_.read(frame)) {
+            roc_log(LogError, "prebuffered source: source became shorter after restart");
+            return false;
+        }
+    }
+
+    roc_log(LogDebug, "prebuffered source: rewound source in %.3fms",
+            (double)(core::timestamp(core::ClockMonotonic) - start_time)
+                / core::Millisecond);
+
+    return true;
+}
+
+void PrebufferedSource::request_rewind_() {
+    core::Mutex::Lock lock(mutex_);
+
+    rewind_ = true;
+    cond_.broadcast();
+
+    ring_pos_ = 0;
+    ring_used_ = false;
+}
+
+size_t PrebufferedSource::read_prefix_(audio::sample_t* data, size_t size) {
+    size_t n_samples = prefix_size_ - prefix_pos_;
+    if (n_samples > size) {
+        n_samples = size;
+    }
+
+    if (n_samples != 0) {
+        memcpy(data, prefix_.data() + prefix_pos_, n_samples * sizeof(audio::sample_t));
+        prefix_pos_ += n_samples;
+    }
+
+    return n_samples;
+}
+
+size_t PrebufferedSource::read_ring_(audio::sample_t* data, size_t size) {
+    core::Mutex::Lock lock(mutex_);
+
+    size_t n_samples = 0;
+
+    while (n_samples < size) {
+        if (!stop_ && (rewind_ || (ring_count_ == 0 && !ring_eof_))) {
+            // Decoding thread is behind.
+            metrics_.underrun_count++;
+
+            while (!stop_ && (rewind_ || (ring_count_ == 0 && !ring_eof_))) {
+                cond_.wait();
+            }
+        }
+
+        if (ring_count_ == 0) {
+            break;
+        }
+
+        const audio::sample_t* block = ring_.data() + ring_head_ * block_size_;
+        const size_t block_size = ring_sizes_[ring_head_];
+
+        size_t n_copy = block_size - ring_pos_;
+        if (n_copy > size - n_samples) {
+            n_copy = size - n_samples;
+        }
+
+        memcpy(data + n_samples, block + ring_pos_, n_copy * sizeof(audio::sample_t));
+
+        n_samples += n_copy;
+        ring_pos_ += n_copy;
+
+        if (ring_pos_ == block_size) {
+            ring_head_ = (ring_head_ + 1) % n_blocks_;
+            ring_count_--;
+            ring_pos_ = 0;
+
+            cond_.broadcast();
+        }
+    }
+
+    if (n_samples != 0) {
+        ring_used_ = true;
+    }
+
+    return n_samples;
+}
+
+void PrebufferedSource::report_switch_() {
+    const core::nanoseconds_t switch_time =
+        core::timestamp(core::ClockMonotonic) - switch_start_;
+
+    switch_pending_ = false;
+
+    PrebufferedSourceMetrics metrics;
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        metrics_.switch_count++;
+        metrics_.last_switch_time = switch_time;
+        if (metrics_.max_switch_time < switch_time) {
+            metrics_.max_switch_time = switch_time;
+        }
+
+        metrics = metrics_;
+    }
+
+    roc_log(LogInfo, "prebuffered source: switched in %.3fms: max=%.3fms n_switches=%lu",
+            (double)switch_time / core::Millisecond,
+            (double)metrics.max_switch_time / core::Millisecond,
+            (unsigned long)metrics.switch_count);
+}
+
+} // namespace sndio
+} // namespace roc
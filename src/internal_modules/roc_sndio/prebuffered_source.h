@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/prebuffered_source.h
+//! @brief Source decorator with pre-decoded beginning of stream.
+
+#ifndef ROC_SNDIO_PREBUFFERED_SOURCE_H_
+#define ROC_SNDIO_PREBUFFERED_SOURCE_H_
+
+#include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/cond.h"
+#include "roc_core/iarena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! Prebuffered source metrics.
+struct PrebufferedSourceMetrics {
+    //! Number of times source was restarted.
+    size_t switch_count;
+
+    //! Time from last restart() until first frame was read.
+    core::nanoseconds_t last_switch_time;
+
+    //! Maximum time from restart() until first frame was read.
+    core::nanoseconds_t max_switch_time;
+
+    //! Number of reads that waited for decoding thread.
+    size_t underrun_count;
+
+    PrebufferedSourceMetrics()
+        : switch_count(0)
+        , last_switch_time(0)
+        , max_switch_time(0)
+        , underrun_count(0) {
+    }
+};
+
+//! Source decorator with pre-decoded beginning of stream.
+//! @remarks
+//!  Intended for backup sources, which are restarted every time they're
+//!  switched to, and which may be slow to restart and decode, e.g. files
+//!  opened via sndfile or SoX backends.
+//!
+//!  When constructed, decodes first @p buffer_length of the stream into memory
+//!  (prefix). Then a background thread decodes the rest of the stream ahead
+//!  into a ring of the same length.
+//!
+//!  restart() doesn't touch underlying source and returns immediately; reading
+//!  starts from the prefix. If the ring was already consumed, background thread
+//!  restarts underlying source, skips the prefix and refills the ring, while
+//!  reader plays the prefix. Thus switching to the source has no latency as
+//!  long as restarting and decoding doesn't take longer than the prefix.
+//!
+//!  Underlying source is accessed only from background thread after
+//!  construction. It should not have its own clock.
+class PrebufferedSource : public ISource,
+                          private core::NonCopyable<>,
+                          private core::Thread {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p source should be just opened, i.e. positioned at the beginning.
+    PrebufferedSource(core::IArena& arena,
+                      ISource& source,
+                      core::nanoseconds_t frame_length,
+                      core::nanoseconds_t buffer_length);
+
+    virtual ~PrebufferedSource();
+
+    //! Check if the object was successfully constructed.
+    bool is_valid() const;
+
+    //! Get metrics.
+    //! @remarks
+    //!  Can be called from any thread.
+    PrebufferedSourceMetrics get_metrics() const;
+
+    //! Cast IDevice to ISink.
+    virtual ISink* to_sink();
+
+    //! Cast IDevice to ISink.
+    virtual ISource* to_source();
+
+    //! Get device type.
+    virtual DeviceType type() const;
+
+    //! Get device state.
+    virtual DeviceState state() const;
+
+    //! Pause reading.
+    virtual void pause();
+
+    //! Resume paused reading.
+    virtual bool resume();
+
+    //! Restart reading from the beginning.
+    virtual bool restart();
+
+    //! Get sample specification of the source.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of the source.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if the source supports latency reports.
+    virtual bool has_latency() const;
+
+    //! Check if the source has own clock.
+    virtual bool has_clock() const;
+
+    //! Adjust source clock to match consumer clock.
+    virtual void reclock(core::nanoseconds_t timestamp);
+
+    //! Read frame.
+    virtual bool read(audio::Frame&);
+
+private:
+    virtual void run();
+
+    bool fill_prefix_();
+    bool rewind_source_();
+    void request_rewind_();
+
+    size_t read_prefix_(audio::sample_t* data, size_t size);
+    size_t read_ring_(audio::sample_t* data, size_t size);
+
+    void report_switch_();
+
+    ISource& source_;
+    audio::SampleSpec sample_spec_;
+
+    size_t block_size_;
+    size_t n_blocks_;
+
+    // Beginning of stream, immutable after construction.
+    core::Array<audio::sample_t> prefix_;
+    size_t prefix_size_;
+    bool prefix_eof_;
+
+    // Continuation of stream after prefix.
+    core::Array<audio::sample_t> ring_;
+    core::Array<size_t> ring_sizes_;
+
+    // Accessed by both threads.
+    core::Mutex mutex_;
+    core::Cond cond_;
+    size_t ring_head_;
+    size_t ring_count_;
+    bool ring_eof_;
+    bool rewind_;
+    bool stop_;
+    PrebufferedSourceMetrics metrics_;
+
+    // Accessed only by reader thread.
+    size_t prefix_pos_;
+    size_t ring_pos_;
+    bool ring_used_;
+    bool paused_;
+    bool switch_pending_;
+    core::nanoseconds_t switch_start_;
+
+    bool valid_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_PREBUFFERED_SOURCE_H_
@@ -8,6 +8,9 @@
 
 #include "roc_sndio/pump.h"
 #include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/probe.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace sndio {
@@ -24,8 +27,13 @@ Pump::Pump(core::IPool& buffer_pool,
     , backup_source_(backup_source)
     , sink_(sink)
     , sample_spec_(sample_spec)
+    , batch_arena_(NULL)
+    , batch_buffer_(NULL)
+    , batch_size_(0)
     , n_bufs_(0)
     , oneshot_(mode == ModeOneshot)
+    , pull_started_(0)
+    , pull_eof_(0)
     , stop_(0) {
     size_t frame_size = sample_spec_.ns_2_samples_overall(frame_length);
     if (frame_size == 0) {
@@ -49,10 +57,50 @@ Pump::Pump(core::IPool& buffer_pool,
     frame_buffer_.reslice(0, frame_size);
 }
 
+Pump::~Pump() {
+    if (batch_buffer_) {
+        batch_arena_->deallocate(batch_buffer_);
+    }
+}
+
 bool Pump::is_valid() const {
     return frame_buffer_;
 }
 
+bool Pump::enable_batching(core::IArena& arena, core::nanoseconds_t batch_length) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(batch_buffer_);
+
+    if (sink_.has_clock()) {
+        roc_log(LogInfo, "pump: sink has own clock, not enabling batch mode");
+        return true;
+    }
+
+    // batch is always a whole number of frames
+    const size_t frame_size = frame_buffer_.size();
+    const size_t n_frames = sample_spec_.ns_2_samples_overall(batch_length) / frame_size;
+
+    if (n_frames < 2) {
+        roc_log(LogDebug, "pump: batch is shorter than two frames, not enabling");
+        return true;
+    }
+
+    batch_buffer_ =
+        (audio::sample_t*)arena.allocate(n_frames * frame_size * sizeof(audio::sample_t));
+    if (!batch_buffer_) {
+        roc_log(LogError, "pump: can't allocate batch buffer");
+        return false;
+    }
+
+    batch_arena_ = &arena;
+    batch_size_ = n_frames * frame_size;
+
+    roc_log(LogDebug, "pump: enabled batch mode: n_frames=%lu batch_size=%lu",
+            (unsigned long)n_frames, (unsigned long)batch_size_);
+
+    return true;
+}
+
 bool Pump::run() {
     roc_log(LogDebug, "pump: starting main loop");
 
@@ -89,8 +137,10 @@ bool Pump::run() {
             }
         }
 
-        // read frame
-        if (!transfer_frame_(*current_source)) {
+        // read frame, or several frames in batch mode
+        const bool ok = batch_buffer_ ? transfer_batch_(*current_source)
+                                      : transfer_frame_(*current_source);
+        if (!ok) {
             roc_log(LogDebug, "pump: got eof from source");
 
             if (current_source == backup_source_) {
@@ -120,32 +170,15 @@ bool Pump::transfer_frame_(ISource& current_source) {
         return false;
     }
 
-    if (!frame.has_duration()) {
-        // if source does not provide frame duration, we fill it here
-        // we assume that the frame has some PCM format
-        frame.set_duration(sample_spec_.bytes_2_stream_timestamp(frame.num_bytes()));
-    }
-
-    if (frame.capture_timestamp() == 0) {
-        // if source does not provide capture timestamps, we fill them here
-        // we subtract source latency to take into account recording buffer size,
-        // where this frame spent some time before we read it
-        // we subtract frame size because we already read the whole frame from
-        // recording buffer, and should take it into account too
-        core::nanoseconds_t capture_latency = 0;
-
-        if (current_source.has_latency()) {
-            capture_latency = current_source.latency()
-                + sample_spec_.stream_timestamp_2_ns(frame.duration());
-        }
-
-        frame.set_capture_timestamp(core::timestamp(core::ClockUnix) - capture_latency);
-    }
+    prepare_frame_(current_source, frame);
 
     // if sink has clock, here we block on it
     // note that either source or sink has clock, but not both
     sink_.write(frame);
 
+    roc_probe(pump_frame, (unsigned long)n_bufs_, (uint32_t)frame.duration(),
+              (unsigned)frame.flags(), (int64_t)frame.capture_timestamp());
+
     {
         // tell source what is playback time of first sample of last read frame
         // we add sink latency to take into account playback buffer size
@@ -158,12 +191,182 @@ bool Pump::transfer_frame_(ISource& current_source) {
                 sink_.latency() - sample_spec_.stream_timestamp_2_ns(frame.duration());
         }
 
-        current_source.reclock(core::timestamp(core::ClockUnix) + playback_latency);
+        current_source.reclock(core::timestamp(core::ClockMedia) + playback_latency);
+    }
+
+    return true;
+}
+
+bool Pump::transfer_batch_(ISource& current_source) {
+    const size_t frame_size = frame_buffer_.size();
+
+    size_t batch_pos = 0;
+    unsigned batch_flags = audio::Frame::FlagSilent;
+    packet::stream_timestamp_t batch_duration = 0;
+    packet::stream_timestamp_t last_duration = 0;
+    core::nanoseconds_t batch_capture_ts = 0;
+
+    // read frames directly into batch buffer, without any copying
+    while (batch_pos < batch_size_ && !stop_) {
+        audio::Frame frame(batch_buffer_ + batch_pos, frame_size);
+
+        if (!current_source.read(frame)) {
+            break;
+        }
+
+        prepare_frame_(current_source, frame);
+
+        if (batch_pos == 0) {
+            batch_capture_ts = frame.capture_timestamp();
+        }
+
+        batch_flags = audio::Frame::combine_flags(batch_flags, frame.flags());
+        batch_duration += frame.duration();
+        last_duration = frame.duration();
+        batch_pos += frame_size;
+
+        // don't delay switching to backup source or exiting in oneshot mode
+        if (&current_source == &main_source_
+            && main_source_.state() != DeviceState_Active) {
+            break;
+        }
+    }
+
+    if (batch_pos == 0) {
+        return false;
+    }
+
+    audio::Frame batch(batch_buffer_, batch_pos);
+    batch.set_flags(batch_flags);
+    batch.set_duration(batch_duration);
+    batch.set_capture_timestamp(batch_capture_ts);
+
+    sink_.write(batch);
+
+    roc_probe(pump_frame, (unsigned long)n_bufs_, (uint32_t)batch.duration(),
+              (unsigned)batch.flags(), (int64_t)batch.capture_timestamp());
+
+    {
+        // same as in transfer_frame_(), for the last frame of the batch
+        core::nanoseconds_t playback_latency = 0;
+
+        if (sink_.has_latency()) {
+            playback_latency =
+                sink_.latency() - sample_spec_.stream_timestamp_2_ns(last_duration);
+        }
+
+        current_source.reclock(core::timestamp(core::ClockMedia) + playback_latency);
     }
 
     return true;
 }
 
+bool Pump::run_pull() {
+    if (backup_source_) {
+        roc_log(LogError, "pump: backup source is not supported in pull mode");
+        return false;
+    }
+
+    if (!sink_.start_pull(*this)) {
+        roc_log(LogError, "pump: sink doesn't support pull mode");
+        return false;
+    }
+
+    roc_log(LogDebug, "pump: starting pull loop");
+
+    const core::nanoseconds_t poll_interval =
+        sample_spec_.samples_overall_2_ns(frame_buffer_.size());
+
+    while (!stop_) {
+        core::sleep_for(core::ClockMonotonic, poll_interval);
+
+        if (pull_eof_) {
+            roc_log(LogDebug, "pump: got eof from source");
+            break;
+        }
+
+        if (oneshot_ && pull_started_ && main_source_.state() != DeviceState_Active) {
+            roc_log(LogInfo, "pump: main source become inactive in oneshot mode");
+            break;
+        }
+
+        if (sink_.state() == DeviceState_Paused) {
+            roc_log(LogInfo, "pump: restarting sink");
+
+            if (!sink_.restart()) {
+                roc_log(LogError, "pump: can't restart sink");
+            }
+        }
+    }
+
+    // after this call, read() is not invoked anymore
+    sink_.stop_pull();
+
+    roc_log(LogDebug, "pump: exiting pull loop, wrote %lu buffers from main source",
+            (unsigned long)n_bufs_);
+
+    return !stop_;
+}
+
+bool Pump::read(audio::Frame& frame) {
+    // invoked from sink's callback in pull mode
+    if (pull_eof_) {
+        return false;
+    }
+
+    if (!main_source_.read(frame)) {
+        pull_eof_ = 1;
+        return false;
+    }
+
+    prepare_frame_(main_source_, frame);
+
+    roc_probe(pump_frame, (unsigned long)n_bufs_, (uint32_t)frame.duration(),
+              (unsigned)frame.flags(), (int64_t)frame.capture_timestamp());
+
+    {
+        // tell source what is playback time of first sample of just read frame
+        // unlike in run(), frame is not yet written to playback buffer, so we
+        // don't subtract its size from sink latency
+        core::nanoseconds_t playback_latency = 0;
+
+        if (sink_.has_latency()) {
+            playback_latency = sink_.latency();
+        }
+
+        main_source_.reclock(core::timestamp(core::ClockMedia) + playback_latency);
+    }
+
+    n_bufs_++;
+    pull_started_ = 1;
+
+    return true;
+}
+
+void Pump::prepare_frame_(ISource& current_source, audio::Frame& frame) {
+    if (!frame.has_duration()) {
+        // if source does not provide frame duration, we fill it here
+        // we assume that the frame has some PCM format
+        frame.set_duration(sample_spec_.bytes_2_stream_timestamp(frame.num_bytes()));
+    }
+
+    if (frame.capture_timestamp() == 0) {
+        // if source does not provide capture timestamps, we fill them here
+        // we subtract source latency to take into account recording buffer size,
+        // where this frame spent some time before we read it
+        // we subtract frame size because we already read the whole frame from
+        // recording buffer, and should take it into account too
+        core::nanoseconds_t capture_latency = 0;
+
+        if (current_source.has_latency()) {
+            capture_latency = current_source.latency()
+                + sample_spec_.stream_timestamp_2_ns(frame.duration());
+        }
+
+        frame.set_capture_timestamp(core::timestamp(core::ClockMedia) - capture_latency);
+    }
+}
+
 void Pump::stop() {
     stop_ = 1;
 }
@@ -13,10 +13,12 @@
 #define ROC_SNDIO_PUMP_H_
 
 #include "roc_audio/frame_factory.h"
+#include "roc_audio/iframe_reader.h"
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_core/atomic.h"
 #include "roc_core/attributes.h"
+#include "roc_core/iarena.h"
 #include "roc_core/ipool.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
@@ -31,7 +33,7 @@ namespace sndio {
 //! Audio pump.
 //! @remarks
 //!  Reads frames from source and writes them to sink.
-class Pump : public core::NonCopyable<> {
+class Pump : private audio::IFrameReader, public core::NonCopyable<> {
 public:
     //! Pump mode.
     enum Mode {
@@ -51,22 +53,54 @@ public:
          const audio::SampleSpec& sample_spec,
          Mode mode);
 
+    //! Deinitialize.
+    ~Pump();
+
     //! Check if the object was successfulyl constructed.
     bool is_valid() const;
 
+    //! Enable batch mode.
+    //! @remarks
+    //!  Instead of writing every frame to sink, run() accumulates frames read
+    //!  from source and writes them to sink in one block of @p batch_length.
+    //!  This reduces per-write overhead of sinks without own clock, like files.
+    //!  Pump doesn't add any pacing, so if source is not timed either, frames
+    //!  are transferred at full speed.
+    //!  Sinks with own clock are not affected, to keep device timing.
+    //!  Should be called before run().
+    ROC_ATTR_NODISCARD bool enable_batching(core::IArena& arena,
+                                            core::nanoseconds_t batch_length);
+
     //! Run the pump.
     //! @remarks
     //!  Run until the stop() is called or, if oneshot mode is enabled,
     //!  the source becomes inactive.
     ROC_ATTR_NODISCARD bool run();
 
+    //! Run the pump in pull mode.
+    //! @remarks
+    //!  Instead of reading frames from source and writing them to sink in
+    //!  the current thread, asks sink to pull frames from source by itself,
+    //!  from the sink's own callback (see ISink::start_pull()). This removes
+    //!  one buffer and one thread handoff between source and sink.
+    //!  Current thread only monitors source and sink state until the stop()
+    //!  is called or, if oneshot mode is enabled, the source becomes inactive.
+    //!  Backup source is not supported in this mode.
+    //! @returns
+    //!  false if the sink doesn't support pull mode or an error occurred.
+    ROC_ATTR_NODISCARD bool run_pull();
+
     //! Stop the pump.
     //! @remarks
     //!  May be called from any thread.
     void stop();
 
 private:
+    virtual bool read(audio::Frame& frame);
+
     bool transfer_frame_(ISource& current_source);
+    bool transfer_batch_(ISource& current_source);
+    void prepare_frame_(ISource& current_source, audio::Frame& frame);
 
     audio::FrameFactory frame_factory_;
 
@@ -78,9 +112,16 @@ private:
 
     core::Slice<audio::sample_t> frame_buffer_;
 
+    core::IArena* batch_arena_;
+    audio::sample_t* batch_buffer_;
+    size_t batch_size_;
+
     size_t n_bufs_;
     const bool oneshot_;
 
+    core::Atomic<int> pull_started_;
+    core::Atomic<int> pull_eof_;
+
     core::Atomic<int> stop_;
 };
 
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_sndio/sample_ring.h"
+#include "roc_core/align_ops.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+SampleRing::SampleRing(core::IArena& arena, size_t block_size, size_t n_blocks)
+    : block_size_(block_size)
+    , buffer_(arena, chunk_size_(block_size), n_blocks)
+    , free_sem_((unsigned)n_blocks)
+    , filled_sem_(0)
+    , closed_(0)
+    , write_block_(NULL)
+    , write_pos_(0)
+    , read_block_(NULL)
+    , read_block_size_(0)
+    , read_pos_(0)
+    , read_eos_(false) {
+    roc_panic_if_msg(block_size == 0 || n_blocks == 0,
+                     "sample ring: block size and count should be non-zero");
+}
+
+bool SampleRing::is_valid() const {
+    return buffer_.is_valid();
+}
+
+size_t SampleRing::block_size() const {
+    return block_size_;
+}
+
+void SampleRing::close() {
+    closed_ = 1;
+
+    free_sem_.post();
+    filled_sem_.post();
+}
+
+audio::sample_t* SampleRing::begin_write() {
+    roc_panic_if(!is_valid());
+
+    free_sem_.wait();
+
+    if (closed_) {
+        // pass wakeup to next call
+        free_sem_.post();
+        return NULL;
+    }
+
+    uint8_t* chunk = buffer_.begin_write();
+    if (!chunk) {
+        roc_panic("sample ring: free semaphore is out of sync with buffer");
+    }
+
+    return (audio::sample_t*)(chunk + header_size_());
+}
+
+audio::sample_t* SampleRing::try_begin_write() {
+    roc_panic_if(!is_valid());
+
+    // zero deadline is always in past, so this doesn't block
+    if (!free_sem_.timed_wait(0)) {
+        return NULL;
+    }
+
+    if (closed_) {
+        free_sem_.post();
+        return NULL;
+    }
+
+    uint8_t* chunk = buffer_.begin_write();
+    if (!chunk) {
+        roc_panic("sample ring: free semaphore is out of sync with buffer");
+    }
+
+    return (audio::sample_t*)(chunk + header_size_());
+}
+
+void SampleRing::end_write(size_t n_samples) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(n_samples > block_size_);
+
+    uint8_t* chunk = buffer_.begin_write();
+    roc_panic_if(!chunk);
+
+    ((BlockHeader*)chunk)->n_samples = n_samples;
+
+    buffer_.end_write();
+    filled_sem_.post();
+}
+
+bool SampleRing::write(const audio::sample_t* data, size_t size) {
+    while (size > 0) {
+        if (!write_block_) {
+            if (!(write_block_ = begin_write())) {
+                return false;
+            }
+            write_pos_ = 0;
+        }
+
+        const size_t n_samples = std::min(size, block_size_ - write_pos_);
+
+        memcpy(write_block_ + write_pos_, data, n_samples * sizeof(audio::sample_t));
+
+        write_pos_ += n_samples;
+        data += n_samples;
+        size -= n_samples;
+
+        if (write_pos_ == block_size_) {
+            end_write(write_pos_);
+            write_block_ = NULL;
+        }
+    }
+
+    return true;
+}
+
+void SampleRing::flush() {
+    if (!write_block_) {
+        return;
+    }
+
+    end_write(write_pos_);
+    write_block_ = NULL;
+}
+
+const audio::sample_t* SampleRing::begin_read(size_t& n_samples) {
+    roc_panic_if(!is_valid());
+
+    filled_sem_.wait();
+
+    if (closed_) {
+        filled_sem_.post();
+        return NULL;
+    }
+
+    uint8_t* chunk = buffer_.begin_read();
+    if (!chunk) {
+        roc_panic("sample ring: filled semaphore is out of sync with buffer");
+    }
+
+    n_samples = ((const BlockHeader*)chunk)->n_samples;
+
+    return (const audio::sample_t*)(chunk + header_size_());
+}
+
+void SampleRing::end_read() {
+    roc_panic_if(!is_valid());
+
+    buffer_.end_read();
+    free_sem_.post();
+}
+
+size_t SampleRing::read(audio::sample_t* data, size_t size) {
+    size_t n_read = 0;
+
+    while (n_read < size) {
+        if (!read_block_) {
+            if (read_eos_) {
+                break;
+            }
+            if (!(read_block_ = begin_read(read_block_size_))) {
+                break;
+            }
+            read_pos_ = 0;
+
+            if (read_block_size_ == 0) {
+                end_read();
+                read_block_ = NULL;
+                read_eos_ = true;
+                break;
+            }
+        }
+
+        const size_t n_samples = std::min(size - n_read, read_block_size_ - read_pos_);
+
+        memcpy(data + n_read, read_block_ + read_pos_,
+               n_samples * sizeof(audio::sample_t));
+
+        read_pos_ += n_samples;
+        n_read += n_samples;
+
+        if (read_pos_ == read_block_size_) {
+            end_read();
+            read_block_ = NULL;
+        }
+    }
+
+    return n_read;
+}
+
+size_t SampleRing::header_size_() {
+    return core::AlignOps::align_max(sizeof(BlockHeader));
+}
+
+size_t SampleRing::chunk_size_(size_t block_size) {
+    return core::AlignOps::align_max(header_size_()
+                                     + block_size * sizeof(audio::sample_t));
+}
+
+} // namespace sndio
+} // namespace roc
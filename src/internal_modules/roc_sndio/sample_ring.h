@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/sample_ring.h
+//! @brief Blocking ring of sample blocks.
+
+#ifndef ROC_SNDIO_SAMPLE_RING_H_
+#define ROC_SNDIO_SAMPLE_RING_H_
+
+#include "roc_audio/sample.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/spsc_byte_buffer.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace sndio {
+
+//! Blocking ring of sample blocks.
+//! @remarks
+//!  Moves samples between two threads, typically between pump thread and
+//!  I/O thread. Blocks are stored in lock-free SPSC buffer; writer blocks
+//!  on semaphore only when all blocks are filled, and reader blocks only
+//!  when all blocks are free.
+//!
+//!  Block with zero samples marks end of stream.
+//!
+//!  Writer may fill blocks in place (begin_write() and end_write()) or copy
+//!  samples in arbitrary portions (write() and flush()). Same for reader.
+class SampleRing : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @p block_size defines maximum number of samples in block.
+    SampleRing(core::IArena& arena, size_t block_size, size_t n_blocks);
+
+    //! Check if ring was successfully constructed.
+    bool is_valid() const;
+
+    //! Get maximum number of samples in block.
+    size_t block_size() const;
+
+    //! Close ring.
+    //! @remarks
+    //!  Wakes up blocked reader and writer. All subsequent calls fail.
+    //!  Can be called from any thread.
+    void close();
+
+    //! Get next free block.
+    //! @remarks
+    //!  Blocks until there is a free block.
+    //!  Returns NULL if ring is closed.
+    audio::sample_t* begin_write();
+
+    //! Get next free block without blocking.
+    //! @remarks
+    //!  Returns NULL if there are no free blocks or ring is closed.
+    //!  Returned block should be committed using end_write().
+    audio::sample_t* try_begin_write();
+
+    //! Commit block obtained from begin_write().
+    //! @remarks
+    //!  Zero @p n_samples marks end of stream.
+    void end_write(size_t n_samples);
+
+    //! Copy samples to ring.
+    //! @remarks
+    //!  Blocks are committed when they become full.
+    //!  Returns false if ring is closed.
+    bool write(const audio::sample_t* data, size_t size);
+
+    //! Commit partially filled block, if any.
+    void flush();
+
+    //! Get next filled block.
+    //! @remarks
+    //!  Blocks until there is a filled block.
+    //!  Returns NULL if ring is closed.
+    const audio::sample_t* begin_read(size_t& n_samples);
+
+    //! Release block obtained from begin_read().
+    void end_read();
+
+    //! Copy samples from ring.
+    //! @remarks
+    //!  Returns less than @p size if reached end of stream or ring is closed.
+    size_t read(audio::sample_t* data, size_t size);
+
+private:
+    struct BlockHeader {
+        size_t n_samples;
+    };
+
+    static size_t header_size_();
+    static size_t chunk_size_(size_t block_size);
+
+    const size_t block_size_;
+
+    core::SpscByteBuffer buffer_;
+
+    core::Semaphore free_sem_;
+    core::Semaphore filled_sem_;
+    core::Atomic<int> closed_;
+
+    audio::sample_t* write_block_;
+    size_t write_pos_;
+
+    const audio::sample_t* read_block_;
+    size_t read_block_size_;
+    size_t read_pos_;
+    bool read_eos_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_SAMPLE_RING_H_
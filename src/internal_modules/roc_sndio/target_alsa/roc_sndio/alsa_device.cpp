@@ -0,0 +1,629 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "roc_sndio/alsa_device.h"
+#include "roc_audio/channel_defs.h"
+#include "roc_audio/pcm_format.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_format.h"
+#include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+const core::nanoseconds_t ReportInterval = 10 * core::Second;
+
+// same default as for pulseaudio; ring buffer size is set to this value,
+// so it defines how much audio is queued in the device
+const core::nanoseconds_t DefaultLatency = core::Millisecond * 60;
+
+const core::nanoseconds_t MinTimeout = core::Millisecond * 50;
+const core::nanoseconds_t MaxTimeout = core::Second * 2;
+
+const unsigned int DefaultRate = 48000;
+const unsigned int DefaultChannels = 2;
+
+// ring buffer should hold at least this number of periods,
+// otherwise device may underrun while we're filling next period
+const snd_pcm_uframes_t MinPeriods = 2;
+
+struct FormatMapping {
+    snd_pcm_format_t alsa_format;
+    audio::PcmFormat pcm_format;
+};
+
+// device formats, in order of preference
+const FormatMapping format_mappings[] = {
+    { SND_PCM_FORMAT_FLOAT_LE, audio::PcmFormat_Float32_Le },
+    { SND_PCM_FORMAT_S32_LE, audio::PcmFormat_SInt32_Le },
+    { SND_PCM_FORMAT_S16_LE, audio::PcmFormat_SInt16_Le },
+};
+
+} // namespace
+
+AlsaDevice::AlsaDevice(const Config& config, DeviceType device_type)
+    : device_type_(device_type)
+    , device_(NULL)
+    , sample_spec_(config.sample_spec)
+    , frame_len_ns_(config.frame_length)
+    , target_latency_ns_(config.latency)
+    , timeout_ms_(0)
+    , pcm_(NULL)
+    , pcm_format_(SND_PCM_FORMAT_UNKNOWN)
+    , period_size_(0)
+    , buffer_size_(0)
+    , frame_bytes_(0)
+    , paused_(false)
+    , failed_(false)
+    , rate_limiter_(ReportInterval) {
+    if (frame_len_ns_ == 0) {
+        frame_len_ns_ = DefaultFrameLength;
+    }
+    if (target_latency_ns_ == 0) {
+        target_latency_ns_ = DefaultLatency;
+    }
+    core::nanoseconds_t timeout_ns = target_latency_ns_ * 2;
+    if (timeout_ns < MinTimeout) {
+        timeout_ns = MinTimeout;
+    }
+    if (timeout_ns > MaxTimeout) {
+        timeout_ns = MaxTimeout;
+    }
+    timeout_ms_ = (int)(timeout_ns / core::Millisecond);
+}
+
+AlsaDevice::~AlsaDevice() {
+    roc_log(LogDebug, "alsa %s: closing device", device_type_to_str(device_type_));
+
+    close_pcm_();
+}
+
+bool AlsaDevice::open(const char* device) {
+    roc_log(LogDebug, "alsa %s: opening device: device=%s",
+            device_type_to_str(device_type_), device);
+
+    if (device_) {
+        roc_panic("alsa %s: can't call open() more than once",
+                  device_type_to_str(device_type_));
+    }
+
+    device_ = device ? device : "default";
+
+    if (!open_pcm_()) {
+        close_pcm_();
+        return false;
+    }
+
+    return true;
+}
+
+ISink* AlsaDevice::to_sink() {
+    return device_type_ == DeviceType_Sink ? this : NULL;
+}
+
+ISource* AlsaDevice::to_source() {
+    return device_type_ == DeviceType_Source ? this : NULL;
+}
+
+DeviceType AlsaDevice::type() const {
+    return device_type_;
+}
+
+DeviceState AlsaDevice::state() const {
+    return pcm_ && !paused_ && !failed_ ? DeviceState_Active : DeviceState_Paused;
+}
+
+void AlsaDevice::pause() {
+    if (!pcm_ || paused_) {
+        return;
+    }
+
+    roc_log(LogDebug, "alsa %s: pausing device", device_type_to_str(device_type_));
+
+    const int err = snd_pcm_drop(pcm_);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't stop device: err=%s",
+                device_type_to_str(device_type_), snd_strerror(err));
+    }
+
+    paused_ = true;
+}
+
+bool AlsaDevice::resume() {
+    if (!pcm_ || failed_) {
+        return restart();
+    }
+
+    if (!paused_) {
+        return true;
+    }
+
+    roc_log(LogDebug, "alsa %s: resuming device", device_type_to_str(device_type_));
+
+    int err = snd_pcm_prepare(pcm_);
+    if (err == 0 && device_type_ == DeviceType_Source) {
+        err = snd_pcm_start(pcm_);
+    }
+
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't resume device: err=%s",
+                device_type_to_str(device_type_), snd_strerror(err));
+        return restart();
+    }
+
+    paused_ = false;
+
+    return true;
+}
+
+bool AlsaDevice::restart() {
+    roc_log(LogDebug, "alsa %s: restarting device", device_type_to_str(device_type_));
+
+    close_pcm_();
+
+    if (!open_pcm_()) {
+        roc_log(LogError, "alsa %s: can't restart device",
+                device_type_to_str(device_type_));
+        close_pcm_();
+        return false;
+    }
+
+    return true;
+}
+
+audio::SampleSpec AlsaDevice::sample_spec() const {
+    return sample_spec_;
+}
+
+core::nanoseconds_t AlsaDevice::latency() const {
+    if (!pcm_ || paused_ || failed_) {
+        return 0;
+    }
+
+    snd_pcm_sframes_t delay = 0;
+
+    const int err = snd_pcm_delay(pcm_, &delay);
+    if (err < 0 || delay < 0) {
+        return 0;
+    }
+
+    return sample_spec_.samples_per_chan_2_ns((size_t)delay);
+}
+
+bool AlsaDevice::has_latency() const {
+    return true;
+}
+
+bool AlsaDevice::has_clock() const {
+    return true;
+}
+
+void AlsaDevice::reclock(core::nanoseconds_t timestamp) {
+    // no-op
+}
+
+void AlsaDevice::write(audio::Frame& frame) {
+    roc_panic_if(device_type_ != DeviceType_Sink);
+
+    if (!pcm_ || paused_ || failed_) {
+        return;
+    }
+
+    transfer_(frame.raw_samples(), frame.num_raw_samples() / sample_spec_.num_channels());
+}
+
+bool AlsaDevice::read(audio::Frame& frame) {
+    roc_panic_if(device_type_ != DeviceType_Source);
+
+    if (!pcm_ || paused_ || failed_) {
+        return false;
+    }
+
+    return transfer_(frame.raw_samples(),
+                     frame.num_raw_samples() / sample_spec_.num_channels());
+}
+
+bool AlsaDevice::open_pcm_() {
+    roc_panic_if(pcm_);
+
+    const snd_pcm_stream_t stream = device_type_ == DeviceType_Sink
+        ? SND_PCM_STREAM_PLAYBACK
+        : SND_PCM_STREAM_CAPTURE;
+
+    int err = snd_pcm_open(&pcm_, device_, stream, 0);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't open device: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        pcm_ = NULL;
+        return false;
+    }
+
+    if (!set_hw_params_() || !set_sw_params_()) {
+        return false;
+    }
+
+    err = snd_pcm_prepare(pcm_);
+    if (err == 0 && device_type_ == DeviceType_Source) {
+        // capture isn't started automatically in mmap mode
+        err = snd_pcm_start(pcm_);
+    }
+
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't start device: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    paused_ = false;
+    failed_ = false;
+
+    roc_log(LogInfo,
+            "alsa %s: opened device: device=%s format=%s period=%lu buffer=%lu"
+            " sample_spec=%s",
+            device_type_to_str(device_type_), device_, snd_pcm_format_name(pcm_format_),
+            (unsigned long)period_size_, (unsigned long)buffer_size_,
+            audio::sample_spec_to_str(sample_spec_).c_str());
+
+    return true;
+}
+
+void AlsaDevice::close_pcm_() {
+    if (!pcm_) {
+        return;
+    }
+
+    roc_log(LogDebug, "alsa %s: closing pcm", device_type_to_str(device_type_));
+
+    if (!paused_ && !failed_ && device_type_ == DeviceType_Sink) {
+        snd_pcm_drop(pcm_);
+    }
+
+    snd_pcm_close(pcm_);
+    pcm_ = NULL;
+}
+
+bool AlsaDevice::set_hw_params_() {
+    snd_pcm_hw_params_t* hw_params = NULL;
+    snd_pcm_hw_params_alloca(&hw_params);
+
+    int err = snd_pcm_hw_params_any(pcm_, hw_params);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't get device params: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    // frames are copied directly to and from the ring buffer, so we need mmap
+    err = snd_pcm_hw_params_set_access(pcm_, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    if (err < 0) {
+        roc_log(LogError,
+                "alsa %s: device doesn't support mmap access: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    audio::PcmFormat pcm_format = audio::PcmFormat_Invalid;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(format_mappings); n++) {
+        if (snd_pcm_hw_params_test_format(pcm_, hw_params,
+                                          format_mappings[n].alsa_format)
+            == 0) {
+            pcm_format_ = format_mappings[n].alsa_format;
+            pcm_format = format_mappings[n].pcm_format;
+            break;
+        }
+    }
+
+    if (pcm_format == audio::PcmFormat_Invalid) {
+        roc_log(LogError, "alsa %s: device doesn't support any known format: device=%s",
+                device_type_to_str(device_type_), device_);
+        return false;
+    }
+
+    err = snd_pcm_hw_params_set_format(pcm_, hw_params, pcm_format_);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set format: device=%s format=%s err=%s",
+                device_type_to_str(device_type_), device_,
+                snd_pcm_format_name(pcm_format_), snd_strerror(err));
+        return false;
+    }
+
+    if (!init_sample_spec_()) {
+        return false;
+    }
+
+    unsigned int n_channels = sample_spec_.channel_set().is_valid()
+        ? (unsigned int)sample_spec_.num_channels()
+        : DefaultChannels;
+
+    err = snd_pcm_hw_params_set_channels_near(pcm_, hw_params, &n_channels);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set channels: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    if (sample_spec_.channel_set().is_valid()
+        && n_channels != sample_spec_.num_channels()) {
+        roc_log(LogError,
+                "alsa %s: device doesn't support requested channel count:"
+                " device=%s requested=%lu supported=%u",
+                device_type_to_str(device_type_), device_,
+                (unsigned long)sample_spec_.num_channels(), n_channels);
+        return false;
+    }
+
+    unsigned int rate = sample_spec_.sample_rate() != 0
+        ? (unsigned int)sample_spec_.sample_rate()
+        : DefaultRate;
+    int dir = 0;
+
+    err = snd_pcm_hw_params_set_rate_near(pcm_, hw_params, &rate, &dir);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set rate: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    if (sample_spec_.sample_rate() != 0 && rate != sample_spec_.sample_rate()) {
+        roc_log(LogError,
+                "alsa %s: device doesn't support requested rate:"
+                " device=%s requested=%lu supported=%u",
+                device_type_to_str(device_type_), device_,
+                (unsigned long)sample_spec_.sample_rate(), rate);
+        return false;
+    }
+
+    if (!sample_spec_.channel_set().is_valid()) {
+        sample_spec_.channel_set().set_layout(audio::ChanLayout_Surround);
+        sample_spec_.channel_set().set_order(audio::ChanOrder_Smpte);
+        sample_spec_.channel_set().set_count(n_channels);
+    }
+    sample_spec_.set_sample_rate(rate);
+
+    // one period is one frame, so that device wakes us up once per frame
+    snd_pcm_uframes_t period_size = sample_spec_.ns_2_samples_per_chan(frame_len_ns_);
+    if (period_size == 0) {
+        roc_log(LogError, "alsa %s: frame size must be > 0: frame_len=%.3fms",
+                device_type_to_str(device_type_),
+                (double)frame_len_ns_ / core::Millisecond);
+        return false;
+    }
+
+    dir = 0;
+    err = snd_pcm_hw_params_set_period_size_near(pcm_, hw_params, &period_size, &dir);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set period size: device=%s size=%lu err=%s",
+                device_type_to_str(device_type_), device_, (unsigned long)period_size,
+                snd_strerror(err));
+        return false;
+    }
+
+    // ring buffer holds target latency
+    snd_pcm_uframes_t buffer_size =
+        sample_spec_.ns_2_samples_per_chan(target_latency_ns_);
+    if (buffer_size < period_size * MinPeriods) {
+        buffer_size = period_size * MinPeriods;
+    }
+
+    err = snd_pcm_hw_params_set_buffer_size_near(pcm_, hw_params, &buffer_size);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set buffer size: device=%s size=%lu err=%s",
+                device_type_to_str(device_type_), device_, (unsigned long)buffer_size,
+                snd_strerror(err));
+        return false;
+    }
+
+    err = snd_pcm_hw_params(pcm_, hw_params);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't apply device params: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    dir = 0;
+    if ((err = snd_pcm_hw_params_get_period_size(hw_params, &period_size_, &dir)) < 0
+        || (err = snd_pcm_hw_params_get_buffer_size(hw_params, &buffer_size_)) < 0) {
+        roc_log(LogError, "alsa %s: can't get buffer params: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    frame_bytes_ = (size_t)snd_pcm_frames_to_bytes(pcm_, 1);
+
+    if (device_type_ == DeviceType_Sink) {
+        mapper_.reset(new (mapper_)
+                          audio::PcmMapper(audio::Sample_RawFormat, pcm_format));
+    } else {
+        mapper_.reset(new (mapper_)
+                          audio::PcmMapper(pcm_format, audio::Sample_RawFormat));
+    }
+
+    return true;
+}
+
+bool AlsaDevice::set_sw_params_() {
+    snd_pcm_sw_params_t* sw_params = NULL;
+    snd_pcm_sw_params_alloca(&sw_params);
+
+    int err = snd_pcm_sw_params_current(pcm_, sw_params);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't get software params: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    // playback starts when ring buffer is filled up to target latency
+    err = snd_pcm_sw_params_set_start_threshold(
+        pcm_, sw_params, device_type_ == DeviceType_Sink ? buffer_size_ : 1);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set start threshold: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    // wake up when at least one period can be transferred
+    err = snd_pcm_sw_params_set_avail_min(pcm_, sw_params, period_size_);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't set avail min: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    err = snd_pcm_sw_params(pcm_, sw_params);
+    if (err < 0) {
+        roc_log(LogError, "alsa %s: can't apply software params: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(err));
+        return false;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::init_sample_spec_() {
+    if (sample_spec_.sample_format() == audio::SampleFormat_Invalid) {
+        sample_spec_.set_sample_format(audio::SampleFormat_Pcm);
+        sample_spec_.set_pcm_format(audio::Sample_RawFormat);
+    }
+
+    if (!sample_spec_.is_raw()) {
+        roc_log(LogError,
+                "alsa %s: sample format can be only \"-\" or \"%s\": sample_spec=%s",
+                device_type_to_str(device_type_),
+                audio::pcm_format_to_str(audio::Sample_RawFormat),
+                audio::sample_spec_to_str(sample_spec_).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::transfer_(audio::sample_t* data, size_t n_frames) {
+    const size_t n_chans = sample_spec_.num_channels();
+
+    while (n_frames != 0) {
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_);
+        if (avail < 0) {
+            if (!recover_((int)avail)) {
+                return false;
+            }
+            continue;
+        }
+
+        // wait until at least one period (or the rest of frame) can be transferred
+        const snd_pcm_uframes_t min_avail =
+            ROC_MIN((snd_pcm_uframes_t)n_frames, period_size_);
+
+        if ((snd_pcm_uframes_t)avail < min_avail) {
+            if (!wait_()) {
+                return false;
+            }
+            continue;
+        }
+
+        const snd_pcm_channel_area_t* areas = NULL;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t n_mapped = (snd_pcm_uframes_t)n_frames;
+
+        const int err = snd_pcm_mmap_begin(pcm_, &areas, &offset, &n_mapped);
+        if (err < 0) {
+            if (!recover_(err)) {
+                return false;
+            }
+            continue;
+        }
+
+        // with interleaved access, all channels share same area
+        uint8_t* ring_data =
+            (uint8_t*)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        const size_t ring_size = n_mapped * frame_bytes_;
+
+        const size_t n_samples = n_mapped * n_chans;
+        size_t frame_off = 0;
+        size_t ring_off = 0;
+
+        if (device_type_ == DeviceType_Sink) {
+            mapper_->map(data, n_samples * sizeof(audio::sample_t), frame_off, ring_data,
+                         ring_size, ring_off, n_samples);
+        } else {
+            mapper_->map(ring_data, ring_size, ring_off, data,
+                         n_samples * sizeof(audio::sample_t), frame_off, n_samples);
+        }
+
+        const snd_pcm_sframes_t n_committed = snd_pcm_mmap_commit(pcm_, offset, n_mapped);
+        if (n_committed < 0 || (snd_pcm_uframes_t)n_committed != n_mapped) {
+            if (!recover_(n_committed < 0 ? (int)n_committed : -EPIPE)) {
+                return false;
+            }
+            continue;
+        }
+
+        data += n_samples;
+        n_frames -= n_mapped;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::wait_() {
+    if (device_type_ == DeviceType_Sink
+        && snd_pcm_state(pcm_) == SND_PCM_STATE_PREPARED) {
+        // ring buffer is full, but playback wasn't started automatically,
+        // which may happen with some plugins in mmap mode
+        const int err = snd_pcm_start(pcm_);
+        if (err < 0) {
+            return recover_(err);
+        }
+    }
+
+    const int ret = snd_pcm_wait(pcm_, timeout_ms_);
+    if (ret < 0) {
+        return recover_(ret);
+    }
+
+    if (ret == 0) {
+        roc_log(LogError, "alsa %s: device timeout: device=%s timeout=%dms",
+                device_type_to_str(device_type_), device_, timeout_ms_);
+        failed_ = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool AlsaDevice::recover_(int err) {
+    if (err == -EPIPE && rate_limiter_.allow()) {
+        roc_log(LogInfo, "alsa %s: got %s, recovering", device_type_to_str(device_type_),
+                device_type_ == DeviceType_Sink ? "underrun" : "overrun");
+    }
+
+    int ret = snd_pcm_recover(pcm_, err, 1);
+    if (ret == 0 && device_type_ == DeviceType_Source
+        && snd_pcm_state(pcm_) == SND_PCM_STATE_PREPARED) {
+        ret = snd_pcm_start(pcm_);
+    }
+
+    if (ret < 0) {
+        roc_log(LogError, "alsa %s: can't recover device: device=%s err=%s",
+                device_type_to_str(device_type_), device_, snd_strerror(ret));
+        failed_ = true;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace sndio
+} // namespace roc
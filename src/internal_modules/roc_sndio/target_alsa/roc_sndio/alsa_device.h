@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_sndio/target_alsa/roc_sndio/alsa_device.h
+//! @brief ALSA device.
+
+#ifndef ROC_SNDIO_ALSA_DEVICE_H_
+#define ROC_SNDIO_ALSA_DEVICE_H_
+
+#include <alsa/asoundlib.h>
+
+#include "roc_audio/frame.h"
+#include "roc_audio/pcm_mapper.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_sndio/config.h"
+#include "roc_sndio/isink.h"
+#include "roc_sndio/isource.h"
+
+namespace roc {
+namespace sndio {
+
+//! ALSA device.
+//! Can be either source or sink depending on constructor parameter.
+//! @remarks
+//!  Uses mmap access: samples are converted from frame format directly to
+//!  the device ring buffer obtained from snd_pcm_mmap_begin() (or vice versa
+//!  for source), without intermediate copies. Period size is set to frame
+//!  length, and ring buffer size is set to target latency.
+class AlsaDevice : public ISink, public ISource, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    AlsaDevice(const Config& config, DeviceType device_type);
+    ~AlsaDevice();
+
+    //! Open device.
+    bool open(const char* device);
+
+    //! Cast IDevice to ISink.
+    virtual ISink* to_sink();
+
+    //! Cast IDevice to ISink.
+    virtual ISource* to_source();
+
+    //! Get device type.
+    virtual DeviceType type() const;
+
+    //! Get device state.
+    virtual DeviceState state() const;
+
+    //! Pause reading.
+    virtual void pause();
+
+    //! Resume paused reading.
+    virtual bool resume();
+
+    //! Restart reading from the beginning.
+    virtual bool restart();
+
+    //! Get sample specification of the device.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of the device.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if the device supports latency reports.
+    virtual bool has_latency() const;
+
+    //! Check if the device has own clock.
+    virtual bool has_clock() const;
+
+    //! Adjust source clock to match consumer clock.
+    virtual void reclock(core::nanoseconds_t timestamp);
+
+    //! Write audio frame.
+    virtual void write(audio::Frame& frame);
+
+    //! Read audio frame.
+    virtual bool read(audio::Frame& frame);
+
+private:
+    bool open_pcm_();
+    void close_pcm_();
+
+    bool set_hw_params_();
+    bool set_sw_params_();
+    bool init_sample_spec_();
+
+    bool transfer_(audio::sample_t* data, size_t n_frames);
+    bool wait_();
+    bool recover_(int err);
+
+    const DeviceType device_type_;
+    const char* device_;
+
+    audio::SampleSpec sample_spec_;
+
+    core::nanoseconds_t frame_len_ns_;
+    core::nanoseconds_t target_latency_ns_;
+    int timeout_ms_;
+
+    snd_pcm_t* pcm_;
+    snd_pcm_format_t pcm_format_;
+
+    snd_pcm_uframes_t period_size_;
+    snd_pcm_uframes_t buffer_size_;
+
+    core::Optional<audio::PcmMapper> mapper_;
+    size_t frame_bytes_;
+
+    bool paused_;
+    bool failed_;
+
+    core::RateLimiter rate_limiter_;
+};
+
+} // namespace sndio
+} // namespace roc
+
+#endif // ROC_SNDIO_ALSA_DEVICE_H_
@@ -44,7 +44,7 @@ IDevice* PulseaudioBackend::open_device(DeviceType device_type,
     }
 
     core::ScopedPtr<PulseaudioDevice> device(
-        new (arena) PulseaudioDevice(config, device_type), arena);
+        new (arena) PulseaudioDevice(arena, config, device_type), arena);
 
     if (!device) {
         roc_log(LogDebug, "pulseaudio backend: can't construct device: path=%s", path);
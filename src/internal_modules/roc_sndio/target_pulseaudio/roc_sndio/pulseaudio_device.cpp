@@ -11,6 +11,7 @@
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_format.h"
 #include "roc_audio/sample_spec_to_str.h"
+#include "roc_core/align_ops.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 
@@ -29,10 +30,20 @@ const core::nanoseconds_t DefaultLatency = core::Millisecond * 60;
 const core::nanoseconds_t MinTimeout = core::Millisecond * 50;
 const core::nanoseconds_t MaxTimeout = core::Second * 2;
 
+// Header of ring buffer chunk, followed by samples.
+struct RingChunkHeader {
+    size_t n_samples;
+};
+
+const size_t RingHeaderSize = core::AlignOps::align_max(sizeof(RingChunkHeader));
+
 } // namespace
 
-PulseaudioDevice::PulseaudioDevice(const Config& config, DeviceType device_type)
-    : device_type_(device_type)
+PulseaudioDevice::PulseaudioDevice(core::IArena& arena,
+                                   const Config& config,
+                                   DeviceType device_type)
+    : arena_(arena)
+    , device_type_(device_type)
     , device_(NULL)
     , sample_spec_(config.sample_spec)
     , frame_len_ns_(config.frame_length)
@@ -46,6 +57,16 @@ PulseaudioDevice::PulseaudioDevice(const Config& config, DeviceType device_type)
     , record_frag_flag_(false)
     , open_done_(false)
     , opened_(false)
+    , pull_reader_(NULL)
+    , pull_failed_(false)
+    , ring_len_ns_(config.ring_length)
+    , ring_chunk_samples_(0)
+    , ring_read_pos_(0)
+    , ring_samples_(0)
+    , ring_stream_latency_(-1)
+    , ring_writer_waiting_(0)
+    , ring_starved_(0)
+    , ring_failed_(0)
     , mainloop_(NULL)
     , context_(NULL)
     , device_info_op_(NULL)
@@ -96,6 +117,10 @@ bool PulseaudioDevice::open(const char* device) {
         return false;
     }
 
+    if (ring_len_ns_ > 0 && !init_ring_()) {
+        return false;
+    }
+
     return true;
 }
 
@@ -116,7 +141,8 @@ DeviceState PulseaudioDevice::state() const {
 
     pa_threaded_mainloop_lock(mainloop_);
 
-    const DeviceState state = opened_ ? DeviceState_Active : DeviceState_Paused;
+    const DeviceState state =
+        opened_ && !pull_failed_ ? DeviceState_Active : DeviceState_Paused;
 
     pa_threaded_mainloop_unlock(mainloop_);
 
@@ -168,7 +194,24 @@ audio::SampleSpec PulseaudioDevice::sample_spec() const {
 core::nanoseconds_t PulseaudioDevice::latency() const {
     want_mainloop_();
 
-    pa_threaded_mainloop_lock(mainloop_);
+    if (ring_) {
+        // in ring mode, stream latency is cached by write callback, so that
+        // pump thread doesn't need to lock mainloop on every frame
+        const int stream_latency = ring_stream_latency_;
+
+        return (stream_latency >= 0
+                    ? sample_spec_.samples_per_chan_2_ns((size_t)stream_latency)
+                    : target_latency_ns_)
+            + sample_spec_.samples_overall_2_ns((size_t)(int)ring_samples_);
+    }
+
+    // in pull mode, may be called from stream callback, which is invoked
+    // on mainloop thread with mainloop lock already acquired
+    const bool in_mainloop = pa_threaded_mainloop_in_thread(mainloop_);
+
+    if (!in_mainloop) {
+        pa_threaded_mainloop_lock(mainloop_);
+    }
 
     core::nanoseconds_t latency = 0;
 
@@ -178,7 +221,9 @@ core::nanoseconds_t PulseaudioDevice::latency() const {
         latency = target_latency_ns_;
     }
 
-    pa_threaded_mainloop_unlock(mainloop_);
+    if (!in_mainloop) {
+        pa_threaded_mainloop_unlock(mainloop_);
+    }
 
     return latency;
 }
@@ -198,9 +243,61 @@ void PulseaudioDevice::reclock(core::nanoseconds_t timestamp) {
 void PulseaudioDevice::write(audio::Frame& frame) {
     roc_panic_if(device_type_ != DeviceType_Sink);
 
+    if (pull_reader_) {
+        roc_panic("pulseaudio %s: unexpected write() call in pull mode",
+                  device_type_to_str(device_type_));
+    }
+
+    if (ring_) {
+        write_ring_(frame);
+        return;
+    }
+
     request_frame_(frame);
 }
 
+bool PulseaudioDevice::start_pull(audio::IFrameReader& reader) {
+    if (device_type_ != DeviceType_Sink) {
+        roc_log(LogError, "pulseaudio %s: pull mode is supported only for sink",
+                device_type_to_str(device_type_));
+        return false;
+    }
+
+    want_mainloop_();
+
+    pa_threaded_mainloop_lock(mainloop_);
+
+    roc_log(LogDebug, "pulseaudio %s: starting pull mode",
+            device_type_to_str(device_type_));
+
+    pull_reader_ = &reader;
+
+    if (opened_ && !pull_failed_) {
+        // stream may have already requested data before we started pulling,
+        // fill all available space right now
+        pull_stream_(pa_stream_writable_size(stream_));
+    }
+
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    return true;
+}
+
+void PulseaudioDevice::stop_pull() {
+    want_mainloop_();
+
+    pa_threaded_mainloop_lock(mainloop_);
+
+    if (pull_reader_) {
+        roc_log(LogDebug, "pulseaudio %s: stopping pull mode",
+                device_type_to_str(device_type_));
+    }
+
+    pull_reader_ = NULL;
+
+    pa_threaded_mainloop_unlock(mainloop_);
+}
+
 bool PulseaudioDevice::read(audio::Frame& frame) {
     roc_panic_if(device_type_ != DeviceType_Source);
 
@@ -234,23 +331,240 @@ bool PulseaudioDevice::request_frame_(audio::Frame& frame) {
         pa_threaded_mainloop_unlock(mainloop_);
 
         if (ret < 0) {
-            roc_log(LogInfo, "pulseaudio %s: restarting stream",
-                    device_type_to_str(device_type_));
+            restart_stream_();
+            return false;
+        }
+    }
+
+    return true;
+}
 
-            close_();
+void PulseaudioDevice::restart_stream_() {
+    roc_log(LogInfo, "pulseaudio %s: restarting stream",
+            device_type_to_str(device_type_));
 
-            if (!open_()) {
-                roc_log(LogError, "pulseaudio %s: can't restart stream",
-                        device_type_to_str(device_type_));
-            }
+    close_();
+
+    if (!open_()) {
+        roc_log(LogError, "pulseaudio %s: can't restart stream",
+                device_type_to_str(device_type_));
+    }
+}
+
+bool PulseaudioDevice::init_ring_() {
+    if (device_type_ != DeviceType_Sink) {
+        roc_log(LogError, "pulseaudio %s: ring buffer is supported only for sink",
+                device_type_to_str(device_type_));
+        return false;
+    }
 
+    pa_threaded_mainloop_lock(mainloop_);
+
+    // every chunk holds up to one frame of configured length
+    ring_chunk_samples_ = (size_t)frame_len_samples_ * sample_spec_.num_channels();
+
+    const size_t chunk_size = core::AlignOps::align_max(
+        RingHeaderSize + ring_chunk_samples_ * sizeof(audio::sample_t));
+
+    size_t n_chunks = (size_t)((ring_len_ns_ + frame_len_ns_ - 1) / frame_len_ns_);
+    if (n_chunks < 2) {
+        n_chunks = 2;
+    }
+
+    roc_log(LogDebug,
+            "pulseaudio %s: initializing ring buffer:"
+            " ring_len=%.3fms n_chunks=%lu chunk_samples=%lu",
+            device_type_to_str(device_type_), (double)ring_len_ns_ / core::Millisecond,
+            (unsigned long)n_chunks, (unsigned long)ring_chunk_samples_);
+
+    ring_.reset(new (ring_) core::SpscByteBuffer(arena_, chunk_size, n_chunks));
+
+    const bool ok = ring_->is_valid();
+
+    if (!ok) {
+        roc_log(LogError, "pulseaudio %s: can't allocate ring buffer",
+                device_type_to_str(device_type_));
+        ring_.reset();
+    } else {
+        // stream could already request data before ring was created,
+        // so first write should fill it explicitly
+        ring_starved_ = 1;
+    }
+
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    return ok;
+}
+
+// Invoked on pump thread.
+// Copies frame into ring buffer without locking mainloop.
+bool PulseaudioDevice::write_ring_(const audio::Frame& frame) {
+    const audio::sample_t* data = frame.raw_samples();
+    size_t size = frame.num_raw_samples();
+
+    while (size > 0) {
+        if (ring_failed_) {
+            restart_stream_();
             return false;
         }
+
+        uint8_t* chunk = ring_->begin_write();
+
+        if (!chunk) {
+            // write callback may be waiting for us instead of draining ring
+            kick_ring_();
+
+            if (!wait_ring_()) {
+                restart_stream_();
+                return false;
+            }
+            continue;
+        }
+
+        RingChunkHeader& header = *(RingChunkHeader*)chunk;
+        header.n_samples = std::min(size, ring_chunk_samples_);
+
+        memcpy(chunk + RingHeaderSize, data, header.n_samples * sizeof(audio::sample_t));
+
+        ring_samples_ += (int)header.n_samples;
+        data += header.n_samples;
+        size -= header.n_samples;
+
+        ring_->end_write();
+    }
+
+    kick_ring_();
+
+    return true;
+}
+
+// Invoked on pump thread when ring is full.
+// Blocks until write callback releases a chunk.
+bool PulseaudioDevice::wait_ring_() {
+    ring_writer_waiting_ = 1;
+
+    // callback could release chunk before it saw the flag
+    if (ring_->begin_write() || ring_failed_) {
+        ring_writer_waiting_ = 0;
+        return true;
+    }
+
+    if (!ring_sem_.timed_wait(core::timestamp(core::ClockMonotonic) + timeout_ns_)) {
+        ring_writer_waiting_ = 0;
+
+        roc_log(LogInfo,
+                "pulseaudio %s: ring buffer timeout expired:"
+                " latency=%ld(%.3fms) timeout=%ld(%.3fms)",
+                device_type_to_str(device_type_), (long)target_latency_samples_,
+                (double)target_latency_ns_ / core::Millisecond, (long)timeout_samples_,
+                (double)timeout_ns_ / core::Millisecond);
+        return false;
     }
 
     return true;
 }
 
+// Invoked on pump thread.
+// If write callback found ring empty, PulseAudio won't invoke it again
+// until we write something to stream, so we drain ring ourselves.
+// This happens only after underrun, so locking here is fine.
+void PulseaudioDevice::kick_ring_() {
+    if (!ring_starved_.exchange(0)) {
+        return;
+    }
+
+    pa_threaded_mainloop_lock(mainloop_);
+
+    if (opened_ && stream_) {
+        drain_ring_(pa_stream_writable_size(stream_));
+    }
+
+    pa_threaded_mainloop_unlock(mainloop_);
+}
+
+// Invoked on mainloop thread with mainloop lock acquired.
+// Moves samples from ring buffer to stream.
+void PulseaudioDevice::drain_ring_(size_t length) {
+    if (length == (size_t)-1) {
+        roc_log(LogError, "pulseaudio %s: stream is broken",
+                device_type_to_str(device_type_));
+        ring_failed_ = 1;
+        wake_ring_writer_();
+        return;
+    }
+
+    length /= sizeof(audio::sample_t);
+
+    while (length > 0) {
+        uint8_t* chunk = ring_->begin_read();
+
+        if (!chunk) {
+            ring_starved_ = 1;
+
+            // writer could add chunk after our check but before it saw the
+            // flag; in this case, whoever resets the flag drains the ring
+            if (!ring_->is_empty() && ring_starved_.exchange(0)) {
+                continue;
+            }
+            break;
+        }
+
+        const RingChunkHeader& header = *(const RingChunkHeader*)chunk;
+        const audio::sample_t* data =
+            (const audio::sample_t*)(chunk + RingHeaderSize) + ring_read_pos_;
+
+        const size_t size = std::min(header.n_samples - ring_read_pos_, length);
+
+        if (int err = pa_stream_write(stream_, data, size * sizeof(audio::sample_t), NULL,
+                                      0, PA_SEEK_RELATIVE)) {
+            roc_log(LogError, "pulseaudio %s: pa_stream_write(): %s",
+                    device_type_to_str(device_type_), pa_strerror(err));
+            ring_failed_ = 1;
+            wake_ring_writer_();
+            return;
+        }
+
+        ring_samples_ -= (int)size;
+        ring_read_pos_ += size;
+        length -= size;
+
+        if (ring_read_pos_ == header.n_samples) {
+            ring_read_pos_ = 0;
+            ring_->end_read();
+            wake_ring_writer_();
+        }
+    }
+
+    core::nanoseconds_t latency = 0;
+    if (get_latency_(latency)) {
+        ring_stream_latency_ =
+            (int)std::max(sample_spec_.ns_2_stream_timestamp_delta(latency),
+                          (packet::stream_timestamp_diff_t)0);
+    }
+
+    report_latency_();
+}
+
+void PulseaudioDevice::wake_ring_writer_() {
+    if (ring_writer_waiting_.exchange(0)) {
+        ring_sem_.post();
+    }
+}
+
+// Invoked with mainloop lock acquired when stream is closed.
+// Samples left in ring belong to old stream and are dropped.
+void PulseaudioDevice::drop_ring_() {
+    while (ring_->begin_read()) {
+        ring_->end_read();
+    }
+
+    ring_read_pos_ = 0;
+    ring_samples_ = 0;
+    ring_stream_latency_ = -1;
+    ring_starved_ = 0;
+    ring_failed_ = 0;
+}
+
 void PulseaudioDevice::want_mainloop_() const {
     if (!mainloop_) {
         roc_panic("pulseaudio %s: can't use unopened device",
@@ -318,8 +632,13 @@ void PulseaudioDevice::close_() {
         close_context_();
     }
 
+    if (ring_) {
+        drop_ring_();
+    }
+
     open_done_ = false;
     opened_ = false;
+    pull_failed_ = false;
 
     pa_threaded_mainloop_unlock(mainloop_);
 }
@@ -792,6 +1111,65 @@ ssize_t PulseaudioDevice::wait_stream_() {
     }
 }
 
+void PulseaudioDevice::pull_stream_(size_t length) {
+    roc_panic_if_not(pull_reader_);
+
+    if (length == (size_t)-1) {
+        roc_log(LogError, "pulseaudio %s: stream is broken",
+                device_type_to_str(device_type_));
+        pull_failed_ = true;
+        return;
+    }
+
+    const size_t sample_bytes = sample_spec_.num_channels() * sizeof(audio::sample_t);
+    const size_t max_chunk = (size_t)frame_len_samples_ * sample_bytes;
+
+    // stream buffer is filled in chunks of configured frame length, so that
+    // pipeline processes frames of the same size as in push mode
+    length -= length % sample_bytes;
+
+    while (length > 0) {
+        void* data = NULL;
+        size_t chunk = std::min(length, max_chunk);
+
+        // get buffer from stream memory pool; samples are rendered directly
+        // into it, without intermediate copying
+        if (int err = pa_stream_begin_write(stream_, &data, &chunk)) {
+            roc_log(LogError, "pulseaudio %s: pa_stream_begin_write(): %s",
+                    device_type_to_str(device_type_), pa_strerror(err));
+            pull_failed_ = true;
+            return;
+        }
+
+        chunk = std::min(chunk, std::min(length, max_chunk));
+        chunk -= chunk % sample_bytes;
+
+        if (!data || chunk == 0) {
+            pa_stream_cancel_write(stream_);
+            break;
+        }
+
+        audio::Frame frame((audio::sample_t*)data, chunk / sizeof(audio::sample_t));
+
+        if (!pull_reader_->read(frame)) {
+            // reader is exhausted, keep device running with silence
+            // until pull mode is stopped
+            memset(data, 0, chunk);
+        }
+
+        if (int err = pa_stream_write(stream_, data, chunk, NULL, 0, PA_SEEK_RELATIVE)) {
+            roc_log(LogError, "pulseaudio %s: pa_stream_write(): %s",
+                    device_type_to_str(device_type_), pa_strerror(err));
+            pull_failed_ = true;
+            return;
+        }
+
+        length -= chunk;
+    }
+
+    report_latency_();
+}
+
 void PulseaudioDevice::stream_state_cb_(pa_stream* stream, void* userdata) {
     PulseaudioDevice& self = *(PulseaudioDevice*)userdata;
 
@@ -833,6 +1211,16 @@ void PulseaudioDevice::stream_request_cb_(pa_stream*, size_t length, void* userd
     roc_log(LogTrace, "pulseaudio %s: stream request callback",
             device_type_to_str(self.device_type_));
 
+    if (self.pull_reader_ && !self.pull_failed_ && length != 0) {
+        self.pull_stream_(length);
+        return;
+    }
+
+    if (self.ring_ && self.stream_ && length != 0) {
+        self.drain_ring_(length);
+        return;
+    }
+
     if (length != 0) {
         pa_threaded_mainloop_signal(self.mainloop_, 0);
     }
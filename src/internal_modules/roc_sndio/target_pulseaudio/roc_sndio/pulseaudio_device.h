@@ -15,8 +15,13 @@
 #include <pulse/pulseaudio.h>
 
 #include "roc_audio/frame.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/rate_limiter.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/spsc_byte_buffer.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/time.h"
 #include "roc_packet/units.h"
@@ -29,10 +34,15 @@ namespace sndio {
 
 //! PulseAudio device.
 //! Can be either source or sink depending on constructor parameter.
+//!
+//! By default, write() and read() lock PulseAudio mainloop and wait until
+//! stream has space or data. If Config::ring_length is non-zero, sink instead
+//! copies frames into a lock-free ring buffer, which is drained by stream write
+//! callback, and write() blocks only when the ring is full.
 class PulseaudioDevice : public ISink, public ISource, public core::NonCopyable<> {
 public:
     //! Initialize.
-    PulseaudioDevice(const Config& config, DeviceType device_type);
+    PulseaudioDevice(core::IArena& arena, const Config& config, DeviceType device_type);
     ~PulseaudioDevice();
 
     //! Open output device.
@@ -77,6 +87,15 @@ public:
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
+    //! Start pulling frames from reader.
+    //! @remarks
+    //!  Supported only for sink. Frames are read from PulseAudio write callback
+    //!  directly into the stream buffer obtained from pa_stream_begin_write().
+    virtual bool start_pull(audio::IFrameReader& reader);
+
+    //! Stop pulling frames from reader.
+    virtual void stop_pull();
+
     //! Read audio frame.
     virtual bool read(audio::Frame& frame);
 
@@ -95,6 +114,15 @@ private:
                           void* userdata);
 
     bool request_frame_(audio::Frame& frame);
+    void restart_stream_();
+
+    bool init_ring_();
+    bool write_ring_(const audio::Frame& frame);
+    bool wait_ring_();
+    void kick_ring_();
+    void drain_ring_(size_t length);
+    void wake_ring_writer_();
+    void drop_ring_();
 
     void want_mainloop_() const;
     bool start_mainloop_();
@@ -118,6 +146,7 @@ private:
     ssize_t write_stream_(const audio::sample_t* data, size_t size);
     ssize_t read_stream_(audio::sample_t* data, size_t size);
     ssize_t wait_stream_();
+    void pull_stream_(size_t length);
 
     bool get_latency_(core::nanoseconds_t& latency) const;
     void report_latency_();
@@ -125,6 +154,8 @@ private:
     void start_timer_(core::nanoseconds_t timeout);
     bool stop_timer_();
 
+    core::IArena& arena_;
+
     const DeviceType device_type_;
     const char* device_;
 
@@ -146,6 +177,20 @@ private:
     bool open_done_;
     bool opened_;
 
+    audio::IFrameReader* pull_reader_;
+    bool pull_failed_;
+
+    core::nanoseconds_t ring_len_ns_;
+    core::Optional<core::SpscByteBuffer> ring_;
+    size_t ring_chunk_samples_;
+    size_t ring_read_pos_;
+    core::Semaphore ring_sem_;
+    core::Atomic<int> ring_samples_;
+    core::Atomic<int> ring_stream_latency_;
+    core::Atomic<int> ring_writer_waiting_;
+    core::Atomic<int> ring_starved_;
+    core::Atomic<int> ring_failed_;
+
     pa_threaded_mainloop* mainloop_;
     pa_context* context_;
     pa_operation* device_info_op_;
@@ -132,10 +132,16 @@ bool map_to_sndfile(const char** driver, const char* path, SF_INFO& file_info_)
     }
 }
 
+// Write-behind ring is split into this many blocks, each written by one
+// sf_write_float() call.
+const size_t RingBlocks = 8;
+
 } // namespace
 
 SndfileSink::SndfileSink(core::IArena& arena, const Config& config)
-    : file_(NULL)
+    : arena_(arena)
+    , file_(NULL)
+    , ring_len_ns_(config.ring_length)
     , valid_(false) {
     if (config.latency != 0) {
         roc_log(LogError,
@@ -160,6 +166,7 @@ SndfileSink::SndfileSink(core::IArena& arena, const Config& config)
 }
 
 SndfileSink::~SndfileSink() {
+    stop_write_behind_();
     close_();
 }
 
@@ -184,6 +191,10 @@ bool SndfileSink::open(const char* driver, const char* path) {
         return false;
     }
 
+    if (ring_len_ns_ > 0 && !start_write_behind_()) {
+        return false;
+    }
+
     return true;
 }
 
@@ -245,6 +256,14 @@ void SndfileSink::write(audio::Frame& frame) {
     audio::sample_t* frame_data = frame.raw_samples();
     sf_count_t frame_left = (sf_count_t)frame.num_raw_samples();
 
+    if (ring_) {
+        // Blocks only if write-behind thread fell behind by whole ring
+        if (!ring_->write(frame_data, (size_t)frame_left)) {
+            roc_panic("sndfile sink: write-behind ring is closed");
+        }
+        return;
+    }
+
     // Write entire float buffer in one call
     sf_count_t count = sf_write_float(file_, frame_data, frame_left);
 
@@ -255,6 +274,92 @@ void SndfileSink::write(audio::Frame& frame) {
     }
 }
 
+// Write-behind thread.
+void SndfileSink::run() {
+    for (;;) {
+        size_t n_samples = 0;
+
+        const audio::sample_t* block = ring_->begin_read(n_samples);
+        if (!block) {
+            // ring was closed
+            break;
+        }
+
+        if (n_samples == 0) {
+            // empty block marks end of stream
+            ring_->end_read();
+            break;
+        }
+
+        sf_count_t count = sf_write_float(file_, block, (sf_count_t)n_samples);
+
+        int errnum = sf_error(file_);
+        if (count != (sf_count_t)n_samples || errnum != 0) {
+            // TODO(gh-183): return error instead of panic
+            roc_panic("sndfile sink: sf_write_float() failed: %s",
+                      sf_error_number(errnum));
+        }
+
+        ring_->end_read();
+    }
+}
+
+bool SndfileSink::start_write_behind_() {
+    roc_panic_if(ring_);
+
+    const size_t num_ch = sample_spec_.num_channels();
+
+    size_t block_size = sample_spec_.ns_2_samples_overall(ring_len_ns_ / RingBlocks);
+    if (block_size < num_ch) {
+        block_size = num_ch;
+    }
+
+    roc_log(LogDebug,
+            "sndfile sink: starting write-behind thread:"
+            " ring_len=%.3fms n_blocks=%lu block_size=%lu",
+            (double)ring_len_ns_ / core::Millisecond, (unsigned long)RingBlocks,
+            (unsigned long)block_size);
+
+    ring_.reset(new (ring_) SampleRing(arena_, block_size, RingBlocks));
+
+    if (!ring_->is_valid()) {
+        roc_log(LogError, "sndfile sink: can't allocate write-behind ring");
+        ring_.reset();
+        return false;
+    }
+
+    if (!start()) {
+        roc_log(LogError, "sndfile sink: can't start write-behind thread");
+        ring_.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void SndfileSink::stop_write_behind_() {
+    if (!ring_) {
+        return;
+    }
+
+    roc_log(LogDebug, "sndfile sink: flushing write-behind ring");
+
+    // write remaining samples and end of stream marker, and wait until
+    // thread writes everything to file
+    ring_->flush();
+
+    if (audio::sample_t* block = ring_->begin_write()) {
+        (void)block;
+        ring_->end_write(0);
+    }
+
+    if (is_joinable()) {
+        join();
+    }
+
+    ring_.reset();
+}
+
 bool SndfileSink::open_(const char* driver, const char* path) {
     if (!map_to_sndfile(&driver, path, file_info_)) {
         roc_log(LogDebug,
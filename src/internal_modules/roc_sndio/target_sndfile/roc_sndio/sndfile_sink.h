@@ -18,10 +18,13 @@
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
 #include "roc_packet/units.h"
 #include "roc_sndio/config.h"
 #include "roc_sndio/isink.h"
+#include "roc_sndio/sample_ring.h"
 
 namespace roc {
 namespace sndio {
@@ -30,7 +33,11 @@ namespace sndio {
 //! @remarks
 //!  Writes samples to output file.
 //!  Supports multiple drivers for different file types.
-class SndfileSink : public ISink, public core::NonCopyable<> {
+//!
+//!  If Config::ring_length is non-zero, write() puts samples into a ring,
+//!  and a separate write-behind thread writes them to file in large blocks.
+//!  This hides occasional I/O stalls, e.g. when writing to slow disk.
+class SndfileSink : public ISink, public core::NonCopyable<>, private core::Thread {
 public:
     //! Initialize.
     SndfileSink(core::IArena& arena, const Config& config);
@@ -87,13 +94,24 @@ public:
     virtual void write(audio::Frame& frame);
 
 private:
+    virtual void run();
+
     bool open_(const char* driver, const char* path);
     void close_();
 
+    bool start_write_behind_();
+    void stop_write_behind_();
+
+    core::IArena& arena_;
+
     SNDFILE* file_;
     SF_INFO file_info_;
 
     audio::SampleSpec sample_spec_;
+
+    core::nanoseconds_t ring_len_ns_;
+    core::Optional<SampleRing> ring_;
+
     bool valid_;
 };
 
@@ -15,8 +15,18 @@
 namespace roc {
 namespace sndio {
 
+namespace {
+
+// Read-ahead ring is split into this many blocks, each read by one
+// sf_read_float() call.
+const size_t RingBlocks = 8;
+
+} // namespace
+
 SndfileSource::SndfileSource(core::IArena& arena, const Config& config)
-    : file_(NULL)
+    : arena_(arena)
+    , ring_len_ns_(config.ring_length)
+    , file_(NULL)
     , path_(arena)
     , valid_(false) {
     if (config.latency != 0) {
@@ -35,6 +45,7 @@ SndfileSource::SndfileSource(core::IArena& arena, const Config& config)
 }
 
 SndfileSource::~SndfileSource() {
+    stop_read_ahead_();
     close_();
 }
 
@@ -64,6 +75,10 @@ bool SndfileSource::open(const char* driver, const char* path) {
         return false;
     }
 
+    if (ring_len_ns_ > 0 && !start_read_ahead_()) {
+        return false;
+    }
+
     return true;
 }
 
@@ -97,6 +112,8 @@ bool SndfileSource::restart() {
 
     roc_log(LogDebug, "sndfile source: restarting");
 
+    stop_read_ahead_();
+
     if (file_ && file_info_.seekable) {
         if (!seek_(0)) {
             roc_log(LogError, "sndfile source: seek failed when restarting");
@@ -113,6 +130,10 @@ bool SndfileSource::restart() {
         }
     }
 
+    if (ring_len_ns_ > 0 && !start_read_ahead_()) {
+        return false;
+    }
+
     return true;
 }
 
@@ -150,10 +171,16 @@ bool SndfileSource::read(audio::Frame& frame) {
     audio::sample_t* frame_data = frame.raw_samples();
     sf_count_t frame_left = (sf_count_t)frame.num_raw_samples();
 
-    sf_count_t n_samples = sf_read_float(file_, frame_data, frame_left);
-    if (sf_error(file_) != 0) {
-        // TODO(gh-183): return error instead of panic
-        roc_panic("sndfile source: sf_read_float() failed: %s", sf_strerror(file_));
+    sf_count_t n_samples = 0;
+
+    if (ring_) {
+        n_samples = (sf_count_t)ring_->read(frame_data, (size_t)frame_left);
+    } else {
+        n_samples = sf_read_float(file_, frame_data, frame_left);
+        if (sf_error(file_) != 0) {
+            // TODO(gh-183): return error instead of panic
+            roc_panic("sndfile source: sf_read_float() failed: %s", sf_strerror(file_));
+        }
     }
 
     if (n_samples < frame_left && n_samples != 0) {
@@ -164,6 +191,78 @@ bool SndfileSource::read(audio::Frame& frame) {
     return n_samples != 0;
 }
 
+// Read-ahead thread.
+void SndfileSource::run() {
+    for (;;) {
+        audio::sample_t* block = ring_->begin_write();
+        if (!block) {
+            // ring was closed
+            break;
+        }
+
+        const sf_count_t n_samples =
+            sf_read_float(file_, block, (sf_count_t)ring_->block_size());
+        if (sf_error(file_) != 0) {
+            // TODO(gh-183): return error instead of panic
+            roc_panic("sndfile source: sf_read_float() failed: %s", sf_strerror(file_));
+        }
+
+        // empty block marks end of file
+        ring_->end_write((size_t)n_samples);
+
+        if (n_samples == 0) {
+            break;
+        }
+    }
+}
+
+bool SndfileSource::start_read_ahead_() {
+    roc_panic_if(ring_);
+
+    const size_t num_ch = sample_spec_.num_channels();
+
+    size_t block_size = sample_spec_.ns_2_samples_overall(ring_len_ns_ / RingBlocks);
+    if (block_size < num_ch) {
+        block_size = num_ch;
+    }
+
+    roc_log(LogDebug,
+            "sndfile source: starting read-ahead thread:"
+            " ring_len=%.3fms n_blocks=%lu block_size=%lu",
+            (double)ring_len_ns_ / core::Millisecond, (unsigned long)RingBlocks,
+            (unsigned long)block_size);
+
+    ring_.reset(new (ring_) SampleRing(arena_, block_size, RingBlocks));
+
+    if (!ring_->is_valid()) {
+        roc_log(LogError, "sndfile source: can't allocate read-ahead ring");
+        ring_.reset();
+        return false;
+    }
+
+    if (!start()) {
+        roc_log(LogError, "sndfile source: can't start read-ahead thread");
+        ring_.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void SndfileSource::stop_read_ahead_() {
+    if (!ring_) {
+        return;
+    }
+
+    ring_->close();
+
+    if (is_joinable()) {
+        join();
+    }
+
+    ring_.reset();
+}
+
 bool SndfileSource::seek_(size_t offset) {
     if (!file_) {
         roc_panic("sndfile source: can't seek: not opened");
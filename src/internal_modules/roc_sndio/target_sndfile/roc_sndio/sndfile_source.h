@@ -18,11 +18,14 @@
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/string_buffer.h"
+#include "roc_core/thread.h"
 #include "roc_packet/units.h"
 #include "roc_sndio/config.h"
 #include "roc_sndio/isource.h"
+#include "roc_sndio/sample_ring.h"
 
 namespace roc {
 namespace sndio {
@@ -31,7 +34,14 @@ namespace sndio {
 //! @remarks
 //!  Reads samples from input file.
 //!  Supports multiple drivers for different file types.
-class SndfileSource : public ISource, private core::NonCopyable<> {
+//!
+//!  If Config::ring_length is non-zero, file is read in large blocks by
+//!  a separate read-ahead thread, and read() takes samples from the ring
+//!  filled by that thread. This hides occasional I/O stalls, e.g. when
+//!  reading from network storage.
+class SndfileSource : public ISource,
+                      private core::NonCopyable<>,
+                      private core::Thread {
 public:
     //! Initialize.
     SndfileSource(core::IArena& arena, const Config& config);
@@ -91,13 +101,23 @@ public:
     virtual bool read(audio::Frame&);
 
 private:
+    virtual void run();
+
     bool open_();
     void close_();
 
     bool seek_(size_t offset);
 
+    bool start_read_ahead_();
+    void stop_read_ahead_();
+
+    core::IArena& arena_;
+
     audio::SampleSpec sample_spec_;
 
+    core::nanoseconds_t ring_len_ns_;
+    core::Optional<SampleRing> ring_;
+
     SNDFILE* file_;
     SF_INFO file_info_;
     core::StringBuffer path_;
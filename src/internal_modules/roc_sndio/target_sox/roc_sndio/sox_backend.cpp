@@ -160,27 +160,33 @@ void log_handler(unsigned sox_level,
 } // namespace
 
 SoxBackend::SoxBackend()
-    : first_created_(false) {
-    sox_init();
-
-    sox_get_globals()->verbosity = 100;
-    sox_get_globals()->output_message_handler = log_handler;
+    : initialized_(false)
+    , first_created_(false)
+    , buffer_size_(0) {
 }
 
 void SoxBackend::set_frame_size(core::nanoseconds_t frame_length,
                                 const audio::SampleSpec& sample_spec) {
     size_t size = sample_spec.ns_2_samples_overall(frame_length);
 
+    core::Mutex::Lock lock(mutex_);
+
     if (first_created_) {
         roc_panic(
             "sox backend:"
             " set_frame_size() can be called only before creating first source or sink");
     }
 
-    sox_get_globals()->bufsiz = size * sizeof(sox_sample_t);
+    buffer_size_ = size * sizeof(sox_sample_t);
+
+    if (initialized_) {
+        sox_get_globals()->bufsiz = buffer_size_;
+    }
 }
 
 void SoxBackend::discover_drivers(core::Array<DriverInfo, MaxDrivers>& driver_list) {
+    init_();
+
     for (size_t n = 0; n < ROC_ARRAY_SIZE(default_drivers); n++) {
         const sox_format_handler_t* handler =
             sox_write_handler(NULL, default_drivers[n], NULL);
@@ -229,7 +235,12 @@ IDevice* SoxBackend::open_device(DeviceType device_type,
                                  const char* path,
                                  const Config& config,
                                  core::IArena& arena) {
-    first_created_ = true;
+    init_();
+
+    {
+        core::Mutex::Lock lock(mutex_);
+        first_created_ = true;
+    }
 
     driver = map_to_sox_driver(driver);
 
@@ -300,5 +311,26 @@ const char* SoxBackend::name() const {
     return "sox";
 }
 
+void SoxBackend::init_() {
+    core::Mutex::Lock lock(mutex_);
+
+    if (initialized_) {
+        return;
+    }
+
+    roc_log(LogDebug, "sox backend: initializing");
+
+    sox_init();
+
+    sox_get_globals()->verbosity = 100;
+    sox_get_globals()->output_message_handler = log_handler;
+
+    if (buffer_size_ != 0) {
+        sox_get_globals()->bufsiz = buffer_size_;
+    }
+
+    initialized_ = true;
+}
+
 } // namespace sndio
 } // namespace roc
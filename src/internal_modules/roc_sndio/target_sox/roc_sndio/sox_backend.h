@@ -15,6 +15,7 @@
 #include <sox.h>
 
 #include "roc_audio/sample_spec.h"
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_sndio/ibackend.h"
 
@@ -22,6 +23,9 @@ namespace roc {
 namespace sndio {
 
 //! SoX backend.
+//! @remarks
+//!  SoX library is initialized on first use, because initialization loads
+//!  all format handlers, which is slow.
 class SoxBackend : public IBackend, core::NonCopyable<> {
 public:
     SoxBackend();
@@ -46,7 +50,13 @@ public:
     virtual const char* name() const;
 
 private:
+    void init_();
+
+    core::Mutex mutex_;
+
+    bool initialized_;
     bool first_created_;
+    size_t buffer_size_;
 };
 
 } // namespace sndio
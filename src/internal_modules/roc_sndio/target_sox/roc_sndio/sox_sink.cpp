@@ -9,7 +9,6 @@
 #include "roc_sndio/sox_sink.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
-#include "roc_sndio/backend_map.h"
 
 namespace roc {
 namespace sndio {
@@ -20,8 +19,6 @@ SoxSink::SoxSink(core::IArena& arena, const Config& config, DriverType type)
     , buffer_size_(0)
     , is_file_(false)
     , valid_(false) {
-    BackendMap::instance();
-
     if (config.latency != 0) {
         roc_log(LogError, "sox sink: setting io latency not supported by sox backend");
         return;
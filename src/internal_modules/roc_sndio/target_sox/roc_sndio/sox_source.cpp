@@ -9,7 +9,6 @@
 #include "roc_sndio/sox_source.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
-#include "roc_sndio/backend_map.h"
 
 namespace roc {
 namespace sndio {
@@ -24,8 +23,6 @@ SoxSource::SoxSource(core::IArena& arena, const Config& config, DriverType type)
     , eof_(false)
     , paused_(false)
     , valid_(false) {
-    BackendMap::instance();
-
     if (config.latency != 0) {
         roc_log(LogError, "sox source: setting io latency not supported by sox backend");
         return;
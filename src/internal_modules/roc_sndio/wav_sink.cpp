@@ -90,7 +90,7 @@ bool WavSink::restart() {
 }
 
 audio::SampleSpec WavSink::sample_spec() const {
-    if (!output_file_) {
+    if (!output_file_ && !mapped_file_.is_opened()) {
         roc_panic("wav sink: not opened");
     }
 
@@ -110,7 +110,7 @@ bool WavSink::has_clock() const {
 }
 
 void WavSink::write(audio::Frame& frame) {
-    if (!output_file_) {
+    if (!output_file_ && !mapped_file_.is_opened()) {
         roc_panic("wav sink: not opened");
     }
 
@@ -118,40 +118,39 @@ void WavSink::write(audio::Frame& frame) {
     size_t n_samples = frame.num_raw_samples();
 
     if (n_samples > 0) {
-        if (fseek(output_file_, 0, SEEK_SET)) {
-            roc_log(LogError, "wav sink: failed to seek to the beginning of the file: %s",
-                    core::errno_to_str(errno).c_str());
+        if (mapped_file_.is_opened()) {
+            write_mapped_(samples, n_samples);
+        } else {
+            write_stdio_(samples, n_samples);
         }
+    }
+}
 
-        const WavHeader::WavHeaderData& wav_header =
-            header_->update_and_get_header(n_samples);
-        if (fwrite(&wav_header, sizeof(wav_header), 1, output_file_) != 1) {
-            roc_log(LogError, "wav sink: failed to write header: %s",
-                    core::errno_to_str(errno).c_str());
-        }
+bool WavSink::open_(const char* path) {
+    if (output_file_ || mapped_file_.is_opened()) {
+        roc_panic("wav sink: already opened");
+    }
 
-        if (fseek(output_file_, 0, SEEK_END)) {
-            roc_log(LogError,
-                    "wav sink: failed to seek to append position of the file: %s",
-                    core::errno_to_str(errno).c_str());
-        }
+    if (mapped_file_.open_write(path)) {
+        const WavHeader::WavHeaderData& wav_header = header_->update_and_get_header(0);
 
-        if (fwrite(samples, sizeof(audio::sample_t), n_samples, output_file_)
-            != n_samples) {
-            roc_log(LogError, "wav sink: failed to write samples: %s",
-                    core::errno_to_str(errno).c_str());
+        if (!mapped_file_.reserve(sizeof(wav_header))) {
+            roc_log(LogDebug, "wav sink: can't map output file");
+            mapped_file_.close();
+            return false;
         }
 
-        if (fflush(output_file_)) {
-            roc_log(LogError, "wav sink: failed to flush data to the file: %s",
-                    core::errno_to_str(errno).c_str());
-        }
-    }
-}
+        memcpy(mapped_file_.data(), &wav_header, sizeof(wav_header));
+        mapped_file_.resize(sizeof(wav_header));
 
-bool WavSink::open_(const char* path) {
-    if (output_file_) {
-        roc_panic("wav sink: already opened");
+        roc_log(LogInfo,
+                "wav sink: opened output file:"
+                " path=%s out_bits=%lu out_rate=%lu out_ch=%lu mapped=1",
+                path, (unsigned long)header_->bits_per_sample(),
+                (unsigned long)header_->sample_rate(),
+                (unsigned long)header_->num_channels());
+
+        return true;
     }
 
     output_file_ = fopen(path, "w");
@@ -163,7 +162,7 @@ bool WavSink::open_(const char* path) {
 
     roc_log(LogInfo,
             "wav sink: opened output file:"
-            " path=%s out_bits=%lu out_rate=%lu out_ch=%lu",
+            " path=%s out_bits=%lu out_rate=%lu out_ch=%lu mapped=0",
             path, (unsigned long)header_->bits_per_sample(),
             (unsigned long)header_->sample_rate(),
             (unsigned long)header_->num_channels());
@@ -172,6 +171,15 @@ bool WavSink::open_(const char* path) {
 }
 
 void WavSink::close_() {
+    if (mapped_file_.is_opened()) {
+        roc_log(LogDebug, "wav sink: closing output file");
+
+        if (!mapped_file_.close()) {
+            roc_panic("wav sink: can't close output file");
+        }
+        return;
+    }
+
     if (!output_file_) {
         return;
     }
@@ -186,5 +194,51 @@ void WavSink::close_() {
     output_file_ = NULL;
 }
 
+void WavSink::write_mapped_(const audio::sample_t* samples, size_t n_samples) {
+    const size_t pos = mapped_file_.size();
+    const size_t n_bytes = n_samples * sizeof(audio::sample_t);
+
+    if (!mapped_file_.reserve(pos + n_bytes)) {
+        roc_log(LogError, "wav sink: failed to extend output file");
+        return;
+    }
+
+    memcpy(mapped_file_.data() + pos, samples, n_bytes);
+    mapped_file_.resize(pos + n_bytes);
+
+    const WavHeader::WavHeaderData& wav_header =
+        header_->update_and_get_header(n_samples / sample_spec_.num_channels());
+    memcpy(mapped_file_.data(), &wav_header, sizeof(wav_header));
+}
+
+void WavSink::write_stdio_(const audio::sample_t* samples, size_t n_samples) {
+    if (fseek(output_file_, 0, SEEK_SET)) {
+        roc_log(LogError, "wav sink: failed to seek to the beginning of the file: %s",
+                core::errno_to_str(errno).c_str());
+    }
+
+    const WavHeader::WavHeaderData& wav_header =
+        header_->update_and_get_header(n_samples / sample_spec_.num_channels());
+    if (fwrite(&wav_header, sizeof(wav_header), 1, output_file_) != 1) {
+        roc_log(LogError, "wav sink: failed to write header: %s",
+                core::errno_to_str(errno).c_str());
+    }
+
+    if (fseek(output_file_, 0, SEEK_END)) {
+        roc_log(LogError, "wav sink: failed to seek to append position of the file: %s",
+                core::errno_to_str(errno).c_str());
+    }
+
+    if (fwrite(samples, sizeof(audio::sample_t), n_samples, output_file_) != n_samples) {
+        roc_log(LogError, "wav sink: failed to write samples: %s",
+                core::errno_to_str(errno).c_str());
+    }
+
+    if (fflush(output_file_)) {
+        roc_log(LogError, "wav sink: failed to flush data to the file: %s",
+                core::errno_to_str(errno).c_str());
+    }
+}
+
 } // namespace sndio
 } // namespace roc
@@ -15,6 +15,7 @@
 #include "roc_audio/sample_spec.h"
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
+#include "roc_core/mapped_file.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
@@ -29,7 +30,8 @@ namespace sndio {
 
 //! WAV sink.
 //! @remarks
-//!  Writes samples to output file.
+//!  Writes samples to output file. If the output is a regular file, it is
+//!  memory-mapped and extended in large chunks; otherwise, stdio is used.
 class WavSink : public ISink, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -89,8 +91,12 @@ private:
     bool open_(const char* path);
     void close_();
 
+    void write_mapped_(const audio::sample_t* samples, size_t n_samples);
+    void write_stdio_(const audio::sample_t* samples, size_t n_samples);
+
     audio::SampleSpec sample_spec_;
 
+    core::MappedFile mapped_file_;
     FILE* output_file_;
     core::Optional<WavHeader> header_;
 
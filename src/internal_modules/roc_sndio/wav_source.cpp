@@ -7,15 +7,54 @@
  */
 
 #include "roc_sndio/wav_source.h"
+#include "roc_audio/pcm_format.h"
 #include "roc_core/log.h"
+#include "roc_core/macro_helpers.h"
 #include "roc_core/panic.h"
 
 namespace roc {
 namespace sndio {
 
+namespace {
+
+// Get pcm format of samples stored in wav file, if they can be
+// mapped directly without decoding.
+audio::PcmFormat wav_pcm_format(const drwav& wav) {
+    switch (wav.translatedFormatTag) {
+    case DR_WAVE_FORMAT_PCM:
+        switch (wav.bitsPerSample) {
+        case 8:
+            return audio::PcmFormat_UInt8;
+        case 16:
+            return audio::PcmFormat_SInt16_Le;
+        case 24:
+            return audio::PcmFormat_SInt24_Le;
+        case 32:
+            return audio::PcmFormat_SInt32_Le;
+        }
+        break;
+
+    case DR_WAVE_FORMAT_IEEE_FLOAT:
+        switch (wav.bitsPerSample) {
+        case 32:
+            return audio::PcmFormat_Float32_Le;
+        case 64:
+            return audio::PcmFormat_Float64_Le;
+        }
+        break;
+    }
+
+    return audio::PcmFormat_Invalid;
+}
+
+} // namespace
+
 WavSource::WavSource(core::IArena& arena, const Config& config)
     : file_opened_(false)
     , eof_(false)
+    , mapped_data_(NULL)
+    , mapped_size_(0)
+    , mapped_bit_off_(0)
     , valid_(false) {
     if (config.latency != 0) {
         roc_log(LogError, "wav source: setting io latency not supported");
@@ -79,7 +118,9 @@ bool WavSource::restart() {
 
     roc_log(LogDebug, "wav source: restarting");
 
-    if (!drwav_seek_to_pcm_frame(&wav_, 0)) {
+    if (mapped_data_) {
+        mapped_bit_off_ = 0;
+    } else if (!drwav_seek_to_pcm_frame(&wav_, 0)) {
         roc_log(LogError, "wav source: seek failed when restarting");
         return false;
     }
@@ -132,11 +173,8 @@ bool WavSource::read(audio::Frame& frame) {
     size_t frame_left = frame.num_raw_samples();
 
     while (frame_left != 0) {
-        size_t n_samples = frame_left;
-
-        n_samples =
-            drwav_read_pcm_frames_f32(&wav_, n_samples / wav_.channels, frame_data)
-            * wav_.channels;
+        const size_t n_samples = mapped_data_ ? read_mapped_(frame_data, frame_left)
+                                              : read_decoded_(frame_data, frame_left);
 
         if (n_samples == 0) {
             roc_log(LogDebug, "wav source: got eof from input file");
@@ -170,16 +208,67 @@ bool WavSource::open_(const char* path) {
         return false;
     }
 
+    const bool mapped = map_(path);
+
     roc_log(LogInfo,
             "wav source: opened input file:"
-            " path=%s in_bits=%lu in_rate=%lu in_ch=%lu",
+            " path=%s in_bits=%lu in_rate=%lu in_ch=%lu mapped=%d",
             path, (unsigned long)wav_.bitsPerSample, (unsigned long)wav_.sampleRate,
-            (unsigned long)wav_.channels);
+            (unsigned long)wav_.channels, (int)mapped);
 
     file_opened_ = true;
     return true;
 }
 
+bool WavSource::map_(const char* path) {
+    const audio::PcmFormat pcm_format = wav_pcm_format(wav_);
+    if (pcm_format == audio::PcmFormat_Invalid) {
+        return false;
+    }
+
+    mapper_.reset(new (mapper_) audio::PcmMapper(pcm_format, audio::Sample_RawFormat));
+
+    // samples should be tightly packed to be mapped as is
+    if (wav_.channels == 0
+        || wav_.fmt.blockAlign != mapper_->input_byte_count(1) * wav_.channels) {
+        return false;
+    }
+
+    // mapper uses bit offsets, which should fit size_t
+    const drwav_uint64 data_size64 = wav_.totalPCMFrameCount * wav_.fmt.blockAlign;
+    if (data_size64 > ROC_MAX_OF(size_t) / 8) {
+        return false;
+    }
+
+    if (!mapped_file_.open_read(path)) {
+        return false;
+    }
+
+    const size_t data_pos = (size_t)wav_.dataChunkDataPos;
+    size_t data_size = (size_t)data_size64;
+
+    if (data_pos > mapped_file_.size()) {
+        roc_log(LogDebug,
+                "wav source: data chunk is out of file bounds:"
+                " data_pos=%lu file_size=%lu",
+                (unsigned long)data_pos, (unsigned long)mapped_file_.size());
+        mapped_file_.close();
+        return false;
+    }
+
+    // file may be truncated, e.g. if recording was interrupted
+    if (data_size > mapped_file_.size() - data_pos) {
+        data_size = (mapped_file_.size() - data_pos) / wav_.fmt.blockAlign
+            * wav_.fmt.blockAlign;
+    }
+
+    mapped_data_ = mapped_file_.data() + data_pos;
+    mapped_size_ = data_size;
+    mapped_bit_off_ = 0;
+
+    return true;
+}
+
 void WavSource::close_() {
     if (!file_opened_) {
         return;
@@ -187,6 +276,23 @@ void WavSource::close_() {
 
     file_opened_ = false;
     drwav_uninit(&wav_);
+
+    mapped_data_ = NULL;
+    mapped_size_ = 0;
+    mapped_bit_off_ = 0;
+    mapped_file_.close();
+}
+
+size_t WavSource::read_mapped_(audio::sample_t* data, size_t n_samples) {
+    size_t out_bit_off = 0;
+
+    return mapper_->map(mapped_data_, mapped_size_, mapped_bit_off_, data,
+                        n_samples * sizeof(audio::sample_t), out_bit_off, n_samples);
+}
+
+size_t WavSource::read_decoded_(audio::sample_t* data, size_t n_samples) {
+    return drwav_read_pcm_frames_f32(&wav_, n_samples / wav_.channels, data)
+        * wav_.channels;
 }
 
 } // namespace sndio
@@ -14,10 +14,13 @@
 
 #include <dr_wav.h>
 
+#include "roc_audio/pcm_mapper.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_core/array.h"
 #include "roc_core/iarena.h"
+#include "roc_core/mapped_file.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/string_buffer.h"
 #include "roc_packet/units.h"
@@ -28,6 +31,10 @@ namespace roc {
 namespace sndio {
 
 //! WAV source.
+//! @remarks
+//!  If the file is a regular file with plain PCM or float samples, its data
+//!  chunk is memory-mapped and samples are converted directly from the
+//!  mapping into frames. Otherwise, samples are decoded via dr_wav.
 class WavSource : public ISource, private core::NonCopyable<> {
 public:
     //! Initialize.
@@ -88,12 +95,22 @@ public:
 
 private:
     bool open_(const char* path);
+    bool map_(const char* path);
     void close_();
 
+    size_t read_mapped_(audio::sample_t* data, size_t n_samples);
+    size_t read_decoded_(audio::sample_t* data, size_t n_samples);
+
     drwav wav_;
     bool file_opened_;
     bool eof_;
 
+    core::MappedFile mapped_file_;
+    core::Optional<audio::PcmMapper> mapper_;
+    const uint8_t* mapped_data_;
+    size_t mapped_size_;
+    size_t mapped_bit_off_;
+
     bool valid_;
 };
 
@@ -100,8 +100,10 @@ typedef enum roc_interface {
      *
      * Allowed protocols:
      *  - \ref ROC_PROTO_RTP
+     *  - \ref ROC_PROTO_RTP_SHM
      *  - \ref ROC_PROTO_RTP_RS8M_SOURCE
      *  - \ref ROC_PROTO_RTP_LDPC_SOURCE
+     *  - \ref ROC_PROTO_RTP_RLC_SOURCE
      */
     ROC_INTERFACE_AUDIO_SOURCE = 11,
 
@@ -114,6 +116,7 @@ typedef enum roc_interface {
      * Allowed protocols:
      *  - \ref ROC_PROTO_RS8M_REPAIR
      *  - \ref ROC_PROTO_LDPC_REPAIR
+     *  - \ref ROC_PROTO_RLC_REPAIR
      */
     ROC_INTERFACE_AUDIO_REPAIR = 12,
 
@@ -163,6 +166,29 @@ typedef enum roc_protocol {
      */
     ROC_PROTO_RTP = 20,
 
+    /** RTP (RFC 3550) over shared memory ring.
+     *
+     * Passes packets between sender and receiver running on the same host
+     * without network stack. Receiver creates shared memory segment selected
+     * by endpoint port number, and senders connected to same port number
+     * write packets to it. Endpoint host is used only as packet address.
+     *
+     * Supported only on Linux and other platforms with POSIX shared memory.
+     *
+     * Interfaces:
+     *  - \ref ROC_INTERFACE_AUDIO_SOURCE
+     *
+     * Transports:
+     *  - shared memory
+     *
+     * Audio encodings:
+     *  - similar to \ref ROC_PROTO_RTP
+     *
+     * FEC encodings:
+     *   - none
+     */
+    ROC_PROTO_RTP_SHM = 21,
+
     /** RTP source packet (RFC 3550) + FECFRAME Reed-Solomon footer (RFC 6865) with m=8.
      *
      * Interfaces:
@@ -221,6 +247,35 @@ typedef enum roc_protocol {
      */
     ROC_PROTO_LDPC_REPAIR = 33,
 
+    /** RTP source packet (RFC 3550) + FECFRAME RLC footer (RFC 8681) with m=8.
+     *
+     * Interfaces:
+     *  - \ref ROC_INTERFACE_AUDIO_SOURCE
+     *
+     * Transports:
+     *  - UDP
+     *
+     * Audio encodings:
+     *  - similar to \ref ROC_PROTO_RTP
+     *
+     * FEC encodings:
+     *  - \ref ROC_FEC_ENCODING_RLC
+     */
+    ROC_PROTO_RTP_RLC_SOURCE = 34,
+
+    /** FEC repair packet + FECFRAME RLC header (RFC 8681) with m=8.
+     *
+     * Interfaces:
+     *  - \ref ROC_INTERFACE_AUDIO_REPAIR
+     *
+     * Transports:
+     *  - UDP
+     *
+     * FEC encodings:
+     *  - \ref ROC_FEC_ENCODING_RLC
+     */
+    ROC_PROTO_RLC_REPAIR = 35,
+
     /** RTCP over UDP (RFC 3550).
      *
      * Interfaces:
@@ -247,6 +302,7 @@ typedef enum roc_packet_encoding {
      *  - \ref ROC_PROTO_RTP
      *  - \ref ROC_PROTO_RTP_RS8M_SOURCE
      *  - \ref ROC_PROTO_RTP_LDPC_SOURCE
+     *  - \ref ROC_PROTO_RTP_RLC_SOURCE
      */
     ROC_PACKET_ENCODING_AVP_L16_MONO = 11,
 
@@ -260,6 +316,7 @@ typedef enum roc_packet_encoding {
      *  - \ref ROC_PROTO_RTP
      *  - \ref ROC_PROTO_RTP_RS8M_SOURCE
      *  - \ref ROC_PROTO_RTP_LDPC_SOURCE
+     *  - \ref ROC_PROTO_RTP_RLC_SOURCE
      */
     ROC_PACKET_ENCODING_AVP_L16_STEREO = 10,
 } roc_packet_encoding;
@@ -311,7 +368,27 @@ typedef enum roc_fec_encoding {
      * Cons:
      *  - low repair capabilities on small block sizes
      */
-    ROC_FEC_ENCODING_LDPC_STAIRCASE = 2
+    ROC_FEC_ENCODING_LDPC_STAIRCASE = 2,
+
+    /** Sliding-window Random Linear Codes FEC encoding (RFC 8681) with m=8.
+     *
+     * Good for low latency.
+     * Compatible with \ref ROC_PROTO_RTP_RLC_SOURCE and \ref ROC_PROTO_RLC_REPAIR
+     * protocols for source and repair endpoints.
+     *
+     * Instead of blocks, each repair packet protects a window of last
+     * \c fec_block_source_packets source packets, and \c fec_block_repair_packets
+     * repair packets are sent per that many source packets, spread evenly.
+     *
+     * Pros:
+     *  - lost packet can be repaired as soon as next repair packet arrives, without
+     *    waiting for the end of a block, which allows lower latency
+     *
+     * Cons:
+     *  - higher CPU usage on receiver when repairing losses
+     *  - block size can't be changed on the fly (e.g. by adaptive FEC)
+     */
+    ROC_FEC_ENCODING_RLC = 3
 } roc_fec_encoding;
 
 /** Sample format.
@@ -415,6 +492,39 @@ typedef enum roc_clock_source {
     ROC_CLOCK_SOURCE_INTERNAL = 2
 } roc_clock_source;
 
+/** Write queue overflow policy.
+ * Defines what sender does when write queue is full.
+ *
+ * \see roc_sender_config.write_queue_length
+ */
+typedef enum roc_write_overflow {
+    /** Default policy.
+     * Current default is \c ROC_WRITE_OVERFLOW_BLOCK.
+     */
+    ROC_WRITE_OVERFLOW_DEFAULT = 0,
+
+    /** Write blocks until the queue has enough space.
+     *
+     * No samples are lost, but if the pipeline can't keep up, the write
+     * operation waits for it, like when the queue is disabled.
+     */
+    ROC_WRITE_OVERFLOW_BLOCK = 1,
+
+    /** Write discards samples that don't fit into the queue.
+     *
+     * Write operation never waits for the pipeline. Samples written
+     * while the queue is full are lost.
+     */
+    ROC_WRITE_OVERFLOW_DROP = 2,
+
+    /** Write discards the oldest queued samples to make room for new ones.
+     *
+     * Write operation never waits for the pipeline. When the queue is full,
+     * the most recent samples are kept, which keeps latency bounded.
+     */
+    ROC_WRITE_OVERFLOW_OVERWRITE = 3
+} roc_write_overflow;
+
 /** Latency tuner backend.
  * Defines which latency is monitored and tuned by latency tuner.
  */
@@ -577,7 +687,36 @@ typedef enum roc_resampler_backend {
      *
      * Recommended when CPU resources are extremely limited.
      */
-    ROC_RESAMPLER_BACKEND_SPEEXDEC = 3
+    ROC_RESAMPLER_BACKEND_SPEEXDEC = 3,
+
+    /** Built-in resampler with fixed-point arithmetic.
+     *
+     * Same algorithm as \c ROC_RESAMPLER_BACKEND_BUILTIN, but samples are converted
+     * to 16-bit integers and filtering is done using integer arithmetic only.
+     * Precision is limited to 16 bits, which is enough when both network and sound
+     * card use 16-bit samples.
+     *
+     * Always available.
+     *
+     * Recommended on CPUs without fast floating point unit.
+     */
+    ROC_RESAMPLER_BACKEND_BUILTIN_FIXED = 4,
+
+    /** Built-in resampler with polyphase filter bank.
+     *
+     * Same algorithm as \c ROC_RESAMPLER_BACKEND_BUILTIN, but filter coefficients are
+     * precomputed for a number of fractional positions and interpolated between them,
+     * and filtering uses SIMD instructions when available. Clock speed is controlled
+     * with the same high precision, while CPU usage is lower, at the cost of a bigger
+     * memory footprint per session (tens of kilobytes on medium profile, hundreds
+     * on high profile).
+     *
+     * Always available.
+     *
+     * Recommended for \ref ROC_LATENCY_TUNER_PROFILE_RESPONSIVE when CPU usage of
+     * \ref ROC_RESAMPLER_BACKEND_BUILTIN is too high.
+     */
+    ROC_RESAMPLER_BACKEND_BUILTIN_POLYPHASE = 5
 } roc_resampler_backend;
 
 /** Resampler profile.
@@ -600,6 +739,99 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_PROFILE_LOW = 3
 } roc_resampler_profile;
 
+/** Thread scheduling policy.
+ */
+typedef enum roc_thread_policy {
+    /** Default policy.
+     * Thread inherits scheduling policy of the thread that opened context.
+     */
+    ROC_THREAD_POLICY_DEFAULT = 0,
+
+    /** Realtime first-in first-out policy (SCHED_FIFO).
+     * Usually requires elevated privileges.
+     */
+    ROC_THREAD_POLICY_FIFO = 1,
+
+    /** Realtime round-robin policy (SCHED_RR).
+     * Usually requires elevated privileges.
+     */
+    ROC_THREAD_POLICY_RR = 2
+} roc_thread_policy;
+
+/** Thread configuration.
+ *
+ * Defines CPU affinity and scheduling of a background thread.
+ *
+ * It is safe to memset() this struct with zeros to get a default config.
+ */
+typedef struct roc_thread_config {
+    /** Mask of CPUs on which thread is allowed to run.
+     *
+     * N-th bit corresponds to N-th CPU. Only first 64 CPUs can be specified.
+     * Supported only on Linux.
+     *
+     * If zero, thread is not pinned to any CPU.
+     */
+    unsigned long long cpu_mask;
+
+    /** Scheduling policy.
+     *
+     * If zero, default policy is used.
+     */
+    roc_thread_policy policy;
+
+    /** Scheduling priority.
+     *
+     * Used only with realtime policies. Should be in range allowed by the
+     * selected policy, e.g. from 1 to 99 on Linux.
+     *
+     * If zero, maximum priority for the policy is used.
+     */
+    int priority;
+} roc_thread_config;
+
+/** Media clock.
+ *
+ * Defines clock used for capture timestamps of frames and for end-to-end latency
+ * computation. The more precise the clock is synchronized between sender and
+ * receiver hosts, the more precise is \ref ROC_LATENCY_TUNER_BACKEND_E2E, and
+ * the lower target latency can be used with it.
+ *
+ * Sender and receiver should use the same media clock. Capture timestamps provided
+ * by user should be taken from the same clock too.
+ */
+typedef enum roc_media_clock {
+    /** Default media clock.
+     * Current default is \c ROC_MEDIA_CLOCK_SYSTEM.
+     */
+    ROC_MEDIA_CLOCK_DEFAULT = 0,
+
+    /** System real-time clock (CLOCK_REALTIME).
+     *
+     * Usually synchronized using NTP, with precision of about a millisecond.
+     */
+    ROC_MEDIA_CLOCK_SYSTEM = 1,
+
+    /** International Atomic Time (CLOCK_TAI).
+     *
+     * Use when system clock is synchronized using PTP daemon (e.g. phc2sys).
+     * Differs from system clock by number of leap seconds.
+     *
+     * Supported only on Linux.
+     */
+    ROC_MEDIA_CLOCK_TAI = 2,
+
+    /** PTP hardware clock of network interface.
+     *
+     * Clock is read directly from network card, which is synchronized by PTP
+     * daemon (e.g. ptp4l) with sub-microsecond precision. Device is specified
+     * by \c ptp_device field of \ref roc_context_config.
+     *
+     * Supported only on Linux.
+     */
+    ROC_MEDIA_CLOCK_PTP = 3
+} roc_media_clock;
+
 /** Context configuration.
  *
  * It is safe to memset() this struct with zeros to get a default config. It is also
@@ -625,6 +857,207 @@ typedef struct roc_context_config {
      * If zero, default value is used.
      */
     unsigned int max_frame_size;
+
+    /** Number of network threads.
+     *
+     * Each thread runs its own network event loop. Network ports of senders and
+     * receivers attached to the context are distributed between threads in
+     * round-robin order. Increasing the number of threads allows to spread
+     * network I/O of many senders and receivers across multiple CPU cores.
+     *
+     * If zero, default value is used (one thread).
+     */
+    unsigned int network_threads;
+
+    /** Network thread configuration.
+     *
+     * Defines CPU affinity and scheduling of the background threads that perform
+     * network I/O. Applied to every network thread.
+     *
+     * If zero, default configuration is used.
+     */
+    roc_thread_config network_thread;
+
+    /** Control thread configuration.
+     *
+     * Defines CPU affinity and scheduling of the background thread that performs
+     * control tasks, like periodic reports and pipeline maintenance.
+     *
+     * If zero, default configuration is used.
+     */
+    roc_thread_config control_thread;
+
+    /** Use process-wide shared runtime.
+     *
+     * If true, context doesn't start its own network and control threads, and
+     * instead uses threads shared by all contexts opened with this flag. This is
+     * useful when an application opens many contexts, e.g. one per plugin
+     * instance, and most of them are idle.
+     *
+     * Shared threads are started when the first such context is opened, using its
+     * \c network_threads, \c network_thread, \c control_thread and resolver
+     * settings, and are stopped when the last such context is closed. These
+     * settings of other contexts are ignored. Packet and frame memory, memory
+     * limits, and metrics are still separate for every context.
+     *
+     * By default, false.
+     */
+    int shared_runtime;
+
+    /** Mask of NUMA nodes to which context is bound.
+     *
+     * N-th bit corresponds to N-th NUMA node. Only first 64 nodes can be specified.
+     * Supported only on Linux.
+     *
+     * If non-zero, memory of packets and frames allocated by the context is placed
+     * on these nodes, and network and control threads that don't have explicit
+     * \c cpu_mask are pinned to CPUs of these nodes. All senders and receivers
+     * attached to the context use its memory, so they become bound to the same
+     * nodes. To serve senders and receivers from multiple nodes, create one
+     * context per node.
+     *
+     * If zero, context is not bound to any node.
+     */
+    unsigned long long numa_nodes;
+
+    /** Number of packets to preallocate.
+     *
+     * Context reserves memory for this number of network packets when it's
+     * opened, and allocates more on demand after that.
+     *
+     * If zero, memory for packets is allocated on demand from the beginning.
+     */
+    unsigned int prealloc_packets;
+
+    /** Number of frames to preallocate.
+     *
+     * Same as \c prealloc_packets, but for intermediate internal frames.
+     */
+    unsigned int prealloc_frames;
+
+    /** Maximum number of packets.
+     *
+     * If non-zero, context reserves memory for at least this number of network
+     * packets when it's opened, and never allocates more after that. When all
+     * packets are in use, new incoming or outgoing packets are dropped. This
+     * guarantees that packets don't cause heap allocations after the context
+     * is opened.
+     *
+     * Should not be less than \c prealloc_packets.
+     *
+     * If zero, number of packets is not limited.
+     */
+    unsigned int max_packets;
+
+    /** Maximum number of frames.
+     *
+     * Same as \c max_packets, but for intermediate internal frames.
+     *
+     * Should not be less than \c prealloc_frames.
+     */
+    unsigned int max_frames;
+
+    /** Memory quota of every sender and receiver, in bytes.
+     *
+     * If non-zero, every sender, receiver, encoder, and decoder opened with the
+     * context gets its own pools of packets and frames, which take memory from
+     * the context, but not more than this quota. One sender or receiver with a
+     * large latency or a flooded port then can't exhaust memory of others, and
+     * doesn't contend with them on pool locks. When quota is exhausted, packets
+     * of this sender or receiver are dropped.
+     *
+     * Such pools are not affected by \c prealloc_packets, \c prealloc_frames,
+     * \c max_packets, and \c max_frames.
+     *
+     * If zero, all senders and receivers share pools of the context.
+     */
+    unsigned long long node_memory_limit;
+
+    /** Realtime mode.
+     *
+     * If true, when context is opened, all memory of the process is locked in RAM
+     * and prefaulted, including memory reserved for \c prealloc_packets and
+     * \c prealloc_frames, and stacks of context threads. This prevents page
+     * faults on realtime paths, which may otherwise cause latency spikes and
+     * glitches. Pools are not shrunk while context is open.
+     *
+     * Memory allocated after that is locked as well. To avoid page faults when
+     * pools grow, set \c prealloc_packets and \c prealloc_frames (or
+     * \c max_packets and \c max_frames) to the expected peak usage.
+     *
+     * Requires permission to lock memory (e.g. \c CAP_IPC_LOCK or large enough
+     * \c RLIMIT_MEMLOCK). If memory can't be locked, context fails to open.
+     * Supported only on POSIX systems.
+     *
+     * By default, false.
+     */
+    int realtime_mode;
+
+    /** Maximum number of cached hostname resolving results.
+     *
+     * Results of resolving hostnames in endpoint URIs are cached, so that
+     * reconnecting to the same hosts doesn't wait for DNS queries. When cache is
+     * full, least recently used result is evicted. Each network thread has its own
+     * cache.
+     *
+     * If zero, default value is used.
+     */
+    unsigned int resolver_cache_size;
+
+    /** How long successfully resolved address is cached, in nanoseconds.
+     *
+     * If zero, default value is used. If negative, successful results are not cached.
+     */
+    long long resolver_cache_ttl;
+
+    /** How long hostname resolving failure is cached, in nanoseconds.
+     *
+     * Prevents repeated DNS queries for hostnames that can't be resolved.
+     *
+     * If zero, default value is used. If negative, failures are not cached.
+     */
+    long long resolver_negative_cache_ttl;
+
+    /** Media clock.
+     *
+     * Defines clock used for capture timestamps and end-to-end latency by all
+     * senders and receivers in the process. Selection is process-wide and is
+     * applied when context is opened.
+     *
+     * If zero, current selection is not changed (by default it's system clock).
+     */
+    roc_media_clock media_clock;
+
+    /** Path to PTP clock device, e.g. "/dev/ptp0".
+     *
+     * Used when \c media_clock is \ref ROC_MEDIA_CLOCK_PTP. Should remain valid
+     * until \ref roc_context_open() returns.
+     */
+    const char* ptp_device;
+
+    /** Number of packets kept by in-process packet capture.
+     *
+     * If non-zero, context keeps headers and first bytes of last packets received
+     * and sent by its senders and receivers, and of packets produced by FEC
+     * decoding, together with pipeline annotations (session, late, repaired,
+     * dropped). They can be written to pcapng file using
+     * \ref roc_context_dump_packet_capture().
+     *
+     * Capturing doesn't block and doesn't allocate memory, but memory for all
+     * packets is allocated when context is opened.
+     *
+     * If zero, packets are not captured.
+     */
+    unsigned int packet_capture_records;
+
+    /** Maximum number of captured bytes of each packet.
+     *
+     * Used when \c packet_capture_records is non-zero. Longer packets are
+     * truncated.
+     *
+     * If zero, default value is used (128 bytes). Maximum value is 256.
+     */
+    unsigned int packet_capture_snaplen;
 } roc_context_config;
 
 /** Sender configuration.
@@ -793,6 +1226,27 @@ typedef struct roc_sender_config {
      * If zero, default value is used (if latency tuning is enabled on sender).
      */
     unsigned long long latency_tolerance;
+
+    /** Length of write queue, in nanoseconds.
+     *
+     * If non-zero, write operation copies samples into a preallocated queue that
+     * can hold this much audio, and returns immediately. Encoding, FEC, and packet
+     * composition are then performed by a writer thread of the context, so that
+     * the write operation doesn't wait for them.
+     *
+     * Write queue can't be used with \ref ROC_CLOCK_SOURCE_INTERNAL.
+     *
+     * If zero, write queue is disabled, and write operation performs encoding
+     * in the calling thread.
+     */
+    unsigned long long write_queue_length;
+
+    /** Write queue overflow policy.
+     * Used if \c write_queue_length is non-zero.
+     *
+     * If zero, default policy is used (\ref ROC_WRITE_OVERFLOW_DEFAULT).
+     */
+    roc_write_overflow write_overflow;
 } roc_sender_config;
 
 /** Receiver configuration.
@@ -979,6 +1433,96 @@ typedef struct roc_interface_config {
      * By default, false.
      */
     int reuse_address;
+
+    /** Multicast TTL.
+     *
+     * Defines how many routers outgoing multicast packets may pass. Used only when
+     * sending to an endpoint with multicast IP address.
+     *
+     * If zero, OS default is used, which is usually 1, i.e. packets don't leave
+     * local network.
+     */
+    unsigned int multicast_ttl;
+
+    /** Disable multicast loopback.
+     *
+     * When true (non-zero), outgoing multicast packets are not looped back to
+     * sockets on the same host which joined the multicast group. Used only when
+     * sending to an endpoint with multicast IP address.
+     *
+     * By default, false.
+     */
+    int disable_multicast_loop;
+
+    /** Socket receive buffer size, in bytes.
+     *
+     * Sets SO_RCVBUF option. Larger buffer allows to absorb bursts of incoming
+     * packets while network thread is not yet woken up, instead of dropping them
+     * in kernel.
+     *
+     * OS may adjust or limit the value, e.g. Linux doubles it and caps it by
+     * net.core.rmem_max sysctl. Effective value is reported to log.
+     *
+     * If zero, OS default is used.
+     */
+    unsigned int recv_buffer_size;
+
+    /** Socket send buffer size, in bytes.
+     *
+     * Sets SO_SNDBUF option. OS may adjust or limit the value, e.g. Linux doubles
+     * it and caps it by net.core.wmem_max sysctl. Effective value is reported to log.
+     *
+     * If zero, OS default is used.
+     */
+    unsigned int send_buffer_size;
+
+    /** Kernel busy-poll duration for receiving, in nanoseconds.
+     *
+     * Sets SO_BUSY_POLL option. When there are no pending packets, reads from socket
+     * busy-poll network device queue during given time. Reduces receive latency at
+     * the cost of higher CPU usage.
+     *
+     * Supported only on Linux. Setting value higher than system default requires
+     * CAP_NET_ADMIN capability.
+     *
+     * If zero, OS default is used.
+     */
+    unsigned long long recv_busy_poll;
+
+    /** Inline receiving flag.
+     *
+     * When true (non-zero), socket is not read by network thread. Instead, receiver
+     * pipeline polls socket without blocking every time it produces a frame, and
+     * processes received packets right away on the same thread. This removes the
+     * handoff of every packet between network and pipeline threads, which is useful
+     * for latency-critical setups, but packets are read only at frame boundaries.
+     *
+     * Used only when binding receiver interface.
+     *
+     * By default, false.
+     */
+    int inline_recv;
+
+    /** DSCP value of outgoing packets.
+     *
+     * Sets upper 6 bits of IP_TOS (for IPv4) or IPV6_TCLASS (for IPv6) option.
+     * Allows network equipment to prioritize traffic. For example, 46 (Expedited
+     * Forwarding) is commonly used for real-time audio.
+     *
+     * Should be in range [0; 63]. If zero, OS default is used.
+     */
+    unsigned int dscp;
+
+    /** Priority of outgoing packets.
+     *
+     * Sets SO_PRIORITY option, which defines priority of packets in local queueing
+     * disciplines.
+     *
+     * Supported only on Linux. Values higher than 6 require CAP_NET_ADMIN capability.
+     *
+     * If zero, OS default is used.
+     */
+    int priority;
 } roc_interface_config;
 
 #ifdef __cplusplus
@@ -27,6 +27,10 @@ extern "C" {
  * to the context. It is allowed both to create a separate context for every object, or
  * to create a single context shared between multiple objects.
  *
+ * Network and control threads are started when they're needed for the first time, e.g.
+ * when a sender or receiver is connected or bound. Contexts used only by
+ * roc_sender_encoder and roc_receiver_decoder never start them.
+ *
  * **Life cycle**
  *
  * A context is created using roc_context_open() and destroyed using roc_context_close().
@@ -96,6 +100,33 @@ ROC_API int roc_context_register_encoding(roc_context* context,
                                           int encoding_id,
                                           const roc_media_encoding* encoding);
 
+/** Dump captured packets to file.
+ *
+ * Writes packets kept by in-process packet capture to a file in pcapng format,
+ * which can be opened by Wireshark or tcpdump. Each capture point (received
+ * packets, sent packets, packets after FEC decoding) is written as a separate
+ * interface, and pipeline annotations are written as packet comments.
+ *
+ * Packet capture should be enabled using \c packet_capture_records field of
+ * \ref roc_context_config.
+ *
+ * Can be called at any time from any thread. Doesn't stop capturing.
+ *
+ * **Parameters**
+ *  - \p context should point to an opened context
+ *  - \p path should be a path to output file; existing file is overwritten
+ *
+ * **Returns**
+ *  - returns zero if packets were successfully written
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if packet capture is disabled
+ *  - returns a negative value if file can't be written
+ *
+ * **Ownership**
+ *  - doesn't take or share the ownership of \p path
+ */
+ROC_API int roc_context_dump_packet_capture(roc_context* context, const char* path);
+
 /** Close the context.
  *
  * Stops any started background threads, deinitializes and deallocates the context.
@@ -46,6 +46,8 @@ extern "C" {
  *  - `rs8m://`      (\ref ROC_PROTO_RS8M_REPAIR)
  *  - `rtp+ldpc://`  (\ref ROC_PROTO_RTP_LDPC_SOURCE)
  *  - `ldpc://`      (\ref ROC_PROTO_LDPC_REPAIR)
+ *  - `rtp+rlc://`   (\ref ROC_PROTO_RTP_RLC_SOURCE)
+ *  - `rlc://`       (\ref ROC_PROTO_RLC_REPAIR)
  *
  * The host field should be either FQDN (domain name), or IPv4 address, or
  * IPv6 address in square brackets.
@@ -43,6 +43,21 @@ typedef struct roc_connection_metrics {
      * May be zero initially, until enough statistics is accumulated.
      */
     unsigned long long e2e_latency;
+
+    /** CPU time spent on connection, in nanoseconds per second.
+     *
+     * Defines how much time the pipeline thread spends processing this
+     * connection per second of wall clock time, e.g. 10000000 means 1% of
+     * one CPU core. Can be used to find out which connections are the most
+     * expensive.
+     *
+     * On receiver, covers decoding, FEC, resampling and other per-connection
+     * processing. On sender, covers encoding of the stream which is shared by
+     * all connections of the slot, so all of them report the same value.
+     *
+     * Zero initially, until enough statistics is accumulated.
+     */
+    unsigned long long cpu_ns_per_sec;
 } roc_connection_metrics;
 
 /** Receiver metrics.
@@ -78,6 +93,28 @@ typedef struct roc_sender_metrics {
      * connections, one per each discovered receiver.
      */
     unsigned int connection_count;
+
+    /** Current length of write queue, in nanoseconds.
+     *
+     * Defines how much written audio is not yet encoded.
+     * Zero if write queue is disabled.
+     */
+    unsigned long long write_queue_length;
+
+    /** Maximum length of write queue, in nanoseconds.
+     *
+     * Defines the largest \c write_queue_length since sender was opened.
+     * If it approaches \c write_queue_length from \ref roc_sender_config,
+     * the queue is close to overflow.
+     */
+    unsigned long long write_queue_peak;
+
+    /** Total duration of discarded audio, in nanoseconds.
+     *
+     * Defines how much audio was dropped or overwritten because write queue
+     * was full. Always zero with \ref ROC_WRITE_OVERFLOW_BLOCK.
+     */
+    unsigned long long write_queue_dropped;
 } roc_sender_metrics;
 
 #ifdef __cplusplus
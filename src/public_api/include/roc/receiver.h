@@ -284,6 +284,74 @@ ROC_API int roc_receiver_bind(roc_receiver* receiver,
                               roc_interface iface,
                               roc_endpoint* endpoint);
 
+/** Receiver interface binding.
+ *
+ * Describes one interface to be configured and bound by roc_receiver_bind_many().
+ */
+typedef struct roc_receiver_binding {
+    /** Receiver slot.
+     *
+     * If in doubt, use \c ROC_SLOT_DEFAULT.
+     */
+    roc_slot slot;
+
+    /** Receiver interface.
+     */
+    roc_interface iface;
+
+    /** Interface configuration.
+     *
+     * Optional. If non-NULL, has the same effect as calling roc_receiver_configure()
+     * before binding. If NULL, configuration is left unchanged.
+     */
+    const roc_interface_config* config;
+
+    /** Local endpoint.
+     *
+     * Same as endpoint passed to roc_receiver_bind(). If it has zero port, the
+     * actual port is written back to it.
+     */
+    roc_endpoint* endpoint;
+} roc_receiver_binding;
+
+/** Configure and bind multiple receiver interfaces at once.
+ *
+ * Has the same effect as calling roc_receiver_configure() and roc_receiver_bind()
+ * for every element of \p bindings, but much faster when there are many of them.
+ * Instead of scheduling and waiting separate tasks for every interface, receiver
+ * submits each step (resolving addresses, creating slots, opening ports, adding
+ * endpoints, starting receiving) for all interfaces together, and waits for the
+ * whole batch only once. This is useful to provision a receiver with hundreds of
+ * slots without stalling pipeline with a burst of separate tasks.
+ *
+ * Automatically initializes slots with given indices if they're used first time.
+ *
+ * If an error happens during binding of some interface, its whole slot is disabled
+ * and marked broken, like in roc_receiver_bind(). Other slots are not affected.
+ * The user is responsible for removing broken slots using roc_receiver_unlink().
+ *
+ * **Parameters**
+ *  - \p receiver should point to an opened receiver
+ *  - \p bindings should point to an array of bindings; each binding should specify
+ *    slot, interface, and endpoint, and optionally interface config
+ *  - \p n_bindings defines number of elements in \p bindings
+ *
+ * **Returns**
+ *  - returns zero if all interfaces were successfully bound
+ *  - returns a negative value if the arguments are invalid; in this case, no
+ *    interfaces are bound
+ *  - returns a negative value if some interfaces can't be bound; in this case,
+ *    other interfaces remain bound
+ *  - returns a negative value on resource allocation failure
+ *
+ * **Ownership**
+ *  - doesn't take or share the ownership of \p bindings and objects referenced
+ *    from them; they may be safely deallocated after the function returns
+ */
+ROC_API int roc_receiver_bind_many(roc_receiver* receiver,
+                                   const roc_receiver_binding* bindings,
+                                   size_t n_bindings);
+
 /** Query receiver slot metrics.
  *
  * Reads metrics into provided structs.
@@ -357,6 +425,10 @@ ROC_API int roc_receiver_unlink(roc_receiver* receiver, roc_slot slot);
  *  - \p receiver should point to an opened receiver
  *  - \p frame should point to an initialized frame; it should contain pointer to
  *    a buffer and it's size; the buffer is fully filled with data from receiver
+ *  - size of \p frame may be different on every call and is not required to match
+ *    packet size; it should be a multiple of the number of channels multiplied by
+ *    sample size; exactly requested number of samples is produced, without
+ *    buffering or re-framing on receiver side
  *
  * **Returns**
  *  - returns zero if all samples were successfully decoded
@@ -366,6 +438,10 @@ ROC_API int roc_receiver_unlink(roc_receiver* receiver, roc_slot slot);
  * **Ownership**
  *  - doesn't take or share the ownership of \p frame; it may be safely deallocated
  *    after the function returns
+ *  - the samples buffer is lent to the receiver only for the duration of the call;
+ *    samples are written directly into it by the pipeline, without intermediate
+ *    copying, so the user can pass the final destination buffer instead of copying
+ *    samples from a temporary one
  */
 ROC_API int roc_receiver_read(roc_receiver* receiver, roc_frame* frame);
 
@@ -48,7 +48,8 @@ extern "C" {
  *   and control packets).
  *
  * - The per-interface streams of encoded packets are iteratively pushed to the decoder
- *   using roc_receiver_decoder_push_packet().
+ *   using roc_receiver_decoder_push_packet() or, in batches, using
+ *   roc_receiver_decoder_push_packets().
  *
  * - The audio stream is iteratively popped from the decoder using
  *   roc_receiver_decoder_pop_frame(). User should push all available packets to all
@@ -88,7 +89,8 @@ extern "C" {
  *
  * **Thread safety**
  *
- * Can be used concurrently.
+ * Can be used concurrently. Packets may be pushed from any number of threads at the
+ * same time; pushing doesn't take locks and doesn't block frame decoding.
  */
 typedef struct roc_receiver_decoder roc_receiver_decoder;
 
@@ -176,6 +178,10 @@ ROC_API int roc_receiver_decoder_query(roc_receiver_decoder* decoder,
  * The user should iteratively push all delivered packets to appropriate interfaces. They
  * will be later consumed by roc_receiver_decoder_pop_frame().
  *
+ * May be called from multiple threads concurrently with each other and with
+ * roc_receiver_decoder_pop_frame(). Packet is added to a lock-free queue, which is
+ * drained by the next roc_receiver_decoder_pop_frame().
+ *
  * **Parameters**
  *  - \p decoder should point to an opened decoder
  *  - \p packet should point to an initialized packet; it should contain pointer to
@@ -196,6 +202,37 @@ ROC_API int roc_receiver_decoder_push_packet(roc_receiver_decoder* decoder,
                                              roc_interface iface,
                                              const roc_packet* packet);
 
+/** Write multiple packets to decoder.
+ *
+ * Same as roc_receiver_decoder_push_packet(), but adds a batch of packets to the
+ * interface queue at once. Interface lookup is performed only once per batch, which
+ * reduces per-packet overhead when many packets are delivered at the same time.
+ *
+ * **Parameters**
+ *  - \p decoder should point to an opened decoder
+ *  - \p packets should point to an array of initialized packets; each packet should
+ *    contain pointer to a buffer and it's size; buffers are fully copied into decoder
+ *  - \p n_packets should point to the number of packets in \p packets array;
+ *    it is updated with the number of packets actually written to decoder
+ *
+ * **Returns**
+ *  - returns zero if all packets were successfully copied to decoder
+ *  - returns a negative value if some packets were not copied; in this case,
+ *    \p n_packets is set to the number of leading packets that were copied
+ *  - returns a negative value if the interface is not activated
+ *  - returns a negative value if the buffer size of some packet is too large
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value on resource allocation failure
+ *
+ * **Ownership**
+ *  - doesn't take or share the ownership of \p packets; they may be safely
+ *    deallocated after the function returns
+ */
+ROC_API int roc_receiver_decoder_push_packets(roc_receiver_decoder* decoder,
+                                              roc_interface iface,
+                                              const roc_packet* packets,
+                                              size_t* n_packets);
+
 /** Read feedback packet from decoder.
  *
  * Removes encoded feedback packet from control interface queue and returns it
@@ -242,6 +279,10 @@ ROC_API int roc_receiver_decoder_pop_feedback_packet(roc_receiver_decoder* decod
  *  - \p decoder should point to an opened decoder
  *  - \p frame should point to an initialized frame; it should contain pointer to
  *    a buffer and it's size; the buffer is fully filled with data from decoder
+ *  - size of \p frame may be different on every call and is not required to match
+ *    packet size; it should be a multiple of the number of channels multiplied by
+ *    sample size; exactly requested number of samples is produced, without
+ *    buffering or re-framing on receiver side
  *
  * **Returns**
  *  - returns zero if all samples were successfully decoded
@@ -251,6 +292,10 @@ ROC_API int roc_receiver_decoder_pop_feedback_packet(roc_receiver_decoder* decod
  * **Ownership**
  *  - doesn't take or share the ownership of \p frame; it may be safely deallocated
  *    after the function returns
+ *  - the samples buffer is lent to the decoder only for the duration of the call;
+ *    samples are written directly into it by the pipeline, without intermediate
+ *    copying, so the user can pass the final destination buffer instead of copying
+ *    samples from a temporary one
  */
 ROC_API int roc_receiver_decoder_pop_frame(roc_receiver_decoder* decoder,
                                            roc_frame* frame);
@@ -323,6 +323,11 @@ ROC_API int roc_sender_unlink(roc_sender* sender, roc_slot slot);
  * after encoding and enqueuing the packets, without waiting when the packets are actually
  * transmitted.
  *
+ * If write queue is enabled (see \c write_queue_length in \ref roc_sender_config),
+ * the function only copies samples to the queue and returns, and encoding is done
+ * later by a writer thread of the context. When the queue is full, the function
+ * blocks or discards samples, depending on \c write_overflow.
+ *
  * Until the sender is connected to at least one receiver, the stream is just dropped.
  * If the sender is connected to multiple receivers, the stream is duplicated to
  * each of them.
@@ -330,7 +335,8 @@ ROC_API int roc_sender_unlink(roc_sender* sender, roc_slot slot);
  * **Parameters**
  *  - \p sender should point to an opened sender
  *  - \p frame should point to an initialized frame; it should contain pointer to
- *    a buffer and it's size; the buffer is fully copied into the sender
+ *    a buffer and it's size; if write queue is disabled, the buffer is read in place
+ *    before the function returns, otherwise it's copied into the queue
  *
  * **Returns**
  *  - returns zero if all samples were successfully encoded and enqueued
@@ -343,6 +349,55 @@ ROC_API int roc_sender_unlink(roc_sender* sender, roc_slot slot);
  */
 ROC_API int roc_sender_write(roc_sender* sender, const roc_frame* frame);
 
+/** Frame release handler.
+ *
+ * **Parameters**
+ *  - \p argument is the argument passed to roc_sender_write_ref()
+ *
+ * \see roc_sender_write_ref
+ */
+typedef void (*roc_frame_release_handler)(void* argument);
+
+/** Encode samples to packets and transmit them to receiver, without copying.
+ *
+ * Same as roc_sender_write(), but the sender doesn't copy samples into write queue.
+ * Instead, it keeps reference to the samples buffer until they're encoded, and then
+ * invokes \p handler with \p argument. The user should not modify or deallocate the
+ * buffer until then.
+ *
+ * If write queue is disabled, samples are encoded before the function returns, and
+ * \p handler is invoked before the function returns too.
+ *
+ * If write queue is enabled, \p handler is invoked later from writer thread of the
+ * context. Frames written by reference and by roc_sender_write() are encoded in the
+ * order in which they were written. Frames written by reference are never discarded
+ * on queue overflow; instead, if there are too many frames waiting for encoding, the
+ * function blocks if \c write_overflow is \ref ROC_WRITE_OVERFLOW_BLOCK, and fails
+ * otherwise.
+ *
+ * **Parameters**
+ *  - \p sender should point to an opened sender
+ *  - \p frame should point to an initialized frame; it should contain pointer to
+ *    a buffer and it's size; the buffer is not copied
+ *  - \p handler should point to a function invoked when the buffer is released
+ *  - \p argument will be passed to \p handler
+ *
+ * **Returns**
+ *  - returns zero if the frame was accepted; \p handler will be invoked exactly once
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if too many frames are waiting for encoding
+ *  - if a negative value is returned, \p handler is not invoked
+ *
+ * **Ownership**
+ *  - doesn't take ownership of \p frame, but shares ownership of its samples buffer
+ *    until \p handler is invoked; the \p frame struct itself may be safely
+ *    deallocated after the function returns
+ */
+ROC_API int roc_sender_write_ref(roc_sender* sender,
+                                 const roc_frame* frame,
+                                 roc_frame_release_handler handler,
+                                 void* argument);
+
 /** Close the sender.
  *
  * Deinitializes and deallocates the sender, and detaches it from the context. The user
@@ -51,8 +51,9 @@ extern "C" {
  *   accumulates them in internal queue.
  *
  * - The packet stream is iteratively popped from the encoder internal queue using
- *   roc_sender_encoder_pop_packet(). User should retrieve all available packets from all
- *   activated interfaces every time after pushing a frame.
+ *   roc_sender_encoder_pop_packet() or, in batches, using
+ *   roc_sender_encoder_pop_packets(). User should retrieve all available packets from
+ *   all activated interfaces every time after pushing a frame.
  *
  * - User is responsible for delivering packets to \ref roc_receiver_decoder and pushing
  *   them to appropriate interfaces of decoder.
@@ -182,7 +183,8 @@ ROC_API int roc_sender_encoder_query(roc_sender_encoder* encoder,
  * **Parameters**
  *  - \p encoder should point to an opened encoder
  *  - \p frame should point to an initialized frame; it should contain pointer to
- *    a buffer and it's size; the buffer is fully copied into encoder
+ *    a buffer and it's size; the buffer is read in place and is not used after the
+ *    function returns
  *
  * **Returns**
  *  - returns zero if all samples were successfully encoded and enqueued
@@ -253,6 +255,38 @@ ROC_API int roc_sender_encoder_pop_packet(roc_sender_encoder* encoder,
                                           roc_interface iface,
                                           roc_packet* packet);
 
+/** Read multiple packets from encoder.
+ *
+ * Same as roc_sender_encoder_pop_packet(), but removes a batch of encoded packets
+ * from the interface queue at once. Interface lookup and queue locking are performed
+ * only once per batch, which reduces per-packet overhead.
+ *
+ * **Parameters**
+ *  - \p encoder should point to an opened encoder
+ *  - \p packets should point to an array of initialized packets; each packet should
+ *    contain pointer to a buffer and it's size; packet bytes are copied to user's
+ *    buffers and the size fields are updated with the actual packet sizes
+ *  - \p n_packets should point to the number of packets in \p packets array;
+ *    it is updated with the number of packets actually read from encoder
+ *
+ * **Returns**
+ *  - returns zero if at least one packet was successfully copied from encoder
+ *  - returns a negative value if there are no more packets for this interface
+ *  - returns a negative value if the interface is not activated
+ *  - returns a negative value if the buffer size of some packet is too small;
+ *    packets removed from the queue but not copied are dropped, hence each
+ *    buffer should be large enough to hold a packet of maximum size
+ *  - returns a negative value if the arguments are invalid
+ *
+ * **Ownership**
+ *  - doesn't take or share the ownership of \p packets; they may be safely
+ *    deallocated after the function returns
+ */
+ROC_API int roc_sender_encoder_pop_packets(roc_sender_encoder* encoder,
+                                           roc_interface iface,
+                                           roc_packet* packets,
+                                           size_t* n_packets);
+
 /** Close encoder.
  *
  * Deinitializes and deallocates the encoder, and detaches it from the context. The user
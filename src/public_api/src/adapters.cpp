@@ -49,6 +49,121 @@ bool context_config_from_user(node::ContextConfig& out, const roc_context_config
         out.max_frame_size = in.max_frame_size;
     }
 
+    if (in.network_threads != 0) {
+        out.network_threads = in.network_threads;
+    }
+
+    if (!thread_config_from_user(out.network_thread, in.network_thread)) {
+        roc_log(LogError, "bad configuration: invalid roc_context_config.network_thread");
+        return false;
+    }
+
+    if (!thread_config_from_user(out.control_thread, in.control_thread)) {
+        roc_log(LogError, "bad configuration: invalid roc_context_config.control_thread");
+        return false;
+    }
+
+    out.shared_runtime = (in.shared_runtime != 0);
+
+    out.numa_nodes = (uint64_t)in.numa_nodes;
+
+    out.prealloc_packets = in.prealloc_packets;
+    out.prealloc_frames = in.prealloc_frames;
+
+    if (in.max_packets != 0 && in.prealloc_packets > in.max_packets) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_context_config.max_packets:"
+                " should be zero or not less than prealloc_packets");
+        return false;
+    }
+
+    out.max_packets = in.max_packets;
+
+    if (in.max_frames != 0 && in.prealloc_frames > in.max_frames) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_context_config.max_frames:"
+                " should be zero or not less than prealloc_frames");
+        return false;
+    }
+
+    out.max_frames = in.max_frames;
+
+    out.node_memory_limit = (size_t)in.node_memory_limit;
+
+    out.realtime = (in.realtime_mode != 0);
+
+    if (in.resolver_cache_size != 0) {
+        out.resolver.cache_size = in.resolver_cache_size;
+    }
+
+    if (in.resolver_cache_ttl != 0) {
+        out.resolver.cache_ttl = in.resolver_cache_ttl;
+    }
+
+    if (in.resolver_negative_cache_ttl != 0) {
+        out.resolver.negative_cache_ttl = in.resolver_negative_cache_ttl;
+    }
+
+    if (!media_clock_from_user(out.media_clock, in.media_clock)) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_context_config.media_clock:"
+                " should be valid enum value");
+        return false;
+    }
+
+    if (in.packet_capture_snaplen > packet::CaptureRecord::MaxSnapLen) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_context_config.packet_capture_snaplen:"
+                " should be in range [0; %u]",
+                (unsigned)packet::CaptureRecord::MaxSnapLen);
+        return false;
+    }
+
+    out.packet_capture.num_records = in.packet_capture_records;
+
+    if (in.packet_capture_snaplen != 0) {
+        out.packet_capture.snap_len = in.packet_capture_snaplen;
+    }
+
+    if (out.media_clock == core::MediaClock_Ptp && !in.ptp_device) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_context_config.ptp_device:"
+                " should be set when media_clock is ROC_MEDIA_CLOCK_PTP");
+        return false;
+    }
+
+    out.ptp_device = in.ptp_device;
+
+    return true;
+}
+
+ROC_ATTR_NO_SANITIZE_UB
+bool thread_config_from_user(core::ThreadConfig& out, const roc_thread_config& in) {
+    out.cpu_mask = (uint64_t)in.cpu_mask;
+
+    if (!thread_policy_from_user(out.policy, in.policy)) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_thread_config.policy:"
+                " should be valid enum value");
+        return false;
+    }
+
+    if (in.priority < 0) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_thread_config.priority:"
+                " should be zero or positive");
+        return false;
+    }
+
+    if (in.priority != 0 && out.policy == core::ThreadPolicy_Default) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_thread_config.priority:"
+                " should be zero when policy is ROC_THREAD_POLICY_DEFAULT");
+        return false;
+    }
+
+    out.priority = in.priority;
+
     return true;
 }
 
@@ -160,6 +275,35 @@ bool sender_config_from_user(node::Context& context,
     return true;
 }
 
+ROC_ATTR_NO_SANITIZE_UB
+bool sender_async_config_from_user(node::AsyncSinkConfig& out,
+                                   const roc_sender_config& in) {
+    out.queue_length = (core::nanoseconds_t)in.write_queue_length;
+
+    if (out.queue_length < 0) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_sender_config.write_queue_length:"
+                " should be less than 2^63");
+        return false;
+    }
+
+    if (out.queue_length != 0 && in.clock_source == ROC_CLOCK_SOURCE_INTERNAL) {
+        roc_log(LogError,
+                "bad configuration: roc_sender_config.write_queue_length can't be"
+                " used with ROC_CLOCK_SOURCE_INTERNAL");
+        return false;
+    }
+
+    if (!write_overflow_from_user(out.overflow_policy, in.write_overflow)) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_sender_config.write_overflow:"
+                " should be valid enum value");
+        return false;
+    }
+
+    return true;
+}
+
 ROC_ATTR_NO_SANITIZE_UB
 bool receiver_config_from_user(node::Context&,
                                pipeline::ReceiverSourceConfig& out,
@@ -267,6 +411,40 @@ ROC_ATTR_NO_SANITIZE_UB bool interface_config_from_user(netio::UdpConfig& out,
 
     out.enable_reuseaddr = (in.reuse_address != 0);
 
+    if (in.multicast_ttl > 255) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_interface_config.multicast_ttl:"
+                " should be in range [0; 255]");
+        return false;
+    }
+
+    out.multicast_ttl = in.multicast_ttl;
+    out.enable_multicast_loop = (in.disable_multicast_loop == 0);
+
+    out.recv_buffer_size = in.recv_buffer_size;
+    out.send_buffer_size = in.send_buffer_size;
+
+    out.recv_busy_poll = (core::nanoseconds_t)in.recv_busy_poll;
+    out.enable_inline_recv = (in.inline_recv != 0);
+
+    if (in.dscp > 63) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_interface_config.dscp:"
+                " should be in range [0; 63]");
+        return false;
+    }
+
+    out.dscp = in.dscp;
+
+    if (in.priority < 0) {
+        roc_log(LogError,
+                "bad configuration: invalid roc_interface_config.priority:"
+                " should be >= 0");
+        return false;
+    }
+
+    out.priority = in.priority;
+
     return true;
 }
 
@@ -390,6 +568,46 @@ bool clock_source_from_user(bool& out_timing, roc_clock_source in) {
     return false;
 }
 
+ROC_ATTR_NO_SANITIZE_UB
+bool write_overflow_from_user(node::AsyncOverflowPolicy& out, roc_write_overflow in) {
+    switch (enum_from_user(in)) {
+    case ROC_WRITE_OVERFLOW_DEFAULT:
+    case ROC_WRITE_OVERFLOW_BLOCK:
+        out = node::AsyncOverflow_Block;
+        return true;
+
+    case ROC_WRITE_OVERFLOW_DROP:
+        out = node::AsyncOverflow_Drop;
+        return true;
+
+    case ROC_WRITE_OVERFLOW_OVERWRITE:
+        out = node::AsyncOverflow_Overwrite;
+        return true;
+    }
+
+    return false;
+}
+
+ROC_ATTR_NO_SANITIZE_UB
+bool media_clock_from_user(core::MediaClockSource& out, roc_media_clock in) {
+    switch (enum_from_user(in)) {
+    case ROC_MEDIA_CLOCK_DEFAULT:
+    case ROC_MEDIA_CLOCK_SYSTEM:
+        out = core::MediaClock_System;
+        return true;
+
+    case ROC_MEDIA_CLOCK_TAI:
+        out = core::MediaClock_Tai;
+        return true;
+
+    case ROC_MEDIA_CLOCK_PTP:
+        out = core::MediaClock_Ptp;
+        return true;
+    }
+
+    return false;
+}
+
 ROC_ATTR_NO_SANITIZE_UB
 bool latency_tuner_backend_from_user(audio::LatencyTunerBackend& out,
                                      roc_latency_tuner_backend in) {
@@ -448,6 +666,14 @@ bool resampler_backend_from_user(audio::ResamplerBackend& out, roc_resampler_bac
     case ROC_RESAMPLER_BACKEND_SPEEXDEC:
         out = audio::ResamplerBackend_SpeexDec;
         return true;
+
+    case ROC_RESAMPLER_BACKEND_BUILTIN_FIXED:
+        out = audio::ResamplerBackend_BuiltinFixed;
+        return true;
+
+    case ROC_RESAMPLER_BACKEND_BUILTIN_POLYPHASE:
+        out = audio::ResamplerBackend_BuiltinPolyphase;
+        return true;
     }
 
     return false;
@@ -473,6 +699,25 @@ bool resampler_profile_from_user(audio::ResamplerProfile& out, roc_resampler_pro
     return false;
 }
 
+ROC_ATTR_NO_SANITIZE_UB
+bool thread_policy_from_user(core::ThreadPolicy& out, roc_thread_policy in) {
+    switch (enum_from_user(in)) {
+    case ROC_THREAD_POLICY_DEFAULT:
+        out = core::ThreadPolicy_Default;
+        return true;
+
+    case ROC_THREAD_POLICY_FIFO:
+        out = core::ThreadPolicy_Fifo;
+        return true;
+
+    case ROC_THREAD_POLICY_RR:
+        out = core::ThreadPolicy_RoundRobin;
+        return true;
+    }
+
+    return false;
+}
+
 ROC_ATTR_NO_SANITIZE_UB
 bool packet_encoding_from_user(unsigned& out_pt, roc_packet_encoding in) {
     switch (enum_from_user(in)) {
@@ -504,6 +749,10 @@ bool fec_encoding_from_user(packet::FecScheme& out, roc_fec_encoding in) {
     case ROC_FEC_ENCODING_LDPC_STAIRCASE:
         out = packet::FEC_LDPC_Staircase;
         return true;
+
+    case ROC_FEC_ENCODING_RLC:
+        out = packet::FEC_RLC;
+        return true;
     }
 
     return false;
@@ -543,6 +792,10 @@ bool proto_from_user(address::Protocol& out, const roc_protocol& in) {
         out = address::Proto_RTP;
         return true;
 
+    case ROC_PROTO_RTP_SHM:
+        out = address::Proto_RTP_Shm;
+        return true;
+
     case ROC_PROTO_RTP_RS8M_SOURCE:
         out = address::Proto_RTP_RS8M_Source;
         return true;
@@ -559,6 +812,14 @@ bool proto_from_user(address::Protocol& out, const roc_protocol& in) {
         out = address::Proto_LDPC_Repair;
         return true;
 
+    case ROC_PROTO_RTP_RLC_SOURCE:
+        out = address::Proto_RTP_RLC_Source;
+        return true;
+
+    case ROC_PROTO_RLC_REPAIR:
+        out = address::Proto_RLC_Repair;
+        return true;
+
     case ROC_PROTO_RTCP:
         out = address::Proto_RTCP;
         return true;
@@ -577,6 +838,10 @@ bool proto_to_user(roc_protocol& out, address::Protocol in) {
         out = ROC_PROTO_RTP;
         return true;
 
+    case address::Proto_RTP_Shm:
+        out = ROC_PROTO_RTP_SHM;
+        return true;
+
     case address::Proto_RTP_RS8M_Source:
         out = ROC_PROTO_RTP_RS8M_SOURCE;
         return true;
@@ -593,10 +858,19 @@ bool proto_to_user(roc_protocol& out, address::Protocol in) {
         out = ROC_PROTO_LDPC_REPAIR;
         return true;
 
+    case address::Proto_RTP_RLC_Source:
+        out = ROC_PROTO_RTP_RLC_SOURCE;
+        return true;
+
+    case address::Proto_RLC_Repair:
+        out = ROC_PROTO_RLC_REPAIR;
+        return true;
+
     case address::Proto_RTCP:
         out = ROC_PROTO_RTCP;
         return true;
 
+    case address::Proto_SRTP:
     case address::Proto_None:
         break;
     }
@@ -626,6 +900,10 @@ void receiver_participant_metrics_to_user(
     if (party_metrics.latency.e2e_latency > 0) {
         out.e2e_latency = (unsigned long long)party_metrics.latency.e2e_latency;
     }
+
+    if (party_metrics.cpu_ns_per_sec > 0) {
+        out.cpu_ns_per_sec = (unsigned long long)party_metrics.cpu_ns_per_sec;
+    }
 }
 
 ROC_ATTR_NO_SANITIZE_UB
@@ -638,6 +916,13 @@ void sender_slot_metrics_to_user(const pipeline::SenderSlotMetrics& slot_metrics
     out.connection_count = (unsigned)slot_metrics.num_participants;
 }
 
+void sender_async_metrics_to_user(roc_sender_metrics& out,
+                                  const node::AsyncSinkMetrics& in) {
+    out.write_queue_length = (unsigned long long)in.queue_length;
+    out.write_queue_peak = (unsigned long long)in.peak_queue_length;
+    out.write_queue_dropped = (unsigned long long)in.dropped_length;
+}
+
 ROC_ATTR_NO_SANITIZE_UB
 void sender_participant_metrics_to_user(
     const pipeline::SenderParticipantMetrics& party_metrics,
@@ -650,6 +935,10 @@ void sender_participant_metrics_to_user(
     if (party_metrics.latency.e2e_latency > 0) {
         out.e2e_latency = (unsigned long long)party_metrics.latency.e2e_latency;
     }
+
+    if (party_metrics.cpu_ns_per_sec > 0) {
+        out.cpu_ns_per_sec = (unsigned long long)party_metrics.cpu_ns_per_sec;
+    }
 }
 
 ROC_ATTR_NO_SANITIZE_UB
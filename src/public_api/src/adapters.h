@@ -23,6 +23,8 @@ namespace api {
 
 bool context_config_from_user(node::ContextConfig& out, const roc_context_config& in);
 
+bool thread_config_from_user(core::ThreadConfig& out, const roc_thread_config& in);
+
 bool sender_config_from_user(node::Context& context,
                              pipeline::SenderSinkConfig& out,
                              const roc_sender_config& in);
@@ -43,7 +45,12 @@ bool channel_set_from_user(audio::ChannelSet& out,
                            roc_channel_layout in,
                            unsigned int in_tracks);
 
+bool sender_async_config_from_user(node::AsyncSinkConfig& out,
+                                   const roc_sender_config& in);
+
 bool clock_source_from_user(bool& out_timing, roc_clock_source in);
+bool write_overflow_from_user(node::AsyncOverflowPolicy& out, roc_write_overflow in);
+bool media_clock_from_user(core::MediaClockSource& out, roc_media_clock in);
 
 bool latency_tuner_backend_from_user(audio::LatencyTunerBackend& out,
                                      roc_latency_tuner_backend in);
@@ -53,6 +60,8 @@ bool latency_tuner_profile_from_user(audio::LatencyTunerProfile& out,
 bool resampler_backend_from_user(audio::ResamplerBackend& out, roc_resampler_backend in);
 bool resampler_profile_from_user(audio::ResamplerProfile& out, roc_resampler_profile in);
 
+bool thread_policy_from_user(core::ThreadPolicy& out, roc_thread_policy in);
+
 bool packet_encoding_from_user(unsigned& out_pt, roc_packet_encoding in);
 bool fec_encoding_from_user(packet::FecScheme& out, roc_fec_encoding in);
 
@@ -70,6 +79,8 @@ void receiver_participant_metrics_to_user(
 
 void sender_slot_metrics_to_user(const pipeline::SenderSlotMetrics& slot_metrics,
                                  void* slot_arg);
+void sender_async_metrics_to_user(roc_sender_metrics& out,
+                                  const node::AsyncSinkMetrics& in);
 void sender_participant_metrics_to_user(
     const pipeline::SenderParticipantMetrics& party_metrics,
     size_t party_index,
@@ -102,6 +102,29 @@ int roc_context_register_encoding(roc_context* context,
     return 0;
 }
 
+int roc_context_dump_packet_capture(roc_context* context, const char* path) {
+    if (!context) {
+        roc_log(LogError,
+                "roc_context_dump_packet_capture(): invalid arguments: context is null");
+        return -1;
+    }
+
+    if (!path) {
+        roc_log(LogError,
+                "roc_context_dump_packet_capture(): invalid arguments: path is null");
+        return -1;
+    }
+
+    node::Context* imp_context = (node::Context*)context;
+
+    if (!imp_context->dump_packet_capture(path)) {
+        roc_log(LogError, "roc_context_dump_packet_capture(): can't dump packets");
+        return -1;
+    }
+
+    return 0;
+}
+
 int roc_context_close(roc_context* context) {
     if (!context) {
         roc_log(LogError, "roc_context_close(): invalid arguments: context is null");
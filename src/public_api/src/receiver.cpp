@@ -9,7 +9,9 @@
 #include "roc/receiver.h"
 
 #include "adapters.h"
+#include "arena.h"
 
+#include "roc_core/array.h"
 #include "roc_core/log.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_node/receiver.h"
@@ -131,6 +133,78 @@ int roc_receiver_bind(roc_receiver* receiver,
     return 0;
 }
 
+int roc_receiver_bind_many(roc_receiver* receiver,
+                           const roc_receiver_binding* bindings,
+                           size_t n_bindings) {
+    if (!receiver) {
+        roc_log(LogError,
+                "roc_receiver_bind_many(): invalid arguments: receiver is null");
+        return -1;
+    }
+
+    node::Receiver* imp_receiver = (node::Receiver*)receiver;
+
+    if (!bindings && n_bindings != 0) {
+        roc_log(LogError,
+                "roc_receiver_bind_many(): invalid arguments: bindings is null");
+        return -1;
+    }
+
+    if (n_bindings == 0) {
+        return 0;
+    }
+
+    core::Array<node::Receiver::Binding> imp_bindings(api::default_arena);
+    core::Array<netio::UdpConfig> imp_configs(api::default_arena);
+
+    if (!imp_bindings.resize(n_bindings) || !imp_configs.resize(n_bindings)) {
+        roc_log(LogError, "roc_receiver_bind_many(): can't allocate bindings");
+        return -1;
+    }
+
+    for (size_t i = 0; i < n_bindings; i++) {
+        node::Receiver::Binding& imp_binding = imp_bindings[i];
+
+        imp_binding.slot_index = bindings[i].slot;
+
+        if (!api::interface_from_user(imp_binding.iface, bindings[i].iface)) {
+            roc_log(LogError,
+                    "roc_receiver_bind_many(): invalid arguments:"
+                    " bad interface in binding %lu",
+                    (unsigned long)i);
+            return -1;
+        }
+
+        if (bindings[i].config) {
+            if (!api::interface_config_from_user(imp_configs[i], *bindings[i].config)) {
+                roc_log(LogError,
+                        "roc_receiver_bind_many(): invalid arguments:"
+                        " bad config in binding %lu",
+                        (unsigned long)i);
+                return -1;
+            }
+            imp_binding.config = &imp_configs[i];
+        }
+
+        if (!bindings[i].endpoint) {
+            roc_log(LogError,
+                    "roc_receiver_bind_many(): invalid arguments:"
+                    " endpoint is null in binding %lu",
+                    (unsigned long)i);
+            return -1;
+        }
+
+        imp_binding.uri = (address::EndpointUri*)bindings[i].endpoint;
+    }
+
+    if (!imp_receiver->bind_many(imp_bindings.data(), imp_bindings.size())) {
+        roc_log(LogError, "roc_receiver_bind_many(): operation failed");
+        return -1;
+    }
+
+    return 0;
+}
+
 int roc_receiver_unlink(roc_receiver* receiver, roc_slot slot) {
     if (!receiver) {
         roc_log(LogError, "roc_receiver_unlink(): invalid arguments: receiver is null");
@@ -223,6 +223,136 @@ int roc_receiver_decoder_push_packet(roc_receiver_decoder* decoder,
     return 0;
 }
 
+int roc_receiver_decoder_push_packets(roc_receiver_decoder* decoder,
+                                      roc_interface iface,
+                                      const roc_packet* packets,
+                                      size_t* n_packets) {
+    if (!decoder) {
+        roc_log(LogError,
+                "roc_receiver_decoder_push_packets(): invalid arguments:"
+                " decoder is null");
+        return -1;
+    }
+
+    node::ReceiverDecoder* imp_decoder = (node::ReceiverDecoder*)decoder;
+
+    address::Interface imp_iface;
+    if (!api::interface_from_user(imp_iface, iface)) {
+        roc_log(LogError,
+                "roc_receiver_decoder_push_packets(): invalid arguments:"
+                " bad interface");
+        return -1;
+    }
+
+    if (!n_packets) {
+        roc_log(LogError,
+                "roc_receiver_decoder_push_packets(): invalid arguments:"
+                " packet count is null");
+        return -1;
+    }
+
+    const size_t total_packets = *n_packets;
+    *n_packets = 0;
+
+    if (total_packets != 0 && !packets) {
+        roc_log(LogError,
+                "roc_receiver_decoder_push_packets(): invalid arguments:"
+                " packets array is null");
+        return -1;
+    }
+
+    for (size_t n = 0; n < total_packets; n++) {
+        if (!packets[n].bytes) {
+            roc_log(LogError,
+                    "roc_receiver_decoder_push_packets(): invalid arguments:"
+                    " packet bytes buffer is null: index=%lu",
+                    (unsigned long)n);
+            return -1;
+        }
+
+        if (packets[n].bytes_size == 0) {
+            roc_log(LogError,
+                    "roc_receiver_decoder_push_packets(): invalid arguments:"
+                    " packet bytes count is zero: index=%lu",
+                    (unsigned long)n);
+            return -1;
+        }
+    }
+
+    enum { MaxBatch = 32 };
+
+    packet::PacketPtr imp_packets[MaxBatch];
+
+    while (*n_packets < total_packets) {
+        size_t batch_size = 0;
+
+        while (batch_size < MaxBatch && *n_packets + batch_size < total_packets) {
+            const roc_packet& packet = packets[*n_packets + batch_size];
+
+            core::BufferPtr imp_buffer =
+                imp_decoder->packet_factory().new_packet_buffer();
+            if (!imp_buffer) {
+                roc_log(LogError,
+                        "roc_receiver_decoder_push_packets():"
+                        " can't allocate buffer of requested size");
+                break;
+            }
+
+            if (imp_buffer->size() < packet.bytes_size) {
+                roc_log(LogError,
+                        "roc_receiver_decoder_push_packets():"
+                        " provided packet exceeds maximum packet size"
+                        " (see roc_context_config): provided=%lu maximum=%lu",
+                        (unsigned long)packet.bytes_size,
+                        (unsigned long)imp_buffer->size());
+                break;
+            }
+
+            core::Slice<uint8_t> imp_slice(*imp_buffer, 0, packet.bytes_size);
+            memcpy(imp_slice.data(), packet.bytes, packet.bytes_size);
+
+            packet::PacketPtr imp_packet = imp_decoder->packet_factory().new_packet();
+            if (!imp_packet) {
+                roc_log(LogError,
+                        "roc_receiver_decoder_push_packets():"
+                        " can't allocate packet");
+                break;
+            }
+
+            imp_packet->add_flags(packet::Packet::FlagUDP);
+            imp_packet->set_buffer(imp_slice);
+
+            imp_packets[batch_size++] = imp_packet;
+        }
+
+        size_t n_written = 0;
+        const status::StatusCode code =
+            imp_decoder->write_packets(imp_iface, imp_packets, batch_size, n_written);
+
+        for (size_t n = 0; n < batch_size; n++) {
+            imp_packets[n] = NULL;
+        }
+
+        *n_packets += n_written;
+
+        if (code != status::StatusOK) {
+            // TODO(gh-183): forward status code to user
+            roc_log(LogError,
+                    "roc_receiver_decoder_push_packets():"
+                    " can't write packet to decoder: status=%s",
+                    status::code_to_str(code));
+            return -1;
+        }
+
+        if (n_written < MaxBatch && *n_packets < total_packets) {
+            // Batch was cut short by allocation or size failure.
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 int roc_receiver_decoder_pop_feedback_packet(roc_receiver_decoder* decoder,
                                              roc_interface iface,
                                              roc_packet* packet) {
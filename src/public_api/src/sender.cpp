@@ -44,9 +44,16 @@ int roc_sender_open(roc_context* context,
         return -1;
     }
 
-    core::ScopedPtr<node::Sender> imp_sender(new (imp_context->arena())
-                                                 node::Sender(*imp_context, imp_config),
-                                             imp_context->arena());
+    node::AsyncSinkConfig imp_async_config;
+    if (!api::sender_async_config_from_user(imp_async_config, *config)) {
+        roc_log(LogError, "roc_sender_open(): invalid arguments: bad config");
+        return -1;
+    }
+
+    core::ScopedPtr<node::Sender> imp_sender(
+        new (imp_context->arena())
+            node::Sender(*imp_context, imp_config, imp_async_config),
+        imp_context->arena());
 
     if (!imp_sender) {
         roc_log(LogError, "roc_sender_open(): can't allocate sender");
@@ -156,6 +163,10 @@ int roc_sender_query(roc_sender* sender,
         return -1;
     }
 
+    if (slot_metrics) {
+        api::sender_async_metrics_to_user(*slot_metrics, imp_sender->async_metrics());
+    }
+
     return 0;
 }
 
@@ -216,6 +227,57 @@ int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
     return 0;
 }
 
+int roc_sender_write_ref(roc_sender* sender,
+                         const roc_frame* frame,
+                         roc_frame_release_handler handler,
+                         void* argument) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_write_ref(): invalid arguments: sender is null");
+        return -1;
+    }
+
+    node::Sender* imp_sender = (node::Sender*)sender;
+
+    if (!frame) {
+        roc_log(LogError, "roc_sender_write_ref(): invalid arguments: frame is null");
+        return -1;
+    }
+
+    if (!handler) {
+        roc_log(LogError, "roc_sender_write_ref(): invalid arguments: handler is null");
+        return -1;
+    }
+
+    const size_t factor =
+        imp_sender->sink().sample_spec().num_channels() * sizeof(float);
+
+    if (frame->samples_size % factor != 0) {
+        roc_log(LogError,
+                "roc_sender_write_ref(): invalid arguments:"
+                " # of samples should be multiple of %u",
+                (unsigned)factor);
+        return -1;
+    }
+
+    if (frame->samples_size != 0 && !frame->samples) {
+        roc_log(LogError,
+                "roc_sender_write_ref(): invalid arguments:"
+                " frame samples buffer is null");
+        return -1;
+    }
+
+    audio::Frame imp_frame((float*)frame->samples, frame->samples_size / sizeof(float));
+
+    if (!imp_sender->write_ref(imp_frame, handler, argument)) {
+        roc_log(LogError,
+                "roc_sender_write_ref(): operation failed:"
+                " too many frames are waiting for encoding");
+        return -1;
+    }
+
+    return 0;
+}
+
 int roc_sender_close(roc_sender* sender) {
     if (!sender) {
         roc_log(LogError, "roc_sender_close(): invalid arguments: sender is null");
@@ -328,6 +328,124 @@ int roc_sender_encoder_pop_packet(roc_sender_encoder* encoder,
     return 0;
 }
 
+int roc_sender_encoder_pop_packets(roc_sender_encoder* encoder,
+                                   roc_interface iface,
+                                   roc_packet* packets,
+                                   size_t* n_packets) {
+    if (!encoder) {
+        roc_log(LogError,
+                "roc_sender_encoder_pop_packets(): invalid arguments:"
+                " encoder is null");
+        return -1;
+    }
+
+    node::SenderEncoder* imp_encoder = (node::SenderEncoder*)encoder;
+
+    address::Interface imp_iface;
+    if (!api::interface_from_user(imp_iface, iface)) {
+        roc_log(LogError,
+                "roc_sender_encoder_pop_packets(): invalid arguments:"
+                " bad interface");
+        return -1;
+    }
+
+    if (!n_packets) {
+        roc_log(LogError,
+                "roc_sender_encoder_pop_packets(): invalid arguments:"
+                " packet count is null");
+        return -1;
+    }
+
+    const size_t max_packets = *n_packets;
+    *n_packets = 0;
+
+    if (max_packets == 0) {
+        roc_log(LogError,
+                "roc_sender_encoder_pop_packets(): invalid arguments:"
+                " packet count is zero");
+        return -1;
+    }
+
+    if (!packets) {
+        roc_log(LogError,
+                "roc_sender_encoder_pop_packets(): invalid arguments:"
+                " packets array is null");
+        return -1;
+    }
+
+    for (size_t n = 0; n < max_packets; n++) {
+        if (!packets[n].bytes) {
+            roc_log(LogError,
+                    "roc_sender_encoder_pop_packets(): invalid arguments:"
+                    " packet bytes buffer is null: index=%lu",
+                    (unsigned long)n);
+            return -1;
+        }
+    }
+
+    enum { MaxBatch = 32 };
+
+    packet::PacketPtr imp_packets[MaxBatch];
+
+    while (*n_packets < max_packets) {
+        const size_t batch_size = std::min((size_t)MaxBatch, max_packets - *n_packets);
+
+        size_t n_read = 0;
+        const status::StatusCode code =
+            imp_encoder->read_packets(imp_iface, imp_packets, batch_size, n_read);
+        if (code != status::StatusOK) {
+            if (code == status::StatusNoData) {
+                break;
+            }
+            // TODO(gh-183): forward status code to user
+            roc_log(LogError,
+                    "roc_sender_encoder_pop_packets():"
+                    " can't read packet from encoder: status=%s",
+                    status::code_to_str(code));
+            return -1;
+        }
+
+        bool copy_failed = false;
+
+        for (size_t n = 0; n < n_read; n++) {
+            const core::Slice<uint8_t>& imp_buffer = imp_packets[n]->buffer();
+            roc_packet& packet = packets[*n_packets];
+
+            if (!copy_failed) {
+                if (packet.bytes_size < imp_buffer.size()) {
+                    roc_log(LogError,
+                            "roc_sender_encoder_pop_packets():"
+                            " not enough space in provided packet:"
+                            " index=%lu provided=%lu needed=%lu",
+                            (unsigned long)*n_packets, (unsigned long)packet.bytes_size,
+                            (unsigned long)imp_buffer.size());
+                    copy_failed = true;
+                } else {
+                    memcpy(packet.bytes, imp_buffer.data(), imp_buffer.size());
+                    packet.bytes_size = imp_buffer.size();
+                    (*n_packets)++;
+                }
+            }
+
+            imp_packets[n] = NULL;
+        }
+
+        if (copy_failed) {
+            return -1;
+        }
+
+        if (n_read < batch_size) {
+            break;
+        }
+    }
+
+    if (*n_packets == 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
 int roc_sender_encoder_close(roc_sender_encoder* encoder) {
     if (!encoder) {
         roc_log(LogError,
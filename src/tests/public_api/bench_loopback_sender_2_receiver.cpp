@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+
+#include "roc/config.h"
+#include "roc/context.h"
+#include "roc/endpoint.h"
+#include "roc/receiver.h"
+#include "roc/sender.h"
+
+#include <math.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace roc {
+namespace api {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// Sender and receiver are opened via public API in one context and connected
+// over UDP on loopback interface, with source, repair (if FEC is enabled), and
+// control endpoints. Sender thread writes sine wave to sender, and benchmark
+// thread reads frames from receiver. Both use internal clock, so the stream
+// runs in real time, as it would in an application.
+//
+// Every benchmark run streams WarmupDuration of audio, which is not measured,
+// and then MeasureDuration of audio, during which receiver metrics are sampled
+// every MetricsInterval and frames are checked for gaps.
+//
+// ----------
+// Benchmarks
+// ----------
+//
+// BM_Loopback_SenderReceiver  -  one sender streaming to one receiver
+//
+// ---------
+// Arguments
+// ---------
+//
+// frame    -  frame length used by sender and receiver, in milliseconds
+// profile  -  receiver latency tuner profile (0 - intact, 1 - responsive,
+//             2 - gradual)
+// fec      -  FEC scheme (0 - none, 1 - Reed-Solomon, 2 - LDPC-Staircase)
+//
+// --------------
+// Output columns
+// --------------
+//
+// (latencies are in milliseconds, cpu loads are fractions of one core)
+//
+// e2e_avg      -  average end-to-end latency reported by receiver
+// e2e_p50      -  50% percentile of the above
+// e2e_p99      -  99% percentile of the above
+// e2e_max      -  maximum of the above
+//
+// underruns    -  number of times receiver output switched from signal to silence
+//
+// cpu          -  CPU time of the whole process per second of audio, including
+//                 network and pipeline threads of both sides
+// rx_pipeline  -  CPU time of receiver pipeline per second, as reported by receiver
+// tx_pipeline  -  CPU time of sender pipeline per second, as reported by sender
+
+enum {
+    SampleRate = 44100,
+    NumChans = 2,
+
+    MaxFrameSize = 16384,
+    MaxPacketSize = 2048,
+
+    MaxConnections = 4
+};
+
+enum Profile { Profile_Intact, Profile_Responsive, Profile_Gradual };
+
+enum Scheme { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+
+const core::nanoseconds_t TargetLatency = 100 * core::Millisecond;
+const core::nanoseconds_t PacketLength = 5 * core::Millisecond;
+
+const core::nanoseconds_t WarmupDuration = 2 * core::Second;
+const core::nanoseconds_t MeasureDuration = 5 * core::Second;
+const core::nanoseconds_t MetricsInterval = 100 * core::Millisecond;
+
+const double SineFreq = 440;
+
+// Signal never goes below this value, so anything below means silence
+// inserted by receiver.
+const double SignalOffset = 0.25;
+const double SignalAmplitude = 0.2;
+const double SilenceThreshold = 0.01;
+
+class SenderThread : public core::Thread {
+public:
+    SenderThread(roc_sender* sender, size_t frame_samples)
+        : sender_(sender)
+        , samples_(frame_samples * NumChans)
+        , pos_(0)
+        , stopped_(false) {
+    }
+
+    void stop() {
+        stopped_ = true;
+    }
+
+private:
+    virtual void run() {
+        while (!stopped_) {
+            for (size_t ns = 0; ns < samples_.size() / NumChans; ns++) {
+                const double phase = 2 * M_PI * SineFreq * pos_ / SampleRate;
+                const float s = (float)(SignalOffset + SignalAmplitude * sin(phase));
+                for (size_t nc = 0; nc < NumChans; nc++) {
+                    samples_[ns * NumChans + nc] = s;
+                }
+                pos_++;
+            }
+
+            roc_frame frame;
+            memset(&frame, 0, sizeof(frame));
+            frame.samples = &samples_[0];
+            frame.samples_size = samples_.size() * sizeof(float);
+
+            roc_panic_if_not(roc_sender_write(sender_, &frame) == 0);
+        }
+    }
+
+    roc_sender* sender_;
+    std::vector<float> samples_;
+    size_t pos_;
+    core::Atomic<int> stopped_;
+};
+
+class Stats {
+public:
+    Stats()
+        : n_underruns_(0)
+        , in_gap_(false)
+        , rx_cpu_(0)
+        , tx_cpu_(0) {
+    }
+
+    void add_frame(const float* samples, size_t n_samples) {
+        bool has_gap = false;
+        for (size_t n = 0; n < n_samples; n++) {
+            if ((double)samples[n] < SilenceThreshold) {
+                has_gap = true;
+                break;
+            }
+        }
+
+        if (has_gap && !in_gap_) {
+            n_underruns_++;
+        }
+        in_gap_ = has_gap;
+    }
+
+    void add_metrics(const roc_connection_metrics& rx_metrics,
+                     const roc_connection_metrics& tx_metrics) {
+        // Zero means that there is not enough statistics yet.
+        if (rx_metrics.e2e_latency != 0) {
+            latencies_.push_back((core::nanoseconds_t)rx_metrics.e2e_latency);
+        }
+        rx_cpu_ = rx_metrics.cpu_ns_per_sec;
+        tx_cpu_ = tx_metrics.cpu_ns_per_sec;
+    }
+
+    void report(benchmark::State& state, double cpu_load) {
+        state.counters["underruns"] = (double)n_underruns_;
+
+        state.counters["cpu"] = cpu_load;
+        state.counters["rx_pipeline"] = (double)rx_cpu_ / core::Second;
+        state.counters["tx_pipeline"] = (double)tx_cpu_ / core::Second;
+
+        if (latencies_.empty()) {
+            return;
+        }
+
+        std::sort(latencies_.begin(), latencies_.end());
+
+        double total = 0;
+        for (size_t n = 0; n < latencies_.size(); n++) {
+            total += (double)latencies_[n];
+        }
+
+        state.counters["e2e_avg"] = total / latencies_.size() / core::Millisecond;
+        state.counters["e2e_p50"] = percentile_(0.50);
+        state.counters["e2e_p99"] = percentile_(0.99);
+        state.counters["e2e_max"] =
+            (double)latencies_[latencies_.size() - 1] / core::Millisecond;
+    }
+
+private:
+    double percentile_(double p) const {
+        const size_t n = std::min(latencies_.size() - 1,
+                                  (size_t)(p * (double)latencies_.size()));
+        return (double)latencies_[n] / core::Millisecond;
+    }
+
+    std::vector<core::nanoseconds_t> latencies_;
+    size_t n_underruns_;
+    bool in_gap_;
+    unsigned long long rx_cpu_;
+    unsigned long long tx_cpu_;
+};
+
+bool is_scheme_supported(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8);
+    case Scheme_LDPC:
+        return fec::CodecMap::instance().is_supported(packet::FEC_LDPC_Staircase);
+    default:
+        break;
+    }
+    return true;
+}
+
+roc_latency_tuner_profile make_profile(Profile profile) {
+    switch (profile) {
+    case Profile_Responsive:
+        return ROC_LATENCY_TUNER_PROFILE_RESPONSIVE;
+    case Profile_Gradual:
+        return ROC_LATENCY_TUNER_PROFILE_GRADUAL;
+    default:
+        break;
+    }
+    return ROC_LATENCY_TUNER_PROFILE_INTACT;
+}
+
+void make_configs(Profile profile,
+                  Scheme scheme,
+                  roc_sender_config& sender_conf,
+                  roc_receiver_config& receiver_conf) {
+    memset(&sender_conf, 0, sizeof(sender_conf));
+    sender_conf.frame_encoding.rate = SampleRate;
+    sender_conf.frame_encoding.format = ROC_FORMAT_PCM_FLOAT32;
+    sender_conf.frame_encoding.channels = ROC_CHANNEL_LAYOUT_STEREO;
+    sender_conf.packet_encoding = ROC_PACKET_ENCODING_AVP_L16_STEREO;
+    sender_conf.packet_length = PacketLength;
+    sender_conf.clock_source = ROC_CLOCK_SOURCE_INTERNAL;
+
+    switch (scheme) {
+    case Scheme_RS8M:
+        sender_conf.fec_encoding = ROC_FEC_ENCODING_RS8M;
+        break;
+    case Scheme_LDPC:
+        sender_conf.fec_encoding = ROC_FEC_ENCODING_LDPC_STAIRCASE;
+        break;
+    default:
+        sender_conf.fec_encoding = ROC_FEC_ENCODING_DISABLE;
+        break;
+    }
+
+    memset(&receiver_conf, 0, sizeof(receiver_conf));
+    receiver_conf.frame_encoding.rate = SampleRate;
+    receiver_conf.frame_encoding.format = ROC_FORMAT_PCM_FLOAT32;
+    receiver_conf.frame_encoding.channels = ROC_CHANNEL_LAYOUT_STEREO;
+    receiver_conf.clock_source = ROC_CLOCK_SOURCE_INTERNAL;
+    receiver_conf.latency_tuner_profile = make_profile(profile);
+    receiver_conf.target_latency = TargetLatency;
+}
+
+bool bind_and_connect(roc_receiver* receiver,
+                      roc_sender* sender,
+                      roc_interface iface,
+                      const char* uri) {
+    roc_endpoint* endpoint = NULL;
+    if (roc_endpoint_allocate(&endpoint) != 0) {
+        return false;
+    }
+
+    // Receiver updates endpoint with actual port.
+    const bool ok = roc_endpoint_set_uri(endpoint, uri) == 0
+        && roc_receiver_bind(receiver, ROC_SLOT_DEFAULT, iface, endpoint) == 0
+        && roc_sender_connect(sender, ROC_SLOT_DEFAULT, iface, endpoint) == 0;
+
+    roc_panic_if_not(roc_endpoint_deallocate(endpoint) == 0);
+
+    return ok;
+}
+
+bool connect_all(roc_receiver* receiver, roc_sender* sender, Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        if (!bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_SOURCE,
+                              "rtp+rs8m://127.0.0.1:0")
+            || !bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_REPAIR,
+                                 "rs8m://127.0.0.1:0")) {
+            return false;
+        }
+        break;
+    case Scheme_LDPC:
+        if (!bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_SOURCE,
+                              "rtp+ldpc://127.0.0.1:0")
+            || !bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_REPAIR,
+                                 "ldpc://127.0.0.1:0")) {
+            return false;
+        }
+        break;
+    default:
+        if (!bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_SOURCE,
+                              "rtp://127.0.0.1:0")) {
+            return false;
+        }
+        break;
+    }
+
+    // Control endpoint is needed for e2e latency.
+    return bind_and_connect(receiver, sender, ROC_INTERFACE_AUDIO_CONTROL,
+                            "rtcp://127.0.0.1:0");
+}
+
+bool query_metrics(roc_receiver* receiver,
+                   roc_sender* sender,
+                   roc_connection_metrics& rx_metrics,
+                   roc_connection_metrics& tx_metrics) {
+    roc_receiver_metrics rx_slot_metrics;
+    roc_connection_metrics rx_conn_metrics[MaxConnections];
+    size_t rx_conn_count = MaxConnections;
+
+    if (roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &rx_slot_metrics,
+                           rx_conn_metrics, &rx_conn_count)
+        != 0) {
+        return false;
+    }
+
+    roc_sender_metrics tx_slot_metrics;
+    roc_connection_metrics tx_conn_metrics[MaxConnections];
+    size_t tx_conn_count = MaxConnections;
+
+    if (roc_sender_query(sender, ROC_SLOT_DEFAULT, &tx_slot_metrics, tx_conn_metrics,
+                         &tx_conn_count)
+        != 0) {
+        return false;
+    }
+
+    memset(&rx_metrics, 0, sizeof(rx_metrics));
+    memset(&tx_metrics, 0, sizeof(tx_metrics));
+
+    if (rx_conn_count != 0) {
+        rx_metrics = rx_conn_metrics[0];
+    }
+    if (tx_conn_count != 0) {
+        tx_metrics = tx_conn_metrics[0];
+    }
+
+    return true;
+}
+
+void BM_Loopback_SenderReceiver(benchmark::State& state) {
+    const size_t frame_samples = (size_t)state.range(0) * SampleRate / 1000;
+    const Profile profile = (Profile)state.range(1);
+    const Scheme scheme = (Scheme)state.range(2);
+
+    if (!is_scheme_supported(scheme)) {
+        state.SkipWithError("fec scheme not supported");
+        return;
+    }
+
+    roc_context_config context_conf;
+    memset(&context_conf, 0, sizeof(context_conf));
+    context_conf.max_frame_size = MaxFrameSize;
+    context_conf.max_packet_size = MaxPacketSize;
+
+    roc_context* context = NULL;
+    roc_panic_if_not(roc_context_open(&context_conf, &context) == 0);
+
+    roc_sender_config sender_conf;
+    roc_receiver_config receiver_conf;
+    make_configs(profile, scheme, sender_conf, receiver_conf);
+
+    roc_sender* sender = NULL;
+    roc_panic_if_not(roc_sender_open(context, &sender_conf, &sender) == 0);
+
+    roc_receiver* receiver = NULL;
+    roc_panic_if_not(roc_receiver_open(context, &receiver_conf, &receiver) == 0);
+
+    if (!connect_all(receiver, sender, scheme)) {
+        state.SkipWithError("can't connect sender to receiver");
+    } else {
+        std::vector<float> samples(frame_samples * NumChans);
+
+        const core::nanoseconds_t frame_length =
+            (core::nanoseconds_t)frame_samples * core::Second / SampleRate;
+
+        while (state.KeepRunning()) {
+            SenderThread sender_thread(sender, frame_samples);
+            roc_panic_if_not(sender_thread.start());
+
+            Stats stats;
+
+            core::nanoseconds_t pos = 0;
+            core::nanoseconds_t next_metrics = WarmupDuration;
+
+            bool measuring = false;
+            clock_t cpu_start = 0;
+
+            while (pos < WarmupDuration + MeasureDuration) {
+                roc_frame frame;
+                memset(&frame, 0, sizeof(frame));
+                frame.samples = &samples[0];
+                frame.samples_size = samples.size() * sizeof(float);
+
+                roc_panic_if_not(roc_receiver_read(receiver, &frame) == 0);
+
+                if (pos >= WarmupDuration) {
+                    if (!measuring) {
+                        cpu_start = clock();
+                        measuring = true;
+                    }
+
+                    stats.add_frame(&samples[0], samples.size());
+
+                    if (pos >= next_metrics) {
+                        roc_connection_metrics rx_metrics, tx_metrics;
+                        roc_panic_if_not(
+                            query_metrics(receiver, sender, rx_metrics, tx_metrics));
+                        stats.add_metrics(rx_metrics, tx_metrics);
+                        next_metrics += MetricsInterval;
+                    }
+                }
+
+                pos += frame_length;
+            }
+
+            const double cpu_load = (double)(clock() - cpu_start) / CLOCKS_PER_SEC
+                / ((double)MeasureDuration / core::Second);
+
+            sender_thread.stop();
+            sender_thread.join();
+
+            stats.report(state, cpu_load);
+        }
+    }
+
+    roc_panic_if_not(roc_receiver_close(receiver) == 0);
+    roc_panic_if_not(roc_sender_close(sender) == 0);
+    roc_panic_if_not(roc_context_close(context) == 0);
+}
+
+void loopback_args(benchmark::internal::Benchmark* b) {
+    const int frame_lengths[] = { 2, 5, 10, 20 };
+    const int profiles[] = { Profile_Intact, Profile_Responsive, Profile_Gradual };
+    const int schemes[] = { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+
+    std::vector<std::string> names;
+    names.push_back("frame");
+    names.push_back("profile");
+    names.push_back("fec");
+    b->ArgNames(names);
+
+    for (size_t n_fl = 0; n_fl < ROC_ARRAY_SIZE(frame_lengths); n_fl++) {
+        for (size_t n_pr = 0; n_pr < ROC_ARRAY_SIZE(profiles); n_pr++) {
+            for (size_t n_sch = 0; n_sch < ROC_ARRAY_SIZE(schemes); n_sch++) {
+                std::vector<int64_t> args;
+                args.push_back(frame_lengths[n_fl]);
+                args.push_back(profiles[n_pr]);
+                args.push_back(schemes[n_sch]);
+                b->Args(args);
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_Loopback_SenderReceiver)
+    ->Apply(loopback_args)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace api
+} // namespace roc
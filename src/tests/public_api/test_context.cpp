@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/stddefs.h"
+#include "roc_core/temp_file.h"
 
 #include "roc/context.h"
 #include "roc/receiver.h"
@@ -40,6 +41,147 @@ TEST(context, open_null) {
     LONGS_EQUAL(-1, roc_context_open(&config, NULL));
 }
 
+TEST(context, thread_config) {
+#if defined(__linux__) && !defined(__ANDROID__)
+    { // pin threads to first cpu
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.network_thread.cpu_mask = 0x1;
+        config.control_thread.cpu_mask = 0x1;
+
+        roc_context* context = NULL;
+        CHECK(roc_context_open(&config, &context) == 0);
+        CHECK(context);
+
+        LONGS_EQUAL(0, roc_context_close(context));
+    }
+#endif
+    { // invalid policy
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.network_thread.policy = (roc_thread_policy)-1;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+    { // priority without policy
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.control_thread.priority = 10;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+    { // negative priority
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.network_thread.policy = ROC_THREAD_POLICY_FIFO;
+        config.network_thread.priority = -1;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+    { // prealloc greater than max
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.prealloc_packets = 20;
+        config.max_packets = 10;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+    { // invalid media clock
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.media_clock = (roc_media_clock)-1;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+    { // ptp media clock without device
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.media_clock = ROC_MEDIA_CLOCK_PTP;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+}
+
+TEST(context, shared_runtime) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+    config.shared_runtime = 1;
+
+    roc_context* context1 = NULL;
+    CHECK(roc_context_open(&config, &context1) == 0);
+    CHECK(context1);
+
+    roc_context* context2 = NULL;
+    CHECK(roc_context_open(&config, &context2) == 0);
+    CHECK(context2);
+
+    // Contexts may be closed in any order.
+    LONGS_EQUAL(0, roc_context_close(context1));
+
+    roc_context* context3 = NULL;
+    CHECK(roc_context_open(&config, &context3) == 0);
+    CHECK(context3);
+
+    LONGS_EQUAL(0, roc_context_close(context2));
+    LONGS_EQUAL(0, roc_context_close(context3));
+}
+
+TEST(context, packet_capture) {
+    core::TempFile temp_file("capture.pcapng");
+
+    { // disabled
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+
+        roc_context* context = NULL;
+        CHECK(roc_context_open(&config, &context) == 0);
+        CHECK(context);
+
+        LONGS_EQUAL(-1, roc_context_dump_packet_capture(context, temp_file.path()));
+
+        LONGS_EQUAL(0, roc_context_close(context));
+    }
+    { // enabled
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.packet_capture_records = 64;
+        config.packet_capture_snaplen = 32;
+
+        roc_context* context = NULL;
+        CHECK(roc_context_open(&config, &context) == 0);
+        CHECK(context);
+
+        LONGS_EQUAL(0, roc_context_dump_packet_capture(context, temp_file.path()));
+
+        LONGS_EQUAL(-1, roc_context_dump_packet_capture(context, NULL));
+        LONGS_EQUAL(-1, roc_context_dump_packet_capture(NULL, temp_file.path()));
+
+        LONGS_EQUAL(0, roc_context_close(context));
+    }
+    { // bad snaplen
+        roc_context_config config;
+        memset(&config, 0, sizeof(config));
+        config.packet_capture_records = 64;
+        config.packet_capture_snaplen = 100000;
+
+        roc_context* context = NULL;
+        LONGS_EQUAL(-1, roc_context_open(&config, &context));
+        CHECK(!context);
+    }
+}
+
 TEST(context, close_null) {
     LONGS_EQUAL(-1, roc_context_close(NULL));
 }
@@ -28,6 +28,7 @@ namespace {
 enum {
     NoFlags = 0,
     FlagLosses = (1 << 0),
+    FlagBatch = (1 << 1),
 };
 
 } // namespace
@@ -77,6 +78,43 @@ TEST_GROUP(loopback_encoder_2_decoder) {
         return std::abs(s) < 1e-6f;
     }
 
+    // pop packets from encoder and push to decoder in batches, until encoder
+    // queue is empty; returns number of transferred packets
+    size_t transfer_packet_batches(roc_sender_encoder * encoder,
+                                   roc_receiver_decoder * decoder, roc_interface iface) {
+        enum { BatchSize = 4 };
+
+        uint8_t bytes[BatchSize][test::MaxBufSize] = {};
+        size_t n_transferred = 0;
+
+        for (;;) {
+            roc_packet packets[BatchSize];
+            for (size_t n = 0; n < BatchSize; n++) {
+                packets[n].bytes = bytes[n];
+                packets[n].bytes_size = test::MaxBufSize;
+            }
+
+            size_t n_packets = BatchSize;
+            if (roc_sender_encoder_pop_packets(encoder, iface, packets, &n_packets)
+                != 0) {
+                UNSIGNED_LONGS_EQUAL(0, n_packets);
+                break;
+            }
+
+            CHECK(n_packets > 0);
+            CHECK(n_packets <= BatchSize);
+
+            const size_t n_popped = n_packets;
+            CHECK(roc_receiver_decoder_push_packets(decoder, iface, packets, &n_packets)
+                  == 0);
+            UNSIGNED_LONGS_EQUAL(n_popped, n_packets);
+
+            n_transferred += n_packets;
+        }
+
+        return n_transferred;
+    }
+
     void run_test(roc_sender_encoder * encoder, roc_receiver_decoder * decoder,
                   const roc_interface* ifaces, size_t num_ifaces, int flags) {
         enum {
@@ -127,6 +165,14 @@ TEST_GROUP(loopback_encoder_2_decoder) {
 
                 // repeat for all enabled interfaces (source, repair, etc)
                 for (size_t n_if = 0; n_if < num_ifaces; n_if++) {
+                    if (flags & FlagBatch) {
+                        const size_t n_transferred =
+                            transfer_packet_batches(encoder, decoder, ifaces[n_if]);
+                        iface_packets[n_if] += n_transferred;
+                        n_pkt += n_transferred;
+                        continue;
+                    }
+
                     for (;;) {
                         roc_packet packet;
                         packet.bytes = bytes;
@@ -488,5 +534,58 @@ TEST(loopback_encoder_2_decoder, source_repair_control) {
     LONGS_EQUAL(0, roc_receiver_decoder_close(decoder));
 }
 
+TEST(loopback_encoder_2_decoder, batch) {
+    if (!is_rs8m_supported()) {
+        return;
+    }
+
+    sender_conf.fec_encoding = ROC_FEC_ENCODING_RS8M;
+    sender_conf.fec_block_source_packets = test::SourcePackets;
+    sender_conf.fec_block_repair_packets = test::RepairPackets;
+
+    roc_sender_encoder* encoder = NULL;
+    CHECK(roc_sender_encoder_open(context, &sender_conf, &encoder) == 0);
+    CHECK(encoder);
+
+    roc_receiver_decoder* decoder = NULL;
+    CHECK(roc_receiver_decoder_open(context, &receiver_conf, &decoder) == 0);
+    CHECK(decoder);
+
+    CHECK(roc_sender_encoder_activate(encoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                      ROC_PROTO_RTP_RS8M_SOURCE)
+          == 0);
+
+    CHECK(roc_sender_encoder_activate(encoder, ROC_INTERFACE_AUDIO_REPAIR,
+                                      ROC_PROTO_RS8M_REPAIR)
+          == 0);
+
+    CHECK(
+        roc_sender_encoder_activate(encoder, ROC_INTERFACE_AUDIO_CONTROL, ROC_PROTO_RTCP)
+        == 0);
+
+    CHECK(roc_receiver_decoder_activate(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                        ROC_PROTO_RTP_RS8M_SOURCE)
+          == 0);
+
+    CHECK(roc_receiver_decoder_activate(decoder, ROC_INTERFACE_AUDIO_REPAIR,
+                                        ROC_PROTO_RS8M_REPAIR)
+          == 0);
+
+    CHECK(roc_receiver_decoder_activate(decoder, ROC_INTERFACE_AUDIO_CONTROL,
+                                        ROC_PROTO_RTCP)
+          == 0);
+
+    roc_interface ifaces[] = {
+        ROC_INTERFACE_AUDIO_SOURCE,
+        ROC_INTERFACE_AUDIO_REPAIR,
+        ROC_INTERFACE_AUDIO_CONTROL,
+    };
+
+    run_test(encoder, decoder, ifaces, ROC_ARRAY_SIZE(ifaces), FlagBatch);
+
+    LONGS_EQUAL(0, roc_sender_encoder_close(encoder));
+    LONGS_EQUAL(0, roc_receiver_decoder_close(decoder));
+}
+
 } // namespace api
 } // namespace roc
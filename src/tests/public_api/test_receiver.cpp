@@ -99,6 +99,57 @@ TEST(receiver, bind_slots) {
     LONGS_EQUAL(0, roc_receiver_close(receiver));
 }
 
+TEST(receiver, bind_many) {
+    enum { NumSlots = 4, NumBindings = NumSlots * 2 };
+
+    roc_receiver* receiver = NULL;
+    CHECK(roc_receiver_open(context, &receiver_config, &receiver) == 0);
+    CHECK(receiver);
+
+    roc_interface_config iface_config;
+    memset(&iface_config, 0, sizeof(iface_config));
+    iface_config.reuse_address = 1;
+
+    roc_endpoint* endpoints[NumBindings];
+    roc_receiver_binding bindings[NumBindings];
+
+    for (size_t n = 0; n < NumBindings; n++) {
+        CHECK(roc_endpoint_allocate(&endpoints[n]) == 0);
+
+        CHECK(roc_endpoint_set_protocol(endpoints[n],
+                                        n % 2 == 0 ? ROC_PROTO_RTP : ROC_PROTO_RTCP)
+              == 0);
+        CHECK(roc_endpoint_set_host(endpoints[n], "127.0.0.1") == 0);
+        CHECK(roc_endpoint_set_port(endpoints[n], 0) == 0);
+
+        bindings[n].slot = n / 2;
+        bindings[n].iface =
+            n % 2 == 0 ? ROC_INTERFACE_AUDIO_SOURCE : ROC_INTERFACE_AUDIO_CONTROL;
+        bindings[n].config = n % 2 == 0 ? &iface_config : NULL;
+        bindings[n].endpoint = endpoints[n];
+    }
+
+    CHECK(roc_receiver_bind_many(receiver, bindings, NumBindings) == 0);
+
+    for (size_t n = 0; n < NumBindings; n++) {
+        int port = 0;
+        CHECK(roc_endpoint_get_port(endpoints[n], &port) == 0);
+        CHECK(port != 0);
+
+        CHECK(roc_endpoint_deallocate(endpoints[n]) == 0);
+    }
+
+    // bad args
+    CHECK(roc_receiver_bind_many(NULL, bindings, NumBindings) == -1);
+    CHECK(roc_receiver_bind_many(receiver, NULL, NumBindings) == -1);
+    CHECK(roc_receiver_bind_many(receiver, NULL, 0) == 0);
+
+    bindings[0].endpoint = NULL;
+    CHECK(roc_receiver_bind_many(receiver, bindings, 1) == -1);
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
 TEST(receiver, bind_error) {
     roc_receiver* receiver = NULL;
     CHECK(roc_receiver_open(context, &receiver_config, &receiver) == 0);
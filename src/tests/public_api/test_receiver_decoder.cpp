@@ -214,6 +214,116 @@ TEST(receiver_decoder, push_packet_args) {
     LONGS_EQUAL(0, roc_receiver_decoder_close(decoder));
 }
 
+TEST(receiver_decoder, push_packets_args) {
+    roc_receiver_decoder* decoder = NULL;
+    CHECK(roc_receiver_decoder_open(context, &receiver_config, &decoder) == 0);
+
+    CHECK(
+        roc_receiver_decoder_activate(decoder, ROC_INTERFACE_AUDIO_SOURCE, ROC_PROTO_RTP)
+        == 0);
+
+    enum { NumPackets = 40 };
+
+    uint8_t bytes[NumPackets][256] = {};
+    roc_packet packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n].bytes = bytes[n];
+        packets[n].bytes_size = ROC_ARRAY_SIZE(bytes[n]);
+    }
+
+    { // null decoder
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(NULL, ROC_INTERFACE_AUDIO_SOURCE, packets,
+                                                &n_packets)
+              == -1);
+    }
+
+    { // bad interface
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, (roc_interface)-1, packets,
+                                                &n_packets)
+              == -1);
+    }
+
+    { // inactive interface
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_REPAIR,
+                                                packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // null packets
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE, NULL,
+                                                &n_packets)
+              == -1);
+    }
+
+    { // null packet count
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                packets, NULL)
+              == -1);
+    }
+
+    { // null bytes in one of packets
+        roc_packet bad_packets[NumPackets];
+        memcpy(bad_packets, packets, sizeof(packets));
+        bad_packets[NumPackets - 1].bytes = NULL;
+
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                bad_packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // zero byte count in one of packets
+        roc_packet bad_packets[NumPackets];
+        memcpy(bad_packets, packets, sizeof(packets));
+        bad_packets[NumPackets - 1].bytes_size = 0;
+
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                bad_packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // large byte count in one of packets
+        float large_bytes[20000] = {};
+        roc_packet bad_packets[NumPackets];
+        memcpy(bad_packets, packets, sizeof(packets));
+        bad_packets[NumPackets - 2].bytes = large_bytes;
+        bad_packets[NumPackets - 2].bytes_size = ROC_ARRAY_SIZE(large_bytes);
+
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                bad_packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(NumPackets - 2, n_packets);
+    }
+
+    { // zero packets
+        size_t n_packets = 0;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                packets, &n_packets)
+              == 0);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // all good
+        size_t n_packets = NumPackets;
+        CHECK(roc_receiver_decoder_push_packets(decoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                                packets, &n_packets)
+              == 0);
+        UNSIGNED_LONGS_EQUAL(NumPackets, n_packets);
+    }
+
+    LONGS_EQUAL(0, roc_receiver_decoder_close(decoder));
+}
+
 TEST(receiver_decoder, pop_feedback_packet_args) {
     int n_iter = 0;
 
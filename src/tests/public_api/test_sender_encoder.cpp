@@ -350,5 +350,118 @@ TEST(sender_encoder, pop_packet_args) {
     LONGS_EQUAL(0, roc_sender_encoder_close(encoder));
 }
 
+TEST(sender_encoder, pop_packets_args) {
+    roc_sender_encoder* encoder = NULL;
+    CHECK(roc_sender_encoder_open(context, &sender_config, &encoder) == 0);
+
+    CHECK(roc_sender_encoder_activate(encoder, ROC_INTERFACE_AUDIO_SOURCE, ROC_PROTO_RTP)
+          == 0);
+
+    {
+        float samples[8192] = {};
+        roc_frame frame;
+        frame.samples = samples;
+        frame.samples_size = ROC_ARRAY_SIZE(samples);
+        CHECK(roc_sender_encoder_push_frame(encoder, &frame) == 0);
+    }
+
+    enum { NumPackets = 4 };
+
+    uint8_t bytes[NumPackets][8192] = {};
+    roc_packet packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n].bytes = bytes[n];
+        packets[n].bytes_size = ROC_ARRAY_SIZE(bytes[n]);
+    }
+
+    { // null encoder
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(NULL, ROC_INTERFACE_AUDIO_SOURCE, packets,
+                                             &n_packets)
+              == -1);
+    }
+
+    { // bad interface
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(encoder, (roc_interface)-1, packets,
+                                             &n_packets)
+              == -1);
+    }
+
+    { // unactivated interface
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_REPAIR,
+                                             packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // null packets
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE, NULL,
+                                             &n_packets)
+              == -1);
+    }
+
+    { // null packet count
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE, packets,
+                                             NULL)
+              == -1);
+    }
+
+    { // zero packet count
+        size_t n_packets = 0;
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE, packets,
+                                             &n_packets)
+              == -1);
+    }
+
+    { // null bytes in one of packets
+        roc_packet bad_packets[NumPackets];
+        memcpy(bad_packets, packets, sizeof(packets));
+        bad_packets[NumPackets - 1].bytes = NULL;
+
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                             bad_packets, &n_packets)
+              == -1);
+        UNSIGNED_LONGS_EQUAL(0, n_packets);
+    }
+
+    { // all good
+        size_t n_packets = NumPackets;
+        CHECK(roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE, packets,
+                                             &n_packets)
+              == 0);
+
+        CHECK(n_packets > 0);
+        CHECK(n_packets <= NumPackets);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            CHECK(packets[n].bytes == bytes[n]);
+            CHECK(packets[n].bytes_size > 0);
+            CHECK(packets[n].bytes_size < ROC_ARRAY_SIZE(bytes[n]));
+        }
+    }
+
+    { // drain queue
+        for (;;) {
+            size_t n_packets = NumPackets;
+            for (size_t n = 0; n < NumPackets; n++) {
+                packets[n].bytes_size = ROC_ARRAY_SIZE(bytes[n]);
+            }
+            if (roc_sender_encoder_pop_packets(encoder, ROC_INTERFACE_AUDIO_SOURCE,
+                                               packets, &n_packets)
+                != 0) {
+                UNSIGNED_LONGS_EQUAL(0, n_packets);
+                break;
+            }
+        }
+    }
+
+    LONGS_EQUAL(0, roc_sender_encoder_close(encoder));
+}
+
 } // namespace api
 } // namespace roc
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace address {
+namespace {
+
+void init_key(uint8_t* key, size_t size) {
+    for (size_t n = 0; n < size; n++) {
+        key[n] = uint8_t(n * 31 + 7);
+    }
+}
+
+void make_addr(SocketAddr& addr, AddrFamily family) {
+    const bool ok = family == Family_IPv4
+        ? addr.set_host_port(Family_IPv4, "192.168.1.10", 10001)
+        : addr.set_host_port(Family_IPv6, "2001:db8::1", 10001);
+    if (!ok) {
+        roc_panic("bench: can't set address");
+    }
+}
+
+// Byte-by-byte DJB2, used by hashsum_add().
+void BM_Hashsum_Add(benchmark::State& state) {
+    uint8_t key[64];
+    const size_t size = (size_t)state.range(0);
+    init_key(key, size);
+
+    while (state.KeepRunning()) {
+        core::hashsum_t h = 0;
+        core::hashsum_add(h, key, size);
+        benchmark::DoNotOptimize(h);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+
+// 16 and 28 are sizes of sockaddr_in and sockaddr_in6.
+BENCHMARK(BM_Hashsum_Add)->Arg(4)->Arg(16)->Arg(28)->Arg(64);
+
+// Word-at-a-time hash, used by hashsum_mem().
+void BM_Hashsum_Mem(benchmark::State& state) {
+    uint8_t key[64];
+    const size_t size = (size_t)state.range(0);
+    init_key(key, size);
+
+    while (state.KeepRunning()) {
+        core::hashsum_t h = core::hashsum_mem(key, size);
+        benchmark::DoNotOptimize(h);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+
+// 16 and 28 are sizes of sockaddr_in and sockaddr_in6.
+BENCHMARK(BM_Hashsum_Mem)->Arg(4)->Arg(16)->Arg(28)->Arg(64);
+
+// Hash is recomputed on every call.
+void BM_SocketAddr_Hash_Uncached(benchmark::State& state) {
+    SocketAddr addr;
+    make_addr(addr, state.range(0) == 6 ? Family_IPv6 : Family_IPv4);
+
+    while (state.KeepRunning()) {
+        // Non-const saddr() resets cached hash.
+        benchmark::DoNotOptimize(addr.saddr());
+        core::hashsum_t h = addr.hash();
+        benchmark::DoNotOptimize(h);
+    }
+}
+
+BENCHMARK(BM_SocketAddr_Hash_Uncached)->Arg(4)->Arg(6);
+
+// Hash is computed once, like when same address is looked up repeatedly.
+void BM_SocketAddr_Hash_Cached(benchmark::State& state) {
+    SocketAddr addr;
+    make_addr(addr, state.range(0) == 6 ? Family_IPv6 : Family_IPv4);
+
+    while (state.KeepRunning()) {
+        core::hashsum_t h = addr.hash();
+        benchmark::DoNotOptimize(h);
+    }
+}
+
+BENCHMARK(BM_SocketAddr_Hash_Cached)->Arg(4)->Arg(6);
+
+} // namespace
+} // namespace address
+} // namespace roc
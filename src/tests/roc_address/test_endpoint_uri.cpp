@@ -237,6 +237,32 @@ TEST(endpoint_uri, protocols) {
 
         STRCMP_EQUAL("rtcp://host:123", endpoint_uri_to_str(u).c_str());
     }
+    {
+        EndpointUri u(arena);
+        CHECK(parse_endpoint_uri("rtp+shm://host:123", EndpointUri::Subset_Full, u));
+        CHECK(u.verify(EndpointUri::Subset_Full));
+
+        LONGS_EQUAL(Proto_RTP_Shm, u.proto());
+        STRCMP_EQUAL("host", u.host());
+        LONGS_EQUAL(123, u.port());
+        CHECK(!u.path());
+        CHECK(!u.encoded_query());
+
+        STRCMP_EQUAL("rtp+shm://host:123", endpoint_uri_to_str(u).c_str());
+    }
+    {
+        EndpointUri u(arena);
+        CHECK(parse_endpoint_uri("srtp://host:123", EndpointUri::Subset_Full, u));
+        CHECK(u.verify(EndpointUri::Subset_Full));
+
+        LONGS_EQUAL(Proto_SRTP, u.proto());
+        STRCMP_EQUAL("host", u.host());
+        LONGS_EQUAL(123, u.port());
+        CHECK(!u.path());
+        CHECK(!u.encoded_query());
+
+        STRCMP_EQUAL("srtp://host:123", endpoint_uri_to_str(u).c_str());
+    }
 }
 
 TEST(endpoint_uri, addresses) {
@@ -229,5 +229,42 @@ TEST(socket_addr, clear) {
     CHECK(addr == SocketAddr());
 }
 
+TEST(socket_addr, hash) {
+    SocketAddr addr1;
+    CHECK(addr1.set_host_port(Family_IPv4, "1.2.3.4", 123));
+
+    SocketAddr addr2;
+    CHECK(addr2.set_host_port(Family_IPv4, "1.2.3.4", 123));
+
+    SocketAddr addr3;
+    CHECK(addr3.set_host_port(Family_IPv6, "2001:db8::1", 123));
+
+    SocketAddr addr4;
+    CHECK(addr4.set_host_port(Family_IPv6, "2001:db8::1", 123));
+
+    CHECK(addr1.hash() != 0);
+    CHECK(addr3.hash() != 0);
+
+    CHECK(addr1.hash() == addr2.hash());
+    CHECK(addr3.hash() == addr4.hash());
+    CHECK(addr1.hash() != addr3.hash());
+
+    // Fields not compared by operator== don't affect hash.
+    ((sockaddr_in6*)addr4.saddr())->sin6_flowinfo = 1;
+    CHECK(addr3 == addr4);
+    CHECK(addr3.hash() == addr4.hash());
+
+    // Cached hash is updated when address changes.
+    const core::hashsum_t old_hash = addr2.hash();
+    CHECK(addr2.set_host_port(Family_IPv4, "1.2.3.4", 456));
+    CHECK(addr2.hash() != old_hash);
+
+    ((sockaddr_in*)addr2.saddr())->sin_port = ((sockaddr_in*)addr1.saddr())->sin_port;
+    CHECK(addr2.hash() == old_hash);
+
+    addr2.clear();
+    CHECK(addr2.hash() == SocketAddr().hash());
+}
+
 } // namespace address
 } // namespace roc
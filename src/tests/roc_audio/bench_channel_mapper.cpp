@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_audio/channel_defs.h"
+#include "roc_audio/channel_mapper.h"
+#include "roc_audio/channel_set.h"
+#include "roc_core/fast_random.h"
+
+namespace roc {
+namespace audio {
+namespace {
+
+enum { NumFrames = 480, MaxSamples = NumFrames * ChanPos_Max };
+
+sample_t in_buf[MaxSamples];
+sample_t out_buf[MaxSamples];
+
+void bench_mapper(benchmark::State& state, ChannelMask in_mask, ChannelMask out_mask) {
+    ChannelSet in_chans;
+    in_chans.set_layout(ChanLayout_Surround);
+    in_chans.set_order(ChanOrder_Smpte);
+    in_chans.set_mask(in_mask);
+
+    ChannelSet out_chans;
+    out_chans.set_layout(ChanLayout_Surround);
+    out_chans.set_order(ChanOrder_Smpte);
+    out_chans.set_mask(out_mask);
+
+    ChannelMapper mapper(in_chans, out_chans);
+
+    for (size_t n = 0; n < MaxSamples; n++) {
+        in_buf[n] = (sample_t)core::fast_random_gaussian() * 0.3f;
+    }
+
+    while (state.KeepRunning()) {
+        mapper.map(in_buf, NumFrames * in_chans.num_channels(), out_buf,
+                   NumFrames * out_chans.num_channels());
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * NumFrames);
+}
+
+void BM_ChannelMapper_Mono_Stereo(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_Mono, ChanMask_Surround_Stereo);
+}
+
+void BM_ChannelMapper_Stereo_Mono(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_Stereo, ChanMask_Surround_Mono);
+}
+
+void BM_ChannelMapper_51_Stereo(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_5_1, ChanMask_Surround_Stereo);
+}
+
+void BM_ChannelMapper_71_Stereo(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_7_1, ChanMask_Surround_Stereo);
+}
+
+void BM_ChannelMapper_Mono_51(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_Mono, ChanMask_Surround_5_1);
+}
+
+// Not specialized, uses generic matrix multiplication.
+void BM_ChannelMapper_31_Stereo(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_3_1, ChanMask_Surround_Stereo);
+}
+
+void BM_ChannelMapper_714_Stereo(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_7_1_4, ChanMask_Surround_Stereo);
+}
+
+void BM_ChannelMapper_714_512(benchmark::State& state) {
+    bench_mapper(state, ChanMask_Surround_7_1_4, ChanMask_Surround_5_1_2);
+}
+
+BENCHMARK(BM_ChannelMapper_Mono_Stereo);
+BENCHMARK(BM_ChannelMapper_Stereo_Mono);
+BENCHMARK(BM_ChannelMapper_51_Stereo);
+BENCHMARK(BM_ChannelMapper_71_Stereo);
+BENCHMARK(BM_ChannelMapper_Mono_51);
+BENCHMARK(BM_ChannelMapper_31_Stereo);
+BENCHMARK(BM_ChannelMapper_714_Stereo);
+BENCHMARK(BM_ChannelMapper_714_512);
+
+} // namespace
+} // namespace audio
+} // namespace roc
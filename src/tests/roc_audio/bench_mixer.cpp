@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_audio/mixer.h"
+#include "roc_audio/mixer_kernel.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/worker_pool.h"
+
+namespace roc {
+namespace audio {
+namespace {
+
+enum { NumSamples = 480 * 2 };
+
+sample_t in_buf[NumSamples];
+sample_t out_buf[NumSamples];
+
+void fill_buffers() {
+    for (size_t n = 0; n < NumSamples; n++) {
+        in_buf[n] = (sample_t)core::fast_random_gaussian() * 0.3f;
+        out_buf[n] = (sample_t)core::fast_random_gaussian() * 0.3f;
+    }
+}
+
+void BM_MixerKernel(benchmark::State& state) {
+    const MixerKernel kernel = (MixerKernel)state.range(0);
+
+    MixerKernelFunc func = mixer_kernel_func(kernel);
+    if (!func) {
+        state.SkipWithError("kernel not supported");
+        return;
+    }
+
+    fill_buffers();
+
+    while (state.KeepRunning()) {
+        func(out_buf, in_buf, NumSamples);
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(mixer_kernel_to_str(kernel));
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+
+BENCHMARK(BM_MixerKernel)
+    ->Arg(MixerKernel_Scalar)
+    ->Arg(MixerKernel_SSE2)
+    ->Arg(MixerKernel_AVX)
+    ->Arg(MixerKernel_NEON);
+
+enum { NumInputs = 500, NumTalkers = 5, NumWorkers = 3 };
+
+// Produces low background noise, or speech-level signal for talkers.
+class NoiseReader : public IFrameReader {
+public:
+    NoiseReader()
+        : level_(0.001f) {
+    }
+
+    void set_talker() {
+        level_ = 0.3f;
+    }
+
+    virtual bool read(Frame& frame) {
+        sample_t* samples = frame.raw_samples();
+        for (size_t n = 0; n < frame.num_raw_samples(); n++) {
+            samples[n] = in_buf[n] * level_;
+        }
+        frame.set_flags(Frame::FlagNotBlank);
+        frame.set_duration(frame.num_raw_samples() / 2);
+        return true;
+    }
+
+private:
+    sample_t level_;
+};
+
+// Args: number of inputs.
+// Measures per-frame cost of serial mixing depending on number of inputs.
+void BM_Mixer_InputCount(benchmark::State& state) {
+    const size_t num_inputs = (size_t)state.range(0);
+
+    core::HeapArena arena;
+    FrameFactory frame_factory(arena, NumSamples * sizeof(sample_t));
+
+    const SampleSpec sample_spec(48000, Sample_RawFormat, ChanLayout_Surround,
+                                 ChanOrder_Smpte, ChanMask_Surround_Stereo);
+
+    Mixer mixer(frame_factory, sample_spec, false, MixerConfig(), NULL, arena);
+
+    fill_buffers();
+
+    // Readers are allocated separately, as sessions are, rather than in one array.
+    NoiseReader** readers = new NoiseReader*[num_inputs];
+    for (size_t n = 0; n < num_inputs; n++) {
+        readers[n] = new NoiseReader;
+        mixer.add_input(*readers[n]);
+    }
+
+    while (state.KeepRunning()) {
+        Frame frame(out_buf, NumSamples);
+        mixer.read(frame);
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    for (size_t n = 0; n < num_inputs; n++) {
+        mixer.remove_input(*readers[n]);
+        delete readers[n];
+    }
+    delete[] readers;
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)num_inputs);
+}
+
+BENCHMARK(BM_Mixer_InputCount)
+    ->RangeMultiplier(4)
+    ->Range(1, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// Args: number of workers, group size, max active inputs.
+void BM_Mixer_ManyInputs(benchmark::State& state) {
+    core::HeapArena arena;
+    FrameFactory frame_factory(arena, NumSamples * sizeof(sample_t));
+
+    const SampleSpec sample_spec(48000, Sample_RawFormat, ChanLayout_Surround,
+                                 ChanOrder_Smpte, ChanMask_Surround_Stereo);
+
+    MixerConfig config;
+    config.group_size = (size_t)state.range(1);
+    config.max_active_inputs = (size_t)state.range(2);
+
+    core::WorkerPool workers((size_t)state.range(0), arena);
+
+    Mixer mixer(frame_factory, sample_spec, false, config,
+                state.range(0) != 0 ? &workers : NULL, arena);
+
+    fill_buffers();
+
+    NoiseReader* readers = new NoiseReader[NumInputs];
+    for (size_t n = 0; n < NumInputs; n++) {
+        if (n % (NumInputs / NumTalkers) == 0) {
+            readers[n].set_talker();
+        }
+        mixer.add_input(readers[n]);
+    }
+
+    while (state.KeepRunning()) {
+        Frame frame(out_buf, NumSamples);
+        mixer.read(frame);
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    for (size_t n = 0; n < NumInputs; n++) {
+        mixer.remove_input(readers[n]);
+    }
+    delete[] readers;
+}
+
+BENCHMARK(BM_Mixer_ManyInputs)
+    ->Args({ 0, 1, 0 })
+    ->Args({ NumWorkers, 1, 0 })
+    ->Args({ NumWorkers, 32, 0 })
+    ->Args({ 0, 1, NumTalkers })
+    ->Args({ NumWorkers, 32, NumTalkers })
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_audio/pcm_mapper.h"
+#include "roc_core/fast_random.h"
+
+namespace roc {
+namespace audio {
+namespace {
+
+enum { NumSamples = 480 * 2, MaxBytes = NumSamples * 4 + 1 };
+
+enum Path {
+    // Byte-aligned offsets, vectorized path is used if available.
+    Path_Bulk,
+    // Offsets are not byte-aligned, generic per-sample path is always used.
+    Path_Generic
+};
+
+uint8_t in_buf[MaxBytes];
+uint8_t out_buf[MaxBytes];
+
+void fill_buffers(PcmFormat in_fmt) {
+    if (in_fmt == PcmFormat_Float32_Le) {
+        float* in_samples = (float*)in_buf;
+        for (size_t n = 0; n < NumSamples; n++) {
+            in_samples[n] = (float)core::fast_random_gaussian() * 0.3f;
+        }
+    } else {
+        for (size_t n = 0; n < MaxBytes; n++) {
+            in_buf[n] = (uint8_t)core::fast_random_range(0, 255);
+        }
+    }
+}
+
+void bench_mapper(benchmark::State& state, PcmFormat in_fmt, PcmFormat out_fmt) {
+    const Path path = (Path)state.range(0);
+
+    PcmMapper mapper(in_fmt, out_fmt);
+
+    fill_buffers(in_fmt);
+
+    const size_t start_off = (path == Path_Bulk ? 0 : 1);
+
+    while (state.KeepRunning()) {
+        size_t in_off = start_off;
+        size_t out_off = start_off;
+
+        mapper.map(in_buf, MaxBytes, in_off, out_buf, MaxBytes, out_off, NumSamples);
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(path == Path_Bulk ? "bulk" : "generic");
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+
+void BM_PcmMapper_S16Le_F32(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_SInt16_Le, PcmFormat_Float32_Le);
+}
+
+void BM_PcmMapper_S16Be_F32(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_SInt16_Be, PcmFormat_Float32_Le);
+}
+
+void BM_PcmMapper_S24Le_F32(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_SInt24_Le, PcmFormat_Float32_Le);
+}
+
+void BM_PcmMapper_S32Le_F32(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_SInt32_Le, PcmFormat_Float32_Le);
+}
+
+void BM_PcmMapper_F32_S16Le(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_Float32_Le, PcmFormat_SInt16_Le);
+}
+
+void BM_PcmMapper_F32_S16Be(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_Float32_Le, PcmFormat_SInt16_Be);
+}
+
+void BM_PcmMapper_F32_S24Le(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_Float32_Le, PcmFormat_SInt24_Le);
+}
+
+void BM_PcmMapper_F32_S32Le(benchmark::State& state) {
+    bench_mapper(state, PcmFormat_Float32_Le, PcmFormat_SInt32_Le);
+}
+
+BENCHMARK(BM_PcmMapper_S16Le_F32)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_S16Be_F32)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_S24Le_F32)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_S32Le_F32)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_F32_S16Le)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_F32_S16Be)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_F32_S24Le)->Arg(Path_Bulk)->Arg(Path_Generic);
+BENCHMARK(BM_PcmMapper_F32_S32Le)->Arg(Path_Bulk)->Arg(Path_Generic);
+
+} // namespace
+} // namespace audio
+} // namespace roc
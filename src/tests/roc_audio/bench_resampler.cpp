@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+
+namespace roc {
+namespace audio {
+namespace {
+
+enum {
+    MaxCh = 6,
+    OutFrameLen = 480,
+    InBufLen = 4800,
+    MaxBufSize = 8192,
+
+    // Quality is measured on output after warm-up, in windows,
+    // with tone frequency fitted separately in every window.
+    WarmupLen = 4096,
+    WindowLen = 2048,
+    NumWindows = 8,
+
+    // Number of harmonics included into THD.
+    NumHarmonics = 5
+};
+
+const float Scaling = 1.0005f;
+
+// Test tone frequency, in Hz.
+// Not a divisor of any tested rate, so that tone doesn't repeat in few samples.
+const double ToneFreq = 997;
+const double ToneAmp = 0.5;
+
+core::HeapArena arena;
+FrameFactory frame_factory(arena, MaxBufSize * sizeof(sample_t));
+
+sample_t in_buf[InBufLen * MaxCh];
+sample_t out_buf[OutFrameLen * MaxCh];
+sample_t quality_buf[(WarmupLen + WindowLen * NumWindows) * MaxCh];
+
+ChannelMask channel_mask(size_t n_ch) {
+    switch (n_ch) {
+    case 1:
+        return ChanMask_Surround_Mono;
+    case 2:
+        return ChanMask_Surround_Stereo;
+    default:
+        return ChanMask_Surround_5_1;
+    }
+}
+
+core::SharedPtr<IResampler> new_resampler(ResamplerBackend backend,
+                                          ResamplerProfile profile,
+                                          size_t in_rate,
+                                          size_t out_rate,
+                                          size_t n_ch) {
+    const SampleSpec in_spec(in_rate, Sample_RawFormat, ChanLayout_Surround,
+                             ChanOrder_Smpte, channel_mask(n_ch));
+    const SampleSpec out_spec(out_rate, Sample_RawFormat, ChanLayout_Surround,
+                              ChanOrder_Smpte, channel_mask(n_ch));
+
+    ResamplerConfig config;
+    config.backend = backend;
+    config.profile = profile;
+
+    return ResamplerMap::instance().new_resampler(arena, frame_factory, config, in_spec,
+                                                  out_spec);
+}
+
+// Input of resampler: either pre-generated noise, or sine tone in all channels.
+class InputGenerator {
+public:
+    InputGenerator(size_t n_ch, double tone_freq)
+        : n_ch_(n_ch)
+        , tone_freq_(tone_freq)
+        , pos_(0) {
+    }
+
+    void fill(const core::Slice<sample_t>& buf) {
+        sample_t* data = buf.data();
+
+        for (size_t n = 0; n < buf.size(); n += n_ch_) {
+            for (size_t c = 0; c < n_ch_; c++) {
+                if (tone_freq_ != 0) {
+                    const double phase = 2 * M_PI * tone_freq_ * double(pos_);
+                    data[n + c] = sample_t(ToneAmp * std::sin(phase));
+                } else {
+                    data[n + c] = in_buf[(pos_ % InBufLen) * n_ch_ + c];
+                }
+            }
+            pos_++;
+        }
+    }
+
+private:
+    const size_t n_ch_;
+    // Tone frequency in cycles per input sample, or 0 for noise.
+    const double tone_freq_;
+    size_t pos_;
+};
+
+void fill_noise() {
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(in_buf); n++) {
+        in_buf[n] = (sample_t)core::fast_random_gaussian() * 0.3f;
+    }
+}
+
+void resample(IResampler& resampler,
+              InputGenerator& input,
+              sample_t* out_data,
+              size_t out_size) {
+    size_t out_pos = 0;
+
+    while (out_pos < out_size) {
+        out_pos += resampler.pop_output(out_data + out_pos, out_size - out_pos);
+
+        if (out_pos < out_size) {
+            input.fill(resampler.begin_push_input());
+            resampler.end_push_input();
+        }
+    }
+}
+
+// Least-squares fit of a*sin + b*cos at given frequency (cycles per sample).
+// Subtracts fitted tone from window and returns its energy.
+double remove_tone(double* window, double freq) {
+    double ss = 0, cc = 0, sc = 0, xs = 0, xc = 0;
+
+    for (size_t n = 0; n < WindowLen; n++) {
+        const double s = std::sin(2 * M_PI * freq * double(n));
+        const double c = std::cos(2 * M_PI * freq * double(n));
+
+        ss += s * s;
+        cc += c * c;
+        sc += s * c;
+        xs += window[n] * s;
+        xc += window[n] * c;
+    }
+
+    const double det = ss * cc - sc * sc;
+    if (det <= 0) {
+        return 0;
+    }
+
+    const double a = (xs * cc - xc * sc) / det;
+    const double b = (xc * ss - xs * sc) / det;
+
+    for (size_t n = 0; n < WindowLen; n++) {
+        window[n] -= a * std::sin(2 * M_PI * freq * double(n))
+            + b * std::cos(2 * M_PI * freq * double(n));
+    }
+
+    // For least-squares fit, energy of fit equals its projection on signal.
+    return a * xs + b * xc;
+}
+
+// Energy of least-squares fit, without modifying window.
+double tone_energy(const double* window, double freq) {
+    double copy[WindowLen];
+    memcpy(copy, window, sizeof(copy));
+    return remove_tone(copy, freq);
+}
+
+// Find frequency of tone near expected, as one with maximum fit energy.
+double find_tone(const double* window, double expected_freq) {
+    const double golden = 0.6180339887;
+
+    double lo = expected_freq * 0.998, hi = expected_freq * 1.002;
+
+    for (int iter = 0; iter < 40; iter++) {
+        const double f1 = hi - (hi - lo) * golden;
+        const double f2 = lo + (hi - lo) * golden;
+
+        if (tone_energy(window, f1) > tone_energy(window, f2)) {
+            hi = f2;
+        } else {
+            lo = f1;
+        }
+    }
+
+    return (lo + hi) / 2;
+}
+
+// Resample test tone and measure SNR (tone to everything else, i.e. noise
+// and distortion) and THD (harmonics to tone), in dB.
+bool measure_quality(ResamplerBackend backend,
+                     ResamplerProfile profile,
+                     size_t in_rate,
+                     size_t out_rate,
+                     size_t n_ch,
+                     double& snr_db,
+                     double& thd_db) {
+    core::SharedPtr<IResampler> resampler =
+        new_resampler(backend, profile, in_rate, out_rate, n_ch);
+    if (!resampler || !resampler->set_scaling(in_rate, out_rate, Scaling)) {
+        return false;
+    }
+
+    InputGenerator input(n_ch, ToneFreq / in_rate);
+    resample(*resampler, input, quality_buf,
+             (WarmupLen + WindowLen * NumWindows) * n_ch);
+
+    // Resampler stretches input by scaling factor.
+    const double expected_freq = ToneFreq * (double)Scaling / out_rate;
+
+    double tone = 0, noise = 0, harmonics = 0;
+
+    for (size_t w = 0; w < NumWindows; w++) {
+        for (size_t c = 0; c < n_ch; c++) {
+            const sample_t* samples =
+                quality_buf + (WarmupLen + w * WindowLen) * n_ch + c;
+
+            double window[WindowLen];
+            double total = 0;
+
+            for (size_t n = 0; n < WindowLen; n++) {
+                window[n] = samples[n * n_ch];
+                total += window[n] * window[n];
+            }
+
+            const double freq = find_tone(window, expected_freq);
+            const double energy = remove_tone(window, freq);
+
+            tone += energy;
+            noise += total - energy;
+
+            // Harmonics are fitted on residual, to exclude leakage of tone.
+            for (size_t h = 2; h <= NumHarmonics && freq * h < 0.5; h++) {
+                harmonics += remove_tone(window, freq * h);
+            }
+        }
+    }
+
+    // Clamp to numerical noise floor.
+    const double floor = tone * 1e-15;
+
+    snr_db = 10 * std::log10(tone / std::max(noise, floor));
+    thd_db = 10 * std::log10(std::max(harmonics, floor) / tone);
+
+    return true;
+}
+
+void BM_Resampler(benchmark::State& state) {
+    const ResamplerBackend backend = (ResamplerBackend)state.range(0);
+    const ResamplerProfile profile = (ResamplerProfile)state.range(1);
+    const size_t in_rate = (size_t)state.range(2);
+    const size_t out_rate = (size_t)state.range(3);
+    const size_t n_ch = (size_t)state.range(4);
+    // Maximum deviation of scaling, in ppm.
+    const size_t jitter = (size_t)state.range(5);
+
+    if (!ResamplerMap::instance().is_supported(backend)) {
+        state.SkipWithError("backend not supported");
+        return;
+    }
+
+    core::SharedPtr<IResampler> resampler =
+        new_resampler(backend, profile, in_rate, out_rate, n_ch);
+    if (!resampler) {
+        state.SkipWithError("can't create resampler");
+        return;
+    }
+    if (!resampler->set_scaling(in_rate, out_rate, Scaling)) {
+        state.SkipWithError("can't set scaling");
+        return;
+    }
+
+    fill_noise();
+
+    InputGenerator input(n_ch, 0);
+
+    while (state.KeepRunning()) {
+        if (jitter != 0) {
+            // Scaling is updated every frame, like in receiver pipeline.
+            const float deviation = float((int)core::fast_random_range(0, jitter * 2)
+                                          - (int)jitter)
+                / 1e6f;
+            if (!resampler->set_scaling(in_rate, out_rate, Scaling + deviation)) {
+                state.SkipWithError("can't set scaling");
+                return;
+            }
+        }
+
+        resample(*resampler, input, out_buf, OutFrameLen * n_ch);
+
+        benchmark::DoNotOptimize(out_buf);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string(resampler_backend_to_str(backend)) + "/"
+                   + resampler_profile_to_str(profile));
+    state.SetItemsProcessed(state.iterations() * OutFrameLen);
+
+    // Time per output sample of all channels.
+    state.counters["time_per_sample"] = benchmark::Counter(
+        double(OutFrameLen * n_ch),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+
+    // Quality depends on filter, not on jitter, and is measured
+    // at constant scaling.
+    double snr_db = 0, thd_db = 0;
+    if (measure_quality(backend, profile, in_rate, out_rate, n_ch, snr_db, thd_db)) {
+        state.counters["snr_db"] = snr_db;
+        state.counters["thd_db"] = thd_db;
+    }
+}
+
+void resampler_args(benchmark::internal::Benchmark* b) {
+    const int backends[] = { ResamplerBackend_Builtin, ResamplerBackend_BuiltinFixed,
+                             ResamplerBackend_BuiltinPolyphase, ResamplerBackend_Speex,
+                             ResamplerBackend_SpeexDec };
+    const int profiles[] = { ResamplerProfile_Low, ResamplerProfile_Medium,
+                             ResamplerProfile_High };
+    // same rate (only scaling), rate conversion, and integer ratio conversion
+    const int in_rates[] = { 48000, 44100, 96000 };
+    const int channels[] = { 1, 2, 6 };
+    // no jitter, and typical jitter of receiver latency tuner
+    const int jitters[] = { 0, 500 };
+
+    std::vector<std::string> names;
+    names.push_back("backend");
+    names.push_back("profile");
+    names.push_back("in_rate");
+    names.push_back("out_rate");
+    names.push_back("n_ch");
+    names.push_back("jitter_ppm");
+    b->ArgNames(names);
+
+    for (size_t n_bk = 0; n_bk < ROC_ARRAY_SIZE(backends); n_bk++) {
+        for (size_t n_pr = 0; n_pr < ROC_ARRAY_SIZE(profiles); n_pr++) {
+            for (size_t n_rate = 0; n_rate < ROC_ARRAY_SIZE(in_rates); n_rate++) {
+                for (size_t n_ch = 0; n_ch < ROC_ARRAY_SIZE(channels); n_ch++) {
+                    for (size_t n_jt = 0; n_jt < ROC_ARRAY_SIZE(jitters); n_jt++) {
+                        std::vector<int64_t> args;
+                        args.push_back(backends[n_bk]);
+                        args.push_back(profiles[n_pr]);
+                        args.push_back(in_rates[n_rate]);
+                        args.push_back(48000);
+                        args.push_back(channels[n_ch]);
+                        args.push_back(jitters[n_jt]);
+                        b->Args(args);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_Resampler)->Apply(resampler_args)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace audio
+} // namespace roc
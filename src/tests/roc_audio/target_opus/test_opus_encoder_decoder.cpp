@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/opus_decoder.h"
+#include "roc_audio/opus_encoder.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/scoped_ptr.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 48000,
+    NumChans = 2,
+    SamplesPerFrame = 480, // 10ms
+    Bitrate = 96000,
+    MaxBytes = 2000
+};
+
+core::HeapArena arena;
+
+SampleSpec make_spec(ChannelMask mask = ChanMask_Surround_Stereo) {
+    SampleSpec spec;
+    spec.set_sample_format(SampleFormat_Opus);
+    spec.set_sample_rate(SampleRate);
+    spec.channel_set().set_layout(ChanLayout_Surround);
+    spec.channel_set().set_order(ChanOrder_Smpte);
+    spec.channel_set().set_mask(mask);
+    return spec;
+}
+
+FrameEncoderConfig make_config() {
+    FrameEncoderConfig config;
+    config.bitrate = Bitrate;
+    return config;
+}
+
+void fill_samples(sample_t* samples, size_t n_samples, size_t offset) {
+    for (size_t n = 0; n < n_samples; n++) {
+        for (size_t c = 0; c < NumChans; c++) {
+            samples[n * NumChans + c] = sample_t((offset + n) % 100) / 200;
+        }
+    }
+}
+
+size_t encode_frame(IFrameEncoder& encoder,
+                    uint8_t* data,
+                    size_t n_samples,
+                    size_t offset) {
+    sample_t samples[SamplesPerFrame * NumChans];
+    fill_samples(samples, n_samples, offset);
+
+    const size_t n_bytes = encoder.encoded_byte_count(n_samples);
+    CHECK(n_bytes <= MaxBytes);
+
+    encoder.begin(data, n_bytes);
+    UNSIGNED_LONGS_EQUAL(n_samples, encoder.write(samples, n_samples));
+    encoder.end();
+
+    return n_bytes;
+}
+
+// Encodes and decodes tone in one channel, and checks that decoded
+// tone is in the same channel.
+void check_surround_channel(ChannelMask mask, size_t tone_chan) {
+    enum { NumFrames = 10, MaxChans = 8 };
+
+    const SampleSpec spec = make_spec(mask);
+    const size_t n_chans = spec.num_channels();
+
+    FrameEncoderConfig config;
+    core::ScopedPtr<IFrameEncoder> encoder(OpusEncoder::construct(arena, spec, config),
+                                           arena);
+    CHECK(encoder);
+
+    core::ScopedPtr<IFrameDecoder> decoder(OpusDecoder::construct(arena, spec), arena);
+    CHECK(decoder);
+
+    double energy[MaxChans] = {};
+
+    for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+        sample_t samples[SamplesPerFrame * MaxChans] = {};
+        for (size_t n = 0; n < SamplesPerFrame; n++) {
+            const double pos = double(n_frame * SamplesPerFrame + n);
+            samples[n * n_chans + tone_chan] =
+                sample_t(0.5 * std::sin(2 * M_PI * 1000 * pos / SampleRate));
+        }
+
+        uint8_t data[MaxBytes] = {};
+        const size_t n_bytes = encoder->encoded_byte_count(SamplesPerFrame);
+        CHECK(n_bytes <= MaxBytes);
+
+        encoder->begin(data, n_bytes);
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame, encoder->write(samples, SamplesPerFrame));
+        UNSIGNED_LONGS_EQUAL(n_bytes, encoder->end());
+
+        decoder->begin(packet::stream_timestamp_t(n_frame * SamplesPerFrame), data,
+                       n_bytes);
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder->read(samples, SamplesPerFrame));
+        decoder->end();
+
+        // Skip codec warm-up.
+        if (n_frame < NumFrames / 2) {
+            continue;
+        }
+
+        for (size_t n = 0; n < SamplesPerFrame; n++) {
+            for (size_t c = 0; c < n_chans; c++) {
+                energy[c] += double(samples[n * n_chans + c] * samples[n * n_chans + c]);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < n_chans; c++) {
+        if (c != tone_chan) {
+            CHECK(energy[tone_chan] > energy[c] * 100);
+        }
+    }
+}
+
+} // namespace
+
+TEST_GROUP(opus_encoder_decoder) {};
+
+TEST(opus_encoder_decoder, invalid_spec) {
+    SampleSpec spec = make_spec();
+    spec.set_sample_rate(44100);
+
+    core::ScopedPtr<IFrameEncoder> encoder(
+        OpusEncoder::construct(arena, spec, make_config()), arena);
+    CHECK(!encoder);
+}
+
+TEST(opus_encoder_decoder, unsupported_channels) {
+    const SampleSpec spec = make_spec(ChanMask_Surround_5_1_2);
+
+    core::ScopedPtr<IFrameEncoder> encoder(
+        OpusEncoder::construct(arena, spec, make_config()), arena);
+    CHECK(!encoder);
+
+    core::ScopedPtr<IFrameDecoder> decoder(OpusDecoder::construct(arena, spec), arena);
+    CHECK(!decoder);
+}
+
+TEST(opus_encoder_decoder, encoded_size) {
+    core::ScopedPtr<IFrameEncoder> encoder(
+        OpusEncoder::construct(arena, make_spec(), make_config()), arena);
+    CHECK(encoder);
+
+    // Constant bitrate.
+    UNSIGNED_LONGS_EQUAL(Bitrate * SamplesPerFrame / SampleRate / 8,
+                         encoder->encoded_byte_count(SamplesPerFrame));
+
+    // Rounded up to valid frame duration.
+    UNSIGNED_LONGS_EQUAL(encoder->encoded_byte_count(SamplesPerFrame),
+                         encoder->encoded_byte_count(SamplesPerFrame - 100));
+}
+
+TEST(opus_encoder_decoder, round_trip) {
+    enum { Timestamp = 100500, NumFrames = 10 };
+
+    core::ScopedPtr<IFrameEncoder> encoder(
+        OpusEncoder::construct(arena, make_spec(), make_config()), arena);
+    CHECK(encoder);
+
+    core::ScopedPtr<IFrameDecoder> decoder(OpusDecoder::construct(arena, make_spec()),
+                                           arena);
+    CHECK(decoder);
+
+    for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+        uint8_t data[MaxBytes] = {};
+        const size_t n_bytes =
+            encode_frame(*encoder, data, SamplesPerFrame, n_frame * SamplesPerFrame);
+
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame,
+                             decoder->decoded_sample_count(data, n_bytes));
+
+        const packet::stream_timestamp_t pos =
+            packet::stream_timestamp_t(Timestamp + n_frame * SamplesPerFrame);
+
+        decoder->begin(pos, data, n_bytes);
+
+        UNSIGNED_LONGS_EQUAL(pos, decoder->position());
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder->available());
+
+        sample_t samples[SamplesPerFrame * NumChans];
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame / 2,
+                             decoder->read(samples, SamplesPerFrame / 2));
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame / 2, decoder->shift(SamplesPerFrame));
+
+        UNSIGNED_LONGS_EQUAL(pos + SamplesPerFrame, decoder->position());
+        UNSIGNED_LONGS_EQUAL(0, decoder->available());
+
+        decoder->end();
+    }
+}
+
+TEST(opus_encoder_decoder, conceal) {
+    core::ScopedPtr<IFrameEncoder> encoder(
+        OpusEncoder::construct(arena, make_spec(), make_config()), arena);
+    CHECK(encoder);
+
+    core::ScopedPtr<IFrameDecoder> decoder(OpusDecoder::construct(arena, make_spec()),
+                                           arena);
+    CHECK(decoder);
+
+    sample_t samples[SamplesPerFrame * 3 * NumChans];
+
+    // Nothing decoded yet, nothing to conceal.
+    UNSIGNED_LONGS_EQUAL(0, decoder->conceal(samples, SamplesPerFrame));
+
+    uint8_t data[MaxBytes] = {};
+    const size_t n_bytes = encode_frame(*encoder, data, SamplesPerFrame, 0);
+
+    decoder->begin(0, data, n_bytes);
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder->read(samples, SamplesPerFrame));
+    decoder->end();
+
+    // Concealment spans several lost frames.
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame * 3,
+                         decoder->conceal(samples, SamplesPerFrame * 3));
+}
+
+TEST(opus_encoder_decoder, surround_5_1) {
+    // SMPTE order: FL, FR, FC, LFE, BL, BR.
+    // LFE is low-passed by encoder and is not checked.
+    const size_t chans[] = { 0, 1, 2, 4, 5 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chans); n++) {
+        check_surround_channel(ChanMask_Surround_5_1, chans[n]);
+    }
+}
+
+TEST(opus_encoder_decoder, surround_7_1) {
+    // SMPTE order: FL, FR, FC, LFE, BL, BR, SL, SR.
+    const size_t chans[] = { 0, 1, 2, 4, 5, 6, 7 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chans); n++) {
+        check_surround_channel(ChanMask_Surround_7_1, chans[n]);
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -1441,5 +1441,134 @@ TEST(channel_mapper, multitrack_overlap) {
           ChanLayout_Multitrack, ChanOrder_None, OutChans);
 }
 
+// specialized kernels for common channel counts should produce same
+// result as generic matrix multiplication
+TEST(channel_mapper, surround_fixed_kernels) {
+    enum { NumSamples = 20 };
+
+    const ChannelMask masks[][2] = {
+        { ChanMask_Surround_Mono, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_Stereo, ChanMask_Surround_Mono },
+        { ChanMask_Surround_Stereo, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_5_1, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_Stereo, ChanMask_Surround_5_1 },
+        { ChanMask_Surround_Mono, ChanMask_Surround_5_1 },
+        { ChanMask_Surround_7_1, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_6_0, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_7_0, ChanMask_Surround_Stereo },
+        // not specialized
+        { ChanMask_Surround_3_1, ChanMask_Surround_Stereo },
+    };
+
+    for (size_t n_pair = 0; n_pair < ROC_ARRAY_SIZE(masks); n_pair++) {
+        for (size_t n_order = 0; n_order < 2; n_order++) {
+            ChannelSet in_chans;
+            in_chans.set_layout(ChanLayout_Surround);
+            in_chans.set_order(ChanOrder_Smpte);
+            in_chans.set_mask(masks[n_pair][0]);
+
+            ChannelSet out_chans;
+            out_chans.set_layout(ChanLayout_Surround);
+            out_chans.set_order(n_order == 0 ? ChanOrder_Smpte : ChanOrder_Alsa);
+            out_chans.set_mask(masks[n_pair][1]);
+
+            const size_t in_n = in_chans.num_channels();
+            const size_t out_n = out_chans.num_channels();
+
+            sample_t input[NumSamples * ChanPos_Max] = {};
+            for (size_t n = 0; n < NumSamples * in_n; n++) {
+                input[n] = (sample_t)((n * 7) % 23) / 23.0f - 0.5f;
+            }
+
+            ChannelMapperMatrix matrix;
+            matrix.build(in_chans, out_chans);
+
+            sample_t expected[NumSamples * ChanPos_Max] = {};
+            for (size_t ns = 0; ns < NumSamples; ns++) {
+                for (size_t out_ch = 0; out_ch < out_n; out_ch++) {
+                    sample_t s = 0;
+                    for (size_t in_ch = 0; in_ch < in_n; in_ch++) {
+                        s += input[ns * in_n + in_ch] * matrix.coeff(out_ch, in_ch);
+                    }
+                    expected[ns * out_n + out_ch] =
+                        std::max(std::min(s, Sample_Max), Sample_Min);
+                }
+            }
+
+            sample_t actual[NumSamples * ChanPos_Max] = {};
+
+            ChannelMapper mapper(in_chans, out_chans);
+            mapper.map(input, NumSamples * in_n, actual, NumSamples * out_n);
+
+            for (size_t n = 0; n < NumSamples * out_n; n++) {
+                DOUBLES_EQUAL((double)expected[n], (double)actual[n], 1e-6);
+            }
+        }
+    }
+}
+
+// generic kernel processes samples in chunks; result should not depend
+// on chunk boundaries
+TEST(channel_mapper, surround_generic_kernel_chunks) {
+    enum { NumSamples = 150 };
+
+    const ChannelMask masks[][2] = {
+        { ChanMask_Surround_3_1, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_7_1_4, ChanMask_Surround_Stereo },
+        { ChanMask_Surround_7_1_4, ChanMask_Surround_5_1_2 },
+        { ChanMask_Surround_5_1_2, ChanMask_Surround_7_1_4_3c },
+    };
+
+    const size_t sizes[] = { 1, 63, 64, 65, 128, NumSamples };
+
+    for (size_t n_pair = 0; n_pair < ROC_ARRAY_SIZE(masks); n_pair++) {
+        ChannelSet in_chans;
+        in_chans.set_layout(ChanLayout_Surround);
+        in_chans.set_order(ChanOrder_Smpte);
+        in_chans.set_mask(masks[n_pair][0]);
+
+        ChannelSet out_chans;
+        out_chans.set_layout(ChanLayout_Surround);
+        out_chans.set_order(ChanOrder_Smpte);
+        out_chans.set_mask(masks[n_pair][1]);
+
+        const size_t in_n = in_chans.num_channels();
+        const size_t out_n = out_chans.num_channels();
+
+        sample_t input[NumSamples * ChanPos_Max] = {};
+        for (size_t n = 0; n < NumSamples * in_n; n++) {
+            input[n] = (sample_t)((n * 7) % 23) / 23.0f - 0.5f;
+        }
+
+        ChannelMapperMatrix matrix;
+        matrix.build(in_chans, out_chans);
+
+        sample_t expected[NumSamples * ChanPos_Max] = {};
+        for (size_t ns = 0; ns < NumSamples; ns++) {
+            for (size_t out_ch = 0; out_ch < out_n; out_ch++) {
+                sample_t s = 0;
+                for (size_t in_ch = 0; in_ch < in_n; in_ch++) {
+                    s += input[ns * in_n + in_ch] * matrix.coeff(out_ch, in_ch);
+                }
+                expected[ns * out_n + out_ch] =
+                    std::max(std::min(s, Sample_Max), Sample_Min);
+            }
+        }
+
+        for (size_t n_size = 0; n_size < ROC_ARRAY_SIZE(sizes); n_size++) {
+            const size_t size = sizes[n_size];
+
+            sample_t actual[NumSamples * ChanPos_Max] = {};
+
+            ChannelMapper mapper(in_chans, out_chans);
+            mapper.map(input, size * in_n, actual, size * out_n);
+
+            for (size_t n = 0; n < size * out_n; n++) {
+                DOUBLES_EQUAL((double)expected[n], (double)actual[n], 1e-6);
+            }
+        }
+    }
+}
+
 } // namespace audio
 } // namespace roc
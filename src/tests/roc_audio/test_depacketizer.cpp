@@ -272,6 +272,53 @@ TEST(depacketizer, multiple_packets_multiple_reads) {
     }
 }
 
+TEST(depacketizer, multiple_packets_one_read_with_gap) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, frame_spec, false);
+    CHECK(dp.is_valid());
+
+    const sample_t values[] = { 0.11f, 0.22f, 0.33f, 0.00f, 0.55f, 0.66f };
+
+    // Packet 3 is lost, packet 1 is duplicated.
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(values); n++) {
+        if (n == 3) {
+            continue;
+        }
+        const packet::stream_timestamp_t ts =
+            packet::stream_timestamp_t(n * SamplesPerPacket);
+        LONGS_EQUAL(status::StatusOK,
+                    queue.write(new_packet(encoder, ts, values[n],
+                                           Now + NsPerPacket * (int64_t)n)));
+        if (n == 1) {
+            LONGS_EQUAL(status::StatusOK,
+                        queue.write(new_packet(encoder, SamplesPerPacket, 0.99f,
+                                               Now + NsPerPacket)));
+        }
+    }
+
+    expect_output(dp, SamplesPerPacket, 0.11f, Now);
+
+    const size_t frame_size = (ROC_ARRAY_SIZE(values) - 1) * SamplesPerPacket;
+
+    core::Slice<sample_t> buf = new_buffer(frame_size);
+    Frame frame(buf.data(), buf.size());
+    CHECK(dp.read(frame));
+
+    CHECK(core::ns_equal_delta(frame.capture_timestamp(), Now + NsPerPacket,
+                               core::Microsecond));
+    UNSIGNED_LONGS_EQUAL(Frame::FlagNotBlank | Frame::FlagNotComplete
+                             | Frame::FlagPacketDrops,
+                         frame.flags());
+
+    for (size_t n = 1; n < ROC_ARRAY_SIZE(values); n++) {
+        expect_values(frame.raw_samples() + (n - 1) * SamplesSize, SamplesSize,
+                      values[n]);
+    }
+}
+
 TEST(depacketizer, timestamp_overflow) {
     PcmEncoder encoder(packet_spec);
     PcmDecoder decoder(packet_spec);
@@ -391,6 +438,75 @@ TEST(depacketizer, zeros_between_packets) {
     expect_output(dp, SamplesPerPacket, 0.33f, Now + 2 * NsPerPacket);
 }
 
+TEST(depacketizer, concealment_between_packets) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    LossConcealerConfig config;
+    config.max_duration = NsPerPacket * 2;
+    config.fade_duration = 0;
+
+    LossConcealer concealer(frame_spec, config, arena);
+    CHECK(concealer.is_valid());
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, frame_spec, false, &concealer);
+    CHECK(dp.is_valid());
+
+    LONGS_EQUAL(status::StatusOK,
+                queue.write(new_packet(encoder, 1 * SamplesPerPacket, 0.11f, Now)));
+    LONGS_EQUAL(status::StatusOK, queue.write(new_packet(encoder, 3 * SamplesPerPacket,
+                                                         0.33f, Now + NsPerPacket * 2)));
+
+    expect_output(dp, SamplesPerPacket, 0.11f, Now);
+
+    // Lost packet is concealed with fading signal of previous packet.
+    core::Slice<sample_t> buf = new_buffer(SamplesPerPacket);
+    Frame frame(buf.data(), buf.size());
+    CHECK(dp.read(frame));
+
+    for (size_t ns = 0; ns < SamplesPerPacket; ns++) {
+        const double gain = 1 - (double)ns / (SamplesPerPacket * 2);
+        for (size_t nc = 0; nc < NumCh; nc++) {
+            DOUBLES_EQUAL(0.11 * gain, frame.raw_samples()[ns * NumCh + nc], 0.0001);
+        }
+    }
+
+    // Concealed samples are not decoded samples.
+    UNSIGNED_LONGS_EQUAL(Frame::FlagNotComplete, frame.flags());
+
+    expect_output(dp, SamplesPerPacket, 0.33f, Now + 2 * NsPerPacket);
+
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket, dp.concealed_samples());
+}
+
+TEST(depacketizer, silence_between_packets) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, frame_spec, false);
+    CHECK(dp.is_valid());
+
+    // Sender suppressed silence: gap in timestamps, but not in seqnums.
+    packet::PacketPtr pp1 = new_packet(encoder, 1 * SamplesPerPacket, 0.11f, Now);
+    packet::PacketPtr pp2 =
+        new_packet(encoder, 3 * SamplesPerPacket, 0.33f, Now + NsPerPacket * 2);
+
+    pp1->rtp()->seqnum = 100;
+    pp2->rtp()->seqnum = 101;
+    pp2->rtp()->marker = true;
+
+    LONGS_EQUAL(status::StatusOK, queue.write(pp1));
+    LONGS_EQUAL(status::StatusOK, queue.write(pp2));
+
+    expect_output(dp, SamplesPerPacket, 0.11f, Now);
+    // Intended silence is not reported as blank or incomplete, but is silent.
+    expect_flags(dp, SamplesPerPacket, Frame::FlagNotBlank | Frame::FlagSilent,
+                 Now + NsPerPacket);
+    expect_output(dp, SamplesPerPacket, 0.33f, Now + 2 * NsPerPacket);
+}
+
 TEST(depacketizer, zeros_between_packets_timestamp_overflow) {
     PcmEncoder encoder(packet_spec);
     PcmDecoder decoder(packet_spec);
@@ -541,9 +657,9 @@ TEST(depacketizer, frame_flags_incompltete_blank) {
         Frame::FlagNotComplete | Frame::FlagNotBlank,
         Frame::FlagNotComplete | Frame::FlagNotBlank,
         Frame::FlagNotComplete | Frame::FlagNotBlank,
-        Frame::FlagNotComplete,
+        Frame::FlagNotComplete | Frame::FlagSilent,
         Frame::FlagNotBlank,
-        Frame::FlagNotComplete,
+        Frame::FlagNotComplete | Frame::FlagSilent,
     };
 
     core::nanoseconds_t capt_ts[] = {
@@ -586,11 +702,11 @@ TEST(depacketizer, frame_flags_drops) {
     };
 
     unsigned frame_flags[] = {
-        Frame::FlagNotBlank,                             //
-        Frame::FlagNotBlank | Frame::FlagPacketDrops,    //
-        Frame::FlagNotBlank,                             //
-        Frame::FlagNotComplete | Frame::FlagPacketDrops, //
-        Frame::FlagNotBlank,                             //
+        Frame::FlagNotBlank,                                                  //
+        Frame::FlagNotBlank | Frame::FlagPacketDrops,                         //
+        Frame::FlagNotBlank,                                                  //
+        Frame::FlagNotComplete | Frame::FlagPacketDrops | Frame::FlagSilent, //
+        Frame::FlagNotBlank,                                                  //
     };
 
     for (size_t n = 0; n < ROC_ARRAY_SIZE(packets); n++) {
@@ -602,6 +718,27 @@ TEST(depacketizer, frame_flags_drops) {
     }
 }
 
+TEST(depacketizer, beep) {
+    enum { FrameSz = 2000 };
+
+    packet::Queue queue;
+    PcmDecoder decoder(packet_spec);
+    Depacketizer dp(queue, decoder, frame_spec, true);
+    CHECK(dp.is_valid());
+
+    // Frame is longer than beep period, so beep wraps around.
+    core::Slice<sample_t> buf = new_buffer(FrameSz);
+    Frame frame(buf.data(), buf.size());
+    CHECK(dp.read(frame));
+
+    for (size_t n = 0; n < frame.num_raw_samples(); n++) {
+        DOUBLES_EQUAL(std::sin(2 * M_PI / 44100 * 880 * n), frame.raw_samples()[n],
+                      0.0001);
+    }
+
+    UNSIGNED_LONGS_EQUAL(Frame::FlagNotComplete, frame.flags());
+}
+
 TEST(depacketizer, timestamp) {
     enum {
         StartTimestamp = 1000,
@@ -14,6 +14,7 @@
 #include "roc_audio/frame_factory.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/worker_pool.h"
 
 namespace roc {
 namespace audio {
@@ -130,5 +131,41 @@ TEST(fanout, has_output) {
     CHECK(!fanout.has_output(writer));
 }
 
+TEST(fanout, parallel_many_outputs) {
+    enum { NumWriters = 10, NumWorkers = 3 };
+
+    test::MockWriter writers[NumWriters];
+
+    core::WorkerPool workers(NumWorkers, arena);
+    CHECK(workers.is_valid());
+
+    Fanout fanout(workers, arena);
+
+    for (size_t n = 0; n < NumWriters; n++) {
+        fanout.add_output(writers[n]);
+    }
+
+    write_frame(fanout, BufSz, 0.11f);
+
+    for (size_t n = 0; n < NumWriters; n++) {
+        CHECK(writers[n].num_unread() == BufSz);
+        expect_written(writers[n], BufSz, 0.11f);
+    }
+
+    fanout.remove_output(writers[0]);
+    fanout.remove_output(writers[5]);
+
+    write_frame(fanout, BufSz, 0.22f);
+
+    for (size_t n = 0; n < NumWriters; n++) {
+        if (n == 0 || n == 5) {
+            CHECK(writers[n].num_unread() == 0);
+        } else {
+            CHECK(writers[n].num_unread() == BufSz);
+            expect_written(writers[n], BufSz, 0.22f);
+        }
+    }
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/feedback_monitor.h"
+#include "roc_audio/frame_factory.h"
+#include "roc_audio/packetizer.h"
+#include "roc_audio/pcm_encoder.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_audio/resampler_writer.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/optional.h"
+#include "roc_core/time.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/identity.h"
+#include "roc_rtp/sequencer.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 44100,
+    NumCh = 2,
+    ChMask = 0x3,
+
+    SamplesPerFrame = 441,
+    MaxBufSize = 4000,
+
+    PayloadType = 123
+};
+
+const core::nanoseconds_t FrameDuration = SamplesPerFrame * core::Second / SampleRate;
+
+const core::nanoseconds_t TargetLatency = 40 * core::Millisecond;
+
+const SampleSpec frame_spec(
+    SampleRate, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+const SampleSpec packet_spec(
+    SampleRate, PcmFormat_SInt16_Be, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxBufSize);
+FrameFactory frame_factory(arena, MaxBufSize * sizeof(sample_t));
+
+rtp::Composer rtp_composer(NULL);
+
+// Counts duration of frames produced by sender.
+class DurationCounter : public IFrameWriter {
+public:
+    DurationCounter()
+        : duration_(0) {
+    }
+
+    core::nanoseconds_t duration() const {
+        return duration_;
+    }
+
+    virtual void write(Frame& frame) {
+        duration_ += frame_spec.samples_overall_2_ns(frame.num_raw_samples());
+    }
+
+private:
+    core::nanoseconds_t duration_;
+};
+
+// Sender with latency tuning, connected to simulated receiver without it.
+// Receiver queue grows by what sender produces and shrinks by what receiver
+// plays. Receiver clock is faster than sender clock by given drift.
+class Simulator {
+public:
+    Simulator(const FeedbackConfig& feedback_config,
+              double drift,
+              bool locked_clocks = false)
+        : encoder_(packet_spec)
+        , sequencer_(identity_, PayloadType)
+        , packetizer_(packet_queue_,
+                      rtp_composer,
+                      sequencer_,
+                      encoder_,
+                      packet_factory,
+                      FrameDuration,
+                      frame_spec)
+        , drift_(drift)
+        , queue_(TargetLatency)
+        , n_frames_(0) {
+        CHECK(packetizer_.is_valid());
+
+        ResamplerConfig resampler_config;
+        resampler_config.backend = ResamplerBackend_Builtin;
+        resampler_config.profile = ResamplerProfile_Low;
+
+        resampler_ = ResamplerMap::instance().new_resampler(
+            arena, frame_factory, resampler_config, frame_spec, frame_spec);
+        CHECK(resampler_);
+
+        resampler_writer_.reset(new (resampler_writer_) ResamplerWriter(
+            counter_, *resampler_, frame_factory, frame_spec, frame_spec));
+        CHECK(resampler_writer_->is_valid());
+
+        LatencyConfig latency_config;
+        latency_config.tuner_backend = LatencyTunerBackend_Niq;
+        latency_config.tuner_profile = LatencyTunerProfile_Responsive;
+        latency_config.target_latency = TargetLatency;
+        latency_config.locked_clocks = locked_clocks;
+        latency_config.deduce_defaults(TargetLatency, false);
+
+        monitor_.reset(new (monitor_) FeedbackMonitor(
+            *resampler_writer_, packetizer_, resampler_writer_.get(), feedback_config,
+            latency_config, frame_spec));
+        CHECK(monitor_->is_valid());
+        monitor_->start();
+
+        buf_ = frame_factory.new_raw_buffer();
+        CHECK(buf_);
+        buf_.reslice(0, SamplesPerFrame * NumCh);
+        for (size_t n = 0; n < buf_.size(); n++) {
+            buf_.data()[n] = 0;
+        }
+    }
+
+    void set_latency(core::nanoseconds_t latency) {
+        queue_ = latency;
+    }
+
+    core::nanoseconds_t latency() const {
+        return queue_;
+    }
+
+    // Deliver report from receiver with current queue length.
+    void report(packet::stream_source_t source_id) {
+        LatencyMetrics latency_metrics;
+        latency_metrics.niq_latency = queue_;
+
+        packet::LinkMetrics link_metrics;
+        link_metrics.total_packets = n_frames_ + 1;
+
+        monitor_->process_feedback(source_id, latency_metrics, link_metrics);
+    }
+
+    // Write one frame to sender and play one frame on receiver.
+    // Returns duration produced by sender.
+    core::nanoseconds_t step() {
+        const core::nanoseconds_t produced_before = counter_.duration();
+
+        Frame frame(buf_.data(), buf_.size());
+        frame.set_duration(SamplesPerFrame);
+        monitor_->write(frame);
+
+        const core::nanoseconds_t produced = counter_.duration() - produced_before;
+
+        queue_ += produced;
+        queue_ -= core::nanoseconds_t(FrameDuration * (1 + drift_));
+
+        n_frames_++;
+
+        return produced;
+    }
+
+private:
+    PcmEncoder encoder_;
+    rtp::Identity identity_;
+    rtp::Sequencer sequencer_;
+    packet::Queue packet_queue_;
+    Packetizer packetizer_;
+
+    core::SharedPtr<IResampler> resampler_;
+    DurationCounter counter_;
+    core::Optional<ResamplerWriter> resampler_writer_;
+    core::Optional<FeedbackMonitor> monitor_;
+
+    core::Slice<sample_t> buf_;
+
+    const double drift_;
+    core::nanoseconds_t queue_;
+    size_t n_frames_;
+};
+
+core::nanoseconds_t abs_delta(core::nanoseconds_t a, core::nanoseconds_t b) {
+    return a > b ? a - b : b - a;
+}
+
+} // namespace
+
+TEST_GROUP(feedback_monitor) {};
+
+// Sender compensates clock drift between sender and receiver, so that
+// receiver queue, which is not tuned by receiver itself, stays near target.
+TEST(feedback_monitor, sender_driven_drift) {
+    enum { NumFrames = 6000, ReportFrames = 20 };
+
+    const double drifts[] = { 0.0001, -0.0001 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(drifts); n++) {
+        Simulator sim(FeedbackConfig(), drifts[n]);
+
+        for (size_t fn = 0; fn < NumFrames; fn++) {
+            if (fn % ReportFrames == 0) {
+                sim.report(1);
+            }
+            sim.step();
+
+            CHECK(abs_delta(sim.latency(), TargetLatency) < 5 * core::Millisecond);
+        }
+    }
+}
+
+// Sender brings receiver queue from initial length to target.
+TEST(feedback_monitor, sender_driven_convergence) {
+    enum { NumFrames = 6000, ReportFrames = 20 };
+
+    Simulator sim(FeedbackConfig(), 0);
+    sim.set_latency(TargetLatency + 20 * core::Millisecond);
+
+    for (size_t fn = 0; fn < NumFrames; fn++) {
+        if (fn % ReportFrames == 0) {
+            sim.report(1);
+        }
+        sim.step();
+    }
+
+    CHECK(abs_delta(sim.latency(), TargetLatency) < 2 * core::Millisecond);
+}
+
+// With locked clocks, resampler is bypassed until drift is detected.
+TEST(feedback_monitor, locked_clocks) {
+    enum { NumFrames = 6000, ReportFrames = 20 };
+
+    { // no drift
+        Simulator sim(FeedbackConfig(), 0, true);
+
+        for (size_t fn = 0; fn < NumFrames; fn++) {
+            if (fn % ReportFrames == 0) {
+                sim.report(1);
+            }
+            // Frames are passed as is.
+            LONGS_EQUAL(FrameDuration, sim.step());
+        }
+    }
+    { // drift
+        Simulator sim(FeedbackConfig(), 0.0005, true);
+
+        bool scaled = false;
+
+        for (size_t fn = 0; fn < NumFrames; fn++) {
+            if (fn % ReportFrames == 0) {
+                sim.report(1);
+            }
+            if (sim.step() != FrameDuration) {
+                scaled = true;
+            }
+        }
+
+        CHECK(scaled);
+        // Without compensation, queue would shrink by 30ms.
+        CHECK(abs_delta(sim.latency(), TargetLatency) < 15 * core::Millisecond);
+    }
+}
+
+// When feedback stops, sender stops scaling.
+TEST(feedback_monitor, restart_on_timeout) {
+    enum { NumFrames = 500, CheckFrames = 500, ReportFrames = 20 };
+
+    FeedbackConfig feedback_config;
+    feedback_config.source_timeout = 50 * core::Millisecond;
+
+    Simulator sim(feedback_config, 0);
+    sim.set_latency(TargetLatency + 20 * core::Millisecond);
+
+    for (size_t fn = 0; fn < NumFrames; fn++) {
+        if (fn % ReportFrames == 0) {
+            sim.report(1);
+        }
+        sim.step();
+    }
+
+    core::nanoseconds_t produced = 0;
+    for (size_t fn = 0; fn < CheckFrames; fn++) {
+        sim.report(1);
+        produced += sim.step();
+    }
+    // Sender is scaling.
+    CHECK(abs_delta(produced, CheckFrames * FrameDuration) > core::Millisecond);
+
+    core::sleep_for(core::ClockMonotonic, 100 * core::Millisecond);
+    sim.step();
+
+    produced = 0;
+    for (size_t fn = 0; fn < CheckFrames; fn++) {
+        produced += sim.step();
+    }
+    // Sender is not scaling.
+    CHECK(abs_delta(produced, CheckFrames * FrameDuration) < core::Millisecond / 2);
+}
+
+} // namespace audio
+} // namespace roc
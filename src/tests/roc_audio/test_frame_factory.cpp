@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/frame_factory.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SmallSize = 64, MediumSize = 256, LargeSize = 1024 };
+
+core::HeapArena arena;
+
+} // namespace
+
+TEST_GROUP(frame_factory) {};
+
+TEST(frame_factory, no_small_pools) {
+    core::SlabPool<core::Buffer> buffer_pool("buffer_pool", arena,
+                                             sizeof(core::Buffer) + LargeSize);
+
+    FrameFactory factory(buffer_pool);
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.byte_buffer_size());
+    UNSIGNED_LONGS_EQUAL(LargeSize / sizeof(sample_t), factory.raw_buffer_size());
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_byte_buffer().size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_byte_buffer(1).size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_byte_buffer(LargeSize).size());
+
+    UNSIGNED_LONGS_EQUAL(LargeSize / sizeof(sample_t), factory.new_raw_buffer(1).size());
+
+    CHECK(!factory.new_byte_buffer(LargeSize + 1));
+    CHECK(!factory.new_raw_buffer(LargeSize / sizeof(sample_t) + 1));
+}
+
+TEST(frame_factory, small_pools) {
+    core::SlabPool<core::Buffer> small_pool("small_pool", arena,
+                                            sizeof(core::Buffer) + SmallSize);
+    core::SlabPool<core::Buffer> medium_pool("medium_pool", arena,
+                                             sizeof(core::Buffer) + MediumSize);
+    core::SlabPool<core::Buffer> buffer_pool("buffer_pool", arena,
+                                             sizeof(core::Buffer) + LargeSize);
+
+    FrameFactory factory(buffer_pool);
+
+    // added in reverse order
+    factory.add_small_buffer_pool(medium_pool);
+    factory.add_small_buffer_pool(small_pool);
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.byte_buffer_size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_byte_buffer().size());
+    UNSIGNED_LONGS_EQUAL(LargeSize / sizeof(sample_t), factory.new_raw_buffer().size());
+
+    UNSIGNED_LONGS_EQUAL(SmallSize, factory.new_byte_buffer(1).size());
+    UNSIGNED_LONGS_EQUAL(SmallSize, factory.new_byte_buffer(SmallSize).size());
+    UNSIGNED_LONGS_EQUAL(MediumSize, factory.new_byte_buffer(SmallSize + 1).size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_byte_buffer(MediumSize + 1).size());
+
+    // raw buffer size is in samples
+    UNSIGNED_LONGS_EQUAL(SmallSize / sizeof(sample_t),
+                         factory.new_raw_buffer(SmallSize / sizeof(sample_t)).size());
+    UNSIGNED_LONGS_EQUAL(
+        MediumSize / sizeof(sample_t),
+        factory.new_raw_buffer(SmallSize / sizeof(sample_t) + 1).size());
+    UNSIGNED_LONGS_EQUAL(
+        LargeSize / sizeof(sample_t),
+        factory.new_raw_buffer(MediumSize / sizeof(sample_t) + 1).size());
+
+    CHECK(!factory.new_byte_buffer(LargeSize + 1));
+    CHECK(!factory.new_raw_buffer(LargeSize / sizeof(sample_t) + 1));
+
+    UNSIGNED_LONGS_EQUAL(0, small_pool.num_used_slots());
+    UNSIGNED_LONGS_EQUAL(0, medium_pool.num_used_slots());
+    UNSIGNED_LONGS_EQUAL(0, buffer_pool.num_used_slots());
+}
+
+} // namespace audio
+} // namespace roc
@@ -9,6 +9,8 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_audio/freq_estimator.h"
+#include "roc_audio/freq_estimator_decim.h"
+#include "roc_core/fast_random.h"
 #include "roc_core/macro_helpers.h"
 
 namespace roc {
@@ -23,6 +25,12 @@ const FreqEstimatorProfile Profiles[] = { FreqEstimatorProfile_Responsive,
 
 const double Epsilon = 0.0001;
 
+const FreqEstimatorKernel Kernels[] = {
+    FreqEstimatorKernel_SSE2,
+    FreqEstimatorKernel_AVX,
+    FreqEstimatorKernel_NEON,
+};
+
 } // namespace
 
 TEST_GROUP(freq_estimator) {
@@ -69,5 +77,77 @@ TEST(freq_estimator, small_queue_size) {
     }
 }
 
+TEST(freq_estimator, change_target) {
+    for (size_t p = 0; p < ROC_ARRAY_SIZE(Profiles); p++) {
+        FreqEstimator fe(Profiles[p], Target);
+
+        for (size_t n = 0; n < 1000; n++) {
+            fe.update(Target);
+        }
+
+        fe.set_target_latency(Target * 2);
+
+        do {
+            fe.update(Target);
+        } while (fe.freq_coeff() > 0.99f);
+    }
+}
+
+TEST(freq_estimator, restore_state) {
+    for (size_t p = 0; p < ROC_ARRAY_SIZE(Profiles); p++) {
+        FreqEstimator fe1(Profiles[p], Target);
+
+        do {
+            fe1.update(Target * 2);
+        } while (fe1.freq_coeff() < 1.01f);
+
+        FreqEstimator fe2(Profiles[p], Target);
+        fe2.restore_state(fe1.save_state());
+
+        DOUBLES_EQUAL((double)fe1.freq_coeff(), (double)fe2.freq_coeff(), Epsilon);
+
+        // Restored estimator keeps integrated drift, fresh one starts from 1.0.
+        FreqEstimator fe3(Profiles[p], Target);
+
+        for (size_t n = 0; n < 1000; n++) {
+            fe2.update(Target);
+            fe3.update(Target);
+        }
+
+        CHECK(fe2.freq_coeff() > fe3.freq_coeff());
+        DOUBLES_EQUAL(1.0, (double)fe3.freq_coeff(), Epsilon);
+    }
+}
+
+TEST(freq_estimator, kernel_scalar_always_supported) {
+    CHECK(fe_decim_kernel_func(FreqEstimatorKernel_Scalar));
+}
+
+TEST(freq_estimator, kernel_best_supported) {
+    CHECK(fe_decim_kernel_func(fe_decim_kernel_best()));
+}
+
+TEST(freq_estimator, kernel_same_as_scalar) {
+    FreqEstimatorKernelFunc scalar_func =
+        fe_decim_kernel_func(FreqEstimatorKernel_Scalar);
+
+    double samples[fe_decim_len];
+    for (size_t n = 0; n < fe_decim_len; n++) {
+        samples[n] = Target + (double)core::fast_random_range(0, 2000) - 1000;
+    }
+
+    const double expected = scalar_func(samples);
+
+    for (size_t k = 0; k < ROC_ARRAY_SIZE(Kernels); k++) {
+        FreqEstimatorKernelFunc kernel_func = fe_decim_kernel_func(Kernels[k]);
+        if (!kernel_func) {
+            continue;
+        }
+
+        // order of additions differs, so allow rounding errors
+        DOUBLES_EQUAL(expected, kernel_func(samples), expected * 1e-12);
+    }
+}
+
 } // namespace audio
 } // namespace roc
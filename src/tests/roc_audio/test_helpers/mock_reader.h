@@ -22,6 +22,7 @@ class MockReader : public IFrameReader {
 public:
     explicit MockReader(bool fail_on_empty = true)
         : total_reads_(0)
+        , last_data_(NULL)
         , pos_(0)
         , size_(0)
         , fail_on_empty_(fail_on_empty)
@@ -30,6 +31,7 @@ public:
 
     virtual bool read(Frame& frame) {
         total_reads_++;
+        last_data_ = frame.raw_samples();
 
         if (fail_on_empty_) {
             CHECK(pos_ + frame.num_raw_samples() <= size_);
@@ -40,9 +42,9 @@ public:
         memcpy(frame.raw_samples(), samples_ + pos_,
                frame.num_raw_samples() * sizeof(sample_t));
 
-        unsigned flags = 0;
+        unsigned flags = Frame::FlagSilent;
         for (size_t n = pos_; n < pos_ + frame.num_raw_samples(); n++) {
-            flags |= flags_[n];
+            flags = Frame::combine_flags(flags, flags_[n]);
         }
         frame.set_flags(flags);
 
@@ -84,6 +86,10 @@ public:
         return total_reads_;
     }
 
+    const sample_t* last_data() const {
+        return last_data_;
+    }
+
     size_t num_unread() const {
         return size_ - pos_;
     }
@@ -92,6 +98,7 @@ private:
     enum { MaxSz = 100000 };
 
     size_t total_reads_;
+    const sample_t* last_data_;
 
     sample_t samples_[MaxSz];
     unsigned flags_[MaxSz];
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/late_packet_filter.h"
+#include "roc_audio/pcm_decoder.h"
+#include "roc_audio/pcm_encoder.h"
+#include "roc_core/heap_arena.h"
+#include "roc_packet/fec.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_status/status_code.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SamplesPerPacket = 100, SampleRate = 1000, ChMask = 0x3, MaxBufSize = 1000 };
+
+const SampleSpec packet_spec(
+    SampleRate, PcmFormat_SInt16_Be, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxBufSize);
+
+rtp::Composer rtp_composer(NULL);
+
+packet::PacketPtr new_packet(IFrameEncoder& encoder,
+                             packet::stream_timestamp_t ts,
+                             bool with_duration) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> bp = packet_factory.new_packet_buffer();
+    CHECK(bp);
+
+    CHECK(rtp_composer.prepare(*pp, bp, encoder.encoded_byte_count(SamplesPerPacket)));
+
+    pp->set_buffer(bp);
+
+    pp->rtp()->stream_timestamp = ts;
+    if (with_duration) {
+        pp->rtp()->duration = SamplesPerPacket;
+    }
+
+    return pp;
+}
+
+packet::PacketPtr new_fec_packet(IFrameEncoder& encoder,
+                                 packet::stream_timestamp_t ts,
+                                 packet::blknum_t sbn) {
+    packet::PacketPtr pp = new_packet(encoder, ts, true);
+
+    pp->add_flags(packet::Packet::FlagFEC);
+    pp->fec()->source_block_number = sbn;
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(late_packet_filter) {};
+
+TEST(late_packet_filter, no_position) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    for (packet::stream_timestamp_t ts = 0; ts < SamplesPerPacket * 5;
+         ts += SamplesPerPacket) {
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(encoder, ts, true)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(5, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, filter.num_dropped());
+}
+
+TEST(late_packet_filter, drop_late) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    filter.set_playback_position(SamplesPerPacket * 3 + SamplesPerPacket / 2);
+
+    for (packet::stream_timestamp_t ts = 0; ts < SamplesPerPacket * 5;
+         ts += SamplesPerPacket) {
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(encoder, ts, true)));
+    }
+
+    // packet which is played partially is kept
+    UNSIGNED_LONGS_EQUAL(2, queue.size());
+    UNSIGNED_LONGS_EQUAL(3, filter.num_dropped());
+
+    packet::PacketPtr pp;
+    LONGS_EQUAL(status::StatusOK, queue.read(pp));
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket * 3, pp->stream_timestamp());
+    LONGS_EQUAL(status::StatusOK, queue.read(pp));
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket * 4, pp->stream_timestamp());
+}
+
+TEST(late_packet_filter, packet_end_at_position) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    filter.set_playback_position(SamplesPerPacket * 2);
+
+    LONGS_EQUAL(status::StatusOK,
+                filter.write(new_packet(encoder, SamplesPerPacket, true)));
+    LONGS_EQUAL(status::StatusOK,
+                filter.write(new_packet(encoder, SamplesPerPacket * 2, true)));
+
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    UNSIGNED_LONGS_EQUAL(1, filter.num_dropped());
+}
+
+TEST(late_packet_filter, compute_duration) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    filter.set_playback_position(SamplesPerPacket * 2 + 1);
+
+    packet::PacketPtr late_pp = new_packet(encoder, SamplesPerPacket, false);
+    packet::PacketPtr good_pp = new_packet(encoder, SamplesPerPacket * 2, false);
+
+    LONGS_EQUAL(status::StatusOK, filter.write(late_pp));
+    LONGS_EQUAL(status::StatusOK, filter.write(good_pp));
+
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    UNSIGNED_LONGS_EQUAL(1, filter.num_dropped());
+
+    // duration is left for rtp::Filter
+    UNSIGNED_LONGS_EQUAL(0, good_pp->duration());
+}
+
+TEST(late_packet_filter, position_wraparound) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    const packet::stream_timestamp_t base = (packet::stream_timestamp_t)-1 - 50;
+
+    filter.set_playback_position(base + SamplesPerPacket);
+
+    LONGS_EQUAL(status::StatusOK, filter.write(new_packet(encoder, base, true)));
+    LONGS_EQUAL(status::StatusOK,
+                filter.write(new_packet(encoder, base + SamplesPerPacket, true)));
+
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    UNSIGNED_LONGS_EQUAL(1, filter.num_dropped());
+}
+
+TEST(late_packet_filter, fec_no_block) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    filter.set_playback_position(SamplesPerPacket * 2);
+
+    // FEC reader didn't start yet, late packet may be needed for repair
+    LONGS_EQUAL(status::StatusOK, filter.write(new_fec_packet(encoder, 0, 5)));
+
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, filter.num_dropped());
+}
+
+TEST(late_packet_filter, fec_block) {
+    PcmEncoder encoder(packet_spec);
+    PcmDecoder decoder(packet_spec);
+
+    packet::Queue queue;
+    LatePacketFilter filter(queue, decoder);
+
+    filter.set_playback_position(SamplesPerPacket * 3);
+    filter.set_fec_block(5);
+
+    // late packet from previous block is dropped
+    LONGS_EQUAL(status::StatusOK, filter.write(new_fec_packet(encoder, 0, 4)));
+    // late packet from current block is kept
+    LONGS_EQUAL(status::StatusOK,
+                filter.write(new_fec_packet(encoder, SamplesPerPacket, 5)));
+    // packet from previous block which is not late is kept
+    LONGS_EQUAL(status::StatusOK,
+                filter.write(new_fec_packet(encoder, SamplesPerPacket * 3, 4)));
+
+    UNSIGNED_LONGS_EQUAL(2, queue.size());
+    UNSIGNED_LONGS_EQUAL(1, filter.num_dropped());
+
+    packet::PacketPtr pp;
+    LONGS_EQUAL(status::StatusOK, queue.read(pp));
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket, pp->stream_timestamp());
+    LONGS_EQUAL(status::StatusOK, queue.read(pp));
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket * 3, pp->stream_timestamp());
+}
+
+} // namespace audio
+} // namespace roc
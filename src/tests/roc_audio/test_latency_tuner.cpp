@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/clock_group.h"
+#include "roc_audio/latency_tuner.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SampleRate = 10000, FrameSize = 100 };
+
+const SampleSpec sample_spec(SampleRate,
+                             Sample_RawFormat,
+                             ChanLayout_Surround,
+                             ChanOrder_Smpte,
+                             ChanMask_Surround_Mono);
+
+const core::nanoseconds_t Epsilon = core::Millisecond;
+
+core::HeapArena arena;
+
+// Run tuner for given duration, assuming that queue latency has already
+// converged to target and the rest of pipeline adds given overhead.
+void run_converged(LatencyTuner& tuner,
+                   core::nanoseconds_t duration,
+                   core::nanoseconds_t overhead,
+                   core::nanoseconds_t jitter) {
+    const size_t n_frames =
+        size_t(duration / sample_spec.samples_per_chan_2_ns(FrameSize));
+
+    for (size_t n = 0; n < n_frames; n++) {
+        LatencyMetrics latency_metrics;
+        latency_metrics.niq_latency = tuner.target_latency();
+        latency_metrics.e2e_latency = tuner.target_latency() + overhead;
+
+        packet::LinkMetrics link_metrics;
+        link_metrics.jitter = jitter;
+
+        tuner.write_metrics(latency_metrics, link_metrics);
+
+        if (tuner.need_update()) {
+            CHECK(tuner.update_stream());
+        }
+
+        tuner.advance_stream(FrameSize);
+    }
+}
+
+// Run one frame, assuming that queue latency differs from target by given offset.
+void run_frame(LatencyTuner& tuner, core::nanoseconds_t offset) {
+    LatencyMetrics latency_metrics;
+    latency_metrics.niq_latency = tuner.target_latency() + offset;
+    latency_metrics.e2e_latency = latency_metrics.niq_latency;
+
+    tuner.write_metrics(latency_metrics, packet::LinkMetrics());
+
+    if (tuner.need_update()) {
+        CHECK(tuner.update_stream());
+    }
+
+    tuner.advance_stream(FrameSize);
+}
+
+} // namespace
+
+TEST_GROUP(latency_tuner) {
+    LatencyConfig make_config(core::nanoseconds_t latency_budget) {
+        LatencyConfig config;
+        config.tuner_backend = LatencyTunerBackend_Niq;
+        config.tuner_profile = LatencyTunerProfile_Responsive;
+        config.latency_budget = latency_budget;
+        config.deduce_defaults(200 * core::Millisecond, true);
+        return config;
+    }
+};
+
+TEST(latency_tuner, fixed_target) {
+    const LatencyConfig config = make_config(0);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    LONGS_EQUAL(200 * core::Millisecond, tuner.target_latency());
+
+    run_converged(tuner, 10 * core::Second, 30 * core::Millisecond, 0);
+
+    LONGS_EQUAL(200 * core::Millisecond, tuner.target_latency());
+}
+
+TEST(latency_tuner, budget_initial_target) {
+    const LatencyConfig config = make_config(100 * core::Millisecond);
+
+    LONGS_EQUAL(50 * core::Millisecond, config.target_latency);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    LONGS_EQUAL(50 * core::Millisecond, tuner.target_latency());
+}
+
+TEST(latency_tuner, budget_lower_target) {
+    const LatencyConfig config = make_config(60 * core::Millisecond);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    // 30ms is spent outside of the queue, so 30ms is left for the queue.
+    run_converged(tuner, 30 * core::Second, 30 * core::Millisecond, 0);
+
+    DOUBLES_EQUAL(30 * core::Millisecond, tuner.target_latency(), Epsilon * 2);
+}
+
+TEST(latency_tuner, budget_higher_target) {
+    const LatencyConfig config = make_config(100 * core::Millisecond);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    // 20ms is spent outside of the queue, so 80ms is left for the queue.
+    run_converged(tuner, 30 * core::Second, 20 * core::Millisecond, 0);
+
+    DOUBLES_EQUAL(80 * core::Millisecond, tuner.target_latency(), Epsilon * 4);
+}
+
+TEST(latency_tuner, budget_jitter_floor) {
+    const LatencyConfig config = make_config(60 * core::Millisecond);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    // Budget leaves 10ms for the queue, but 5ms jitter requires 20ms.
+    run_converged(tuner, 30 * core::Second, 50 * core::Millisecond,
+                  5 * core::Millisecond);
+
+    DOUBLES_EQUAL(20 * core::Millisecond, tuner.target_latency(), Epsilon);
+}
+
+TEST(latency_tuner, budget_requires_tuning) {
+    LatencyConfig config;
+    config.tuner_backend = LatencyTunerBackend_Niq;
+    config.tuner_profile = LatencyTunerProfile_Intact;
+    config.target_latency = 50 * core::Millisecond;
+    config.latency_budget = 100 * core::Millisecond;
+    config.deduce_defaults(200 * core::Millisecond, true);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(!tuner.is_valid());
+}
+
+TEST(latency_tuner, set_target_gradual) {
+    const LatencyConfig config = make_config(0);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    CHECK(tuner.set_target_latency(100 * core::Millisecond));
+
+    // Not changed at once.
+    LONGS_EQUAL(200 * core::Millisecond, tuner.target_latency());
+
+    core::nanoseconds_t prev_target = tuner.target_latency();
+
+    for (size_t n = 0; n < 30; n++) {
+        run_converged(tuner, core::Second, 0, 0);
+
+        // Each step keeps latency, which was near previous target,
+        // within bounds of the new target.
+        CHECK(tuner.target_latency() <= prev_target);
+        CHECK(prev_target - tuner.target_latency()
+              <= config.latency_tolerance / 4 + Epsilon);
+
+        prev_target = tuner.target_latency();
+    }
+
+    LONGS_EQUAL(100 * core::Millisecond, tuner.target_latency());
+}
+
+TEST(latency_tuner, set_target_invalid) {
+    LatencyTuner tuner(make_config(0), sample_spec);
+    CHECK(tuner.is_valid());
+
+    CHECK(!tuner.set_target_latency(0));
+    CHECK(!tuner.set_target_latency(-core::Millisecond));
+
+    LONGS_EQUAL(200 * core::Millisecond, tuner.target_latency());
+}
+
+TEST(latency_tuner, set_target_with_budget) {
+    LatencyTuner tuner(make_config(100 * core::Millisecond), sample_spec);
+    CHECK(tuner.is_valid());
+
+    // Target is managed by budget.
+    CHECK(!tuner.set_target_latency(20 * core::Millisecond));
+}
+
+TEST(latency_tuner, clock_group_follower) {
+    const LatencyConfig config = make_config(0);
+
+    core::SharedPtr<ClockGroup> group = new (arena) ClockGroup(arena);
+    CHECK(group);
+
+    LatencyTuner leader(config, sample_spec);
+    LatencyTuner follower(config, sample_spec);
+    CHECK(leader.is_valid());
+    CHECK(follower.is_valid());
+
+    leader.set_clock_group(group);
+    follower.set_clock_group(group);
+
+    for (size_t n = 0; n < 300; n++) {
+        // Only leader observes drift.
+        run_frame(leader, 5 * core::Millisecond);
+        run_frame(follower, 0);
+    }
+
+    CHECK(leader.save_state().freq_coeff > 1);
+
+    // Follower applies leader's scaling instead of its own.
+    DOUBLES_EQUAL(leader.save_state().freq_coeff, follower.save_state().freq_coeff,
+                  1e-6);
+}
+
+TEST(latency_tuner, clock_group_new_leader) {
+    const LatencyConfig config = make_config(0);
+
+    core::SharedPtr<ClockGroup> group = new (arena) ClockGroup(arena);
+    CHECK(group);
+
+    LatencyTuner follower(config, sample_spec);
+    CHECK(follower.is_valid());
+
+    {
+        LatencyTuner leader(config, sample_spec);
+        CHECK(leader.is_valid());
+
+        leader.set_clock_group(group);
+        follower.set_clock_group(group);
+
+        for (size_t n = 0; n < 3000; n++) {
+            run_frame(leader, 5 * core::Millisecond);
+            run_frame(follower, 0);
+        }
+    }
+
+    const float leader_coeff = follower.save_state().freq_coeff;
+    CHECK(leader_coeff > 1);
+
+    // Follower becomes leader. Its own estimator didn't see drift, so it
+    // would produce nominal scaling, but it continues from accumulated
+    // state of previous leader instead.
+    for (size_t n = 0; n < 10; n++) {
+        run_frame(follower, 0);
+    }
+
+    CHECK(follower.save_state().freq_coeff > 1);
+}
+
+TEST(latency_tuner, clock_group_disabled_tuning) {
+    LatencyConfig config;
+    config.tuner_backend = LatencyTunerBackend_Niq;
+    config.tuner_profile = LatencyTunerProfile_Intact;
+    config.target_latency = 50 * core::Millisecond;
+    config.deduce_defaults(200 * core::Millisecond, true);
+
+    core::SharedPtr<ClockGroup> group = new (arena) ClockGroup(arena);
+    CHECK(group);
+
+    LatencyTuner tuner(config, sample_spec);
+    CHECK(tuner.is_valid());
+
+    tuner.set_clock_group(group);
+
+    // Tuner without scaling doesn't join group.
+    LONGS_EQUAL(1, group->getref());
+}
+
+} // namespace audio
+} // namespace roc
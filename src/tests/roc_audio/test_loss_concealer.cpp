@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/loss_concealer.h"
+#include "roc_core/heap_arena.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 48000,
+    NumCh = 2,
+    ChMask = 0x3,
+
+    // 200 Hz tone.
+    TonePeriod = 240,
+
+    // 100ms of history.
+    HistorySamples = 4800,
+
+    MaxSamples = 960,
+    FadeSamples = 48,
+
+    BufSize = HistorySamples * NumCh
+};
+
+const SampleSpec sample_spec(
+    SampleRate, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+core::HeapArena arena;
+
+LossConcealerConfig make_config() {
+    LossConcealerConfig config;
+    config.max_duration = sample_spec.samples_per_chan_2_ns(MaxSamples);
+    config.fade_duration = sample_spec.samples_per_chan_2_ns(FadeSamples);
+    return config;
+}
+
+// Right channel is left channel with half amplitude.
+sample_t tone(size_t pos, size_t chan) {
+    return sample_t(std::sin(2 * M_PI * (double)pos / TonePeriod) * (chan ? 0.25 : 0.5));
+}
+
+void fill_tone(sample_t* samples, size_t n_samples, size_t start_pos) {
+    for (size_t ns = 0; ns < n_samples; ns++) {
+        for (size_t nc = 0; nc < NumCh; nc++) {
+            samples[ns * NumCh + nc] = tone(start_pos + ns, nc);
+        }
+    }
+}
+
+void fill_value(sample_t* samples, size_t n_samples, sample_t value) {
+    for (size_t n = 0; n < n_samples * NumCh; n++) {
+        samples[n] = value;
+    }
+}
+
+} // namespace
+
+TEST_GROUP(loss_concealer) {};
+
+TEST(loss_concealer, not_enough_history) {
+    LossConcealer concealer(sample_spec, make_config(), arena);
+    CHECK(concealer.is_valid());
+
+    sample_t samples[BufSize];
+
+    // Nothing written.
+    UNSIGNED_LONGS_EQUAL(0, concealer.conceal(samples, MaxSamples));
+
+    // Less than two longest periods written.
+    fill_tone(samples, TonePeriod, 0);
+    concealer.write(samples, TonePeriod);
+    UNSIGNED_LONGS_EQUAL(0, concealer.conceal(samples, MaxSamples));
+}
+
+TEST(loss_concealer, continue_tone) {
+    enum { GapSamples = 100 };
+
+    LossConcealer concealer(sample_spec, make_config(), arena);
+    CHECK(concealer.is_valid());
+
+    sample_t samples[BufSize];
+
+    fill_tone(samples, HistorySamples, 0);
+    concealer.write(samples, HistorySamples);
+
+    // Gap is concealed in two parts.
+    UNSIGNED_LONGS_EQUAL(GapSamples / 2, concealer.conceal(samples, GapSamples / 2));
+    UNSIGNED_LONGS_EQUAL(GapSamples / 2,
+                         concealer.conceal(samples + GapSamples / 2 * NumCh,
+                                           GapSamples / 2));
+
+    // Concealed signal continues tone and fades out.
+    for (size_t ns = 0; ns < GapSamples; ns++) {
+        const double gain = 1 - (double)ns / MaxSamples;
+
+        for (size_t nc = 0; nc < NumCh; nc++) {
+            DOUBLES_EQUAL((double)tone(HistorySamples + ns, nc) * gain,
+                          samples[ns * NumCh + nc], 0.0001);
+        }
+    }
+}
+
+TEST(loss_concealer, max_duration) {
+    LossConcealer concealer(sample_spec, make_config(), arena);
+    CHECK(concealer.is_valid());
+
+    sample_t samples[BufSize];
+
+    fill_tone(samples, HistorySamples, 0);
+    concealer.write(samples, HistorySamples);
+
+    UNSIGNED_LONGS_EQUAL(MaxSamples, concealer.conceal(samples, MaxSamples * 2));
+    UNSIGNED_LONGS_EQUAL(0, concealer.conceal(samples, MaxSamples));
+
+    // Gain reaches zero at the end.
+    for (size_t nc = 0; nc < NumCh; nc++) {
+        CHECK(std::fabs(samples[(MaxSamples - 1) * NumCh + nc]) < 0.001f);
+    }
+}
+
+TEST(loss_concealer, fade_after_gap) {
+    LossConcealer concealer(sample_spec, make_config(), arena);
+    CHECK(concealer.is_valid());
+
+    sample_t samples[BufSize];
+
+    fill_value(samples, HistorySamples, 0.5f);
+    concealer.write(samples, HistorySamples);
+
+    UNSIGNED_LONGS_EQUAL(1, concealer.conceal(samples, 1));
+
+    // First samples after gap are between concealed and decoded values.
+    fill_value(samples, FadeSamples * 2, 0.1f);
+    concealer.write(samples, FadeSamples * 2);
+
+    for (size_t ns = 0; ns < FadeSamples * 2; ns++) {
+        for (size_t nc = 0; nc < NumCh; nc++) {
+            const sample_t s = samples[ns * NumCh + nc];
+            if (ns < FadeSamples) {
+                CHECK(s > 0.1f && s < 0.5f);
+                if (ns > 0) {
+                    CHECK(s < samples[(ns - 1) * NumCh + nc]);
+                }
+            } else {
+                DOUBLES_EQUAL(0.1, s, 0.0001);
+            }
+        }
+    }
+}
+
+TEST(loss_concealer, reset) {
+    LossConcealer concealer(sample_spec, make_config(), arena);
+    CHECK(concealer.is_valid());
+
+    sample_t samples[BufSize];
+
+    fill_tone(samples, HistorySamples, 0);
+    concealer.write(samples, HistorySamples);
+
+    concealer.reset();
+
+    UNSIGNED_LONGS_EQUAL(0, concealer.conceal(samples, MaxSamples));
+}
+
+} // namespace audio
+} // namespace roc
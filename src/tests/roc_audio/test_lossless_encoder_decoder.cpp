@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/lossless_decoder.h"
+#include "roc_audio/lossless_encoder.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SampleRate = 48000, SamplesPerFrame = 240, MaxChans = 2, MaxBytes = 4000 };
+
+core::HeapArena arena;
+
+SampleSpec make_spec(ChannelMask mask) {
+    SampleSpec spec;
+    spec.set_sample_format(SampleFormat_Lossless);
+    spec.set_sample_rate(SampleRate);
+    spec.channel_set().set_layout(ChanLayout_Surround);
+    spec.channel_set().set_order(ChanOrder_Smpte);
+    spec.channel_set().set_mask(mask);
+    return spec;
+}
+
+// Quantized to 16 bits, like audio from 16-bit source.
+sample_t nth_sample(size_t n, size_t c) {
+    const double v =
+        0.4 * sin(double(n) * 0.03 + double(c)) + 0.1 * sin(double(n) * 0.41);
+    return sample_t(floor(v * 32768) / 32768);
+}
+
+void fill_samples(sample_t* samples, size_t n_samples, size_t n_chans, size_t offset) {
+    for (size_t n = 0; n < n_samples; n++) {
+        for (size_t c = 0; c < n_chans; c++) {
+            samples[n * n_chans + c] = nth_sample(offset + n, c);
+        }
+    }
+}
+
+void check_samples(const sample_t* samples,
+                   size_t n_samples,
+                   size_t n_chans,
+                   size_t offset) {
+    for (size_t n = 0; n < n_samples; n++) {
+        for (size_t c = 0; c < n_chans; c++) {
+            // must be bit-exact
+            CHECK(samples[n * n_chans + c] == nth_sample(offset + n, c));
+        }
+    }
+}
+
+} // namespace
+
+TEST_GROUP(lossless_encoder_decoder) {};
+
+TEST(lossless_encoder_decoder, round_trip) {
+    enum { NumFrames = 20 };
+
+    const ChannelMask masks[] = { ChanMask_Surround_Mono, ChanMask_Surround_Stereo };
+
+    for (size_t n_mask = 0; n_mask < ROC_ARRAY_SIZE(masks); n_mask++) {
+        const SampleSpec spec = make_spec(masks[n_mask]);
+        const size_t n_chans = spec.num_channels();
+
+        LosslessEncoder encoder(arena, spec);
+        LosslessDecoder decoder(arena, spec);
+
+        for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+            const size_t offset = n_frame * SamplesPerFrame;
+
+            sample_t samples[SamplesPerFrame * MaxChans];
+            fill_samples(samples, SamplesPerFrame, n_chans, offset);
+
+            uint8_t data[MaxBytes];
+            const size_t max_size = encoder.encoded_byte_count(SamplesPerFrame);
+            CHECK(max_size <= MaxBytes);
+
+            encoder.begin(data, max_size);
+            UNSIGNED_LONGS_EQUAL(SamplesPerFrame,
+                                 encoder.write(samples, SamplesPerFrame));
+            const size_t size = encoder.end();
+
+            // 16-bit content packed into 24-bit samples compresses well.
+            CHECK(size < SamplesPerFrame * n_chans * 3 / 2);
+
+            UNSIGNED_LONGS_EQUAL(SamplesPerFrame,
+                                 decoder.decoded_sample_count(data, size));
+
+            decoder.begin(offset, data, size);
+            UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder.available());
+
+            sample_t decoded[SamplesPerFrame * MaxChans] = {};
+            UNSIGNED_LONGS_EQUAL(SamplesPerFrame,
+                                 decoder.read(decoded, SamplesPerFrame));
+            decoder.end();
+
+            check_samples(decoded, SamplesPerFrame, n_chans, offset);
+        }
+    }
+}
+
+TEST(lossless_encoder_decoder, partial_frame) {
+    enum { Written = SamplesPerFrame / 3 };
+
+    const SampleSpec spec = make_spec(ChanMask_Surround_Stereo);
+
+    LosslessEncoder encoder(arena, spec);
+    LosslessDecoder decoder(arena, spec);
+
+    sample_t samples[SamplesPerFrame * MaxChans];
+    fill_samples(samples, SamplesPerFrame, MaxChans, 0);
+
+    uint8_t data[MaxBytes];
+    encoder.begin(data, encoder.encoded_byte_count(SamplesPerFrame));
+    UNSIGNED_LONGS_EQUAL(Written, encoder.write(samples, Written));
+    const size_t size = encoder.end();
+
+    CHECK(size <= encoder.encoded_byte_count(Written));
+    UNSIGNED_LONGS_EQUAL(Written, decoder.decoded_sample_count(data, size));
+
+    decoder.begin(0, data, size);
+    sample_t decoded[SamplesPerFrame * MaxChans] = {};
+    UNSIGNED_LONGS_EQUAL(Written, decoder.read(decoded, SamplesPerFrame));
+    decoder.end();
+
+    check_samples(decoded, Written, MaxChans, 0);
+}
+
+TEST(lossless_encoder_decoder, silence) {
+    const SampleSpec spec = make_spec(ChanMask_Surround_Stereo);
+
+    LosslessEncoder encoder(arena, spec);
+
+    sample_t samples[SamplesPerFrame * MaxChans] = {};
+
+    uint8_t data[MaxBytes];
+    encoder.begin(data, encoder.encoded_byte_count(SamplesPerFrame));
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, encoder.write(samples, SamplesPerFrame));
+
+    // Header and two constant subframes.
+    CHECK(encoder.end() <= 16);
+}
+
+TEST(lossless_encoder_decoder, corrupted_frame) {
+    const SampleSpec spec = make_spec(ChanMask_Surround_Stereo);
+
+    LosslessEncoder encoder(arena, spec);
+    LosslessDecoder decoder(arena, spec);
+
+    sample_t samples[SamplesPerFrame * MaxChans];
+    fill_samples(samples, SamplesPerFrame, MaxChans, 0);
+
+    uint8_t data[MaxBytes];
+    encoder.begin(data, encoder.encoded_byte_count(SamplesPerFrame));
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, encoder.write(samples, SamplesPerFrame));
+    const size_t size = encoder.end();
+
+    // Truncated frame is decoded as silence.
+    decoder.begin(0, data, size / 2);
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder.available());
+
+    sample_t decoded[SamplesPerFrame * MaxChans];
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, decoder.read(decoded, SamplesPerFrame));
+    decoder.end();
+
+    for (size_t n = 0; n < SamplesPerFrame * MaxChans; n++) {
+        CHECK(decoded[n] == 0);
+    }
+}
+
+} // namespace audio
+} // namespace roc
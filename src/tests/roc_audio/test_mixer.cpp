@@ -11,8 +11,10 @@
 #include "test_helpers/mock_reader.h"
 
 #include "roc_audio/mixer.h"
+#include "roc_core/fast_random.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/worker_pool.h"
 
 namespace roc {
 namespace audio {
@@ -63,16 +65,16 @@ void expect_output(Mixer& mixer,
 TEST_GROUP(mixer) {};
 
 TEST(mixer, no_readers) {
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
-    expect_output(mixer, BufSz, 0);
+    expect_output(mixer, BufSz, 0, Frame::FlagSilent);
 }
 
 TEST(mixer, one_reader) {
     test::MockReader reader;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader);
@@ -86,7 +88,7 @@ TEST(mixer, one_reader) {
 TEST(mixer, one_reader_large) {
     test::MockReader reader;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader);
@@ -97,11 +99,56 @@ TEST(mixer, one_reader_large) {
     CHECK(reader.num_unread() == 0);
 }
 
+TEST(mixer, one_reader_in_place) {
+    test::MockReader reader;
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    mixer.add_input(reader);
+
+    reader.add_samples(BufSz, 0.11f);
+
+    core::Slice<sample_t> buf = new_buffer(BufSz);
+    Frame frame(buf.data(), buf.size());
+    CHECK(mixer.read(frame));
+
+    // reader should write directly into output frame
+    POINTERS_EQUAL(buf.data(), reader.last_data());
+}
+
+TEST(mixer, two_readers_first_in_place) {
+    test::MockReader reader1;
+    test::MockReader reader2;
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+
+    reader1.add_samples(BufSz, 0.11f);
+    reader2.add_samples(BufSz, 0.22f);
+
+    core::Slice<sample_t> buf = new_buffer(BufSz);
+    Frame frame(buf.data(), buf.size());
+    CHECK(mixer.read(frame));
+
+    // first reader should write directly into output frame,
+    // second reader should write into temporary buffer
+    POINTERS_EQUAL(buf.data(), reader1.last_data());
+    CHECK(reader2.last_data() != buf.data());
+
+    for (size_t n = 0; n < BufSz; n++) {
+        DOUBLES_EQUAL(0.33, (double)frame.raw_samples()[n], 0.0001);
+    }
+}
+
 TEST(mixer, two_readers) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -116,11 +163,40 @@ TEST(mixer, two_readers) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, first_reader_fails) {
+    test::MockReader reader1(false);
+    test::MockReader reader2(false);
+    test::MockReader reader3(false);
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+    mixer.add_input(reader3);
+
+    // First reader has no samples, rest are mixed.
+    reader2.add_samples(BufSz, 0.22f);
+    reader3.add_samples(BufSz, 0.33f);
+    expect_output(mixer, BufSz, 0.55f);
+
+    // Only last reader has samples.
+    reader3.add_samples(BufSz, 0.44f);
+    expect_output(mixer, BufSz, 0.44f);
+
+    // No reader has samples, output is zeroized.
+    expect_output(mixer, BufSz, 0.0f, Frame::FlagSilent);
+
+    // First reader has samples again.
+    reader1.add_samples(BufSz, 0.11f);
+    expect_output(mixer, BufSz, 0.11f);
+}
+
 TEST(mixer, remove_reader) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -140,17 +216,154 @@ TEST(mixer, remove_reader) {
 
     reader1.add_samples(BufSz, 0.77f);
     reader2.add_samples(BufSz, 0.88f);
-    expect_output(mixer, BufSz, 0.0f);
+    expect_output(mixer, BufSz, 0.0f, Frame::FlagSilent);
 
     CHECK(reader1.num_unread() == BufSz);
     CHECK(reader2.num_unread() == BufSz * 2);
 }
 
+TEST(mixer, remove_middle_reader) {
+    test::MockReader reader1;
+    test::MockReader reader2;
+    test::MockReader reader3;
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    CHECK(mixer.add_input(reader1));
+    CHECK(mixer.add_input(reader2));
+    CHECK(mixer.add_input(reader3));
+
+    reader1.add_samples(BufSz, 0.11f);
+    reader2.add_samples(BufSz, 0.22f);
+    reader3.add_samples(BufSz, 0.33f);
+    expect_output(mixer, BufSz, 0.66f);
+
+    mixer.remove_input(reader2);
+
+    reader1.add_samples(BufSz, 0.44f);
+    reader2.add_samples(BufSz, 0.55f);
+    reader3.add_samples(BufSz, 0.11f);
+    expect_output(mixer, BufSz, 0.55f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == BufSz);
+    CHECK(reader3.num_unread() == 0);
+
+    // Removed reader can be added again.
+    CHECK(mixer.add_input(reader2));
+
+    reader1.add_samples(BufSz, 0.11f);
+    reader3.add_samples(BufSz, 0.11f);
+    expect_output(mixer, BufSz, 0.77f);
+
+    CHECK(reader2.num_unread() == 0);
+}
+
+TEST(mixer, many_readers_serial) {
+    enum { NumReaders = 10 };
+
+    test::MockReader readers[NumReaders];
+
+    Mixer mixer(frame_factory, sample_spec, true, MixerConfig(), NULL, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(mixer.add_input(readers[n]));
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders);
+
+    // Remove every second reader.
+    for (size_t n = 0; n < NumReaders; n += 2) {
+        mixer.remove_input(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders / 2);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == (n % 2 == 0 ? BufSz : 0));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumReaders / 2, mixer.metrics().occupancy);
+    UNSIGNED_LONGS_EQUAL(NumReaders, mixer.metrics().max_occupancy);
+}
+
+// Number of inputs is not limited by embedded capacity of inputs array.
+TEST(mixer, many_readers_default_config) {
+    enum { NumReaders = 12 };
+
+    // Mock readers are too large for stack.
+    test::MockReader* readers = new test::MockReader[NumReaders];
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(mixer.add_input(readers[n]));
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumReaders, mixer.metrics().occupancy);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.remove_input(readers[n]);
+    }
+
+    delete[] readers;
+}
+
+TEST(mixer, switch_direct_and_mixing) {
+    test::MockReader reader1;
+    test::MockReader reader2;
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    CHECK(mixer.add_input(reader1));
+
+    for (int n = 0; n < 3; n++) {
+        // One input, direct read.
+        reader1.add_samples(BufSz, 0.11f);
+        expect_output(mixer, BufSz, 0.11f);
+
+        // Two inputs, mixing.
+        CHECK(mixer.add_input(reader2));
+
+        reader1.add_samples(BufSz, 0.22f);
+        reader2.add_samples(BufSz, 0.33f);
+        expect_output(mixer, BufSz, 0.55f);
+
+        // Back to one input.
+        mixer.remove_input(reader2);
+    }
+
+    reader1.add_samples(MaxBufSz * 2, 0.44f);
+    expect_output(mixer, MaxBufSz * 2, 0.44f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
 TEST(mixer, clamp) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -175,13 +388,44 @@ TEST(mixer, clamp) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, silent_reader) {
+    test::MockReader reader1;
+    test::MockReader reader2;
+    test::MockReader reader3;
+
+    Mixer mixer(frame_factory, sample_spec, true, arena);
+    CHECK(mixer.is_valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+    mixer.add_input(reader3);
+
+    // Silent frame is not added to output, so its samples are ignored.
+    reader1.add_samples(BufSz, 0.11f);
+    reader2.add_samples(BufSz, 0.22f, Frame::FlagSilent);
+    reader3.add_samples(BufSz, 0.33f);
+
+    expect_output(mixer, BufSz, 0.44f, 0);
+
+    // Output is silent only if all inputs are silent.
+    reader1.add_samples(BufSz, 0.00f, Frame::FlagSilent);
+    reader2.add_samples(BufSz, 0.00f, Frame::FlagSilent);
+    reader3.add_samples(BufSz, 0.00f, Frame::FlagSilent);
+
+    expect_output(mixer, BufSz, 0.00f, Frame::FlagSilent);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+    CHECK(reader3.num_unread() == 0);
+}
+
 TEST(mixer, flags) {
     enum { BigBatch = MaxBufSz * 2 };
 
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -212,7 +456,7 @@ TEST(mixer, timestamps_one_reader) {
 
     test::MockReader reader;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader);
@@ -241,7 +485,7 @@ TEST(mixer, timestamps_two_readers) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -279,7 +523,7 @@ TEST(mixer, timestamps_partial) {
     test::MockReader reader2;
     test::MockReader reader3;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -326,7 +570,7 @@ TEST(mixer, timestamps_no_overflow) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, true);
+    Mixer mixer(frame_factory, sample_spec, true, arena);
     CHECK(mixer.is_valid());
 
     mixer.add_input(reader1);
@@ -362,7 +606,7 @@ TEST(mixer, timestamps_disabled) {
     test::MockReader reader1;
     test::MockReader reader2;
 
-    Mixer mixer(frame_factory, sample_spec, false);
+    Mixer mixer(frame_factory, sample_spec, false, arena);
     CHECK(mixer.is_valid());
 
     reader1.enable_timestamps(start_ts, sample_spec);
@@ -383,5 +627,296 @@ TEST(mixer, timestamps_disabled) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, parallel_many_readers) {
+    enum { NumReaders = 10, NumWorkers = 3, BigBatch = MaxBufSz * 2 };
+
+    test::MockReader readers[NumReaders];
+
+    core::WorkerPool workers(NumWorkers, arena);
+    CHECK(workers.is_valid());
+
+    Mixer mixer(frame_factory, sample_spec, true, MixerConfig(), &workers, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.add_input(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f, n == 3 ? Frame::FlagNotBlank : 0);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders, Frame::FlagNotBlank);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BigBatch, 0.02f, n == 7 ? Frame::FlagPacketDrops : 0);
+    }
+    expect_output(mixer, BigBatch, 0.02f * NumReaders, Frame::FlagPacketDrops);
+
+    mixer.remove_input(readers[0]);
+    mixer.remove_input(readers[5]);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        if (n != 0 && n != 5) {
+            readers[n].add_samples(BufSz, 0.03f);
+        }
+    }
+    expect_output(mixer, BufSz, 0.03f * (NumReaders - 2));
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+}
+
+TEST(mixer, parallel_timestamps) {
+    // BufSz samples per second
+    const SampleSpec sample_spec(BufSz, Sample_RawFormat, ChanLayout_Surround,
+                                 ChanOrder_Smpte, ChanMask_Surround_Mono);
+    const core::nanoseconds_t start_ts1 = 2000000000000;
+    const core::nanoseconds_t start_ts2 = 1000000000000;
+
+    test::MockReader reader1;
+    test::MockReader reader2;
+
+    core::WorkerPool workers(1, arena);
+    CHECK(workers.is_valid());
+
+    Mixer mixer(frame_factory, sample_spec, true, MixerConfig(), &workers, arena);
+    CHECK(mixer.is_valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+
+    reader1.enable_timestamps(start_ts1, sample_spec);
+    reader2.enable_timestamps(start_ts2, sample_spec);
+
+    reader1.add_samples(BufSz, 0.11f);
+    reader2.add_samples(BufSz, 0.11f);
+    expect_output(mixer, BufSz, 0.11f * 2, 0, (start_ts1 + start_ts2) / 2);
+
+    reader1.add_samples(BufSz, 0.22f);
+    reader2.add_samples(BufSz, 0.22f);
+    expect_output(mixer, BufSz, 0.22f * 2, 0,
+                  ((start_ts1 + core::Second) + (start_ts2 + core::Second)) / 2);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
+TEST(mixer, parallel_same_as_serial) {
+    enum { NumReaders = 4, NumWorkers = 2, NumIterations = 10 };
+
+    test::MockReader serial_readers[NumReaders];
+    test::MockReader parallel_readers[NumReaders];
+
+    core::WorkerPool workers(NumWorkers, arena);
+    CHECK(workers.is_valid());
+
+    Mixer serial_mixer(frame_factory, sample_spec, true, arena);
+    CHECK(serial_mixer.is_valid());
+
+    Mixer parallel_mixer(frame_factory, sample_spec, true, MixerConfig(), &workers,
+                         arena);
+    CHECK(parallel_mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        serial_mixer.add_input(serial_readers[n]);
+        parallel_mixer.add_input(parallel_readers[n]);
+    }
+
+    for (size_t i = 0; i < NumIterations; i++) {
+        for (size_t n = 0; n < NumReaders; n++) {
+            for (size_t s = 0; s < BufSz; s++) {
+                // Large enough to cause saturation.
+                const sample_t value =
+                    (sample_t)core::fast_random_range(0, 1000) / 1000 * 0.8f - 0.3f;
+                serial_readers[n].add_samples(1, value);
+                parallel_readers[n].add_samples(1, value);
+            }
+        }
+
+        core::Slice<sample_t> serial_buf = new_buffer(BufSz);
+        core::Slice<sample_t> parallel_buf = new_buffer(BufSz);
+
+        Frame serial_frame(serial_buf.data(), serial_buf.size());
+        CHECK(serial_mixer.read(serial_frame));
+
+        Frame parallel_frame(parallel_buf.data(), parallel_buf.size());
+        CHECK(parallel_mixer.read(parallel_frame));
+
+        for (size_t s = 0; s < BufSz; s++) {
+            CHECK(serial_frame.raw_samples()[s] == parallel_frame.raw_samples()[s]);
+        }
+    }
+}
+
+TEST(mixer, grouped_many_readers) {
+    enum { NumReaders = 10, NumWorkers = 2, GroupSize = 3 };
+
+    test::MockReader readers[NumReaders];
+
+    core::WorkerPool workers(NumWorkers, arena);
+    CHECK(workers.is_valid());
+
+    MixerConfig config;
+    config.group_size = GroupSize;
+
+    Mixer mixer(frame_factory, sample_spec, true, config, &workers, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.add_input(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f, n == 4 ? Frame::FlagNotBlank : 0);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders, Frame::FlagNotBlank);
+
+    // Whole group is silent.
+    for (size_t n = 0; n < NumReaders; n++) {
+        if (n < GroupSize) {
+            readers[n].add_samples(BufSz, 0.0f, Frame::FlagSilent);
+        } else {
+            readers[n].add_samples(BufSz, 0.02f);
+        }
+    }
+    expect_output(mixer, BufSz, 0.02f * (NumReaders - GroupSize));
+
+    mixer.remove_input(readers[0]);
+    mixer.remove_input(readers[5]);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        if (n != 0 && n != 5) {
+            readers[n].add_samples(BufSz, 0.03f);
+        }
+    }
+    expect_output(mixer, BufSz, 0.03f * (NumReaders - 2));
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+}
+
+TEST(mixer, grouped_timestamps) {
+    enum { NumReaders = 5, GroupSize = 2 };
+
+    // BufSz samples per second
+    const SampleSpec sample_spec(BufSz, Sample_RawFormat, ChanLayout_Surround,
+                                 ChanOrder_Smpte, ChanMask_Surround_Mono);
+
+    test::MockReader readers[NumReaders];
+
+    MixerConfig config;
+    config.group_size = GroupSize;
+
+    Mixer mixer(frame_factory, sample_spec, true, config, NULL, arena);
+    CHECK(mixer.is_valid());
+
+    core::nanoseconds_t ts_sum = 0;
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        const core::nanoseconds_t start_ts =
+            1000000000000 + core::nanoseconds_t(n) * 3 * core::Second;
+
+        mixer.add_input(readers[n]);
+        readers[n].enable_timestamps(start_ts, sample_spec);
+        readers[n].add_samples(BufSz, 0.1f);
+
+        ts_sum += start_ts;
+    }
+
+    expect_output(mixer, BufSz, 0.1f * NumReaders, 0, ts_sum / NumReaders);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+}
+
+TEST(mixer, loudest_inputs) {
+    enum { NumReaders = 6, MaxActive = 2 };
+
+    test::MockReader readers[NumReaders];
+
+    MixerConfig config;
+    config.max_active_inputs = MaxActive;
+
+    Mixer mixer(frame_factory, sample_spec, true, config, NULL, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.add_input(readers[n]);
+    }
+
+    // Only two loudest are mixed, but flags are combined from all.
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f * (n + 1),
+                               n == 0 ? Frame::FlagPacketDrops : 0);
+    }
+    expect_output(mixer, BufSz, 0.05f + 0.06f, Frame::FlagPacketDrops);
+
+    // Silent inputs are never selected.
+    for (size_t n = 0; n < NumReaders; n++) {
+        if (n == 2) {
+            readers[n].add_samples(BufSz, 0.04f);
+        } else {
+            readers[n].add_samples(BufSz, 0.0f, Frame::FlagSilent);
+        }
+    }
+    expect_output(mixer, BufSz, 0.04f);
+
+    // All silent.
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.0f, Frame::FlagSilent);
+    }
+    expect_output(mixer, BufSz, 0, Frame::FlagSilent);
+
+    // Fewer talkers than limit.
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, 0.01f);
+    }
+    mixer.remove_input(readers[1]);
+    mixer.remove_input(readers[2]);
+    mixer.remove_input(readers[3]);
+    mixer.remove_input(readers[4]);
+    expect_output(mixer, BufSz, 0.02f);
+}
+
+TEST(mixer, loudest_inputs_parallel) {
+    enum { NumReaders = 8, NumWorkers = 3, GroupSize = 3, MaxActive = 3 };
+
+    test::MockReader readers[NumReaders];
+
+    core::WorkerPool workers(NumWorkers, arena);
+    CHECK(workers.is_valid());
+
+    MixerConfig config;
+    config.group_size = GroupSize;
+    config.max_active_inputs = MaxActive;
+
+    Mixer mixer(frame_factory, sample_spec, true, config, &workers, arena);
+    CHECK(mixer.is_valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.add_input(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add_samples(BufSz, n == 1 || n == 4 || n == 6 ? 0.1f : 0.001f);
+    }
+    expect_output(mixer, BufSz, 0.1f * 3);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+}
+
+TEST(mixer, invalid_group_size) {
+    MixerConfig config;
+    config.group_size = 0;
+
+    Mixer mixer(frame_factory, sample_spec, true, config, NULL, arena);
+    CHECK(!mixer.is_valid());
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/mixer_kernel.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { MaxSamples = 301 };
+
+sample_t random_sample(float range) {
+    return (float)core::fast_random_range(0, 100000) / 100000.f * range * 2 - range;
+}
+
+void check_kernel(MixerKernel kernel, size_t n_samples, float range) {
+    MixerKernelFunc scalar_func = mixer_kernel_func(MixerKernel_Scalar);
+    MixerKernelFunc kernel_func = mixer_kernel_func(kernel);
+
+    CHECK(scalar_func);
+    CHECK(kernel_func);
+
+    sample_t in[MaxSamples];
+    sample_t expected_out[MaxSamples];
+    sample_t actual_out[MaxSamples];
+
+    for (size_t n = 0; n < n_samples; n++) {
+        in[n] = random_sample(range);
+        expected_out[n] = actual_out[n] = random_sample(range);
+    }
+
+    scalar_func(expected_out, in, n_samples);
+    kernel_func(actual_out, in, n_samples);
+
+    for (size_t n = 0; n < n_samples; n++) {
+        CHECK(actual_out[n] >= Sample_Min);
+        CHECK(actual_out[n] <= Sample_Max);
+        DOUBLES_EQUAL((double)expected_out[n], (double)actual_out[n], 0);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(mixer_kernel) {};
+
+TEST(mixer_kernel, scalar_always_supported) {
+    CHECK(mixer_kernel_func(MixerKernel_Scalar));
+}
+
+TEST(mixer_kernel, best_supported) {
+    CHECK(mixer_kernel_func(mixer_kernel_best()));
+}
+
+TEST(mixer_kernel, scalar_saturation) {
+    MixerKernelFunc func = mixer_kernel_func(MixerKernel_Scalar);
+
+    sample_t out[4] = { 0.5f, -0.5f, 0.9f, -0.9f };
+    const sample_t in[4] = { 0.25f, -0.25f, 0.2f, -0.2f };
+
+    func(out, in, 4);
+
+    DOUBLES_EQUAL(0.75, (double)out[0], 0.0001);
+    DOUBLES_EQUAL(-0.75, (double)out[1], 0.0001);
+    DOUBLES_EQUAL((double)Sample_Max, (double)out[2], 0);
+    DOUBLES_EQUAL((double)Sample_Min, (double)out[3], 0);
+}
+
+TEST(mixer_kernel, same_as_scalar) {
+    const size_t sizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 100, MaxSamples };
+
+    for (int k = 0; k < MixerKernel_Max; k++) {
+        const MixerKernel kernel = (MixerKernel)k;
+        if (!mixer_kernel_func(kernel)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < ROC_ARRAY_SIZE(sizes); i++) {
+            // no saturation
+            check_kernel(kernel, sizes[i], 0.4f);
+            // saturation
+            check_kernel(kernel, sizes[i], 1.5f);
+        }
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -379,5 +379,75 @@ TEST(packetizer, metrics) {
     }
 }
 
+TEST(packetizer, dtx) {
+    enum { NumPackets = 10, KeepalivePackets = 3 };
+
+    // Packets which contain audio, others contain silence.
+    const bool is_audio[NumPackets] = {
+        true, false, false, false, false, false, false, false, false, true,
+    };
+    // Expected packets to be sent.
+    const bool is_sent[NumPackets] = {
+        true, true, false, false, true, false, false, true, false, true,
+    };
+
+    PcmEncoder encoder(packet_spec);
+    packet::Queue packet_queue;
+
+    DtxConfig dtx_config;
+    dtx_config.enabled = true;
+    dtx_config.silence_threshold = 0.001f;
+    dtx_config.keepalive_interval = PacketDuration * KeepalivePackets;
+
+    rtp::Identity identity;
+    rtp::Sequencer sequencer(identity, PayloadType);
+    Packetizer packetizer(packet_queue, rtp_composer, sequencer, encoder, packet_factory,
+                          PacketDuration, frame_spec, dtx_config);
+
+    for (size_t pn = 0; pn < NumPackets; pn++) {
+        sample_t samples[SamplesPerPacket * NumCh];
+        for (size_t n = 0; n < SamplesPerPacket * NumCh; n++) {
+            // Silence is below threshold, but not zero.
+            samples[n] = is_audio[pn] ? 0.5f : 0.0005f;
+        }
+
+        Frame frame(samples, SamplesPerPacket * NumCh);
+        packetizer.write(frame);
+    }
+
+    packet::PacketPtr first;
+    LONGS_EQUAL(status::StatusOK, packet_queue.read(first));
+    CHECK(first);
+    CHECK(!first->rtp()->marker);
+
+    size_t n_sent = 1;
+
+    for (size_t pn = 1; pn < NumPackets; pn++) {
+        if (!is_sent[pn]) {
+            continue;
+        }
+
+        packet::PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, packet_queue.read(pp));
+        CHECK(pp);
+
+        // Seqnums are continuous, timestamps have gaps.
+        UNSIGNED_LONGS_EQUAL(packet::seqnum_t(first->rtp()->seqnum + n_sent),
+                             pp->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(first->rtp()->stream_timestamp + pn * SamplesPerPacket,
+                             pp->rtp()->stream_timestamp);
+
+        // Marker is set on first packet after gap.
+        CHECK(pp->rtp()->marker == !is_sent[pn - 1]);
+
+        n_sent++;
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, packet_queue.size());
+
+    UNSIGNED_LONGS_EQUAL(n_sent, packetizer.metrics().packet_count);
+    UNSIGNED_LONGS_EQUAL(NumPackets - n_sent, packetizer.metrics().suppressed_count);
+}
+
 } // namespace audio
 } // namespace roc
@@ -90,6 +90,51 @@ void compare(const double* expected, const double* actual, size_t n_items) {
     }
 }
 
+// Map whole buffer at once (may take vectorized path), then map it again
+// sample-by-sample (always takes generic path), and check that results
+// are bit-exact.
+void check_bulk(const void* input,
+                size_t n_samples,
+                PcmFormat in_fmt,
+                PcmFormat out_fmt) {
+    enum { MaxBytes = 4096 };
+
+    PcmMapper mapper(in_fmt, out_fmt);
+
+    const size_t in_bytes = mapper.input_byte_count(n_samples);
+    const size_t out_bytes = mapper.output_byte_count(n_samples);
+
+    CHECK(in_bytes + 1 <= MaxBytes);
+    CHECK(out_bytes + 1 <= MaxBytes);
+
+    uint8_t bulk_output[MaxBytes] = {};
+    uint8_t generic_output[MaxBytes] = {};
+
+    size_t in_off = 0;
+    size_t out_off = 0;
+
+    UNSIGNED_LONGS_EQUAL(n_samples,
+                         mapper.map(input, in_bytes, in_off, bulk_output, out_bytes,
+                                    out_off, n_samples));
+
+    UNSIGNED_LONGS_EQUAL(in_bytes * 8, in_off);
+    UNSIGNED_LONGS_EQUAL(out_bytes * 8, out_off);
+
+    in_off = 0;
+    out_off = 0;
+
+    for (size_t n = 0; n < n_samples; n++) {
+        UNSIGNED_LONGS_EQUAL(1,
+                             mapper.map(input, in_bytes, in_off, generic_output,
+                                        out_bytes, out_off, 1));
+    }
+
+    UNSIGNED_LONGS_EQUAL(in_bytes * 8, in_off);
+    UNSIGNED_LONGS_EQUAL(out_bytes * 8, out_off);
+
+    compare(generic_output, bulk_output, out_bytes);
+}
+
 } // namespace
 
 TEST_GROUP(pcm_mapper) {};
@@ -1037,5 +1082,77 @@ TEST(pcm_mapper, le_to_be) {
     compare(expected_output, actual_output, NumOutputBytes);
 }
 
+
+TEST(pcm_mapper, bulk_int_to_float32) {
+    enum { NumSamples = 501 };
+
+    const PcmFormat int_formats[] = {
+        PcmFormat_SInt16_Le, PcmFormat_SInt16_Be, PcmFormat_SInt24_Le,
+        PcmFormat_SInt24_Be, PcmFormat_SInt32_Le, PcmFormat_SInt32_Be,
+    };
+
+    uint8_t input[NumSamples * 4];
+    for (size_t n = 0; n < sizeof(input); n++) {
+        input[n] = uint8_t(n * 37 + n / 3);
+    }
+    // extreme values at the beginning
+    input[0] = input[1] = input[2] = input[3] = 0x80;
+    input[4] = input[5] = input[6] = input[7] = 0x7f;
+    input[8] = input[9] = input[10] = input[11] = 0xff;
+
+    for (size_t i = 0; i < ROC_ARRAY_SIZE(int_formats); i++) {
+        check_bulk(input, NumSamples, int_formats[i], PcmFormat_Float32_Le);
+    }
+}
+
+TEST(pcm_mapper, bulk_float32_to_int) {
+    enum { NumSamples = 501 };
+
+    const PcmFormat int_formats[] = {
+        PcmFormat_SInt16_Le, PcmFormat_SInt16_Be, PcmFormat_SInt24_Le,
+        PcmFormat_SInt24_Be, PcmFormat_SInt32_Le, PcmFormat_SInt32_Be,
+    };
+
+    float input[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        input[n] = float(n % 97) / 40.0f - 1.2f;
+    }
+    // edge values at the beginning
+    input[0] = -1.0f;
+    input[1] = 1.0f;
+    input[2] = 0.99999994f;
+    input[3] = -0.99999994f;
+    input[4] = 1.5f;
+    input[5] = -1.5f;
+    input[6] = 0.0f;
+    input[7] = 100.0f;
+    input[8] = -100.0f;
+
+    for (size_t i = 0; i < ROC_ARRAY_SIZE(int_formats); i++) {
+        check_bulk(input, NumSamples, PcmFormat_Float32_Le, int_formats[i]);
+    }
+}
+
+TEST(pcm_mapper, bulk_same_format) {
+    enum { NumSamples = 501 };
+
+    const PcmFormat formats[] = {
+        PcmFormat_SInt8,     PcmFormat_UInt8,     PcmFormat_SInt16_Le,
+        PcmFormat_SInt16_Be, PcmFormat_UInt16_Le, PcmFormat_SInt24_Le,
+        PcmFormat_SInt24_Be, PcmFormat_UInt24_Be, PcmFormat_SInt32_Le,
+        PcmFormat_SInt32_Be, PcmFormat_UInt32_Le, PcmFormat_SInt64_Be,
+        PcmFormat_UInt64_Le,
+    };
+
+    uint8_t input[NumSamples * 8];
+    for (size_t n = 0; n < sizeof(input); n++) {
+        input[n] = uint8_t(n * 37 + n / 3);
+    }
+
+    for (size_t i = 0; i < ROC_ARRAY_SIZE(formats); i++) {
+        check_bulk(input, NumSamples, formats[i], formats[i]);
+    }
+}
+
 } // namespace audio
 } // namespace roc
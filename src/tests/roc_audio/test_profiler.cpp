@@ -128,5 +128,71 @@ TEST(profiler, test_moving_average) {
     }
 }
 
+TEST(profiler, sampling_frames) {
+    ProfilerConfig config = profiler_config;
+    config.sampling_frames = 3;
+
+    Profiler profiler(arena, sample_spec, config);
+    CHECK(profiler.is_valid());
+
+    for (size_t i = 0; i < 9; i++) {
+        // Every 3rd frame is measured.
+        CHECK_EQUAL(i % 3 == 2, profiler.should_measure());
+
+        if (profiler.should_measure()) {
+            profiler.add_frame(10, core::Second / 1000);
+        } else {
+            profiler.skip_frame(10);
+        }
+    }
+
+    const ProfilerMetrics metrics = profiler.metrics();
+
+    UNSIGNED_LONGS_EQUAL(3, metrics.measured_frames);
+    UNSIGNED_LONGS_EQUAL(6, metrics.skipped_frames);
+    DOUBLES_EQUAL(10000, metrics.speed, EpsilionThreshold);
+    DOUBLES_EQUAL(10000. / SampleRate, metrics.speed_ratio, EpsilionThreshold);
+}
+
+TEST(profiler, sampling_interval) {
+    ProfilerConfig config = profiler_config;
+    // 100 samples.
+    config.sampling_interval = 20 * core::Millisecond;
+
+    Profiler profiler(arena, sample_spec, config);
+    CHECK(profiler.is_valid());
+
+    // Frames are skipped until skipped frames cover sampling interval.
+    for (size_t i = 0; i < 2; i++) {
+        CHECK(!profiler.should_measure());
+        profiler.skip_frame(40);
+        CHECK(!profiler.should_measure());
+        profiler.skip_frame(40);
+        CHECK(!profiler.should_measure());
+        profiler.skip_frame(40);
+
+        CHECK(profiler.should_measure());
+        profiler.add_frame(40, core::Second / 100);
+    }
+
+    CHECK(!profiler.should_measure());
+
+    const ProfilerMetrics metrics = profiler.metrics();
+
+    UNSIGNED_LONGS_EQUAL(2, metrics.measured_frames);
+    UNSIGNED_LONGS_EQUAL(6, metrics.skipped_frames);
+}
+
+TEST(profiler, no_frames) {
+    Profiler profiler(arena, sample_spec, profiler_config);
+    CHECK(profiler.is_valid());
+
+    const ProfilerMetrics metrics = profiler.metrics();
+
+    DOUBLES_EQUAL(0, metrics.speed, EpsilionThreshold);
+    DOUBLES_EQUAL(0, metrics.speed_ratio, EpsilionThreshold);
+    UNSIGNED_LONGS_EQUAL(0, metrics.measured_frames);
+}
+
 } // namespace audio
 } // namespace roc
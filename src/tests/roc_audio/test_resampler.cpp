@@ -215,6 +215,8 @@ const char* dir_to_str(Direction dir) {
 double timestamp_allowance(ResamplerBackend backend) {
     switch (backend) {
     case ResamplerBackend_Builtin:
+    case ResamplerBackend_BuiltinFixed:
+    case ResamplerBackend_BuiltinPolyphase:
         return 0.1;
     case ResamplerBackend_Speex:
         return 5;
@@ -652,6 +654,719 @@ TEST(resampler, upscale_downscale_stereo) {
     }
 }
 
+// Check that builtin resampler produces exactly the same output for every
+// channel of a multichannel stream, as for the same channel resampled alone.
+TEST(resampler, builtin_multichannel_same_as_mono) {
+    enum {
+        SampleRate = 44100,
+        NumPad = 2 * OutFrameSize,
+        NumSamples = 20 * OutFrameSize
+    };
+
+    const ChannelMask ch_masks[] = { 0x3, 0x3F };
+    const float Scaling = 0.97f;
+
+    for (size_t n_prof = 0; n_prof < ROC_ARRAY_SIZE(supported_profiles); n_prof++) {
+        const ResamplerProfile profile = supported_profiles[n_prof];
+
+        const SampleSpec mono_spec(SampleRate, Sample_RawFormat, ChanLayout_Surround,
+                                   ChanOrder_Smpte, 0x1);
+
+        sample_t mono_input[NumSamples];
+        generate_sine(mono_input, NumSamples, NumPad);
+
+        sample_t mono_output[NumSamples] = {};
+        resample(ResamplerBackend_Builtin, profile, Dir_Read, mono_input, mono_output,
+                 NumSamples, mono_spec, Scaling);
+
+        for (size_t n_mask = 0; n_mask < ROC_ARRAY_SIZE(ch_masks); n_mask++) {
+            const SampleSpec sample_spec(SampleRate, Sample_RawFormat,
+                                         ChanLayout_Surround, ChanOrder_Smpte,
+                                         ch_masks[n_mask]);
+            const size_t num_ch = sample_spec.num_channels();
+
+            // Every channel is mono signal multiplied by a power of two,
+            // so the result of every channel is exactly predictable.
+            sample_t input[NumSamples * 6];
+            for (size_t n = 0; n < NumSamples; n++) {
+                for (size_t ch = 0; ch < num_ch; ch++) {
+                    input[n * num_ch + ch] = mono_input[n] / (sample_t)(1 << ch);
+                }
+            }
+
+            sample_t output[NumSamples * 6] = {};
+            resample(ResamplerBackend_Builtin, profile, Dir_Read, input, output,
+                     NumSamples * num_ch, sample_spec, Scaling);
+
+            for (size_t n = 0; n < NumSamples; n++) {
+                for (size_t ch = 0; ch < num_ch; ch++) {
+                    DOUBLES_EQUAL((double)(mono_output[n] / (sample_t)(1 << ch)),
+                                  (double)output[n * num_ch + ch], 0);
+                }
+            }
+        }
+    }
+}
+
+// Check that builtin resampler doesn't shrink input frame when output rate
+// is higher than input rate, so that every pushed frame produces a batch of
+// output samples proportional to the rates ratio.
+TEST(resampler, builtin_upscale_frame_size) {
+    enum { ChMask = 0x3, InRate = 48000, OutRate = 192000, NumIterations = 20 };
+
+    const SampleSpec in_spec(InRate, Sample_RawFormat, ChanLayout_Surround,
+                             ChanOrder_Smpte, ChMask);
+    const SampleSpec out_spec(OutRate, Sample_RawFormat, ChanLayout_Surround,
+                              ChanOrder_Smpte, ChMask);
+
+    for (size_t n_prof = 0; n_prof < ROC_ARRAY_SIZE(supported_profiles); n_prof++) {
+        const ResamplerConfig config =
+            make_config(ResamplerBackend_Builtin, supported_profiles[n_prof]);
+
+        core::SharedPtr<IResampler> same_rate_resampler =
+            ResamplerMap::instance().new_resampler(arena, frame_factory, config,
+                                                   in_spec, in_spec);
+        CHECK(same_rate_resampler);
+        CHECK(same_rate_resampler->is_valid());
+
+        core::SharedPtr<IResampler> resampler = ResamplerMap::instance().new_resampler(
+            arena, frame_factory, config, in_spec, out_spec);
+        CHECK(resampler);
+        CHECK(resampler->is_valid());
+        CHECK(resampler->set_scaling(InRate, OutRate, 1.0f));
+
+        const size_t in_size = resampler->begin_push_input().size();
+        CHECK(in_size >= same_rate_resampler->begin_push_input().size());
+        resampler->end_push_input();
+
+        size_t n_pushed = 1;
+        size_t n_popped = 0;
+
+        for (size_t i = 0; i < NumIterations; i++) {
+            sample_t out[MaxFrameSize];
+            const size_t n_out = resampler->pop_output(out, ROC_ARRAY_SIZE(out));
+            CHECK(n_out < ROC_ARRAY_SIZE(out));
+
+            n_popped += n_out;
+
+            const core::Slice<sample_t>& buf = resampler->begin_push_input();
+            UNSIGNED_LONGS_EQUAL(in_size, buf.size());
+            resampler->end_push_input();
+
+            n_pushed++;
+        }
+
+        // first two frames are history
+        DOUBLES_EQUAL((double)(n_pushed - 3) * in_size * OutRate / InRate,
+                      (double)n_popped, in_size * OutRate / InRate);
+    }
+}
+
+// Check that integer ratio conversions, which are handled by a separate
+// decimation stage, produce sine at correct position, with and without
+// drift correction. Builtin resampler doesn't have exactly unity gain,
+// so we compare with sine scaled by gain estimated from output. Position
+// of output samples is computed from n_left_to_process().
+TEST(resampler, builtin_integer_ratio) {
+    enum { ChMask = 0x1, OutChunkSize = 64, WarmupSamples = 2000, NumChunks = 200 };
+
+    const ResamplerBackend backends[] = { ResamplerBackend_Builtin,
+                                          ResamplerBackend_BuiltinFixed,
+                                          ResamplerBackend_BuiltinPolyphase };
+    const size_t rates[][2] = { { 96000, 48000 }, { 48000, 24000 }, { 48000, 16000 } };
+    const float scalings[] = { 1.0f, 0.999f, 1.001f };
+
+    const double SineFreq = 1000;
+    const double Amplitude = 0.5;
+    // gain of builtin resampler slightly depends on fractional position
+    const double Epsilon = 0.015;
+
+    for (size_t n_back = 0; n_back < ROC_ARRAY_SIZE(backends); n_back++) {
+        for (size_t n_rate = 0; n_rate < ROC_ARRAY_SIZE(rates); n_rate++) {
+            for (size_t n_scale = 0; n_scale < ROC_ARRAY_SIZE(scalings); n_scale++) {
+                const SampleSpec in_spec(rates[n_rate][0], Sample_RawFormat,
+                                         ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+                const SampleSpec out_spec(rates[n_rate][1], Sample_RawFormat,
+                                          ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+                core::SharedPtr<IResampler> resampler =
+                    ResamplerMap::instance().new_resampler(
+                        arena, frame_factory,
+                        make_config(backends[n_back], ResamplerProfile_Medium),
+                        in_spec, out_spec);
+                CHECK(resampler);
+                CHECK(resampler->is_valid());
+
+                CHECK(resampler->set_scaling(in_spec.sample_rate(),
+                                             out_spec.sample_rate(),
+                                             scalings[n_scale]));
+
+                const double step = 2 * M_PI * SineFreq / in_spec.sample_rate();
+
+                double expected[NumChunks] = {};
+                double actual[NumChunks] = {};
+
+                size_t n_pushed = 0;
+                size_t n_checked = 0;
+
+                while (n_checked < NumChunks) {
+                    sample_t out[OutChunkSize];
+                    size_t out_pos = 0;
+
+                    while (out_pos < OutChunkSize) {
+                        out_pos +=
+                            resampler->pop_output(out + out_pos, OutChunkSize - out_pos);
+
+                        if (out_pos < OutChunkSize) {
+                            const core::Slice<sample_t>& buf =
+                                resampler->begin_push_input();
+                            for (size_t n = 0; n < buf.size(); n++) {
+                                buf.data()[n] =
+                                    (sample_t)(Amplitude * std::sin(step * n_pushed++));
+                            }
+                            resampler->end_push_input();
+                        }
+                    }
+
+                    if (n_pushed < WarmupSamples) {
+                        continue;
+                    }
+
+                    // last output sample corresponds to this input position
+                    const double in_pos =
+                        double(n_pushed - 1) - (double)resampler->n_left_to_process();
+
+                    expected[n_checked] = Amplitude * std::sin(step * in_pos);
+                    actual[n_checked] = out[OutChunkSize - 1];
+
+                    n_checked++;
+                }
+
+                double cross = 0, energy = 0;
+                for (size_t n = 0; n < NumChunks; n++) {
+                    cross += expected[n] * actual[n];
+                    energy += expected[n] * expected[n];
+                }
+                const double gain = cross / energy;
+
+                CHECK(gain > 0.9 && gain < 1.2);
+
+                for (size_t n = 0; n < NumChunks; n++) {
+                    if (std::abs(expected[n] * gain - actual[n]) > Epsilon) {
+                        fail("\nunexpected sample:\n"
+                             " backend=%s in_rate=%d out_rate=%d scaling=%f\n"
+                             " gain=%f expected=%f actual=%f",
+                             resampler_backend_to_str(backends[n_back]),
+                             (int)rates[n_rate][0], (int)rates[n_rate][1],
+                             (double)scalings[n_scale], gain, expected[n] * gain,
+                             actual[n]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Check that fixed-point builtin resampler produces the same output as
+// floating-point one, up to 16-bit precision.
+TEST(resampler, builtin_fixed_same_as_float) {
+    enum {
+        SampleRate = 44100,
+        NumPad = 2 * OutFrameSize,
+        NumSamples = 20 * OutFrameSize
+    };
+
+    const ChannelMask ch_masks[] = { 0x1, 0x3, 0x3F };
+    const float scalings[] = { 0.97f, 1.0f, 1.03f };
+
+    // Two Q1.15 LSBs: one for input rounding, one for coefficients
+    // and accumulation.
+    const double Epsilon = 2.0 / (1 << 15);
+
+    for (size_t n_prof = 0; n_prof < ROC_ARRAY_SIZE(supported_profiles); n_prof++) {
+        for (size_t n_mask = 0; n_mask < ROC_ARRAY_SIZE(ch_masks); n_mask++) {
+            for (size_t n_sc = 0; n_sc < ROC_ARRAY_SIZE(scalings); n_sc++) {
+                const ResamplerProfile profile = supported_profiles[n_prof];
+                const SampleSpec sample_spec(SampleRate, Sample_RawFormat,
+                                             ChanLayout_Surround, ChanOrder_Smpte,
+                                             ch_masks[n_mask]);
+                const size_t num_ch = sample_spec.num_channels();
+
+                sample_t mono_input[NumSamples];
+                generate_sine(mono_input, NumSamples, NumPad);
+
+                sample_t input[NumSamples * 6];
+                for (size_t n = 0; n < NumSamples; n++) {
+                    for (size_t ch = 0; ch < num_ch; ch++) {
+                        input[n * num_ch + ch] = mono_input[n];
+                    }
+                }
+
+                sample_t float_output[NumSamples * 6] = {};
+                resample(ResamplerBackend_Builtin, profile, Dir_Read, input,
+                         float_output, NumSamples * num_ch, sample_spec,
+                         scalings[n_sc]);
+
+                sample_t fixed_output[NumSamples * 6] = {};
+                resample(ResamplerBackend_BuiltinFixed, profile, Dir_Read, input,
+                         fixed_output, NumSamples * num_ch, sample_spec,
+                         scalings[n_sc]);
+
+                for (size_t n = 0; n < NumSamples * num_ch; n++) {
+                    DOUBLES_EQUAL((double)float_output[n], (double)fixed_output[n],
+                                  Epsilon);
+                }
+            }
+        }
+    }
+}
+
+// Check that polyphase builtin resampler reproduces sine wave for non-integer
+// rates ratio on every channel, and is at least as close to it as regular
+// builtin resampler. Polyphase one interpolates coefficients for exact
+// position of every tap, while regular one reuses same fractional position
+// for all taps in window half, so its error is used as an upper bound.
+TEST(resampler, builtin_polyphase_quality) {
+    enum { OutChunkSize = 64, WarmupSamples = 2000, NumChunks = 200 };
+
+    const size_t rates[][2] = { { 44100, 48000 }, { 48000, 44100 } };
+    const ChannelMask ch_masks[] = { 0x1, 0x3, 0x3F };
+    const float scalings[] = { 1.0f, 0.999f, 1.001f };
+
+    const double SineFreq = 1000;
+    const double Amplitude = 0.5;
+    const double Epsilon = 0.001;
+
+    const ResamplerBackend backends[] = { ResamplerBackend_Builtin,
+                                          ResamplerBackend_BuiltinPolyphase };
+
+    for (size_t n_prof = 0; n_prof < ROC_ARRAY_SIZE(supported_profiles); n_prof++) {
+        for (size_t n_rate = 0; n_rate < ROC_ARRAY_SIZE(rates); n_rate++) {
+            for (size_t n_mask = 0; n_mask < ROC_ARRAY_SIZE(ch_masks); n_mask++) {
+                for (size_t n_sc = 0; n_sc < ROC_ARRAY_SIZE(scalings); n_sc++) {
+                    const SampleSpec in_spec(rates[n_rate][0], Sample_RawFormat,
+                                             ChanLayout_Surround, ChanOrder_Smpte,
+                                             ch_masks[n_mask]);
+                    const SampleSpec out_spec(rates[n_rate][1], Sample_RawFormat,
+                                              ChanLayout_Surround, ChanOrder_Smpte,
+                                              ch_masks[n_mask]);
+                    const size_t num_ch = in_spec.num_channels();
+
+                    const double step = 2 * M_PI * SineFreq / in_spec.sample_rate();
+
+                    double max_error[ROC_ARRAY_SIZE(backends)] = {};
+
+                    for (size_t n_back = 0; n_back < ROC_ARRAY_SIZE(backends); n_back++) {
+                        core::SharedPtr<IResampler> resampler =
+                            ResamplerMap::instance().new_resampler(
+                                arena, frame_factory,
+                                make_config(backends[n_back], supported_profiles[n_prof]),
+                                in_spec, out_spec);
+                        CHECK(resampler);
+                        CHECK(resampler->is_valid());
+                        CHECK(resampler->set_scaling(in_spec.sample_rate(),
+                                                     out_spec.sample_rate(),
+                                                     scalings[n_sc]));
+
+                        double pos[NumChunks] = {};
+                        double actual[NumChunks] = {};
+
+                        size_t n_pushed = 0;
+                        size_t n_checked = 0;
+
+                        while (n_checked < NumChunks) {
+                            sample_t out[OutChunkSize * 6];
+                            size_t out_pos = 0;
+
+                            while (out_pos < OutChunkSize * num_ch) {
+                                out_pos += resampler->pop_output(
+                                    out + out_pos, OutChunkSize * num_ch - out_pos);
+
+                                if (out_pos < OutChunkSize * num_ch) {
+                                    const core::Slice<sample_t>& buf =
+                                        resampler->begin_push_input();
+                                    for (size_t n = 0; n < buf.size(); n += num_ch) {
+                                        const double s =
+                                            Amplitude * std::sin(step * n_pushed++);
+                                        for (size_t ch = 0; ch < num_ch; ch++) {
+                                            buf.data()[n + ch] = (sample_t)s;
+                                        }
+                                    }
+                                    resampler->end_push_input();
+                                }
+                            }
+
+                            if (n_pushed < WarmupSamples) {
+                                continue;
+                            }
+
+                            // last output frame corresponds to this input position
+                            pos[n_checked] = double(n_pushed - 1)
+                                - (double)resampler->n_left_to_process() / num_ch;
+
+                            const sample_t* frame = out + (OutChunkSize - 1) * num_ch;
+                            for (size_t ch = 1; ch < num_ch; ch++) {
+                                DOUBLES_EQUAL((double)frame[0], (double)frame[ch],
+                                              1e-6);
+                            }
+                            actual[n_checked] = frame[0];
+
+                            n_checked++;
+                        }
+
+                        // position estimate is approximate, so fit amplitude and
+                        // phase of sine by least squares and check the residual
+                        double ss = 0, sc = 0, cc = 0, as = 0, ac = 0;
+                        for (size_t n = 0; n < NumChunks; n++) {
+                            const double s = std::sin(step * pos[n]);
+                            const double c = std::cos(step * pos[n]);
+                            ss += s * s;
+                            sc += s * c;
+                            cc += c * c;
+                            as += actual[n] * s;
+                            ac += actual[n] * c;
+                        }
+                        const double det = ss * cc - sc * sc;
+                        const double a = (as * cc - ac * sc) / det;
+                        const double b = (ac * ss - as * sc) / det;
+
+                        const double gain = std::sqrt(a * a + b * b) / Amplitude;
+                        CHECK(gain > 0.9 && gain < 1.2);
+
+                        for (size_t n = 0; n < NumChunks; n++) {
+                            const double expected =
+                                a * std::sin(step * pos[n]) + b * std::cos(step * pos[n]);
+                            max_error[n_back] = std::max(max_error[n_back],
+                                                         std::abs(expected - actual[n]));
+                        }
+                    }
+
+                    CHECK(max_error[1] < Epsilon);
+                    CHECK(max_error[1] <= max_error[0]);
+                }
+            }
+        }
+    }
+}
+
+// Testing that resampler reader bypasses resampler during long silence.
+// Output produced from silent input must be marked silent and zeroed, and
+// signal after silence must appear at the same position as if silence
+// was not marked and was passed through resampler.
+TEST(resampler, reader_silence_bypass) {
+    enum {
+        ChMask = 0x3,
+        FrameLen = 200,
+        NumSilent = 40000,
+        NumSignal = 20000,
+        NumFrames = 300
+    };
+
+    const sample_t signal = 0.5f;
+
+    for (size_t n_back = 0; n_back < ResamplerMap::instance().num_backends(); n_back++) {
+        for (size_t n_prof = 0; n_prof < ROC_ARRAY_SIZE(supported_profiles); n_prof++) {
+            const ResamplerBackend backend = ResamplerMap::instance().nth_backend(n_back);
+
+            const SampleSpec in_spec = SampleSpec(44100, Sample_RawFormat,
+                                                  ChanLayout_Surround, ChanOrder_Smpte,
+                                                  ChMask);
+            const SampleSpec out_spec = SampleSpec(48000, Sample_RawFormat,
+                                                   ChanLayout_Surround, ChanOrder_Smpte,
+                                                   ChMask);
+
+            // Position of first non-zero output sample, with and without
+            // silence flag.
+            size_t signal_pos[2] = {};
+
+            for (size_t n_mark = 0; n_mark < 2; n_mark++) {
+                core::SharedPtr<IResampler> resampler =
+                    ResamplerMap::instance().new_resampler(
+                        arena, frame_factory,
+                        make_config(backend, supported_profiles[n_prof]), in_spec,
+                        out_spec);
+                CHECK(resampler);
+                CHECK(resampler->is_valid());
+
+                test::MockReader input_reader;
+                input_reader.add_samples(NumSilent, 0,
+                                         n_mark ? (unsigned)Frame::FlagSilent : 0);
+                input_reader.add_samples(NumSignal, signal);
+
+                ResamplerReader rreader(input_reader, *resampler, in_spec, out_spec);
+                CHECK(rreader.is_valid());
+                CHECK(rreader.set_scaling(1.0f));
+
+                size_t n_silent_frames = 0;
+                bool got_signal = false;
+
+                for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+                    sample_t samples[FrameLen] = {};
+                    Frame frame(samples, FrameLen);
+                    CHECK(rreader.read(frame));
+
+                    if (frame.flags() & Frame::FlagSilent) {
+                        CHECK(!got_signal);
+                        n_silent_frames++;
+                    }
+
+                    for (size_t n = 0; n < FrameLen; n++) {
+                        if (frame.flags() & Frame::FlagSilent) {
+                            CHECK(samples[n] == 0);
+                        }
+                        if (!got_signal && samples[n] != 0) {
+                            signal_pos[n_mark] = n_frame * FrameLen + n;
+                            got_signal = true;
+                        }
+                    }
+                }
+
+                CHECK(got_signal);
+
+                if (n_mark) {
+                    CHECK(n_silent_frames > 0);
+                } else {
+                    CHECK(n_silent_frames == 0);
+                }
+            }
+
+            // Allow one sample per channel of rounding error.
+            CHECK(signal_pos[1] + out_spec.num_channels() >= signal_pos[0]);
+            CHECK(signal_pos[1] <= signal_pos[0] + out_spec.num_channels());
+        }
+    }
+}
+
+// Testing that resampler reader replaces resampler only during silence.
+// Signal after silence may be delayed only by initial delay of the new
+// resampler, which is below a couple of milliseconds.
+TEST(resampler, reader_switch_resampler) {
+    enum {
+        ChMask = 0x3,
+        FrameLen = 200,
+        NumSignal = 20000,
+        NumSilent = 40000,
+        NumFrames = 400
+    };
+
+    const sample_t signal = 0.5f;
+
+    for (size_t n_back = 0; n_back < ResamplerMap::instance().num_backends(); n_back++) {
+        const ResamplerBackend backend = ResamplerMap::instance().nth_backend(n_back);
+
+        const SampleSpec in_spec = SampleSpec(
+            44100, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+        const SampleSpec out_spec = SampleSpec(
+            48000, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+        // Position of first non-zero output sample after silence,
+        // without and with replacement.
+        size_t signal_pos[2] = {};
+
+        for (size_t n_switch = 0; n_switch < 2; n_switch++) {
+            core::SharedPtr<IResampler> resampler =
+                ResamplerMap::instance().new_resampler(
+                    arena, frame_factory, make_config(backend, ResamplerProfile_Medium),
+                    in_spec, out_spec);
+            CHECK(resampler);
+
+            core::SharedPtr<IResampler> next_resampler =
+                ResamplerMap::instance().new_resampler(
+                    arena, frame_factory, make_config(backend, ResamplerProfile_Medium),
+                    in_spec, out_spec);
+            CHECK(next_resampler);
+
+            test::MockReader input_reader;
+            input_reader.add_samples(NumSignal, signal);
+            input_reader.add_samples(NumSilent, 0, Frame::FlagSilent);
+            input_reader.add_samples(NumSignal, signal);
+
+            ResamplerReader rreader(input_reader, *resampler, in_spec, out_spec);
+            CHECK(rreader.is_valid());
+
+            if (n_switch) {
+                CHECK(rreader.set_resampler(*next_resampler));
+                CHECK(rreader.has_pending_resampler());
+            }
+
+            bool got_silence = false;
+            bool got_signal = false;
+
+            for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+                sample_t samples[FrameLen] = {};
+                Frame frame(samples, FrameLen);
+                CHECK(rreader.read(frame));
+
+                if (frame.flags() & Frame::FlagSilent) {
+                    got_silence = true;
+                }
+
+                if (!got_silence) {
+                    // Not replaced while signal is playing.
+                    CHECK(rreader.has_pending_resampler() == (n_switch != 0));
+                    continue;
+                }
+
+                for (size_t n = 0; n < FrameLen; n++) {
+                    if (!got_signal && samples[n] != 0) {
+                        signal_pos[n_switch] = n_frame * FrameLen + n;
+                        got_signal = true;
+                    }
+                }
+            }
+
+            CHECK(got_silence);
+            CHECK(got_signal);
+            CHECK(!rreader.has_pending_resampler());
+        }
+
+
+        const size_t max_delay =
+            out_spec.ns_2_samples_overall(2 * core::Millisecond);
+
+        CHECK(signal_pos[1] + out_spec.num_channels() >= signal_pos[0]);
+        CHECK(signal_pos[1] <= signal_pos[0] + max_delay);
+    }
+}
+
+// Reader created without resampler is an identity stage until resampler is set.
+TEST(resampler, reader_deferred_resampler) {
+    enum { ChMask = 0x3, FrameLen = 200, NumFrames = 10 };
+
+    const SampleSpec spec =
+        SampleSpec(44100, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+    for (size_t n_back = 0; n_back < ResamplerMap::instance().num_backends(); n_back++) {
+        const ResamplerBackend backend = ResamplerMap::instance().nth_backend(n_back);
+
+        test::MockReader input_reader;
+        input_reader.add_samples(FrameLen * NumFrames, 0.5f);
+        input_reader.add_zero_samples();
+
+        ResamplerReader rreader(input_reader, spec, spec);
+        CHECK(rreader.is_valid());
+        CHECK(!rreader.has_resampler());
+
+        // Can't leave passthrough without resampler.
+        CHECK(!rreader.set_passthrough(false));
+
+        for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+            sample_t samples[FrameLen] = {};
+            Frame frame(samples, FrameLen);
+            CHECK(rreader.read(frame));
+
+            // Frame is read from underlying reader directly.
+            POINTERS_EQUAL(samples, input_reader.last_data());
+            for (size_t n = 0; n < FrameLen; n++) {
+                DOUBLES_EQUAL(0.5f, samples[n], 0);
+            }
+        }
+
+        core::SharedPtr<IResampler> resampler = ResamplerMap::instance().new_resampler(
+            arena, frame_factory, make_config(backend, ResamplerProfile_Medium), spec,
+            spec);
+        CHECK(resampler);
+
+        // Applied at once, since reader is in passthrough mode.
+        CHECK(rreader.set_resampler(*resampler));
+        CHECK(rreader.has_resampler());
+        CHECK(!rreader.has_pending_resampler());
+
+        CHECK(rreader.set_passthrough(false));
+        CHECK(rreader.set_scaling(1.001f));
+
+        for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+            sample_t samples[FrameLen] = {};
+            Frame frame(samples, FrameLen);
+            CHECK(rreader.read(frame));
+
+            CHECK(input_reader.last_data() != samples);
+        }
+    }
+}
+
+// Writer in passthrough mode is an identity stage.
+TEST(resampler, writer_passthrough) {
+    enum { ChMask = 0x3, FrameLen = 200, NumFrames = 10 };
+
+    const SampleSpec spec =
+        SampleSpec(44100, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+    const SampleSpec other_spec =
+        SampleSpec(48000, Sample_RawFormat, ChanLayout_Surround, ChanOrder_Smpte, ChMask);
+
+    for (size_t n_back = 0; n_back < ResamplerMap::instance().num_backends(); n_back++) {
+        const ResamplerBackend backend = ResamplerMap::instance().nth_backend(n_back);
+
+        { // passthrough
+            core::SharedPtr<IResampler> resampler =
+                ResamplerMap::instance().new_resampler(
+                    arena, frame_factory, make_config(backend, ResamplerProfile_Medium),
+                    spec, spec);
+            CHECK(resampler);
+
+            test::MockWriter output_writer;
+
+            ResamplerWriter rwriter(output_writer, *resampler, frame_factory, spec,
+                                    spec);
+            CHECK(rwriter.is_valid());
+            CHECK(rwriter.set_passthrough(true));
+
+            for (size_t n_frame = 0; n_frame < NumFrames; n_frame++) {
+                sample_t samples[FrameLen];
+                for (size_t n = 0; n < FrameLen; n++) {
+                    samples[n] = 0.5f;
+                }
+                Frame frame(samples, FrameLen);
+                rwriter.write(frame);
+            }
+
+            // Frames are written to underlying writer as is.
+            UNSIGNED_LONGS_EQUAL(NumFrames, output_writer.n_writes());
+            UNSIGNED_LONGS_EQUAL(FrameLen * NumFrames, output_writer.num_unread());
+            for (size_t n = 0; n < FrameLen * NumFrames; n++) {
+                DOUBLES_EQUAL(0.5f, output_writer.get(), 0);
+            }
+
+            // Resampler starts from initial state.
+            CHECK(rwriter.set_passthrough(false));
+            CHECK(rwriter.set_scaling(1.001f));
+        }
+        { // can't enable passthrough after resampler was used
+            core::SharedPtr<IResampler> resampler =
+                ResamplerMap::instance().new_resampler(
+                    arena, frame_factory, make_config(backend, ResamplerProfile_Medium),
+                    spec, spec);
+            CHECK(resampler);
+
+            test::MockWriter output_writer;
+
+            ResamplerWriter rwriter(output_writer, *resampler, frame_factory, spec,
+                                    spec);
+            CHECK(rwriter.is_valid());
+
+            sample_t samples[FrameLen] = {};
+            Frame frame(samples, FrameLen);
+            rwriter.write(frame);
+
+            CHECK(!rwriter.set_passthrough(true));
+        }
+        { // can't enable passthrough with rate conversion
+            core::SharedPtr<IResampler> resampler =
+                ResamplerMap::instance().new_resampler(
+                    arena, frame_factory, make_config(backend, ResamplerProfile_Medium),
+                    spec, other_spec);
+            CHECK(resampler);
+
+            test::MockWriter output_writer;
+
+            ResamplerWriter rwriter(output_writer, *resampler, frame_factory, spec,
+                                    other_spec);
+            CHECK(rwriter.is_valid());
+            CHECK(!rwriter.set_passthrough(true));
+        }
+    }
+}
+
 // Testing how resampler deals with timestamps: output frame timestamp must accumulate
 // number of previous sammples multiplid by immediate sample rate.
 TEST(resampler, reader_timestamp_passthrough) {
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/builtin_resampler.h"
+#include "roc_audio/channel_defs.h"
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/heap_arena.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { MaxFrameSize = 4000 };
+
+core::HeapArena arena;
+FrameFactory frame_factory(arena, MaxFrameSize * sizeof(sample_t));
+
+} // namespace
+
+TEST_GROUP(sinc_table_cache) {};
+
+TEST(sinc_table_cache, same_key) {
+    SincTableCache& cache = SincTableCache::instance();
+    const size_t n_tables = cache.num_tables();
+
+    const sample_t* t1 = cache.acquire(8, 16);
+    const sample_t* t2 = cache.acquire(8, 16);
+
+    CHECK(t1);
+    CHECK(t1 == t2);
+    UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+    cache.release(t1);
+    UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+    cache.release(t2);
+    UNSIGNED_LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+TEST(sinc_table_cache, different_keys) {
+    SincTableCache& cache = SincTableCache::instance();
+    const size_t n_tables = cache.num_tables();
+
+    const sample_t* t1 = cache.acquire(8, 16);
+    const sample_t* t2 = cache.acquire(8, 32);
+    const sample_t* t3 = cache.acquire(4, 16);
+
+    CHECK(t1);
+    CHECK(t2);
+    CHECK(t3);
+    CHECK(t1 != t2);
+    CHECK(t1 != t3);
+    CHECK(t2 != t3);
+    UNSIGNED_LONGS_EQUAL(n_tables + 3, cache.num_tables());
+
+    cache.release(t1);
+    cache.release(t2);
+    cache.release(t3);
+    UNSIGNED_LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+TEST(sinc_table_cache, contents) {
+    SincTableCache& cache = SincTableCache::instance();
+
+    enum { WindowSize = 8, WindowInterp = 16, TableSize = WindowSize * WindowInterp + 2 };
+
+    const sample_t* table = cache.acquire(WindowSize, WindowInterp);
+    CHECK(table);
+
+    DOUBLES_EQUAL(1.0, (double)table[0], 0);
+    // zero crossings of sinc at integer arguments
+    for (size_t n = WindowInterp; n < TableSize - 2; n += WindowInterp) {
+        DOUBLES_EQUAL(0.0, (double)table[n], 1e-6);
+    }
+    DOUBLES_EQUAL(0.0, (double)table[TableSize - 2], 0);
+    DOUBLES_EQUAL(0.0, (double)table[TableSize - 1], 0);
+
+    cache.release(table);
+}
+
+TEST(sinc_table_cache, fixed_contents) {
+    SincTableCache& cache = SincTableCache::instance();
+    const size_t n_tables = cache.num_tables();
+
+    enum { WindowSize = 8, WindowInterp = 16, TableSize = WindowSize * WindowInterp + 2 };
+
+    const int32_t* fixed_table = cache.acquire_fixed(WindowSize, WindowInterp);
+    CHECK(fixed_table);
+    UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+    // fixed-point table shares entry with floating-point one
+    const sample_t* table = cache.acquire(WindowSize, WindowInterp);
+    CHECK(table);
+    UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+    CHECK(cache.acquire_fixed(WindowSize, WindowInterp) == fixed_table);
+
+    LONGS_EQUAL(1 << 30, fixed_table[0]);
+    for (size_t n = 0; n < TableSize; n++) {
+        DOUBLES_EQUAL((double)table[n], (double)fixed_table[n] / (1 << 30), 1e-9);
+    }
+
+    cache.release(fixed_table);
+    cache.release(table);
+    UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+    cache.release(fixed_table);
+    UNSIGNED_LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+TEST(sinc_table_cache, shared_by_resamplers) {
+    SincTableCache& cache = SincTableCache::instance();
+    const size_t n_tables = cache.num_tables();
+
+    const SampleSpec in_spec(44100, Sample_RawFormat, ChanLayout_Surround,
+                             ChanOrder_Smpte, ChanMask_Surround_Stereo);
+    const SampleSpec out_spec(48000, Sample_RawFormat, ChanLayout_Surround,
+                              ChanOrder_Smpte, ChanMask_Surround_Stereo);
+
+    {
+        BuiltinResampler r1(arena, frame_factory, ResamplerProfile_Medium, in_spec,
+                            out_spec, BuiltinResamplerArith_Float);
+        CHECK(r1.is_valid());
+        UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+        BuiltinResampler r2(arena, frame_factory, ResamplerProfile_Medium, in_spec,
+                            out_spec, BuiltinResamplerArith_Float);
+        CHECK(r2.is_valid());
+        UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+        BuiltinResampler r2_fixed(arena, frame_factory, ResamplerProfile_Medium,
+                                  in_spec, out_spec, BuiltinResamplerArith_Fixed);
+        CHECK(r2_fixed.is_valid());
+        UNSIGNED_LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+        BuiltinResampler r3(arena, frame_factory, ResamplerProfile_High, in_spec,
+                            out_spec, BuiltinResamplerArith_Float);
+        CHECK(r3.is_valid());
+        UNSIGNED_LONGS_EQUAL(n_tables + 2, cache.num_tables());
+    }
+
+    UNSIGNED_LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/stage_profiler.h"
+#include "roc_audio/stage_profiling_reader.h"
+#include "roc_core/fast_clock.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { NumFrames = 20, SamplesPerFrame = 10 };
+
+const core::nanoseconds_t InnerTime = 5 * core::Millisecond;
+const core::nanoseconds_t OuterTime = 1 * core::Millisecond;
+
+// Spins for given time, then reads from nested reader, if any.
+// Uses same clock as profiler, so that measured time can't be lower.
+class SpinReader : public IFrameReader {
+public:
+    SpinReader(core::nanoseconds_t spin_time, IFrameReader* nested)
+        : spin_time_(spin_time)
+        , nested_(nested) {
+    }
+
+    virtual bool read(Frame& frame) {
+        const core::nanoseconds_t start = core::fast_timestamp();
+        while (core::fast_timestamp() - start < spin_time_) {
+        }
+        if (nested_) {
+            return nested_->read(frame);
+        }
+        return true;
+    }
+
+private:
+    const core::nanoseconds_t spin_time_;
+    IFrameReader* nested_;
+};
+
+void read_frames(IFrameReader& reader) {
+    sample_t samples[SamplesPerFrame] = {};
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        Frame frame(samples, SamplesPerFrame);
+        CHECK(reader.read(frame));
+    }
+}
+
+} // namespace
+
+TEST_GROUP(stage_profiler) {};
+
+TEST(stage_profiler, empty) {
+    StageProfiler profiler;
+
+    const StageProfilerMetrics metrics = profiler.metrics();
+
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        UNSIGNED_LONGS_EQUAL(0, metrics.stages[n].frames);
+        LONGS_EQUAL(0, metrics.stages[n].p50);
+        LONGS_EQUAL(0, metrics.stages[n].max);
+    }
+}
+
+TEST(stage_profiler, single_stage) {
+    StageProfiler profiler;
+
+    SpinReader spin_reader(OuterTime, NULL);
+    StageProfilingReader profiling_reader(spin_reader, profiler, ProfilerStage_Mixer);
+
+    read_frames(profiling_reader);
+
+    const StageProfilerMetrics metrics = profiler.metrics();
+
+    for (size_t n = 0; n < ProfilerStage_Max; n++) {
+        if (n == ProfilerStage_Mixer) {
+            UNSIGNED_LONGS_EQUAL(NumFrames, metrics.stages[n].frames);
+            CHECK(metrics.stages[n].p50 >= OuterTime);
+            CHECK(metrics.stages[n].p50 <= metrics.stages[n].p99);
+            CHECK(metrics.stages[n].p99 <= metrics.stages[n].p999);
+            CHECK(metrics.stages[n].p999 <= metrics.stages[n].max);
+        } else {
+            UNSIGNED_LONGS_EQUAL(0, metrics.stages[n].frames);
+        }
+    }
+}
+
+TEST(stage_profiler, nested_stages) {
+    StageProfiler profiler;
+
+    SpinReader inner_spin_reader(InnerTime, NULL);
+    StageProfilingReader inner_reader(inner_spin_reader, profiler,
+                                      ProfilerStage_Resampler);
+
+    SpinReader outer_spin_reader(OuterTime, &inner_reader);
+    StageProfilingReader outer_reader(outer_spin_reader, profiler, ProfilerStage_Mixer);
+
+    read_frames(outer_reader);
+
+    const StageProfilerMetrics metrics = profiler.metrics();
+
+    const StageMetrics& inner = metrics.stages[ProfilerStage_Resampler];
+    const StageMetrics& outer = metrics.stages[ProfilerStage_Mixer];
+
+    UNSIGNED_LONGS_EQUAL(NumFrames, inner.frames);
+    UNSIGNED_LONGS_EQUAL(NumFrames, outer.frames);
+
+    CHECK(inner.p50 >= InnerTime);
+
+    // time of outer stage should not include time of nested stage
+    CHECK(outer.p50 >= OuterTime);
+    CHECK(outer.p50 < InnerTime);
+}
+
+TEST(stage_profiler, same_stage_twice) {
+    StageProfiler profiler;
+
+    // two readers of same stage nested into one outer frame,
+    // e.g. two sessions read by mixer
+    SpinReader spin_reader1(OuterTime, NULL);
+    StageProfilingReader reader1(spin_reader1, profiler, ProfilerStage_Session);
+
+    SpinReader spin_reader2(OuterTime, NULL);
+    StageProfilingReader reader2(spin_reader2, profiler, ProfilerStage_Session);
+
+    sample_t samples[SamplesPerFrame] = {};
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        profiler.enter();
+
+        Frame frame(samples, SamplesPerFrame);
+        CHECK(reader1.read(frame));
+        CHECK(reader2.read(frame));
+
+        profiler.leave(ProfilerStage_Mixer);
+    }
+
+    const StageProfilerMetrics metrics = profiler.metrics();
+
+    // both reads are accumulated into one frame
+    UNSIGNED_LONGS_EQUAL(NumFrames, metrics.stages[ProfilerStage_Session].frames);
+    CHECK(metrics.stages[ProfilerStage_Session].p50 >= OuterTime * 2);
+
+    UNSIGNED_LONGS_EQUAL(NumFrames, metrics.stages[ProfilerStage_Mixer].frames);
+    CHECK(metrics.stages[ProfilerStage_Mixer].p50 < OuterTime);
+}
+
+TEST(stage_profiler, clear) {
+    StageProfiler profiler;
+
+    SpinReader spin_reader(0, NULL);
+    StageProfilingReader profiling_reader(spin_reader, profiler, ProfilerStage_Mixer);
+
+    read_frames(profiling_reader);
+
+    UNSIGNED_LONGS_EQUAL(NumFrames,
+                         profiler.metrics().stages[ProfilerStage_Mixer].frames);
+
+    profiler.clear();
+
+    UNSIGNED_LONGS_EQUAL(0, profiler.metrics().stages[ProfilerStage_Mixer].frames);
+
+    read_frames(profiling_reader);
+
+    UNSIGNED_LONGS_EQUAL(NumFrames,
+                         profiler.metrics().stages[ProfilerStage_Mixer].frames);
+}
+
+TEST(stage_profiler, collect_times) {
+    StageProfiler profiler;
+
+    SpinReader spin_reader(OuterTime, NULL);
+    StageProfilingReader profiling_reader(spin_reader, profiler, ProfilerStage_Mixer);
+
+    read_frames(profiling_reader);
+
+    core::nanoseconds_t times[ProfilerStage_Max];
+    profiler.collect_times(times);
+
+    // time of all frames is accumulated since last collection
+    CHECK(times[ProfilerStage_Mixer] >= OuterTime * NumFrames);
+    LONGLONGS_EQUAL(0, times[ProfilerStage_Resampler]);
+
+    // collection resets accumulated time
+    profiler.collect_times(times);
+    LONGLONGS_EQUAL(0, times[ProfilerStage_Mixer]);
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/limited_pool.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/memory_limiter.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace roc {
+namespace core {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// Each thread repeatedly allocates a batch of objects and then frees them, using
+// one of the allocators shared by all threads. Every SampleInterval-th batch,
+// each allocate() and deallocate() call is timed individually to build latency
+// distribution.
+//
+// ---------
+// Arguments
+// ---------
+//
+// alloc  -  allocator: HeapArena, SlabPool, SlabPool with thread cache,
+//           LimitedPool wrapping SlabPool and MemoryLimiter
+// size   -  object size: packet, packet buffer, frame buffer
+//
+// --------------
+// Output columns
+// --------------
+//
+// (all time units are nanoseconds, averaged across threads)
+//
+// items_per_second  -  allocate() + deallocate() pairs per second, all threads
+//
+// a_p50, a_p99      -  50% and 99% percentiles of allocate() duration
+// d_p50, d_p99      -  50% and 99% percentiles of deallocate() duration
+
+enum {
+    NumThreads = 8,
+    BatchSize = 32,
+    SampleInterval = 16,
+    MaxSamples = 100000
+};
+
+enum AllocatorType {
+    Alloc_HeapArena,
+    Alloc_SlabPool,
+    Alloc_SlabPoolCache,
+    Alloc_LimitedPool
+};
+
+// typical sizes of packet object, packet buffer (MTU), and frame buffer
+// (10ms of stereo float samples at 48kHz)
+const size_t sizes[] = { 256, 1536, 3840 };
+
+const char* allocator_to_str(AllocatorType type) {
+    switch (type) {
+    case Alloc_HeapArena:
+        return "heap_arena";
+    case Alloc_SlabPool:
+        return "slab_pool";
+    case Alloc_SlabPoolCache:
+        return "slab_pool_cache";
+    case Alloc_LimitedPool:
+        return "limited_pool";
+    }
+    return "<invalid>";
+}
+
+HeapArena arena;
+
+// Allocators for one object size.
+// Shared by all benchmark threads.
+struct Allocators {
+    Allocators(size_t size)
+        : object_size(size)
+        , slab_pool("bench_slab_pool", arena, size)
+        , slab_pool_cache("bench_slab_pool_cache",
+                          arena,
+                          size,
+                          0,
+                          0,
+                          SlabPool_DefaultGuards,
+                          true)
+        , limiter_pool("bench_limiter_pool", arena, size)
+        , limiter("bench_limiter", 0)
+        , limited_pool(limiter_pool, limiter) {
+    }
+
+    void* allocate(AllocatorType type) {
+        switch (type) {
+        case Alloc_HeapArena:
+            return arena.allocate(object_size);
+        case Alloc_SlabPool:
+            return slab_pool.allocate();
+        case Alloc_SlabPoolCache:
+            return slab_pool_cache.allocate();
+        case Alloc_LimitedPool:
+            return limited_pool.allocate();
+        }
+        return NULL;
+    }
+
+    void deallocate(AllocatorType type, void* ptr) {
+        switch (type) {
+        case Alloc_HeapArena:
+            arena.deallocate(ptr);
+            break;
+        case Alloc_SlabPool:
+            slab_pool.deallocate(ptr);
+            break;
+        case Alloc_SlabPoolCache:
+            slab_pool_cache.deallocate(ptr);
+            break;
+        case Alloc_LimitedPool:
+            limited_pool.deallocate(ptr);
+            break;
+        }
+    }
+
+    const size_t object_size;
+
+    SlabPool<uint8_t> slab_pool;
+    SlabPool<uint8_t> slab_pool_cache;
+
+    SlabPool<uint8_t> limiter_pool;
+    MemoryLimiter limiter;
+    LimitedPool limited_pool;
+};
+
+Allocators allocators_small(sizes[0]);
+Allocators allocators_medium(sizes[1]);
+Allocators allocators_large(sizes[2]);
+
+Allocators& get_allocators(size_t size) {
+    if (size == allocators_small.object_size) {
+        return allocators_small;
+    }
+    if (size == allocators_medium.object_size) {
+        return allocators_medium;
+    }
+    return allocators_large;
+}
+
+class Histogram {
+public:
+    Histogram() {
+        samples_.reserve(MaxSamples);
+    }
+
+    void add(nanoseconds_t t) {
+        if (samples_.size() < MaxSamples) {
+            samples_.push_back(t);
+        }
+    }
+
+    void report(benchmark::State& state, const char* p50_name, const char* p99_name) {
+        if (samples_.empty()) {
+            return;
+        }
+
+        std::sort(samples_.begin(), samples_.end());
+
+        state.counters[p50_name] =
+            benchmark::Counter(percentile_(0.50), benchmark::Counter::kAvgThreads);
+        state.counters[p99_name] =
+            benchmark::Counter(percentile_(0.99), benchmark::Counter::kAvgThreads);
+    }
+
+private:
+    double percentile_(double p) const {
+        const size_t n =
+            std::min(samples_.size() - 1, (size_t)(p * (double)samples_.size()));
+        return (double)samples_[n];
+    }
+
+    std::vector<nanoseconds_t> samples_;
+};
+
+void BM_AllocatorContention(benchmark::State& state) {
+    const AllocatorType type = (AllocatorType)state.range(0);
+    Allocators& allocs = get_allocators((size_t)state.range(1));
+
+    void* objects[BatchSize];
+
+    Histogram alloc_hist;
+    Histogram dealloc_hist;
+
+    size_t n_batch = 0;
+
+    while (state.KeepRunningBatch(BatchSize)) {
+        if (n_batch++ % SampleInterval != 0) {
+            for (size_t n = 0; n < BatchSize; n++) {
+                objects[n] = allocs.allocate(type);
+                benchmark::DoNotOptimize(objects[n]);
+            }
+            for (size_t n = 0; n < BatchSize; n++) {
+                allocs.deallocate(type, objects[n]);
+            }
+        } else {
+            for (size_t n = 0; n < BatchSize; n++) {
+                const nanoseconds_t start = timestamp(ClockMonotonic);
+                objects[n] = allocs.allocate(type);
+                alloc_hist.add(timestamp(ClockMonotonic) - start);
+                benchmark::DoNotOptimize(objects[n]);
+            }
+            for (size_t n = 0; n < BatchSize; n++) {
+                const nanoseconds_t start = timestamp(ClockMonotonic);
+                allocs.deallocate(type, objects[n]);
+                dealloc_hist.add(timestamp(ClockMonotonic) - start);
+            }
+        }
+    }
+
+    state.SetLabel(allocator_to_str(type));
+    state.SetItemsProcessed(state.iterations());
+
+    alloc_hist.report(state, "a_p50", "a_p99");
+    dealloc_hist.report(state, "d_p50", "d_p99");
+}
+
+void allocator_args(benchmark::internal::Benchmark* b) {
+    const int types[] = { Alloc_HeapArena, Alloc_SlabPool, Alloc_SlabPoolCache,
+                          Alloc_LimitedPool };
+
+    std::vector<std::string> names;
+    names.push_back("alloc");
+    names.push_back("size");
+    b->ArgNames(names);
+
+    for (size_t n_tp = 0; n_tp < ROC_ARRAY_SIZE(types); n_tp++) {
+        for (size_t n_sz = 0; n_sz < ROC_ARRAY_SIZE(sizes); n_sz++) {
+            std::vector<int64_t> args;
+            args.push_back(types[n_tp]);
+            args.push_back((int64_t)sizes[n_sz]);
+            b->Args(args);
+        }
+    }
+}
+
+BENCHMARK(BM_AllocatorContention)
+    ->Apply(allocator_args)
+    ->ThreadRange(1, NumThreads)
+    ->UseRealTime();
+
+} // namespace
+} // namespace core
+} // namespace roc
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/cpu_instructions.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/hashmap.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/list.h"
+#include "roc_core/ring_queue.h"
+#include "roc_core/spsc_ring_buffer.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+namespace {
+
+enum {
+    MaxElems = 16384,
+
+    // SPSC throughput is measured on fixed number of elements,
+    // which are transferred in batches.
+    SpscBatchSize = 1000,
+    SpscNumElems = 200000
+};
+
+HeapArena arena;
+
+// Element keyed by 32-bit id, like SSRC or route id.
+class Object : public HashmapNode<>, public ListNode<> {
+public:
+    Object()
+        : key_(0) {
+    }
+
+    void set_key(uint32_t key) {
+        key_ = key;
+    }
+
+    uint32_t key() const {
+        return key_;
+    }
+
+    static hashsum_t key_hash(uint32_t key) {
+        return hashsum_int(key);
+    }
+
+    static bool key_equal(uint32_t key1, uint32_t key2) {
+        return key1 == key2;
+    }
+
+private:
+    uint32_t key_;
+};
+
+// Element of per-frame queues, roughly the size of frame or packet descriptor.
+struct Message {
+    uint64_t timestamp;
+    uint64_t position;
+    uint32_t flags;
+    uint32_t size;
+};
+
+Object objects[MaxElems];
+
+void init_objects(size_t n_elems) {
+    for (size_t n = 0; n < n_elems; n++) {
+        objects[n].set_key(fast_random());
+    }
+}
+
+// Lookup of existing keys, without rehashing.
+void BM_Hashmap_Find(benchmark::State& state) {
+    const size_t n_elems = (size_t)state.range(0);
+
+    init_objects(n_elems);
+
+    Hashmap<Object, 0, NoOwnership> hashmap(arena);
+    if (!hashmap.reserve(n_elems)) {
+        state.SkipWithError("can't reserve hashmap");
+        return;
+    }
+
+    for (size_t n = 0; n < n_elems; n++) {
+        if (!hashmap.insert(objects[n])) {
+            state.SkipWithError("can't insert to hashmap");
+            return;
+        }
+    }
+
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(hashmap.find(objects[n].key()));
+        if (++n == n_elems) {
+            n = 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Hashmap_Find)->RangeMultiplier(8)->Range(8, MaxElems);
+
+// Inserts into growing hashmap, interleaved with lookups of present keys.
+// Every growth starts incremental rehashing, so lookups and inserts
+// mostly happen while rehashing is in progress.
+void BM_Hashmap_InsertFind_Rehash(benchmark::State& state) {
+    const size_t n_elems = (size_t)state.range(0);
+
+    init_objects(n_elems);
+
+    size_t n_rehash_steps = 0;
+
+    while (state.KeepRunningBatch((int64_t)n_elems)) {
+        Hashmap<Object, 0, NoOwnership> hashmap(arena);
+
+        for (size_t n = 0; n < n_elems; n++) {
+            if (!hashmap.insert(objects[n])) {
+                state.SkipWithError("can't insert to hashmap");
+                return;
+            }
+            benchmark::DoNotOptimize(
+                hashmap.find(objects[fast_random_range(0, (uint32_t)n)].key()));
+        }
+
+        n_rehash_steps += hashmap.num_rehash_steps();
+
+        while (Hashmap<Object, 0, NoOwnership>::Pointer obj = hashmap.back()) {
+            hashmap.remove(*obj);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["rehash_steps"] =
+        benchmark::Counter((double)n_rehash_steps, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_Hashmap_InsertFind_Rehash)->RangeMultiplier(8)->Range(8, MaxElems);
+
+// FIFO churn, like list of pending packets or sessions.
+void BM_List_PushPop(benchmark::State& state) {
+    const size_t depth = (size_t)state.range(0);
+
+    List<Object, NoOwnership> list;
+
+    for (size_t n = 0; n < depth; n++) {
+        list.push_back(objects[n]);
+    }
+
+    while (state.KeepRunning()) {
+        Object* obj = list.front();
+        list.pop_front();
+        list.push_back(*obj);
+    }
+
+    while (!list.is_empty()) {
+        list.pop_back();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_List_PushPop)->RangeMultiplier(8)->Range(8, MaxElems);
+
+// FIFO churn of copyable elements.
+void BM_RingQueue_PushPop(benchmark::State& state) {
+    const size_t depth = (size_t)state.range(0);
+
+    RingQueue<Message> queue(arena, depth + 1);
+    if (!queue.is_valid()) {
+        state.SkipWithError("can't allocate queue");
+        return;
+    }
+
+    Message msg = {};
+
+    for (size_t n = 0; n < depth; n++) {
+        queue.push_back(msg);
+    }
+
+    while (state.KeepRunning()) {
+        msg = queue.front();
+        queue.pop_front();
+        msg.position++;
+        queue.push_back(msg);
+    }
+
+    benchmark::DoNotOptimize(msg);
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RingQueue_PushPop)->RangeMultiplier(8)->Range(8, MaxElems);
+
+class SpscProducer : public Thread {
+public:
+    SpscProducer(SpscRingBuffer<Message>& buffer)
+        : buffer_(buffer)
+        , n_full_(0) {
+    }
+
+    size_t num_full() const {
+        return n_full_;
+    }
+
+private:
+    virtual void run() {
+        Message msg = {};
+
+        for (size_t n = 0; n < SpscNumElems; n++) {
+            msg.position = n;
+            while (!buffer_.push_back(msg)) {
+                n_full_++;
+                cpu_relax();
+            }
+        }
+    }
+
+    SpscRingBuffer<Message>& buffer_;
+    size_t n_full_;
+};
+
+// Throughput between two threads, which are normally scheduled on
+// different cores. Benchmark thread is consumer.
+void BM_SpscRingBuffer_Throughput(benchmark::State& state) {
+    const size_t capacity = (size_t)state.range(0);
+
+    SpscRingBuffer<Message> buffer(arena, capacity);
+    if (!buffer.is_valid()) {
+        state.SkipWithError("can't allocate buffer");
+        return;
+    }
+
+    SpscProducer producer(buffer);
+    if (!producer.start()) {
+        state.SkipWithError("can't start thread");
+        return;
+    }
+
+    Message msg;
+    size_t n_empty = 0;
+
+    while (state.KeepRunningBatch(SpscBatchSize)) {
+        for (size_t n = 0; n < SpscBatchSize; n++) {
+            while (!buffer.pop_front(msg)) {
+                n_empty++;
+                cpu_relax();
+            }
+        }
+    }
+
+    producer.join();
+
+    benchmark::DoNotOptimize(msg);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["full_spins"] = benchmark::Counter(
+        (double)producer.num_full(), benchmark::Counter::kAvgIterations);
+    state.counters["empty_spins"] =
+        benchmark::Counter((double)n_empty, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_SpscRingBuffer_Throughput)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096)
+    ->Iterations(SpscNumElems)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace core
+} // namespace roc
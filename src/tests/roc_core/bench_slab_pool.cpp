@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+
+namespace roc {
+namespace core {
+namespace {
+
+enum { NumObjects = 16 };
+
+struct Object {
+    char bytes[256];
+};
+
+HeapArena arena;
+
+SlabPool<Object> pool_no_cache("bench_no_cache", arena);
+
+SlabPool<Object> pool_cache(
+    "bench_cache", arena, sizeof(Object), 0, 0, SlabPool_DefaultGuards, true);
+
+void bench_pool(benchmark::State& state, IPool& pool) {
+    void* objects[NumObjects];
+
+    while (state.KeepRunning()) {
+        for (size_t n = 0; n < NumObjects; n++) {
+            objects[n] = pool.allocate();
+            benchmark::DoNotOptimize(objects[n]);
+        }
+        for (size_t n = 0; n < NumObjects; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * NumObjects);
+}
+
+void BM_SlabPool_NoCache(benchmark::State& state) {
+    bench_pool(state, pool_no_cache);
+}
+
+BENCHMARK(BM_SlabPool_NoCache)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_SlabPool_ThreadCache(benchmark::State& state) {
+    bench_pool(state, pool_cache);
+}
+
+BENCHMARK(BM_SlabPool_ThreadCache)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+} // namespace core
+} // namespace roc
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/async_log_queue.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { MaxMessages = 4000 };
+
+struct TestSink {
+    Mutex mutex;
+    size_t n_messages;
+    size_t n_drop_reports;
+    int last_seq[16];
+    bool in_order;
+
+    TestSink()
+        : n_messages(0)
+        , n_drop_reports(0)
+        , in_order(true) {
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(last_seq); n++) {
+            last_seq[n] = -1;
+        }
+    }
+
+    static void handle(const LogMessage& msg, void* arg) {
+        TestSink& sink = *(TestSink*)arg;
+
+        Mutex::Lock lock(sink.mutex);
+
+        if (strstr(msg.text, "dropped")) {
+            sink.n_drop_reports++;
+            return;
+        }
+
+        int id = 0, seq = 0;
+        CHECK(sscanf(msg.text, "%d:%d", &id, &seq) == 2);
+        CHECK(id >= 0 && id < (int)ROC_ARRAY_SIZE(sink.last_seq));
+
+        if (seq <= sink.last_seq[id]) {
+            sink.in_order = false;
+        }
+        sink.last_seq[id] = seq;
+        sink.n_messages++;
+    }
+};
+
+bool push(AsyncLogQueue& queue, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const bool ok = queue.push(LogInfo, "test", __FILE__, __LINE__, format, args);
+    va_end(args);
+    return ok;
+}
+
+struct TestPushThread : public Thread {
+    TestPushThread(AsyncLogQueue& queue, int id, int n_messages)
+        : queue(queue)
+        , id(id)
+        , n_messages(n_messages)
+        , n_pushed(0) {
+    }
+
+    AsyncLogQueue& queue;
+    int id;
+    int n_messages;
+    int n_pushed;
+
+    virtual void run() {
+        for (int seq = 0; seq < n_messages; seq++) {
+            if (push(queue, "%d:%d", id, seq)) {
+                n_pushed++;
+            }
+        }
+    }
+};
+
+size_t n_logger_messages = 0;
+
+void count_logger_messages(const LogMessage&, void**) {
+    n_logger_messages++;
+}
+
+} // namespace
+
+TEST_GROUP(async_log_queue) {};
+
+TEST(async_log_queue, push_and_flush) {
+    HeapArena arena;
+    TestSink sink;
+
+    AsyncLogQueue queue(arena, &TestSink::handle, &sink);
+    CHECK(queue.is_valid());
+    CHECK(queue.start());
+
+    for (int seq = 0; seq < 100; seq++) {
+        CHECK(push(queue, "%d:%d", 0, seq));
+    }
+
+    queue.stop();
+
+    UNSIGNED_LONGS_EQUAL(100, sink.n_messages);
+    UNSIGNED_LONGS_EQUAL(0, sink.n_drop_reports);
+    UNSIGNED_LONGS_EQUAL(0, queue.num_dropped());
+    CHECK(sink.in_order);
+}
+
+TEST(async_log_queue, overflow) {
+    HeapArena arena;
+    TestSink sink;
+
+    AsyncLogQueue queue(arena, &TestSink::handle, &sink);
+    CHECK(queue.is_valid());
+
+    // Background thread is not running yet, so rings become full.
+    size_t n_pushed = 0;
+    for (int seq = 0; seq < MaxMessages; seq++) {
+        if (push(queue, "%d:%d", 0, seq)) {
+            n_pushed++;
+        }
+    }
+
+    CHECK(n_pushed > 0);
+    CHECK(n_pushed < MaxMessages);
+    UNSIGNED_LONGS_EQUAL(MaxMessages - n_pushed, queue.num_dropped());
+
+    CHECK(queue.start());
+    queue.stop();
+
+    UNSIGNED_LONGS_EQUAL(n_pushed, sink.n_messages);
+    UNSIGNED_LONGS_EQUAL(1, sink.n_drop_reports);
+}
+
+TEST(async_log_queue, many_threads) {
+    enum { NumThreads = 8, NumMessages = 500 };
+
+    HeapArena arena;
+    TestSink sink;
+
+    AsyncLogQueue queue(arena, &TestSink::handle, &sink);
+    CHECK(queue.is_valid());
+    CHECK(queue.start());
+
+    TestPushThread* threads[NumThreads];
+
+    for (int n = 0; n < NumThreads; n++) {
+        threads[n] = new TestPushThread(queue, n, NumMessages);
+        CHECK(threads[n]->start());
+    }
+
+    size_t n_pushed = 0;
+    for (int n = 0; n < NumThreads; n++) {
+        threads[n]->join();
+        n_pushed += (size_t)threads[n]->n_pushed;
+        delete threads[n];
+    }
+
+    queue.stop();
+
+    // Messages of each thread are delivered in order, without losses
+    // except reported drops.
+    UNSIGNED_LONGS_EQUAL(n_pushed, sink.n_messages);
+    UNSIGNED_LONGS_EQUAL(NumThreads * NumMessages - n_pushed, queue.num_dropped());
+    CHECK(sink.in_order);
+}
+
+TEST(async_log_queue, logger) {
+    Logger& logger = Logger::instance();
+
+    const LogLevel level = logger.get_level();
+
+    logger.set_level(LogInfo);
+    logger.set_handler(&count_logger_messages, NULL, 0);
+
+    n_logger_messages = 0;
+
+    CHECK(logger.set_async(true));
+
+    for (int n = 0; n < 50; n++) {
+        roc_log(LogInfo, "test message %d", n);
+    }
+    roc_log(LogDebug, "filtered message");
+
+    // Disabling asynchronous mode flushes queued messages.
+    CHECK(logger.set_async(false));
+
+    UNSIGNED_LONGS_EQUAL(50, n_logger_messages);
+
+    // Synchronous mode.
+    roc_log(LogInfo, "test message");
+    UNSIGNED_LONGS_EQUAL(51, n_logger_messages);
+
+    logger.set_handler(NULL, NULL, 0);
+    logger.set_level(level);
+}
+
+} // namespace core
+} // namespace roc
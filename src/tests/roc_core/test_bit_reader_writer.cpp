@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/bit_reader.h"
+#include "roc_core/bit_writer.h"
+#include "roc_core/macro_helpers.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(bit_reader_writer) {};
+
+TEST(bit_reader_writer, fields) {
+    uint8_t data[16] = {};
+
+    BitWriter writer(data, sizeof(data));
+    writer.write(0x5, 3);
+    writer.write(0xABCDE, 20);
+    writer.write(0xFFFFFFFF, 32);
+    writer.write(0x0, 1);
+    writer.flush();
+
+    CHECK(!writer.is_overflow());
+    UNSIGNED_LONGS_EQUAL(7, writer.byte_count());
+
+    BitReader reader(data, writer.byte_count());
+    UNSIGNED_LONGS_EQUAL(0x5, reader.read(3));
+    UNSIGNED_LONGS_EQUAL(0xABCDE, reader.read(20));
+    UNSIGNED_LONGS_EQUAL(0xFFFFFFFF, reader.read(32));
+    UNSIGNED_LONGS_EQUAL(0x0, reader.read(1));
+
+    CHECK(!reader.is_overflow());
+}
+
+TEST(bit_reader_writer, signed_fields) {
+    uint8_t data[16] = {};
+
+    BitWriter writer(data, sizeof(data));
+    writer.write((uint32_t)-5, 4);
+    writer.write((uint32_t)7, 4);
+    writer.write((uint32_t)-8388608, 24);
+    writer.flush();
+
+    BitReader reader(data, writer.byte_count());
+    LONGS_EQUAL(-5, reader.read_signed(4));
+    LONGS_EQUAL(7, reader.read_signed(4));
+    LONGS_EQUAL(-8388608, reader.read_signed(24));
+}
+
+TEST(bit_reader_writer, unary) {
+    const uint32_t values[] = { 0, 1, 7, 8, 31, 32, 33, 100 };
+
+    uint8_t data[64] = {};
+
+    BitWriter writer(data, sizeof(data));
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(values); n++) {
+        writer.write_unary(values[n]);
+        writer.write(n, 3);
+    }
+    writer.flush();
+
+    CHECK(!writer.is_overflow());
+
+    BitReader reader(data, writer.byte_count());
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(values); n++) {
+        UNSIGNED_LONGS_EQUAL(values[n], reader.read_unary());
+        UNSIGNED_LONGS_EQUAL(n, reader.read(3));
+    }
+
+    CHECK(!reader.is_overflow());
+}
+
+TEST(bit_reader_writer, overflow) {
+    uint8_t data[2] = {};
+
+    BitWriter writer(data, sizeof(data));
+    writer.write(0xFFFFFF, 24);
+    writer.flush();
+
+    CHECK(writer.is_overflow());
+    UNSIGNED_LONGS_EQUAL(0xFF, data[0]);
+    UNSIGNED_LONGS_EQUAL(0xFF, data[1]);
+
+    BitReader reader(data, sizeof(data));
+    UNSIGNED_LONGS_EQUAL(0xFFFF00, reader.read(24));
+
+    CHECK(reader.is_overflow());
+}
+
+} // namespace core
+} // namespace roc
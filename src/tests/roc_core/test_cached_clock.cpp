@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/cached_clock.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+class TestThread : public Thread {
+public:
+    TestThread()
+        : ts_(0) {
+    }
+
+    nanoseconds_t ts() const {
+        return ts_;
+    }
+
+private:
+    virtual void run() {
+        ts_ = CachedClock::now(ClockUnix);
+    }
+
+    nanoseconds_t ts_;
+};
+
+} // namespace
+
+TEST_GROUP(cached_clock) {};
+
+TEST(cached_clock, no_scope) {
+    const nanoseconds_t ts = CachedClock::now(ClockUnix);
+
+    while (ts == CachedClock::now(ClockUnix)) {
+        // wait until clock changes
+    }
+}
+
+TEST(cached_clock, scope) {
+    nanoseconds_t unix_ts = 0, mono_ts = 0;
+
+    {
+        CachedClock::Scope scope;
+
+        unix_ts = CachedClock::now(ClockUnix);
+        mono_ts = CachedClock::now(ClockMonotonic);
+
+        sleep_for(ClockMonotonic, Millisecond);
+
+        LONGS_EQUAL(unix_ts, CachedClock::now(ClockUnix));
+        LONGS_EQUAL(mono_ts, CachedClock::now(ClockMonotonic));
+    }
+
+    CHECK(CachedClock::now(ClockUnix) >= unix_ts + Millisecond);
+}
+
+TEST(cached_clock, nested_scopes) {
+    CachedClock::Scope outer_scope;
+    const nanoseconds_t outer_ts = CachedClock::now(ClockUnix);
+
+    sleep_for(ClockMonotonic, Millisecond);
+
+    {
+        CachedClock::Scope inner_scope;
+        CHECK(CachedClock::now(ClockUnix) >= outer_ts + Millisecond);
+    }
+
+    LONGS_EQUAL(outer_ts, CachedClock::now(ClockUnix));
+}
+
+TEST(cached_clock, other_thread) {
+    CachedClock::Scope scope;
+    const nanoseconds_t ts = CachedClock::now(ClockUnix);
+
+    sleep_for(ClockMonotonic, Millisecond);
+
+    TestThread thr;
+    CHECK(thr.start());
+    thr.join();
+
+    CHECK(thr.ts() >= ts + Millisecond);
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/cpu_meter.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(cpu_meter) {};
+
+TEST(cpu_meter, empty) {
+    CpuMeter meter;
+
+    LONGS_EQUAL(0, meter.total_cpu_ns());
+    LONGS_EQUAL(0, meter.cpu_ns_per_sec());
+}
+
+TEST(cpu_meter, rate) {
+    CpuMeter meter(Second);
+
+    nanoseconds_t now = Second;
+
+    // 1ms of every 10ms during first window
+    for (int n = 0; n < 100; n++) {
+        LONGS_EQUAL(0, meter.cpu_ns_per_sec());
+
+        meter.begin(now);
+        now += Millisecond;
+        meter.end(now);
+        now += 9 * Millisecond;
+    }
+
+    LONGS_EQUAL(100 * Millisecond, meter.total_cpu_ns());
+
+    meter.begin(now);
+    meter.end(now);
+
+    LONGS_EQUAL(100 * Millisecond, meter.cpu_ns_per_sec());
+
+    // 2ms of every 10ms during second window
+    for (int n = 0; n < 100; n++) {
+        LONGS_EQUAL(100 * Millisecond, meter.cpu_ns_per_sec());
+
+        meter.begin(now);
+        now += 2 * Millisecond;
+        meter.end(now);
+        now += 8 * Millisecond;
+    }
+
+    meter.begin(now);
+    meter.end(now);
+
+    LONGS_EQUAL(200 * Millisecond, meter.cpu_ns_per_sec());
+    LONGS_EQUAL(300 * Millisecond, meter.total_cpu_ns());
+}
+
+TEST(cpu_meter, long_region) {
+    CpuMeter meter(Second);
+
+    meter.begin(Second);
+    meter.end(3 * Second);
+
+    LONGS_EQUAL(Second, meter.cpu_ns_per_sec());
+    LONGS_EQUAL(2 * Second, meter.total_cpu_ns());
+}
+
+} // namespace core
+} // namespace roc
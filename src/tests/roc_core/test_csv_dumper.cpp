@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/csv_dumper.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/temp_file.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+HeapArena arena;
+
+CsvEntry make_entry(char type, double value) {
+    CsvEntry entry;
+    entry.type = type;
+    entry.n_fields = 1;
+    entry.fields[0] = value;
+    return entry;
+}
+
+size_t count_lines(const char* path, char type) {
+    FILE* fp = fopen(path, "r");
+    CHECK(fp);
+
+    size_t n_lines = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == type) {
+            n_lines++;
+        }
+    }
+
+    fclose(fp);
+    return n_lines;
+}
+
+} // namespace
+
+TEST_GROUP(csv_dumper) {};
+
+TEST(csv_dumper, write) {
+    TempFile file("test.csv");
+
+    CsvConfig config;
+    config.max_interval = 0;
+
+    CsvDumper dumper(file.path(), config, arena);
+    CHECK(dumper.is_valid());
+    CHECK(dumper.start());
+
+    for (int n = 0; n < 100; n++) {
+        dumper.write(make_entry('a', n));
+    }
+
+    dumper.stop();
+    dumper.join();
+
+    UNSIGNED_LONGS_EQUAL(100, count_lines(file.path(), 'a'));
+    UNSIGNED_LONGS_EQUAL(0, dumper.num_dropped());
+}
+
+TEST(csv_dumper, queue_full) {
+    TempFile file("test.csv");
+
+    CsvConfig config;
+    config.max_queued = 10;
+    config.max_interval = 0;
+
+    CsvDumper dumper(file.path(), config, arena);
+    CHECK(dumper.is_valid());
+
+    // Background thread is not running yet, so queue becomes full.
+    for (int n = 0; n < 15; n++) {
+        dumper.write(make_entry('a', n));
+    }
+
+    UNSIGNED_LONGS_EQUAL(5, dumper.num_dropped());
+
+    CHECK(dumper.start());
+    dumper.stop();
+    dumper.join();
+
+    UNSIGNED_LONGS_EQUAL(10, count_lines(file.path(), 'a'));
+}
+
+TEST(csv_dumper, rate_limits) {
+    TempFile file("test.csv");
+
+    CsvConfig config;
+    config.max_interval = Second * 100;
+    CHECK(config.set_rate_limit('b', 0));
+
+    LONGS_EQUAL(Second * 100, config.rate_limit('a'));
+    LONGS_EQUAL(0, config.rate_limit('b'));
+
+    CsvDumper dumper(file.path(), config, arena);
+    CHECK(dumper.is_valid());
+    CHECK(dumper.start());
+
+    for (int n = 0; n < 10; n++) {
+        dumper.write(make_entry('a', n));
+        dumper.write(make_entry('b', n));
+    }
+
+    CHECK(!dumper.would_write('a'));
+    CHECK(dumper.would_write('b'));
+
+    dumper.stop();
+    dumper.join();
+
+    // Only first entry of type 'a' passed default rate limit.
+    UNSIGNED_LONGS_EQUAL(1, count_lines(file.path(), 'a'));
+    UNSIGNED_LONGS_EQUAL(10, count_lines(file.path(), 'b'));
+    UNSIGNED_LONGS_EQUAL(0, dumper.num_dropped());
+}
+
+TEST(csv_dumper, too_many_rate_limits) {
+    CsvConfig config;
+
+    for (size_t n = 0; n < Csv_MaxRateLimits; n++) {
+        CHECK(config.set_rate_limit((char)('a' + n), Millisecond));
+    }
+
+    // Overriding existing type is still possible.
+    CHECK(config.set_rate_limit('a', Second));
+    LONGS_EQUAL(Second, config.rate_limit('a'));
+
+    CHECK(!config.set_rate_limit('z', Second));
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/cpu_features.h"
+#include "roc_core/fast_clock.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// Generous bound, tests may be preempted.
+const nanoseconds_t MaxError = 50 * Millisecond;
+
+} // namespace
+
+TEST_GROUP(fast_clock) {};
+
+TEST(fast_clock, calibration) {
+    FastClock clock;
+
+    CHECK_EQUAL(cpu_supports(CpuFeature_CycleCounter), clock.is_calibrated());
+}
+
+TEST(fast_clock, disabled) {
+    FastClock clock(100 * Millisecond, false);
+
+    CHECK(!clock.is_calibrated());
+
+    const nanoseconds_t before = timestamp(ClockMonotonic);
+    const nanoseconds_t ts = clock.now();
+    const nanoseconds_t after = timestamp(ClockMonotonic);
+
+    CHECK(ts >= before);
+    CHECK(ts <= after);
+}
+
+TEST(fast_clock, follows_system_clock) {
+    FastClock clock;
+
+    for (int n = 0; n < 20; n++) {
+        const nanoseconds_t before = timestamp(ClockMonotonic);
+        const nanoseconds_t ts = clock.now();
+        const nanoseconds_t after = timestamp(ClockMonotonic);
+
+        CHECK(ts >= before - MaxError);
+        CHECK(ts <= after + MaxError);
+
+        sleep_for(ClockMonotonic, Millisecond);
+    }
+}
+
+TEST(fast_clock, monotonic) {
+    FastClock clock(Millisecond);
+
+    nanoseconds_t prev = clock.now();
+
+    const nanoseconds_t deadline = timestamp(ClockMonotonic) + 20 * Millisecond;
+    while (timestamp(ClockMonotonic) < deadline) {
+        const nanoseconds_t ts = clock.now();
+        CHECK(ts >= prev);
+        prev = ts;
+    }
+}
+
+TEST(fast_clock, resync) {
+    FastClock clock(Millisecond);
+
+    if (!clock.is_calibrated()) {
+        return;
+    }
+
+    LONGS_EQUAL(0, clock.num_resyncs());
+
+    for (int n = 0; n < 5; n++) {
+        sleep_for(ClockMonotonic, 2 * Millisecond);
+
+        const nanoseconds_t ts = clock.now();
+        const nanoseconds_t sys_ts = timestamp(ClockMonotonic);
+
+        LONGS_EQUAL(n + 1, clock.num_resyncs());
+        CHECK(ts <= sys_ts + MaxError);
+        CHECK(ts >= sys_ts - MaxError);
+    }
+}
+
+TEST(fast_clock, fast_timestamp) {
+    const nanoseconds_t ts1 = fast_timestamp();
+    sleep_for(ClockMonotonic, Millisecond);
+    const nanoseconds_t ts2 = fast_timestamp();
+
+    CHECK(ts2 - ts1 >= Millisecond / 2);
+}
+
+} // namespace core
+} // namespace roc
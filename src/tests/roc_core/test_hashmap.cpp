@@ -275,6 +275,123 @@ TEST(hashmap, grow_slowly) {
     }
 }
 
+TEST(hashmap, reserve) {
+    enum { NumElements = 1000 };
+
+    Hashmap<Object> hashmap(arena);
+
+    CHECK(hashmap.reserve(NumElements));
+    CHECK(hashmap.capacity() >= NumElements);
+
+    UNSIGNED_LONGS_EQUAL(1, arena.num_allocations());
+
+    for (size_t n = 0; n < NumElements; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        SharedPtr<Object> obj = new Object(key);
+        CHECK(hashmap.insert(*obj));
+    }
+
+    // No reallocations and no rehashing after reserve.
+    UNSIGNED_LONGS_EQUAL(1, arena.num_allocations());
+    UNSIGNED_LONGS_EQUAL(0, hashmap.num_rehashes());
+    UNSIGNED_LONGS_EQUAL(0, hashmap.num_rehash_steps());
+
+    // Reserving less than capacity is no-op.
+    const size_t cap = hashmap.capacity();
+    CHECK(hashmap.reserve(NumElements / 2));
+    UNSIGNED_LONGS_EQUAL(cap, hashmap.capacity());
+    UNSIGNED_LONGS_EQUAL(1, arena.num_allocations());
+}
+
+TEST(hashmap, reserve_non_empty) {
+    enum { NumElements = 200, NumReserved = 1000 };
+
+    Hashmap<Object> hashmap(arena);
+
+    for (size_t n = 0; n < NumElements; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        SharedPtr<Object> obj = new Object(key);
+        if (hashmap.size() == hashmap.capacity()) {
+            CHECK(hashmap.grow());
+        }
+        CHECK(hashmap.insert(*obj));
+    }
+
+    const size_t num_rehashes = hashmap.num_rehashes();
+    CHECK(num_rehashes > 0);
+
+    CHECK(hashmap.reserve(NumReserved));
+    CHECK(hashmap.capacity() >= NumReserved);
+
+    // Reserve completes rehashing immediately.
+    UNSIGNED_LONGS_EQUAL(num_rehashes + 1, hashmap.num_rehashes());
+
+    const size_t num_steps = hashmap.num_rehash_steps();
+
+    for (size_t n = NumElements; n < NumReserved; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        SharedPtr<Object> obj = new Object(key);
+        CHECK(hashmap.insert(*obj));
+    }
+
+    UNSIGNED_LONGS_EQUAL(num_rehashes + 1, hashmap.num_rehashes());
+    UNSIGNED_LONGS_EQUAL(num_steps, hashmap.num_rehash_steps());
+
+    for (size_t n = 0; n < NumReserved; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        SharedPtr<Object> obj = hashmap.find(key);
+        CHECK(obj);
+        STRCMP_EQUAL(key, obj->key());
+    }
+}
+
+TEST(hashmap, probe_stats) {
+    enum { NumElements = 100 };
+
+    Hashmap<Object> hashmap(arena);
+
+    UNSIGNED_LONGS_EQUAL(0, hashmap.num_lookups());
+    UNSIGNED_LONGS_EQUAL(0, hashmap.num_probes());
+    UNSIGNED_LONGS_EQUAL(0, hashmap.max_probe_length());
+
+    CHECK(hashmap.reserve(NumElements));
+
+    for (size_t n = 0; n < NumElements; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        SharedPtr<Object> obj = new Object(key);
+        CHECK(hashmap.insert(*obj));
+    }
+
+    // Each insert looks up for duplicate key.
+    UNSIGNED_LONGS_EQUAL(NumElements, hashmap.num_lookups());
+
+    const size_t num_probes = hashmap.num_probes();
+
+    for (size_t n = 0; n < NumElements; n++) {
+        char key[64];
+        format_key(key, sizeof(key), n);
+
+        CHECK(hashmap.find(key));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumElements * 2, hashmap.num_lookups());
+
+    // Every successful lookup visits at least one element.
+    CHECK(hashmap.num_probes() >= num_probes + NumElements);
+    CHECK(hashmap.max_probe_length() >= 1);
+    CHECK(hashmap.max_probe_length() <= NumElements);
+}
+
 TEST(hashmap, refcounting) {
     SharedPtr<Object> obj1 = new Object("foo");
     SharedPtr<Object> obj2 = new Object("bar");
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/hdr_histogram.h"
+#include "roc_core/macro_helpers.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(hdr_histogram) {};
+
+TEST(hdr_histogram, empty) {
+    HdrHistogram hist;
+
+    UNSIGNED_LONGS_EQUAL(0, hist.count());
+
+    UNSIGNED_LONGS_EQUAL(0, hist.quantile(0.0));
+    UNSIGNED_LONGS_EQUAL(0, hist.quantile(0.5));
+    UNSIGNED_LONGS_EQUAL(0, hist.quantile(1.0));
+}
+
+TEST(hdr_histogram, small_values) {
+    HdrHistogram hist;
+
+    for (uint64_t v = 0; v < HdrHistogram::SubBuckets; v++) {
+        hist.add(v);
+    }
+
+    UNSIGNED_LONGS_EQUAL(HdrHistogram::SubBuckets, hist.count());
+
+    UNSIGNED_LONGS_EQUAL(0, hist.quantile(0.0));
+    UNSIGNED_LONGS_EQUAL(HdrHistogram::SubBuckets / 2 - 1, hist.quantile(0.5));
+    UNSIGNED_LONGS_EQUAL(HdrHistogram::SubBuckets - 1, hist.quantile(1.0));
+}
+
+TEST(hdr_histogram, quantiles) {
+    HdrHistogram hist;
+
+    // 900 small, 90 medium, 9 large, 1 huge
+    for (size_t n = 0; n < 900; n++) {
+        hist.add(10);
+    }
+    for (size_t n = 0; n < 90; n++) {
+        hist.add(1000);
+    }
+    for (size_t n = 0; n < 9; n++) {
+        hist.add(100000);
+    }
+    hist.add(10000000);
+
+    const double quantiles[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+    uint64_t values[ROC_ARRAY_SIZE(quantiles)];
+
+    UNSIGNED_LONGS_EQUAL(1000, hist.quantiles(quantiles, values, ROC_ARRAY_SIZE(values)));
+
+    UNSIGNED_LONGS_EQUAL(10, values[0]);
+    UNSIGNED_LONGS_EQUAL(10, values[1]);
+
+    CHECK(values[2] >= 1000 && values[2] <= 1000 + 1000 / HdrHistogram::SubBuckets);
+    CHECK(values[3] >= 100000
+          && values[3] <= 100000 + 100000 / HdrHistogram::SubBuckets);
+    CHECK(values[4] >= 10000000
+          && values[4] <= 10000000 + 10000000 / HdrHistogram::SubBuckets);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(values); n++) {
+        UNSIGNED_LONGS_EQUAL(values[n], hist.quantile(quantiles[n]));
+    }
+}
+
+TEST(hdr_histogram, relative_error) {
+    for (uint64_t v = 1; v < HdrHistogram::MaxValue / 3; v = v * 3 + 1) {
+        HdrHistogram hist;
+        hist.add(v);
+
+        const uint64_t reported = hist.quantile(0.5);
+
+        CHECK(reported >= v);
+        CHECK(reported - v <= v / HdrHistogram::SubBuckets);
+    }
+}
+
+TEST(hdr_histogram, clamping) {
+    HdrHistogram hist;
+
+    hist.add(HdrHistogram::MaxValue);
+    hist.add(HdrHistogram::MaxValue + 1);
+    hist.add((uint64_t)-1);
+
+    UNSIGNED_LONGS_EQUAL(3, hist.count());
+    UNSIGNED_LONGS_EQUAL(HdrHistogram::MaxValue, hist.quantile(0.0));
+    UNSIGNED_LONGS_EQUAL(HdrHistogram::MaxValue, hist.quantile(1.0));
+}
+
+TEST(hdr_histogram, clear) {
+    HdrHistogram hist;
+
+    for (size_t n = 0; n < 100; n++) {
+        hist.add(n * 100);
+    }
+
+    UNSIGNED_LONGS_EQUAL(100, hist.count());
+    CHECK(hist.quantile(1.0) > 0);
+
+    hist.clear();
+
+    UNSIGNED_LONGS_EQUAL(0, hist.count());
+    UNSIGNED_LONGS_EQUAL(0, hist.quantile(1.0));
+
+    hist.add(5);
+
+    UNSIGNED_LONGS_EQUAL(1, hist.count());
+    UNSIGNED_LONGS_EQUAL(5, hist.quantile(1.0));
+}
+
+TEST(hdr_histogram, merge) {
+    HdrHistogram hist1;
+    HdrHistogram hist2;
+
+    for (size_t n = 0; n < 10; n++) {
+        hist1.add(1);
+        hist2.add(10);
+    }
+    hist2.add(10);
+
+    hist1.merge(hist2);
+
+    UNSIGNED_LONGS_EQUAL(21, hist1.count());
+    UNSIGNED_LONGS_EQUAL(11, hist2.count());
+
+    UNSIGNED_LONGS_EQUAL(1, hist1.quantile(0.0));
+    UNSIGNED_LONGS_EQUAL(10, hist1.quantile(0.5));
+    UNSIGNED_LONGS_EQUAL(10, hist1.quantile(1.0));
+}
+
+} // namespace core
+} // namespace roc
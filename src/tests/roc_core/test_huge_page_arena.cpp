@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/huge_page_arena.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(huge_page_arena) {};
+
+TEST(huge_page_arena, passthrough) {
+    HeapArena heap_arena;
+
+    {
+        HugePageArena arena(heap_arena, 0);
+        CHECK(arena.is_valid());
+        UNSIGNED_LONGS_EQUAL(0, arena.reserved_size());
+
+        void* pointer = arena.allocate(100);
+        CHECK(pointer);
+
+        UNSIGNED_LONGS_EQUAL(1, arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(heap_arena.compute_allocated_size(100),
+                             arena.compute_allocated_size(100));
+
+        arena.deallocate(pointer);
+        UNSIGNED_LONGS_EQUAL(0, arena.num_allocations());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(huge_page_arena, allocate_from_reserved) {
+    HeapArena heap_arena;
+
+    {
+        HugePageArena arena(heap_arena, 1000);
+        CHECK(arena.is_valid());
+
+        // Rounded up to huge page.
+        CHECK(arena.reserved_size() >= 1000);
+        UNSIGNED_LONGS_EQUAL(0, arena.reserved_size() % (2 * 1024 * 1024));
+
+        void* pointer0 = arena.allocate(100);
+        CHECK(pointer0);
+        void* pointer1 = arena.allocate(2000);
+        CHECK(pointer1);
+        CHECK(pointer0 != pointer1);
+
+        UNSIGNED_LONGS_EQUAL(0, (size_t)pointer0 % sizeof(AlignMax));
+        UNSIGNED_LONGS_EQUAL(0, (size_t)pointer1 % sizeof(AlignMax));
+
+        memset(pointer0, 0xff, 100);
+        memset(pointer1, 0xff, 2000);
+
+        UNSIGNED_LONGS_EQUAL(2, arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(
+            arena.compute_allocated_size(100) + arena.compute_allocated_size(2000),
+            arena.num_used_bytes());
+        UNSIGNED_LONGS_EQUAL(arena.compute_allocated_size(100),
+                             arena.allocated_size(pointer0));
+
+        // Nothing allocated from parent.
+        UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(0, arena.num_fallbacks());
+
+        arena.deallocate(pointer0);
+        arena.deallocate(pointer1);
+
+        // Rewound when idle.
+        UNSIGNED_LONGS_EQUAL(0, arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(0, arena.num_used_bytes());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(huge_page_arena, fallback_to_parent) {
+    HeapArena heap_arena;
+
+    {
+        HugePageArena arena(heap_arena, 1);
+        CHECK(arena.is_valid());
+
+        const size_t big_size = arena.reserved_size();
+
+        void* pointer0 = arena.allocate(100);
+        CHECK(pointer0);
+        void* pointer1 = arena.allocate(big_size);
+        CHECK(pointer1);
+
+        UNSIGNED_LONGS_EQUAL(2, arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(1, arena.num_fallbacks());
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+
+        UNSIGNED_LONGS_EQUAL(heap_arena.allocated_size(pointer1),
+                             arena.allocated_size(pointer1));
+
+        arena.deallocate(pointer1);
+        UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+
+        arena.deallocate(pointer0);
+        UNSIGNED_LONGS_EQUAL(0, arena.num_allocations());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_core/mapped_file.h"
+#include "roc_core/temp_file.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+size_t file_size(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    CHECK(fp);
+    CHECK(fseek(fp, 0, SEEK_END) == 0);
+    const long size = ftell(fp);
+    CHECK(fclose(fp) == 0);
+    return (size_t)size;
+}
+
+} // namespace
+
+TEST_GROUP(mapped_file) {};
+
+TEST(mapped_file, write_read) {
+    TempFile temp_file("test.bin");
+
+    enum { NumBytes = 3000 };
+
+    {
+        MappedFile file;
+        CHECK(file.open_write(temp_file.path()));
+        CHECK(file.is_opened());
+        UNSIGNED_LONGS_EQUAL(0, file.size());
+
+        for (size_t n = 0; n < NumBytes; n++) {
+            CHECK(file.reserve(n + 1));
+            file.data()[n] = uint8_t(n);
+            file.resize(n + 1);
+        }
+
+        CHECK(file.capacity() >= NumBytes);
+        UNSIGNED_LONGS_EQUAL(NumBytes, file.size());
+
+        CHECK(file.close());
+        CHECK(!file.is_opened());
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumBytes, file_size(temp_file.path()));
+
+    {
+        MappedFile file;
+        CHECK(file.open_read(temp_file.path()));
+        UNSIGNED_LONGS_EQUAL(NumBytes, file.size());
+
+        for (size_t n = 0; n < NumBytes; n++) {
+            UNSIGNED_LONGS_EQUAL(uint8_t(n), file.data()[n]);
+        }
+    }
+}
+
+TEST(mapped_file, grow) {
+    TempFile temp_file("test.bin");
+
+    MappedFile file;
+    CHECK(file.open_write(temp_file.path()));
+    UNSIGNED_LONGS_EQUAL(0, file.capacity());
+
+    CHECK(file.reserve(1));
+    const size_t chunk_size = file.capacity();
+    CHECK(chunk_size > 1);
+
+    // doesn't remap while there is enough room
+    uint8_t* data = file.data();
+    CHECK(file.reserve(chunk_size));
+    CHECK(file.data() == data);
+    UNSIGNED_LONGS_EQUAL(chunk_size, file.capacity());
+
+    CHECK(file.reserve(chunk_size + 1));
+    CHECK(file.capacity() > chunk_size);
+
+    file.resize(10);
+    CHECK(file.close());
+
+    // truncated to size on close
+    UNSIGNED_LONGS_EQUAL(10, file_size(temp_file.path()));
+}
+
+TEST(mapped_file, empty) {
+    TempFile temp_file("test.bin");
+
+    {
+        MappedFile file;
+        CHECK(file.open_write(temp_file.path()));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, file_size(temp_file.path()));
+
+    MappedFile file;
+    CHECK(file.open_read(temp_file.path()));
+    UNSIGNED_LONGS_EQUAL(0, file.size());
+    CHECK(!file.data());
+}
+
+TEST(mapped_file, not_found) {
+    MappedFile file;
+    CHECK(!file.open_read("/nonexistent/test.bin"));
+    CHECK(!file.is_opened());
+    CHECK(!file.open_write("/nonexistent/test.bin"));
+    CHECK(!file.is_opened());
+}
+
+TEST(mapped_file, not_regular) {
+    MappedFile file;
+    CHECK(!file.open_read("/dev/null"));
+    CHECK(!file.is_opened());
+}
+
+} // namespace core
+} // namespace roc
@@ -9,10 +9,45 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/memory_limiter.h"
+#include "roc_core/thread.h"
 
 namespace roc {
 namespace core {
 
+namespace {
+
+struct TestThread : public Thread {
+    TestThread(MemoryLimiter& limiter, size_t n_bytes)
+        : limiter(limiter)
+        , n_bytes(n_bytes)
+        , n_failed(0) {
+    }
+
+    MemoryLimiter& limiter;
+    size_t n_bytes;
+    size_t n_failed;
+
+    virtual void run() {
+        enum { NumIterations = 1000, NumAllocs = 10 };
+
+        for (size_t i = 0; i < NumIterations; i++) {
+            size_t n_acquired = 0;
+            for (size_t n = 0; n < NumAllocs; n++) {
+                if (limiter.acquire(n_bytes)) {
+                    n_acquired++;
+                } else {
+                    n_failed++;
+                }
+            }
+            for (size_t n = 0; n < n_acquired; n++) {
+                limiter.release(n_bytes);
+            }
+        }
+    }
+};
+
+} // namespace
+
 TEST_GROUP(memory_limiter) {};
 
 TEST(memory_limiter, acquire_release) {
@@ -28,5 +63,80 @@ TEST(memory_limiter, acquire_release) {
     CHECK(memory_limiter.num_acquired() == 0);
 }
 
+TEST(memory_limiter, no_limit) {
+    MemoryLimiter memory_limiter("test", 0);
+
+    for (size_t n = 0; n < 100; n++) {
+        CHECK(memory_limiter.acquire(1000));
+    }
+    UNSIGNED_LONGS_EQUAL(100000, memory_limiter.num_acquired());
+
+    for (size_t n = 0; n < 100; n++) {
+        memory_limiter.release(1000);
+    }
+    UNSIGNED_LONGS_EQUAL(0, memory_limiter.num_acquired());
+}
+
+TEST(memory_limiter, exact_limit) {
+    enum { Limit = 1024 * 1024, Size = 100 };
+
+    MemoryLimiter memory_limiter("test", Limit);
+
+    // quota reserved in chunks shouldn't prevent reaching the limit
+    size_t n_acquired = 0;
+    while (memory_limiter.acquire(Size)) {
+        n_acquired++;
+    }
+    UNSIGNED_LONGS_EQUAL(Limit / Size, n_acquired);
+    UNSIGNED_LONGS_EQUAL(Limit / Size * Size, memory_limiter.num_acquired());
+
+    for (size_t n = 0; n < n_acquired; n++) {
+        memory_limiter.release(Size);
+    }
+    UNSIGNED_LONGS_EQUAL(0, memory_limiter.num_acquired());
+}
+
+TEST(memory_limiter, release_from_other_thread) {
+    MemoryLimiter memory_limiter("test", 1024 * 1024);
+
+    CHECK(memory_limiter.acquire(100000));
+
+    // other thread uses its own shard, and leaves some unused quota there
+    TestThread thread(memory_limiter, 1000);
+    CHECK(thread.start());
+    thread.join();
+    UNSIGNED_LONGS_EQUAL(0, thread.n_failed);
+
+    UNSIGNED_LONGS_EQUAL(100000, memory_limiter.num_acquired());
+
+    memory_limiter.release(100000);
+    UNSIGNED_LONGS_EQUAL(0, memory_limiter.num_acquired());
+}
+
+TEST(memory_limiter, concurrent) {
+    enum { NumThreads = 8, Size = 1000 };
+
+    // enough for all threads
+    MemoryLimiter memory_limiter("test", NumThreads * Size * 10);
+
+    TestThread* threads[NumThreads];
+    for (size_t n = 0; n < NumThreads; n++) {
+        threads[n] = new TestThread(memory_limiter, Size);
+    }
+    for (size_t n = 0; n < NumThreads; n++) {
+        CHECK(threads[n]->start());
+    }
+    for (size_t n = 0; n < NumThreads; n++) {
+        threads[n]->join();
+    }
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        UNSIGNED_LONGS_EQUAL(0, threads[n]->n_failed);
+        delete threads[n];
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, memory_limiter.num_acquired());
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <sys/mman.h>
+
+#include "roc_core/memory_lock.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { PageSize = 4096, NumPages = 64 };
+
+uint8_t* map_pages() {
+    void* ptr = mmap(NULL, PageSize * NumPages, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(ptr != MAP_FAILED);
+    return (uint8_t*)ptr;
+}
+
+void unmap_pages(uint8_t* ptr) {
+    munmap(ptr, PageSize * NumPages);
+}
+
+void touch_pages(volatile uint8_t* ptr) {
+    for (size_t n = 0; n < NumPages; n++) {
+        ptr[n * PageSize] = 1;
+    }
+}
+
+} // namespace
+
+TEST_GROUP(memory_lock) {};
+
+TEST(memory_lock, page_faults) {
+    PageFaults faults1;
+    CHECK(MemoryLock::get_page_faults(faults1));
+
+    // First touch of fresh pages faults them in.
+    uint8_t* pages = map_pages();
+    touch_pages(pages);
+
+    PageFaults faults2;
+    CHECK(MemoryLock::get_page_faults(faults2));
+
+    CHECK(faults2.minor > faults1.minor);
+    CHECK(faults2.major >= faults1.major);
+
+    unmap_pages(pages);
+}
+
+TEST(memory_lock, prefault) {
+    // Locking memory may be not permitted in test environment.
+    if (!MemoryLock::acquire()) {
+        return;
+    }
+
+    // Pages of new mapping are populated when it's created.
+    uint8_t* pages = map_pages();
+
+    PageFaults faults1;
+    CHECK(MemoryLock::get_page_faults(faults1));
+
+    touch_pages(pages);
+
+    PageFaults faults2;
+    CHECK(MemoryLock::get_page_faults(faults2));
+
+    UNSIGNED_LONGS_EQUAL(faults1.minor, faults2.minor);
+    UNSIGNED_LONGS_EQUAL(faults1.major, faults2.major);
+
+    unmap_pages(pages);
+
+    MemoryLock::release();
+}
+
+TEST(memory_lock, prefault_stack) {
+    // Just checks that it doesn't crash.
+    Thread::prefault_stack(128 * 1024);
+}
+
+} // namespace core
+} // namespace roc
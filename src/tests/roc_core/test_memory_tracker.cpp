@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/memory_tracker.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(memory_tracker) {};
+
+TEST(memory_tracker, live_and_peak) {
+    MemoryTracker tracker;
+
+    tracker.acquire(MemoryTag_Fec, 100);
+    tracker.acquire(MemoryTag_Fec, 50);
+    tracker.release(MemoryTag_Fec, 100);
+    tracker.acquire(MemoryTag_Fec, 20);
+
+    MemoryUsage usage = tracker.usage();
+    UNSIGNED_LONGS_EQUAL(70, usage.live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(150, usage.peak_bytes[MemoryTag_Fec]);
+
+    tracker.release(MemoryTag_Fec, 70);
+
+    usage = tracker.usage();
+    UNSIGNED_LONGS_EQUAL(0, usage.live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(150, usage.peak_bytes[MemoryTag_Fec]);
+}
+
+TEST(memory_tracker, tags) {
+    MemoryTracker tracker;
+
+    tracker.acquire(MemoryTag_Queue, 10);
+    tracker.acquire(MemoryTag_Resampler, 20);
+    tracker.acquire(MemoryTag_Rtcp, 30);
+
+    const MemoryUsage usage = tracker.usage();
+    UNSIGNED_LONGS_EQUAL(0, usage.live_bytes[MemoryTag_Session]);
+    UNSIGNED_LONGS_EQUAL(10, usage.live_bytes[MemoryTag_Queue]);
+    UNSIGNED_LONGS_EQUAL(0, usage.live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(20, usage.live_bytes[MemoryTag_Resampler]);
+    UNSIGNED_LONGS_EQUAL(30, usage.live_bytes[MemoryTag_Rtcp]);
+
+    tracker.release(MemoryTag_Queue, 10);
+    tracker.release(MemoryTag_Resampler, 20);
+    tracker.release(MemoryTag_Rtcp, 30);
+}
+
+TEST(memory_tracker, parent) {
+    MemoryTracker parent;
+
+    {
+        MemoryTracker child1(&parent);
+        MemoryTracker child2(&parent);
+
+        child1.acquire(MemoryTag_Session, 100);
+        child2.acquire(MemoryTag_Session, 50);
+        child1.release(MemoryTag_Session, 100);
+        child2.acquire(MemoryTag_Session, 30);
+
+        UNSIGNED_LONGS_EQUAL(0, child1.usage().live_bytes[MemoryTag_Session]);
+        UNSIGNED_LONGS_EQUAL(100, child1.usage().peak_bytes[MemoryTag_Session]);
+        UNSIGNED_LONGS_EQUAL(80, child2.usage().live_bytes[MemoryTag_Session]);
+        UNSIGNED_LONGS_EQUAL(80, child2.usage().peak_bytes[MemoryTag_Session]);
+
+        // Peak of sum, not sum of peaks.
+        UNSIGNED_LONGS_EQUAL(80, parent.usage().live_bytes[MemoryTag_Session]);
+        UNSIGNED_LONGS_EQUAL(150, parent.usage().peak_bytes[MemoryTag_Session]);
+
+        child2.release(MemoryTag_Session, 80);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, parent.usage().live_bytes[MemoryTag_Session]);
+}
+
+} // namespace core
+} // namespace roc
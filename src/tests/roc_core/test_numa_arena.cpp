@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/numa_arena.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(numa_arena) {};
+
+TEST(numa_arena, unbound) {
+    HeapArena heap_arena;
+
+    {
+        NumaArena arena(heap_arena, 0);
+        CHECK(arena.is_valid());
+
+        UNSIGNED_LONGS_EQUAL(0, arena.node_mask());
+        UNSIGNED_LONGS_EQUAL(0, arena.cpu_mask());
+
+        void* pointer = arena.allocate(100);
+        CHECK(pointer);
+
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(heap_arena.compute_allocated_size(100),
+                             arena.compute_allocated_size(100));
+        UNSIGNED_LONGS_EQUAL(heap_arena.allocated_size(pointer),
+                             arena.allocated_size(pointer));
+
+        arena.deallocate(pointer);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(numa_arena, bound) {
+    uint64_t node0_cpus = 0;
+    if (!NumaArena::get_node_cpus(1, node0_cpus) || node0_cpus == 0) {
+        // NUMA topology is not available on this system.
+        return;
+    }
+
+    HeapArena heap_arena;
+
+    {
+        NumaArena arena(heap_arena, 1);
+        CHECK(arena.is_valid());
+
+        UNSIGNED_LONGS_EQUAL(1, arena.node_mask());
+        UNSIGNED_LONGS_EQUAL(node0_cpus, arena.cpu_mask());
+
+        // Both smaller and larger than page.
+        void* pointer0 = arena.allocate(100);
+        CHECK(pointer0);
+        void* pointer1 = arena.allocate(1024 * 1024);
+        CHECK(pointer1);
+
+        memset(pointer0, 0xff, 100);
+        memset(pointer1, 0xff, 1024 * 1024);
+
+        UNSIGNED_LONGS_EQUAL(2, heap_arena.num_allocations());
+
+        arena.deallocate(pointer0);
+        arena.deallocate(pointer1);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(numa_arena, missing_node) {
+    HeapArena heap_arena;
+    NumaArena arena(heap_arena, (uint64_t)1 << 63);
+
+    CHECK(!arena.is_valid());
+}
+
+} // namespace core
+} // namespace roc
@@ -201,5 +201,46 @@ TEST(parse_units, parse_size_overflow) {
     CHECK_FALSE(parse_size(s, result));
 }
 
+TEST(parse_units, parse_cpu_list_error) {
+    uint64_t result = 0;
+
+    CHECK(!parse_cpu_list(NULL, result));
+    CHECK(!parse_cpu_list("", result));
+    CHECK(!parse_cpu_list(",", result));
+    CHECK(!parse_cpu_list("1,", result));
+    CHECK(!parse_cpu_list(",1", result));
+    CHECK(!parse_cpu_list("1 ", result));
+    CHECK(!parse_cpu_list(" 1", result));
+    CHECK(!parse_cpu_list("-1", result));
+    CHECK(!parse_cpu_list("1-", result));
+    CHECK(!parse_cpu_list("3-1", result));
+    CHECK(!parse_cpu_list("1x", result));
+    CHECK(!parse_cpu_list("64", result));
+    CHECK(!parse_cpu_list("0-64", result));
+    CHECK(!parse_cpu_list("99999999999999999999", result));
+}
+
+TEST(parse_units, parse_cpu_list) {
+    uint64_t result = 0;
+
+    CHECK(parse_cpu_list("0", result));
+    CHECK(result == 0x1);
+
+    CHECK(parse_cpu_list("2,3", result));
+    CHECK(result == 0xc);
+
+    CHECK(parse_cpu_list("0-3,6", result));
+    CHECK(result == 0x4f);
+
+    CHECK(parse_cpu_list("5,5,4-5", result));
+    CHECK(result == 0x30);
+
+    CHECK(parse_cpu_list("63", result));
+    CHECK(result == ((uint64_t)1 << 63));
+
+    CHECK(parse_cpu_list("0-63", result));
+    CHECK(result == (uint64_t)-1);
+}
+
 } // namespace core
 } // namespace roc
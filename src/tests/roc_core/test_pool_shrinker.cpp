@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/pool_shrinker.h"
+#include "roc_core/slab_pool.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+const nanoseconds_t IdlePeriod = 100 * Millisecond;
+
+enum { NumObjects = 15 };
+
+struct TestObject {
+    char bytes[100];
+};
+
+PoolShrinkerConfig make_config(float headroom) {
+    PoolShrinkerConfig config;
+    config.idle_period = IdlePeriod;
+    config.headroom = headroom;
+    return config;
+}
+
+void allocate_objects(SlabPool<TestObject>& pool, void** objects, size_t n_objects) {
+    for (size_t n = 0; n < n_objects; n++) {
+        objects[n] = pool.allocate();
+        CHECK(objects[n]);
+    }
+}
+
+void deallocate_objects(SlabPool<TestObject>& pool, void** objects, size_t n_objects) {
+    for (size_t n = 0; n < n_objects; n++) {
+        pool.deallocate(objects[n]);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(pool_shrinker) {
+    HeapArena arena;
+};
+
+TEST(pool_shrinker, disabled) {
+    SlabPool<TestObject> pool("test", arena);
+    PoolShrinker shrinker((PoolShrinkerConfig()));
+
+    CHECK(!shrinker.is_enabled());
+    CHECK(shrinker.add_pool(pool, 0));
+
+    void* objects[NumObjects];
+    allocate_objects(pool, objects, NumObjects);
+    deallocate_objects(pool, objects, NumObjects);
+
+    for (size_t n = 0; n < 10; n++) {
+        LONGS_EQUAL(0, shrinker.shrink_pools((nanoseconds_t)n * IdlePeriod));
+    }
+    LONGS_EQUAL(4, arena.num_allocations());
+}
+
+TEST(pool_shrinker, idle_period) {
+    SlabPool<TestObject> pool("test", arena);
+    PoolShrinker shrinker(make_config(0));
+
+    CHECK(shrinker.is_enabled());
+    CHECK(shrinker.add_pool(pool, 0));
+
+    void* objects[NumObjects];
+    allocate_objects(pool, objects, NumObjects);
+    deallocate_objects(pool, objects, NumObjects);
+
+    // Idle period starts.
+    LONGS_EQUAL(0, shrinker.shrink_pools(0));
+    LONGS_EQUAL(0, shrinker.shrink_pools(IdlePeriod / 2));
+    LONGS_EQUAL(4, arena.num_allocations());
+
+    // Idle period ends.
+    LONGS_EQUAL(4, shrinker.shrink_pools(IdlePeriod));
+    LONGS_EQUAL(0, arena.num_allocations());
+    LONGS_EQUAL(4, pool.num_shrink_events());
+}
+
+TEST(pool_shrinker, grow_restarts_period) {
+    SlabPool<TestObject> pool("test", arena);
+    PoolShrinker shrinker(make_config(0));
+
+    CHECK(shrinker.add_pool(pool, 0));
+
+    void* objects[NumObjects];
+    allocate_objects(pool, objects, 7);
+    deallocate_objects(pool, objects, 7);
+
+    LONGS_EQUAL(0, shrinker.shrink_pools(0));
+
+    // Pool grows in the middle of period.
+    allocate_objects(pool, objects, NumObjects);
+    deallocate_objects(pool, objects, NumObjects);
+
+    LONGS_EQUAL(0, shrinker.shrink_pools(IdlePeriod / 2));
+    LONGS_EQUAL(0, shrinker.shrink_pools(IdlePeriod));
+    LONGS_EQUAL(4, arena.num_allocations());
+
+    LONGS_EQUAL(4, shrinker.shrink_pools(IdlePeriod / 2 + IdlePeriod));
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(pool_shrinker, headroom) {
+    SlabPool<TestObject> pool("test", arena);
+    PoolShrinker shrinker(make_config(1.0f));
+
+    CHECK(shrinker.add_pool(pool, 0));
+
+    void* objects[NumObjects];
+    allocate_objects(pool, objects, NumObjects);
+    deallocate_objects(pool, objects, NumObjects);
+
+    LONGS_EQUAL(0, shrinker.shrink_pools(0));
+
+    // Peak usage during period.
+    allocate_objects(pool, objects, 3);
+    LONGS_EQUAL(0, shrinker.shrink_pools(IdlePeriod / 2));
+    deallocate_objects(pool, objects, 3);
+
+    CHECK(shrinker.shrink_pools(IdlePeriod) > 0);
+    CHECK(arena.num_allocations() < 4);
+
+    // Twice the peak fits without growing.
+    const size_t grow_events = pool.num_grow_events();
+    allocate_objects(pool, objects, 6);
+    LONGS_EQUAL(grow_events, pool.num_grow_events());
+    deallocate_objects(pool, objects, 6);
+}
+
+TEST(pool_shrinker, min_slots) {
+    SlabPool<TestObject> pool("test", arena);
+    PoolShrinker shrinker(make_config(0));
+
+    CHECK(shrinker.add_pool(pool, 7));
+
+    void* objects[NumObjects];
+    allocate_objects(pool, objects, NumObjects);
+    deallocate_objects(pool, objects, NumObjects);
+
+    LONGS_EQUAL(0, shrinker.shrink_pools(0));
+    LONGS_EQUAL(1, shrinker.shrink_pools(IdlePeriod));
+    LONGS_EQUAL(3, arena.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/allocation_policy.h"
+#include "roc_core/ref_counted.h"
+#include "roc_core/shared_ptr.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+struct TestObject : RefCounted<TestObject, ManualAllocation> {};
+
+} // namespace
+
+TEST_GROUP(ref_counted) {};
+
+TEST(ref_counted, shared_by_default) {
+    TestObject obj;
+
+    CHECK(!obj.is_local());
+    LONGS_EQUAL(0, obj.getref());
+
+    {
+        SharedPtr<TestObject> p1(&obj);
+        SharedPtr<TestObject> p2(p1);
+
+        CHECK(!obj.is_local());
+        LONGS_EQUAL(2, obj.getref());
+    }
+
+    LONGS_EQUAL(0, obj.getref());
+}
+
+TEST(ref_counted, make_local) {
+    TestObject obj;
+
+    {
+        SharedPtr<TestObject> p1(&obj);
+
+        CHECK(obj.make_local());
+        CHECK(obj.is_local());
+
+        {
+            SharedPtr<TestObject> p2(p1);
+            SharedPtr<TestObject> p3(p2);
+
+            LONGS_EQUAL(3, obj.getref());
+        }
+
+        LONGS_EQUAL(1, obj.getref());
+
+        // no-op if already local
+        CHECK(obj.make_local());
+        CHECK(obj.is_local());
+    }
+
+    LONGS_EQUAL(0, obj.getref());
+}
+
+TEST(ref_counted, make_local_other_refs) {
+    TestObject obj;
+
+    SharedPtr<TestObject> p1(&obj);
+    SharedPtr<TestObject> p2(p1);
+
+    // can't switch while someone else may hold a reference
+    CHECK(!obj.make_local());
+    CHECK(!obj.is_local());
+
+    p2 = NULL;
+
+    CHECK(obj.make_local());
+    CHECK(obj.is_local());
+}
+
+TEST(ref_counted, make_shared) {
+    TestObject obj;
+
+    {
+        SharedPtr<TestObject> p1(&obj);
+
+        CHECK(obj.make_local());
+
+        SharedPtr<TestObject> p2(p1);
+        LONGS_EQUAL(2, obj.getref());
+
+        obj.make_shared();
+        CHECK(!obj.is_local());
+        LONGS_EQUAL(2, obj.getref());
+
+        // no-op if already shared
+        obj.make_shared();
+        CHECK(!obj.is_local());
+
+        p2 = NULL;
+        LONGS_EQUAL(1, obj.getref());
+    }
+
+    LONGS_EQUAL(0, obj.getref());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/region_arena.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(region_arena) {};
+
+TEST(region_arena, allocate_from_region) {
+    HeapArena heap_arena;
+
+    {
+        RegionArena arena(heap_arena, 1024);
+        CHECK(arena.is_valid());
+        CHECK(arena.is_idle());
+
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+
+        void* pointer0 = arena.allocate(100);
+        CHECK(pointer0);
+        void* pointer1 = arena.allocate(200);
+        CHECK(pointer1);
+        CHECK(pointer0 != pointer1);
+
+        CHECK(!arena.is_idle());
+        UNSIGNED_LONGS_EQUAL(2, arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(
+            arena.compute_allocated_size(100) + arena.compute_allocated_size(200),
+            arena.num_used_bytes());
+        UNSIGNED_LONGS_EQUAL(0, arena.num_fallbacks());
+
+        // Nothing allocated from parent.
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+
+        arena.deallocate(pointer0);
+        arena.deallocate(pointer1);
+
+        CHECK(arena.is_idle());
+        UNSIGNED_LONGS_EQUAL(0, arena.num_allocations());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(region_arena, alignment) {
+    HeapArena heap_arena;
+    RegionArena arena(heap_arena, 1024);
+
+    void* pointers[5] = {};
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pointers); n++) {
+        pointers[n] = arena.allocate(n * 3 + 1);
+        CHECK(pointers[n]);
+        UNSIGNED_LONGS_EQUAL(0, (size_t)pointers[n] % sizeof(AlignMax));
+    }
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pointers); n++) {
+        arena.deallocate(pointers[n]);
+    }
+}
+
+TEST(region_arena, rewind_when_idle) {
+    HeapArena heap_arena;
+    RegionArena arena(heap_arena, 1024);
+
+    void* pointer0 = arena.allocate(100);
+    void* pointer1 = arena.allocate(100);
+    CHECK(pointer0);
+    CHECK(pointer1);
+
+    // Region is not rewound until all chunks are freed.
+    arena.deallocate(pointer0);
+    CHECK(arena.num_used_bytes() > 0);
+
+    void* pointer2 = arena.allocate(100);
+    CHECK(pointer2);
+    CHECK(pointer2 != pointer0);
+
+    arena.deallocate(pointer1);
+    arena.deallocate(pointer2);
+
+    CHECK(arena.is_idle());
+    UNSIGNED_LONGS_EQUAL(0, arena.num_used_bytes());
+
+    // After rewinding, same memory is used again.
+    void* pointer3 = arena.allocate(100);
+    POINTERS_EQUAL(pointer0, pointer3);
+
+    arena.deallocate(pointer3);
+}
+
+TEST(region_arena, fallback_to_parent) {
+    HeapArena heap_arena;
+
+    {
+        RegionArena arena(heap_arena, 256);
+
+        void* pointer0 = arena.allocate(128);
+        CHECK(pointer0);
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+
+        // Doesn't fit into region.
+        void* pointer1 = arena.allocate(256);
+        CHECK(pointer1);
+        UNSIGNED_LONGS_EQUAL(2, heap_arena.num_allocations());
+        UNSIGNED_LONGS_EQUAL(1, arena.num_fallbacks());
+        UNSIGNED_LONGS_EQUAL(2, arena.num_allocations());
+
+        UNSIGNED_LONGS_EQUAL(heap_arena.allocated_size(pointer1),
+                             arena.allocated_size(pointer1));
+        UNSIGNED_LONGS_EQUAL(arena.compute_allocated_size(128),
+                             arena.allocated_size(pointer0));
+
+        arena.deallocate(pointer1);
+        UNSIGNED_LONGS_EQUAL(1, heap_arena.num_allocations());
+        CHECK(!arena.is_idle());
+
+        arena.deallocate(pointer0);
+        CHECK(arena.is_idle());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/semaphore.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(semaphore) {};
+
+TEST(semaphore, timed_wait_posted) {
+    Semaphore sem(0);
+    sem.post();
+
+    CHECK(sem.timed_wait(timestamp(ClockMonotonic) + Second));
+}
+
+TEST(semaphore, timed_wait_expired) {
+    Semaphore sem(0);
+
+    CHECK(!sem.timed_wait(timestamp(ClockMonotonic) - Millisecond));
+}
+
+TEST(semaphore, timed_wait_deadline) {
+    const nanoseconds_t delay = 10 * Millisecond;
+
+    Semaphore sem(0);
+
+    const nanoseconds_t start = timestamp(ClockMonotonic);
+    CHECK(!sem.timed_wait(start + delay));
+
+    // Deadline is in monotonic clock domain, so wait shouldn't return earlier.
+    CHECK(timestamp(ClockMonotonic) >= start + delay);
+}
+
+} // namespace core
+} // namespace roc
@@ -12,6 +12,7 @@
 #include "roc_core/memory_ops.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
 
 namespace roc {
 namespace core {
@@ -39,6 +40,53 @@ struct TestObject {
     char bytes[1000];
 };
 
+struct TestAllocThread : public Thread {
+    TestAllocThread(IPool& pool)
+        : pool(pool) {
+    }
+
+    IPool& pool;
+
+    virtual void run() {
+        enum { NumIterations = 1000, NumObjects = 50 };
+
+        void* objects[NumObjects];
+
+        for (size_t i = 0; i < NumIterations; i++) {
+            for (size_t n = 0; n < NumObjects; n++) {
+                objects[n] = pool.allocate();
+                CHECK(objects[n]);
+                memset(objects[n], (int)n, sizeof(TestObject));
+            }
+            for (size_t n = 0; n < NumObjects; n++) {
+                pool.deallocate(objects[n]);
+            }
+        }
+    }
+};
+
+struct TestReleaseThread : public Thread {
+    TestReleaseThread(IPool& pool, size_t n_objects)
+        : pool(pool)
+        , n_objects(n_objects) {
+    }
+
+    IPool& pool;
+    size_t n_objects;
+
+    virtual void run() {
+        void* objects[100];
+
+        for (size_t n = 0; n < n_objects; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        for (size_t n = 0; n < n_objects; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+};
+
 } // namespace
 
 TEST_GROUP(slab_pool) {};
@@ -196,6 +244,140 @@ TEST(slab_pool, reserve_many) {
     LONGS_EQUAL(0, arena.num_allocations());
 }
 
+TEST(slab_pool, grow_events) {
+    TestArena arena;
+
+    SlabPool<TestObject> pool("test", arena);
+
+    CHECK(pool.reserve(4));
+    LONGS_EQUAL(0, pool.num_grow_events());
+
+    void* objects[5];
+
+    // served from reserved memory
+    for (size_t n = 0; n < 4; n++) {
+        objects[n] = pool.allocate();
+        CHECK(objects[n]);
+    }
+    LONGS_EQUAL(0, pool.num_grow_events());
+
+    // pool grows on demand
+    objects[4] = pool.allocate();
+    CHECK(objects[4]);
+    LONGS_EQUAL(1, pool.num_grow_events());
+    LONGS_EQUAL(0, pool.num_exhausted());
+
+    for (size_t n = 0; n < 5; n++) {
+        pool.deallocate(objects[n]);
+    }
+}
+
+TEST(slab_pool, used_slots) {
+    TestArena arena;
+    SlabPool<TestObject> pool("test", arena);
+
+    LONGS_EQUAL(0, pool.num_used_slots());
+
+    void* objects[3];
+    for (size_t n = 0; n < 3; n++) {
+        objects[n] = pool.allocate();
+        CHECK(objects[n]);
+        LONGS_EQUAL(n + 1, pool.num_used_slots());
+    }
+
+    for (size_t n = 0; n < 3; n++) {
+        pool.deallocate(objects[n]);
+        LONGS_EQUAL(2 - n, pool.num_used_slots());
+    }
+}
+
+TEST(slab_pool, fixed_capacity) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena);
+
+        CHECK(pool.reserve(10));
+        pool.set_fixed_capacity(true);
+
+        const size_t n_allocations = arena.num_allocations();
+
+        void* objects[100];
+        size_t n_objects = 0;
+
+        // reserved capacity may be rounded up to slab size
+        while ((objects[n_objects] = pool.allocate()) != NULL) {
+            n_objects++;
+            CHECK(n_objects < ROC_ARRAY_SIZE(objects));
+        }
+        CHECK(n_objects >= 10);
+
+        // pool doesn't grow
+        CHECK(!pool.allocate());
+
+        LONGS_EQUAL(n_allocations, arena.num_allocations());
+        LONGS_EQUAL(0, pool.num_grow_events());
+        LONGS_EQUAL(2, pool.num_exhausted());
+
+        // returned slots can be reused
+        pool.deallocate(objects[0]);
+        objects[0] = pool.allocate();
+        CHECK(objects[0]);
+
+        // disable fixed mode, pool grows again
+        pool.set_fixed_capacity(false);
+
+        objects[n_objects] = pool.allocate();
+        CHECK(objects[n_objects]);
+        n_objects++;
+
+        LONGS_EQUAL(1, pool.num_grow_events());
+
+        for (size_t n = 0; n < n_objects; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, fixed_capacity_thread_cache) {
+    enum { NumObjects = 32 };
+
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena, sizeof(TestObject), 0, 0,
+                                  SlabPool_DefaultGuards, true);
+
+        // exactly one slab of NumObjects slots
+        CHECK(pool.reserve(NumObjects));
+        pool.set_fixed_capacity(true);
+
+        // another thread leaves part of slots in its magazine
+        TestReleaseThread thread(pool, NumObjects);
+        CHECK(thread.start());
+        thread.join();
+
+        // all slots are still available to this thread
+        void* objects[NumObjects];
+        for (size_t n = 0; n < NumObjects; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+
+        CHECK(!pool.allocate());
+        LONGS_EQUAL(1, pool.num_exhausted());
+        LONGS_EQUAL(0, pool.num_grow_events());
+
+        for (size_t n = 0; n < NumObjects; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
 TEST(slab_pool, min_size_allocate) {
     // min_size=0
     {
@@ -547,5 +729,259 @@ TEST(slab_pool, object_ownership_guard) {
     pool1.deallocate(pointers[1]);
 }
 
+TEST(slab_pool, thread_cache_allocate_deallocate) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena, sizeof(TestObject), 0, 0,
+                                  SlabPool_DefaultGuards, true);
+
+        void* objects[100];
+
+        for (size_t i = 0; i < 10; i++) {
+            for (size_t n = 0; n < ROC_ARRAY_SIZE(objects); n++) {
+                objects[n] = pool.allocate();
+                CHECK(objects[n]);
+            }
+            for (size_t n = 0; n < ROC_ARRAY_SIZE(objects); n++) {
+                pool.deallocate(objects[n]);
+            }
+        }
+
+        // after first iteration, most operations are served from cache
+        CHECK(pool.num_cache_hits() > 0);
+        CHECK(pool.num_cache_misses() > 0);
+        CHECK(pool.num_cache_hits() > pool.num_cache_misses());
+
+        LONGS_EQUAL(0, pool.num_guard_failures());
+    }
+
+    // all slots, including cached ones, are returned to arena
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, thread_cache_reuse) {
+    TestArena arena;
+
+    SlabPool<TestObject> pool("test", arena, sizeof(TestObject), 0, 0,
+                              SlabPool_DefaultGuards, true);
+
+    void* object = pool.allocate();
+    CHECK(object);
+    pool.deallocate(object);
+
+    const size_t n_allocations = arena.num_allocations();
+
+    for (size_t i = 0; i < 100; i++) {
+        void* new_object = pool.allocate();
+        CHECK(new_object == object);
+        pool.deallocate(new_object);
+    }
+
+    LONGS_EQUAL(n_allocations, arena.num_allocations());
+
+    // first allocation missed cache
+    LONGS_EQUAL(201, pool.num_cache_hits());
+    LONGS_EQUAL(1, pool.num_cache_misses());
+}
+
+TEST(slab_pool, thread_cache_disabled) {
+    TestArena arena;
+
+    SlabPool<TestObject> pool("test", arena);
+
+    void* object = pool.allocate();
+    CHECK(object);
+    pool.deallocate(object);
+
+    LONGS_EQUAL(0, pool.num_cache_hits());
+    LONGS_EQUAL(0, pool.num_cache_misses());
+}
+
+TEST(slab_pool, thread_cache_many_threads) {
+    enum { NumThreads = 8 };
+
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena, sizeof(TestObject), 0, 0,
+                                  SlabPool_DefaultGuards, true);
+
+        TestAllocThread* threads[NumThreads];
+
+        for (size_t n = 0; n < NumThreads; n++) {
+            threads[n] = new TestAllocThread(pool);
+            CHECK(threads[n]->start());
+        }
+
+        for (size_t n = 0; n < NumThreads; n++) {
+            threads[n]->join();
+            delete threads[n];
+        }
+
+        LONGS_EQUAL(0, pool.num_guard_failures());
+        CHECK(pool.num_cache_hits() > pool.num_cache_misses());
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, release_free_slabs) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena);
+
+        void* objects[15];
+
+        // slabs of 1, 2, 4, 8 slots
+        for (size_t n = 0; n < 15; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        LONGS_EQUAL(4, arena.num_allocations());
+
+        // all slabs are used
+        LONGS_EQUAL(0, pool.release_free_slabs(0));
+        LONGS_EQUAL(4, arena.num_allocations());
+
+        for (size_t n = 0; n < 15; n++) {
+            pool.deallocate(objects[n]);
+        }
+
+        LONGS_EQUAL(4, pool.release_free_slabs(0));
+        LONGS_EQUAL(0, arena.num_allocations());
+        LONGS_EQUAL(4, pool.num_shrink_events());
+
+        // pool grows again
+        for (size_t n = 0; n < 15; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        for (size_t n = 0; n < 15; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, release_free_slabs_partial) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena);
+
+        void* objects[15];
+
+        for (size_t n = 0; n < 15; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+
+        // first object is from first slab
+        for (size_t n = 1; n < 15; n++) {
+            pool.deallocate(objects[n]);
+        }
+
+        LONGS_EQUAL(3, pool.release_free_slabs(0));
+        LONGS_EQUAL(1, arena.num_allocations());
+        LONGS_EQUAL(1, pool.num_used_slots());
+
+        pool.deallocate(objects[0]);
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, release_free_slabs_min_slots) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena);
+
+        void* objects[15];
+
+        for (size_t n = 0; n < 15; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        for (size_t n = 0; n < 15; n++) {
+            pool.deallocate(objects[n]);
+        }
+
+        // only largest slab can be released without going below 7 slots
+        LONGS_EQUAL(1, pool.release_free_slabs(7));
+        LONGS_EQUAL(3, arena.num_allocations());
+
+        LONGS_EQUAL(0, pool.release_free_slabs(7));
+        LONGS_EQUAL(3, arena.num_allocations());
+
+        // remaining capacity is used without growing
+        const size_t grow_events = pool.num_grow_events();
+        for (size_t n = 0; n < 7; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        LONGS_EQUAL(grow_events, pool.num_grow_events());
+
+        for (size_t n = 0; n < 7; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, release_free_slabs_thread_cache) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena, sizeof(TestObject), 0, 0,
+                                  SlabPool_DefaultGuards, true);
+
+        void* objects[15];
+
+        for (size_t n = 0; n < 15; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        for (size_t n = 0; n < 15; n++) {
+            pool.deallocate(objects[n]);
+        }
+
+        // slots held in thread cache are returned to slabs
+        LONGS_EQUAL(4, pool.release_free_slabs(0));
+        LONGS_EQUAL(1, arena.num_allocations());
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
+TEST(slab_pool, release_free_slabs_fixed_capacity) {
+    TestArena arena;
+
+    {
+        SlabPool<TestObject> pool("test", arena);
+
+        CHECK(pool.reserve(10));
+        pool.set_fixed_capacity(true);
+
+        LONGS_EQUAL(0, pool.release_free_slabs(0));
+        LONGS_EQUAL(0, pool.num_shrink_events());
+
+        void* objects[10];
+        for (size_t n = 0; n < 10; n++) {
+            objects[n] = pool.allocate();
+            CHECK(objects[n]);
+        }
+        for (size_t n = 0; n < 10; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, arena.num_allocations());
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/tagged_arena.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(tagged_arena) {};
+
+TEST(tagged_arena, track_allocations) {
+    HeapArena heap_arena;
+    MemoryTracker tracker;
+
+    TaggedArena fec_arena(heap_arena, tracker, MemoryTag_Fec);
+    TaggedArena queue_arena(heap_arena, tracker, MemoryTag_Queue);
+
+    void* ptr0 = fec_arena.allocate(128);
+    CHECK(ptr0);
+    void* ptr1 = fec_arena.allocate(64);
+    CHECK(ptr1);
+    void* ptr2 = queue_arena.allocate(32);
+    CHECK(ptr2);
+
+    const size_t size0 = heap_arena.compute_allocated_size(128);
+    const size_t size1 = heap_arena.compute_allocated_size(64);
+    const size_t size2 = heap_arena.compute_allocated_size(32);
+
+    UNSIGNED_LONGS_EQUAL(size0 + size1, tracker.usage().live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(size2, tracker.usage().live_bytes[MemoryTag_Queue]);
+
+    fec_arena.deallocate(ptr0);
+
+    UNSIGNED_LONGS_EQUAL(size1, tracker.usage().live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(size0 + size1, tracker.usage().peak_bytes[MemoryTag_Fec]);
+
+    fec_arena.deallocate(ptr1);
+    queue_arena.deallocate(ptr2);
+
+    UNSIGNED_LONGS_EQUAL(0, tracker.usage().live_bytes[MemoryTag_Fec]);
+    UNSIGNED_LONGS_EQUAL(0, tracker.usage().live_bytes[MemoryTag_Queue]);
+    UNSIGNED_LONGS_EQUAL(0, heap_arena.num_allocations());
+}
+
+TEST(tagged_arena, allocated_size) {
+    HeapArena heap_arena;
+    MemoryTracker tracker;
+    TaggedArena arena(heap_arena, tracker, MemoryTag_Session);
+
+    UNSIGNED_LONGS_EQUAL(heap_arena.compute_allocated_size(128),
+                         arena.compute_allocated_size(128));
+
+    void* ptr = arena.allocate(128);
+    CHECK(ptr);
+
+    UNSIGNED_LONGS_EQUAL(arena.compute_allocated_size(128), arena.allocated_size(ptr));
+
+    arena.deallocate(ptr);
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/ticker.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// One tick per microsecond.
+const Ticker::ticks_t Freq = 1000000;
+
+} // namespace
+
+TEST_GROUP(ticker) {};
+
+TEST(ticker, wait) {
+    Ticker ticker(Freq);
+
+    ticker.start();
+    const nanoseconds_t start = timestamp(ClockMonotonic);
+
+    for (Ticker::ticks_t n = 1; n <= 5; n++) {
+        ticker.wait(n * 1000);
+        CHECK(timestamp(ClockMonotonic) >= start + nanoseconds_t(n) * Millisecond);
+    }
+
+    const TickerMetrics& metrics = ticker.metrics();
+
+    LONGS_EQUAL(5, metrics.wait_count);
+    LONGS_EQUAL(0, metrics.total_spin_time);
+    CHECK(metrics.max_lateness >= metrics.last_lateness);
+    CHECK(metrics.total_lateness >= metrics.max_lateness);
+}
+
+TEST(ticker, spin) {
+    Ticker ticker(Freq, Millisecond);
+
+    ticker.start();
+    const nanoseconds_t start = timestamp(ClockMonotonic);
+
+    for (Ticker::ticks_t n = 1; n <= 5; n++) {
+        ticker.wait(n * 2000);
+        CHECK(timestamp(ClockMonotonic) >= start + nanoseconds_t(n) * 2 * Millisecond);
+    }
+
+    const TickerMetrics& metrics = ticker.metrics();
+
+    LONGS_EQUAL(5, metrics.wait_count);
+    // Spinning takes at most spin window per wait.
+    CHECK(metrics.total_spin_time <= 5 * Millisecond + metrics.total_lateness);
+}
+
+TEST(ticker, behind_schedule) {
+    Ticker ticker(Freq, Millisecond);
+
+    ticker.start();
+    sleep_for(ClockMonotonic, 5 * Millisecond);
+
+    // Deadline already passed, wait doesn't block or spin.
+    ticker.wait(1000);
+
+    const TickerMetrics& metrics = ticker.metrics();
+
+    LONGS_EQUAL(1, metrics.wait_count);
+    LONGS_EQUAL(0, metrics.total_spin_time);
+    CHECK(metrics.last_lateness >= 4 * Millisecond);
+}
+
+} // namespace core
+} // namespace roc
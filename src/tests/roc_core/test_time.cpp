@@ -19,6 +19,7 @@ namespace {
 const clock_t clock_list[] = {
     core::ClockMonotonic,
     core::ClockUnix,
+    core::ClockMedia,
 };
 
 } // namespace
@@ -61,5 +62,52 @@ TEST(time, sleep_for) {
     }
 }
 
+TEST(time, media_clock_system) {
+    CHECK(set_media_clock(MediaClock_System, NULL));
+    LONGS_EQUAL(MediaClock_System, media_clock());
+
+    const nanoseconds_t unix_ts = timestamp(ClockUnix);
+    const nanoseconds_t media_ts = timestamp(ClockMedia);
+
+    CHECK(media_ts >= unix_ts);
+    CHECK(media_ts - unix_ts < Second);
+}
+
+TEST(time, media_clock_tai) {
+    if (!set_media_clock(MediaClock_Tai, NULL)) {
+        // not supported on this platform
+        LONGS_EQUAL(MediaClock_System, media_clock());
+        return;
+    }
+
+    LONGS_EQUAL(MediaClock_Tai, media_clock());
+
+    const nanoseconds_t unix_ts = timestamp(ClockUnix);
+    const nanoseconds_t media_ts = timestamp(ClockMedia);
+
+    // TAI is ahead of UTC by number of leap seconds, if kernel knows it.
+    CHECK(media_ts >= unix_ts);
+    CHECK(media_ts - unix_ts < Minute);
+
+    sleep_for(ClockMedia, Millisecond);
+    CHECK(timestamp(ClockMedia) >= media_ts + Millisecond);
+
+    CHECK(set_media_clock(MediaClock_System, NULL));
+}
+
+TEST(time, media_clock_bad_ptp_device) {
+    CHECK(set_media_clock(MediaClock_System, NULL));
+
+    CHECK(!set_media_clock(MediaClock_Ptp, NULL));
+    CHECK(!set_media_clock(MediaClock_Ptp, ""));
+    CHECK(!set_media_clock(MediaClock_Ptp, "/nonexistent/ptp0"));
+
+    // previous source is kept
+    LONGS_EQUAL(MediaClock_System, media_clock());
+
+    const nanoseconds_t unix_ts = timestamp(ClockUnix);
+    CHECK(timestamp(ClockMedia) - unix_ts < Second);
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/token_bucket.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(token_bucket) {};
+
+TEST(token_bucket, steady_rate) {
+    TokenBucket bucket(100, 1);
+
+    nanoseconds_t now = Second;
+
+    for (int n = 0; n < 1000; n++) {
+        CHECK(bucket.allow(now));
+        now += 10 * Millisecond;
+    }
+
+    LONGS_EQUAL(0, bucket.num_denied());
+}
+
+TEST(token_bucket, above_rate) {
+    TokenBucket bucket(100, 1);
+
+    nanoseconds_t now = Second;
+
+    // 1000 events per second during one second
+    size_t n_allowed = 0;
+    for (int n = 0; n < 1000; n++) {
+        if (bucket.allow(now)) {
+            n_allowed++;
+        }
+        now += Millisecond;
+    }
+
+    LONGS_EQUAL(100, n_allowed);
+    LONGS_EQUAL(900, bucket.num_denied());
+}
+
+TEST(token_bucket, burst) {
+    TokenBucket bucket(100, 10);
+
+    nanoseconds_t now = Second;
+
+    // bucket starts full
+    for (int n = 0; n < 10; n++) {
+        CHECK(bucket.allow(now));
+    }
+    CHECK(!bucket.allow(now));
+
+    // one token per 10ms
+    now += 10 * Millisecond;
+    CHECK(bucket.allow(now));
+    CHECK(!bucket.allow(now));
+
+    // bucket refills after idle period, but not above burst
+    now += Second;
+    for (int n = 0; n < 10; n++) {
+        CHECK(bucket.allow(now));
+    }
+    CHECK(!bucket.allow(now));
+
+    LONGS_EQUAL(3, bucket.num_denied());
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/worker_pool.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { MaxJobs = 100 };
+
+HeapArena arena;
+
+struct TestJob : IWorkerJob {
+    Atomic<int> counts[MaxJobs];
+    Atomic<int> total;
+
+    TestJob() {
+        for (size_t n = 0; n < MaxJobs; n++) {
+            counts[n] = 0;
+        }
+        total = 0;
+    }
+
+    virtual void run_job(size_t job_index) {
+        CHECK(job_index < MaxJobs);
+        counts[job_index]++;
+        total++;
+    }
+};
+
+} // namespace
+
+TEST_GROUP(worker_pool) {};
+
+TEST(worker_pool, no_threads) {
+    WorkerPool pool(0, arena);
+    CHECK(pool.is_valid());
+    LONGS_EQUAL(0, pool.num_threads());
+
+    TestJob job;
+    pool.run(job, MaxJobs);
+
+    LONGS_EQUAL(MaxJobs, (int)job.total);
+    for (size_t n = 0; n < MaxJobs; n++) {
+        LONGS_EQUAL(1, (int)job.counts[n]);
+    }
+}
+
+TEST(worker_pool, run_many_times) {
+    WorkerPool pool(4, arena);
+    CHECK(pool.is_valid());
+    LONGS_EQUAL(4, pool.num_threads());
+
+    const size_t n_jobs[] = { 0, 1, 2, 3, 4, 5, 10, MaxJobs };
+
+    for (size_t i = 0; i < 100; i++) {
+        for (size_t j = 0; j < sizeof(n_jobs) / sizeof(n_jobs[0]); j++) {
+            TestJob job;
+            pool.run(job, n_jobs[j]);
+
+            LONGS_EQUAL(n_jobs[j], (int)job.total);
+            for (size_t n = 0; n < MaxJobs; n++) {
+                LONGS_EQUAL(n < n_jobs[j] ? 1 : 0, (int)job.counts[n]);
+            }
+        }
+    }
+}
+
+} // namespace core
+} // namespace roc
@@ -19,12 +19,16 @@ namespace {
 enum {
     NumScheduleIterations = 2000000,
     NumScheduleAfterIterations = 20000,
+    NumRescheduleIterations = 200000,
     NumThreads = 8,
     BatchSize = 1000
 };
 
 const core::nanoseconds_t MaxDelay = 100 * core::Millisecond;
 
+// Deadline of background timers, far enough to never expire during benchmark.
+const core::nanoseconds_t TimerDelay = 1000 * core::Second;
+
 class NoopExecutor : public ControlTaskExecutor<NoopExecutor> {
 public:
     class Task : public ControlTask {
@@ -105,6 +109,62 @@ BENCHMARK_REGISTER_F(BM_QueueContention, ScheduleAt)
     ->Iterations(NumScheduleAfterIterations)
     ->Unit(benchmark::kMicrosecond);
 
+// Re-schedule tasks while thousands of other timers are sleeping in queue,
+// like with many pipelines each having its own processing and RTCP timers.
+BENCHMARK_DEFINE_F(BM_QueueContention, RescheduleManyTimers)(benchmark::State& state) {
+    const int num_timers = (int)state.range(0);
+
+    NoopExecutor::Task* timers = NULL;
+    if (state.thread_index() == 0) {
+        timers = new NoopExecutor::Task[num_timers];
+        for (int n = 0; n < num_timers; n++) {
+            queue.schedule_at(timers[n],
+                              core::timestamp(core::ClockMonotonic) + TimerDelay
+                                  + core::fast_random_range(0, MaxDelay),
+                              executor, &completer);
+        }
+    }
+
+    NoopExecutor::Task* tasks = new NoopExecutor::Task[BatchSize];
+    for (int n = 0; n < BatchSize; n++) {
+        queue.schedule_at(tasks[n], core::timestamp(core::ClockMonotonic) + TimerDelay,
+                          executor, &completer);
+    }
+
+    size_t n_task = 0;
+
+    while (state.KeepRunningBatch(BatchSize)) {
+        for (int n = 0; n < BatchSize; n++) {
+            queue.schedule_at(tasks[n_task % BatchSize],
+                              core::timestamp(core::ClockMonotonic) + TimerDelay
+                                  + core::fast_random_range(0, MaxDelay),
+                              executor, &completer);
+            n_task++;
+        }
+    }
+
+    for (int n = 0; n < BatchSize; n++) {
+        queue.async_cancel(tasks[n]);
+        queue.wait(tasks[n]);
+    }
+    delete[] tasks;
+
+    if (timers) {
+        for (int n = 0; n < num_timers; n++) {
+            queue.async_cancel(timers[n]);
+            queue.wait(timers[n]);
+        }
+        delete[] timers;
+    }
+}
+
+BENCHMARK_REGISTER_F(BM_QueueContention, RescheduleManyTimers)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->ThreadRange(1, NumThreads)
+    ->Iterations(NumRescheduleIterations)
+    ->Unit(benchmark::kMicrosecond);
+
 } // namespace
 } // namespace ctl
 } // namespace roc
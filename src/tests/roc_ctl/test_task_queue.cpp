@@ -66,6 +66,12 @@ public:
         results_[n] = (success ? ControlTaskSuccess : ControlTaskFailure);
     }
 
+    void set_nth_paused(size_t n) {
+        core::Mutex::Lock lock(mutex_);
+        roc_panic_if_not(n < MaxTasks);
+        results_[n] = ControlTaskPause;
+    }
+
     void block() {
         core::Mutex::Lock lock(mutex_);
         allow_counter_ = 0;
@@ -756,6 +762,81 @@ TEST(task_queue, schedule_at_same_deadline) {
     executor.check_all_unblocked();
 }
 
+TEST(task_queue, schedule_at_shuffled_many) {
+    enum { NumTasks = 89, Stride = 37 };
+
+    TestExecutor executor;
+
+    ControlTaskQueue queue;
+    CHECK(queue.is_valid());
+
+    TestExecutor::Task blocker;
+    TestCompleter blocker_completer;
+
+    TestExecutor::Task tasks[NumTasks];
+    TestCompleter completers[NumTasks];
+
+    // Order in which tasks should be executed.
+    size_t order[NumTasks];
+
+    blocker_completer.expect_success(true);
+    blocker_completer.expect_n_calls(1);
+
+    executor.block();
+
+    executor.set_nth_result(0, true);
+    queue.schedule(blocker, executor, &blocker_completer);
+
+    executor.wait_blocked();
+
+    const core::nanoseconds_t base = now_plus_delay(core::Millisecond * 20);
+
+    core::nanoseconds_t deadlines[NumTasks];
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        // Stride is coprime with NumTasks, so ranks are a permutation.
+        const size_t rank = n * Stride % NumTasks;
+        order[rank] = n;
+
+        deadlines[n] = base + core::Microsecond * 10 * core::nanoseconds_t(rank);
+
+        completers[n].expect_success(true);
+        completers[n].expect_n_calls(1);
+
+        executor.set_nth_result(rank + 1, true);
+
+        if (n % 2 == 0) {
+            // Will be re-scheduled below.
+            queue.schedule_at(tasks[n], deadlines[n] + core::Second, executor,
+                              &completers[n]);
+        } else {
+            queue.schedule_at(tasks[n], deadlines[n], executor, &completers[n]);
+        }
+    }
+
+    executor.unblock_one();
+    CHECK(blocker_completer.wait_called() == &blocker);
+
+    // Re-schedule tasks while they're likely in sleeping queue,
+    // so that they're removed from the middle of it.
+    for (size_t n = 0; n < NumTasks; n += 2) {
+        queue.schedule_at(tasks[n], deadlines[n], executor, &completers[n]);
+    }
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        executor.unblock_one();
+
+        CHECK(completers[order[n]].wait_called() == &tasks[order[n]]);
+
+        UNSIGNED_LONGS_EQUAL(n + 2, executor.num_tasks());
+        CHECK(executor.nth_task(n + 1) == &tasks[order[n]]);
+
+        CHECK(tasks[order[n]].succeeded());
+    }
+
+    executor.check_all_unblocked();
+}
+
 TEST(task_queue, schedule_at_and_schedule) {
     TestExecutor executor;
 
@@ -1324,6 +1405,47 @@ TEST(task_queue, reschedule_cancelled) {
     UNSIGNED_LONGS_EQUAL(1, executor.num_tasks());
 }
 
+TEST(task_queue, pause_and_resume_many) {
+    enum { NumPauses = 5 };
+
+    TestExecutor executor;
+
+    ControlTaskQueue queue;
+    CHECK(queue.is_valid());
+
+    TestCompleter completer;
+    completer.expect_success(true);
+    completer.expect_cancelled(false);
+    completer.expect_n_calls(1);
+
+    TestExecutor::Task task;
+
+    for (size_t n = 0; n < NumPauses; n++) {
+        executor.set_nth_paused(n);
+    }
+    executor.set_nth_result(NumPauses, true);
+
+    queue.schedule(task, executor, &completer);
+
+    // Task pauses after every execution, and every resume executes it
+    // again, no matter if it's called during or after execution.
+    for (size_t n = 1; n <= NumPauses; n++) {
+        while (executor.num_tasks() < n) {
+            core::sleep_for(core::ClockMonotonic, core::Microsecond * 10);
+        }
+        queue.resume(task);
+    }
+
+    queue.wait(task);
+
+    CHECK(task.succeeded());
+    CHECK(!task.cancelled());
+
+    CHECK(completer.wait_called() == &task);
+
+    UNSIGNED_LONGS_EQUAL(NumPauses + 1, executor.num_tasks());
+}
+
 TEST(task_queue, no_starvation) {
     TestExecutor executor;
 
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+namespace {
+
+enum { MaxPayloadSize = 1280, MaxPackets = 128 };
+
+enum LossPattern {
+    // One source packet is lost.
+    Loss_Single,
+    // Consecutive source packets are lost, half of repair packets count.
+    Loss_Half,
+    // Consecutive source packets are lost, as many as repair packets.
+    Loss_Max
+};
+
+const char* loss_pattern_to_str(LossPattern loss) {
+    switch (loss) {
+    case Loss_Single:
+        return "single";
+    case Loss_Half:
+        return "half";
+    case Loss_Max:
+        return "max";
+    }
+    return "<invalid>";
+}
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxPayloadSize);
+
+core::Slice<uint8_t> buffers[MaxPackets];
+
+void fill_buffers(size_t n_packets, size_t payload_size) {
+    for (size_t i = 0; i < n_packets; i++) {
+        buffers[i] = packet_factory.new_packet_buffer();
+        buffers[i].reslice(0, payload_size);
+        for (size_t n = 0; n < payload_size; n++) {
+            buffers[i].data()[n] = (uint8_t)core::fast_random_range(0, 0xff);
+        }
+    }
+}
+
+void encode_block(IBlockEncoder& encoder,
+                  size_t n_source,
+                  size_t n_repair,
+                  size_t payload_size) {
+    if (!encoder.begin(n_source, n_repair, payload_size)) {
+        roc_panic("bench_fec_codec: can't begin encoder block");
+    }
+    for (size_t i = 0; i < n_source + n_repair; i++) {
+        encoder.set(i, buffers[i]);
+    }
+    encoder.fill();
+    encoder.end();
+}
+
+size_t num_lost(LossPattern loss, size_t n_repair) {
+    switch (loss) {
+    case Loss_Single:
+        return 1;
+    case Loss_Half:
+        return std::max(n_repair / 2, (size_t)1);
+    case Loss_Max:
+        return n_repair;
+    }
+    return 0;
+}
+
+void BM_FecCodec_Encode(benchmark::State& state) {
+    const packet::FecScheme scheme = (packet::FecScheme)state.range(0);
+    const size_t n_source = (size_t)state.range(1);
+    const size_t n_repair = (size_t)state.range(2);
+    const size_t payload_size = (size_t)state.range(3);
+
+    if (!CodecMap::instance().is_supported(scheme)) {
+        state.SkipWithError("scheme not supported");
+        return;
+    }
+
+    CodecConfig config;
+    config.scheme = scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, packet_factory, arena), arena);
+    if (!encoder) {
+        state.SkipWithError("can't create encoder");
+        return;
+    }
+    if (n_source + n_repair > encoder->max_block_length()) {
+        state.SkipWithError("block too large for scheme");
+        return;
+    }
+
+    fill_buffers(n_source + n_repair, payload_size);
+
+    while (state.KeepRunning()) {
+        encode_block(*encoder, n_source, n_repair, payload_size);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(packet::fec_scheme_to_str(scheme));
+    state.SetBytesProcessed(state.iterations() * (int64_t)(n_source * payload_size));
+}
+
+void BM_FecCodec_Repair(benchmark::State& state) {
+    const packet::FecScheme scheme = (packet::FecScheme)state.range(0);
+    const size_t n_source = (size_t)state.range(1);
+    const size_t n_repair = (size_t)state.range(2);
+    const size_t payload_size = (size_t)state.range(3);
+    const LossPattern loss = (LossPattern)state.range(4);
+
+    if (!CodecMap::instance().is_supported(scheme)) {
+        state.SkipWithError("scheme not supported");
+        return;
+    }
+
+    CodecConfig config;
+    config.scheme = scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, packet_factory, arena), arena);
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(config, packet_factory, arena), arena);
+    if (!encoder || !decoder) {
+        state.SkipWithError("can't create codec");
+        return;
+    }
+    if (n_source + n_repair > encoder->max_block_length()
+        || n_source + n_repair > decoder->max_block_length()) {
+        state.SkipWithError("block too large for scheme");
+        return;
+    }
+
+    fill_buffers(n_source + n_repair, payload_size);
+    encode_block(*encoder, n_source, n_repair, payload_size);
+
+    // lose consecutive source packets in the middle of the block
+    const size_t n_lost = num_lost(loss, n_repair);
+    const size_t first_lost = (n_source - n_lost) / 2;
+
+    size_t n_blocks = 0;
+    size_t n_failed = 0;
+
+    while (state.KeepRunning()) {
+        if (!decoder->begin(n_source, n_repair, payload_size)) {
+            roc_panic("bench_fec_codec: can't begin decoder block");
+        }
+        for (size_t i = 0; i < n_source + n_repair; i++) {
+            if (i >= first_lost && i < first_lost + n_lost) {
+                continue;
+            }
+            decoder->set(i, buffers[i]);
+        }
+        for (size_t i = first_lost; i < first_lost + n_lost; i++) {
+            core::Slice<uint8_t> repaired = decoder->repair(i);
+            if (!repaired) {
+                n_failed++;
+            }
+            benchmark::DoNotOptimize(repaired.data());
+        }
+        decoder->end();
+        n_blocks++;
+    }
+
+    state.SetLabel(std::string(packet::fec_scheme_to_str(scheme)) + " loss="
+                   + loss_pattern_to_str(loss));
+    state.SetBytesProcessed(state.iterations() * (int64_t)(n_source * payload_size));
+
+    state.counters["lost"] = (double)n_lost;
+    state.counters["fail_rate"] =
+        n_blocks ? (double)n_failed / (double)(n_blocks * n_lost) : 0;
+}
+
+const int schemes[] = { packet::FEC_ReedSolomon_M8, packet::FEC_LDPC_Staircase };
+
+// source and repair packets per block
+const int blocks[][2] = { { 10, 5 }, { 20, 10 }, { 40, 20 }, { 80, 40 } };
+
+const int payloads[] = { 256, 1280 };
+
+const int losses[] = { Loss_Single, Loss_Half, Loss_Max };
+
+void encode_args(benchmark::internal::Benchmark* b) {
+    std::vector<std::string> names;
+    names.push_back("scheme");
+    names.push_back("src");
+    names.push_back("rpr");
+    names.push_back("payload");
+    b->ArgNames(names);
+
+    for (size_t n_sch = 0; n_sch < ROC_ARRAY_SIZE(schemes); n_sch++) {
+        for (size_t n_blk = 0; n_blk < ROC_ARRAY_SIZE(blocks); n_blk++) {
+            for (size_t n_pl = 0; n_pl < ROC_ARRAY_SIZE(payloads); n_pl++) {
+                std::vector<int64_t> args;
+                args.push_back(schemes[n_sch]);
+                args.push_back(blocks[n_blk][0]);
+                args.push_back(blocks[n_blk][1]);
+                args.push_back(payloads[n_pl]);
+                b->Args(args);
+            }
+        }
+    }
+}
+
+void repair_args(benchmark::internal::Benchmark* b) {
+    std::vector<std::string> names;
+    names.push_back("scheme");
+    names.push_back("src");
+    names.push_back("rpr");
+    names.push_back("payload");
+    names.push_back("loss");
+    b->ArgNames(names);
+
+    for (size_t n_sch = 0; n_sch < ROC_ARRAY_SIZE(schemes); n_sch++) {
+        for (size_t n_blk = 0; n_blk < ROC_ARRAY_SIZE(blocks); n_blk++) {
+            for (size_t n_pl = 0; n_pl < ROC_ARRAY_SIZE(payloads); n_pl++) {
+                for (size_t n_ls = 0; n_ls < ROC_ARRAY_SIZE(losses); n_ls++) {
+                    std::vector<int64_t> args;
+                    args.push_back(schemes[n_sch]);
+                    args.push_back(blocks[n_blk][0]);
+                    args.push_back(blocks[n_blk][1]);
+                    args.push_back(payloads[n_pl]);
+                    args.push_back(losses[n_ls]);
+                    b->Args(args);
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_FecCodec_Encode)->Apply(encode_args)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_FecCodec_Repair)->Apply(repair_args)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_fec/gf256_kernel.h"
+#include "roc_fec/rs8m_encoder.h"
+
+namespace roc {
+namespace fec {
+namespace {
+
+enum { PayloadSize = 1024, NumSourcePackets = 20, NumRepairPackets = 10 };
+
+uint8_t src_buf[PayloadSize];
+uint8_t dst_buf[PayloadSize];
+
+void BM_Gf256Kernel(benchmark::State& state) {
+    const Gf256Kernel kernel = (Gf256Kernel)state.range(0);
+
+    Gf256KernelFunc func = gf256_kernel_func(kernel);
+    if (!func) {
+        state.SkipWithError("kernel not supported");
+        return;
+    }
+
+    for (size_t n = 0; n < PayloadSize; n++) {
+        src_buf[n] = (uint8_t)core::fast_random_range(0, 0xff);
+        dst_buf[n] = (uint8_t)core::fast_random_range(0, 0xff);
+    }
+
+    while (state.KeepRunning()) {
+        func(dst_buf, src_buf, 0x53, PayloadSize);
+        benchmark::DoNotOptimize(dst_buf);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(gf256_kernel_to_str(kernel));
+    state.SetBytesProcessed(state.iterations() * PayloadSize);
+}
+
+BENCHMARK(BM_Gf256Kernel)
+    ->Arg(Gf256Kernel_Scalar)
+    ->Arg(Gf256Kernel_SSSE3)
+    ->Arg(Gf256Kernel_AVX2)
+    ->Arg(Gf256Kernel_NEON);
+
+void BM_Rs8mEncoder(benchmark::State& state) {
+    core::HeapArena arena;
+    packet::PacketFactory packet_factory(arena, PayloadSize);
+
+    CodecConfig config;
+    config.scheme = packet::FEC_ReedSolomon_M8;
+
+    Rs8mEncoder encoder(config, packet_factory, arena);
+    if (!encoder.is_valid()) {
+        state.SkipWithError("encoder not valid");
+        return;
+    }
+
+    core::Slice<uint8_t> buffers[NumSourcePackets + NumRepairPackets];
+    for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; i++) {
+        buffers[i] = packet_factory.new_packet_buffer();
+        buffers[i].reslice(0, PayloadSize);
+        for (size_t n = 0; n < PayloadSize; n++) {
+            buffers[i].data()[n] = (uint8_t)core::fast_random_range(0, 0xff);
+        }
+    }
+
+    while (state.KeepRunning()) {
+        encoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize);
+        for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; i++) {
+            encoder.set(i, buffers[i]);
+        }
+        encoder.fill();
+        encoder.end();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Rs8mEncoder)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace fec
+} // namespace roc
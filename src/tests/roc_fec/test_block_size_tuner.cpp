@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/time.h"
+#include "roc_fec/block_size_tuner.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t SourcePackets = 20;
+const size_t RepairPackets = 10;
+const size_t MaxBlockLength = 255;
+
+const core::nanoseconds_t ReportInterval = 100 * core::Millisecond;
+
+} // namespace
+
+TEST_GROUP(block_size_tuner) {
+    BlockSizeTunerConfig config;
+    WriterConfig writer_config;
+
+    void setup() {
+        config.min_repair_packets = 1;
+        config.redundancy_margin = 2.0f;
+        config.loss_smoothing = 1.0f;
+        config.decrease_hold = core::Second;
+        config.report_timeout = core::Second;
+        config.congestion_delay = 50 * core::Millisecond;
+        config.min_rtt_window = 10 * core::Second;
+
+        writer_config.n_source_packets = SourcePackets;
+        writer_config.n_repair_packets = RepairPackets;
+    }
+
+    void check_sizes(const BlockSizeTuner& tuner, size_t sblen, size_t rblen) {
+        UNSIGNED_LONGS_EQUAL(sblen, tuner.source_packets());
+        UNSIGNED_LONGS_EQUAL(rblen, tuner.repair_packets());
+
+        const BlockSizeTunerMetrics metrics = tuner.metrics();
+        UNSIGNED_LONGS_EQUAL(sblen, metrics.source_packets);
+        UNSIGNED_LONGS_EQUAL(rblen, metrics.repair_packets);
+    }
+};
+
+TEST(block_size_tuner, initial) {
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    check_sizes(tuner, SourcePackets, RepairPackets);
+    UNSIGNED_LONGS_EQUAL(0, tuner.metrics().adjustments);
+
+    // No reports, nothing changes.
+    tuner.refresh(10 * core::Second);
+    check_sizes(tuner, SourcePackets, RepairPackets);
+}
+
+TEST(block_size_tuner, invalid_config) {
+    {
+        WriterConfig wc = writer_config;
+        wc.n_source_packets = 0;
+        BlockSizeTuner tuner(config, wc, MaxBlockLength);
+        CHECK(!tuner.is_valid());
+    }
+    {
+        BlockSizeTuner tuner(config, writer_config, SourcePackets + RepairPackets - 1);
+        CHECK(!tuner.is_valid());
+    }
+    {
+        BlockSizeTunerConfig tc = config;
+        tc.min_repair_packets = RepairPackets + 1;
+        BlockSizeTuner tuner(tc, writer_config, MaxBlockLength);
+        CHECK(!tuner.is_valid());
+    }
+    {
+        BlockSizeTunerConfig tc = config;
+        tc.loss_smoothing = 0;
+        BlockSizeTuner tuner(tc, writer_config, MaxBlockLength);
+        CHECK(!tuner.is_valid());
+    }
+}
+
+TEST(block_size_tuner, clean_link) {
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    // Protection is not reduced until hold period expires.
+    for (; ts < config.decrease_hold; ts += ReportInterval) {
+        tuner.update(0, 0, ts);
+        tuner.refresh(ts);
+        check_sizes(tuner, SourcePackets, RepairPackets);
+    }
+
+    tuner.update(0, 0, ts);
+    check_sizes(tuner, SourcePackets, config.min_repair_packets);
+
+    UNSIGNED_LONGS_EQUAL(1, tuner.metrics().adjustments);
+    DOUBLES_EQUAL(0, tuner.metrics().loss_rate, 1e-6);
+}
+
+TEST(block_size_tuner, loss_increase) {
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    for (; ts <= config.decrease_hold; ts += ReportInterval) {
+        tuner.update(0, 0, ts);
+    }
+    check_sizes(tuner, SourcePackets, 1);
+
+    // 5% loss with margin 2 requires 2 repair packets per 20 source packets.
+    // Increase is applied immediately.
+    tuner.update(0.05f, 0, ts);
+    check_sizes(tuner, SourcePackets, 2);
+
+    // 20% loss requires 8 repair packets.
+    tuner.update(0.20f, 0, ts + ReportInterval);
+    check_sizes(tuner, SourcePackets, 8);
+
+    DOUBLES_EQUAL(0.20, tuner.metrics().loss_rate, 1e-6);
+}
+
+TEST(block_size_tuner, high_loss) {
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    // 40% loss requires 16 repair packets per 20 source packets, which is
+    // more than maximum, so source block is reduced to 10/0.8=12 packets.
+    tuner.update(0.40f, 0, 0);
+    check_sizes(tuner, 12, RepairPackets);
+
+    // Source block is never smaller than repair block.
+    tuner.update(0.90f, 0, ReportInterval);
+    check_sizes(tuner, RepairPackets, RepairPackets);
+}
+
+TEST(block_size_tuner, decrease_delayed_by_rtt) {
+    const core::nanoseconds_t rtt = 500 * core::Millisecond;
+
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    // Hold period is extended by two RTTs.
+    for (; ts < config.decrease_hold + rtt * 2; ts += ReportInterval) {
+        tuner.update(0, rtt, ts);
+        check_sizes(tuner, SourcePackets, RepairPackets);
+    }
+
+    tuner.update(0, rtt, ts);
+    check_sizes(tuner, SourcePackets, 1);
+}
+
+TEST(block_size_tuner, smoothing) {
+    config.loss_smoothing = 0.5f;
+
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    for (; ts <= config.decrease_hold; ts += ReportInterval) {
+        tuner.update(0, 0, ts);
+    }
+    check_sizes(tuner, SourcePackets, 1);
+
+    // Loss grows, protection follows raw loss immediately.
+    tuner.update(0.20f, 0, ts);
+    DOUBLES_EQUAL(0.10, tuner.metrics().loss_rate, 1e-6);
+    check_sizes(tuner, SourcePackets, 8);
+
+    // Loss drops, but smoothed estimate decays slowly, and decrease is held.
+    ts += ReportInterval;
+    tuner.update(0, 0, ts);
+    DOUBLES_EQUAL(0.05, tuner.metrics().loss_rate, 1e-6);
+    check_sizes(tuner, SourcePackets, 8);
+
+    // After hold period, protection follows smoothed estimate.
+    ts += config.decrease_hold;
+    tuner.update(0, 0, ts);
+    DOUBLES_EQUAL(0.025, tuner.metrics().loss_rate, 1e-6);
+    check_sizes(tuner, SourcePackets, 1);
+}
+
+TEST(block_size_tuner, report_timeout) {
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    for (; ts <= config.decrease_hold; ts += ReportInterval) {
+        tuner.update(0, 0, ts);
+    }
+    check_sizes(tuner, SourcePackets, 1);
+
+    const core::nanoseconds_t last_report = ts - ReportInterval;
+
+    tuner.refresh(last_report + config.report_timeout - 1);
+    check_sizes(tuner, SourcePackets, 1);
+
+    // Without reports, fall back to configured protection.
+    tuner.refresh(last_report + config.report_timeout);
+    check_sizes(tuner, SourcePackets, RepairPackets);
+
+    UNSIGNED_LONGS_EQUAL(2, tuner.metrics().adjustments);
+}
+
+TEST(block_size_tuner, congestion) {
+    const core::nanoseconds_t rtt = 100 * core::Millisecond;
+
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    for (; ts <= config.decrease_hold + rtt * 2; ts += ReportInterval) {
+        tuner.update(0, rtt, ts);
+    }
+    check_sizes(tuner, SourcePackets, 1);
+
+    tuner.update(0.05f, rtt, ts);
+    check_sizes(tuner, SourcePackets, 2);
+    CHECK(!tuner.metrics().congested);
+
+    // RTT grows above minimum, loss grows too, but protection isn't increased.
+    ts += ReportInterval;
+    tuner.update(0.20f, rtt + config.congestion_delay, ts);
+    check_sizes(tuner, SourcePackets, 2);
+    CHECK(tuner.metrics().congested);
+    LONGS_EQUAL(config.congestion_delay, tuner.metrics().queuing_delay);
+    UNSIGNED_LONGS_EQUAL(1, tuner.metrics().congestion_events);
+
+    // Loss drops, protection is reduced without waiting for hold period.
+    ts += ReportInterval;
+    tuner.update(0, rtt + config.congestion_delay, ts);
+    check_sizes(tuner, SourcePackets, 1);
+
+    // Queue drains, loss is handled as usual again.
+    ts += ReportInterval;
+    tuner.update(0.20f, rtt, ts);
+    check_sizes(tuner, SourcePackets, 8);
+    CHECK(!tuner.metrics().congested);
+    LONGS_EQUAL(0, tuner.metrics().queuing_delay);
+    UNSIGNED_LONGS_EQUAL(1, tuner.metrics().congestion_events);
+}
+
+TEST(block_size_tuner, congestion_disabled) {
+    const core::nanoseconds_t rtt = 100 * core::Millisecond;
+
+    config.congestion_delay = 0;
+
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    for (; ts <= config.decrease_hold + rtt * 2; ts += ReportInterval) {
+        tuner.update(0, rtt, ts);
+    }
+    check_sizes(tuner, SourcePackets, 1);
+
+    tuner.update(0.20f, rtt * 10, ts);
+    check_sizes(tuner, SourcePackets, 8);
+    CHECK(!tuner.metrics().congested);
+}
+
+TEST(block_size_tuner, min_rtt_window) {
+    const core::nanoseconds_t rtt = 100 * core::Millisecond;
+    const core::nanoseconds_t new_rtt = rtt + config.congestion_delay * 2;
+
+    BlockSizeTuner tuner(config, writer_config, MaxBlockLength);
+    CHECK(tuner.is_valid());
+
+    core::nanoseconds_t ts = 0;
+
+    tuner.update(0, rtt, ts);
+    CHECK(!tuner.metrics().congested);
+
+    // Route changed and RTT grew for good. It is first seen as congestion,
+    // until old minimum leaves both windows.
+    for (ts += ReportInterval; ts < config.min_rtt_window * 2; ts += ReportInterval) {
+        tuner.update(0, new_rtt, ts);
+        CHECK(tuner.metrics().congested);
+    }
+
+    tuner.update(0, new_rtt, ts);
+    CHECK(!tuner.metrics().congested);
+    UNSIGNED_LONGS_EQUAL(1, tuner.metrics().congestion_events);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/fast_random.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/stddefs.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/gf256_kernel.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { MaxBytes = 301 };
+
+// Reference multiplication: shift-and-add with reduction by 0x11D.
+uint8_t slow_mul(uint8_t a, uint8_t b) {
+    unsigned r = 0, x = a;
+    for (; b != 0; b >>= 1) {
+        if (b & 1) {
+            r ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+    return (uint8_t)r;
+}
+
+void check_kernel(Gf256Kernel kernel, size_t size, uint8_t coef) {
+    Gf256KernelFunc scalar_func = gf256_kernel_func(Gf256Kernel_Scalar);
+    Gf256KernelFunc kernel_func = gf256_kernel_func(kernel);
+
+    CHECK(scalar_func);
+    CHECK(kernel_func);
+
+    uint8_t src[MaxBytes];
+    uint8_t expected_dst[MaxBytes];
+    uint8_t actual_dst[MaxBytes];
+
+    for (size_t n = 0; n < size; n++) {
+        src[n] = (uint8_t)core::fast_random_range(0, 0xff);
+        expected_dst[n] = actual_dst[n] = (uint8_t)core::fast_random_range(0, 0xff);
+    }
+
+    scalar_func(expected_dst, src, coef, size);
+    kernel_func(actual_dst, src, coef, size);
+
+    for (size_t n = 0; n < size; n++) {
+        UNSIGNED_LONGS_EQUAL(expected_dst[n], actual_dst[n]);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(gf256_kernel) {};
+
+TEST(gf256_kernel, mul) {
+    for (unsigned a = 0; a < 256; a++) {
+        for (unsigned b = 0; b < 256; b++) {
+            UNSIGNED_LONGS_EQUAL(slow_mul((uint8_t)a, (uint8_t)b),
+                                 gf256_mul((uint8_t)a, (uint8_t)b));
+        }
+    }
+}
+
+TEST(gf256_kernel, inv) {
+    for (unsigned a = 1; a < 256; a++) {
+        UNSIGNED_LONGS_EQUAL(1, gf256_mul((uint8_t)a, gf256_inv((uint8_t)a)));
+    }
+}
+
+TEST(gf256_kernel, invert_matrix) {
+    enum { N = 5 };
+
+    uint8_t matrix[N * N];
+    uint8_t inverse[N * N];
+    uint8_t work[N * N];
+
+    // Vandermonde matrix with distinct elements is invertible.
+    for (size_t row = 0; row < N; row++) {
+        for (size_t col = 0; col < N; col++) {
+            matrix[row * N + col] = gf256_exp(row * col);
+        }
+    }
+
+    memcpy(inverse, matrix, sizeof(matrix));
+    CHECK(gf256_invert_matrix(inverse, work, N));
+
+    for (size_t row = 0; row < N; row++) {
+        for (size_t col = 0; col < N; col++) {
+            uint8_t v = 0;
+            for (size_t i = 0; i < N; i++) {
+                v ^= gf256_mul(matrix[row * N + i], inverse[i * N + col]);
+            }
+            UNSIGNED_LONGS_EQUAL(row == col ? 1 : 0, v);
+        }
+    }
+
+    // Matrix with two equal rows is singular.
+    for (size_t col = 0; col < N; col++) {
+        matrix[N + col] = matrix[col];
+    }
+    CHECK(!gf256_invert_matrix(matrix, work, N));
+}
+
+TEST(gf256_kernel, scalar_always_supported) {
+    CHECK(gf256_kernel_func(Gf256Kernel_Scalar));
+}
+
+TEST(gf256_kernel, best_supported) {
+    CHECK(gf256_kernel_func(gf256_kernel_best()));
+}
+
+TEST(gf256_kernel, scalar_muladd) {
+    Gf256KernelFunc func = gf256_kernel_func(Gf256Kernel_Scalar);
+
+    for (unsigned c = 0; c < 256; c++) {
+        uint8_t src[256];
+        uint8_t dst[256];
+
+        for (unsigned n = 0; n < 256; n++) {
+            src[n] = (uint8_t)n;
+            dst[n] = (uint8_t)(255 - n);
+        }
+
+        func(dst, src, (uint8_t)c, 256);
+
+        for (unsigned n = 0; n < 256; n++) {
+            UNSIGNED_LONGS_EQUAL((uint8_t)(255 - n) ^ slow_mul((uint8_t)c, (uint8_t)n),
+                                 dst[n]);
+        }
+    }
+}
+
+TEST(gf256_kernel, same_as_scalar) {
+    const size_t sizes[] = { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100, MaxBytes };
+    const uint8_t coefs[] = { 0, 1, 2, 0x0f, 0x10, 0x53, 0x8e, 0xff };
+
+    for (int k = 0; k < Gf256Kernel_Max; k++) {
+        const Gf256Kernel kernel = (Gf256Kernel)k;
+        if (!gf256_kernel_func(kernel)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < ROC_ARRAY_SIZE(sizes); i++) {
+            for (size_t j = 0; j < ROC_ARRAY_SIZE(coefs); j++) {
+                check_kernel(kernel, sizes[i], coefs[j]);
+            }
+            check_kernel(kernel, sizes[i], (uint8_t)core::fast_random_range(0, 0xff));
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
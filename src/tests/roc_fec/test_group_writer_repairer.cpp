@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/optional.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/group_repairer.h"
+#include "roc_fec/group_writer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/parser.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/encoding_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumStreams = 2, NumSourcePackets = 20, NumRepairPackets = 10 };
+
+const unsigned SourceIDs[NumStreams] = { 555, 556 };
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t FECPayloadSize = 193;
+
+const size_t MaxBuffSize = 500;
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxBuffSize);
+
+rtp::EncodingMap encoding_map(arena);
+rtp::Parser rtp_parser(encoding_map, NULL);
+
+Parser<RS8M_PayloadID, Source, Footer> source_parser(&rtp_parser);
+Parser<RS8M_PayloadID, Repair, Header> repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+Composer<RS8M_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<RS8M_PayloadID, Repair, Header> repair_composer(NULL);
+
+} // namespace
+
+TEST_GROUP(group_writer_repairer) {
+    CodecConfig codec_config;
+    WriterConfig writer_config;
+    GroupRepairerConfig repairer_config;
+
+    void setup() {
+        codec_config.scheme = packet::FEC_ReedSolomon_M8;
+
+        writer_config.n_source_packets = NumSourcePackets;
+        writer_config.n_repair_packets = NumRepairPackets;
+    }
+
+    // Packet number n of the group belongs to stream n % NumStreams.
+    packet::PacketPtr make_source_packet(size_t n) {
+        const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+        const size_t sn = n / NumStreams;
+
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = packet_factory.new_packet_buffer();
+        CHECK(bp);
+
+        CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+        pp->set_buffer(bp);
+
+        pp->add_flags(packet::Packet::FlagAudio | packet::Packet::FlagPrepared);
+
+        pp->rtp()->source_id = SourceIDs[n % NumStreams];
+        pp->rtp()->payload_type = PayloadType;
+        pp->rtp()->seqnum = packet::seqnum_t(sn);
+        pp->rtp()->stream_timestamp = packet::stream_timestamp_t(sn * 10);
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            pp->rtp()->payload.data()[i] = uint8_t(n + i);
+        }
+
+        return pp;
+    }
+
+    void check_restored_packet(const packet::PacketPtr& pp, size_t n) {
+        const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+        const size_t sn = n / NumStreams;
+
+        CHECK(pp);
+        CHECK(pp->has_flags(packet::Packet::FlagRestored));
+        CHECK(pp->has_flags(packet::Packet::FlagAudio));
+        CHECK(pp->rtp());
+        CHECK(!pp->fec());
+
+        UNSIGNED_LONGS_EQUAL(SourceIDs[n % NumStreams], pp->rtp()->source_id);
+        UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(sn * 10, pp->rtp()->stream_timestamp);
+        UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+
+        for (size_t i = 0; i < rtp_payload_size; i++) {
+            UNSIGNED_LONGS_EQUAL(uint8_t(n + i), pp->rtp()->payload.data()[i]);
+        }
+    }
+
+    // Re-parse composed packet, as receiver would.
+    packet::PacketPtr reparse_packet(const packet::PacketPtr& old_pp) {
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+
+        packet::IParser& parser = old_pp->has_flags(packet::Packet::FlagRepair)
+            ? (packet::IParser&)repair_parser
+            : (packet::IParser&)source_parser;
+
+        CHECK(parser.parse(*pp, old_pp->buffer()));
+        pp->set_buffer(old_pp->buffer());
+
+        return pp;
+    }
+};
+
+TEST(group_writer_repairer, no_losses) {
+    core::SharedPtr<GroupWriter> group =
+        new (arena) GroupWriter(writer_config, codec_config, packet_factory, arena);
+    CHECK(group);
+    CHECK(group->is_valid());
+
+    packet::Queue network_queues[NumStreams];
+
+    core::Optional<GroupWriterMember> members[NumStreams];
+    for (size_t n = 0; n < NumStreams; n++) {
+        members[n].reset(new (members[n]) GroupWriterMember(
+            group, network_queues[n], source_composer, repair_composer));
+    }
+
+    for (size_t n = 0; n < NumSourcePackets; n++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK,
+                             members[n % NumStreams]->write(make_source_packet(n)));
+    }
+
+    // Block is completed by last stream, so it sends repair packets.
+    UNSIGNED_LONGS_EQUAL(NumSourcePackets / NumStreams, network_queues[0].size());
+    UNSIGNED_LONGS_EQUAL(NumSourcePackets / NumStreams + NumRepairPackets,
+                         network_queues[1].size());
+
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+    CHECK(decoder);
+
+    packet::Queue restored_queue;
+    GroupRepairer repairer(repairer_config, codec_config.scheme, *decoder, rtp_parser,
+                           restored_queue, packet_factory, arena);
+    CHECK(repairer.is_valid());
+
+    for (size_t n = 0; n < NumStreams; n++) {
+        packet::PacketPtr pp;
+        while (network_queues[n].read(pp) == status::StatusOK) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, repairer.write(reparse_packet(pp)));
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, restored_queue.size());
+
+    UNSIGNED_LONGS_EQUAL(0, repairer.metrics().restored_packets);
+    UNSIGNED_LONGS_EQUAL(1, repairer.metrics().lossless_blocks);
+    UNSIGNED_LONGS_EQUAL(0, repairer.metrics().lost_blocks);
+
+    UNSIGNED_LONGS_EQUAL(1, group->metrics().encoded_blocks);
+}
+
+TEST(group_writer_repairer, losses_in_different_streams) {
+    core::SharedPtr<GroupWriter> group =
+        new (arena) GroupWriter(writer_config, codec_config, packet_factory, arena);
+    CHECK(group);
+    CHECK(group->is_valid());
+
+    packet::Queue network_queue;
+
+    core::Optional<GroupWriterMember> members[NumStreams];
+    for (size_t n = 0; n < NumStreams; n++) {
+        members[n].reset(new (members[n]) GroupWriterMember(
+            group, network_queue, source_composer, repair_composer));
+    }
+
+    for (size_t n = 0; n < NumSourcePackets; n++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK,
+                             members[n % NumStreams]->write(make_source_packet(n)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumSourcePackets + NumRepairPackets, network_queue.size());
+
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+    CHECK(decoder);
+
+    packet::Queue restored_queue;
+    GroupRepairer repairer(repairer_config, codec_config.scheme, *decoder, rtp_parser,
+                           restored_queue, packet_factory, arena);
+    CHECK(repairer.is_valid());
+
+    // Lose packets of both streams.
+    const size_t lost_packets[] = { 3, 8, 9 };
+
+    for (size_t n = 0; n < NumSourcePackets + NumRepairPackets; n++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, network_queue.read(pp));
+
+        if (n == lost_packets[0] || n == lost_packets[1] || n == lost_packets[2]) {
+            continue;
+        }
+
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, repairer.write(reparse_packet(pp)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(lost_packets), restored_queue.size());
+
+    for (size_t i = 0; i < ROC_ARRAY_SIZE(lost_packets); i++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, restored_queue.read(pp));
+        check_restored_packet(pp, lost_packets[i]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(lost_packets),
+                         repairer.metrics().restored_packets);
+    UNSIGNED_LONGS_EQUAL(0, repairer.metrics().lossless_blocks);
+    UNSIGNED_LONGS_EQUAL(0, repairer.metrics().lost_blocks);
+}
+
+TEST(group_writer_repairer, unrecoverable_block) {
+    core::SharedPtr<GroupWriter> group =
+        new (arena) GroupWriter(writer_config, codec_config, packet_factory, arena);
+    CHECK(group);
+    CHECK(group->is_valid());
+
+    packet::Queue network_queue;
+    GroupWriterMember member(group, network_queue, source_composer, repair_composer);
+
+    repairer_config.max_blocks = 1;
+
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+    CHECK(decoder);
+
+    packet::Queue restored_queue;
+    GroupRepairer repairer(repairer_config, codec_config.scheme, *decoder, rtp_parser,
+                           restored_queue, packet_factory, arena);
+    CHECK(repairer.is_valid());
+
+    for (size_t n = 0; n < NumSourcePackets * 2; n++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, member.write(make_source_packet(n)));
+    }
+
+    for (size_t n = 0; n < (NumSourcePackets + NumRepairPackets) * 2; n++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, network_queue.read(pp));
+
+        // Lose more packets of first block than can be repaired.
+        if (n < NumRepairPackets + 1) {
+            continue;
+        }
+
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, repairer.write(reparse_packet(pp)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, restored_queue.size());
+
+    UNSIGNED_LONGS_EQUAL(0, repairer.metrics().restored_packets);
+    UNSIGNED_LONGS_EQUAL(1, repairer.metrics().lossless_blocks);
+    UNSIGNED_LONGS_EQUAL(1, repairer.metrics().lost_blocks);
+}
+
+} // namespace fec
+} // namespace roc
@@ -30,6 +30,7 @@ public:
     PacketDispatcher(packet::IParser& source_parser,
                      packet::IParser& repair_parser,
                      packet::PacketFactory& packet_factory,
+                     core::IArena& arena,
                      size_t num_source,
                      size_t num_repair)
         : source_parser_(source_parser)
@@ -38,10 +39,10 @@ public:
         , num_source_(num_source)
         , num_repair_(num_repair)
         , packet_num_(0)
-        , source_queue_(0)
-        , source_stock_(0)
-        , repair_queue_(0)
-        , repair_stock_(0)
+        , source_queue_(arena, 0)
+        , source_stock_(arena, 0)
+        , repair_queue_(arena, 0)
+        , repair_stock_(arena, 0)
         , n_lost_(0)
         , n_delayed_(0) {
         reset();
@@ -218,6 +219,12 @@ private:
 
         pp->set_buffer(old_pp->buffer());
 
+        // Duration isn't stored in header, it's populated later by receiver
+        // pipeline. Here we just preserve it.
+        if (pp->rtp() && old_pp->rtp()) {
+            pp->rtp()->duration = old_pp->rtp()->duration;
+        }
+
         return pp;
     }
 
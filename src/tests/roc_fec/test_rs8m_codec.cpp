@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_fec/rs8m_encoder.h"
+#include "roc_fec/rs8m_matrix.h"
+
+#ifdef ROC_TARGET_OPENFEC
+#include "roc_fec/openfec_decoder.h"
+#include "roc_fec/openfec_encoder.h"
+#endif // ROC_TARGET_OPENFEC
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { MaxPayloadSize = 1024 };
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxPayloadSize);
+
+CodecConfig make_config() {
+    CodecConfig config;
+    config.scheme = packet::FEC_ReedSolomon_M8;
+    return config;
+}
+
+core::Slice<uint8_t> make_buffer(size_t size) {
+    core::Slice<uint8_t> buf = packet_factory.new_packet_buffer();
+    buf.reslice(0, size);
+    for (size_t i = 0; i < buf.size(); i++) {
+        buf.data()[i] = (uint8_t)core::fast_random_range(0, 0xff);
+    }
+    return buf;
+}
+
+void encode(Rs8mEncoder& encoder,
+            core::Array<core::Slice<uint8_t> >& buffers,
+            size_t n_source,
+            size_t n_repair,
+            size_t p_size) {
+    CHECK(buffers.resize(n_source + n_repair));
+    CHECK(encoder.begin(n_source, n_repair, p_size));
+
+    for (size_t i = 0; i < n_source + n_repair; i++) {
+        buffers[i] = make_buffer(p_size);
+        encoder.set(i, buffers[i]);
+    }
+
+    encoder.fill();
+    encoder.end();
+}
+
+#ifdef ROC_TARGET_OPENFEC
+
+void encode_repair(IBlockEncoder& encoder,
+                   const core::Array<core::Slice<uint8_t> >& source,
+                   core::Array<core::Slice<uint8_t> >& repair,
+                   size_t n_repair,
+                   size_t p_size) {
+    CHECK(repair.resize(n_repair));
+    CHECK(encoder.begin(source.size(), n_repair, p_size));
+
+    for (size_t i = 0; i < source.size(); i++) {
+        encoder.set(i, source[i]);
+    }
+    for (size_t i = 0; i < n_repair; i++) {
+        repair[i] = make_buffer(p_size);
+        encoder.set(source.size() + i, repair[i]);
+    }
+
+    encoder.fill();
+    encoder.end();
+}
+
+void decode_lost(IBlockDecoder& decoder,
+                 const core::Array<core::Slice<uint8_t> >& source,
+                 const core::Array<core::Slice<uint8_t> >& repair,
+                 size_t n_lost,
+                 size_t p_size) {
+    CHECK(decoder.begin(source.size(), repair.size(), p_size));
+
+    // Lose first n_lost source packets.
+    for (size_t i = n_lost; i < source.size(); i++) {
+        decoder.set(i, source[i]);
+    }
+    for (size_t i = 0; i < repair.size(); i++) {
+        decoder.set(source.size() + i, repair[i]);
+    }
+
+    for (size_t i = 0; i < source.size(); i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        UNSIGNED_LONGS_EQUAL(p_size, buf.size());
+        CHECK(memcmp(source[i].data(), buf.data(), p_size) == 0);
+    }
+
+    decoder.end();
+}
+
+#endif // ROC_TARGET_OPENFEC
+
+} // namespace
+
+TEST_GROUP(rs8m_codec) {};
+
+TEST(rs8m_codec, matrix) {
+    Rs8mMatrix matrix(arena);
+
+    // With two source symbols, repair symbol j is (1 + x) * s0 + x * s1,
+    // where x = alpha^(j+1).
+    CHECK(matrix.build(2, 2));
+
+    UNSIGNED_LONGS_EQUAL(2, matrix.sblen());
+    UNSIGNED_LONGS_EQUAL(2, matrix.rblen());
+
+    UNSIGNED_LONGS_EQUAL(0x03, matrix.repair_row(0)[0]);
+    UNSIGNED_LONGS_EQUAL(0x02, matrix.repair_row(0)[1]);
+    UNSIGNED_LONGS_EQUAL(0x05, matrix.repair_row(1)[0]);
+    UNSIGNED_LONGS_EQUAL(0x04, matrix.repair_row(1)[1]);
+
+    // With one source symbol, all repair symbols are copies.
+    CHECK(matrix.build(1, 3));
+
+    for (size_t r = 0; r < 3; r++) {
+        UNSIGNED_LONGS_EQUAL(1, matrix.repair_row(r)[0]);
+    }
+}
+
+TEST(rs8m_codec, matrix_invalid) {
+    Rs8mMatrix matrix(arena);
+
+    CHECK(!matrix.build(0, 10));
+    CHECK(!matrix.build(200, 56));
+
+    CHECK(matrix.build(200, 55));
+}
+
+TEST(rs8m_codec, lost_all_source) {
+    enum { NumSourcePackets = 10, NumRepairPackets = 10 };
+
+    Rs8mEncoder encoder(make_config(), packet_factory, arena);
+    Rs8mDecoder decoder(make_config(), packet_factory, arena);
+
+    CHECK(encoder.is_valid());
+    CHECK(decoder.is_valid());
+
+    core::Array<core::Slice<uint8_t> > buffers(arena);
+
+    for (size_t p_size = 1; p_size < 100; p_size++) {
+        encode(encoder, buffers, NumSourcePackets, NumRepairPackets, p_size);
+
+        CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, p_size));
+
+        for (size_t i = NumSourcePackets; i < NumSourcePackets + NumRepairPackets; i++) {
+            decoder.set(i, buffers[i]);
+        }
+
+        for (size_t i = 0; i < NumSourcePackets; i++) {
+            core::Slice<uint8_t> buf = decoder.repair(i);
+            CHECK(buf);
+            UNSIGNED_LONGS_EQUAL(p_size, buf.size());
+            CHECK(memcmp(buffers[i].data(), buf.data(), p_size) == 0);
+        }
+
+        decoder.end();
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, decoder.num_copied_bytes());
+}
+
+TEST(rs8m_codec, random_losses) {
+    enum {
+        NumSourcePackets = 20,
+        NumRepairPackets = 10,
+        PayloadSize = 333,
+        NumIterations = 50
+    };
+
+    Rs8mEncoder encoder(make_config(), packet_factory, arena);
+    Rs8mDecoder decoder(make_config(), packet_factory, arena);
+
+    core::Array<core::Slice<uint8_t> > buffers(arena);
+
+    for (size_t iter = 0; iter < NumIterations; iter++) {
+        encode(encoder, buffers, NumSourcePackets, NumRepairPackets, PayloadSize);
+
+        CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+        // RS is MDS: any NumRepairPackets losses are recoverable.
+        const size_t n_loss = core::fast_random_range(0, NumRepairPackets);
+        size_t n_lost = 0;
+
+        bool lost[NumSourcePackets + NumRepairPackets] = {};
+        while (n_lost < n_loss) {
+            const size_t i =
+                core::fast_random_range(0, NumSourcePackets + NumRepairPackets - 1);
+            if (!lost[i]) {
+                lost[i] = true;
+                n_lost++;
+            }
+        }
+
+        for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; i++) {
+            if (!lost[i]) {
+                decoder.set(i, buffers[i]);
+            }
+        }
+
+        for (size_t i = 0; i < NumSourcePackets; i++) {
+            core::Slice<uint8_t> buf = decoder.repair(i);
+            CHECK(buf);
+            CHECK(memcmp(buffers[i].data(), buf.data(), PayloadSize) == 0);
+        }
+
+        decoder.end();
+    }
+}
+
+TEST(rs8m_codec, not_enough_packets) {
+    enum { NumSourcePackets = 10, NumRepairPackets = 5, PayloadSize = 100 };
+
+    Rs8mEncoder encoder(make_config(), packet_factory, arena);
+    Rs8mDecoder decoder(make_config(), packet_factory, arena);
+
+    core::Array<core::Slice<uint8_t> > buffers(arena);
+    encode(encoder, buffers, NumSourcePackets, NumRepairPackets, PayloadSize);
+
+    CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+    // Lose 3 source packets and keep only 2 repair packets.
+    for (size_t i = 3; i < NumSourcePackets + 2; i++) {
+        decoder.set(i, buffers[i]);
+    }
+
+    for (size_t i = 0; i < 3; i++) {
+        CHECK(!decoder.repair(i));
+    }
+
+    // One more repair packet makes block recoverable.
+    decoder.set(NumSourcePackets + 4, buffers[NumSourcePackets + 4]);
+
+    for (size_t i = 0; i < NumSourcePackets; i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        CHECK(memcmp(buffers[i].data(), buf.data(), PayloadSize) == 0);
+    }
+
+    // Repair packets are not repaired.
+    CHECK(!decoder.repair(NumSourcePackets + 2));
+
+    decoder.end();
+}
+
+TEST(rs8m_codec, max_block) {
+    enum { NumSourcePackets = 200, NumRepairPackets = 55, PayloadSize = 64 };
+
+    Rs8mEncoder encoder(make_config(), packet_factory, arena);
+    Rs8mDecoder decoder(make_config(), packet_factory, arena);
+
+    UNSIGNED_LONGS_EQUAL(255, encoder.max_block_length());
+    UNSIGNED_LONGS_EQUAL(255, decoder.max_block_length());
+
+    core::Array<core::Slice<uint8_t> > buffers(arena);
+    encode(encoder, buffers, NumSourcePackets, NumRepairPackets, PayloadSize);
+
+    CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+    // Lose first NumRepairPackets source packets.
+    for (size_t i = NumRepairPackets; i < NumSourcePackets + NumRepairPackets; i++) {
+        decoder.set(i, buffers[i]);
+    }
+
+    for (size_t i = 0; i < NumSourcePackets; i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        CHECK(memcmp(buffers[i].data(), buf.data(), PayloadSize) == 0);
+    }
+
+    decoder.end();
+}
+
+TEST(rs8m_codec, unsupported_m) {
+    CodecConfig config = make_config();
+    config.rs_m = 16;
+
+    Rs8mEncoder encoder(config, packet_factory, arena);
+    Rs8mDecoder decoder(config, packet_factory, arena);
+
+    CHECK(!encoder.is_valid());
+    CHECK(!decoder.is_valid());
+}
+
+#ifdef ROC_TARGET_OPENFEC
+
+// Builtin codec and OpenFEC should produce same repair packets for same
+// source packets, and each decoder should repair packets using repair
+// packets produced by another encoder.
+TEST(rs8m_codec, openfec_interop) {
+    const size_t block_sizes[][2] = {
+        { 1, 1 }, { 2, 2 }, { 10, 5 }, { 18, 10 }, { 20, 30 }, { 200, 55 },
+    };
+    const size_t payload_sizes[] = { 1, 8, 33, 100, 333, 1000 };
+
+    Rs8mEncoder builtin_encoder(make_config(), packet_factory, arena);
+    Rs8mDecoder builtin_decoder(make_config(), packet_factory, arena);
+
+    OpenfecEncoder openfec_encoder(make_config(), packet_factory, arena);
+    OpenfecDecoder openfec_decoder(make_config(), packet_factory, arena);
+
+    CHECK(builtin_encoder.is_valid());
+    CHECK(builtin_decoder.is_valid());
+    CHECK(openfec_encoder.is_valid());
+    CHECK(openfec_decoder.is_valid());
+
+    for (size_t n_bs = 0; n_bs < ROC_ARRAY_SIZE(block_sizes); n_bs++) {
+        for (size_t n_ps = 0; n_ps < ROC_ARRAY_SIZE(payload_sizes); n_ps++) {
+            const size_t n_source = block_sizes[n_bs][0];
+            const size_t n_repair = block_sizes[n_bs][1];
+            const size_t p_size = payload_sizes[n_ps];
+
+            core::Array<core::Slice<uint8_t> > source(arena);
+            CHECK(source.resize(n_source));
+            for (size_t i = 0; i < n_source; i++) {
+                source[i] = make_buffer(p_size);
+            }
+
+            core::Array<core::Slice<uint8_t> > builtin_repair(arena);
+            core::Array<core::Slice<uint8_t> > openfec_repair(arena);
+
+            encode_repair(builtin_encoder, source, builtin_repair, n_repair, p_size);
+            encode_repair(openfec_encoder, source, openfec_repair, n_repair, p_size);
+
+            for (size_t i = 0; i < n_repair; i++) {
+                CHECK(memcmp(builtin_repair[i].data(), openfec_repair[i].data(),
+                             p_size)
+                      == 0);
+            }
+
+            const size_t n_lost = n_source < n_repair ? n_source : n_repair;
+
+            decode_lost(builtin_decoder, source, openfec_repair, n_lost, p_size);
+            decode_lost(openfec_decoder, source, builtin_repair, n_lost, p_size);
+        }
+    }
+}
+
+#endif // ROC_TARGET_OPENFEC
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "test_helpers/packet_dispatcher.h"
+
+#include "roc_core/heap_arena.h"
+#include "roc_fec/codec_map.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/parser.h"
+#include "roc_fec/sliding_reader.h"
+#include "roc_fec/sliding_writer.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/encoding_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t WindowSize = 20;
+const size_t NumRepairPackets = 10;
+
+// Sources and repairs written per window.
+const size_t CycleSize = WindowSize + NumRepairPackets;
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t FECPayloadSize = 193;
+
+const size_t MaxBuffSize = 500;
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, MaxBuffSize);
+
+rtp::EncodingMap encoding_map(arena);
+rtp::Parser rtp_parser(encoding_map, NULL);
+
+Parser<RLC_Source_PayloadID, Source, Footer> source_parser(&rtp_parser);
+Parser<RLC_Repair_PayloadID, Repair, Header> repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+Composer<RLC_Source_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<RLC_Repair_PayloadID, Repair, Header> repair_composer(NULL);
+
+packet::PacketPtr make_packet(size_t sn, size_t fec_payload_size = FECPayloadSize) {
+    const size_t rtp_payload_size = fec_payload_size - sizeof(rtp::Header);
+
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> bp = packet_factory.new_packet_buffer();
+    CHECK(bp);
+
+    CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+    pp->set_buffer(bp);
+
+    pp->add_flags(packet::Packet::FlagAudio | packet::Packet::FlagPrepared);
+
+    pp->rtp()->source_id = SourceID;
+    pp->rtp()->payload_type = PayloadType;
+    pp->rtp()->seqnum = packet::seqnum_t(sn);
+    pp->rtp()->stream_timestamp = packet::stream_timestamp_t(sn * 10);
+
+    for (size_t i = 0; i < rtp_payload_size; i++) {
+        pp->rtp()->payload.data()[i] = uint8_t(sn + i);
+    }
+
+    return pp;
+}
+
+void check_packet(const packet::PacketPtr& pp,
+                  size_t sn,
+                  bool restored,
+                  size_t fec_payload_size = FECPayloadSize) {
+    const size_t rtp_payload_size = fec_payload_size - sizeof(rtp::Header);
+
+    CHECK(pp);
+    CHECK(pp->rtp());
+
+    UNSIGNED_LONGS_EQUAL(SourceID, pp->rtp()->source_id);
+    UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+    UNSIGNED_LONGS_EQUAL(packet::stream_timestamp_t(sn * 10),
+                         pp->rtp()->stream_timestamp);
+    UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+
+    for (size_t i = 0; i < rtp_payload_size; i++) {
+        UNSIGNED_LONGS_EQUAL(uint8_t(sn + i), pp->rtp()->payload.data()[i]);
+    }
+
+    CHECK_EQUAL(restored, pp->has_flags(packet::Packet::FlagRestored));
+}
+
+} // namespace
+
+TEST_GROUP(sliding_writer_reader) {
+    WriterConfig writer_config;
+
+    void setup() {
+        writer_config.n_source_packets = WindowSize;
+        writer_config.n_repair_packets = NumRepairPackets;
+    }
+};
+
+TEST(sliding_writer_reader, codec_map) {
+    CHECK(CodecMap::instance().is_supported(packet::FEC_RLC));
+    CHECK(CodecMap::instance().is_sliding_window(packet::FEC_RLC));
+    CHECK(!CodecMap::instance().is_sliding_window(packet::FEC_ReedSolomon_M8));
+
+    for (size_t n = 0; n < CodecMap::instance().num_schemes(); n++) {
+        CHECK(CodecMap::instance().nth_scheme(n) != packet::FEC_RLC);
+    }
+}
+
+TEST(sliding_writer_reader, no_losses) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(make_packet(sn)));
+    }
+    dispatcher.push_stocks();
+
+    UNSIGNED_LONGS_EQUAL(WindowSize, dispatcher.source_size());
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        check_packet(pp, sn, false);
+    }
+
+    packet::PacketPtr pp;
+    UNSIGNED_LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+
+    UNSIGNED_LONGS_EQUAL(0, reader.metrics().restored_packets);
+}
+
+// Repair packet is written right after the source packets it protects,
+// so loss can be restored without waiting for other packets.
+TEST(sliding_writer_reader, restore_without_waiting) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    // Stream is: s0 s1 r0 s2 s3 r1 ...
+    dispatcher.lose(1);
+
+    for (size_t sn = 0; sn < 2; sn++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(make_packet(sn)));
+    }
+    dispatcher.push_stocks();
+
+    UNSIGNED_LONGS_EQUAL(1, dispatcher.source_size());
+    UNSIGNED_LONGS_EQUAL(1, dispatcher.repair_size());
+
+    for (size_t sn = 0; sn < 2; sn++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        check_packet(pp, sn, sn == 1);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, reader.metrics().restored_packets);
+}
+
+TEST(sliding_writer_reader, multiple_losses) {
+    enum { NumCycles = 10 };
+
+    // Positions in each cycle of 30 packets; sources and repairs are lost.
+    const size_t lost[] = { 1, 4, 5, 11, 17, 18, 25 };
+
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    for (size_t n = 0; n < sizeof(lost) / sizeof(lost[0]); n++) {
+        dispatcher.lose(lost[n]);
+    }
+
+    size_t sn = 0;
+
+    for (size_t cycle = 0; cycle < NumCycles; cycle++) {
+        for (size_t n = 0; n < WindowSize; n++) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(make_packet(sn++)));
+        }
+    }
+    dispatcher.push_stocks();
+
+    CHECK(dispatcher.source_size() + dispatcher.repair_size()
+          == NumCycles * (CycleSize - sizeof(lost) / sizeof(lost[0])));
+
+    for (size_t n = 0; n < sn; n++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        CHECK(pp);
+        UNSIGNED_LONGS_EQUAL(n, pp->rtp()->seqnum);
+        check_packet(pp, n, pp->has_flags(packet::Packet::FlagRestored));
+    }
+
+    packet::PacketPtr pp;
+    UNSIGNED_LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+
+    CHECK(reader.metrics().restored_packets > 0);
+}
+
+// When loss can't be restored, reader skips it.
+TEST(sliding_writer_reader, skip_unrepairable) {
+    writer_config.n_repair_packets = 0;
+
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, 0);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    dispatcher.lose(5);
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(make_packet(sn)));
+    }
+    dispatcher.push_stocks();
+
+    UNSIGNED_LONGS_EQUAL(0, dispatcher.repair_size());
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        if (sn == 5) {
+            continue;
+        }
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        check_packet(pp, sn, false);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, reader.metrics().restored_packets);
+}
+
+// Missing packet at the end of stream is not skipped until later
+// packets arrive, and is restored when repair packet arrives.
+TEST(sliding_writer_reader, wait_for_repair) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    // Stream is: s0 s1 r0 s2 s3 r1; s3 is lost, r1 is delayed.
+    dispatcher.lose(4);
+    dispatcher.delay(5);
+
+    for (size_t sn = 0; sn < 4; sn++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(make_packet(sn)));
+    }
+    dispatcher.push_stocks();
+
+    for (size_t sn = 0; sn < 3; sn++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        check_packet(pp, sn, false);
+    }
+
+    packet::PacketPtr pp;
+    UNSIGNED_LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+
+    dispatcher.push_delayed(5);
+
+    UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    check_packet(pp, 3, true);
+}
+
+// Window is restarted when payload size changes.
+TEST(sliding_writer_reader, payload_size_change) {
+    const size_t payload_sizes[] = { FECPayloadSize, FECPayloadSize + 50 };
+
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                         packet_factory, arena);
+    SlidingReader reader(dispatcher.source_reader(), dispatcher.repair_reader(),
+                         rtp_parser, packet_factory, arena);
+
+    CHECK(writer.is_valid());
+    CHECK(reader.is_valid());
+
+    // Last source packet of first size and third source packet of second size.
+    dispatcher.lose(13);
+    dispatcher.lose(18);
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        UNSIGNED_LONGS_EQUAL(status::StatusOK,
+                             writer.write(make_packet(sn, payload_sizes[sn / 10])));
+    }
+    dispatcher.push_stocks();
+
+    for (size_t sn = 0; sn < WindowSize; sn++) {
+        packet::PacketPtr pp;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(pp));
+        check_packet(pp, sn, sn == 9 || sn == 12, payload_sizes[sn / 10]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(2, reader.metrics().restored_packets);
+}
+
+TEST(sliding_writer_reader, invalid_window) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      arena, WindowSize, NumRepairPackets);
+
+    writer_config.n_source_packets = 0;
+    {
+        SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                             packet_factory, arena);
+        CHECK(!writer.is_valid());
+    }
+
+    writer_config.n_source_packets = RlcMaxWindow + 1;
+    {
+        SlidingWriter writer(writer_config, dispatcher, source_composer, repair_composer,
+                             packet_factory, arena);
+        CHECK(!writer.is_valid());
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/macro_helpers.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_fec/tinymt32.h"
+
+namespace roc {
+namespace fec {
+
+TEST_GROUP(tinymt32) {};
+
+// Sequence from reference implementation of RFC 8682 for seed 1.
+TEST(tinymt32, reference_sequence) {
+    const uint32_t expected[] = {
+        2545341989u, 981918433u, 3715302833u, 2387538352u, 3591001365u,
+    };
+
+    TinyMT32 prng(1);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(expected); n++) {
+        UNSIGNED_LONGS_EQUAL(expected[n], prng.next_u32());
+    }
+}
+
+TEST(tinymt32, same_seed) {
+    TinyMT32 a(12345), b(12345), c(12346);
+
+    bool differs = false;
+    for (size_t n = 0; n < 100; n++) {
+        const uint32_t va = a.next_u32();
+        UNSIGNED_LONGS_EQUAL(va, b.next_u32());
+        if (va != c.next_u32()) {
+            differs = true;
+        }
+    }
+    CHECK(differs);
+}
+
+TEST(tinymt32, rlc_coefficients_dense) {
+    enum { NumCoeffs = 200 };
+
+    for (uint32_t key = 0; key < 100; key++) {
+        uint8_t coeffs[NumCoeffs];
+        rlc_make_coefficients((uint16_t)key, RlcMaxDensity, coeffs, NumCoeffs);
+
+        for (size_t n = 0; n < NumCoeffs; n++) {
+            CHECK(coeffs[n] != 0);
+        }
+    }
+}
+
+TEST(tinymt32, rlc_coefficients_sparse) {
+    enum { NumCoeffs = 1600 };
+
+    uint8_t coeffs[NumCoeffs];
+    rlc_make_coefficients(1, 3, coeffs, NumCoeffs);
+
+    // With density threshold 3, about 4/16 of coefficients are non-zero.
+    size_t n_nonzero = 0;
+    for (size_t n = 0; n < NumCoeffs; n++) {
+        if (coeffs[n] != 0) {
+            n_nonzero++;
+        }
+    }
+    CHECK(n_nonzero > NumCoeffs / 8);
+    CHECK(n_nonzero < NumCoeffs / 2);
+}
+
+TEST(tinymt32, rlc_coefficients_prefix) {
+    enum { NumCoeffs = 50 };
+
+    // Coefficients of smaller window are prefix of coefficients of larger one.
+    uint8_t a[NumCoeffs], b[NumCoeffs / 2];
+    rlc_make_coefficients(777, RlcMaxDensity, a, NumCoeffs);
+    rlc_make_coefficients(777, RlcMaxDensity, b, NumCoeffs / 2);
+
+    for (size_t n = 0; n < NumCoeffs / 2; n++) {
+        UNSIGNED_LONGS_EQUAL(a[n], b[n]);
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -11,9 +11,12 @@
 #include "test_helpers/mock_arena.h"
 #include "test_helpers/packet_dispatcher.h"
 
+#include "roc_core/atomic.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/macro_helpers.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/composer.h"
 #include "roc_fec/headers.h"
@@ -60,6 +63,12 @@ Composer<RS8M_PayloadID, Repair, Header> rs8m_repair_composer(NULL);
 Composer<LDPC_Source_PayloadID, Source, Footer> ldpc_source_composer(&rtp_composer);
 Composer<LDPC_Repair_PayloadID, Repair, Header> ldpc_repair_composer(NULL);
 
+// Returns scheme different from given one, even if only one scheme is supported.
+packet::FecScheme other_scheme(packet::FecScheme scheme) {
+    return scheme == packet::FEC_ReedSolomon_M8 ? packet::FEC_LDPC_Staircase
+                                                : packet::FEC_ReedSolomon_M8;
+}
+
 class StatusReader : public packet::IReader {
 public:
     explicit StatusReader(status::StatusCode code)
@@ -74,6 +83,118 @@ private:
     status::StatusCode code_;
 };
 
+// Forwards calls to another encoder, but blocks fill() until unblocked.
+class BlockingEncoder : public IBlockEncoder {
+public:
+    explicit BlockingEncoder(IBlockEncoder& encoder)
+        : encoder_(encoder) {
+    }
+
+    void unblock() {
+        sem_.post();
+    }
+
+    virtual size_t alignment() const {
+        return encoder_.alignment();
+    }
+
+    virtual size_t max_block_length() const {
+        return encoder_.max_block_length();
+    }
+
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size) {
+        return encoder_.begin(sblen, rblen, payload_size);
+    }
+
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer) {
+        encoder_.set(index, buffer);
+    }
+
+    virtual void fill() {
+        sem_.wait();
+        encoder_.fill();
+    }
+
+    virtual void end() {
+        encoder_.end();
+    }
+
+private:
+    IBlockEncoder& encoder_;
+    core::Semaphore sem_;
+};
+
+// Forwards calls to another decoder, optionally blocks begin() until unblocked,
+// notifies when block is finished, and counts started blocks.
+class ControlledDecoder : public IBlockDecoder {
+public:
+    ControlledDecoder(IBlockDecoder& decoder, bool blocking)
+        : decoder_(decoder)
+        , blocking_(blocking)
+        , n_begins_(0) {
+    }
+
+    size_t num_begins() const {
+        return (size_t)n_begins_;
+    }
+
+    void unblock() {
+        begin_sem_.post();
+    }
+
+    // Waits until decoder finishes block.
+    // Worker thread passes block back to reader right after that, so we
+    // also give it a moment to do so.
+    void wait_end() {
+        end_sem_.wait();
+        core::sleep_for(core::ClockMonotonic, core::Millisecond * 10);
+    }
+
+    virtual size_t max_block_length() const {
+        return decoder_.max_block_length();
+    }
+
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size) {
+        if (blocking_) {
+            begin_sem_.wait();
+        }
+        n_begins_++;
+        return decoder_.begin(sblen, rblen, payload_size);
+    }
+
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer) {
+        decoder_.set(index, buffer);
+    }
+
+    virtual core::Slice<uint8_t> repair(size_t index) {
+        return decoder_.repair(index);
+    }
+
+    virtual void end() {
+        decoder_.end();
+        end_sem_.post();
+    }
+
+    virtual uint64_t num_copied_bytes() const {
+        return decoder_.num_copied_bytes();
+    }
+
+private:
+    IBlockDecoder& decoder_;
+    const bool blocking_;
+    core::Atomic<int> n_begins_;
+    core::Semaphore begin_sem_;
+    core::Semaphore end_sem_;
+};
+
+// Waits until all asynchronously encoded blocks are written.
+void wait_pending_blocks(Writer& writer) {
+    while (writer.metrics().pending_blocks != 0) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+        writer.flush();
+    }
+}
+
 } // namespace
 
 TEST_GROUP(writer_reader) {
@@ -234,7 +355,7 @@ TEST(writer_reader, no_losses) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -281,7 +402,7 @@ TEST(writer_reader, 1_loss) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -316,6 +437,412 @@ TEST(writer_reader, 1_loss) {
     }
 }
 
+TEST(writer_reader, zero_copy) {
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        UNSIGNED_LONGS_EQUAL(0, reader.metrics().restored_packets);
+
+        fill_all_packets(0);
+
+        dispatcher.lose(3);
+        dispatcher.lose(7);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+        }
+        dispatcher.push_stocks();
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p;
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+            CHECK(p);
+            check_audio_packet(p, i);
+
+            if (i == 3 || i == 7) {
+                check_restored(p, true);
+            } else {
+                check_restored(p, false);
+                // Received packet shares buffer with sent packet.
+                POINTERS_EQUAL(source_packets[i]->buffer().data(), p->buffer().data());
+            }
+
+            // Payload is a slice of packet buffer.
+            CHECK(p->payload().data() >= p->buffer().data());
+            CHECK(p->payload().data_end() <= p->buffer().data_end());
+        }
+
+        UNSIGNED_LONGS_EQUAL(2, reader.metrics().restored_packets);
+    }
+}
+
+TEST(writer_reader, lossless_blocks) {
+    enum { NumBlocks = 6, LostPacket = 7 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        ControlledDecoder controlled_decoder(*decoder, false);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, controlled_decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            // Every second block has a loss.
+            const bool has_loss = block_num % 2 == 1;
+            if (has_loss) {
+                dispatcher.lose(LostPacket);
+            }
+
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+            }
+            dispatcher.push_stocks();
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p;
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, has_loss && i == LostPacket);
+            }
+
+            dispatcher.reset();
+        }
+
+        const ReaderMetrics metrics = reader.metrics();
+
+        // Decoder was used only for blocks with losses.
+        UNSIGNED_LONGS_EQUAL(NumBlocks / 2, controlled_decoder.num_begins());
+
+        UNSIGNED_LONGS_EQUAL(NumBlocks / 2, metrics.restored_packets);
+        UNSIGNED_LONGS_EQUAL(NumBlocks / 2, metrics.lossless_blocks);
+        UNSIGNED_LONGS_EQUAL(NumBlocks / 2 * NumRepairPackets,
+                             metrics.skipped_repair_packets);
+    }
+}
+
+TEST(writer_reader, async_encoding) {
+    enum { NumBlocks = 10, MaxPendingBlocks = 2, LostPacket = 11 };
+
+    writer_config.max_pending_blocks = MaxPendingBlocks;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            dispatcher.lose(LostPacket);
+
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+            }
+            wait_pending_blocks(writer);
+            dispatcher.push_stocks();
+
+            UNSIGNED_LONGS_EQUAL(NumSourcePackets - 1, dispatcher.source_size());
+            UNSIGNED_LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p;
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, i == LostPacket);
+            }
+
+            dispatcher.reset();
+        }
+
+        const WriterMetrics metrics = writer.metrics();
+
+        UNSIGNED_LONGS_EQUAL(NumBlocks, metrics.encoded_blocks);
+        UNSIGNED_LONGS_EQUAL(0, metrics.dropped_blocks);
+        UNSIGNED_LONGS_EQUAL(0, metrics.pending_blocks);
+        CHECK(metrics.encoding_lag > 0);
+        CHECK(metrics.max_encoding_lag >= metrics.encoding_lag);
+    }
+}
+
+TEST(writer_reader, async_encoding_lag) {
+    enum { MaxPendingBlocks = 1 };
+
+    writer_config.max_pending_blocks = MaxPendingBlocks;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+
+        BlockingEncoder blocking_encoder(*encoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, blocking_encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        CHECK(writer.is_valid());
+
+        // First block is submitted to encoder, which is blocked.
+        fill_all_packets(0);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, writer.metrics().pending_blocks);
+
+        // Second block doesn't fit into queue, source packets are written
+        // anyway, and repair packets are dropped.
+        fill_all_packets(NumSourcePackets);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+        }
+
+        dispatcher.push_stocks();
+
+        UNSIGNED_LONGS_EQUAL(NumSourcePackets * 2, dispatcher.source_size());
+        UNSIGNED_LONGS_EQUAL(0, dispatcher.repair_size());
+
+        UNSIGNED_LONGS_EQUAL(0, writer.metrics().encoded_blocks);
+        UNSIGNED_LONGS_EQUAL(1, writer.metrics().dropped_blocks);
+        UNSIGNED_LONGS_EQUAL(1, writer.metrics().pending_blocks);
+
+        // Repair packets of first block are written when encoder is unblocked.
+        blocking_encoder.unblock();
+        wait_pending_blocks(writer);
+
+        dispatcher.push_stocks();
+
+        UNSIGNED_LONGS_EQUAL(NumSourcePackets * 2, dispatcher.source_size());
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+        UNSIGNED_LONGS_EQUAL(1, writer.metrics().encoded_blocks);
+        UNSIGNED_LONGS_EQUAL(1, writer.metrics().dropped_blocks);
+        UNSIGNED_LONGS_EQUAL(0, writer.metrics().pending_blocks);
+    }
+}
+
+TEST(writer_reader, async_decoding) {
+    enum { NumBlocks = 10, MaxPendingBlocks = 2, LostPacket = 11 };
+
+    reader_config.max_pending_blocks = MaxPendingBlocks;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        ControlledDecoder controlled_decoder(*decoder, false);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, controlled_decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            dispatcher.lose(LostPacket);
+
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+            }
+            dispatcher.push_stocks();
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p;
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, i == LostPacket);
+
+                if (i == 0) {
+                    // Whole block was received, so decoding was started
+                    // when reading first packet.
+                    controlled_decoder.wait_end();
+                }
+            }
+
+            dispatcher.reset();
+        }
+
+        const ReaderMetrics metrics = reader.metrics();
+
+        UNSIGNED_LONGS_EQUAL(NumBlocks, metrics.restored_packets);
+        UNSIGNED_LONGS_EQUAL(0, metrics.late_packets);
+        UNSIGNED_LONGS_EQUAL(0, metrics.pending_blocks);
+        CHECK(metrics.max_decoding_lag > 0);
+    }
+}
+
+TEST(writer_reader, async_decoding_late) {
+    enum { MaxPendingBlocks = 1, LostPacket1 = 5, LostPacket2 = 15 };
+
+    reader_config.max_pending_blocks = MaxPendingBlocks;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        ControlledDecoder controlled_decoder(*decoder, true);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, controlled_decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        dispatcher.lose(LostPacket1);
+        dispatcher.lose(LostPacket2);
+
+        fill_all_packets(0);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+        }
+        dispatcher.push_stocks();
+
+        // Decoder is blocked, so first lost packet is skipped.
+        for (size_t i = 0; i < LostPacket1 + 1; ++i) {
+            packet::PacketPtr p;
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+            CHECK(p);
+            if (i < LostPacket1) {
+                check_audio_packet(p, i);
+            } else {
+                check_audio_packet(p, i + 1);
+            }
+            check_restored(p, false);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, reader.metrics().pending_blocks);
+
+        controlled_decoder.unblock();
+        controlled_decoder.wait_end();
+
+        // Second lost packet is restored in time.
+        for (size_t i = LostPacket1 + 2; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p;
+            UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, i == LostPacket2);
+        }
+
+        const ReaderMetrics metrics = reader.metrics();
+
+        UNSIGNED_LONGS_EQUAL(1, metrics.restored_packets);
+        UNSIGNED_LONGS_EQUAL(1, metrics.late_packets);
+        UNSIGNED_LONGS_EQUAL(0, metrics.pending_blocks);
+    }
+}
+
 TEST(writer_reader, lost_first_packet_in_first_block) {
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
@@ -330,7 +857,7 @@ TEST(writer_reader, lost_first_packet_in_first_block) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -388,7 +915,7 @@ TEST(writer_reader, lost_one_source_and_all_repair_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -460,7 +987,7 @@ TEST(writer_reader, multiple_blocks_1_loss) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -518,6 +1045,79 @@ TEST(writer_reader, multiple_blocks_1_loss) {
     }
 }
 
+TEST(writer_reader, late_block) {
+    enum { NumBlocks = 3, LostPacket = 11, PacketDuration = 10 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, packet_factory, arena), arena);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, packet_factory, arena), arena);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, arena, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory, arena);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, arena);
+
+        CHECK(writer.is_valid());
+        CHECK(reader.is_valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            const size_t first_sn = NumSourcePackets * block_num;
+
+            fill_all_packets(first_sn);
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                source_packets[i]->rtp()->duration = PacketDuration;
+            }
+
+            dispatcher.lose(LostPacket);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, writer.write(source_packets[i]));
+            }
+            dispatcher.push_stocks();
+
+            // In second block, playback position is already at the end of the block,
+            // so lost packet is not restored. In other blocks, playback position
+            // is before lost packet.
+            const size_t pos_sn = block_num == 1 ? first_sn + NumSourcePackets
+                                                 : first_sn + LostPacket;
+            reader.set_playback_position(
+                packet::stream_timestamp_t(pos_sn * PacketDuration));
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                if (block_num == 1 && i == LostPacket) {
+                    continue;
+                }
+
+                packet::PacketPtr p;
+                UNSIGNED_LONGS_EQUAL(status::StatusOK, reader.read(p));
+                CHECK(p);
+
+                check_audio_packet(p, first_sn + i);
+                check_restored(p, i == LostPacket);
+            }
+
+            dispatcher.reset();
+        }
+
+        UNSIGNED_LONGS_EQUAL(NumBlocks - 1, reader.metrics().restored_packets);
+        UNSIGNED_LONGS_EQUAL(1, reader.metrics().late_blocks);
+    }
+}
+
 TEST(writer_reader, multiple_blocks_in_queue) {
     enum { NumBlocks = 3 };
 
@@ -534,7 +1134,7 @@ TEST(writer_reader, multiple_blocks_in_queue) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -589,7 +1189,7 @@ TEST(writer_reader, interleaved_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         packet::Interleaver intrlvr(dispatcher, arena, 10);
@@ -645,7 +1245,7 @@ TEST(writer_reader, delayed_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -719,7 +1319,7 @@ TEST(writer_reader, late_out_of_order_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -799,7 +1399,8 @@ TEST(writer_reader, repair_packets_before_source_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, writer_config.n_source_packets,
+                                          packet_factory, arena,
+                                          writer_config.n_source_packets,
                                           writer_config.n_repair_packets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -886,7 +1487,8 @@ TEST(writer_reader, repair_packets_mixed_with_source_packets) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, writer_config.n_source_packets,
+                                          packet_factory, arena,
+                                          writer_config.n_source_packets,
                                           writer_config.n_repair_packets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -987,7 +1589,7 @@ TEST(writer_reader, multiple_repair_attempts) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -1068,7 +1670,7 @@ TEST(writer_reader, drop_outdated_block) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -1141,7 +1743,7 @@ TEST(writer_reader, repaired_block_numbering) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -1231,7 +1833,7 @@ TEST(writer_reader, invalid_esi) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, queue,
@@ -1313,7 +1915,7 @@ TEST(writer_reader, invalid_sbl) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, queue,
@@ -1390,7 +1992,7 @@ TEST(writer_reader, invalid_nes) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, queue,
@@ -1552,7 +2154,7 @@ TEST(writer_reader, zero_source_packets) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, queue,
@@ -1638,7 +2240,7 @@ TEST(writer_reader, zero_repair_packets) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(ldpc_source_parser, ldpc_repair_parser,
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, packet::FEC_LDPC_Staircase, *encoder, queue,
@@ -1809,7 +2411,7 @@ TEST(writer_reader, sbn_jump) {
         packet::Queue queue;
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, queue,
@@ -1927,7 +2529,7 @@ TEST(writer_reader, writer_encode_blocks) {
             CHECK(encoder);
 
             test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                              packet_factory, NumSourcePackets,
+                                              packet_factory, arena, NumSourcePackets,
                                               NumRepairPackets);
 
             Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2016,7 +2618,7 @@ TEST(writer_reader, writer_resize_blocks) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2082,7 +2684,7 @@ TEST(writer_reader, resize_block_begin) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2155,7 +2757,7 @@ TEST(writer_reader, resize_block_middle) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2251,7 +2853,7 @@ TEST(writer_reader, resize_block_losses) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2326,7 +2928,7 @@ TEST(writer_reader, resize_block_repair_first) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2415,7 +3017,7 @@ TEST(writer_reader, error_writer_resize_block) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         test::MockArena mock_arena;
@@ -2469,7 +3071,7 @@ TEST(writer_reader, error_writer_encode_packet) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2519,7 +3121,7 @@ TEST(writer_reader, error_reader_resize_block) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2593,7 +3195,7 @@ TEST(writer_reader, error_reader_decode_packet) {
         CHECK(decoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2677,7 +3279,7 @@ TEST(writer_reader, writer_oversized_block) {
         CHECK(NumSourcePackets + NumRepairPackets <= encoder->max_block_length());
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2745,7 +3347,7 @@ TEST(writer_reader, reader_oversized_source_block) {
 
         packet::Queue queue;
         test::PacketDispatcher dispatcher(ldpc_source_parser, ldpc_repair_parser,
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         // We are going to spoil source_block_length field of a FEC packet,
@@ -2816,7 +3418,7 @@ TEST(writer_reader, reader_oversized_repair_block) {
 
         packet::Queue queue;
         test::PacketDispatcher dispatcher(ldpc_source_parser, ldpc_repair_parser,
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         // We are going to spoil source_block_length field of a FEC packet,
@@ -2878,7 +3480,7 @@ TEST(writer_reader, writer_invalid_payload_size_change) {
         CHECK(encoder);
 
         test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
-                                          packet_factory, NumSourcePackets,
+                                          packet_factory, arena, NumSourcePackets,
                                           NumRepairPackets);
 
         Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
@@ -2976,8 +3578,7 @@ TEST(writer_reader, reader_invalid_fec_scheme_source_packet) {
             UNSIGNED_LONGS_EQUAL(status::StatusOK, writer_queue.read(p));
             CHECK(p);
             CHECK((p->flags() & packet::Packet::FlagRepair) == 0);
-            p->fec()->fec_scheme = CodecMap::instance().nth_scheme(
-                (n_scheme + 1) % CodecMap::instance().num_schemes());
+            p->fec()->fec_scheme = other_scheme(codec_config.scheme);
             UNSIGNED_LONGS_EQUAL(status::StatusOK, source_queue.write(p));
             UNSIGNED_LONGS_EQUAL(1, source_queue.size());
         }
@@ -3059,8 +3660,7 @@ TEST(writer_reader, reader_invalid_fec_scheme_repair_packet) {
             UNSIGNED_LONGS_EQUAL(status::StatusOK, writer_queue.read(p));
             CHECK(p);
             CHECK((p->flags() & packet::Packet::FlagRepair) != 0);
-            p->fec()->fec_scheme = CodecMap::instance().nth_scheme(
-                (n_scheme + 1) % CodecMap::instance().num_schemes());
+            p->fec()->fec_scheme = other_scheme(codec_config.scheme);
             UNSIGNED_LONGS_EQUAL(status::StatusOK, repair_queue.write(p));
             UNSIGNED_LONGS_EQUAL(1, repair_queue.size());
         }
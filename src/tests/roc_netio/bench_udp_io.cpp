@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/mutex.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+#include "roc_netio/network_loop.h"
+#include "roc_packet/packet_factory.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace roc {
+namespace netio {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// Sender and receiver UDP ports are opened on loopback interface and attached
+// to a single NetworkLoop. Each sender port sends packets to its own receiver
+// port. Every packet carries timestamp of the moment when it was passed to
+// write() of sender port, and receiver computes one-way latency when packet
+// is delivered to inbound writer.
+//
+// ----------
+// Benchmarks
+// ----------
+//
+// BM_UdpIo_Throughput  - each iteration writes a burst of packets to all ports
+//                        and waits until they're delivered; measures maximum
+//                        packet rate
+// BM_UdpIo_Latency     - each iteration writes one packet and waits until it's
+//                        delivered; measures latency of unloaded network loop
+//
+// ---------
+// Arguments
+// ---------
+//
+// size   -  packet payload size, in bytes
+// ports  -  number of sender/receiver port pairs
+// batch  -  whether batch receiving is enabled in receiver ports
+//
+// --------------
+// Output columns
+// --------------
+//
+// (all time units are microseconds)
+//
+// items_per_second  -  delivered packets per second
+// loss              -  percentage (0..1) of packets that weren't delivered
+//
+// l_avg             -  average latency between write() and delivery
+// l_p50             -  50% percentile of the above
+// l_p99             -  99% percentile of the above
+// l_max             -  maximum of the above
+
+enum {
+    MaxPacketSize = 1400,
+    MaxPorts = 16,
+    BurstSize = 64,
+    MaxLatencySamples = 200000
+};
+
+// how long to wait for packets that may be lost
+const core::nanoseconds_t DeliveryTimeout = 100 * core::Millisecond;
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    buffer_pool("buffer_pool", arena, sizeof(core::Buffer) + MaxPacketSize);
+
+packet::PacketFactory packet_factory(packet_pool, buffer_pool);
+
+// Receives packets from all receiver ports and collects statistics.
+class Receiver : public packet::IWriter {
+public:
+    Receiver()
+        : n_received_(0) {
+        latencies_.reserve(MaxLatencySamples);
+    }
+
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& pp) {
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+        core::nanoseconds_t send_ts = 0;
+        memcpy(&send_ts, pp->buffer().data(), sizeof(send_ts));
+
+        {
+            core::Mutex::Lock lock(mutex_);
+            if (latencies_.size() < MaxLatencySamples) {
+                latencies_.push_back(now - send_ts);
+            }
+        }
+
+        n_received_++;
+
+        return status::StatusOK;
+    }
+
+    size_t num_received() const {
+        return (size_t)n_received_;
+    }
+
+    // Wait until given number of packets is received or timeout expires.
+    void wait(size_t n_packets) const {
+        const core::nanoseconds_t deadline =
+            core::timestamp(core::ClockMonotonic) + DeliveryTimeout;
+
+        while ((size_t)n_received_ < n_packets) {
+            if (core::timestamp(core::ClockMonotonic) >= deadline) {
+                break;
+            }
+            core::sleep_for(core::ClockMonotonic, core::Microsecond * 5);
+        }
+    }
+
+    void report(benchmark::State& state, size_t n_sent) {
+        core::Mutex::Lock lock(mutex_);
+
+        state.counters["loss"] =
+            n_sent ? 1. - (double)(size_t)n_received_ / (double)n_sent : 0;
+
+        if (latencies_.empty()) {
+            return;
+        }
+
+        std::sort(latencies_.begin(), latencies_.end());
+
+        double total = 0;
+        for (size_t n = 0; n < latencies_.size(); n++) {
+            total += (double)latencies_[n];
+        }
+
+        state.counters["l_avg"] = total / latencies_.size() / core::Microsecond;
+        state.counters["l_p50"] = percentile_(0.50);
+        state.counters["l_p99"] = percentile_(0.99);
+        state.counters["l_max"] =
+            (double)latencies_[latencies_.size() - 1] / core::Microsecond;
+    }
+
+private:
+    double percentile_(double p) const {
+        const size_t n = std::min(latencies_.size() - 1,
+                                  (size_t)(p * (double)latencies_.size()));
+        return (double)latencies_[n] / core::Microsecond;
+    }
+
+    core::Atomic<long> n_received_;
+
+    core::Mutex mutex_;
+    std::vector<core::nanoseconds_t> latencies_;
+};
+
+class PortPairs {
+public:
+    PortPairs(NetworkLoop& net_loop)
+        : net_loop_(net_loop)
+        , n_ports_(0) {
+    }
+
+    bool add(Receiver& receiver, bool batch_recv) {
+        UdpConfig& tx_config = tx_configs_[n_ports_];
+        UdpConfig& rx_config = rx_configs_[n_ports_];
+
+        if (!tx_config.bind_address.set_host_port(address::Family_IPv4, "127.0.0.1", 0)
+            || !rx_config.bind_address.set_host_port(address::Family_IPv4, "127.0.0.1",
+                                                     0)) {
+            return false;
+        }
+
+        rx_config.enable_batch_recv = batch_recv;
+
+        NetworkLoop::Tasks::AddUdpPort add_tx_task(tx_config);
+        if (!net_loop_.schedule_and_wait(add_tx_task)) {
+            return false;
+        }
+
+        NetworkLoop::Tasks::StartUdpSend send_task(add_tx_task.get_handle());
+        if (!net_loop_.schedule_and_wait(send_task)) {
+            return false;
+        }
+
+        NetworkLoop::Tasks::AddUdpPort add_rx_task(rx_config);
+        if (!net_loop_.schedule_and_wait(add_rx_task)) {
+            return false;
+        }
+
+        NetworkLoop::Tasks::StartUdpRecv recv_task(add_rx_task.get_handle(), receiver);
+        if (!net_loop_.schedule_and_wait(recv_task)) {
+            return false;
+        }
+
+        tx_writers_[n_ports_] = &send_task.get_outbound_writer();
+        n_ports_++;
+
+        return true;
+    }
+
+    bool send(size_t port, size_t packet_size) {
+        packet::PacketPtr pp = packet_factory.new_packet();
+        if (!pp) {
+            return false;
+        }
+
+        core::Slice<uint8_t> buf = packet_factory.new_packet_buffer();
+        if (!buf) {
+            return false;
+        }
+        buf.reslice(0, packet_size);
+        memset(buf.data(), 0, packet_size);
+
+        pp->add_flags(packet::Packet::FlagUDP);
+        pp->udp()->src_addr = tx_configs_[port].bind_address;
+        pp->udp()->dst_addr = rx_configs_[port].bind_address;
+        pp->set_buffer(buf);
+
+        const core::nanoseconds_t send_ts = core::timestamp(core::ClockMonotonic);
+        memcpy(buf.data(), &send_ts, sizeof(send_ts));
+
+        return tx_writers_[port]->write(pp) == status::StatusOK;
+    }
+
+private:
+    NetworkLoop& net_loop_;
+
+    UdpConfig tx_configs_[MaxPorts];
+    UdpConfig rx_configs_[MaxPorts];
+    packet::IWriter* tx_writers_[MaxPorts];
+
+    size_t n_ports_;
+};
+
+bool setup(benchmark::State& state, PortPairs& ports, Receiver& receiver) {
+    const size_t n_ports = (size_t)state.range(1);
+    const bool batch_recv = state.range(2) != 0;
+
+    for (size_t n = 0; n < n_ports; n++) {
+        if (!ports.add(receiver, batch_recv)) {
+            state.SkipWithError("can't add udp ports");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BM_UdpIo_Throughput(benchmark::State& state) {
+    const size_t packet_size = (size_t)state.range(0);
+    const size_t n_ports = (size_t)state.range(1);
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    if (!net_loop.is_valid()) {
+        state.SkipWithError("can't create network loop");
+        return;
+    }
+
+    Receiver receiver;
+    PortPairs ports(net_loop);
+    if (!setup(state, ports, receiver)) {
+        return;
+    }
+
+    size_t n_sent = 0;
+
+    while (state.KeepRunning()) {
+        for (size_t n_pkt = 0; n_pkt < BurstSize; n_pkt++) {
+            for (size_t n_port = 0; n_port < n_ports; n_port++) {
+                if (ports.send(n_port, packet_size)) {
+                    n_sent++;
+                }
+            }
+        }
+        receiver.wait(n_sent);
+    }
+
+    state.SetItemsProcessed((int64_t)receiver.num_received());
+    receiver.report(state, n_sent);
+}
+
+void BM_UdpIo_Latency(benchmark::State& state) {
+    const size_t packet_size = (size_t)state.range(0);
+    const size_t n_ports = (size_t)state.range(1);
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    if (!net_loop.is_valid()) {
+        state.SkipWithError("can't create network loop");
+        return;
+    }
+
+    Receiver receiver;
+    PortPairs ports(net_loop);
+    if (!setup(state, ports, receiver)) {
+        return;
+    }
+
+    size_t n_sent = 0;
+    size_t n_port = 0;
+
+    while (state.KeepRunning()) {
+        if (ports.send(n_port, packet_size)) {
+            n_sent++;
+        }
+        receiver.wait(n_sent);
+
+        if (++n_port == n_ports) {
+            n_port = 0;
+        }
+    }
+
+    state.SetItemsProcessed((int64_t)receiver.num_received());
+    receiver.report(state, n_sent);
+}
+
+void udp_io_args(benchmark::internal::Benchmark* b) {
+    const int sizes[] = { 64, 512, 1400 };
+    const int ports[] = { 1, 4, 16 };
+
+    std::vector<std::string> names;
+    names.push_back("size");
+    names.push_back("ports");
+    names.push_back("batch");
+    b->ArgNames(names);
+
+    for (size_t n_sz = 0; n_sz < ROC_ARRAY_SIZE(sizes); n_sz++) {
+        for (size_t n_pt = 0; n_pt < ROC_ARRAY_SIZE(ports); n_pt++) {
+            for (int batch = 0; batch <= 1; batch++) {
+                std::vector<int64_t> args;
+                args.push_back(sizes[n_sz]);
+                args.push_back(ports[n_pt]);
+                args.push_back(batch);
+                b->Args(args);
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_UdpIo_Throughput)
+    ->Apply(udp_io_args)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_UdpIo_Latency)
+    ->Apply(udp_io_args)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+#include "roc_netio/network_loop.h"
+#include "roc_netio/shm_ring.h"
+#include "roc_packet/concurrent_queue.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { NumPackets = 50, BufferSize = 125 };
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    buffer_pool("buffer_pool", arena, sizeof(core::Buffer) + BufferSize);
+
+packet::PacketFactory packet_factory(packet_pool, buffer_pool);
+
+ShmConfig make_shm_config() {
+    // Random port, so that concurrent test runs don't share segments.
+    ShmConfig config;
+    CHECK(config.address.set_host_port(address::Family_IPv4, "127.0.0.1",
+                                       (int)core::fast_random_range(20000, 60000)));
+    return config;
+}
+
+NetworkLoop::PortHandle add_shm_sender(NetworkLoop& net_loop,
+                                       ShmConfig& config,
+                                       packet::IWriter** outbound_writer) {
+    NetworkLoop::Tasks::AddShmPort add_task(config);
+    CHECK(net_loop.schedule_and_wait(add_task));
+
+    NetworkLoop::Tasks::StartShmSend send_task(add_task.get_handle());
+    CHECK(net_loop.schedule_and_wait(send_task));
+    *outbound_writer = &send_task.get_outbound_writer();
+
+    return add_task.get_handle();
+}
+
+NetworkLoop::PortHandle add_shm_receiver(NetworkLoop& net_loop,
+                                         ShmConfig& config,
+                                         packet::IWriter& inbound_writer) {
+    NetworkLoop::Tasks::AddShmPort add_task(config);
+    CHECK(net_loop.schedule_and_wait(add_task));
+
+    NetworkLoop::Tasks::StartShmRecv recv_task(add_task.get_handle(), inbound_writer);
+    CHECK(net_loop.schedule_and_wait(recv_task));
+
+    return add_task.get_handle();
+}
+
+void remove_port(NetworkLoop& net_loop, NetworkLoop::PortHandle handle) {
+    NetworkLoop::Tasks::RemovePort remove_task(handle);
+    CHECK(net_loop.schedule_and_wait(remove_task));
+}
+
+packet::PacketPtr new_packet(int value) {
+    core::Slice<uint8_t> buf = packet_factory.new_packet_buffer();
+    CHECK(buf);
+    buf.reslice(0, BufferSize);
+    for (int n = 0; n < BufferSize; n++) {
+        buf.data()[n] = uint8_t((value + n) & 0xff);
+    }
+
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+    pp->set_buffer(buf);
+
+    return pp;
+}
+
+void check_packet(const packet::PacketPtr& pp, const ShmConfig& config, int value) {
+    CHECK(pp);
+    CHECK(pp->udp());
+    CHECK(pp->buffer());
+
+    CHECK(pp->udp()->dst_addr == config.address);
+    CHECK(pp->udp()->src_addr.port() > 0);
+    CHECK(pp->udp()->receive_timestamp > 0);
+
+    UNSIGNED_LONGS_EQUAL(BufferSize, pp->buffer().size());
+    for (int n = 0; n < BufferSize; n++) {
+        UNSIGNED_LONGS_EQUAL(uint8_t((value + n) & 0xff), pp->buffer().data()[n]);
+    }
+}
+
+packet::PacketPtr read_packet(packet::ConcurrentQueue& rx_queue) {
+    for (;;) {
+        packet::PacketPtr pp;
+        const status::StatusCode code = rx_queue.read(pp);
+        if (code == status::StatusOK) {
+            return pp;
+        }
+        LONGS_EQUAL(status::StatusNoData, code);
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+}
+
+// Write packets until sender attaches to ring and one of them is received.
+void wait_attached(packet::IWriter& tx_writer, packet::ConcurrentQueue& rx_queue) {
+    for (;;) {
+        LONGS_EQUAL(status::StatusOK, tx_writer.write(new_packet(0)));
+        core::sleep_for(core::ClockMonotonic, core::Millisecond * 10);
+
+        packet::PacketPtr pp;
+        if (rx_queue.read(pp) == status::StatusOK) {
+            break;
+        }
+    }
+
+    // drain
+    for (;;) {
+        packet::PacketPtr pp;
+        if (rx_queue.read(pp) != status::StatusOK) {
+            break;
+        }
+    }
+}
+
+} // namespace
+
+TEST_GROUP(shm_io) {};
+
+TEST(shm_io, one_sender_one_receiver) {
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::NonBlocking);
+
+    ShmConfig rx_config = make_shm_config();
+    ShmConfig tx_config = rx_config;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    CHECK(add_shm_receiver(net_loop, rx_config, rx_queue));
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_shm_sender(net_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    address::SocketAddr src_addr;
+
+    for (int p = 0; p < NumPackets; p++) {
+        LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(p)));
+
+        packet::PacketPtr pp = read_packet(rx_queue);
+        check_packet(pp, rx_config, p);
+
+        if (p == 0) {
+            src_addr = pp->udp()->src_addr;
+        } else {
+            CHECK(pp->udp()->src_addr == src_addr);
+        }
+    }
+}
+
+TEST(shm_io, two_senders_one_receiver) {
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::NonBlocking);
+
+    ShmConfig rx_config = make_shm_config();
+    ShmConfig tx_config = rx_config;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    CHECK(add_shm_receiver(net_loop, rx_config, rx_queue));
+
+    packet::IWriter* tx_writer1 = NULL;
+    CHECK(add_shm_sender(net_loop, tx_config, &tx_writer1));
+
+    packet::IWriter* tx_writer2 = NULL;
+    CHECK(add_shm_sender(net_loop, tx_config, &tx_writer2));
+
+    address::SocketAddr src_addr1, src_addr2;
+
+    for (int p = 0; p < NumPackets; p++) {
+        LONGS_EQUAL(status::StatusOK, tx_writer1->write(new_packet(p)));
+        LONGS_EQUAL(status::StatusOK, tx_writer2->write(new_packet(p + 1)));
+
+        packet::PacketPtr pp1 = read_packet(rx_queue);
+        check_packet(pp1, rx_config, p);
+
+        packet::PacketPtr pp2 = read_packet(rx_queue);
+        check_packet(pp2, rx_config, p + 1);
+
+        if (p == 0) {
+            src_addr1 = pp1->udp()->src_addr;
+            src_addr2 = pp2->udp()->src_addr;
+        } else {
+            CHECK(pp1->udp()->src_addr == src_addr1);
+            CHECK(pp2->udp()->src_addr == src_addr2);
+        }
+    }
+}
+
+TEST(shm_io, sender_before_receiver) {
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::NonBlocking);
+
+    ShmConfig rx_config = make_shm_config();
+    ShmConfig tx_config = rx_config;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_shm_sender(net_loop, tx_config, &tx_writer));
+
+    // Ring doesn't exist yet, packets are dropped.
+    LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(0)));
+
+    CHECK(add_shm_receiver(net_loop, rx_config, rx_queue));
+
+    wait_attached(*tx_writer, rx_queue);
+
+    for (int p = 0; p < NumPackets; p++) {
+        LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(p)));
+
+        packet::PacketPtr pp = read_packet(rx_queue);
+        check_packet(pp, rx_config, p);
+    }
+}
+
+TEST(shm_io, receiver_restart) {
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::NonBlocking);
+
+    ShmConfig rx_config = make_shm_config();
+    ShmConfig tx_config = rx_config;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    NetworkLoop::PortHandle rx_handle = add_shm_receiver(net_loop, rx_config, rx_queue);
+    CHECK(rx_handle);
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_shm_sender(net_loop, tx_config, &tx_writer));
+
+    LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(1)));
+    {
+        packet::PacketPtr pp = read_packet(rx_queue);
+        check_packet(pp, rx_config, 1);
+    }
+
+    remove_port(net_loop, rx_handle);
+
+    // Sender notices that ring was closed and detaches.
+    LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(2)));
+
+    CHECK(add_shm_receiver(net_loop, rx_config, rx_queue));
+
+    // Sender attaches to new ring.
+    wait_attached(*tx_writer, rx_queue);
+
+    LONGS_EQUAL(status::StatusOK, tx_writer->write(new_packet(3)));
+    {
+        packet::PacketPtr pp = read_packet(rx_queue);
+        check_packet(pp, rx_config, 3);
+    }
+}
+
+TEST(shm_io, ring_full) {
+    enum { SlotSize = 16, NumSlots = 4 };
+
+    char name[ShmRing::MaxNameLen];
+    ShmRing::make_name(name, sizeof(name), (int)core::fast_random_range(20000, 60000));
+
+    ShmRing reader;
+    CHECK(reader.create(name, SlotSize, NumSlots));
+
+    ShmRing writer;
+    CHECK(writer.attach(name));
+    UNSIGNED_LONGS_EQUAL(SlotSize, writer.slot_size());
+
+    uint8_t data[SlotSize + 1] = {};
+
+    // too large
+    CHECK(!writer.write(1, data, SlotSize + 1));
+
+    for (int n = 0; n < NumSlots; n++) {
+        data[0] = (uint8_t)n;
+        CHECK(writer.write(1, data, (size_t)n + 1));
+    }
+
+    // full
+    CHECK(!writer.write(1, data, 1));
+
+    for (int lap = 0; lap < 3; lap++) {
+        for (int n = 0; n < NumSlots; n++) {
+            uint32_t sender_id = 0;
+            size_t size = 0;
+            const uint8_t* slot = reader.begin_read(sender_id, size);
+            CHECK(slot);
+            UNSIGNED_LONGS_EQUAL(1, sender_id);
+            UNSIGNED_LONGS_EQUAL(n + 1, size);
+            UNSIGNED_LONGS_EQUAL(n, slot[0]);
+            reader.end_read();
+
+            // freed slot can be reused
+            data[0] = (uint8_t)n;
+            CHECK(writer.write(1, data, (size_t)n + 1));
+        }
+    }
+
+    CHECK(!writer.is_closed_by_peer());
+    reader.close();
+    CHECK(writer.is_closed_by_peer());
+    CHECK(!writer.write(1, data, 1));
+}
+
+} // namespace netio
+} // namespace roc
@@ -110,6 +110,12 @@ public:
         drop_next_conn_ = true;
     }
 
+    size_t num_added() {
+        core::Mutex::Lock lock(mutex_);
+
+        return add_calls_;
+    }
+
     IConn* wait_added() {
         core::Mutex::Lock lock(mutex_);
 
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_address/socket_addr_to_str.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/temp_file.h"
+#include "roc_netio/pcap_reader.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { BufferSize = 100, MaxFileSize = 4096 };
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    buffer_pool("buffer_pool", arena, sizeof(core::Buffer) + BufferSize);
+
+packet::PacketFactory packet_factory(packet_pool, buffer_pool);
+
+const uint8_t Payload[] = { 0x80, 0x0b, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+
+const uint8_t IPv4Src[] = { 192, 168, 0, 1 };
+const uint8_t IPv4Dst[] = { 192, 168, 0, 2 };
+
+const uint8_t IPv6Src[] = { 0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+const uint8_t IPv6Dst[] = { 0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2 };
+
+// Builds capture file in memory.
+struct FileBuilder {
+    uint8_t data[MaxFileSize];
+    size_t size;
+    bool big_endian;
+
+    FileBuilder(bool be)
+        : size(0)
+        , big_endian(be) {
+    }
+
+    void put_u8(uint8_t v) {
+        CHECK(size < MaxFileSize);
+        data[size++] = v;
+    }
+
+    void put_be16(uint16_t v) {
+        put_u8(uint8_t(v >> 8));
+        put_u8(uint8_t(v));
+    }
+
+    void put_u16(uint16_t v) {
+        if (big_endian) {
+            put_be16(v);
+        } else {
+            put_u8(uint8_t(v));
+            put_u8(uint8_t(v >> 8));
+        }
+    }
+
+    void put_u32(uint32_t v) {
+        if (big_endian) {
+            put_u16(uint16_t(v >> 16));
+            put_u16(uint16_t(v));
+        } else {
+            put_u16(uint16_t(v));
+            put_u16(uint16_t(v >> 16));
+        }
+    }
+
+    void put_bytes(const uint8_t* bytes, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            put_u8(bytes[i]);
+        }
+    }
+
+    void set_u32(size_t pos, uint32_t v) {
+        const size_t saved_size = size;
+        size = pos;
+        put_u32(v);
+        size = saved_size;
+    }
+
+    void pad4() {
+        while (size % 4 != 0) {
+            put_u8(0);
+        }
+    }
+
+    void write(const char* path) {
+        FILE* fp = fopen(path, "wb");
+        CHECK(fp);
+        CHECK(fwrite(data, 1, size, fp) == size);
+        CHECK(fclose(fp) == 0);
+    }
+};
+
+// Appends ethernet frame with IPv4 datagram.
+void put_ethernet_ipv4(FileBuilder& b,
+                       uint8_t proto,
+                       uint16_t frag,
+                       bool vlan,
+                       const uint8_t* payload,
+                       size_t payload_size) {
+    for (int n = 0; n < 12; n++) {
+        b.put_u8(0xaa);
+    }
+    if (vlan) {
+        b.put_be16(0x8100);
+        b.put_be16(42);
+    }
+    b.put_be16(0x0800);
+
+    b.put_u8(0x45);
+    b.put_u8(0);
+    b.put_be16(uint16_t(20 + 8 + payload_size));
+    b.put_be16(0);
+    b.put_be16(frag);
+    b.put_u8(64);
+    b.put_u8(proto);
+    b.put_be16(0);
+    b.put_bytes(IPv4Src, 4);
+    b.put_bytes(IPv4Dst, 4);
+
+    b.put_be16(10000);
+    b.put_be16(20000);
+    b.put_be16(uint16_t(8 + payload_size));
+    b.put_be16(0);
+    b.put_bytes(payload, payload_size);
+}
+
+size_t ethernet_ipv4_size(bool vlan, size_t payload_size) {
+    return 14 + (vlan ? 4 : 0) + 20 + 8 + payload_size;
+}
+
+// Appends raw IPv6 datagram.
+void put_raw_ipv6(FileBuilder& b, const uint8_t* payload, size_t payload_size) {
+    b.put_u8(0x60);
+    b.put_u8(0);
+    b.put_be16(0);
+    b.put_be16(uint16_t(8 + payload_size));
+    b.put_u8(17);
+    b.put_u8(64);
+    b.put_bytes(IPv6Src, 16);
+    b.put_bytes(IPv6Dst, 16);
+
+    b.put_be16(10000);
+    b.put_be16(20000);
+    b.put_be16(uint16_t(8 + payload_size));
+    b.put_be16(0);
+    b.put_bytes(payload, payload_size);
+}
+
+size_t raw_ipv6_size(size_t payload_size) {
+    return 40 + 8 + payload_size;
+}
+
+void put_pcap_header(FileBuilder& b, uint32_t magic, uint32_t link_type) {
+    b.put_u32(magic);
+    b.put_u16(2);
+    b.put_u16(4);
+    b.put_u32(0);
+    b.put_u32(0);
+    b.put_u32(65535);
+    b.put_u32(link_type);
+}
+
+void put_pcap_record(FileBuilder& b, uint32_t sec, uint32_t frac, size_t len) {
+    b.put_u32(sec);
+    b.put_u32(frac);
+    b.put_u32((uint32_t)len);
+    b.put_u32((uint32_t)len);
+}
+
+void check_payload(const packet::PacketPtr& pp) {
+    CHECK(pp->has_flags(packet::Packet::FlagUDP));
+    LONGS_EQUAL(sizeof(Payload), pp->buffer().size());
+    CHECK(memcmp(Payload, pp->buffer().data(), sizeof(Payload)) == 0);
+}
+
+void check_ipv4_addrs(const packet::PacketPtr& pp) {
+    address::SocketAddr src, dst;
+    CHECK(src.set_host_port(address::Family_IPv4, "192.168.0.1", 10000));
+    CHECK(dst.set_host_port(address::Family_IPv4, "192.168.0.2", 20000));
+
+    CHECK(pp->udp()->src_addr == src);
+    CHECK(pp->udp()->dst_addr == dst);
+}
+
+void check_ipv6_addrs(const packet::PacketPtr& pp) {
+    address::SocketAddr src, dst;
+    CHECK(src.set_host_port(address::Family_IPv6, "fd00::1", 10000));
+    CHECK(dst.set_host_port(address::Family_IPv6, "fd00::2", 20000));
+
+    CHECK(pp->udp()->src_addr == src);
+    CHECK(pp->udp()->dst_addr == dst);
+}
+
+} // namespace
+
+TEST_GROUP(pcap_reader) {};
+
+TEST(pcap_reader, pcap_ethernet) {
+    core::TempFile temp_file("test.pcap");
+
+    FileBuilder b(false);
+    put_pcap_header(b, 0xa1b2c3d4, 1);
+
+    // UDP
+    put_pcap_record(b, 100, 250000, ethernet_ipv4_size(false, sizeof(Payload)));
+    put_ethernet_ipv4(b, 17, 0, false, Payload, sizeof(Payload));
+
+    // TCP
+    put_pcap_record(b, 100, 260000, ethernet_ipv4_size(false, sizeof(Payload)));
+    put_ethernet_ipv4(b, 6, 0, false, Payload, sizeof(Payload));
+
+    // UDP fragment
+    put_pcap_record(b, 100, 270000, ethernet_ipv4_size(false, sizeof(Payload)));
+    put_ethernet_ipv4(b, 17, 0x2000, false, Payload, sizeof(Payload));
+
+    // UDP with VLAN tag
+    put_pcap_record(b, 101, 0, ethernet_ipv4_size(true, sizeof(Payload)));
+    put_ethernet_ipv4(b, 17, 0, true, Payload, sizeof(Payload));
+
+    b.write(temp_file.path());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    CHECK(pp);
+    check_payload(pp);
+    check_ipv4_addrs(pp);
+    CHECK_EQUAL(100 * core::Second + 250 * core::Millisecond,
+                pp->udp()->receive_timestamp);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    CHECK(pp);
+    check_payload(pp);
+    check_ipv4_addrs(pp);
+    CHECK_EQUAL(101 * core::Second, pp->udp()->receive_timestamp);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+    CHECK(!pp);
+
+    LONGS_EQUAL(2, reader.num_packets());
+    LONGS_EQUAL(2, reader.num_skipped());
+}
+
+TEST(pcap_reader, pcap_big_endian_nanosec) {
+    core::TempFile temp_file("test.pcap");
+
+    FileBuilder b(true);
+    put_pcap_header(b, 0xa1b23c4d, 101);
+
+    put_pcap_record(b, 5, 123, raw_ipv6_size(sizeof(Payload)));
+    put_raw_ipv6(b, Payload, sizeof(Payload));
+
+    b.write(temp_file.path());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    CHECK(pp);
+    check_payload(pp);
+    check_ipv6_addrs(pp);
+    CHECK_EQUAL(5 * core::Second + 123, pp->udp()->receive_timestamp);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+    CHECK(!pp);
+}
+
+TEST(pcap_reader, pcapng) {
+    core::TempFile temp_file("test.pcapng");
+
+    FileBuilder b(false);
+
+    // Section header
+    b.put_u32(0x0a0d0d0a);
+    b.put_u32(28);
+    b.put_u32(0x1a2b3c4d);
+    b.put_u16(1);
+    b.put_u16(0);
+    b.put_u32(0xffffffff);
+    b.put_u32(0xffffffff);
+    b.put_u32(28);
+
+    // Interface 0: ethernet, default resolution (microseconds)
+    b.put_u32(1);
+    b.put_u32(20);
+    b.put_u16(1);
+    b.put_u16(0);
+    b.put_u32(0);
+    b.put_u32(20);
+
+    // Interface 1: raw IP, nanosecond resolution
+    b.put_u32(1);
+    b.put_u32(32);
+    b.put_u16(101);
+    b.put_u16(0);
+    b.put_u32(0);
+    b.put_u16(9);
+    b.put_u16(1);
+    b.put_u8(9);
+    b.pad4();
+    b.put_u16(0);
+    b.put_u16(0);
+    b.put_u32(32);
+
+    const uint64_t ts0 = 2000000; // 2s in microseconds
+    const uint64_t ts1 = 3000000007ull; // 3s + 7ns in nanoseconds
+
+    // Enhanced packet on interface 0
+    {
+        const size_t start = b.size;
+        const size_t cap_len = ethernet_ipv4_size(false, sizeof(Payload));
+        b.put_u32(6);
+        b.put_u32(0);
+        b.put_u32(0);
+        b.put_u32(uint32_t(ts0 >> 32));
+        b.put_u32(uint32_t(ts0));
+        b.put_u32((uint32_t)cap_len);
+        b.put_u32((uint32_t)cap_len);
+        put_ethernet_ipv4(b, 17, 0, false, Payload, sizeof(Payload));
+        b.pad4();
+        b.put_u32((uint32_t)(b.size - start + 4));
+        b.set_u32(start + 4, (uint32_t)(b.size - start));
+    }
+
+    // Unknown block
+    b.put_u32(0x0bad);
+    b.put_u32(16);
+    b.put_u32(0);
+    b.put_u32(16);
+
+    // Enhanced packet on interface 1
+    {
+        const size_t start = b.size;
+        const size_t cap_len = raw_ipv6_size(sizeof(Payload));
+        b.put_u32(6);
+        b.put_u32(0);
+        b.put_u32(1);
+        b.put_u32(uint32_t(ts1 >> 32));
+        b.put_u32(uint32_t(ts1));
+        b.put_u32((uint32_t)cap_len);
+        b.put_u32((uint32_t)cap_len);
+        put_raw_ipv6(b, Payload, sizeof(Payload));
+        b.pad4();
+        b.put_u32((uint32_t)(b.size - start + 4));
+        b.set_u32(start + 4, (uint32_t)(b.size - start));
+    }
+
+    b.write(temp_file.path());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    CHECK(pp);
+    check_payload(pp);
+    check_ipv4_addrs(pp);
+    CHECK_EQUAL(2 * core::Second, pp->udp()->receive_timestamp);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    CHECK(pp);
+    check_payload(pp);
+    check_ipv6_addrs(pp);
+    CHECK_EQUAL(3 * core::Second + 7, pp->udp()->receive_timestamp);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+    CHECK(!pp);
+
+    LONGS_EQUAL(2, reader.num_packets());
+    LONGS_EQUAL(0, reader.num_skipped());
+}
+
+TEST(pcap_reader, truncated) {
+    core::TempFile temp_file("test.pcap");
+
+    FileBuilder b(false);
+    put_pcap_header(b, 0xa1b2c3d4, 1);
+
+    // Datagram cut by snaplen
+    const size_t cap_len = ethernet_ipv4_size(false, sizeof(Payload)) - 2;
+    put_pcap_record(b, 1, 0, cap_len);
+    put_ethernet_ipv4(b, 17, 0, false, Payload, sizeof(Payload));
+    b.size -= 2;
+
+    // Record cut by end of file
+    put_pcap_record(b, 2, 0, ethernet_ipv4_size(false, sizeof(Payload)));
+    put_ethernet_ipv4(b, 17, 0, false, Payload, sizeof(Payload));
+    b.size -= 1;
+
+    b.write(temp_file.path());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+    CHECK(!pp);
+
+    LONGS_EQUAL(0, reader.num_packets());
+    LONGS_EQUAL(1, reader.num_skipped());
+}
+
+TEST(pcap_reader, bad_format) {
+    core::TempFile temp_file("test.pcap");
+
+    FileBuilder b(false);
+    for (int n = 0; n < 64; n++) {
+        b.put_u8(uint8_t(n));
+    }
+    b.write(temp_file.path());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(!reader.open(temp_file.path()));
+}
+
+} // namespace netio
+} // namespace roc
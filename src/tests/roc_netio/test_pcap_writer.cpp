@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/temp_file.h"
+#include "roc_netio/pcap_reader.h"
+#include "roc_netio/pcap_writer.h"
+#include "roc_packet/capture_ring.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { BufferSize = 100, NumRecords = 16 };
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    buffer_pool("buffer_pool", arena, sizeof(core::Buffer) + BufferSize);
+
+packet::PacketFactory packet_factory(packet_pool, buffer_pool);
+
+const uint8_t Payload[] = { 0x80, 0x0b, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+
+packet::PacketPtr new_packet(address::AddrFamily family,
+                             const char* src_host,
+                             const char* dst_host) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+    buffer.reslice(0, sizeof(Payload));
+    memcpy(buffer.data(), Payload, sizeof(Payload));
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->set_buffer(buffer);
+
+    CHECK(pp->udp()->src_addr.set_host_port(family, src_host, 10000));
+    CHECK(pp->udp()->dst_addr.set_host_port(family, dst_host, 20000));
+
+    return pp;
+}
+
+void check_packet(const packet::PacketPtr& pp,
+                  address::AddrFamily family,
+                  const char* src_host,
+                  const char* dst_host) {
+    CHECK(pp);
+    CHECK(pp->has_flags(packet::Packet::FlagUDP));
+    LONGS_EQUAL(sizeof(Payload), pp->buffer().size());
+    CHECK(memcmp(Payload, pp->buffer().data(), sizeof(Payload)) == 0);
+
+    address::SocketAddr src, dst;
+    CHECK(src.set_host_port(family, src_host, 10000));
+    CHECK(dst.set_host_port(family, dst_host, 20000));
+
+    CHECK(pp->udp()->src_addr == src);
+    CHECK(pp->udp()->dst_addr == dst);
+}
+
+} // namespace
+
+TEST_GROUP(pcap_writer) {};
+
+TEST(pcap_writer, write_ring) {
+    packet::CaptureConfig config;
+    config.num_records = NumRecords;
+
+    packet::CaptureRing ring(config, arena);
+    CHECK(ring.is_valid());
+
+    ring.capture(*new_packet(address::Family_IPv4, "192.168.0.1", "192.168.0.2"),
+                 packet::CapturePoint_Ingress, 0);
+    ring.capture(*new_packet(address::Family_IPv6, "fd00::1", "fd00::2"),
+                 packet::CapturePoint_Egress, 0);
+    ring.capture(*new_packet(address::Family_IPv4, "192.168.0.3", "192.168.0.4"),
+                 packet::CapturePoint_Repair,
+                 packet::CaptureFlag_Repaired | packet::CaptureFlag_Dropped);
+
+    core::TempFile temp_file("test.pcapng");
+
+    {
+        PcapWriter writer;
+        CHECK(writer.open(temp_file.path()));
+        CHECK(writer.write_all(ring));
+        CHECK(writer.close());
+
+        LONGS_EQUAL(3, writer.num_packets());
+    }
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    check_packet(pp, address::Family_IPv4, "192.168.0.1", "192.168.0.2");
+    CHECK(pp->udp()->receive_timestamp > 0);
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    check_packet(pp, address::Family_IPv6, "fd00::1", "fd00::2");
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusOK, reader.read(pp));
+    check_packet(pp, address::Family_IPv4, "192.168.0.3", "192.168.0.4");
+
+    pp = NULL;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+
+    LONGS_EQUAL(3, reader.num_packets());
+    LONGS_EQUAL(0, reader.num_skipped());
+}
+
+TEST(pcap_writer, empty_ring) {
+    packet::CaptureConfig config;
+    config.num_records = NumRecords;
+
+    packet::CaptureRing ring(config, arena);
+    CHECK(ring.is_valid());
+
+    core::TempFile temp_file("test.pcapng");
+
+    PcapWriter writer;
+    CHECK(writer.open(temp_file.path()));
+    CHECK(writer.write_all(ring));
+    CHECK(writer.close());
+
+    LONGS_EQUAL(0, writer.num_packets());
+
+    PcapReader reader(packet_factory, arena);
+    CHECK(reader.open(temp_file.path()));
+
+    packet::PacketPtr pp;
+    LONGS_EQUAL(status::StatusNoData, reader.read(pp));
+}
+
+TEST(pcap_writer, bad_path) {
+    PcapWriter writer;
+    CHECK(!writer.open("/bad/path/test.pcapng"));
+    CHECK(writer.close());
+}
+
+} // namespace netio
+} // namespace roc
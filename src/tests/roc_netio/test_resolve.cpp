@@ -11,6 +11,7 @@
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
 
 namespace roc {
@@ -137,5 +138,127 @@ TEST(resolve, bad_host) {
     }
 }
 
+TEST(resolve, cache_hit) {
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    address::EndpointUri endpoint_uri(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:123",
+                                      address::EndpointUri::Subset_Full, endpoint_uri));
+
+    address::SocketAddr address1;
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address1));
+
+    UNSIGNED_LONGS_EQUAL(0, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_misses());
+
+    address::SocketAddr address2;
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address2));
+
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_misses());
+
+    CHECK(address1 == address2);
+
+    // Different port is cached separately.
+    address::EndpointUri other_uri(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:456",
+                                      address::EndpointUri::Subset_Full, other_uri));
+
+    address::SocketAddr address3;
+    CHECK(resolve_endpoint_address(net_loop, other_uri, address3));
+
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(2, net_loop.num_resolver_cache_misses());
+
+    LONGS_EQUAL(456, address3.port());
+}
+
+TEST(resolve, cache_negative) {
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    address::EndpointUri endpoint_uri(arena);
+    CHECK(address::parse_endpoint_uri("rtp://_:123", address::EndpointUri::Subset_Full,
+                                      endpoint_uri));
+
+    address::SocketAddr address;
+    CHECK(!resolve_endpoint_address(net_loop, endpoint_uri, address));
+    CHECK(!resolve_endpoint_address(net_loop, endpoint_uri, address));
+
+    // Failure is cached too.
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(1, net_loop.num_resolver_cache_misses());
+}
+
+TEST(resolve, cache_disabled) {
+    ResolverConfig resolver_config;
+    resolver_config.cache_size = 0;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena, core::ThreadConfig(),
+                         resolver_config);
+    CHECK(net_loop.is_valid());
+
+    address::EndpointUri endpoint_uri(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:123",
+                                      address::EndpointUri::Subset_Full, endpoint_uri));
+
+    address::SocketAddr address;
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address));
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address));
+
+    UNSIGNED_LONGS_EQUAL(0, net_loop.num_resolver_cache_hits());
+}
+
+TEST(resolve, cache_expiration) {
+    ResolverConfig resolver_config;
+    resolver_config.cache_ttl = core::Millisecond;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena, core::ThreadConfig(),
+                         resolver_config);
+    CHECK(net_loop.is_valid());
+
+    address::EndpointUri endpoint_uri(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:123",
+                                      address::EndpointUri::Subset_Full, endpoint_uri));
+
+    address::SocketAddr address;
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address));
+
+    core::sleep_for(core::ClockMonotonic, core::Millisecond * 2);
+
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri, address));
+
+    UNSIGNED_LONGS_EQUAL(0, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(2, net_loop.num_resolver_cache_misses());
+}
+
+TEST(resolve, cache_eviction) {
+    ResolverConfig resolver_config;
+    resolver_config.cache_size = 1;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena, core::ThreadConfig(),
+                         resolver_config);
+    CHECK(net_loop.is_valid());
+
+    address::EndpointUri endpoint_uri1(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:123",
+                                      address::EndpointUri::Subset_Full, endpoint_uri1));
+
+    address::EndpointUri endpoint_uri2(arena);
+    CHECK(address::parse_endpoint_uri("rtp://localhost:456",
+                                      address::EndpointUri::Subset_Full, endpoint_uri2));
+
+    address::SocketAddr address;
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri1, address));
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri2, address));
+
+    // First result was evicted by second one.
+    CHECK(resolve_endpoint_address(net_loop, endpoint_uri1, address));
+
+    UNSIGNED_LONGS_EQUAL(0, net_loop.num_resolver_cache_hits());
+    UNSIGNED_LONGS_EQUAL(3, net_loop.num_resolver_cache_misses());
+}
+
 } // namespace netio
 } // namespace roc
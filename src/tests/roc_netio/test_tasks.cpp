@@ -60,6 +60,32 @@ private:
     NetworkTask* task_;
 };
 
+class CountingCompleter : public INetworkTaskCompleter {
+public:
+    CountingCompleter()
+        : cond_(mutex_)
+        , count_(0) {
+    }
+
+    virtual void network_task_completed(NetworkTask&) {
+        core::Mutex::Lock lock(mutex_);
+        count_++;
+        cond_.broadcast();
+    }
+
+    void wait_tasks(size_t count) {
+        core::Mutex::Lock lock(mutex_);
+        while (count_ < count) {
+            cond_.wait();
+        }
+    }
+
+private:
+    core::Mutex mutex_;
+    core::Cond cond_;
+    size_t count_;
+};
+
 class AddRemoveCompleter : public INetworkTaskCompleter {
 public:
     AddRemoveCompleter(NetworkLoop& net_loop)
@@ -232,5 +258,62 @@ TEST(tasks, asynchronous_add_recv_remove) {
     UNSIGNED_LONGS_EQUAL(0, net_loop.num_ports());
 }
 
+TEST(tasks, coalesced_wakeups) {
+    enum { NumTasks = 20 };
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    UdpConfig configs[NumTasks];
+    NetworkLoop::Tasks::AddUdpPort* tasks[NumTasks];
+
+    CountingCompleter completer;
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        configs[n] = make_receiver_config("127.0.0.1", 0);
+        tasks[n] = new NetworkLoop::Tasks::AddUdpPort(configs[n]);
+    }
+
+    const size_t start_wakeups = net_loop.num_task_wakeups();
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        net_loop.schedule(*tasks[n], completer);
+    }
+
+    completer.wait_tasks(NumTasks);
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        CHECK(tasks[n]->success());
+        delete tasks[n];
+    }
+
+    // each task is processed, but wakeups may be coalesced
+    const size_t num_wakeups = net_loop.num_task_wakeups() - start_wakeups;
+
+    CHECK(num_wakeups >= 1);
+    CHECK(num_wakeups <= NumTasks);
+
+    UNSIGNED_LONGS_EQUAL(NumTasks, net_loop.num_ports());
+}
+
+TEST(tasks, query_path_mtu) {
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    address::SocketAddr address;
+    CHECK(address.set_host_port(address::Family_IPv4, "127.0.0.1", 1234));
+
+    NetworkLoop::Tasks::QueryPathMtu mtu_task(address);
+
+    // Path MTU is not available on all platforms.
+    if (net_loop.schedule_and_wait(mtu_task)) {
+        CHECK(mtu_task.success());
+        // IPv4 requires links to support at least 576 bytes.
+        CHECK(mtu_task.get_mtu() >= 576);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, net_loop.num_ports());
+}
+
 } // namespace netio
 } // namespace roc
@@ -15,6 +15,7 @@
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
 
 namespace roc {
@@ -690,6 +691,66 @@ TEST(tcp_ports, connect_many_servers_many_clients_many_loops) {
     POINTERS_EQUAL(&server_conn_handler2, acceptor2.wait_removed());
 }
 
+TEST(tcp_ports, connection_limit) {
+    test::MockConnHandler client_conn_handler1;
+    test::MockConnHandler client_conn_handler2;
+
+    test::MockConnHandler server_conn_handler1;
+    test::MockConnHandler server_conn_handler2;
+
+    test::MockConnAcceptor acceptor;
+    acceptor.push_handler(server_conn_handler1);
+    acceptor.push_handler(server_conn_handler2);
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    TcpServerConfig server_config = make_server_config("127.0.0.1", 0);
+    server_config.max_connections = 1;
+
+    CHECK(add_tcp_server(net_loop, server_config, acceptor));
+
+    TcpClientConfig client_config1 = make_client_config(
+        "127.0.0.1", 0, "127.0.0.1", server_config.bind_address.port());
+
+    CHECK(add_tcp_client(net_loop, client_config1, client_conn_handler1));
+
+    IConn* server_conn1 = server_conn_handler1.wait_established();
+    IConn* client_conn1 = client_conn_handler1.wait_established();
+
+    POINTERS_EQUAL(server_conn1, acceptor.wait_added());
+
+    TcpClientConfig client_config2 = make_client_config(
+        "127.0.0.1", 0, "127.0.0.1", server_config.bind_address.port());
+
+    CHECK(add_tcp_client(net_loop, client_config2, client_conn_handler2));
+
+    // Client connection is established in server backlog, but server
+    // doesn't accept it until there is a free connection slot.
+    IConn* client_conn2 = client_conn_handler2.wait_established();
+
+    core::sleep_for(core::ClockMonotonic, 100 * core::Millisecond);
+    UNSIGNED_LONGS_EQUAL(1, acceptor.num_added());
+
+    terminate_and_wait(server_conn_handler1, server_conn1, test::ExpectNotFailed);
+    terminate_and_wait(client_conn_handler1, client_conn1, test::ExpectNotFailed);
+
+    POINTERS_EQUAL(&server_conn_handler1, acceptor.wait_removed());
+
+    IConn* server_conn2 = server_conn_handler2.wait_established();
+
+    POINTERS_EQUAL(server_conn2, acceptor.wait_added());
+    UNSIGNED_LONGS_EQUAL(2, acceptor.num_added());
+
+    wait_writable_readable(server_conn_handler2, server_conn2, true, false);
+    wait_writable_readable(client_conn_handler2, client_conn2, true, false);
+
+    terminate_and_wait(server_conn_handler2, server_conn2, test::ExpectNotFailed);
+    terminate_and_wait(client_conn_handler2, client_conn2, test::ExpectNotFailed);
+
+    POINTERS_EQUAL(&server_conn_handler2, acceptor.wait_removed());
+}
+
 TEST(tcp_ports, connect_error) {
     test::MockConnHandler client_conn_handler1;
     test::MockConnHandler client_conn_handler2;
@@ -11,6 +11,7 @@
 #include "roc_address/socket_addr.h"
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/heap_arena.h"
+#include "roc_core/semaphore.h"
 #include "roc_core/slab_pool.h"
 #include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
@@ -22,7 +23,7 @@ namespace netio {
 
 namespace {
 
-enum { NumIterations = 10, NumPackets = 7, BufferSize = 125 };
+enum { NumIterations = 10, NumPackets = 7, NumBurstPackets = 100, BufferSize = 125 };
 
 core::HeapArena arena;
 
@@ -181,6 +182,38 @@ void check_packet(const packet::PacketPtr& pp,
     }
 }
 
+// Blocks network thread on first packet until released by test.
+class GateWriter : public packet::IWriter {
+public:
+    explicit GateWriter(packet::IWriter& writer)
+        : writer_(writer)
+        , first_(true) {
+    }
+
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& pp) {
+        if (first_) {
+            first_ = false;
+            entered_.post();
+            released_.wait();
+        }
+        return writer_.write(pp);
+    }
+
+    void wait_entered() {
+        entered_.wait();
+    }
+
+    void release() {
+        released_.post();
+    }
+
+private:
+    packet::IWriter& writer_;
+    bool first_;
+    core::Semaphore entered_;
+    core::Semaphore released_;
+};
+
 } // namespace
 
 TEST_GROUP(udp_io) {};
@@ -276,6 +309,365 @@ TEST(udp_io, one_sender_one_receiver_separate_loops) {
     }
 }
 
+TEST(udp_io, one_sender_one_receiver_burst) {
+    for (int batch_recv = 0; batch_recv <= 1; batch_recv++) {
+        packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+        UdpConfig tx_config = make_udp_config();
+        UdpConfig rx_config = make_udp_config();
+
+        rx_config.enable_batch_recv = (batch_recv == 1);
+
+        NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+        CHECK(tx_loop.is_valid());
+
+        packet::IWriter* tx_writer = NULL;
+        CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+        CHECK(tx_writer);
+
+        NetworkLoop rx_loop(packet_pool, buffer_pool, arena);
+        CHECK(rx_loop.is_valid());
+        CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+        for (int i = 0; i < NumIterations; i++) {
+            // Send packets without delays, so that many of them are
+            // pending in socket when receiver wakes up.
+            for (int p = 0; p < NumBurstPackets; p++) {
+                LONGS_EQUAL(status::StatusOK,
+                            tx_writer->write(new_packet(tx_config, rx_config, p)));
+            }
+            for (int p = 0; p < NumBurstPackets; p++) {
+                packet::PacketPtr pp;
+                LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+                check_packet(pp, tx_config, rx_config, p, i);
+            }
+        }
+    }
+}
+
+// Check that port drains several full batches per wakeup, but no more than
+// the limit, so that a flooded port doesn't starve other ports of same loop.
+TEST(udp_io, batch_recv_per_event_limit) {
+    // Must match UdpPort limits.
+    enum { RecvBatch = 32, RecvBatchesPerEvent = 8 };
+    enum { MaxPerEvent = RecvBatch * RecvBatchesPerEvent, NumFlood = MaxPerEvent * 2 };
+
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+    GateWriter gate_writer(rx_queue);
+
+    UdpConfig tx_config = make_udp_config();
+    UdpConfig rx_config_a = make_udp_config();
+    UdpConfig rx_config_b = make_udp_config();
+
+    rx_config_a.enable_batch_recv = true;
+    rx_config_a.recv_buffer_size = 1024 * 1024;
+    rx_config_b.enable_batch_recv = true;
+
+    NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+    CHECK(tx_loop.is_valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_pool, buffer_pool, arena);
+    CHECK(rx_loop.is_valid());
+    CHECK(add_udp_receiver(rx_loop, rx_config_a, gate_writer));
+    CHECK(add_udp_receiver(rx_loop, rx_config_b, rx_queue));
+
+    // Block network thread of receiver on first packet.
+    LONGS_EQUAL(status::StatusOK,
+                tx_writer->write(new_packet(tx_config, rx_config_a, 0)));
+    gate_writer.wait_entered();
+
+    // While it's blocked, flood first port and send one packet to second port.
+    for (int p = 1; p <= NumFlood; p++) {
+        LONGS_EQUAL(status::StatusOK,
+                    tx_writer->write(new_packet(tx_config, rx_config_a, p)));
+    }
+    LONGS_EQUAL(status::StatusOK,
+                tx_writer->write(new_packet(tx_config, rx_config_b, 0)));
+
+    core::sleep_for(core::ClockMonotonic, core::Millisecond * 100);
+    gate_writer.release();
+
+    int next_a = 0;
+    int pos_b = -1;
+
+    for (int n = 0; n < NumFlood + 2; n++) {
+        packet::PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+        CHECK(pp);
+
+        if (pp->udp()->dst_addr == rx_config_b.bind_address) {
+            check_packet(pp, tx_config, rx_config_b, 0, 0);
+            pos_b = n;
+        } else {
+            check_packet(pp, tx_config, rx_config_a, next_a, 0);
+            next_a++;
+        }
+    }
+
+    LONGS_EQUAL(NumFlood + 1, next_a);
+
+    // Packet of second port is received either before flood, if its port
+    // was handled first, or right after first port drained exactly
+    // RecvBatchesPerEvent full batches and returned to event loop.
+    CHECK(pos_b == 1 || pos_b == 1 + MaxPerEvent);
+}
+
+TEST(udp_io, one_sender_one_receiver_small_buffers) {
+    enum { LargeBufferSize = BufferSize * 4 };
+
+    core::SlabPool<core::Buffer> large_buffer_pool(
+        "large_buffer_pool", arena, sizeof(core::Buffer) + LargeBufferSize);
+    core::SlabPool<core::Buffer> small_buffer_pool(
+        "small_buffer_pool", arena, sizeof(core::Buffer) + BufferSize);
+
+    for (int batch_recv = 0; batch_recv <= 1; batch_recv++) {
+        packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+        UdpConfig tx_config = make_udp_config();
+        UdpConfig rx_config = make_udp_config();
+
+        rx_config.enable_batch_recv = (batch_recv == 1);
+
+        NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+        CHECK(tx_loop.is_valid());
+
+        packet::IWriter* tx_writer = NULL;
+        CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+        CHECK(tx_writer);
+
+        NetworkLoop rx_loop(packet_pool, large_buffer_pool, arena);
+        CHECK(rx_loop.is_valid());
+        rx_loop.add_small_packet_buffer_pool(small_buffer_pool);
+        CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+        for (int i = 0; i < NumIterations; i++) {
+            for (int p = 0; p < NumBurstPackets; p++) {
+                LONGS_EQUAL(status::StatusOK,
+                            tx_writer->write(new_packet(tx_config, rx_config, p)));
+            }
+            for (int p = 0; p < NumBurstPackets; p++) {
+                packet::PacketPtr pp;
+                LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+                check_packet(pp, tx_config, rx_config, p, i);
+
+                // packet was moved to small buffer
+                UNSIGNED_LONGS_EQUAL(BufferSize, pp->buffer().capacity());
+            }
+        }
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_batch_send) {
+    enum { ModeNoBatch, ModeBatch, ModeBatchGso, ModeMax };
+
+    for (int mode = 0; mode < ModeMax; mode++) {
+        packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+        UdpConfig tx_config = make_udp_config();
+        UdpConfig rx_config = make_udp_config();
+
+        // Force all packets to go through network thread.
+        tx_config.enable_non_blocking = false;
+        tx_config.enable_batch_send = (mode != ModeNoBatch);
+        tx_config.enable_gso = (mode == ModeBatchGso);
+
+        NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+        CHECK(tx_loop.is_valid());
+
+        packet::IWriter* tx_writer = NULL;
+        CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+        CHECK(tx_writer);
+
+        NetworkLoop rx_loop(packet_pool, buffer_pool, arena);
+        CHECK(rx_loop.is_valid());
+        CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+        for (int i = 0; i < NumIterations; i++) {
+            for (int p = 0; p < NumBurstPackets; p++) {
+                LONGS_EQUAL(status::StatusOK,
+                            tx_writer->write(new_packet(tx_config, rx_config, p)));
+            }
+            for (int p = 0; p < NumBurstPackets; p++) {
+                packet::PacketPtr pp;
+                LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+                check_packet(pp, tx_config, rx_config, p, i);
+            }
+        }
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_busy_poll) {
+    packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+    UdpConfig tx_config = make_udp_config();
+    UdpConfig rx_config = make_udp_config();
+
+    // Force all packets to go through network thread.
+    tx_config.enable_non_blocking = false;
+    tx_config.send_busy_poll = 5 * core::Millisecond;
+
+    NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+    CHECK(tx_loop.is_valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_pool, buffer_pool, arena);
+    CHECK(rx_loop.is_valid());
+    CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            LONGS_EQUAL(status::StatusOK,
+                        tx_writer->write(new_packet(tx_config, rx_config, p)));
+            core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            packet::PacketPtr pp;
+            LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+            check_packet(pp, tx_config, rx_config, p, i);
+        }
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_inline) {
+    UdpConfig tx_config = make_udp_config();
+    UdpConfig rx_config = make_udp_config();
+
+    rx_config.enable_inline_recv = true;
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_udp_sender(net_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    NetworkLoop::Tasks::AddUdpPort add_task(rx_config);
+    CHECK(net_loop.schedule_and_wait(add_task));
+
+    // Socket is read by this thread instead of network thread.
+    NetworkLoop::Tasks::StartUdpInlineRecv recv_task(add_task.get_handle());
+    CHECK(net_loop.schedule_and_wait(recv_task));
+
+    packet::IReader& rx_reader = recv_task.get_inbound_reader();
+
+    for (int i = 0; i < NumIterations; i++) {
+        packet::PacketPtr pp;
+        LONGS_EQUAL(status::StatusNoData, rx_reader.read(pp));
+
+        for (int p = 0; p < NumPackets; p++) {
+            LONGS_EQUAL(status::StatusOK,
+                        tx_writer->write(new_packet(tx_config, rx_config, p)));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            // Reader doesn't block, so poll it until packet arrives.
+            status::StatusCode code;
+            while ((code = rx_reader.read(pp)) == status::StatusNoData) {
+                short_delay();
+            }
+            LONGS_EQUAL(status::StatusOK, code);
+            check_packet(pp, tx_config, rx_config, p, i);
+        }
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_kernel_timestamps) {
+    for (int batch_recv = 0; batch_recv <= 1; batch_recv++) {
+        packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+        UdpConfig tx_config = make_udp_config();
+        UdpConfig rx_config = make_udp_config();
+
+        rx_config.enable_batch_recv = (batch_recv == 1);
+        rx_config.enable_kernel_timestamps = true;
+
+        NetworkLoop tx_loop(packet_pool, buffer_pool, arena);
+        CHECK(tx_loop.is_valid());
+
+        packet::IWriter* tx_writer = NULL;
+        CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+        CHECK(tx_writer);
+
+        NetworkLoop rx_loop(packet_pool, buffer_pool, arena);
+        CHECK(rx_loop.is_valid());
+        CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+        for (int i = 0; i < NumIterations; i++) {
+            const core::nanoseconds_t send_ts = core::timestamp(core::ClockUnix);
+
+            for (int p = 0; p < NumBurstPackets; p++) {
+                LONGS_EQUAL(status::StatusOK,
+                            tx_writer->write(new_packet(tx_config, rx_config, p)));
+            }
+
+            core::nanoseconds_t prev_recv_ts = send_ts;
+
+            for (int p = 0; p < NumBurstPackets; p++) {
+                packet::PacketPtr pp;
+                LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+                check_packet(pp, tx_config, rx_config, p, i);
+
+                // Whether timestamp comes from kernel or from user space,
+                // it should be in Unix clock domain and follow packet order.
+                CHECK(pp->udp()->receive_timestamp >= prev_recv_ts);
+                CHECK(pp->udp()->receive_timestamp
+                      <= core::timestamp(core::ClockUnix));
+
+                prev_recv_ts = pp->udp()->receive_timestamp;
+            }
+        }
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_paced) {
+    enum { ModeBatch, ModeNoBatch, ModeMax };
+
+    const core::nanoseconds_t PacketInterval = 5 * core::Millisecond;
+
+    for (int mode = 0; mode < ModeMax; mode++) {
+        packet::ConcurrentQueue rx_queue(packet::ConcurrentQueue::Blocking);
+
+        UdpConfig tx_config = make_udp_config();
+        UdpConfig rx_config = make_udp_config();
+
+        tx_config.enable_batch_send = (mode == ModeBatch);
+
+        NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+        CHECK(net_loop.is_valid());
+
+        packet::IWriter* tx_writer = NULL;
+        CHECK(add_udp_sender(net_loop, tx_config, &tx_writer));
+        CHECK(tx_writer);
+
+        CHECK(add_udp_receiver(net_loop, rx_config, rx_queue));
+
+        core::nanoseconds_t send_ts[NumPackets] = {};
+
+        // Packets are written at once, but should be sent not earlier than
+        // their send timestamps.
+        const core::nanoseconds_t start_ts = core::timestamp(core::ClockMonotonic);
+        for (int p = 0; p < NumPackets; p++) {
+            packet::PacketPtr pp = new_packet(tx_config, rx_config, p);
+            send_ts[p] = start_ts + PacketInterval * (p + 1);
+            pp->udp()->send_timestamp = send_ts[p];
+            LONGS_EQUAL(status::StatusOK, tx_writer->write(pp));
+        }
+
+        for (int p = 0; p < NumPackets; p++) {
+            packet::PacketPtr pp;
+            LONGS_EQUAL(status::StatusOK, rx_queue.read(pp));
+            check_packet(pp, tx_config, rx_config, p, 0);
+            CHECK(core::timestamp(core::ClockMonotonic) >= send_ts[p]);
+        }
+    }
+}
+
 TEST(udp_io, one_sender_many_receivers) {
     packet::ConcurrentQueue rx_queue1(packet::ConcurrentQueue::Blocking);
     packet::ConcurrentQueue rx_queue2(packet::ConcurrentQueue::Blocking);
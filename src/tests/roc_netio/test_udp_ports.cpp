@@ -74,6 +74,17 @@ bool start_recv(NetworkLoop& net_loop,
     return true;
 }
 
+bool start_inline_recv(NetworkLoop& net_loop, NetworkLoop::PortHandle port_handle) {
+    NetworkLoop::Tasks::StartUdpInlineRecv recv_task(port_handle);
+    CHECK(!recv_task.success());
+    if (!net_loop.schedule_and_wait(recv_task)) {
+        CHECK(!recv_task.success());
+        return false;
+    }
+    CHECK(recv_task.success());
+    return true;
+}
+
 } // namespace
 
 TEST_GROUP(udp_ports) {};
@@ -375,6 +386,97 @@ TEST(udp_ports, multicast_receiver_error) {
     LONGS_EQUAL(0, net_loop.num_ports());
 }
 
+TEST(udp_ports, multicast_sender) {
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    LONGS_EQUAL(0, net_loop.num_ports());
+
+    { // default
+        UdpConfig tx_config = make_udp_config("0.0.0.0", 0);
+
+        NetworkLoop::PortHandle tx_handle = add_port(net_loop, tx_config);
+        CHECK(tx_handle);
+        CHECK(start_send(net_loop, tx_handle));
+
+        remove_port(net_loop, tx_handle);
+    }
+    { // ttl and loop
+        UdpConfig tx_config = make_udp_config("0.0.0.0", 0);
+        tx_config.multicast_ttl = 16;
+        tx_config.enable_multicast_loop = false;
+
+        NetworkLoop::PortHandle tx_handle = add_port(net_loop, tx_config);
+        CHECK(tx_handle);
+        CHECK(start_send(net_loop, tx_handle));
+
+        remove_port(net_loop, tx_handle);
+    }
+    { // invalid ttl
+        UdpConfig tx_config = make_udp_config("0.0.0.0", 0);
+        tx_config.multicast_ttl = 1000;
+
+        NetworkLoop::PortHandle tx_handle = add_port(net_loop, tx_config);
+        CHECK(tx_handle);
+        CHECK(!start_send(net_loop, tx_handle));
+
+        remove_port(net_loop, tx_handle);
+    }
+
+    LONGS_EQUAL(0, net_loop.num_ports());
+}
+
+TEST(udp_ports, socket_options) {
+    packet::ConcurrentQueue queue(packet::ConcurrentQueue::Blocking);
+
+    NetworkLoop net_loop(packet_pool, buffer_pool, arena);
+    CHECK(net_loop.is_valid());
+
+    LONGS_EQUAL(0, net_loop.num_ports());
+
+    { // buffer sizes and dscp
+        UdpConfig config = make_udp_config("127.0.0.1", 0);
+        config.recv_buffer_size = 256 * 1024;
+        config.send_buffer_size = 256 * 1024;
+        config.dscp = 46;
+
+        NetworkLoop::PortHandle handle = add_port(net_loop, config);
+        CHECK(handle);
+        CHECK(start_send(net_loop, handle));
+        CHECK(start_recv(net_loop, handle, queue));
+
+        remove_port(net_loop, handle);
+    }
+    { // invalid dscp
+        UdpConfig config = make_udp_config("127.0.0.1", 0);
+        config.dscp = 64;
+
+        CHECK(!add_port(net_loop, config));
+    }
+    { // inline receiving
+        UdpConfig config = make_udp_config("127.0.0.1", 0);
+        config.enable_inline_recv = true;
+
+        NetworkLoop::PortHandle handle = add_port(net_loop, config);
+        CHECK(handle);
+        CHECK(!start_recv(net_loop, handle, queue));
+        CHECK(start_inline_recv(net_loop, handle));
+
+        remove_port(net_loop, handle);
+    }
+    { // inline receiving not enabled
+        UdpConfig config = make_udp_config("127.0.0.1", 0);
+
+        NetworkLoop::PortHandle handle = add_port(net_loop, config);
+        CHECK(handle);
+        CHECK(!start_inline_recv(net_loop, handle));
+
+        remove_port(net_loop, handle);
+    }
+
+    LONGS_EQUAL(0, net_loop.num_ports());
+}
+
 TEST(udp_ports, bidirectional) {
     packet::ConcurrentQueue queue(packet::ConcurrentQueue::Blocking);
 
@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/buffer.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/mutex.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_node/async_sink.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+enum {
+    SampleRate = 48000,
+    NumCh = 2,
+    ChMask = 0x3,
+    FrameSize = SampleRate / 1000 * NumCh,
+    MaxBufSize = FrameSize * 2,
+    MaxSamples = FrameSize * 100
+};
+
+const core::nanoseconds_t FrameLen = core::Millisecond;
+
+const audio::SampleSpec sample_spec(SampleRate,
+                                    audio::Sample_RawFormat,
+                                    audio::ChanLayout_Surround,
+                                    audio::ChanOrder_Smpte,
+                                    ChMask);
+
+core::HeapArena arena;
+core::SlabPool<core::Buffer> buffer_pool("buffer_pool",
+                                         arena,
+                                         sizeof(core::Buffer)
+                                             + MaxBufSize * sizeof(audio::sample_t));
+
+core::ThreadConfig thread_config;
+
+// Records samples. Writes can be held by locking gate.
+class MockSink : public sndio::ISink, public core::NonCopyable<> {
+public:
+    MockSink()
+        : last_frame_(NULL)
+        , n_samples_(0)
+        , n_writes_(0) {
+    }
+
+    virtual sndio::ISink* to_sink() {
+        return this;
+    }
+
+    virtual sndio::ISource* to_source() {
+        return NULL;
+    }
+
+    virtual sndio::DeviceType type() const {
+        return sndio::DeviceType_Sink;
+    }
+
+    virtual sndio::DeviceState state() const {
+        return sndio::DeviceState_Active;
+    }
+
+    virtual void pause() {
+    }
+
+    virtual bool resume() {
+        return true;
+    }
+
+    virtual bool restart() {
+        return true;
+    }
+
+    virtual audio::SampleSpec sample_spec() const {
+        return node::sample_spec;
+    }
+
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
+    virtual bool has_latency() const {
+        return false;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+
+    virtual void write(audio::Frame& frame) {
+        n_writes_++;
+
+        core::Mutex::Lock lock(gate_);
+
+        CHECK(frame.capture_timestamp() != 0);
+        UNSIGNED_LONGS_EQUAL(frame.num_raw_samples() / NumCh, frame.duration());
+
+        const size_t n_samples = (size_t)n_samples_;
+        CHECK(n_samples + frame.num_raw_samples() <= MaxSamples);
+
+        memcpy(samples_ + n_samples, frame.raw_samples(),
+               frame.num_raw_samples() * sizeof(audio::sample_t));
+
+        n_samples_ = n_samples + frame.num_raw_samples();
+        last_frame_ = frame.raw_samples();
+    }
+
+    core::Mutex& gate() {
+        return gate_;
+    }
+
+    size_t num_samples() const {
+        return (size_t)n_samples_;
+    }
+
+    size_t num_writes() const {
+        return (size_t)n_writes_;
+    }
+
+    const audio::sample_t* last_frame() {
+        core::Mutex::Lock lock(gate_);
+        return last_frame_;
+    }
+
+    // Check that n-th frame written to async sink has given number.
+    void expect_frame(size_t index, size_t frame_num) const {
+        for (size_t n = 0; n < FrameSize; n++) {
+            DOUBLES_EQUAL((double)frame_num, (double)samples_[index * FrameSize + n], 0);
+        }
+    }
+
+private:
+    core::Mutex gate_;
+
+    audio::sample_t samples_[MaxSamples];
+    const audio::sample_t* last_frame_;
+    core::Atomic<size_t> n_samples_;
+    core::Atomic<size_t> n_writes_;
+};
+
+void write_frame(sndio::ISink& sink, size_t frame_num) {
+    audio::sample_t samples[FrameSize];
+    for (size_t n = 0; n < FrameSize; n++) {
+        samples[n] = (audio::sample_t)frame_num;
+    }
+
+    audio::Frame frame(samples, FrameSize);
+    sink.write(frame);
+}
+
+void fill_frame(audio::sample_t* samples, size_t frame_num) {
+    for (size_t n = 0; n < FrameSize; n++) {
+        samples[n] = (audio::sample_t)frame_num;
+    }
+}
+
+core::Atomic<int> n_released;
+
+void release_frame(void* arg) {
+    CHECK(arg == &n_released);
+    n_released++;
+}
+
+void wait_samples(const MockSink& sink, size_t num_samples) {
+    while (sink.num_samples() < num_samples) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+}
+
+void wait_writes(const MockSink& sink, size_t num_writes) {
+    while (sink.num_writes() < num_writes) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+}
+
+class Writer : public core::Thread {
+public:
+    Writer(sndio::ISink& sink, size_t num_frames)
+        : sink_(sink)
+        , num_frames_(num_frames)
+        , done_(0) {
+    }
+
+    bool done() const {
+        return done_ != 0;
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < num_frames_; n++) {
+            write_frame(sink_, n);
+        }
+        done_ = 1;
+    }
+
+    sndio::ISink& sink_;
+    const size_t num_frames_;
+    core::Atomic<int> done_;
+};
+
+} // namespace
+
+TEST_GROUP(async_sink) {
+    void setup() {
+        n_released = 0;
+    }
+};
+
+TEST(async_sink, forward) {
+    enum { NumFrames = 50 };
+
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 10;
+
+    AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+    CHECK(async_sink.is_valid());
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        write_frame(async_sink, n);
+    }
+
+    wait_samples(mock_sink, NumFrames * FrameSize);
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        mock_sink.expect_frame(n, n);
+    }
+
+    const AsyncSinkMetrics metrics = async_sink.metrics();
+
+    CHECK_EQUAL(FrameLen * 10, metrics.queue_capacity);
+    CHECK_EQUAL(0, metrics.queue_length);
+    CHECK(metrics.peak_queue_length >= FrameLen);
+    CHECK(metrics.peak_queue_length <= FrameLen * 10);
+    CHECK_EQUAL(0, metrics.dropped_length);
+}
+
+TEST(async_sink, overflow_drop) {
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 4;
+    config.overflow_policy = AsyncOverflow_Drop;
+
+    AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+    CHECK(async_sink.is_valid());
+
+    mock_sink.gate().lock();
+
+    // Frame 0 is dequeued and is stuck in underlying sink.
+    write_frame(async_sink, 0);
+    wait_writes(mock_sink, 1);
+
+    // Frames 1-4 fill queue, frames 5-6 are dropped.
+    for (size_t n = 1; n <= 6; n++) {
+        write_frame(async_sink, n);
+    }
+
+    AsyncSinkMetrics metrics = async_sink.metrics();
+
+    CHECK_EQUAL(FrameLen * 4, metrics.queue_length);
+    CHECK_EQUAL(FrameLen * 4, metrics.peak_queue_length);
+    CHECK_EQUAL(FrameLen * 2, metrics.dropped_length);
+
+    mock_sink.gate().unlock();
+
+    wait_samples(mock_sink, FrameSize * 5);
+
+    for (size_t n = 0; n <= 4; n++) {
+        mock_sink.expect_frame(n, n);
+    }
+
+    metrics = async_sink.metrics();
+
+    CHECK_EQUAL(0, metrics.queue_length);
+    CHECK_EQUAL(FrameLen * 2, metrics.dropped_length);
+}
+
+TEST(async_sink, overflow_overwrite) {
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 4;
+    config.overflow_policy = AsyncOverflow_Overwrite;
+
+    AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+    CHECK(async_sink.is_valid());
+
+    mock_sink.gate().lock();
+
+    // Frame 0 is dequeued and is stuck in underlying sink.
+    write_frame(async_sink, 0);
+    wait_writes(mock_sink, 1);
+
+    // Frames 1-4 fill queue, frames 5-6 replace frames 1-2.
+    for (size_t n = 1; n <= 6; n++) {
+        write_frame(async_sink, n);
+    }
+
+    AsyncSinkMetrics metrics = async_sink.metrics();
+
+    CHECK_EQUAL(FrameLen * 4, metrics.queue_length);
+    CHECK_EQUAL(FrameLen * 2, metrics.dropped_length);
+
+    mock_sink.gate().unlock();
+
+    wait_samples(mock_sink, FrameSize * 5);
+
+    mock_sink.expect_frame(0, 0);
+    for (size_t n = 1; n <= 4; n++) {
+        mock_sink.expect_frame(n, n + 2);
+    }
+}
+
+TEST(async_sink, overflow_block) {
+    enum { NumFrames = 20 };
+
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 4;
+    config.overflow_policy = AsyncOverflow_Block;
+
+    AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+    CHECK(async_sink.is_valid());
+
+    mock_sink.gate().lock();
+
+    Writer writer(async_sink, NumFrames);
+    CHECK(writer.start());
+
+    // Writer fills queue and waits.
+    core::sleep_for(core::ClockMonotonic, core::Millisecond * 20);
+    CHECK(!writer.done());
+
+    mock_sink.gate().unlock();
+    writer.join();
+
+    wait_samples(mock_sink, NumFrames * FrameSize);
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        mock_sink.expect_frame(n, n);
+    }
+
+    const AsyncSinkMetrics metrics = async_sink.metrics();
+
+    CHECK_EQUAL(FrameLen * 4, metrics.peak_queue_length);
+    CHECK_EQUAL(0, metrics.dropped_length);
+}
+
+TEST(async_sink, flush_on_destroy) {
+    enum { NumFrames = 4 };
+
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    {
+        AsyncSinkConfig config;
+        config.queue_length = FrameLen * NumFrames;
+
+        AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+        CHECK(async_sink.is_valid());
+
+        mock_sink.gate().lock();
+
+        write_frame(async_sink, 0);
+        wait_writes(mock_sink, 1);
+
+        for (size_t n = 1; n < NumFrames; n++) {
+            write_frame(async_sink, n);
+        }
+
+        mock_sink.gate().unlock();
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumFrames * FrameSize, mock_sink.num_samples());
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        mock_sink.expect_frame(n, n);
+    }
+}
+
+TEST(async_sink, write_ref) {
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 4;
+
+    AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+    CHECK(async_sink.is_valid());
+
+    audio::sample_t ref_samples[2][FrameSize];
+    fill_frame(ref_samples[0], 1);
+    fill_frame(ref_samples[1], 3);
+
+    mock_sink.gate().lock();
+
+    // Frame 0 is dequeued and is stuck in underlying sink.
+    write_frame(async_sink, 0);
+    wait_writes(mock_sink, 1);
+
+    // Mix frames written by copy and by reference.
+    audio::Frame frame1(ref_samples[0], FrameSize);
+    CHECK(async_sink.write_ref(frame1, release_frame, &n_released));
+    write_frame(async_sink, 2);
+    audio::Frame frame3(ref_samples[1], FrameSize);
+    CHECK(async_sink.write_ref(frame3, release_frame, &n_released));
+    write_frame(async_sink, 4);
+
+    CHECK_EQUAL(FrameLen * 4, async_sink.metrics().queue_length);
+    CHECK_EQUAL(0, (int)n_released);
+
+    mock_sink.gate().unlock();
+
+    wait_samples(mock_sink, FrameSize * 5);
+
+    // Order is preserved.
+    for (size_t n = 0; n <= 4; n++) {
+        mock_sink.expect_frame(n, n);
+    }
+
+    while (n_released != 2) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+
+    // Frame written by reference is passed to underlying sink as is.
+    audio::Frame frame5(ref_samples[0], FrameSize);
+    CHECK(async_sink.write_ref(frame5, release_frame, &n_released));
+
+    while (n_released != 3) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+
+    CHECK(mock_sink.last_frame() == ref_samples[0]);
+}
+
+TEST(async_sink, write_ref_overflow) {
+    ctl::ControlTaskQueue queue(thread_config);
+    CHECK(queue.is_valid());
+
+    MockSink mock_sink;
+
+    AsyncSinkConfig config;
+    config.queue_length = FrameLen * 2;
+    config.overflow_policy = AsyncOverflow_Overwrite;
+    config.max_references = 2;
+
+    audio::sample_t ref_samples[3][FrameSize];
+    for (size_t n = 0; n < 3; n++) {
+        fill_frame(ref_samples[n], n + 1);
+    }
+
+    {
+        AsyncSink async_sink(mock_sink, queue, config, buffer_pool, arena);
+        CHECK(async_sink.is_valid());
+
+        mock_sink.gate().lock();
+
+        // Frame 0 is dequeued and is stuck in underlying sink.
+        write_frame(async_sink, 0);
+        wait_writes(mock_sink, 1);
+
+        // Frames 1-2 take all reference slots, frame 3 is rejected.
+        for (size_t n = 0; n < 3; n++) {
+            audio::Frame frame(ref_samples[n], FrameSize);
+            CHECK_EQUAL(n < 2,
+                        async_sink.write_ref(frame, release_frame, &n_released));
+        }
+
+        // Frames 4-5 fill queue, frame 6 replaces frame 4, references are kept.
+        for (size_t n = 4; n <= 6; n++) {
+            write_frame(async_sink, n);
+        }
+
+        const AsyncSinkMetrics metrics = async_sink.metrics();
+
+        CHECK_EQUAL(FrameLen * 4, metrics.queue_length);
+        CHECK_EQUAL(FrameLen, metrics.dropped_length);
+
+        mock_sink.gate().unlock();
+    }
+
+    UNSIGNED_LONGS_EQUAL(FrameSize * 5, mock_sink.num_samples());
+    CHECK_EQUAL(2, (int)n_released);
+
+    mock_sink.expect_frame(0, 0);
+    mock_sink.expect_frame(1, 1);
+    mock_sink.expect_frame(2, 2);
+    mock_sink.expect_frame(3, 5);
+    mock_sink.expect_frame(4, 6);
+}
+
+} // namespace node
+} // namespace roc
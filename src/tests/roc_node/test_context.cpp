@@ -8,10 +8,15 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "roc_address/endpoint_uri.h"
 #include "roc_core/heap_arena.h"
+#include "roc_core/time.h"
 #include "roc_node/context.h"
 #include "roc_node/receiver.h"
+#include "roc_node/receiver_decoder.h"
+#include "roc_node/runtime.h"
 #include "roc_node/sender.h"
+#include "roc_node/sender_encoder.h"
 
 namespace roc {
 namespace node {
@@ -50,5 +55,430 @@ TEST(context, reference_counting) {
     CHECK(context.getref() == 0);
 }
 
+TEST(context, network_threads) {
+    { // default
+        ContextConfig context_config;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+        UNSIGNED_LONGS_EQUAL(1, context.num_network_loops());
+
+        CHECK(&context.select_network_loop() == &context.network_loop());
+        CHECK(&context.select_network_loop() == &context.network_loop());
+    }
+    { // multiple
+        ContextConfig context_config;
+        context_config.network_threads = 3;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+        UNSIGNED_LONGS_EQUAL(3, context.num_network_loops());
+
+        netio::NetworkLoop* loop1 = &context.select_network_loop();
+        netio::NetworkLoop* loop2 = &context.select_network_loop();
+        netio::NetworkLoop* loop3 = &context.select_network_loop();
+
+        CHECK(loop1 == &context.network_loop());
+        CHECK(loop2 != loop1);
+        CHECK(loop3 != loop1);
+        CHECK(loop3 != loop2);
+
+        CHECK(&context.select_network_loop() == loop1);
+        CHECK(&context.select_network_loop() == loop2);
+        CHECK(&context.select_network_loop() == loop3);
+    }
+    { // zero
+        ContextConfig context_config;
+        context_config.network_threads = 0;
+        Context context(context_config, arena);
+
+        CHECK(!context.is_valid());
+    }
+}
+
+TEST(context, shared_runtime) {
+    UNSIGNED_LONGS_EQUAL(0, Runtime::num_shared_users());
+
+    {
+        ContextConfig context_config;
+        context_config.shared_runtime = true;
+        context_config.network_threads = 2;
+
+        Context context1(context_config, arena);
+        CHECK(context1.is_valid());
+
+        // Runtime parameters of other contexts are ignored.
+        context_config.network_threads = 3;
+
+        Context context2(context_config, arena);
+        CHECK(context2.is_valid());
+
+        // Shared runtime is acquired when threads are started.
+        UNSIGNED_LONGS_EQUAL(0, Runtime::num_shared_users());
+
+        CHECK(context1.start_runtime());
+        CHECK(context2.start_runtime());
+
+        UNSIGNED_LONGS_EQUAL(2, Runtime::num_shared_users());
+        UNSIGNED_LONGS_EQUAL(2, context2.num_network_loops());
+
+        CHECK(&context1.network_loop() == &context2.network_loop());
+        CHECK(&context1.control_loop() == &context2.control_loop());
+
+        // Pools are separate.
+        CHECK(&context1.packet_pool() != &context2.packet_pool());
+        CHECK(&context1.packet_factory() != &context2.packet_factory());
+
+        // Context without option has its own runtime.
+        ContextConfig own_config;
+        Context context3(own_config, arena);
+        CHECK(context3.is_valid());
+
+        CHECK(&context3.network_loop() != &context1.network_loop());
+        CHECK(&context3.control_loop() != &context1.control_loop());
+        UNSIGNED_LONGS_EQUAL(2, Runtime::num_shared_users());
+
+        {
+            pipeline::ReceiverSourceConfig receiver_config;
+            Receiver receiver1(context1, receiver_config);
+            Receiver receiver2(context2, receiver_config);
+            CHECK(receiver1.is_valid());
+            CHECK(receiver2.is_valid());
+
+            address::EndpointUri endp1(arena);
+            CHECK(address::parse_endpoint_uri(
+                "rtp://127.0.0.1:0", address::EndpointUri::Subset_Full, endp1));
+            CHECK(receiver1.bind(0, address::Iface_AudioSource, endp1));
+
+            address::EndpointUri endp2(arena);
+            CHECK(address::parse_endpoint_uri(
+                "rtp://127.0.0.1:0", address::EndpointUri::Subset_Full, endp2));
+            CHECK(receiver2.bind(0, address::Iface_AudioSource, endp2));
+
+            // Ports of both contexts are served by shared loops.
+            const size_t num_ports = context1.select_network_loop().num_ports()
+                + context1.select_network_loop().num_ports();
+            UNSIGNED_LONGS_EQUAL(2, num_ports);
+        }
+    }
+
+    // Shared runtime is destroyed with last context.
+    UNSIGNED_LONGS_EQUAL(0, Runtime::num_shared_users());
+
+    {
+        ContextConfig context_config;
+        context_config.shared_runtime = true;
+
+        Context context(context_config, arena);
+        CHECK(context.is_valid());
+
+        UNSIGNED_LONGS_EQUAL(1, context.num_network_loops());
+        UNSIGNED_LONGS_EQUAL(1, Runtime::num_shared_users());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, Runtime::num_shared_users());
+}
+
+TEST(context, lazy_runtime) {
+    { // started by request
+        ContextConfig context_config;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+        CHECK(!context.has_runtime());
+
+        CHECK(context.start_runtime());
+        CHECK(context.has_runtime());
+
+        CHECK(context.start_runtime());
+        CHECK(context.has_runtime());
+    }
+    { // not started by encoder and decoder
+        ContextConfig context_config;
+        Context context(context_config, arena);
+
+        {
+            pipeline::SenderSinkConfig sender_config;
+            SenderEncoder encoder(context, sender_config);
+            CHECK(encoder.is_valid());
+
+            pipeline::ReceiverSourceConfig receiver_config;
+            ReceiverDecoder decoder(context, receiver_config);
+            CHECK(decoder.is_valid());
+
+            CHECK(encoder.activate(address::Iface_AudioSource, address::Proto_RTP));
+            CHECK(decoder.activate(address::Iface_AudioSource, address::Proto_RTP));
+        }
+
+        CHECK(!context.has_runtime());
+    }
+    { // started by bind
+        ContextConfig context_config;
+        Context context(context_config, arena);
+
+        {
+            pipeline::ReceiverSourceConfig receiver_config;
+            Receiver receiver(context, receiver_config);
+            CHECK(receiver.is_valid());
+
+            CHECK(!context.has_runtime());
+
+            address::EndpointUri endp(arena);
+            CHECK(address::parse_endpoint_uri(
+                "rtp://127.0.0.1:0", address::EndpointUri::Subset_Full, endp));
+            CHECK(receiver.bind(0, address::Iface_AudioSource, endp));
+
+            CHECK(context.has_runtime());
+            UNSIGNED_LONGS_EQUAL(1, context.network_loop().num_ports());
+        }
+    }
+}
+
+TEST(context, pipeline_threads) {
+    { // default
+        ContextConfig context_config;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+        CHECK(context.pipeline_pool() == NULL);
+    }
+    { // enabled
+        ContextConfig context_config;
+        context_config.pipeline_threads = 2;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+        CHECK(context.pipeline_pool() != NULL);
+        UNSIGNED_LONGS_EQUAL(2, context.pipeline_pool()->num_threads());
+    }
+}
+
+TEST(context, numa_nodes) {
+    uint64_t node0_cpus = 0;
+    if (!core::NumaArena::get_node_cpus(1, node0_cpus) || node0_cpus == 0) {
+        // NUMA topology is not available on this system.
+        return;
+    }
+    { // existing node
+        ContextConfig context_config;
+        context_config.numa_nodes = 1;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+
+        void* packet = context.packet_pool().allocate();
+        CHECK(packet);
+        context.packet_pool().deallocate(packet);
+
+        void* buffer = context.frame_buffer_pool().allocate();
+        CHECK(buffer);
+        context.frame_buffer_pool().deallocate(buffer);
+    }
+    { // missing node
+        ContextConfig context_config;
+        context_config.numa_nodes = (uint64_t)1 << 63;
+        Context context(context_config, arena);
+
+        CHECK(!context.is_valid());
+    }
+}
+
+TEST(context, max_packets) {
+    { // preallocate
+        ContextConfig context_config;
+        context_config.prealloc_packets = 10;
+        context_config.prealloc_frames = 10;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+
+        const size_t num_allocs = arena.num_allocations();
+
+        void* buffers[100];
+        for (size_t n = 0; n < 10; n++) {
+            buffers[n] = context.packet_buffer_pool().allocate();
+            CHECK(buffers[n]);
+        }
+
+        // Served from preallocated memory.
+        UNSIGNED_LONGS_EQUAL(num_allocs, arena.num_allocations());
+
+        for (size_t n = 10; n < 100; n++) {
+            buffers[n] = context.packet_buffer_pool().allocate();
+            CHECK(buffers[n]);
+        }
+
+        // Pool grows on demand.
+        CHECK(arena.num_allocations() > num_allocs);
+
+        for (size_t n = 0; n < 100; n++) {
+            context.packet_buffer_pool().deallocate(buffers[n]);
+        }
+    }
+    { // limit
+        ContextConfig context_config;
+        context_config.max_packets = 16;
+        context_config.max_frames = 8;
+        Context context(context_config, arena);
+
+        CHECK(context.is_valid());
+
+        const size_t num_allocs = arena.num_allocations();
+
+        void* packets[16];
+        for (size_t n = 0; n < 16; n++) {
+            packets[n] = context.packet_pool().allocate();
+            CHECK(packets[n]);
+        }
+        CHECK(!context.packet_pool().allocate());
+
+        void* frames[8];
+        for (size_t n = 0; n < 8; n++) {
+            frames[n] = context.frame_buffer_pool().allocate();
+            CHECK(frames[n]);
+        }
+        CHECK(!context.frame_buffer_pool().allocate());
+
+        // Nothing allocated after startup.
+        UNSIGNED_LONGS_EQUAL(num_allocs, arena.num_allocations());
+
+        for (size_t n = 0; n < 16; n++) {
+            context.packet_pool().deallocate(packets[n]);
+        }
+        for (size_t n = 0; n < 8; n++) {
+            context.frame_buffer_pool().deallocate(frames[n]);
+        }
+    }
+    { // prealloc greater than limit
+        ContextConfig context_config;
+        context_config.prealloc_packets = 20;
+        context_config.max_packets = 10;
+        Context context(context_config, arena);
+
+        CHECK(!context.is_valid());
+    }
+}
+
+TEST(context, huge_pages) {
+    ContextConfig context_config;
+    context_config.huge_pages_size = 1024 * 1024;
+    Context context(context_config, arena);
+
+    CHECK(context.is_valid());
+
+    const size_t num_allocs = arena.num_allocations();
+
+    void* packet = context.packet_pool().allocate();
+    CHECK(packet);
+
+    void* buffer = context.frame_buffer_pool().allocate();
+    CHECK(buffer);
+
+    // Slabs are allocated from reserved memory.
+    UNSIGNED_LONGS_EQUAL(num_allocs, arena.num_allocations());
+
+    context.packet_pool().deallocate(packet);
+    context.frame_buffer_pool().deallocate(buffer);
+}
+
+TEST(context, pool_shrinker) {
+    ContextConfig context_config;
+    context_config.prealloc_packets = 10;
+    context_config.pool_shrinker.idle_period = 10 * core::Millisecond;
+    Context context(context_config, arena);
+
+    CHECK(context.is_valid());
+
+    // Shrinker is run by control thread.
+    CHECK(context.start_runtime());
+
+    const size_t num_allocs = arena.num_allocations();
+
+    void* buffers[100];
+    for (size_t n = 0; n < 100; n++) {
+        buffers[n] = context.packet_buffer_pool().allocate();
+        CHECK(buffers[n]);
+    }
+    for (size_t n = 0; n < 100; n++) {
+        context.packet_buffer_pool().deallocate(buffers[n]);
+    }
+
+    const size_t grown_allocs = arena.num_allocations();
+    CHECK(grown_allocs > num_allocs);
+
+    // Control thread releases memory after idle period.
+    for (size_t n = 0; n < 500; n++) {
+        if (context.get_metrics().packet_buffer_pool.shrink_events != 0) {
+            break;
+        }
+        core::sleep_for(core::ClockMonotonic, core::Millisecond * 10);
+    }
+
+    CHECK(context.get_metrics().packet_buffer_pool.shrink_events != 0);
+    CHECK(arena.num_allocations() < grown_allocs);
+
+    // Preallocated capacity is kept.
+    for (size_t n = 0; n < 10; n++) {
+        buffers[n] = context.packet_buffer_pool().allocate();
+        CHECK(buffers[n]);
+    }
+    for (size_t n = 0; n < 10; n++) {
+        context.packet_buffer_pool().deallocate(buffers[n]);
+    }
+}
+
+TEST(context, realtime) {
+    ContextConfig context_config;
+    context_config.realtime = true;
+    context_config.prealloc_packets = 10;
+    context_config.prealloc_frames = 10;
+    Context context(context_config, arena);
+
+    // Locking memory may be not permitted in test environment.
+    if (!context.is_valid()) {
+        return;
+    }
+
+    void* buffers[10];
+    for (size_t n = 0; n < 10; n++) {
+        buffers[n] = context.packet_buffer_pool().allocate();
+        CHECK(buffers[n]);
+    }
+    for (size_t n = 0; n < 10; n++) {
+        context.packet_buffer_pool().deallocate(buffers[n]);
+    }
+
+    const ContextMetrics metrics = context.get_metrics();
+
+    // Served from preallocated and locked memory.
+    UNSIGNED_LONGS_EQUAL(0, metrics.packet_buffer_pool.grow_events);
+    UNSIGNED_LONGS_EQUAL(0, metrics.major_page_faults);
+}
+
+TEST(context, media_clock) {
+    { // bad ptp device
+        ContextConfig context_config;
+        context_config.media_clock = core::MediaClock_Ptp;
+        context_config.ptp_device = "/nonexistent/ptp0";
+
+        Context context(context_config, arena);
+
+        CHECK(!context.is_valid());
+        LONGS_EQUAL(core::MediaClock_System, core::media_clock());
+    }
+    { // tai
+        ContextConfig context_config;
+        context_config.media_clock = core::MediaClock_Tai;
+
+        Context context(context_config, arena);
+
+        if (context.is_valid()) {
+            LONGS_EQUAL(core::MediaClock_Tai, core::media_clock());
+        }
+
+        CHECK(core::set_media_clock(core::MediaClock_System, NULL));
+    }
+}
+
 } // namespace node
 } // namespace roc
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/string_buffer.h"
+#include "roc_core/string_builder.h"
+#include "roc_core/time.h"
+#include "roc_netio/socket_ops.h"
+#include "roc_node/context.h"
+#include "roc_node/metrics_exporter.h"
+#include "roc_node/receiver.h"
+#include "roc_node/sender.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+enum { DefaultSlot = 0, MaxResponse = 64 * 1024 };
+
+const core::nanoseconds_t Timeout = 10 * core::Second;
+
+core::HeapArena arena;
+
+void parse_uri(address::EndpointUri& uri, const char* str) {
+    CHECK(address::parse_endpoint_uri(str, address::EndpointUri::Subset_Full, uri));
+    CHECK(uri.verify(address::EndpointUri::Subset_Full));
+}
+
+// Sends HTTP request and reads response until server closes connection.
+void http_request(const address::SocketAddr& server_address,
+                  const char* request,
+                  char* response,
+                  size_t response_size) {
+    netio::SocketHandle sock = -1;
+    CHECK(netio::socket_create(server_address.family(), netio::SocketType_Tcp, sock));
+
+    bool completed = false;
+    CHECK(netio::socket_begin_connect(sock, server_address, completed));
+
+    const core::nanoseconds_t deadline = core::timestamp(core::ClockMonotonic) + Timeout;
+
+    size_t n_sent = 0;
+    while (n_sent < strlen(request)) {
+        CHECK(core::timestamp(core::ClockMonotonic) < deadline);
+
+        const ssize_t ret =
+            netio::socket_try_send(sock, request + n_sent, strlen(request) - n_sent);
+        if (ret == netio::SockErr_WouldBlock) {
+            core::sleep_for(core::ClockMonotonic, core::Millisecond);
+            continue;
+        }
+        CHECK(ret > 0);
+        n_sent += (size_t)ret;
+    }
+
+    size_t n_recv = 0;
+    for (;;) {
+        CHECK(core::timestamp(core::ClockMonotonic) < deadline);
+        CHECK(n_recv < response_size - 1);
+
+        const ssize_t ret =
+            netio::socket_try_recv(sock, response + n_recv, response_size - n_recv - 1);
+        if (ret == netio::SockErr_WouldBlock) {
+            core::sleep_for(core::ClockMonotonic, core::Millisecond);
+            continue;
+        }
+        if (ret == netio::SockErr_StreamEnd || ret == 0) {
+            break;
+        }
+        CHECK(ret > 0);
+        n_recv += (size_t)ret;
+    }
+    response[n_recv] = '\0';
+
+    CHECK(netio::socket_close(sock));
+}
+
+} // namespace
+
+TEST_GROUP(metrics_exporter) {
+    ContextConfig context_config;
+    pipeline::ReceiverSourceConfig receiver_config;
+    pipeline::SenderSinkConfig sender_config;
+};
+
+TEST(metrics_exporter, format_receiver) {
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(receiver.is_valid());
+
+    address::EndpointUri source_endp(arena);
+    parse_uri(source_endp, "rtp://127.0.0.1:0");
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+    MetricsExporter exporter(context, arena);
+    CHECK(exporter.is_valid());
+
+    CHECK(exporter.add_receiver_slot(receiver, DefaultSlot));
+
+    core::StringBuffer buf(arena);
+    core::StringBuilder b(buf);
+    CHECK(exporter.format_metrics(b));
+
+    CHECK(strstr(buf.c_str(), "# TYPE roc_receiver_participants gauge\n"));
+    CHECK(strstr(buf.c_str(), "roc_receiver_participants{slot=\"0\"} 0\n"));
+    CHECK(strstr(buf.c_str(), "roc_receiver_frame_overruns_total{slot=\"0\"} 0\n"));
+    CHECK(strstr(buf.c_str(), "# TYPE roc_receiver_e2e_latency_seconds gauge\n"));
+    CHECK(strstr(buf.c_str(), "roc_pool_used_objects{pool=\"packet\"} "));
+    CHECK(strstr(buf.c_str(), "roc_pool_used_objects{pool=\"frame_buffer\"} "));
+
+    CHECK(!strstr(buf.c_str(), "roc_sender_"));
+}
+
+TEST(metrics_exporter, format_sender) {
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Sender sender(context, sender_config);
+    CHECK(sender.is_valid());
+
+    address::EndpointUri source_endp(arena);
+    parse_uri(source_endp, "rtp://127.0.0.1:123");
+    CHECK(sender.connect(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+    MetricsExporter exporter(context, arena);
+    CHECK(exporter.is_valid());
+
+    CHECK(exporter.add_sender_slot(sender, DefaultSlot));
+
+    core::StringBuffer buf(arena);
+    core::StringBuilder b(buf);
+    CHECK(exporter.format_metrics(b));
+
+    CHECK(strstr(buf.c_str(), "# TYPE roc_sender_fec_encoded_blocks_total counter\n"));
+    CHECK(strstr(buf.c_str(), "roc_sender_fec_encoded_blocks_total{slot=\"0\"} 0\n"));
+    CHECK(strstr(buf.c_str(), "roc_pool_used_objects{pool=\"packet_buffer\"} "));
+
+    CHECK(!strstr(buf.c_str(), "roc_receiver_"));
+}
+
+TEST(metrics_exporter, http) {
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(receiver.is_valid());
+
+    address::EndpointUri source_endp(arena);
+    parse_uri(source_endp, "rtp://127.0.0.1:0");
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+    MetricsExporter exporter(context, arena);
+    CHECK(exporter.is_valid());
+
+    CHECK(exporter.add_receiver_slot(receiver, DefaultSlot));
+
+    address::SocketAddr server_address;
+    CHECK(server_address.set_host_port(address::Family_IPv4, "127.0.0.1", 0));
+    CHECK(exporter.start(server_address));
+    CHECK(server_address.port() != 0);
+
+    char response[MaxResponse];
+
+    http_request(server_address, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n",
+                 response, sizeof(response));
+
+    CHECK(strncmp(response, "HTTP/1.1 200 OK\r\n", 17) == 0);
+    CHECK(strstr(response, "Content-Type: text/plain; version=0.0.4"));
+    CHECK(strstr(response, "\r\n\r\n# HELP "));
+    CHECK(strstr(response, "roc_receiver_participants{slot=\"0\"} 0\n"));
+
+    http_request(server_address, "GET /foo HTTP/1.1\r\n\r\n", response,
+                 sizeof(response));
+
+    CHECK(strncmp(response, "HTTP/1.1 404 Not Found\r\n", 24) == 0);
+
+    http_request(server_address, "POST /metrics HTTP/1.1\r\n\r\n", response,
+                 sizeof(response));
+
+    CHECK(strncmp(response, "HTTP/1.1 405 Method Not Allowed\r\n", 33) == 0);
+
+    exporter.stop();
+}
+
+} // namespace node
+} // namespace roc
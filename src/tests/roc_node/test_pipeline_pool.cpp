@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/buffer.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+#include "roc_node/pipeline_pool.h"
+
+namespace roc {
+namespace node {
+
+namespace {
+
+enum {
+    SampleRate = 48000,
+    NumCh = 2,
+    ChMask = 0x3,
+    FrameSize = SampleRate / 1000 * NumCh,
+    MaxBufSize = FrameSize * 2
+};
+
+const core::nanoseconds_t FrameLen = core::Millisecond;
+
+const audio::SampleSpec sample_spec(SampleRate,
+                                    audio::Sample_RawFormat,
+                                    audio::ChanLayout_Surround,
+                                    audio::ChanOrder_Smpte,
+                                    ChMask);
+
+core::HeapArena arena;
+core::SlabPool<core::Buffer> buffer_pool("buffer_pool",
+                                         arena,
+                                         sizeof(core::Buffer)
+                                             + MaxBufSize * sizeof(audio::sample_t));
+
+core::ThreadConfig thread_config;
+
+class MockDevice : virtual public sndio::IDevice {
+public:
+    virtual sndio::DeviceState state() const {
+        return sndio::DeviceState_Active;
+    }
+
+    virtual void pause() {
+        FAIL("not implemented");
+    }
+
+    virtual bool resume() {
+        FAIL("not implemented");
+        return false;
+    }
+
+    virtual bool restart() {
+        FAIL("not implemented");
+        return false;
+    }
+
+    virtual audio::SampleSpec sample_spec() const {
+        return node::sample_spec;
+    }
+
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
+    virtual bool has_latency() const {
+        return false;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+};
+
+// Produces frames filled with their number, and reports EOF
+// after given number of frames, or never, if it's zero.
+class MockSource : public sndio::ISource, public MockDevice {
+public:
+    explicit MockSource(size_t num_frames = 0)
+        : limit_(num_frames)
+        , n_frames_(0) {
+    }
+
+    virtual sndio::ISink* to_sink() {
+        return NULL;
+    }
+
+    virtual sndio::ISource* to_source() {
+        return this;
+    }
+
+    virtual sndio::DeviceType type() const {
+        return sndio::DeviceType_Source;
+    }
+
+    virtual void reclock(core::nanoseconds_t) {
+        // no-op
+    }
+
+    virtual bool read(audio::Frame& frame) {
+        const size_t n = (size_t)n_frames_;
+
+        if (limit_ != 0 && n >= limit_) {
+            return false;
+        }
+
+        UNSIGNED_LONGS_EQUAL(FrameSize, frame.num_raw_samples());
+
+        for (size_t i = 0; i < frame.num_raw_samples(); i++) {
+            frame.raw_samples()[i] = (audio::sample_t)n;
+        }
+
+        n_frames_++;
+        return true;
+    }
+
+    size_t num_frames() const {
+        return (size_t)n_frames_;
+    }
+
+private:
+    const size_t limit_;
+    core::Atomic<size_t> n_frames_;
+};
+
+// Checks that frames come in order.
+class MockSink : public sndio::ISink, public MockDevice {
+public:
+    MockSink()
+        : n_frames_(0) {
+    }
+
+    virtual sndio::ISink* to_sink() {
+        return this;
+    }
+
+    virtual sndio::ISource* to_source() {
+        return NULL;
+    }
+
+    virtual sndio::DeviceType type() const {
+        return sndio::DeviceType_Sink;
+    }
+
+    virtual void write(audio::Frame& frame) {
+        const size_t n = (size_t)n_frames_;
+
+        UNSIGNED_LONGS_EQUAL(FrameSize, frame.num_raw_samples());
+        CHECK(frame.has_duration());
+        CHECK(frame.capture_timestamp() != 0);
+
+        for (size_t i = 0; i < frame.num_raw_samples(); i++) {
+            DOUBLES_EQUAL((double)n, (double)frame.raw_samples()[i], 0);
+        }
+
+        n_frames_++;
+    }
+
+    size_t num_frames() const {
+        return (size_t)n_frames_;
+    }
+
+private:
+    core::Atomic<size_t> n_frames_;
+};
+
+void wait_frames(const PipelineJob& job, size_t num_frames) {
+    while (job.num_frames() < num_frames) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+}
+
+void wait_finished(const PipelineJob& job) {
+    while (!job.finished()) {
+        core::sleep_for(core::ClockMonotonic, core::Microsecond * 100);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(pipeline_pool) {};
+
+TEST(pipeline_pool, run_until_eof) {
+    enum { NumFrames = 20 };
+
+    PipelinePool pool(1, thread_config, arena);
+    CHECK(pool.is_valid());
+
+    MockSource source(NumFrames);
+    MockSink sink;
+
+    PipelineJob job(source, &sink, FrameLen, buffer_pool);
+    CHECK(job.is_valid());
+
+    const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+
+    CHECK(pool.add_job(job));
+    UNSIGNED_LONGS_EQUAL(1, pool.thread_jobs(0));
+
+    wait_finished(job);
+
+    // first frame is transferred immediately, every next one frame later
+    CHECK(core::timestamp(core::ClockMonotonic) - start >= FrameLen * (NumFrames - 1));
+
+    UNSIGNED_LONGS_EQUAL(NumFrames, source.num_frames());
+    UNSIGNED_LONGS_EQUAL(NumFrames, sink.num_frames());
+    UNSIGNED_LONGS_EQUAL(NumFrames, job.num_frames());
+
+    UNSIGNED_LONGS_EQUAL(0, pool.thread_jobs(0));
+}
+
+TEST(pipeline_pool, run_without_sink) {
+    enum { NumFrames = 5 };
+
+    PipelinePool pool(1, thread_config, arena);
+    CHECK(pool.is_valid());
+
+    MockSource source(NumFrames);
+
+    PipelineJob job(source, NULL, FrameLen, buffer_pool);
+    CHECK(job.is_valid());
+
+    CHECK(pool.add_job(job));
+    wait_finished(job);
+
+    UNSIGNED_LONGS_EQUAL(NumFrames, source.num_frames());
+    UNSIGNED_LONGS_EQUAL(NumFrames, job.num_frames());
+}
+
+TEST(pipeline_pool, remove_job) {
+    PipelinePool pool(1, thread_config, arena);
+    CHECK(pool.is_valid());
+
+    MockSource source;
+    MockSink sink;
+
+    PipelineJob job(source, &sink, FrameLen, buffer_pool);
+    CHECK(job.is_valid());
+
+    for (int iter = 0; iter < 3; iter++) {
+        CHECK(pool.add_job(job));
+        UNSIGNED_LONGS_EQUAL(1, pool.thread_jobs(0));
+
+        wait_frames(job, source.num_frames() + 5);
+
+        pool.remove_job(job);
+        UNSIGNED_LONGS_EQUAL(0, pool.thread_jobs(0));
+
+        CHECK(!job.finished());
+
+        const size_t num_frames = source.num_frames();
+        core::sleep_for(core::ClockMonotonic, FrameLen * 5);
+
+        UNSIGNED_LONGS_EQUAL(num_frames, source.num_frames());
+        UNSIGNED_LONGS_EQUAL(num_frames, sink.num_frames());
+    }
+
+    // no-op
+    pool.remove_job(job);
+}
+
+TEST(pipeline_pool, distribute_jobs) {
+    enum { NumThreads = 4, NumJobs = NumThreads * 2 };
+
+    PipelinePool pool(NumThreads, thread_config, arena);
+    CHECK(pool.is_valid());
+    UNSIGNED_LONGS_EQUAL(NumThreads, pool.num_threads());
+
+    MockSource sources[NumJobs];
+    MockSink sinks[NumJobs];
+    PipelineJob* jobs[NumJobs];
+
+    for (size_t n = 0; n < NumJobs; n++) {
+        jobs[n] = new (arena) PipelineJob(sources[n], &sinks[n], FrameLen, buffer_pool);
+        CHECK(jobs[n]->is_valid());
+        CHECK(pool.add_job(*jobs[n]));
+    }
+
+    size_t total_jobs = 0;
+    for (size_t n = 0; n < NumThreads; n++) {
+        CHECK(pool.thread_jobs(n) >= 1);
+        total_jobs += pool.thread_jobs(n);
+    }
+    UNSIGNED_LONGS_EQUAL(NumJobs, total_jobs);
+
+    for (size_t n = 0; n < NumJobs; n++) {
+        wait_frames(*jobs[n], 10);
+    }
+
+    for (size_t n = 0; n < NumJobs; n++) {
+        pool.remove_job(*jobs[n]);
+        arena.destroy_object(*jobs[n]);
+
+        CHECK(sinks[n].num_frames() >= 10);
+    }
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        UNSIGNED_LONGS_EQUAL(0, pool.thread_jobs(n));
+        CHECK(pool.thread_load(n) == 0);
+    }
+}
+
+TEST(pipeline_pool, invalid_job) {
+    PipelinePool pool(1, thread_config, arena);
+    CHECK(pool.is_valid());
+
+    core::SlabPool<core::Buffer> small_pool(
+        "small_pool", arena, sizeof(core::Buffer) + sizeof(audio::sample_t));
+
+    MockSource source;
+    PipelineJob job(source, NULL, FrameLen, small_pool);
+    CHECK(!job.is_valid());
+
+    CHECK(!pool.add_job(job));
+    UNSIGNED_LONGS_EQUAL(0, pool.thread_jobs(0));
+}
+
+} // namespace node
+} // namespace roc
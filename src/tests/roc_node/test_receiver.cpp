@@ -11,6 +11,7 @@
 #include "roc_address/protocol.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/macro_helpers.h"
+#include "roc_core/scoped_ptr.h"
 #include "roc_fec/codec_map.h"
 #include "roc_node/context.h"
 #include "roc_node/receiver.h"
@@ -100,6 +101,147 @@ TEST(receiver, bind) {
     }
 }
 
+TEST(receiver, bind_network_threads) {
+    context_config.network_threads = 2;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(receiver.is_valid());
+
+    for (size_t n = 0; n < 4; n++) {
+        address::EndpointUri source_endp(arena);
+        parse_uri(source_endp, "rtp://127.0.0.1:0");
+
+        CHECK(receiver.bind(n, address::Iface_AudioSource, source_endp));
+        CHECK(source_endp.port() != 0);
+    }
+
+    // ports are distributed between loops
+    LONGS_EQUAL(2, context.network_loop().num_ports());
+
+    CHECK(receiver.unlink(0));
+    CHECK(receiver.unlink(2));
+
+    LONGS_EQUAL(0, context.network_loop().num_ports());
+
+    CHECK(receiver.unlink(1));
+    CHECK(receiver.unlink(3));
+}
+
+TEST(receiver, bind_many) {
+    enum { NumSlots = 10, NumBindings = NumSlots * 2 };
+
+    { // source and control of many slots
+        Context context(context_config, arena);
+        CHECK(context.is_valid());
+
+        Receiver receiver(context, receiver_config);
+        CHECK(receiver.is_valid());
+
+        core::ScopedPtr<address::EndpointUri> endpoints[NumBindings];
+        Receiver::Binding bindings[NumBindings];
+
+        for (size_t n = 0; n < NumBindings; n++) {
+            endpoints[n].reset(new (arena) address::EndpointUri(arena), arena);
+            parse_uri(*endpoints[n], n % 2 == 0 ? "rtp://127.0.0.1:0"
+                                                : "rtcp://127.0.0.1:0");
+
+            bindings[n].slot_index = n / 2;
+            bindings[n].iface =
+                n % 2 == 0 ? address::Iface_AudioSource : address::Iface_AudioControl;
+            bindings[n].uri = endpoints[n].get();
+        }
+
+        CHECK(receiver.bind_many(bindings, NumBindings));
+
+        for (size_t n = 0; n < NumBindings; n++) {
+            CHECK(bindings[n].success);
+            CHECK(endpoints[n]->port() != 0);
+        }
+
+        LONGS_EQUAL(NumBindings, context.network_loop().num_ports());
+        CHECK(!receiver.has_broken());
+
+        for (size_t n = 0; n < NumSlots; n++) {
+            CHECK(receiver.unlink(n));
+        }
+
+        LONGS_EQUAL(0, context.network_loop().num_ports());
+    }
+    { // error in one slot
+        Context context(context_config, arena);
+        CHECK(context.is_valid());
+
+        Receiver receiver(context, receiver_config);
+        CHECK(receiver.is_valid());
+
+        address::EndpointUri source_endp1(arena);
+        parse_uri(source_endp1, "rtp://127.0.0.1:0");
+
+        address::EndpointUri source_endp2(arena);
+        parse_uri(source_endp2, "rtp://127.0.0.1:0");
+
+        address::EndpointUri control_endp2(arena);
+        parse_uri(control_endp2, "rtp://127.0.0.1:0");
+
+        Receiver::Binding bindings[3];
+
+        bindings[0].slot_index = 1;
+        bindings[0].iface = address::Iface_AudioSource;
+        bindings[0].uri = &source_endp1;
+
+        bindings[1].slot_index = 2;
+        bindings[1].iface = address::Iface_AudioSource;
+        bindings[1].uri = &source_endp2;
+
+        // protocol mismatch
+        bindings[2].slot_index = 2;
+        bindings[2].iface = address::Iface_AudioControl;
+        bindings[2].uri = &control_endp2;
+
+        CHECK(!receiver.bind_many(bindings, ROC_ARRAY_SIZE(bindings)));
+
+        CHECK(bindings[0].success);
+        CHECK(!bindings[1].success);
+        CHECK(!bindings[2].success);
+
+        // second slot is broken, and its port is closed
+        CHECK(receiver.has_broken());
+        LONGS_EQUAL(1, context.network_loop().num_ports());
+
+        CHECK(receiver.unlink(2));
+        CHECK(!receiver.has_broken());
+    }
+    { // with config
+        Context context(context_config, arena);
+        CHECK(context.is_valid());
+
+        Receiver receiver(context, receiver_config);
+        CHECK(receiver.is_valid());
+
+        address::EndpointUri source_endp(arena);
+        parse_uri(source_endp, "rtp://127.0.0.1:0");
+
+        netio::UdpConfig iface_config;
+        iface_config.enable_reuseaddr = true;
+
+        Receiver::Binding binding;
+        binding.slot_index = DefaultSlot;
+        binding.iface = address::Iface_AudioSource;
+        binding.config = &iface_config;
+        binding.uri = &source_endp;
+
+        CHECK(receiver.bind_many(&binding, 1));
+        CHECK(binding.success);
+
+        // interface is already bound
+        CHECK(!receiver.configure(DefaultSlot, address::Iface_AudioSource,
+                                  iface_config));
+    }
+}
+
 TEST(receiver, configure) {
     { // one slot
         Context context(context_config, arena);
@@ -784,5 +926,107 @@ TEST(receiver, metrics) {
     LONGS_EQUAL(0, party_count);
 }
 
+TEST(receiver, shards) {
+    enum { NumShards = 3 };
+
+    receiver_config.common.num_shards = NumShards;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(receiver.is_valid());
+
+    CHECK(receiver.source().sample_spec()
+          == receiver_config.common.output_sample_spec);
+
+    address::EndpointUri source_endp(arena);
+    parse_uri(source_endp, "rtp+rs8m://127.0.0.1:0");
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+    address::EndpointUri repair_endp(arena);
+    parse_uri(repair_endp, "rs8m://127.0.0.1:0");
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioRepair, repair_endp));
+
+    address::EndpointUri control_endp(arena);
+    parse_uri(control_endp, "rtcp://127.0.0.1:0");
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioControl, control_endp));
+
+    // One port per interface, shared by all shards.
+    LONGS_EQUAL(3, context.network_loop().num_ports());
+
+    pipeline::ReceiverSlotMetrics slot_metrics;
+    pipeline::ReceiverParticipantMetrics party_metrics[10];
+    size_t party_count = ROC_ARRAY_SIZE(party_metrics);
+
+    CHECK(receiver.get_metrics(DefaultSlot, write_slot_metrics, &slot_metrics,
+                               write_party_metrics, &party_count, &party_metrics));
+
+    LONGS_EQUAL(0, slot_metrics.num_participants);
+    LONGS_EQUAL(0, party_count);
+
+    CHECK(receiver.unlink(DefaultSlot));
+
+    LONGS_EQUAL(0, context.network_loop().num_ports());
+}
+
+TEST(receiver, too_many_shards) {
+    receiver_config.common.num_shards = 1000;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(!receiver.is_valid());
+}
+
+TEST(receiver, node_memory_limit) {
+    enum { MemoryLimit = 256 * 1024, MaxBuffers = 1000 };
+
+    context_config.node_memory_limit = MemoryLimit;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    Receiver receiver1(context, receiver_config);
+    CHECK(receiver1.is_valid());
+
+    Receiver receiver2(context, receiver_config);
+    CHECK(receiver2.is_valid());
+
+    // Every receiver has own pools.
+    CHECK(&receiver1.packet_factory() != &context.packet_factory());
+    CHECK(&receiver1.packet_factory() != &receiver2.packet_factory());
+    CHECK(&receiver1.frame_buffer_pool() != &receiver2.frame_buffer_pool());
+
+    // Exhaust quota of first receiver.
+    core::BufferPtr buffers[MaxBuffers];
+    size_t n_buffers = 0;
+
+    while (n_buffers < MaxBuffers) {
+        buffers[n_buffers] = receiver1.packet_factory().new_packet_buffer();
+        if (!buffers[n_buffers]) {
+            break;
+        }
+        n_buffers++;
+    }
+
+    CHECK(n_buffers > 0);
+    CHECK(n_buffers < MaxBuffers);
+
+    CHECK(receiver1.pools_allocated_bytes() > 0);
+    CHECK(receiver1.pools_allocated_bytes() <= MemoryLimit);
+
+    // Others are not affected.
+    CHECK(receiver2.packet_factory().new_packet_buffer());
+    CHECK(context.packet_factory().new_packet_buffer());
+
+    // Quota is available again when buffers are returned.
+    for (size_t n = 0; n < n_buffers; n++) {
+        buffers[n] = NULL;
+    }
+    CHECK(receiver1.packet_factory().new_packet_buffer());
+}
+
 } // namespace node
 } // namespace roc
@@ -11,6 +11,7 @@
 #include "roc_address/interface.h"
 #include "roc_address/protocol.h"
 #include "roc_core/heap_arena.h"
+#include "roc_core/thread.h"
 #include "roc_fec/codec_map.h"
 #include "roc_node/context.h"
 #include "roc_node/receiver_decoder.h"
@@ -37,6 +38,47 @@ void write_party_metrics(const pipeline::ReceiverParticipantMetrics& party_metri
     ((pipeline::ReceiverParticipantMetrics*)party_arg)[party_index] = party_metrics;
 }
 
+// Writes packets to decoder from separate thread.
+class PacketPusher : public core::Thread {
+public:
+    PacketPusher(ReceiverDecoder& decoder, size_t n_packets)
+        : decoder_(decoder)
+        , n_packets_(n_packets)
+        , n_written_(0) {
+    }
+
+    size_t num_written() const {
+        return n_written_;
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < n_packets_; n++) {
+            core::BufferPtr bp = decoder_.packet_factory().new_packet_buffer();
+            roc_panic_if_not(bp);
+
+            packet::PacketPtr pp = decoder_.packet_factory().new_packet();
+            roc_panic_if_not(pp);
+
+            // Zeros are not a valid RTP packet, so pipeline drops it.
+            core::Slice<uint8_t> slice(*bp, 0, 16);
+            memset(slice.data(), 0, slice.size());
+
+            pp->add_flags(packet::Packet::FlagUDP);
+            pp->set_buffer(slice);
+
+            if (decoder_.write_packet(address::Iface_AudioSource, pp)
+                == status::StatusOK) {
+                n_written_++;
+            }
+        }
+    }
+
+    ReceiverDecoder& decoder_;
+    const size_t n_packets_;
+    size_t n_written_;
+};
+
 } // namespace
 
 TEST_GROUP(receiver_decoder) {
@@ -140,5 +182,44 @@ TEST(receiver_decoder, metrics) {
     LONGS_EQUAL(0, slot_metrics.num_participants);
 }
 
+TEST(receiver_decoder, concurrent_write) {
+    enum { NumThreads = 4, NumPackets = 1000, FrameSize = 200 };
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    ReceiverDecoder receiver_decoder(context, receiver_config);
+    CHECK(receiver_decoder.is_valid());
+
+    CHECK(receiver_decoder.activate(address::Iface_AudioSource, address::Proto_RTP));
+
+    PacketPusher* pushers[NumThreads];
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        pushers[n] = new PacketPusher(receiver_decoder, NumPackets);
+        CHECK(pushers[n]->start());
+    }
+
+    audio::sample_t samples[FrameSize] = {};
+
+    // Read frames while packets are being written.
+    for (size_t n = 0; n < NumPackets; n++) {
+        audio::Frame frame(samples, FrameSize);
+        CHECK(receiver_decoder.source().read(frame));
+    }
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        pushers[n]->join();
+        UNSIGNED_LONGS_EQUAL(NumPackets, pushers[n]->num_written());
+        delete pushers[n];
+    }
+
+    // Remaining packets are drained by next read.
+    audio::Frame frame(samples, FrameSize);
+    CHECK(receiver_decoder.source().read(frame));
+
+    LONGS_EQUAL(sndio::DeviceState_Idle, receiver_decoder.source().state());
+}
+
 } // namespace node
 } // namespace roc
@@ -8,6 +8,7 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "roc_core/atomic.h"
 #include "roc_core/heap_arena.h"
 #include "roc_fec/codec_map.h"
 #include "roc_node/context.h"
@@ -38,6 +39,10 @@ void write_party_metrics(const pipeline::SenderParticipantMetrics& party_metrics
     ((pipeline::SenderParticipantMetrics*)party_arg)[party_index] = party_metrics;
 }
 
+void release_frame(void* arg) {
+    (*(core::Atomic<int>*)arg)++;
+}
+
 } // namespace
 
 TEST_GROUP(sender) {
@@ -1045,5 +1050,101 @@ TEST(sender, metrics) {
     LONGS_EQUAL(0, party_count);
 }
 
+TEST(sender, async_write) {
+    enum { NumFrames = 20 };
+
+    const core::nanoseconds_t frame_len = 10 * core::Millisecond;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    { // internal clock is not allowed
+        pipeline::SenderSinkConfig timing_config = sender_config;
+        timing_config.enable_timing = true;
+
+        AsyncSinkConfig async_config;
+        async_config.queue_length = frame_len * 4;
+
+        Sender sender(context, timing_config, async_config);
+        CHECK(!sender.is_valid());
+    }
+    { // frames are encoded by writer thread
+        AsyncSinkConfig async_config;
+        async_config.queue_length = frame_len * 4;
+
+        Sender sender(context, sender_config, async_config);
+        CHECK(sender.is_valid());
+
+        address::EndpointUri source_endp(arena);
+        parse_uri(source_endp, "rtp://127.0.0.1:1000");
+        CHECK(sender.connect(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+        const audio::SampleSpec spec = sender.sink().sample_spec();
+
+        audio::sample_t samples[(size_t)(48000 / 100 * 2)] = {};
+        const size_t n_samples = spec.ns_2_samples_overall(frame_len);
+        CHECK(n_samples <= ROC_ARRAY_SIZE(samples));
+
+        for (size_t n = 0; n < NumFrames; n++) {
+            audio::Frame frame(samples, n_samples);
+            sender.sink().write(frame);
+        }
+
+        while (sender.async_metrics().queue_length != 0) {
+            core::sleep_for(core::ClockMonotonic, core::Millisecond);
+        }
+
+        const AsyncSinkMetrics metrics = sender.async_metrics();
+
+        CHECK_EQUAL(frame_len * 4, metrics.queue_capacity);
+        CHECK(metrics.peak_queue_length >= frame_len);
+        CHECK_EQUAL(0, metrics.dropped_length);
+    }
+}
+
+TEST(sender, write_ref) {
+    const core::nanoseconds_t frame_len = 10 * core::Millisecond;
+
+    Context context(context_config, arena);
+    CHECK(context.is_valid());
+
+    audio::sample_t samples[(size_t)(48000 / 100 * 2)] = {};
+
+    { // without queue, frame is released before returning
+        Sender sender(context, sender_config);
+        CHECK(sender.is_valid());
+
+        const size_t n_samples =
+            sender.sink().sample_spec().ns_2_samples_overall(frame_len);
+        CHECK(n_samples <= ROC_ARRAY_SIZE(samples));
+
+        core::Atomic<int> n_released(0);
+
+        audio::Frame frame(samples, n_samples);
+        CHECK(sender.write_ref(frame, release_frame, &n_released));
+        CHECK_EQUAL(1, (int)n_released);
+    }
+    { // with queue, frame is released by writer thread
+        AsyncSinkConfig async_config;
+        async_config.queue_length = frame_len * 4;
+
+        Sender sender(context, sender_config, async_config);
+        CHECK(sender.is_valid());
+
+        const size_t n_samples =
+            sender.sink().sample_spec().ns_2_samples_overall(frame_len);
+        CHECK(n_samples <= ROC_ARRAY_SIZE(samples));
+
+        core::Atomic<int> n_released(0);
+
+        audio::Frame frame(samples, n_samples);
+        CHECK(sender.write_ref(frame, release_frame, &n_released));
+
+        while (n_released != 1) {
+            core::sleep_for(core::ClockMonotonic, core::Millisecond);
+        }
+    }
+}
+
 } // namespace node
 } // namespace roc
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/interleaver.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+namespace {
+
+enum { MaxPackets = 256, BufferSize = 100 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+class NullWriter : public IWriter {
+public:
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const PacketPtr& pp) {
+        benchmark::DoNotOptimize(pp.get());
+        return status::StatusOK;
+    }
+};
+
+void BM_Interleaver_Write(benchmark::State& state) {
+    const size_t block_size = (size_t)state.range(0);
+
+    PacketPtr packets[MaxPackets];
+    for (size_t n = 0; n < MaxPackets; n++) {
+        packets[n] = packet_factory.new_packet();
+    }
+
+    NullWriter writer;
+    Interleaver intrlvr(writer, arena, block_size);
+    if (!intrlvr.is_valid()) {
+        state.SkipWithError("interleaver is not valid");
+        return;
+    }
+
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        status::StatusCode code = intrlvr.write(packets[n]);
+        benchmark::DoNotOptimize(code);
+        if (++n == MaxPackets) {
+            n = 0;
+        }
+    }
+
+    (void)intrlvr.flush();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Interleaver_Write)->Arg(10)->Arg(28)->Arg(64)->Arg(255);
+
+} // namespace
+} // namespace packet
+} // namespace roc
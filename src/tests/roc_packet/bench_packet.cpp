@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace packet {
+namespace {
+
+enum { BufferSize = 100, PayloadSize = 64 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+PacketPtr new_packet(seqnum_t sn) {
+    PacketPtr pp = packet_factory.new_packet();
+
+    pp->add_flags(Packet::FlagUDP | Packet::FlagRTP | Packet::FlagAudio);
+
+    pp->udp()->receive_timestamp = 1;
+    pp->udp()->queue_timestamp = 1;
+
+    pp->rtp()->source_id = 1;
+    pp->rtp()->seqnum = sn;
+    pp->rtp()->stream_timestamp = (stream_timestamp_t)sn * PayloadSize;
+    pp->rtp()->duration = PayloadSize;
+
+    return pp;
+}
+
+// Allocates packets, fills headers, passes them through a queue of given
+// size and reads back fields used by receiver pipeline.
+// Larger queues make working set larger than CPU cache, so the cost
+// depends on how many cache lines every packet occupies.
+void BM_Packet_Pipeline(benchmark::State& state) {
+    const size_t queue_size = (size_t)state.range(0);
+
+    SortedQueue queue(arena, 0);
+
+    seqnum_t sn = 0;
+    for (; sn < queue_size; sn++) {
+        if (queue.write(new_packet(sn)) != status::StatusOK) {
+            state.SkipWithError("can't write packet");
+            return;
+        }
+    }
+
+    while (state.KeepRunning()) {
+        (void)queue.write(new_packet(sn++));
+
+        PacketPtr pp;
+        (void)queue.read(pp);
+
+        benchmark::DoNotOptimize(pp->rtp()->seqnum);
+        benchmark::DoNotOptimize(pp->stream_timestamp());
+        benchmark::DoNotOptimize(pp->duration());
+        benchmark::DoNotOptimize(pp->receive_timestamp());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Packet_Pipeline)->Arg(16)->Arg(1024)->Arg(16384);
+
+} // namespace
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace packet {
+namespace {
+
+enum {
+    BufferSize = 100,
+
+    // Sequence covers whole seqnum range, so that it wraps seamlessly.
+    SeqLen = 65536,
+
+    MaxDepth = 1024,
+    MaxWindow = 64,
+    MaxPackets = MaxDepth + MaxWindow
+};
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+seqnum_t seqnums[SeqLen];
+
+// Packets arrive in blocks of given size, shuffled within block, so that
+// every packet is displaced by less than block size.
+void init_seqnums(size_t window) {
+    for (size_t n = 0; n < SeqLen; n++) {
+        seqnums[n] = (seqnum_t)n;
+    }
+
+    for (size_t blk = 0; blk < SeqLen; blk += window) {
+        for (size_t n = window - 1; n > 0; n--) {
+            const size_t k = core::fast_random_range(0, (uint32_t)n);
+            std::swap(seqnums[blk + n], seqnums[blk + k]);
+        }
+    }
+}
+
+// Jitter buffer workload: queue holds given number of packets, every
+// incoming reordered packet is inserted, and head is read.
+void BM_SortedQueue_Reordered(benchmark::State& state) {
+    const size_t depth = (size_t)state.range(0);
+    const size_t window = (size_t)state.range(1);
+
+    init_seqnums(window);
+
+    // Packets are reused after they're read from queue.
+    PacketPtr packets[MaxPackets];
+    size_t n_packets = 0;
+
+    for (; n_packets < depth + window; n_packets++) {
+        packets[n_packets] = packet_factory.new_packet();
+        if (!packets[n_packets]) {
+            state.SkipWithError("can't allocate packet");
+            return;
+        }
+        packets[n_packets]->add_flags(Packet::FlagRTP);
+    }
+
+    SortedQueue queue(arena, 0);
+
+    size_t pos = 0;
+
+    for (; pos < depth; pos++) {
+        PacketPtr& pp = packets[--n_packets];
+        pp->rtp()->seqnum = seqnums[pos];
+        if (queue.write(pp) != status::StatusOK) {
+            state.SkipWithError("can't write packet");
+            return;
+        }
+        pp = NULL;
+    }
+
+    while (state.KeepRunning()) {
+        if (n_packets == 0) {
+            state.SkipWithError("packet was dropped by queue");
+            return;
+        }
+
+        PacketPtr& wp = packets[--n_packets];
+        wp->rtp()->seqnum = seqnums[pos];
+        if (queue.write(wp) != status::StatusOK) {
+            state.SkipWithError("can't write packet");
+            return;
+        }
+        wp = NULL;
+
+        if (++pos == SeqLen) {
+            pos = 0;
+        }
+
+        if (queue.read(packets[n_packets++]) != status::StatusOK) {
+            state.SkipWithError("can't read packet");
+            return;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+void sorted_queue_args(benchmark::internal::Benchmark* b) {
+    const int depths[] = { 16, 128, MaxDepth };
+    // in-order, light and heavy reordering
+    const int windows[] = { 1, 8, MaxWindow };
+
+    std::vector<std::string> names;
+    names.push_back("depth");
+    names.push_back("window");
+    b->ArgNames(names);
+
+    for (size_t n_d = 0; n_d < ROC_ARRAY_SIZE(depths); n_d++) {
+        for (size_t n_w = 0; n_w < ROC_ARRAY_SIZE(windows); n_w++) {
+            // Otherwise late packets are dropped.
+            if (windows[n_w] > depths[n_d]) {
+                continue;
+            }
+
+            std::vector<int64_t> args;
+            args.push_back(depths[n_d]);
+            args.push_back(windows[n_w]);
+            b->Args(args);
+        }
+    }
+}
+
+BENCHMARK(BM_SortedQueue_Reordered)->Apply(sorted_queue_args);
+
+} // namespace
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_packet/address_sharder.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_status/status_code.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MaxBufSize = 100, NumShards = 4, NumHosts = 64 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, MaxBufSize);
+
+PacketPtr new_packet(const char* host, int port) {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+    packet->add_flags(Packet::FlagUDP);
+    CHECK(packet->udp()->src_addr.set_host_port_auto(host, port));
+    return packet;
+}
+
+} // namespace
+
+TEST_GROUP(address_sharder) {};
+
+TEST(address_sharder, one_shard) {
+    AddressSharder sharder(arena);
+
+    Queue queue;
+    CHECK(sharder.add_shard(queue));
+
+    LONGS_EQUAL(status::StatusOK, sharder.write(new_packet("10.0.0.1", 1000)));
+    LONGS_EQUAL(status::StatusOK, sharder.write(new_packet("10.0.0.2", 1000)));
+
+    LONGS_EQUAL(2, queue.size());
+}
+
+TEST(address_sharder, same_host_same_shard) {
+    AddressSharder sharder(arena);
+
+    Queue queues[NumShards];
+    for (size_t n = 0; n < NumShards; n++) {
+        CHECK(sharder.add_shard(queues[n]));
+    }
+    LONGS_EQUAL(NumShards, sharder.num_shards());
+
+    // Port is ignored, e.g. source and repair packets from different sockets.
+    const char* hosts[] = { "10.0.0.1", "192.168.1.77", "::1", "2001:db8::5" };
+
+    for (size_t h = 0; h < ROC_ARRAY_SIZE(hosts); h++) {
+        const size_t shard = sharder.select_shard(*new_packet(hosts[h], 1000));
+
+        for (int port = 1001; port < 1010; port++) {
+            PacketPtr pp = new_packet(hosts[h], port);
+            LONGS_EQUAL(shard, sharder.select_shard(*pp));
+
+            const size_t size_before = queues[shard].size();
+            LONGS_EQUAL(status::StatusOK, sharder.write(pp));
+            LONGS_EQUAL(size_before + 1, queues[shard].size());
+        }
+    }
+}
+
+TEST(address_sharder, hosts_spread) {
+    AddressSharder sharder(arena);
+
+    Queue queues[NumShards];
+    for (size_t n = 0; n < NumShards; n++) {
+        CHECK(sharder.add_shard(queues[n]));
+    }
+
+    for (size_t h = 0; h < NumHosts; h++) {
+        char host[32];
+        snprintf(host, sizeof(host), "10.0.%d.%d", (int)(h / 7), (int)(h * 3 + 1));
+        LONGS_EQUAL(status::StatusOK, sharder.write(new_packet(host, 5000)));
+    }
+
+    size_t total = 0;
+    for (size_t n = 0; n < NumShards; n++) {
+        // Every shard gets some hosts.
+        CHECK(queues[n].size() > 0);
+        total += queues[n].size();
+    }
+    LONGS_EQUAL(NumHosts, total);
+}
+
+TEST(address_sharder, no_address) {
+    AddressSharder sharder(arena);
+
+    Queue queues[NumShards];
+    for (size_t n = 0; n < NumShards; n++) {
+        CHECK(sharder.add_shard(queues[n]));
+    }
+
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    LONGS_EQUAL(status::StatusOK, sharder.write(pp));
+    LONGS_EQUAL(1, queues[0].size());
+}
+
+} // namespace packet
+} // namespace roc
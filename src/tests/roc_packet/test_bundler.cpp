@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/bundler.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_packet/unbundler.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 1500, MaxBundleSize = 300 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+address::SocketAddr make_address(int port) {
+    address::SocketAddr address;
+    CHECK(address.set_host_port_auto("127.0.0.1", port));
+    return address;
+}
+
+PacketPtr new_packet(size_t size, uint8_t value, int port) {
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+    buffer.reslice(0, size);
+
+    // RTP version 2.
+    buffer.data()[0] = 0x80;
+    for (size_t n = 1; n < size; n++) {
+        buffer.data()[n] = value;
+    }
+
+    pp->add_flags(Packet::FlagUDP | Packet::FlagPrepared | Packet::FlagComposed);
+    pp->udp()->dst_addr = make_address(port);
+    pp->set_buffer(buffer);
+
+    return pp;
+}
+
+void check_packet(const Packet& pp, size_t size, uint8_t value, int port) {
+    UNSIGNED_LONGS_EQUAL(size, pp.buffer().size());
+    CHECK(pp.udp());
+    CHECK(pp.udp()->dst_addr == make_address(port));
+
+    UNSIGNED_LONGS_EQUAL(0x80, pp.buffer().data()[0]);
+    for (size_t n = 1; n < size; n++) {
+        UNSIGNED_LONGS_EQUAL(value, pp.buffer().data()[n]);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(bundler) {};
+
+TEST(bundler, bundle_unbundle) {
+    enum { NumPackets = 5, PacketSize = 40, Port = 1000 };
+
+    BundlerConfig config;
+    config.max_bundle_size = MaxBundleSize;
+
+    Queue bundle_queue;
+    Bundler bundler(bundle_queue, packet_factory, config);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        LONGS_EQUAL(status::StatusOK,
+                    bundler.write(new_packet(PacketSize, uint8_t(n + 1), Port)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, bundle_queue.size());
+    LONGS_EQUAL(status::StatusOK, bundler.flush());
+    UNSIGNED_LONGS_EQUAL(1, bundle_queue.size());
+
+    PacketPtr bundle;
+    LONGS_EQUAL(status::StatusOK, bundle_queue.read(bundle));
+    CHECK(bundle);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets * (Bundler::LengthSize + PacketSize),
+                         bundle->buffer().size());
+    CHECK(bundle->udp()->dst_addr == make_address(Port));
+    CHECK(Unbundler::is_bundle(*bundle));
+
+    Queue packet_queue;
+    Unbundler unbundler(packet_factory);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, unbundler.unbundle(*bundle, packet_queue));
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, packet_queue.read(pp));
+        CHECK(pp);
+        CHECK(!Unbundler::is_bundle(*pp));
+        check_packet(*pp, PacketSize, uint8_t(n + 1), Port);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, packet_queue.size());
+}
+
+TEST(bundler, single_packet) {
+    enum { PacketSize = 40, Port = 1000 };
+
+    Queue bundle_queue;
+    Bundler bundler(bundle_queue, packet_factory, BundlerConfig());
+
+    PacketPtr pp = new_packet(PacketSize, 1, Port);
+    LONGS_EQUAL(status::StatusOK, bundler.write(pp));
+    LONGS_EQUAL(status::StatusOK, bundler.flush());
+
+    // Single packet is sent as is.
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, bundle_queue.read(rp));
+    CHECK(rp == pp);
+    CHECK(!Unbundler::is_bundle(*rp));
+
+    UNSIGNED_LONGS_EQUAL(0, bundle_queue.size());
+}
+
+TEST(bundler, max_size) {
+    enum {
+        PacketSize = 70,
+        PacketsPerBundle = MaxBundleSize / (PacketSize + Bundler::LengthSize),
+        NumBundles = 3,
+        Port = 1000
+    };
+
+    BundlerConfig config;
+    config.max_bundle_size = MaxBundleSize;
+
+    Queue bundle_queue;
+    Bundler bundler(bundle_queue, packet_factory, config);
+
+    for (size_t n = 0; n < PacketsPerBundle * NumBundles; n++) {
+        LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 1, Port)));
+    }
+    LONGS_EQUAL(status::StatusOK, bundler.flush());
+
+    UNSIGNED_LONGS_EQUAL(NumBundles, bundle_queue.size());
+
+    for (size_t n = 0; n < NumBundles; n++) {
+        PacketPtr bundle;
+        LONGS_EQUAL(status::StatusOK, bundle_queue.read(bundle));
+        CHECK(bundle->buffer().size() <= MaxBundleSize);
+        CHECK(Unbundler::is_bundle(*bundle));
+    }
+
+    // Packet larger than bundle is sent as is.
+    PacketPtr pp = new_packet(MaxBundleSize, 1, Port);
+    LONGS_EQUAL(status::StatusOK, bundler.write(pp));
+
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, bundle_queue.read(rp));
+    CHECK(rp == pp);
+}
+
+TEST(bundler, different_addresses) {
+    enum { PacketSize = 40, Port1 = 1000, Port2 = 2000 };
+
+    Queue bundle_queue;
+    Bundler bundler(bundle_queue, packet_factory, BundlerConfig());
+
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 1, Port1)));
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 2, Port1)));
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 3, Port2)));
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 4, Port2)));
+    LONGS_EQUAL(status::StatusOK, bundler.flush());
+
+    const int ports[] = { Port1, Port2 };
+
+    for (size_t n = 0; n < 2; n++) {
+        PacketPtr bundle;
+        LONGS_EQUAL(status::StatusOK, bundle_queue.read(bundle));
+        CHECK(bundle->udp()->dst_addr == make_address(ports[n]));
+
+        Queue packet_queue;
+        Unbundler unbundler(packet_factory);
+        UNSIGNED_LONGS_EQUAL(2, unbundler.unbundle(*bundle, packet_queue));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, bundle_queue.size());
+}
+
+TEST(bundler, malformed_bundle) {
+    enum { PacketSize = 40, Port = 1000 };
+
+    Queue bundle_queue;
+    Bundler bundler(bundle_queue, packet_factory, BundlerConfig());
+
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 1, Port)));
+    LONGS_EQUAL(status::StatusOK, bundler.write(new_packet(PacketSize, 2, Port)));
+    LONGS_EQUAL(status::StatusOK, bundler.flush());
+
+    PacketPtr bundle;
+    LONGS_EQUAL(status::StatusOK, bundle_queue.read(bundle));
+
+    // Truncate second packet.
+    PacketPtr truncated = packet_factory.new_packet();
+    CHECK(truncated);
+    truncated->add_flags(Packet::FlagUDP);
+    truncated->udp()->dst_addr = bundle->udp()->dst_addr;
+    truncated->set_buffer(bundle->buffer().subslice(0, bundle->buffer().size() - 1));
+
+    Queue packet_queue;
+    Unbundler unbundler(packet_factory);
+    UNSIGNED_LONGS_EQUAL(1, unbundler.unbundle(*truncated, packet_queue));
+
+    PacketPtr pp;
+    LONGS_EQUAL(status::StatusOK, packet_queue.read(pp));
+    check_packet(*pp, PacketSize, 1, Port);
+}
+
+} // namespace packet
+} // namespace roc
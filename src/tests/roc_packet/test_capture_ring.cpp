@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/capture_ring.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 200, NumRecords = 8, SnapLen = 16 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+PacketPtr new_packet(size_t size, uint8_t value) {
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+    buffer.reslice(0, size);
+    memset(buffer.data(), value, size);
+
+    pp->add_flags(Packet::FlagUDP);
+    pp->set_buffer(buffer);
+
+    CHECK(pp->udp()->src_addr.set_host_port(address::Family_IPv4, "127.0.0.1", 1000));
+    CHECK(pp->udp()->dst_addr.set_host_port(address::Family_IPv4, "127.0.0.2", 2000));
+
+    return pp;
+}
+
+CaptureConfig make_config() {
+    CaptureConfig config;
+    config.num_records = NumRecords;
+    config.snap_len = SnapLen;
+    return config;
+}
+
+} // namespace
+
+TEST_GROUP(capture_ring) {};
+
+TEST(capture_ring, empty) {
+    CaptureRing ring(make_config(), arena);
+    CHECK(ring.is_valid());
+
+    CaptureRecord record;
+    for (uint32_t seqnum = ring.first_seqnum(); seqnum != ring.end_seqnum(); seqnum++) {
+        CHECK(!ring.read(seqnum, record));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, ring.num_captured());
+}
+
+TEST(capture_ring, disabled) {
+    CaptureRing ring(CaptureConfig(), arena);
+    CHECK(!ring.is_valid());
+}
+
+TEST(capture_ring, capture) {
+    CaptureRing ring(make_config(), arena);
+    CHECK(ring.is_valid());
+
+    PacketPtr pp = new_packet(SnapLen / 2, 0x11);
+    ring.capture(*pp, CapturePoint_Ingress, 0);
+
+    pp = new_packet(SnapLen * 2, 0x22);
+    ring.capture(*pp, CapturePoint_Repair, CaptureFlag_Repaired | CaptureFlag_Late);
+
+    UNSIGNED_LONGS_EQUAL(2, ring.num_captured());
+    UNSIGNED_LONGS_EQUAL(2, ring.end_seqnum());
+
+    CaptureRecord record;
+
+    CHECK(ring.read(0, record));
+    UNSIGNED_LONGS_EQUAL(0, record.seqnum);
+    CHECK(record.timestamp > 0);
+    LONGS_EQUAL(CapturePoint_Ingress, record.point);
+    UNSIGNED_LONGS_EQUAL(0, record.flags);
+    LONGS_EQUAL(1000, record.src_addr.port());
+    LONGS_EQUAL(2000, record.dst_addr.port());
+    UNSIGNED_LONGS_EQUAL(SnapLen / 2, record.orig_len);
+    UNSIGNED_LONGS_EQUAL(SnapLen / 2, record.cap_len);
+    for (size_t n = 0; n < record.cap_len; n++) {
+        UNSIGNED_LONGS_EQUAL(0x11, record.data[n]);
+    }
+
+    // truncated to snap_len
+    CHECK(ring.read(1, record));
+    UNSIGNED_LONGS_EQUAL(1, record.seqnum);
+    LONGS_EQUAL(CapturePoint_Repair, record.point);
+    UNSIGNED_LONGS_EQUAL(CaptureFlag_Repaired | CaptureFlag_Late, record.flags);
+    UNSIGNED_LONGS_EQUAL(SnapLen * 2, record.orig_len);
+    UNSIGNED_LONGS_EQUAL(SnapLen, record.cap_len);
+    for (size_t n = 0; n < record.cap_len; n++) {
+        UNSIGNED_LONGS_EQUAL(0x22, record.data[n]);
+    }
+
+    CHECK(!ring.read(2, record));
+}
+
+TEST(capture_ring, overwrite) {
+    CaptureRing ring(make_config(), arena);
+    CHECK(ring.is_valid());
+
+    const size_t num_packets = NumRecords * 3 + 1;
+
+    for (size_t n = 0; n < num_packets; n++) {
+        PacketPtr pp = new_packet(4, uint8_t(n));
+        ring.capture(*pp, CapturePoint_Egress, 0);
+    }
+
+    UNSIGNED_LONGS_EQUAL(num_packets, ring.num_captured());
+    UNSIGNED_LONGS_EQUAL(num_packets - NumRecords, ring.first_seqnum());
+
+    // only last records are kept
+    CaptureRecord record;
+    size_t n_read = 0;
+    for (uint32_t seqnum = ring.first_seqnum(); seqnum != ring.end_seqnum(); seqnum++) {
+        CHECK(ring.read(seqnum, record));
+        UNSIGNED_LONGS_EQUAL(seqnum, record.seqnum);
+        UNSIGNED_LONGS_EQUAL(uint8_t(seqnum), record.data[0]);
+        n_read++;
+    }
+    UNSIGNED_LONGS_EQUAL(NumRecords, n_read);
+
+    // overwritten record
+    CHECK(!ring.read(0, record));
+
+    UNSIGNED_LONGS_EQUAL(0, ring.num_lost());
+}
+
+TEST(capture_ring, round_up) {
+    CaptureConfig config = make_config();
+    config.num_records = NumRecords + 1;
+
+    CaptureRing ring(config, arena);
+    CHECK(ring.is_valid());
+
+    for (size_t n = 0; n < NumRecords * 2; n++) {
+        PacketPtr pp = new_packet(4, uint8_t(n));
+        ring.capture(*pp, CapturePoint_Egress, 0);
+    }
+
+    // rounded up to power of two
+    CaptureRecord record;
+    CHECK(ring.read(0, record));
+    CHECK(ring.read(NumRecords * 2 - 1, record));
+}
+
+} // namespace packet
+} // namespace roc
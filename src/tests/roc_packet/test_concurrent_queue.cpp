@@ -154,5 +154,40 @@ TEST(concurrent_queue, nonblocking_queue_read_empty) {
     }
 }
 
+TEST(concurrent_queue, nonblocking_queue_read_batch) {
+    ConcurrentQueue queue(ConcurrentQueue::NonBlocking);
+
+    for (size_t i = 0; i < 100; i++) {
+        PacketPtr packets[10];
+
+        for (size_t j = 0; j < ROC_ARRAY_SIZE(packets); j++) {
+            packets[j] = new_packet();
+            LONGS_EQUAL(status::StatusOK, queue.write(packets[j]));
+        }
+
+        PacketPtr batch[4];
+        size_t n_read = 0;
+        size_t n_total = 0;
+
+        while (n_total < ROC_ARRAY_SIZE(packets)) {
+            LONGS_EQUAL(status::StatusOK,
+                        queue.read_batch(batch, ROC_ARRAY_SIZE(batch), n_read));
+            CHECK(n_read > 0);
+            CHECK(n_read <= ROC_ARRAY_SIZE(batch));
+
+            for (size_t j = 0; j < n_read; j++) {
+                CHECK(batch[j] == packets[n_total + j]);
+            }
+            n_total += n_read;
+        }
+
+        UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(packets), n_total);
+
+        LONGS_EQUAL(status::StatusNoData,
+                    queue.read_batch(batch, ROC_ARRAY_SIZE(batch), n_read));
+        UNSIGNED_LONGS_EQUAL(0, n_read);
+    }
+}
+
 } // namespace packet
 } // namespace roc
@@ -70,7 +70,7 @@ TEST(delayed_reader, failed_to_read_packet) {
 
     for (size_t n = 0; n < ROC_ARRAY_SIZE(codes); ++n) {
         StatusReader reader(codes[n]);
-        DelayedReader dr(reader, 0, sample_spec);
+        DelayedReader dr(reader, 0, sample_spec, arena);
         CHECK(dr.is_valid());
 
         PacketPtr pp;
@@ -81,7 +81,7 @@ TEST(delayed_reader, failed_to_read_packet) {
 
 TEST(delayed_reader, no_delay) {
     Queue queue;
-    DelayedReader dr(queue, 0, sample_spec);
+    DelayedReader dr(queue, 0, sample_spec, arena);
     CHECK(dr.is_valid());
 
     PacketPtr pp;
@@ -100,7 +100,8 @@ TEST(delayed_reader, no_delay) {
 
 TEST(delayed_reader, delay) {
     Queue queue;
-    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec);
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec,
+                     arena);
     CHECK(dr.is_valid());
 
     PacketPtr packets[NumPackets];
@@ -139,7 +140,8 @@ TEST(delayed_reader, delay) {
 
 TEST(delayed_reader, instant) {
     Queue queue;
-    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec);
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec,
+                     arena);
     CHECK(dr.is_valid());
 
     PacketPtr packets[NumPackets];
@@ -162,7 +164,8 @@ TEST(delayed_reader, instant) {
 
 TEST(delayed_reader, trim) {
     Queue queue;
-    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec);
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec,
+                     arena);
     CHECK(dr.is_valid());
 
     PacketPtr packets[NumPackets * 2];
@@ -185,7 +188,8 @@ TEST(delayed_reader, trim) {
 
 TEST(delayed_reader, late_duplicates) {
     Queue queue;
-    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec);
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, sample_spec,
+                     arena);
     CHECK(dr.is_valid());
 
     PacketPtr packets[NumPackets];
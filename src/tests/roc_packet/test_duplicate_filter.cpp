@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/duplicate_filter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 100, WindowSize = 8 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+PacketPtr new_packet(seqnum_t sn) {
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    pp->add_flags(Packet::FlagRTP);
+    pp->rtp()->seqnum = sn;
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(duplicate_filter) {
+    DuplicateFilterConfig config;
+
+    void setup() {
+        config.window_size = WindowSize;
+    }
+};
+
+TEST(duplicate_filter, no_duplicates) {
+    Queue queue;
+
+    DuplicateFilter filter(queue, arena, config);
+    CHECK(filter.is_valid());
+
+    for (seqnum_t sn = 0; sn < WindowSize * 3; sn++) {
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(WindowSize * 3, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, filter.num_dropped());
+}
+
+TEST(duplicate_filter, duplicates) {
+    Queue queue;
+
+    DuplicateFilter filter(queue, arena, config);
+    CHECK(filter.is_valid());
+
+    for (seqnum_t sn = 0; sn < WindowSize * 3; sn++) {
+        PacketPtr wp = new_packet(sn);
+        LONGS_EQUAL(status::StatusOK, filter.write(wp));
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn)));
+
+        // Only first copy is passed.
+        PacketPtr rp;
+        LONGS_EQUAL(status::StatusOK, queue.read(rp));
+        CHECK(rp == wp);
+        UNSIGNED_LONGS_EQUAL(0, queue.size());
+    }
+
+    UNSIGNED_LONGS_EQUAL(WindowSize * 3, filter.num_dropped());
+}
+
+TEST(duplicate_filter, delayed_path) {
+    enum { Delay = WindowSize / 2 };
+
+    Queue queue;
+
+    DuplicateFilter filter(queue, arena, config);
+    CHECK(filter.is_valid());
+
+    // Second path is a few packets behind first one.
+    for (seqnum_t sn = 0; sn < WindowSize * 3; sn++) {
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn)));
+        if (sn >= Delay) {
+            LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn - Delay)));
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(WindowSize * 3, queue.size());
+    UNSIGNED_LONGS_EQUAL(WindowSize * 3 - Delay, filter.num_dropped());
+}
+
+TEST(duplicate_filter, seqnum_wrap) {
+    Queue queue;
+
+    DuplicateFilter filter(queue, arena, config);
+    CHECK(filter.is_valid());
+
+    for (seqnum_t sn = seqnum_t(-WindowSize); sn != WindowSize; sn++) {
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn)));
+        LONGS_EQUAL(status::StatusOK, filter.write(new_packet(sn)));
+    }
+
+    UNSIGNED_LONGS_EQUAL(WindowSize * 2, queue.size());
+    UNSIGNED_LONGS_EQUAL(WindowSize * 2, filter.num_dropped());
+}
+
+TEST(duplicate_filter, non_rtp) {
+    Queue queue;
+
+    DuplicateFilter filter(queue, arena, config);
+    CHECK(filter.is_valid());
+
+    for (size_t n = 0; n < WindowSize; n++) {
+        PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+        LONGS_EQUAL(status::StatusOK, filter.write(pp));
+    }
+
+    UNSIGNED_LONGS_EQUAL(WindowSize, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, filter.num_dropped());
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/fanout.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 100, PacketSize = 40 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+PacketPtr new_packet(unsigned flags) {
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+    buffer.reslice(0, PacketSize);
+
+    pp->add_flags(Packet::FlagPrepared | Packet::FlagComposed | flags);
+    pp->set_buffer(buffer);
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(fanout) {};
+
+TEST(fanout, no_outputs) {
+    Fanout fanout(packet_factory, arena);
+
+    LONGS_EQUAL(status::StatusOK, fanout.write(new_packet(Packet::FlagAudio)));
+}
+
+TEST(fanout, one_output) {
+    Queue queue;
+
+    Fanout fanout(packet_factory, arena);
+    CHECK(fanout.add_output(queue));
+
+    PacketPtr wp = new_packet(Packet::FlagAudio);
+    LONGS_EQUAL(status::StatusOK, fanout.write(wp));
+
+    // Original packet is passed as is.
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    CHECK(rp == wp);
+
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+}
+
+TEST(fanout, multiple_outputs) {
+    enum { NumOutputs = 3 };
+
+    Queue queues[NumOutputs];
+
+    Fanout fanout(packet_factory, arena);
+    for (size_t n = 0; n < NumOutputs; n++) {
+        CHECK(fanout.add_output(queues[n]));
+    }
+
+    PacketPtr wp = new_packet(Packet::FlagAudio | Packet::FlagUDP | Packet::FlagRTP);
+    CHECK(wp->udp());
+    wp->rtp()->source_id = 123;
+    wp->rtp()->seqnum = 456;
+
+    LONGS_EQUAL(status::StatusOK, fanout.write(wp));
+
+    for (size_t n = 0; n < NumOutputs; n++) {
+        PacketPtr rp;
+        LONGS_EQUAL(status::StatusOK, queues[n].read(rp));
+        CHECK(rp);
+
+        if (n == 0) {
+            CHECK(rp == wp);
+            continue;
+        }
+
+        // Copy shares buffer and RTP header, but doesn't share UDP header.
+        CHECK(rp != wp);
+        CHECK(rp->buffer().data() == wp->buffer().data());
+        UNSIGNED_LONGS_EQUAL(wp->buffer().size(), rp->buffer().size());
+
+        CHECK(rp->has_flags(Packet::FlagAudio | Packet::FlagRTP | Packet::FlagPrepared
+                            | Packet::FlagComposed));
+        CHECK(!rp->udp());
+
+        UNSIGNED_LONGS_EQUAL(123, rp->rtp()->source_id);
+        UNSIGNED_LONGS_EQUAL(456, rp->rtp()->seqnum);
+
+        UNSIGNED_LONGS_EQUAL(0, queues[n].size());
+    }
+}
+
+TEST(fanout, remove_output) {
+    Queue queue1;
+    Queue queue2;
+
+    Fanout fanout(packet_factory, arena);
+    CHECK(fanout.add_output(queue1));
+    CHECK(fanout.add_output(queue2));
+
+    CHECK(fanout.has_output(queue1));
+    CHECK(fanout.has_output(queue2));
+
+    fanout.remove_output(queue1);
+
+    CHECK(!fanout.has_output(queue1));
+    CHECK(fanout.has_output(queue2));
+
+    PacketPtr wp = new_packet(Packet::FlagRepair);
+    LONGS_EQUAL(status::StatusOK, fanout.write(wp));
+
+    UNSIGNED_LONGS_EQUAL(0, queue1.size());
+    UNSIGNED_LONGS_EQUAL(1, queue2.size());
+
+    // Remaining output became first and receives original packet.
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, queue2.read(rp));
+    CHECK(rp == wp);
+}
+
+} // namespace packet
+} // namespace roc
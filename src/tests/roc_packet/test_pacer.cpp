@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/time.h"
+#include "roc_packet/pacer.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum {
+    MaxBufSize = 100,
+    SampleRate = 1000,
+    PacketDuration = 10 // 10 samples = 10ms
+};
+
+const core::nanoseconds_t PacketLength = 10 * core::Millisecond;
+
+// Tolerance for comparing scheduled time with wall clock.
+const core::nanoseconds_t Epsilon = 5 * core::Millisecond;
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, MaxBufSize);
+
+PacketPtr new_audio_packet() {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagRTP | Packet::FlagAudio);
+    packet->rtp()->duration = PacketDuration;
+
+    return packet;
+}
+
+PacketPtr new_repair_packet() {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagRepair);
+
+    return packet;
+}
+
+core::nanoseconds_t write_packet(Pacer& pacer, Queue& queue, const PacketPtr& pp) {
+    UNSIGNED_LONGS_EQUAL(status::StatusOK, pacer.write(pp));
+
+    PacketPtr rp;
+    UNSIGNED_LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    CHECK(rp == pp);
+
+    CHECK(rp->udp());
+    CHECK(rp->udp()->send_timestamp != 0);
+
+    return rp->udp()->send_timestamp;
+}
+
+} // namespace
+
+TEST_GROUP(pacer) {
+    PacerConfig config;
+
+    void setup() {
+        config.burst_packets = 1;
+        config.max_delay = core::Second;
+    }
+};
+
+TEST(pacer, invalid_config) {
+    Queue queue;
+
+    {
+        Pacer pacer(queue, config, 0);
+        CHECK(!pacer.is_valid());
+    }
+    {
+        PacerConfig bad_config = config;
+        bad_config.burst_packets = 0;
+        Pacer pacer(queue, bad_config, SampleRate);
+        CHECK(!pacer.is_valid());
+    }
+}
+
+TEST(pacer, no_rate_yet) {
+    Queue queue;
+    Pacer pacer(queue, config, SampleRate);
+    CHECK(pacer.is_valid());
+
+    // Without audio packets, rate is unknown and packets are not delayed.
+    for (size_t n = 0; n < 5; n++) {
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+        const core::nanoseconds_t ts = write_packet(pacer, queue, new_repair_packet());
+        CHECK(ts >= now);
+        CHECK(ts - now < Epsilon);
+    }
+
+    LONGS_EQUAL(0, pacer.packet_interval());
+    UNSIGNED_LONGS_EQUAL(0, pacer.metrics().paced_packets);
+}
+
+TEST(pacer, spread_burst) {
+    enum { NumPackets = 10 };
+
+    Queue queue;
+    Pacer pacer(queue, config, SampleRate);
+    CHECK(pacer.is_valid());
+
+    // Packets written at once are spread evenly using packet duration.
+    core::nanoseconds_t prev_ts = 0;
+    for (size_t n = 0; n < NumPackets; n++) {
+        const core::nanoseconds_t ts = write_packet(pacer, queue, new_audio_packet());
+        if (n != 0) {
+            LONGS_EQUAL(PacketLength, ts - prev_ts);
+        }
+        prev_ts = ts;
+    }
+
+    LONGS_EQUAL(PacketLength, pacer.packet_interval());
+
+    const PacerMetrics metrics = pacer.metrics();
+    UNSIGNED_LONGS_EQUAL(NumPackets - 1, metrics.paced_packets);
+    CHECK(metrics.pacing_delay > PacketLength * (NumPackets - 1) - Epsilon);
+    CHECK(metrics.max_pacing_delay >= metrics.pacing_delay);
+}
+
+TEST(pacer, repair_packets) {
+    enum { NumBlocks = 200, SourcePackets = 4, RepairPackets = 4 };
+
+    Queue queue;
+    Pacer pacer(queue, config, SampleRate);
+    CHECK(pacer.is_valid());
+
+    for (size_t bn = 0; bn < NumBlocks; bn++) {
+        for (size_t n = 0; n < SourcePackets; n++) {
+            CHECK(pacer.write(new_audio_packet()) == status::StatusOK);
+        }
+        for (size_t n = 0; n < RepairPackets; n++) {
+            CHECK(pacer.write(new_repair_packet()) == status::StatusOK);
+        }
+    }
+
+    // Repair packets have no duration, so media duration is shared between
+    // all packets, and interval is about half of packet length.
+    const core::nanoseconds_t expected_interval =
+        PacketLength * SourcePackets / (SourcePackets + RepairPackets);
+
+    CHECK(pacer.packet_interval() > expected_interval * 8 / 10);
+    CHECK(pacer.packet_interval() < expected_interval * 12 / 10);
+}
+
+TEST(pacer, burst_allowance) {
+    enum { BurstPackets = 3 };
+
+    config.burst_packets = BurstPackets;
+
+    Queue queue;
+    Pacer pacer(queue, config, SampleRate);
+    CHECK(pacer.is_valid());
+
+    const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+    // First packet defines rate, then BurstPackets are sent without delay.
+    for (size_t n = 0; n < BurstPackets; n++) {
+        const core::nanoseconds_t ts = write_packet(pacer, queue, new_audio_packet());
+        CHECK(ts - now < Epsilon);
+    }
+
+    // Next packets are paced.
+    const core::nanoseconds_t ts = write_packet(pacer, queue, new_audio_packet());
+    CHECK(ts - now > PacketLength - Epsilon);
+}
+
+TEST(pacer, max_delay) {
+    enum { NumPackets = 20 };
+
+    config.max_delay = PacketLength * 3;
+
+    Queue queue;
+    Pacer pacer(queue, config, SampleRate);
+    CHECK(pacer.is_valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        const core::nanoseconds_t ts = write_packet(pacer, queue, new_audio_packet());
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+        CHECK(ts - now <= config.max_delay);
+    }
+
+    CHECK(pacer.metrics().max_pacing_delay <= config.max_delay);
+    CHECK(pacer.metrics().max_pacing_delay > config.max_delay - Epsilon);
+}
+
+} // namespace packet
+} // namespace roc
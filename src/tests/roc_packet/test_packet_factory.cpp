@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/slab_pool.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { SmallSize = 64, MediumSize = 256, LargeSize = 1024 };
+
+core::HeapArena arena;
+
+} // namespace
+
+TEST_GROUP(packet_factory) {};
+
+TEST(packet_factory, no_small_pools) {
+    core::SlabPool<Packet> packet_pool("packet_pool", arena);
+    core::SlabPool<core::Buffer> buffer_pool("buffer_pool", arena,
+                                             sizeof(core::Buffer) + LargeSize);
+
+    PacketFactory factory(packet_pool, buffer_pool);
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.packet_buffer_size());
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer()->size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer(1)->size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer(LargeSize)->size());
+
+    CHECK(!factory.new_packet_buffer(LargeSize + 1));
+}
+
+TEST(packet_factory, small_pools) {
+    core::SlabPool<Packet> packet_pool("packet_pool", arena);
+    core::SlabPool<core::Buffer> small_pool("small_pool", arena,
+                                            sizeof(core::Buffer) + SmallSize);
+    core::SlabPool<core::Buffer> medium_pool("medium_pool", arena,
+                                             sizeof(core::Buffer) + MediumSize);
+    core::SlabPool<core::Buffer> buffer_pool("buffer_pool", arena,
+                                             sizeof(core::Buffer) + LargeSize);
+
+    PacketFactory factory(packet_pool, buffer_pool);
+
+    // added in reverse order
+    factory.add_small_buffer_pool(medium_pool);
+    factory.add_small_buffer_pool(small_pool);
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.packet_buffer_size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer()->size());
+
+    UNSIGNED_LONGS_EQUAL(SmallSize, factory.new_packet_buffer(1)->size());
+    UNSIGNED_LONGS_EQUAL(SmallSize, factory.new_packet_buffer(SmallSize)->size());
+
+    UNSIGNED_LONGS_EQUAL(MediumSize, factory.new_packet_buffer(SmallSize + 1)->size());
+    UNSIGNED_LONGS_EQUAL(MediumSize, factory.new_packet_buffer(MediumSize)->size());
+
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer(MediumSize + 1)->size());
+    UNSIGNED_LONGS_EQUAL(LargeSize, factory.new_packet_buffer(LargeSize)->size());
+
+    CHECK(!factory.new_packet_buffer(LargeSize + 1));
+
+    UNSIGNED_LONGS_EQUAL(0, small_pool.num_used_slots());
+    UNSIGNED_LONGS_EQUAL(0, medium_pool.num_used_slots());
+    UNSIGNED_LONGS_EQUAL(0, buffer_pool.num_used_slots());
+}
+
+} // namespace packet
+} // namespace roc
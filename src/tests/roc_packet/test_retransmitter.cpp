@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_packet/retransmitter.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BufferSize = 100, PacketSize = 40, HistorySize = 8 };
+
+core::HeapArena arena;
+PacketFactory packet_factory(arena, BufferSize);
+
+PacketPtr new_packet(seqnum_t sn) {
+    PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+    buffer.reslice(0, PacketSize);
+
+    pp->add_flags(Packet::FlagPrepared | Packet::FlagComposed | Packet::FlagAudio
+                  | Packet::FlagUDP | Packet::FlagRTP);
+    pp->set_buffer(buffer);
+    pp->rtp()->seqnum = sn;
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(retransmitter) {
+    RetransmitterConfig config;
+
+    void setup() {
+        config.history_size = HistorySize;
+    }
+};
+
+TEST(retransmitter, write) {
+    Queue queue;
+
+    Retransmitter retransmitter(queue, packet_factory, arena, config);
+    CHECK(retransmitter.is_valid());
+
+    PacketPtr wp = new_packet(100);
+    LONGS_EQUAL(status::StatusOK, retransmitter.write(wp));
+
+    // Original packet is passed as is.
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    CHECK(rp == wp);
+
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+}
+
+TEST(retransmitter, retransmit) {
+    Queue queue;
+
+    Retransmitter retransmitter(queue, packet_factory, arena, config);
+    CHECK(retransmitter.is_valid());
+
+    PacketPtr wp = new_packet(100);
+    wp->udp()->send_timestamp = 123;
+    LONGS_EQUAL(status::StatusOK, retransmitter.write(wp));
+    LONGS_EQUAL(status::StatusOK, retransmitter.write(new_packet(101)));
+
+    PacketPtr rp;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    LONGS_EQUAL(status::StatusOK, queue.read(rp));
+
+    LONGS_EQUAL(status::StatusOK, retransmitter.retransmit(100));
+
+    // Copy shares buffer with original packet.
+    LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    CHECK(rp != wp);
+    CHECK(rp->flags() == wp->flags());
+    CHECK(rp->buffer().data() == wp->buffer().data());
+    UNSIGNED_LONGS_EQUAL(100, rp->rtp()->seqnum);
+    LONGS_EQUAL(0, rp->udp()->send_timestamp);
+
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    UNSIGNED_LONGS_EQUAL(1, retransmitter.metrics().requested_packets);
+    UNSIGNED_LONGS_EQUAL(1, retransmitter.metrics().retransmitted_packets);
+}
+
+TEST(retransmitter, not_in_history) {
+    Queue queue;
+
+    Retransmitter retransmitter(queue, packet_factory, arena, config);
+    CHECK(retransmitter.is_valid());
+
+    for (seqnum_t sn = 100; sn < 100 + HistorySize + 1; sn++) {
+        LONGS_EQUAL(status::StatusOK, retransmitter.write(new_packet(sn)));
+    }
+    while (queue.size() != 0) {
+        PacketPtr rp;
+        LONGS_EQUAL(status::StatusOK, queue.read(rp));
+    }
+
+    // Never sent.
+    LONGS_EQUAL(status::StatusOK, retransmitter.retransmit(50));
+    // Evicted by newer packet.
+    LONGS_EQUAL(status::StatusOK, retransmitter.retransmit(100));
+
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    UNSIGNED_LONGS_EQUAL(2, retransmitter.metrics().requested_packets);
+    UNSIGNED_LONGS_EQUAL(0, retransmitter.metrics().retransmitted_packets);
+}
+
+} // namespace packet
+} // namespace roc
@@ -189,5 +189,25 @@ TEST(shipper, packet_not_composed) {
     CHECK(wp == rp);
 }
 
+TEST(shipper, repair_packet_dropped) {
+    address::SocketAddr address;
+    MockComposer composer;
+    MockWriter writer(status::StatusLimit);
+
+    Shipper shipper(composer, writer, &address);
+
+    PacketPtr repair_pp = new_packet();
+    repair_pp->add_flags(Packet::FlagRepair);
+
+    // dropped repair packet is not an error
+    LONGS_EQUAL(status::StatusOK, shipper.write(repair_pp));
+    LONGS_EQUAL(status::StatusOK, shipper.write(repair_pp));
+    UNSIGNED_LONGS_EQUAL(2, shipper.num_dropped_repair());
+
+    // source packet can't be dropped
+    LONGS_EQUAL(status::StatusLimit, shipper.write(new_packet()));
+    UNSIGNED_LONGS_EQUAL(2, shipper.num_dropped_repair());
+}
+
 } // namespace packet
 } // namespace roc
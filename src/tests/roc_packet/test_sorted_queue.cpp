@@ -8,6 +8,7 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "roc_core/fast_random.h"
 #include "roc_core/heap_arena.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_packet/sorted_queue.h"
@@ -32,12 +33,23 @@ PacketPtr new_packet(seqnum_t sn) {
     return packet;
 }
 
+PacketPtr new_fec_packet(blknum_t sbn, size_t esi) {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagFEC);
+    packet->fec()->source_block_number = sbn;
+    packet->fec()->encoding_symbol_id = esi;
+
+    return packet;
+}
+
 } // namespace
 
 TEST_GROUP(sorted_queue) {};
 
 TEST(sorted_queue, empty) {
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     CHECK(!queue.tail());
     CHECK(!queue.head());
@@ -50,7 +62,7 @@ TEST(sorted_queue, empty) {
 }
 
 TEST(sorted_queue, two_packets) {
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(1);
     PacketPtr wp2 = new_packet(2);
@@ -91,7 +103,7 @@ TEST(sorted_queue, two_packets) {
 TEST(sorted_queue, many_packets) {
     enum { NumPackets = 10 };
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr packets[NumPackets];
 
@@ -119,7 +131,7 @@ TEST(sorted_queue, many_packets) {
 }
 
 TEST(sorted_queue, out_of_order) {
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(1);
     PacketPtr wp2 = new_packet(2);
@@ -159,7 +171,7 @@ TEST(sorted_queue, out_of_order) {
 TEST(sorted_queue, out_of_order_many_packets) {
     enum { NumPackets = 20 };
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     for (packet::seqnum_t n = 0; n < 7; ++n) {
         LONGS_EQUAL(status::StatusOK, queue.write(new_packet(n)));
@@ -200,7 +212,7 @@ TEST(sorted_queue, out_of_order_many_packets) {
 }
 
 TEST(sorted_queue, one_duplicate) {
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(1);
     PacketPtr wp2 = new_packet(1);
@@ -230,7 +242,7 @@ TEST(sorted_queue, one_duplicate) {
 TEST(sorted_queue, many_duplicates) {
     const size_t NumPackets = 10;
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     for (seqnum_t n = 0; n < NumPackets; n++) {
         LONGS_EQUAL(status::StatusOK, queue.write(new_packet(n)));
@@ -254,7 +266,7 @@ TEST(sorted_queue, many_duplicates) {
 }
 
 TEST(sorted_queue, max_size) {
-    SortedQueue queue(2);
+    SortedQueue queue(arena, 2);
 
     PacketPtr wp1 = new_packet(1);
     PacketPtr wp2 = new_packet(2);
@@ -265,6 +277,7 @@ TEST(sorted_queue, max_size) {
     LONGS_EQUAL(status::StatusOK, queue.write(wp3));
 
     LONGS_EQUAL(2, queue.size());
+    LONGS_EQUAL(1, queue.num_overflows());
 
     CHECK(queue.head() == wp1);
     CHECK(queue.tail() == wp2);
@@ -278,6 +291,7 @@ TEST(sorted_queue, max_size) {
     LONGS_EQUAL(status::StatusOK, queue.write(wp3));
 
     LONGS_EQUAL(2, queue.size());
+    LONGS_EQUAL(1, queue.num_overflows());
 
     CHECK(queue.head() == wp2);
     CHECK(queue.tail() == wp3);
@@ -286,7 +300,7 @@ TEST(sorted_queue, max_size) {
 TEST(sorted_queue, overflow_ordered1) {
     const seqnum_t sn = seqnum_t(-1);
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(seqnum_t(sn - 10));
     PacketPtr wp2 = new_packet(sn);
@@ -318,7 +332,7 @@ TEST(sorted_queue, overflow_ordered1) {
 TEST(sorted_queue, overflow_ordered2) {
     const seqnum_t sn = seqnum_t(-1) >> 1;
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(seqnum_t(sn - 10));
     PacketPtr wp2 = new_packet(sn);
@@ -350,7 +364,7 @@ TEST(sorted_queue, overflow_ordered2) {
 TEST(sorted_queue, overflow_sorting) {
     const seqnum_t sn = seqnum_t(-1);
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(seqnum_t(sn - 10));
     PacketPtr wp2 = new_packet(sn);
@@ -382,7 +396,7 @@ TEST(sorted_queue, overflow_sorting) {
 TEST(sorted_queue, overflow_out_of_order) {
     const seqnum_t sn = seqnum_t(-1);
 
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(seqnum_t(sn - 10));
     PacketPtr wp2 = new_packet(sn);
@@ -418,7 +432,7 @@ TEST(sorted_queue, overflow_out_of_order) {
 }
 
 TEST(sorted_queue, latest) {
-    SortedQueue queue(0);
+    SortedQueue queue(arena, 0);
 
     PacketPtr wp1 = new_packet(1);
     PacketPtr wp2 = new_packet(3);
@@ -472,5 +486,172 @@ TEST(sorted_queue, latest) {
     CHECK(queue.latest() == wp4);
 }
 
+TEST(sorted_queue, many_packets_shuffled) {
+    enum { NumPackets = 500, Shift = 65000 };
+
+    SortedQueue queue(arena, 0);
+
+    PacketPtr packets[NumPackets];
+    size_t order[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        // every 7th packet is lost, seqnums wrap
+        packets[n] = new_packet(seqnum_t(Shift + n * 8 / 7));
+        order[n] = n;
+    }
+
+    for (size_t n = NumPackets - 1; n > 0; n--) {
+        const size_t k = core::fast_random_range(0, n);
+        const size_t tmp = order[n];
+        order[n] = order[k];
+        order[k] = tmp;
+    }
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        LONGS_EQUAL(status::StatusOK, queue.write(packets[order[n]]));
+        // duplicates are dropped
+        LONGS_EQUAL(status::StatusOK, queue.write(packets[order[n]]));
+    }
+
+    LONGS_EQUAL(NumPackets, queue.size());
+    CHECK(queue.head() == packets[0]);
+    CHECK(queue.tail() == packets[NumPackets - 1]);
+    CHECK(queue.latest() == packets[NumPackets - 1]);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        CHECK(queue.head() == packets[n]);
+
+        PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, queue.read(pp));
+        CHECK(pp == packets[n]);
+    }
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.head());
+    CHECK(!queue.tail());
+}
+
+TEST(sorted_queue, interleaved_write_read) {
+    enum { NumPackets = 1000, Window = 40 };
+
+    SortedQueue queue(arena, 0);
+
+    // write packets slightly out of order and read them while writing,
+    // so that ring wraps around many times
+    seqnum_t next_read = 0;
+
+    for (size_t n = 0; n < NumPackets; n += 2) {
+        LONGS_EQUAL(status::StatusOK, queue.write(new_packet(seqnum_t(n + 1))));
+        LONGS_EQUAL(status::StatusOK, queue.write(new_packet(seqnum_t(n))));
+
+        while (queue.size() > Window) {
+            PacketPtr pp;
+            LONGS_EQUAL(status::StatusOK, queue.read(pp));
+            LONGS_EQUAL(next_read, pp->rtp()->seqnum);
+            next_read++;
+        }
+    }
+
+    while (queue.size() > 0) {
+        PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, queue.read(pp));
+        LONGS_EQUAL(next_read, pp->rtp()->seqnum);
+        next_read++;
+    }
+
+    LONGS_EQUAL(NumPackets, next_read);
+}
+
+TEST(sorted_queue, too_far_packet) {
+    SortedQueue queue(arena, 0);
+
+    PacketPtr wp1 = new_packet(100);
+    PacketPtr wp2 = new_packet(110);
+    PacketPtr wp3 = new_packet(seqnum_t(100 - 32760));
+
+    LONGS_EQUAL(status::StatusOK, queue.write(wp1));
+    LONGS_EQUAL(status::StatusOK, queue.write(wp2));
+
+    // distance between tail and new head exceeds half of seqnum range, dropped
+    LONGS_EQUAL(status::StatusOK, queue.write(wp3));
+
+    LONGS_EQUAL(2, queue.size());
+    CHECK(queue.head() == wp1);
+    CHECK(queue.tail() == wp2);
+    CHECK(queue.latest() == wp2);
+}
+
+TEST(sorted_queue, fec_packets) {
+    SortedQueue queue(arena, 0);
+
+    PacketPtr wp1 = new_fec_packet(1, 0);
+    PacketPtr wp2 = new_fec_packet(1, 1);
+    PacketPtr wp3 = new_fec_packet(2, 0);
+
+    LONGS_EQUAL(status::StatusOK, queue.write(wp3));
+    LONGS_EQUAL(status::StatusOK, queue.write(wp1));
+    LONGS_EQUAL(status::StatusOK, queue.write(wp2));
+    LONGS_EQUAL(status::StatusOK, queue.write(wp2));
+
+    LONGS_EQUAL(3, queue.size());
+    CHECK(queue.head() == wp1);
+    CHECK(queue.tail() == wp3);
+
+    PacketPtr rp1;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp1));
+    CHECK(rp1 == wp1);
+
+    PacketPtr rp2;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp2));
+    CHECK(rp2 == wp2);
+
+    PacketPtr rp3;
+    LONGS_EQUAL(status::StatusOK, queue.read(rp3));
+    CHECK(rp3 == wp3);
+
+    LONGS_EQUAL(0, queue.size());
+}
+
+TEST(sorted_queue, metrics) {
+    SortedQueue queue(arena, 0);
+
+    UNSIGNED_LONGS_EQUAL(0, queue.metrics().occupancy);
+    UNSIGNED_LONGS_EQUAL(0, queue.metrics().max_occupancy);
+    UNSIGNED_LONGS_EQUAL(0, queue.metrics().throughput);
+
+    for (seqnum_t n = 0; n < 5; n++) {
+        LONGS_EQUAL(status::StatusOK, queue.write(new_packet(n)));
+    }
+
+    for (size_t n = 0; n < 3; n++) {
+        PacketPtr pp;
+        LONGS_EQUAL(status::StatusOK, queue.read(pp));
+    }
+
+    LONGS_EQUAL(status::StatusOK, queue.write(new_packet(5)));
+
+    UNSIGNED_LONGS_EQUAL(3, queue.metrics().occupancy);
+    UNSIGNED_LONGS_EQUAL(5, queue.metrics().max_occupancy);
+    UNSIGNED_LONGS_EQUAL(3, queue.metrics().throughput);
+
+    PacketPtr pp;
+    while (queue.read(pp) == status::StatusOK) {
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, queue.metrics().occupancy);
+    UNSIGNED_LONGS_EQUAL(5, queue.metrics().max_occupancy);
+    UNSIGNED_LONGS_EQUAL(6, queue.metrics().throughput);
+}
+
+TEST(sorted_queue, incompatible_packets) {
+    SortedQueue queue(arena, 0);
+
+    LONGS_EQUAL(status::StatusOK, queue.write(new_packet(1)));
+    LONGS_EQUAL(status::StatusOK, queue.write(new_fec_packet(1, 0)));
+
+    LONGS_EQUAL(1, queue.size());
+    CHECK(queue.head()->rtp());
+}
+
 } // namespace packet
 } // namespace roc
@@ -27,15 +27,31 @@ namespace {
 // Note that the scheduling time for one-thread run is higher because the
 // pipeline is able to perform in-place task execution in this case and the
 // scheduling time also includes task execution time.
+//
+// ScheduleFrames benchmark additionally dedicates first thread to frame
+// processing, which updates pipeline state read by scheduling threads. It
+// allows to ensure that frame processing does not slow down scheduling because
+// of cross-thread contention on shared pipeline fields.
 
 enum {
     SampleRate = 1000000, // 1 sample = 1 us (for convenience)
     Chans = 0x1,
     NumThreads = 16,
     NumIterations = 1000000,
-    BatchSize = 10000
+    BatchSize = 10000,
+    FrameSize = 100
 };
 
+#if defined(ROC_BENCHMARK_USE_ACCESSORS)
+inline int get_thread_index(const benchmark::State& state) {
+    return state.thread_index();
+}
+#else
+inline int get_thread_index(const benchmark::State& state) {
+    return state.thread_index;
+}
+#endif
+
 core::HeapArena arena;
 
 class NoopPipeline : public PipelineLoop,
@@ -63,6 +79,8 @@ public:
         control_queue_.wait(control_task_);
     }
 
+    using PipelineLoop::process_subframes_and_tasks;
+
     void stop_and_wait() {
         control_queue_.async_cancel(control_task_);
 
@@ -154,6 +172,37 @@ BENCHMARK_REGISTER_F(BM_PipelineContention, Schedule)
     ->Iterations(NumIterations)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_DEFINE_F(BM_PipelineContention, ScheduleFrames)(benchmark::State& state) {
+    if (get_thread_index(state) == 0) {
+        audio::sample_t samples[FrameSize * Chans] = {};
+
+        while (state.KeepRunningBatch(BatchSize)) {
+            for (int n = 0; n < BatchSize; n++) {
+                audio::Frame frame(samples, FrameSize * Chans);
+                pipeline.process_subframes_and_tasks(frame);
+            }
+        }
+    } else {
+        NoopPipeline::Task* tasks = new NoopPipeline::Task[NumIterations];
+        size_t n_task = 0;
+
+        while (state.KeepRunningBatch(BatchSize)) {
+            for (int n = 0; n < BatchSize; n++) {
+                pipeline.schedule(tasks[n_task++], completer);
+            }
+        }
+
+        pipeline.stop_and_wait();
+
+        delete[] tasks;
+    }
+}
+
+BENCHMARK_REGISTER_F(BM_PipelineContention, ScheduleFrames)
+    ->ThreadRange(2, NumThreads)
+    ->Iterations(NumIterations)
+    ->Unit(benchmark::kMicrosecond);
+
 } // namespace
 } // namespace pipeline
 } // namespace roc
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/panic.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/receiver_source.h"
+#include "roc_pipeline/sender_sink.h"
+#include "roc_rtp/encoding_map.h"
+
+// Measures how many sessions one ReceiverSource can depacketize, decode, resample
+// and mix per core.
+//
+// Packets are produced by a SenderSink with one slot per session, so that each
+// session has its own SSRC and source address. Packets are generated in batches
+// outside of timed region and then delivered to receiver just in time, keeping
+// receiver queues at target latency. Every benchmark iteration reads one frame.
+//
+// Parameters:
+//  - number of sessions mixed by receiver
+//  - frame length, in samples per channel at output rate
+//  - FEC scheme; when FEC is enabled, one of FecLossInterval source packets is
+//    dropped, so that repair path is actually exercised
+//  - resampler backend; when none, output rate matches packet rate and resampler
+//    is not used at all
+//
+// Reported counters:
+//  - Time - nanoseconds per frame
+//  - samples/s - samples per channel produced per second, summed over sessions
+//  - rt_factor - seconds of output produced per second, i.e. how many times
+//    faster than real-time receiver works
+//
+// FrameOverhead benchmark reads very short frames (down to 125us) from one
+// session without FEC and resampler, with and without low-latency profile.
+// Since there is almost no audio processing, Time is dominated by fixed
+// per-frame overhead, in nanoseconds.
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+enum {
+    MaxSessions = 32,
+    MaxFrameSamples = 2048,
+    MaxBufSize = 2048,
+
+    PacketRate = 44100,
+    ResampledRate = 48000,
+    NumChans = 2,
+
+    PacketSamples = PacketRate / 100,
+    BatchPackets = 100,
+
+    FecLossInterval = 25
+};
+
+enum Backend {
+    Backend_None,
+    Backend_Builtin,
+    Backend_Speex,
+    Backend_SpeexDec
+};
+
+const core::nanoseconds_t TargetLatency = 60 * core::Millisecond;
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    packet_buffer_pool("packet_buffer_pool", arena, sizeof(core::Buffer) + MaxBufSize);
+core::SlabPool<core::Buffer>
+    frame_buffer_pool("frame_buffer_pool",
+                      arena,
+                      sizeof(core::Buffer)
+                          + MaxFrameSamples * NumChans * sizeof(audio::sample_t));
+
+packet::PacketFactory packet_factory(packet_pool, packet_buffer_pool);
+
+rtp::EncodingMap encoding_map(arena);
+
+audio::SampleSpec make_spec(size_t sample_rate) {
+    audio::SampleSpec spec;
+    spec.set_sample_rate(sample_rate);
+    spec.set_sample_format(audio::SampleFormat_Pcm);
+    spec.set_pcm_format(audio::Sample_RawFormat);
+    spec.channel_set().set_layout(audio::ChanLayout_Surround);
+    spec.channel_set().set_order(audio::ChanOrder_Smpte);
+    spec.channel_set().set_mask(audio::ChanMask_Surround_Stereo);
+    return spec;
+}
+
+bool is_backend_supported(Backend backend, audio::ResamplerBackend& backend_id) {
+    switch (backend) {
+    case Backend_None:
+        backend_id = audio::ResamplerBackend_Default;
+        return true;
+    case Backend_Builtin:
+        backend_id = audio::ResamplerBackend_Builtin;
+        break;
+    case Backend_Speex:
+        backend_id = audio::ResamplerBackend_Speex;
+        break;
+    case Backend_SpeexDec:
+        backend_id = audio::ResamplerBackend_SpeexDec;
+        break;
+    }
+    return audio::ResamplerMap::instance().is_supported(backend_id);
+}
+
+class ReceiverBench {
+public:
+    ReceiverBench(size_t n_sessions,
+                  size_t frame_size,
+                  bool fec,
+                  Backend backend,
+                  bool low_latency = false)
+        : n_sessions_(n_sessions)
+        , frame_size_(frame_size)
+        , fec_(fec)
+        , backend_(backend)
+        , low_latency_(low_latency)
+        , source_writer_(NULL)
+        , repair_writer_(NULL)
+        , send_ts_(core::Second)
+        , read_ns_(0)
+        , n_source_(0) {
+        roc_panic_if(n_sessions > MaxSessions);
+        roc_panic_if(frame_size > MaxFrameSamples);
+    }
+
+    const char* init() {
+        audio::ResamplerBackend backend_id = audio::ResamplerBackend_Default;
+        if (!is_backend_supported(backend_, backend_id)) {
+            return "resampler backend not supported";
+        }
+        if (fec_ && !fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+            return "fec scheme not supported";
+        }
+
+        SenderSinkConfig sender_config;
+        sender_config.input_sample_spec = make_spec(PacketRate);
+        sender_config.payload_type = rtp::PayloadType_L16_Stereo;
+        sender_config.packet_length = PacketSamples * core::Second / PacketRate;
+        sender_config.fec_encoder.scheme =
+            fec_ ? packet::FEC_ReedSolomon_M8 : packet::FEC_None;
+        sender_config.enable_timing = false;
+        sender_config.latency.tuner_backend = audio::LatencyTunerBackend_Niq;
+        sender_config.latency.tuner_profile = audio::LatencyTunerProfile_Intact;
+
+        ReceiverSourceConfig receiver_config;
+        receiver_config.common.output_sample_spec =
+            make_spec(backend_ == Backend_None ? PacketRate : ResampledRate);
+        receiver_config.common.enable_timing = false;
+        receiver_config.common.enable_low_latency = low_latency_;
+        receiver_config.session_defaults.latency.tuner_backend =
+            audio::LatencyTunerBackend_Niq;
+        receiver_config.session_defaults.latency.tuner_profile =
+            audio::LatencyTunerProfile_Intact;
+        receiver_config.session_defaults.latency.target_latency = TargetLatency;
+        receiver_config.session_defaults.resampler.backend = backend_id;
+
+        out_spec_ = receiver_config.common.output_sample_spec;
+
+        sender_.reset(new (sender_) SenderSink(sender_config, encoding_map, packet_pool,
+                                               packet_buffer_pool, frame_buffer_pool,
+                                               arena));
+        if (!sender_ || !sender_->is_valid()) {
+            return "can't create sender";
+        }
+
+        receiver_.reset(new (receiver_)
+                            ReceiverSource(receiver_config, encoding_map, packet_pool,
+                                           packet_buffer_pool, frame_buffer_pool, arena));
+        if (!receiver_ || !receiver_->is_valid()) {
+            return "can't create receiver";
+        }
+
+        const address::Protocol source_proto =
+            fec_ ? address::Proto_RTP_RS8M_Source : address::Proto_RTP;
+        const address::Protocol repair_proto = address::Proto_RS8M_Repair;
+
+        address::SocketAddr source_addr;
+        address::SocketAddr repair_addr;
+        if (!source_addr.set_host_port(address::Family_IPv4, "127.0.0.1", 10001)
+            || !repair_addr.set_host_port(address::Family_IPv4, "127.0.0.1", 10002)) {
+            return "can't set address";
+        }
+
+        ReceiverSlotConfig receiver_slot_config;
+        ReceiverSlot* receiver_slot = receiver_->create_slot(receiver_slot_config);
+        if (!receiver_slot) {
+            return "can't create receiver slot";
+        }
+
+        ReceiverEndpoint* source_endpoint = receiver_slot->add_endpoint(
+            address::Iface_AudioSource, source_proto, source_addr, NULL);
+        if (!source_endpoint) {
+            return "can't create receiver endpoint";
+        }
+        source_writer_ = &source_endpoint->inbound_writer();
+
+        if (fec_) {
+            ReceiverEndpoint* repair_endpoint = receiver_slot->add_endpoint(
+                address::Iface_AudioRepair, repair_proto, repair_addr, NULL);
+            if (!repair_endpoint) {
+                return "can't create receiver endpoint";
+            }
+            repair_writer_ = &repair_endpoint->inbound_writer();
+        }
+
+        for (size_t n = 0; n < n_sessions_; n++) {
+            SenderSlotConfig sender_slot_config;
+            SenderSlot* sender_slot = sender_->create_slot(sender_slot_config);
+            if (!sender_slot) {
+                return "can't create sender slot";
+            }
+
+            if (!sender_slot->add_endpoint(address::Iface_AudioSource, source_proto,
+                                           source_addr, queues_[n])) {
+                return "can't create sender endpoint";
+            }
+            if (fec_
+                && !sender_slot->add_endpoint(address::Iface_AudioRepair, repair_proto,
+                                              repair_addr, queues_[n])) {
+                return "can't create sender endpoint";
+            }
+
+            if (!sender_addrs_[n].set_host_port(address::Family_IPv4, "127.0.0.2",
+                                                int(20000 + n))) {
+                return "can't set address";
+            }
+            delivered_ns_[n] = 0;
+        }
+
+        for (size_t ns = 0; ns < PacketSamples * NumChans; ns++) {
+            // non-silent signal, so that watchdog doesn't terminate sessions
+            send_samples_[ns] = (audio::sample_t)((ns % 200) / 100.0 - 0.5);
+        }
+
+        // fill queues up to target latency and let all sessions start playing
+        while (read_ns_ < TargetLatency * 4) {
+            read_frame(NULL);
+        }
+
+        if (receiver_->num_sessions() != n_sessions_) {
+            return "unexpected number of sessions";
+        }
+
+        return NULL;
+    }
+
+    audio::SampleSpec output_spec() const {
+        return out_spec_;
+    }
+
+    void read_frame(benchmark::State* state) {
+        deliver_(state);
+
+        audio::Frame frame(recv_samples_, frame_size_ * NumChans);
+
+        receiver_->refresh(core::Second + read_ns_);
+        if (!receiver_->read(frame)) {
+            roc_panic("bench: can't read frame");
+        }
+
+        read_ns_ += out_spec_.samples_per_chan_2_ns(frame_size_);
+    }
+
+private:
+    void deliver_(benchmark::State* state) {
+        for (size_t n = 0; n < n_sessions_; n++) {
+            while (delivered_ns_[n] < read_ns_ + TargetLatency) {
+                packet::PacketPtr pp;
+                if (queues_[n].read(pp) != status::StatusOK) {
+                    if (state) {
+                        state->PauseTiming();
+                    }
+                    generate_();
+                    if (state) {
+                        state->ResumeTiming();
+                    }
+                    continue;
+                }
+
+                if (pp->flags() & packet::Packet::FlagAudio) {
+                    delivered_ns_[n] += packet::stream_timestamp_t(pp->rtp()->duration)
+                        * core::Second / PacketRate;
+
+                    if (fec_ && ++n_source_ % FecLossInterval == 0) {
+                        continue;
+                    }
+                    write_packet_(*source_writer_, pp, sender_addrs_[n]);
+                } else if (pp->flags() & packet::Packet::FlagRepair) {
+                    write_packet_(*repair_writer_, pp, sender_addrs_[n]);
+                }
+            }
+        }
+    }
+
+    // produce next batch of packets for all sessions
+    void generate_() {
+        for (size_t np = 0; np < BatchPackets; np++) {
+            audio::Frame frame(send_samples_, PacketSamples * NumChans);
+            frame.set_duration(PacketSamples);
+
+            sender_->write(frame);
+            sender_->refresh(send_ts_);
+
+            send_ts_ += PacketSamples * core::Second / PacketRate;
+        }
+    }
+
+    // creates a new packet with the same buffer, without any meta-information,
+    // as if it was delivered over network
+    void write_packet_(packet::IWriter& writer,
+                       const packet::PacketPtr& pa,
+                       const address::SocketAddr& src_addr) {
+        packet::PacketPtr pb = packet_factory.new_packet();
+        if (!pb) {
+            roc_panic("bench: can't allocate packet");
+        }
+
+        pb->add_flags(packet::Packet::FlagUDP);
+        pb->udp()->src_addr = src_addr;
+        pb->set_buffer(pa->buffer());
+
+        if (writer.write(pb) != status::StatusOK) {
+            roc_panic("bench: can't write packet");
+        }
+    }
+
+    const size_t n_sessions_;
+    const size_t frame_size_;
+    const bool fec_;
+    const Backend backend_;
+    const bool low_latency_;
+
+    audio::SampleSpec out_spec_;
+
+    core::Optional<SenderSink> sender_;
+    core::Optional<ReceiverSource> receiver_;
+
+    packet::IWriter* source_writer_;
+    packet::IWriter* repair_writer_;
+
+    packet::Queue queues_[MaxSessions];
+    address::SocketAddr sender_addrs_[MaxSessions];
+    core::nanoseconds_t delivered_ns_[MaxSessions];
+
+    core::nanoseconds_t send_ts_;
+    core::nanoseconds_t read_ns_;
+    size_t n_source_;
+
+    audio::sample_t send_samples_[PacketSamples * NumChans];
+    audio::sample_t recv_samples_[MaxFrameSamples * NumChans];
+};
+
+void BM_ReceiverSource_Throughput(benchmark::State& state) {
+    const size_t n_sessions = (size_t)state.range(0);
+    const size_t frame_size = (size_t)state.range(1);
+    const bool fec = state.range(2) != 0;
+    const Backend backend = (Backend)state.range(3);
+
+    ReceiverBench bench(n_sessions, frame_size, fec, backend);
+
+    if (const char* error = bench.init()) {
+        state.SkipWithError(error);
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        bench.read_frame(&state);
+    }
+
+    const double frame_duration =
+        (double)bench.output_spec().samples_per_chan_2_ns(frame_size) / core::Second;
+
+    state.counters["samples/s"] = benchmark::Counter(
+        double(state.iterations()) * double(frame_size * n_sessions),
+        benchmark::Counter::kIsRate);
+    state.counters["rt_factor"] = benchmark::Counter(
+        state.iterations() * frame_duration, benchmark::Counter::kIsRate);
+}
+
+void throughput_args(benchmark::internal::Benchmark* b) {
+    const int sessions[] = { 1, 4, 16 };
+    // 2.5ms, 10ms, 20ms at 48kHz
+    const int frames[] = { 120, 480, 960 };
+    const int backends[] = { Backend_None, Backend_Builtin, Backend_Speex,
+                             Backend_SpeexDec };
+
+    std::vector<std::string> names;
+    names.push_back("sess");
+    names.push_back("frame");
+    names.push_back("fec");
+    names.push_back("rs");
+    b->ArgNames(names);
+
+    for (size_t n_sess = 0; n_sess < ROC_ARRAY_SIZE(sessions); n_sess++) {
+        for (size_t n_frm = 0; n_frm < ROC_ARRAY_SIZE(frames); n_frm++) {
+            for (int fec = 0; fec <= 1; fec++) {
+                for (size_t n_bk = 0; n_bk < ROC_ARRAY_SIZE(backends); n_bk++) {
+                    std::vector<int64_t> args;
+                    args.push_back(sessions[n_sess]);
+                    args.push_back(frames[n_frm]);
+                    args.push_back(fec);
+                    args.push_back(backends[n_bk]);
+                    b->Args(args);
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_ReceiverSource_Throughput)
+    ->Apply(throughput_args)
+    ->Unit(benchmark::kNanosecond);
+
+void BM_ReceiverSource_FrameOverhead(benchmark::State& state) {
+    const size_t frame_size = (size_t)state.range(0);
+    const bool low_latency = state.range(1) != 0;
+
+    ReceiverBench bench(1, frame_size, false, Backend_None, low_latency);
+
+    if (const char* error = bench.init()) {
+        state.SkipWithError(error);
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        bench.read_frame(&state);
+    }
+
+    const double frame_duration =
+        (double)bench.output_spec().samples_per_chan_2_ns(frame_size) / core::Second;
+
+    state.counters["rt_factor"] = benchmark::Counter(
+        state.iterations() * frame_duration, benchmark::Counter::kIsRate);
+}
+
+void frame_overhead_args(benchmark::internal::Benchmark* b) {
+    // 125us, 250us, 1ms, 5ms at 44.1kHz
+    const int frames[] = { 6, 11, 44, 220 };
+
+    std::vector<std::string> names;
+    names.push_back("frame");
+    names.push_back("ll");
+    b->ArgNames(names);
+
+    for (size_t n_frm = 0; n_frm < ROC_ARRAY_SIZE(frames); n_frm++) {
+        for (int ll = 0; ll <= 1; ll++) {
+            std::vector<int64_t> args;
+            args.push_back(frames[n_frm]);
+            args.push_back(ll);
+            b->Args(args);
+        }
+    }
+}
+
+BENCHMARK(BM_ReceiverSource_FrameOverhead)
+    ->Apply(frame_overhead_args)
+    ->Unit(benchmark::kNanosecond);
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
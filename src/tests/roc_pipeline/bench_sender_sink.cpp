@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/panic.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/iwriter.h"
+#include "roc_pipeline/sender_sink.h"
+#include "roc_rtp/encoding_map.h"
+
+// Measures CPU cost of SenderSink per second of audio.
+//
+// Every benchmark iteration writes one frame to SenderSink with one slot. Produced
+// packets go to a writer that drops them, so that only pipeline is measured.
+//
+// Parameters:
+//  - FEC scheme (none, Reed-Solomon, LDPC-Staircase)
+//  - FEC block size, number of source packets; number of repair packets is half
+//    of it; ignored if FEC is disabled
+//  - interleaving on/off
+//  - packet length, in milliseconds
+//
+// Reported counters:
+//  - Time - nanoseconds per frame
+//  - cpu_load - seconds spent per second of audio, i.e. fraction of one core
+//    needed to send one stream in real time
+//  - packets/s - packets produced per second
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+enum {
+    MaxBufSize = 4096,
+
+    SampleRate = 44100,
+    NumChans = 2,
+
+    FrameSamples = SampleRate / 100
+};
+
+enum Scheme { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+
+core::HeapArena arena;
+
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    packet_buffer_pool("packet_buffer_pool", arena, sizeof(core::Buffer) + MaxBufSize);
+core::SlabPool<core::Buffer>
+    frame_buffer_pool("frame_buffer_pool",
+                      arena,
+                      sizeof(core::Buffer) + MaxBufSize * sizeof(audio::sample_t));
+
+rtp::EncodingMap encoding_map(arena);
+
+class NullWriter : public packet::IWriter {
+public:
+    NullWriter()
+        : n_packets_(0) {
+    }
+
+    size_t num_packets() const {
+        return n_packets_;
+    }
+
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&) {
+        n_packets_++;
+        return status::StatusOK;
+    }
+
+private:
+    size_t n_packets_;
+};
+
+audio::SampleSpec make_spec() {
+    audio::SampleSpec spec;
+    spec.set_sample_rate(SampleRate);
+    spec.set_sample_format(audio::SampleFormat_Pcm);
+    spec.set_pcm_format(audio::Sample_RawFormat);
+    spec.channel_set().set_layout(audio::ChanLayout_Surround);
+    spec.channel_set().set_order(audio::ChanOrder_Smpte);
+    spec.channel_set().set_mask(audio::ChanMask_Surround_Stereo);
+    return spec;
+}
+
+packet::FecScheme make_scheme(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return packet::FEC_ReedSolomon_M8;
+    case Scheme_LDPC:
+        return packet::FEC_LDPC_Staircase;
+    default:
+        break;
+    }
+    return packet::FEC_None;
+}
+
+address::Protocol make_source_proto(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return address::Proto_RTP_RS8M_Source;
+    case Scheme_LDPC:
+        return address::Proto_RTP_LDPC_Source;
+    default:
+        break;
+    }
+    return address::Proto_RTP;
+}
+
+address::Protocol make_repair_proto(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return address::Proto_RS8M_Repair;
+    case Scheme_LDPC:
+        return address::Proto_LDPC_Repair;
+    default:
+        break;
+    }
+    return address::Proto_None;
+}
+
+void BM_SenderSink_Throughput(benchmark::State& state) {
+    const Scheme scheme = (Scheme)state.range(0);
+    const size_t block_size = (size_t)state.range(1);
+    const bool interleaving = state.range(2) != 0;
+    const core::nanoseconds_t packet_length = state.range(3) * core::Millisecond;
+
+    if (scheme != Scheme_None
+        && !fec::CodecMap::instance().is_supported(make_scheme(scheme))) {
+        state.SkipWithError("fec scheme not supported");
+        return;
+    }
+
+    SenderSinkConfig config;
+    config.input_sample_spec = make_spec();
+    config.payload_type = rtp::PayloadType_L16_Stereo;
+    config.packet_length = packet_length;
+    config.fec_encoder.scheme = make_scheme(scheme);
+    if (scheme != Scheme_None) {
+        config.fec_writer.n_source_packets = block_size;
+        config.fec_writer.n_repair_packets = block_size / 2;
+    }
+    config.enable_interleaving = interleaving;
+    config.enable_timing = false;
+    config.latency.tuner_backend = audio::LatencyTunerBackend_Niq;
+    config.latency.tuner_profile = audio::LatencyTunerProfile_Intact;
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    if (!sender.is_valid()) {
+        state.SkipWithError("can't create sender");
+        return;
+    }
+
+    address::SocketAddr source_addr;
+    address::SocketAddr repair_addr;
+    if (!source_addr.set_host_port(address::Family_IPv4, "127.0.0.1", 10001)
+        || !repair_addr.set_host_port(address::Family_IPv4, "127.0.0.1", 10002)) {
+        state.SkipWithError("can't set address");
+        return;
+    }
+
+    NullWriter writer;
+
+    SenderSlotConfig slot_config;
+    SenderSlot* slot = sender.create_slot(slot_config);
+    if (!slot
+        || !slot->add_endpoint(address::Iface_AudioSource, make_source_proto(scheme),
+                               source_addr, writer)) {
+        state.SkipWithError("can't create slot");
+        return;
+    }
+    if (scheme != Scheme_None
+        && !slot->add_endpoint(address::Iface_AudioRepair, make_repair_proto(scheme),
+                               repair_addr, writer)) {
+        state.SkipWithError("can't create slot");
+        return;
+    }
+
+    audio::sample_t samples[FrameSamples * NumChans];
+    for (size_t ns = 0; ns < FrameSamples * NumChans; ns++) {
+        samples[ns] = (audio::sample_t)((ns % 200) / 100.0 - 0.5);
+    }
+
+    const core::nanoseconds_t frame_length =
+        config.input_sample_spec.samples_per_chan_2_ns(FrameSamples);
+
+    core::nanoseconds_t refresh_ts = core::Second;
+
+    while (state.KeepRunning()) {
+        audio::Frame frame(samples, FrameSamples * NumChans);
+        frame.set_duration(FrameSamples);
+
+        sender.write(frame);
+        sender.refresh(refresh_ts);
+
+        refresh_ts += frame_length;
+    }
+
+    state.counters["cpu_load"] =
+        benchmark::Counter(double(state.iterations()) * frame_length / core::Second,
+                           benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["packets/s"] =
+        benchmark::Counter(double(writer.num_packets()), benchmark::Counter::kIsRate);
+}
+
+void throughput_args(benchmark::internal::Benchmark* b) {
+    const int schemes[] = { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+    const int block_sizes[] = { 10, 20, 40 };
+    const int packet_lengths[] = { 5, 10, 20 };
+
+    std::vector<std::string> names;
+    names.push_back("fec");
+    names.push_back("block");
+    names.push_back("intrlv");
+    names.push_back("plen");
+    b->ArgNames(names);
+
+    for (size_t n_sch = 0; n_sch < ROC_ARRAY_SIZE(schemes); n_sch++) {
+        for (size_t n_bs = 0; n_bs < ROC_ARRAY_SIZE(block_sizes); n_bs++) {
+            if (schemes[n_sch] == Scheme_None && n_bs != 0) {
+                // block size is meaningless without FEC
+                continue;
+            }
+            for (int intrlv = 0; intrlv <= 1; intrlv++) {
+                for (size_t n_pl = 0; n_pl < ROC_ARRAY_SIZE(packet_lengths); n_pl++) {
+                    std::vector<int64_t> args;
+                    args.push_back(schemes[n_sch]);
+                    args.push_back(schemes[n_sch] == Scheme_None ? 0 : block_sizes[n_bs]);
+                    args.push_back(intrlv);
+                    args.push_back(packet_lengths[n_pl]);
+                    b->Args(args);
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_SenderSink_Throughput)
+    ->Apply(throughput_args)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
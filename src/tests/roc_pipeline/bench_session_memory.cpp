@@ -0,0 +1,689 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/panic.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/tagged_arena.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/receiver_source.h"
+#include "roc_pipeline/sender_sink.h"
+#include "roc_rtp/encoding_map.h"
+
+#include <string.h>
+
+// Measures memory footprint of one receiver or sender session.
+//
+// Pipeline is created with N sessions and runs until it reaches steady state,
+// i.e. receiver queues are filled up to target latency, FEC blocks are being
+// filled and RTCP reports are exchanged. Then memory is sampled and divided by
+// the number of sessions. Footprint of the pipeline itself (before the first
+// session was created) is subtracted.
+//
+// Pipeline arena is wrapped with TaggedArena, so that every allocation made by
+// pipeline is counted. Packets and buffers come from pools instead of arena;
+// they are counted as used pool slots multiplied by slot size.
+//
+// Receiver sessions account their memory per component (see MemoryTracker),
+// so receiver benchmark also reports breakdown by tag. Sender sessions don't
+// have per-component accounting, for them only totals are reported; cost of a
+// component can be seen by comparing runs with and without it.
+//
+// Parameters:
+//  - number of sessions
+//  - FEC scheme (none, Reed-Solomon, LDPC-Staircase)
+//  - resampler backend; when none, frame rate matches packet rate and resampler
+//    is not used at all
+//  - RTCP on/off
+//
+// Reported counters, in bytes per session:
+//  - total - arena memory plus packets
+//  - arena - arena memory currently allocated
+//  - arena_peak - maximum arena memory allocated at once
+//  - packets - memory of packets and buffers held by session, e.g. in receiver
+//    queues at target latency or in sender FEC block
+//  - session, queue, fec, resampler, rtcp - receiver arena memory by component;
+//    their sum is less than arena, because some per-session allocations happen
+//    outside of session (e.g. in router and mixer)
+//
+// Time is not meaningful and should be ignored.
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+enum {
+    MaxSessions = 16,
+    MaxBufSize = 2048,
+    MaxFrameSamples = 2048,
+
+    PacketRate = 44100,
+    ResampledRate = 48000,
+    NumChans = 2,
+
+    // Number of 10ms steps before and during measurement.
+    WarmupSteps = 300,
+    MeasureSteps = 100
+};
+
+enum Scheme { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+
+enum Backend { Backend_None, Backend_Builtin, Backend_Speex };
+
+const core::nanoseconds_t TargetLatency = 60 * core::Millisecond;
+const core::nanoseconds_t StepLength = 10 * core::Millisecond;
+
+core::HeapArena arena;
+
+// Pools used by pipeline under test.
+core::SlabPool<packet::Packet> packet_pool("packet_pool", arena);
+core::SlabPool<core::Buffer>
+    packet_buffer_pool("packet_buffer_pool", arena, sizeof(core::Buffer) + MaxBufSize);
+core::SlabPool<core::Buffer>
+    frame_buffer_pool("frame_buffer_pool",
+                      arena,
+                      sizeof(core::Buffer)
+                          + MaxFrameSamples * NumChans * sizeof(audio::sample_t));
+
+packet::PacketFactory packet_factory(packet_pool, packet_buffer_pool);
+
+// Pools used by peer pipeline, i.e. by sender when measuring receiver,
+// so that its packets are not counted.
+core::SlabPool<packet::Packet> peer_packet_pool("peer_packet_pool", arena);
+core::SlabPool<core::Buffer> peer_packet_buffer_pool("peer_packet_buffer_pool",
+                                                     arena,
+                                                     sizeof(core::Buffer) + MaxBufSize);
+core::SlabPool<core::Buffer>
+    peer_frame_buffer_pool("peer_frame_buffer_pool",
+                           arena,
+                           sizeof(core::Buffer)
+                               + MaxFrameSamples * NumChans * sizeof(audio::sample_t));
+
+rtp::EncodingMap encoding_map(arena);
+
+class NullWriter : public packet::IWriter {
+public:
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr&) {
+        return status::StatusOK;
+    }
+};
+
+audio::SampleSpec make_spec(size_t sample_rate) {
+    audio::SampleSpec spec;
+    spec.set_sample_rate(sample_rate);
+    spec.set_sample_format(audio::SampleFormat_Pcm);
+    spec.set_pcm_format(audio::Sample_RawFormat);
+    spec.channel_set().set_layout(audio::ChanLayout_Surround);
+    spec.channel_set().set_order(audio::ChanOrder_Smpte);
+    spec.channel_set().set_mask(audio::ChanMask_Surround_Stereo);
+    return spec;
+}
+
+packet::FecScheme make_scheme(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return packet::FEC_ReedSolomon_M8;
+    case Scheme_LDPC:
+        return packet::FEC_LDPC_Staircase;
+    default:
+        break;
+    }
+    return packet::FEC_None;
+}
+
+address::Protocol make_source_proto(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return address::Proto_RTP_RS8M_Source;
+    case Scheme_LDPC:
+        return address::Proto_RTP_LDPC_Source;
+    default:
+        break;
+    }
+    return address::Proto_RTP;
+}
+
+address::Protocol make_repair_proto(Scheme scheme) {
+    switch (scheme) {
+    case Scheme_RS8M:
+        return address::Proto_RS8M_Repair;
+    case Scheme_LDPC:
+        return address::Proto_LDPC_Repair;
+    default:
+        break;
+    }
+    return address::Proto_None;
+}
+
+bool is_backend_supported(Backend backend, audio::ResamplerBackend& backend_id) {
+    switch (backend) {
+    case Backend_None:
+        backend_id = audio::ResamplerBackend_Default;
+        return true;
+    case Backend_Builtin:
+        backend_id = audio::ResamplerBackend_Builtin;
+        break;
+    case Backend_Speex:
+        backend_id = audio::ResamplerBackend_Speex;
+        break;
+    }
+    return audio::ResamplerMap::instance().is_supported(backend_id);
+}
+
+const char* check_support(Scheme scheme, Backend backend) {
+    audio::ResamplerBackend backend_id = audio::ResamplerBackend_Default;
+    if (!is_backend_supported(backend, backend_id)) {
+        return "resampler backend not supported";
+    }
+    if (scheme != Scheme_None
+        && !fec::CodecMap::instance().is_supported(make_scheme(scheme))) {
+        return "fec scheme not supported";
+    }
+    return NULL;
+}
+
+size_t pool_bytes() {
+    return packet_pool.num_used_slots() * packet_pool.allocation_size()
+        + packet_buffer_pool.num_used_slots() * packet_buffer_pool.allocation_size();
+}
+
+void set_counter(benchmark::State& state, const char* name, double value) {
+    state.counters[name] =
+        benchmark::Counter(value, benchmark::Counter::kDefaults,
+                           benchmark::Counter::OneK::kIs1024);
+}
+
+SenderSinkConfig make_sender_config(Scheme scheme, size_t input_rate) {
+    SenderSinkConfig config;
+    config.input_sample_spec = make_spec(input_rate);
+    config.payload_type = rtp::PayloadType_L16_Stereo;
+    config.packet_length = StepLength;
+    config.fec_encoder.scheme = make_scheme(scheme);
+    config.enable_timing = false;
+    config.latency.tuner_backend = audio::LatencyTunerBackend_Niq;
+    config.latency.tuner_profile = audio::LatencyTunerProfile_Intact;
+    return config;
+}
+
+class Addresses {
+public:
+    const char* init() {
+        if (!source.set_host_port(address::Family_IPv4, "127.0.0.1", 10001)
+            || !repair.set_host_port(address::Family_IPv4, "127.0.0.1", 10002)
+            || !control.set_host_port(address::Family_IPv4, "127.0.0.1", 10003)) {
+            return "can't set address";
+        }
+        for (size_t n = 0; n < MaxSessions; n++) {
+            if (!peers[n].set_host_port(address::Family_IPv4, "127.0.0.2",
+                                        int(20000 + n))) {
+                return "can't set address";
+            }
+        }
+        return NULL;
+    }
+
+    address::SocketAddr source;
+    address::SocketAddr repair;
+    address::SocketAddr control;
+    address::SocketAddr peers[MaxSessions];
+};
+
+const char* add_sender_endpoints(SenderSlot& slot,
+                                 Scheme scheme,
+                                 bool rtcp,
+                                 const Addresses& addrs,
+                                 packet::IWriter& writer) {
+    if (!slot.add_endpoint(address::Iface_AudioSource, make_source_proto(scheme),
+                           addrs.source, writer)) {
+        return "can't create sender endpoint";
+    }
+    if (scheme != Scheme_None
+        && !slot.add_endpoint(address::Iface_AudioRepair, make_repair_proto(scheme),
+                              addrs.repair, writer)) {
+        return "can't create sender endpoint";
+    }
+    if (rtcp
+        && !slot.add_endpoint(address::Iface_AudioControl, address::Proto_RTCP,
+                              addrs.control, writer)) {
+        return "can't create sender endpoint";
+    }
+    return NULL;
+}
+
+class ReceiverBench {
+public:
+    ReceiverBench(size_t n_sessions,
+                  Scheme scheme,
+                  Backend backend,
+                  bool rtcp,
+                  core::IArena& tracked_arena,
+                  core::MemoryTracker& memory_tracker)
+        : n_sessions_(n_sessions)
+        , scheme_(scheme)
+        , backend_(backend)
+        , rtcp_(rtcp)
+        , tracked_arena_(tracked_arena)
+        , memory_tracker_(memory_tracker)
+        , source_writer_(NULL)
+        , repair_writer_(NULL)
+        , control_writer_(NULL)
+        , ts_(core::Second)
+        , frame_size_(0) {
+        roc_panic_if(n_sessions > MaxSessions);
+    }
+
+    const char* init() {
+        if (const char* error = check_support(scheme_, backend_)) {
+            return error;
+        }
+        if (const char* error = addrs_.init()) {
+            return error;
+        }
+
+        audio::ResamplerBackend backend_id = audio::ResamplerBackend_Default;
+        (void)is_backend_supported(backend_, backend_id);
+
+        ReceiverSourceConfig receiver_config;
+        receiver_config.common.output_sample_spec =
+            make_spec(backend_ == Backend_None ? PacketRate : ResampledRate);
+        receiver_config.common.enable_timing = false;
+        receiver_config.session_defaults.latency.tuner_backend =
+            audio::LatencyTunerBackend_Niq;
+        receiver_config.session_defaults.latency.tuner_profile =
+            audio::LatencyTunerProfile_Intact;
+        receiver_config.session_defaults.latency.target_latency = TargetLatency;
+        receiver_config.session_defaults.resampler.backend = backend_id;
+
+        out_spec_ = receiver_config.common.output_sample_spec;
+        frame_size_ = out_spec_.ns_2_samples_per_chan(StepLength);
+        roc_panic_if(frame_size_ > MaxFrameSamples);
+
+        sender_.reset(new (sender_) SenderSink(
+            make_sender_config(scheme_, PacketRate), encoding_map, peer_packet_pool,
+            peer_packet_buffer_pool, peer_frame_buffer_pool, arena));
+        if (!sender_ || !sender_->is_valid()) {
+            return "can't create sender";
+        }
+
+        for (size_t n = 0; n < n_sessions_; n++) {
+            SenderSlotConfig slot_config;
+            SenderSlot* slot = sender_->create_slot(slot_config);
+            if (!slot) {
+                return "can't create sender slot";
+            }
+            if (const char* error =
+                    add_sender_endpoints(*slot, scheme_, rtcp_, addrs_, queues_[n])) {
+                return error;
+            }
+        }
+
+        receiver_.reset(new (receiver_)
+                            ReceiverSource(receiver_config, encoding_map, packet_pool,
+                                           packet_buffer_pool, frame_buffer_pool,
+                                           tracked_arena_, &memory_tracker_));
+        if (!receiver_ || !receiver_->is_valid()) {
+            return "can't create receiver";
+        }
+
+        ReceiverSlotConfig slot_config;
+        ReceiverSlot* slot = receiver_->create_slot(slot_config);
+        if (!slot) {
+            return "can't create receiver slot";
+        }
+
+        ReceiverEndpoint* source_endpoint = slot->add_endpoint(
+            address::Iface_AudioSource, make_source_proto(scheme_), addrs_.source, NULL);
+        if (!source_endpoint) {
+            return "can't create receiver endpoint";
+        }
+        source_writer_ = &source_endpoint->inbound_writer();
+
+        if (scheme_ != Scheme_None) {
+            ReceiverEndpoint* repair_endpoint =
+                slot->add_endpoint(address::Iface_AudioRepair, make_repair_proto(scheme_),
+                                   addrs_.repair, NULL);
+            if (!repair_endpoint) {
+                return "can't create receiver endpoint";
+            }
+            repair_writer_ = &repair_endpoint->inbound_writer();
+        }
+
+        if (rtcp_) {
+            ReceiverEndpoint* control_endpoint =
+                slot->add_endpoint(address::Iface_AudioControl, address::Proto_RTCP,
+                                   addrs_.control, &feedback_writer_);
+            if (!control_endpoint) {
+                return "can't create receiver endpoint";
+            }
+            control_writer_ = &control_endpoint->inbound_writer();
+        }
+
+        for (size_t ns = 0; ns < MaxFrameSamples * NumChans; ns++) {
+            // non-silent signal, so that watchdog doesn't terminate sessions
+            send_samples_[ns] = (audio::sample_t)((ns % 200) / 100.0 - 0.5);
+        }
+
+        return NULL;
+    }
+
+    // Send audio ahead of receiver, so that queues reach target latency.
+    void prefill() {
+        for (core::nanoseconds_t pos = 0; pos < TargetLatency; pos += StepLength) {
+            send_();
+            ts_ += StepLength;
+        }
+    }
+
+    // Send one packet per session and read one frame.
+    void step() {
+        send_();
+
+        audio::Frame frame(recv_samples_, frame_size_ * NumChans);
+
+        receiver_->refresh(ts_ - TargetLatency);
+        if (!receiver_->read(frame)) {
+            roc_panic("bench: can't read frame");
+        }
+
+        ts_ += StepLength;
+    }
+
+    size_t num_sessions() const {
+        return receiver_->num_sessions();
+    }
+
+private:
+    void send_() {
+        const size_t n_samples = make_spec(PacketRate).ns_2_samples_per_chan(StepLength);
+
+        audio::Frame frame(send_samples_, n_samples * NumChans);
+        frame.set_duration(packet::stream_timestamp_t(n_samples));
+
+        sender_->write(frame);
+        sender_->refresh(ts_);
+
+        for (size_t n = 0; n < n_sessions_; n++) {
+            packet::PacketPtr pp;
+            while (queues_[n].read(pp) == status::StatusOK) {
+                if (pp->flags() & packet::Packet::FlagAudio) {
+                    write_packet_(*source_writer_, pp, addrs_.peers[n]);
+                } else if (pp->flags() & packet::Packet::FlagRepair) {
+                    write_packet_(*repair_writer_, pp, addrs_.peers[n]);
+                } else if (pp->flags() & packet::Packet::FlagControl) {
+                    write_packet_(*control_writer_, pp, addrs_.peers[n]);
+                }
+            }
+        }
+    }
+
+    // creates a new packet from receiver pool with a copy of the payload,
+    // without any meta-information, as if it was delivered over network
+    void write_packet_(packet::IWriter& writer,
+                       const packet::PacketPtr& pa,
+                       const address::SocketAddr& src_addr) {
+        const size_t size = pa->buffer().size();
+
+        packet::PacketPtr pb = packet_factory.new_packet();
+        core::BufferPtr bp = packet_factory.new_packet_buffer();
+        if (!pb || !bp || bp->size() < size) {
+            roc_panic("bench: can't allocate packet");
+        }
+
+        memcpy(bp->data(), pa->buffer().data(), size);
+
+        pb->add_flags(packet::Packet::FlagUDP);
+        pb->udp()->src_addr = src_addr;
+        pb->set_buffer(core::Slice<uint8_t>(*bp, 0, size));
+
+        if (writer.write(pb) != status::StatusOK) {
+            roc_panic("bench: can't write packet");
+        }
+    }
+
+    const size_t n_sessions_;
+    const Scheme scheme_;
+    const Backend backend_;
+    const bool rtcp_;
+
+    core::IArena& tracked_arena_;
+    core::MemoryTracker& memory_tracker_;
+
+    Addresses addrs_;
+    audio::SampleSpec out_spec_;
+
+    core::Optional<SenderSink> sender_;
+    core::Optional<ReceiverSource> receiver_;
+
+    packet::IWriter* source_writer_;
+    packet::IWriter* repair_writer_;
+    packet::IWriter* control_writer_;
+
+    packet::Queue queues_[MaxSessions];
+    NullWriter feedback_writer_;
+
+    core::nanoseconds_t ts_;
+    size_t frame_size_;
+
+    audio::sample_t send_samples_[MaxFrameSamples * NumChans];
+    audio::sample_t recv_samples_[MaxFrameSamples * NumChans];
+};
+
+void BM_SessionMemory_Receiver(benchmark::State& state) {
+    const size_t n_sessions = (size_t)state.range(0);
+    const Scheme scheme = (Scheme)state.range(1);
+    const Backend backend = (Backend)state.range(2);
+    const bool rtcp = state.range(3) != 0;
+
+    // counts all allocations made by receiver
+    core::MemoryTracker arena_tracker;
+    core::TaggedArena tracked_arena(arena, arena_tracker, core::MemoryTag_Session);
+
+    // counts allocations of receiver sessions per component
+    core::MemoryTracker session_tracker;
+
+    ReceiverBench bench(n_sessions, scheme, backend, rtcp, tracked_arena,
+                        session_tracker);
+
+    if (const char* error = bench.init()) {
+        state.SkipWithError(error);
+        return;
+    }
+
+    // pipeline footprint without sessions
+    const core::MemoryUsage base_arena = arena_tracker.usage();
+    const core::MemoryUsage base_session = session_tracker.usage();
+    const size_t base_pools = pool_bytes();
+
+    bench.prefill();
+
+    for (size_t n = 0; n < WarmupSteps; n++) {
+        bench.step();
+    }
+
+    if (bench.num_sessions() != n_sessions) {
+        state.SkipWithError("unexpected number of sessions");
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        bench.step();
+    }
+
+    const core::MemoryUsage arena_usage = arena_tracker.usage();
+    const core::MemoryUsage session_usage = session_tracker.usage();
+
+    const double arena_bytes = double(arena_usage.live_bytes[core::MemoryTag_Session])
+        - double(base_arena.live_bytes[core::MemoryTag_Session]);
+    const double arena_peak = double(arena_usage.peak_bytes[core::MemoryTag_Session])
+        - double(base_arena.live_bytes[core::MemoryTag_Session]);
+    const double packet_bytes = double(pool_bytes()) - double(base_pools);
+
+    set_counter(state, "total", (arena_bytes + packet_bytes) / n_sessions);
+    set_counter(state, "arena", arena_bytes / n_sessions);
+    set_counter(state, "arena_peak", arena_peak / n_sessions);
+    set_counter(state, "packets", packet_bytes / n_sessions);
+
+    for (size_t n_tag = 0; n_tag < core::MemoryTag_Max; n_tag++) {
+        set_counter(state, core::memory_tag_to_str((core::MemoryTag)n_tag),
+                    (double(session_usage.live_bytes[n_tag])
+                     - double(base_session.live_bytes[n_tag]))
+                        / n_sessions);
+    }
+}
+
+void BM_SessionMemory_Sender(benchmark::State& state) {
+    const size_t n_sessions = (size_t)state.range(0);
+    const Scheme scheme = (Scheme)state.range(1);
+    const Backend backend = (Backend)state.range(2);
+    const bool rtcp = state.range(3) != 0;
+
+    if (const char* error = check_support(scheme, backend)) {
+        state.SkipWithError(error);
+        return;
+    }
+
+    Addresses addrs;
+    if (const char* error = addrs.init()) {
+        state.SkipWithError(error);
+        return;
+    }
+
+    audio::ResamplerBackend backend_id = audio::ResamplerBackend_Default;
+    (void)is_backend_supported(backend, backend_id);
+
+    // when resampler is enabled, frames are resampled to packet rate
+    SenderSinkConfig config =
+        make_sender_config(scheme, backend == Backend_None ? PacketRate : ResampledRate);
+    config.resampler.backend = backend_id;
+
+    const size_t frame_size = config.input_sample_spec.ns_2_samples_per_chan(StepLength);
+    roc_panic_if(frame_size > MaxFrameSamples);
+
+    // counts all allocations made by sender
+    core::MemoryTracker arena_tracker;
+    core::TaggedArena tracked_arena(arena, arena_tracker, core::MemoryTag_Session);
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, tracked_arena);
+    if (!sender.is_valid()) {
+        state.SkipWithError("can't create sender");
+        return;
+    }
+
+    // pipeline footprint without sessions
+    const core::MemoryUsage base_arena = arena_tracker.usage();
+    const size_t base_pools = pool_bytes();
+
+    // produced packets are dropped; packets which remain allocated are those
+    // kept by sender itself, e.g. in FEC block or interleaver
+    NullWriter writer;
+
+    for (size_t n = 0; n < n_sessions; n++) {
+        SenderSlotConfig slot_config;
+        SenderSlot* slot = sender.create_slot(slot_config);
+        if (!slot) {
+            state.SkipWithError("can't create sender slot");
+            return;
+        }
+        if (const char* error =
+                add_sender_endpoints(*slot, scheme, rtcp, addrs, writer)) {
+            state.SkipWithError(error);
+            return;
+        }
+    }
+
+    audio::sample_t samples[MaxFrameSamples * NumChans];
+    for (size_t ns = 0; ns < MaxFrameSamples * NumChans; ns++) {
+        samples[ns] = (audio::sample_t)((ns % 200) / 100.0 - 0.5);
+    }
+
+    core::nanoseconds_t ts = core::Second;
+
+    for (size_t n = 0; n < WarmupSteps; n++) {
+        audio::Frame frame(samples, frame_size * NumChans);
+        frame.set_duration(packet::stream_timestamp_t(frame_size));
+
+        sender.write(frame);
+        sender.refresh(ts);
+
+        ts += StepLength;
+    }
+
+    while (state.KeepRunning()) {
+        audio::Frame frame(samples, frame_size * NumChans);
+        frame.set_duration(packet::stream_timestamp_t(frame_size));
+
+        sender.write(frame);
+        sender.refresh(ts);
+
+        ts += StepLength;
+    }
+
+    const core::MemoryUsage arena_usage = arena_tracker.usage();
+
+    const double arena_bytes = double(arena_usage.live_bytes[core::MemoryTag_Session])
+        - double(base_arena.live_bytes[core::MemoryTag_Session]);
+    const double arena_peak = double(arena_usage.peak_bytes[core::MemoryTag_Session])
+        - double(base_arena.live_bytes[core::MemoryTag_Session]);
+    const double packet_bytes = double(pool_bytes()) - double(base_pools);
+
+    set_counter(state, "total", (arena_bytes + packet_bytes) / n_sessions);
+    set_counter(state, "arena", arena_bytes / n_sessions);
+    set_counter(state, "arena_peak", arena_peak / n_sessions);
+    set_counter(state, "packets", packet_bytes / n_sessions);
+}
+
+void session_memory_args(benchmark::internal::Benchmark* b) {
+    const int sessions[] = { 1, 16 };
+    const int schemes[] = { Scheme_None, Scheme_RS8M, Scheme_LDPC };
+    const int backends[] = { Backend_None, Backend_Builtin, Backend_Speex };
+
+    std::vector<std::string> names;
+    names.push_back("sess");
+    names.push_back("fec");
+    names.push_back("rs");
+    names.push_back("rtcp");
+    b->ArgNames(names);
+
+    for (size_t n_sess = 0; n_sess < ROC_ARRAY_SIZE(sessions); n_sess++) {
+        for (size_t n_sch = 0; n_sch < ROC_ARRAY_SIZE(schemes); n_sch++) {
+            for (size_t n_bk = 0; n_bk < ROC_ARRAY_SIZE(backends); n_bk++) {
+                for (int rtcp = 0; rtcp <= 1; rtcp++) {
+                    std::vector<int64_t> args;
+                    args.push_back(sessions[n_sess]);
+                    args.push_back(schemes[n_sch]);
+                    args.push_back(backends[n_bk]);
+                    args.push_back(rtcp);
+                    b->Args(args);
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_SessionMemory_Receiver)
+    ->Apply(session_memory_args)
+    ->Iterations(MeasureSteps)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_SessionMemory_Sender)
+    ->Apply(session_memory_args)
+    ->Iterations(MeasureSteps)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_core/array.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/panic.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_pipeline/receiver_session_router.h"
+#include "roc_rtp/encoding_map.h"
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+enum { MaxBufSize = 1000, RunLength = 10 };
+
+core::HeapArena arena;
+
+packet::PacketFactory packet_factory(arena, MaxBufSize);
+audio::FrameFactory frame_factory(arena, MaxBufSize * sizeof(audio::sample_t));
+
+rtp::EncodingMap encoding_map(arena);
+
+core::MemoryTracker memory_tracker;
+
+struct RouterFixture {
+    ReceiverSessionRouter router;
+    core::Array<packet::stream_source_t> source_ids;
+    core::Array<address::SocketAddr> addresses;
+
+    explicit RouterFixture(size_t n_sessions)
+        : router(arena)
+        , source_ids(arena)
+        , addresses(arena) {
+        ReceiverSessionConfig session_config;
+        ReceiverCommonConfig common_config;
+
+        if (!source_ids.resize(n_sessions) || !addresses.resize(n_sessions)) {
+            roc_panic("bench: can't allocate arrays");
+        }
+
+        for (size_t n = 0; n < n_sessions; n++) {
+            core::SharedPtr<ReceiverSession> sess =
+                new (arena) ReceiverSession(session_config, common_config, encoding_map,
+                                            packet_factory, frame_factory, NULL, NULL,
+                                            memory_tracker, arena);
+
+            source_ids[n] = (packet::stream_source_t)(n * 7919 + 1);
+
+            if (!addresses[n].set_host_port(address::Family_IPv4, "127.0.0.1",
+                                            int(10000 + n))) {
+                roc_panic("bench: can't set address");
+            }
+
+            if (router.add_session(sess, source_ids[n], addresses[n])
+                != status::StatusOK) {
+                roc_panic("bench: can't add session");
+            }
+        }
+    }
+};
+
+// Packets arrive in runs from same sender.
+void BM_SessionRouter_FindBySource_Runs(benchmark::State& state) {
+    RouterFixture fixture((size_t)state.range(0));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const packet::stream_source_t source_id =
+            fixture.source_ids[(i++ / RunLength) % fixture.source_ids.size()];
+        benchmark::DoNotOptimize(fixture.router.find_by_source(source_id));
+    }
+}
+
+BENCHMARK(BM_SessionRouter_FindBySource_Runs)->Arg(1)->Arg(100)->Arg(1000);
+
+// Every packet is from different sender.
+void BM_SessionRouter_FindBySource_Interleaved(benchmark::State& state) {
+    RouterFixture fixture((size_t)state.range(0));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const packet::stream_source_t source_id =
+            fixture.source_ids[i++ % fixture.source_ids.size()];
+        benchmark::DoNotOptimize(fixture.router.find_by_source(source_id));
+    }
+}
+
+BENCHMARK(BM_SessionRouter_FindBySource_Interleaved)->Arg(1)->Arg(100)->Arg(1000);
+
+// Packets arrive in runs from same sender.
+void BM_SessionRouter_FindByAddress_Runs(benchmark::State& state) {
+    RouterFixture fixture((size_t)state.range(0));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const address::SocketAddr& addr =
+            fixture.addresses[(i++ / RunLength) % fixture.addresses.size()];
+        benchmark::DoNotOptimize(fixture.router.find_by_address(addr));
+    }
+}
+
+BENCHMARK(BM_SessionRouter_FindByAddress_Runs)->Arg(1)->Arg(100)->Arg(1000);
+
+// Every packet is from different sender.
+void BM_SessionRouter_FindByAddress_Interleaved(benchmark::State& state) {
+    RouterFixture fixture((size_t)state.range(0));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const address::SocketAddr& addr =
+            fixture.addresses[i++ % fixture.addresses.size()];
+        benchmark::DoNotOptimize(fixture.router.find_by_address(addr));
+    }
+}
+
+BENCHMARK(BM_SessionRouter_FindByAddress_Interleaved)->Arg(1)->Arg(100)->Arg(1000);
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
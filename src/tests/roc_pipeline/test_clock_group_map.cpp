@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_pipeline/clock_group_map.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+core::HeapArena arena;
+
+} // namespace
+
+TEST_GROUP(clock_group_map) {};
+
+TEST(clock_group_map, same_cname) {
+    ClockGroupMap map(arena);
+
+    core::SharedPtr<audio::ClockGroup> group1 = map.find_or_create("host1");
+    core::SharedPtr<audio::ClockGroup> group2 = map.find_or_create("host1");
+
+    CHECK(group1);
+    CHECK(group1 == group2);
+
+    LONGS_EQUAL(1, map.num_groups());
+}
+
+TEST(clock_group_map, different_cnames) {
+    ClockGroupMap map(arena);
+
+    core::SharedPtr<audio::ClockGroup> group1 = map.find_or_create("host1");
+    core::SharedPtr<audio::ClockGroup> group2 = map.find_or_create("host2");
+
+    CHECK(group1);
+    CHECK(group2);
+    CHECK(group1 != group2);
+
+    LONGS_EQUAL(2, map.num_groups());
+}
+
+TEST(clock_group_map, remove_unused) {
+    ClockGroupMap map(arena);
+
+    core::SharedPtr<audio::ClockGroup> group1 = map.find_or_create("host1");
+    core::SharedPtr<audio::ClockGroup> group2 = map.find_or_create("host2");
+
+    LONGS_EQUAL(2, map.num_groups());
+
+    map.remove_unused();
+    LONGS_EQUAL(2, map.num_groups());
+
+    group1 = NULL;
+
+    map.remove_unused();
+    LONGS_EQUAL(1, map.num_groups());
+
+    // Group is re-created after removal.
+    CHECK(map.find_or_create("host2") == group2);
+    CHECK(map.find_or_create("host1"));
+    LONGS_EQUAL(2, map.num_groups());
+
+    group2 = NULL;
+
+    map.remove_unused();
+    LONGS_EQUAL(0, map.num_groups());
+}
+
+} // namespace pipeline
+} // namespace roc
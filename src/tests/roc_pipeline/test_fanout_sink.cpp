@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/semaphore.h"
+#include "roc_core/slab_pool.h"
+#include "roc_pipeline/fanout_sink.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum {
+    MaxBufSize = 1000,
+
+    SampleRate = 44100,
+
+    SamplesPerFrame = 20,
+    ManyFrames = 30,
+
+    MaxRecorded = SamplesPerFrame * ManyFrames * 2
+};
+
+const core::nanoseconds_t FrameLength =
+    SamplesPerFrame * core::Second / SampleRate;
+
+core::HeapArena arena;
+
+core::SlabPool<core::Buffer> buffer_pool("frame_buffer_pool",
+                                         arena,
+                                         sizeof(core::Buffer)
+                                             + MaxBufSize * sizeof(audio::sample_t));
+
+audio::SampleSpec make_spec(audio::PcmFormat format, audio::ChannelMask chans) {
+    return audio::SampleSpec(SampleRate, format, audio::ChanLayout_Surround,
+                             audio::ChanOrder_Smpte, chans);
+}
+
+// Sink which records written samples.
+// If blocked, write() waits until unblock() is called.
+class RecordingSink : public sndio::ISink, public core::NonCopyable<> {
+public:
+    RecordingSink(const audio::SampleSpec& sample_spec)
+        : sample_spec_(sample_spec)
+        , n_samples_(0)
+        , blocked_(0) {
+    }
+
+    void block() {
+        blocked_ = 1;
+    }
+
+    void unblock() {
+        blocked_ = 0;
+        sem_.post();
+    }
+
+    size_t num_samples() const {
+        return n_samples_;
+    }
+
+    audio::sample_t sample(size_t n) const {
+        CHECK(n < n_samples_);
+        return samples_[n];
+    }
+
+    virtual sndio::ISink* to_sink() {
+        return this;
+    }
+
+    virtual sndio::ISource* to_source() {
+        return NULL;
+    }
+
+    virtual sndio::DeviceType type() const {
+        return sndio::DeviceType_Sink;
+    }
+
+    virtual sndio::DeviceState state() const {
+        return sndio::DeviceState_Active;
+    }
+
+    virtual void pause() {
+    }
+
+    virtual bool resume() {
+        return true;
+    }
+
+    virtual bool restart() {
+        return true;
+    }
+
+    virtual audio::SampleSpec sample_spec() const {
+        return sample_spec_;
+    }
+
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
+    virtual bool has_latency() const {
+        return false;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+
+    virtual void write(audio::Frame& frame) {
+        if (blocked_) {
+            sem_.wait();
+        }
+
+        for (size_t n = 0; n < frame.num_raw_samples(); n++) {
+            if (n_samples_ < MaxRecorded) {
+                samples_[n_samples_] = frame.raw_samples()[n];
+            }
+            n_samples_++;
+        }
+    }
+
+private:
+    const audio::SampleSpec sample_spec_;
+
+    audio::sample_t samples_[MaxRecorded];
+    size_t n_samples_;
+
+    core::Atomic<int> blocked_;
+    core::Semaphore sem_;
+};
+
+void write_frames(FanoutSink& fanout, size_t n_frames, size_t n_chans) {
+    audio::sample_t samples[SamplesPerFrame * 2];
+
+    for (size_t nf = 0; nf < n_frames; nf++) {
+        for (size_t n = 0; n < SamplesPerFrame * n_chans; n++) {
+            samples[n] = audio::sample_t(nf * SamplesPerFrame * n_chans + n) / 10000;
+        }
+
+        audio::Frame frame(samples, SamplesPerFrame * n_chans);
+        frame.set_duration(SamplesPerFrame);
+
+        fanout.write(frame);
+    }
+}
+
+void expect_same(const RecordingSink& expected, const RecordingSink& actual) {
+    UNSIGNED_LONGS_EQUAL(expected.num_samples(), actual.num_samples());
+
+    for (size_t n = 0; n < expected.num_samples(); n++) {
+        DOUBLES_EQUAL(expected.sample(n), actual.sample(n), 0);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(fanout_sink) {};
+
+TEST(fanout_sink, no_outputs) {
+    const audio::SampleSpec spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Stereo);
+
+    RecordingSink main_sink(spec);
+
+    FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+    CHECK(fanout.is_valid());
+
+    CHECK(fanout.sample_spec() == spec);
+    UNSIGNED_LONGS_EQUAL(0, fanout.num_outputs());
+
+    write_frames(fanout, ManyFrames, 2);
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame * 2, main_sink.num_samples());
+}
+
+TEST(fanout_sink, sync_outputs) {
+    const audio::SampleSpec spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Stereo);
+
+    RecordingSink main_sink(spec);
+    RecordingSink output_sink1(spec);
+    RecordingSink output_sink2(spec);
+
+    FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+    CHECK(fanout.is_valid());
+
+    FanoutOutputConfig config;
+    CHECK(fanout.add_output(output_sink1, config));
+    CHECK(fanout.add_output(output_sink2, config));
+
+    UNSIGNED_LONGS_EQUAL(2, fanout.num_outputs());
+
+    write_frames(fanout, ManyFrames, 2);
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame * 2, main_sink.num_samples());
+
+    expect_same(main_sink, output_sink1);
+    expect_same(main_sink, output_sink2);
+
+    CHECK(fanout.output_metrics(0).written_length > 0);
+    CHECK(fanout.output_metrics(0).dropped_length == 0);
+}
+
+TEST(fanout_sink, async_output) {
+    const audio::SampleSpec spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Stereo);
+
+    RecordingSink main_sink(spec);
+    RecordingSink output_sink(spec);
+
+    {
+        FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+        CHECK(fanout.is_valid());
+
+        FanoutOutputConfig config;
+        config.ring_length = FrameLength * ManyFrames;
+        CHECK(fanout.add_output(output_sink, config));
+
+        write_frames(fanout, ManyFrames, 2);
+
+        CHECK(fanout.output_metrics(0).dropped_length == 0);
+    }
+
+    // Remaining samples are written when fanout is destroyed.
+    expect_same(main_sink, output_sink);
+}
+
+TEST(fanout_sink, async_output_overflow) {
+    const audio::SampleSpec spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Stereo);
+
+    RecordingSink main_sink(spec);
+    RecordingSink output_sink(spec);
+
+    // Output is stuck in write().
+    output_sink.block();
+
+    {
+        FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+        CHECK(fanout.is_valid());
+
+        FanoutOutputConfig config;
+        config.ring_length = FrameLength * 4;
+        CHECK(fanout.add_output(output_sink, config));
+
+        // Main sink is not blocked by output.
+        write_frames(fanout, ManyFrames, 2);
+
+        UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame * 2, main_sink.num_samples());
+
+        CHECK(fanout.output_metrics(0).dropped_length > 0);
+
+        output_sink.unblock();
+    }
+
+    CHECK(output_sink.num_samples() > 0);
+    CHECK(output_sink.num_samples() < main_sink.num_samples());
+}
+
+TEST(fanout_sink, convert_output) {
+    const audio::SampleSpec main_spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Stereo);
+    const audio::SampleSpec output_spec =
+        make_spec(audio::Sample_RawFormat, audio::ChanMask_Surround_Mono);
+
+    RecordingSink main_sink(main_spec);
+    RecordingSink output_sink(output_spec);
+
+    FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+    CHECK(fanout.is_valid());
+
+    FanoutOutputConfig config;
+    CHECK(fanout.add_output(output_sink, config));
+
+    write_frames(fanout, ManyFrames, 2);
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame * 2, main_sink.num_samples());
+    UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame, output_sink.num_samples());
+}
+
+TEST(fanout_sink, non_raw_main_sink) {
+    RecordingSink main_sink(
+        make_spec(audio::PcmFormat_SInt16, audio::ChanMask_Surround_Stereo));
+
+    FanoutSink fanout(main_sink, FrameLength, buffer_pool, arena);
+    CHECK(!fanout.is_valid());
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/time.h"
+#include "roc_pipeline/fec_group_map.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { PacketSz = 512 };
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, PacketSz);
+
+FecGroupKey make_key(int port) {
+    FecGroupKey key;
+    CHECK(key.repair_address.set_host_port(address::Family_IPv4, "127.0.0.1", port));
+    key.fec_scheme = packet::FEC_ReedSolomon_M8;
+    key.payload_type = 10;
+    key.packet_length = 5 * core::Millisecond;
+    return key;
+}
+
+} // namespace
+
+TEST_GROUP(fec_group_map) {
+    fec::WriterConfig writer_config;
+    fec::CodecConfig codec_config;
+
+    void setup() {
+        codec_config.scheme = packet::FEC_ReedSolomon_M8;
+    }
+};
+
+TEST(fec_group_map, same_key) {
+    FecGroupMap map(packet_factory, arena);
+
+    core::SharedPtr<fec::GroupWriter> group1 =
+        map.find_or_create(make_key(1000), writer_config, codec_config);
+    core::SharedPtr<fec::GroupWriter> group2 =
+        map.find_or_create(make_key(1000), writer_config, codec_config);
+
+    CHECK(group1);
+    CHECK(group1 == group2);
+
+    LONGS_EQUAL(1, map.num_groups());
+}
+
+TEST(fec_group_map, different_keys) {
+    FecGroupMap map(packet_factory, arena);
+
+    core::SharedPtr<fec::GroupWriter> group1 =
+        map.find_or_create(make_key(1000), writer_config, codec_config);
+    core::SharedPtr<fec::GroupWriter> group2 =
+        map.find_or_create(make_key(2000), writer_config, codec_config);
+
+    FecGroupKey key3 = make_key(1000);
+    key3.packet_length = 10 * core::Millisecond;
+
+    core::SharedPtr<fec::GroupWriter> group3 =
+        map.find_or_create(key3, writer_config, codec_config);
+
+    CHECK(group1);
+    CHECK(group2);
+    CHECK(group3);
+    CHECK(group1 != group2);
+    CHECK(group1 != group3);
+    CHECK(group2 != group3);
+
+    LONGS_EQUAL(3, map.num_groups());
+}
+
+TEST(fec_group_map, remove_unused) {
+    FecGroupMap map(packet_factory, arena);
+
+    core::SharedPtr<fec::GroupWriter> group1 =
+        map.find_or_create(make_key(1000), writer_config, codec_config);
+    core::SharedPtr<fec::GroupWriter> group2 =
+        map.find_or_create(make_key(2000), writer_config, codec_config);
+
+    LONGS_EQUAL(2, map.num_groups());
+
+    group1 = NULL;
+
+    // Unused group is removed when next group is requested.
+    CHECK(map.find_or_create(make_key(2000), writer_config, codec_config) == group2);
+    LONGS_EQUAL(1, map.num_groups());
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -155,7 +155,9 @@ private:
         // payload encoder
         const rtp::Encoding* enc = encoding_map.find_by_pt(pt);
         CHECK(enc);
-        payload_encoder_.reset(enc->new_encoder(arena, enc->sample_spec), arena);
+        payload_encoder_.reset(
+            enc->new_encoder(arena, enc->sample_spec, audio::FrameEncoderConfig()),
+            arena);
         CHECK(payload_encoder_);
 
         if (fec_scheme == packet::FEC_None) {
@@ -267,7 +269,7 @@ private:
         packet::PacketPtr pp = packet_factory_.new_packet();
         CHECK(pp);
 
-        pp->add_flags(packet::Packet::FlagAudio);
+        pp->add_flags(packet::Packet::FlagAudio | packet::Packet::FlagPrepared);
 
         core::Slice<uint8_t> bp = packet_factory_.new_packet_buffer();
         CHECK(bp);
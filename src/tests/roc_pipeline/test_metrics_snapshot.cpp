@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_pipeline/metrics_snapshot.h"
+
+namespace roc {
+namespace pipeline {
+
+TEST_GROUP(metrics_snapshot) {};
+
+TEST(metrics_snapshot, empty) {
+    ReceiverMetricsSnapshot snapshot;
+
+    ReceiverSlotMetrics slot_metrics;
+    CHECK(!snapshot.load(slot_metrics, NULL, NULL));
+}
+
+TEST(metrics_snapshot, publish_load) {
+    ReceiverMetricsSnapshot snapshot;
+
+    for (size_t iter = 1; iter <= 5; iter++) {
+        ReceiverMetricsSnapshot::Data data;
+        data.slot.source_id = (packet::stream_source_t)iter;
+        data.slot.num_participants = 2;
+        data.party[0].link.total_packets = iter * 10;
+        data.party[1].link.total_packets = iter * 20;
+        data.party_count = 2;
+
+        snapshot.publish(data);
+
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[3];
+        size_t party_count = 3;
+
+        CHECK(snapshot.load(slot_metrics, party_metrics, &party_count));
+
+        UNSIGNED_LONGS_EQUAL(iter, slot_metrics.source_id);
+        UNSIGNED_LONGS_EQUAL(2, slot_metrics.num_participants);
+
+        UNSIGNED_LONGS_EQUAL(2, party_count);
+        UNSIGNED_LONGS_EQUAL(iter * 10, party_metrics[0].link.total_packets);
+        UNSIGNED_LONGS_EQUAL(iter * 20, party_metrics[1].link.total_packets);
+    }
+}
+
+TEST(metrics_snapshot, party_count) {
+    ReceiverMetricsSnapshot snapshot;
+
+    ReceiverMetricsSnapshot::Data data;
+    data.slot.num_participants = 3;
+    data.party_count = 3;
+    for (size_t n = 0; n < 3; n++) {
+        data.party[n].link.total_packets = n + 1;
+    }
+
+    snapshot.publish(data);
+
+    { // less than available
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[2];
+        size_t party_count = 2;
+
+        CHECK(snapshot.load(slot_metrics, party_metrics, &party_count));
+
+        UNSIGNED_LONGS_EQUAL(2, party_count);
+        UNSIGNED_LONGS_EQUAL(1, party_metrics[0].link.total_packets);
+        UNSIGNED_LONGS_EQUAL(2, party_metrics[1].link.total_packets);
+    }
+    { // no buffer
+        ReceiverSlotMetrics slot_metrics;
+        size_t party_count = 2;
+
+        CHECK(snapshot.load(slot_metrics, NULL, &party_count));
+
+        UNSIGNED_LONGS_EQUAL(0, party_count);
+        UNSIGNED_LONGS_EQUAL(3, slot_metrics.num_participants);
+    }
+}
+
+TEST(metrics_snapshot, truncated) {
+    ReceiverMetricsSnapshot snapshot;
+
+    // more participants than snapshot can hold
+    ReceiverMetricsSnapshot::Data data;
+    data.slot.num_participants = ReceiverMetricsSnapshot::MaxParticipants + 1;
+    data.party_count = ReceiverMetricsSnapshot::MaxParticipants;
+
+    snapshot.publish(data);
+
+    { // request fits into snapshot
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics
+            party_metrics[ReceiverMetricsSnapshot::MaxParticipants];
+        size_t party_count = ReceiverMetricsSnapshot::MaxParticipants;
+
+        CHECK(snapshot.load(slot_metrics, party_metrics, &party_count));
+
+        UNSIGNED_LONGS_EQUAL(ReceiverMetricsSnapshot::MaxParticipants, party_count);
+    }
+    { // request doesn't fit into snapshot
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics
+            party_metrics[ReceiverMetricsSnapshot::MaxParticipants + 1];
+        size_t party_count = ReceiverMetricsSnapshot::MaxParticipants + 1;
+
+        CHECK(!snapshot.load(slot_metrics, party_metrics, &party_count));
+
+        // output is untouched
+        UNSIGNED_LONGS_EQUAL(ReceiverMetricsSnapshot::MaxParticipants + 1, party_count);
+        UNSIGNED_LONGS_EQUAL(0, slot_metrics.num_participants);
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
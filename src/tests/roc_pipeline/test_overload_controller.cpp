@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_pipeline/overload_controller.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+const core::nanoseconds_t FrameDuration = 10 * core::Millisecond;
+const core::nanoseconds_t Window = 100 * core::Millisecond;
+
+const size_t FramesPerWindow = size_t(Window / FrameDuration);
+
+OverloadControllerConfig make_config() {
+    OverloadControllerConfig config;
+    config.window = Window;
+    config.high_load = 0.8f;
+    config.low_load = 0.5f;
+    config.step_up_windows = 3;
+    return config;
+}
+
+// Report one window of frames with given load.
+// Returns true if level was changed at the end of window.
+bool report_window(OverloadController& controller, double load) {
+    bool changed = false;
+    for (size_t n = 0; n < FramesPerWindow; n++) {
+        changed = controller.report_frame(
+            core::nanoseconds_t(FrameDuration * load), FrameDuration);
+        if (n + 1 < FramesPerWindow) {
+            CHECK(!changed);
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+TEST_GROUP(overload_controller) {};
+
+TEST(overload_controller, normal_load) {
+    OverloadController controller(make_config());
+
+    for (size_t n = 0; n < 10; n++) {
+        CHECK(!report_window(controller, 0.3));
+        LONGS_EQUAL(OverloadLevel_None, controller.level());
+        DOUBLES_EQUAL(0.3, controller.load(), 0.001);
+    }
+}
+
+TEST(overload_controller, step_down) {
+    OverloadController controller(make_config());
+
+    // One level per window.
+    CHECK(report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoConcealment, controller.level());
+
+    CHECK(report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoLateRepair, controller.level());
+
+    // Already at lowest level.
+    CHECK(!report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoLateRepair, controller.level());
+}
+
+TEST(overload_controller, step_up) {
+    OverloadController controller(make_config());
+
+    CHECK(report_window(controller, 0.95));
+    CHECK(report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoLateRepair, controller.level());
+
+    // Need step_up_windows low windows for every level.
+    for (size_t lev = 0; lev < 2; lev++) {
+        CHECK(!report_window(controller, 0.2));
+        CHECK(!report_window(controller, 0.2));
+        CHECK(report_window(controller, 0.2));
+    }
+    LONGS_EQUAL(OverloadLevel_None, controller.level());
+
+    // Already at highest level.
+    for (size_t n = 0; n < 5; n++) {
+        CHECK(!report_window(controller, 0.2));
+    }
+    LONGS_EQUAL(OverloadLevel_None, controller.level());
+}
+
+TEST(overload_controller, hysteresis) {
+    OverloadController controller(make_config());
+
+    CHECK(report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoConcealment, controller.level());
+
+    // Load between thresholds keeps level and restarts step up countdown.
+    for (size_t n = 0; n < 10; n++) {
+        CHECK(!report_window(controller, 0.2));
+        CHECK(!report_window(controller, 0.2));
+        CHECK(!report_window(controller, 0.6));
+    }
+    LONGS_EQUAL(OverloadLevel_NoConcealment, controller.level());
+
+    // Spike restarts countdown too.
+    CHECK(!report_window(controller, 0.2));
+    CHECK(!report_window(controller, 0.2));
+    CHECK(report_window(controller, 0.95));
+    LONGS_EQUAL(OverloadLevel_NoLateRepair, controller.level());
+}
+
+} // namespace pipeline
+} // namespace roc
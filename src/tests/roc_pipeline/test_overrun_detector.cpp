@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_pipeline/overrun_detector.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+const core::nanoseconds_t FrameDuration = 10 * core::Millisecond;
+const core::nanoseconds_t ReportInterval = 1 * core::Second;
+
+const core::nanoseconds_t StartTime = 1000 * core::Second;
+
+OverrunDetectorConfig make_config() {
+    OverrunDetectorConfig config;
+    config.threshold = 1.0f;
+    config.report_interval = ReportInterval;
+    return config;
+}
+
+// Process one frame without tasks, taking given time.
+// Returns true if overrun was detected.
+bool process_frame(OverrunDetector& detector,
+                   core::nanoseconds_t time,
+                   core::nanoseconds_t proc_time) {
+    detector.begin_frame(time, time, FrameDuration);
+    detector.report_subframe(proc_time);
+    return detector.end_frame(time + proc_time, NULL);
+}
+
+} // namespace
+
+TEST_GROUP(overrun_detector) {};
+
+TEST(overrun_detector, no_overrun) {
+    OverrunDetector detector(make_config());
+
+    core::nanoseconds_t time = StartTime;
+
+    for (size_t n = 0; n < 100; n++) {
+        CHECK(!process_frame(detector, time, FrameDuration / 2));
+        CHECK(!process_frame(detector, time, FrameDuration));
+        time += FrameDuration;
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, detector.num_overruns());
+}
+
+TEST(overrun_detector, overrun) {
+    OverrunDetector detector(make_config());
+
+    const core::nanoseconds_t call_time = StartTime;
+    const core::nanoseconds_t wait_time = 1 * core::Millisecond;
+    const core::nanoseconds_t subframe_time = 3 * core::Millisecond;
+    const core::nanoseconds_t task_time = 4 * core::Millisecond;
+
+    core::nanoseconds_t stage_times[audio::ProfilerStage_Max] = {};
+    stage_times[audio::ProfilerStage_Mixer] = 2 * core::Millisecond;
+
+    core::nanoseconds_t time = call_time + wait_time;
+
+    detector.begin_frame(call_time, time, FrameDuration);
+
+    detector.report_subframe(subframe_time);
+    time += subframe_time;
+
+    detector.report_task("task1", time, time + task_time);
+    time += task_time;
+
+    detector.report_subframe(subframe_time);
+    time += subframe_time;
+
+    CHECK(detector.end_frame(time, stage_times));
+
+    UNSIGNED_LONGS_EQUAL(1, detector.num_overruns());
+
+    const FrameOverrun& overrun = detector.last_overrun();
+
+    LONGLONGS_EQUAL(FrameDuration, overrun.frame_duration);
+    LONGLONGS_EQUAL(time - call_time, overrun.proc_time);
+    LONGLONGS_EQUAL(wait_time, overrun.wait_time);
+    POINTERS_EQUAL(NULL, overrun.blocking_task);
+    LONGLONGS_EQUAL(subframe_time * 2, overrun.frame_time);
+    LONGLONGS_EQUAL(task_time, overrun.task_time);
+
+    UNSIGNED_LONGS_EQUAL(1, overrun.num_tasks);
+    STRCMP_EQUAL("task1", overrun.task_names[0]);
+    LONGLONGS_EQUAL(task_time, overrun.task_times[0]);
+
+    CHECK(overrun.has_stages);
+    LONGLONGS_EQUAL(2 * core::Millisecond,
+                    overrun.stage_times[audio::ProfilerStage_Mixer]);
+    LONGLONGS_EQUAL(0, overrun.stage_times[audio::ProfilerStage_Session]);
+}
+
+TEST(overrun_detector, blocking_task) {
+    OverrunDetector detector(make_config());
+
+    const core::nanoseconds_t task_start = StartTime;
+    const core::nanoseconds_t call_time = task_start + 5 * core::Millisecond;
+    const core::nanoseconds_t task_end = call_time + 8 * core::Millisecond;
+
+    // task is processed outside of frame and frame waits for it
+    detector.report_task("blocker", task_start, task_end);
+
+    detector.begin_frame(call_time, task_end, FrameDuration);
+    detector.report_subframe(3 * core::Millisecond);
+    CHECK(detector.end_frame(task_end + 3 * core::Millisecond, NULL));
+
+    const FrameOverrun& overrun = detector.last_overrun();
+
+    LONGLONGS_EQUAL(11 * core::Millisecond, overrun.proc_time);
+    LONGLONGS_EQUAL(8 * core::Millisecond, overrun.wait_time);
+    STRCMP_EQUAL("blocker", overrun.blocking_task);
+    LONGLONGS_EQUAL(13 * core::Millisecond, overrun.blocking_task_time);
+    UNSIGNED_LONGS_EQUAL(0, overrun.num_tasks);
+    CHECK(!overrun.has_stages);
+}
+
+TEST(overrun_detector, finished_task_not_blocking) {
+    OverrunDetector detector(make_config());
+
+    // task finished before frame was requested
+    detector.report_task("task", StartTime, StartTime + core::Millisecond);
+
+    const core::nanoseconds_t call_time = StartTime + 2 * core::Millisecond;
+
+    detector.begin_frame(call_time, call_time, FrameDuration);
+    detector.report_subframe(FrameDuration * 2);
+    CHECK(detector.end_frame(call_time + FrameDuration * 2, NULL));
+
+    POINTERS_EQUAL(NULL, detector.last_overrun().blocking_task);
+    LONGLONGS_EQUAL(0, detector.last_overrun().wait_time);
+}
+
+TEST(overrun_detector, many_tasks) {
+    OverrunDetector detector(make_config());
+
+    const size_t num_tasks = FrameOverrun::MaxTasks + 5;
+    const core::nanoseconds_t task_time = core::Millisecond;
+
+    core::nanoseconds_t time = StartTime;
+
+    detector.begin_frame(time, time, FrameDuration);
+    for (size_t n = 0; n < num_tasks; n++) {
+        detector.report_task("task", time, time + task_time);
+        time += task_time;
+    }
+    CHECK(detector.end_frame(time, NULL));
+
+    const FrameOverrun& overrun = detector.last_overrun();
+
+    // all tasks are counted, but only first MaxTasks are recorded
+    UNSIGNED_LONGS_EQUAL(num_tasks, overrun.num_tasks);
+    LONGLONGS_EQUAL(task_time * (core::nanoseconds_t)num_tasks, overrun.task_time);
+    LONGLONGS_EQUAL(task_time, overrun.task_times[FrameOverrun::MaxTasks - 1]);
+}
+
+TEST(overrun_detector, threshold) {
+    OverrunDetectorConfig config = make_config();
+    config.threshold = 0.5f;
+
+    OverrunDetector detector(config);
+
+    CHECK(!process_frame(detector, StartTime, FrameDuration / 2));
+    CHECK(process_frame(detector, StartTime, FrameDuration / 2 + 1));
+
+    UNSIGNED_LONGS_EQUAL(1, detector.num_overruns());
+}
+
+TEST(overrun_detector, rate_limited_reports) {
+    OverrunDetector detector(make_config());
+
+    core::nanoseconds_t time = StartTime;
+
+    // reports are rate-limited, but every overrun is counted
+    for (size_t n = 0; n < 500; n++) {
+        CHECK(process_frame(detector, time, FrameDuration * 2));
+        time += FrameDuration * 2;
+
+        UNSIGNED_LONGS_EQUAL(n + 1, detector.num_overruns());
+    }
+}
+
+TEST(overrun_detector, disabled) {
+    OverrunDetectorConfig config = make_config();
+    config.enable = false;
+
+    OverrunDetector detector(config);
+
+    CHECK(!detector.is_enabled());
+}
+
+} // namespace pipeline
+} // namespace roc
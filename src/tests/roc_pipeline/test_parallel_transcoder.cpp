@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <math.h>
+
+#include "roc_audio/iframe_reader.h"
+#include "roc_audio/iframe_writer.h"
+#include "roc_core/array.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/slab_pool.h"
+#include "roc_pipeline/parallel_transcoder.h"
+#include "roc_pipeline/transcoder_sink.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { MaxBufSize = 10000 };
+
+const audio::ChannelMask Chans_Mono = audio::ChanMask_Surround_Mono;
+const audio::ChannelMask Chans_Stereo = audio::ChanMask_Surround_Stereo;
+
+core::HeapArena arena;
+
+core::SlabPool<core::Buffer> buffer_pool("frame_buffer_pool",
+                                         arena,
+                                         sizeof(core::Buffer)
+                                             + MaxBufSize * sizeof(audio::sample_t));
+
+// Produces given number of samples per channel of sine wave,
+// with different frequency on every channel, zero-padding last frame.
+class TestReader : public audio::IFrameReader {
+public:
+    TestReader(size_t sample_rate, size_t num_channels, size_t num_samples)
+        : sample_rate_(sample_rate)
+        , num_channels_(num_channels)
+        , num_samples_(num_samples)
+        , pos_(0) {
+    }
+
+    virtual bool read(audio::Frame& frame) {
+        if (pos_ >= num_samples_) {
+            return false;
+        }
+
+        for (size_t n = 0; n < frame.num_raw_samples(); n++) {
+            if (pos_ < num_samples_) {
+                const double freq = 500. * (n % num_channels_ + 1);
+                frame.raw_samples()[n] =
+                    (audio::sample_t)(0.5 * sin(2 * M_PI * freq * pos_ / sample_rate_));
+            } else {
+                frame.raw_samples()[n] = 0;
+            }
+            if ((n + 1) % num_channels_ == 0) {
+                pos_++;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    const size_t sample_rate_;
+    const size_t num_channels_;
+    const size_t num_samples_;
+    size_t pos_;
+};
+
+class TestWriter : public audio::IFrameWriter {
+public:
+    TestWriter()
+        : samples(arena) {
+    }
+
+    virtual void write(audio::Frame& frame) {
+        const size_t pos = samples.size();
+        CHECK(samples.grow_exp(pos + frame.num_raw_samples()));
+        CHECK(samples.resize(pos + frame.num_raw_samples()));
+        memcpy(samples.data() + pos, frame.raw_samples(),
+               frame.num_raw_samples() * sizeof(audio::sample_t));
+    }
+
+    core::Array<audio::sample_t> samples;
+};
+
+audio::SampleSpec make_spec(size_t sample_rate, audio::ChannelMask channels) {
+    audio::SampleSpec spec;
+    spec.set_sample_rate(sample_rate);
+    spec.set_sample_format(audio::SampleFormat_Pcm);
+    spec.set_pcm_format(audio::Sample_RawFormat);
+    spec.channel_set().set_layout(audio::ChanLayout_Surround);
+    spec.channel_set().set_order(audio::ChanOrder_Smpte);
+    spec.channel_set().set_mask(channels);
+    return spec;
+}
+
+// Transcode whole input sequentially, frame by frame.
+void transcode_sequential(const TranscoderConfig& config,
+                          size_t frame_size,
+                          size_t num_samples,
+                          TestWriter& writer) {
+    TranscoderSink transcoder(config, &writer, buffer_pool, arena);
+    CHECK(transcoder.is_valid());
+
+    const size_t num_ch = config.input_sample_spec.num_channels();
+    TestReader reader(config.input_sample_spec.sample_rate(), num_ch, num_samples);
+
+    core::Array<audio::sample_t> frame_data(arena);
+    CHECK(frame_data.resize(frame_size * num_ch));
+
+    for (;;) {
+        audio::Frame frame(frame_data.data(), frame_data.size());
+        if (!reader.read(frame)) {
+            break;
+        }
+        frame.set_duration((packet::stream_timestamp_t)frame_size);
+        transcoder.write(frame);
+    }
+}
+
+void compare(const TestWriter& expected, const TestWriter& actual, double epsilon) {
+    UNSIGNED_LONGS_EQUAL(expected.samples.size(), actual.samples.size());
+
+    for (size_t n = 0; n < expected.samples.size(); n++) {
+        DOUBLES_EQUAL(expected.samples[n], actual.samples[n], epsilon);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(parallel_transcoder) {
+    TranscoderConfig make_config(size_t in_rate, audio::ChannelMask in_chans,
+                                 size_t out_rate, audio::ChannelMask out_chans) {
+        TranscoderConfig config;
+        config.input_sample_spec = make_spec(in_rate, in_chans);
+        config.output_sample_spec = make_spec(out_rate, out_chans);
+        config.enable_profiling = false;
+        return config;
+    }
+
+    ParallelTranscoderConfig make_parallel_config(size_t num_jobs) {
+        ParallelTranscoderConfig config;
+        config.num_jobs = num_jobs;
+        config.segment_length = 50 * core::Millisecond;
+        config.overlap_length = 20 * core::Millisecond;
+        config.frame_length = 5 * core::Millisecond;
+        return config;
+    }
+};
+
+TEST(parallel_transcoder, no_resampling) {
+    const TranscoderConfig config = make_config(44100, Chans_Stereo, 44100, Chans_Mono);
+    const ParallelTranscoderConfig parallel_config = make_parallel_config(3);
+
+    // not multiple of frame, segment, or round
+    enum { NumSamples = 44100 + 123 };
+    const size_t frame_size =
+        config.input_sample_spec.ns_2_samples_per_chan(parallel_config.frame_length);
+
+    TestWriter expected;
+    transcode_sequential(config, frame_size, NumSamples, expected);
+
+    TestWriter actual;
+    TestReader reader(config.input_sample_spec.sample_rate(),
+                      config.input_sample_spec.num_channels(), NumSamples);
+
+    ParallelTranscoder transcoder(config, parallel_config, actual, arena);
+    CHECK(transcoder.is_valid());
+    CHECK(transcoder.run(reader));
+
+    compare(expected, actual, 0);
+
+    UNSIGNED_LONGS_EQUAL(
+        (NumSamples + frame_size - 1) / frame_size * frame_size,
+        transcoder.num_input_samples());
+}
+
+TEST(parallel_transcoder, resampling) {
+    const size_t rates[][2] = {
+        { 44100, 48000 },
+        { 48000, 44100 },
+        { 48000, 16000 },
+    };
+
+    for (size_t r = 0; r < ROC_ARRAY_SIZE(rates); r++) {
+        for (size_t num_jobs = 1; num_jobs <= 4; num_jobs++) {
+            const TranscoderConfig config =
+                make_config(rates[r][0], Chans_Stereo, rates[r][1], Chans_Stereo);
+            const ParallelTranscoderConfig parallel_config =
+                make_parallel_config(num_jobs);
+
+            const size_t num_samples = rates[r][0] + 321;
+            const size_t frame_size = config.input_sample_spec.ns_2_samples_per_chan(
+                parallel_config.frame_length);
+
+            TestWriter expected;
+            transcode_sequential(config, frame_size, num_samples, expected);
+
+            TestWriter actual;
+            TestReader reader(config.input_sample_spec.sample_rate(),
+                              config.input_sample_spec.num_channels(), num_samples);
+
+            ParallelTranscoder transcoder(config, parallel_config, actual, arena);
+            CHECK(transcoder.is_valid());
+            CHECK(transcoder.run(reader));
+
+            // every segment is resampled by a fresh resampler, which resets
+            // fixed-point position drift accumulated by sequential resampler,
+            // so results differ within fraction of sample phase
+            compare(expected, actual, 0.01);
+        }
+    }
+}
+
+TEST(parallel_transcoder, empty_input) {
+    const TranscoderConfig config = make_config(44100, Chans_Stereo, 48000, Chans_Stereo);
+
+    TestWriter writer;
+    TestReader reader(config.input_sample_spec.sample_rate(),
+                      config.input_sample_spec.num_channels(), 0);
+
+    ParallelTranscoder transcoder(config, make_parallel_config(2), writer, arena);
+    CHECK(transcoder.is_valid());
+    CHECK(transcoder.run(reader));
+
+    UNSIGNED_LONGS_EQUAL(0, writer.samples.size());
+    UNSIGNED_LONGS_EQUAL(0, transcoder.num_input_samples());
+}
+
+TEST(parallel_transcoder, invalid_config) {
+    const TranscoderConfig config = make_config(44100, Chans_Stereo, 48000, Chans_Stereo);
+
+    TestWriter writer;
+
+    ParallelTranscoder transcoder(config, make_parallel_config(0), writer, arena);
+    CHECK(!transcoder.is_valid());
+}
+
+} // namespace pipeline
+} // namespace roc
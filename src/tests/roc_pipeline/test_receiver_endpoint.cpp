@@ -12,6 +12,7 @@
 #include "roc_audio/mixer.h"
 #include "roc_audio/sample.h"
 #include "roc_core/heap_arena.h"
+#include "roc_core/memory_tracker.h"
 #include "roc_core/noop_arena.h"
 #include "roc_packet/queue.h"
 #include "roc_pipeline/config.h"
@@ -32,37 +33,57 @@ audio::FrameFactory frame_factory(arena, PacketSz * sizeof(audio::sample_t));
 
 rtp::EncodingMap encoding_map(arena);
 
+core::MemoryTracker memory_tracker;
+
 } // namespace
 
 TEST_GROUP(receiver_endpoint) {};
 
 TEST(receiver_endpoint, valid) {
-    audio::Mixer mixer(frame_factory, DefaultSampleSpec, false);
+    audio::Mixer mixer(frame_factory, DefaultSampleSpec, false, arena);
 
     StateTracker state_tracker;
     ReceiverSourceConfig source_config;
     ReceiverSlotConfig slot_config;
     ReceiverSessionGroup session_group(source_config, slot_config, state_tracker, mixer,
-                                       encoding_map, packet_factory, frame_factory,
-                                       arena);
+                                       NULL, NULL, encoding_map, packet_factory,
+                                       frame_factory, memory_tracker, arena);
 
-    ReceiverEndpoint endpoint(address::Proto_RTP, state_tracker, session_group,
-                              encoding_map, address::SocketAddr(), NULL, arena);
+    ReceiverEndpoint endpoint(address::Proto_RTP, rtp::SrtpConfig(), state_tracker,
+                              session_group, encoding_map, address::SocketAddr(), NULL,
+                              packet_factory, arena);
     CHECK(endpoint.is_valid());
 }
 
 TEST(receiver_endpoint, invalid_proto) {
-    audio::Mixer mixer(frame_factory, DefaultSampleSpec, false);
+    audio::Mixer mixer(frame_factory, DefaultSampleSpec, false, arena);
+
+    StateTracker state_tracker;
+    ReceiverSourceConfig source_config;
+    ReceiverSlotConfig slot_config;
+    ReceiverSessionGroup session_group(source_config, slot_config, state_tracker, mixer,
+                                       NULL, NULL, encoding_map, packet_factory,
+                                       frame_factory, memory_tracker, arena);
+
+    ReceiverEndpoint endpoint(address::Proto_None, rtp::SrtpConfig(), state_tracker,
+                              session_group, encoding_map, address::SocketAddr(), NULL,
+                              packet_factory, arena);
+    CHECK(!endpoint.is_valid());
+}
+
+TEST(receiver_endpoint, srtp_without_key) {
+    audio::Mixer mixer(frame_factory, DefaultSampleSpec, false, arena);
 
     StateTracker state_tracker;
     ReceiverSourceConfig source_config;
     ReceiverSlotConfig slot_config;
     ReceiverSessionGroup session_group(source_config, slot_config, state_tracker, mixer,
-                                       encoding_map, packet_factory, frame_factory,
-                                       arena);
+                                       NULL, NULL, encoding_map, packet_factory,
+                                       frame_factory, memory_tracker, arena);
 
-    ReceiverEndpoint endpoint(address::Proto_None, state_tracker, session_group,
-                              encoding_map, address::SocketAddr(), NULL, arena);
+    ReceiverEndpoint endpoint(address::Proto_SRTP, rtp::SrtpConfig(), state_tracker,
+                              session_group, encoding_map, address::SocketAddr(), NULL,
+                              packet_factory, arena);
     CHECK(!endpoint.is_valid());
 }
 
@@ -75,17 +96,19 @@ TEST(receiver_endpoint, no_memory) {
     };
 
     for (size_t n = 0; n < ROC_ARRAY_SIZE(protos); ++n) {
-        audio::Mixer mixer(frame_factory, DefaultSampleSpec, false);
+        audio::Mixer mixer(frame_factory, DefaultSampleSpec, false, arena);
 
         StateTracker state_tracker;
         ReceiverSourceConfig source_config;
         ReceiverSlotConfig slot_config;
         ReceiverSessionGroup session_group(source_config, slot_config, state_tracker,
-                                           mixer, encoding_map, packet_factory,
-                                           frame_factory, core::NoopArena);
+                                           mixer, NULL, NULL, encoding_map,
+                                           packet_factory, frame_factory, memory_tracker,
+                                           core::NoopArena);
 
-        ReceiverEndpoint endpoint(protos[n], state_tracker, session_group, encoding_map,
-                                  address::SocketAddr(), NULL, core::NoopArena);
+        ReceiverEndpoint endpoint(protos[n], rtp::SrtpConfig(), state_tracker,
+                                  session_group, encoding_map, address::SocketAddr(),
+                                  NULL, packet_factory, core::NoopArena);
 
         CHECK(!endpoint.is_valid());
     }
@@ -12,6 +12,8 @@
 
 #include "roc_core/heap_arena.h"
 #include "roc_core/slab_pool.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
 #include "roc_pipeline/receiver_loop.h"
 #include "roc_rtp/encoding_map.h"
@@ -106,6 +108,32 @@ private:
     core::Atomic<int> done_;
 };
 
+class DelayedWriter : public core::Thread {
+public:
+    DelayedWriter(packet::IWriter& writer, core::nanoseconds_t delay)
+        : writer_(writer)
+        , delay_(delay) {
+    }
+
+private:
+    virtual void run() {
+        core::sleep_for(core::ClockMonotonic, delay_);
+
+        core::BufferPtr buffer = packet_factory.new_packet_buffer();
+        roc_panic_if_not(buffer);
+
+        packet::PacketPtr pp = packet_factory.new_packet();
+        roc_panic_if_not(pp);
+
+        pp->set_buffer(core::Slice<uint8_t>(*buffer, 0, 16));
+
+        roc_panic_if_not(writer_.write(pp) == status::StatusOK);
+    }
+
+    packet::IWriter& writer_;
+    const core::nanoseconds_t delay_;
+};
+
 } // namespace
 
 TEST_GROUP(receiver_loop) {
@@ -167,5 +195,187 @@ TEST(receiver_loop, endpoints_async) {
     scheduler.wait_done();
 }
 
+TEST(receiver_loop, metrics_snapshot) {
+    ReceiverLoop receiver(scheduler, config, encoding_map, packet_pool,
+                          packet_buffer_pool, frame_buffer_pool, arena);
+
+    CHECK(receiver.is_valid());
+    ReceiverLoop::SlotHandle slot = NULL;
+
+    {
+        ReceiverSlotConfig config;
+        ReceiverLoop::Tasks::CreateSlot task(config);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+        CHECK(task.get_handle());
+
+        slot = task.get_handle();
+    }
+
+    ReceiverSlotMetrics task_metrics;
+
+    {
+        ReceiverLoop::Tasks::QuerySlot task(slot, task_metrics, NULL, NULL);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    {
+        // snapshot is published when slot is created
+        ReceiverSlotMetrics snapshot_metrics;
+        CHECK(receiver.load_slot_metrics(slot, snapshot_metrics, NULL, NULL));
+
+        CHECK_EQUAL(task_metrics.source_id, snapshot_metrics.source_id);
+        CHECK_EQUAL(0, snapshot_metrics.num_participants);
+    }
+
+    {
+        ReceiverParticipantMetrics party_metrics[4];
+        size_t party_count = 4;
+
+        ReceiverSlotMetrics snapshot_metrics;
+        CHECK(receiver.load_slot_metrics(slot, snapshot_metrics, party_metrics,
+                                         &party_count));
+
+        CHECK_EQUAL(0, party_count);
+    }
+
+    {
+        ReceiverLoop::Tasks::DeleteSlot task(slot);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+}
+
+TEST(receiver_loop, reconfigure_slot) {
+    ReceiverLoop receiver(scheduler, config, encoding_map, packet_pool,
+                          packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverLoop::SlotHandle slot = NULL;
+
+    {
+        ReceiverSlotConfig config;
+        ReceiverLoop::Tasks::CreateSlot task(config);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+
+        slot = task.get_handle();
+    }
+
+    {
+        ReceiverLiveConfig live_config;
+        live_config.target_latency = 100 * core::Millisecond;
+        live_config.change_resampler = true;
+        live_config.resampler_profile = audio::ResamplerProfile_High;
+
+        ReceiverLoop::Tasks::ReconfigureSlot task(slot, live_config);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    {
+        ReceiverLiveConfig live_config;
+        live_config.target_latency = -core::Millisecond;
+
+        ReceiverLoop::Tasks::ReconfigureSlot task(slot, live_config);
+        CHECK(!receiver.schedule_and_wait(task));
+        CHECK(!task.success());
+    }
+
+    {
+        ReceiverLoop::Tasks::DeleteSlot task(slot);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+}
+
+TEST(receiver_loop, idle_wait_timeout) {
+    const core::nanoseconds_t timeout = 50 * core::Millisecond;
+
+    config.common.enable_timing = true;
+    config.common.enable_idle_wait = true;
+    config.common.idle_wait_timeout = timeout;
+
+    ReceiverLoop receiver(scheduler, config, encoding_map, packet_pool,
+                          packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    core::Slice<audio::sample_t> samples = frame_factory.new_raw_buffer();
+    CHECK(samples);
+    samples.reslice(0, 100);
+
+    // no sessions and packets, read blocks until timeout
+    for (int n = 0; n < 3; n++) {
+        audio::Frame frame(samples.data(), samples.size());
+
+        const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+        CHECK(receiver.source().read(frame));
+        const core::nanoseconds_t elapsed = core::timestamp(core::ClockMonotonic) - start;
+
+        CHECK(elapsed >= timeout);
+        CHECK(receiver.source().state() == sndio::DeviceState_Idle);
+    }
+}
+
+TEST(receiver_loop, idle_wait_packet) {
+    const core::nanoseconds_t timeout = 10 * core::Second;
+    const core::nanoseconds_t delay = 20 * core::Millisecond;
+
+    config.common.enable_timing = true;
+    config.common.enable_idle_wait = true;
+    config.common.idle_wait_timeout = timeout;
+
+    ReceiverLoop receiver(scheduler, config, encoding_map, packet_pool,
+                          packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverLoop::SlotHandle slot = NULL;
+    packet::IWriter* writer = NULL;
+
+    {
+        ReceiverSlotConfig config;
+        ReceiverLoop::Tasks::CreateSlot task(config);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+        slot = task.get_handle();
+    }
+
+    {
+        ReceiverLoop::Tasks::AddEndpoint task(slot, address::Iface_AudioSource,
+                                              address::Proto_RTP, address::SocketAddr(),
+                                              NULL);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+        writer = task.get_inbound_writer();
+        CHECK(writer);
+    }
+
+    core::Slice<audio::sample_t> samples = frame_factory.new_raw_buffer();
+    CHECK(samples);
+    samples.reslice(0, 100);
+
+    // read blocks until packet arrives
+    DelayedWriter delayed_writer(*writer, delay);
+    CHECK(delayed_writer.start());
+
+    audio::Frame frame(samples.data(), samples.size());
+
+    const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+    CHECK(receiver.source().read(frame));
+    const core::nanoseconds_t elapsed = core::timestamp(core::ClockMonotonic) - start;
+
+    delayed_writer.join();
+
+    CHECK(elapsed >= delay);
+    CHECK(elapsed < timeout);
+
+    {
+        ReceiverLoop::Tasks::DeleteSlot task(slot);
+        CHECK(receiver.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -16,8 +16,13 @@
 #include "roc_address/interface.h"
 #include "roc_address/protocol.h"
 #include "roc_core/heap_arena.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/memory_tracker.h"
+#include "roc_core/optional.h"
 #include "roc_core/slab_pool.h"
 #include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/queue.h"
 #include "roc_pipeline/receiver_source.h"
 #include "roc_rtp/encoding_map.h"
 
@@ -263,6 +268,47 @@ TEST(receiver_source, one_session) {
     }
 }
 
+TEST(receiver_source, one_session_inline_reader) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSource receiver(make_default_config(), encoding_map, packet_pool,
+                            packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    ReceiverEndpoint* endpoint =
+        slot->add_endpoint(address::Iface_AudioSource, proto1, dst_addr1, NULL);
+    CHECK(endpoint);
+
+    // Packets are not written to endpoint, but polled by it from queue.
+    packet::Queue inline_queue;
+    endpoint->set_inbound_reader(inline_queue);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, inline_queue, encoding_map, packet_factory,
+                                     src_id1, src_addr1, dst_addr1, PayloadType_Ch2);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                packet_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            UNSIGNED_LONGS_EQUAL(0, inline_queue.size());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+    }
+}
+
 TEST(receiver_source, one_session_long_run) {
     enum { Rate = SampleRate, Chans = Chans_Stereo, NumIterations = 10 };
 
@@ -302,6 +348,49 @@ TEST(receiver_source, one_session_long_run) {
     }
 }
 
+// Check that with locked clocks, latency tuning is enabled but resampler is
+// bypassed, so samples are passed to output as is.
+TEST(receiver_source, locked_clocks) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.session_defaults.latency.tuner_profile = audio::LatencyTunerProfile_Responsive;
+    config.session_defaults.latency.locked_clocks = true;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                packet_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+    }
+}
+
 // Check how receiver accumulates packets in jitter buffer
 // before starting playback.
 TEST(receiver_source, initial_latency) {
@@ -349,6 +438,89 @@ TEST(receiver_source, initial_latency) {
     }
 }
 
+// New session after ended one starts with reduced prefill.
+TEST(receiver_source, warm_start) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, WarmLatency = Latency / 4 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.session_defaults.warm_start_timeout = core::Second * 100;
+    config.session_defaults.warm_start_latency = WarmLatency * core::Second / Rate;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    {
+        // First session starts after full latency.
+        test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                         packet_factory, src_id1, src_addr1, dst_addr1,
+                                         PayloadType_Ch2);
+
+        for (size_t np = 0; np < Latency / SamplesPerPacket - 1; np++) {
+            packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_zero_samples(SamplesPerFrame, output_sample_spec);
+            }
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+
+        for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+            }
+        }
+
+        while (receiver.num_sessions() != 0) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_zero_samples(SamplesPerFrame, output_sample_spec);
+        }
+    }
+
+    {
+        // Sender reconnects, second session starts after reduced latency.
+        test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                         packet_factory, src_id2, src_addr2, dst_addr1,
+                                         PayloadType_Ch2);
+
+        for (size_t np = 0; np < WarmLatency / SamplesPerPacket - 1; np++) {
+            packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_zero_samples(SamplesPerFrame, output_sample_spec);
+            }
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+
+        for (size_t np = 0; np < WarmLatency / SamplesPerPacket; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_nonzero_samples(SamplesPerFrame, output_sample_spec);
+            }
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+    }
+}
+
 // Timeout expires during initial latency accumulation.
 TEST(receiver_source, initial_latency_timeout) {
     enum { Rate = SampleRate, Chans = Chans_Stereo };
@@ -430,6 +602,61 @@ TEST(receiver_source, timeout) {
     }
 }
 
+// Checks that resources of ended session are kept until released explicitly,
+// or until next refresh.
+TEST(receiver_source, release_ended_sessions) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSource receiver(make_default_config(), encoding_map, packet_pool,
+                            packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    for (int n_sess = 0; n_sess < 2; n_sess++) {
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                    packet_sample_spec);
+
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        CHECK(!receiver.has_ended_sessions());
+
+        while (receiver.num_sessions() != 0) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+        }
+
+        // session is detached, but not released
+        CHECK(receiver.has_ended_sessions());
+
+        if (n_sess == 0) {
+            // release explicitly
+            receiver.release_ended_sessions();
+        } else {
+            // release on next refresh
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_zero_samples(SamplesPerFrame, output_sample_spec);
+        }
+
+        CHECK(!receiver.has_ended_sessions());
+    }
+}
+
 // Checks that receiver can work with latency longer than timeout.
 TEST(receiver_source, timeout_smaller_than_latency) {
     enum {
@@ -721,6 +948,165 @@ TEST(receiver_source, two_sessions_synchronous) {
     }
 }
 
+TEST(receiver_source, three_sessions_parallel) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.session_threads = 2;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer1(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr1, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer2(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id2, src_addr2, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer3(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, 333, test::new_address(13),
+                                      dst_addr1, PayloadType_Ch2);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer3.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 3, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(3, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer3.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+}
+
+// Sessions are read in parallel on worker threads, while their packets are in
+// non-atomic local mode, and some packets are restored by FEC. This is safe only
+// as long as every packet is touched by one session at a time. If ROC_DEBUG_CHECKS
+// is defined, reference counter panics when same local packet is touched by two
+// jobs of one worker pool run, so this test fails if a packet becomes shared
+// between sessions without switching it to shared mode.
+TEST(receiver_source, parallel_sessions_local_packets) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        NumSessions = 4,
+        NumThreads = NumSessions - 1,
+        SourcePackets = 4,
+        RepairPackets = 2,
+        // one loss per FEC block, not the first packet of session
+        LostIndex = 2,
+        LatencyPackets = Latency / SamplesPerPacket,
+        NumPackets = ManyPackets * 5
+    };
+
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.session_threads = NumThreads;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* source_endpoint_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource,
+                                  address::Proto_RTP_RS8M_Source, dst_addr1);
+    CHECK(source_endpoint_writer);
+
+    packet::IWriter* repair_endpoint_writer = create_transport_endpoint(
+        slot, address::Iface_AudioRepair, address::Proto_RS8M_Repair, dst_addr2);
+    CHECK(repair_endpoint_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    fec::WriterConfig fec_config;
+    fec_config.n_source_packets = SourcePackets;
+    fec_config.n_repair_packets = RepairPackets;
+
+    packet::Queue source_queue;
+    packet::Queue repair_queue;
+
+    core::Optional<test::PacketWriter> packet_writers[NumSessions];
+    for (size_t ns = 0; ns < NumSessions; ns++) {
+        packet_writers[ns].reset(new (packet_writers[ns]) test::PacketWriter(
+            arena, source_queue, repair_queue, encoding_map, packet_factory,
+            packet::stream_source_t(100 + ns), test::new_address(int(100 + ns)),
+            dst_addr1, dst_addr2, PayloadType_Ch2, packet::FEC_ReedSolomon_M8,
+            fec_config));
+    }
+
+    size_t n_source = 0;
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        if (np >= LatencyPackets) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_samples(SamplesPerFrame, NumSessions,
+                                          output_sample_spec);
+
+                UNSIGNED_LONGS_EQUAL(NumSessions, receiver.num_sessions());
+            }
+        }
+
+        for (size_t ns = 0; ns < NumSessions; ns++) {
+            packet_writers[ns]->write_packets(1, SamplesPerPacket, packet_sample_spec);
+        }
+
+        // Test doesn't keep references to packets, so that pipeline can
+        // switch them to local mode.
+        packet::PacketPtr pp;
+        while (source_queue.read(pp) == status::StatusOK) {
+            if (n_source / NumSessions % SourcePackets != LostIndex) {
+                LONGS_EQUAL(status::StatusOK, source_endpoint_writer->write(pp));
+            }
+            n_source++;
+        }
+        while (repair_queue.read(pp) == status::StatusOK) {
+            LONGS_EQUAL(status::StatusOK, repair_endpoint_writer->write(pp));
+        }
+        pp = NULL;
+    }
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[NumSessions];
+    size_t party_metrics_size = NumSessions;
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(NumSessions, party_metrics_size);
+    for (size_t ns = 0; ns < NumSessions; ns++) {
+        CHECK(party_metrics[ns].fec.restored_packets > 0);
+    }
+}
+
 TEST(receiver_source, two_sessions_overlapping) {
     enum { Rate = SampleRate, Chans = Chans_Stereo };
 
@@ -907,25 +1293,550 @@ TEST(receiver_source, two_sessions_same_address_different_streams) {
     packet_writer1.set_source(11);
     packet_writer2.set_source(22);
 
-    packet_writer2.set_offset(77);
-    packet_writer2.set_seqnum(5);
-    packet_writer2.set_timestamp(5 * SamplesPerPacket);
+    packet_writer2.set_offset(77);
+    packet_writer2.set_seqnum(5);
+    packet_writer2.set_timestamp(5 * SamplesPerPacket);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+}
+
+// Checks that sessions beyond max_sessions are not created, and that
+// preallocated session memory is reused after session is removed.
+TEST(receiver_source, max_sessions) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.max_sessions = 1;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer1(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr1, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer2(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id2, src_addr2, dst_addr1,
+                                      PayloadType_Ch2);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+
+    while (receiver.num_sessions() != 0) {
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+    }
+
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                 output_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_nonzero_samples(SamplesPerFrame, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+}
+
+// Checks that packets of a sender exceeding session packet rate are dropped,
+// while packets within the rate are not.
+TEST(receiver_source, session_packet_rate) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        MaxParties = 10,
+        RateLimit = 1000,
+        BurstPackets = 100,
+        FloodPackets = 300
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.max_session_packet_rate = RateLimit;
+    config.common.packet_rate_burst = BurstPackets * core::Second / RateLimit;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                output_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_nonzero_samples(SamplesPerFrame, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, output_sample_spec);
+    }
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_nonzero_samples(SamplesPerFrame, output_sample_spec);
+    }
+
+    // flood: only burst fits into the rate
+    packet_writer.write_packets(FloodPackets, SamplesPerPacket, output_sample_spec);
+    receiver.refresh(frame_reader.refresh_ts());
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    UNSIGNED_LONGS_EQUAL(FloodPackets - BurstPackets,
+                         party_metrics[0].rate_limited_packets);
+    UNSIGNED_LONGS_EQUAL(0, slot_metrics.rate_limited_packets);
+}
+
+// Checks that packets exceeding slot packet rate are dropped, including
+// packets that would create sessions.
+TEST(receiver_source, slot_packet_rate) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        MaxParties = 10,
+        RateLimit = 1000,
+        BurstPackets = 100,
+        FloodPackets = 300
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.max_slot_packet_rate = RateLimit;
+    config.common.packet_rate_burst = BurstPackets * core::Second / RateLimit;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    packet_writer.write_packets(FloodPackets, SamplesPerPacket, output_sample_spec);
+    receiver.refresh(frame_reader.refresh_ts());
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    UNSIGNED_LONGS_EQUAL(FloodPackets - BurstPackets, slot_metrics.rate_limited_packets);
+    UNSIGNED_LONGS_EQUAL(0, party_metrics[0].rate_limited_packets);
+}
+
+// Checks that packets beyond session queue limit are dropped.
+TEST(receiver_source, session_queue_limit) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        MaxParties = 10,
+        QueueLimit = 10,
+        FloodPackets = 50
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.max_session_queue_packets = QueueLimit;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    packet_writer.write_packets(FloodPackets, SamplesPerPacket, output_sample_spec);
+    receiver.refresh(frame_reader.refresh_ts());
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    UNSIGNED_LONGS_EQUAL(FloodPackets - QueueLimit,
+                         party_metrics[0].queue_overflow_packets);
+}
+
+// Packets of existing session are routed by network thread.
+TEST(receiver_source, early_routing) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, MaxParties = 10 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.enable_early_routing = true;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    // Session doesn't exist yet, these packets are routed by pipeline thread.
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                packet_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+    }
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(ManyPackets, slot_metrics.early_routed_packets);
+    UNSIGNED_LONGS_EQUAL(0, slot_metrics.early_dropped_packets);
+}
+
+// Checks that packets beyond per-session queue limit are dropped
+// by network thread when early routing is enabled.
+TEST(receiver_source, early_routing_queue_limit) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        MaxParties = 10,
+        QueueLimit = 10,
+        FloodPackets = 50
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.enable_early_routing = true;
+    config.common.max_session_queue_packets = QueueLimit;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    // Create session and let pipeline thread learn its route.
+    packet_writer.write_packets(2, SamplesPerPacket, output_sample_spec);
+    receiver.refresh(frame_reader.refresh_ts());
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    // Pipeline thread doesn't pull packets while sender floods.
+    packet_writer.write_packets(FloodPackets, SamplesPerPacket, output_sample_spec);
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(QueueLimit, slot_metrics.early_routed_packets);
+    UNSIGNED_LONGS_EQUAL(FloodPackets - QueueLimit, slot_metrics.early_dropped_packets);
+
+    receiver.refresh(frame_reader.refresh_ts());
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+}
+
+// Same stream is received over two paths, and every packet is lost on
+// one of them. Both paths are merged into one session without gaps.
+TEST(receiver_source, redundant_paths) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, MaxParties = 10 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.enable_redundancy = true;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    packet::IWriter* endpoint2_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr2);
+    CHECK(endpoint2_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer1(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr1, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer2(arena, *endpoint2_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr2, dst_addr2,
+                                      PayloadType_Ch2);
+
+    size_t num_packets = 0;
+    size_t num_duplicates = 0;
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+        num_packets++;
+        num_duplicates++;
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        switch (np % 3) {
+        case 0:
+            packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+            packet_writer2.shift_to(num_packets + 1, SamplesPerPacket);
+            break;
+        case 1:
+            packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+            packet_writer1.shift_to(num_packets + 1, SamplesPerPacket);
+            break;
+        default:
+            packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+            packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+            num_duplicates++;
+            break;
+        }
+        num_packets++;
+    }
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    slot->get_metrics(slot_metrics, party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    UNSIGNED_LONGS_EQUAL(num_duplicates, party_metrics[0].duplicate_packets);
+    LONGS_EQUAL(0, party_metrics[0].link.lost_packets);
+}
+
+// Checks that with control interval, packets are received on every refresh,
+// but metrics are published only when interval expires.
+TEST(receiver_source, control_interval) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        MaxParties = 10,
+        ControlFrames = FramesPerPacket * 2
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    const core::nanoseconds_t control_interval =
+        output_sample_spec.samples_per_chan_2_ns(SamplesPerFrame * ControlFrames);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.control_interval = control_interval;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer1(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr1, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer2(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id2, src_addr2, dst_addr1,
+                                      PayloadType_Ch2);
+
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                 output_sample_spec);
+
+    // first refresh performs control update
+    const core::nanoseconds_t start_ts = frame_reader.refresh_ts();
+    const core::nanoseconds_t deadline = receiver.refresh(start_ts);
+    frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+
+    CHECK(deadline > start_ts);
+    CHECK(deadline <= start_ts + control_interval);
+
+    {
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[MaxParties];
+        size_t party_metrics_size = MaxParties;
+
+        CHECK(slot->load_metrics(slot_metrics, party_metrics, &party_metrics_size));
+        UNSIGNED_LONGS_EQUAL(1, slot_metrics.num_participants);
+    }
+
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                 output_sample_spec);
+
+    // packets of second sender are received before control update,
+    // but snapshot is not updated yet
+    receiver.refresh(frame_reader.refresh_ts());
+    frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+    {
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[MaxParties];
+        size_t party_metrics_size = MaxParties;
+
+        CHECK(slot->load_metrics(slot_metrics, party_metrics, &party_metrics_size));
+        UNSIGNED_LONGS_EQUAL(1, slot_metrics.num_participants);
+    }
 
-    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
-        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
-        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+    while (frame_reader.refresh_ts() < deadline) {
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
     }
 
-    for (size_t np = 0; np < ManyPackets; np++) {
-        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
-            receiver.refresh(frame_reader.refresh_ts());
-            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+    receiver.refresh(frame_reader.refresh_ts());
+    frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
 
-            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
-        }
+    {
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[MaxParties];
+        size_t party_metrics_size = MaxParties;
 
-        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
-        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+        CHECK(slot->load_metrics(slot_metrics, party_metrics, &party_metrics_size));
+        UNSIGNED_LONGS_EQUAL(2, slot_metrics.num_participants);
     }
 }
 
@@ -1468,6 +2379,104 @@ TEST(receiver_source, timestamp_late) {
     frame_reader.read_samples(SamplesPerFrame, 0, output_sample_spec);
 }
 
+// Source packet arrives after its playback time, but before the loss
+// in the same FEC block is repaired. Late packet should not be dropped,
+// because it's needed to restore the lost one.
+TEST(receiver_source, fec_late_source_packet) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        SourcePackets = 10,
+        RepairPackets = 1,
+        NumPackets = SourcePackets * 3,
+        LatencyPackets = Latency / SamplesPerPacket,
+        // first packet of second block
+        LatePacket = SourcePackets,
+        // delivered right after late packet was played
+        LateDelivery = LatePacket + LatencyPackets + 1,
+        // can be restored only using late packet
+        LostPacket = SourcePackets + 2
+    };
+
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSource receiver(make_default_config(), encoding_map, packet_pool,
+                            packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* source_endpoint_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource,
+                                  address::Proto_RTP_RS8M_Source, dst_addr1);
+    CHECK(source_endpoint_writer);
+
+    packet::IWriter* repair_endpoint_writer = create_transport_endpoint(
+        slot, address::Iface_AudioRepair, address::Proto_RS8M_Repair, dst_addr2);
+    CHECK(repair_endpoint_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    fec::WriterConfig fec_config;
+    fec_config.n_source_packets = SourcePackets;
+    fec_config.n_repair_packets = RepairPackets;
+
+    packet::Queue source_queue;
+    packet::Queue repair_queue;
+
+    test::PacketWriter packet_writer(arena, source_queue, repair_queue, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     dst_addr2, PayloadType_Ch2,
+                                     packet::FEC_ReedSolomon_M8, fec_config);
+
+    packet::PacketPtr late_pp;
+    size_t n_source = 0;
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        if (np >= LatencyPackets) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                receiver.refresh(frame_reader.refresh_ts());
+                frame_reader.read_samples(SamplesPerFrame,
+                                          np - LatencyPackets == LatePacket ? 0 : 1,
+                                          output_sample_spec);
+            }
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+
+        packet::PacketPtr pp;
+        while (source_queue.read(pp) == status::StatusOK) {
+            if (n_source == LatePacket) {
+                late_pp = pp;
+            } else if (n_source != LostPacket) {
+                LONGS_EQUAL(status::StatusOK, source_endpoint_writer->write(pp));
+            }
+            n_source++;
+        }
+        while (repair_queue.read(pp) == status::StatusOK) {
+            LONGS_EQUAL(status::StatusOK, repair_endpoint_writer->write(pp));
+        }
+
+        if (np == LateDelivery) {
+            CHECK(late_pp);
+            LONGS_EQUAL(status::StatusOK, source_endpoint_writer->write(late_pp));
+        }
+    }
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics;
+    size_t party_metrics_size = 1;
+    slot->get_metrics(slot_metrics, &party_metrics, &party_metrics_size);
+
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    CHECK(party_metrics.fec.restored_packets > 0);
+}
+
 // Packets smaller than frame.
 TEST(receiver_source, packet_size_small) {
     enum {
@@ -1600,6 +2609,64 @@ TEST(receiver_source, packet_size_variable) {
     }
 }
 
+// Frames are read with different sizes, not multiples of packet size.
+// Receiver should produce exactly requested number of samples each time
+// and stream should remain continuous.
+TEST(receiver_source, frame_size_variable) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    const size_t frame_sizes[] = {
+        SamplesPerFrame / 2, SamplesPerFrame * 3, 1, 33, SamplesPerFrame, 7,
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSource receiver(make_default_config(), encoding_map, packet_pool,
+                            packet_buffer_pool, frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer1(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id1, src_addr1, dst_addr1,
+                                      PayloadType_Ch2);
+
+    test::PacketWriter packet_writer2(arena, *endpoint1_writer, encoding_map,
+                                      packet_factory, src_id2, src_addr2, dst_addr1,
+                                      PayloadType_Ch2);
+
+    size_t available = 0;
+    size_t nf = 0;
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        while (available >= Latency) {
+            const size_t frame_size = frame_sizes[nf % ROC_ARRAY_SIZE(frame_sizes)];
+
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(frame_size, 2, output_sample_spec);
+
+            UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+            available -= frame_size;
+            nf++;
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, output_sample_spec);
+        packet_writer2.write_packets(1, SamplesPerPacket, output_sample_spec);
+
+        available += SamplesPerPacket;
+    }
+
+    CHECK(nf > ManyPackets);
+}
+
 // Receiver should ignore corrupted packets and don't create session.
 TEST(receiver_source, corrupted_packets_new_session) {
     enum { Rate = SampleRate, Chans = Chans_Stereo };
@@ -2313,6 +3380,67 @@ TEST(receiver_source, metrics_truncation) {
     }
 }
 
+// Check per-stage profiling metrics.
+// Stages present in pipeline should report frames, other stages should be empty.
+TEST(receiver_source, metrics_stages) {
+    enum { Rate = SampleRate, OutputChans = Chans_Stereo, PacketChans = Chans_Mono };
+
+    init(Rate, OutputChans, Rate, PacketChans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.enable_stage_profiling = true;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+    CHECK(receiver.stage_profiler());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch1);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                packet_sample_spec);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts());
+            frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, packet_sample_spec);
+    }
+
+    ReceiverSlotMetrics slot_metrics;
+    slot->get_metrics(slot_metrics, NULL, NULL);
+
+    const audio::StageMetrics* stages = slot_metrics.stages.stages;
+
+    CHECK(stages[audio::ProfilerStage_Depacketizer].frames > 0);
+    CHECK(stages[audio::ProfilerStage_ChannelMapper].frames > 0);
+    CHECK(stages[audio::ProfilerStage_Session].frames > 0);
+    CHECK(stages[audio::ProfilerStage_Mixer].frames > 0);
+
+    UNSIGNED_LONGS_EQUAL(0, stages[audio::ProfilerStage_FecReader].frames);
+    UNSIGNED_LONGS_EQUAL(0, stages[audio::ProfilerStage_Resampler].frames);
+    UNSIGNED_LONGS_EQUAL(0, stages[audio::ProfilerStage_PcmMapper].frames);
+
+    for (size_t n = 0; n < audio::ProfilerStage_Max; n++) {
+        CHECK(stages[n].p50 <= stages[n].p99);
+        CHECK(stages[n].p99 <= stages[n].p999);
+        CHECK(stages[n].p999 <= stages[n].max);
+    }
+}
+
 // Check how receiver computes packet metrics:
 // total_packets, lost_packets, ext_first_seqnum, ext_last_seqnum
 IGNORE_TEST(receiver_source, metrics_packet_counters) {
@@ -2472,6 +3600,119 @@ TEST(receiver_source, metrics_e2e_latency) {
     }
 }
 
+// Check that in sync playback mode, playback that is ahead of target e2e
+// latency is delayed by inserting silence, and playback that is behind is
+// advanced by dropping frames.
+TEST(receiver_source, sync_playback) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        StepFrames = 3,
+        SyncFrames = FramesPerPacket * 3
+    };
+
+    const core::nanoseconds_t frame_duration =
+        core::nanoseconds_t(SamplesPerFrame) * core::Second / Rate;
+    const core::nanoseconds_t capture_ts_base = 1000000000000000;
+    const packet::stream_timestamp_t rtp_base = 1000000;
+
+    const core::nanoseconds_t early_by[] = { frame_duration * StepFrames,
+                                             -frame_duration * StepFrames };
+
+    for (size_t n_case = 0; n_case < ROC_ARRAY_SIZE(early_by); n_case++) {
+        init(Rate, Chans, Rate, Chans);
+
+        ReceiverSourceConfig config = make_default_config();
+        config.session_defaults.latency.tuner_backend = audio::LatencyTunerBackend_E2e;
+        config.session_defaults.latency.sync_playback = true;
+        config.session_defaults.latency.sync_tolerance = frame_duration;
+
+        const core::nanoseconds_t target = config.session_defaults.latency.target_latency;
+
+        ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                                frame_buffer_pool, arena);
+        CHECK(receiver.is_valid());
+
+        ReceiverSlot* slot = create_slot(receiver);
+        CHECK(slot);
+
+        packet::IWriter* transport_endpoint = create_transport_endpoint(
+            slot, address::Iface_AudioSource, proto1, dst_addr1);
+        CHECK(transport_endpoint);
+
+        packet::Queue control_outbound_queue;
+        packet::IWriter* control_endpoint = create_control_endpoint(
+            slot, address::Iface_AudioControl, address::Proto_RTCP, dst_addr2,
+            control_outbound_queue);
+        CHECK(control_endpoint);
+
+        test::FrameReader frame_reader(receiver, frame_factory);
+
+        test::PacketWriter packet_writer(arena, *transport_endpoint, encoding_map,
+                                         packet_factory, src_id1, src_addr1, dst_addr1,
+                                         PayloadType_Ch2);
+
+        test::ControlWriter control_writer(*control_endpoint, packet_factory,
+                                           src_addr1, dst_addr2);
+
+        control_writer.set_local_source(src_id1);
+
+        packet_writer.set_timestamp(rtp_base);
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                    output_sample_spec);
+
+        // First packet, before control packet, has no CTS.
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.refresh(frame_reader.refresh_ts(capture_ts_base));
+            frame_reader.read_nonzero_samples(SamplesPerFrame, output_sample_spec);
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, output_sample_spec);
+        control_writer.write_sender_report(packet::unix_2_ntp(capture_ts_base),
+                                           rtp_base);
+
+        // Playback is in sync.
+        for (size_t nf = 0; nf < SyncFrames; nf++) {
+            receiver.refresh(frame_reader.refresh_ts(capture_ts_base));
+            frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec,
+                                          capture_ts_base);
+            receiver.reclock(frame_reader.last_capture_ts() + target);
+
+            if ((nf + 1) % FramesPerPacket == 0) {
+                packet_writer.write_packets(1, SamplesPerPacket, output_sample_spec);
+            }
+        }
+
+        // Playback is off by StepFrames.
+        receiver.refresh(frame_reader.refresh_ts(capture_ts_base));
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec,
+                                      capture_ts_base);
+        receiver.reclock(frame_reader.last_capture_ts() + target - early_by[n_case]);
+
+        // When ahead, silence is inserted.
+        if (early_by[n_case] > 0) {
+            for (size_t nf = 0; nf < StepFrames; nf++) {
+                receiver.refresh(frame_reader.refresh_ts(capture_ts_base));
+                frame_reader.read_zero_samples(SamplesPerFrame, output_sample_spec);
+                receiver.reclock(frame_reader.last_capture_ts() + target);
+            }
+        }
+
+        // Stream is shifted by StepFrames relative to playback, and stays so.
+        for (size_t nf = 0; nf < SyncFrames; nf++) {
+            receiver.refresh(frame_reader.refresh_ts(capture_ts_base));
+            frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec,
+                                          capture_ts_base - early_by[n_case]);
+            receiver.reclock(frame_reader.last_capture_ts() + target);
+
+            if ((nf + 1) % FramesPerPacket == 0) {
+                packet_writer.write_packets(1, SamplesPerPacket, output_sample_spec);
+            }
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+    }
+}
+
 // Check that no reports are generated by receiver when there are no senders.
 TEST(receiver_source, reports_no_senders) {
     enum { Rate = SampleRate, Chans = Chans_Stereo };
@@ -2913,5 +4154,114 @@ TEST(receiver_source, pipeline_state) {
     }
 }
 
+TEST(receiver_source, overload_control) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, MaxParties = 10 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    ReceiverSourceConfig config = make_default_config();
+    config.common.enable_overload_control = true;
+    // any non-zero processing time is treated as overload
+    config.common.overload_control.window =
+        output_sample_spec.samples_per_chan_2_ns(SamplesPerFrame);
+    config.common.overload_control.high_load = 0;
+    config.common.overload_control.low_load = 0;
+
+    ReceiverSource receiver(config, encoding_map, packet_pool, packet_buffer_pool,
+                            frame_buffer_pool, arena);
+    CHECK(receiver.is_valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto1, dst_addr1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, frame_factory);
+
+    test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                     packet_factory, src_id1, src_addr1, dst_addr1,
+                                     PayloadType_Ch2);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                output_sample_spec);
+
+    for (size_t nf = 0; nf < OverloadLevel_Max; nf++) {
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+    }
+    receiver.refresh(frame_reader.refresh_ts());
+
+    ReceiverSlotMetrics slot_metrics;
+    ReceiverParticipantMetrics party_metrics[MaxParties];
+    size_t party_metrics_size = MaxParties;
+
+    CHECK(slot->load_metrics(slot_metrics, party_metrics, &party_metrics_size));
+    UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+    UNSIGNED_LONGS_EQUAL(OverloadLevel_Max - 1, party_metrics[0].overload_level);
+}
+
+TEST(receiver_source, memory_tracking) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, MaxParties = 10 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    core::MemoryTracker context_tracker;
+
+    {
+        ReceiverSource receiver(make_default_config(), encoding_map, packet_pool,
+                                packet_buffer_pool, frame_buffer_pool, arena,
+                                &context_tracker);
+        CHECK(receiver.is_valid());
+
+        ReceiverSlot* slot = create_slot(receiver);
+        CHECK(slot);
+
+        packet::IWriter* endpoint1_writer = create_transport_endpoint(
+            slot, address::Iface_AudioSource, proto1, dst_addr1);
+        CHECK(endpoint1_writer);
+
+        test::FrameReader frame_reader(receiver, frame_factory);
+
+        test::PacketWriter packet_writer(arena, *endpoint1_writer, encoding_map,
+                                         packet_factory, src_id1, src_addr1, dst_addr1,
+                                         PayloadType_Ch2);
+
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                    output_sample_spec);
+
+        receiver.refresh(frame_reader.refresh_ts());
+        frame_reader.read_any_samples(SamplesPerFrame, output_sample_spec);
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+        ReceiverSlotMetrics slot_metrics;
+        ReceiverParticipantMetrics party_metrics[MaxParties];
+        size_t party_metrics_size = MaxParties;
+
+        CHECK(slot->load_metrics(slot_metrics, party_metrics, &party_metrics_size));
+        UNSIGNED_LONGS_EQUAL(1, party_metrics_size);
+
+        const core::MemoryUsage& session_usage = party_metrics[0].memory;
+        CHECK(session_usage.live_bytes[core::MemoryTag_Session] > 0);
+        CHECK(session_usage.live_bytes[core::MemoryTag_Queue] > 0);
+        UNSIGNED_LONGS_EQUAL(0, session_usage.live_bytes[core::MemoryTag_Fec]);
+
+        // Session memory is included in context memory.
+        const core::MemoryUsage context_usage = context_tracker.usage();
+        for (size_t n = 0; n < core::MemoryTag_Max; n++) {
+            CHECK(context_usage.live_bytes[n] >= session_usage.live_bytes[n]);
+        }
+    }
+
+    // Everything released with pipeline.
+    const core::MemoryUsage context_usage = context_tracker.usage();
+    for (size_t n = 0; n < core::MemoryTag_Max; n++) {
+        UNSIGNED_LONGS_EQUAL(0, context_usage.live_bytes[n]);
+    }
+    CHECK(context_usage.peak_bytes[core::MemoryTag_Session] > 0);
+}
+
 } // namespace pipeline
 } // namespace roc
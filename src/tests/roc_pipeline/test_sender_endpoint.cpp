@@ -46,8 +46,8 @@ TEST(sender_endpoint, valid) {
     SenderSession session(sink_config, encoding_map, packet_factory, frame_factory,
                           arena);
 
-    SenderEndpoint endpoint(address::Proto_RTP, state_tracker, session, addr, queue,
-                            arena);
+    SenderEndpoint endpoint(address::Proto_RTP, rtp::SrtpConfig(), false, state_tracker,
+                            session, addr, queue, arena);
     CHECK(endpoint.is_valid());
 }
 
@@ -61,8 +61,22 @@ TEST(sender_endpoint, invalid_proto) {
     SenderSession session(sink_config, encoding_map, packet_factory, frame_factory,
                           arena);
 
-    SenderEndpoint endpoint(address::Proto_None, state_tracker, session, addr, queue,
-                            arena);
+    SenderEndpoint endpoint(address::Proto_None, rtp::SrtpConfig(), false, state_tracker,
+                            session, addr, queue, arena);
+    CHECK(!endpoint.is_valid());
+}
+
+TEST(sender_endpoint, srtp_without_key) {
+    address::SocketAddr addr;
+    packet::Queue queue;
+
+    SenderSinkConfig sink_config;
+    StateTracker state_tracker;
+    SenderSession session(sink_config, encoding_map, packet_factory, frame_factory,
+                          arena);
+
+    SenderEndpoint endpoint(address::Proto_SRTP, rtp::SrtpConfig(), false, state_tracker,
+                            session, addr, queue, arena);
     CHECK(!endpoint.is_valid());
 }
 
@@ -83,8 +97,8 @@ TEST(sender_endpoint, no_memory) {
         SenderSession session(sink_config, encoding_map, packet_factory, frame_factory,
                               arena);
 
-        SenderEndpoint endpoint(protos[n], state_tracker, session, addr, queue,
-                                core::NoopArena);
+        SenderEndpoint endpoint(protos[n], rtp::SrtpConfig(), false, state_tracker,
+                                session, addr, queue, core::NoopArena);
         CHECK(!endpoint.is_valid());
     }
 }
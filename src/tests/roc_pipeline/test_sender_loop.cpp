@@ -169,5 +169,118 @@ TEST(sender_loop, endpoints_async) {
     scheduler.wait_done();
 }
 
+TEST(sender_loop, metrics_snapshot) {
+    SenderLoop sender(scheduler, config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+
+    CHECK(sender.is_valid());
+
+    SenderLoop::SlotHandle slot = NULL;
+
+    {
+        SenderSlotConfig config;
+        SenderLoop::Tasks::CreateSlot task(config);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+        CHECK(task.get_handle());
+
+        slot = task.get_handle();
+    }
+
+    SenderSlotMetrics task_metrics;
+
+    {
+        SenderLoop::Tasks::QuerySlot task(slot, task_metrics, NULL, NULL);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    {
+        // snapshot is published when slot is created
+        SenderSlotMetrics snapshot_metrics;
+        CHECK(sender.load_slot_metrics(slot, snapshot_metrics, NULL, NULL));
+
+        CHECK_EQUAL(task_metrics.source_id, snapshot_metrics.source_id);
+        CHECK_EQUAL(0, snapshot_metrics.num_participants);
+    }
+
+    {
+        SenderParticipantMetrics party_metrics[4];
+        size_t party_count = 4;
+
+        SenderSlotMetrics snapshot_metrics;
+        CHECK(sender.load_slot_metrics(slot, snapshot_metrics, party_metrics,
+                                       &party_count));
+
+        CHECK_EQUAL(0, party_count);
+    }
+
+    {
+        SenderLoop::Tasks::DeleteSlot task(slot);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+}
+
+TEST(sender_loop, reconfigure_slot) {
+    SenderLoop sender(scheduler, config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    CHECK(sender.is_valid());
+
+    SenderLoop::SlotHandle slot = NULL;
+
+    address::SocketAddr outbound_address;
+    packet::Queue outbound_writer;
+
+    {
+        SenderSlotConfig config;
+        SenderLoop::Tasks::CreateSlot task(config);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+
+        slot = task.get_handle();
+    }
+
+    SenderLiveConfig live_config;
+    live_config.target_latency = 100 * core::Millisecond;
+
+    {
+        // No transport pipeline yet.
+        SenderLoop::Tasks::ReconfigureSlot task(slot, live_config);
+        CHECK(!sender.schedule_and_wait(task));
+        CHECK(!task.success());
+    }
+
+    {
+        SenderLoop::Tasks::AddEndpoint task(slot, address::Iface_AudioSource,
+                                            address::Proto_RTP, outbound_address,
+                                            outbound_writer);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    {
+        SenderLoop::Tasks::ReconfigureSlot task(slot, live_config);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    {
+        // FEC is not used.
+        live_config.fec_n_source_packets = 10;
+        live_config.fec_n_repair_packets = 5;
+
+        SenderLoop::Tasks::ReconfigureSlot task(slot, live_config);
+        CHECK(!sender.schedule_and_wait(task));
+        CHECK(!task.success());
+    }
+
+    {
+        SenderLoop::Tasks::DeleteSlot task(slot);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -392,6 +392,215 @@ TEST(sender_sink, sample_rate_mapping) {
     }
 }
 
+// Packet length selected from path MTU.
+TEST(sender_sink, mtu_autotune) {
+    enum {
+        Rate = SampleRate,
+        Chans = Chans_Stereo,
+        // IPv4 minimum MTU.
+        PathMtu = 576,
+        // Payload size left after IPv4, UDP, and RTP headers,
+        // divided by size of 16-bit stereo sample.
+        AutoSamplesPerPacket = (PathMtu - 20 - 8 - 12) / 4,
+        NumPackets = 10
+    };
+
+    init(Rate, Chans, Rate, Chans);
+
+    packet::Queue queue;
+
+    SenderSinkConfig config = make_config();
+    config.enable_mtu_autotune = true;
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    CHECK(sender.is_valid());
+
+    SenderSlot* slot = create_slot(sender);
+    CHECK(slot->add_endpoint(address::Iface_AudioSource, proto, dst_addr1, queue,
+                             PathMtu));
+
+    SenderSlotMetrics slot_metrics;
+    slot->get_metrics(slot_metrics, NULL, NULL);
+
+    UNSIGNED_LONGS_EQUAL(PathMtu, slot_metrics.path_mtu);
+    CHECK(packet_sample_spec.ns_2_stream_timestamp(slot_metrics.packet_length)
+          == AutoSamplesPerPacket);
+
+    test::FrameWriter frame_writer(sender, frame_factory);
+
+    for (size_t nf = 0; nf < NumPackets * AutoSamplesPerPacket / SamplesPerFrame;
+         nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+        sender.refresh(frame_writer.refresh_ts());
+    }
+
+    test::PacketReader packet_reader(arena, queue, encoding_map, packet_factory,
+                                     dst_addr1, PayloadType_Ch2);
+
+    for (size_t np = 0; np < NumPackets - 1; np++) {
+        packet_reader.read_packet(AutoSamplesPerPacket, packet_sample_spec);
+    }
+}
+
+// Two slots with same transport settings share encoded packets.
+TEST(sender_sink, shared_encoding) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    packet::Queue queue1;
+    packet::Queue queue2;
+
+    SenderSinkConfig config = make_config();
+    config.enable_shared_encoding = true;
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    CHECK(sender.is_valid());
+
+    SenderSlot* slot1 = create_slot(sender);
+    create_transport_endpoint(slot1, address::Iface_AudioSource, proto, dst_addr1,
+                              queue1);
+
+    SenderSlot* slot2 = create_slot(sender);
+    create_transport_endpoint(slot2, address::Iface_AudioSource, proto, dst_addr2,
+                              queue2);
+
+    test::FrameWriter frame_writer(sender, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+        sender.refresh(frame_writer.refresh_ts());
+    }
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, queue1.size());
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, queue2.size());
+
+    test::PacketReader packet_reader1(arena, queue1, encoding_map, packet_factory,
+                                      dst_addr1, PayloadType_Ch2);
+    test::PacketReader packet_reader2(arena, queue2, encoding_map, packet_factory,
+                                      dst_addr2, PayloadType_Ch2);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader1.read_packet(SamplesPerPacket, packet_sample_spec);
+        packet_reader2.read_packet(SamplesPerPacket, packet_sample_spec);
+    }
+
+    packet_reader1.read_eof();
+    packet_reader2.read_eof();
+
+    // Both slots report the same stream.
+    SenderSlotMetrics slot_metrics1;
+    SenderSlotMetrics slot_metrics2;
+    slot1->get_metrics(slot_metrics1, NULL, NULL);
+    slot2->get_metrics(slot_metrics2, NULL, NULL);
+
+    LONGS_EQUAL(slot_metrics1.source_id, slot_metrics2.source_id);
+
+    // After first slot is removed, second one starts its own encoding.
+    sender.delete_slot(slot1);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+        sender.refresh(frame_writer.refresh_ts());
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, queue1.size());
+    CHECK(queue2.size() >= ManyFrames / FramesPerPacket - 1);
+}
+
+TEST(sender_sink, redundant_paths) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    packet::Queue queue1;
+    packet::Queue queue2;
+
+    SenderSinkConfig config = make_config();
+    config.enable_redundancy = true;
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    CHECK(sender.is_valid());
+
+    // Two source endpoints in one slot.
+    SenderSlot* slot = create_slot(sender);
+    create_transport_endpoint(slot, address::Iface_AudioSource, proto, dst_addr1,
+                              queue1);
+    create_transport_endpoint(slot, address::Iface_AudioSource, proto, dst_addr2,
+                              queue2);
+
+    test::FrameWriter frame_writer(sender, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+        sender.refresh(frame_writer.refresh_ts());
+    }
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, queue1.size());
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, queue2.size());
+
+    test::PacketReader packet_reader1(arena, queue1, encoding_map, packet_factory,
+                                      dst_addr1, PayloadType_Ch2);
+    test::PacketReader packet_reader2(arena, queue2, encoding_map, packet_factory,
+                                      dst_addr2, PayloadType_Ch2);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader1.read_packet(SamplesPerPacket, packet_sample_spec);
+        packet_reader2.read_packet(SamplesPerPacket, packet_sample_spec);
+    }
+
+    packet_reader1.read_eof();
+    packet_reader2.read_eof();
+}
+
+TEST(sender_sink, three_slots_parallel) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo, NumSlots = 3 };
+
+    init(Rate, Chans, Rate, Chans);
+
+    packet::Queue queues[NumSlots];
+    address::SocketAddr dst_addrs[NumSlots];
+
+    SenderSinkConfig config = make_config();
+    config.session_threads = 2;
+
+    SenderSink sender(config, encoding_map, packet_pool, packet_buffer_pool,
+                      frame_buffer_pool, arena);
+    CHECK(sender.is_valid());
+
+    for (size_t ns = 0; ns < NumSlots; ns++) {
+        dst_addrs[ns] = test::new_address(int(31 + ns));
+
+        SenderSlot* slot = create_slot(sender);
+        CHECK(slot);
+        create_transport_endpoint(slot, address::Iface_AudioSource, proto,
+                                  dst_addrs[ns], queues[ns]);
+    }
+
+    test::FrameWriter frame_writer(sender, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+        sender.refresh(frame_writer.refresh_ts());
+    }
+
+    for (size_t ns = 0; ns < NumSlots; ns++) {
+        UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, queues[ns].size());
+
+        test::PacketReader packet_reader(arena, queues[ns], encoding_map,
+                                         packet_factory, dst_addrs[ns], PayloadType_Ch2);
+
+        for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+            packet_reader.read_packet(SamplesPerPacket, packet_sample_spec);
+        }
+
+        packet_reader.read_eof();
+    }
+}
+
 // Check how sender sets CTS of packets based on CTS of frames
 // written to it.
 TEST(sender_sink, timestamp_mapping) {
@@ -11,6 +11,7 @@
 #include "test_helpers/utils.h"
 
 #include "roc_core/heap_arena.h"
+#include "roc_core/memory_tracker.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/receiver_session_router.h"
 #include "roc_rtp/encoding_map.h"
@@ -29,6 +30,8 @@ audio::FrameFactory frame_factory(arena, MaxBufSize * sizeof(audio::sample_t));
 
 rtp::EncodingMap encoding_map(arena);
 
+core::MemoryTracker memory_tracker;
+
 } // namespace
 
 TEST_GROUP(session_router) {
@@ -62,10 +65,12 @@ TEST_GROUP(session_router) {
 
             sess1 =
                 new (arena) ReceiverSession(session_config, common_config, encoding_map,
-                                            packet_factory, frame_factory, arena);
+                                            packet_factory, frame_factory, NULL, NULL,
+                                            memory_tracker, arena);
             sess2 =
                 new (arena) ReceiverSession(session_config, common_config, encoding_map,
-                                            packet_factory, frame_factory, arena);
+                                            packet_factory, frame_factory, NULL, NULL,
+                                            memory_tracker, arena);
         }
     }
 };
@@ -816,5 +821,62 @@ TEST(session_router, conflict_address_exists) {
     CHECK(!router.find_by_address(addr2));
 }
 
+TEST(session_router, repeated_lookups) {
+    ReceiverSessionRouter router(arena);
+
+    LONGS_EQUAL(status::StatusOK, router.add_session(sess1, ssrc1, addr1));
+    LONGS_EQUAL(status::StatusOK, router.add_session(sess2, ssrc2, addr2));
+
+    for (size_t n = 0; n < 3; n++) {
+        CHECK(router.find_by_source(ssrc1) == sess1);
+        CHECK(router.find_by_source(ssrc1) == sess1);
+        CHECK(router.find_by_address(addr1) == sess1);
+        CHECK(router.find_by_address(addr1) == sess1);
+
+        CHECK(router.find_by_source(ssrc2) == sess2);
+        CHECK(router.find_by_source(ssrc2) == sess2);
+        CHECK(router.find_by_address(addr2) == sess2);
+        CHECK(router.find_by_address(addr2) == sess2);
+
+        CHECK(!router.find_by_source(ssrc3));
+    }
+
+    // Last lookups were for sess2, remove it.
+    router.remove_session(sess2);
+
+    CHECK(!router.find_by_source(ssrc2));
+    CHECK(!router.find_by_address(addr2));
+
+    CHECK(router.find_by_source(ssrc1) == sess1);
+    CHECK(router.find_by_address(addr1) == sess1);
+
+    // Last lookups were for sess1, unlink its source.
+    router.unlink_source(ssrc1);
+
+    CHECK(!router.find_by_source(ssrc1));
+    CHECK(!router.find_by_address(addr1));
+}
+
+TEST(session_router, repeated_lookups_relink) {
+    ReceiverSessionRouter router(arena);
+
+    LONGS_EQUAL(status::StatusOK, router.add_session(sess1, ssrc1, addr1));
+    LONGS_EQUAL(status::StatusOK, router.link_source(ssrc2, cname1));
+
+    CHECK(router.find_by_source(ssrc1) == sess1);
+    CHECK(!router.find_by_source(ssrc2));
+
+    LONGS_EQUAL(status::StatusOK, router.link_source(ssrc1, cname1));
+
+    CHECK(router.find_by_source(ssrc1) == sess1);
+    CHECK(router.find_by_source(ssrc2) == sess1);
+
+    // Move ssrc2 to another route.
+    LONGS_EQUAL(status::StatusOK, router.link_source(ssrc2, cname2));
+
+    CHECK(router.find_by_source(ssrc1) == sess1);
+    CHECK(!router.find_by_source(ssrc2));
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -198,5 +198,73 @@ TEST(transcoder_sink, channel_mapping_mono_to_stereo) {
     mock_sink.expect_samples(ManyFrames * SamplesPerFrame);
 }
 
+TEST(transcoder_sink, format_mapping) {
+    enum { Rate = SampleRate, Chans = Chans_Stereo };
+
+    init(Rate, Chans, Rate, Chans);
+
+    audio::SampleSpec encoded_sample_spec = output_sample_spec;
+    encoded_sample_spec.set_pcm_format(audio::PcmFormat_SInt16_Le);
+
+    test::MockSink mock_sink(output_sample_spec);
+
+    // s16 -> raw
+    TranscoderConfig decoder_config = make_config();
+    decoder_config.input_sample_spec = encoded_sample_spec;
+
+    TranscoderSink decoder(decoder_config, &mock_sink, buffer_pool, arena);
+    CHECK(decoder.is_valid());
+
+    // raw -> s16
+    TranscoderConfig encoder_config = make_config();
+    encoder_config.output_sample_spec = encoded_sample_spec;
+
+    TranscoderSink encoder(encoder_config, &decoder, buffer_pool, arena);
+    CHECK(encoder.is_valid());
+
+    test::FrameWriter frame_writer(encoder, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+    }
+
+    mock_sink.expect_frames(ManyFrames);
+    mock_sink.expect_samples(ManyFrames * SamplesPerFrame);
+}
+
+TEST(transcoder_sink, format_and_channel_mapping) {
+    enum { Rate = SampleRate, InputChans = Chans_Stereo, OutputChans = Chans_Mono };
+
+    init(Rate, InputChans, Rate, OutputChans);
+
+    audio::SampleSpec encoded_sample_spec = output_sample_spec;
+    encoded_sample_spec.set_pcm_format(audio::PcmFormat_SInt16_Le);
+
+    test::MockSink mock_sink(output_sample_spec);
+
+    // s16 mono -> raw mono
+    TranscoderConfig decoder_config = make_config();
+    decoder_config.input_sample_spec = encoded_sample_spec;
+
+    TranscoderSink decoder(decoder_config, &mock_sink, buffer_pool, arena);
+    CHECK(decoder.is_valid());
+
+    // raw stereo -> s16 mono
+    TranscoderConfig encoder_config = make_config();
+    encoder_config.output_sample_spec = encoded_sample_spec;
+
+    TranscoderSink encoder(encoder_config, &decoder, buffer_pool, arena);
+    CHECK(encoder.is_valid());
+
+    test::FrameWriter frame_writer(encoder, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame, input_sample_spec);
+    }
+
+    mock_sink.expect_frames(ManyFrames);
+    mock_sink.expect_samples(ManyFrames * SamplesPerFrame);
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -249,5 +249,73 @@ TEST(transcoder_source, channel_mapping_mono_to_stereo) {
     UNSIGNED_LONGS_EQUAL(mock_source.num_remaining(), 0);
 }
 
+TEST(transcoder_source, format_mapping) {
+    enum { Chans = Chans_Stereo };
+
+    init(Chans, Chans);
+
+    audio::SampleSpec encoded_sample_spec = output_sample_spec;
+    encoded_sample_spec.set_pcm_format(audio::PcmFormat_SInt16_Le);
+
+    test::MockSource mock_source;
+    mock_source.add(ManyFrames * SamplesPerFrame, input_sample_spec);
+
+    // raw -> s16
+    TranscoderConfig encoder_config = make_config();
+    encoder_config.output_sample_spec = encoded_sample_spec;
+
+    TranscoderSource encoder(encoder_config, mock_source, buffer_pool, arena);
+    CHECK(encoder.is_valid());
+
+    // s16 -> raw
+    TranscoderConfig decoder_config = make_config();
+    decoder_config.input_sample_spec = encoded_sample_spec;
+
+    TranscoderSource decoder(decoder_config, encoder, buffer_pool, arena);
+    CHECK(decoder.is_valid());
+
+    test::FrameReader frame_reader(decoder, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+    }
+
+    UNSIGNED_LONGS_EQUAL(mock_source.num_remaining(), 0);
+}
+
+TEST(transcoder_source, format_and_channel_mapping) {
+    enum { InputChans = Chans_Stereo, OutputChans = Chans_Mono };
+
+    init(InputChans, OutputChans);
+
+    audio::SampleSpec encoded_sample_spec = output_sample_spec;
+    encoded_sample_spec.set_pcm_format(audio::PcmFormat_SInt16_Le);
+
+    test::MockSource mock_source;
+    mock_source.add(ManyFrames * SamplesPerFrame, input_sample_spec);
+
+    // raw stereo -> s16 mono
+    TranscoderConfig encoder_config = make_config();
+    encoder_config.output_sample_spec = encoded_sample_spec;
+
+    TranscoderSource encoder(encoder_config, mock_source, buffer_pool, arena);
+    CHECK(encoder.is_valid());
+
+    // s16 mono -> raw mono
+    TranscoderConfig decoder_config = make_config();
+    decoder_config.input_sample_spec = encoded_sample_spec;
+
+    TranscoderSource decoder(decoder_config, encoder, buffer_pool, arena);
+    CHECK(decoder.is_valid());
+
+    test::FrameReader frame_reader(decoder, frame_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_reader.read_samples(SamplesPerFrame, 1, output_sample_spec);
+    }
+
+    UNSIGNED_LONGS_EQUAL(mock_source.num_remaining(), 0);
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -65,7 +65,8 @@ void validate_buffer(const core::Slice<uint8_t>& buff) {
 
         CHECK(header.type() == header::RTCP_SR || header.type() == header::RTCP_RR
               || header.type() == header::RTCP_XR || header.type() == header::RTCP_SDES
-              || header.type() == header::RTCP_BYE);
+              || header.type() == header::RTCP_BYE
+              || header.type() == header::RTCP_RTPFB);
 
         if (pkt_index == 0) {
             // First packet should be SR or RR.
@@ -749,6 +750,86 @@ TEST(builder_traverser, rr_sdes_bye) {
     CHECK_FALSE(it.error());
 }
 
+TEST(builder_traverser, rr_sdes_nack_padding) {
+    core::Slice<uint8_t> buff = new_buffer();
+
+    header::ReceiverReportPacket rr;
+    rr.set_ssrc(11);
+
+    SdesChunk sdes_chunk;
+    sdes_chunk.ssrc = 22;
+    SdesItem sdes_item_send;
+    sdes_item_send.type = header::SDES_CNAME;
+    sdes_item_send.text = "1234:cname1";
+
+    header::NackPacket nack;
+    nack.set_ssrc(33);
+    nack.set_media_ssrc(44);
+
+    header::NackBlock nack_block1;
+    nack_block1.set_pid(100);
+    nack_block1.set_blp(0x8001);
+    header::NackBlock nack_block2;
+    nack_block2.set_pid(65535);
+    nack_block2.set_blp(0);
+
+    // Synthesize part
+
+    Config config;
+    Builder builder(config, buff);
+
+    // Empty RR
+    builder.begin_rr(rr);
+    builder.end_rr();
+
+    // SDES
+    builder.begin_sdes();
+    builder.begin_sdes_chunk(sdes_chunk);
+    builder.add_sdes_item(sdes_item_send);
+    builder.end_sdes_chunk();
+    builder.end_sdes();
+
+    // NACK
+    builder.begin_nack(nack);
+    builder.add_nack_block(nack_block1);
+    builder.add_nack_block(nack_block2);
+    builder.end_nack();
+
+    builder.add_padding(8);
+
+    CHECK(builder.is_ok());
+
+    // Validation part
+
+    validate_buffer(buff);
+
+    // Parsing part
+
+    Traverser traverser(buff);
+    CHECK(traverser.parse());
+
+    Traverser::Iterator it = traverser.iter();
+    CHECK_EQUAL(Traverser::Iterator::RR, it.next());
+    CHECK_EQUAL(11, it.get_rr().ssrc());
+
+    CHECK_EQUAL(Traverser::Iterator::SDES, it.next());
+
+    CHECK_EQUAL(Traverser::Iterator::NACK, it.next());
+    const header::NackPacket& nack_recv = it.get_nack();
+    CHECK_EQUAL(header::RTPFB_NACK, nack_recv.header().counter());
+    CHECK(nack_recv.header().has_padding());
+    CHECK_EQUAL(33, nack_recv.ssrc());
+    CHECK_EQUAL(44, nack_recv.media_ssrc());
+    CHECK_EQUAL(2, nack_recv.num_blocks());
+    CHECK_EQUAL(100, nack_recv.get_block(0).pid());
+    CHECK_EQUAL(0x8001, nack_recv.get_block(0).blp());
+    CHECK_EQUAL(65535, nack_recv.get_block(1).pid());
+    CHECK_EQUAL(0, nack_recv.get_block(1).blp());
+
+    CHECK_EQUAL(Traverser::Iterator::END, it.next());
+    CHECK_FALSE(it.error());
+}
+
 TEST(builder_traverser, small_slice) {
     size_t buff_sz = 0;
 
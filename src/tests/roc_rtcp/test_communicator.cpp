@@ -86,6 +86,8 @@ struct MockParticipant : public IParticipant, public core::NonCopyable<> {
         cur_recv_notification_ = num_recv_notifications_ = 0;
         cur_halt_notification_ = num_halt_notifications_ = 0;
         memset(halt_notifications_, 0, sizeof(halt_notifications_));
+        cur_loss_notification_ = num_loss_notifications_ = 0;
+        memset(loss_notifications_, 0, sizeof(loss_notifications_));
         num_ssrc_change_notifications_ = 0;
     }
 
@@ -120,6 +122,7 @@ struct MockParticipant : public IParticipant, public core::NonCopyable<> {
         return (num_send_notifications_ - cur_send_notification_)
             + (num_recv_notifications_ - cur_recv_notification_)
             + (num_halt_notifications_ - cur_halt_notification_)
+            + (num_loss_notifications_ - cur_loss_notification_)
             + num_ssrc_change_notifications_;
     }
 
@@ -138,6 +141,11 @@ struct MockParticipant : public IParticipant, public core::NonCopyable<> {
         return halt_notifications_[cur_halt_notification_++ % MaxNotifications];
     }
 
+    packet::seqnum_t next_loss_notification() {
+        CHECK(cur_loss_notification_ < num_loss_notifications_);
+        return loss_notifications_[cur_loss_notification_++ % MaxNotifications];
+    }
+
     void next_ssrc_change_notification() {
         CHECK(num_ssrc_change_notifications_ > 0);
         num_ssrc_change_notifications_--;
@@ -184,6 +192,17 @@ struct MockParticipant : public IParticipant, public core::NonCopyable<> {
         return status_;
     }
 
+    virtual void notify_send_losses(packet::stream_source_t recv_source_id,
+                                    const packet::seqnum_t* seqnums,
+                                    size_t n_seqnums) {
+        CHECK(n_seqnums > 0);
+        for (size_t n = 0; n < n_seqnums; n++) {
+            CHECK(num_loss_notifications_ - cur_loss_notification_ < MaxNotifications);
+            loss_notifications_[num_loss_notifications_++ % MaxNotifications] =
+                seqnums[n];
+        }
+    }
+
     virtual size_t num_recv_streams() {
         size_t cnt = 0;
         for (size_t i = 0; i < MaxStreams; i++) {
@@ -259,6 +278,10 @@ private:
     size_t num_halt_notifications_;
     packet::stream_source_t halt_notifications_[MaxNotifications];
 
+    size_t cur_loss_notification_;
+    size_t num_loss_notifications_;
+    packet::seqnum_t loss_notifications_[MaxNotifications];
+
     size_t num_ssrc_change_notifications_;
 };
 
@@ -3715,6 +3738,72 @@ TEST(communicator, report_back_split_reports) {
     CHECK_EQUAL(0, local_queue.size());
 }
 
+// Report interval grows when number of session members exceeds the limit
+TEST(communicator, report_interval_scaling) {
+    enum { SendSsrc = 100, RecvSsrc = 200, NumReceivers = 7, MembersPerInterval = 4 };
+
+    const char* SendCname = "send_cname";
+
+    const core::nanoseconds_t ReportInterval = core::Millisecond * 100;
+
+    Config config;
+    config.report_interval = ReportInterval;
+    config.inactivity_timeout = core::Second * 999;
+    config.members_per_interval = MembersPerInterval;
+
+    packet::Queue send_queue;
+    MockParticipant send_part(SendCname, SendSsrc, Report_ToAddress);
+    Communicator send_comm(config, send_part, send_queue, composer, packet_factory,
+                           arena);
+    CHECK(send_comm.is_valid());
+
+    core::nanoseconds_t send_time = 10000000000000000;
+    core::nanoseconds_t recv_time = 30000000000000000;
+
+    // Sender is alone, interval is not scaled
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed));
+    LONGS_EQUAL(status::StatusOK, send_comm.generate_reports(send_time));
+    CHECK_EQUAL(send_time + ReportInterval, send_comm.generation_deadline(send_time));
+
+    advance_time(send_time, ReportInterval);
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed));
+
+    // Let sender discover receivers
+    for (size_t n_rep = 0; n_rep < NumReceivers; n_rep++) {
+        advance_time(recv_time);
+
+        packet::stream_source_t recv_ssrc = RecvSsrc + n_rep;
+        char recv_cname[64] = {};
+        snprintf(recv_cname, sizeof(recv_cname), "recv_cname%d", (int)recv_ssrc);
+
+        packet::Queue recv_queue;
+        MockParticipant recv_part(recv_cname, recv_ssrc, Report_ToAddress);
+        Communicator recv_comm(config, recv_part, recv_queue, composer, packet_factory,
+                               arena);
+        CHECK(recv_comm.is_valid());
+
+        recv_part.set_recv_report(
+            0, make_recv_report(recv_time, recv_cname, recv_ssrc, SendSsrc, Seed));
+        LONGS_EQUAL(status::StatusOK, recv_comm.generate_reports(recv_time));
+        CHECK_EQUAL(1, recv_queue.size());
+
+        LONGS_EQUAL(status::StatusOK,
+                    send_comm.process_packet(read_packet(recv_queue), send_time));
+
+        CHECK_EQUAL(1, send_part.pending_notifications());
+        send_part.next_recv_notification();
+    }
+
+    CHECK_EQUAL(NumReceivers, send_comm.total_streams());
+    CHECK_EQUAL(send_time, send_comm.generation_deadline(send_time));
+
+    // Session has 8 members now, interval is doubled
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed));
+    LONGS_EQUAL(status::StatusOK, send_comm.generate_reports(send_time));
+    CHECK_EQUAL(send_time + ReportInterval * (NumReceivers + 1) / MembersPerInterval,
+                send_comm.generation_deadline(send_time));
+}
+
 // Check how communicator computes RTT and clock offset
 TEST(communicator, rtt) {
     enum { SendSsrc = 11, RecvSsrc = 22, NumIters = 200 };
@@ -4570,6 +4659,114 @@ TEST(communicator, rtt_missing_xr) {
     }
 }
 
+TEST(communicator, nack) {
+    enum { SendSsrc = 11, RecvSsrc = 22, LastSeqnum = 1000 };
+
+    const char* SendCname = "send_cname";
+    const char* RecvCname = "recv_cname";
+
+    Config config;
+    config.enable_nack = true;
+
+    packet::Queue send_queue;
+    MockParticipant send_part(SendCname, SendSsrc, Report_ToAddress);
+    Communicator send_comm(config, send_part, send_queue, composer, packet_factory,
+                           arena);
+    CHECK(send_comm.is_valid());
+
+    packet::Queue recv_queue;
+    MockParticipant recv_part(RecvCname, RecvSsrc, Report_Back);
+    Communicator recv_comm(config, recv_part, recv_queue, composer, packet_factory,
+                           arena);
+    CHECK(recv_comm.is_valid());
+
+    core::nanoseconds_t send_time = 10000000000000000;
+    core::nanoseconds_t recv_time = 30000000000000000;
+
+    // Generate sender report
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed1));
+    LONGS_EQUAL(status::StatusOK, send_comm.generate_reports(send_time));
+    CHECK_EQUAL(1, send_queue.size());
+
+    // Deliver sender report to receiver
+    LONGS_EQUAL(status::StatusOK,
+                recv_comm.process_packet(read_packet(send_queue), recv_time));
+    CHECK_EQUAL(1, recv_part.pending_notifications());
+    expect_send_report(recv_part.next_send_notification(), send_time, SendCname, SendSsrc,
+                       Seed1);
+
+    advance_time(send_time);
+    advance_time(recv_time);
+
+    // Generate receiver report with losses
+    // Packets 960 and 997 don't fit into one NACK block, 999 fits with 997
+    RecvReport recv_report =
+        make_recv_report(recv_time, RecvCname, RecvSsrc, SendSsrc, 0);
+    recv_report.ext_last_seqnum = LastSeqnum;
+    recv_report.recent_losses = ((uint64_t)1 << 1) | ((uint64_t)1 << 3)
+        | ((uint64_t)1 << 40);
+    recv_part.set_recv_report(0, recv_report);
+    LONGS_EQUAL(status::StatusOK, recv_comm.generate_reports(recv_time));
+    CHECK_EQUAL(1, recv_queue.size());
+
+    packet::PacketPtr pp = read_packet(recv_queue);
+
+    {
+        size_t n_nacks = 0;
+
+        Traverser traverser(pp->rtcp()->payload);
+        CHECK(traverser.parse());
+
+        Traverser::Iterator iter = traverser.iter();
+        Traverser::Iterator::State state;
+
+        while ((state = iter.next()) != Traverser::Iterator::END) {
+            if (state != Traverser::Iterator::NACK) {
+                continue;
+            }
+            const header::NackPacket& nack = iter.get_nack();
+            CHECK_EQUAL(RecvSsrc, nack.ssrc());
+            CHECK_EQUAL(SendSsrc, nack.media_ssrc());
+            CHECK_EQUAL(2, nack.num_blocks());
+            CHECK_EQUAL(LastSeqnum - 40, nack.get_block(0).pid());
+            CHECK_EQUAL(0, nack.get_block(0).blp());
+            CHECK_EQUAL(LastSeqnum - 3, nack.get_block(1).pid());
+            CHECK_EQUAL(0x2, nack.get_block(1).blp());
+            n_nacks++;
+        }
+
+        CHECK_EQUAL(1, n_nacks);
+    }
+
+    // Deliver receiver report to sender
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed2));
+    LONGS_EQUAL(status::StatusOK, send_comm.process_packet(pp, send_time));
+
+    // Check notifications on sender
+    CHECK_EQUAL(4, send_part.pending_notifications());
+    send_part.next_recv_notification();
+    CHECK_EQUAL(LastSeqnum - 40, send_part.next_loss_notification());
+    CHECK_EQUAL(LastSeqnum - 3, send_part.next_loss_notification());
+    CHECK_EQUAL(LastSeqnum - 1, send_part.next_loss_notification());
+
+    advance_time(send_time);
+    advance_time(recv_time);
+
+    // Generate receiver report without losses, no NACK expected
+    recv_report.report_timestamp = recv_time;
+    recv_report.recent_losses = 0;
+    recv_part.set_recv_report(0, recv_report);
+    LONGS_EQUAL(status::StatusOK, recv_comm.generate_reports(recv_time));
+    CHECK_EQUAL(1, recv_queue.size());
+
+    send_part.set_send_report(make_send_report(send_time, SendCname, SendSsrc, Seed3));
+    LONGS_EQUAL(status::StatusOK,
+                send_comm.process_packet(read_packet(recv_queue), send_time));
+
+    CHECK_EQUAL(1, send_part.pending_notifications());
+    send_part.next_recv_notification();
+}
+
 TEST(communicator, generation_error) {
     enum { Ssrc = 11 };
 
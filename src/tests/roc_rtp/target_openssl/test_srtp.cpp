@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/encoding_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+#include "roc_rtp/srtp_composer.h"
+#include "roc_rtp/srtp_config.h"
+#include "roc_rtp/srtp_crypto.h"
+#include "roc_rtp/srtp_parser.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { PacketSz = 512, PayloadSz = 100, Src = 0x1234abcd };
+
+// Master key and salt from RFC 3711, appendix B.3.
+const char* KeyHex = "E1F97A0D3E018BE0D64FA32C06DE4139"
+                     "0EC675AD498AFEEBB6960B3AABE6";
+
+core::HeapArena arena;
+packet::PacketFactory packet_factory(arena, PacketSz);
+
+SrtpConfig make_config(SrtpSuite suite, const char* key_hex = KeyHex) {
+    SrtpConfig config;
+    config.suite = suite;
+
+    if (suite == Srtp_AEAD_AES_128_GCM) {
+        // 12-byte salt.
+        char gcm_key_hex[56 + 1] = {};
+        memcpy(gcm_key_hex, key_hex, 56);
+        CHECK(parse_srtp_key(gcm_key_hex, config));
+    } else {
+        CHECK(parse_srtp_key(key_hex, config));
+    }
+
+    return config;
+}
+
+uint8_t payload_byte(packet::seqnum_t sn, size_t n) {
+    return uint8_t(sn + n);
+}
+
+packet::PacketPtr compose_packet(packet::IComposer& composer, packet::seqnum_t sn) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+
+    CHECK(composer.prepare(*pp, buffer, PayloadSz));
+    pp->set_buffer(buffer);
+
+    pp->rtp()->source_id = Src;
+    pp->rtp()->seqnum = sn;
+    pp->rtp()->stream_timestamp = packet::stream_timestamp_t(sn * 10);
+    pp->rtp()->payload_type = PayloadType_L16_Stereo;
+
+    for (size_t n = 0; n < PayloadSz; n++) {
+        pp->rtp()->payload.data()[n] = payload_byte(sn, n);
+    }
+
+    CHECK(composer.compose(*pp));
+
+    return pp;
+}
+
+void check_bytes(const uint8_t* expected, const uint8_t* actual, size_t size) {
+    for (size_t n = 0; n < size; n++) {
+        UNSIGNED_LONGS_EQUAL(expected[n], actual[n]);
+    }
+}
+
+// Copy packet data into new buffer, as if it was received from network.
+core::Slice<uint8_t> copy_buffer(const core::Slice<uint8_t>& src) {
+    core::Slice<uint8_t> buffer = packet_factory.new_packet_buffer();
+    CHECK(buffer);
+
+    buffer.reslice(0, src.size());
+    memcpy(buffer.data(), src.data(), src.size());
+
+    return buffer;
+}
+
+bool parse_packet(packet::IParser& parser, const core::Slice<uint8_t>& buffer) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    pp->set_buffer(buffer);
+
+    if (!parser.parse(*pp, buffer)) {
+        return false;
+    }
+
+    CHECK(pp->rtp());
+    UNSIGNED_LONGS_EQUAL(Src, pp->rtp()->source_id);
+    UNSIGNED_LONGS_EQUAL(PayloadSz, pp->rtp()->payload.size());
+
+    for (size_t n = 0; n < PayloadSz; n++) {
+        UNSIGNED_LONGS_EQUAL(payload_byte(pp->rtp()->seqnum, n),
+                             pp->rtp()->payload.data()[n]);
+    }
+
+    return true;
+}
+
+void check_round_trip(SrtpSuite suite) {
+    EncodingMap encoding_map(arena);
+
+    Composer rtp_composer(NULL);
+    SrtpComposer srtp_composer(make_config(suite), rtp_composer);
+    CHECK(srtp_composer.is_valid());
+
+    Parser rtp_parser(encoding_map, NULL);
+    SrtpParser srtp_parser(make_config(suite), rtp_parser);
+    CHECK(srtp_parser.is_valid());
+
+    for (packet::seqnum_t sn = 100; sn < 120; sn++) {
+        packet::PacketPtr pp = compose_packet(srtp_composer, sn);
+
+        UNSIGNED_LONGS_EQUAL(sizeof(Header) + PayloadSz + srtp_tag_size(suite),
+                             pp->buffer().size());
+
+        // Payload is encrypted.
+        size_t n_equal = 0;
+        for (size_t n = 0; n < PayloadSz; n++) {
+            if (pp->buffer().data()[sizeof(Header) + n] == payload_byte(sn, n)) {
+                n_equal++;
+            }
+        }
+        CHECK(n_equal < PayloadSz / 10);
+
+        CHECK(parse_packet(srtp_parser, copy_buffer(pp->buffer())));
+    }
+}
+
+void check_tamper(SrtpSuite suite, size_t offset) {
+    EncodingMap encoding_map(arena);
+
+    Composer rtp_composer(NULL);
+    SrtpComposer srtp_composer(make_config(suite), rtp_composer);
+    CHECK(srtp_composer.is_valid());
+
+    Parser rtp_parser(encoding_map, NULL);
+    SrtpParser srtp_parser(make_config(suite), rtp_parser);
+    CHECK(srtp_parser.is_valid());
+
+    packet::PacketPtr pp = compose_packet(srtp_composer, 1);
+
+    core::Slice<uint8_t> buffer = copy_buffer(pp->buffer());
+    buffer.data()[offset] ^= 0x01;
+
+    CHECK(!parse_packet(srtp_parser, buffer));
+
+    // Intact packet is still accepted.
+    CHECK(parse_packet(srtp_parser, copy_buffer(pp->buffer())));
+}
+
+void check_replay(SrtpSuite suite) {
+    EncodingMap encoding_map(arena);
+
+    Composer rtp_composer(NULL);
+    SrtpComposer srtp_composer(make_config(suite), rtp_composer);
+    CHECK(srtp_composer.is_valid());
+
+    Parser rtp_parser(encoding_map, NULL);
+    SrtpParser srtp_parser(make_config(suite), rtp_parser);
+    CHECK(srtp_parser.is_valid());
+
+    packet::PacketPtr pp1 = compose_packet(srtp_composer, 1);
+    packet::PacketPtr pp2 = compose_packet(srtp_composer, 2);
+    packet::PacketPtr pp3 = compose_packet(srtp_composer, 3);
+
+    CHECK(parse_packet(srtp_parser, copy_buffer(pp1->buffer())));
+    CHECK(parse_packet(srtp_parser, copy_buffer(pp3->buffer())));
+
+    // Replayed packets are rejected.
+    CHECK(!parse_packet(srtp_parser, copy_buffer(pp1->buffer())));
+    CHECK(!parse_packet(srtp_parser, copy_buffer(pp3->buffer())));
+
+    // Reordered packet within window is accepted once.
+    CHECK(parse_packet(srtp_parser, copy_buffer(pp2->buffer())));
+    CHECK(!parse_packet(srtp_parser, copy_buffer(pp2->buffer())));
+}
+
+void check_rollover(SrtpSuite suite) {
+    EncodingMap encoding_map(arena);
+
+    Composer rtp_composer(NULL);
+    SrtpComposer srtp_composer(make_config(suite), rtp_composer);
+    CHECK(srtp_composer.is_valid());
+
+    Parser rtp_parser(encoding_map, NULL);
+    SrtpParser srtp_parser(make_config(suite), rtp_parser);
+    CHECK(srtp_parser.is_valid());
+
+    packet::PacketPtr late_pp;
+
+    for (int n = 0; n < 10; n++) {
+        const packet::seqnum_t sn = packet::seqnum_t(65530 + n);
+
+        packet::PacketPtr pp = compose_packet(srtp_composer, sn);
+
+        // Delay one packet from before wrap until after wrap.
+        if (sn == 65535) {
+            late_pp = pp;
+            continue;
+        }
+
+        CHECK(parse_packet(srtp_parser, copy_buffer(pp->buffer())));
+    }
+
+    CHECK(late_pp);
+    CHECK(parse_packet(srtp_parser, copy_buffer(late_pp->buffer())));
+}
+
+} // namespace
+
+TEST_GROUP(srtp) {};
+
+TEST(srtp, parse_key) {
+    SrtpConfig config;
+    config.suite = Srtp_AES_CM_128_HMAC_SHA1_80;
+
+    CHECK(parse_srtp_key(KeyHex, config));
+
+    UNSIGNED_LONGS_EQUAL(0xE1, config.master_key[0]);
+    UNSIGNED_LONGS_EQUAL(0x39, config.master_key[15]);
+    UNSIGNED_LONGS_EQUAL(0x0E, config.master_salt[0]);
+    UNSIGNED_LONGS_EQUAL(0xE6, config.master_salt[13]);
+
+    // wrong length
+    CHECK(!parse_srtp_key("E1F97A0D", config));
+    // not hex
+    CHECK(!parse_srtp_key("X1F97A0D3E018BE0D64FA32C06DE4139"
+                          "0EC675AD498AFEEBB6960B3AABE6",
+                          config));
+    // suite not set
+    config.suite = Srtp_None;
+    CHECK(!parse_srtp_key(KeyHex, config));
+}
+
+// Test vectors from RFC 3711, appendix B.3.
+TEST(srtp, key_derivation) {
+    const SrtpConfig config = make_config(Srtp_AES_CM_128_HMAC_SHA1_80);
+
+    const uint8_t expected_cipher_key[] = {
+        0xC6, 0x1E, 0x7A, 0x93, 0x74, 0x4F, 0x39, 0xEE,
+        0x10, 0x73, 0x4A, 0xFE, 0x3F, 0xF7, 0xA0, 0x87,
+    };
+    const uint8_t expected_salt[] = {
+        0x30, 0xCB, 0xBC, 0x08, 0x86, 0x3D, 0x8C,
+        0x85, 0xD4, 0x9D, 0xB3, 0x4A, 0x9A, 0xE1,
+    };
+    const uint8_t expected_auth_key[] = {
+        0xCE, 0xBE, 0x32, 0x1F, 0x6F, 0xF7, 0x71, 0x6B, 0x6F, 0xD4,
+        0xAB, 0x49, 0xAF, 0x25, 0x6A, 0x15, 0x6D, 0x38, 0xBA, 0xA4,
+    };
+
+    uint8_t key[20] = {};
+
+    CHECK(SrtpCrypto::derive_key(config.master_key, config.master_salt, 14, 0x00, key,
+                                 sizeof(expected_cipher_key)));
+    check_bytes(expected_cipher_key, key, sizeof(expected_cipher_key));
+
+    CHECK(SrtpCrypto::derive_key(config.master_key, config.master_salt, 14, 0x02, key,
+                                 sizeof(expected_salt)));
+    check_bytes(expected_salt, key, sizeof(expected_salt));
+
+    CHECK(SrtpCrypto::derive_key(config.master_key, config.master_salt, 14, 0x01, key,
+                                 sizeof(expected_auth_key)));
+    check_bytes(expected_auth_key, key, sizeof(expected_auth_key));
+}
+
+TEST(srtp, round_trip_aes_cm) {
+    check_round_trip(Srtp_AES_CM_128_HMAC_SHA1_80);
+}
+
+TEST(srtp, round_trip_aes_gcm) {
+    check_round_trip(Srtp_AEAD_AES_128_GCM);
+}
+
+TEST(srtp, tamper_header) {
+    check_tamper(Srtp_AES_CM_128_HMAC_SHA1_80, 4);
+    check_tamper(Srtp_AEAD_AES_128_GCM, 4);
+}
+
+TEST(srtp, tamper_payload) {
+    check_tamper(Srtp_AES_CM_128_HMAC_SHA1_80, sizeof(Header) + 10);
+    check_tamper(Srtp_AEAD_AES_128_GCM, sizeof(Header) + 10);
+}
+
+TEST(srtp, tamper_tag) {
+    check_tamper(Srtp_AES_CM_128_HMAC_SHA1_80, sizeof(Header) + PayloadSz + 1);
+    check_tamper(Srtp_AEAD_AES_128_GCM, sizeof(Header) + PayloadSz + 1);
+}
+
+TEST(srtp, wrong_key) {
+    EncodingMap encoding_map(arena);
+
+    Composer rtp_composer(NULL);
+    SrtpComposer srtp_composer(make_config(Srtp_AES_CM_128_HMAC_SHA1_80), rtp_composer);
+    CHECK(srtp_composer.is_valid());
+
+    Parser rtp_parser(encoding_map, NULL);
+    SrtpParser srtp_parser(make_config(Srtp_AES_CM_128_HMAC_SHA1_80,
+                                       "00F97A0D3E018BE0D64FA32C06DE4139"
+                                       "0EC675AD498AFEEBB6960B3AABE6"),
+                           rtp_parser);
+    CHECK(srtp_parser.is_valid());
+
+    packet::PacketPtr pp = compose_packet(srtp_composer, 1);
+
+    CHECK(!parse_packet(srtp_parser, copy_buffer(pp->buffer())));
+}
+
+TEST(srtp, replay) {
+    check_replay(Srtp_AES_CM_128_HMAC_SHA1_80);
+    check_replay(Srtp_AEAD_AES_128_GCM);
+}
+
+TEST(srtp, rollover) {
+    check_rollover(Srtp_AES_CM_128_HMAC_SHA1_80);
+    check_rollover(Srtp_AEAD_AES_128_GCM);
+}
+
+} // namespace rtp
+} // namespace roc
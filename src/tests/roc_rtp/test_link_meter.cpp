@@ -27,6 +27,7 @@ core::HeapArena arena;
 packet::PacketFactory packet_factory(arena, PacketSz);
 
 EncodingMap encoding_map(arena);
+LinkMeterConfig config;
 
 packet::PacketPtr new_packet(packet::seqnum_t sn) {
     packet::PacketPtr packet = packet_factory.new_packet();
@@ -40,6 +41,20 @@ packet::PacketPtr new_packet(packet::seqnum_t sn) {
     return packet;
 }
 
+// L16 stereo, 44100 Hz
+const core::nanoseconds_t NsPerSample = core::Second / 44100;
+
+packet::PacketPtr new_packet(packet::seqnum_t sn,
+                             packet::stream_timestamp_t sts,
+                             core::nanoseconds_t recv_ts) {
+    packet::PacketPtr packet = new_packet(sn);
+
+    packet->rtp()->stream_timestamp = sts;
+    packet->udp()->receive_timestamp = recv_ts;
+
+    return packet;
+}
+
 class StatusWriter : public packet::IWriter {
 public:
     explicit StatusWriter(status::StatusCode code)
@@ -60,7 +75,7 @@ TEST_GROUP(link_meter) {};
 
 TEST(link_meter, has_metrics) {
     packet::Queue queue;
-    LinkMeter meter(encoding_map);
+    LinkMeter meter(config, encoding_map);
     meter.set_writer(queue);
 
     CHECK(!meter.has_metrics());
@@ -73,7 +88,7 @@ TEST(link_meter, has_metrics) {
 
 TEST(link_meter, last_seqnum) {
     packet::Queue queue;
-    LinkMeter meter(encoding_map);
+    LinkMeter meter(config, encoding_map);
     meter.set_writer(queue);
 
     UNSIGNED_LONGS_EQUAL(0, meter.metrics().ext_last_seqnum);
@@ -98,7 +113,7 @@ TEST(link_meter, last_seqnum) {
 
 TEST(link_meter, last_seqnum_wrap) {
     packet::Queue queue;
-    LinkMeter meter(encoding_map);
+    LinkMeter meter(config, encoding_map);
     meter.set_writer(queue);
 
     UNSIGNED_LONGS_EQUAL(0, meter.metrics().ext_last_seqnum);
@@ -128,11 +143,147 @@ TEST(link_meter, last_seqnum_wrap) {
 
 TEST(link_meter, forward_error) {
     StatusWriter writer(status::StatusNoMem);
-    LinkMeter meter(encoding_map);
+    LinkMeter meter(config, encoding_map);
     meter.set_writer(writer);
 
     LONGS_EQUAL(status::StatusNoMem, meter.write(new_packet(100)));
 }
 
+TEST(link_meter, lost_packets) {
+    packet::Queue queue;
+    LinkMeter meter(config, encoding_map);
+    meter.set_writer(queue);
+
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(100)));
+    UNSIGNED_LONGS_EQUAL(1, meter.metrics().total_packets);
+    LONGS_EQUAL(0, meter.metrics().lost_packets);
+
+    // two packets lost
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(103)));
+    UNSIGNED_LONGS_EQUAL(4, meter.metrics().total_packets);
+    LONGS_EQUAL(2, meter.metrics().lost_packets);
+
+    // one of them arrived late
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(101)));
+    UNSIGNED_LONGS_EQUAL(4, meter.metrics().total_packets);
+    LONGS_EQUAL(1, meter.metrics().lost_packets);
+
+    // duplicate
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(101)));
+    UNSIGNED_LONGS_EQUAL(4, meter.metrics().total_packets);
+    LONGS_EQUAL(0, meter.metrics().lost_packets);
+}
+
+TEST(link_meter, recent_losses) {
+    packet::Queue queue;
+    LinkMeter meter(config, encoding_map);
+    meter.set_writer(queue);
+
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(100)));
+    UNSIGNED_LONGS_EQUAL(0, meter.metrics().recent_losses);
+
+    // 101 and 103 lost
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(102)));
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(104)));
+    UNSIGNED_LONGS_EQUAL((1 << 1) | (1 << 3), meter.metrics().recent_losses);
+
+    // 103 arrived late
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(103)));
+    UNSIGNED_LONGS_EQUAL((1 << 3), meter.metrics().recent_losses);
+
+    // 101 goes out of window
+    LONGS_EQUAL(status::StatusOK, meter.write(new_packet(165)));
+    // 105..164 lost
+    CHECK(meter.metrics().recent_losses == ((uint64_t(1) << 61) - 2));
+}
+
+TEST(link_meter, jitter_zero) {
+    enum { NumPackets = 100, PacketSamples = 441 };
+
+    packet::Queue queue;
+    LinkMeter meter(config, encoding_map);
+    meter.set_writer(queue);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        LONGS_EQUAL(status::StatusOK,
+                    meter.write(new_packet(packet::seqnum_t(n),
+                                           packet::stream_timestamp_t(n * PacketSamples),
+                                           core::Second
+                                               + core::nanoseconds_t(n * PacketSamples)
+                                                   * NsPerSample)));
+    }
+
+    CHECK(meter.metrics().jitter < core::Microsecond);
+    CHECK(meter.metrics().peak_jitter < core::Microsecond);
+}
+
+TEST(link_meter, jitter_constant) {
+    enum { NumPackets = 1000, PacketSamples = 441 };
+
+    const core::nanoseconds_t PacketDur = PacketSamples * NsPerSample;
+    const core::nanoseconds_t Delay = core::Millisecond;
+
+    packet::Queue queue;
+    LinkMeter meter(config, encoding_map);
+    meter.set_writer(queue);
+
+    // every odd packet is delayed, so delay variation of every packet is Delay
+    for (size_t n = 0; n < NumPackets; n++) {
+        const core::nanoseconds_t recv_ts =
+            core::Second + core::nanoseconds_t(n) * PacketDur + (n % 2 ? Delay : 0);
+
+        LONGS_EQUAL(status::StatusOK,
+                    meter.write(new_packet(packet::seqnum_t(n),
+                                           packet::stream_timestamp_t(n * PacketSamples),
+                                           recv_ts)));
+    }
+
+    CHECK(std::abs(meter.metrics().jitter - Delay) < core::Microsecond);
+    CHECK(meter.metrics().peak_jitter >= Delay);
+    CHECK(meter.metrics().peak_jitter <= Delay + Delay / 16);
+}
+
+TEST(link_meter, peak_jitter_window) {
+    enum { Window = 100, PacketSamples = 441 };
+
+    const core::nanoseconds_t PacketDur = PacketSamples * NsPerSample;
+    const core::nanoseconds_t Delay = core::Millisecond * 10;
+
+    LinkMeterConfig window_config;
+    window_config.jitter_window = Window;
+    window_config.jitter_percentile = 0.95;
+
+    packet::Queue queue;
+    LinkMeter meter(window_config, encoding_map);
+    meter.set_writer(queue);
+
+    size_t sn = 0;
+    core::nanoseconds_t recv_ts = core::Second;
+
+    // spikes in every 5th packet
+    for (size_t n = 0; n < Window * 2; n++, sn++) {
+        recv_ts += PacketDur + (sn % 5 == 0 ? Delay : 0) - (sn % 5 == 1 ? Delay : 0);
+
+        LONGS_EQUAL(status::StatusOK,
+                    meter.write(new_packet(packet::seqnum_t(sn),
+                                           packet::stream_timestamp_t(sn * PacketSamples),
+                                           recv_ts)));
+    }
+
+    CHECK(meter.metrics().peak_jitter >= Delay);
+
+    // no more spikes, after two windows they're forgotten
+    for (size_t n = 0; n < Window * 2; n++, sn++) {
+        recv_ts += PacketDur;
+
+        LONGS_EQUAL(status::StatusOK,
+                    meter.write(new_packet(packet::seqnum_t(sn),
+                                           packet::stream_timestamp_t(sn * PacketSamples),
+                                           recv_ts)));
+    }
+
+    CHECK(meter.metrics().peak_jitter < core::Microsecond);
+}
+
 } // namespace rtp
 } // namespace roc
@@ -16,9 +16,11 @@
 #include "roc_core/heap_arena.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_rtp/composer.h"
 #include "roc_rtp/encoding_map.h"
+#include "roc_rtp/headers.h"
 #include "roc_rtp/parser.h"
 
 namespace roc {
@@ -198,7 +200,8 @@ void check_compose_encode(const test::PacketInfo& pi) {
     CHECK(encoding);
 
     core::ScopedPtr<audio::IFrameEncoder> encoder(
-        encoding->new_encoder(arena, encoding->sample_spec), arena);
+        encoding->new_encoder(arena, encoding->sample_spec, audio::FrameEncoderConfig()),
+        arena);
     CHECK(encoder);
 
     Composer composer(NULL);
@@ -252,5 +255,102 @@ TEST(packet_formats, l16_1ch_10s_4pad_2csrc_12ext_marker) {
     check(test::rtp_l16_1ch_10s_4pad_2csrc_12ext_marker, CanParse);
 }
 
+TEST(packet_formats, parse_batch) {
+    enum { NumPackets = 5 };
+
+    const test::PacketInfo* infos[NumPackets] = {
+        &test::rtp_l16_2ch_320s,
+        &test::rtp_l16_1ch_10s_12ext,
+        NULL, // invalid packet
+        &test::rtp_l16_2ch_300s_80pad,
+        &test::rtp_l16_1ch_10s_4pad_2csrc_12ext_marker,
+    };
+
+    EncodingMap encoding_map(arena);
+    Parser parser(encoding_map, NULL);
+
+    packet::PacketPtr packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = packet_factory.new_packet();
+        CHECK(packets[n]);
+
+        if (infos[n]) {
+            packets[n]->set_buffer(
+                new_buffer(infos[n]->raw_data, infos[n]->packet_size));
+        } else {
+            // Truncated header.
+            packets[n]->set_buffer(new_buffer(test::rtp_l16_2ch_320s.raw_data, 4));
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets - 1, parser.parse_batch(packets, NumPackets));
+
+    // Invalid packet is removed, order of other packets is preserved.
+    size_t pkt_idx = 0;
+    for (size_t n = 0; n < NumPackets; n++) {
+        if (!infos[n]) {
+            continue;
+        }
+        CHECK(packets[pkt_idx]);
+        CHECK(packets[pkt_idx]->has_flags(packet::Packet::FlagAudio));
+        check_packet_fields(*packets[pkt_idx], *infos[n]);
+        check_packet_data(*packets[pkt_idx], *infos[n]);
+        pkt_idx++;
+    }
+    CHECK(!packets[NumPackets - 1]);
+}
+
+TEST(packet_formats, capture_time_extension) {
+    enum { PayloadSize = 40 };
+
+    const core::nanoseconds_t capture_timestamps[] = { 1691499037871419405, 0 };
+
+    EncodingMap encoding_map(arena);
+
+    Composer composer(NULL, true);
+    Parser parser(encoding_map, NULL);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(capture_timestamps); n++) {
+        core::Slice<uint8_t> buffer = new_buffer(NULL, 0);
+        CHECK(buffer);
+
+        packet::PacketPtr packet = packet_factory.new_packet();
+        CHECK(packet);
+
+        CHECK(composer.prepare(*packet, buffer, PayloadSize));
+        packet->set_buffer(buffer);
+
+        UNSIGNED_LONGS_EQUAL(sizeof(Header) + sizeof(CaptureTimeExtension),
+                             packet->rtp()->header.size());
+
+        packet->rtp()->source_id = 555;
+        packet->rtp()->seqnum = 1;
+        packet->rtp()->stream_timestamp = 100;
+        packet->rtp()->payload_type = PayloadType_L16_Stereo;
+        packet->rtp()->capture_timestamp = capture_timestamps[n];
+
+        CHECK(composer.compose(*packet));
+
+        packet::PacketPtr parsed = packet_factory.new_packet();
+        CHECK(parsed);
+
+        CHECK(parser.parse(*parsed, buffer));
+
+        UNSIGNED_LONGS_EQUAL(555, parsed->rtp()->source_id);
+        UNSIGNED_LONGS_EQUAL(1, parsed->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(100, parsed->rtp()->stream_timestamp);
+        UNSIGNED_LONGS_EQUAL(PayloadSize, parsed->rtp()->payload.size());
+
+        if (capture_timestamps[n] != 0) {
+            CHECK(core::ns_equal_delta(capture_timestamps[n],
+                                       parsed->rtp()->capture_timestamp,
+                                       10 * core::Nanosecond));
+        } else {
+            LONGS_EQUAL(0, parsed->rtp()->capture_timestamp);
+        }
+    }
+}
+
 } // namespace rtp
 } // namespace roc
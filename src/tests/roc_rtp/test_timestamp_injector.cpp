@@ -123,5 +123,39 @@ TEST(timestamp_injector, negative_and_positive_dn) {
     }
 }
 
+TEST(timestamp_injector, capture_ts_from_packet) {
+    enum { ChMask = 3, SampleRate = 48000, PacketSz = 480 };
+
+    const audio::SampleSpec sample_spec =
+        audio::SampleSpec(SampleRate, audio::Sample_RawFormat, audio::ChanLayout_Surround,
+                          audio::ChanOrder_Smpte, ChMask);
+
+    const core::nanoseconds_t capt_ts = 1691499037871419405;
+    const core::nanoseconds_t ts_step = sample_spec.samples_per_chan_2_ns(PacketSz);
+
+    packet::Queue queue;
+    TimestampInjector injector(queue, sample_spec);
+
+    // First packet has capture timestamp from header extension,
+    // following packets don't.
+    packet::PacketPtr first = new_packet(0, 1000);
+    first->rtp()->capture_timestamp = capt_ts;
+
+    UNSIGNED_LONGS_EQUAL(status::StatusOK, queue.write(first));
+    UNSIGNED_LONGS_EQUAL(status::StatusOK, queue.write(new_packet(1, 1000 + PacketSz)));
+    UNSIGNED_LONGS_EQUAL(status::StatusOK,
+                         queue.write(new_packet(2, 1000 + PacketSz * 2)));
+
+    for (size_t i = 0; i < 3; i++) {
+        packet::PacketPtr packet;
+        UNSIGNED_LONGS_EQUAL(status::StatusOK, injector.read(packet));
+        CHECK(packet);
+
+        CHECK(core::ns_equal_delta(capt_ts + ts_step * (core::nanoseconds_t)i,
+                                   packet->rtp()->capture_timestamp,
+                                   core::Microsecond));
+    }
+}
+
 } // namespace rtp
 } // namespace roc
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_sndio/backend_map.h"
+
+namespace roc {
+namespace sndio {
+
+TEST_GROUP(backend_map) {};
+
+TEST(backend_map, find_driver) {
+    BackendMap& map = BackendMap::instance();
+
+    // iterate lazily
+    size_t n_drivers = 0;
+    while (const DriverInfo* driver_info = map.find_driver(n_drivers)) {
+        CHECK(driver_info->backend);
+        CHECK(strlen(driver_info->name) > 0);
+        n_drivers++;
+    }
+
+    CHECK(n_drivers > 0);
+    UNSIGNED_LONGS_EQUAL(n_drivers, map.num_drivers());
+
+    for (size_t n = 0; n < n_drivers; n++) {
+        POINTERS_EQUAL(map.find_driver(n), &map.nth_driver(n));
+    }
+
+    CHECK(!map.find_driver(n_drivers));
+}
+
+TEST(backend_map, drivers_in_backend_order) {
+    BackendMap& map = BackendMap::instance();
+
+    size_t n_backend = 0;
+
+    for (size_t n = 0; n < map.num_drivers(); n++) {
+        const DriverInfo& driver_info = map.nth_driver(n);
+
+        while (n_backend < map.num_backends()
+               && &map.nth_backend(n_backend) != driver_info.backend) {
+            n_backend++;
+        }
+
+        CHECK(n_backend < map.num_backends());
+    }
+}
+
+} // namespace sndio
+} // namespace roc
@@ -80,6 +80,12 @@ public:
     void check(size_t offset, size_t size) {
         UNSIGNED_LONGS_EQUAL(pos_, size);
 
+        check_prefix(offset, size);
+    }
+
+    void check_prefix(size_t offset, size_t size) {
+        CHECK(pos_ >= size);
+
         for (size_t n = 0; n < size; n++) {
             DOUBLES_EQUAL((double)samples_[n], (double)nth_sample_(offset + n), 0.0001);
         }
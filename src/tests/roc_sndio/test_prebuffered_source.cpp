@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/time.h"
+#include "roc_sndio/prebuffered_source.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum { FrameSize = 512, SampleRate = 48000, ChMask = 0x3 };
+
+const audio::SampleSpec sample_spec(SampleRate,
+                                    audio::Sample_RawFormat,
+                                    audio::ChanLayout_Surround,
+                                    audio::ChanOrder_Smpte,
+                                    ChMask);
+
+const core::nanoseconds_t frame_duration = FrameSize * core::Second
+    / core::nanoseconds_t(sample_spec.sample_rate() * sample_spec.num_channels());
+
+core::HeapArena arena;
+
+audio::sample_t nth_sample(size_t n) {
+    return audio::sample_t(uint8_t(n)) / audio::sample_t(1 << 8);
+}
+
+// Finite source which can be restarted, like file source.
+class TestSource : public ISource {
+public:
+    TestSource(size_t size)
+        : size_(size)
+        , pos_(0)
+        , restart_delay_(0)
+        , n_restarts_(0) {
+    }
+
+    void set_restart_delay(core::nanoseconds_t delay) {
+        restart_delay_ = delay;
+    }
+
+    size_t num_restarts() const {
+        return n_restarts_;
+    }
+
+    virtual ISink* to_sink() {
+        return NULL;
+    }
+
+    virtual ISource* to_source() {
+        return this;
+    }
+
+    virtual DeviceType type() const {
+        return DeviceType_Source;
+    }
+
+    virtual DeviceState state() const {
+        return DeviceState_Active;
+    }
+
+    virtual void pause() {
+    }
+
+    virtual bool resume() {
+        return true;
+    }
+
+    virtual bool restart() {
+        if (restart_delay_ != 0) {
+            core::sleep_for(core::ClockMonotonic, restart_delay_);
+        }
+        pos_ = 0;
+        n_restarts_++;
+        return true;
+    }
+
+    virtual audio::SampleSpec sample_spec() const {
+        return roc::sndio::sample_spec;
+    }
+
+    virtual core::nanoseconds_t latency() const {
+        return 0;
+    }
+
+    virtual bool has_latency() const {
+        return false;
+    }
+
+    virtual bool has_clock() const {
+        return false;
+    }
+
+    virtual void reclock(core::nanoseconds_t) {
+    }
+
+    virtual bool read(audio::Frame& frame) {
+        if (pos_ >= size_) {
+            return false;
+        }
+
+        for (size_t n = 0; n < frame.num_raw_samples(); n++) {
+            frame.raw_samples()[n] = pos_ < size_ ? nth_sample(pos_) : 0;
+            pos_++;
+        }
+
+        return true;
+    }
+
+private:
+    const size_t size_;
+    size_t pos_;
+    core::nanoseconds_t restart_delay_;
+    size_t n_restarts_;
+};
+
+// Reads whole stream and checks samples.
+void read_stream(PrebufferedSource& source, size_t stream_size) {
+    CHECK(source.restart());
+
+    audio::sample_t samples[FrameSize];
+    size_t pos = 0;
+
+    for (;;) {
+        audio::Frame frame(samples, FrameSize);
+        if (!source.read(frame)) {
+            break;
+        }
+
+        for (size_t n = 0; n < FrameSize; n++) {
+            if (pos < stream_size) {
+                DOUBLES_EQUAL(nth_sample(pos), samples[n], 0);
+            } else {
+                DOUBLES_EQUAL(0, samples[n], 0);
+            }
+            pos++;
+        }
+    }
+
+    CHECK(pos >= stream_size);
+    CHECK(pos < stream_size + FrameSize);
+}
+
+} // namespace
+
+TEST_GROUP(prebuffered_source) {};
+
+TEST(prebuffered_source, read) {
+    enum { StreamSize = FrameSize * 50 + 100 };
+
+    TestSource test_source(StreamSize);
+    PrebufferedSource prebuf_source(arena, test_source, frame_duration,
+                                    frame_duration * 4);
+    CHECK(prebuf_source.is_valid());
+
+    read_stream(prebuf_source, StreamSize);
+}
+
+TEST(prebuffered_source, restart) {
+    enum { StreamSize = FrameSize * 50 + 100, NumRestarts = 5 };
+
+    TestSource test_source(StreamSize);
+    PrebufferedSource prebuf_source(arena, test_source, frame_duration,
+                                    frame_duration * 4);
+    CHECK(prebuf_source.is_valid());
+
+    for (size_t n = 0; n < NumRestarts; n++) {
+        read_stream(prebuf_source, StreamSize);
+    }
+
+    // First time source is read from where it was opened.
+    // After last EOF, source may be already rewinding in background.
+    CHECK(test_source.num_restarts() >= NumRestarts - 1);
+    CHECK(test_source.num_restarts() <= NumRestarts);
+    UNSIGNED_LONGS_EQUAL(NumRestarts, prebuf_source.get_metrics().switch_count);
+}
+
+TEST(prebuffered_source, restart_in_middle) {
+    enum { StreamSize = FrameSize * 50 };
+
+    TestSource test_source(StreamSize);
+    PrebufferedSource prebuf_source(arena, test_source, frame_duration,
+                                    frame_duration * 4);
+    CHECK(prebuf_source.is_valid());
+
+    audio::sample_t samples[FrameSize];
+
+    CHECK(prebuf_source.restart());
+    for (size_t n = 0; n < 10; n++) {
+        audio::Frame frame(samples, FrameSize);
+        CHECK(prebuf_source.read(frame));
+    }
+
+    read_stream(prebuf_source, StreamSize);
+}
+
+TEST(prebuffered_source, slow_restart) {
+    enum { StreamSize = FrameSize * 20 };
+
+    const core::nanoseconds_t restart_delay = 100 * core::Millisecond;
+
+    TestSource test_source(StreamSize);
+    test_source.set_restart_delay(restart_delay);
+
+    PrebufferedSource prebuf_source(arena, test_source, frame_duration,
+                                    frame_duration * 4);
+    CHECK(prebuf_source.is_valid());
+
+    read_stream(prebuf_source, StreamSize);
+
+    // Source is restarted in background, while reader plays prefix.
+    CHECK(prebuf_source.restart());
+
+    audio::sample_t samples[FrameSize];
+    audio::Frame frame(samples, FrameSize);
+    CHECK(prebuf_source.read(frame));
+
+    CHECK(prebuf_source.get_metrics().last_switch_time < restart_delay);
+
+    read_stream(prebuf_source, StreamSize);
+}
+
+TEST(prebuffered_source, short_stream) {
+    enum { StreamSize = FrameSize * 2 + 100 };
+
+    TestSource test_source(StreamSize);
+    PrebufferedSource prebuf_source(arena, test_source, frame_duration,
+                                    frame_duration * 10);
+    CHECK(prebuf_source.is_valid());
+
+    for (size_t n = 0; n < 3; n++) {
+        read_stream(prebuf_source, StreamSize);
+    }
+
+    // Whole stream is kept in memory.
+    UNSIGNED_LONGS_EQUAL(0, test_source.num_restarts());
+}
+
+} // namespace sndio
+} // namespace roc
@@ -15,6 +15,8 @@
 #include "roc_core/scoped_ptr.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/temp_file.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_sndio/backend_map.h"
 #include "roc_sndio/config.h"
 #include "roc_sndio/pump.h"
@@ -52,6 +54,65 @@ bool supports_wav(IBackend& backend) {
     return supports;
 }
 
+// Sink that pulls frames from reader in its own thread,
+// paced as if it was driven by device clock.
+class PullSink : public test::MockSink, private core::Thread {
+public:
+    PullSink()
+        : reader_(NULL)
+        , stop_(0) {
+    }
+
+    virtual bool start_pull(audio::IFrameReader& reader) {
+        reader_ = &reader;
+        return start();
+    }
+
+    virtual void stop_pull() {
+        stop_ = 1;
+        join();
+        reader_ = NULL;
+    }
+
+private:
+    virtual void run() {
+        audio::sample_t samples[FrameSize];
+
+        while (!stop_) {
+            audio::Frame frame(samples, FrameSize);
+            if (!reader_->read(frame)) {
+                break;
+            }
+            write(frame);
+
+            core::sleep_for(core::ClockMonotonic, frame_duration);
+        }
+    }
+
+    audio::IFrameReader* reader_;
+    core::Atomic<int> stop_;
+};
+
+// Sink that counts write() calls.
+class CountingSink : public test::MockSink {
+public:
+    CountingSink()
+        : n_writes_(0) {
+    }
+
+    size_t num_writes() const {
+        return n_writes_;
+    }
+
+    virtual void write(audio::Frame& frame) {
+        n_writes_++;
+        test::MockSink::write(frame);
+    }
+
+private:
+    size_t n_writes_;
+};
+
 } // namespace
 
 TEST_GROUP(pump) {
@@ -179,5 +240,57 @@ TEST(pump, write_overwrite_read) {
         mock_writer.check(num_returned1, num_returned2);
     }
 }
+
+TEST(pump, pull_mode) {
+    enum { NumSamples = FrameSize * 10 };
+
+    test::MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    PullSink pull_sink;
+
+    Pump pump(buffer_pool, mock_source, NULL, pull_sink, frame_duration, sample_spec,
+              Pump::ModeOneshot);
+    CHECK(pump.is_valid());
+    CHECK(pump.run_pull());
+
+    UNSIGNED_LONGS_EQUAL(NumSamples, mock_source.num_returned());
+    pull_sink.check_prefix(0, NumSamples);
+}
+
+TEST(pump, pull_mode_not_supported) {
+    test::MockSource mock_source;
+    test::MockSink mock_sink;
+
+    Pump pump(buffer_pool, mock_source, NULL, mock_sink, frame_duration, sample_spec,
+              Pump::ModeOneshot);
+    CHECK(pump.is_valid());
+    CHECK(!pump.run_pull());
+}
+
+TEST(pump, batch_mode) {
+    enum {
+        NumFrames = 20,
+        BatchFrames = 4,
+        NumSamples = FrameSize * NumFrames,
+    };
+
+    test::MockSource mock_source;
+    mock_source.add(NumSamples);
+
+    CountingSink counting_sink;
+
+    Pump pump(buffer_pool, mock_source, NULL, counting_sink, frame_duration,
+              sample_spec, Pump::ModeOneshot);
+    CHECK(pump.is_valid());
+    CHECK(pump.enable_batching(arena, frame_duration * BatchFrames));
+    CHECK(pump.run());
+
+    UNSIGNED_LONGS_EQUAL(NumSamples, mock_source.num_returned());
+    counting_sink.check(0, NumSamples);
+
+    UNSIGNED_LONGS_EQUAL(NumFrames / BatchFrames, counting_sink.num_writes());
+}
+
 } // namespace sndio
 } // namespace roc
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_arena.h"
+#include "roc_core/thread.h"
+#include "roc_sndio/sample_ring.h"
+
+namespace roc {
+namespace sndio {
+
+namespace {
+
+enum { BlockSize = 10, NumBlocks = 4, NumSamples = 10000 };
+
+core::HeapArena arena;
+
+class WriterThread : public core::Thread {
+public:
+    WriterThread(SampleRing& ring, size_t portion)
+        : ring_(ring)
+        , portion_(portion) {
+    }
+
+private:
+    virtual void run() {
+        audio::sample_t buf[BlockSize * 3];
+
+        size_t pos = 0;
+        while (pos < NumSamples) {
+            const size_t n_samples = std::min((size_t)NumSamples - pos, portion_);
+            for (size_t n = 0; n < n_samples; n++) {
+                buf[n] = (audio::sample_t)(pos + n);
+            }
+            if (!ring_.write(buf, n_samples)) {
+                return;
+            }
+            pos += n_samples;
+        }
+
+        ring_.flush();
+
+        audio::sample_t* block = ring_.begin_write();
+        if (block) {
+            ring_.end_write(0);
+        }
+    }
+
+    SampleRing& ring_;
+    const size_t portion_;
+};
+
+} // namespace
+
+TEST_GROUP(sample_ring) {};
+
+TEST(sample_ring, write_read_blocks) {
+    SampleRing ring(arena, BlockSize, NumBlocks);
+    CHECK(ring.is_valid());
+
+    UNSIGNED_LONGS_EQUAL(BlockSize, ring.block_size());
+
+    for (size_t i = 0; i < NumBlocks; i++) {
+        audio::sample_t* block = ring.begin_write();
+        CHECK(block);
+        for (size_t n = 0; n <= i; n++) {
+            block[n] = (audio::sample_t)(i * 100 + n);
+        }
+        ring.end_write(i + 1);
+    }
+
+    for (size_t i = 0; i < NumBlocks; i++) {
+        size_t n_samples = 0;
+        const audio::sample_t* block = ring.begin_read(n_samples);
+        CHECK(block);
+        UNSIGNED_LONGS_EQUAL(i + 1, n_samples);
+        for (size_t n = 0; n <= i; n++) {
+            DOUBLES_EQUAL((double)(i * 100 + n), (double)block[n], 0);
+        }
+        ring.end_read();
+    }
+}
+
+TEST(sample_ring, write_read_portions) {
+    SampleRing ring(arena, BlockSize, NumBlocks);
+    CHECK(ring.is_valid());
+
+    audio::sample_t buf[BlockSize * NumBlocks];
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(buf); n++) {
+        buf[n] = (audio::sample_t)n;
+    }
+
+    // portions are not aligned to blocks
+    CHECK(ring.write(buf, 7));
+    CHECK(ring.write(buf + 7, 7));
+    CHECK(ring.write(buf + 14, 11));
+    ring.flush();
+
+    audio::sample_t* block = ring.begin_write();
+    CHECK(block);
+    ring.end_write(0);
+
+    audio::sample_t out[BlockSize * NumBlocks] = {};
+
+    UNSIGNED_LONGS_EQUAL(3, ring.read(out, 3));
+    UNSIGNED_LONGS_EQUAL(13, ring.read(out + 3, 13));
+    // end of stream
+    UNSIGNED_LONGS_EQUAL(9, ring.read(out + 16, 20));
+    UNSIGNED_LONGS_EQUAL(0, ring.read(out + 25, 1));
+
+    for (size_t n = 0; n < 25; n++) {
+        DOUBLES_EQUAL((double)n, (double)out[n], 0);
+    }
+}
+
+TEST(sample_ring, try_write) {
+    SampleRing ring(arena, BlockSize, NumBlocks);
+    CHECK(ring.is_valid());
+
+    for (size_t i = 0; i < NumBlocks; i++) {
+        audio::sample_t* block = ring.try_begin_write();
+        CHECK(block);
+        block[0] = (audio::sample_t)i;
+        ring.end_write(1);
+    }
+
+    // ring is full
+    CHECK(!ring.try_begin_write());
+
+    size_t n_samples = 0;
+    const audio::sample_t* block = ring.begin_read(n_samples);
+    CHECK(block);
+    UNSIGNED_LONGS_EQUAL(1, n_samples);
+    DOUBLES_EQUAL(0, (double)block[0], 0);
+    ring.end_read();
+
+    // one block was freed
+    CHECK(ring.try_begin_write());
+    ring.end_write(1);
+    CHECK(!ring.try_begin_write());
+
+    ring.close();
+}
+
+TEST(sample_ring, close) {
+    SampleRing ring(arena, BlockSize, NumBlocks);
+    CHECK(ring.is_valid());
+
+    audio::sample_t buf[BlockSize] = {};
+    CHECK(ring.write(buf, BlockSize));
+
+    ring.close();
+
+    size_t n_samples = 0;
+    CHECK(!ring.begin_read(n_samples));
+    CHECK(!ring.begin_write());
+    CHECK(!ring.try_begin_write());
+
+    CHECK(!ring.write(buf, BlockSize));
+    UNSIGNED_LONGS_EQUAL(0, ring.read(buf, BlockSize));
+}
+
+TEST(sample_ring, concurrent) {
+    const size_t portions[] = { 1, 7, BlockSize, BlockSize * 3 };
+
+    for (size_t p = 0; p < ROC_ARRAY_SIZE(portions); p++) {
+        SampleRing ring(arena, BlockSize, NumBlocks);
+        CHECK(ring.is_valid());
+
+        WriterThread writer(ring, portions[p]);
+        CHECK(writer.start());
+
+        audio::sample_t buf[BlockSize * 2 + 3];
+
+        size_t pos = 0;
+        for (;;) {
+            const size_t n_samples = ring.read(buf, ROC_ARRAY_SIZE(buf));
+            for (size_t n = 0; n < n_samples; n++) {
+                DOUBLES_EQUAL((double)(pos + n), (double)buf[n], 0);
+            }
+            pos += n_samples;
+            if (n_samples < ROC_ARRAY_SIZE(buf)) {
+                break;
+            }
+        }
+
+        UNSIGNED_LONGS_EQUAL(NumSamples, pos);
+
+        writer.join();
+    }
+}
+
+} // namespace sndio
+} // namespace roc
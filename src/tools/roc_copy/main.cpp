@@ -7,11 +7,14 @@
  */
 
 #include "roc_address/io_uri.h"
+#include "roc_audio/null_writer.h"
 #include "roc_core/crash_handler.h"
 #include "roc_core/heap_arena.h"
 #include "roc_core/log.h"
 #include "roc_core/parse_units.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/time.h"
+#include "roc_pipeline/parallel_transcoder.h"
 #include "roc_pipeline/transcoder_sink.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/backend_map.h"
@@ -66,12 +69,44 @@ int main(int argc, char** argv) {
     }
 
     pipeline::TranscoderConfig transcoder_config;
+    pipeline::ParallelTranscoderConfig parallel_config;
+
+    const bool bulk_mode = args.jobs_given;
+
+    if (bulk_mode) {
+        if (args.jobs_arg <= 0) {
+            roc_log(LogError, "invalid --jobs: should be > 0");
+            return 1;
+        }
+        parallel_config.num_jobs = (size_t)args.jobs_arg;
+    }
+
+    if (args.segment_len_given) {
+        if (!bulk_mode) {
+            roc_log(LogError, "--segment-len can be used only together with --jobs");
+            return 1;
+        }
+        if (!core::parse_duration(args.segment_len_arg, parallel_config.segment_length)) {
+            roc_log(LogError, "invalid --segment-len: bad format");
+            return 1;
+        }
+        if (parallel_config.segment_length <= 0) {
+            roc_log(LogError, "invalid --segment-len: should be > 0");
+            return 1;
+        }
+    }
 
     sndio::Config source_config;
     source_config.sample_spec.set_channel_set(
         transcoder_config.input_sample_spec.channel_set());
     source_config.sample_spec.set_sample_rate(0);
 
+    if (bulk_mode) {
+        // bulk mode is not limited by frame latency, so use larger frames
+        // by default to reduce per-frame overhead
+        source_config.frame_length = parallel_config.frame_length;
+    }
+
     if (args.frame_len_given) {
         if (!core::parse_duration(args.frame_len_arg, source_config.frame_length)) {
             roc_log(LogError, "invalid --frame-len: bad format");
@@ -81,6 +116,7 @@ int main(int argc, char** argv) {
             roc_log(LogError, "invalid --frame-len: should be > 0");
             return 1;
         }
+        parallel_config.frame_length = source_config.frame_length;
     }
 
     sndio::BackendMap::instance().set_frame_size(source_config.frame_length,
@@ -144,6 +180,12 @@ int main(int argc, char** argv) {
     case resampler_backend_arg_speexdec:
         transcoder_config.resampler.backend = audio::ResamplerBackend_SpeexDec;
         break;
+    case resampler_backend_arg_builtin_fixed:
+        transcoder_config.resampler.backend = audio::ResamplerBackend_BuiltinFixed;
+        break;
+    case resampler_backend_arg_builtin_polyphase:
+        transcoder_config.resampler.backend = audio::ResamplerBackend_BuiltinPolyphase;
+        break;
     default:
         break;
     }
@@ -204,6 +246,36 @@ int main(int argc, char** argv) {
         output_writer = output_sink.get();
     }
 
+    if (bulk_mode) {
+        audio::NullWriter null_writer;
+
+        pipeline::ParallelTranscoder transcoder(
+            transcoder_config, parallel_config,
+            output_writer ? *output_writer : null_writer, arena);
+        if (!transcoder.is_valid()) {
+            roc_log(LogError, "can't create parallel transcoder pipeline");
+            return 1;
+        }
+
+        const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+        const bool ok = transcoder.run(*input_source);
+
+        const core::nanoseconds_t elapsed_time =
+            core::timestamp(core::ClockMonotonic) - start_time;
+        const core::nanoseconds_t processed_time =
+            transcoder_config.input_sample_spec.samples_per_chan_2_ns(
+                transcoder.num_input_samples());
+
+        roc_log(LogInfo, "processed %.3fs in %.3fs (%.1fx realtime) using %lu jobs",
+                (double)processed_time / core::Second,
+                (double)elapsed_time / core::Second,
+                elapsed_time > 0 ? (double)processed_time / elapsed_time : 0.,
+                (unsigned long)parallel_config.num_jobs);
+
+        return ok ? 0 : 1;
+    }
+
     pipeline::TranscoderSink transcoder(transcoder_config, output_writer,
                                         frame_buffer_pool, arena);
     if (!transcoder.is_valid()) {
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_loadgen/generator.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace roc {
+namespace loadgen {
+
+namespace {
+
+const double SineFreq = 440;
+const double SineAmplitude = 0.5;
+
+double ns_2_ms(core::nanoseconds_t ns) {
+    return (double)ns / core::Millisecond;
+}
+
+double percent(uint64_t part, uint64_t total) {
+    return total != 0 ? (double)part / total * 100 : 0;
+}
+
+} // namespace
+
+Generator::Generator(node::Context& context,
+                     const pipeline::SenderSinkConfig& sink_config,
+                     const ImpairmentConfig& impairment_config,
+                     const GeneratorConfig& generator_config)
+    : context_(context)
+    , sink_config_(sink_config)
+    , impairment_config_(impairment_config)
+    , config_(generator_config)
+    , streams_(context.arena())
+    , frame_template_(context.arena())
+    , frame_buffer_(context.arena())
+    , sine_pos_(0)
+    , n_frames_(0)
+    , n_overruns_(0)
+    , last_sent_(0)
+    , last_report_(0)
+    , valid_(false) {
+    roc_panic_if_msg(config_.num_streams == 0, "generator: number of streams is zero");
+    roc_panic_if_msg(config_.frame_length <= 0, "generator: frame length is zero");
+
+    const size_t frame_size =
+        sink_config_.input_sample_spec.ns_2_samples_overall(config_.frame_length);
+
+    if (frame_size == 0) {
+        roc_log(LogError, "generator: frame length is too small");
+        return;
+    }
+
+    if (!frame_template_.resize(frame_size) || !frame_buffer_.resize(frame_size)) {
+        roc_log(LogError, "generator: can't allocate frame buffers");
+        return;
+    }
+
+    valid_ = true;
+}
+
+Generator::~Generator() {
+    for (size_t n = 0; n < streams_.size(); n++) {
+        context_.arena().destroy_object(*streams_[n]);
+    }
+}
+
+bool Generator::is_valid() const {
+    return valid_;
+}
+
+bool Generator::open(const Endpoint* endpoints) {
+    roc_panic_if(!is_valid());
+
+    if (!streams_.grow(config_.num_streams)) {
+        roc_log(LogError, "generator: can't allocate streams");
+        return false;
+    }
+
+    for (size_t n = 0; n < config_.num_streams; n++) {
+        Stream* stream = new (context_.arena())
+            Stream(context_, sink_config_, impairment_config_);
+        if (!stream) {
+            roc_log(LogError, "generator: can't allocate stream");
+            return false;
+        }
+
+        if (!streams_.push_back(stream)) {
+            context_.arena().destroy_object(*stream);
+            roc_log(LogError, "generator: can't allocate stream");
+            return false;
+        }
+
+        if (!stream->is_valid()) {
+            roc_log(LogError, "generator: can't create stream");
+            return false;
+        }
+
+        if (!stream->open(endpoints)) {
+            roc_log(LogError, "generator: can't open stream");
+            return false;
+        }
+    }
+
+    roc_log(LogInfo, "generator: opened %lu streams", (unsigned long)streams_.size());
+
+    return true;
+}
+
+void Generator::run() {
+    roc_panic_if(!is_valid());
+
+    const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+    core::nanoseconds_t next_frame = start_time;
+    last_report_ = start_time;
+
+    for (;;) {
+        core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+        if (config_.duration > 0 && now - start_time >= config_.duration) {
+            break;
+        }
+
+        if (now >= next_frame) {
+            generate_frame_();
+
+            for (size_t n = 0; n < streams_.size(); n++) {
+                // Pipeline may modify frame in-place.
+                memcpy(frame_buffer_.data(), frame_template_.data(),
+                       frame_buffer_.size() * sizeof(audio::sample_t));
+
+                audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
+                streams_[n]->process(frame, now);
+            }
+
+            n_frames_++;
+            next_frame += config_.frame_length;
+
+            now = core::timestamp(core::ClockMonotonic);
+
+            // If we're more than a frame behind, we can't sustain requested
+            // number of streams; skip missed frames instead of bursting them.
+            if (now >= next_frame + config_.frame_length) {
+                n_overruns_++;
+                next_frame = now;
+            }
+        }
+
+        core::nanoseconds_t wakeup_time = next_frame;
+
+        for (size_t n = 0; n < streams_.size(); n++) {
+            const core::nanoseconds_t send_time = streams_[n]->flush(now);
+            if (send_time != 0 && send_time < wakeup_time) {
+                wakeup_time = send_time;
+            }
+        }
+
+        if (now - last_report_ >= config_.report_interval) {
+            report_(now - start_time, false);
+            last_report_ = now;
+        }
+
+        if (wakeup_time > now) {
+            core::sleep_until(core::ClockMonotonic, wakeup_time);
+        }
+    }
+
+    report_(core::timestamp(core::ClockMonotonic) - start_time, true);
+}
+
+void Generator::generate_frame_() {
+    const audio::SampleSpec& spec = sink_config_.input_sample_spec;
+
+    const size_t num_chans = spec.num_channels();
+    const size_t sample_rate = spec.sample_rate();
+
+    audio::sample_t* samples = frame_template_.data();
+
+    for (size_t ns = 0; ns < frame_template_.size() / num_chans; ns++) {
+        const audio::sample_t s = (audio::sample_t)(
+            SineAmplitude * sin(2 * M_PI * SineFreq * sine_pos_ / sample_rate));
+
+        for (size_t nc = 0; nc < num_chans; nc++) {
+            *samples++ = s;
+        }
+
+        if (++sine_pos_ == sample_rate) {
+            sine_pos_ = 0;
+        }
+    }
+}
+
+void Generator::collect_totals_(Totals& totals) {
+    for (size_t n = 0; n < streams_.size(); n++) {
+        const StreamStats& stats = streams_[n]->stats();
+
+        totals.stats.generated_packets += stats.generated_packets;
+        totals.stats.sent_packets += stats.sent_packets;
+        totals.stats.lost_packets += stats.lost_packets;
+        totals.stats.duplicated_packets += stats.duplicated_packets;
+        totals.stats.failed_packets += stats.failed_packets;
+
+        const StreamFeedback feedback = streams_[n]->feedback();
+        if (!feedback.has_report) {
+            continue;
+        }
+
+        totals.n_reports++;
+        totals.rx_expected += feedback.expected_packets;
+        totals.rx_lost += feedback.lost_packets;
+        totals.rx_jitter_sum += feedback.jitter;
+        totals.rx_jitter_max = std::max(totals.rx_jitter_max, feedback.jitter);
+        totals.rx_e2e_sum += feedback.e2e_latency;
+        totals.rx_e2e_max = std::max(totals.rx_e2e_max, feedback.e2e_latency);
+    }
+}
+
+void Generator::report_(core::nanoseconds_t elapsed, bool is_final) {
+    Totals totals;
+    collect_totals_(totals);
+
+    const core::nanoseconds_t interval =
+        is_final ? elapsed : core::timestamp(core::ClockMonotonic) - last_report_;
+
+    const uint64_t sent =
+        is_final ? totals.stats.sent_packets : totals.stats.sent_packets - last_sent_;
+
+    last_sent_ = totals.stats.sent_packets;
+
+    printf("%s%.1fs: streams=%lu frames=%llu overruns=%llu"
+           " rate=%.0fpps sent=%llu failed=%llu lost=%.2f%% dup=%.2f%%",
+           is_final ? "total " : "", (double)elapsed / core::Second,
+           (unsigned long)streams_.size(), (unsigned long long)n_frames_,
+           (unsigned long long)n_overruns_,
+           interval > 0 ? (double)sent / interval * core::Second : 0.,
+           (unsigned long long)totals.stats.sent_packets,
+           (unsigned long long)totals.stats.failed_packets,
+           percent(totals.stats.lost_packets, totals.stats.generated_packets),
+           percent(totals.stats.duplicated_packets, totals.stats.generated_packets));
+
+    if (totals.n_reports != 0) {
+        printf(" | rx_reports=%lu/%lu rx_loss=%.2f%%"
+               " rx_jitter=%.2f/%.2fms rx_e2e=%.2f/%.2fms",
+               (unsigned long)totals.n_reports, (unsigned long)streams_.size(),
+               percent(totals.rx_lost > 0 ? (uint64_t)totals.rx_lost : 0,
+                       totals.rx_expected),
+               ns_2_ms(totals.rx_jitter_sum / (core::nanoseconds_t)totals.n_reports),
+               ns_2_ms(totals.rx_jitter_max),
+               ns_2_ms(totals.rx_e2e_sum / (core::nanoseconds_t)totals.n_reports),
+               ns_2_ms(totals.rx_e2e_max));
+    }
+
+    printf("\n");
+    fflush(stdout);
+}
+
+} // namespace loadgen
+} // namespace roc
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_loadgen/generator.h
+//! @brief Load generator.
+
+#ifndef ROC_LOADGEN_GENERATOR_H_
+#define ROC_LOADGEN_GENERATOR_H_
+
+#include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_loadgen/impairment.h"
+#include "roc_loadgen/stream.h"
+#include "roc_node/context.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace loadgen {
+
+//! Load generator parameters.
+struct GeneratorConfig {
+    //! Number of streams.
+    size_t num_streams;
+
+    //! Duration of generated frames.
+    core::nanoseconds_t frame_length;
+
+    //! How long to run, or zero to run forever.
+    core::nanoseconds_t duration;
+
+    //! How often to print statistics.
+    core::nanoseconds_t report_interval;
+
+    GeneratorConfig()
+        : num_streams(1)
+        , frame_length(10 * core::Millisecond)
+        , duration(0)
+        , report_interval(core::Second) {
+    }
+};
+
+//! Load generator.
+//!
+//! @remarks
+//!  Runs given number of streams from a single thread. Every frame period,
+//!  generates one frame of sine wave, writes it to every stream, and sends
+//!  produced packets, so the total packet rate grows linearly with the number
+//!  of streams. Periodically prints what was sent and what receiver reported
+//!  back via control endpoint.
+class Generator : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Generator(node::Context& context,
+              const pipeline::SenderSinkConfig& sink_config,
+              const ImpairmentConfig& impairment_config,
+              const GeneratorConfig& generator_config);
+
+    ~Generator();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Create streams and connect them to receiver.
+    //! @p endpoints is indexed by address::Interface.
+    ROC_ATTR_NODISCARD bool open(const Endpoint* endpoints);
+
+    //! Run until duration expires.
+    //! @remarks
+    //!  Never returns if duration is zero.
+    void run();
+
+private:
+    struct Totals {
+        StreamStats stats;
+
+        size_t n_reports;
+        uint64_t rx_expected;
+        int64_t rx_lost;
+        core::nanoseconds_t rx_jitter_sum;
+        core::nanoseconds_t rx_jitter_max;
+        core::nanoseconds_t rx_e2e_sum;
+        core::nanoseconds_t rx_e2e_max;
+
+        Totals()
+            : n_reports(0)
+            , rx_expected(0)
+            , rx_lost(0)
+            , rx_jitter_sum(0)
+            , rx_jitter_max(0)
+            , rx_e2e_sum(0)
+            , rx_e2e_max(0) {
+        }
+    };
+
+    void generate_frame_();
+    void collect_totals_(Totals& totals);
+    void report_(core::nanoseconds_t elapsed, bool is_final);
+
+    node::Context& context_;
+
+    const pipeline::SenderSinkConfig sink_config_;
+    const ImpairmentConfig impairment_config_;
+    const GeneratorConfig config_;
+
+    core::Array<Stream*> streams_;
+
+    core::Array<audio::sample_t> frame_template_;
+    core::Array<audio::sample_t> frame_buffer_;
+    size_t sine_pos_;
+
+    uint64_t n_frames_;
+    uint64_t n_overruns_;
+
+    uint64_t last_sent_;
+    core::nanoseconds_t last_report_;
+
+    bool valid_;
+};
+
+} // namespace loadgen
+} // namespace roc
+
+#endif // ROC_LOADGEN_GENERATOR_H_
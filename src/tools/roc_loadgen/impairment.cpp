@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_loadgen/impairment.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace loadgen {
+
+Impairment::Impairment(const ImpairmentConfig& config)
+    : config_(config)
+    , p_good_to_bad_(0)
+    , p_bad_to_good_(1)
+    , bad_state_(false) {
+    roc_panic_if_msg(config.loss < 0 || config.loss >= 1,
+                     "impairment: loss should be in range [0; 1)");
+    roc_panic_if_msg(config.loss_burst < 1, "impairment: loss burst should be >= 1");
+
+    // Average burst length is 1/r, and stationary loss rate is p/(p+r).
+    p_bad_to_good_ = 1. / config.loss_burst;
+    p_good_to_bad_ = config.loss * p_bad_to_good_ / (1. - config.loss);
+
+    if (p_good_to_bad_ > 1) {
+        p_good_to_bad_ = 1;
+    }
+}
+
+size_t Impairment::apply(core::nanoseconds_t delays[MaxCopies]) {
+    if (lose_()) {
+        return 0;
+    }
+
+    size_t n_copies = happens_(config_.duplicate) ? 2 : 1;
+
+    for (size_t n = 0; n < n_copies; n++) {
+        delays[n] = delay_();
+    }
+
+    return n_copies;
+}
+
+bool Impairment::lose_() {
+    if (config_.loss == 0) {
+        return false;
+    }
+
+    if (bad_state_) {
+        bad_state_ = !happens_(p_bad_to_good_);
+    } else {
+        bad_state_ = happens_(p_good_to_bad_);
+    }
+
+    return bad_state_;
+}
+
+core::nanoseconds_t Impairment::delay_() {
+    if (config_.delay == 0 && config_.jitter == 0) {
+        return 0;
+    }
+
+    if (happens_(config_.reorder)) {
+        return 0;
+    }
+
+    core::nanoseconds_t delay = config_.delay;
+
+    if (config_.jitter != 0) {
+        delay += (core::nanoseconds_t)(core::fast_random_gaussian() * config_.jitter);
+    }
+
+    return delay > 0 ? delay : 0;
+}
+
+bool Impairment::happens_(double probability) {
+    if (probability <= 0) {
+        return false;
+    }
+
+    return core::fast_random_range(0, 1000000 - 1) < probability * 1000000;
+}
+
+} // namespace loadgen
+} // namespace roc
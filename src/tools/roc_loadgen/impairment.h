@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_loadgen/impairment.h
+//! @brief Network impairment model.
+
+#ifndef ROC_LOADGEN_IMPAIRMENT_H_
+#define ROC_LOADGEN_IMPAIRMENT_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace loadgen {
+
+//! Impairment parameters.
+//! Semantics follow Linux netem qdisc.
+struct ImpairmentConfig {
+    //! Probability of packet loss, 0..1.
+    double loss;
+
+    //! Average length of loss burst, in packets.
+    //! 1 means independent losses.
+    double loss_burst;
+
+    //! Delay added to every packet.
+    core::nanoseconds_t delay;
+
+    //! Standard deviation of random delay variation.
+    core::nanoseconds_t jitter;
+
+    //! Probability that packet is sent immediately, bypassing delay, 0..1.
+    //! Has effect only if delay or jitter is set.
+    double reorder;
+
+    //! Probability that packet is sent twice, 0..1.
+    double duplicate;
+
+    ImpairmentConfig()
+        : loss(0)
+        , loss_burst(1)
+        , delay(0)
+        , jitter(0)
+        , reorder(0)
+        , duplicate(0) {
+    }
+};
+
+//! Network impairment model.
+//!
+//! @remarks
+//!  Decides fate of each packet: whether it's lost, duplicated, and how much
+//!  it's delayed. Bursty losses use two-state Gilbert model: average loss rate
+//!  is @c loss, and average length of consecutive losses is @c loss_burst.
+class Impairment : public core::NonCopyable<> {
+public:
+    //! Maximum number of copies of one packet.
+    enum { MaxCopies = 2 };
+
+    //! Initialize.
+    explicit Impairment(const ImpairmentConfig& config);
+
+    //! Apply impairment to next packet.
+    //! @returns
+    //!  number of copies to send (zero if packet is lost), and fills
+    //!  @p delays with delay of each copy.
+    size_t apply(core::nanoseconds_t delays[MaxCopies]);
+
+private:
+    bool lose_();
+    core::nanoseconds_t delay_();
+
+    static bool happens_(double probability);
+
+    const ImpairmentConfig config_;
+
+    // Gilbert model transition probabilities.
+    double p_good_to_bad_;
+    double p_bad_to_good_;
+    bool bad_state_;
+};
+
+} // namespace loadgen
+} // namespace roc
+
+#endif // ROC_LOADGEN_IMPAIRMENT_H_
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_address/endpoint_uri.h"
+#include "roc_address/protocol_map.h"
+#include "roc_core/crash_handler.h"
+#include "roc_core/heap_arena.h"
+#include "roc_core/log.h"
+#include "roc_core/parse_units.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_core/time.h"
+#include "roc_loadgen/generator.h"
+#include "roc_loadgen/impairment.h"
+#include "roc_loadgen/stream.h"
+#include "roc_netio/network_loop.h"
+#include "roc_node/context.h"
+#include "roc_packet/packet.h"
+#include "roc_pipeline/config.h"
+
+#include "roc_loadgen/cmdline.h"
+
+using namespace roc;
+
+namespace {
+
+bool parse_endpoint(node::Context& context,
+                    const char* option,
+                    const char* uri_str,
+                    address::Interface iface,
+                    loadgen::Endpoint& endpoint) {
+    address::EndpointUri uri(context.arena());
+    if (!address::parse_endpoint_uri(uri_str, address::EndpointUri::Subset_Full, uri)) {
+        roc_log(LogError, "can't parse --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    const address::ProtocolAttrs* attrs =
+        address::ProtocolMap::instance().find_by_id(uri.proto());
+    if (!attrs || attrs->iface != iface) {
+        roc_log(LogError, "invalid --%s endpoint: protocol is not supported for %s",
+                option, address::interface_to_str(iface));
+        return false;
+    }
+
+    netio::NetworkLoop::Tasks::ResolveEndpointAddress resolve_task(uri);
+    if (!context.network_loop().schedule_and_wait(resolve_task)) {
+        roc_log(LogError, "can't resolve --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    endpoint.proto = uri.proto();
+    endpoint.address = resolve_task.get_address();
+
+    return true;
+}
+
+bool parse_percent(const char* option, double value, double& result) {
+    if (value < 0 || value >= 100) {
+        roc_log(LogError, "invalid --%s: should be in range [0; 100)", option);
+        return false;
+    }
+    result = value / 100;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    core::HeapArena::set_guards(core::HeapArena_DefaultGuards
+                                | core::HeapArena_LeakGuard);
+
+    core::HeapArena heap_arena;
+
+    core::CrashHandler crash_handler;
+
+    gengetopt_args_info args;
+
+    const int code = cmdline_parser(argc, argv, &args);
+    if (code != 0) {
+        return code;
+    }
+
+    core::ScopedPtr<gengetopt_args_info, core::CustomAllocation> args_holder(
+        &args, &cmdline_parser_free);
+
+    core::Logger::instance().set_verbosity(args.verbose_given);
+
+    switch (args.color_arg) {
+    case color_arg_auto:
+        core::Logger::instance().set_colors(core::ColorsAuto);
+        break;
+    case color_arg_always:
+        core::Logger::instance().set_colors(core::ColorsEnabled);
+        break;
+    case color_arg_never:
+        core::Logger::instance().set_colors(core::ColorsDisabled);
+        break;
+    default:
+        break;
+    }
+
+    loadgen::GeneratorConfig generator_config;
+
+    if (args.streams_arg <= 0) {
+        roc_log(LogError, "invalid --streams: should be > 0");
+        return 1;
+    }
+    generator_config.num_streams = (size_t)args.streams_arg;
+
+    if (args.duration_given) {
+        if (!core::parse_duration(args.duration_arg, generator_config.duration)) {
+            roc_log(LogError, "invalid --duration: bad format");
+            return 1;
+        }
+        if (generator_config.duration <= 0) {
+            roc_log(LogError, "invalid --duration: should be > 0");
+            return 1;
+        }
+    }
+
+    if (!core::parse_duration(args.report_interval_arg,
+                              generator_config.report_interval)) {
+        roc_log(LogError, "invalid --report-interval: bad format");
+        return 1;
+    }
+    if (generator_config.report_interval <= 0) {
+        roc_log(LogError, "invalid --report-interval: should be > 0");
+        return 1;
+    }
+
+    if (args.frame_len_given) {
+        if (!core::parse_duration(args.frame_len_arg, generator_config.frame_length)) {
+            roc_log(LogError, "invalid --frame-len: bad format");
+            return 1;
+        }
+        if (generator_config.frame_length <= 0) {
+            roc_log(LogError, "invalid --frame-len: should be > 0");
+            return 1;
+        }
+    }
+
+    loadgen::ImpairmentConfig impairment_config;
+
+    if (!parse_percent("loss", args.loss_arg, impairment_config.loss)) {
+        return 1;
+    }
+
+    if (args.loss_burst_arg < 1) {
+        roc_log(LogError, "invalid --loss-burst: should be >= 1");
+        return 1;
+    }
+    impairment_config.loss_burst = args.loss_burst_arg;
+
+    if (args.delay_given) {
+        if (!core::parse_duration(args.delay_arg, impairment_config.delay)) {
+            roc_log(LogError, "invalid --delay: bad format");
+            return 1;
+        }
+        if (impairment_config.delay < 0) {
+            roc_log(LogError, "invalid --delay: should be >= 0");
+            return 1;
+        }
+    }
+
+    if (args.jitter_given) {
+        if (!core::parse_duration(args.jitter_arg, impairment_config.jitter)) {
+            roc_log(LogError, "invalid --jitter: bad format");
+            return 1;
+        }
+        if (impairment_config.jitter < 0) {
+            roc_log(LogError, "invalid --jitter: should be >= 0");
+            return 1;
+        }
+    }
+
+    if (!parse_percent("reorder", args.reorder_arg, impairment_config.reorder)) {
+        return 1;
+    }
+
+    if (!parse_percent("duplicate", args.duplicate_arg, impairment_config.duplicate)) {
+        return 1;
+    }
+
+    pipeline::SenderSinkConfig sender_config;
+
+    // Generator paces frames by itself.
+    sender_config.enable_timing = false;
+    sender_config.enable_auto_duration = true;
+    sender_config.enable_auto_cts = true;
+
+    if (args.rate_given) {
+        if (args.rate_arg <= 0) {
+            roc_log(LogError, "invalid --rate: should be > 0");
+            return 1;
+        }
+        sender_config.input_sample_spec.set_sample_rate((size_t)args.rate_arg);
+    }
+
+    if (args.packet_len_given) {
+        if (!core::parse_duration(args.packet_len_arg, sender_config.packet_length)) {
+            roc_log(LogError, "invalid --packet-len: bad format");
+            return 1;
+        }
+        if (sender_config.packet_length <= 0) {
+            roc_log(LogError, "invalid --packet-len: should be > 0");
+            return 1;
+        }
+    }
+
+    {
+        address::EndpointUri source_endpoint(heap_arena);
+        if (!address::parse_endpoint_uri(
+                args.source_arg, address::EndpointUri::Subset_Full, source_endpoint)) {
+            roc_log(LogError, "can't parse --source endpoint: %s", args.source_arg);
+            return 1;
+        }
+
+        const address::ProtocolAttrs* source_attrs =
+            address::ProtocolMap::instance().find_by_id(source_endpoint.proto());
+        if (source_attrs) {
+            sender_config.fec_encoder.scheme = source_attrs->fec_scheme;
+        }
+    }
+
+    if (sender_config.fec_encoder.scheme != packet::FEC_None && !args.repair_given) {
+        roc_log(LogError,
+                "incomplete configuration:"
+                " FEC is implied by --source protocol, but --repair is missing");
+        return 1;
+    }
+
+    if (args.nbsrc_given) {
+        if (sender_config.fec_encoder.scheme == packet::FEC_None) {
+            roc_log(LogError, "--nbsrc can't be used when fec is disabled");
+            return 1;
+        }
+        if (args.nbsrc_arg <= 0) {
+            roc_log(LogError, "invalid --nbsrc: should be > 0");
+            return 1;
+        }
+        sender_config.fec_writer.n_source_packets = (size_t)args.nbsrc_arg;
+    }
+
+    if (args.nbrpr_given) {
+        if (sender_config.fec_encoder.scheme == packet::FEC_None) {
+            roc_log(LogError, "--nbrpr can't be used when fec is disabled");
+            return 1;
+        }
+        if (args.nbrpr_arg <= 0) {
+            roc_log(LogError, "invalid --nbrpr: should be > 0");
+            return 1;
+        }
+        sender_config.fec_writer.n_repair_packets = (size_t)args.nbrpr_arg;
+    }
+
+    node::ContextConfig context_config;
+
+    if (args.network_threads_arg <= 0) {
+        roc_log(LogError, "invalid --network-threads: should be > 0");
+        return 1;
+    }
+    context_config.network_threads = (size_t)args.network_threads_arg;
+
+    const audio::SampleSpec& sample_spec = sender_config.input_sample_spec;
+
+    context_config.max_frame_size =
+        std::max(context_config.max_frame_size,
+                 sample_spec.ns_2_bytes(generator_config.frame_length));
+    context_config.max_packet_size =
+        std::max(context_config.max_packet_size,
+                 packet::Packet::approx_size(
+                     sample_spec.ns_2_samples_overall(sender_config.packet_length)));
+
+    node::Context context(context_config, heap_arena);
+    if (!context.is_valid()) {
+        roc_log(LogError, "can't initialize node context");
+        return 1;
+    }
+
+    loadgen::Endpoint endpoints[address::Iface_Max];
+
+    if (!parse_endpoint(context, "source", args.source_arg, address::Iface_AudioSource,
+                        endpoints[address::Iface_AudioSource])) {
+        return 1;
+    }
+
+    if (args.repair_given) {
+        if (!parse_endpoint(context, "repair", args.repair_arg,
+                            address::Iface_AudioRepair,
+                            endpoints[address::Iface_AudioRepair])) {
+            return 1;
+        }
+    }
+
+    if (args.control_given) {
+        if (!parse_endpoint(context, "control", args.control_arg,
+                            address::Iface_AudioControl,
+                            endpoints[address::Iface_AudioControl])) {
+            return 1;
+        }
+    }
+
+    loadgen::Generator generator(context, sender_config, impairment_config,
+                                 generator_config);
+    if (!generator.is_valid()) {
+        roc_log(LogError, "can't create generator");
+        return 1;
+    }
+
+    if (!generator.open(endpoints)) {
+        roc_log(LogError, "can't open streams");
+        return 1;
+    }
+
+    generator.run();
+
+    return 0;
+}
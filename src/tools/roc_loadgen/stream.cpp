@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_loadgen/stream.h"
+#include "roc_address/socket_addr_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_status/code_to_str.h"
+
+namespace roc {
+namespace loadgen {
+
+Stream::Stream(node::Context& context,
+               const pipeline::SenderSinkConfig& sink_config,
+               const ImpairmentConfig& impairment_config)
+    : network_loop_(context.select_network_loop())
+    , encoder_(context, sink_config)
+    , impairment_(impairment_config)
+    , port_(NULL)
+    , port_writer_(NULL)
+    , delayed_(context.arena())
+    , valid_(false) {
+    if (!encoder_.is_valid()) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+Stream::~Stream() {
+    close();
+}
+
+bool Stream::is_valid() const {
+    return valid_;
+}
+
+bool Stream::open(const Endpoint* endpoints) {
+    roc_panic_if(!is_valid());
+    roc_panic_if(port_);
+
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        endpoints_[iface] = endpoints[iface];
+
+        if (endpoints_[iface].proto == address::Proto_None) {
+            continue;
+        }
+
+        if (!encoder_.activate((address::Interface)iface, endpoints_[iface].proto)) {
+            roc_log(LogError, "stream: can't activate %s interface",
+                    address::interface_to_str((address::Interface)iface));
+            return false;
+        }
+    }
+
+    const address::SocketAddr& source_addr =
+        endpoints_[address::Iface_AudioSource].address;
+
+    if (!port_config_.bind_address.set_host_port(
+            source_addr.family(),
+            source_addr.family() == address::Family_IPv6 ? "::" : "0.0.0.0", 0)) {
+        roc_log(LogError, "stream: can't set bind address");
+        return false;
+    }
+
+    port_config_.enable_non_blocking = true;
+
+    netio::NetworkLoop::Tasks::AddUdpPort add_task(port_config_);
+    if (!network_loop_.schedule_and_wait(add_task)) {
+        roc_log(LogError, "stream: can't add udp port");
+        return false;
+    }
+    port_ = add_task.get_handle();
+
+    netio::NetworkLoop::Tasks::StartUdpSend send_task(port_);
+    if (!network_loop_.schedule_and_wait(send_task)) {
+        roc_log(LogError, "stream: can't start sending on udp port");
+        return false;
+    }
+    port_writer_ = &send_task.get_outbound_writer();
+
+    if (endpoints_[address::Iface_AudioControl].proto != address::Proto_None) {
+        // Receiver sends reports to the address from which it receives reports,
+        // i.e. to our port.
+        netio::NetworkLoop::Tasks::StartUdpRecv recv_task(port_, *this);
+        if (!network_loop_.schedule_and_wait(recv_task)) {
+            roc_log(LogError, "stream: can't start receiving on udp port");
+            return false;
+        }
+    }
+
+    roc_log(LogDebug, "stream: opened port: bind_address=%s",
+            address::socket_addr_to_str(port_config_.bind_address).c_str());
+
+    return true;
+}
+
+void Stream::close() {
+    if (!port_) {
+        return;
+    }
+
+    netio::NetworkLoop::Tasks::RemovePort remove_task(port_);
+    if (!network_loop_.schedule_and_wait(remove_task)) {
+        roc_log(LogError, "stream: can't remove udp port");
+    }
+
+    port_ = NULL;
+    port_writer_ = NULL;
+}
+
+void Stream::process(audio::Frame& frame, core::nanoseconds_t now) {
+    roc_panic_if(!port_writer_);
+
+    encoder_.sink().write(frame);
+
+    read_packets_(address::Iface_AudioSource, now);
+    read_packets_(address::Iface_AudioRepair, now);
+    read_packets_(address::Iface_AudioControl, now);
+}
+
+core::nanoseconds_t Stream::flush(core::nanoseconds_t now) {
+    size_t n_sent = 0;
+
+    while (n_sent < delayed_.size() && delayed_[n_sent].send_time <= now) {
+        send_packet_(delayed_[n_sent].packet);
+        n_sent++;
+    }
+
+    if (n_sent != 0) {
+        for (size_t n = n_sent; n < delayed_.size(); n++) {
+            delayed_[n - n_sent] = delayed_[n];
+        }
+        if (!delayed_.resize(delayed_.size() - n_sent)) {
+            roc_panic("stream: can't shrink array");
+        }
+    }
+
+    return delayed_.size() != 0 ? delayed_[0].send_time : 0;
+}
+
+const StreamStats& Stream::stats() const {
+    return stats_;
+}
+
+StreamFeedback Stream::feedback() {
+    if (endpoints_[address::Iface_AudioControl].proto != address::Proto_None) {
+        if (!encoder_.get_metrics(NULL, NULL, &party_metrics_cb_, &feedback_)) {
+            roc_log(LogError, "stream: can't get encoder metrics");
+        }
+    }
+
+    return feedback_;
+}
+
+status::StatusCode Stream::write(const packet::PacketPtr& packet) {
+    return encoder_.write_packet(address::Iface_AudioControl, packet);
+}
+
+void Stream::read_packets_(address::Interface iface, core::nanoseconds_t now) {
+    if (endpoints_[iface].proto == address::Proto_None) {
+        return;
+    }
+
+    packet::PacketPtr packets[MaxBatch];
+
+    for (;;) {
+        size_t n_packets = 0;
+
+        const status::StatusCode code =
+            encoder_.read_packets(iface, packets, MaxBatch, n_packets);
+
+        if (code == status::StatusNoData) {
+            break;
+        }
+        if (code != status::StatusOK) {
+            roc_log(LogError, "stream: can't read packets from encoder: status=%s",
+                    status::code_to_str(code));
+            break;
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            if (!packets[n]->has_flags(packet::Packet::FlagUDP)) {
+                packets[n]->add_flags(packet::Packet::FlagUDP);
+            }
+            packets[n]->udp()->src_addr = port_config_.bind_address;
+            packets[n]->udp()->dst_addr = endpoints_[iface].address;
+
+            if (iface == address::Iface_AudioControl) {
+                // Impairment and counters cover media packets only.
+                if (port_writer_->write(packets[n]) != status::StatusOK) {
+                    roc_log(LogDebug, "stream: can't send control packet");
+                }
+                continue;
+            }
+
+            stats_.generated_packets++;
+
+            core::nanoseconds_t delays[Impairment::MaxCopies];
+            const size_t n_copies = impairment_.apply(delays);
+
+            if (n_copies == 0) {
+                stats_.lost_packets++;
+                continue;
+            }
+
+            stats_.duplicated_packets += n_copies - 1;
+
+            for (size_t n_copy = 0; n_copy < n_copies; n_copy++) {
+                // Port queues are intrusive, so every copy needs its own packet.
+                packet::PacketPtr pp =
+                    n_copy == 0 ? packets[n] : copy_packet_(packets[n]);
+                if (!pp) {
+                    stats_.failed_packets++;
+                    continue;
+                }
+
+                if (delays[n_copy] == 0) {
+                    send_packet_(pp);
+                } else {
+                    delay_packet_(pp, now + delays[n_copy]);
+                }
+            }
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            packets[n] = NULL;
+        }
+
+        if (n_packets < MaxBatch) {
+            break;
+        }
+    }
+}
+
+void Stream::delay_packet_(const packet::PacketPtr& packet,
+                           core::nanoseconds_t send_time) {
+    DelayedPacket dp;
+    dp.send_time = send_time;
+    dp.packet = packet;
+
+    if (!delayed_.push_back(dp)) {
+        roc_log(LogError, "stream: can't allocate delayed packet");
+        stats_.failed_packets++;
+        return;
+    }
+
+    // Keep array sorted by send time.
+    size_t pos = delayed_.size() - 1;
+    while (pos > 0 && delayed_[pos - 1].send_time > send_time) {
+        delayed_[pos] = delayed_[pos - 1];
+        pos--;
+    }
+    delayed_[pos] = dp;
+}
+
+packet::PacketPtr Stream::copy_packet_(const packet::PacketPtr& packet) {
+    packet::PacketPtr pp = encoder_.packet_factory().new_packet();
+    if (!pp) {
+        roc_log(LogError, "stream: can't allocate packet");
+        return NULL;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->src_addr = packet->udp()->src_addr;
+    pp->udp()->dst_addr = packet->udp()->dst_addr;
+    pp->set_buffer(packet->buffer());
+
+    return pp;
+}
+
+void Stream::send_packet_(const packet::PacketPtr& packet) {
+    const status::StatusCode code = port_writer_->write(packet);
+
+    if (code != status::StatusOK) {
+        stats_.failed_packets++;
+        return;
+    }
+
+    stats_.sent_packets++;
+}
+
+void Stream::party_metrics_cb_(const pipeline::SenderParticipantMetrics& metrics,
+                               size_t,
+                               void* arg) {
+    StreamFeedback& feedback = *(StreamFeedback*)arg;
+
+    feedback.has_report = true;
+    feedback.expected_packets = metrics.link.total_packets;
+    feedback.lost_packets = metrics.link.lost_packets;
+    feedback.jitter = metrics.link.jitter;
+    feedback.e2e_latency = metrics.latency.e2e_latency;
+}
+
+} // namespace loadgen
+} // namespace roc
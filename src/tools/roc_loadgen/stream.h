@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_loadgen/stream.h
+//! @brief Synthetic sender stream.
+
+#ifndef ROC_LOADGEN_STREAM_H_
+#define ROC_LOADGEN_STREAM_H_
+
+#include "roc_address/interface.h"
+#include "roc_address/protocol.h"
+#include "roc_address/socket_addr.h"
+#include "roc_audio/frame.h"
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/time.h"
+#include "roc_loadgen/impairment.h"
+#include "roc_netio/network_loop.h"
+#include "roc_node/context.h"
+#include "roc_node/sender_encoder.h"
+#include "roc_packet/iwriter.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace loadgen {
+
+//! Remote endpoint of receiver under test.
+struct Endpoint {
+    //! Endpoint protocol, or Proto_None if not used.
+    address::Protocol proto;
+
+    //! Resolved endpoint address.
+    address::SocketAddr address;
+
+    Endpoint()
+        : proto(address::Proto_None) {
+    }
+};
+
+//! Stream counters.
+//! Cover source and repair packets, but not control packets.
+struct StreamStats {
+    //! Packets produced by encoder.
+    uint64_t generated_packets;
+
+    //! Packets passed to network, including duplicates.
+    uint64_t sent_packets;
+
+    //! Packets dropped by impairment model.
+    uint64_t lost_packets;
+
+    //! Extra copies added by impairment model.
+    uint64_t duplicated_packets;
+
+    //! Packets which network port refused to send.
+    uint64_t failed_packets;
+
+    StreamStats()
+        : generated_packets(0)
+        , sent_packets(0)
+        , lost_packets(0)
+        , duplicated_packets(0)
+        , failed_packets(0) {
+    }
+};
+
+//! Receiver feedback for stream.
+//! Available only if control endpoint is used.
+struct StreamFeedback {
+    //! Whether receiver reported anything yet.
+    bool has_report;
+
+    //! Cumulative count of packets expected by receiver.
+    uint64_t expected_packets;
+
+    //! Cumulative count of packets lost, as reported by receiver.
+    int64_t lost_packets;
+
+    //! Packet jitter, as reported by receiver.
+    core::nanoseconds_t jitter;
+
+    //! End-to-end latency, as reported by receiver.
+    core::nanoseconds_t e2e_latency;
+
+    StreamFeedback()
+        : has_report(false)
+        , expected_packets(0)
+        , lost_packets(0)
+        , jitter(0)
+        , e2e_latency(0) {
+    }
+};
+
+//! Synthetic sender stream.
+//!
+//! @remarks
+//!  Contains sender encoder and UDP port. Frames written to stream are encoded
+//!  into packets, packets are passed through impairment model and then sent
+//!  to receiver endpoints. Feedback from receiver is passed back to encoder.
+//!
+//! @remarks
+//!  Every stream uses its own port for all interfaces. Receiver routes repair
+//!  packets of some FEC schemes by sender address, so streams can't share
+//!  a port. Streams are distributed between network loops of the context.
+class Stream : private packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Stream(node::Context& context,
+           const pipeline::SenderSinkConfig& sink_config,
+           const ImpairmentConfig& impairment_config);
+
+    ~Stream();
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Activate interfaces and open port.
+    //! @p endpoints is indexed by address::Interface.
+    ROC_ATTR_NODISCARD bool open(const Endpoint* endpoints);
+
+    //! Close port.
+    void close();
+
+    //! Encode frame and schedule produced packets.
+    void process(audio::Frame& frame, core::nanoseconds_t now);
+
+    //! Send packets which delay expired.
+    //! @returns
+    //!  time when next packet should be sent, or zero if there are
+    //!  no delayed packets.
+    core::nanoseconds_t flush(core::nanoseconds_t now);
+
+    //! Get counters.
+    const StreamStats& stats() const;
+
+    //! Get receiver feedback.
+    StreamFeedback feedback();
+
+private:
+    struct DelayedPacket {
+        core::nanoseconds_t send_time;
+        packet::PacketPtr packet;
+
+        DelayedPacket()
+            : send_time(0) {
+        }
+    };
+
+    enum { MaxBatch = 16, MaxDelayed = 64 };
+
+    // Receives packets from network port.
+    virtual ROC_ATTR_NODISCARD status::StatusCode write(const packet::PacketPtr& packet);
+
+    void read_packets_(address::Interface iface, core::nanoseconds_t now);
+    void delay_packet_(const packet::PacketPtr& packet, core::nanoseconds_t send_time);
+    packet::PacketPtr copy_packet_(const packet::PacketPtr& packet);
+    void send_packet_(const packet::PacketPtr& packet);
+
+    static void party_metrics_cb_(const pipeline::SenderParticipantMetrics& metrics,
+                                  size_t index,
+                                  void* arg);
+
+    netio::NetworkLoop& network_loop_;
+
+    node::SenderEncoder encoder_;
+    Impairment impairment_;
+
+    Endpoint endpoints_[address::Iface_Max];
+
+    netio::UdpConfig port_config_;
+    netio::NetworkLoop::PortHandle port_;
+    packet::IWriter* port_writer_;
+
+    core::Array<DelayedPacket, MaxDelayed> delayed_;
+
+    StreamStats stats_;
+    StreamFeedback feedback_;
+
+    bool valid_;
+};
+
+} // namespace loadgen
+} // namespace roc
+
+#endif // ROC_LOADGEN_STREAM_H_
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_recv/benchmark.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/packet.h"
+#include "roc_status/code_to_str.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace roc {
+namespace recv {
+
+namespace {
+
+const double SineFreq = 440;
+const double SineAmplitude = 0.5;
+
+} // namespace
+
+Benchmark::Benchmark(node::Context& context,
+                     const pipeline::SenderSinkConfig& encoder_config,
+                     const pipeline::ReceiverSourceConfig& receiver_config,
+                     const BenchmarkConfig& config)
+    : encoder_(context, encoder_config)
+    , decoder_(context, receiver_config)
+    , config_(config)
+    , encoder_spec_(encoder_config.input_sample_spec)
+    , lead_(deduce_lead_(receiver_config))
+    , encode_buffer_(context.arena())
+    , decode_buffer_(context.arena())
+    , sine_pos_(0)
+    , processed_time_(0)
+    , elapsed_time_(0)
+    , valid_(false) {
+    roc_panic_if_msg(config_.frame_length <= 0, "benchmark: frame length is zero");
+    roc_panic_if_msg(config_.duration <= 0, "benchmark: duration is zero");
+    roc_panic_if_msg(config_.headroom < 0 || config_.headroom >= 1,
+                     "benchmark: headroom out of range");
+    roc_panic_if_msg(!encoder_spec_.is_raw(), "benchmark: encoder spec is not raw");
+
+    for (size_t n = 0; n < address::Iface_Max; n++) {
+        active_[n] = false;
+    }
+
+    if (!encoder_.is_valid()) {
+        roc_log(LogError, "benchmark: can't create sender encoder");
+        return;
+    }
+
+    if (!decoder_.is_valid()) {
+        roc_log(LogError, "benchmark: can't create receiver decoder");
+        return;
+    }
+
+    const size_t encode_size = encoder_spec_.ns_2_samples_overall(config_.frame_length);
+    const size_t decode_size =
+        receiver_config.common.output_sample_spec.ns_2_samples_overall(
+            config_.frame_length);
+
+    if (encode_size == 0 || decode_size == 0) {
+        roc_log(LogError, "benchmark: frame length is too small");
+        return;
+    }
+
+    if (!encode_buffer_.resize(encode_size) || !decode_buffer_.resize(decode_size)) {
+        roc_log(LogError, "benchmark: can't allocate frame buffers");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Benchmark::is_valid() const {
+    return valid_;
+}
+
+bool Benchmark::activate(address::Interface iface, address::Protocol proto) {
+    roc_panic_if(!is_valid());
+
+    if (!encoder_.activate(iface, proto)) {
+        roc_log(LogError, "benchmark: can't activate %s interface of encoder",
+                address::interface_to_str(iface));
+        return false;
+    }
+
+    if (!decoder_.activate(iface, proto)) {
+        roc_log(LogError, "benchmark: can't activate %s interface of decoder",
+                address::interface_to_str(iface));
+        return false;
+    }
+
+    active_[iface] = true;
+    return true;
+}
+
+core::nanoseconds_t Benchmark::processed_time() const {
+    return processed_time_;
+}
+
+core::nanoseconds_t Benchmark::elapsed_time() const {
+    return elapsed_time_;
+}
+
+size_t Benchmark::max_sessions() const {
+    if (elapsed_time_ <= 0) {
+        return 0;
+    }
+
+    return (size_t)floor((double)processed_time_ / elapsed_time_
+                         * (1 - config_.headroom));
+}
+
+bool Benchmark::run() {
+    roc_panic_if(!is_valid());
+
+    if (!active_[address::Iface_AudioSource]) {
+        roc_log(LogError, "benchmark: source interface is not activated");
+        return false;
+    }
+
+    roc_log(LogInfo, "benchmark: starting with warmup=%.3fs duration=%.3fs lead=%.3fs",
+            (double)config_.warmup / core::Second,
+            (double)config_.duration / core::Second, (double)lead_ / core::Second);
+
+    // Fill receiver queue up to target latency before reading first frame,
+    // so that session plays from the very beginning, as in real receiver.
+    for (core::nanoseconds_t pos = 0; pos < lead_; pos += config_.frame_length) {
+        encode_frame_();
+
+        for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+            if (!deliver_packets_((address::Interface)iface)) {
+                return false;
+            }
+        }
+    }
+
+    processed_time_ = 0;
+    elapsed_time_ = 0;
+
+    const core::nanoseconds_t total_time = config_.warmup + config_.duration;
+
+    for (core::nanoseconds_t pos = 0; pos < total_time; pos += config_.frame_length) {
+        // Encoding is not measured.
+        encode_frame_();
+
+        const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+        for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+            if (!deliver_packets_((address::Interface)iface)) {
+                return false;
+            }
+        }
+
+        if (!decode_frame_()) {
+            return false;
+        }
+
+        drain_feedback_();
+
+        if (pos >= config_.warmup) {
+            elapsed_time_ += core::timestamp(core::ClockMonotonic) - start_time;
+            processed_time_ += config_.frame_length;
+        }
+    }
+
+    const double factor =
+        elapsed_time_ > 0 ? (double)processed_time_ / elapsed_time_ : 0.;
+
+    printf("decoded %.3fs of audio in %.3fs (%.1fx realtime, %.1f%% cpu per session)\n",
+           (double)processed_time_ / core::Second, (double)elapsed_time_ / core::Second,
+           factor, factor > 0 ? 100. / factor : 0.);
+    printf("estimated capacity: %lu sessions with %.0f%% cpu headroom\n",
+           (unsigned long)max_sessions(), config_.headroom * 100);
+
+    return true;
+}
+
+void Benchmark::generate_frame_() {
+    const size_t num_chans = encoder_spec_.num_channels();
+    const size_t sample_rate = encoder_spec_.sample_rate();
+
+    audio::sample_t* samples = encode_buffer_.data();
+
+    for (size_t ns = 0; ns < encode_buffer_.size() / num_chans; ns++) {
+        const audio::sample_t s = (audio::sample_t)(
+            SineAmplitude * sin(2 * M_PI * SineFreq * sine_pos_ / sample_rate));
+
+        for (size_t nc = 0; nc < num_chans; nc++) {
+            *samples++ = s;
+        }
+
+        if (++sine_pos_ == sample_rate) {
+            sine_pos_ = 0;
+        }
+    }
+}
+
+void Benchmark::encode_frame_() {
+    // Pipeline may modify frame in-place, so it's regenerated every time.
+    generate_frame_();
+
+    audio::Frame frame(encode_buffer_.data(), encode_buffer_.size());
+    encoder_.sink().write(frame);
+}
+
+bool Benchmark::deliver_packets_(address::Interface iface) {
+    if (!active_[iface]) {
+        return true;
+    }
+
+    packet::PacketPtr packets[MaxBatch];
+
+    for (;;) {
+        size_t n_packets = 0;
+        const status::StatusCode read_code =
+            encoder_.read_packets(iface, packets, MaxBatch, n_packets);
+        if (read_code != status::StatusOK || n_packets == 0) {
+            return true;
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            // Decoder parses packets from scratch, like packets from network.
+            packet::PacketPtr pp = decoder_.packet_factory().new_packet();
+            if (!pp) {
+                roc_log(LogError, "benchmark: can't allocate packet");
+                return false;
+            }
+
+            pp->add_flags(packet::Packet::FlagUDP);
+            pp->udp()->receive_timestamp = core::timestamp(core::ClockUnix);
+            pp->set_buffer(packets[n]->buffer());
+
+            packets[n] = NULL;
+
+            const status::StatusCode code = decoder_.write_packet(iface, pp);
+            if (code != status::StatusOK) {
+                roc_log(LogError,
+                        "benchmark: can't write packet to %s interface: status=%s",
+                        address::interface_to_str(iface), status::code_to_str(code));
+                return false;
+            }
+        }
+    }
+}
+
+bool Benchmark::decode_frame_() {
+    audio::Frame frame(decode_buffer_.data(), decode_buffer_.size());
+
+    if (!decoder_.source().read(frame)) {
+        roc_log(LogError, "benchmark: can't read frame from decoder");
+        return false;
+    }
+
+    return true;
+}
+
+void Benchmark::drain_feedback_() {
+    if (!active_[address::Iface_AudioControl]) {
+        return;
+    }
+
+    // Feedback isn't delivered to encoder, but decoder keeps generated
+    // control packets until they're read.
+    packet::PacketPtr pp;
+    while (decoder_.read_packet(address::Iface_AudioControl, pp) == status::StatusOK) {
+        pp = NULL;
+    }
+}
+
+core::nanoseconds_t
+Benchmark::deduce_lead_(const pipeline::ReceiverSourceConfig& receiver_config) {
+    pipeline::ReceiverSessionConfig session_config = receiver_config.session_defaults;
+    session_config.deduce_defaults();
+
+    if (session_config.latency.target_latency > 0) {
+        return session_config.latency.target_latency;
+    }
+
+    return pipeline::DefaultLatency;
+}
+
+} // namespace recv
+} // namespace roc
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_recv/benchmark.h
+//! @brief Receiver capacity benchmark.
+
+#ifndef ROC_RECV_BENCHMARK_H_
+#define ROC_RECV_BENCHMARK_H_
+
+#include "roc_address/interface.h"
+#include "roc_address/protocol.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_node/context.h"
+#include "roc_node/receiver_decoder.h"
+#include "roc_node/sender_encoder.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace recv {
+
+//! Benchmark parameters.
+struct BenchmarkConfig {
+    //! Duration of frames read from pipeline.
+    core::nanoseconds_t frame_length;
+
+    //! Duration of audio decoded before measurement starts.
+    //! Covers session creation and latency tuner startup.
+    core::nanoseconds_t warmup;
+
+    //! Duration of audio decoded during measurement.
+    core::nanoseconds_t duration;
+
+    //! Fraction of CPU time which should remain unused, in range [0; 1).
+    double headroom;
+
+    BenchmarkConfig()
+        : frame_length(10 * core::Millisecond)
+        , warmup(core::Second)
+        , duration(10 * core::Second)
+        , headroom(0.2) {
+    }
+};
+
+//! Receiver capacity benchmark.
+//!
+//! @remarks
+//!  Runs receiver decoder with given pipeline config as fast as possible and
+//!  measures how much faster than real time it decodes one session. Packets
+//!  are produced by sender encoder from a sine wave, using the same protocols
+//!  as the receiver, and only the time spent in decoder is measured.
+//!
+//! @remarks
+//!  All sessions of a receiver are processed by a single pipeline thread, so
+//!  number of sessions which the host can sustain is estimated as realtime
+//!  factor of one session, reduced by requested headroom.
+class Benchmark : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p encoder_config defines how packets for decoder are produced.
+    //!  Its input sample spec should be raw.
+    Benchmark(node::Context& context,
+              const pipeline::SenderSinkConfig& encoder_config,
+              const pipeline::ReceiverSourceConfig& receiver_config,
+              const BenchmarkConfig& config);
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Activate interface on both encoder and decoder.
+    ROC_ATTR_NODISCARD bool activate(address::Interface iface, address::Protocol proto);
+
+    //! Run benchmark and print results.
+    ROC_ATTR_NODISCARD bool run();
+
+    //! Get duration of audio decoded during measurement.
+    core::nanoseconds_t processed_time() const;
+
+    //! Get time spent in decoder during measurement.
+    core::nanoseconds_t elapsed_time() const;
+
+    //! Get estimated number of sessions which can be decoded in real time.
+    size_t max_sessions() const;
+
+private:
+    enum { MaxBatch = 16 };
+
+    static core::nanoseconds_t
+    deduce_lead_(const pipeline::ReceiverSourceConfig& receiver_config);
+
+    void generate_frame_();
+    void encode_frame_();
+    bool deliver_packets_(address::Interface iface);
+    bool decode_frame_();
+    void drain_feedback_();
+
+    node::SenderEncoder encoder_;
+    node::ReceiverDecoder decoder_;
+
+    const BenchmarkConfig config_;
+    const audio::SampleSpec encoder_spec_;
+
+    // How far encoder runs ahead of decoder, i.e. queue length
+    // maintained in receiver.
+    const core::nanoseconds_t lead_;
+
+    core::Array<audio::sample_t> encode_buffer_;
+    core::Array<audio::sample_t> decode_buffer_;
+    size_t sine_pos_;
+
+    bool active_[address::Iface_Max];
+
+    core::nanoseconds_t processed_time_;
+    core::nanoseconds_t elapsed_time_;
+
+    bool valid_;
+};
+
+} // namespace recv
+} // namespace roc
+
+#endif // ROC_RECV_BENCHMARK_H_
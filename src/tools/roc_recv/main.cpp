@@ -8,6 +8,7 @@
 
 #include "roc_address/endpoint_uri.h"
 #include "roc_address/io_uri.h"
+#include "roc_address/parse_socket_addr.h"
 #include "roc_address/print_supported.h"
 #include "roc_address/protocol_map.h"
 #include "roc_core/crash_handler.h"
@@ -15,21 +16,261 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_units.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/thread.h"
 #include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
+#include "roc_netio/pcap_reader.h"
 #include "roc_node/context.h"
+#include "roc_node/metrics_exporter.h"
 #include "roc_node/receiver.h"
+#include "roc_node/receiver_decoder.h"
+#include "roc_pipeline/fanout_sink.h"
 #include "roc_pipeline/receiver_source.h"
 #include "roc_pipeline/transcoder_source.h"
+#include "roc_rtp/srtp_config.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/backend_map.h"
+#include "roc_sndio/prebuffered_source.h"
 #include "roc_sndio/print_supported.h"
 #include "roc_sndio/pump.h"
 
+#include "roc_recv/benchmark.h"
+#include "roc_recv/replayer.h"
+
 #include "roc_recv/cmdline.h"
 
 using namespace roc;
 
+namespace {
+
+bool activate_replay_iface(node::ReceiverDecoder& decoder,
+                           const char* option,
+                           const char* uri_str,
+                           address::Interface iface,
+                           recv::ReplayerConfig& replayer_config,
+                           core::IArena& arena) {
+    address::EndpointUri endpoint(arena);
+
+    if (!address::parse_endpoint_uri(uri_str, address::EndpointUri::Subset_Full,
+                                     endpoint)) {
+        roc_log(LogError, "can't parse --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    if (endpoint.port() < 0) {
+        roc_log(LogError, "invalid --%s endpoint: port is required for --replay: %s",
+                option, uri_str);
+        return false;
+    }
+
+    if (!decoder.activate(iface, endpoint.proto())) {
+        roc_log(LogError, "can't activate --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    replayer_config.ports[iface] = endpoint.port();
+
+    return true;
+}
+
+int replay(node::Context& context,
+           const pipeline::ReceiverSourceConfig& receiver_config,
+           sndio::ISink* output_sink,
+           core::nanoseconds_t frame_length,
+           const gengetopt_args_info& args) {
+    if (args.source_given != 1 || args.repair_given > 1 || args.control_given > 1) {
+        roc_log(LogError,
+                "--replay requires exactly one --source endpoint"
+                " and at most one --repair and --control endpoint");
+        return 1;
+    }
+
+    if (args.backup_given || args.callback_mode_flag || args.metrics_port_given) {
+        roc_log(LogError,
+                "--replay can't be used together with --backup, --callback-mode,"
+                " or --metrics-port");
+        return 1;
+    }
+
+    node::ReceiverDecoder decoder(context, receiver_config);
+    if (!decoder.is_valid()) {
+        roc_log(LogError, "can't create receiver decoder node");
+        return 1;
+    }
+
+    recv::ReplayerConfig replayer_config;
+    replayer_config.frame_length = frame_length;
+
+    switch (args.replay_timing_arg) {
+    case replay_timing_arg_original:
+        replayer_config.timing = recv::ReplayTiming_Original;
+        break;
+    case replay_timing_arg_fast:
+        replayer_config.timing = recv::ReplayTiming_Fast;
+        break;
+    default:
+        break;
+    }
+
+    if (!activate_replay_iface(decoder, "source", args.source_arg[0],
+                               address::Iface_AudioSource, replayer_config,
+                               context.arena())) {
+        return 1;
+    }
+
+    if (args.repair_given) {
+        if (!activate_replay_iface(decoder, "repair", args.repair_arg[0],
+                                   address::Iface_AudioRepair, replayer_config,
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    if (args.control_given) {
+        if (!activate_replay_iface(decoder, "control", args.control_arg[0],
+                                   address::Iface_AudioControl, replayer_config,
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    netio::PcapReader pcap_reader(decoder.packet_factory(), context.arena());
+    if (!pcap_reader.open(args.replay_arg)) {
+        roc_log(LogError, "can't open --replay file: %s", args.replay_arg);
+        return 1;
+    }
+
+    recv::Replayer replayer(decoder, pcap_reader, output_sink,
+                            receiver_config.common.output_sample_spec, replayer_config,
+                            context.arena());
+    if (!replayer.is_valid()) {
+        roc_log(LogError, "can't create replayer");
+        return 1;
+    }
+
+    const bool ok = replayer.run();
+
+    roc_log(LogInfo, "capture file: udp_packets=%lu skipped_records=%lu",
+            (unsigned long)pcap_reader.num_packets(),
+            (unsigned long)pcap_reader.num_skipped());
+
+    return ok ? 0 : 1;
+}
+
+bool parse_benchmark_proto(const char* option,
+                           const char* uri_str,
+                           address::Protocol& proto,
+                           core::IArena& arena) {
+    address::EndpointUri endpoint(arena);
+
+    if (!address::parse_endpoint_uri(uri_str, address::EndpointUri::Subset_Full,
+                                     endpoint)) {
+        roc_log(LogError, "can't parse --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    proto = endpoint.proto();
+    return true;
+}
+
+int benchmark(node::Context& context,
+              const pipeline::ReceiverSourceConfig& receiver_config,
+              core::nanoseconds_t frame_length,
+              const gengetopt_args_info& args) {
+    if (args.source_given != 1 || args.repair_given > 1 || args.control_given > 1) {
+        roc_log(LogError,
+                "--benchmark requires exactly one --source endpoint"
+                " and at most one --repair and --control endpoint");
+        return 1;
+    }
+
+    if (args.output_given || args.tee_given || args.backup_given
+        || args.callback_mode_flag || args.metrics_port_given || args.replay_given) {
+        roc_log(LogError,
+                "--benchmark can't be used together with --output, --tee, --backup,"
+                " --callback-mode, --metrics-port, or --replay");
+        return 1;
+    }
+
+    recv::BenchmarkConfig benchmark_config;
+    benchmark_config.frame_length = frame_length;
+
+    if (!core::parse_duration(args.benchmark_duration_arg, benchmark_config.duration)) {
+        roc_log(LogError, "invalid --benchmark-duration: bad format");
+        return 1;
+    }
+    if (benchmark_config.duration <= 0) {
+        roc_log(LogError, "invalid --benchmark-duration: should be > 0");
+        return 1;
+    }
+
+    if (args.benchmark_headroom_arg < 0 || args.benchmark_headroom_arg >= 100) {
+        roc_log(LogError, "invalid --benchmark-headroom: should be in range [0; 100)");
+        return 1;
+    }
+    benchmark_config.headroom = args.benchmark_headroom_arg / 100.;
+
+    address::Protocol protos[address::Iface_Max];
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        protos[iface] = address::Proto_None;
+    }
+
+    if (!parse_benchmark_proto("source", args.source_arg[0],
+                               protos[address::Iface_AudioSource], context.arena())) {
+        return 1;
+    }
+
+    if (args.repair_given) {
+        if (!parse_benchmark_proto("repair", args.repair_arg[0],
+                                   protos[address::Iface_AudioRepair],
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    if (args.control_given) {
+        if (!parse_benchmark_proto("control", args.control_arg[0],
+                                   protos[address::Iface_AudioControl],
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    // Packets are produced by sender encoder with default encoding
+    // and FEC scheme implied by source protocol.
+    pipeline::SenderSinkConfig encoder_config;
+    encoder_config.enable_timing = false;
+    encoder_config.input_sample_spec =
+        audio::SampleSpec(receiver_config.common.output_sample_spec.sample_rate(),
+                          audio::Sample_RawFormat,
+                          receiver_config.common.output_sample_spec.channel_set());
+
+    const address::ProtocolAttrs* source_attrs =
+        address::ProtocolMap::instance().find_by_id(protos[address::Iface_AudioSource]);
+    if (source_attrs) {
+        encoder_config.fec_encoder.scheme = source_attrs->fec_scheme;
+    }
+
+    recv::Benchmark bench(context, encoder_config, receiver_config, benchmark_config);
+    if (!bench.is_valid()) {
+        roc_log(LogError, "can't create benchmark");
+        return 1;
+    }
+
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        if (protos[iface] == address::Proto_None) {
+            continue;
+        }
+        if (!bench.activate((address::Interface)iface, protos[iface])) {
+            return 1;
+        }
+    }
+
+    return bench.run() ? 0 : 1;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
     core::HeapArena::set_guards(core::HeapArena_DefaultGuards
                                 | core::HeapArena_LeakGuard);
@@ -64,6 +305,13 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (args.async_log_flag) {
+        if (!core::Logger::instance().set_async(true)) {
+            roc_log(LogError, "can't enable asynchronous logging");
+            return 1;
+        }
+    }
+
     pipeline::ReceiverSourceConfig receiver_config;
 
     sndio::Config io_config;
@@ -90,6 +338,43 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.io_ring_len_given) {
+        if (!core::parse_duration(args.io_ring_len_arg, io_config.ring_length)) {
+            roc_log(LogError, "invalid --io-ring-len: bad format");
+            return 1;
+        }
+        if (io_config.ring_length <= 0) {
+            roc_log(LogError, "invalid --io-ring-len: should be > 0");
+            return 1;
+        }
+    }
+
+    if (args.latency_budget_given) {
+        if (!core::parse_duration(
+                args.latency_budget_arg,
+                receiver_config.session_defaults.latency.latency_budget)) {
+            roc_log(LogError, "invalid --latency-budget: bad format");
+            return 1;
+        }
+        if (receiver_config.session_defaults.latency.latency_budget <= 0) {
+            roc_log(LogError, "invalid --latency-budget: should be > 0");
+            return 1;
+        }
+
+        // Frames and device buffer are part of the budget, so unless they're
+        // set explicitly, keep them small compared to it.
+        const core::nanoseconds_t latency_budget =
+            receiver_config.session_defaults.latency.latency_budget;
+
+        if (!args.frame_len_given) {
+            io_config.frame_length =
+                std::min(io_config.frame_length, latency_budget / 20);
+        }
+        if (!args.io_latency_given) {
+            io_config.latency = latency_budget / 4;
+        }
+    }
+
     // TODO(gh-608): replace --rate with --io-encoding
     if (args.rate_given) {
         if (args.rate_arg <= 0) {
@@ -129,6 +414,19 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.scaling_interval_given) {
+        if (!core::parse_duration(
+                args.scaling_interval_arg,
+                receiver_config.session_defaults.latency.scaling_interval)) {
+            roc_log(LogError, "invalid --scaling-interval: bad format");
+            return 1;
+        }
+        if (receiver_config.session_defaults.latency.scaling_interval <= 0) {
+            roc_log(LogError, "invalid --scaling-interval: should be > 0");
+            return 1;
+        }
+    }
+
     if (args.no_play_timeout_given) {
         if (!core::parse_duration(
                 args.no_play_timeout_arg,
@@ -185,6 +483,9 @@ int main(int argc, char** argv) {
         break;
     }
 
+    receiver_config.session_defaults.latency.locked_clocks = args.locked_clocks_flag;
+    receiver_config.session_defaults.latency.sync_playback = args.sync_playback_flag;
+
     switch (args.resampler_backend_arg) {
     case resampler_backend_arg_default:
         receiver_config.session_defaults.resampler.backend =
@@ -202,6 +503,14 @@ int main(int argc, char** argv) {
         receiver_config.session_defaults.resampler.backend =
             audio::ResamplerBackend_SpeexDec;
         break;
+    case resampler_backend_arg_builtin_fixed:
+        receiver_config.session_defaults.resampler.backend =
+            audio::ResamplerBackend_BuiltinFixed;
+        break;
+    case resampler_backend_arg_builtin_polyphase:
+        receiver_config.session_defaults.resampler.backend =
+            audio::ResamplerBackend_BuiltinPolyphase;
+        break;
     default:
         break;
     }
@@ -223,8 +532,40 @@ int main(int argc, char** argv) {
     }
 
     receiver_config.session_defaults.enable_beeping = args.beep_flag;
+    receiver_config.session_defaults.enable_plc = args.plc_flag;
     receiver_config.common.enable_profiling = args.profiling_flag;
 
+    if (args.profiling_sampling_given) {
+        if (args.profiling_sampling_arg <= 0) {
+            roc_log(LogError, "invalid --profiling-sampling: should be > 0");
+            return 1;
+        }
+        receiver_config.common.profiler.sampling_frames =
+            (size_t)args.profiling_sampling_arg;
+    }
+    receiver_config.common.enable_low_latency = args.low_latency_flag;
+    receiver_config.common.enable_overload_control = args.overload_control_flag;
+
+    if (args.srtp_key_given) {
+        switch (args.srtp_suite_arg) {
+        case srtp_suite_arg_aes_cm_128_hmac_sha1_80:
+            receiver_config.common.srtp.suite = rtp::Srtp_AES_CM_128_HMAC_SHA1_80;
+            break;
+        case srtp_suite_arg_aead_aes_128_gcm:
+            receiver_config.common.srtp.suite = rtp::Srtp_AEAD_AES_128_GCM;
+            break;
+        default:
+            break;
+        }
+        if (!rtp::parse_srtp_key(args.srtp_key_arg, receiver_config.common.srtp)) {
+            roc_log(LogError, "invalid --srtp-key: bad format");
+            return 1;
+        }
+    } else if (args.srtp_suite_given) {
+        roc_log(LogError, "--srtp-suite can't be used without --srtp-key");
+        return 1;
+    }
+
     node::ContextConfig context_config;
 
     if (args.max_packet_size_given) {
@@ -255,6 +596,107 @@ int main(int argc, char** argv) {
             spec.ns_2_samples_overall(io_config.frame_length) * sizeof(audio::sample_t);
     }
 
+    if (args.huge_pages_given) {
+        if (!core::parse_size(args.huge_pages_arg, context_config.huge_pages_size)) {
+            roc_log(LogError, "invalid --huge-pages: bad format");
+            return 1;
+        }
+    }
+
+    if (args.realtime_flag) {
+        context_config.realtime = true;
+    }
+
+    switch (args.media_clock_arg) {
+    case media_clock_arg_system:
+        context_config.media_clock = core::MediaClock_System;
+        break;
+    case media_clock_arg_tai:
+        context_config.media_clock = core::MediaClock_Tai;
+        break;
+    case media_clock_arg_ptp:
+        context_config.media_clock = core::MediaClock_Ptp;
+        break;
+    default:
+        break;
+    }
+
+    if (args.ptp_device_given) {
+        if (context_config.media_clock != core::MediaClock_Ptp) {
+            roc_log(LogError, "invalid --ptp-device: requires --media-clock=ptp");
+            return 1;
+        }
+        context_config.ptp_device = args.ptp_device_arg;
+    } else if (context_config.media_clock == core::MediaClock_Ptp) {
+        roc_log(LogError, "invalid --media-clock: ptp requires --ptp-device");
+        return 1;
+    }
+
+    core::ThreadPolicy sched_policy = core::ThreadPolicy_Fifo;
+
+    switch (args.sched_policy_arg) {
+    case sched_policy_arg_fifo:
+        sched_policy = core::ThreadPolicy_Fifo;
+        break;
+    case sched_policy_arg_rr:
+        sched_policy = core::ThreadPolicy_RoundRobin;
+        break;
+    default:
+        break;
+    }
+
+    if (args.network_cpus_given) {
+        if (!core::parse_cpu_list(args.network_cpus_arg,
+                                  context_config.network_thread.cpu_mask)) {
+            roc_log(LogError, "invalid --network-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.network_priority_given) {
+        if (args.network_priority_arg <= 0) {
+            roc_log(LogError, "invalid --network-priority: should be > 0");
+            return 1;
+        }
+        context_config.network_thread.policy = sched_policy;
+        context_config.network_thread.priority = args.network_priority_arg;
+    }
+
+    if (args.control_cpus_given) {
+        if (!core::parse_cpu_list(args.control_cpus_arg,
+                                  context_config.control_thread.cpu_mask)) {
+            roc_log(LogError, "invalid --control-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.control_priority_given) {
+        if (args.control_priority_arg <= 0) {
+            roc_log(LogError, "invalid --control-priority: should be > 0");
+            return 1;
+        }
+        context_config.control_thread.policy = sched_policy;
+        context_config.control_thread.priority = args.control_priority_arg;
+    }
+
+    core::ThreadConfig pump_thread_config;
+
+    if (args.pump_cpus_given) {
+        if (!core::parse_cpu_list(args.pump_cpus_arg, pump_thread_config.cpu_mask)) {
+            roc_log(LogError, "invalid --pump-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.pump_priority_given) {
+        if (args.pump_priority_arg <= 0) {
+            roc_log(LogError, "invalid --pump-priority: should be > 0");
+            return 1;
+        }
+        pump_thread_config.policy = sched_policy;
+        pump_thread_config.priority = args.pump_priority_arg;
+    }
+
     node::Context context(context_config, heap_arena);
     if (!context.is_valid()) {
         roc_log(LogError, "can't initialize node context");
@@ -301,18 +743,24 @@ int main(int argc, char** argv) {
         output_sink.reset(
             backend_dispatcher.open_sink(output_uri, args.output_format_arg, io_config),
             context.arena());
-    } else {
+    } else if (!args.replay_given && !args.benchmark_flag) {
         output_sink.reset(backend_dispatcher.open_default_sink(io_config),
                           context.arena());
     }
-    if (!output_sink) {
+    if (!output_sink
+        && (output_uri.is_valid() || (!args.replay_given && !args.benchmark_flag))) {
         roc_log(LogError, "can't open output file or device: uri=%s format=%s",
                 args.output_arg, args.output_format_arg);
         return 1;
     }
 
-    receiver_config.common.enable_timing = !output_sink->has_clock();
-    receiver_config.common.output_sample_spec = output_sink->sample_spec();
+    if (output_sink) {
+        receiver_config.common.enable_timing = !output_sink->has_clock();
+        receiver_config.common.enable_idle_wait = args.idle_wait_flag;
+        receiver_config.common.output_sample_spec = output_sink->sample_spec();
+    } else if (args.rate_given) {
+        receiver_config.common.output_sample_spec.set_sample_rate((size_t)args.rate_arg);
+    }
 
     if (!receiver_config.common.output_sample_spec.is_valid()) {
         roc_log(LogError,
@@ -321,8 +769,91 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    enum { MaxTeeSinks = 8 };
+
+    core::ScopedPtr<sndio::ISink> tee_sinks[MaxTeeSinks];
+    core::ScopedPtr<pipeline::FanoutSink> fanout_sink;
+
+    if (args.tee_given) {
+        if (!output_sink) {
+            roc_log(LogError, "--tee requires output file or device");
+            return 1;
+        }
+
+        if (args.callback_mode_flag) {
+            roc_log(LogError, "--callback-mode can't be used together with --tee");
+            return 1;
+        }
+
+        if (args.tee_given > MaxTeeSinks) {
+            roc_log(LogError, "too many --tee outputs: maximum is %d", (int)MaxTeeSinks);
+            return 1;
+        }
+
+        pipeline::FanoutOutputConfig output_config;
+
+        if (!core::parse_duration(args.tee_ring_len_arg, output_config.ring_length)
+            || output_config.ring_length < 0) {
+            roc_log(LogError, "invalid --tee-ring-len: bad format");
+            return 1;
+        }
+
+        output_config.resampler.backend =
+            receiver_config.session_defaults.resampler.backend;
+        output_config.resampler.profile =
+            receiver_config.session_defaults.resampler.profile;
+
+        fanout_sink.reset(new (context.arena()) pipeline::FanoutSink(
+                              *output_sink, io_config.frame_length,
+                              context.frame_buffer_pool(), context.arena()),
+                          context.arena());
+        if (!fanout_sink || !fanout_sink->is_valid()) {
+            roc_log(LogError, "can't create fanout sink");
+            return 1;
+        }
+
+        for (size_t n = 0; n < (size_t)args.tee_given; n++) {
+            address::IoUri tee_uri(context.arena());
+
+            if (!address::parse_io_uri(args.tee_arg[n], tee_uri)) {
+                roc_log(LogError, "invalid --tee file or device URI");
+                return 1;
+            }
+
+            if (tee_uri.is_special_file()) {
+                roc_log(LogError, "--tee can't be \"-\"");
+                return 1;
+            }
+
+            tee_sinks[n].reset(backend_dispatcher.open_sink(tee_uri, NULL, io_config),
+                               context.arena());
+            if (!tee_sinks[n]) {
+                roc_log(LogError, "can't open tee file or device: uri=%s",
+                        args.tee_arg[n]);
+                return 1;
+            }
+
+            if (!fanout_sink->add_output(*tee_sinks[n], output_config)) {
+                roc_log(LogError, "can't add tee output: uri=%s", args.tee_arg[n]);
+                return 1;
+            }
+        }
+    }
+
+    // Receiver output goes either to output sink directly, or to fanout
+    // sink, which also duplicates it to --tee outputs.
+    sndio::ISink* sink = fanout_sink
+        ? (sndio::ISink*)fanout_sink.get()
+        : (sndio::ISink*)output_sink.get();
+
     core::ScopedPtr<sndio::ISource> backup_source;
     core::ScopedPtr<pipeline::TranscoderSource> backup_pipeline;
+    core::ScopedPtr<sndio::PrebufferedSource> backup_prebuffer;
+
+    if (args.callback_mode_flag && args.backup_given) {
+        roc_log(LogError, "--callback-mode can't be used together with --backup");
+        return 1;
+    }
 
     if (args.backup_given) {
         address::IoUri backup_uri(context.arena());
@@ -380,6 +911,40 @@ int main(int argc, char** argv) {
             roc_log(LogError, "can't create backup pipeline");
             return 1;
         }
+
+        core::nanoseconds_t prebuffer_len = 0;
+        if (!core::parse_duration(args.backup_prebuffer_arg, prebuffer_len)
+            || prebuffer_len < 0) {
+            roc_log(LogError, "invalid --backup-prebuffer: bad format");
+            return 1;
+        }
+
+        // Devices have own clock and can't be read ahead.
+        if (prebuffer_len > 0 && !backup_source->has_clock()) {
+            backup_prebuffer.reset(new (context.arena()) sndio::PrebufferedSource(
+                                       context.arena(), *backup_pipeline,
+                                       io_config.frame_length, prebuffer_len),
+                                   context.arena());
+            if (!backup_prebuffer || !backup_prebuffer->is_valid()) {
+                roc_log(LogError, "can't create backup prebuffer");
+                return 1;
+            }
+        }
+    }
+
+    if (args.replay_given) {
+        // Replayer paces pipeline by itself, using either capture timing
+        // or no timing at all.
+        receiver_config.common.enable_timing = false;
+
+        return replay(context, receiver_config, sink, io_config.frame_length, args);
+    }
+
+    if (args.benchmark_flag) {
+        // Benchmark runs pipeline as fast as possible.
+        receiver_config.common.enable_timing = false;
+
+        return benchmark(context, receiver_config, io_config.frame_length, args);
     }
 
     node::Receiver receiver(context, receiver_config);
@@ -417,6 +982,53 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    netio::UdpConfig iface_defaults;
+    iface_defaults.enable_reuseaddr = args.reuseaddr_given;
+
+    if (args.sock_rcvbuf_given) {
+        if (!core::parse_size(args.sock_rcvbuf_arg, iface_defaults.recv_buffer_size)) {
+            roc_log(LogError, "invalid --sock-rcvbuf: bad format");
+            return 1;
+        }
+    }
+
+    if (args.sock_sndbuf_given) {
+        if (!core::parse_size(args.sock_sndbuf_arg, iface_defaults.send_buffer_size)) {
+            roc_log(LogError, "invalid --sock-sndbuf: bad format");
+            return 1;
+        }
+    }
+
+    if (args.sock_busy_poll_given) {
+        if (!core::parse_duration(args.sock_busy_poll_arg,
+                                  iface_defaults.recv_busy_poll)) {
+            roc_log(LogError, "invalid --sock-busy-poll: bad format");
+            return 1;
+        }
+        if (iface_defaults.recv_busy_poll < 0) {
+            roc_log(LogError, "invalid --sock-busy-poll: should be >= 0");
+            return 1;
+        }
+    }
+
+    iface_defaults.enable_inline_recv = args.inline_recv_given;
+
+    if (args.dscp_given) {
+        if (args.dscp_arg < 0 || args.dscp_arg > 63) {
+            roc_log(LogError, "invalid --dscp: should be in range [0; 63]");
+            return 1;
+        }
+        iface_defaults.dscp = (unsigned int)args.dscp_arg;
+    }
+
+    if (args.sock_priority_given) {
+        if (args.sock_priority_arg < 0) {
+            roc_log(LogError, "invalid --sock-priority: should be >= 0");
+            return 1;
+        }
+        iface_defaults.priority = args.sock_priority_arg;
+    }
+
     for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
         address::EndpointUri endpoint(context.arena());
 
@@ -426,8 +1038,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (args.miface_given) {
             if (strlen(args.miface_arg[slot])
@@ -459,8 +1070,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (args.miface_given) {
             if (strlen(args.miface_arg[slot])
@@ -493,8 +1103,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (args.miface_given) {
             if (strlen(args.miface_arg[slot])
@@ -518,16 +1127,89 @@ int main(int argc, char** argv) {
         }
     }
 
+    core::ScopedPtr<node::MetricsExporter> metrics_exporter;
+
+    if (args.metrics_port_given) {
+        address::SocketAddr metrics_addr;
+        if (!address::parse_socket_addr(args.metrics_host_arg, args.metrics_port_arg,
+                                        metrics_addr)) {
+            roc_log(LogError, "invalid --metrics-host or --metrics-port: %s:%d",
+                    args.metrics_host_arg, args.metrics_port_arg);
+            return 1;
+        }
+
+        metrics_exporter.reset(new (context.arena())
+                                   node::MetricsExporter(context, context.arena()),
+                               context.arena());
+        if (!metrics_exporter || !metrics_exporter->is_valid()) {
+            roc_log(LogError, "can't create metrics exporter");
+            return 1;
+        }
+
+        for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
+            if (!metrics_exporter->add_receiver_slot(receiver, slot)) {
+                roc_log(LogError, "can't export metrics of receiver slot");
+                return 1;
+            }
+        }
+
+        if (backup_prebuffer) {
+            metrics_exporter->add_backup_source(*backup_prebuffer);
+        }
+
+        if (!metrics_exporter->start(metrics_addr)) {
+            roc_log(LogError, "can't start metrics exporter");
+            return 1;
+        }
+    }
+
+    sndio::ISource* backup = backup_prebuffer
+        ? (sndio::ISource*)backup_prebuffer.get()
+        : (sndio::ISource*)backup_pipeline.get();
+
     sndio::Pump pump(
-        context.frame_buffer_pool(), receiver.source(), backup_pipeline.get(),
-        *output_sink, io_config.frame_length, receiver_config.common.output_sample_spec,
+        context.frame_buffer_pool(), receiver.source(), backup,
+        *sink, io_config.frame_length, receiver_config.common.output_sample_spec,
         args.oneshot_flag ? sndio::Pump::ModeOneshot : sndio::Pump::ModePermanent);
     if (!pump.is_valid()) {
         roc_log(LogError, "can't create pump");
         return 1;
     }
 
-    const bool ok = pump.run();
+    if (args.io_batch_len_given) {
+        if (args.callback_mode_flag) {
+            roc_log(LogError,
+                    "--callback-mode can't be used together with --io-batch-len");
+            return 1;
+        }
+
+        core::nanoseconds_t batch_len = 0;
+        if (!core::parse_duration(args.io_batch_len_arg, batch_len)) {
+            roc_log(LogError, "invalid --io-batch-len: bad format");
+            return 1;
+        }
+        if (batch_len <= 0) {
+            roc_log(LogError, "invalid --io-batch-len: should be > 0");
+            return 1;
+        }
+
+        // Ignored by pump if output has own clock, e.g. is a device.
+        if (!pump.enable_batching(context.arena(), batch_len)) {
+            roc_log(LogError, "can't enable pump batch mode");
+            return 1;
+        }
+    }
+
+    // Pump runs in main thread. Configure it after other threads were started,
+    // so that they don't inherit its affinity and scheduling.
+    if (!core::Thread::configure_current(pump_thread_config)) {
+        roc_log(LogError, "can't configure pump thread");
+        return 1;
+    }
+
+    // In callback mode, output device reads frames from receiver in its own
+    // callback, and pump thread only monitors devices state.
+    const bool ok = args.callback_mode_flag ? pump.run_pull() : pump.run();
 
     return ok ? 0 : 1;
 }
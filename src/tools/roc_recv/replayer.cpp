@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_recv/replayer.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/packet.h"
+#include "roc_status/code_to_str.h"
+
+namespace roc {
+namespace recv {
+
+Replayer::Replayer(node::ReceiverDecoder& decoder,
+                   packet::IReader& reader,
+                   sndio::ISink* sink,
+                   const audio::SampleSpec& sample_spec,
+                   const ReplayerConfig& config,
+                   core::IArena& arena)
+    : decoder_(decoder)
+    , reader_(reader)
+    , sink_(sink)
+    , config_(config)
+    , frame_buffer_(arena)
+    , first_timestamp_(0)
+    , has_first_timestamp_(false)
+    , eof_(false)
+    , n_packets_(0)
+    , n_skipped_(0)
+    , n_frames_(0)
+    , valid_(false) {
+    roc_panic_if_msg(config_.frame_length <= 0, "replayer: frame length is zero");
+
+    const size_t frame_size = sample_spec.ns_2_samples_overall(config_.frame_length);
+
+    if (frame_size == 0) {
+        roc_log(LogError, "replayer: frame length is too small");
+        return;
+    }
+
+    if (!frame_buffer_.resize(frame_size)) {
+        roc_log(LogError, "replayer: can't allocate frame buffer");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Replayer::is_valid() const {
+    return valid_;
+}
+
+size_t Replayer::num_packets() const {
+    return n_packets_;
+}
+
+size_t Replayer::num_skipped() const {
+    return n_skipped_;
+}
+
+size_t Replayer::num_frames() const {
+    return n_frames_;
+}
+
+bool Replayer::run() {
+    roc_panic_if(!is_valid());
+
+    roc_log(LogInfo, "replayer: starting replay in %s mode",
+            config_.timing == ReplayTiming_Original ? "original" : "fast");
+
+    const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+    // Capture time, relative to first packet, up to which packets
+    // should be delivered before reading next frame.
+    core::nanoseconds_t vtime = config_.frame_length;
+
+    for (;;) {
+        if (!deliver_packets_(vtime)) {
+            return false;
+        }
+
+        if (eof_) {
+            break;
+        }
+
+        if (!process_frame_()) {
+            return false;
+        }
+
+        drain_feedback_();
+
+        vtime += config_.frame_length;
+
+        if (config_.timing == ReplayTiming_Original) {
+            core::sleep_until(core::ClockMonotonic, start_time + vtime);
+        }
+    }
+
+    const core::nanoseconds_t elapsed_time =
+        core::timestamp(core::ClockMonotonic) - start_time;
+    const core::nanoseconds_t replayed_time =
+        (core::nanoseconds_t)n_frames_ * config_.frame_length;
+
+    roc_log(LogInfo,
+            "replayed %.3fs in %.3fs (%.1fx realtime):"
+            " packets=%lu skipped=%lu frames=%lu",
+            (double)replayed_time / core::Second, (double)elapsed_time / core::Second,
+            elapsed_time > 0 ? (double)replayed_time / elapsed_time : 0.,
+            (unsigned long)n_packets_, (unsigned long)n_skipped_,
+            (unsigned long)n_frames_);
+
+    return true;
+}
+
+bool Replayer::deliver_packets_(core::nanoseconds_t vtime) {
+    while (!eof_) {
+        if (!pending_packet_) {
+            const status::StatusCode code = reader_.read(pending_packet_);
+            if (code == status::StatusNoData) {
+                eof_ = true;
+                break;
+            }
+            if (code != status::StatusOK) {
+                roc_log(LogError, "replayer: can't read packet: status=%s",
+                        status::code_to_str(code));
+                return false;
+            }
+        }
+
+        roc_panic_if(!pending_packet_->udp());
+
+        const core::nanoseconds_t timestamp = pending_packet_->udp()->receive_timestamp;
+
+        if (!has_first_timestamp_) {
+            first_timestamp_ = timestamp;
+            has_first_timestamp_ = true;
+        }
+
+        if (timestamp - first_timestamp_ >= vtime) {
+            break;
+        }
+
+        if (!deliver_packet_(pending_packet_)) {
+            return false;
+        }
+
+        pending_packet_ = NULL;
+    }
+
+    return true;
+}
+
+bool Replayer::deliver_packet_(const packet::PacketPtr& pp) {
+    const int port = pp->udp()->dst_addr.port();
+
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        if (config_.ports[iface] < 0 || config_.ports[iface] != port) {
+            continue;
+        }
+
+        // Pipeline compares receive timestamps with current time, so they
+        // should look as if packet was just received from network.
+        pp->udp()->receive_timestamp = core::timestamp(core::ClockUnix);
+
+        const status::StatusCode code =
+            decoder_.write_packet((address::Interface)iface, pp);
+        if (code != status::StatusOK) {
+            roc_log(LogError, "replayer: can't write packet to %s interface: status=%s",
+                    address::interface_to_str((address::Interface)iface),
+                    status::code_to_str(code));
+            return false;
+        }
+
+        n_packets_++;
+        return true;
+    }
+
+    n_skipped_++;
+    return true;
+}
+
+bool Replayer::process_frame_() {
+    audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
+
+    if (!decoder_.source().read(frame)) {
+        roc_log(LogError, "replayer: can't read frame from decoder");
+        return false;
+    }
+
+    if (sink_) {
+        sink_->write(frame);
+    }
+
+    n_frames_++;
+    return true;
+}
+
+void Replayer::drain_feedback_() {
+    if (config_.ports[address::Iface_AudioControl] < 0) {
+        return;
+    }
+
+    // There is nobody to send feedback to, but decoder keeps generated
+    // control packets until they're read.
+    packet::PacketPtr pp;
+    while (decoder_.read_packet(address::Iface_AudioControl, pp) == status::StatusOK) {
+        pp = NULL;
+    }
+}
+
+} // namespace recv
+} // namespace roc
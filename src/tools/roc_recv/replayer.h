@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_recv/replayer.h
+//! @brief Packet capture replayer.
+
+#ifndef ROC_RECV_REPLAYER_H_
+#define ROC_RECV_REPLAYER_H_
+
+#include "roc_address/interface.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/iarena.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_node/receiver_decoder.h"
+#include "roc_packet/ireader.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace recv {
+
+//! Replay timing mode.
+enum ReplayTiming {
+    //! Deliver packets at their original capture timing.
+    ReplayTiming_Original,
+
+    //! Deliver packets as fast as pipeline can process them.
+    ReplayTiming_Fast
+};
+
+//! Replayer parameters.
+struct ReplayerConfig {
+    //! Timing mode.
+    ReplayTiming timing;
+
+    //! Duration of frames read from pipeline.
+    core::nanoseconds_t frame_length;
+
+    //! Destination port for every interface.
+    //! Packets sent to this port are routed to this interface.
+    //! Negative value means that interface is not used.
+    int ports[address::Iface_Max];
+
+    ReplayerConfig()
+        : timing(ReplayTiming_Original)
+        , frame_length(10 * core::Millisecond) {
+        for (size_t n = 0; n < address::Iface_Max; n++) {
+            ports[n] = -1;
+        }
+    }
+};
+
+//! Packet capture replayer.
+//!
+//! @remarks
+//!  Reads packets from packet reader (e.g. capture file), routes them to
+//!  decoder interfaces by destination port, and reads decoded frames from
+//!  decoder. Virtual time advances by one frame per iteration, and packets
+//!  are delivered when virtual time reaches their capture timestamp.
+//!
+//! @remarks
+//!  In original timing mode, every iteration is paced to wall clock, so that
+//!  decoder sees the same packet timing as the real receiver did. In fast
+//!  mode, no pacing is done, and the total run time measures how fast the
+//!  pipeline can decode the capture.
+class Replayer : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  If @p sink is NULL, decoded frames are discarded.
+    Replayer(node::ReceiverDecoder& decoder,
+             packet::IReader& reader,
+             sndio::ISink* sink,
+             const audio::SampleSpec& sample_spec,
+             const ReplayerConfig& config,
+             core::IArena& arena);
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Replay all packets.
+    //! @remarks
+    //!  Returns when reader has no more packets.
+    ROC_ATTR_NODISCARD bool run();
+
+    //! Get number of delivered packets.
+    size_t num_packets() const;
+
+    //! Get number of packets not matching any interface.
+    size_t num_skipped() const;
+
+    //! Get number of decoded frames.
+    size_t num_frames() const;
+
+private:
+    bool deliver_packets_(core::nanoseconds_t vtime);
+    bool deliver_packet_(const packet::PacketPtr& pp);
+    bool process_frame_();
+    void drain_feedback_();
+
+    node::ReceiverDecoder& decoder_;
+    packet::IReader& reader_;
+    sndio::ISink* sink_;
+
+    const ReplayerConfig config_;
+
+    core::Array<audio::sample_t> frame_buffer_;
+
+    packet::PacketPtr pending_packet_;
+    core::nanoseconds_t first_timestamp_;
+    bool has_first_timestamp_;
+    bool eof_;
+
+    size_t n_packets_;
+    size_t n_skipped_;
+    size_t n_frames_;
+
+    bool valid_;
+};
+
+} // namespace recv
+} // namespace roc
+
+#endif // ROC_RECV_REPLAYER_H_
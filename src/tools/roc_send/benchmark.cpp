@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_send/benchmark.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/packet.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace roc {
+namespace send {
+
+namespace {
+
+const double SineFreq = 440;
+const double SineAmplitude = 0.5;
+
+} // namespace
+
+Benchmark::Benchmark(node::Context& context,
+                     const pipeline::SenderSinkConfig& sender_config,
+                     const BenchmarkConfig& config)
+    : encoder_(context, sender_config)
+    , config_(config)
+    , sample_spec_(sender_config.input_sample_spec)
+    , frame_buffer_(context.arena())
+    , sine_pos_(0)
+    , n_packets_(0)
+    , processed_time_(0)
+    , elapsed_time_(0)
+    , valid_(false) {
+    roc_panic_if_msg(config_.frame_length <= 0, "benchmark: frame length is zero");
+    roc_panic_if_msg(config_.duration <= 0, "benchmark: duration is zero");
+    roc_panic_if_msg(config_.headroom < 0 || config_.headroom >= 1,
+                     "benchmark: headroom out of range");
+    roc_panic_if_msg(!sample_spec_.is_raw(), "benchmark: input spec is not raw");
+
+    for (size_t n = 0; n < address::Iface_Max; n++) {
+        active_[n] = false;
+    }
+
+    if (!encoder_.is_valid()) {
+        roc_log(LogError, "benchmark: can't create sender encoder");
+        return;
+    }
+
+    const size_t frame_size = sample_spec_.ns_2_samples_overall(config_.frame_length);
+
+    if (frame_size == 0) {
+        roc_log(LogError, "benchmark: frame length is too small");
+        return;
+    }
+
+    if (!frame_buffer_.resize(frame_size)) {
+        roc_log(LogError, "benchmark: can't allocate frame buffer");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Benchmark::is_valid() const {
+    return valid_;
+}
+
+bool Benchmark::activate(address::Interface iface, address::Protocol proto) {
+    roc_panic_if(!is_valid());
+
+    if (!encoder_.activate(iface, proto)) {
+        roc_log(LogError, "benchmark: can't activate %s interface of encoder",
+                address::interface_to_str(iface));
+        return false;
+    }
+
+    active_[iface] = true;
+    return true;
+}
+
+core::nanoseconds_t Benchmark::processed_time() const {
+    return processed_time_;
+}
+
+core::nanoseconds_t Benchmark::elapsed_time() const {
+    return elapsed_time_;
+}
+
+size_t Benchmark::max_streams() const {
+    if (elapsed_time_ <= 0) {
+        return 0;
+    }
+
+    return (size_t)floor((double)processed_time_ / elapsed_time_
+                         * (1 - config_.headroom));
+}
+
+bool Benchmark::run() {
+    roc_panic_if(!is_valid());
+
+    if (!active_[address::Iface_AudioSource]) {
+        roc_log(LogError, "benchmark: source interface is not activated");
+        return false;
+    }
+
+    roc_log(LogInfo, "benchmark: starting with warmup=%.3fs duration=%.3fs",
+            (double)config_.warmup / core::Second,
+            (double)config_.duration / core::Second);
+
+    processed_time_ = 0;
+    elapsed_time_ = 0;
+    n_packets_ = 0;
+
+    const core::nanoseconds_t total_time = config_.warmup + config_.duration;
+
+    for (core::nanoseconds_t pos = 0; pos < total_time; pos += config_.frame_length) {
+        // Input generation is not measured.
+        generate_frame_();
+
+        const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+        encode_frame_();
+
+        for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+            drain_packets_((address::Interface)iface);
+        }
+
+        if (pos >= config_.warmup) {
+            elapsed_time_ += core::timestamp(core::ClockMonotonic) - start_time;
+            processed_time_ += config_.frame_length;
+        }
+    }
+
+    if (n_packets_ == 0) {
+        roc_log(LogError, "benchmark: encoder didn't produce any packets");
+        return false;
+    }
+
+    const double factor =
+        elapsed_time_ > 0 ? (double)processed_time_ / elapsed_time_ : 0.;
+
+    printf("encoded %.3fs of audio in %.3fs (%.1fx realtime, %.1f%% cpu per stream)\n",
+           (double)processed_time_ / core::Second, (double)elapsed_time_ / core::Second,
+           factor, factor > 0 ? 100. / factor : 0.);
+    printf("estimated capacity: %lu streams with %.0f%% cpu headroom\n",
+           (unsigned long)max_streams(), config_.headroom * 100);
+
+    return true;
+}
+
+void Benchmark::generate_frame_() {
+    const size_t num_chans = sample_spec_.num_channels();
+    const size_t sample_rate = sample_spec_.sample_rate();
+
+    audio::sample_t* samples = frame_buffer_.data();
+
+    for (size_t ns = 0; ns < frame_buffer_.size() / num_chans; ns++) {
+        const audio::sample_t s = (audio::sample_t)(
+            SineAmplitude * sin(2 * M_PI * SineFreq * sine_pos_ / sample_rate));
+
+        for (size_t nc = 0; nc < num_chans; nc++) {
+            *samples++ = s;
+        }
+
+        if (++sine_pos_ == sample_rate) {
+            sine_pos_ = 0;
+        }
+    }
+}
+
+void Benchmark::encode_frame_() {
+    audio::Frame frame(frame_buffer_.data(), frame_buffer_.size());
+    encoder_.sink().write(frame);
+}
+
+void Benchmark::drain_packets_(address::Interface iface) {
+    if (!active_[iface]) {
+        return;
+    }
+
+    // There is nobody to send packets to, but encoder keeps
+    // them until they're read.
+    packet::PacketPtr packets[MaxBatch];
+
+    for (;;) {
+        size_t n_packets = 0;
+        const status::StatusCode code =
+            encoder_.read_packets(iface, packets, MaxBatch, n_packets);
+        if (code != status::StatusOK || n_packets == 0) {
+            return;
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            packets[n] = NULL;
+        }
+
+        n_packets_ += n_packets;
+    }
+}
+
+} // namespace send
+} // namespace roc
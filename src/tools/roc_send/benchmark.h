@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_send/benchmark.h
+//! @brief Sender capacity benchmark.
+
+#ifndef ROC_SEND_BENCHMARK_H_
+#define ROC_SEND_BENCHMARK_H_
+
+#include "roc_address/interface.h"
+#include "roc_address/protocol.h"
+#include "roc_audio/sample.h"
+#include "roc_audio/sample_spec.h"
+#include "roc_core/array.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_node/context.h"
+#include "roc_node/sender_encoder.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace send {
+
+//! Benchmark parameters.
+struct BenchmarkConfig {
+    //! Duration of frames written to pipeline.
+    core::nanoseconds_t frame_length;
+
+    //! Duration of audio encoded before measurement starts.
+    core::nanoseconds_t warmup;
+
+    //! Duration of audio encoded during measurement.
+    core::nanoseconds_t duration;
+
+    //! Fraction of CPU time which should remain unused, in range [0; 1).
+    double headroom;
+
+    BenchmarkConfig()
+        : frame_length(10 * core::Millisecond)
+        , warmup(core::Second)
+        , duration(10 * core::Second)
+        , headroom(0.2) {
+    }
+};
+
+//! Sender capacity benchmark.
+//!
+//! @remarks
+//!  Runs sender encoder with given pipeline config as fast as possible and
+//!  measures how much faster than real time it encodes one stream. Input is
+//!  a sine wave, and produced packets are discarded. Time spent in writing
+//!  frames and reading packets is measured.
+//!
+//! @remarks
+//!  All streams of a sender are processed by a single pipeline thread, so
+//!  number of streams which the host can sustain is estimated as realtime
+//!  factor of one stream, reduced by requested headroom.
+class Benchmark : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Input sample spec of @p sender_config should be raw.
+    Benchmark(node::Context& context,
+              const pipeline::SenderSinkConfig& sender_config,
+              const BenchmarkConfig& config);
+
+    //! Check if successfully constructed.
+    bool is_valid() const;
+
+    //! Activate interface on encoder.
+    ROC_ATTR_NODISCARD bool activate(address::Interface iface, address::Protocol proto);
+
+    //! Run benchmark and print results.
+    ROC_ATTR_NODISCARD bool run();
+
+    //! Get duration of audio encoded during measurement.
+    core::nanoseconds_t processed_time() const;
+
+    //! Get time spent in encoder during measurement.
+    core::nanoseconds_t elapsed_time() const;
+
+    //! Get estimated number of streams which can be encoded in real time.
+    size_t max_streams() const;
+
+private:
+    enum { MaxBatch = 16 };
+
+    void generate_frame_();
+    void encode_frame_();
+    void drain_packets_(address::Interface iface);
+
+    node::SenderEncoder encoder_;
+
+    const BenchmarkConfig config_;
+    const audio::SampleSpec sample_spec_;
+
+    core::Array<audio::sample_t> frame_buffer_;
+    size_t sine_pos_;
+
+    bool active_[address::Iface_Max];
+
+    size_t n_packets_;
+
+    core::nanoseconds_t processed_time_;
+    core::nanoseconds_t elapsed_time_;
+
+    bool valid_;
+};
+
+} // namespace send
+} // namespace roc
+
+#endif // ROC_SEND_BENCHMARK_H_
@@ -8,6 +8,7 @@
 
 #include "roc_address/endpoint_uri.h"
 #include "roc_address/io_uri.h"
+#include "roc_address/parse_socket_addr.h"
 #include "roc_address/print_supported.h"
 #include "roc_address/protocol_map.h"
 #include "roc_core/crash_handler.h"
@@ -15,20 +16,134 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_units.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/thread.h"
 #include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
 #include "roc_node/context.h"
+#include "roc_node/metrics_exporter.h"
 #include "roc_node/sender.h"
 #include "roc_pipeline/sender_sink.h"
+#include "roc_rtp/srtp_config.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/backend_map.h"
 #include "roc_sndio/print_supported.h"
 #include "roc_sndio/pump.h"
 
+#include "roc_send/benchmark.h"
+
 #include "roc_send/cmdline.h"
 
 using namespace roc;
 
+namespace {
+
+// Typical MTU of networks with jumbo frames.
+const size_t JumboMtu = 9000;
+
+bool parse_benchmark_proto(const char* option,
+                           const char* uri_str,
+                           address::Protocol& proto,
+                           core::IArena& arena) {
+    address::EndpointUri endpoint(arena);
+
+    if (!address::parse_endpoint_uri(uri_str, address::EndpointUri::Subset_Full,
+                                     endpoint)) {
+        roc_log(LogError, "can't parse --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    proto = endpoint.proto();
+    return true;
+}
+
+int benchmark(node::Context& context,
+              const pipeline::SenderSinkConfig& sender_config,
+              core::nanoseconds_t frame_length,
+              const gengetopt_args_info& args) {
+    if (args.source_given != 1 || args.repair_given > 1 || args.control_given > 1) {
+        roc_log(LogError,
+                "--benchmark requires exactly one --source endpoint"
+                " and at most one --repair and --control endpoint");
+        return 1;
+    }
+
+    if (sender_config.fec_encoder.scheme != packet::FEC_None && !args.repair_given) {
+        roc_log(LogError,
+                "incomplete configuration:"
+                " FEC is implied by --source protocol, but --repair is missing");
+        return 1;
+    }
+
+    if (args.input_given || args.metrics_port_given) {
+        roc_log(LogError,
+                "--benchmark can't be used together with --input or --metrics-port");
+        return 1;
+    }
+
+    send::BenchmarkConfig benchmark_config;
+    benchmark_config.frame_length = frame_length;
+
+    if (!core::parse_duration(args.benchmark_duration_arg, benchmark_config.duration)) {
+        roc_log(LogError, "invalid --benchmark-duration: bad format");
+        return 1;
+    }
+    if (benchmark_config.duration <= 0) {
+        roc_log(LogError, "invalid --benchmark-duration: should be > 0");
+        return 1;
+    }
+
+    if (args.benchmark_headroom_arg < 0 || args.benchmark_headroom_arg >= 100) {
+        roc_log(LogError, "invalid --benchmark-headroom: should be in range [0; 100)");
+        return 1;
+    }
+    benchmark_config.headroom = args.benchmark_headroom_arg / 100.;
+
+    address::Protocol protos[address::Iface_Max];
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        protos[iface] = address::Proto_None;
+    }
+
+    if (!parse_benchmark_proto("source", args.source_arg[0],
+                               protos[address::Iface_AudioSource], context.arena())) {
+        return 1;
+    }
+
+    if (args.repair_given) {
+        if (!parse_benchmark_proto("repair", args.repair_arg[0],
+                                   protos[address::Iface_AudioRepair],
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    if (args.control_given) {
+        if (!parse_benchmark_proto("control", args.control_arg[0],
+                                   protos[address::Iface_AudioControl],
+                                   context.arena())) {
+            return 1;
+        }
+    }
+
+    send::Benchmark bench(context, sender_config, benchmark_config);
+    if (!bench.is_valid()) {
+        roc_log(LogError, "can't create benchmark");
+        return 1;
+    }
+
+    for (size_t iface = 0; iface < address::Iface_Max; iface++) {
+        if (protos[iface] == address::Proto_None) {
+            continue;
+        }
+        if (!bench.activate((address::Interface)iface, protos[iface])) {
+            return 1;
+        }
+    }
+
+    return bench.run() ? 0 : 1;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
     core::HeapArena::set_guards(core::HeapArena_DefaultGuards
                                 | core::HeapArena_LeakGuard);
@@ -63,6 +178,13 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (args.async_log_flag) {
+        if (!core::Logger::instance().set_async(true)) {
+            roc_log(LogError, "can't enable asynchronous logging");
+            return 1;
+        }
+    }
+
     pipeline::SenderSinkConfig sender_config;
 
     sndio::Config io_config;
@@ -89,6 +211,17 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.io_ring_len_given) {
+        if (!core::parse_duration(args.io_ring_len_arg, io_config.ring_length)) {
+            roc_log(LogError, "invalid --io-ring-len: bad format");
+            return 1;
+        }
+        if (io_config.ring_length <= 0) {
+            roc_log(LogError, "invalid --io-ring-len: should be > 0");
+            return 1;
+        }
+    }
+
     // TODO(gh-608): replace --rate with --io-encoding
     if (args.rate_given) {
         if (args.rate_arg <= 0) {
@@ -211,6 +344,12 @@ int main(int argc, char** argv) {
     case resampler_backend_arg_speexdec:
         sender_config.resampler.backend = audio::ResamplerBackend_SpeexDec;
         break;
+    case resampler_backend_arg_builtin_fixed:
+        sender_config.resampler.backend = audio::ResamplerBackend_BuiltinFixed;
+        break;
+    case resampler_backend_arg_builtin_polyphase:
+        sender_config.resampler.backend = audio::ResamplerBackend_BuiltinPolyphase;
+        break;
     default:
         break;
     }
@@ -229,9 +368,39 @@ int main(int argc, char** argv) {
         break;
     }
 
+    sender_config.enable_mtu_autotune = args.mtu_autotune_flag;
     sender_config.enable_interleaving = args.interleaving_flag;
     sender_config.enable_profiling = args.profiling_flag;
 
+    if (args.profiling_sampling_given) {
+        if (args.profiling_sampling_arg <= 0) {
+            roc_log(LogError, "invalid --profiling-sampling: should be > 0");
+            return 1;
+        }
+        sender_config.profiler.sampling_frames = (size_t)args.profiling_sampling_arg;
+    }
+    sender_config.enable_low_latency = args.low_latency_flag;
+
+    if (args.srtp_key_given) {
+        switch (args.srtp_suite_arg) {
+        case srtp_suite_arg_aes_cm_128_hmac_sha1_80:
+            sender_config.srtp.suite = rtp::Srtp_AES_CM_128_HMAC_SHA1_80;
+            break;
+        case srtp_suite_arg_aead_aes_128_gcm:
+            sender_config.srtp.suite = rtp::Srtp_AEAD_AES_128_GCM;
+            break;
+        default:
+            break;
+        }
+        if (!rtp::parse_srtp_key(args.srtp_key_arg, sender_config.srtp)) {
+            roc_log(LogError, "invalid --srtp-key: bad format");
+            return 1;
+        }
+    } else if (args.srtp_suite_given) {
+        roc_log(LogError, "--srtp-suite can't be used without --srtp-key");
+        return 1;
+    }
+
     node::ContextConfig context_config;
 
     if (args.max_packet_size_given) {
@@ -249,6 +418,12 @@ int main(int argc, char** argv) {
                           audio::ChanOrder_Smpte, audio::ChanMask_Surround_7_1_4, 48000);
         context_config.max_packet_size = packet::Packet::approx_size(
             spec.ns_2_samples_overall(io_config.frame_length));
+        if (sender_config.enable_mtu_autotune) {
+            // Packet length is limited by packet buffer size, so make sure
+            // that packets can fill path MTU of jumbo frames.
+            context_config.max_packet_size =
+                std::max(context_config.max_packet_size, JumboMtu);
+        }
     }
 
     if (args.max_frame_size_given) {
@@ -262,6 +437,107 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.huge_pages_given) {
+        if (!core::parse_size(args.huge_pages_arg, context_config.huge_pages_size)) {
+            roc_log(LogError, "invalid --huge-pages: bad format");
+            return 1;
+        }
+    }
+
+    if (args.realtime_flag) {
+        context_config.realtime = true;
+    }
+
+    switch (args.media_clock_arg) {
+    case media_clock_arg_system:
+        context_config.media_clock = core::MediaClock_System;
+        break;
+    case media_clock_arg_tai:
+        context_config.media_clock = core::MediaClock_Tai;
+        break;
+    case media_clock_arg_ptp:
+        context_config.media_clock = core::MediaClock_Ptp;
+        break;
+    default:
+        break;
+    }
+
+    if (args.ptp_device_given) {
+        if (context_config.media_clock != core::MediaClock_Ptp) {
+            roc_log(LogError, "invalid --ptp-device: requires --media-clock=ptp");
+            return 1;
+        }
+        context_config.ptp_device = args.ptp_device_arg;
+    } else if (context_config.media_clock == core::MediaClock_Ptp) {
+        roc_log(LogError, "invalid --media-clock: ptp requires --ptp-device");
+        return 1;
+    }
+
+    core::ThreadPolicy sched_policy = core::ThreadPolicy_Fifo;
+
+    switch (args.sched_policy_arg) {
+    case sched_policy_arg_fifo:
+        sched_policy = core::ThreadPolicy_Fifo;
+        break;
+    case sched_policy_arg_rr:
+        sched_policy = core::ThreadPolicy_RoundRobin;
+        break;
+    default:
+        break;
+    }
+
+    if (args.network_cpus_given) {
+        if (!core::parse_cpu_list(args.network_cpus_arg,
+                                  context_config.network_thread.cpu_mask)) {
+            roc_log(LogError, "invalid --network-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.network_priority_given) {
+        if (args.network_priority_arg <= 0) {
+            roc_log(LogError, "invalid --network-priority: should be > 0");
+            return 1;
+        }
+        context_config.network_thread.policy = sched_policy;
+        context_config.network_thread.priority = args.network_priority_arg;
+    }
+
+    if (args.control_cpus_given) {
+        if (!core::parse_cpu_list(args.control_cpus_arg,
+                                  context_config.control_thread.cpu_mask)) {
+            roc_log(LogError, "invalid --control-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.control_priority_given) {
+        if (args.control_priority_arg <= 0) {
+            roc_log(LogError, "invalid --control-priority: should be > 0");
+            return 1;
+        }
+        context_config.control_thread.policy = sched_policy;
+        context_config.control_thread.priority = args.control_priority_arg;
+    }
+
+    core::ThreadConfig pump_thread_config;
+
+    if (args.pump_cpus_given) {
+        if (!core::parse_cpu_list(args.pump_cpus_arg, pump_thread_config.cpu_mask)) {
+            roc_log(LogError, "invalid --pump-cpus: bad format");
+            return 1;
+        }
+    }
+
+    if (args.pump_priority_given) {
+        if (args.pump_priority_arg <= 0) {
+            roc_log(LogError, "invalid --pump-priority: should be > 0");
+            return 1;
+        }
+        pump_thread_config.policy = sched_policy;
+        pump_thread_config.priority = args.pump_priority_arg;
+    }
+
     node::Context context(context_config, heap_arena);
     if (!context.is_valid()) {
         roc_log(LogError, "can't initialize node context");
@@ -281,6 +557,16 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (args.benchmark_flag) {
+        // Benchmark writes synthetic input as fast as possible.
+        sender_config.enable_timing = false;
+        if (args.rate_given) {
+            sender_config.input_sample_spec.set_sample_rate((size_t)args.rate_arg);
+        }
+
+        return benchmark(context, sender_config, io_config.frame_length, args);
+    }
+
     address::IoUri input_uri(context.arena());
     if (args.input_given) {
         if (!address::parse_io_uri(args.input_arg, input_uri)) {
@@ -354,6 +640,59 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    netio::UdpConfig iface_defaults;
+    iface_defaults.enable_reuseaddr = args.reuseaddr_given;
+
+    if (args.sock_rcvbuf_given) {
+        if (!core::parse_size(args.sock_rcvbuf_arg, iface_defaults.recv_buffer_size)) {
+            roc_log(LogError, "invalid --sock-rcvbuf: bad format");
+            return 1;
+        }
+    }
+
+    if (args.sock_sndbuf_given) {
+        if (!core::parse_size(args.sock_sndbuf_arg, iface_defaults.send_buffer_size)) {
+            roc_log(LogError, "invalid --sock-sndbuf: bad format");
+            return 1;
+        }
+    }
+
+    if (args.sock_busy_poll_given) {
+        if (!core::parse_duration(args.sock_busy_poll_arg,
+                                  iface_defaults.recv_busy_poll)) {
+            roc_log(LogError, "invalid --sock-busy-poll: bad format");
+            return 1;
+        }
+        if (iface_defaults.recv_busy_poll < 0) {
+            roc_log(LogError, "invalid --sock-busy-poll: should be >= 0");
+            return 1;
+        }
+    }
+
+    if (args.dscp_given) {
+        if (args.dscp_arg < 0 || args.dscp_arg > 63) {
+            roc_log(LogError, "invalid --dscp: should be in range [0; 63]");
+            return 1;
+        }
+        iface_defaults.dscp = (unsigned int)args.dscp_arg;
+    }
+
+    if (args.sock_priority_given) {
+        if (args.sock_priority_arg < 0) {
+            roc_log(LogError, "invalid --sock-priority: should be >= 0");
+            return 1;
+        }
+        iface_defaults.priority = args.sock_priority_arg;
+    }
+
+    if (args.repair_queue_limit_given) {
+        if (args.repair_queue_limit_arg < 0) {
+            roc_log(LogError, "invalid --repair-queue-limit: should be >= 0");
+            return 1;
+        }
+        iface_defaults.repair_queue_limit = (size_t)args.repair_queue_limit_arg;
+    }
+
     for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
         address::EndpointUri source_endpoint(context.arena());
         if (!address::parse_endpoint_uri(args.source_arg[slot],
@@ -363,8 +702,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (!sender.configure(slot, address::Iface_AudioSource, iface_config)) {
             roc_log(LogError, "can't configure --source endpoint");
@@ -386,8 +724,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (!sender.configure(slot, address::Iface_AudioRepair, iface_config)) {
             roc_log(LogError, "can't configure --repair endpoint");
@@ -410,8 +747,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        netio::UdpConfig iface_config;
-        iface_config.enable_reuseaddr = args.reuseaddr_given;
+        netio::UdpConfig iface_config = iface_defaults;
 
         if (!sender.configure(slot, address::Iface_AudioControl, iface_config)) {
             roc_log(LogError, "can't configure --control endpoint");
@@ -432,6 +768,38 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    core::ScopedPtr<node::MetricsExporter> metrics_exporter;
+
+    if (args.metrics_port_given) {
+        address::SocketAddr metrics_addr;
+        if (!address::parse_socket_addr(args.metrics_host_arg, args.metrics_port_arg,
+                                        metrics_addr)) {
+            roc_log(LogError, "invalid --metrics-host or --metrics-port: %s:%d",
+                    args.metrics_host_arg, args.metrics_port_arg);
+            return 1;
+        }
+
+        metrics_exporter.reset(new (context.arena())
+                                   node::MetricsExporter(context, context.arena()),
+                               context.arena());
+        if (!metrics_exporter || !metrics_exporter->is_valid()) {
+            roc_log(LogError, "can't create metrics exporter");
+            return 1;
+        }
+
+        for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
+            if (!metrics_exporter->add_sender_slot(sender, slot)) {
+                roc_log(LogError, "can't export metrics of sender slot");
+                return 1;
+            }
+        }
+
+        if (!metrics_exporter->start(metrics_addr)) {
+            roc_log(LogError, "can't start metrics exporter");
+            return 1;
+        }
+    }
+
     sndio::Pump pump(context.frame_buffer_pool(), *input_source, NULL, sender.sink(),
                      io_config.frame_length, sender_config.input_sample_spec,
                      sndio::Pump::ModePermanent);
@@ -440,6 +808,13 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Pump runs in main thread. Configure it after other threads were started,
+    // so that they don't inherit its affinity and scheduling.
+    if (!core::Thread::configure_current(pump_thread_config)) {
+        roc_log(LogError, "can't configure pump thread");
+        return 1;
+    }
+
     const bool ok = pump.run();
 
     return ok ? 0 : 1;